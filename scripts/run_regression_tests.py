@@ -1,10 +1,13 @@
 import argparse
 import glob
+import hashlib
+import json
 import sys
 import os
 import subprocess
 import multiprocessing
 from functools import partial
+from pathlib import Path
 
 def is_game_path(path):
     idx = path.rfind('.')
@@ -15,57 +18,128 @@ def is_game_path(path):
     return extension in ["cue", "chd"]
 
 
-def run_regression_test(runner, destdir, dump_interval, frames, gamepath):
+def get_benchmark_path(benchdir, gamepath):
+    return os.path.join(benchdir, Path(gamepath).stem + ".json")
+
+
+def run_regression_test(runner, destdir, dump_interval, frames, benchdir, timeout, gamepath):
     args = [runner,
             "-renderer", "software",
             "-log", "verbose",
             "-dumpdir", destdir,
             "-dumpinterval", str(dump_interval),
-            "-frames", str(frames),
-            "--", gamepath
+            "-frames", str(frames)
     ]
 
+    if benchdir is not None:
+        args += ["-benchmark", get_benchmark_path(benchdir, gamepath)]
+
+    args += ["--", gamepath]
+
     print("Running '%s'" % (" ".join(args)))
-    subprocess.run(args)
 
+    # Each game is a separate process, the emulator's state is global so it can't run several games itself.
+    # Output goes to a log per game, since it'd be interleaved on the console.
+    logdir = os.path.join(destdir, "logs")
+    os.makedirs(logdir, exist_ok=True)
+    with open(os.path.join(logdir, Path(gamepath).stem + ".log"), "w") as logfile:
+        try:
+            result = subprocess.run(args, stdout=logfile, stderr=subprocess.STDOUT, timeout=timeout)
+            return (gamepath, result.returncode)
+        except subprocess.TimeoutExpired:
+            return (gamepath, None)
+
+
+def hash_frame_dumps(destdir):
+    hashes = {}
+    for gamedir in sorted(glob.glob(os.path.join(destdir, "*"))):
+        if not os.path.isdir(gamedir):
+            continue
+
+        frames = {}
+        for imagepath in sorted(glob.glob(os.path.join(gamedir, "frame_*.png"))):
+            with open(imagepath, "rb") as f:
+                frames[Path(imagepath).name] = hashlib.md5(f.read()).hexdigest()
+
+        if len(frames) > 0:
+            hashes[Path(gamedir).name] = frames
+
+    return hashes
 
-def run_regression_tests(runner, gamedir, destdir, dump_interval, frames, parallel=1):
-    paths = glob.glob(gamedir + "/*.*", recursive=True)
-    gamepaths = list(filter(is_game_path, paths))
 
-    if not os.path.isdir(destdir) and not os.mkdir(destdir):
+def collect_benchmarks(benchdir, gamepaths):
+    results = {}
+    for game in gamepaths:
+        path = get_benchmark_path(benchdir, game)
+        if not os.path.isfile(path):
+            continue
+
+        with open(path, "r") as f:
+            results[Path(game).name] = json.load(f)
+
+    return results
+
+
+def run_regression_tests(runner, gamepaths, destdir, dump_interval, frames, parallel=1, benchmark=False, timeout=None):
+    benchdir = os.path.join(destdir, "benchmarks") if benchmark else None
+    try:
+        os.makedirs(destdir if benchdir is None else benchdir, exist_ok=True)
+    except OSError:
         print("Failed to create directory")
         return False
 
     print("Found %u games" % len(gamepaths))
 
+    func = partial(run_regression_test, runner, destdir, dump_interval, frames, benchdir, timeout)
     if parallel <= 1:
-        for game in gamepaths:
-            run_regression_test(runner, destdir, dump_interval, frames, game)
+        results = list(map(func, gamepaths))
     else:
         print("Processing %u games on %u processors" % (len(gamepaths), parallel))
-        func = partial(run_regression_test, runner, destdir, dump_interval, frames)
-        pool = multiprocessing.Pool(parallel)
-        pool.map(func, gamepaths)
-        pool.close()
+        with multiprocessing.Pool(parallel) as pool:
+            results = pool.map(func, gamepaths)
 
+    failures = [(game, code) for (game, code) in results if code != 0]
+    for (game, code) in failures:
+        print("*** '%s' %s" % (game, "timed out" if code is None else ("exited with code %d" % code)))
 
-    return True
+    # one summary per run, so CI only has to diff or upload a couple of files
+    with open(os.path.join(destdir, "frame_hashes.json"), "w") as f:
+        json.dump(hash_frame_dumps(destdir), f, indent=2, sort_keys=True)
+    if benchdir is not None:
+        with open(os.path.join(destdir, "benchmarks.json"), "w") as f:
+            json.dump(collect_benchmarks(benchdir, gamepaths), f, indent=2, sort_keys=True)
+
+    print("%u of %u games ran successfully" % (len(results) - len(failures), len(results)))
+    return len(failures) == 0
 
 
 if __name__ == "__main__":
     parser = argparse.ArgumentParser(description="Generate frame dump images for regression tests")
     parser.add_argument("-runner", action="store", required=True, help="Path to DuckStation regression test runner")
-    parser.add_argument("-gamedir", action="store", required=True, help="Directory containing game images")
+    parser.add_argument("-gamedir", action="store", help="Directory containing game images")
+    parser.add_argument("-gamelist", action="store", help="File containing a list of game images, one per line")
     parser.add_argument("-destdir", action="store", required=True, help="Base directory to dump frames to")
     parser.add_argument("-dumpinterval", action="store", type=int, default=600, help="Interval to dump frames at")
     parser.add_argument("-frames", action="store", type=int, default=36000, help="Number of frames to run")
-    parser.add_argument("-parallel", action="store", type=int, default=1, help="Number of proceeses to run")
+    parser.add_argument("-parallel", action="store", type=int, default=0, help="Number of processes to run, 0 for one per CPU")
+    parser.add_argument("-benchmark", action="store_true", help="Write a benchmark report for each game, and a combined one")
+    parser.add_argument("-timeout", action="store", type=int, help="Seconds to let each game run for before killing it")
 
     args = parser.parse_args()
 
-    if not run_regression_tests(args.runner, os.path.realpath(args.gamedir), os.path.realpath(args.destdir), args.dumpinterval, args.frames, args.parallel):
+    gamepaths = []
+    if args.gamedir is not None:
+        gamepaths += list(filter(is_game_path, glob.glob(os.path.realpath(args.gamedir) + "/*.*", recursive=True)))
+    if args.gamelist is not None:
+        with open(args.gamelist, "r") as f:
+            gamepaths += [os.path.realpath(line.strip()) for line in f if len(line.strip()) > 0]
+    if len(gamepaths) == 0:
+        print("No games specified, use -gamedir and/or -gamelist")
+        sys.exit(1)
+
+    parallel = args.parallel if args.parallel > 0 else multiprocessing.cpu_count()
+    if not run_regression_tests(args.runner, gamepaths, os.path.realpath(args.destdir), args.dumpinterval, args.frames,
+                                parallel, args.benchmark, args.timeout):
         sys.exit(1)
     else:
         sys.exit(0)
-
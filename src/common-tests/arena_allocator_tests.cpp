@@ -0,0 +1,114 @@
+// SPDX-FileCopyrightText: 2019-2022 Connor McLaughlin <stenzek@gmail.com>
+// SPDX-License-Identifier: (GPL-3.0 OR CC-BY-NC-ND-4.0)
+
+#include "common/arena_allocator.h"
+#include <cstring>
+#include <gtest/gtest.h>
+#include <thread>
+
+TEST(ArenaAllocator, AllocationsAreAlignedAndDisjoint)
+{
+  ArenaAllocator arena(1024);
+  u8* a = static_cast<u8*>(arena.Allocate(3, 1));
+  u32* b = arena.AllocateArray<u32>(4);
+  void* c = arena.Allocate(10, 64);
+
+  ASSERT_EQ(reinterpret_cast<uintptr_t>(b) % alignof(u32), 0u);
+  ASSERT_EQ(reinterpret_cast<uintptr_t>(c) % 64, 0u);
+  ASSERT_GE(reinterpret_cast<u8*>(b), a + 3);
+  ASSERT_GE(static_cast<u8*>(c), reinterpret_cast<u8*>(b + 4));
+
+  std::memset(a, 0xAA, 3);
+  std::memset(b, 0xBB, sizeof(u32) * 4);
+  std::memset(c, 0xCC, 10);
+  ASSERT_EQ(a[2], 0xAA);
+  ASSERT_EQ(b[3], 0xBBBBBBBBu);
+}
+
+TEST(ArenaAllocator, ResetReusesMemory)
+{
+  ArenaAllocator arena(1024);
+  void* first = arena.Allocate(100);
+  arena.Allocate(200);
+  ASSERT_GE(arena.GetBytesUsed(), 300u);
+
+  arena.Reset();
+  ASSERT_EQ(arena.GetBytesUsed(), 0u);
+  ASSERT_EQ(arena.Allocate(100), first);
+}
+
+TEST(ArenaAllocator, ScopeRewindsToStart)
+{
+  ArenaAllocator arena(1024);
+  arena.Allocate(16);
+  const size_t used_before = arena.GetBytesUsed();
+
+  void* inside;
+  {
+    ArenaAllocator::Scope scope(arena);
+    inside = arena.Allocate(64);
+
+    // Spill into another chunk, which the scope has to unwind as well.
+    arena.Allocate(2000);
+  }
+
+  ASSERT_EQ(arena.GetBytesUsed(), used_before);
+  ASSERT_EQ(arena.Allocate(64), inside);
+}
+
+TEST(ArenaAllocator, ResetMergesChunks)
+{
+  ArenaAllocator arena(256);
+  for (u32 i = 0; i < 10; i++)
+    arena.Allocate(200, 1);
+
+  // Oversized allocations get a chunk of their own.
+  arena.Allocate(4096, 1);
+  const size_t reserved = arena.GetBytesReserved();
+  ASSERT_GE(reserved, 10u * 200u + 4096u);
+
+  // After merging, the same allocations fit in a single chunk without reserving anything more.
+  arena.Reset();
+  ASSERT_EQ(arena.GetBytesReserved(), reserved);
+  u8* first = static_cast<u8*>(arena.Allocate(200, 1));
+  for (u32 i = 1; i < 10; i++)
+    ASSERT_EQ(arena.Allocate(200, 1), first + i * 200);
+  arena.Allocate(4096, 1);
+  ASSERT_EQ(arena.GetBytesReserved(), reserved);
+}
+
+TEST(ArenaAllocator, FormatIsNullTerminated)
+{
+  ArenaAllocator arena(64);
+  const std::string_view str = arena.Format("{} {:04X} {}", "value", 0xBEEFu, 1.5);
+  ASSERT_EQ(str, "value BEEF 1.5");
+  ASSERT_EQ(str.data()[str.size()], '\0');
+}
+
+TEST(ArenaAllocator, ArenaVectorAllocatesFromArena)
+{
+  ArenaAllocator arena(1024);
+  {
+    ArenaAllocator::Scope scope(arena);
+    ArenaVector<u32> values{ArenaAllocatorAdapter<u32>(arena)};
+    for (u32 i = 0; i < 100; i++)
+      values.push_back(i);
+
+    ASSERT_EQ(values.size(), 100u);
+    ASSERT_EQ(values[99], 99u);
+    ASSERT_GE(arena.GetBytesUsed(), 100u * sizeof(u32));
+  }
+
+  ASSERT_EQ(arena.GetBytesUsed(), 0u);
+}
+
+TEST(ArenaAllocator, FrameArenaIsPerThread)
+{
+  ArenaAllocator* main_arena = &ArenaAllocator::GetFrameArena();
+  ArenaAllocator* thread_arena = nullptr;
+  std::thread thread([&thread_arena]() { thread_arena = &ArenaAllocator::GetFrameArena(); });
+  thread.join();
+
+  ASSERT_EQ(&ArenaAllocator::GetFrameArena(), main_arena);
+  ASSERT_NE(thread_arena, main_arena);
+}
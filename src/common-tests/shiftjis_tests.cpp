@@ -0,0 +1,69 @@
+// SPDX-FileCopyrightText: 2019-2022 Connor McLaughlin <stenzek@gmail.com>
+// SPDX-License-Identifier: (GPL-3.0 OR CC-BY-NC-ND-4.0)
+
+#include "util/shiftjis.h"
+#include <gtest/gtest.h>
+
+using namespace std::string_view_literals;
+
+TEST(ShiftJIS, PlainASCII)
+{
+  ASSERT_EQ(sjis2utf8("SLUS-00001 SAVE 1"sv), "SLUS-00001 SAVE 1");
+}
+
+TEST(ShiftJIS, StopsAtNull)
+{
+  ASSERT_EQ(sjis2utf8("ABC\0DEF"sv), "ABC");
+  ASSERT_EQ(sjis2utf8("\x82\x60\0\x82\x61"sv), "A");
+}
+
+TEST(ShiftJIS, SingleByteSpecialCharacters)
+{
+  // Backslash and tilde are yen and overline in JIS X 0201, and half-width katakana are single bytes.
+  ASSERT_EQ(sjis2utf8("\\"sv), "\xC2\xA5");
+  ASSERT_EQ(sjis2utf8("~"sv), "\xE2\x80\xBE");
+  ASSERT_EQ(sjis2utf8("\xB1"sv), "\xEF\xBD\xB1");
+}
+
+TEST(ShiftJIS, FullwidthAlphanumericsSimplified)
+{
+  ASSERT_EQ(sjis2utf8("\x82\x60\x82\x79\x82\x4F\x82\x58\x82\x81\x82\x9A"sv), "AZ09az");
+}
+
+TEST(ShiftJIS, FullwidthPunctuationSimplified)
+{
+  ASSERT_EQ(sjis2utf8("\x81\x40"sv), " ");
+  ASSERT_EQ(sjis2utf8("\x81\x43\x81\x44\x81\x46\x81\x47"sv), ",.:;");
+  ASSERT_EQ(sjis2utf8("\x81\x48\x81\x49\x81\x4F\x81\x51"sv), "?!^_");
+  ASSERT_EQ(sjis2utf8("\x81\x5B\x81\x5C\x81\x5D\x81\x7C"sv), "----");
+  ASSERT_EQ(sjis2utf8("\x81\x5E\x81\x61"sv), "/|");
+  ASSERT_EQ(sjis2utf8("\x81\x68\x81\x8B\x81\x8C"sv), "\"'\"");
+  ASSERT_EQ(sjis2utf8("\x81\x69\x81\x6A\x81\x6D\x81\x6E\x81\x6F\x81\x70"sv), "()[]{}");
+  ASSERT_EQ(sjis2utf8("\x81\x7B\x81\x7E\x81\x81\x81\x83\x81\x84"sv), "+*=<>");
+  ASSERT_EQ(sjis2utf8("\x81\x90\x81\x93\x81\x94\x81\x95\x81\x96\x81\x97"sv), "$%#&*@");
+  ASSERT_EQ(sjis2utf8("\x81\x69\x82\x60\x81\x6A"sv), "(A)");
+
+  // These go through the single-byte table, like the plain characters do.
+  ASSERT_EQ(sjis2utf8("\x81\x5F"sv), "\xC2\xA5");
+  ASSERT_EQ(sjis2utf8("\x81\x60"sv), "\xE2\x80\xBE");
+}
+
+TEST(ShiftJIS, MixedWidth)
+{
+  ASSERT_EQ(sjis2utf8("A\x81\x48"sv), "A?");
+  ASSERT_EQ(sjis2utf8("AB\x81\x48"sv), "AB?");
+  ASSERT_EQ(sjis2utf8("SAVE\x81\x40\x82\x50"sv), "SAVE 1");
+}
+
+TEST(ShiftJIS, KanaAndKanji)
+{
+  // "あ", "ア", "日本"
+  ASSERT_EQ(sjis2utf8("\x82\xA0"sv), "\xE3\x81\x82");
+  ASSERT_EQ(sjis2utf8("\x83\x41"sv), "\xE3\x82\xA2");
+  ASSERT_EQ(sjis2utf8("\x93\xFA\x96\x7B"sv), "\xE6\x97\xA5\xE6\x9C\xAC");
+}
+
+TEST(ShiftJIS, TruncatedDoubleByte)
+{
+  ASSERT_EQ(sjis2utf8("AB\x82"sv), "AB");
+}
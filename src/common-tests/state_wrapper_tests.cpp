@@ -0,0 +1,181 @@
+// SPDX-FileCopyrightText: 2019-2022 Connor McLaughlin <stenzek@gmail.com>
+// SPDX-License-Identifier: (GPL-3.0 OR CC-BY-NC-ND-4.0)
+
+#include "common/byte_stream.h"
+#include "common/fifo_queue.h"
+#include "util/state_wrapper.h"
+#include <array>
+#include <cstring>
+#include <gtest/gtest.h>
+#include <vector>
+
+namespace {
+enum class TestEnum : u16
+{
+  A = 1,
+  B = 0x1234,
+  C = 0xFFFF,
+};
+
+constexpr u32 TEST_VERSION = 1;
+
+std::vector<u8> GetStreamBytes(GrowableMemoryByteStream* stream)
+{
+  const u8* ptr = stream->GetMemoryPointer();
+  return std::vector<u8>(ptr, ptr + static_cast<size_t>(stream->GetPosition()));
+}
+
+template<typename T>
+std::vector<u8> WriteEachElement(const T* values, size_t count)
+{
+  std::unique_ptr<GrowableMemoryByteStream> stream = ByteStream::CreateGrowableMemoryStream();
+  StateWrapper sw(stream.get(), StateWrapper::Mode::Write, TEST_VERSION);
+  for (size_t i = 0; i < count; i++)
+  {
+    T value = values[i];
+    sw.Do(&value);
+  }
+  EXPECT_FALSE(sw.HasError());
+  return GetStreamBytes(stream.get());
+}
+} // namespace
+
+TEST(StateWrapper, BulkArrayMatchesPerElementLayout)
+{
+  std::array<u32, 37> u32_values;
+  for (u32 i = 0; i < u32_values.size(); i++)
+    u32_values[i] = 0x01020304u * (i + 1);
+
+  std::unique_ptr<GrowableMemoryByteStream> stream = ByteStream::CreateGrowableMemoryStream();
+  StateWrapper sw(stream.get(), StateWrapper::Mode::Write, TEST_VERSION);
+  sw.Do(&u32_values);
+  ASSERT_FALSE(sw.HasError());
+  ASSERT_EQ(GetStreamBytes(stream.get()), WriteEachElement(u32_values.data(), u32_values.size()));
+}
+
+TEST(StateWrapper, BulkEnumArrayMatchesPerElementLayout)
+{
+  std::array<TestEnum, 5> enum_values = {TestEnum::A, TestEnum::B, TestEnum::C, TestEnum::B, TestEnum::A};
+
+  std::unique_ptr<GrowableMemoryByteStream> stream = ByteStream::CreateGrowableMemoryStream();
+  StateWrapper sw(stream.get(), StateWrapper::Mode::Write, TEST_VERSION);
+  sw.Do(&enum_values);
+  ASSERT_FALSE(sw.HasError());
+  ASSERT_EQ(GetStreamBytes(stream.get()), WriteEachElement(enum_values.data(), enum_values.size()));
+}
+
+TEST(StateWrapper, BulkArraysRoundTrip)
+{
+  std::array<s16, 100> s16_values;
+  for (u32 i = 0; i < s16_values.size(); i++)
+    s16_values[i] = static_cast<s16>(i * 331 - 16000);
+
+  std::vector<float> float_values = {0.0f, -1.5f, 3.25f, 1e10f};
+  std::array<bool, 3> bool_values = {true, false, true};
+
+  std::unique_ptr<GrowableMemoryByteStream> stream = ByteStream::CreateGrowableMemoryStream();
+  {
+    StateWrapper sw(stream.get(), StateWrapper::Mode::Write, TEST_VERSION);
+    sw.Do(&s16_values);
+    sw.Do(&float_values);
+    sw.Do(&bool_values);
+    ASSERT_FALSE(sw.HasError());
+  }
+
+  std::array<s16, 100> s16_read = {};
+  std::vector<float> float_read;
+  std::array<bool, 3> bool_read = {};
+  stream->SeekAbsolute(0);
+  {
+    StateWrapper sw(stream.get(), StateWrapper::Mode::Read, TEST_VERSION);
+    sw.Do(&s16_read);
+    sw.Do(&float_read);
+    sw.Do(&bool_read);
+    ASSERT_FALSE(sw.HasError());
+  }
+
+  ASSERT_EQ(s16_read, s16_values);
+  ASSERT_EQ(float_read, float_values);
+  ASSERT_EQ(bool_read, bool_values);
+}
+
+TEST(StateWrapper, WrappedFIFOQueueRoundTrip)
+{
+  // Push past the end of the ring so the contents are split into two runs.
+  InlineFIFOQueue<u16, 16> queue;
+  for (u16 i = 0; i < 12; i++)
+    queue.Push(i);
+  queue.Remove(10);
+  for (u16 i = 12; i < 22; i++)
+    queue.Push(i);
+  ASSERT_LT(queue.GetContiguousSize(), queue.GetSize());
+
+  std::vector<u16> expected;
+  for (u32 i = 0; i < queue.GetSize(); i++)
+    expected.push_back(queue.Peek(i));
+
+  std::unique_ptr<GrowableMemoryByteStream> stream = ByteStream::CreateGrowableMemoryStream();
+  {
+    StateWrapper sw(stream.get(), StateWrapper::Mode::Write, TEST_VERSION);
+    sw.Do(&queue);
+    ASSERT_FALSE(sw.HasError());
+  }
+
+  // Size prefix, then the elements in queue order.
+  const u32 size = static_cast<u32>(expected.size());
+  std::vector<u8> expected_bytes(sizeof(size) + expected.size() * sizeof(u16));
+  std::memcpy(expected_bytes.data(), &size, sizeof(size));
+  std::memcpy(expected_bytes.data() + sizeof(size), expected.data(), expected.size() * sizeof(u16));
+  ASSERT_EQ(GetStreamBytes(stream.get()), expected_bytes);
+
+  InlineFIFOQueue<u16, 16> read_queue;
+  read_queue.Push(0xFFFF);
+  stream->SeekAbsolute(0);
+  {
+    StateWrapper sw(stream.get(), StateWrapper::Mode::Read, TEST_VERSION);
+    sw.Do(&read_queue);
+    ASSERT_FALSE(sw.HasError());
+  }
+
+  ASSERT_EQ(read_queue.GetSize(), size);
+  for (u32 i = 0; i < size; i++)
+    ASSERT_EQ(read_queue.Peek(i), expected[i]);
+}
+
+TEST(StateWrapper, OversizedFIFOQueueIsAnError)
+{
+  std::unique_ptr<GrowableMemoryByteStream> stream = ByteStream::CreateGrowableMemoryStream();
+  {
+    StateWrapper sw(stream.get(), StateWrapper::Mode::Write, TEST_VERSION);
+    u32 size = 17;
+    sw.Do(&size);
+  }
+
+  InlineFIFOQueue<u16, 16> queue;
+  stream->SeekAbsolute(0);
+  StateWrapper sw(stream.get(), StateWrapper::Mode::Read, TEST_VERSION);
+  sw.Do(&queue);
+  ASSERT_TRUE(sw.HasError());
+  ASSERT_TRUE(queue.IsEmpty());
+}
+
+TEST(StateWrapper, MapBytesReturnsStreamContents)
+{
+  alignas(4) const u8 data[] = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12};
+  std::unique_ptr<ReadOnlyMemoryByteStream> stream = ByteStream::CreateReadOnlyMemoryStream(data, sizeof(data));
+  StateWrapper sw(stream.get(), StateWrapper::Mode::Read, TEST_VERSION);
+
+  const void* first = sw.MapBytes(4, 4);
+  ASSERT_EQ(first, static_cast<const void*>(&data[0]));
+  ASSERT_EQ(stream->GetPosition(), 4u);
+
+  // Misaligned views are refused without consuming anything.
+  u8 skip;
+  sw.Do(&skip);
+  ASSERT_EQ(sw.MapBytes(4, 4), nullptr);
+  ASSERT_EQ(stream->GetPosition(), 5u);
+
+  // Asking for more than is left fails too.
+  ASSERT_EQ(sw.MapBytes(sizeof(data)), nullptr);
+  ASSERT_FALSE(sw.HasError());
+}
@@ -0,0 +1,155 @@
+// SPDX-FileCopyrightText: 2019-2022 Connor McLaughlin <stenzek@gmail.com>
+// SPDX-License-Identifier: (GPL-3.0 OR CC-BY-NC-ND-4.0)
+
+#include "common/threading.h"
+#include <atomic>
+#include <gtest/gtest.h>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using Threading::TaskGroup;
+using Threading::TaskPool;
+
+namespace {
+template<typename Predicate>
+void SpinUntil(const Predicate& pred)
+{
+  while (!pred())
+    std::this_thread::yield();
+}
+} // namespace
+
+TEST(TaskPool, RunsInlineWhenNotRunning)
+{
+  TaskPool pool;
+  ASSERT_FALSE(pool.IsRunning());
+
+  std::thread::id task_thread;
+  pool.Submit([&task_thread]() { task_thread = std::this_thread::get_id(); });
+  ASSERT_EQ(task_thread, std::this_thread::get_id());
+}
+
+TEST(TaskPool, RunsTasksOnWorkers)
+{
+  TaskPool pool;
+  pool.Start(2, 1);
+  ASSERT_EQ(pool.GetWorkerCount(), 2u);
+  ASSERT_EQ(pool.GetLatencyCriticalWorkerCount(), 1u);
+
+  // Nobody helps out here, so only a worker can run it.
+  std::atomic_bool done{false};
+  std::thread::id task_thread;
+  pool.Submit([&done, &task_thread]() {
+    task_thread = std::this_thread::get_id();
+    done.store(true, std::memory_order_release);
+  });
+  SpinUntil([&done]() { return done.load(std::memory_order_acquire); });
+  ASSERT_NE(task_thread, std::this_thread::get_id());
+}
+
+TEST(TaskPool, GroupWaitsForAllTasks)
+{
+  TaskPool pool;
+  pool.Start(4, 1);
+
+  static constexpr u32 NUM_TASKS = 1000;
+  std::atomic<u32> count{0};
+  TaskGroup group(pool);
+  for (u32 i = 0; i < NUM_TASKS; i++)
+    group.Submit([&count]() { count.fetch_add(1, std::memory_order_relaxed); });
+  group.Wait();
+
+  ASSERT_EQ(group.GetPendingCount(), 0u);
+  ASSERT_EQ(count.load(), NUM_TASKS);
+}
+
+TEST(TaskPool, NestedGroupsDoNotDeadlock)
+{
+  // Fewer workers than outer tasks, so waiting workers have to run the inner tasks themselves.
+  TaskPool pool;
+  pool.Start(2, 1);
+
+  std::atomic<u32> count{0};
+  TaskGroup outer(pool);
+  for (u32 i = 0; i < 8; i++)
+  {
+    outer.Submit([&pool, &count]() {
+      TaskGroup inner(pool);
+      for (u32 j = 0; j < 16; j++)
+        inner.Submit([&count]() { count.fetch_add(1, std::memory_order_relaxed); });
+      inner.Wait();
+    });
+  }
+  outer.Wait();
+
+  ASSERT_EQ(count.load(), 8u * 16u);
+}
+
+TEST(TaskPool, HigherPriorityRunsFirst)
+{
+  TaskPool pool;
+  pool.Start(1, 1);
+
+  // Hold the only worker until everything is queued.
+  std::atomic_bool started{false};
+  std::atomic_bool release{false};
+  pool.Submit([&started, &release]() {
+    started.store(true, std::memory_order_release);
+    SpinUntil([&release]() { return release.load(std::memory_order_acquire); });
+  });
+  SpinUntil([&started]() { return started.load(std::memory_order_acquire); });
+
+  std::mutex order_mutex;
+  std::vector<int> order;
+  const auto record = [&order_mutex, &order](int id) {
+    return [&order_mutex, &order, id]() {
+      std::unique_lock lock(order_mutex);
+      order.push_back(id);
+    };
+  };
+  pool.Submit(record(0), TaskPool::Priority::Low);
+  pool.Submit(record(1), TaskPool::Priority::High);
+  pool.Submit(record(2), TaskPool::Priority::Normal);
+  release.store(true, std::memory_order_release);
+
+  SpinUntil([&order_mutex, &order]() {
+    std::unique_lock lock(order_mutex);
+    return (order.size() == 3);
+  });
+  ASSERT_EQ(order, (std::vector<int>{1, 2, 0}));
+}
+
+TEST(TaskPool, LatencyCriticalDoesNotWaitBehindBusyWorkers)
+{
+  TaskPool pool;
+  pool.Start(1, 1);
+
+  // The only normal worker is stuck until the latency-critical task runs.
+  std::atomic_bool critical_ran{false};
+  std::atomic_bool normal_done{false};
+  pool.Submit([&critical_ran, &normal_done]() {
+    SpinUntil([&critical_ran]() { return critical_ran.load(std::memory_order_acquire); });
+    normal_done.store(true, std::memory_order_release);
+  });
+  pool.Submit([&critical_ran]() { critical_ran.store(true, std::memory_order_release); },
+              TaskPool::Priority::LatencyCritical);
+
+  SpinUntil([&normal_done]() { return normal_done.load(std::memory_order_acquire); });
+  ASSERT_TRUE(critical_ran.load());
+}
+
+TEST(TaskPool, StopRunsRemainingTasks)
+{
+  TaskPool pool;
+  pool.Start(2, 1);
+
+  static constexpr u32 NUM_TASKS = 500;
+  std::atomic<u32> count{0};
+  for (u32 i = 0; i < NUM_TASKS; i++)
+    pool.Submit([&count]() { count.fetch_add(1, std::memory_order_relaxed); });
+  pool.Stop();
+
+  ASSERT_FALSE(pool.IsRunning());
+  ASSERT_EQ(count.load(), NUM_TASKS);
+}
@@ -0,0 +1,246 @@
+// SPDX-FileCopyrightText: 2019-2022 Connor McLaughlin <stenzek@gmail.com>
+// SPDX-License-Identifier: (GPL-3.0 OR CC-BY-NC-ND-4.0)
+
+#include "arena_allocator.h"
+#include "assert.h"
+#include <algorithm>
+
+#ifdef WITH_ALLOCATION_COUNTER
+#include <cstdlib>
+#include <new>
+#ifdef _WIN32
+#include <malloc.h>
+#endif
+#endif
+
+ArenaAllocator::ArenaAllocator(size_t chunk_size /* = DEFAULT_CHUNK_SIZE */) : m_chunk_size(chunk_size) {}
+
+ArenaAllocator::~ArenaAllocator() = default;
+
+ArenaAllocator& ArenaAllocator::GetFrameArena()
+{
+  static thread_local ArenaAllocator arena;
+  return arena;
+}
+
+size_t ArenaAllocator::GetBytesUsed() const
+{
+  size_t used = 0;
+  for (size_t i = 0; i < m_current_chunk && i < m_chunks.size(); i++)
+    used += m_chunks[i].size;
+  if (m_current_chunk < m_chunks.size())
+    used += m_current_offset;
+  return used;
+}
+
+size_t ArenaAllocator::GetBytesReserved() const
+{
+  size_t reserved = 0;
+  for (const Chunk& chunk : m_chunks)
+    reserved += chunk.size;
+  return reserved;
+}
+
+void* ArenaAllocator::AllocateSlow(size_t size, size_t alignment)
+{
+  // move on to the next chunk that's big enough, skipping over any that aren't
+  const size_t required = size + alignment;
+  for (;;)
+  {
+    if (m_current_chunk < m_chunks.size())
+      m_current_chunk++;
+    m_current_offset = 0;
+
+    if (m_current_chunk == m_chunks.size())
+    {
+      // oversized allocations get a chunk to themselves
+      Chunk chunk;
+      chunk.size = std::max(m_chunk_size, required);
+      chunk.data = std::make_unique<u8[]>(chunk.size);
+      m_chunks.push_back(std::move(chunk));
+      break;
+    }
+
+    if (m_chunks[m_current_chunk].size >= required)
+      break;
+  }
+
+  void* ptr = Allocate(size, alignment);
+  DebugAssert(ptr);
+  return ptr;
+}
+
+void ArenaAllocator::Rewind(size_t chunk, size_t offset)
+{
+  DebugAssert(chunk < m_current_chunk || (chunk == m_current_chunk && offset <= m_current_offset));
+  m_current_chunk = chunk;
+  m_current_offset = offset;
+}
+
+void ArenaAllocator::Reset()
+{
+  // if we spilled into more than one chunk, merge them, so next time it all fits in one
+  if (m_chunks.size() > 1 && m_current_chunk > 0)
+  {
+    const size_t total_size = GetBytesReserved();
+    m_chunks.clear();
+
+    Chunk chunk;
+    chunk.size = total_size;
+    chunk.data = std::make_unique<u8[]>(total_size);
+    m_chunks.push_back(std::move(chunk));
+  }
+
+  m_current_chunk = 0;
+  m_current_offset = 0;
+}
+
+#ifdef WITH_ALLOCATION_COUNTER
+
+static thread_local u64 s_thread_heap_allocation_count = 0;
+
+u64 GetThreadHeapAllocationCount()
+{
+  return s_thread_heap_allocation_count;
+}
+
+static void* CountedAlloc(size_t size)
+{
+  s_thread_heap_allocation_count++;
+  return std::malloc(std::max<size_t>(size, 1));
+}
+
+static void* CountedAlignedAlloc(size_t size, size_t alignment)
+{
+  s_thread_heap_allocation_count++;
+#ifdef _WIN32
+  return _aligned_malloc(std::max<size_t>(size, 1), alignment);
+#else
+  void* ptr;
+  return (posix_memalign(&ptr, std::max(alignment, sizeof(void*)), std::max<size_t>(size, 1)) == 0) ? ptr : nullptr;
+#endif
+}
+
+static void CountedAlignedFree(void* ptr)
+{
+#ifdef _WIN32
+  _aligned_free(ptr);
+#else
+  std::free(ptr);
+#endif
+}
+
+void* operator new(size_t size)
+{
+  void* ptr = CountedAlloc(size);
+  if (!ptr)
+    throw std::bad_alloc();
+  return ptr;
+}
+
+void* operator new[](size_t size)
+{
+  return operator new(size);
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept
+{
+  return CountedAlloc(size);
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept
+{
+  return CountedAlloc(size);
+}
+
+void* operator new(size_t size, std::align_val_t alignment)
+{
+  void* ptr = CountedAlignedAlloc(size, static_cast<size_t>(alignment));
+  if (!ptr)
+    throw std::bad_alloc();
+  return ptr;
+}
+
+void* operator new[](size_t size, std::align_val_t alignment)
+{
+  return operator new(size, alignment);
+}
+
+void* operator new(size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+  return CountedAlignedAlloc(size, static_cast<size_t>(alignment));
+}
+
+void* operator new[](size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+  return CountedAlignedAlloc(size, static_cast<size_t>(alignment));
+}
+
+void operator delete(void* ptr) noexcept
+{
+  std::free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept
+{
+  std::free(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept
+{
+  std::free(ptr);
+}
+
+void operator delete[](void* ptr, size_t) noexcept
+{
+  std::free(ptr);
+}
+
+void operator delete(void* ptr, const std::nothrow_t&) noexcept
+{
+  std::free(ptr);
+}
+
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept
+{
+  std::free(ptr);
+}
+
+void operator delete(void* ptr, std::align_val_t) noexcept
+{
+  CountedAlignedFree(ptr);
+}
+
+void operator delete[](void* ptr, std::align_val_t) noexcept
+{
+  CountedAlignedFree(ptr);
+}
+
+void operator delete(void* ptr, size_t, std::align_val_t) noexcept
+{
+  CountedAlignedFree(ptr);
+}
+
+void operator delete[](void* ptr, size_t, std::align_val_t) noexcept
+{
+  CountedAlignedFree(ptr);
+}
+
+void operator delete(void* ptr, std::align_val_t, const std::nothrow_t&) noexcept
+{
+  CountedAlignedFree(ptr);
+}
+
+void operator delete[](void* ptr, std::align_val_t, const std::nothrow_t&) noexcept
+{
+  CountedAlignedFree(ptr);
+}
+
+#else
+
+u64 GetThreadHeapAllocationCount()
+{
+  return 0;
+}
+
+#endif
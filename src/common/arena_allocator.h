@@ -0,0 +1,149 @@
+// SPDX-FileCopyrightText: 2019-2022 Connor McLaughlin <stenzek@gmail.com>
+// SPDX-License-Identifier: (GPL-3.0 OR CC-BY-NC-ND-4.0)
+
+#pragma once
+#include "types.h"
+#include "fmt/format.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+// Debug builds replace the global operator new, so per-thread heap allocation counts can be checked.
+#ifdef _DEBUG
+#define WITH_ALLOCATION_COUNTER 1
+#endif
+
+/// Bump allocator for short-lived allocations. Memory is handed out linearly from large chunks, and is only
+/// given back all at once, either by Reset() or by a Scope going out of scope. Individual frees are no-ops.
+/// Not thread safe, each thread should use its own arena.
+class ArenaAllocator
+{
+public:
+  static constexpr size_t DEFAULT_CHUNK_SIZE = 256 * 1024;
+
+  /// Rewinds the arena to where it was when the scope was created, releasing everything allocated since.
+  class Scope
+  {
+  public:
+    explicit Scope(ArenaAllocator& arena)
+      : m_arena(arena), m_chunk(arena.m_current_chunk), m_offset(arena.m_current_offset)
+    {
+    }
+    Scope(const Scope&) = delete;
+    ~Scope() { m_arena.Rewind(m_chunk, m_offset); }
+
+    Scope& operator=(const Scope&) = delete;
+
+  private:
+    ArenaAllocator& m_arena;
+    size_t m_chunk;
+    size_t m_offset;
+  };
+
+  explicit ArenaAllocator(size_t chunk_size = DEFAULT_CHUNK_SIZE);
+  ArenaAllocator(const ArenaAllocator&) = delete;
+  ~ArenaAllocator();
+
+  ArenaAllocator& operator=(const ArenaAllocator&) = delete;
+
+  /// Returns the calling thread's per-frame arena. The CPU thread resets its arena at the start of every frame, so
+  /// nothing allocated from it should be held across frames.
+  static ArenaAllocator& GetFrameArena();
+
+  size_t GetBytesUsed() const;
+  size_t GetBytesReserved() const;
+
+  ALWAYS_INLINE void* Allocate(size_t size, size_t alignment = alignof(std::max_align_t))
+  {
+    if (m_current_chunk < m_chunks.size())
+    {
+      const Chunk& chunk = m_chunks[m_current_chunk];
+      const uintptr_t base = reinterpret_cast<uintptr_t>(chunk.data.get());
+      const uintptr_t start = (base + m_current_offset + (alignment - 1)) & ~static_cast<uintptr_t>(alignment - 1);
+      const size_t new_offset = static_cast<size_t>(start - base) + size;
+      if (new_offset <= chunk.size)
+      {
+        m_current_offset = new_offset;
+        return reinterpret_cast<void*>(start);
+      }
+    }
+
+    return AllocateSlow(size, alignment);
+  }
+
+  template<typename T>
+  ALWAYS_INLINE T* AllocateArray(size_t count)
+  {
+    return static_cast<T*>(Allocate(sizeof(T) * count, alignof(T)));
+  }
+
+  /// Releases everything allocated from the arena. Chunks are kept around for the next round of allocations.
+  void Reset();
+
+  /// Formats a string into the arena. The returned view is null terminated, and valid until the arena is reset.
+  template<typename... T>
+  std::string_view Format(fmt::format_string<T...> fmt, T&&... args)
+  {
+    const size_t length = fmt::formatted_size(fmt, args...);
+    char* buffer = AllocateArray<char>(length + 1);
+    fmt::format_to(buffer, fmt, std::forward<T>(args)...);
+    buffer[length] = '\0';
+    return std::string_view(buffer, length);
+  }
+
+private:
+  struct Chunk
+  {
+    std::unique_ptr<u8[]> data;
+    size_t size;
+  };
+
+  void* AllocateSlow(size_t size, size_t alignment);
+  void Rewind(size_t chunk, size_t offset);
+
+  std::vector<Chunk> m_chunks;
+  size_t m_current_chunk = 0;
+  size_t m_current_offset = 0;
+  size_t m_chunk_size;
+};
+
+/// Standard library allocator which takes its memory from an arena, e.g. for scratch vectors.
+template<typename T>
+class ArenaAllocatorAdapter
+{
+public:
+  using value_type = T;
+
+  ArenaAllocatorAdapter(ArenaAllocator& arena) : m_arena(&arena) {}
+  template<typename U>
+  ArenaAllocatorAdapter(const ArenaAllocatorAdapter<U>& other) : m_arena(other.GetArena())
+  {
+  }
+
+  ALWAYS_INLINE ArenaAllocator* GetArena() const { return m_arena; }
+
+  ALWAYS_INLINE T* allocate(size_t count) { return m_arena->AllocateArray<T>(count); }
+  ALWAYS_INLINE void deallocate(T*, size_t) {}
+
+  template<typename U>
+  ALWAYS_INLINE bool operator==(const ArenaAllocatorAdapter<U>& rhs) const
+  {
+    return (m_arena == rhs.GetArena());
+  }
+  template<typename U>
+  ALWAYS_INLINE bool operator!=(const ArenaAllocatorAdapter<U>& rhs) const
+  {
+    return (m_arena != rhs.GetArena());
+  }
+
+private:
+  ArenaAllocator* m_arena;
+};
+
+template<typename T>
+using ArenaVector = std::vector<T, ArenaAllocatorAdapter<T>>;
+
+/// Returns the number of times the calling thread has called operator new. Always zero if the counter is disabled.
+u64 GetThreadHeapAllocationCount();
@@ -493,6 +493,16 @@ bool MemoryByteStream::Read2(void* pDestination, u32 ByteCount, u32* pNumberOfBy
   return (r == ByteCount);
 }
 
+const void* MemoryByteStream::MapRead(u32 ByteCount)
+{
+  if (ByteCount > (m_iSize - m_iPosition))
+    return nullptr;
+
+  const void* ptr = m_pMemory + m_iPosition;
+  m_iPosition += ByteCount;
+  return ptr;
+}
+
 bool MemoryByteStream::WriteByte(u8 SourceByte)
 {
   if (m_iPosition < m_iSize)
@@ -623,6 +633,16 @@ bool ReadOnlyMemoryByteStream::Read2(void* pDestination, u32 ByteCount, u32* pNu
   return (r == ByteCount);
 }
 
+const void* ReadOnlyMemoryByteStream::MapRead(u32 ByteCount)
+{
+  if (ByteCount > (m_iSize - m_iPosition))
+    return nullptr;
+
+  const void* ptr = m_pMemory + m_iPosition;
+  m_iPosition += ByteCount;
+  return ptr;
+}
+
 bool ReadOnlyMemoryByteStream::WriteByte(u8 SourceByte)
 {
   return false;
@@ -796,6 +816,16 @@ bool GrowableMemoryByteStream::Read2(void* pDestination, u32 ByteCount, u32* pNu
   return (r == ByteCount);
 }
 
+const void* GrowableMemoryByteStream::MapRead(u32 ByteCount)
+{
+  if (ByteCount > (m_iSize - m_iPosition))
+    return nullptr;
+
+  const void* ptr = m_pMemory + m_iPosition;
+  m_iPosition += ByteCount;
+  return ptr;
+}
+
 bool GrowableMemoryByteStream::WriteByte(u8 SourceByte)
 {
   if (m_iPosition == m_iMemorySize)
@@ -883,6 +913,11 @@ void GrowableMemoryByteStream::Grow(u32 MinimumGrowth)
   ResizeMemory(NewSize);
 }
 
+const void* ByteStream::MapRead(u32 ByteCount)
+{
+  return nullptr;
+}
+
 bool ByteStream::ReadU8(u8* dest)
 {
   return Read2(dest, sizeof(u8));
@@ -1503,7 +1538,13 @@ public:
   {
     m_cstream = ZSTD_createDStream();
     m_in_buffer.src = m_input_buffer;
-    Decompress();
+  }
+
+  ZstdDecompressStream(const void* src_data, u32 compressed_size) : m_src_stream(nullptr), m_bytes_remaining(0)
+  {
+    m_cstream = ZSTD_createDStream();
+    m_in_buffer.src = src_data;
+    m_in_buffer.size = compressed_size;
   }
 
   ~ZstdDecompressStream() override { ZSTD_freeDStream(m_cstream); }
@@ -1521,8 +1562,23 @@ public:
       m_output_buffer_rpos += copy_size;
       write_ptr += copy_size;
       remaining -= copy_size;
-      if (remaining == 0 || !Decompress())
+      if (remaining == 0)
         break;
+
+      // large reads (e.g. RAM/VRAM) are decompressed straight into the destination, skipping the output buffer
+      if (remaining >= DIRECT_READ_THRESHOLD)
+      {
+        const u32 decompressed = Decompress(write_ptr, remaining);
+        if (decompressed == 0)
+          break;
+
+        write_ptr += decompressed;
+        remaining -= decompressed;
+      }
+      else if (!FillOutputBuffer())
+      {
+        break;
+      }
     }
 
     return ByteCount - remaining;
@@ -1556,10 +1612,10 @@ public:
     {
       const s64 skip = std::min<s64>(m_output_buffer_wpos - m_output_buffer_rpos, remaining);
       remaining -= skip;
-      m_output_buffer_wpos += static_cast<u32>(skip);
+      m_output_buffer_rpos += static_cast<u32>(skip);
       if (remaining == 0)
         return true;
-      else if (!Decompress())
+      else if (!FillOutputBuffer())
         return false;
     }
   }
@@ -1581,38 +1637,38 @@ private:
   {
     INPUT_BUFFER_SIZE = 65536,
     OUTPUT_BUFFER_SIZE = 131072,
+    DIRECT_READ_THRESHOLD = 4096,
   };
 
-  bool Decompress()
+  /// Only called once the output buffer has been consumed.
+  bool FillOutputBuffer()
   {
-    if (m_output_buffer_rpos != m_output_buffer_wpos)
-    {
-      const u32 move_size = m_output_buffer_wpos - m_output_buffer_rpos;
-      std::memmove(&m_output_buffer[0], &m_output_buffer[m_output_buffer_rpos], move_size);
-      m_output_buffer_rpos = move_size;
-      m_output_buffer_wpos = move_size;
-    }
-    else
-    {
-      m_output_buffer_rpos = 0;
-      m_output_buffer_wpos = 0;
-    }
+    m_output_buffer_rpos = 0;
+    m_output_buffer_wpos = Decompress(m_output_buffer, OUTPUT_BUFFER_SIZE);
+    return (m_output_buffer_wpos > 0);
+  }
 
-    ZSTD_outBuffer outbuf = {m_output_buffer, OUTPUT_BUFFER_SIZE - m_output_buffer_wpos, 0};
+  /// Returns the number of bytes written to dst, zero at the end of the data or on error.
+  u32 Decompress(u8* dst, u32 size)
+  {
+    ZSTD_outBuffer outbuf = {dst, size, 0};
     while (outbuf.pos == 0)
     {
-      if (m_in_buffer.pos == m_in_buffer.size && !m_errorState)
+      if (m_in_buffer.pos == m_in_buffer.size)
       {
+        // memory sources are given to zstd all at once
         const u32 requested_size = std::min<u32>(m_bytes_remaining, INPUT_BUFFER_SIZE);
+        if (!m_src_stream || m_errorState || requested_size == 0)
+          return 0;
+
         const u32 bytes_read = m_src_stream->Read(m_input_buffer, requested_size);
         m_in_buffer.size = bytes_read;
         m_in_buffer.pos = 0;
         m_bytes_remaining -= bytes_read;
-        if (bytes_read != requested_size || m_bytes_remaining == 0)
-        {
+        if (bytes_read != requested_size)
           m_errorState = true;
-          break;
-        }
+        if (bytes_read == 0)
+          return 0;
       }
 
       size_t ret = ZSTD_decompressStream(m_cstream, &outbuf, &m_in_buffer);
@@ -1621,15 +1677,13 @@ private:
         Log_ErrorPrintf("ZSTD_decompressStream() failed: %u (%s)", static_cast<unsigned>(ZSTD_getErrorCode(ret)),
                         ZSTD_getErrorString(ZSTD_getErrorCode(ret)));
         m_in_buffer.pos = m_in_buffer.size;
-        m_output_buffer_rpos = 0;
-        m_output_buffer_wpos = 0;
+        m_bytes_remaining = 0;
         m_errorState = true;
-        return false;
+        return 0;
       }
     }
 
-    m_output_buffer_wpos = static_cast<u32>(outbuf.pos);
-    return true;
+    return static_cast<u32>(outbuf.pos);
   }
 
   ByteStream* m_src_stream;
@@ -1648,3 +1702,8 @@ std::unique_ptr<ByteStream> ByteStream::CreateZstdDecompressStream(ByteStream* s
 {
   return std::make_unique<ZstdDecompressStream>(src_stream, compressed_size);
 }
+
+std::unique_ptr<ByteStream> ByteStream::CreateZstdDecompressStream(const void* src_data, u32 compressed_size)
+{
+  return std::make_unique<ZstdDecompressStream>(src_data, compressed_size);
+}
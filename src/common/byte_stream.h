@@ -75,6 +75,11 @@ public:
   // if the file was opened in atomic update mode, commits the file and replaces the temporary file
   virtual bool Commit() = 0;
 
+  // for streams backed by memory, returns a view of the next ByteCount bytes without copying them, and advances past
+  // them. returns nullptr without moving if the stream can't be mapped, or doesn't have that many bytes left. the view
+  // is only valid until the stream is next written to.
+  virtual const void* MapRead(u32 ByteCount);
+
   // state accessors
   inline bool InErrorState() const { return m_errorState; }
   inline void SetErrorState() { m_errorState = true; }
@@ -124,6 +129,9 @@ public:
   static std::unique_ptr<ByteStream> CreateZstdCompressStream(ByteStream* src_stream, int compression_level);
   static std::unique_ptr<ByteStream> CreateZstdDecompressStream(ByteStream* src_stream, u32 compressed_size);
 
+  // decompresses straight out of memory, e.g. a mapped file, which must outlive the stream.
+  static std::unique_ptr<ByteStream> CreateZstdDecompressStream(const void* src_data, u32 compressed_size);
+
   // copies one stream's contents to another. rewinds source streams automatically, and returns it back to its old
   // position.
   static bool CopyStream(ByteStream* pDestinationStream, ByteStream* pSourceStream);
@@ -185,6 +193,7 @@ public:
   bool ReadByte(u8* pDestByte) override;
   u32 Read(void* pDestination, u32 ByteCount) override;
   bool Read2(void* pDestination, u32 ByteCount, u32* pNumberOfBytesRead /* = nullptr */) override;
+  const void* MapRead(u32 ByteCount) override;
   bool WriteByte(u8 SourceByte) override;
   u32 Write(const void* pSource, u32 ByteCount) override;
   bool Write2(const void* pSource, u32 ByteCount, u32* pNumberOfBytesWritten /* = nullptr */) override;
@@ -215,6 +224,7 @@ public:
   bool ReadByte(u8* pDestByte) override;
   u32 Read(void* pDestination, u32 ByteCount) override;
   bool Read2(void* pDestination, u32 ByteCount, u32* pNumberOfBytesRead /* = nullptr */) override;
+  const void* MapRead(u32 ByteCount) override;
   bool WriteByte(u8 SourceByte) override;
   u32 Write(const void* pSource, u32 ByteCount) override;
   bool Write2(const void* pSource, u32 ByteCount, u32* pNumberOfBytesWritten /* = nullptr */) override;
@@ -250,6 +260,7 @@ public:
   bool ReadByte(u8* pDestByte) override;
   u32 Read(void* pDestination, u32 ByteCount) override;
   bool Read2(void* pDestination, u32 ByteCount, u32* pNumberOfBytesRead /* = nullptr */) override;
+  const void* MapRead(u32 ByteCount) override;
   bool WriteByte(u8 SourceByte) override;
   u32 Write(const void* pSource, u32 ByteCount) override;
   bool Write2(const void* pSource, u32 ByteCount, u32* pNumberOfBytesWritten /* = nullptr */) override;
@@ -38,6 +38,10 @@ public:
   MappingResult Map(ID3D11DeviceContext* context, u32 alignment, u32 min_size);
   void Unmap(ID3D11DeviceContext* context, u32 used_size);
 
+  /// Makes the next Map() discard the buffer. Needed when switching between the immediate and a deferred context,
+  /// as the first map of a dynamic buffer in a command list has to discard it.
+  ALWAYS_INLINE void Invalidate() { m_position = 0; }
+
 private:
   ComPtr<ID3D11Buffer> m_buffer;
   u32 m_size;
@@ -342,11 +342,28 @@ void Context::MoveToNextCommandList()
     HRESULT hr = m_timestamp_query_buffer->Map(0, &read_range, &map);
     if (SUCCEEDED(hr))
     {
-      u64 timestamps[2];
-      std::memcpy(timestamps, static_cast<const u8*>(map) + offset, sizeof(timestamps));
+      // [0] = start, [1] = end, [2..] = scope switches
+      u64 timestamps[NUM_TIMESTAMP_QUERIES_PER_CMDLIST];
+      std::memcpy(timestamps, static_cast<const u8*>(map) + offset, sizeof(u64) * (2 + res.num_scope_timestamps));
       m_accumulated_gpu_time +=
         static_cast<float>(static_cast<double>(timestamps[1] - timestamps[0]) / m_timestamp_frequency);
 
+      u64 scope_start = timestamps[0];
+      u32 scope = res.first_timing_scope;
+      for (u32 i = 0; i <= res.num_scope_timestamps; i++)
+      {
+        const u64 scope_end = (i == res.num_scope_timestamps) ? timestamps[1] : timestamps[2 + i];
+        if (scope_end > scope_start)
+        {
+          m_accumulated_scope_times[scope] +=
+            static_cast<float>(static_cast<double>(scope_end - scope_start) / m_timestamp_frequency);
+          scope_start = scope_end;
+        }
+
+        if (i < res.num_scope_timestamps)
+          scope = res.scope_timestamp_ids[i];
+      }
+
       const D3D12_RANGE write_range = {};
       m_timestamp_query_buffer->Unmap(0, &write_range);
     }
@@ -357,6 +374,8 @@ void Context::MoveToNextCommandList()
   }
 
   res.has_timestamp_query = m_gpu_timing_enabled;
+  res.first_timing_scope = static_cast<u8>(m_current_timing_scope);
+  res.num_scope_timestamps = 0;
   if (m_gpu_timing_enabled)
   {
     res.command_list->EndQuery(m_timestamp_query_heap.Get(), D3D12_QUERY_TYPE_TIMESTAMP,
@@ -378,7 +397,7 @@ void Context::ExecuteCommandList(bool wait_for_completion)
                                (m_current_command_list * NUM_TIMESTAMP_QUERIES_PER_CMDLIST) + 1);
     res.command_list->ResolveQueryData(m_timestamp_query_heap.Get(), D3D12_QUERY_TYPE_TIMESTAMP,
                                        m_current_command_list * NUM_TIMESTAMP_QUERIES_PER_CMDLIST,
-                                       NUM_TIMESTAMP_QUERIES_PER_CMDLIST, m_timestamp_query_buffer.Get(),
+                                       2 + res.num_scope_timestamps, m_timestamp_query_buffer.Get(),
                                        m_current_command_list * (sizeof(u64) * NUM_TIMESTAMP_QUERIES_PER_CMDLIST));
   }
 
@@ -553,4 +572,30 @@ void Context::SetEnableGPUTiming(bool enabled)
 {
   m_gpu_timing_enabled = enabled;
 }
+
+Context::TimingScopeTimes Context::GetAndResetAccumulatedScopeTimes()
+{
+  const TimingScopeTimes times = m_accumulated_scope_times;
+  m_accumulated_scope_times = {};
+  return times;
+}
+
+void Context::SetTimingScope(u32 scope)
+{
+  DebugAssert(scope < MAX_TIMING_SCOPES);
+  if (m_current_timing_scope == scope)
+    return;
+
+  m_current_timing_scope = scope;
+
+  CommandListResources& res = m_command_lists[m_current_command_list];
+  if (!res.has_timestamp_query || res.num_scope_timestamps == MAX_SCOPE_TIMESTAMPS)
+    return;
+
+  res.scope_timestamp_ids[res.num_scope_timestamps] = static_cast<u8>(scope);
+  res.command_list->EndQuery(m_timestamp_query_heap.Get(), D3D12_QUERY_TYPE_TIMESTAMP,
+                             (m_current_command_list * NUM_TIMESTAMP_QUERIES_PER_CMDLIST) + 2 +
+                               res.num_scope_timestamps);
+  res.num_scope_timestamps++;
+}
 } // namespace D3D12
@@ -32,10 +32,18 @@ public:
     // Textures that don't fit into this buffer will be uploaded with a staging buffer.
     TEXTURE_UPLOAD_BUFFER_SIZE = 16 * 1024 * 1024,
 
-    /// Start/End timestamp queries.
-    NUM_TIMESTAMP_QUERIES_PER_CMDLIST = 2,
+    /// GPU time can be broken down into this many scopes, switched with SetTimingScope().
+    MAX_TIMING_SCOPES = 16,
+
+    /// Scope switches past this count in a single command list are attributed to the last scope.
+    MAX_SCOPE_TIMESTAMPS = 126,
+
+    /// Start/End timestamp queries, followed by the scope switches.
+    NUM_TIMESTAMP_QUERIES_PER_CMDLIST = 2 + MAX_SCOPE_TIMESTAMPS,
   };
 
+  using TimingScopeTimes = std::array<float, MAX_TIMING_SCOPES>;
+
   ~Context();
 
   // Creates new device and context.
@@ -98,6 +106,10 @@ public:
   float GetAndResetAccumulatedGPUTime();
   void SetEnableGPUTiming(bool enabled);
 
+  // Writes a timestamp so that GPU work recorded after this point is attributed to the specified scope.
+  void SetTimingScope(u32 scope);
+  TimingScopeTimes GetAndResetAccumulatedScopeTimes();
+
 private:
   struct CommandListResources
   {
@@ -107,6 +119,9 @@ private:
     std::vector<std::pair<DescriptorHeapManager&, u32>> pending_descriptors;
     u64 ready_fence_value = 0;
     bool has_timestamp_query = false;
+    u8 first_timing_scope = 0;
+    u32 num_scope_timestamps = 0;
+    std::array<u8, MAX_SCOPE_TIMESTAMPS> scope_timestamp_ids;
   };
 
   Context();
@@ -138,6 +153,8 @@ private:
   ComPtr<ID3D12Resource> m_timestamp_query_buffer;
   double m_timestamp_frequency = 0.0;
   float m_accumulated_gpu_time = 0.0f;
+  TimingScopeTimes m_accumulated_scope_times = {};
+  u32 m_current_timing_scope = 0;
   bool m_gpu_timing_enabled = false;
 
   DescriptorHeapManager m_descriptor_heap_manager;
@@ -4,6 +4,7 @@
 #include "common/scoped_guard.h"
 #include "common/string.h"
 #include "file_system.h"
+#include <algorithm>
 #include <cmath>
 #include <fcntl.h>
 #include <string.h>
@@ -23,6 +24,8 @@ DRMDisplay::~DRMDisplay()
   if (m_prev_crtc)
     RestoreBuffer();
 
+  ShutdownAtomic();
+
   if (m_connector)
     drmModeFreeConnector(m_connector);
 
@@ -78,6 +81,35 @@ static uint32_t find_crtc_for_connector(int card_fd, const drmModeRes* resources
   return -1;
 }
 
+static bool GetObjectProperty(int card_fd, u32 object_id, u32 object_type, const char* name, u32* id, u64* value)
+{
+  drmModeObjectProperties* props = drmModeObjectGetProperties(card_fd, object_id, object_type);
+  if (!props)
+    return false;
+
+  bool found = false;
+  for (u32 i = 0; i < props->count_props && !found; i++)
+  {
+    drmModePropertyRes* prop = drmModeGetProperty(card_fd, props->props[i]);
+    if (!prop)
+      continue;
+
+    if (strcmp(prop->name, name) == 0)
+    {
+      if (id)
+        *id = prop->prop_id;
+      if (value)
+        *value = props->prop_values[i];
+      found = true;
+    }
+
+    drmModeFreeProperty(prop);
+  }
+
+  drmModeFreeObjectProperties(props);
+  return found;
+}
+
 bool DRMDisplay::Initialize(u32 width, u32 height, float refresh_rate)
 {
   if (m_card_id < 0)
@@ -214,6 +246,7 @@ bool DRMDisplay::TryOpeningCard(int card, u32 width, u32 height, float refresh_r
     }
   }
 
+  m_atomic = InitializeAtomic(resources);
   drmModeFreeResources(resources);
 
   m_card_id = card;
@@ -221,6 +254,119 @@ bool DRMDisplay::TryOpeningCard(int card, u32 width, u32 height, float refresh_r
   return true;
 }
 
+bool DRMDisplay::InitializeAtomic(const drmModeRes* resources)
+{
+  if (drmSetClientCap(m_card_fd, DRM_CLIENT_CAP_UNIVERSAL_PLANES, 1) != 0 ||
+      drmSetClientCap(m_card_fd, DRM_CLIENT_CAP_ATOMIC, 1) != 0)
+  {
+    Log_InfoPrintf("Atomic modesetting is not supported, using legacy page flips.");
+    return false;
+  }
+
+  int crtc_index = -1;
+  for (int i = 0; i < resources->count_crtcs; i++)
+  {
+    if (resources->crtcs[i] == m_crtc_id)
+    {
+      crtc_index = i;
+      break;
+    }
+  }
+
+  if (crtc_index < 0)
+  {
+    Log_ErrorPrintf("CRTC %u is not in the resource list, using legacy page flips.", m_crtc_id);
+    return false;
+  }
+
+  drmModePlaneRes* plane_resources = drmModeGetPlaneResources(m_card_fd);
+  if (!plane_resources)
+  {
+    Log_ErrorPrintf("drmModeGetPlaneResources() failed: %d (%s)", errno, strerror(errno));
+    return false;
+  }
+
+  for (u32 i = 0; i < plane_resources->count_planes && m_plane_id == 0; i++)
+  {
+    drmModePlane* plane = drmModeGetPlane(m_card_fd, plane_resources->planes[i]);
+    if (!plane)
+      continue;
+
+    u64 type;
+    if ((plane->possible_crtcs & (1u << crtc_index)) != 0 &&
+        GetObjectProperty(m_card_fd, plane->plane_id, DRM_MODE_OBJECT_PLANE, "type", nullptr, &type) &&
+        type == DRM_PLANE_TYPE_PRIMARY)
+    {
+      m_plane_id = plane->plane_id;
+    }
+
+    drmModeFreePlane(plane);
+  }
+
+  drmModeFreePlaneResources(plane_resources);
+  if (m_plane_id == 0)
+  {
+    Log_ErrorPrintf("No primary plane found for CRTC %u, using legacy page flips.", m_crtc_id);
+    return false;
+  }
+
+  AtomicProperties& ap = m_atomic_properties;
+  const u32 connector_id = m_connector->connector_id;
+  const struct
+  {
+    u32 object_id;
+    u32 object_type;
+    const char* name;
+    u32* id;
+  } properties[] = {
+    {connector_id, DRM_MODE_OBJECT_CONNECTOR, "CRTC_ID", &ap.connector_crtc_id},
+    {m_crtc_id, DRM_MODE_OBJECT_CRTC, "MODE_ID", &ap.crtc_mode_id},
+    {m_crtc_id, DRM_MODE_OBJECT_CRTC, "ACTIVE", &ap.crtc_active},
+    {m_plane_id, DRM_MODE_OBJECT_PLANE, "FB_ID", &ap.plane_fb_id},
+    {m_plane_id, DRM_MODE_OBJECT_PLANE, "CRTC_ID", &ap.plane_crtc_id},
+    {m_plane_id, DRM_MODE_OBJECT_PLANE, "SRC_X", &ap.plane_src_x},
+    {m_plane_id, DRM_MODE_OBJECT_PLANE, "SRC_Y", &ap.plane_src_y},
+    {m_plane_id, DRM_MODE_OBJECT_PLANE, "SRC_W", &ap.plane_src_w},
+    {m_plane_id, DRM_MODE_OBJECT_PLANE, "SRC_H", &ap.plane_src_h},
+    {m_plane_id, DRM_MODE_OBJECT_PLANE, "CRTC_X", &ap.plane_crtc_x},
+    {m_plane_id, DRM_MODE_OBJECT_PLANE, "CRTC_Y", &ap.plane_crtc_y},
+    {m_plane_id, DRM_MODE_OBJECT_PLANE, "CRTC_W", &ap.plane_crtc_w},
+    {m_plane_id, DRM_MODE_OBJECT_PLANE, "CRTC_H", &ap.plane_crtc_h},
+  };
+  for (const auto& prop : properties)
+  {
+    if (!GetObjectProperty(m_card_fd, prop.object_id, prop.object_type, prop.name, prop.id, nullptr))
+    {
+      Log_ErrorPrintf("Missing atomic property %s on object %u, using legacy page flips.", prop.name, prop.object_id);
+      m_plane_id = 0;
+      return false;
+    }
+  }
+
+  if (drmModeCreatePropertyBlob(m_card_fd, m_mode, sizeof(*m_mode), &m_mode_blob_id) != 0)
+  {
+    Log_ErrorPrintf("drmModeCreatePropertyBlob() failed: %d (%s)", errno, strerror(errno));
+    m_plane_id = 0;
+    return false;
+  }
+
+  Log_InfoPrintf("Using atomic modesetting with primary plane %u on CRTC %u", m_plane_id, m_crtc_id);
+  return true;
+}
+
+void DRMDisplay::ShutdownAtomic()
+{
+  if (m_mode_blob_id != 0)
+  {
+    drmModeDestroyPropertyBlob(m_card_fd, m_mode_blob_id);
+    m_mode_blob_id = 0;
+  }
+
+  m_plane_id = 0;
+  m_atomic = false;
+  m_atomic_mode_set = false;
+}
+
 std::optional<u32> DRMDisplay::AddBuffer(u32 width, u32 height, u32 format, u32 handle, u32 pitch, u32 offset)
 {
   uint32_t bo_handles[4] = {handle, 0, 0, 0};
@@ -243,7 +389,107 @@ void DRMDisplay::RemoveBuffer(u32 fb_id)
   drmModeRmFB(m_card_fd, fb_id);
 }
 
-void DRMDisplay::PresentBuffer(u32 fb_id, bool wait_for_vsync)
+void DRMDisplay::PresentBuffer(u32 fb_id, u32 fb_width, u32 fb_height, bool wait_for_vsync)
+{
+  if (m_atomic)
+    PresentBufferAtomic(fb_id, fb_width, fb_height, wait_for_vsync);
+  else
+    PresentBufferLegacy(fb_id, wait_for_vsync);
+}
+
+bool DRMDisplay::AtomicCommit(u32 fb_id, u32 fb_width, u32 fb_height, u32 flags, void* user_data)
+{
+  drmModeAtomicReq* req = drmModeAtomicAlloc();
+  if (!req)
+    return false;
+
+  const AtomicProperties& ap = m_atomic_properties;
+  if (!m_atomic_mode_set)
+  {
+    drmModeAtomicAddProperty(req, m_connector->connector_id, ap.connector_crtc_id, m_crtc_id);
+    drmModeAtomicAddProperty(req, m_crtc_id, ap.crtc_mode_id, m_mode_blob_id);
+    drmModeAtomicAddProperty(req, m_crtc_id, ap.crtc_active, 1);
+    flags |= DRM_MODE_ATOMIC_ALLOW_MODESET;
+  }
+
+  // Let the plane scale the buffer to the whole mode. Without scaling, the buffer is centered, cropping if needed.
+  u32 src_width = fb_width;
+  u32 src_height = fb_height;
+  u32 crtc_x = 0;
+  u32 crtc_y = 0;
+  u32 crtc_width = GetWidth();
+  u32 crtc_height = GetHeight();
+  if (!m_plane_scaling)
+  {
+    src_width = crtc_width = std::min(fb_width, GetWidth());
+    src_height = crtc_height = std::min(fb_height, GetHeight());
+    crtc_x = (GetWidth() - crtc_width) / 2;
+    crtc_y = (GetHeight() - crtc_height) / 2;
+  }
+
+  // source coordinates are 16.16 fixed point
+  drmModeAtomicAddProperty(req, m_plane_id, ap.plane_fb_id, fb_id);
+  drmModeAtomicAddProperty(req, m_plane_id, ap.plane_crtc_id, m_crtc_id);
+  drmModeAtomicAddProperty(req, m_plane_id, ap.plane_src_x, 0);
+  drmModeAtomicAddProperty(req, m_plane_id, ap.plane_src_y, 0);
+  drmModeAtomicAddProperty(req, m_plane_id, ap.plane_src_w, static_cast<u64>(src_width) << 16);
+  drmModeAtomicAddProperty(req, m_plane_id, ap.plane_src_h, static_cast<u64>(src_height) << 16);
+  drmModeAtomicAddProperty(req, m_plane_id, ap.plane_crtc_x, crtc_x);
+  drmModeAtomicAddProperty(req, m_plane_id, ap.plane_crtc_y, crtc_y);
+  drmModeAtomicAddProperty(req, m_plane_id, ap.plane_crtc_w, crtc_width);
+  drmModeAtomicAddProperty(req, m_plane_id, ap.plane_crtc_h, crtc_height);
+
+  const int res = drmModeAtomicCommit(m_card_fd, req, flags, user_data);
+  drmModeAtomicFree(req);
+  if (res != 0)
+    return false;
+
+  m_atomic_mode_set = true;
+  return true;
+}
+
+void DRMDisplay::PresentBufferAtomic(u32 fb_id, u32 fb_width, u32 fb_height, bool wait_for_vsync)
+{
+  // The first commit performs the modeset, so it has to block.
+  if (!m_atomic_mode_set)
+  {
+    if (AtomicCommit(fb_id, fb_width, fb_height, 0, nullptr))
+      return;
+
+    if (fb_width != GetWidth() || fb_height != GetHeight())
+    {
+      Log_WarningPrintf("Display controller rejected scaling %ux%u to %ux%u, presenting unscaled.", fb_width,
+                        fb_height, GetWidth(), GetHeight());
+      m_plane_scaling = false;
+      if (AtomicCommit(fb_id, fb_width, fb_height, 0, nullptr))
+        return;
+    }
+
+    Log_ErrorPrintf("drmModeAtomicCommit() failed: %d (%s)", errno, strerror(errno));
+    return;
+  }
+
+  if (!wait_for_vsync)
+  {
+    // If the previous flip hasn't happened yet, drop this frame instead of stalling.
+    if (!AtomicCommit(fb_id, fb_width, fb_height, DRM_MODE_ATOMIC_NONBLOCK, nullptr) && errno != EBUSY)
+      Log_ErrorPrintf("drmModeAtomicCommit() failed: %d (%s)", errno, strerror(errno));
+
+    return;
+  }
+
+  bool waiting_for_flip = true;
+  if (!AtomicCommit(fb_id, fb_width, fb_height, DRM_MODE_ATOMIC_NONBLOCK | DRM_MODE_PAGE_FLIP_EVENT,
+                    &waiting_for_flip))
+  {
+    Log_ErrorPrintf("drmModeAtomicCommit() failed: %d (%s)", errno, strerror(errno));
+    return;
+  }
+
+  WaitForPageFlip(&waiting_for_flip);
+}
+
+void DRMDisplay::PresentBufferLegacy(u32 fb_id, bool wait_for_vsync)
 {
   if (!wait_for_vsync)
   {
@@ -256,12 +502,6 @@ void DRMDisplay::PresentBuffer(u32 fb_id, bool wait_for_vsync)
   }
 
   bool waiting_for_flip = true;
-  drmEventContext event_ctx = {};
-  event_ctx.version = DRM_EVENT_CONTEXT_VERSION;
-  event_ctx.page_flip_handler = [](int fd, unsigned int frame, unsigned int sec, unsigned int usec, void* data) {
-    *reinterpret_cast<bool*>(data) = false;
-  };
-
   int res = drmModePageFlip(m_card_fd, m_crtc_id, fb_id, DRM_MODE_PAGE_FLIP_EVENT, &waiting_for_flip);
   if (res != 0)
   {
@@ -269,7 +509,18 @@ void DRMDisplay::PresentBuffer(u32 fb_id, bool wait_for_vsync)
     return;
   }
 
-  while (waiting_for_flip)
+  WaitForPageFlip(&waiting_for_flip);
+}
+
+void DRMDisplay::WaitForPageFlip(bool* waiting_for_flip)
+{
+  drmEventContext event_ctx = {};
+  event_ctx.version = DRM_EVENT_CONTEXT_VERSION;
+  event_ctx.page_flip_handler = [](int fd, unsigned int frame, unsigned int sec, unsigned int usec, void* data) {
+    *reinterpret_cast<bool*>(data) = false;
+  };
+
+  while (*waiting_for_flip)
   {
     fd_set fds;
     FD_ZERO(&fds);
@@ -37,9 +37,14 @@ public:
            (static_cast<float>(m_connector->modes[i].htotal) * static_cast<float>(m_connector->modes[i].vtotal));
   }
 
+  /// Atomic modesetting presents through the primary plane, which lets the display controller scale buffers which
+  /// are smaller than the mode up to the full screen. The whole frame, OSD included, is one GL surface, so there is
+  /// no separate overlay plane for the emulated display.
+  bool IsAtomic() const { return m_atomic; }
+
   std::optional<u32> AddBuffer(u32 width, u32 height, u32 format, u32 handle, u32 pitch, u32 offset);
   void RemoveBuffer(u32 fb_id);
-  void PresentBuffer(u32 fb_id, bool wait_for_vsync);
+  void PresentBuffer(u32 fb_id, u32 fb_width, u32 fb_height, bool wait_for_vsync);
 
 private:
   enum : u32
@@ -47,7 +52,31 @@ private:
     MAX_BUFFERS = 5
   };
 
+  struct AtomicProperties
+  {
+    u32 connector_crtc_id;
+    u32 crtc_mode_id;
+    u32 crtc_active;
+    u32 plane_fb_id;
+    u32 plane_crtc_id;
+    u32 plane_src_x;
+    u32 plane_src_y;
+    u32 plane_src_w;
+    u32 plane_src_h;
+    u32 plane_crtc_x;
+    u32 plane_crtc_y;
+    u32 plane_crtc_w;
+    u32 plane_crtc_h;
+  };
+
   bool TryOpeningCard(int card, u32 width, u32 height, float refresh_rate);
+  bool InitializeAtomic(const drmModeRes* resources);
+  void ShutdownAtomic();
+
+  bool AtomicCommit(u32 fb_id, u32 fb_width, u32 fb_height, u32 flags, void* user_data);
+  void PresentBufferAtomic(u32 fb_id, u32 fb_width, u32 fb_height, bool wait_for_vsync);
+  void PresentBufferLegacy(u32 fb_id, bool wait_for_vsync);
+  void WaitForPageFlip(bool* waiting_for_flip);
 
   int m_card_id = 0;
   int m_card_fd = -1;
@@ -58,4 +87,11 @@ private:
   drmModeModeInfo* m_mode = nullptr;
 
   drmModeCrtc* m_prev_crtc = nullptr;
+
+  AtomicProperties m_atomic_properties = {};
+  u32 m_plane_id = 0;
+  u32 m_mode_blob_id = 0;
+  bool m_atomic = false;
+  bool m_atomic_mode_set = false;
+  bool m_plane_scaling = true;
 };
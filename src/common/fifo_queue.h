@@ -110,6 +110,13 @@ public:
   void Remove(u32 count)
   {
     DebugAssert(m_size >= count);
+    if constexpr (std::is_trivially_destructible_v<T>)
+    {
+      m_head = (m_head + count) % CAPACITY;
+      m_size -= count;
+      return;
+    }
+
     for (u32 i = 0; i < count; i++)
     {
       m_ptr[m_head].~T();
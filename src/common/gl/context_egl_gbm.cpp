@@ -4,6 +4,7 @@
 #include "context_egl_gbm.h"
 #include "../assert.h"
 #include "../log.h"
+#include <algorithm>
 #include <drm.h>
 #include <drm_fourcc.h>
 #include <gbm.h>
@@ -94,6 +95,24 @@ bool ContextEGLGBM::CreateDisplay()
   m_wi.surface_width = m_drm_display.GetWidth();
   m_wi.surface_height = m_drm_display.GetHeight();
   m_wi.surface_refresh_rate = m_drm_display.GetRefreshRate();
+
+  // Render below the mode resolution and let the primary plane scale it up, legacy flips can't scale.
+  if (m_wi.surface_render_scale < 1.0f)
+  {
+    if (m_drm_display.IsAtomic())
+    {
+      const float scale = std::max(m_wi.surface_render_scale, 0.1f);
+      m_wi.surface_width = std::max(static_cast<u32>(static_cast<float>(m_wi.surface_width) * scale), 1u);
+      m_wi.surface_height = std::max(static_cast<u32>(static_cast<float>(m_wi.surface_height) * scale), 1u);
+      Log_InfoPrintf("Rendering at %ux%u, scaled to %ux%u on scanout", m_wi.surface_width, m_wi.surface_height,
+                     m_drm_display.GetWidth(), m_drm_display.GetHeight());
+    }
+    else
+    {
+      Log_WarningPrintf("Render scale requires atomic modesetting, rendering at the mode resolution.");
+    }
+  }
+
   return true;
 }
 
@@ -121,7 +140,7 @@ EGLNativeWindowType ContextEGLGBM::GetNativeWindow(EGLConfig config)
   eglGetConfigAttrib(m_display, config, EGL_NATIVE_VISUAL_ID, &visual_id);
 
   Assert(!m_fb_surface);
-  m_fb_surface = gbm_surface_create(m_gbm_device, m_drm_display.GetWidth(), m_drm_display.GetHeight(),
+  m_fb_surface = gbm_surface_create(m_gbm_device, m_wi.surface_width, m_wi.surface_height,
                                     static_cast<u32>(visual_id), GBM_BO_USE_RENDERING | GBM_BO_USE_SCANOUT);
   if (!m_fb_surface)
   {
@@ -164,6 +183,8 @@ ContextEGLGBM::Buffer* ContextEGLGBM::LockFrontBuffer()
     buffer = &m_buffers[m_num_buffers];
     buffer->bo = bo;
     buffer->fb_id = fb_id.value();
+    buffer->width = width;
+    buffer->height = height;
     m_num_buffers++;
   }
 
@@ -177,7 +198,7 @@ void ContextEGLGBM::ReleaseBuffer(Buffer* buffer)
 
 void ContextEGLGBM::PresentBuffer(Buffer* buffer, bool wait_for_vsync)
 {
-  m_drm_display.PresentBuffer(buffer->fb_id, wait_for_vsync);
+  m_drm_display.PresentBuffer(buffer->fb_id, buffer->width, buffer->height, wait_for_vsync);
 }
 
 bool ContextEGLGBM::SwapBuffers()
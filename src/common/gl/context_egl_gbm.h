@@ -45,6 +45,8 @@ private:
   {
     struct gbm_bo* bo;
     u32 fb_id;
+    u32 width;
+    u32 height;
   };
 
   bool CreateDisplay();
@@ -33,6 +33,18 @@ Program::~Program()
 }
 
 GLuint Program::CompileShader(GLenum type, const std::string_view source)
+{
+  const GLuint id = CreateShader(type, source);
+  if (!CheckShaderStatus(id, source))
+  {
+    glDeleteShader(id);
+    return 0;
+  }
+
+  return id;
+}
+
+GLuint Program::CreateShader(GLenum type, const std::string_view source)
 {
   GLuint id = glCreateShader(type);
 
@@ -40,7 +52,11 @@ GLuint Program::CompileShader(GLenum type, const std::string_view source)
   std::array<GLint, 1> source_lengths = {{static_cast<GLint>(source.size())}};
   glShaderSource(id, static_cast<GLsizei>(sources.size()), sources.data(), source_lengths.data());
   glCompileShader(id);
+  return id;
+}
 
+bool Program::CheckShaderStatus(GLuint id, const std::string_view source)
+{
   GLint status = GL_FALSE;
   glGetShaderiv(id, GL_COMPILE_STATUS, &status);
 
@@ -65,18 +81,17 @@ GLuint Program::CompileShader(GLenum type, const std::string_view source)
                         std::ofstream::out | std::ofstream::binary);
       if (ofs.is_open())
       {
-        ofs.write(sources[0], source_lengths[0]);
+        ofs.write(source.data(), source.size());
         ofs << "\n\nCompile failed, info log:\n";
         ofs << info_log;
         ofs.close();
       }
 
-      glDeleteShader(id);
-      return 0;
+      return false;
     }
   }
 
-  return id;
+  return true;
 }
 
 void Program::ResetLastProgram()
@@ -122,6 +137,22 @@ bool Program::Compile(const std::string_view vertex_shader,const std::string_vie
   return true;
 }
 
+void Program::CompileAsync(const std::string_view vertex_shader, const std::string_view fragment_shader)
+{
+  DebugAssert(m_program_id == 0 && m_vertex_shader_id == 0 && m_fragment_shader_id == 0);
+
+  if (!vertex_shader.empty())
+    m_vertex_shader_id = CreateShader(GL_VERTEX_SHADER, vertex_shader);
+  if (!fragment_shader.empty())
+    m_fragment_shader_id = CreateShader(GL_FRAGMENT_SHADER, fragment_shader);
+
+  m_program_id = glCreateProgram();
+  if (m_vertex_shader_id != 0)
+    glAttachShader(m_program_id, m_vertex_shader_id);
+  if (m_fragment_shader_id != 0)
+    glAttachShader(m_program_id, m_fragment_shader_id);
+}
+
 bool Program::CreateFromBinary(const void* data, u32 data_length, u32 data_format)
 {
   GLuint prog = glCreateProgram();
@@ -211,14 +242,43 @@ void Program::BindFragDataIndexed(GLuint color_number /*= 0*/, const char* name
 bool Program::Link()
 {
   glLinkProgram(m_program_id);
+  DeleteShaders();
+  return CheckLinkStatus();
+}
 
+void Program::LinkAsync()
+{
+  glLinkProgram(m_program_id);
+}
+
+bool Program::FinishLink(const std::string_view vertex_shader, const std::string_view fragment_shader)
+{
+  // only query the shaders after linking, otherwise we'd wait for each compile before the link was even issued
+  const bool shaders_ok = (m_vertex_shader_id == 0 || CheckShaderStatus(m_vertex_shader_id, vertex_shader)) &&
+                          (m_fragment_shader_id == 0 || CheckShaderStatus(m_fragment_shader_id, fragment_shader));
+  DeleteShaders();
+  if (!shaders_ok)
+  {
+    glDeleteProgram(m_program_id);
+    m_program_id = 0;
+    return false;
+  }
+
+  return CheckLinkStatus();
+}
+
+void Program::DeleteShaders()
+{
   if (m_vertex_shader_id != 0)
     glDeleteShader(m_vertex_shader_id);
   m_vertex_shader_id = 0;
   if (m_fragment_shader_id != 0)
     glDeleteShader(m_fragment_shader_id);
   m_fragment_shader_id = 0;
+}
 
+bool Program::CheckLinkStatus()
+{
   GLint status = GL_FALSE;
   glGetProgramiv(m_program_id, GL_LINK_STATUS, &status);
 
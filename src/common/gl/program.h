@@ -24,6 +24,10 @@ public:
 
   bool Compile(const std::string_view vertex_shader, const std::string_view fragment_shader);
 
+  /// Issues the shader compiles without waiting for the results, so the driver can work on several programs at once.
+  /// Must be followed by LinkAsync() and FinishLink(), which reports any compile errors.
+  void CompileAsync(const std::string_view vertex_shader, const std::string_view fragment_shader);
+
   bool CreateFromBinary(const void* data, u32 data_length, u32 data_format);
 
   bool GetBinary(std::vector<u8>* out_data, u32* out_data_format);
@@ -36,6 +40,8 @@ public:
   void BindFragDataIndexed(GLuint color_number = 0, const char* name = "o_col0");
 
   bool Link();
+  void LinkAsync();
+  bool FinishLink(const std::string_view vertex_shader, const std::string_view fragment_shader);
 
   void Bind() const;
 
@@ -92,6 +98,12 @@ public:
   Program& operator=(Program&& prog);
 
 private:
+  static GLuint CreateShader(GLenum type, const std::string_view source);
+  static bool CheckShaderStatus(GLuint id, const std::string_view source);
+
+  void DeleteShaders();
+  bool CheckLinkStatus();
+
   static u32 s_last_program_id;
 
   GLuint m_program_id = 0;
@@ -2,6 +2,7 @@
 // SPDX-License-Identifier: (GPL-3.0 OR CC-BY-NC-ND-4.0)
 
 #include "shader_cache.h"
+#include "../assert.h"
 #include "../file_system.h"
 #include "../log.h"
 #include "../md5_digest.h"
@@ -64,6 +65,12 @@ void GL::ShaderCache::Open(bool is_gles, std::string_view base_path, u32 version
     m_program_binary_supported = (num_formats > 0);
   }
 
+  // let the driver use as many threads as it likes for QueueProgram()
+  if (GLAD_GL_KHR_parallel_shader_compile)
+    glMaxShaderCompilerThreadsKHR(0xFFFFFFFFu);
+  else if (GLAD_GL_ARB_parallel_shader_compile)
+    glMaxShaderCompilerThreadsARB(0xFFFFFFFFu);
+
   if (!m_program_binary_supported)
   {
     Log_WarningPrintf("Your GL driver does not support program binaries. Hopefully it has a built-in cache, otherwise "
@@ -187,9 +194,15 @@ void GL::ShaderCache::Close()
 {
   m_index.clear();
   if (m_index_file)
+  {
     std::fclose(m_index_file);
+    m_index_file = nullptr;
+  }
   if (m_blob_file)
+  {
     std::fclose(m_blob_file);
+    m_blob_file = nullptr;
+  }
 }
 
 bool GL::ShaderCache::Recreate()
@@ -258,13 +271,9 @@ std::optional<GL::Program> GL::ShaderCache::GetProgram(const std::string_view ve
   if (iter == m_index.end())
     return CompileAndAddProgram(key, vertex_shader, fragment_shader, callback);
 
-  std::vector<u8> data(iter->second.blob_size);
-  if (std::fseek(m_blob_file, iter->second.file_offset, SEEK_SET) != 0 ||
-      std::fread(data.data(), 1, iter->second.blob_size, m_blob_file) != iter->second.blob_size)
-  {
-    Log_ErrorPrintf("Read blob from file failed");
+  std::vector<u8> data;
+  if (!ReadProgramBlob(iter->second, &data))
     return {};
-  }
 
   Program prog;
   if (prog.CreateFromBinary(data.data(), static_cast<u32>(data.size()), iter->second.blob_format))
@@ -278,6 +287,91 @@ std::optional<GL::Program> GL::ShaderCache::GetProgram(const std::string_view ve
     return CompileAndAddProgram(key, vertex_shader, fragment_shader, callback);
 }
 
+u32 GL::ShaderCache::QueueProgram(const std::string_view vertex_shader, const std::string_view fragment_shader,
+                                  const PreLinkCallback& callback)
+{
+  const u32 handle = static_cast<u32>(m_pending_programs.size());
+  PendingProgram& pp = m_pending_programs.emplace_back();
+  m_num_pending_programs++;
+
+  if (m_program_binary_supported && m_blob_file)
+  {
+    pp.key = GetCacheKey(vertex_shader, fragment_shader);
+
+    auto iter = m_index.find(pp.key);
+    if (iter != m_index.end())
+    {
+      std::vector<u8> data;
+      Program prog;
+      if (ReadProgramBlob(iter->second, &data) &&
+          prog.CreateFromBinary(data.data(), static_cast<u32>(data.size()), iter->second.blob_format))
+      {
+        pp.program = std::move(prog);
+        return handle;
+      }
+
+      Log_WarningPrintf(
+        "Failed to create program from binary, this may be due to a driver or GPU Change. Recreating cache.");
+      Recreate();
+    }
+
+    pp.add_to_cache = (m_blob_file != nullptr);
+  }
+
+  // hang on to the sources so FinishProgram() can dump them if they fail to compile
+  pp.vertex_shader = vertex_shader;
+  pp.fragment_shader = fragment_shader;
+  pp.linking = true;
+
+  Program prog;
+  prog.CompileAsync(vertex_shader, fragment_shader);
+
+  if (callback)
+    callback(prog);
+
+  if (pp.add_to_cache)
+    prog.SetBinaryRetrievableHint();
+
+  prog.LinkAsync();
+  pp.program = std::move(prog);
+  return handle;
+}
+
+std::optional<GL::Program> GL::ShaderCache::FinishProgram(u32 handle)
+{
+  DebugAssert(handle < m_pending_programs.size() && m_pending_programs[handle].program.has_value());
+
+  PendingProgram& pp = m_pending_programs[handle];
+  std::optional<Program> prog = std::move(pp.program);
+  pp.program.reset();
+
+  if (pp.linking)
+  {
+    if (!prog->FinishLink(pp.vertex_shader, pp.fragment_shader))
+      prog.reset();
+    else if (pp.add_to_cache)
+      AddProgramToCache(pp.key, prog.value());
+  }
+
+  if ((--m_num_pending_programs) == 0)
+    m_pending_programs.clear();
+
+  return prog;
+}
+
+bool GL::ShaderCache::ReadProgramBlob(const CacheIndexData& data, std::vector<u8>* out_data)
+{
+  out_data->resize(data.blob_size);
+  if (std::fseek(m_blob_file, data.file_offset, SEEK_SET) != 0 ||
+      std::fread(out_data->data(), 1, data.blob_size, m_blob_file) != data.blob_size)
+  {
+    Log_ErrorPrintf("Read blob from file failed");
+    return false;
+  }
+
+  return true;
+}
+
 std::optional<GL::Program> GL::ShaderCache::CompileProgram(const std::string_view& vertex_shader,
                                                            const std::string_view& fragment_shader,
                                                            const PreLinkCallback& callback, bool set_retrievable)
@@ -304,16 +398,21 @@ std::optional<GL::Program> GL::ShaderCache::CompileAndAddProgram(const CacheInde
                                                                  const PreLinkCallback& callback)
 {
   std::optional<Program> prog = CompileProgram(vertex_shader, fragment_shader, callback, true);
-  if (!prog)
-    return std::nullopt;
+  if (prog)
+    AddProgramToCache(key, prog.value());
+
+  return prog;
+}
 
+void GL::ShaderCache::AddProgramToCache(const CacheIndexKey& key, Program& prog)
+{
   std::vector<u8> prog_data;
   u32 prog_format = 0;
-  if (!prog->GetBinary(&prog_data, &prog_format))
-    return std::nullopt;
+  if (!prog.GetBinary(&prog_data, &prog_format))
+    return;
 
   if (!m_blob_file || std::fseek(m_blob_file, 0, SEEK_END) != 0)
-    return prog;
+    return;
 
   CacheIndexData data;
   data.file_offset = static_cast<u32>(std::ftell(m_blob_file));
@@ -336,9 +435,8 @@ std::optional<GL::Program> GL::ShaderCache::CompileAndAddProgram(const CacheInde
       std::fflush(m_index_file) != 0)
   {
     Log_ErrorPrintf("Failed to write shader blob to file");
-    return prog;
+    return;
   }
 
   m_index.emplace(key, data);
-  return prog;
 }
@@ -28,6 +28,15 @@ public:
   std::optional<Program> GetProgram(const std::string_view vertex_shader, const std::string_view fragment_shader,
                                     const PreLinkCallback& callback = {});
 
+  /// Starts building a program without waiting for the driver, and returns a handle to pass to FinishProgram().
+  /// Queueing every program up front lets drivers with KHR_parallel_shader_compile (or which defer compiles until
+  /// the status is queried) build them in parallel, instead of stalling on each one in turn.
+  u32 QueueProgram(const std::string_view vertex_shader, const std::string_view fragment_shader,
+                   const PreLinkCallback& callback = {});
+
+  /// Waits for a queued program to finish linking, adding it to the cache if it had to be compiled.
+  std::optional<Program> FinishProgram(u32 handle);
+
 private:
   static constexpr u32 FILE_VERSION = 4;
 
@@ -64,6 +73,16 @@ private:
 
   using CacheIndex = std::unordered_map<CacheIndexKey, CacheIndexData, CacheIndexEntryHasher>;
 
+  struct PendingProgram
+  {
+    CacheIndexKey key;
+    std::string vertex_shader;
+    std::string fragment_shader;
+    std::optional<Program> program;
+    bool linking = false;
+    bool add_to_cache = false;
+  };
+
   static CacheIndexKey GetCacheKey(const std::string_view& vertex_shader, const std::string_view& fragment_shader);
 
   std::string GetIndexFileName() const;
@@ -76,6 +95,8 @@ private:
 
   std::optional<Program> CompileProgram(const std::string_view& vertex_shader, const std::string_view& fragment_shader,
                                         const PreLinkCallback& callback, bool set_retrievable);
+  bool ReadProgramBlob(const CacheIndexData& data, std::vector<u8>* out_data);
+  void AddProgramToCache(const CacheIndexKey& key, Program& prog);
   std::optional<Program> CompileAndAddProgram(const CacheIndexKey& key, const std::string_view& vertex_shader,
                                               const std::string_view& fragment_shader, const PreLinkCallback& callback);
 
@@ -84,6 +105,8 @@ private:
   std::FILE* m_blob_file = nullptr;
 
   CacheIndex m_index;
+  std::vector<PendingProgram> m_pending_programs;
+  u32 m_num_pending_programs = 0;
   u32 m_version = 0;
   bool m_program_binary_supported = false;
 };
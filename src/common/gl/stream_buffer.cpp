@@ -4,8 +4,10 @@
 #include "stream_buffer.h"
 #include "../align.h"
 #include "../assert.h"
+#include "../timer.h"
 #include <array>
 #include <cstdio>
+#include <utility>
 
 namespace GL {
 
@@ -29,6 +31,11 @@ void StreamBuffer::Unbind()
   glBindBuffer(m_target, 0);
 }
 
+StreamBuffer::Stats StreamBuffer::GetAndResetStats()
+{
+  return std::exchange(m_stats, Stats{});
+}
+
 namespace detail {
 
 // Uses glBufferSubData() to update. Preferred for drivers which don't support {ARB,EXT}_buffer_storage.
@@ -165,7 +172,15 @@ protected:
 
   void WaitForSync(GLsync& sync)
   {
-    glClientWaitSync(sync, GL_SYNC_FLUSH_COMMANDS_BIT, GL_TIMEOUT_IGNORED);
+    // only count it if the GPU hasn't already finished with this block
+    if (glClientWaitSync(sync, GL_SYNC_FLUSH_COMMANDS_BIT, 0) == GL_TIMEOUT_EXPIRED)
+    {
+      Common::Timer timer;
+      glClientWaitSync(sync, 0, GL_TIMEOUT_IGNORED);
+      m_stats.num_waits++;
+      m_stats.wait_time_us += static_cast<u32>(timer.GetTimeNanoseconds() / 1000.0);
+    }
+
     glDeleteSync(sync);
     sync = nullptr;
   }
@@ -214,6 +229,67 @@ protected:
   std::array<GLsync, NUM_SYNC_POINTS> m_sync_objects{};
 };
 
+// Maps each allocation with GL_MAP_UNSYNCHRONIZED_BIT, relying on the fences to avoid overwriting data in use. For
+// drivers without {ARB,EXT}_buffer_storage, where it avoids reallocating the buffer with every update.
+class MapAndSyncStreamBuffer final : public SyncingStreamBuffer
+{
+public:
+  ~MapAndSyncStreamBuffer() override = default;
+
+  MappingResult Map(u32 alignment, u32 min_size) override
+  {
+    if (m_position > 0)
+      m_position = Common::AlignUp(m_position, alignment);
+
+    AllocateSpace(min_size);
+    DebugAssert((m_position + min_size) <= (m_available_block_index * m_bytes_per_block));
+
+    // the last block can extend past the end of the buffer, which the map can't
+    const u32 free_space_in_block = std::min(m_available_block_index * m_bytes_per_block, m_size) - m_position;
+    glBindBuffer(m_target, m_buffer_id);
+    void* mapped_ptr =
+      glMapBufferRange(m_target, m_position, free_space_in_block,
+                       GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT |
+                         GL_MAP_FLUSH_EXPLICIT_BIT);
+    Assert(mapped_ptr);
+
+    return MappingResult{mapped_ptr, m_position, m_position / alignment, free_space_in_block / alignment};
+  }
+
+  void Unmap(u32 used_size) override
+  {
+    DebugAssert((m_position + used_size) <= m_size);
+    glBindBuffer(m_target, m_buffer_id);
+    if (used_size > 0)
+      glFlushMappedBufferRange(m_target, 0, used_size);
+    glUnmapBuffer(m_target);
+
+    m_position += used_size;
+  }
+
+  static std::unique_ptr<StreamBuffer> Create(GLenum target, u32 size)
+  {
+    glGetError();
+
+    GLuint buffer_id;
+    glGenBuffers(1, &buffer_id);
+    glBindBuffer(target, buffer_id);
+    glBufferData(target, size, nullptr, GL_STREAM_DRAW);
+
+    GLenum err = glGetError();
+    if (err != GL_NO_ERROR)
+    {
+      glDeleteBuffers(1, &buffer_id);
+      return {};
+    }
+
+    return std::unique_ptr<StreamBuffer>(new MapAndSyncStreamBuffer(target, buffer_id, size));
+  }
+
+private:
+  MapAndSyncStreamBuffer(GLenum target, GLuint buffer_id, u32 size) : SyncingStreamBuffer(target, buffer_id, size) {}
+};
+
 class BufferStorageStreamBuffer : public SyncingStreamBuffer
 {
 public:
@@ -298,6 +374,13 @@ std::unique_ptr<StreamBuffer> StreamBuffer::Create(GLenum target, u32 size)
       return buf;
   }
 
+  if (GLAD_GL_VERSION_3_0 || GLAD_GL_ES_VERSION_3_0)
+  {
+    buf = detail::MapAndSyncStreamBuffer::Create(target, size);
+    if (buf)
+      return buf;
+  }
+
   // BufferSubData is slower on all drivers except NVIDIA...
 #if 0
   const char* vendor = reinterpret_cast<const char*>(glGetString(GL_VENDOR));
@@ -12,6 +12,13 @@ namespace GL {
 class StreamBuffer
 {
 public:
+  /// Time spent stalled waiting for the GPU to release space in the buffer.
+  struct Stats
+  {
+    u32 num_waits;
+    u32 wait_time_us;
+  };
+
   virtual ~StreamBuffer();
 
   ALWAYS_INLINE GLuint GetGLBufferId() const { return m_buffer_id; }
@@ -32,6 +39,8 @@ public:
   virtual MappingResult Map(u32 alignment, u32 min_size) = 0;
   virtual void Unmap(u32 used_size) = 0;
 
+  Stats GetAndResetStats();
+
   static std::unique_ptr<StreamBuffer> Create(GLenum target, u32 size);
 
 protected:
@@ -40,5 +49,6 @@ protected:
   GLenum m_target;
   GLuint m_buffer_id;
   u32 m_size;
+  Stats m_stats = {};
 };
 } // namespace GL
\ No newline at end of file
@@ -4,7 +4,6 @@
 #include "common/string_util.h"
 #include "common/timer.h"
 #include <algorithm>
-#include <functional>
 #include <pthread.h>
 #include <signal.h>
 Log_SetChannel(HTTPDownloaderCurl);
@@ -13,7 +12,20 @@ namespace Common {
 
 HTTPDownloaderCurl::HTTPDownloaderCurl() : HTTPDownloader() {}
 
-HTTPDownloaderCurl::~HTTPDownloaderCurl() = default;
+HTTPDownloaderCurl::~HTTPDownloaderCurl()
+{
+  std::unique_lock<std::mutex> lock(m_pending_http_request_lock);
+  for (HTTPDownloader::Request* request : m_pending_http_requests)
+  {
+    Request* req = static_cast<Request*>(request);
+    RemoveHandle(req);
+    delete req;
+  }
+  m_pending_http_requests.clear();
+
+  if (m_multi)
+    curl_multi_cleanup(m_multi);
+}
 
 std::unique_ptr<HTTPDownloader> HTTPDownloader::Create(const char* user_agent)
 {
@@ -48,8 +60,17 @@ bool HTTPDownloaderCurl::Initialize(const char* user_agent)
     }
   }
 
+  m_multi = curl_multi_init();
+  if (!m_multi)
+  {
+    Log_ErrorPrint("curl_multi_init() failed");
+    return false;
+  }
+
+  // Let requests to the same host share a single HTTP/2 connection where the server supports it.
+  curl_multi_setopt(m_multi, CURLMOPT_PIPELINING, CURLPIPE_MULTIPLEX);
+
   m_user_agent = user_agent;
-  m_thread_pool = std::make_unique<cb::ThreadPool>(m_max_active_requests);
   return true;
 }
 
@@ -64,14 +85,21 @@ size_t HTTPDownloaderCurl::WriteCallback(char* ptr, size_t size, size_t nmemb, v
   return nmemb;
 }
 
-void HTTPDownloaderCurl::ProcessRequest(Request* req)
+HTTPDownloader::Request* HTTPDownloaderCurl::InternalCreateRequest()
 {
-  std::unique_lock<std::mutex> cancel_lock(m_cancel_mutex);
-  if (req->closed.load())
-    return;
+  Request* req = new Request();
+  req->handle = curl_easy_init();
+  if (!req->handle)
+  {
+    delete req;
+    return nullptr;
+  }
 
-  cancel_lock.unlock();
+  return req;
+}
 
+void HTTPDownloaderCurl::InternalPollRequests()
+{
   // Apparently OpenSSL can fire SIGPIPE...
   sigset_t old_block_mask = {};
   sigset_t new_block_mask = {};
@@ -81,55 +109,52 @@ void HTTPDownloaderCurl::ProcessRequest(Request* req)
   if (pthread_sigmask(SIG_BLOCK, &new_block_mask, &old_block_mask) != 0)
     Log_WarningPrint("Failed to block SIGPIPE");
 
-  req->start_time = Common::Timer::GetCurrentValue();
-  int ret = curl_easy_perform(req->handle);
-  if (ret == CURLE_OK)
-  {
-    long response_code = 0;
-    curl_easy_getinfo(req->handle, CURLINFO_RESPONSE_CODE, &response_code);
-    req->status_code = static_cast<s32>(response_code);
+  int running_handles;
+  const CURLMcode err = curl_multi_perform(m_multi, &running_handles);
+  if (err != CURLM_OK)
+    Log_ErrorPrintf("curl_multi_perform() failed: %d", err);
 
-    char* content_type = nullptr;
-    if (!curl_easy_getinfo(req->handle, CURLINFO_CONTENT_TYPE, &content_type) && content_type)
-      req->content_type = content_type;
-
-    Log_DevPrintf("Request for '%s' returned status code %d and %zu bytes", req->url.c_str(), req->status_code,
-                  req->data.size());
-  }
-  else
+  CURLMsg* msg;
+  int msgs_in_queue;
+  while ((msg = curl_multi_info_read(m_multi, &msgs_in_queue)) != nullptr)
   {
-    Log_ErrorPrintf("Request for '%s' returned %d", req->url.c_str(), ret);
-  }
+    if (msg->msg != CURLMSG_DONE)
+      continue;
 
-  curl_easy_cleanup(req->handle);
+    Request* req = nullptr;
+    if (curl_easy_getinfo(msg->easy_handle, CURLINFO_PRIVATE, &req) != CURLE_OK || !req)
+    {
+      Log_ErrorPrint("Failed to get request for completed handle");
+      curl_multi_remove_handle(m_multi, msg->easy_handle);
+      continue;
+    }
 
-  if (pthread_sigmask(SIG_UNBLOCK, &new_block_mask, &old_block_mask) != 0)
-    Log_WarningPrint("Failed to unblock SIGPIPE");
+    if (msg->data.result == CURLE_OK)
+    {
+      long response_code = 0;
+      curl_easy_getinfo(req->handle, CURLINFO_RESPONSE_CODE, &response_code);
+      req->status_code = static_cast<s32>(response_code);
 
-  cancel_lock.lock();
-  req->state = Request::State::Complete;
-  if (req->closed.load())
-    delete req;
-  else
-    req->closed.store(true);
-}
+      char* content_type = nullptr;
+      if (!curl_easy_getinfo(req->handle, CURLINFO_CONTENT_TYPE, &content_type) && content_type)
+        req->content_type = content_type;
 
-HTTPDownloader::Request* HTTPDownloaderCurl::InternalCreateRequest()
-{
-  Request* req = new Request();
-  req->handle = curl_easy_init();
-  if (!req->handle)
-  {
-    delete req;
-    return nullptr;
-  }
+      Log_DevPrintf("Request for '%s' returned status code %d and %zu bytes", req->url.c_str(), req->status_code,
+                    req->data.size());
+    }
+    else
+    {
+      Log_ErrorPrintf("Request for '%s' returned %d", req->url.c_str(), msg->data.result);
+      req->status_code = -1;
+    }
 
-  return req;
-}
+    // msg is invalidated by removing the handle.
+    RemoveHandle(req);
+    req->state.store(Request::State::Complete);
+  }
 
-void HTTPDownloaderCurl::InternalPollRequests()
-{
-  // noop - uses thread pool
+  if (pthread_sigmask(SIG_UNBLOCK, &new_block_mask, &old_block_mask) != 0)
+    Log_WarningPrint("Failed to unblock SIGPIPE");
 }
 
 bool HTTPDownloaderCurl::StartRequest(HTTPDownloader::Request* request)
@@ -140,6 +165,9 @@ bool HTTPDownloaderCurl::StartRequest(HTTPDownloader::Request* request)
   curl_easy_setopt(req->handle, CURLOPT_WRITEFUNCTION, &HTTPDownloaderCurl::WriteCallback);
   curl_easy_setopt(req->handle, CURLOPT_WRITEDATA, req);
   curl_easy_setopt(req->handle, CURLOPT_NOSIGNAL, 1);
+  curl_easy_setopt(req->handle, CURLOPT_PRIVATE, req);
+  curl_easy_setopt(req->handle, CURLOPT_HTTP_VERSION, CURL_HTTP_VERSION_2TLS);
+  curl_easy_setopt(req->handle, CURLOPT_PIPEWAIT, 1L);
 
   if (request->type == Request::Type::Post)
   {
@@ -147,21 +175,43 @@ bool HTTPDownloaderCurl::StartRequest(HTTPDownloader::Request* request)
     curl_easy_setopt(req->handle, CURLOPT_POSTFIELDS, request->post_data.c_str());
   }
 
+  const CURLMcode err = curl_multi_add_handle(m_multi, req->handle);
+  if (err != CURLM_OK)
+  {
+    Log_ErrorPrintf("curl_multi_add_handle() for '%s' failed: %d", req->url.c_str(), err);
+    req->callback(-1, std::string(), Request::Data());
+    curl_easy_cleanup(req->handle);
+    delete req;
+    return false;
+  }
+
   Log_DevPrintf("Started HTTP request for '%s'", req->url.c_str());
   req->state = Request::State::Started;
   req->start_time = Common::Timer::GetCurrentValue();
-  m_thread_pool->Schedule(std::bind(&HTTPDownloaderCurl::ProcessRequest, this, req));
   return true;
 }
 
 void HTTPDownloaderCurl::CloseRequest(HTTPDownloader::Request* request)
 {
-  std::unique_lock<std::mutex> cancel_lock(m_cancel_mutex);
+  // Timed out requests are still attached to the multi handle.
   Request* req = static_cast<Request*>(request);
-  if (req->closed.load())
-    delete req;
-  else
-    req->closed.store(true);
+  if (req->handle)
+  {
+    std::unique_lock<std::mutex> lock(m_pending_http_request_lock);
+    RemoveHandle(req);
+  }
+
+  delete req;
+}
+
+void HTTPDownloaderCurl::RemoveHandle(Request* req)
+{
+  if (!req->handle)
+    return;
+
+  curl_multi_remove_handle(m_multi, req->handle);
+  curl_easy_cleanup(req->handle);
+  req->handle = nullptr;
 }
 
 } // namespace Common
@@ -1,9 +1,6 @@
 #pragma once
 #include "http_downloader.h"
-#include "common/thirdparty/thread_pool.h"
-#include <atomic>
 #include <memory>
-#include <mutex>
 #include <curl/curl.h>
 
 namespace Common {
@@ -26,15 +23,15 @@ private:
   struct Request : HTTPDownloader::Request
   {
     CURL* handle = nullptr;
-    std::atomic_bool closed{false};
   };
 
   static size_t WriteCallback(char* ptr, size_t size, size_t nmemb, void* userdata);
-  void ProcessRequest(Request* req);
+  void RemoveHandle(Request* req);
 
+  // All transfers share a single multi handle, so connections (and HTTP/2 streams) are reused across requests.
+  // Only touched with m_pending_http_request_lock held.
+  CURLM* m_multi = nullptr;
   std::string m_user_agent;
-  std::unique_ptr<cb::ThreadPool> m_thread_pool;
-  std::mutex m_cancel_mutex;
 };
 
 } // namespace FrontendCommon
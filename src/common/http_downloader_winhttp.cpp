@@ -48,6 +48,13 @@ bool HTTPDownloaderWinHttp::Initialize(const char* user_agent)
     return false;
   }
 
+#ifdef WINHTTP_PROTOCOL_FLAG_HTTP2
+  // Requests to the same host are multiplexed over one connection when HTTP/2 is available (Win10 1607+).
+  DWORD http_protocols = WINHTTP_PROTOCOL_FLAG_HTTP2;
+  if (!WinHttpSetOption(m_hSession, WINHTTP_OPTION_ENABLE_HTTP_PROTOCOL, &http_protocols, sizeof(http_protocols)))
+    Log_WarningPrintf("Failed to enable HTTP/2: %u", GetLastError());
+#endif
+
   const DWORD notification_flags = WINHTTP_CALLBACK_FLAG_ALL_COMPLETIONS | WINHTTP_CALLBACK_FLAG_REQUEST_ERROR |
                                    WINHTTP_CALLBACK_FLAG_HANDLES | WINHTTP_CALLBACK_FLAG_SECURE_FAILURE;
   if (WinHttpSetStatusCallback(m_hSession, HTTPStatusCallback, notification_flags, NULL) ==
@@ -3,6 +3,10 @@
 
 #include "layered_settings_interface.h"
 #include "common/assert.h"
+#include "common/hash_combine.h"
+#include "common/string_util.h"
+#include <string_view>
+#include <type_traits>
 #include <unordered_set>
 
 LayeredSettingsInterface::LayeredSettingsInterface() = default;
@@ -20,88 +24,127 @@ void LayeredSettingsInterface::Clear()
   Panic("Attempting to clear layered settings interface");
 }
 
-bool LayeredSettingsInterface::GetIntValue(const char* section, const char* key, s32* value) const
+const LayeredSettingsInterface::CachedValue* LayeredSettingsInterface::LookupCachedValue(const char* section,
+                                                                                        const char* key) const
 {
   for (u32 layer = FIRST_LAYER; layer <= LAST_LAYER; layer++)
   {
-    if (SettingsInterface* sif = m_layers[layer]; sif != nullptr)
+    const u32 counter = m_layers[layer] ? m_layers[layer]->GetChangeCounter() : 0;
+    if (m_cache_change_counters[layer] != counter)
     {
-      if (sif->GetIntValue(section, key, value))
-        return true;
+      m_cache_change_counters[layer] = counter;
+      m_cache.clear();
     }
   }
 
-  return false;
-}
+  std::size_t hash = 0;
+  hash_combine(hash, std::string_view(section), std::string_view(key));
 
-bool LayeredSettingsInterface::GetUIntValue(const char* section, const char* key, u32* value) const
-{
+  if (const auto it = m_cache.find(hash); it != m_cache.end())
+  {
+    // On a hash collision, skip the cache and let the caller go through the layers.
+    return (it->second.section == section && it->second.key == key) ? &it->second : nullptr;
+  }
+
+  CachedValue cv;
+  cv.section = section;
+  cv.key = key;
+  cv.layer = NUM_LAYERS;
   for (u32 layer = FIRST_LAYER; layer <= LAST_LAYER; layer++)
   {
-    if (SettingsInterface* sif = m_layers[layer]; sif != nullptr)
+    if (SettingsInterface* sif = m_layers[layer]; sif != nullptr && sif->GetStringValue(section, key, &cv.value))
     {
-      if (sif->GetUIntValue(section, key, value))
-        return true;
+      cv.layer = layer;
+      break;
     }
   }
 
-  return false;
+  return &m_cache.emplace(hash, std::move(cv)).first->second;
 }
 
-bool LayeredSettingsInterface::GetFloatValue(const char* section, const char* key, float* value) const
+template<typename T>
+bool LayeredSettingsInterface::GetValue(const char* section, const char* key, T* value) const
 {
-  for (u32 layer = FIRST_LAYER; layer <= LAST_LAYER; layer++)
+  u32 first_layer = FIRST_LAYER;
+  if (const CachedValue* cv = LookupCachedValue(section, key); cv)
   {
-    if (SettingsInterface* sif = m_layers[layer]; sif != nullptr)
+    if (cv->layer == NUM_LAYERS)
+      return false;
+
+    if constexpr (std::is_same_v<T, std::string>)
+    {
+      *value = cv->value;
+      return true;
+    }
+    else
     {
-      if (sif->GetFloatValue(section, key, value))
+      // Every layer parses its strings the same way, so this matches asking the layer itself.
+      if (std::optional<T> parsed = StringUtil::FromChars<T>(cv->value); parsed.has_value())
+      {
+        *value = parsed.value();
         return true;
+      }
+
+      // Not valid for this type, a lower layer might still have something usable.
+      first_layer = cv->layer + 1;
     }
   }
 
+  for (u32 layer = first_layer; layer <= LAST_LAYER; layer++)
+  {
+    SettingsInterface* sif = m_layers[layer];
+    if (!sif)
+      continue;
+
+    bool result;
+    if constexpr (std::is_same_v<T, s32>)
+      result = sif->GetIntValue(section, key, value);
+    else if constexpr (std::is_same_v<T, u32>)
+      result = sif->GetUIntValue(section, key, value);
+    else if constexpr (std::is_same_v<T, float>)
+      result = sif->GetFloatValue(section, key, value);
+    else if constexpr (std::is_same_v<T, double>)
+      result = sif->GetDoubleValue(section, key, value);
+    else if constexpr (std::is_same_v<T, bool>)
+      result = sif->GetBoolValue(section, key, value);
+    else
+      result = sif->GetStringValue(section, key, value);
+
+    if (result)
+      return true;
+  }
+
   return false;
 }
 
-bool LayeredSettingsInterface::GetDoubleValue(const char* section, const char* key, double* value) const
+bool LayeredSettingsInterface::GetIntValue(const char* section, const char* key, s32* value) const
 {
-  for (u32 layer = FIRST_LAYER; layer <= LAST_LAYER; layer++)
-  {
-    if (SettingsInterface* sif = m_layers[layer]; sif != nullptr)
-    {
-      if (sif->GetDoubleValue(section, key, value))
-        return true;
-    }
-  }
+  return GetValue(section, key, value);
+}
 
-  return false;
+bool LayeredSettingsInterface::GetUIntValue(const char* section, const char* key, u32* value) const
+{
+  return GetValue(section, key, value);
 }
 
-bool LayeredSettingsInterface::GetBoolValue(const char* section, const char* key, bool* value) const
+bool LayeredSettingsInterface::GetFloatValue(const char* section, const char* key, float* value) const
 {
-  for (u32 layer = FIRST_LAYER; layer <= LAST_LAYER; layer++)
-  {
-    if (SettingsInterface* sif = m_layers[layer]; sif != nullptr)
-    {
-      if (sif->GetBoolValue(section, key, value))
-        return true;
-    }
-  }
+  return GetValue(section, key, value);
+}
 
-  return false;
+bool LayeredSettingsInterface::GetDoubleValue(const char* section, const char* key, double* value) const
+{
+  return GetValue(section, key, value);
 }
 
-bool LayeredSettingsInterface::GetStringValue(const char* section, const char* key, std::string* value) const
+bool LayeredSettingsInterface::GetBoolValue(const char* section, const char* key, bool* value) const
 {
-  for (u32 layer = FIRST_LAYER; layer <= LAST_LAYER; layer++)
-  {
-    if (SettingsInterface* sif = m_layers[layer]; sif != nullptr)
-    {
-      if (sif->GetStringValue(section, key, value))
-        return true;
-    }
-  }
+  return GetValue(section, key, value);
+}
 
-  return false;
+bool LayeredSettingsInterface::GetStringValue(const char* section, const char* key, std::string* value) const
+{
+  return GetValue(section, key, value);
 }
 
 void LayeredSettingsInterface::SetIntValue(const char* section, const char* key, int value)
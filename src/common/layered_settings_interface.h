@@ -4,6 +4,7 @@
 #pragma once
 #include "settings_interface.h"
 #include <array>
+#include <unordered_map>
 
 class LayeredSettingsInterface final : public SettingsInterface
 {
@@ -21,7 +22,11 @@ public:
   ~LayeredSettingsInterface() override;
 
   SettingsInterface* GetLayer(Layer layer) const { return m_layers[layer]; }
-  void SetLayer(Layer layer, SettingsInterface* sif) { m_layers[layer] = sif; }
+  void SetLayer(Layer layer, SettingsInterface* sif)
+  {
+    m_layers[layer] = sif;
+    m_cache.clear();
+  }
 
   bool Save() override;
 
@@ -64,5 +69,23 @@ private:
   static constexpr Layer FIRST_LAYER = LAYER_CMDLINE;
   static constexpr Layer LAST_LAYER = LAYER_BASE;
 
+  /// Value from the highest layer which has the key, or NUM_LAYERS if none do.
+  struct CachedValue
+  {
+    std::string section;
+    std::string key;
+    std::string value;
+    u32 layer;
+  };
+
+  const CachedValue* LookupCachedValue(const char* section, const char* key) const;
+
+  template<typename T>
+  bool GetValue(const char* section, const char* key, T* value) const;
+
   std::array<SettingsInterface*, NUM_LAYERS> m_layers{};
+
+  // Flattened view of the layers, keyed by a hash of the section and key. Thrown away whenever a layer changes.
+  mutable std::unordered_map<std::size_t, CachedValue> m_cache;
+  mutable std::array<u32, NUM_LAYERS> m_cache_change_counters{};
 };
\ No newline at end of file
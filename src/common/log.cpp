@@ -3,10 +3,17 @@
 
 #include "log.h"
 #include "assert.h"
+#include "align.h"
 #include "file_system.h"
 #include "string.h"
+#include "threading.h"
 #include "timer.h"
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
 #include <cstdio>
+#include <cstring>
+#include <memory>
 #include <mutex>
 #include <vector>
 
@@ -28,6 +35,49 @@ struct RegisteredCallback
   void* Parameter;
 };
 
+namespace {
+struct AsyncRecordHeader
+{
+  u32 size;
+  u32 level;
+  u32 channel_length;
+  u32 function_length;
+  u32 message_length;
+  u32 pad;
+  Common::Timer::Value timestamp;
+};
+
+// Written by a single thread, and read by whichever thread is draining the buffers. Records are 8 byte aligned, and
+// a wrap marker is written when a record won't fit before the end of the buffer.
+struct AsyncRing
+{
+  static constexpr u32 SIZE = 256 * 1024;
+  static constexpr u32 MAX_RECORD_SIZE = SIZE / 4;
+  static constexpr u32 WRAP_MARKER = 0xFFFFFFFFu;
+
+  std::unique_ptr<u8[]> data;
+  std::atomic<u64> read_pos{0};
+  std::atomic<u64> write_pos{0};
+  bool orphaned = false;
+};
+
+struct AsyncThreadState
+{
+  ~AsyncThreadState();
+
+  AsyncRing* ring = nullptr;
+};
+
+struct AsyncCursor
+{
+  AsyncRing* ring;
+  u64 pos;
+  u64 end;
+};
+} // namespace
+
+std::atomic<u32> Detail::g_filter_generation{1};
+
 std::vector<RegisteredCallback> s_callbacks;
 static std::mutex s_callback_mutex;
 
@@ -35,6 +85,20 @@ static LOGLEVEL s_filter_level = LOGLEVEL_TRACE;
 
 static Common::Timer::Value s_startTimeStamp = Common::Timer::GetCurrentValue();
 
+// time the message being passed to the callbacks was written, which can be earlier than now with async output
+static thread_local Common::Timer::Value s_message_timestamp = 0;
+
+static std::atomic_bool s_async_output_enabled{false};
+static std::mutex s_async_rings_mutex;
+static std::vector<std::unique_ptr<AsyncRing>> s_async_rings;
+static std::vector<AsyncCursor> s_async_cursors;
+static thread_local AsyncThreadState s_async_thread_state;
+
+static Threading::Thread s_async_thread;
+static std::mutex s_async_thread_mutex;
+static std::condition_variable s_async_thread_cv;
+static bool s_async_thread_shutdown = false;
+
 static bool s_console_output_enabled = false;
 static String s_console_output_channel_filter;
 static LOGLEVEL s_console_output_level_filter = LOGLEVEL_TRACE;
@@ -60,6 +124,59 @@ std::unique_ptr<std::FILE, void (*)(std::FILE*)> s_fileOutputHandle(nullptr, [](
   }
 });
 
+static void ConsoleOutputLogCallback(void* pUserParam, const char* channelName, const char* functionName,
+                                     LOGLEVEL level, const char* message);
+static void DebugOutputLogCallback(void* pUserParam, const char* channelName, const char* functionName, LOGLEVEL level,
+                                   const char* message);
+static void FileOutputLogCallback(void* pUserParam, const char* channelName, const char* functionName, LOGLEVEL level,
+                                  const char* message);
+
+static void InvalidateChannels()
+{
+  Detail::g_filter_generation.fetch_add(1, std::memory_order_release);
+}
+
+bool Detail::UpdateChannel(Channel& channel, LOGLEVEL level)
+{
+  // Read the generation first, if the filters change while we're looking at them it'll be updated again next time.
+  const u32 generation = g_filter_generation.load(std::memory_order_acquire);
+
+  LOGLEVEL max_level = LOGLEVEL_NONE;
+  {
+    std::lock_guard<std::mutex> guard(s_callback_mutex);
+    for (const RegisteredCallback& callback : s_callbacks)
+    {
+      LOGLEVEL callback_level;
+      if (callback.Function == ConsoleOutputLogCallback)
+      {
+        callback_level =
+          (s_console_output_channel_filter.Find(channel.name) >= 0) ? LOGLEVEL_NONE : s_console_output_level_filter;
+      }
+      else if (callback.Function == FileOutputLogCallback)
+      {
+        callback_level =
+          (s_file_output_channel_filter.Find(channel.name) >= 0) ? LOGLEVEL_NONE : s_file_output_level_filter;
+      }
+      else if (callback.Function == DebugOutputLogCallback)
+      {
+        // filtered by function name, so that has to be done per message
+        callback_level = s_debug_output_level_filter;
+      }
+      else
+      {
+        // no idea what other callbacks want, so they get everything
+        callback_level = LOGLEVEL_TRACE;
+      }
+
+      max_level = std::max(max_level, callback_level);
+    }
+  }
+
+  max_level = std::min(max_level, s_filter_level);
+  channel.state.store((generation << 4) | static_cast<u32>(max_level), std::memory_order_relaxed);
+  return (level <= max_level);
+}
+
 void RegisterCallback(CallbackFunctionType callbackFunction, void* pUserParam)
 {
   RegisteredCallback Callback;
@@ -68,6 +185,7 @@ void RegisterCallback(CallbackFunctionType callbackFunction, void* pUserParam)
 
   std::lock_guard<std::mutex> guard(s_callback_mutex);
   s_callbacks.push_back(std::move(Callback));
+  InvalidateChannels();
 }
 
 void UnregisterCallback(CallbackFunctionType callbackFunction, void* pUserParam)
@@ -79,6 +197,7 @@ void UnregisterCallback(CallbackFunctionType callbackFunction, void* pUserParam)
     if (iter->Function == callbackFunction && iter->Parameter == pUserParam)
     {
       s_callbacks.erase(iter);
+      InvalidateChannels();
       break;
     }
   }
@@ -94,9 +213,11 @@ bool IsDebugOutputEnabled()
   return s_debug_output_enabled;
 }
 
-static void ExecuteCallbacks(const char* channelName, const char* functionName, LOGLEVEL level, const char* message)
+static void ExecuteCallbacks(const char* channelName, const char* functionName, LOGLEVEL level, const char* message,
+                             Common::Timer::Value timestamp)
 {
   std::lock_guard<std::mutex> guard(s_callback_mutex);
+  s_message_timestamp = timestamp;
   for (RegisteredCallback& callback : s_callbacks)
     callback.Function(callback.Parameter, channelName, functionName, level, message);
 }
@@ -126,7 +247,7 @@ static int FormatLogMessageForDisplay(char* buffer, size_t buffer_size, const ch
   {
     // find time since start of process
     const float message_time =
-      static_cast<float>(Common::Timer::ConvertValueToSeconds(Common::Timer::GetCurrentValue() - s_startTimeStamp));
+      static_cast<float>(Common::Timer::ConvertValueToSeconds(s_message_timestamp - s_startTimeStamp));
 
     if (level <= LOGLEVEL_PERF)
     {
@@ -297,6 +418,7 @@ void SetConsoleOutputParams(bool Enabled, const char* ChannelFilter, LOGLEVEL Le
 {
   s_console_output_channel_filter = (ChannelFilter != NULL) ? ChannelFilter : "";
   s_console_output_level_filter = LevelFilter;
+  InvalidateChannels();
 
   if (s_console_output_enabled == Enabled)
     return;
@@ -387,6 +509,7 @@ void SetDebugOutputParams(bool enabled, const char* channelFilter /* = nullptr *
 
   s_debug_output_channel_filter = (channelFilter != nullptr) ? channelFilter : "";
   s_debug_output_level_filter = levelFilter;
+  InvalidateChannels();
 }
 
 static void FileOutputLogCallback(void* pUserParam, const char* channelName, const char* functionName, LOGLEVEL level,
@@ -418,6 +541,8 @@ void SetFileOutputParams(bool enabled, const char* filename, bool timestamps /*
     }
     else
     {
+      // anything still queued for the file needs to be written before it's closed
+      Flush();
       UnregisterCallback(FileOutputLogCallback, nullptr);
       s_fileOutputHandle.reset();
     }
@@ -429,12 +554,230 @@ void SetFileOutputParams(bool enabled, const char* filename, bool timestamps /*
   s_file_output_channel_filter = (channelFilter != nullptr) ? channelFilter : "";
   s_file_output_level_filter = levelFilter;
   s_file_output_timestamp = timestamps;
+  InvalidateChannels();
 }
 
 void SetFilterLevel(LOGLEVEL level)
 {
   DebugAssert(level < LOGLEVEL_COUNT);
   s_filter_level = level;
+  InvalidateChannels();
+}
+
+AsyncThreadState::~AsyncThreadState()
+{
+  if (!ring)
+    return;
+
+  // The output thread frees the buffer once everything in it has been written.
+  std::lock_guard<std::mutex> guard(s_async_rings_mutex);
+  ring->orphaned = true;
+}
+
+static AsyncRing* AllocateAsyncRing()
+{
+  std::unique_ptr<AsyncRing> ring = std::make_unique<AsyncRing>();
+  ring->data = std::make_unique<u8[]>(AsyncRing::SIZE);
+  s_async_thread_state.ring = ring.get();
+
+  std::lock_guard<std::mutex> guard(s_async_rings_mutex);
+  return s_async_rings.emplace_back(std::move(ring)).get();
+}
+
+static const AsyncRecordHeader* PeekAsyncRecord(AsyncCursor& cursor)
+{
+  while (cursor.pos != cursor.end)
+  {
+    const u32 offset = static_cast<u32>(cursor.pos % AsyncRing::SIZE);
+    const AsyncRecordHeader* header = reinterpret_cast<const AsyncRecordHeader*>(cursor.ring->data.get() + offset);
+    if (header->size != AsyncRing::WRAP_MARKER)
+      return header;
+
+    cursor.pos += AsyncRing::SIZE - offset;
+  }
+
+  return nullptr;
+}
+
+static void DrainAsyncOutput()
+{
+  std::lock_guard<std::mutex> guard(s_async_rings_mutex);
+
+  // Messages are written in timestamp order across all threads, up to where each thread was when we started.
+  s_async_cursors.clear();
+  for (const std::unique_ptr<AsyncRing>& ring : s_async_rings)
+  {
+    s_async_cursors.push_back(AsyncCursor{ring.get(), ring->read_pos.load(std::memory_order_relaxed),
+                                          ring->write_pos.load(std::memory_order_acquire)});
+  }
+
+  for (;;)
+  {
+    AsyncCursor* next_cursor = nullptr;
+    const AsyncRecordHeader* next_header = nullptr;
+    for (AsyncCursor& cursor : s_async_cursors)
+    {
+      const AsyncRecordHeader* header = PeekAsyncRecord(cursor);
+      if (header && (!next_header || header->timestamp < next_header->timestamp))
+      {
+        next_cursor = &cursor;
+        next_header = header;
+      }
+    }
+    if (!next_header)
+      break;
+
+    const char* channel_name = reinterpret_cast<const char*>(next_header + 1);
+    const char* function_name = channel_name + next_header->channel_length + 1;
+    const char* message = function_name + next_header->function_length + 1;
+    ExecuteCallbacks(channel_name, function_name, static_cast<LOGLEVEL>(next_header->level), message,
+                     next_header->timestamp);
+
+    // release the space straight away, so the writer isn't waiting on everything else
+    next_cursor->pos += next_header->size;
+    next_cursor->ring->read_pos.store(next_cursor->pos, std::memory_order_release);
+  }
+
+  for (const AsyncCursor& cursor : s_async_cursors)
+    cursor.ring->read_pos.store(cursor.pos, std::memory_order_release);
+
+  for (auto iter = s_async_rings.begin(); iter != s_async_rings.end();)
+  {
+    AsyncRing* ring = iter->get();
+    if (ring->orphaned && ring->read_pos.load(std::memory_order_relaxed) ==
+                            ring->write_pos.load(std::memory_order_acquire))
+    {
+      iter = s_async_rings.erase(iter);
+    }
+    else
+    {
+      ++iter;
+    }
+  }
+}
+
+static void QueueAsyncMessage(const char* channelName, const char* functionName, LOGLEVEL level, const char* message,
+                              Common::Timer::Value timestamp)
+{
+  AsyncRing* ring = s_async_thread_state.ring;
+  if (!ring)
+    ring = AllocateAsyncRing();
+
+  const u32 channel_length = static_cast<u32>(std::strlen(channelName));
+  const u32 function_length = static_cast<u32>(std::strlen(functionName));
+  const u32 fixed_size = static_cast<u32>(sizeof(AsyncRecordHeader)) + channel_length + function_length + 3;
+  if (fixed_size >= AsyncRing::MAX_RECORD_SIZE)
+    return;
+
+  // really long messages get truncated, they have to fit in the buffer
+  const u32 message_length =
+    std::min(static_cast<u32>(std::strlen(message)), AsyncRing::MAX_RECORD_SIZE - fixed_size);
+  const u32 size = Common::AlignUpPow2(fixed_size + message_length, 8);
+
+  const u64 write_pos = ring->write_pos.load(std::memory_order_relaxed);
+  u32 offset = static_cast<u32>(write_pos % AsyncRing::SIZE);
+  const u32 skip = ((AsyncRing::SIZE - offset) < size) ? (AsyncRing::SIZE - offset) : 0;
+  const u64 new_write_pos = write_pos + skip + size;
+  if ((new_write_pos - ring->read_pos.load(std::memory_order_acquire)) > AsyncRing::SIZE)
+  {
+    // The output thread has fallen behind, write everything out on this thread instead of dropping messages.
+    DrainAsyncOutput();
+  }
+
+  u8* data = ring->data.get();
+  if (skip > 0)
+  {
+    const u32 marker = AsyncRing::WRAP_MARKER;
+    std::memcpy(data + offset, &marker, sizeof(marker));
+    offset = 0;
+  }
+
+  AsyncRecordHeader header;
+  header.size = size;
+  header.level = static_cast<u32>(level);
+  header.channel_length = channel_length;
+  header.function_length = function_length;
+  header.message_length = message_length;
+  header.pad = 0;
+  header.timestamp = timestamp;
+
+  u8* ptr = data + offset;
+  std::memcpy(ptr, &header, sizeof(header));
+  ptr += sizeof(header);
+  std::memcpy(ptr, channelName, channel_length + 1);
+  ptr += channel_length + 1;
+  std::memcpy(ptr, functionName, function_length + 1);
+  ptr += function_length + 1;
+  std::memcpy(ptr, message, message_length);
+  ptr[message_length] = '\0';
+
+  ring->write_pos.store(new_write_pos, std::memory_order_release);
+
+  // wake the output thread early if the buffer is getting full
+  if ((new_write_pos - ring->read_pos.load(std::memory_order_relaxed)) > (AsyncRing::SIZE / 2))
+    s_async_thread_cv.notify_one();
+}
+
+static void AsyncOutputThreadEntryPoint()
+{
+  Threading::SetNameOfCurrentThread("Log Output Thread");
+
+  std::unique_lock<std::mutex> lock(s_async_thread_mutex);
+  while (!s_async_thread_shutdown)
+  {
+    s_async_thread_cv.wait_for(lock, std::chrono::milliseconds(10));
+
+    lock.unlock();
+    DrainAsyncOutput();
+    lock.lock();
+  }
+}
+
+bool IsAsyncOutputEnabled()
+{
+  return s_async_output_enabled.load(std::memory_order_relaxed);
+}
+
+void SetAsyncOutput(bool enabled)
+{
+  if (s_async_output_enabled.load(std::memory_order_relaxed) == enabled)
+    return;
+
+  if (enabled)
+  {
+    s_async_thread_shutdown = false;
+    if (!s_async_thread.Start(AsyncOutputThreadEntryPoint))
+    {
+      Log::Write("Log", __FUNCTION__, LOGLEVEL_ERROR, "Failed to start log output thread");
+      return;
+    }
+
+    s_async_output_enabled.store(true, std::memory_order_release);
+  }
+  else
+  {
+    s_async_output_enabled.store(false, std::memory_order_release);
+    {
+      std::lock_guard<std::mutex> guard(s_async_thread_mutex);
+      s_async_thread_shutdown = true;
+      s_async_thread_cv.notify_one();
+    }
+    s_async_thread.Join();
+    DrainAsyncOutput();
+  }
+}
+
+void Flush()
+{
+  DrainAsyncOutput();
+}
+
+static void OutputMessage(const char* channelName, const char* functionName, LOGLEVEL level, const char* message)
+{
+  if (s_async_output_enabled.load(std::memory_order_relaxed))
+    QueueAsyncMessage(channelName, functionName, level, message, Common::Timer::GetCurrentValue());
+  else
+    ExecuteCallbacks(channelName, functionName, level, message, Common::Timer::GetCurrentValue());
 }
 
 void Write(const char* channelName, const char* functionName, LOGLEVEL level, const char* message)
@@ -442,7 +785,7 @@ void Write(const char* channelName, const char* functionName, LOGLEVEL level, co
   if (level > s_filter_level)
     return;
 
-  ExecuteCallbacks(channelName, functionName, level, message);
+  OutputMessage(channelName, functionName, level, message);
 }
 
 void Writef(const char* channelName, const char* functionName, LOGLEVEL level, const char* format, ...)
@@ -475,13 +818,13 @@ void Writev(const char* channelName, const char* functionName, LOGLEVEL level, c
   {
     char buffer[256];
     std::vsnprintf(buffer, countof(buffer), format, ap);
-    ExecuteCallbacks(channelName, functionName, level, buffer);
+    OutputMessage(channelName, functionName, level, buffer);
   }
   else
   {
     char* buffer = new char[requiredSize + 1];
     std::vsnprintf(buffer, requiredSize + 1, format, ap);
-    ExecuteCallbacks(channelName, functionName, level, buffer);
+    OutputMessage(channelName, functionName, level, buffer);
     delete[] buffer;
   }
 }
@@ -3,6 +3,7 @@
 
 #pragma once
 #include "types.h"
+#include <atomic>
 #include <cinttypes>
 #include <cstdarg>
 #include <mutex>
@@ -23,6 +24,28 @@ enum LOGLEVEL
 };
 
 namespace Log {
+// per-channel state, which caches the highest level any of the sinks will accept
+struct Channel
+{
+  const char* name;
+  std::atomic<u32> state; // generation << 4 | level
+};
+
+namespace Detail {
+extern std::atomic<u32> g_filter_generation;
+bool UpdateChannel(Channel& channel, LOGLEVEL level);
+} // namespace Detail
+
+// returns true if a message at this level would be written anywhere, so disabled messages are never formatted
+ALWAYS_INLINE static bool IsChannelEnabled(Channel& channel, LOGLEVEL level)
+{
+  const u32 state = channel.state.load(std::memory_order_relaxed);
+  if ((state >> 4) != Detail::g_filter_generation.load(std::memory_order_relaxed))
+    return Detail::UpdateChannel(channel, level);
+
+  return (static_cast<u32>(level) <= (state & 0xFu));
+}
+
 // log message callback type
 using CallbackFunctionType = void (*)(void* pUserParam, const char* channelName, const char* functionName,
                                       LOGLEVEL level, const char* message);
@@ -48,6 +71,14 @@ void SetFileOutputParams(bool enabled, const char* filename, bool timestamps = t
 // Sets global filtering level, messages below this level won't be sent to any of the logging sinks.
 void SetFilterLevel(LOGLEVEL level);
 
+// Moves output to a separate thread. Messages are copied to a per-thread buffer without taking any locks, and the
+// callbacks are run on the output thread instead of the thread which wrote the message.
+bool IsAsyncOutputEnabled();
+void SetAsyncOutput(bool enabled);
+
+// Writes out any messages which are waiting for the output thread.
+void Flush();
+
 // writes a message to the log
 void Write(const char* channelName, const char* functionName, LOGLEVEL level, const char* message);
 void Writef(const char* channelName, const char* functionName, LOGLEVEL level, const char* format, ...) printflike(4, 5);
@@ -55,27 +86,40 @@ void Writev(const char* channelName, const char* functionName, LOGLEVEL level, c
 } // namespace Log
 
 // log wrappers
-#define Log_SetChannel(ChannelName) static const char* ___LogChannel___ = #ChannelName;
-#define Log_ErrorPrint(msg) Log::Write(___LogChannel___, __func__, LOGLEVEL_ERROR, msg)
-#define Log_ErrorPrintf(...) Log::Writef(___LogChannel___, __func__, LOGLEVEL_ERROR, __VA_ARGS__)
-#define Log_WarningPrint(msg) Log::Write(___LogChannel___, __func__, LOGLEVEL_WARNING, msg)
-#define Log_WarningPrintf(...) Log::Writef(___LogChannel___, __func__, LOGLEVEL_WARNING, __VA_ARGS__)
-#define Log_PerfPrint(msg) Log::Write(___LogChannel___, __func__, LOGLEVEL_PERF, msg)
-#define Log_PerfPrintf(...) Log::Writef(___LogChannel___, __func__, LOGLEVEL_PERF, __VA_ARGS__)
-#define Log_InfoPrint(msg) Log::Write(___LogChannel___, __func__, LOGLEVEL_INFO, msg)
-#define Log_InfoPrintf(...) Log::Writef(___LogChannel___, __func__, LOGLEVEL_INFO, __VA_ARGS__)
-#define Log_VerbosePrint(msg) Log::Write(___LogChannel___, __func__, LOGLEVEL_VERBOSE, msg)
-#define Log_VerbosePrintf(...) Log::Writef(___LogChannel___, __func__, LOGLEVEL_VERBOSE, __VA_ARGS__)
-#define Log_DevPrint(msg) Log::Write(___LogChannel___, __func__, LOGLEVEL_DEV, msg)
-#define Log_DevPrintf(...) Log::Writef(___LogChannel___, __func__, LOGLEVEL_DEV, __VA_ARGS__)
-#define Log_ProfilePrint(msg) Log::Write(___LogChannel___, __func__, LOGLEVEL_PROFILE, msg)
-#define Log_ProfilePrintf(...) Log::Writef(___LogChannel___, __func__, LOGLEVEL_PROFILE, __VA_ARGS__)
+#define Log_SetChannel(ChannelName) static Log::Channel ___LogChannel___{#ChannelName, {0}};
+#define Log_ChannelWrite(level, msg)                                                                                   \
+  do                                                                                                                   \
+  {                                                                                                                    \
+    if (Log::IsChannelEnabled(___LogChannel___, level))                                                                \
+      Log::Write(___LogChannel___.name, __func__, level, msg);                                                         \
+  } while (0)
+#define Log_ChannelWritef(level, ...)                                                                                  \
+  do                                                                                                                   \
+  {                                                                                                                    \
+    if (Log::IsChannelEnabled(___LogChannel___, level))                                                                \
+      Log::Writef(___LogChannel___.name, __func__, level, __VA_ARGS__);                                                \
+  } while (0)
+
+#define Log_ErrorPrint(msg) Log_ChannelWrite(LOGLEVEL_ERROR, msg)
+#define Log_ErrorPrintf(...) Log_ChannelWritef(LOGLEVEL_ERROR, __VA_ARGS__)
+#define Log_WarningPrint(msg) Log_ChannelWrite(LOGLEVEL_WARNING, msg)
+#define Log_WarningPrintf(...) Log_ChannelWritef(LOGLEVEL_WARNING, __VA_ARGS__)
+#define Log_PerfPrint(msg) Log_ChannelWrite(LOGLEVEL_PERF, msg)
+#define Log_PerfPrintf(...) Log_ChannelWritef(LOGLEVEL_PERF, __VA_ARGS__)
+#define Log_InfoPrint(msg) Log_ChannelWrite(LOGLEVEL_INFO, msg)
+#define Log_InfoPrintf(...) Log_ChannelWritef(LOGLEVEL_INFO, __VA_ARGS__)
+#define Log_VerbosePrint(msg) Log_ChannelWrite(LOGLEVEL_VERBOSE, msg)
+#define Log_VerbosePrintf(...) Log_ChannelWritef(LOGLEVEL_VERBOSE, __VA_ARGS__)
+#define Log_DevPrint(msg) Log_ChannelWrite(LOGLEVEL_DEV, msg)
+#define Log_DevPrintf(...) Log_ChannelWritef(LOGLEVEL_DEV, __VA_ARGS__)
+#define Log_ProfilePrint(msg) Log_ChannelWrite(LOGLEVEL_PROFILE, msg)
+#define Log_ProfilePrintf(...) Log_ChannelWritef(LOGLEVEL_PROFILE, __VA_ARGS__)
 
 #ifdef _DEBUG
-#define Log_DebugPrint(msg) Log::Write(___LogChannel___, __func__, LOGLEVEL_DEBUG, msg)
-#define Log_DebugPrintf(...) Log::Writef(___LogChannel___, __func__, LOGLEVEL_DEBUG, __VA_ARGS__)
-#define Log_TracePrint(msg) Log::Write(___LogChannel___, __func__, LOGLEVEL_TRACE, msg)
-#define Log_TracePrintf(...) Log::Writef(___LogChannel___, __func__, LOGLEVEL_TRACE, __VA_ARGS__)
+#define Log_DebugPrint(msg) Log_ChannelWrite(LOGLEVEL_DEBUG, msg)
+#define Log_DebugPrintf(...) Log_ChannelWritef(LOGLEVEL_DEBUG, __VA_ARGS__)
+#define Log_TracePrint(msg) Log_ChannelWrite(LOGLEVEL_TRACE, msg)
+#define Log_TracePrintf(...) Log_ChannelWritef(LOGLEVEL_TRACE, __VA_ARGS__)
 #else
 #define Log_DebugPrint(msg)                                                                                            \
   do                                                                                                                   \
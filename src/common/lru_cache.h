@@ -94,6 +94,13 @@ public:
     m_items.erase(iter);
     return true;
   }
+  template<typename F>
+  void ForEachValue(F&& func) const
+  {
+    for (const auto& it : m_items)
+      func(it.second.value);
+  }
+
   void SetManualEvict(bool block)
   {
     m_manual_evict = block;
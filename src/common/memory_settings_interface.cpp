@@ -16,6 +16,7 @@ bool MemorySettingsInterface::Save()
 
 void MemorySettingsInterface::Clear()
 {
+  m_change_counter++;
   m_sections.clear();
 }
 
@@ -168,6 +169,8 @@ std::vector<std::pair<std::string, std::string>> MemorySettingsInterface::GetKey
 void MemorySettingsInterface::SetKeyValueList(const char* section,
                                               const std::vector<std::pair<std::string, std::string>>& items)
 {
+  m_change_counter++;
+
   auto sit = UnorderedStringMapFind(m_sections, section);
   sit->second.clear();
   for (const auto& [key, value] : items)
@@ -176,6 +179,8 @@ void MemorySettingsInterface::SetKeyValueList(const char* section,
 
 void MemorySettingsInterface::SetValue(const char* section, const char* key, std::string value)
 {
+  m_change_counter++;
+
   auto sit = UnorderedStringMapFind(m_sections, section);
   if (sit == m_sections.end())
     sit = m_sections.emplace(std::make_pair(std::string(section), KeyMap())).first;
@@ -216,6 +221,8 @@ std::vector<std::string> MemorySettingsInterface::GetStringList(const char* sect
 
 void MemorySettingsInterface::SetStringList(const char* section, const char* key, const std::vector<std::string>& items)
 {
+  m_change_counter++;
+
   auto sit = UnorderedStringMapFind(m_sections, section);
   if (sit == m_sections.end())
     sit = m_sections.emplace(std::make_pair(std::string(section), KeyMap())).first;
@@ -231,6 +238,8 @@ void MemorySettingsInterface::SetStringList(const char* section, const char* key
 
 bool MemorySettingsInterface::RemoveFromStringList(const char* section, const char* key, const char* item)
 {
+  m_change_counter++;
+
   auto sit = UnorderedStringMapFind(m_sections, section);
   if (sit == m_sections.end())
     sit = m_sections.emplace(std::make_pair(std::string(section), KeyMap())).first;
@@ -255,6 +264,8 @@ bool MemorySettingsInterface::RemoveFromStringList(const char* section, const ch
 
 bool MemorySettingsInterface::AddToStringList(const char* section, const char* key, const char* item)
 {
+  m_change_counter++;
+
   auto sit = UnorderedStringMapFind(m_sections, section);
   if (sit == m_sections.end())
     sit = m_sections.emplace(std::make_pair(std::string(section), KeyMap())).first;
@@ -281,6 +292,8 @@ bool MemorySettingsInterface::ContainsValue(const char* section, const char* key
 
 void MemorySettingsInterface::DeleteValue(const char* section, const char* key)
 {
+  m_change_counter++;
+
   auto sit = UnorderedStringMapFind(m_sections, section);
   if (sit == m_sections.end())
     return;
@@ -292,6 +305,8 @@ void MemorySettingsInterface::DeleteValue(const char* section, const char* key)
 
 void MemorySettingsInterface::ClearSection(const char* section)
 {
+  m_change_counter++;
+
   auto sit = UnorderedStringMapFind(m_sections, section);
   if (sit == m_sections.end())
     return;
@@ -42,6 +42,9 @@ public:
   virtual void DeleteValue(const char* section, const char* key) = 0;
   virtual void ClearSection(const char* section) = 0;
 
+  /// Incremented whenever any value is changed, so anything cached from the values can be checked for staleness.
+  ALWAYS_INLINE u32 GetChangeCounter() const { return m_change_counter; }
+
   ALWAYS_INLINE s32 GetIntValue(const char* section, const char* key, s32 default_value = 0) const
   {
     s32 value;
@@ -216,4 +219,7 @@ public:
     else
       DeleteValue(section, key);
   }
+
+protected:
+  u32 m_change_counter = 0;
 };
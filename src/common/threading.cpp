@@ -3,7 +3,15 @@
 
 #include "threading.h"
 #include "assert.h"
+#include "log.h"
+#include "trace.h"
+#include "cpuinfo.h"
+#include "fmt/format.h"
+#include <algorithm>
+#include <array>
+#include <cinttypes>
 #include <memory>
+#include <thread>
 
 #if !defined(_WIN32) && !defined(__APPLE__)
 #ifndef _GNU_SOURCE
@@ -38,6 +46,8 @@
 #endif
 #endif
 
+Log_SetChannel(Threading);
+
 #ifdef _WIN32
 union FileTimeU64Union
 {
@@ -559,6 +569,414 @@ void Threading::SetNameOfCurrentThread(const char* name)
 #else
   pthread_set_name_np(pthread_self(), name);
 #endif
+
+#ifdef WITH_TRACING
+  Trace::SetCurrentThreadName(name);
+#endif
+}
+
+struct Threading::TaskPool::Worker
+{
+  std::mutex mutex;
+  std::array<std::deque<Task>, NUM_WORKER_PRIORITIES> queues;
+  Thread thread;
+};
+
+static thread_local Threading::TaskPool* s_current_task_pool = nullptr;
+static thread_local u32 s_current_task_worker = 0;
+
+static std::atomic_bool s_affinity_policy_enabled{false};
+static std::atomic<u32> s_affinity_policy_generation{0};
+static thread_local bool s_affinity_policy_pinned = false;
+
+static Threading::CPUTopology DetectCPUTopology()
+{
+  Threading::CPUTopology topo = {};
+  if (!cpuinfo_initialize())
+  {
+    Log_ErrorPrint("cpuinfo_initialize() failed, assuming homogeneous CPU");
+    topo.num_processors = std::max(std::thread::hardware_concurrency(), 1u);
+    return topo;
+  }
+
+  topo.num_processors = std::max(cpuinfo_get_processors_count(), 1u);
+
+  // performance cores are the ones which clock the highest, if they don't all match
+  const u32 num_cores = cpuinfo_get_cores_count();
+  u64 max_frequency = 0;
+  for (u32 i = 0; i < num_cores; i++)
+    max_frequency = std::max(max_frequency, cpuinfo_get_core(i)->frequency);
+
+  for (u32 i = 0; i < num_cores; i++)
+  {
+    const cpuinfo_core* core = cpuinfo_get_core(i);
+
+    u64 core_mask = 0;
+    for (u32 j = 0; j < core->processor_count; j++)
+    {
+      const u32 index = core->processor_start + j;
+#if defined(_WIN32)
+      const cpuinfo_processor* proc = cpuinfo_get_processor(index);
+      const u32 bit = (proc->windows_group_id == 0) ? proc->windows_processor_id : 64;
+#elif defined(__linux__)
+      const u32 bit = static_cast<u32>(cpuinfo_get_processor(index)->linux_id);
+#else
+      const u32 bit = index;
+#endif
+      if (bit < 64)
+        core_mask |= static_cast<u64>(1) << bit;
+    }
+    if (core_mask == 0)
+      continue;
+
+    if (core->frequency == max_frequency)
+      topo.performance_cores.push_back(core_mask);
+    else
+      topo.efficiency_mask |= core_mask;
+  }
+
+  Log_InfoPrintf("Detected %u processors, %zu performance cores, efficiency mask %016" PRIX64, topo.num_processors,
+                 topo.performance_cores.size(), topo.efficiency_mask);
+  return topo;
+}
+
+const Threading::CPUTopology& Threading::GetCPUTopology()
+{
+  static const CPUTopology topo = DetectCPUTopology();
+  return topo;
+}
+
+void Threading::SetAffinityPolicyEnabled(bool enabled)
+{
+  if (s_affinity_policy_enabled.exchange(enabled, std::memory_order_acq_rel) != enabled)
+    s_affinity_policy_generation.fetch_add(1, std::memory_order_acq_rel);
+}
+
+bool Threading::IsAffinityPolicyEnabled()
+{
+  return s_affinity_policy_enabled.load(std::memory_order_acquire);
+}
+
+u32 Threading::GetAffinityPolicyGeneration()
+{
+  return s_affinity_policy_generation.load(std::memory_order_acquire);
+}
+
+bool Threading::ApplyAffinityPolicy(AffinityClass cls)
+{
+  if (!IsAffinityPolicyEnabled())
+  {
+    // leave alone anything we didn't pin, the user may have set the process affinity themselves
+    if (!s_affinity_policy_pinned)
+      return true;
+
+    s_affinity_policy_pinned = false;
+    return ThreadHandle::GetForCallingThread().SetAffinity(0);
+  }
+
+  // the first two performance cores are reserved for the CPU and GPU threads
+  const CPUTopology& topo = GetCPUTopology();
+  const size_t num_performance_cores = topo.performance_cores.size();
+  u64 remaining_performance_mask = 0;
+  for (size_t i = 2; i < num_performance_cores; i++)
+    remaining_performance_mask |= topo.performance_cores[i];
+
+  u64 mask = 0;
+  switch (cls)
+  {
+    case AffinityClass::EmulationCPU:
+      mask = (num_performance_cores > 0) ? topo.performance_cores[0] : 0;
+      break;
+
+    case AffinityClass::EmulationGPU:
+      mask = (num_performance_cores > 1) ? topo.performance_cores[1] : 0;
+      break;
+
+    case AffinityClass::EmulationWorker:
+      mask = remaining_performance_mask;
+      break;
+
+    case AffinityClass::Background:
+      mask = topo.IsHybrid() ? topo.efficiency_mask : remaining_performance_mask;
+      break;
+
+      DefaultCaseIsUnreachable();
+  }
+
+  s_affinity_policy_pinned = (mask != 0);
+  return ThreadHandle::GetForCallingThread().SetAffinity(mask);
+}
+
+Threading::TaskPool::TaskPool() = default;
+
+Threading::TaskPool::~TaskPool()
+{
+  Stop();
+}
+
+Threading::TaskPool& Threading::TaskPool::GetInstance()
+{
+  static TaskPool instance;
+  static std::once_flag start_flag;
+  std::call_once(start_flag, []() { instance.Start(); });
+  return instance;
+}
+
+void Threading::TaskPool::Start(u32 num_workers, u32 num_latency_critical_workers)
+{
+  AssertMsg(!IsRunning(), "Task pool is already running");
+
+  const CPUTopology& topo = GetCPUTopology();
+  if (num_latency_critical_workers == 0)
+    num_latency_critical_workers = (topo.num_processors > 2) ? 1 : 0;
+  if (num_workers == 0)
+    num_workers = std::max(topo.num_processors - std::min(topo.num_processors, num_latency_critical_workers + 1), 1u);
+
+  Log_InfoPrintf("Starting task pool with %u workers and %u latency-critical workers", num_workers,
+                 num_latency_critical_workers);
+
+  m_shutdown = false;
+  m_queued_tasks.store(0, std::memory_order_release);
+  m_next_worker.store(0, std::memory_order_release);
+  m_workers.reserve(num_workers);
+  for (u32 i = 0; i < num_workers; i++)
+    m_workers.push_back(std::make_unique<Worker>());
+
+  // workers can steal from each other as soon as they start, so the whole array has to exist first
+  for (u32 i = 0; i < num_workers; i++)
+    m_workers[i]->thread.Start([this, i]() { WorkerThread(i); });
+
+  // only worth pinning on big/little, otherwise we'd just be fighting the scheduler
+  u64 critical_mask = 0;
+  if (topo.IsHybrid())
+  {
+    for (const u64 core_mask : topo.performance_cores)
+      critical_mask |= core_mask;
+  }
+
+  m_critical_shutdown = false;
+  m_critical_workers.reserve(num_latency_critical_workers);
+  for (u32 i = 0; i < num_latency_critical_workers; i++)
+  {
+    std::unique_ptr<Thread> thread = std::make_unique<Thread>();
+    thread->Start([this, i, critical_mask]() { LatencyCriticalWorkerThread(i, critical_mask); });
+    m_critical_workers.push_back(std::move(thread));
+  }
+}
+
+void Threading::TaskPool::Stop()
+{
+  if (!m_critical_workers.empty())
+  {
+    {
+      std::unique_lock lock(m_critical_mutex);
+      m_critical_shutdown = true;
+      m_critical_cv.notify_all();
+    }
+
+    for (std::unique_ptr<Thread>& thread : m_critical_workers)
+      thread->Join();
+    m_critical_workers.clear();
+  }
+
+  if (!m_workers.empty())
+  {
+    {
+      std::unique_lock lock(m_wake_mutex);
+      m_shutdown = true;
+      m_wake_cv.notify_all();
+    }
+
+    for (std::unique_ptr<Worker>& worker : m_workers)
+      worker->thread.Join();
+    m_workers.clear();
+  }
+}
+
+void Threading::TaskPool::Submit(Task task, Priority priority)
+{
+  if (priority == Priority::LatencyCritical)
+  {
+    if (!m_critical_workers.empty())
+    {
+      std::unique_lock lock(m_critical_mutex);
+      m_critical_queue.push_back(std::move(task));
+      m_critical_cv.notify_one();
+      return;
+    }
+
+    // no dedicated workers, so just go to the front of the line
+    priority = Priority::High;
+  }
+
+  if (m_workers.empty())
+  {
+    task();
+    return;
+  }
+
+  // tasks spawned from a worker stay on that worker, since they probably share data
+  const u32 index = (s_current_task_pool == this) ?
+                      s_current_task_worker :
+                      (m_next_worker.fetch_add(1, std::memory_order_relaxed) % static_cast<u32>(m_workers.size()));
+  Worker& worker = *m_workers[index];
+  {
+    std::unique_lock lock(worker.mutex);
+    worker.queues[static_cast<u32>(priority)].push_back(std::move(task));
+  }
+
+  // counter has to be bumped under the wake lock, otherwise a worker could miss it and go to sleep
+  std::unique_lock lock(m_wake_mutex);
+  m_queued_tasks.fetch_add(1, std::memory_order_acq_rel);
+  m_wake_cv.notify_one();
+}
+
+bool Threading::TaskPool::TryRunPendingTask()
+{
+  if (m_workers.empty())
+    return false;
+
+  Task task;
+  const bool own_queue = (s_current_task_pool == this);
+  if (!PopTask(own_queue ? s_current_task_worker : 0, own_queue, &task))
+    return false;
+
+  task();
+  return true;
+}
+
+bool Threading::TaskPool::PopTask(u32 start_index, bool own_queue, Task* task)
+{
+  if (m_queued_tasks.load(std::memory_order_acquire) == 0)
+    return false;
+
+  // highest priority anywhere in the pool wins over lower priority work in our own queue
+  const u32 num_workers = static_cast<u32>(m_workers.size());
+  for (u32 priority = NUM_WORKER_PRIORITIES; priority-- > 0;)
+  {
+    for (u32 i = 0; i < num_workers; i++)
+    {
+      const u32 index = (start_index + i) % num_workers;
+      Worker& worker = *m_workers[index];
+      std::unique_lock lock(worker.mutex);
+      std::deque<Task>& queue = worker.queues[priority];
+      if (queue.empty())
+        continue;
+
+      // newest first from our own queue while it's still hot in cache, oldest first when stealing
+      if (own_queue && index == start_index)
+      {
+        *task = std::move(queue.back());
+        queue.pop_back();
+      }
+      else
+      {
+        *task = std::move(queue.front());
+        queue.pop_front();
+      }
+
+      m_queued_tasks.fetch_sub(1, std::memory_order_acq_rel);
+      return true;
+    }
+  }
+
+  return false;
+}
+
+void Threading::TaskPool::WorkerThread(u32 index)
+{
+  SetNameOfCurrentThread(fmt::format("Task Worker {}", index).c_str());
+
+  s_current_task_pool = this;
+  s_current_task_worker = index;
+
+  u32 affinity_generation = GetAffinityPolicyGeneration();
+  ApplyAffinityPolicy(AffinityClass::Background);
+
+  Task task;
+  for (;;)
+  {
+    // policy can change while we're running, e.g. from the settings
+    if (const u32 generation = GetAffinityPolicyGeneration(); generation != affinity_generation)
+    {
+      affinity_generation = generation;
+      ApplyAffinityPolicy(AffinityClass::Background);
+    }
+
+    if (PopTask(index, true, &task))
+    {
+      task();
+      task = {};
+      continue;
+    }
+
+    std::unique_lock lock(m_wake_mutex);
+    m_wake_cv.wait(lock, [this]() { return (m_shutdown || m_queued_tasks.load(std::memory_order_acquire) > 0); });
+    if (m_shutdown && m_queued_tasks.load(std::memory_order_acquire) == 0)
+      break;
+  }
+
+  s_current_task_pool = nullptr;
+}
+
+void Threading::TaskPool::LatencyCriticalWorkerThread(u32 index, u64 affinity_mask)
+{
+  SetNameOfCurrentThread(fmt::format("Task Worker LC{}", index).c_str());
+  if (affinity_mask != 0 && !ThreadHandle::GetForCallingThread().SetAffinity(affinity_mask))
+    Log_WarningPrintf("Failed to pin latency-critical worker %u to %016" PRIX64, index, affinity_mask);
+
+  std::unique_lock lock(m_critical_mutex);
+  for (;;)
+  {
+    m_critical_cv.wait(lock, [this]() { return (m_critical_shutdown || !m_critical_queue.empty()); });
+    if (m_critical_queue.empty())
+      break;
+
+    Task task(std::move(m_critical_queue.front()));
+    m_critical_queue.pop_front();
+    lock.unlock();
+    task();
+    lock.lock();
+  }
+}
+
+Threading::TaskGroup::TaskGroup(TaskPool& pool) : m_pool(pool) {}
+
+Threading::TaskGroup::~TaskGroup()
+{
+  Wait();
+}
+
+void Threading::TaskGroup::Submit(TaskPool::Task task, TaskPool::Priority priority)
+{
+  m_pending.fetch_add(1, std::memory_order_acq_rel);
+  m_pool.Submit(
+    [this, task = std::move(task)]() {
+      task();
+
+      // last one out wakes the waiter, has to be done under the lock so it can't be missed
+      std::unique_lock lock(m_mutex);
+      if (m_pending.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        m_cv.notify_all();
+    },
+    priority);
+}
+
+void Threading::TaskGroup::Wait()
+{
+  while (m_pending.load(std::memory_order_acquire) > 0)
+  {
+    // might as well make ourselves useful
+    if (m_pool.TryRunPendingTask())
+      continue;
+
+    std::unique_lock lock(m_mutex);
+    m_cv.wait_for(lock, std::chrono::milliseconds(1),
+                  [this]() { return (m_pending.load(std::memory_order_acquire) == 0); });
+  }
+
+  // the last task may still be holding the lock after dropping the count, don't let it outlive us
+  std::unique_lock lock(m_mutex);
 }
 
 Threading::KernelSemaphore::KernelSemaphore()
@@ -11,7 +11,12 @@
 #endif
 
 #include <atomic>
+#include <condition_variable>
+#include <deque>
 #include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
 
 namespace Threading {
 extern u64 GetThreadCpuTime();
@@ -102,6 +107,147 @@ protected:
   u32 m_stack_size = 0;
 };
 
+// --------------------------------------------------------------------------------------
+//  CPU topology and affinity policy
+// --------------------------------------------------------------------------------------
+// Detects performance and efficiency cores on big/little (hybrid) CPUs via cpuinfo, so that
+// the threads the emulator's speed depends on can be kept off the efficiency cores.
+//
+struct CPUTopology
+{
+  u32 num_processors;
+
+  /// Logical processor mask for each performance core, one entry per physical core.
+  /// On CPUs where all cores are the same, every core is listed here.
+  std::vector<u64> performance_cores;
+
+  /// Logical processors which are not part of a performance core. Zero if all cores are the same.
+  u64 efficiency_mask;
+
+  ALWAYS_INLINE bool IsHybrid() const { return (efficiency_mask != 0); }
+};
+
+enum class AffinityClass : u8
+{
+  EmulationCPU,    // Gets the first performance core to itself.
+  EmulationGPU,    // Gets the second performance core to itself.
+  EmulationWorker, // Shares the remaining performance cores.
+  Background,      // Efficiency cores, or the remaining performance cores if there are none.
+};
+
+/// Returns the host CPU layout. Detected on first call.
+const CPUTopology& GetCPUTopology();
+
+/// Enables or disables pinning threads by class. Threads pick up the change next time they apply the policy.
+void SetAffinityPolicyEnabled(bool enabled);
+bool IsAffinityPolicyEnabled();
+
+/// Incremented every time the policy changes, so long-lived threads can tell when to re-apply it.
+u32 GetAffinityPolicyGeneration();
+
+/// Pins the calling thread according to its class, or unpins it if the policy is disabled.
+bool ApplyAffinityPolicy(AffinityClass cls);
+
+// --------------------------------------------------------------------------------------
+//  TaskPool
+// --------------------------------------------------------------------------------------
+// Shared set of worker threads for short-lived background work. Each worker owns one deque
+// per priority, taking from the back of its own and stealing from the front of the others
+// when it runs dry. Latency-critical tasks never wait behind bulk work: they are run by a
+// separate set of workers, which are pinned to the performance cores on big/little CPUs.
+//
+class TaskPool
+{
+public:
+  using Task = std::function<void()>;
+
+  enum class Priority : u8
+  {
+    Low,
+    Normal,
+    High,
+    LatencyCritical,
+    Count
+  };
+
+  TaskPool();
+  TaskPool(const TaskPool&) = delete;
+  ~TaskPool();
+
+  TaskPool& operator=(const TaskPool&) = delete;
+
+  /// Returns the process-wide pool, starting it with the default worker counts on first use.
+  static TaskPool& GetInstance();
+
+  ALWAYS_INLINE bool IsRunning() const { return !m_workers.empty(); }
+  ALWAYS_INLINE u32 GetWorkerCount() const { return static_cast<u32>(m_workers.size()); }
+  ALWAYS_INLINE u32 GetLatencyCriticalWorkerCount() const { return static_cast<u32>(m_critical_workers.size()); }
+
+  /// Starts the worker threads. Passing zero picks a count based on the host CPU topology.
+  void Start(u32 num_workers = 0, u32 num_latency_critical_workers = 0);
+
+  /// Runs any remaining tasks to completion, then stops all workers.
+  void Stop();
+
+  /// Queues a task. If the pool is not running, the task is executed immediately on the calling thread.
+  void Submit(Task task, Priority priority = Priority::Normal);
+
+  /// Runs one queued (non latency-critical) task on the calling thread. Returns false if there was nothing to run.
+  bool TryRunPendingTask();
+
+private:
+  struct Worker;
+
+  static constexpr u32 NUM_WORKER_PRIORITIES = static_cast<u32>(Priority::LatencyCritical);
+
+  bool PopTask(u32 start_index, bool own_queue, Task* task);
+  void WorkerThread(u32 index);
+  void LatencyCriticalWorkerThread(u32 index, u64 affinity_mask);
+
+  std::vector<std::unique_ptr<Worker>> m_workers;
+  std::atomic<u32> m_next_worker{0};
+  std::atomic<u32> m_queued_tasks{0};
+  std::mutex m_wake_mutex;
+  std::condition_variable m_wake_cv;
+  bool m_shutdown = false;
+
+  std::vector<std::unique_ptr<Thread>> m_critical_workers;
+  std::deque<Task> m_critical_queue;
+  std::mutex m_critical_mutex;
+  std::condition_variable m_critical_cv;
+  bool m_critical_shutdown = false;
+};
+
+// --------------------------------------------------------------------------------------
+//  TaskGroup
+// --------------------------------------------------------------------------------------
+// Tracks a batch of tasks submitted to a TaskPool, so the caller can wait on all of them.
+// While waiting, the calling thread helps out by running queued tasks itself.
+//
+class TaskGroup
+{
+public:
+  explicit TaskGroup(TaskPool& pool = TaskPool::GetInstance());
+  TaskGroup(const TaskGroup&) = delete;
+  ~TaskGroup();
+
+  TaskGroup& operator=(const TaskGroup&) = delete;
+
+  void Submit(TaskPool::Task task, TaskPool::Priority priority = TaskPool::Priority::Normal);
+
+  /// Blocks until every task submitted through this group has completed.
+  void Wait();
+
+  /// Returns the number of tasks which have been submitted, but haven't completed yet.
+  ALWAYS_INLINE u32 GetPendingCount() const { return m_pending.load(std::memory_order_acquire); }
+
+private:
+  TaskPool& m_pool;
+  std::atomic<u32> m_pending{0};
+  std::mutex m_mutex;
+  std::condition_variable m_cv;
+};
+
 /// A semaphore that may not have a fast userspace path
 /// (Used in other semaphore-based algorithms where the semaphore is just used for its thread sleep/wake ability)
 class KernelSemaphore
@@ -0,0 +1,200 @@
+// SPDX-FileCopyrightText: 2019-2022 Connor McLaughlin <stenzek@gmail.com>
+// SPDX-License-Identifier: (GPL-3.0 OR CC-BY-NC-ND-4.0)
+
+#include "trace.h"
+#include "file_system.h"
+#include "log.h"
+#include <cinttypes>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+Log_SetChannel(Trace);
+
+namespace Trace {
+
+namespace {
+struct Event
+{
+  const char* name;
+  Common::Timer::Value start;
+  Common::Timer::Value end;
+};
+
+struct ThreadBuffer
+{
+  // 3MB per thread, which is several seconds of the busiest thread.
+  static constexpr u32 NUM_EVENTS = 131072;
+  static constexpr u32 EVENT_MASK = NUM_EVENTS - 1;
+
+  // The owning thread can still be writing while the buffer is flushed, so skip the oldest events once it wraps.
+  static constexpr u32 WRAP_MARGIN = 4096;
+
+  std::unique_ptr<Event[]> events;
+  std::atomic<u64> count{0};
+  std::string thread_name;
+  u32 thread_id = 0;
+  bool in_use = false;
+};
+
+struct ThreadState
+{
+  ~ThreadState();
+
+  ThreadBuffer* buffer = nullptr;
+  std::string name;
+};
+} // namespace
+
+static ThreadBuffer* AllocateThreadBuffer(ThreadState& state);
+
+std::atomic_bool Detail::g_capturing{false};
+
+static std::mutex s_buffers_mutex;
+static std::vector<std::unique_ptr<ThreadBuffer>> s_buffers;
+static u32 s_next_thread_id = 1;
+static Common::Timer::Value s_capture_start = 0;
+
+static thread_local ThreadState s_thread_state;
+
+ThreadState::~ThreadState()
+{
+  if (!buffer)
+    return;
+
+  // Keep the events around for the capture, the buffer can be reused by another thread later.
+  std::unique_lock lock(s_buffers_mutex);
+  buffer->in_use = false;
+}
+
+ThreadBuffer* AllocateThreadBuffer(ThreadState& state)
+{
+  std::unique_lock lock(s_buffers_mutex);
+
+  // Buffers of exited threads are only reused between captures, otherwise their events would be lost.
+  ThreadBuffer* buffer = nullptr;
+  if (!Detail::g_capturing.load(std::memory_order_relaxed))
+  {
+    for (const std::unique_ptr<ThreadBuffer>& it : s_buffers)
+    {
+      if (!it->in_use)
+      {
+        buffer = it.get();
+        buffer->count.store(0, std::memory_order_relaxed);
+        break;
+      }
+    }
+  }
+  if (!buffer)
+  {
+    buffer = s_buffers.emplace_back(std::make_unique<ThreadBuffer>()).get();
+    buffer->events = std::make_unique<Event[]>(ThreadBuffer::NUM_EVENTS);
+  }
+
+  buffer->thread_name = state.name.empty() ? std::string("Unnamed Thread") : state.name;
+  buffer->thread_id = s_next_thread_id++;
+  buffer->in_use = true;
+  state.buffer = buffer;
+  return buffer;
+}
+
+void Detail::RecordEvent(const char* name, Common::Timer::Value start, Common::Timer::Value end)
+{
+  ThreadBuffer* buffer = s_thread_state.buffer;
+  if (!buffer)
+    buffer = AllocateThreadBuffer(s_thread_state);
+
+  // Only this thread writes to the buffer, so the count just needs to be published after the event.
+  const u64 index = buffer->count.load(std::memory_order_relaxed);
+  buffer->events[index & ThreadBuffer::EVENT_MASK] = Event{name, start, end};
+  buffer->count.store(index + 1, std::memory_order_release);
+}
+
+void StartCapture()
+{
+  std::unique_lock lock(s_buffers_mutex);
+
+  // Anything recorded before this point is ignored when the capture is written, so the buffers don't need clearing.
+  s_capture_start = Common::Timer::GetCurrentValue();
+  Detail::g_capturing.store(true, std::memory_order_relaxed);
+  Log_InfoPrintf("Trace capture started.");
+}
+
+static void WriteEscapedString(std::FILE* fp, const char* str)
+{
+  std::fputc('"', fp);
+  for (; *str != '\0'; str++)
+  {
+    if (*str == '"' || *str == '\\')
+      std::fputc('\\', fp);
+    if (static_cast<u8>(*str) >= 0x20)
+      std::fputc(*str, fp);
+  }
+  std::fputc('"', fp);
+}
+
+bool StopCapture(const char* filename)
+{
+  Detail::g_capturing.store(false, std::memory_order_relaxed);
+
+  std::unique_lock lock(s_buffers_mutex);
+  auto fp = FileSystem::OpenManagedCFile(filename, "wb");
+  if (!fp)
+  {
+    Log_ErrorPrintf("Failed to open trace file '%s'", filename);
+    return false;
+  }
+
+  std::fputs("{\"traceEvents\":[\n", fp.get());
+  std::fputs("{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,\"args\":{\"name\":\"DuckStation\"}}",
+             fp.get());
+
+  u64 total_events = 0;
+  for (const std::unique_ptr<ThreadBuffer>& buffer : s_buffers)
+  {
+    std::fprintf(fp.get(), ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":",
+                 buffer->thread_id);
+    WriteEscapedString(fp.get(), buffer->thread_name.c_str());
+    std::fputs("}}", fp.get());
+
+    const u64 count = buffer->count.load(std::memory_order_acquire);
+    const u64 first =
+      (count > ThreadBuffer::NUM_EVENTS) ? (count - ThreadBuffer::NUM_EVENTS + ThreadBuffer::WRAP_MARGIN) : 0;
+    for (u64 i = first; i < count; i++)
+    {
+      const Event& ev = buffer->events[i & ThreadBuffer::EVENT_MASK];
+      if (ev.start < s_capture_start || ev.end < ev.start)
+        continue;
+
+      const double ts = Common::Timer::ConvertValueToNanoseconds(ev.start - s_capture_start) / 1000.0;
+      const double dur = Common::Timer::ConvertValueToNanoseconds(ev.end - ev.start) / 1000.0;
+      std::fputs(",\n{\"name\":", fp.get());
+      WriteEscapedString(fp.get(), ev.name);
+      std::fprintf(fp.get(), ",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}", buffer->thread_id, ts,
+                   dur);
+      total_events++;
+    }
+  }
+
+  std::fputs("\n]}\n", fp.get());
+  if (std::ferror(fp.get()))
+  {
+    Log_ErrorPrintf("Failed to write trace file '%s'", filename);
+    return false;
+  }
+
+  Log_InfoPrintf("Wrote %" PRIu64 " trace events to '%s'", total_events, filename);
+  return true;
+}
+
+void SetCurrentThreadName(const char* name)
+{
+  s_thread_state.name = name;
+  if (s_thread_state.buffer)
+  {
+    std::unique_lock lock(s_buffers_mutex);
+    s_thread_state.buffer->thread_name = name;
+  }
+}
+
+} // namespace Trace
@@ -0,0 +1,73 @@
+// SPDX-FileCopyrightText: 2019-2022 Connor McLaughlin <stenzek@gmail.com>
+// SPDX-License-Identifier: (GPL-3.0 OR CC-BY-NC-ND-4.0)
+
+#pragma once
+#include "timer.h"
+#include "types.h"
+#include <atomic>
+
+//////////////////////////////////////////////////////////////////////////
+// Trace events, written in the Chrome trace format (chrome://tracing or ui.perfetto.dev can open them).
+// Each thread records into its own ring buffer, so recording an event doesn't take any locks. When the capture is
+// stopped, the buffers are merged into a single file. Only the newest events are kept if a buffer wraps around.
+//////////////////////////////////////////////////////////////////////////
+
+namespace Trace {
+
+namespace Detail {
+extern std::atomic_bool g_capturing;
+void RecordEvent(const char* name, Common::Timer::Value start, Common::Timer::Value end);
+} // namespace Detail
+
+/// Returns true if events are currently being recorded.
+ALWAYS_INLINE static bool IsCapturing()
+{
+  return Detail::g_capturing.load(std::memory_order_relaxed);
+}
+
+/// Starts recording events, any events from a previous capture are discarded.
+void StartCapture();
+
+/// Stops recording events, and writes everything recorded since StartCapture() to the specified file.
+bool StopCapture(const char* filename);
+
+/// Sets the name the current thread is shown as in the trace.
+void SetCurrentThreadName(const char* name);
+
+/// Records the time between construction and destruction as an event. The name must be a string literal, only
+/// the pointer is stored.
+class ScopedEvent
+{
+public:
+  ALWAYS_INLINE ScopedEvent(const char* name) : m_name(name)
+  {
+    if (IsCapturing())
+      m_start = Common::Timer::GetCurrentValue();
+  }
+
+  ALWAYS_INLINE ~ScopedEvent()
+  {
+    if (m_start != 0)
+      Detail::RecordEvent(m_name, m_start, Common::Timer::GetCurrentValue());
+  }
+
+  ScopedEvent(const ScopedEvent&) = delete;
+  ScopedEvent& operator=(const ScopedEvent&) = delete;
+
+private:
+  const char* m_name;
+  Common::Timer::Value m_start = 0;
+};
+
+} // namespace Trace
+
+#ifdef WITH_TRACING
+#define TRACE_SCOPE_CONCAT2(a, b) a##b
+#define TRACE_SCOPE_CONCAT(a, b) TRACE_SCOPE_CONCAT2(a, b)
+#define TRACE_SCOPE(name) Trace::ScopedEvent TRACE_SCOPE_CONCAT(trace_scope_, __LINE__)(name)
+#else
+#define TRACE_SCOPE(name)                                                                                              \
+  do                                                                                                                   \
+  {                                                                                                                    \
+  } while (0)
+#endif
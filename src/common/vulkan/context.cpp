@@ -774,7 +774,8 @@ bool Vulkan::Context::CreateGlobalDescriptorPool()
   VkDescriptorPoolSize pool_sizes[] = {{VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, 1024},
                                        {VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1024},
                                        {VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER, 16},
-                                       {VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 16}};
+                                       {VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 16},
+                                       {VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 16}};
 
   VkDescriptorPoolCreateInfo pool_create_info = {VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO,
                                                  nullptr,
@@ -808,7 +809,8 @@ bool Vulkan::Context::CreateQueryPool()
     return true;
 
   const VkQueryPoolCreateInfo query_create_info = {
-    VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO, nullptr, 0, VK_QUERY_TYPE_TIMESTAMP, NUM_COMMAND_BUFFERS * 2, 0};
+    VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO, nullptr, 0, VK_QUERY_TYPE_TIMESTAMP,
+    NUM_COMMAND_BUFFERS * TIMESTAMP_QUERIES_PER_COMMAND_BUFFER, 0};
   const VkResult res = vkCreateQueryPool(m_device, &query_create_info, nullptr, &m_timestamp_query_pool);
   if (res != VK_SUCCESS)
   {
@@ -915,6 +917,31 @@ float Vulkan::Context::GetAndResetAccumulatedGPUTime()
   return time;
 }
 
+Vulkan::Context::TimingScopeTimes Vulkan::Context::GetAndResetAccumulatedScopeTimes()
+{
+  const TimingScopeTimes times = m_accumulated_scope_times;
+  m_accumulated_scope_times = {};
+  return times;
+}
+
+void Vulkan::Context::SetTimingScope(u32 scope)
+{
+  DebugAssert(scope < MAX_TIMING_SCOPES);
+  if (m_current_timing_scope == scope)
+    return;
+
+  m_current_timing_scope = scope;
+
+  FrameResources& resources = m_frame_resources[m_current_frame];
+  if (!m_gpu_timing_enabled || !resources.timestamp_written || resources.num_scope_timestamps == MAX_SCOPE_TIMESTAMPS)
+    return;
+
+  resources.scope_timestamp_ids[resources.num_scope_timestamps] = static_cast<u8>(scope);
+  vkCmdWriteTimestamp(m_current_command_buffer, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, m_timestamp_query_pool,
+                      m_current_frame * TIMESTAMP_QUERIES_PER_COMMAND_BUFFER + 2 + resources.num_scope_timestamps);
+  resources.num_scope_timestamps++;
+}
+
 bool Vulkan::Context::SetEnableGPUTiming(bool enabled)
 {
   m_gpu_timing_enabled = enabled && m_gpu_timing_supported;
@@ -962,7 +989,7 @@ void Vulkan::Context::SubmitCommandBuffer(VkSemaphore wait_semaphore /* = VK_NUL
   if (m_gpu_timing_enabled && resources.timestamp_written)
   {
     vkCmdWriteTimestamp(m_current_command_buffer, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, m_timestamp_query_pool,
-                        m_current_frame * 2 + 1);
+                        m_current_frame * TIMESTAMP_QUERIES_PER_COMMAND_BUFFER + 1);
   }
 
   // End the current command buffer.
@@ -1150,10 +1177,12 @@ void Vulkan::Context::ActivateCommandBuffer(u32 index)
   {
     if (resources.timestamp_written)
     {
-      std::array<u64, 2> timestamps;
-      res =
-        vkGetQueryPoolResults(m_device, m_timestamp_query_pool, index * 2, static_cast<u32>(timestamps.size()),
-                              sizeof(u64) * timestamps.size(), timestamps.data(), sizeof(u64), VK_QUERY_RESULT_64_BIT);
+      // [0] = start, [1] = end, [2..] = scope switches
+      const u32 num_timestamps = 2 + resources.num_scope_timestamps;
+      std::array<u64, TIMESTAMP_QUERIES_PER_COMMAND_BUFFER> timestamps;
+      res = vkGetQueryPoolResults(m_device, m_timestamp_query_pool, index * TIMESTAMP_QUERIES_PER_COMMAND_BUFFER,
+                                  num_timestamps, sizeof(u64) * num_timestamps, timestamps.data(), sizeof(u64),
+                                  VK_QUERY_RESULT_64_BIT);
       if (res == VK_SUCCESS)
       {
         // if we didn't write the timestamp at the start of the cmdbuffer (just enabled timing), the first TS will be
@@ -1164,6 +1193,23 @@ void Vulkan::Context::ActivateCommandBuffer(u32 index)
             (timestamps[1] - timestamps[0]) * static_cast<double>(m_device_properties.limits.timestampPeriod);
           m_accumulated_gpu_time =
             static_cast<float>(static_cast<double>(m_accumulated_gpu_time) + (ns_diff / 1000000.0));
+
+          u64 scope_start = timestamps[0];
+          u32 scope = resources.first_timing_scope;
+          for (u32 i = 0; i <= resources.num_scope_timestamps; i++)
+          {
+            const u64 scope_end = (i == resources.num_scope_timestamps) ? timestamps[1] : timestamps[2 + i];
+            if (scope_end > scope_start)
+            {
+              const double scope_ns_diff =
+                (scope_end - scope_start) * static_cast<double>(m_device_properties.limits.timestampPeriod);
+              m_accumulated_scope_times[scope] += static_cast<float>(scope_ns_diff / 1000000.0);
+              scope_start = scope_end;
+            }
+
+            if (i < resources.num_scope_timestamps)
+              scope = resources.scope_timestamp_ids[i];
+          }
         }
       }
       else
@@ -1172,13 +1218,16 @@ void Vulkan::Context::ActivateCommandBuffer(u32 index)
       }
     }
 
-    vkCmdResetQueryPool(resources.command_buffer, m_timestamp_query_pool, index * 2, 2);
+    vkCmdResetQueryPool(resources.command_buffer, m_timestamp_query_pool, index * TIMESTAMP_QUERIES_PER_COMMAND_BUFFER,
+                        TIMESTAMP_QUERIES_PER_COMMAND_BUFFER);
     vkCmdWriteTimestamp(resources.command_buffer, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, m_timestamp_query_pool,
-                        index * 2);
+                        index * TIMESTAMP_QUERIES_PER_COMMAND_BUFFER);
   }
 
   resources.fence_counter = m_next_fence_counter++;
   resources.timestamp_written = m_gpu_timing_enabled;
+  resources.first_timing_scope = static_cast<u8>(m_current_timing_scope);
+  resources.num_scope_timestamps = 0;
 
   m_current_frame = index;
   m_current_command_buffer = resources.command_buffer;
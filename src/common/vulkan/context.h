@@ -28,9 +28,18 @@ class Context
 public:
   enum : u32
   {
-    NUM_COMMAND_BUFFERS = 3
+    NUM_COMMAND_BUFFERS = 3,
+
+    // GPU time can be broken down into this many scopes, switched with SetTimingScope().
+    MAX_TIMING_SCOPES = 16,
+
+    // Scope switches past this count in a single command buffer are attributed to the last scope.
+    MAX_SCOPE_TIMESTAMPS = 126,
+    TIMESTAMP_QUERIES_PER_COMMAND_BUFFER = 2 + MAX_SCOPE_TIMESTAMPS,
   };
 
+  using TimingScopeTimes = std::array<float, MAX_TIMING_SCOPES>;
+
   struct OptionalExtensions
   {
     bool vk_ext_memory_budget : 1;
@@ -187,6 +196,10 @@ public:
   float GetAndResetAccumulatedGPUTime();
   bool SetEnableGPUTiming(bool enabled);
 
+  // Writes a timestamp so that GPU work recorded after this point is attributed to the specified scope.
+  void SetTimingScope(u32 scope);
+  TimingScopeTimes GetAndResetAccumulatedScopeTimes();
+
 private:
   Context(VkInstance instance, VkPhysicalDevice physical_device, bool owns_device);
 
@@ -231,6 +244,10 @@ private:
     bool needs_fence_wait = false;
     bool timestamp_written = false;
 
+    u8 first_timing_scope = 0;
+    u32 num_scope_timestamps = 0;
+    std::array<u8, MAX_SCOPE_TIMESTAMPS> scope_timestamp_ids;
+
     std::vector<std::function<void()>> cleanup_resources;
   };
 
@@ -250,6 +267,8 @@ private:
 
   VkQueryPool m_timestamp_query_pool = VK_NULL_HANDLE;
   float m_accumulated_gpu_time = 0.0f;
+  TimingScopeTimes m_accumulated_scope_times = {};
+  u32 m_current_timing_scope = 0;
   bool m_gpu_timing_enabled = false;
   bool m_gpu_timing_supported = false;
 
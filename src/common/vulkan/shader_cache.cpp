@@ -6,6 +6,7 @@
 #include "../file_system.h"
 #include "../log.h"
 #include "../md5_digest.h"
+#include "../string_util.h"
 #include "context.h"
 #include "shader_compiler.h"
 #include "util.h"
@@ -402,6 +403,11 @@ std::string ShaderCache::GetPipelineCacheBaseFileName(const std::string_view& ba
   std::string base_filename(base_path);
   base_filename += FS_OSPATH_SEPARATOR_STR "vulkan_pipelines";
 
+  // Keep a separate cache per device, so switching between GPUs doesn't throw the other one away. Driver updates are
+  // caught by the UUID in the header.
+  const VkPhysicalDeviceProperties& props = g_vulkan_context->GetDeviceProperties();
+  base_filename += StringUtil::StdStringFromFormat("_%04x_%04x", props.vendorID, props.deviceID);
+
   if (debug)
     base_filename += "_debug";
 
@@ -433,14 +439,19 @@ std::optional<ShaderCompiler::SPIRVCodeVector> ShaderCache::GetShaderSPV(ShaderC
                                                                          std::string_view shader_code)
 {
   const auto key = GetCacheKey(type, shader_code);
+  std::unique_lock lock(m_mutex);
   auto iter = m_index.find(key);
   if (iter == m_index.end())
+  {
+    lock.unlock();
     return CompileAndAddShaderSPV(key, shader_code);
+  }
 
   SPIRVCodeVector spv(iter->second.blob_size);
   if (std::fseek(m_blob_file, iter->second.file_offset, SEEK_SET) != 0 ||
       std::fread(spv.data(), sizeof(SPIRVCodeType), iter->second.blob_size, m_blob_file) != iter->second.blob_size)
   {
+    lock.unlock();
     Log_ErrorPrintf("Read blob from file failed, recompiling");
     return ShaderCompiler::CompileShader(type, shader_code, m_debug);
   }
@@ -495,7 +506,9 @@ std::optional<ShaderCompiler::SPIRVCodeVector> ShaderCache::CompileAndAddShaderS
   if (!spv.has_value())
     return {};
 
-  if (!m_blob_file || std::fseek(m_blob_file, 0, SEEK_END) != 0)
+  // Another thread may have compiled the same shader in the meantime.
+  std::unique_lock lock(m_mutex);
+  if (!m_blob_file || m_index.find(key) != m_index.end() || std::fseek(m_blob_file, 0, SEEK_END) != 0)
     return spv;
 
   CacheIndexData data;
@@ -8,6 +8,7 @@
 #include "shader_compiler.h"
 #include <cstdio>
 #include <memory>
+#include <mutex>
 #include <optional>
 #include <string>
 #include <string_view>
@@ -93,6 +94,8 @@ private:
   std::FILE* m_blob_file = nullptr;
   std::string m_pipeline_cache_filename;
 
+  // Guards the index and the files, shaders are compiled outside the lock.
+  std::mutex m_mutex;
   CacheIndex m_index;
 
   VkPipelineCache m_pipeline_cache = VK_NULL_HANDLE;
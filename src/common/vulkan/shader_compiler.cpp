@@ -6,9 +6,11 @@
 #include "../log.h"
 #include "../string_util.h"
 #include "util.h"
+#include <atomic>
 #include <cstring>
 #include <fstream>
 #include <memory>
+#include <mutex>
 Log_SetChannel(Vulkan::ShaderCompiler);
 
 // glslang includes
@@ -20,8 +22,10 @@ namespace Vulkan::ShaderCompiler {
 // Registers itself for cleanup via atexit
 bool InitializeGlslang();
 
-static unsigned s_next_bad_shader_id = 1;
+static std::atomic<unsigned> s_next_bad_shader_id{1};
 
+// Shaders can be compiled from multiple threads at once.
+static std::mutex glslang_mutex;
 static bool glslang_initialized = false;
 
 static std::optional<SPIRVCodeVector> CompileShaderToSPV(EShLanguage stage, const char* stage_filename,
@@ -113,6 +117,7 @@ static std::optional<SPIRVCodeVector> CompileShaderToSPV(EShLanguage stage, cons
 
 bool InitializeGlslang()
 {
+  std::unique_lock lock(glslang_mutex);
   if (glslang_initialized)
     return true;
 
@@ -130,6 +135,7 @@ bool InitializeGlslang()
 
 void DeinitializeGlslang()
 {
+  std::unique_lock lock(glslang_mutex);
   if (!glslang_initialized)
     return;
 
@@ -5,19 +5,25 @@
 #include "../align.h"
 #include "../assert.h"
 #include "../log.h"
+#include "../timer.h"
 #include "context.h"
 #include "util.h"
+#include <algorithm>
+#include <utility>
 Log_SetChannel(Vulkan::StreamBuffer);
 
 namespace Vulkan {
 StreamBuffer::StreamBuffer() = default;
 
 StreamBuffer::StreamBuffer(StreamBuffer&& move)
-  : m_size(move.m_size), m_current_offset(move.m_current_offset), m_current_space(move.m_current_space),
-    m_current_gpu_position(move.m_current_gpu_position), m_allocation(move.m_allocation), m_buffer(move.m_buffer),
-    m_host_pointer(move.m_host_pointer), m_tracked_fences(std::move(move.m_tracked_fences))
+  : m_usage(move.m_usage), m_size(move.m_size), m_max_size(move.m_max_size), m_current_offset(move.m_current_offset),
+    m_current_space(move.m_current_space), m_current_gpu_position(move.m_current_gpu_position),
+    m_allocation(move.m_allocation), m_buffer(move.m_buffer), m_host_pointer(move.m_host_pointer),
+    m_tracked_fences(std::move(move.m_tracked_fences)), m_stats(move.m_stats)
 {
+  move.m_usage = 0;
   move.m_size = 0;
+  move.m_max_size = 0;
   move.m_current_offset = 0;
   move.m_current_space = 0;
   move.m_current_gpu_position = 0;
@@ -37,18 +43,32 @@ StreamBuffer& StreamBuffer::operator=(StreamBuffer&& move)
   if (IsValid())
     Destroy(true);
 
+  std::swap(m_usage, move.m_usage);
   std::swap(m_size, move.m_size);
+  std::swap(m_max_size, move.m_max_size);
   std::swap(m_current_offset, move.m_current_offset);
   std::swap(m_current_space, move.m_current_space);
   std::swap(m_current_gpu_position, move.m_current_gpu_position);
+  std::swap(m_allocation, move.m_allocation);
   std::swap(m_buffer, move.m_buffer);
   std::swap(m_host_pointer, move.m_host_pointer);
   std::swap(m_tracked_fences, move.m_tracked_fences);
+  std::swap(m_stats, move.m_stats);
 
   return *this;
 }
 
-bool StreamBuffer::Create(VkBufferUsageFlags usage, u32 size)
+bool StreamBuffer::Create(VkBufferUsageFlags usage, u32 size, u32 max_size /* = 0 */)
+{
+  if (!AllocateBuffer(usage, size))
+    return false;
+
+  m_max_size = std::max(size, max_size);
+  m_stats = {};
+  return true;
+}
+
+bool StreamBuffer::AllocateBuffer(VkBufferUsageFlags usage, u32 size)
 {
   const VkBufferCreateInfo bci = {VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
                                   nullptr,
@@ -74,12 +94,14 @@ bool StreamBuffer::Create(VkBufferUsageFlags usage, u32 size)
     return false;
   }
 
+  // Replace with the new buffer. The old one is kept alive until the GPU is done with it.
   if (IsValid())
-    Destroy(true);
+    g_vulkan_context->DeferBufferDestruction(m_buffer, m_allocation);
 
-  // Replace with the new buffer
+  m_usage = usage;
   m_size = size;
   m_current_offset = 0;
+  m_current_space = size;
   m_current_gpu_position = 0;
   m_tracked_fences.clear();
   m_allocation = new_allocation;
@@ -99,6 +121,7 @@ void StreamBuffer::Destroy(bool defer)
   }
 
   m_size = 0;
+  m_max_size = 0;
   m_current_offset = 0;
   m_current_gpu_position = 0;
   m_tracked_fences.clear();
@@ -112,7 +135,7 @@ bool StreamBuffer::ReserveMemory(u32 num_bytes, u32 alignment)
   const u32 required_bytes = num_bytes + alignment;
 
   // Check for sane allocations
-  if (required_bytes > m_size)
+  if (required_bytes > m_size && !Grow(required_bytes))
   {
     Log_ErrorPrintf("Attempting to allocate %u bytes from a %u byte stream buffer", static_cast<u32>(num_bytes),
                     static_cast<u32>(m_size));
@@ -161,6 +184,10 @@ bool StreamBuffer::ReserveMemory(u32 num_bytes, u32 alignment)
     }
   }
 
+  // Rather than stalling until the GPU catches up, switch to a bigger buffer if we're allowed to.
+  if (Grow(required_bytes))
+    return true;
+
   // Can we find a fence to wait on that will give us enough memory?
   if (WaitForClearSpace(required_bytes))
   {
@@ -189,6 +216,33 @@ void StreamBuffer::CommitMemory(u32 final_num_bytes)
   UpdateCurrentFencePosition();
 }
 
+StreamBuffer::Stats StreamBuffer::GetAndResetStats()
+{
+  return std::exchange(m_stats, Stats{});
+}
+
+bool StreamBuffer::Grow(u32 required_bytes)
+{
+  if (m_size >= m_max_size)
+    return false;
+
+  // Doubling means we'll quickly settle on whatever the game needs per frame.
+  const u32 new_size = std::min(std::max(m_size * 2, required_bytes), m_max_size);
+  if (new_size < required_bytes)
+    return false;
+
+  Log_DevPrintf("Growing stream buffer from %u to %u bytes", m_size, new_size);
+  if (!AllocateBuffer(m_usage, new_size))
+  {
+    // don't try again
+    m_max_size = m_size;
+    return false;
+  }
+
+  m_stats.num_grows++;
+  return true;
+}
+
 void StreamBuffer::UpdateCurrentFencePosition()
 {
   // Has the offset changed since the last fence?
@@ -300,7 +354,13 @@ bool StreamBuffer::WaitForClearSpace(u32 num_bytes)
     return false;
 
   // Wait until this fence is signaled. This will fire the callback, updating the GPU position.
-  g_vulkan_context->WaitForFenceCounter(iter->first);
+  if (g_vulkan_context->GetCompletedFenceCounter() < iter->first)
+  {
+    Common::Timer timer;
+    g_vulkan_context->WaitForFenceCounter(iter->first);
+    m_stats.num_waits++;
+    m_stats.wait_time_us += static_cast<u32>(timer.GetTimeNanoseconds() / 1000.0);
+  }
   m_tracked_fences.erase(m_tracked_fences.begin(), m_current_offset == iter->second ? m_tracked_fences.end() : ++iter);
   m_current_offset = new_offset;
   m_current_space = new_space;
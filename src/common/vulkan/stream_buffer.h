@@ -13,6 +13,14 @@ namespace Vulkan {
 class StreamBuffer
 {
 public:
+  /// Time spent stalled waiting for the GPU to release space, and the number of times the buffer was grown instead.
+  struct Stats
+  {
+    u32 num_waits;
+    u32 wait_time_us;
+    u32 num_grows;
+  };
+
   StreamBuffer();
   StreamBuffer(StreamBuffer&& move);
   StreamBuffer(const StreamBuffer&) = delete;
@@ -31,21 +39,29 @@ public:
   ALWAYS_INLINE u32 GetCurrentSpace() const { return m_current_space; }
   ALWAYS_INLINE u32 GetCurrentOffset() const { return m_current_offset; }
 
-  bool Create(VkBufferUsageFlags usage, u32 size);
+  /// If max_size is larger than size, the buffer is replaced with a larger one when it would otherwise have to wait
+  /// for the GPU. The buffer handle changes when this happens, so it should only be used for buffers which are bound
+  /// directly, not through descriptor sets, and callers need to check GetBuffer() after reserving memory.
+  bool Create(VkBufferUsageFlags usage, u32 size, u32 max_size = 0);
   void Destroy(bool defer);
 
   bool ReserveMemory(u32 num_bytes, u32 alignment);
   void CommitMemory(u32 final_num_bytes);
 
+  Stats GetAndResetStats();
+
 private:
   bool AllocateBuffer(VkBufferUsageFlags usage, u32 size);
+  bool Grow(u32 required_bytes);
   void UpdateCurrentFencePosition();
   void UpdateGPUPosition();
 
   // Waits for as many fences as needed to allocate num_bytes bytes from the buffer.
   bool WaitForClearSpace(u32 num_bytes);
 
+  VkBufferUsageFlags m_usage = 0;
   u32 m_size = 0;
+  u32 m_max_size = 0;
   u32 m_current_offset = 0;
   u32 m_current_space = 0;
   u32 m_current_gpu_position = 0;
@@ -56,6 +72,8 @@ private:
 
   // List of fences and the corresponding positions in the buffer
   std::deque<std::pair<u64, u32>> m_tracked_fences;
+
+  Stats m_stats = {};
 };
 
 } // namespace Vulkan
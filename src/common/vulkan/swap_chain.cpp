@@ -557,6 +557,13 @@ bool SwapChain::SelectPresentMode()
     return true;
   }
 
+  // With triple buffering, show the newest complete frame at each refresh instead of tearing.
+  if (m_triple_buffering && CheckForMode(VK_PRESENT_MODE_MAILBOX_KHR))
+  {
+    m_present_mode = VK_PRESENT_MODE_MAILBOX_KHR;
+    return true;
+  }
+
   // Prefer screen-tearing, if possible, for lowest latency.
   if (CheckForMode(VK_PRESENT_MODE_IMMEDIATE_KHR))
   {
@@ -592,8 +599,10 @@ bool SwapChain::CreateSwapChain()
   if (!SelectSurfaceFormat() || !SelectPresentMode())
     return false;
 
-  // Select number of images in swap chain, we prefer one buffer in the background to work on
-  u32 image_count = std::max(surface_capabilities.minImageCount, 2u);
+  // Select number of images in swap chain, we prefer one buffer in the background to work on. Mailbox needs a third,
+  // otherwise we'd have to wait for the queued image to be shown before we could render another.
+  const u32 wanted_image_count = (m_present_mode == VK_PRESENT_MODE_MAILBOX_KHR) ? 3u : 2u;
+  u32 image_count = std::max(surface_capabilities.minImageCount, wanted_image_count);
 
   // maxImageCount can be zero, in which case there isn't an upper limit on the number of buffers.
   if (surface_capabilities.maxImageCount > 0)
@@ -793,13 +802,14 @@ bool SwapChain::RecreateSwapChain()
   return true;
 }
 
-bool SwapChain::SetVSync(bool enabled)
+bool SwapChain::SetVSync(bool enabled, bool triple_buffering)
 {
-  if (m_vsync_enabled == enabled)
+  if (m_vsync_enabled == enabled && m_triple_buffering == triple_buffering)
     return true;
 
   // Recreate the swap chain with the new present mode.
   m_vsync_enabled = enabled;
+  m_triple_buffering = triple_buffering;
   return RecreateSwapChain();
 }
 
@@ -41,6 +41,7 @@ public:
   ALWAYS_INLINE VkSurfaceFormatKHR GetSurfaceFormat() const { return m_surface_format; }
   ALWAYS_INLINE VkFormat GetTextureFormat() const { return m_surface_format.format; }
   ALWAYS_INLINE bool IsVSyncEnabled() const { return m_vsync_enabled; }
+  ALWAYS_INLINE bool IsTripleBufferingEnabled() const { return m_triple_buffering; }
   ALWAYS_INLINE VkSwapchainKHR GetSwapChain() const { return m_swap_chain; }
   ALWAYS_INLINE const WindowInfo& GetWindowInfo() const { return m_window_info; }
   ALWAYS_INLINE u32 GetWidth() const { return m_window_info.surface_width; }
@@ -61,8 +62,9 @@ public:
   bool ResizeSwapChain(u32 new_width = 0, u32 new_height = 0);
   bool RecreateSwapChain();
 
-  // Change vsync enabled state. This may fail as it causes a swapchain recreation.
-  bool SetVSync(bool enabled);
+  // Change vsync/triple buffering state. This may fail as it causes a swapchain recreation.
+  // Triple buffering uses mailbox presentation when vsync is off, so frames don't tear.
+  bool SetVSync(bool enabled, bool triple_buffering);
 
 private:
   bool SelectSurfaceFormat();
@@ -102,6 +104,7 @@ private:
   std::vector<SwapChainImage> m_images;
   u32 m_current_image = 0;
   bool m_vsync_enabled = false;
+  bool m_triple_buffering = false;
 };
 
 } // namespace Vulkan
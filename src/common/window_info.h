@@ -37,6 +37,9 @@ struct WindowInfo
   float surface_scale = 1.0f;
   SurfaceFormat surface_format = SurfaceFormat::RGB8;
 
+  // Fraction of the display mode to render at, where the display controller scales up on scanout (DRM/KMS).
+  float surface_render_scale = 1.0f;
+
   // Needed for macOS.
 #ifdef __APPLE__
   void* surface_handle = nullptr;
@@ -0,0 +1,242 @@
+// SPDX-FileCopyrightText: 2019-2023 Connor McLaughlin <stenzek@gmail.com>
+// SPDX-License-Identifier: (GPL-3.0 OR CC-BY-NC-ND-4.0)
+
+#include "benchmark.h"
+#include "common/log.h"
+#include "common/string_util.h"
+#include "core/settings.h"
+#include "core/timing_event.h"
+#include <algorithm>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <optional>
+
+namespace Benchmark {
+
+namespace {
+struct Entry
+{
+  const char* name;
+  Function func;
+};
+} // namespace
+
+static std::vector<Entry>& GetEntries();
+static void RunBenchmark(const Entry& entry);
+static bool ParseCommandLine(int argc, char* argv[]);
+static void PrintCommandLineHelp(const char* progname);
+
+static std::string s_filter;
+static std::string s_chd_path;
+static double s_min_time = 0.5;
+
+// Keeps the event list non-empty, since components are run on their own without the rest of the system.
+static std::unique_ptr<TimingEvent> s_idle_event;
+
+} // namespace Benchmark
+
+Benchmark::State::State(u64 iterations) : m_iterations(iterations), m_iterations_remaining(iterations) {}
+
+void Benchmark::State::Skip(std::string message)
+{
+  m_skip_message = std::move(message);
+  m_iterations_remaining = 0;
+}
+
+std::vector<Benchmark::Entry>& Benchmark::GetEntries()
+{
+  // Function-local, since registration happens during static initialization.
+  static std::vector<Entry> entries;
+  return entries;
+}
+
+bool Benchmark::Register(const char* name, Function func)
+{
+  GetEntries().push_back(Entry{name, func});
+  return true;
+}
+
+const std::string& Benchmark::GetCHDPath()
+{
+  return s_chd_path;
+}
+
+void Benchmark::FillRandom(void* data, size_t size, u32 seed)
+{
+  // xorshift32, the exact sequence doesn't matter as long as it never changes.
+  u32 state = (seed != 0) ? seed : 1;
+  u8* ptr = static_cast<u8*>(data);
+  for (size_t i = 0; i < size; i++)
+  {
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    ptr[i] = static_cast<u8>(state >> 24);
+  }
+}
+
+std::vector<u8> Benchmark::MakeRandomData(size_t size, u32 seed)
+{
+  std::vector<u8> data(size);
+  FillRandom(data.data(), size, seed);
+  return data;
+}
+
+void Benchmark::RunBenchmark(const Entry& entry)
+{
+  // The first run is a single iteration, which also warms up the caches. The count is then scaled until a run takes
+  // at least the minimum time.
+  u64 iterations = 1;
+  for (;;)
+  {
+    State state(iterations);
+    entry.func(state);
+    if (!state.GetSkipMessage().empty())
+    {
+      std::fprintf(stdout, "%-48s skipped: %s\n", entry.name, state.GetSkipMessage().c_str());
+      return;
+    }
+
+    const double elapsed = state.GetElapsedSeconds();
+    if (elapsed < s_min_time && iterations < UINT64_C(1000000000))
+    {
+      const double scale = (elapsed > 0.0) ? std::clamp(s_min_time * 1.4 / elapsed, 2.0, 10.0) : 10.0;
+      iterations = static_cast<u64>(static_cast<double>(iterations) * scale);
+      continue;
+    }
+
+    const double ns_per_iteration = (elapsed * 1e9) / static_cast<double>(iterations);
+    std::fprintf(stdout, "%-48s %14.1f ns/iter %12" PRIu64 " iters", entry.name, ns_per_iteration, iterations);
+    if (state.GetBytesPerIteration() > 0)
+    {
+      const double bytes = static_cast<double>(state.GetBytesPerIteration()) * static_cast<double>(iterations);
+      std::fprintf(stdout, " %10.2f MB/s", bytes / elapsed / 1048576.0);
+    }
+    if (state.GetItemsPerIteration() > 0)
+    {
+      const double items = static_cast<double>(state.GetItemsPerIteration()) * static_cast<double>(iterations);
+      std::fprintf(stdout, " %10.3f M items/s", items / elapsed / 1e6);
+    }
+    std::fputc('\n', stdout);
+    std::fflush(stdout);
+    return;
+  }
+}
+
+void Benchmark::PrintCommandLineHelp(const char* progname)
+{
+  std::fprintf(stderr, "Usage: %s [parameters]\n", progname);
+  std::fprintf(stderr, "\n");
+  std::fprintf(stderr, "  -filter <substring>: Only runs benchmarks whose name contains the string.\n");
+  std::fprintf(stderr, "  -mintime <seconds>: Minimum time to run each benchmark for (default 0.5).\n");
+  std::fprintf(stderr, "  -chd <path>: CHD image to use for the CHD benchmarks. They're skipped without one.\n");
+  std::fprintf(stderr, "  -list: Lists the benchmarks and exits.\n");
+  std::fprintf(stderr, "  -log <level>: Enables logging at the given level (e.g. Info).\n");
+  std::fprintf(stderr, "  -help: Displays this information and exits.\n");
+  std::fprintf(stderr, "\n");
+}
+
+bool Benchmark::ParseCommandLine(int argc, char* argv[])
+{
+  for (int i = 1; i < argc; i++)
+  {
+    const char* arg = argv[i];
+    const bool has_value = (i < (argc - 1));
+    if (std::strcmp(arg, "-filter") == 0 && has_value)
+    {
+      s_filter = argv[++i];
+      continue;
+    }
+    else if (std::strcmp(arg, "-mintime") == 0 && has_value)
+    {
+      const std::optional<double> value = StringUtil::FromChars<double>(argv[++i]);
+      if (!value.has_value() || value.value() <= 0.0)
+      {
+        std::fprintf(stderr, "Invalid minimum time: %s\n", argv[i]);
+        return false;
+      }
+
+      s_min_time = value.value();
+      continue;
+    }
+    else if (std::strcmp(arg, "-chd") == 0 && has_value)
+    {
+      s_chd_path = argv[++i];
+      continue;
+    }
+    else if (std::strcmp(arg, "-list") == 0)
+    {
+      for (const Entry& entry : GetEntries())
+        std::fprintf(stdout, "%s\n", entry.name);
+      std::exit(EXIT_SUCCESS);
+    }
+    else if (std::strcmp(arg, "-log") == 0 && has_value)
+    {
+      const std::optional<LOGLEVEL> level = Settings::ParseLogLevelName(argv[++i]);
+      if (!level.has_value())
+      {
+        std::fprintf(stderr, "Invalid log level: %s\n", argv[i]);
+        return false;
+      }
+
+      Log::SetConsoleOutputParams(true, nullptr, level.value());
+      continue;
+    }
+    else if (std::strcmp(arg, "-help") == 0)
+    {
+      PrintCommandLineHelp(argv[0]);
+      std::exit(EXIT_SUCCESS);
+    }
+
+    std::fprintf(stderr, "Unknown parameter: '%s'\n", arg);
+    return false;
+  }
+
+  return true;
+}
+
+int main(int argc, char* argv[])
+{
+  if (!Benchmark::ParseCommandLine(argc, argv))
+  {
+    Benchmark::PrintCommandLineHelp(argv[0]);
+    return EXIT_FAILURE;
+  }
+
+  // Each component is driven directly from the benchmark thread.
+  g_settings.gpu_use_thread = false;
+  g_settings.mdec_decode_thread = false;
+  TimingEvents::Initialize();
+  Benchmark::s_idle_event =
+    TimingEvents::CreateTimingEvent("Benchmark Idle", 1000000, 1000000, [](void*, TickCount, TickCount) {}, nullptr,
+                                    true);
+
+  std::vector<Benchmark::Entry> entries = Benchmark::GetEntries();
+  std::sort(entries.begin(), entries.end(), [](const Benchmark::Entry& lhs, const Benchmark::Entry& rhs) {
+    return std::strcmp(lhs.name, rhs.name) < 0;
+  });
+
+  u32 num_run = 0;
+  for (const Benchmark::Entry& entry : entries)
+  {
+    if (!Benchmark::s_filter.empty() && !std::strstr(entry.name, Benchmark::s_filter.c_str()))
+      continue;
+
+    Benchmark::RunBenchmark(entry);
+    num_run++;
+  }
+
+  Benchmark::s_idle_event.reset();
+  TimingEvents::Shutdown();
+
+  if (num_run == 0)
+  {
+    std::fprintf(stderr, "No benchmarks matched the filter '%s'.\n", Benchmark::s_filter.c_str());
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,85 @@
+// SPDX-FileCopyrightText: 2019-2023 Connor McLaughlin <stenzek@gmail.com>
+// SPDX-License-Identifier: (GPL-3.0 OR CC-BY-NC-ND-4.0)
+
+#pragma once
+#include "common/timer.h"
+#include "common/types.h"
+#include <string>
+#include <vector>
+
+namespace Benchmark {
+
+class State
+{
+public:
+  explicit State(u64 iterations);
+
+  /// Returns true while the timed loop should continue. The timer starts on the first call, so setup before the loop
+  /// isn't measured.
+  ALWAYS_INLINE bool KeepRunning()
+  {
+    if (LIKELY(m_iterations_remaining > 0))
+    {
+      if (UNLIKELY(m_iterations_remaining-- == m_iterations))
+        m_start_time = Common::Timer::GetCurrentValue();
+
+      return true;
+    }
+
+    m_end_time = Common::Timer::GetCurrentValue();
+    return false;
+  }
+
+  ALWAYS_INLINE u64 GetIterations() const { return m_iterations; }
+  ALWAYS_INLINE double GetElapsedSeconds() const
+  {
+    return Common::Timer::ConvertValueToSeconds(m_end_time - m_start_time);
+  }
+
+  ALWAYS_INLINE u64 GetBytesPerIteration() const { return m_bytes_per_iteration; }
+  ALWAYS_INLINE u64 GetItemsPerIteration() const { return m_items_per_iteration; }
+  ALWAYS_INLINE const std::string& GetSkipMessage() const { return m_skip_message; }
+
+  /// Throughput is reported when either of these are set.
+  ALWAYS_INLINE void SetBytesPerIteration(u64 bytes) { m_bytes_per_iteration = bytes; }
+  ALWAYS_INLINE void SetItemsPerIteration(u64 items) { m_items_per_iteration = items; }
+
+  /// Stops the benchmark without a result, e.g. when the input isn't available. Must be called before the loop.
+  void Skip(std::string message);
+
+private:
+  u64 m_iterations;
+  u64 m_iterations_remaining;
+  u64 m_bytes_per_iteration = 0;
+  u64 m_items_per_iteration = 0;
+  Common::Timer::Value m_start_time = 0;
+  Common::Timer::Value m_end_time = 0;
+  std::string m_skip_message;
+};
+
+using Function = void (*)(State& state);
+
+bool Register(const char* name, Function func);
+
+/// Keeps the compiler from discarding a computed value.
+template<typename T>
+ALWAYS_INLINE void DoNotOptimize(const T& value)
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+  const volatile T* ptr = &value;
+  (void)*ptr;
+#else
+  asm volatile("" : : "r,m"(value) : "memory");
+#endif
+}
+
+/// Path to a CHD image for the CHD benchmarks, from the command line. Empty if none was given.
+const std::string& GetCHDPath();
+
+/// Fills a buffer with the same pseudo-random bytes on every run, so inputs don't need to be shipped as binaries.
+void FillRandom(void* data, size_t size, u32 seed);
+std::vector<u8> MakeRandomData(size_t size, u32 seed);
+
+} // namespace Benchmark
+
+#define BENCHMARK(func) static const bool s_benchmark_registered_##func = Benchmark::Register(#func, &func)
@@ -0,0 +1,101 @@
+// SPDX-FileCopyrightText: 2019-2023 Connor McLaughlin <stenzek@gmail.com>
+// SPDX-License-Identifier: (GPL-3.0 OR CC-BY-NC-ND-4.0)
+
+#include "benchmark.h"
+#include "common/error.h"
+#include "util/cd_image.h"
+#include "util/cd_xa.h"
+#include <algorithm>
+#include <array>
+#include <memory>
+#include <vector>
+
+namespace {
+enum : u32
+{
+  NUM_XA_SECTORS = 64,
+  SUBHEADER_OFFSET = CDImage::SECTOR_SYNC_SIZE + sizeof(CDImage::SectorHeader),
+};
+} // namespace
+
+static void DecodeXASectors(Benchmark::State& state, u8 codinginfo)
+{
+  // Random ADPCM data, with the subheader patched to the requested format.
+  std::vector<u8> sectors = Benchmark::MakeRandomData(NUM_XA_SECTORS * CDImage::RAW_SECTOR_SIZE, 0x58413031u);
+  for (u32 i = 0; i < NUM_XA_SECTORS; i++)
+  {
+    u8* subheader = &sectors[i * CDImage::RAW_SECTOR_SIZE + SUBHEADER_OFFSET];
+    subheader[2] = 0x64; // audio, form 2, realtime
+    subheader[3] = codinginfo;
+    std::copy_n(subheader, CDXA::XA_SUBHEADER_SIZE, subheader + CDXA::XA_SUBHEADER_SIZE);
+  }
+
+  std::array<s16, CDXA::XA_ADPCM_SAMPLES_PER_SECTOR_4BIT> samples;
+  std::array<s32, 4> last_samples = {};
+  u32 index = 0;
+  while (state.KeepRunning())
+  {
+    CDXA::DecodeADPCMSector(&sectors[index * CDImage::RAW_SECTOR_SIZE], samples.data(), last_samples.data());
+    index = (index + 1) % NUM_XA_SECTORS;
+  }
+
+  Benchmark::DoNotOptimize(samples[0]);
+  state.SetItemsPerIteration(1);
+  state.SetBytesPerIteration(CDImage::RAW_SECTOR_SIZE);
+}
+
+static void XA_Decode4BitStereo(Benchmark::State& state)
+{
+  DecodeXASectors(state, 0x01);
+}
+BENCHMARK(XA_Decode4BitStereo);
+
+static void XA_Decode4BitMono(Benchmark::State& state)
+{
+  DecodeXASectors(state, 0x00);
+}
+BENCHMARK(XA_Decode4BitMono);
+
+static void XA_Decode8BitStereo(Benchmark::State& state)
+{
+  DecodeXASectors(state, 0x11);
+}
+BENCHMARK(XA_Decode8BitStereo);
+
+static void CHD_SequentialRead(Benchmark::State& state)
+{
+  // CHDs can't be generated here, and aren't small enough to ship, so this needs an image from the command line.
+  const std::string& path = Benchmark::GetCHDPath();
+  if (path.empty())
+  {
+    state.Skip("no image given with -chd");
+    return;
+  }
+
+  Common::Error error;
+  std::unique_ptr<CDImage> image = CDImage::OpenCHDImage(path.c_str(), &error);
+  if (!image)
+  {
+    state.Skip(error.GetCodeAndMessage().GetCharArray());
+    return;
+  }
+
+  // Reading every sector in order decompresses each hunk once, which is the pattern when streaming FMVs.
+  const CDImage::LBA lba_count = image->GetLBACount();
+  std::array<u8, CDImage::RAW_SECTOR_SIZE> buffer;
+  CDImage::LBA lba = 0;
+  image->Seek(lba);
+  while (state.KeepRunning())
+  {
+    if (!image->ReadRawSector(buffer.data(), nullptr) || ++lba == lba_count)
+    {
+      lba = 0;
+      image->Seek(lba);
+    }
+  }
+
+  Benchmark::DoNotOptimize(buffer[0]);
+  state.SetItemsPerIteration(1);
+  state.SetBytesPerIteration(CDImage::RAW_SECTOR_SIZE);
+}
+BENCHMARK(CHD_SequentialRead);
@@ -0,0 +1,183 @@
+// SPDX-FileCopyrightText: 2019-2023 Connor McLaughlin <stenzek@gmail.com>
+// SPDX-License-Identifier: (GPL-3.0 OR CC-BY-NC-ND-4.0)
+
+#include "benchmark.h"
+#include "core/gpu_sw_backend.h"
+#include <array>
+#include <memory>
+#include <vector>
+
+namespace {
+enum : u32
+{
+  PRIMITIVES_PER_ITERATION = 256,
+  DRAWING_AREA_WIDTH = 640,
+  DRAWING_AREA_HEIGHT = 480,
+
+  // The texture page and CLUT live to the right of the drawing area, as they would in a game.
+  TEXTURE_PAGE_X = 768,
+  TEXTURE_PAGE_Y = 0,
+  CLUT_X = 768,
+  CLUT_Y = 480,
+};
+
+struct PrimitiveOptions
+{
+  bool shaded;
+  bool textured;
+  bool transparent;
+  GPUTextureMode texture_mode;
+};
+} // namespace
+
+static std::unique_ptr<GPU_SW_Backend> CreateBackend()
+{
+  std::unique_ptr<GPU_SW_Backend> backend = std::make_unique<GPU_SW_Backend>();
+  backend->Initialize(false);
+  backend->Reset(true);
+
+  // Noise everywhere, so textures and blending see realistic data.
+  Benchmark::FillRandom(backend->GetVRAM(), VRAM_WIDTH * VRAM_HEIGHT * sizeof(u16), 0x47505531u);
+
+  GPUBackendSetDrawingAreaCommand* cmd = backend->NewSetDrawingAreaCommand();
+  cmd->params.bits = 0;
+  cmd->new_area = Common::Rectangle<u32>(0, 0, DRAWING_AREA_WIDTH - 1, DRAWING_AREA_HEIGHT - 1);
+  backend->PushCommand(cmd);
+  return backend;
+}
+
+static void FillDrawCommand(GPUBackendDrawCommand* cmd, GPUPrimitive primitive, const PrimitiveOptions& options)
+{
+  cmd->params.bits = 0;
+  cmd->rc.bits = 0;
+  cmd->rc.primitive = primitive;
+  cmd->rc.shading_enable = options.shaded;
+  cmd->rc.texture_enable = options.textured;
+  cmd->rc.transparency_enable = options.transparent;
+
+  cmd->draw_mode.bits = 0;
+  cmd->draw_mode.texture_page_x_base = TEXTURE_PAGE_X / 64;
+  cmd->draw_mode.texture_page_y_base = TEXTURE_PAGE_Y / 256;
+  cmd->draw_mode.texture_mode = options.texture_mode;
+  cmd->draw_mode.transparency_mode = GPUTransparencyMode::HalfBackgroundPlusHalfForeground;
+  cmd->draw_mode.dither_enable = true;
+
+  cmd->palette.bits = 0;
+  cmd->palette.x = CLUT_X / 16;
+  cmd->palette.y = CLUT_Y;
+  cmd->window = {0xFF, 0xFF, 0x00, 0x00};
+}
+
+static void DrawTriangles(Benchmark::State& state, const PrimitiveOptions& options)
+{
+  std::unique_ptr<GPU_SW_Backend> backend = CreateBackend();
+
+  // Triangles with edges of up to 64 pixels, scattered over the drawing area.
+  struct Triangle
+  {
+    std::array<s32, 3> x, y;
+    std::array<u32, 3> color;
+    std::array<u16, 3> texcoord;
+  };
+  std::vector<Triangle> triangles(PRIMITIVES_PER_ITERATION);
+  std::vector<u8> random = Benchmark::MakeRandomData(PRIMITIVES_PER_ITERATION * 32, 0x54524931u);
+  for (u32 i = 0; i < PRIMITIVES_PER_ITERATION; i++)
+  {
+    const u8* r = &random[i * 32];
+    Triangle& tri = triangles[i];
+    const s32 base_x = static_cast<s32>((ZeroExtend32(r[0]) * (DRAWING_AREA_WIDTH - 64)) / 255);
+    const s32 base_y = static_cast<s32>((ZeroExtend32(r[1]) * (DRAWING_AREA_HEIGHT - 64)) / 255);
+    for (u32 j = 0; j < 3; j++)
+    {
+      tri.x[j] = base_x + (r[2 + j] % 64);
+      tri.y[j] = base_y + (r[5 + j] % 64);
+      tri.color[j] = ZeroExtend32(r[8 + j]) | (ZeroExtend32(r[11 + j]) << 8) | (ZeroExtend32(r[14 + j]) << 16);
+      tri.texcoord[j] = static_cast<u16>(ZeroExtend32(r[17 + j]) | (ZeroExtend32(r[20 + j]) << 8));
+    }
+  }
+
+  while (state.KeepRunning())
+  {
+    for (const Triangle& tri : triangles)
+    {
+      GPUBackendDrawPolygonCommand* cmd = backend->NewDrawPolygonCommand(3);
+      FillDrawCommand(cmd, GPUPrimitive::Polygon, options);
+      for (u32 j = 0; j < 3; j++)
+        cmd->vertices[j].Set(tri.x[j], tri.y[j], tri.color[j], tri.texcoord[j]);
+      backend->PushCommand(cmd);
+    }
+  }
+
+  Benchmark::DoNotOptimize(backend->GetPixel(0, 0));
+  backend->Shutdown();
+  state.SetItemsPerIteration(PRIMITIVES_PER_ITERATION);
+}
+
+static void DrawRectangles(Benchmark::State& state, const PrimitiveOptions& options, u16 width, u16 height)
+{
+  std::unique_ptr<GPU_SW_Backend> backend = CreateBackend();
+
+  std::vector<u8> random = Benchmark::MakeRandomData(PRIMITIVES_PER_ITERATION * 8, 0x52454331u);
+  while (state.KeepRunning())
+  {
+    for (u32 i = 0; i < PRIMITIVES_PER_ITERATION; i++)
+    {
+      const u8* r = &random[i * 8];
+      GPUBackendDrawRectangleCommand* cmd = backend->NewDrawRectangleCommand();
+      FillDrawCommand(cmd, GPUPrimitive::Rectangle, options);
+      cmd->x = static_cast<s32>((ZeroExtend32(r[0]) * (DRAWING_AREA_WIDTH - width)) / 255);
+      cmd->y = static_cast<s32>((ZeroExtend32(r[1]) * (DRAWING_AREA_HEIGHT - height)) / 255);
+      cmd->width = width;
+      cmd->height = height;
+      cmd->texcoord = static_cast<u16>(ZeroExtend32(r[2]) | (ZeroExtend32(r[3]) << 8));
+      cmd->color = ZeroExtend32(r[4]) | (ZeroExtend32(r[5]) << 8) | (ZeroExtend32(r[6]) << 16);
+      backend->PushCommand(cmd);
+    }
+  }
+
+  Benchmark::DoNotOptimize(backend->GetPixel(0, 0));
+  backend->Shutdown();
+  state.SetItemsPerIteration(PRIMITIVES_PER_ITERATION);
+}
+
+static void GPUSW_FlatTriangles(Benchmark::State& state)
+{
+  DrawTriangles(state, {false, false, false, GPUTextureMode::Palette4Bit});
+}
+BENCHMARK(GPUSW_FlatTriangles);
+
+static void GPUSW_ShadedTriangles(Benchmark::State& state)
+{
+  DrawTriangles(state, {true, false, false, GPUTextureMode::Palette4Bit});
+}
+BENCHMARK(GPUSW_ShadedTriangles);
+
+static void GPUSW_ShadedTextured4BitTriangles(Benchmark::State& state)
+{
+  DrawTriangles(state, {true, true, false, GPUTextureMode::Palette4Bit});
+}
+BENCHMARK(GPUSW_ShadedTextured4BitTriangles);
+
+static void GPUSW_ShadedTextured16BitTransparentTriangles(Benchmark::State& state)
+{
+  DrawTriangles(state, {true, true, true, GPUTextureMode::Direct16Bit});
+}
+BENCHMARK(GPUSW_ShadedTextured16BitTransparentTriangles);
+
+static void GPUSW_FlatRectangles64x64(Benchmark::State& state)
+{
+  DrawRectangles(state, {false, false, false, GPUTextureMode::Palette4Bit}, 64, 64);
+}
+BENCHMARK(GPUSW_FlatRectangles64x64);
+
+static void GPUSW_Textured4BitSprites16x16(Benchmark::State& state)
+{
+  DrawRectangles(state, {false, true, false, GPUTextureMode::Palette4Bit}, 16, 16);
+}
+BENCHMARK(GPUSW_Textured4BitSprites16x16);
+
+static void GPUSW_Textured8BitTransparentSprites64x64(Benchmark::State& state)
+{
+  DrawRectangles(state, {false, true, true, GPUTextureMode::Palette8Bit}, 64, 64);
+}
+BENCHMARK(GPUSW_Textured8BitTransparentSprites64x64);
@@ -0,0 +1,344 @@
+// SPDX-FileCopyrightText: 2019-2023 Connor McLaughlin <stenzek@gmail.com>
+// SPDX-License-Identifier: (GPL-3.0 OR CC-BY-NC-ND-4.0)
+
+#include "benchmark.h"
+#include "core/cpu_core.h"
+#include "core/gte.h"
+#include <array>
+
+namespace {
+enum : u32
+{
+  NUM_VERTICES = 1024,
+
+  // Data registers.
+  REG_VXY0 = 0,
+  REG_VZ0 = 1,
+  REG_VXY1 = 2,
+  REG_VZ1 = 3,
+  REG_VXY2 = 4,
+  REG_VZ2 = 5,
+  REG_RGBC = 6,
+  REG_IR1 = 9,
+  REG_MAC0 = 24,
+  REG_IRGB = 28,
+
+  // Control registers, offset by 32.
+  REG_RT11RT12 = 32,
+  REG_TRX = 37,
+  REG_L11L12 = 40,
+  REG_RBK = 45,
+  REG_LR1LR2 = 48,
+  REG_RFC = 53,
+  REG_OFX = 56,
+  REG_H = 58,
+  REG_DQA = 59,
+  REG_ZSF3 = 61,
+};
+
+// Command word bits, sf is set for all of these as games do.
+constexpr u32 MakeCommand(u32 command, u32 extra = 0)
+{
+  return (UINT32_C(0x4A) << 24) | (UINT32_C(1) << 19) | extra | command;
+}
+
+constexpr u32 CMD_RTPS = MakeCommand(0x01);
+constexpr u32 CMD_NCLIP = MakeCommand(0x06);
+constexpr u32 CMD_DPCS = MakeCommand(0x10);
+constexpr u32 CMD_INTPL = MakeCommand(0x11);
+constexpr u32 CMD_MVMVA = MakeCommand(0x12, (0 << 17) | (0 << 15) | (0 << 13));    // RT * V0 + TR
+constexpr u32 CMD_MVMVA_FC = MakeCommand(0x12, (1 << 17) | (0 << 15) | (2 << 13)); // LLM * V0 + FC, buggy
+constexpr u32 CMD_NCDS = MakeCommand(0x13);
+constexpr u32 CMD_NCDT = MakeCommand(0x16);
+constexpr u32 CMD_NCS = MakeCommand(0x1E);
+constexpr u32 CMD_NCT = MakeCommand(0x20);
+constexpr u32 CMD_AVSZ3 = MakeCommand(0x2D);
+constexpr u32 CMD_RTPT = MakeCommand(0x30);
+constexpr u32 CMD_NCCT = MakeCommand(0x3F);
+} // namespace
+
+static u32 PackXY(s16 x, s16 y)
+{
+  return ZeroExtend32(static_cast<u16>(x)) | (ZeroExtend32(static_cast<u16>(y)) << 16);
+}
+
+static void SetupGTE()
+{
+  GTE::Initialize();
+
+  // Rotation by ~30 degrees around Y, in 4.12 fixed point, and a translation which keeps everything in front.
+  GTE::WriteRegister(REG_RT11RT12 + 0, PackXY(3547, 0));
+  GTE::WriteRegister(REG_RT11RT12 + 1, PackXY(2048, 0));
+  GTE::WriteRegister(REG_RT11RT12 + 2, PackXY(4096, -2048));
+  GTE::WriteRegister(REG_RT11RT12 + 3, PackXY(0, 3547));
+  GTE::WriteRegister(REG_RT11RT12 + 4, 4096);
+  GTE::WriteRegister(REG_TRX + 0, 0);
+  GTE::WriteRegister(REG_TRX + 1, 0);
+  GTE::WriteRegister(REG_TRX + 2, 4096);
+
+  // One white light from the front-left, with some ambient.
+  GTE::WriteRegister(REG_L11L12 + 0, PackXY(-2896, 0));
+  GTE::WriteRegister(REG_L11L12 + 1, PackXY(2896, 0));
+  GTE::WriteRegister(REG_L11L12 + 2, PackXY(0, 0));
+  GTE::WriteRegister(REG_L11L12 + 3, PackXY(0, 0));
+  GTE::WriteRegister(REG_L11L12 + 4, 0);
+  GTE::WriteRegister(REG_LR1LR2 + 0, PackXY(4096, 0));
+  GTE::WriteRegister(REG_LR1LR2 + 1, PackXY(0, 0));
+  GTE::WriteRegister(REG_LR1LR2 + 2, PackXY(4096, 0));
+  GTE::WriteRegister(REG_LR1LR2 + 3, PackXY(0, 0));
+  GTE::WriteRegister(REG_LR1LR2 + 4, 4096);
+  GTE::WriteRegister(REG_RBK + 0, 512);
+  GTE::WriteRegister(REG_RBK + 1, 512);
+  GTE::WriteRegister(REG_RBK + 2, 512);
+  GTE::WriteRegister(REG_RFC + 0, 0);
+  GTE::WriteRegister(REG_RFC + 1, 0);
+  GTE::WriteRegister(REG_RFC + 2, 0);
+  GTE::WriteRegister(REG_RGBC, 0x30808080u);
+
+  // 320x240 screen, centred.
+  GTE::WriteRegister(REG_OFX + 0, 160 << 16);
+  GTE::WriteRegister(REG_OFX + 1, 120 << 16);
+  GTE::WriteRegister(REG_H, 320);
+  GTE::WriteRegister(REG_DQA, static_cast<u32>(-100) & 0xFFFFu);
+  GTE::WriteRegister(REG_DQA + 1, 0x1400000);
+  GTE::WriteRegister(REG_ZSF3, 0x155);
+  GTE::WriteRegister(REG_ZSF3 + 1, 0x100);
+}
+
+static std::array<std::array<u32, 2>, NUM_VERTICES> MakeVertices()
+{
+  std::array<std::array<s16, 3>, NUM_VERTICES> values;
+  Benchmark::FillRandom(values.data(), sizeof(values), 0x47544531u);
+
+  std::array<std::array<u32, 2>, NUM_VERTICES> vertices;
+  for (u32 i = 0; i < NUM_VERTICES; i++)
+  {
+    // Keep the model within +/- 1024 units, like a typical mesh.
+    const s16 x = static_cast<s16>(values[i][0] / 32);
+    const s16 y = static_cast<s16>(values[i][1] / 32);
+    const s16 z = static_cast<s16>(values[i][2] / 32);
+    vertices[i] = {PackXY(x, y), ZeroExtend32(static_cast<u16>(z))};
+  }
+
+  return vertices;
+}
+
+static void LoadTriangle(const std::array<std::array<u32, 2>, NUM_VERTICES>& vertices, u32 index)
+{
+  GTE::WriteRegister(REG_VXY0, vertices[index][0]);
+  GTE::WriteRegister(REG_VZ0, vertices[index][1]);
+  GTE::WriteRegister(REG_VXY1, vertices[(index + 1) % NUM_VERTICES][0]);
+  GTE::WriteRegister(REG_VZ1, vertices[(index + 1) % NUM_VERTICES][1]);
+  GTE::WriteRegister(REG_VXY2, vertices[(index + 2) % NUM_VERTICES][0]);
+  GTE::WriteRegister(REG_VZ2, vertices[(index + 2) % NUM_VERTICES][1]);
+}
+
+static void GTE_RTPS(Benchmark::State& state)
+{
+  SetupGTE();
+  const auto vertices = MakeVertices();
+  u32 index = 0;
+  while (state.KeepRunning())
+  {
+    GTE::WriteRegister(REG_VXY0, vertices[index][0]);
+    GTE::WriteRegister(REG_VZ0, vertices[index][1]);
+    GTE::ExecuteInstruction(CMD_RTPS);
+    index = (index + 1) % NUM_VERTICES;
+  }
+
+  Benchmark::DoNotOptimize(GTE::ReadRegister(REG_MAC0));
+  CPU::ResetPendingTicks();
+  state.SetItemsPerIteration(1);
+}
+BENCHMARK(GTE_RTPS);
+
+static void GTE_RTPT_NCLIP_AVSZ3(Benchmark::State& state)
+{
+  // The usual per-polygon sequence: transform, backface cull and compute the ordering table depth.
+  SetupGTE();
+  const auto vertices = MakeVertices();
+  u32 index = 0;
+  while (state.KeepRunning())
+  {
+    LoadTriangle(vertices, index);
+    GTE::ExecuteInstruction(CMD_RTPT);
+    GTE::ExecuteInstruction(CMD_NCLIP);
+    GTE::ExecuteInstruction(CMD_AVSZ3);
+    index = (index + 3) % NUM_VERTICES;
+  }
+
+  Benchmark::DoNotOptimize(GTE::ReadRegister(REG_MAC0));
+  CPU::ResetPendingTicks();
+  state.SetItemsPerIteration(1);
+}
+BENCHMARK(GTE_RTPT_NCLIP_AVSZ3);
+
+static void GTE_MVMVA(Benchmark::State& state)
+{
+  SetupGTE();
+  const auto vertices = MakeVertices();
+  u32 index = 0;
+  while (state.KeepRunning())
+  {
+    GTE::WriteRegister(REG_VXY0, vertices[index][0]);
+    GTE::WriteRegister(REG_VZ0, vertices[index][1]);
+    GTE::ExecuteInstruction(CMD_MVMVA);
+    index = (index + 1) % NUM_VERTICES;
+  }
+
+  Benchmark::DoNotOptimize(GTE::ReadRegister(REG_IRGB));
+  CPU::ResetPendingTicks();
+  state.SetItemsPerIteration(1);
+}
+BENCHMARK(GTE_MVMVA);
+
+static void GTE_MVMVA_FarColor(Benchmark::State& state)
+{
+  // Far colour as the translation takes the separate MulMatVecBuggy() path.
+  SetupGTE();
+  const auto vertices = MakeVertices();
+  u32 index = 0;
+  while (state.KeepRunning())
+  {
+    GTE::WriteRegister(REG_VXY0, vertices[index][0]);
+    GTE::WriteRegister(REG_VZ0, vertices[index][1]);
+    GTE::ExecuteInstruction(CMD_MVMVA_FC);
+    index = (index + 1) % NUM_VERTICES;
+  }
+
+  Benchmark::DoNotOptimize(GTE::ReadRegister(REG_IRGB));
+  CPU::ResetPendingTicks();
+  state.SetItemsPerIteration(1);
+}
+BENCHMARK(GTE_MVMVA_FarColor);
+
+static void GTE_NCS(Benchmark::State& state)
+{
+  SetupGTE();
+  const auto vertices = MakeVertices();
+  u32 index = 0;
+  while (state.KeepRunning())
+  {
+    GTE::WriteRegister(REG_VXY0, vertices[index][0]);
+    GTE::WriteRegister(REG_VZ0, vertices[index][1]);
+    GTE::ExecuteInstruction(CMD_NCS);
+    index = (index + 1) % NUM_VERTICES;
+  }
+
+  Benchmark::DoNotOptimize(GTE::ReadRegister(REG_IRGB));
+  CPU::ResetPendingTicks();
+  state.SetItemsPerIteration(1);
+}
+BENCHMARK(GTE_NCS);
+
+static void GTE_NCT(Benchmark::State& state)
+{
+  SetupGTE();
+  const auto vertices = MakeVertices();
+  u32 index = 0;
+  while (state.KeepRunning())
+  {
+    LoadTriangle(vertices, index);
+    GTE::ExecuteInstruction(CMD_NCT);
+    index = (index + 3) % NUM_VERTICES;
+  }
+
+  Benchmark::DoNotOptimize(GTE::ReadRegister(REG_IRGB));
+  CPU::ResetPendingTicks();
+  state.SetItemsPerIteration(1);
+}
+BENCHMARK(GTE_NCT);
+
+static void GTE_DPCS(Benchmark::State& state)
+{
+  // Depth cueing of a single colour, which is InterpolateColor() on its own.
+  SetupGTE();
+  const auto vertices = MakeVertices();
+  u32 index = 0;
+  while (state.KeepRunning())
+  {
+    GTE::WriteRegister(REG_RGBC, vertices[index][0]);
+    GTE::ExecuteInstruction(CMD_DPCS);
+    index = (index + 1) % NUM_VERTICES;
+  }
+
+  Benchmark::DoNotOptimize(GTE::ReadRegister(REG_IRGB));
+  CPU::ResetPendingTicks();
+  state.SetItemsPerIteration(1);
+}
+BENCHMARK(GTE_DPCS);
+
+static void GTE_INTPL(Benchmark::State& state)
+{
+  SetupGTE();
+  const auto vertices = MakeVertices();
+  u32 index = 0;
+  while (state.KeepRunning())
+  {
+    GTE::WriteRegister(REG_IR1 + 0, vertices[index][0] & 0xFFFu);
+    GTE::WriteRegister(REG_IR1 + 1, (vertices[index][0] >> 16) & 0xFFFu);
+    GTE::WriteRegister(REG_IR1 + 2, vertices[index][1] & 0xFFFu);
+    GTE::ExecuteInstruction(CMD_INTPL);
+    index = (index + 1) % NUM_VERTICES;
+  }
+
+  Benchmark::DoNotOptimize(GTE::ReadRegister(REG_IRGB));
+  CPU::ResetPendingTicks();
+  state.SetItemsPerIteration(1);
+}
+BENCHMARK(GTE_INTPL);
+
+static void GTE_NCDS(Benchmark::State& state)
+{
+  SetupGTE();
+  const auto vertices = MakeVertices();
+  u32 index = 0;
+  while (state.KeepRunning())
+  {
+    GTE::WriteRegister(REG_VXY0, vertices[index][0]);
+    GTE::WriteRegister(REG_VZ0, vertices[index][1]);
+    GTE::ExecuteInstruction(CMD_NCDS);
+    index = (index + 1) % NUM_VERTICES;
+  }
+
+  Benchmark::DoNotOptimize(GTE::ReadRegister(REG_IRGB));
+  CPU::ResetPendingTicks();
+  state.SetItemsPerIteration(1);
+}
+BENCHMARK(GTE_NCDS);
+
+static void GTE_NCDT(Benchmark::State& state)
+{
+  SetupGTE();
+  const auto vertices = MakeVertices();
+  u32 index = 0;
+  while (state.KeepRunning())
+  {
+    LoadTriangle(vertices, index);
+    GTE::ExecuteInstruction(CMD_NCDT);
+    index = (index + 3) % NUM_VERTICES;
+  }
+
+  Benchmark::DoNotOptimize(GTE::ReadRegister(REG_IRGB));
+  CPU::ResetPendingTicks();
+  state.SetItemsPerIteration(1);
+}
+BENCHMARK(GTE_NCDT);
+
+static void GTE_NCCT(Benchmark::State& state)
+{
+  SetupGTE();
+  const auto vertices = MakeVertices();
+  u32 index = 0;
+  while (state.KeepRunning())
+  {
+    LoadTriangle(vertices, index);
+    GTE::ExecuteInstruction(CMD_NCCT);
+    index = (index + 3) % NUM_VERTICES;
+  }
+
+  Benchmark::DoNotOptimize(GTE::ReadRegister(REG_IRGB));
+  CPU::ResetPendingTicks();
+  state.SetItemsPerIteration(1);
+}
+BENCHMARK(GTE_NCCT);
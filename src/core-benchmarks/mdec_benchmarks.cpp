@@ -0,0 +1,176 @@
+// SPDX-FileCopyrightText: 2019-2023 Connor McLaughlin <stenzek@gmail.com>
+// SPDX-License-Identifier: (GPL-3.0 OR CC-BY-NC-ND-4.0)
+
+#include "benchmark.h"
+#include "common/assert.h"
+#include "core/cpu_core.h"
+#include "core/mdec.h"
+#include "core/timing_event.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+namespace {
+enum : u32
+{
+  MACROBLOCKS_PER_FRAME = (320 / 16) * (240 / 16),
+  BLOCKS_PER_MACROBLOCK = 6,
+  TICKS_PER_MACROBLOCK = 448 * BLOCKS_PER_MACROBLOCK,
+  DMA_BLOCK_WORDS = 32,
+
+  STATUS_DATA_OUT_REQUEST = (1u << 27),
+  STATUS_DATA_IN_REQUEST = (1u << 28),
+  STATUS_COMMAND_BUSY = (1u << 29),
+
+  CONTROL_RESET = (1u << 31),
+  CONTROL_ENABLE_DMA_IN = (1u << 30),
+  CONTROL_ENABLE_DMA_OUT = (1u << 29),
+
+  COMMAND_DECODE_MACROBLOCK = (1u << 29),
+  COMMAND_SET_IQ_TABLE = (2u << 29),
+  COMMAND_SET_SCALE_TABLE = (3u << 29),
+  OUTPUT_DEPTH_24BIT = (2u << 27),
+  OUTPUT_DEPTH_15BIT = (3u << 27),
+
+  END_OF_BLOCK = 0xFE00,
+};
+} // namespace
+
+static void SendWords(const u32* words, u32 count)
+{
+  for (u32 i = 0; i < count; i += DMA_BLOCK_WORDS)
+    MDEC::DMAWrite(&words[i], std::min<u32>(count - i, DMA_BLOCK_WORDS));
+}
+
+static void SetupMDEC()
+{
+  MDEC::Initialize();
+  MDEC::WriteRegister(4, CONTROL_RESET);
+  MDEC::WriteRegister(4, CONTROL_ENABLE_DMA_IN | CONTROL_ENABLE_DMA_OUT);
+
+  // Flat-ish quantization for both luma and chroma, like a mid-quality FMV.
+  std::array<u8, 128> iq_tables;
+  for (u32 i = 0; i < 64; i++)
+  {
+    iq_tables[i] = static_cast<u8>(2 + i / 4);
+    iq_tables[64 + i] = static_cast<u8>(2 + i / 2);
+  }
+  MDEC::WriteRegister(0, COMMAND_SET_IQ_TABLE | 1);
+  SendWords(reinterpret_cast<const u32*>(iq_tables.data()), static_cast<u32>(iq_tables.size() / sizeof(u32)));
+
+  // The standard DCT basis, which is what every game uploads.
+  std::array<s16, 64> scale_table;
+  for (u32 i = 0; i < 8; i++)
+  {
+    for (u32 j = 0; j < 8; j++)
+    {
+      const double value = (i == 0) ? std::sqrt(0.5) : std::cos((2.0 * j + 1.0) * i * 3.14159265358979323846 / 16.0);
+      scale_table[i * 8 + j] = static_cast<s16>(std::lround(value * 32767.0));
+    }
+  }
+  MDEC::WriteRegister(0, COMMAND_SET_SCALE_TABLE);
+  SendWords(reinterpret_cast<const u32*>(scale_table.data()), static_cast<u32>(sizeof(scale_table) / sizeof(u32)));
+}
+
+static std::vector<u32> MakeFrameData()
+{
+  // Run-length coded blocks with a DC term and a handful of AC terms each, which is roughly what real FMVs contain.
+  std::vector<u8> random = Benchmark::MakeRandomData(MACROBLOCKS_PER_FRAME * BLOCKS_PER_MACROBLOCK * 32, 0x4D444543u);
+  size_t random_pos = 0;
+  const auto next_random = [&random, &random_pos]() { return random[random_pos++ % random.size()]; };
+
+  std::vector<u16> halfwords;
+  for (u32 block = 0; block < (MACROBLOCKS_PER_FRAME * BLOCKS_PER_MACROBLOCK); block++)
+  {
+    const u16 q_scale = 8;
+    const u16 dc = static_cast<u16>((next_random() << 2) & 0x3FF);
+    halfwords.push_back(static_cast<u16>((q_scale << 10) | dc));
+
+    u32 coefficient = 0;
+    const u32 num_ac = 4 + (next_random() % 16);
+    for (u32 i = 0; i < num_ac; i++)
+    {
+      const u32 run = next_random() % 4;
+      if ((coefficient + run + 1) >= 63)
+        break;
+
+      coefficient += run + 1;
+      const s32 level = static_cast<s32>(next_random() % 64) - 32;
+      halfwords.push_back(static_cast<u16>((run << 10) | (static_cast<u32>(level) & 0x3FF)));
+    }
+
+    halfwords.push_back(END_OF_BLOCK);
+  }
+
+  if (halfwords.size() % 2)
+    halfwords.push_back(END_OF_BLOCK);
+
+  std::vector<u32> words(halfwords.size() / 2);
+  std::memcpy(words.data(), halfwords.data(), words.size() * sizeof(u32));
+  return words;
+}
+
+static void DecodeFrame(const std::vector<u32>& data, u32 output_depth, u32 words_per_macroblock, u32* output)
+{
+  MDEC::WriteRegister(0, COMMAND_DECODE_MACROBLOCK | output_depth | static_cast<u32>(data.size()));
+
+  // Plays the part of the DMA controller, feeding input when requested and draining each macroblock as it's output.
+  size_t pos = 0;
+  u32 idle_count = 0;
+  for (;;)
+  {
+    const u32 status = MDEC::ReadRegister(4);
+    if (status & STATUS_DATA_OUT_REQUEST)
+    {
+      MDEC::DMARead(output, words_per_macroblock);
+      idle_count = 0;
+    }
+    else if ((status & STATUS_DATA_IN_REQUEST) && pos < data.size())
+    {
+      const u32 count = static_cast<u32>(std::min<size_t>(data.size() - pos, DMA_BLOCK_WORDS));
+      MDEC::DMAWrite(&data[pos], count);
+      pos += count;
+      idle_count = 0;
+    }
+    else if (status & STATUS_COMMAND_BUSY)
+    {
+      // Waiting on the block copy out.
+      CPU::AddPendingTicks(TICKS_PER_MACROBLOCK);
+      TimingEvents::RunEvents();
+      AssertMsg(++idle_count < 16, "MDEC stalled, the input stream is malformed");
+    }
+    else
+    {
+      break;
+    }
+  }
+}
+
+static void RunMDECFrames(Benchmark::State& state, u32 output_depth, u32 words_per_macroblock)
+{
+  SetupMDEC();
+  const std::vector<u32> data = MakeFrameData();
+  std::vector<u32> output(words_per_macroblock);
+
+  while (state.KeepRunning())
+    DecodeFrame(data, output_depth, words_per_macroblock, output.data());
+
+  Benchmark::DoNotOptimize(output[0]);
+  MDEC::Shutdown();
+  state.SetItemsPerIteration(MACROBLOCKS_PER_FRAME);
+  state.SetBytesPerIteration(data.size() * sizeof(u32));
+}
+
+static void MDEC_DecodeFrame15Bit(Benchmark::State& state)
+{
+  RunMDECFrames(state, OUTPUT_DEPTH_15BIT, (16 * 16 * 2) / sizeof(u32));
+}
+BENCHMARK(MDEC_DecodeFrame15Bit);
+
+static void MDEC_DecodeFrame24Bit(Benchmark::State& state)
+{
+  RunMDECFrames(state, OUTPUT_DEPTH_24BIT, (16 * 16 * 3) / sizeof(u32));
+}
+BENCHMARK(MDEC_DecodeFrame24Bit);
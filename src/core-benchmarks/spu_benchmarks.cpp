@@ -0,0 +1,112 @@
+// SPDX-FileCopyrightText: 2019-2023 Connor McLaughlin <stenzek@gmail.com>
+// SPDX-License-Identifier: (GPL-3.0 OR CC-BY-NC-ND-4.0)
+
+#include "benchmark.h"
+#include "core/cpu_core.h"
+#include "core/spu.h"
+#include "core/timing_event.h"
+#include <array>
+
+namespace {
+enum : u32
+{
+  NUM_VOICES = 24,
+  SYSCLK_TICKS_PER_SPU_TICK = 768,
+  FRAMES_PER_ITERATION = SPU::SAMPLE_RATE / 60, // one NTSC frame
+
+  SAMPLE_ADDRESS = 0x1000,
+  SAMPLE_BLOCKS = 64,
+  ADPCM_BLOCK_SIZE = 16,
+  REVERB_BASE_ADDRESS = 0x60000,
+
+  // Register offsets from the start of the SPU's I/O range.
+  REG_MAIN_VOLUME_LEFT = 0x180,
+  REG_MAIN_VOLUME_RIGHT = 0x182,
+  REG_REVERB_OUT_VOLUME_LEFT = 0x184,
+  REG_REVERB_OUT_VOLUME_RIGHT = 0x186,
+  REG_KEY_ON_LOW = 0x188,
+  REG_KEY_ON_HIGH = 0x18A,
+  REG_REVERB_ON_LOW = 0x198,
+  REG_REVERB_ON_HIGH = 0x19A,
+  REG_REVERB_BASE_ADDRESS = 0x1A2,
+  REG_SPUCNT = 0x1AA,
+  REG_REVERB_FIRST = 0x1C0,
+};
+
+// A hall-style reverb configuration. The exact values don't matter for timing, as long as the taps stay inside the
+// work area.
+constexpr std::array<u16, 32> REVERB_REGISTERS = {
+  {0x0365, 0x01FF, 0x7FFF, 0x7FFF, 0x7FFF, 0x7FFF, 0x7F00, 0x7E00, 0x5000, 0x0000, 0x1E40, 0x1400, 0x1EC0, 0x1520,
+   0x1600, 0x0E80, 0x05FF, 0x0480, 0x0990, 0x0A40, 0x0D38, 0x0D58, 0x0DE8, 0x09B0, 0x07E8, 0x0818, 0x0518, 0x0508,
+   0x0200, 0x0160, 0x8000, 0x8000}};
+} // namespace
+
+static void SetupSPU(bool reverb)
+{
+  SPU::Initialize();
+
+  // A looping sample of random ADPCM blocks, which is the worst case for the decoder since nothing is silent.
+  std::array<u8, SPU::RAM_SIZE>& ram = SPU::GetWritableRAM();
+  Benchmark::FillRandom(&ram[SAMPLE_ADDRESS], SAMPLE_BLOCKS * ADPCM_BLOCK_SIZE, 0x53505531u);
+  for (u32 i = 0; i < SAMPLE_BLOCKS; i++)
+  {
+    u8* block = &ram[SAMPLE_ADDRESS + i * ADPCM_BLOCK_SIZE];
+    block[0] = static_cast<u8>(((block[0] % 5) << 4) | (4 + (block[0] % 8))); // filter, shift
+    block[1] = (i == 0) ? 0x04 : ((i == (SAMPLE_BLOCKS - 1)) ? 0x03 : 0x00);  // loop start/end+repeat
+  }
+
+  SPU::WriteRegister(REG_SPUCNT, reverb ? 0xC080 : 0xC000);
+  SPU::WriteRegister(REG_MAIN_VOLUME_LEFT, 0x3FFF);
+  SPU::WriteRegister(REG_MAIN_VOLUME_RIGHT, 0x3FFF);
+
+  for (u32 i = 0; i < NUM_VOICES; i++)
+  {
+    const u32 base = i * 0x10;
+    SPU::WriteRegister(base + 0x00, 0x3FFF);                            // volume left
+    SPU::WriteRegister(base + 0x02, 0x3FFF);                            // volume right
+    SPU::WriteRegister(base + 0x04, static_cast<u16>(0x0800 + i * 0x80)); // pitch, mixed rates
+    SPU::WriteRegister(base + 0x06, static_cast<u16>((SAMPLE_ADDRESS + (i % 8) * 0x80) / 8));
+    SPU::WriteRegister(base + 0x08, 0x00FF); // fastest attack, slow decay, max sustain
+    SPU::WriteRegister(base + 0x0A, 0x0000);
+  }
+
+  if (reverb)
+  {
+    SPU::WriteRegister(REG_REVERB_BASE_ADDRESS, REVERB_BASE_ADDRESS / 8);
+    for (u32 i = 0; i < REVERB_REGISTERS.size(); i++)
+      SPU::WriteRegister(REG_REVERB_FIRST + i * 2, REVERB_REGISTERS[i]);
+    SPU::WriteRegister(REG_REVERB_OUT_VOLUME_LEFT, 0x3000);
+    SPU::WriteRegister(REG_REVERB_OUT_VOLUME_RIGHT, 0x3000);
+    SPU::WriteRegister(REG_REVERB_ON_LOW, 0xFFFF);
+    SPU::WriteRegister(REG_REVERB_ON_HIGH, 0x00FF);
+  }
+
+  SPU::WriteRegister(REG_KEY_ON_LOW, 0xFFFF);
+  SPU::WriteRegister(REG_KEY_ON_HIGH, 0x00FF);
+}
+
+static void RunSPUFrames(Benchmark::State& state, bool reverb)
+{
+  SetupSPU(reverb);
+
+  while (state.KeepRunning())
+  {
+    CPU::AddPendingTicks(FRAMES_PER_ITERATION * SYSCLK_TICKS_PER_SPU_TICK);
+    TimingEvents::RunEvents();
+  }
+
+  SPU::Shutdown();
+  state.SetItemsPerIteration(FRAMES_PER_ITERATION);
+}
+
+static void SPU_Mix24Voices(Benchmark::State& state)
+{
+  RunSPUFrames(state, false);
+}
+BENCHMARK(SPU_Mix24Voices);
+
+static void SPU_Mix24VoicesReverb(Benchmark::State& state)
+{
+  RunSPUFrames(state, true);
+}
+BENCHMARK(SPU_Mix24VoicesReverb);
@@ -0,0 +1,124 @@
+// SPDX-FileCopyrightText: 2019-2023 Connor McLaughlin <stenzek@gmail.com>
+// SPDX-License-Identifier: (GPL-3.0 OR CC-BY-NC-ND-4.0)
+
+#include "benchmark.h"
+#include "common/assert.h"
+#include "common/byte_stream.h"
+#include "core/gpu_types.h"
+#include "core/gte.h"
+#include "core/mdec.h"
+#include "core/save_state_version.h"
+#include "core/spu.h"
+#include "util/state_wrapper.h"
+#include <memory>
+#include <vector>
+
+namespace {
+enum : u32
+{
+  RAM_SIZE = 2 * 1024 * 1024,
+};
+
+// Stands in for the parts of the system which are plain memory. The rest of the state comes from the real components.
+struct StateData
+{
+  std::vector<u8> ram;
+  std::vector<u8> vram;
+};
+} // namespace
+
+static StateData CreateState()
+{
+  GTE::Initialize();
+  SPU::Initialize();
+  MDEC::Initialize();
+
+  // Games leave large parts of memory zeroed, which is what makes states compress well, so only fill half of it.
+  StateData data;
+  data.ram.resize(RAM_SIZE);
+  data.vram.resize(VRAM_SIZE);
+  Benchmark::FillRandom(data.ram.data(), RAM_SIZE / 2, 0x52414D31u);
+  Benchmark::FillRandom(data.vram.data(), VRAM_SIZE / 2, 0x5652414Du);
+  Benchmark::FillRandom(SPU::GetWritableRAM().data(), SPU::RAM_SIZE / 2, 0x53524D31u);
+  return data;
+}
+
+static void DestroyState()
+{
+  MDEC::Shutdown();
+  SPU::Shutdown();
+}
+
+static bool DoState(StateWrapper& sw, StateData& data)
+{
+  sw.DoBytes(data.ram.data(), data.ram.size());
+  if (!GTE::DoState(sw) || !SPU::DoState(sw) || !MDEC::DoState(sw))
+    return false;
+
+  sw.DoBytes(data.vram.data(), data.vram.size());
+  return !sw.HasError();
+}
+
+static u32 SaveState(GrowableMemoryByteStream* stream, StateData& data, bool compress)
+{
+  stream->SeekAbsolute(0);
+  if (!compress)
+  {
+    StateWrapper sw(stream, StateWrapper::Mode::Write, SAVE_STATE_VERSION);
+    Assert(DoState(sw, data));
+  }
+  else
+  {
+    std::unique_ptr<ByteStream> cstream = ByteStream::CreateZstdCompressStream(stream, 0);
+    StateWrapper sw(cstream.get(), StateWrapper::Mode::Write, SAVE_STATE_VERSION);
+    Assert(DoState(sw, data) && cstream->Commit());
+  }
+
+  return static_cast<u32>(stream->GetPosition());
+}
+
+static void State_Save(Benchmark::State& state)
+{
+  StateData data = CreateState();
+  std::unique_ptr<GrowableMemoryByteStream> stream = ByteStream::CreateGrowableMemoryStream();
+  u32 size = 0;
+  while (state.KeepRunning())
+    size = SaveState(stream.get(), data, false);
+
+  DestroyState();
+  state.SetBytesPerIteration(size);
+}
+BENCHMARK(State_Save);
+
+static void State_SaveCompressed(Benchmark::State& state)
+{
+  StateData data = CreateState();
+  std::unique_ptr<GrowableMemoryByteStream> stream = ByteStream::CreateGrowableMemoryStream();
+  while (state.KeepRunning())
+    SaveState(stream.get(), data, true);
+
+  // Reported against the uncompressed size, so it's comparable with State_Save.
+  const u32 uncompressed_size = SaveState(stream.get(), data, false);
+  DestroyState();
+  state.SetBytesPerIteration(uncompressed_size);
+}
+BENCHMARK(State_SaveCompressed);
+
+static void State_LoadCompressed(Benchmark::State& state)
+{
+  StateData data = CreateState();
+  std::unique_ptr<GrowableMemoryByteStream> stream = ByteStream::CreateGrowableMemoryStream();
+  const u32 compressed_size = SaveState(stream.get(), data, true);
+  while (state.KeepRunning())
+  {
+    std::unique_ptr<ByteStream> dstream =
+      ByteStream::CreateZstdDecompressStream(stream->GetMemoryPointer(), compressed_size);
+    StateWrapper sw(dstream.get(), StateWrapper::Mode::Read, SAVE_STATE_VERSION);
+    Assert(DoState(sw, data));
+  }
+
+  const u32 uncompressed_size = SaveState(stream.get(), data, false);
+  DestroyState();
+  state.SetBytesPerIteration(uncompressed_size);
+}
+BENCHMARK(State_LoadCompressed);
@@ -0,0 +1,186 @@
+// SPDX-FileCopyrightText: 2019-2023 Connor McLaughlin <stenzek@gmail.com>
+// SPDX-License-Identifier: (GPL-3.0 OR CC-BY-NC-ND-4.0)
+
+// The core tests and benchmarks only run individual components, so none of the host is needed. These satisfy the
+// linker.
+
+#include "common/log.h"
+#include "common/memory_settings_interface.h"
+#include "core/achievements.h"
+#include "core/host.h"
+#include "core/host_display.h"
+#include "core/host_settings.h"
+#include "core/system.h"
+#include "util/audio_stream.h"
+Log_SetChannel(HostStubs);
+
+static std::mutex s_settings_mutex;
+static MemorySettingsInterface s_settings_interface;
+
+std::optional<std::string> Host::ReadResourceFileToString(const char* filename)
+{
+  return std::nullopt;
+}
+
+std::optional<std::time_t> Host::GetResourceFileTimestamp(const char* filename)
+{
+  return std::nullopt;
+}
+
+TinyString Host::TranslateString(const char* context, const char* str, const char* disambiguation, int n)
+{
+  return str;
+}
+
+std::string Host::TranslateStdString(const char* context, const char* str, const char* disambiguation, int n)
+{
+  return str;
+}
+
+std::unique_ptr<AudioStream> Host::CreateAudioStream(AudioBackend backend, u32 sample_rate, u32 channels, u32 buffer_ms,
+                                                     u32 latency_ms, AudioStretchMode stretch)
+{
+  return AudioStream::CreateNullStream(sample_rate, channels, buffer_ms);
+}
+
+float Host::GetOSDScale()
+{
+  return 1.0f;
+}
+
+void Host::AddOSDMessage(std::string message, float duration) {}
+
+void Host::AddKeyedOSDMessage(std::string key, std::string message, float duration) {}
+
+void Host::AddIconOSDMessage(std::string key, const char* icon, std::string message, float duration) {}
+
+void Host::AddFormattedOSDMessage(float duration, const char* format, ...) {}
+
+void Host::AddKeyedFormattedOSDMessage(std::string key, float duration, const char* format, ...) {}
+
+void Host::ReportErrorAsync(const std::string_view& title, const std::string_view& message)
+{
+  Log_ErrorPrintf("%.*s: %.*s", static_cast<int>(title.size()), title.data(), static_cast<int>(message.size()),
+                  message.data());
+}
+
+bool Host::ConfirmMessage(const std::string_view& title, const std::string_view& message)
+{
+  return true;
+}
+
+void Host::ReportDebuggerMessage(const std::string_view& message) {}
+
+void Host::DisplayLoadingScreen(const char* message, int progress_min, int progress_max, int progress_value) {}
+
+void Host::SetPadVibrationIntensity(u32 pad_index, float large_or_single_motor_intensity, float small_motor_intensity)
+{
+}
+
+void Host::ProcessQueuedInputEvents(bool poll_sources) {}
+
+void Host::SetMouseMode(bool relative, bool hide_cursor) {}
+
+bool Host::AcquireHostDisplay(RenderAPI api)
+{
+  return false;
+}
+
+void Host::ReleaseHostDisplay() {}
+
+void Host::RenderDisplay(bool skip_present) {}
+
+void Host::InvalidateDisplay() {}
+
+std::string Host::GetStringSettingValue(const char* section, const char* key, const char* default_value)
+{
+  return default_value;
+}
+
+bool Host::GetBoolSettingValue(const char* section, const char* key, bool default_value)
+{
+  return default_value;
+}
+
+std::unique_lock<std::mutex> Host::GetSettingsLock()
+{
+  return std::unique_lock<std::mutex>(s_settings_mutex);
+}
+
+SettingsInterface* Host::GetSettingsInterface()
+{
+  return &s_settings_interface;
+}
+
+SettingsInterface* Host::GetSettingsInterfaceForBindings()
+{
+  return &s_settings_interface;
+}
+
+SettingsInterface* Host::Internal::GetBaseSettingsLayer()
+{
+  return &s_settings_interface;
+}
+
+void Host::Internal::SetGameSettingsLayer(SettingsInterface* sif) {}
+
+void Host::Internal::SetInputSettingsLayer(SettingsInterface* sif) {}
+
+void Host::LoadSettings(SettingsInterface& si, std::unique_lock<std::mutex>& lock) {}
+
+void Host::CheckForSettingsChanges(const Settings& old_settings) {}
+
+void Host::OnSystemStarting() {}
+
+void Host::OnSystemStarted() {}
+
+void Host::OnSystemDestroyed() {}
+
+void Host::OnSystemPaused() {}
+
+void Host::OnSystemResumed() {}
+
+void Host::OnPerformanceCountersUpdated() {}
+
+void Host::OnGameChanged(const std::string& disc_path, const std::string& game_serial, const std::string& game_name) {}
+
+void Host::PumpMessagesOnCPUThread() {}
+
+void Host::RequestResizeHostDisplay(s32 width, s32 height) {}
+
+void Host::RequestSystemShutdown(bool allow_confirm, bool save_state) {}
+
+#ifdef WITH_CHEEVOS
+
+bool Achievements::ConfirmSystemReset()
+{
+  return true;
+}
+
+void Achievements::ResetRuntime() {}
+
+bool Achievements::DoState(StateWrapper& sw)
+{
+  return true;
+}
+
+void Achievements::GameChanged(const std::string& path, CDImage* image) {}
+
+bool Achievements::ResetChallengeMode()
+{
+  return false;
+}
+
+void Achievements::DisableChallengeMode() {}
+
+bool Achievements::ConfirmChallengeModeDisable(const char* trigger)
+{
+  return true;
+}
+
+bool Achievements::ChallengeModeActive()
+{
+  return false;
+}
+
+#endif
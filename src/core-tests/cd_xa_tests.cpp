@@ -0,0 +1,112 @@
+// SPDX-FileCopyrightText: 2019-2023 Connor McLaughlin <stenzek@gmail.com>
+// SPDX-License-Identifier: (GPL-3.0 OR CC-BY-NC-ND-4.0)
+
+#include "test_utils.h"
+#include "util/cd_image.h"
+#include "util/cd_xa.h"
+#include <array>
+#include <gtest/gtest.h>
+
+// Decodes and resamples pseudo-random XA-ADPCM data, and compares a hash of the output with the result of the scalar
+// C++ implementation. The expected values were generated with the SSE2/NEON paths disabled.
+
+using CoreTests::Random;
+
+namespace {
+enum : u32
+{
+  NUM_SECTORS = 64,
+  NUM_RESAMPLE_ITERATIONS = 20000,
+  SUBHEADER_OFFSET = CDImage::SECTOR_SYNC_SIZE + sizeof(CDImage::SectorHeader),
+  CODINGINFO_OFFSET = SUBHEADER_OFFSET + 3,
+  CHUNKS_OFFSET = SUBHEADER_OFFSET + CDXA::XA_SUBHEADER_SIZE * 2,
+  NUM_CHUNKS = 18,
+  CHUNK_SIZE = 128,
+  CHUNK_HEADER_SIZE = 16,
+};
+} // namespace
+
+static u64 DecodeSectors(u8 codinginfo)
+{
+  Random rng(0x58410000u | codinginfo);
+  const u32 num_samples = CDXA::XASubHeader::Codinginfo{codinginfo}.GetSamplesPerSector();
+  std::array<s32, 4> last_samples = {};
+  std::array<s16, CDXA::XA_ADPCM_SAMPLES_PER_SECTOR_4BIT> samples;
+  u64 hash = CoreTests::HASH_SEED;
+
+  for (u32 sector = 0; sector < NUM_SECTORS; sector++)
+  {
+    std::array<u8, CDImage::RAW_SECTOR_SIZE> data;
+    rng.Fill(data.data(), data.size());
+    data[CODINGINFO_OFFSET] = codinginfo;
+
+    // Every filter and shift, including the reserved shifts. Most headers use a small shift, so the samples are large
+    // and the filter pushes the output into the clamp.
+    for (u32 chunk = 0; chunk < NUM_CHUNKS; chunk++)
+    {
+      u8* headers = &data[CHUNKS_OFFSET + chunk * CHUNK_SIZE];
+      for (u32 i = 0; i < CHUNK_HEADER_SIZE; i++)
+      {
+        if ((headers[i] & 0xC0) != 0)
+          headers[i] = static_cast<u8>((headers[i] & 0x30) | (headers[i] & 0x3));
+      }
+    }
+
+    CDXA::DecodeADPCMSector(data.data(), samples.data(), last_samples.data());
+    hash = CoreTests::HashBytes(samples.data(), num_samples * sizeof(s16), hash);
+    hash = CoreTests::HashBytes(last_samples.data(), last_samples.size() * sizeof(s32), hash);
+  }
+
+  return hash;
+}
+
+TEST(CDXA, DecodeMono4Bit)
+{
+  ASSERT_EQ(DecodeSectors(0x00), UINT64_C(0xDDFA469F12DB3B7C));
+}
+
+TEST(CDXA, DecodeStereo4Bit)
+{
+  ASSERT_EQ(DecodeSectors(0x01), UINT64_C(0xD242C01633C17A41));
+}
+
+TEST(CDXA, DecodeMono8Bit)
+{
+  ASSERT_EQ(DecodeSectors(0x10), UINT64_C(0xD1097C7A4D2070D9));
+}
+
+TEST(CDXA, DecodeStereo8Bit)
+{
+  ASSERT_EQ(DecodeSectors(0x11), UINT64_C(0x7A0CC6A0B51A60FF));
+}
+
+TEST(CDXA, ZigZagInterpolate)
+{
+  Random rng(0x5A49475Au);
+  std::array<s16, CDXA::XA_RESAMPLE_RING_BUFFER_SIZE> ringbuf;
+  std::array<s16, CDXA::XA_RESAMPLE_OUTPUTS_PER_WINDOW> out;
+  u64 hash = CoreTests::HASH_SEED;
+
+  for (u32 i = 0; i < NUM_RESAMPLE_ITERATIONS; i++)
+  {
+    // Full-scale samples of one sign push the sum past the clamp, and mixed signs check the rounding of each product.
+    const u32 mode = i % 4;
+    for (s16& sample : ringbuf)
+    {
+      const u32 value = rng.Next();
+      if (mode == 0)
+        sample = static_cast<s16>(value);
+      else if (mode == 1)
+        sample = (value & 1) ? -0x8000 : 0x7FFF;
+      else if (mode == 2)
+        sample = static_cast<s16>(-0x8000 + static_cast<s32>(value & 0xFF));
+      else
+        sample = static_cast<s16>(static_cast<s32>(value & 0x1FF) - 0x100);
+    }
+
+    CDXA::ZigZagInterpolate(ringbuf.data(), static_cast<u8>(i % CDXA::XA_RESAMPLE_RING_BUFFER_SIZE), out.data());
+    hash = CoreTests::HashBytes(out.data(), out.size() * sizeof(s16), hash);
+  }
+
+  ASSERT_EQ(hash, UINT64_C(0x2896EF35BD48C9A1));
+}
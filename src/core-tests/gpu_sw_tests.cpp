@@ -0,0 +1,303 @@
+// SPDX-FileCopyrightText: 2019-2023 Connor McLaughlin <stenzek@gmail.com>
+// SPDX-License-Identifier: (GPL-3.0 OR CC-BY-NC-ND-4.0)
+
+#include "core/gpu_sw.h"
+#include "core/gpu_sw_backend.h"
+#include "core/settings.h"
+#include "test_utils.h"
+#include <gtest/gtest.h>
+#include <memory>
+#include <vector>
+
+// Draws pseudo-random primitives with the software renderer, and compares a hash of VRAM with the result of the scalar
+// C++ implementation. The expected values were generated with the SSE2/NEON paths disabled, so this checks that the
+// vectorized span shading, VRAM transfers and display copy-out are bit-identical on the targets which use them.
+
+using CoreTests::Random;
+
+namespace {
+enum : u32
+{
+  NUM_TRIANGLES = 512,
+  NUM_TRANSFERS = 256,
+  MAX_UPDATE_HEIGHT = 64,
+  MAX_COPY_OUT_WIDTH = 80,
+  MAX_TRIANGLE_SIZE = 128,
+  DRAWING_AREA_WIDTH = 640,
+  DRAWING_AREA_HEIGHT = 480,
+
+  // The texture page and CLUT live to the right of the drawing area, so the spans aren't drawn one pixel at a time.
+  TEXTURE_PAGE_X = 768,
+  TEXTURE_PAGE_Y = 0,
+  CLUT_X = 768,
+  CLUT_Y = 480,
+};
+
+class GPUSWTest : public ::testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    // Rasterize on the calling thread, so everything has been drawn by the time the commands are pushed.
+    m_old_gpu_use_thread = g_settings.gpu_use_thread;
+    g_settings.gpu_use_thread = false;
+    m_backend = std::make_unique<GPU_SW_Backend>();
+    m_backend->Initialize(false);
+    m_backend->Reset(true);
+  }
+
+  void TearDown() override
+  {
+    m_backend->Shutdown();
+    m_backend.reset();
+    g_settings.gpu_use_thread = m_old_gpu_use_thread;
+  }
+
+  void FillRandomVRAM(Random& rng)
+  {
+    // Noise with the mask bit set on half of the pixels, and zero on some, which textures treat as transparent.
+    u16* vram = m_backend->GetVRAM();
+    for (u32 i = 0; i < VRAM_WIDTH * VRAM_HEIGHT; i++)
+    {
+      const u32 value = rng.Next();
+      vram[i] = ((value & 0x70000) == 0) ? 0 : static_cast<u16>(value);
+    }
+  }
+
+  void SetDrawingArea()
+  {
+    GPUBackendSetDrawingAreaCommand* cmd = m_backend->NewSetDrawingAreaCommand();
+    cmd->params.bits = 0;
+    cmd->new_area = Common::Rectangle<u32>(0, 0, DRAWING_AREA_WIDTH - 1, DRAWING_AREA_HEIGHT - 1);
+    m_backend->PushCommand(cmd);
+  }
+
+  u64 HashVRAM() const { return CoreTests::HashBytes(m_backend->GetVRAM(), VRAM_WIDTH * VRAM_HEIGHT * sizeof(u16)); }
+
+  u64 DrawTriangles(bool shaded, bool textured, GPUTextureMode texture_mode, u32 seed);
+  u64 FillRectangles(u32 seed);
+  u64 UpdateRectangles(u32 seed);
+  u64 CopyRectangles(u32 seed);
+
+  std::unique_ptr<GPU_SW_Backend> m_backend;
+  bool m_old_gpu_use_thread = false;
+};
+} // namespace
+
+static u16 RandomExtent(Random& rng, u32 max)
+{
+  // Mostly small rectangles with odd sizes, which leave a remainder after the vectors, and some which wrap around.
+  const u32 value = rng.Next();
+  return static_cast<u16>(((value & 0x7) == 0) ? ((value >> 3) % max + 1) : ((value >> 3) % 64 + 1));
+}
+
+u64 GPUSWTest::DrawTriangles(bool shaded, bool textured, GPUTextureMode texture_mode, u32 seed)
+{
+  Random rng(seed);
+  FillRandomVRAM(rng);
+  SetDrawingArea();
+
+  for (u32 i = 0; i < NUM_TRIANGLES; i++)
+  {
+    // Every blending mode, with and without dithering and mask bits, and raw textures.
+    const u32 flags = rng.Next();
+    GPUBackendDrawPolygonCommand* cmd = m_backend->NewDrawPolygonCommand(3);
+    cmd->params.bits = static_cast<u8>(flags & 0xC);
+    cmd->rc.bits = 0;
+    cmd->rc.primitive = GPUPrimitive::Polygon;
+    cmd->rc.shading_enable = shaded;
+    cmd->rc.texture_enable = textured;
+    cmd->rc.raw_texture_enable = textured && (flags & 0x10) != 0;
+    cmd->rc.transparency_enable = (flags & 0x20) != 0;
+
+    cmd->draw_mode.bits = 0;
+    cmd->draw_mode.texture_page_x_base = TEXTURE_PAGE_X / 64;
+    cmd->draw_mode.texture_page_y_base = TEXTURE_PAGE_Y / 256;
+    cmd->draw_mode.texture_mode = texture_mode;
+    cmd->draw_mode.transparency_mode = static_cast<GPUTransparencyMode>((flags >> 6) & 0x3);
+    cmd->draw_mode.dither_enable = (flags & 0x100) != 0;
+
+    cmd->palette.bits = 0;
+    cmd->palette.x = CLUT_X / 16;
+    cmd->palette.y = CLUT_Y;
+    cmd->window = {0xFF, 0xFF, 0x00, 0x00};
+
+    // Spans from a single pixel to over a hundred, with and without a remainder after the groups of eight, and some
+    // clipped by the edges of the drawing area.
+    const s32 base_x = static_cast<s32>(rng.Next() % (DRAWING_AREA_WIDTH + MAX_TRIANGLE_SIZE)) - MAX_TRIANGLE_SIZE / 2;
+    const s32 base_y = static_cast<s32>(rng.Next() % (DRAWING_AREA_HEIGHT + MAX_TRIANGLE_SIZE)) - MAX_TRIANGLE_SIZE / 2;
+    for (u32 j = 0; j < 3; j++)
+    {
+      const s32 x = base_x + static_cast<s32>(rng.Next() % MAX_TRIANGLE_SIZE);
+      const s32 y = base_y + static_cast<s32>(rng.Next() % MAX_TRIANGLE_SIZE);
+      cmd->vertices[j].Set(x, y, rng.Next() & 0xFFFFFF, static_cast<u16>(rng.Next()));
+    }
+
+    m_backend->PushCommand(cmd);
+  }
+
+  m_backend->Sync(false);
+  return HashVRAM();
+}
+
+TEST_F(GPUSWTest, FlatTriangles)
+{
+  ASSERT_EQ(DrawTriangles(false, false, GPUTextureMode::Palette4Bit, 0x464C4154u), UINT64_C(0xA7F93602E83FABAE));
+}
+
+TEST_F(GPUSWTest, ShadedTriangles)
+{
+  ASSERT_EQ(DrawTriangles(true, false, GPUTextureMode::Palette4Bit, 0x53484144u), UINT64_C(0xF086F6DC98FFB072));
+}
+
+TEST_F(GPUSWTest, TexturedTriangles4Bit)
+{
+  ASSERT_EQ(DrawTriangles(false, true, GPUTextureMode::Palette4Bit, 0x54455834u), UINT64_C(0x88CB942B3FDBB747));
+}
+
+TEST_F(GPUSWTest, TexturedTriangles8Bit)
+{
+  ASSERT_EQ(DrawTriangles(false, true, GPUTextureMode::Palette8Bit, 0x54455838u), UINT64_C(0x7D02377CFD7F6E08));
+}
+
+TEST_F(GPUSWTest, TexturedTriangles15Bit)
+{
+  ASSERT_EQ(DrawTriangles(false, true, GPUTextureMode::Direct16Bit, 0x54455846u), UINT64_C(0x9355318CBFE1B982));
+}
+
+TEST_F(GPUSWTest, ShadedTexturedTriangles)
+{
+  ASSERT_EQ(DrawTriangles(true, true, GPUTextureMode::Palette8Bit, 0x53544558u), UINT64_C(0x53D249D083A06A28));
+}
+
+u64 GPUSWTest::FillRectangles(u32 seed)
+{
+  Random rng(seed);
+  FillRandomVRAM(rng);
+
+  for (u32 i = 0; i < NUM_TRANSFERS; i++)
+  {
+    // Fills ignore the mask bits, but skip lines when interlaced.
+    GPUBackendFillVRAMCommand* cmd = m_backend->NewFillVRAMCommand();
+    cmd->params.bits = static_cast<u8>(rng.Next() & 0x3);
+    cmd->x = static_cast<u16>(rng.Next() % VRAM_WIDTH);
+    cmd->y = static_cast<u16>(rng.Next() % VRAM_HEIGHT);
+    cmd->width = RandomExtent(rng, VRAM_WIDTH);
+    cmd->height = RandomExtent(rng, VRAM_HEIGHT);
+    cmd->color = rng.Next() & 0xFFFFFF;
+    m_backend->PushCommand(cmd);
+  }
+
+  m_backend->Sync(false);
+  return HashVRAM();
+}
+
+u64 GPUSWTest::UpdateRectangles(u32 seed)
+{
+  Random rng(seed);
+  FillRandomVRAM(rng);
+
+  for (u32 i = 0; i < NUM_TRANSFERS; i++)
+  {
+    const u16 width = RandomExtent(rng, VRAM_WIDTH);
+    const u16 height = RandomExtent(rng, MAX_UPDATE_HEIGHT);
+    GPUBackendUpdateVRAMCommand* cmd = m_backend->NewUpdateVRAMCommand(ZeroExtend32(width) * ZeroExtend32(height));
+    cmd->params.bits = static_cast<u8>(rng.Next() & 0xC);
+    cmd->x = static_cast<u16>(rng.Next() % VRAM_WIDTH);
+    cmd->y = static_cast<u16>(rng.Next() % VRAM_HEIGHT);
+    cmd->width = width;
+    cmd->height = height;
+    rng.Fill(cmd->data, ZeroExtend32(width) * ZeroExtend32(height) * sizeof(u16));
+    m_backend->PushCommand(cmd);
+  }
+
+  m_backend->Sync(false);
+  return HashVRAM();
+}
+
+u64 GPUSWTest::CopyRectangles(u32 seed)
+{
+  Random rng(seed);
+  FillRandomVRAM(rng);
+
+  for (u32 i = 0; i < NUM_TRANSFERS; i++)
+  {
+    // Half of the copies overlap their source, in either direction.
+    const u32 flags = rng.Next();
+    GPUBackendCopyVRAMCommand* cmd = m_backend->NewCopyVRAMCommand();
+    cmd->params.bits = static_cast<u8>(flags & 0xC);
+    cmd->src_x = static_cast<u16>(rng.Next() % VRAM_WIDTH);
+    cmd->src_y = static_cast<u16>(rng.Next() % VRAM_HEIGHT);
+    if (flags & 0x10)
+    {
+      cmd->dst_x = static_cast<u16>((cmd->src_x + VRAM_WIDTH - 16 + rng.Next() % 32) % VRAM_WIDTH);
+      cmd->dst_y = static_cast<u16>((cmd->src_y + VRAM_HEIGHT - 2 + rng.Next() % 4) % VRAM_HEIGHT);
+    }
+    else
+    {
+      cmd->dst_x = static_cast<u16>(rng.Next() % VRAM_WIDTH);
+      cmd->dst_y = static_cast<u16>(rng.Next() % VRAM_HEIGHT);
+    }
+    cmd->width = RandomExtent(rng, VRAM_WIDTH);
+    cmd->height = RandomExtent(rng, VRAM_HEIGHT);
+    m_backend->PushCommand(cmd);
+  }
+
+  m_backend->Sync(false);
+  return HashVRAM();
+}
+
+TEST_F(GPUSWTest, FillVRAM)
+{
+  ASSERT_EQ(FillRectangles(0x46494C4Cu), UINT64_C(0xF11AD86C927BAC65));
+}
+
+TEST_F(GPUSWTest, UpdateVRAM)
+{
+  ASSERT_EQ(UpdateRectangles(0x55504454u), UINT64_C(0x95038EFF20D29FD4));
+}
+
+TEST_F(GPUSWTest, CopyVRAM)
+{
+  ASSERT_EQ(CopyRectangles(0x434F5059u), UINT64_C(0xAB91990B8DA36C5C));
+}
+
+template<typename OutputPixelType>
+static u64 CopyOut24BitRows(GPUTexture::Format display_format, u32 seed)
+{
+  // Every width up to several groups, so each vector loop stops at every possible remainder. The source is sized
+  // exactly, as the wide loads mustn't read past the last pixel.
+  Random rng(seed);
+  u64 hash = CoreTests::HASH_SEED;
+  for (u32 width = 1; width <= MAX_COPY_OUT_WIDTH; width++)
+  {
+    std::vector<u8> src(width * 3);
+    rng.Fill(src.data(), src.size());
+
+    std::vector<OutputPixelType> dst(width);
+    GPU_SW::CopyOut24BitRow(display_format, src.data(), dst.data(), width);
+    hash = CoreTests::HashBytes(dst.data(), dst.size() * sizeof(OutputPixelType), hash);
+  }
+
+  return hash;
+}
+
+TEST(GPUSW, CopyOut24BitRGBA8)
+{
+  ASSERT_EQ(CopyOut24BitRows<u32>(GPUTexture::Format::RGBA8, 0x52474241u), UINT64_C(0x645424DF1AB1754C));
+}
+
+TEST(GPUSW, CopyOut24BitBGRA8)
+{
+  ASSERT_EQ(CopyOut24BitRows<u32>(GPUTexture::Format::BGRA8, 0x42475241u), UINT64_C(0xBB713FE5C60D58E6));
+}
+
+TEST(GPUSW, CopyOut24BitRGB565)
+{
+  ASSERT_EQ(CopyOut24BitRows<u16>(GPUTexture::Format::RGB565, 0x52353635u), UINT64_C(0x8881E2493742F99B));
+}
+
+TEST(GPUSW, CopyOut24BitRGBA5551)
+{
+  ASSERT_EQ(CopyOut24BitRows<u16>(GPUTexture::Format::RGBA5551, 0x35353531u), UINT64_C(0x6F600D479F48998A));
+}
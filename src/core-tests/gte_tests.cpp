@@ -0,0 +1,146 @@
+// SPDX-FileCopyrightText: 2019-2023 Connor McLaughlin <stenzek@gmail.com>
+// SPDX-License-Identifier: (GPL-3.0 OR CC-BY-NC-ND-4.0)
+
+#include "core/cpu_core.h"
+#include "core/gte.h"
+#include "test_utils.h"
+#include <gtest/gtest.h>
+#include <iterator>
+
+// Runs each GTE command against pseudo-random register contents, and compares a hash of every register afterwards
+// with the result of the scalar C++ implementation. The expected values were generated with the vector MAC path
+// disabled, so on targets which use it (AArch64), this checks that MAC/IR values and flags are bit-identical.
+
+using CoreTests::Random;
+
+namespace {
+enum : u32
+{
+  NUM_ITERATIONS = 2000,
+  NUM_REGISTERS = 64,
+};
+} // namespace
+
+static constexpr u32 MakeCommand(u32 command, bool sf, bool lm, u32 extra = 0)
+{
+  return (UINT32_C(0x4A) << 24) | (static_cast<u32>(sf) << 19) | (static_cast<u32>(lm) << 10) | extra | command;
+}
+
+static void RandomizeRegisters(Random& rng)
+{
+  for (u32 i = 0; i < NUM_REGISTERS; i++)
+  {
+    // Mostly small values, like real vertices and matrices, with some full-range ones to hit the saturation paths.
+    u32 value = rng.Next();
+    if ((rng.Next() & 3) != 0)
+      value &= 0x0FFF0FFFu;
+
+    GTE::WriteRegister(i, value);
+  }
+}
+
+static void RandomizeRegistersExtreme(Random& rng)
+{
+  // Each half from the values either side of the sign and saturation boundaries, so the partial sums, the divide and
+  // the screen/depth clamps overflow far more often than with the values above.
+  static constexpr u16 values[] = {0x0000, 0x0001, 0x7FFF, 0x8000, 0x8001, 0xFFFF, 0x0400, 0xFC00};
+  for (u32 i = 0; i < NUM_REGISTERS; i++)
+  {
+    const u32 lo = rng.Next();
+    const u32 hi = rng.Next();
+    const u16 lo_value = ((lo & 0x700) == 0) ? static_cast<u16>(lo >> 16) : values[lo % std::size(values)];
+    const u16 hi_value = ((hi & 0x700) == 0) ? static_cast<u16>(hi >> 16) : values[hi % std::size(values)];
+    GTE::WriteRegister(i, (static_cast<u32>(hi_value) << 16) | lo_value);
+  }
+}
+
+static u64 HashRegisters(u64 hash)
+{
+  for (u32 i = 0; i < NUM_REGISTERS; i++)
+  {
+    // FNV-1a
+    hash = (hash ^ GTE::ReadRegister(i)) * UINT64_C(0x100000001B3);
+  }
+
+  return hash;
+}
+
+static u64 RunCommand(u32 inst_bits, void (*randomize)(Random&) = RandomizeRegisters)
+{
+  GTE::Initialize();
+
+  Random rng(inst_bits);
+  u64 hash = CoreTests::HASH_SEED;
+  for (u32 i = 0; i < NUM_ITERATIONS; i++)
+  {
+    randomize(rng);
+    GTE::ExecuteInstruction(inst_bits);
+    hash = HashRegisters(hash);
+  }
+
+  CPU::ResetPendingTicks();
+  return hash;
+}
+
+static u64 RunCommandVariants(u32 command, void (*randomize)(Random&) = RandomizeRegisters)
+{
+  u64 hash = 0;
+  for (u32 sf = 0; sf < 2; sf++)
+  {
+    for (u32 lm = 0; lm < 2; lm++)
+      hash = hash * 31 + RunCommand(MakeCommand(command, sf != 0, lm != 0), randomize);
+  }
+
+  return hash;
+}
+
+#define GTE_COMMAND_TEST(name, command, expected)                                                                     \
+  TEST(GTE, name) { ASSERT_EQ(RunCommandVariants(command), UINT64_C(expected)); }
+
+GTE_COMMAND_TEST(RTPS, 0x01, 0x7BF3B280CC432F66)
+GTE_COMMAND_TEST(NCLIP, 0x06, 0xCB5915F1F4AFDFBA)
+GTE_COMMAND_TEST(OP, 0x0C, 0x12842CF0D14C42CE)
+GTE_COMMAND_TEST(DPCS, 0x10, 0x2DC4100F9A7C4D86)
+GTE_COMMAND_TEST(INTPL, 0x11, 0x06C18C043137F4A6)
+GTE_COMMAND_TEST(NCDS, 0x13, 0x888BF82C026E665A)
+GTE_COMMAND_TEST(CDP, 0x14, 0x8347E4AF13557564)
+GTE_COMMAND_TEST(NCDT, 0x16, 0xB82257347B2E58D4)
+GTE_COMMAND_TEST(NCCS, 0x1B, 0xB45338B534296307)
+GTE_COMMAND_TEST(CC, 0x1C, 0x432D3B0E008EA22F)
+GTE_COMMAND_TEST(NCS, 0x1E, 0x7BE251BF105767E3)
+GTE_COMMAND_TEST(NCT, 0x20, 0x4BB89C553A237ED8)
+GTE_COMMAND_TEST(SQR, 0x28, 0x295A431AAB281BD5)
+GTE_COMMAND_TEST(DCPL, 0x29, 0x26CF8CE401B60117)
+GTE_COMMAND_TEST(DPCT, 0x2A, 0xA358B9A6B2F5DCD5)
+GTE_COMMAND_TEST(AVSZ3, 0x2D, 0xDFD6F80CFB65EDF8)
+GTE_COMMAND_TEST(AVSZ4, 0x2E, 0x429F9D6B05626323)
+GTE_COMMAND_TEST(RTPT, 0x30, 0xDD3100844AE9D2D2)
+GTE_COMMAND_TEST(GPF, 0x3D, 0x55B0B3BC92EF095A)
+GTE_COMMAND_TEST(GPL, 0x3E, 0x5F4AEFDCDB88F35B)
+GTE_COMMAND_TEST(NCCT, 0x3F, 0x9BBCC41A06197862)
+
+TEST(GTE, MVMVA)
+{
+  // Every matrix, vector and translation combination, including the buggy far colour translation.
+  u64 hash = 0;
+  for (u32 mx = 0; mx < 4; mx++)
+  {
+    for (u32 v = 0; v < 4; v++)
+    {
+      for (u32 cv = 0; cv < 4; cv++)
+        hash = hash * 31 + RunCommandVariants(0x12 | (mx << 17) | (v << 15) | (cv << 13));
+    }
+  }
+
+  ASSERT_EQ(hash, UINT64_C(0x566ED6B3EEABFCBB));
+}
+
+TEST(GTE, RTPSExtreme)
+{
+  ASSERT_EQ(RunCommandVariants(0x01, RandomizeRegistersExtreme), UINT64_C(0x6BA0B6A8DF3D346F));
+}
+
+TEST(GTE, RTPTExtreme)
+{
+  ASSERT_EQ(RunCommandVariants(0x30, RandomizeRegistersExtreme), UINT64_C(0xA133868820FACA63));
+}
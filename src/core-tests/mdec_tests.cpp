@@ -0,0 +1,208 @@
+// SPDX-FileCopyrightText: 2019-2023 Connor McLaughlin <stenzek@gmail.com>
+// SPDX-License-Identifier: (GPL-3.0 OR CC-BY-NC-ND-4.0)
+
+#include "core/cpu_core.h"
+#include "core/mdec.h"
+#include "core/timing_event.h"
+#include "test_utils.h"
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <gtest/gtest.h>
+#include <memory>
+#include <vector>
+
+// Decodes pseudo-random macroblocks in every output mode, and compares a hash of the output with the result of the
+// scalar C++ implementation. The expected values were generated with the SSE2/NEON paths disabled, so this checks that
+// the vectorized IDCT and colour conversion are bit-identical on the targets which use them.
+
+using CoreTests::Random;
+
+namespace {
+enum : u32
+{
+  NUM_BLOCKS = 64 * 6,
+  BLOCKS_PER_MACROBLOCK = 6,
+  TICKS_PER_MACROBLOCK = 448 * BLOCKS_PER_MACROBLOCK,
+  DMA_BLOCK_WORDS = 32,
+
+  STATUS_DATA_OUT_REQUEST = (1u << 27),
+  STATUS_DATA_IN_REQUEST = (1u << 28),
+  STATUS_COMMAND_BUSY = (1u << 29),
+
+  CONTROL_RESET = (1u << 31),
+  CONTROL_ENABLE_DMA_IN = (1u << 30),
+  CONTROL_ENABLE_DMA_OUT = (1u << 29),
+
+  COMMAND_DECODE_MACROBLOCK = (1u << 29),
+  COMMAND_SET_IQ_TABLE = (2u << 29),
+  COMMAND_SET_SCALE_TABLE = (3u << 29),
+  OUTPUT_DEPTH_4BIT = (0u << 27),
+  OUTPUT_DEPTH_8BIT = (1u << 27),
+  OUTPUT_DEPTH_24BIT = (2u << 27),
+  OUTPUT_DEPTH_15BIT = (3u << 27),
+  OUTPUT_SIGNED = (1u << 26),
+  OUTPUT_BIT15 = (1u << 25),
+
+  // Mono output is one block at a time, colour output a whole macroblock.
+  OUTPUT_WORDS_4BIT = (8 * 8 / 2) / sizeof(u32),
+  OUTPUT_WORDS_8BIT = (8 * 8) / sizeof(u32),
+  OUTPUT_WORDS_24BIT = (16 * 16 * 3) / sizeof(u32),
+  OUTPUT_WORDS_15BIT = (16 * 16 * 2) / sizeof(u32),
+
+  END_OF_BLOCK = 0xFE00,
+};
+
+class MDECTest : public ::testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    // RunEvents() needs at least one active event, which a running system always has.
+    TimingEvents::Initialize();
+    m_idle_event = TimingEvents::CreateTimingEvent(
+      "Idle", 1000000, 1000000, [](void*, TickCount, TickCount) {}, nullptr, true);
+    MDEC::Initialize();
+    MDEC::WriteRegister(4, CONTROL_RESET);
+    MDEC::WriteRegister(4, CONTROL_ENABLE_DMA_IN | CONTROL_ENABLE_DMA_OUT);
+  }
+
+  void TearDown() override
+  {
+    MDEC::Shutdown();
+    m_idle_event.reset();
+    TimingEvents::Shutdown();
+    CPU::ResetPendingTicks();
+  }
+
+  std::unique_ptr<TimingEvent> m_idle_event;
+};
+} // namespace
+
+static void SendWords(const u32* words, u32 count)
+{
+  for (u32 i = 0; i < count; i += DMA_BLOCK_WORDS)
+    MDEC::DMAWrite(&words[i], std::min<u32>(count - i, DMA_BLOCK_WORDS));
+}
+
+static void SetRandomTables(Random& rng)
+{
+  // Every quantization step, and a full-range scale table, which the vector IDCT has to handle without overflowing.
+  std::array<u8, 128> iq_tables;
+  rng.Fill(iq_tables.data(), iq_tables.size());
+  MDEC::WriteRegister(0, COMMAND_SET_IQ_TABLE | 1);
+  SendWords(reinterpret_cast<const u32*>(iq_tables.data()), static_cast<u32>(iq_tables.size() / sizeof(u32)));
+
+  std::array<s16, 64> scale_table;
+  rng.Fill(scale_table.data(), sizeof(scale_table));
+  MDEC::WriteRegister(0, COMMAND_SET_SCALE_TABLE);
+  SendWords(reinterpret_cast<const u32*>(scale_table.data()), static_cast<u32>(sizeof(scale_table) / sizeof(u32)));
+}
+
+static std::vector<u32> MakeRandomBlocks(Random& rng)
+{
+  // Full-range DC and AC levels, including a quantization scale of zero, so the coefficients reach both clamps.
+  std::vector<u16> halfwords;
+  for (u32 block = 0; block < NUM_BLOCKS; block++)
+  {
+    halfwords.push_back(static_cast<u16>(rng.Next()));
+
+    u32 coefficient = 0;
+    const u32 num_ac = rng.Next() % 64;
+    for (u32 i = 0; i < num_ac; i++)
+    {
+      const u32 value = rng.Next();
+      const u32 run = (value & 0x30000) ? ((value >> 18) & 0x3) : ((value >> 18) & 0x3F);
+      if ((coefficient + run + 1) >= 63)
+        break;
+
+      coefficient += run + 1;
+      halfwords.push_back(static_cast<u16>((run << 10) | (value & 0x3FF)));
+    }
+
+    halfwords.push_back(END_OF_BLOCK);
+  }
+
+  if (halfwords.size() % 2)
+    halfwords.push_back(END_OF_BLOCK);
+
+  std::vector<u32> words(halfwords.size() / 2);
+  std::memcpy(words.data(), halfwords.data(), words.size() * sizeof(u32));
+  return words;
+}
+
+static u64 DecodeBlocks(u32 command_bits, u32 words_per_macroblock, u32 seed)
+{
+  Random rng(seed);
+  SetRandomTables(rng);
+  const std::vector<u32> data = MakeRandomBlocks(rng);
+  MDEC::WriteRegister(0, COMMAND_DECODE_MACROBLOCK | command_bits | static_cast<u32>(data.size()));
+
+  // Plays the part of the DMA controller, feeding input when requested and draining each macroblock as it's output.
+  std::vector<u32> output(words_per_macroblock);
+  u64 hash = CoreTests::HASH_SEED;
+  size_t pos = 0;
+  u32 idle_count = 0;
+  for (;;)
+  {
+    const u32 status = MDEC::ReadRegister(4);
+    if (status & STATUS_DATA_OUT_REQUEST)
+    {
+      MDEC::DMARead(output.data(), words_per_macroblock);
+      hash = CoreTests::HashBytes(output.data(), output.size() * sizeof(u32), hash);
+      idle_count = 0;
+    }
+    else if ((status & STATUS_DATA_IN_REQUEST) && pos < data.size())
+    {
+      const u32 count = static_cast<u32>(std::min<size_t>(data.size() - pos, DMA_BLOCK_WORDS));
+      MDEC::DMAWrite(&data[pos], count);
+      pos += count;
+      idle_count = 0;
+    }
+    else if (status & STATUS_COMMAND_BUSY)
+    {
+      // Waiting on the block copy out.
+      CPU::AddPendingTicks(TICKS_PER_MACROBLOCK);
+      TimingEvents::RunEvents();
+      if (++idle_count == 16)
+      {
+        ADD_FAILURE() << "MDEC stalled";
+        break;
+      }
+    }
+    else
+    {
+      break;
+    }
+  }
+
+  return hash;
+}
+
+TEST_F(MDECTest, Mono4Bit)
+{
+  ASSERT_EQ(DecodeBlocks(OUTPUT_DEPTH_4BIT, OUTPUT_WORDS_4BIT, 0x4D343030u), UINT64_C(0x982A30E15238BD12));
+  ASSERT_EQ(DecodeBlocks(OUTPUT_DEPTH_4BIT | OUTPUT_SIGNED, OUTPUT_WORDS_4BIT, 0x4D343031u),
+            UINT64_C(0x0E4965D9FB6D5C6C));
+}
+
+TEST_F(MDECTest, Mono8Bit)
+{
+  ASSERT_EQ(DecodeBlocks(OUTPUT_DEPTH_8BIT, OUTPUT_WORDS_8BIT, 0x4D383030u), UINT64_C(0xE9523700B3518C29));
+  ASSERT_EQ(DecodeBlocks(OUTPUT_DEPTH_8BIT | OUTPUT_SIGNED, OUTPUT_WORDS_8BIT, 0x4D383031u),
+            UINT64_C(0x4151DA841E39FFD6));
+}
+
+TEST_F(MDECTest, Color24Bit)
+{
+  ASSERT_EQ(DecodeBlocks(OUTPUT_DEPTH_24BIT, OUTPUT_WORDS_24BIT, 0x43323430u), UINT64_C(0x57BDB69B7094DAB0));
+  ASSERT_EQ(DecodeBlocks(OUTPUT_DEPTH_24BIT | OUTPUT_SIGNED, OUTPUT_WORDS_24BIT, 0x43323431u),
+            UINT64_C(0xAA94596E7B243C58));
+}
+
+TEST_F(MDECTest, Color15Bit)
+{
+  ASSERT_EQ(DecodeBlocks(OUTPUT_DEPTH_15BIT, OUTPUT_WORDS_15BIT, 0x43313530u), UINT64_C(0xFCA02B127B3246C9));
+  ASSERT_EQ(DecodeBlocks(OUTPUT_DEPTH_15BIT | OUTPUT_SIGNED | OUTPUT_BIT15, OUTPUT_WORDS_15BIT, 0x43313531u),
+            UINT64_C(0x6C76A14C3DA065F5));
+}
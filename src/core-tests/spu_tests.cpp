@@ -0,0 +1,207 @@
+// SPDX-FileCopyrightText: 2019-2023 Connor McLaughlin <stenzek@gmail.com>
+// SPDX-License-Identifier: (GPL-3.0 OR CC-BY-NC-ND-4.0)
+
+#include "core/cpu_core.h"
+#include "core/spu.h"
+#include "core/timing_event.h"
+#include "test_utils.h"
+#include <array>
+#include <gtest/gtest.h>
+
+// Plays pseudo-random ADPCM data through every voice and compares a hash of the output and SPU RAM with the result
+// of the scalar C++ implementation. The expected values were generated with the SSE2/NEON paths disabled, so this
+// checks that the vectorized mixing is bit-identical on the targets which use it.
+
+using CoreTests::Random;
+
+namespace {
+enum : u32
+{
+  NUM_VOICES = 24,
+  SYSCLK_TICKS_PER_SPU_TICK = 768,
+  FRAMES_PER_BATCH = 64,
+  NUM_BATCHES = 64,
+
+  // At the fastest clock the noise level steps once per frame, and first reaches -0x8000 after 65533 steps.
+  NOISE_CLOCK_FASTEST = 0x3F,
+  NOISE_MIN_LEVEL_FRAMES = 65536,
+
+  SAMPLE_ADDRESS = 0x1000,
+  SAMPLE_BLOCKS = 64,
+  ADPCM_BLOCK_SIZE = 16,
+
+  // Register offsets from the start of the SPU's I/O range.
+  REG_MAIN_VOLUME_LEFT = 0x180,
+  REG_MAIN_VOLUME_RIGHT = 0x182,
+  REG_KEY_ON_LOW = 0x188,
+  REG_KEY_ON_HIGH = 0x18A,
+  REG_REVERB_VOLUME_LEFT = 0x184,
+  REG_REVERB_VOLUME_RIGHT = 0x186,
+  REG_PITCH_MODULATION_LOW = 0x190,
+  REG_PITCH_MODULATION_HIGH = 0x192,
+  REG_NOISE_MODE_LOW = 0x194,
+  REG_NOISE_MODE_HIGH = 0x196,
+  REG_REVERB_ON_LOW = 0x198,
+  REG_REVERB_ON_HIGH = 0x19A,
+  REG_REVERB_BASE = 0x1A2,
+  REG_SPUCNT = 0x1AA,
+  REG_REVERB_FIRST = 0x1C0,
+  NUM_REVERB_REGS = 32,
+
+  // The upper 128KB of SPU RAM, well clear of the samples.
+  REVERB_BASE_ADDRESS = 0x60000,
+
+  REG_VOICE_VOLUME_LEFT = 0x00,
+  REG_VOICE_VOLUME_RIGHT = 0x02,
+  REG_VOICE_ADSR_LOW = 0x08,
+  REG_VOICE_ADSR_VOLUME = 0x0C,
+};
+
+class SPUTest : public ::testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    TimingEvents::Initialize();
+    SPU::Initialize();
+    SPU::SetOutputHashingEnabled(true);
+  }
+
+  void TearDown() override
+  {
+    SPU::Shutdown();
+    TimingEvents::Shutdown();
+    CPU::ResetPendingTicks();
+  }
+};
+} // namespace
+
+static void WriteRandomSamples(Random& rng)
+{
+  std::array<u8, SPU::RAM_SIZE>& ram = SPU::GetWritableRAM();
+  rng.Fill(&ram[SAMPLE_ADDRESS], SAMPLE_BLOCKS * ADPCM_BLOCK_SIZE);
+  for (u32 i = 0; i < SAMPLE_BLOCKS; i++)
+  {
+    // Every filter, and shifts from nearly silent to clipping.
+    u8* block = &ram[SAMPLE_ADDRESS + i * ADPCM_BLOCK_SIZE];
+    block[0] = static_cast<u8>(((block[0] % 5) << 4) | (block[0] >> 4));
+    block[1] = (i == 0) ? 0x04 : ((i == (SAMPLE_BLOCKS - 1)) ? 0x03 : 0x00); // loop start/end+repeat
+  }
+}
+
+static u16 RandomVolume(Random& rng)
+{
+  // Mostly fixed volumes over the whole range, with some sweeps.
+  const u32 value = rng.Next();
+  return static_cast<u16>(((value & 0x30000) == 0) ? (value | 0x8000) : (value & 0x7FFF));
+}
+
+static void KeyOnRandomVoices(Random& rng)
+{
+  SPU::WriteRegister(REG_MAIN_VOLUME_LEFT, 0x3FFF);
+  SPU::WriteRegister(REG_MAIN_VOLUME_RIGHT, 0x3FFF);
+
+  for (u32 i = 0; i < NUM_VOICES; i++)
+  {
+    const u32 base = i * 0x10;
+    SPU::WriteRegister(base + 0x00, RandomVolume(rng));
+    SPU::WriteRegister(base + 0x02, RandomVolume(rng));
+    SPU::WriteRegister(base + 0x04, static_cast<u16>(rng.Next() & 0x3FFF));
+    SPU::WriteRegister(base + 0x06, static_cast<u16>((SAMPLE_ADDRESS + (rng.Next() % SAMPLE_BLOCKS) * 0x10) / 8));
+    SPU::WriteRegister(base + 0x08, static_cast<u16>(rng.Next()));
+    SPU::WriteRegister(base + 0x0A, static_cast<u16>(rng.Next()));
+  }
+
+  SPU::WriteRegister(REG_PITCH_MODULATION_LOW, static_cast<u16>(rng.Next()));
+  SPU::WriteRegister(REG_PITCH_MODULATION_HIGH, static_cast<u16>(rng.Next() & 0xFF));
+  SPU::WriteRegister(REG_NOISE_MODE_LOW, static_cast<u16>(rng.Next()));
+  SPU::WriteRegister(REG_NOISE_MODE_HIGH, static_cast<u16>(rng.Next() & 0xFF));
+
+  SPU::WriteRegister(REG_KEY_ON_LOW, 0xFFFF);
+  SPU::WriteRegister(REG_KEY_ON_HIGH, 0x00FF);
+}
+
+static void RunFrames(u32 count)
+{
+  CPU::AddPendingTicks(count * SYSCLK_TICKS_PER_SPU_TICK);
+  TimingEvents::RunEvents();
+
+  // The tick event can run well behind, so the register writes in between would otherwise land on arbitrary frames.
+  SPU::GeneratePendingSamples();
+}
+
+static u64 RunVoices(Random& rng)
+{
+  u64 hash = CoreTests::HASH_SEED;
+  for (u32 batch = 0; batch < NUM_BATCHES; batch++)
+  {
+    RunFrames(FRAMES_PER_BATCH);
+
+    // Force some envelopes to the extremes.
+    for (u32 i = 0; i < 4; i++)
+    {
+      const u32 value = rng.Next();
+      const u16 adsr_volume = static_cast<u16>((value & 0x10000) ? ((value & 0x20000) ? 0x8000 : 0x7FFF) : value);
+      SPU::WriteRegister((value >> 24) % NUM_VOICES * 0x10 + REG_VOICE_ADSR_VOLUME, adsr_volume);
+    }
+
+    const u64 output_hash = SPU::GetAndResetOutputHash();
+    hash = CoreTests::HashBytes(&output_hash, sizeof(output_hash), hash);
+  }
+
+  return CoreTests::HashBytes(SPU::GetRAM().data(), SPU::RAM_SIZE, hash);
+}
+
+TEST_F(SPUTest, VoiceMixing)
+{
+  Random rng(0x53505531u);
+  WriteRandomSamples(rng);
+
+  // A fast noise clock, so the noise output reaches its extremes quickly.
+  SPU::WriteRegister(REG_SPUCNT, static_cast<u16>(0xC000 | ((rng.Next() & 0x3) << 8)));
+  KeyOnRandomVoices(rng);
+
+  ASSERT_EQ(RunVoices(rng), UINT64_C(0xBD702315927C3CE6));
+}
+
+TEST_F(SPUTest, NoiseAtMinimumEnvelope)
+{
+  // A single noise voice with its envelope held at -0x8000, by the slowest attack rate. When the noise level reaches
+  // -0x8000, the voice outputs 0x8000, the one value which doesn't fit in 16 bits. Other voices would clip the mix,
+  // and only positive channel volumes round differently if the output were truncated to 0x7FFF.
+  SPU::WriteRegister(REG_MAIN_VOLUME_LEFT, 0x3FFF);
+  SPU::WriteRegister(REG_MAIN_VOLUME_RIGHT, 0x3FFF);
+  SPU::WriteRegister(REG_SPUCNT, static_cast<u16>(0xC000 | (NOISE_CLOCK_FASTEST << 8)));
+  SPU::WriteRegister(REG_VOICE_VOLUME_LEFT, 0x3FFF);
+  SPU::WriteRegister(REG_VOICE_VOLUME_RIGHT, 0x3FFF);
+  SPU::WriteRegister(REG_VOICE_ADSR_LOW, 0x7F00);
+  SPU::WriteRegister(REG_NOISE_MODE_LOW, 0x0001);
+  SPU::WriteRegister(REG_KEY_ON_LOW, 0x0001);
+  RunFrames(1);
+  SPU::WriteRegister(REG_VOICE_ADSR_VOLUME, 0x8000);
+
+  for (u32 i = 0; i < NOISE_MIN_LEVEL_FRAMES; i += FRAMES_PER_BATCH)
+    RunFrames(FRAMES_PER_BATCH);
+
+  ASSERT_EQ(SPU::GetAndResetOutputHash(), UINT64_C(0xB7ACE0E548C0441C));
+}
+
+TEST_F(SPUTest, Reverb)
+{
+  // Voices feed the reverb through both resampling filters. Random offsets and full-range coefficients, so the
+  // work area taps wrap and the saturating steps clip, and the output volumes are random as well.
+  Random rng(0x52455642u);
+  WriteRandomSamples(rng);
+
+  SPU::WriteRegister(REG_SPUCNT, 0xC080);
+  SPU::WriteRegister(REG_REVERB_BASE, static_cast<u16>(REVERB_BASE_ADDRESS / 8));
+  for (u32 i = 0; i < NUM_REVERB_REGS; i++)
+    SPU::WriteRegister(REG_REVERB_FIRST + i * 2, static_cast<u16>(rng.Next()));
+  SPU::WriteRegister(REG_REVERB_VOLUME_LEFT, static_cast<u16>(rng.Next()));
+  SPU::WriteRegister(REG_REVERB_VOLUME_RIGHT, static_cast<u16>(rng.Next()));
+  SPU::WriteRegister(REG_REVERB_ON_LOW, 0xFFFF);
+  SPU::WriteRegister(REG_REVERB_ON_HIGH, 0x00FF);
+  KeyOnRandomVoices(rng);
+
+  ASSERT_EQ(RunVoices(rng), UINT64_C(0xC06694364D336BE0));
+}
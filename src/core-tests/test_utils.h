@@ -0,0 +1,47 @@
+// SPDX-FileCopyrightText: 2019-2023 Connor McLaughlin <stenzek@gmail.com>
+// SPDX-License-Identifier: (GPL-3.0 OR CC-BY-NC-ND-4.0)
+
+#pragma once
+#include "common/types.h"
+#include <cstddef>
+
+namespace CoreTests {
+
+/// xorshift32, so the inputs are the same on every platform and no test data needs to be shipped.
+class Random
+{
+public:
+  explicit Random(u32 seed) : m_state(seed) {}
+
+  u32 Next()
+  {
+    m_state ^= m_state << 13;
+    m_state ^= m_state >> 17;
+    m_state ^= m_state << 5;
+    return m_state;
+  }
+
+  void Fill(void* data, size_t size)
+  {
+    u8* ptr = static_cast<u8*>(data);
+    for (size_t i = 0; i < size; i++)
+      ptr[i] = static_cast<u8>(Next());
+  }
+
+private:
+  u32 m_state;
+};
+
+static constexpr u64 HASH_SEED = UINT64_C(0xCBF29CE484222325);
+
+/// FNV-1a over a byte range, for comparing outputs against the expected values recorded from the scalar paths.
+inline u64 HashBytes(const void* data, size_t size, u64 hash = HASH_SEED)
+{
+  const u8* ptr = static_cast<const u8*>(data);
+  for (size_t i = 0; i < size; i++)
+    hash = (hash ^ ptr[i]) * UINT64_C(0x100000001B3);
+
+  return hash;
+}
+
+} // namespace CoreTests
@@ -119,6 +119,20 @@ bool AnalogController::DoState(StateWrapper& sw, bool apply_input_state)
   return true;
 }
 
+bool AnalogController::DoInputState(StateWrapper& sw)
+{
+  // the analog button is a toggle, so the mode it left the controller in is recorded instead
+  bool analog_mode = m_analog_mode;
+  sw.Do(&analog_mode);
+  sw.Do(&m_button_state);
+  sw.Do(&m_axis_state);
+  sw.Do(&m_half_axis_state);
+  if (sw.IsReading() && analog_mode != m_analog_mode)
+    SetAnalogMode(analog_mode, true);
+
+  return !sw.HasError();
+}
+
 float AnalogController::GetBindState(u32 index) const
 {
   if (index >= static_cast<u32>(Button::Count))
@@ -69,6 +69,7 @@ public:
 
   void Reset() override;
   bool DoState(StateWrapper& sw, bool ignore_input_state) override;
+  bool DoInputState(StateWrapper& sw) override;
 
   float GetBindState(u32 index) const override;
   void SetBindState(u32 index, float value) override;
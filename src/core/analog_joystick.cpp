@@ -66,6 +66,19 @@ bool AnalogJoystick::DoState(StateWrapper& sw, bool apply_input_state)
   return true;
 }
 
+bool AnalogJoystick::DoInputState(StateWrapper& sw)
+{
+  bool analog_mode = m_analog_mode;
+  sw.Do(&analog_mode);
+  sw.Do(&m_button_state);
+  sw.Do(&m_axis_state);
+  sw.Do(&m_half_axis_state);
+  if (sw.IsReading() && analog_mode != m_analog_mode)
+    ToggleAnalogMode();
+
+  return !sw.HasError();
+}
+
 float AnalogJoystick::GetBindState(u32 index) const
 {
   if (index >= static_cast<u32>(Button::Count))
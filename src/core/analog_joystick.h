@@ -67,6 +67,7 @@ public:
 
   void Reset() override;
   bool DoState(StateWrapper& sw, bool apply_input_state) override;
+  bool DoInputState(StateWrapper& sw) override;
 
   float GetBindState(u32 index) const override;
   void SetBindState(u32 index, float value) override;
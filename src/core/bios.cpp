@@ -242,6 +242,15 @@ bool BIOS::PatchBIOSForEXE(u8* image, u32 image_size, u32 r_pc, u32 r_gp, u32 r_
   return true;
 }
 
+bool BIOS::PatchBIOSHaltForEXE(u8* image, u32 image_size)
+{
+  Log_InfoPrintf("Patching BIOS to halt before starting the executable");
+  const u32 jump = UINT32_C(0x08000000) | ((EXE_BOOT_ADDRESS >> 2) & UINT32_C(0x03FFFFFF));
+  PatchBIOS(image, image_size, EXE_BOOT_ADDRESS, jump);                     // j EXE_BOOT_ADDRESS
+  PatchBIOS(image, image_size, EXE_BOOT_ADDRESS + 4, UINT32_C(0x00000000)); // nop
+  return true;
+}
+
 bool BIOS::IsValidPSExeHeader(const PSEXEHeader& header, u32 file_size)
 {
   static constexpr char expected_id[] = {'P', 'S', '-', 'X', ' ', 'E', 'X', 'E'};
@@ -71,6 +71,12 @@ bool PatchBIOSEnableTTY(u8* image, u32 image_size);
 bool PatchBIOSFastBoot(u8* image, u32 image_size);
 bool PatchBIOSForEXE(u8* image, u32 image_size, u32 r_pc, u32 r_gp, u32 r_sp, u32 r_fp);
 
+/// Where PatchBIOSForEXE() starts the executable, once the kernel has been initialized.
+static constexpr u32 EXE_BOOT_ADDRESS = UINT32_C(0xBFC06FF0);
+
+/// Makes the BIOS spin at EXE_BOOT_ADDRESS, so the state can be captured before the executable is loaded.
+bool PatchBIOSHaltForEXE(u8* image, u32 image_size);
+
 bool IsValidPSExeHeader(const PSEXEHeader& header, u32 file_size);
 DiscRegion GetPSExeDiscRegion(const PSEXEHeader& header);
 
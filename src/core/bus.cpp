@@ -11,9 +11,11 @@
 #include "cpu_core.h"
 #include "cpu_core_private.h"
 #include "cpu_disasm.h"
+#include "cpu_recompiler_thunks.h"
 #include "dma.h"
 #include "gpu.h"
 #include "host.h"
+#include "imgui.h"
 #include "interrupt_controller.h"
 #include "mdec.h"
 #include "pad.h"
@@ -22,6 +24,8 @@
 #include "spu.h"
 #include "timers.h"
 #include "util/state_wrapper.h"
+#include <algorithm>
+#include <cinttypes>
 #include <cstdio>
 #include <tuple>
 #include <utility>
@@ -114,6 +118,12 @@ static Common::MemoryArena m_memory_arena;
 
 static CPUFastmemMode m_fastmem_mode = CPUFastmemMode::Disabled;
 
+// Memory save state which each RAM page was last written before, for incremental memory states.
+static std::array<u64, CPU::RAM_DIRTY_PAGE_COUNT> s_ram_page_serials = {};
+static u64 s_ram_snapshot_serial = 0;
+static RAMSnapshot* s_memory_state_ram_snapshot = nullptr;
+static bool s_ram_dirty_tracking = false;
+
 #ifdef WITH_MMAP_FASTMEM
 static u8* m_fastmem_base = nullptr;
 static std::vector<Common::MemoryArena::View> m_fastmem_ram_views;
@@ -121,6 +131,11 @@ static std::vector<Common::MemoryArena::View> m_fastmem_reserved_views;
 #endif
 
 static u8** m_fastmem_lut = nullptr;
+
+// Reads and writes of each word in the I/O page, only counted while enabled.
+static constexpr u32 IO_ACCESS_COUNT_SLOTS = (EXP2_BASE - MEMCTRL_BASE) / sizeof(u32);
+static std::array<std::array<u64, IO_ACCESS_COUNT_SLOTS>, 2> s_io_access_counts = {};
+static bool s_io_access_counting = false;
 static constexpr auto m_fastmem_ram_mirrors =
   make_array(0x00000000u, 0x00200000u, 0x00400000u, 0x00600000u, 0x80000000u, 0x80200000u, 0x80400000u, 0x80600000u,
              0xA0000000u, 0xA0200000u, 0xA0400000u, 0xA0600000u);
@@ -133,6 +148,8 @@ static void ReleaseMemory();
 
 static void SetCodePageFastmemProtection(u32 page_index, bool writable);
 
+static void DoMemoryStateRAM(StateWrapper& sw, RAMSnapshot* snapshot);
+
 #define FIXUP_HALFWORD_OFFSET(size, offset) ((size >= MemoryAccessSize::HalfWord) ? (offset) : ((offset) & ~1u))
 #define FIXUP_HALFWORD_READ_VALUE(size, offset, value)                                                                 \
   ((size >= MemoryAccessSize::HalfWord) ? (value) : ((value) >> (((offset)&u32(1)) * 8u)))
@@ -176,6 +193,9 @@ void Shutdown()
 void Reset()
 {
   std::memset(g_ram, 0, g_ram_size);
+  UpdateIOAccessCounting();
+  ResetIOAccessCounts();
+  CPU::g_state.ram_dirty_pages.fill(1);
   m_MEMCTRL.exp1_base = 0x1F000000;
   m_MEMCTRL.exp2_base = 0x1F802000;
   m_MEMCTRL.exp1_delay_size.bits = 0x0013243F;
@@ -210,7 +230,17 @@ bool DoState(StateWrapper& sw)
   sw.Do(&m_bios_access_time);
   sw.Do(&m_cdrom_access_time);
   sw.Do(&m_spu_access_time);
-  sw.DoBytes(g_ram, g_ram_size);
+
+  if (sw.IsWriting() && s_memory_state_ram_snapshot)
+  {
+    DoMemoryStateRAM(sw, s_memory_state_ram_snapshot);
+  }
+  else
+  {
+    sw.DoBytes(g_ram, g_ram_size);
+    if (sw.IsReading())
+      CPU::g_state.ram_dirty_pages.fill(1);
+  }
 
   if (sw.GetVersion() < 58)
   {
@@ -224,6 +254,92 @@ bool DoState(StateWrapper& sw)
   return !sw.HasError();
 }
 
+void DoMemoryStateRAM(StateWrapper& sw, RAMSnapshot* snapshot)
+{
+  // pages written since the previous memory state changed in this one
+  const u64 serial = ++s_ram_snapshot_serial;
+  const u32 page_count = g_ram_size / HOST_PAGE_SIZE;
+  for (u32 i = 0; i < page_count; i++)
+  {
+    if (CPU::g_state.ram_dirty_pages[i])
+    {
+      s_ram_page_serials[i] = serial;
+      CPU::g_state.ram_dirty_pages[i] = 0;
+    }
+  }
+
+  ByteStream* stream = sw.GetStream();
+  const u32 offset = static_cast<u32>(stream->GetPosition());
+  bool copied = false;
+  if (snapshot->serial != 0 && snapshot->stream_offset == offset && snapshot->size == g_ram_size &&
+      stream->GetSize() >= (offset + g_ram_size) && !sw.HasError())
+  {
+    // only rewrite the runs of pages which have changed since the stream's copy was made
+    copied = true;
+    for (u32 page = 0; page < page_count && copied;)
+    {
+      if (s_ram_page_serials[page] <= snapshot->serial)
+      {
+        page++;
+        continue;
+      }
+
+      u32 end_page = page + 1;
+      while (end_page < page_count && s_ram_page_serials[end_page] > snapshot->serial)
+        end_page++;
+
+      copied = (stream->SeekAbsolute(offset + (page * HOST_PAGE_SIZE)) &&
+                stream->Write2(&g_ram[page * HOST_PAGE_SIZE], (end_page - page) * HOST_PAGE_SIZE));
+      page = end_page;
+    }
+
+    copied = copied && stream->SeekAbsolute(offset + g_ram_size);
+  }
+
+  if (!copied)
+  {
+    stream->SeekAbsolute(offset);
+    sw.DoBytes(g_ram, g_ram_size);
+  }
+
+  snapshot->serial = sw.HasError() ? 0 : serial;
+  snapshot->stream_offset = offset;
+  snapshot->size = g_ram_size;
+}
+
+bool IsRAMDirtyTrackingEnabled()
+{
+  return s_ram_dirty_tracking;
+}
+
+void SetRAMDirtyTracking(bool enabled)
+{
+  // pages written while tracking was off weren't flagged, so nothing can be trusted
+  if (enabled && !s_ram_dirty_tracking)
+    CPU::g_state.ram_dirty_pages.fill(1);
+
+  s_ram_dirty_tracking = enabled;
+}
+
+void SetMemoryStateRAMSnapshot(RAMSnapshot* snapshot)
+{
+  s_memory_state_ram_snapshot = snapshot;
+}
+
+void MarkRAMDirty(PhysicalMemoryAddress address, u32 size)
+{
+  if (!IsRAMAddress(address) || size == 0)
+    return;
+
+  // the range can wrap around the end of RAM
+  const u32 page_count = g_ram_size / HOST_PAGE_SIZE;
+  const u32 offset = address & g_ram_mask;
+  const u32 num_pages =
+    std::min<u32>(((offset & HOST_PAGE_OFFSET_MASK) + size + HOST_PAGE_OFFSET_MASK) / HOST_PAGE_SIZE, page_count);
+  for (u32 i = 0, page = offset / HOST_PAGE_SIZE; i < num_pages; i++, page = (page + 1) % page_count)
+    CPU::g_state.ram_dirty_pages[page] = 1;
+}
+
 void SetExpansionROM(std::vector<u8> data)
 {
   m_exp1_rom = std::move(data);
@@ -287,7 +403,7 @@ void RecalculateMemoryTimings()
 
 bool AllocateMemory(bool enable_8mb_ram)
 {
-  if (!m_memory_arena.Create(MEMORY_ARENA_SIZE, true, false))
+  if (!m_memory_arena.Create(MEMORY_ARENA_SIZE, true, false, g_settings.cpu_use_large_pages))
   {
     Log_ErrorPrint("Failed to create memory arena");
     return false;
@@ -391,7 +507,8 @@ void UpdateFastmemViews(CPUFastmemMode mode)
       m_fastmem_base = static_cast<u8*>(m_memory_arena.FindBaseAddressForMapping(FASTMEM_REGION_SIZE));
       if (!m_fastmem_base)
       {
-        Log_ErrorPrint("Failed to find base address for fastmem");
+        Log_ErrorPrint("Failed to find base address for fastmem, falling back to LUT");
+        UpdateFastmemViews(CPUFastmemMode::LUT);
         return;
       }
 
@@ -441,6 +558,11 @@ void UpdateFastmemViews(CPUFastmemMode mode)
 #endif
     };
 
+#ifdef CPU_AARCH32
+    // Segment bits are masked off by the recompiler, so only the physical address space is mapped.
+    MapRAM(0x00000000);
+    ReserveRegion(0x00000000 + g_ram_size, FASTMEM_REGION_SIZE - 1);
+#else
     // KUSEG - cached
     MapRAM(0x00000000);
     ReserveRegion(0x00000000 + g_ram_size, 0x80000000 - 1);
@@ -452,6 +574,7 @@ void UpdateFastmemViews(CPUFastmemMode mode)
     // KSEG1 - uncached
     MapRAM(0xA0000000);
     ReserveRegion(0xA0000000 + g_ram_size, 0xFFFFFFFF);
+#endif
 
     return;
   }
@@ -494,6 +617,25 @@ void UpdateFastmemViews(CPUFastmemMode mode)
   MapRAM(0xA0200000);
   MapRAM(0xA0400000);
   MapRAM(0xA0600000);
+
+  // Scratchpad, which is only reachable through KUSEG/KSEG0. The rest of its 4K page hits the padding after it.
+  SetLUTFastmemPage(CPU::DCACHE_LOCATION, CPU::g_state.dcache.data(), true);
+  SetLUTFastmemPage(0x80000000u | CPU::DCACHE_LOCATION, CPU::g_state.dcache.data(), true);
+
+  // BIOS is mapped read-only, so writes fault and get backpatched to the slow path.
+  auto MapBIOS = [](u32 base_address) {
+    for (u32 address = 0; address < BIOS_SIZE; address += HOST_PAGE_SIZE)
+      SetLUTFastmemPage(base_address + address, &g_bios[address], false);
+  };
+  MapBIOS(BIOS_BASE);
+  MapBIOS(0x80000000u | BIOS_BASE);
+  MapBIOS(0xA0000000u | BIOS_BASE);
+}
+
+static ALWAYS_INLINE bool IsScratchpadFastmemAddress(VirtualMemoryAddress address)
+{
+  // KUSEG and KSEG0 only, KSEG1 doesn't see the scratchpad.
+  return ((address & 0x7FFFFC00u) == CPU::DCACHE_LOCATION);
 }
 
 bool CanUseFastmemForAddress(VirtualMemoryAddress address)
@@ -512,7 +654,8 @@ bool CanUseFastmemForAddress(VirtualMemoryAddress address)
 #endif
 
     case CPUFastmemMode::LUT:
-      return (paddr < g_ram_size);
+      return (paddr < g_ram_size || IsScratchpadFastmemAddress(address) ||
+              (paddr >= BIOS_BASE && paddr < (BIOS_BASE + BIOS_SIZE)));
 
     case CPUFastmemMode::Disabled:
     default:
@@ -520,6 +663,20 @@ bool CanUseFastmemForAddress(VirtualMemoryAddress address)
   }
 }
 
+TickCount GetFastmemReadTicks(VirtualMemoryAddress address, MemoryAccessSize size)
+{
+  if (m_fastmem_mode == CPUFastmemMode::LUT)
+  {
+    const PhysicalMemoryAddress paddr = address & CPU::PHYSICAL_MEMORY_ADDRESS_MASK;
+    if (IsScratchpadFastmemAddress(address))
+      return 0;
+    else if (paddr >= BIOS_BASE && paddr < (BIOS_BASE + BIOS_SIZE))
+      return m_bios_access_time[static_cast<u32>(size)];
+  }
+
+  return RAM_READ_TICKS;
+}
+
 bool IsRAMCodePage(u32 index)
 {
   return m_ram_code_bits[index];
@@ -805,6 +962,8 @@ ALWAYS_INLINE static TickCount DoRAMAccess(u32 offset, u32& value)
   else
   {
     const u32 page_index = offset / HOST_PAGE_SIZE;
+    constexpr u32 write_size = 1u << static_cast<u32>(size);
+    CPU::g_state.ram_dirty_pages[page_index] = 1;
     if constexpr (skip_redundant_writes)
     {
       if constexpr (size == MemoryAccessSize::Byte)
@@ -813,7 +972,7 @@ ALWAYS_INLINE static TickCount DoRAMAccess(u32 offset, u32& value)
         {
           g_ram[offset] = Truncate8(value);
           if (m_ram_code_bits[page_index])
-            CPU::CodeCache::InvalidateBlocksWithPageIndex(page_index);
+            CPU::CodeCache::InvalidateBlocksInPageRange(page_index, offset, offset + write_size);
         }
       }
       else if constexpr (size == MemoryAccessSize::HalfWord)
@@ -825,7 +984,7 @@ ALWAYS_INLINE static TickCount DoRAMAccess(u32 offset, u32& value)
         {
           std::memcpy(&g_ram[offset], &new_value, sizeof(u16));
           if (m_ram_code_bits[page_index])
-            CPU::CodeCache::InvalidateBlocksWithPageIndex(page_index);
+            CPU::CodeCache::InvalidateBlocksInPageRange(page_index, offset, offset + write_size);
         }
       }
       else if constexpr (size == MemoryAccessSize::Word)
@@ -836,14 +995,14 @@ ALWAYS_INLINE static TickCount DoRAMAccess(u32 offset, u32& value)
         {
           std::memcpy(&g_ram[offset], &value, sizeof(u32));
           if (m_ram_code_bits[page_index])
-            CPU::CodeCache::InvalidateBlocksWithPageIndex(page_index);
+            CPU::CodeCache::InvalidateBlocksInPageRange(page_index, offset, offset + write_size);
         }
       }
     }
     else
     {
       if (m_ram_code_bits[page_index])
-        CPU::CodeCache::InvalidateBlocksWithPageIndex(page_index);
+        CPU::CodeCache::InvalidateBlocksInPageRange(page_index, offset, offset + write_size);
 
       if constexpr (size == MemoryAccessSize::Byte)
       {
@@ -1338,6 +1497,302 @@ ALWAYS_INLINE static TickCount DoDMAAccess(u32 offset, u32& value)
   }
 }
 
+// The I/O page (MEMCTRL_BASE up to EXP2_BASE) is dispatched through a table instead of a chain of range checks.
+// Every device starts and ends on a 16 byte boundary, so one slot per 16 bytes is enough.
+static constexpr u32 IO_PAGE_BASE = MEMCTRL_BASE;
+static constexpr u32 IO_PAGE_SIZE = EXP2_BASE - MEMCTRL_BASE;
+static constexpr u32 IO_PAGE_SLOT_SHIFT = 4;
+static constexpr u32 IO_PAGE_SLOT_COUNT = IO_PAGE_SIZE >> IO_PAGE_SLOT_SHIFT;
+static constexpr u32 IO_PAGE_SLOT_MASK = IO_PAGE_SLOT_COUNT - 1;
+static_assert(Common::IsPow2(IO_PAGE_SLOT_COUNT));
+
+using IORegisterHandler = TickCount (*)(PhysicalMemoryAddress address, u32& value);
+
+template<MemoryAccessType type, MemoryAccessSize size, TickCount (*Handler)(u32, u32&), u32 mask>
+static TickCount DoIORegisterAccess(PhysicalMemoryAddress address, u32& value)
+{
+  return Handler(address & mask, value);
+}
+
+template<MemoryAccessType type, MemoryAccessSize size>
+static TickCount DoInvalidIORegisterAccess(PhysicalMemoryAddress address, u32& value)
+{
+  return DoInvalidAccess(type, size, address, value);
+}
+
+template<MemoryAccessType type, MemoryAccessSize size>
+struct IORegisterTable
+{
+  IORegisterHandler handlers[IO_PAGE_SLOT_COUNT];
+
+  constexpr IORegisterTable() : handlers()
+  {
+    for (u32 i = 0; i < IO_PAGE_SLOT_COUNT; i++)
+      handlers[i] = &DoInvalidIORegisterAccess<type, size>;
+
+    Map<&DoMemoryControlAccess<type, size>, MEMCTRL_MASK>(MEMCTRL_BASE, MEMCTRL_SIZE);
+    Map<&DoPadAccess<type, size>, PAD_MASK>(PAD_BASE, PAD_SIZE);
+    Map<&DoSIOAccess<type, size>, SIO_MASK>(SIO_BASE, SIO_SIZE);
+    Map<&DoMemoryControl2Access<type, size>, MEMCTRL2_MASK>(MEMCTRL2_BASE, MEMCTRL2_SIZE);
+    Map<&DoAccessInterruptController<type, size>, INTERRUPT_CONTROLLER_MASK>(INTERRUPT_CONTROLLER_BASE,
+                                                                             INTERRUPT_CONTROLLER_SIZE);
+    Map<&DoDMAAccess<type, size>, DMA_MASK>(DMA_BASE, DMA_SIZE);
+    Map<&DoAccessTimers<type, size>, TIMERS_MASK>(TIMERS_BASE, TIMERS_SIZE);
+    Map<&DoCDROMAccess<type, size>, CDROM_MASK>(CDROM_BASE, CDROM_SIZE);
+    Map<&DoGPUAccess<type, size>, GPU_MASK>(GPU_BASE, GPU_SIZE);
+    Map<&DoMDECAccess<type, size>, MDEC_MASK>(MDEC_BASE, MDEC_SIZE);
+    Map<&DoAccessSPU<type, size>, SPU_MASK>(SPU_BASE, SPU_SIZE);
+  }
+
+  template<TickCount (*Handler)(u32, u32&), u32 mask>
+  constexpr void Map(u32 base, u32 size_in_bytes)
+  {
+    for (u32 i = 0; i < (size_in_bytes >> IO_PAGE_SLOT_SHIFT); i++)
+      handlers[((base - IO_PAGE_BASE) >> IO_PAGE_SLOT_SHIFT) + i] = &DoIORegisterAccess<type, size, Handler, mask>;
+  }
+};
+
+template<MemoryAccessType type, MemoryAccessSize size>
+static constexpr IORegisterTable<type, size> s_io_register_table;
+
+ALWAYS_INLINE static void CountIOAccess(MemoryAccessType type, u32 address)
+{
+  if (UNLIKELY(s_io_access_counting))
+    s_io_access_counts[static_cast<u32>(type)][(address & (IO_PAGE_SIZE - 1)) / sizeof(u32)]++;
+}
+
+template<MemoryAccessType type, MemoryAccessSize size>
+ALWAYS_INLINE static TickCount DoIOPageAccess(PhysicalMemoryAddress address, u32& value)
+{
+  CountIOAccess(type, address);
+  return s_io_register_table<type, size>.handlers[(address >> IO_PAGE_SLOT_SHIFT) & IO_PAGE_SLOT_MASK](address, value);
+}
+
+namespace {
+struct IODeviceRange
+{
+  const char* name;
+  PhysicalMemoryAddress base;
+  u32 size;
+};
+
+struct IOAccessCountRow
+{
+  PhysicalMemoryAddress address;
+  u32 device;
+  u64 reads;
+  u64 writes;
+};
+} // namespace
+
+static constexpr std::array<IODeviceRange, 11> s_io_devices = {{
+  {"MEMCTRL", MEMCTRL_BASE, MEMCTRL_SIZE},
+  {"PAD", PAD_BASE, PAD_SIZE},
+  {"SIO", SIO_BASE, SIO_SIZE},
+  {"MEMCTRL2", MEMCTRL2_BASE, MEMCTRL2_SIZE},
+  {"INTC", INTERRUPT_CONTROLLER_BASE, INTERRUPT_CONTROLLER_SIZE},
+  {"DMA", DMA_BASE, DMA_SIZE},
+  {"TIMERS", TIMERS_BASE, TIMERS_SIZE},
+  {"CDROM", CDROM_BASE, CDROM_SIZE},
+  {"GPU", GPU_BASE, GPU_SIZE},
+  {"MDEC", MDEC_BASE, MDEC_SIZE},
+  {"SPU", SPU_BASE, SPU_SIZE},
+}};
+
+static u32 GetIODeviceIndex(PhysicalMemoryAddress address)
+{
+  for (u32 i = 0; i < static_cast<u32>(s_io_devices.size()); i++)
+  {
+    if (address >= s_io_devices[i].base && address < (s_io_devices[i].base + s_io_devices[i].size))
+      return i;
+  }
+
+  return static_cast<u32>(s_io_devices.size());
+}
+
+static const char* GetIODeviceName(u32 index)
+{
+  return (index < s_io_devices.size()) ? s_io_devices[index].name : "Unknown";
+}
+
+/// Returns the registers which have been accessed, in address order.
+static std::vector<IOAccessCountRow> GetIOAccessCountRows()
+{
+  std::vector<IOAccessCountRow> rows;
+  for (u32 i = 0; i < IO_ACCESS_COUNT_SLOTS; i++)
+  {
+    const u64 reads = s_io_access_counts[static_cast<u32>(MemoryAccessType::Read)][i];
+    const u64 writes = s_io_access_counts[static_cast<u32>(MemoryAccessType::Write)][i];
+    if (reads == 0 && writes == 0)
+      continue;
+
+    const PhysicalMemoryAddress address = IO_PAGE_BASE + (i * sizeof(u32));
+    rows.push_back(IOAccessCountRow{address, GetIODeviceIndex(address), reads, writes});
+  }
+
+  return rows;
+}
+
+/// Sums the register rows into one per device, in device order.
+static std::vector<IOAccessCountRow> GetIODeviceAccessCountRows(const std::vector<IOAccessCountRow>& register_rows)
+{
+  std::vector<IOAccessCountRow> rows;
+  for (const IOAccessCountRow& rrow : register_rows)
+  {
+    auto iter = std::find_if(rows.begin(), rows.end(),
+                             [&rrow](const IOAccessCountRow& row) { return row.device == rrow.device; });
+    if (iter == rows.end())
+    {
+      const PhysicalMemoryAddress base =
+        (rrow.device < s_io_devices.size()) ? s_io_devices[rrow.device].base : rrow.address;
+      rows.push_back(IOAccessCountRow{base, rrow.device, rrow.reads, rrow.writes});
+    }
+    else
+    {
+      iter->reads += rrow.reads;
+      iter->writes += rrow.writes;
+    }
+  }
+
+  return rows;
+}
+
+static void DrawIOAccessCountTable(const char* str_id, std::vector<IOAccessCountRow>& rows, bool show_address)
+{
+  enum : u32
+  {
+    COLUMN_ADDRESS,
+    COLUMN_DEVICE,
+    COLUMN_READS,
+    COLUMN_WRITES,
+    COLUMN_TOTAL
+  };
+
+  const u32 num_columns = show_address ? 5 : 4;
+  const ImGuiTableFlags flags = ImGuiTableFlags_Sortable | ImGuiTableFlags_RowBg | ImGuiTableFlags_Borders;
+  if (!ImGui::BeginTable(str_id, num_columns, flags))
+    return;
+
+  if (show_address)
+    ImGui::TableSetupColumn("Address", 0, 0.0f, COLUMN_ADDRESS);
+  ImGui::TableSetupColumn("Device", 0, 0.0f, COLUMN_DEVICE);
+  ImGui::TableSetupColumn("Reads", ImGuiTableColumnFlags_PreferSortDescending, 0.0f, COLUMN_READS);
+  ImGui::TableSetupColumn("Writes", ImGuiTableColumnFlags_PreferSortDescending, 0.0f, COLUMN_WRITES);
+  ImGui::TableSetupColumn("Total", ImGuiTableColumnFlags_DefaultSort | ImGuiTableColumnFlags_PreferSortDescending,
+                          0.0f, COLUMN_TOTAL);
+  ImGui::TableHeadersRow();
+
+  const ImGuiTableSortSpecs* sort_specs = ImGui::TableGetSortSpecs();
+  if (sort_specs && sort_specs->SpecsCount > 0)
+  {
+    const ImGuiTableColumnSortSpecs& spec = sort_specs->Specs[0];
+    const auto key = [column = spec.ColumnUserID](const IOAccessCountRow& row) -> u64 {
+      switch (column)
+      {
+        case COLUMN_DEVICE:
+          return row.device;
+        case COLUMN_READS:
+          return row.reads;
+        case COLUMN_WRITES:
+          return row.writes;
+        case COLUMN_TOTAL:
+          return row.reads + row.writes;
+        case COLUMN_ADDRESS:
+        default:
+          return row.address;
+      }
+    };
+    const bool ascending = (spec.SortDirection == ImGuiSortDirection_Ascending);
+    std::stable_sort(rows.begin(), rows.end(),
+                     [&key, ascending](const IOAccessCountRow& lhs, const IOAccessCountRow& rhs) {
+                       return ascending ? (key(lhs) < key(rhs)) : (key(lhs) > key(rhs));
+                     });
+  }
+
+  for (const IOAccessCountRow& row : rows)
+  {
+    ImGui::TableNextRow();
+    if (show_address)
+    {
+      ImGui::TableNextColumn();
+      ImGui::Text("0x%08X", row.address);
+    }
+    ImGui::TableNextColumn();
+    ImGui::TextUnformatted(GetIODeviceName(row.device));
+    ImGui::TableNextColumn();
+    ImGui::Text("%" PRIu64, row.reads);
+    ImGui::TableNextColumn();
+    ImGui::Text("%" PRIu64, row.writes);
+    ImGui::TableNextColumn();
+    ImGui::Text("%" PRIu64, row.reads + row.writes);
+  }
+
+  ImGui::EndTable();
+}
+
+void UpdateIOAccessCounting()
+{
+  s_io_access_counting = (g_settings.debugging.count_io_accesses || g_settings.debugging.show_io_access_counts);
+}
+
+void ResetIOAccessCounts()
+{
+  for (auto& counts : s_io_access_counts)
+    counts.fill(0);
+}
+
+void DrawIOAccessCountsWindow()
+{
+  const float framebuffer_scale = Host::GetOSDScale();
+
+  ImGui::SetNextWindowSize(ImVec2(500.0f * framebuffer_scale, 600.0f * framebuffer_scale), ImGuiCond_FirstUseEver);
+  if (!ImGui::Begin("I/O Access Counts", nullptr))
+  {
+    ImGui::End();
+    return;
+  }
+
+  if (ImGui::Button("Reset"))
+    ResetIOAccessCounts();
+
+  std::vector<IOAccessCountRow> register_rows = GetIOAccessCountRows();
+  std::vector<IOAccessCountRow> device_rows = GetIODeviceAccessCountRows(register_rows);
+
+  if (ImGui::CollapsingHeader("Devices", ImGuiTreeNodeFlags_DefaultOpen))
+    DrawIOAccessCountTable("Devices", device_rows, false);
+
+  if (ImGui::CollapsingHeader("Registers", ImGuiTreeNodeFlags_DefaultOpen))
+    DrawIOAccessCountTable("Registers", register_rows, true);
+
+  ImGui::End();
+}
+
+void WriteIOAccessCounts(std::FILE* fp)
+{
+  const std::vector<IOAccessCountRow> register_rows = GetIOAccessCountRows();
+  const std::vector<IOAccessCountRow> device_rows = GetIODeviceAccessCountRows(register_rows);
+
+  std::fprintf(fp, "{\n");
+  std::fprintf(fp, "  \"devices\": {");
+  for (size_t i = 0; i < device_rows.size(); i++)
+  {
+    const IOAccessCountRow& row = device_rows[i];
+    std::fprintf(fp, "%s\n    \"%s\": {\"reads\": %" PRIu64 ", \"writes\": %" PRIu64 "}", (i > 0) ? "," : "",
+                 GetIODeviceName(row.device), row.reads, row.writes);
+  }
+  std::fprintf(fp, "\n  },\n");
+
+  std::fprintf(fp, "  \"registers\": {");
+  for (size_t i = 0; i < register_rows.size(); i++)
+  {
+    const IOAccessCountRow& row = register_rows[i];
+    std::fprintf(fp, "%s\n    \"0x%08X\": {\"device\": \"%s\", \"reads\": %" PRIu64 ", \"writes\": %" PRIu64 "}",
+                 (i > 0) ? "," : "", row.address, GetIODeviceName(row.device), row.reads, row.writes);
+  }
+  std::fprintf(fp, "\n  }\n");
+  std::fprintf(fp, "}\n");
+}
+
 } // namespace Bus
 
 namespace CPU {
@@ -1416,11 +1871,15 @@ TickCount GetICacheFillTicks(VirtualMemoryAddress address)
   }
 }
 
-void CheckAndUpdateICacheTags(u32 line_count, TickCount uncached_ticks)
+void CheckAndUpdateICacheTags(u32 line_count, TickCount uncached_ticks, u32* icache_generation)
 {
   VirtualMemoryAddress current_pc = g_state.regs.pc & ICACHE_TAG_ADDRESS_MASK;
   if (IsCachedAddress(current_pc))
   {
+    // nothing's been evicted since the last time this block checked its lines?
+    if (*icache_generation == g_state.icache_generation)
+      return;
+
     TickCount ticks = 0;
     TickCount cached_ticks_per_line = GetICacheFillTicks(current_pc);
     for (u32 i = 0; i < line_count; i++, current_pc += ICACHE_LINE_SIZE)
@@ -1429,11 +1888,13 @@ void CheckAndUpdateICacheTags(u32 line_count, TickCount uncached_ticks)
       if (g_state.icache_tags[line] != current_pc)
       {
         g_state.icache_tags[line] = current_pc;
+        g_state.icache_generation++;
         ticks += cached_ticks_per_line;
       }
     }
 
     g_state.pending_ticks += ticks;
+    *icache_generation = g_state.icache_generation;
   }
   else
   {
@@ -1467,6 +1928,7 @@ u32 FillICache(VirtualMemoryAddress address)
       break;
   }
   g_state.icache_tags[line] = line_tag;
+  g_state.icache_generation++;
 
   const u32 offset = GetICacheLineOffset(address);
   u32 result;
@@ -1478,6 +1940,7 @@ void ClearICache()
 {
   std::memset(g_state.icache_data.data(), 0, ICACHE_SIZE);
   g_state.icache_tags.fill(ICACHE_INVALID_BITS);
+  g_state.icache_generation++;
 }
 
 ALWAYS_INLINE_RELEASE static u32 ReadICache(VirtualMemoryAddress address)
@@ -1495,6 +1958,7 @@ ALWAYS_INLINE_RELEASE static void WriteICache(VirtualMemoryAddress address, u32
   const u32 line = GetICacheLine(address);
   const u32 offset = GetICacheLineOffset(address);
   g_state.icache_tags[line] = GetICacheTagForAddress(address) | ICACHE_INVALID_BITS;
+  g_state.icache_generation++;
   std::memcpy(&g_state.icache_data[line * ICACHE_LINE_SIZE + offset], &value, sizeof(value));
 }
 
@@ -1624,61 +2088,9 @@ static ALWAYS_INLINE TickCount DoMemoryAccess(VirtualMemoryAddress address, u32&
   {
     return DoInvalidAccess(type, size, address, value);
   }
-  else if (address < (MEMCTRL_BASE + MEMCTRL_SIZE))
-  {
-    return DoMemoryControlAccess<type, size>(address & MEMCTRL_MASK, value);
-  }
-  else if (address < (PAD_BASE + PAD_SIZE))
-  {
-    return DoPadAccess<type, size>(address & PAD_MASK, value);
-  }
-  else if (address < (SIO_BASE + SIO_SIZE))
-  {
-    return DoSIOAccess<type, size>(address & SIO_MASK, value);
-  }
-  else if (address < (MEMCTRL2_BASE + MEMCTRL2_SIZE))
-  {
-    return DoMemoryControl2Access<type, size>(address & MEMCTRL2_MASK, value);
-  }
-  else if (address < (INTERRUPT_CONTROLLER_BASE + INTERRUPT_CONTROLLER_SIZE))
-  {
-    return DoAccessInterruptController<type, size>(address & INTERRUPT_CONTROLLER_MASK, value);
-  }
-  else if (address < (DMA_BASE + DMA_SIZE))
-  {
-    return DoDMAAccess<type, size>(address & DMA_MASK, value);
-  }
-  else if (address < (TIMERS_BASE + TIMERS_SIZE))
-  {
-    return DoAccessTimers<type, size>(address & TIMERS_MASK, value);
-  }
-  else if (address < CDROM_BASE)
-  {
-    return DoInvalidAccess(type, size, address, value);
-  }
-  else if (address < (CDROM_BASE + GPU_SIZE))
-  {
-    return DoCDROMAccess<type, size>(address & CDROM_MASK, value);
-  }
-  else if (address < (GPU_BASE + GPU_SIZE))
-  {
-    return DoGPUAccess<type, size>(address & GPU_MASK, value);
-  }
-  else if (address < (MDEC_BASE + MDEC_SIZE))
-  {
-    return DoMDECAccess<type, size>(address & MDEC_MASK, value);
-  }
-  else if (address < SPU_BASE)
-  {
-    return DoInvalidAccess(type, size, address, value);
-  }
-  else if (address < (SPU_BASE + SPU_SIZE))
-  {
-    return DoAccessSPU<type, size>(address & SPU_MASK, value);
-  }
   else if (address < EXP2_BASE)
   {
-    return DoInvalidAccess(type, size, address, value);
+    return DoIOPageAccess<type, size>(address, value);
   }
   else if (address < (EXP2_BASE + EXP2_SIZE))
   {
@@ -2249,6 +2661,122 @@ void UncheckedWriteMemoryWord(u32 address, u32 value)
   g_state.pending_ticks += DoMemoryAccess<MemoryAccessType::Write, MemoryAccessSize::Word>(address, value);
 }
 
+template<MemoryAccessSize size, TickCount (*Handler)(u32, u32&), u32 mask>
+static u32 DirectReadIORegister(u32 address)
+{
+  Bus::CountIOAccess(MemoryAccessType::Read, address);
+
+  u32 temp;
+  g_state.pending_ticks += Handler(address & mask, temp);
+  return temp;
+}
+
+template<MemoryAccessSize size, TickCount (*Handler)(u32, u32&), u32 mask>
+static void DirectWriteIORegister(u32 address, u32 value)
+{
+  // KUSEG/KSEG0 writes go to the icache when the cache is isolated.
+  if ((address >> 29) != 0x05 && g_state.cop0_regs.sr.Isc)
+  {
+    WriteICache(address, value);
+    return;
+  }
+
+  Bus::CountIOAccess(MemoryAccessType::Write, address);
+  Handler(address & mask, value);
+}
+
+template<MemoryAccessType type, MemoryAccessSize size>
+static auto GetDirectIORegisterHandler(PhysicalMemoryAddress paddr)
+{
+  using namespace Bus;
+
+#define IO_HANDLER(handler, mask)                                                                                      \
+  if constexpr (type == MemoryAccessType::Read)                                                                        \
+    return &DirectReadIORegister<size, &handler<type, size>, mask>;                                                    \
+  else                                                                                                                 \
+    return &DirectWriteIORegister<size, &handler<type, size>, mask>;
+
+  if (paddr >= MEMCTRL_BASE && paddr < (MEMCTRL_BASE + MEMCTRL_SIZE))
+  {
+    IO_HANDLER(DoMemoryControlAccess, MEMCTRL_MASK);
+  }
+  else if (paddr >= PAD_BASE && paddr < (PAD_BASE + PAD_SIZE))
+  {
+    IO_HANDLER(DoPadAccess, PAD_MASK);
+  }
+  else if (paddr >= SIO_BASE && paddr < (SIO_BASE + SIO_SIZE))
+  {
+    IO_HANDLER(DoSIOAccess, SIO_MASK);
+  }
+  else if (paddr >= INTERRUPT_CONTROLLER_BASE && paddr < (INTERRUPT_CONTROLLER_BASE + INTERRUPT_CONTROLLER_SIZE))
+  {
+    IO_HANDLER(DoAccessInterruptController, INTERRUPT_CONTROLLER_MASK);
+  }
+  else if (paddr >= DMA_BASE && paddr < (DMA_BASE + DMA_SIZE))
+  {
+    IO_HANDLER(DoDMAAccess, DMA_MASK);
+  }
+  else if (paddr >= TIMERS_BASE && paddr < (TIMERS_BASE + TIMERS_SIZE))
+  {
+    IO_HANDLER(DoAccessTimers, TIMERS_MASK);
+  }
+  else if (paddr >= CDROM_BASE && paddr < (CDROM_BASE + CDROM_SIZE))
+  {
+    IO_HANDLER(DoCDROMAccess, CDROM_MASK);
+  }
+  else if (paddr >= GPU_BASE && paddr < (GPU_BASE + GPU_SIZE))
+  {
+    IO_HANDLER(DoGPUAccess, GPU_MASK);
+  }
+  else if (paddr >= MDEC_BASE && paddr < (MDEC_BASE + MDEC_SIZE))
+  {
+    IO_HANDLER(DoMDECAccess, MDEC_MASK);
+  }
+  else if (paddr >= SPU_BASE && paddr < (SPU_BASE + SPU_SIZE))
+  {
+    IO_HANDLER(DoAccessSPU, SPU_MASK);
+  }
+
+#undef IO_HANDLER
+
+  using HandlerType = std::conditional_t<type == MemoryAccessType::Read, DirectReadHandler, DirectWriteHandler>;
+  return static_cast<HandlerType>(nullptr);
+}
+
+template<MemoryAccessType type>
+static auto GetDirectIORegisterHandler(u32 address, MemoryAccessSize size)
+{
+  using HandlerType = std::conditional_t<type == MemoryAccessType::Read, DirectReadHandler, DirectWriteHandler>;
+
+  // Only the segments which map physical memory, and aligned accesses, so no exception can be raised.
+  const u32 seg = (address >> 29);
+  if ((seg != 0x00 && seg != 0x04 && seg != 0x05) || !Common::IsAlignedPow2(address, 1u << static_cast<u32>(size)))
+    return static_cast<HandlerType>(nullptr);
+
+  const PhysicalMemoryAddress paddr = address & PHYSICAL_MEMORY_ADDRESS_MASK;
+  switch (size)
+  {
+    case MemoryAccessSize::Byte:
+      return GetDirectIORegisterHandler<type, MemoryAccessSize::Byte>(paddr);
+    case MemoryAccessSize::HalfWord:
+      return GetDirectIORegisterHandler<type, MemoryAccessSize::HalfWord>(paddr);
+    case MemoryAccessSize::Word:
+      return GetDirectIORegisterHandler<type, MemoryAccessSize::Word>(paddr);
+    default:
+      return static_cast<HandlerType>(nullptr);
+  }
+}
+
+DirectReadHandler GetDirectReadHandler(u32 address, MemoryAccessSize size)
+{
+  return GetDirectIORegisterHandler<MemoryAccessType::Read>(address, size);
+}
+
+DirectWriteHandler GetDirectWriteHandler(u32 address, MemoryAccessSize size)
+{
+  return GetDirectIORegisterHandler<MemoryAccessType::Write>(address, size);
+}
+
 } // namespace Recompiler::Thunks
 
 } // namespace CPU
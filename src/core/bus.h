@@ -7,6 +7,7 @@
 #include "types.h"
 #include <array>
 #include <bitset>
+#include <cstdio>
 #include <optional>
 #include <string>
 #include <vector>
@@ -89,9 +90,15 @@ enum : size_t
   MEMORY_ARENA_RAM_OFFSET = 0,
 
 #ifdef WITH_MMAP_FASTMEM
+#ifdef CPU_AARCH32
+  // We can't reserve 4GB of address space on a 32-bit host, so the fastmem region only covers the 512MB physical
+  // address space. The recompiler masks off the segment bits before accessing it.
+  FASTMEM_REGION_SIZE = 0x20000000,
+#else
   // Fastmem region size is 4GB to cover the entire 32-bit address space.
   FASTMEM_REGION_SIZE = UINT64_C(0x100000000),
 #endif
+#endif
 };
 
 enum : u32
@@ -103,18 +110,52 @@ enum : u32
   FASTMEM_LUT_NUM_SLOTS = FASTMEM_LUT_NUM_PAGES * 2,
 };
 
+/// Describes the RAM held in a memory save state's stream, so the next save into the same stream only has to rewrite
+/// the pages which have been written since.
+struct RAMSnapshot
+{
+  u64 serial = 0; // zero if the stream doesn't hold a usable copy of RAM
+  u32 stream_offset = 0;
+  u32 size = 0;
+};
+
 bool Initialize();
 void Shutdown();
 void Reset();
 bool DoState(StateWrapper& sw);
 
+/// Enables flagging of RAM pages written by recompiled fastmem stores, which is needed for incremental memory save
+/// states. Recompiled code has to be flushed when this changes.
+bool IsRAMDirtyTrackingEnabled();
+void SetRAMDirtyTracking(bool enabled);
+
+/// While set, saving state only rewrites the RAM pages which have changed since the snapshot was taken, as long as the
+/// stream still holds its RAM at the same offset. The snapshot is updated to describe the new save.
+void SetMemoryStateRAMSnapshot(RAMSnapshot* snapshot);
+
+/// Flags RAM written behind the bus's back, e.g. by DMA or the debugger. Addresses outside RAM are ignored.
+void MarkRAMDirty(PhysicalMemoryAddress address, u32 size);
+
 CPUFastmemMode GetFastmemMode();
 u8* GetFastmemBase();
 void UpdateFastmemViews(CPUFastmemMode mode);
 bool CanUseFastmemForAddress(VirtualMemoryAddress address);
 
+/// Returns the cycles to charge for a fastmem load from the specified address. The LUT maps the scratchpad and BIOS
+/// as well as RAM, which don't take the same time to read.
+TickCount GetFastmemReadTicks(VirtualMemoryAddress address, MemoryAccessSize size);
+
 void SetExpansionROM(std::vector<u8> data);
 
+/// Counts the reads and writes of each I/O register while enabled in the debug settings, so it can be seen which
+/// devices a game spends its time polling. Counts are cleared on reset.
+void UpdateIOAccessCounting();
+void ResetIOAccessCounts();
+void DrawIOAccessCountsWindow();
+
+/// Writes the nonzero counts as JSON, per device and per register.
+void WriteIOAccessCounts(std::FILE* fp);
+
 extern std::bitset<RAM_8MB_CODE_PAGE_COUNT> m_ram_code_bits;
 extern u8* g_ram;            // 2MB-8MB RAM
 extern u32 g_ram_size;       // Active size of RAM.
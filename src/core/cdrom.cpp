@@ -36,9 +36,6 @@ enum : u32
   DATA_SECTOR_OUTPUT_SIZE = CDImage::DATA_SECTOR_SIZE,
   SECTOR_SYNC_SIZE = CDImage::SECTOR_SYNC_SIZE,
   SECTOR_HEADER_SIZE = CDImage::SECTOR_HEADER_SIZE,
-  XA_RESAMPLE_RING_BUFFER_SIZE = 32,
-  XA_RESAMPLE_ZIGZAG_TABLE_SIZE = 29,
-  XA_RESAMPLE_NUM_ZIGZAG_TABLES = 7,
 
   PARAM_FIFO_SIZE = 16,
   RESPONSE_FIFO_SIZE = 16,
@@ -341,7 +338,7 @@ static std::array<std::array<u8, 2>, 2> s_cd_audio_volume_matrix{};
 static std::array<std::array<u8, 2>, 2> s_next_cd_audio_volume_matrix{};
 
 static std::array<s32, 4> s_xa_last_samples{};
-static std::array<std::array<s16, XA_RESAMPLE_RING_BUFFER_SIZE>, 2> s_xa_resample_ring_buffer{};
+static std::array<std::array<s16, CDXA::XA_RESAMPLE_RING_BUFFER_SIZE>, 2> s_xa_resample_ring_buffer{};
 static u8 s_xa_resample_p = 0;
 static u8 s_xa_resample_sixstep = 6;
 
@@ -720,6 +717,8 @@ void CDROM::InsertMedia(std::unique_ptr<CDImage> media)
   if (CanReadMedia())
     RemoveMedia(true);
 
+  media->SetDecompressionCache(g_settings.cdrom_decompression_cache_blocks, g_settings.cdrom_decompression_prefetch);
+
   // check if it's a valid PS1 disc
   std::string exe_name;
   std::vector<u8> exe_buffer;
@@ -793,7 +792,9 @@ bool CDROM::PrecacheMedia()
   if (!m_reader.HasMedia())
     return false;
 
-  if (m_reader.GetMedia()->HasSubImages() && m_reader.GetMedia()->GetSubImageCount() > 1)
+  // multi-disc images are only precached compressed, the memory cost would be too high otherwise
+  if (!g_settings.cdrom_load_image_to_ram_compressed && m_reader.GetMedia()->HasSubImages() &&
+      m_reader.GetMedia()->GetSubImageCount() > 1)
   {
     Host::AddFormattedOSDMessage(
       15.0f, Host::TranslateString("OSDMessage", "CD image preloading not available for multi-disc image '%s'"),
@@ -802,7 +803,7 @@ bool CDROM::PrecacheMedia()
   }
 
   HostInterfaceProgressCallback callback;
-  if (!m_reader.Precache(&callback))
+  if (!m_reader.Precache(&callback, g_settings.cdrom_load_image_to_ram_compressed))
   {
     Host::AddOSDMessage(Host::TranslateStdString("OSDMessage", "Precaching CD image failed, it may be unreliable."),
                         15.0f);
@@ -2880,43 +2881,22 @@ void CDROM::ProcessDataSector(const u8* raw_sector, const CDImage::SubChannelQ&
   SetAsyncInterrupt(Interrupt::DataReady);
 }
 
-static std::array<std::array<s16, 29>, 7> s_zigzag_table = {
-  {{0,      0x0,     0x0,     0x0,    0x0,     -0x0002, 0x000A,  -0x0022, 0x0041, -0x0054,
-    0x0034, 0x0009,  -0x010A, 0x0400, -0x0A78, 0x234C,  0x6794,  -0x1780, 0x0BCD, -0x0623,
-    0x0350, -0x016D, 0x006B,  0x000A, -0x0010, 0x0011,  -0x0008, 0x0003,  -0x0001},
-   {0,       0x0,    0x0,     -0x0002, 0x0,    0x0003,  -0x0013, 0x003C,  -0x004B, 0x00A2,
-    -0x00E3, 0x0132, -0x0043, -0x0267, 0x0C9D, 0x74BB,  -0x11B4, 0x09B8,  -0x05BF, 0x0372,
-    -0x01A8, 0x00A6, -0x001B, 0x0005,  0x0006, -0x0008, 0x0003,  -0x0001, 0x0},
-   {0,      0x0,     -0x0001, 0x0003,  -0x0002, -0x0005, 0x001F,  -0x004A, 0x00B3, -0x0192,
-    0x02B1, -0x039E, 0x04F8,  -0x05A6, 0x7939,  -0x05A6, 0x04F8,  -0x039E, 0x02B1, -0x0192,
-    0x00B3, -0x004A, 0x001F,  -0x0005, -0x0002, 0x0003,  -0x0001, 0x0,     0x0},
-   {0,       -0x0001, 0x0003,  -0x0008, 0x0006, 0x0005,  -0x001B, 0x00A6, -0x01A8, 0x0372,
-    -0x05BF, 0x09B8,  -0x11B4, 0x74BB,  0x0C9D, -0x0267, -0x0043, 0x0132, -0x00E3, 0x00A2,
-    -0x004B, 0x003C,  -0x0013, 0x0003,  0x0,    -0x0002, 0x0,     0x0,    0x0},
-   {-0x0001, 0x0003,  -0x0008, 0x0011,  -0x0010, 0x000A, 0x006B,  -0x016D, 0x0350, -0x0623,
-    0x0BCD,  -0x1780, 0x6794,  0x234C,  -0x0A78, 0x0400, -0x010A, 0x0009,  0x0034, -0x0054,
-    0x0041,  -0x0022, 0x000A,  -0x0001, 0x0,     0x0001, 0x0,     0x0,     0x0},
-   {0x0002,  -0x0008, 0x0010,  -0x0023, 0x002B, 0x001A,  -0x00EB, 0x027B,  -0x0548, 0x0AFA,
-    -0x16FA, 0x53E0,  0x3C07,  -0x1249, 0x080E, -0x0347, 0x015B,  -0x0044, -0x0017, 0x0046,
-    -0x0023, 0x0011,  -0x0005, 0x0,     0x0,    0x0,     0x0,     0x0,     0x0},
-   {-0x0005, 0x0011,  -0x0023, 0x0046, -0x0017, -0x0044, 0x015B,  -0x0347, 0x080E, -0x1249,
-    0x3C07,  0x53E0,  -0x16FA, 0x0AFA, -0x0548, 0x027B,  -0x00EB, 0x001A,  0x002B, -0x0023,
-    0x0010,  -0x0008, 0x0002,  0x0,    0x0,     0x0,     0x0,     0x0,     0x0}}};
-
-static s16 ZigZagInterpolate(const s16* ringbuf, const s16* table, u8 p)
-{
-  s32 sum = 0;
-  for (u8 i = 0; i < 29; i++)
-    sum += (s32(ringbuf[(p - i) & 0x1F]) * s32(table[i])) / 0x8000;
-
-  return static_cast<s16>(std::clamp<s32>(sum, -0x8000, 0x7FFF));
-}
-
 std::tuple<s16, s16> CDROM::GetAudioFrame()
 {
-  const u32 frame = s_audio_fifo.IsEmpty() ? 0u : s_audio_fifo.Pop();
+  if (s_audio_fifo.IsEmpty())
+    return std::tuple<s16, s16>(0, 0);
+
+  const u32 frame = s_audio_fifo.Pop();
   const s16 left = static_cast<s16>(Truncate16(frame));
   const s16 right = static_cast<s16>(Truncate16(frame >> 16));
+
+  // Most games never change the volume from the default of left to left and right to right at full volume, which
+  // leaves the samples unchanged.
+  u32 matrix_bits;
+  std::memcpy(&matrix_bits, s_cd_audio_volume_matrix.data(), sizeof(matrix_bits));
+  if (matrix_bits == 0x80000080u)
+    return std::tuple<s16, s16>(left, right);
+
   const s16 left_out = SaturateVolume(ApplyVolume(left, s_cd_audio_volume_matrix[0][0]) +
                                       ApplyVolume(right, s_cd_audio_volume_matrix[1][0]));
   const s16 right_out = SaturateVolume(ApplyVolume(left, s_cd_audio_volume_matrix[0][1]) +
@@ -2976,12 +2956,15 @@ void CDROM::ResampleXAADPCM(const s16* frames_in, u32 num_frames_in)
       if (sixstep == 0)
       {
         sixstep = 6;
-        for (u32 j = 0; j < 7; j++)
-        {
-          const s16 left_interp = ZigZagInterpolate(left_ringbuf, s_zigzag_table[j].data(), p);
-          const s16 right_interp = STEREO ? ZigZagInterpolate(right_ringbuf, s_zigzag_table[j].data(), p) : left_interp;
-          AddCDAudioFrame(left_interp, right_interp);
-        }
+
+        std::array<s16, CDXA::XA_RESAMPLE_OUTPUTS_PER_WINDOW> left_interp;
+        std::array<s16, CDXA::XA_RESAMPLE_OUTPUTS_PER_WINDOW> right_interp;
+        CDXA::ZigZagInterpolate(left_ringbuf, p, left_interp.data());
+        if constexpr (STEREO)
+          CDXA::ZigZagInterpolate(right_ringbuf, p, right_interp.data());
+
+        for (u32 j = 0; j < CDXA::XA_RESAMPLE_OUTPUTS_PER_WINDOW; j++)
+          AddCDAudioFrame(left_interp[j], STEREO ? right_interp[j] : left_interp[j]);
       }
     }
   }
@@ -3179,15 +3162,9 @@ void CDROM::ProcessCDDASector(const u8* raw_sector, const CDImage::SubChannelQ&
     s_audio_fifo.Remove(num_samples - remaining_space);
   }
 
-  const u8* sector_ptr = raw_sector;
-  for (u32 i = 0; i < num_samples; i++)
-  {
-    s16 samp_left, samp_right;
-    std::memcpy(&samp_left, sector_ptr, sizeof(samp_left));
-    std::memcpy(&samp_right, sector_ptr + sizeof(s16), sizeof(samp_right));
-    sector_ptr += sizeof(s16) * 2;
-    AddCDAudioFrame(samp_left, samp_right);
-  }
+  // The sector is interleaved little-endian left/right samples, which is already the layout of the FIFO's frames.
+  // Volume is applied when the frames are popped, so changes to the matrix affect audio which is already buffered.
+  s_audio_fifo.PushRange(reinterpret_cast<const u32*>(raw_sector), num_samples);
 }
 
 void CDROM::LoadDataFIFO()
@@ -3277,6 +3254,20 @@ void CDROM::DrawDebugWindow()
 
       ImGui::Text("Last Sector: %02X:%02X:%02X (Mode %u)", s_last_sector_header.minute, s_last_sector_header.second,
                   s_last_sector_header.frame, s_last_sector_header.sector_mode);
+
+      if (m_reader.IsUsingThread())
+      {
+        const CDROMAsyncReader::Stats& stats = m_reader.GetStats();
+        const u32 total = stats.readahead_hits + stats.readahead_misses;
+        const float hit_rate = (total > 0) ? (static_cast<float>(stats.readahead_hits) * 100.0f / total) : 0.0f;
+        ImGui::Text("Readahead: Depth[%u/%u] Hits[%u] Misses[%u] (%.1f%% hit rate)", m_reader.GetReadaheadDepth(),
+                    m_reader.GetReadaheadCount() * CDROMAsyncReader::MAX_READAHEAD_MULTIPLIER, stats.readahead_hits,
+                    stats.readahead_misses, hit_rate);
+        ImGui::Text("Read Stalls: %u (%.2f ms total)", stats.waits, stats.wait_time_ms);
+        ImGui::SameLine();
+        if (ImGui::SmallButton("Reset"))
+          m_reader.ResetStats();
+      }
     }
     else
     {
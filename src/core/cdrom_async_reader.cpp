@@ -4,7 +4,10 @@
 #include "cdrom_async_reader.h"
 #include "common/assert.h"
 #include "common/log.h"
+#include "common/threading.h"
 #include "common/timer.h"
+#include "common/trace.h"
+#include <algorithm>
 Log_SetChannel(CDROMAsyncReader);
 
 CDROMAsyncReader::CDROMAsyncReader() = default;
@@ -20,12 +23,17 @@ void CDROMAsyncReader::StartThread(u32 readahead_count)
     StopThread();
 
   m_buffers.clear();
-  m_buffers.resize(readahead_count);
+  m_buffers.resize(readahead_count * MAX_READAHEAD_MULTIPLIER);
+  m_readahead_count = readahead_count;
+  m_readahead_depth.store(readahead_count);
+  m_sequential_run = 0;
   EmptyBuffers();
 
   m_shutdown_flag.store(false);
   m_read_thread = std::thread(&CDROMAsyncReader::WorkerThreadEntryPoint, this);
-  Log_InfoPrintf("Read thread started with readahead of %u sectors", readahead_count);
+  Log_InfoPrintf("Read thread started with readahead of %u-%u sectors",
+                 std::min(readahead_count, static_cast<u32>(MIN_READAHEAD_SECTORS)),
+                 static_cast<u32>(m_buffers.size()));
 }
 
 void CDROMAsyncReader::StopThread()
@@ -42,6 +50,8 @@ void CDROMAsyncReader::StopThread()
   m_read_thread.join();
   EmptyBuffers();
   m_buffers.clear();
+  m_readahead_count = 0;
+  m_readahead_depth.store(0);
 }
 
 void CDROMAsyncReader::SetMedia(std::unique_ptr<CDImage> media)
@@ -50,6 +60,7 @@ void CDROMAsyncReader::SetMedia(std::unique_ptr<CDImage> media)
     CancelReadahead();
 
   m_media = std::move(media);
+  m_stats = {};
 }
 
 std::unique_ptr<CDImage> CDROMAsyncReader::RemoveMedia()
@@ -60,7 +71,7 @@ std::unique_ptr<CDImage> CDROMAsyncReader::RemoveMedia()
   return std::move(m_media);
 }
 
-bool CDROMAsyncReader::Precache(ProgressCallback* callback)
+bool CDROMAsyncReader::Precache(ProgressCallback* callback, bool compressed)
 {
   WaitForIdle();
 
@@ -72,11 +83,15 @@ bool CDROMAsyncReader::Precache(ProgressCallback* callback)
 
   EmptyBuffers();
 
-  const CDImage::PrecacheResult res = m_media->Precache(callback);
+  const CDImage::PrecacheResult res = m_media->Precache(callback, compressed);
   if (res == CDImage::PrecacheResult::Unsupported)
   {
+    // a memory copy only holds the current disc, so other sub-images would become unreachable
+    if (m_media->HasSubImages() && m_media->GetSubImageCount() > 1)
+      return false;
+
     // fall back to copy precaching
-    std::unique_ptr<CDImage> memory_image = CDImage::CreateMemoryImage(m_media.get(), callback);
+    std::unique_ptr<CDImage> memory_image = CDImage::CreateMemoryImage(m_media.get(), callback, compressed);
     if (memory_image)
     {
       const CDImage::LBA lba = m_media->GetPositionOnDisc();
@@ -108,6 +123,7 @@ void CDROMAsyncReader::QueueReadSector(CDImage::LBA lba)
   }
 
   const u32 buffer_count = m_buffer_count.load();
+  bool sequential = false;
   if (buffer_count > 0)
   {
     // don't re-read the same sector if it was the last one we read
@@ -125,22 +141,56 @@ void CDROMAsyncReader::QueueReadSector(CDImage::LBA lba)
     {
       // great, don't need a seek, but still kick the thread to start reading ahead again
       Log_DebugPrintf("Readahead buffer hit for sector %u", lba);
+      m_stats.readahead_hits++;
+      UpdateReadaheadDepth(true);
       m_buffer_front.store(next_buffer);
       m_buffer_count.fetch_sub(1);
       m_can_readahead.store(true);
       m_do_read_cv.notify_one();
       return;
     }
+
+    // reading the next sector before the worker got to it is still a sequential run, just a slow one
+    sequential = (m_buffers[buffer_front].lba + 1) == lba;
   }
 
   // we need to toss away our readahead and start fresh
   Log_DebugPrintf("Readahead buffer miss, queueing seek to %u", lba);
+  m_stats.readahead_misses++;
+  UpdateReadaheadDepth(sequential);
   std::unique_lock<std::mutex> lock(m_mutex);
   m_next_position_set.store(true);
   m_next_position = lba;
   m_do_read_cv.notify_one();
 }
 
+void CDROMAsyncReader::UpdateReadaheadDepth(bool sequential)
+{
+  const u32 depth = m_readahead_depth.load();
+  if (sequential)
+  {
+    // streaming, e.g. FMVs or XA audio: once a whole window has been consumed, double it
+    if ((++m_sequential_run) >= depth && depth < static_cast<u32>(m_buffers.size()))
+    {
+      m_readahead_depth.store(std::min(depth * 2, static_cast<u32>(m_buffers.size())));
+      m_sequential_run = 0;
+      Log_DevPrintf("Sequential reads, readahead depth increased to %u", m_readahead_depth.load());
+    }
+  }
+  else
+  {
+    // a seek before half the window was used means most of the readahead was wasted
+    const u32 min_depth = std::min(m_readahead_count, static_cast<u32>(MIN_READAHEAD_SECTORS));
+    if (m_sequential_run < (depth / 2) && depth > min_depth)
+    {
+      m_readahead_depth.store(std::max(depth / 2, min_depth));
+      Log_DevPrintf("Random access, readahead depth decreased to %u", m_readahead_depth.load());
+    }
+
+    m_sequential_run = 0;
+  }
+}
+
 bool CDROMAsyncReader::ReadSectorUncached(CDImage::LBA lba, CDImage::SubChannelQ* subq, SectorBuffer* data)
 {
   if (!IsUsingThread())
@@ -191,6 +241,7 @@ bool CDROMAsyncReader::WaitForReadToComplete()
 
   Common::Timer wait_timer;
   Log_DebugPrintf("Sector read pending, waiting");
+  m_stats.waits++;
 
   std::unique_lock<std::mutex> lock(m_mutex);
   m_notify_read_complete_cv.wait(
@@ -203,6 +254,7 @@ bool CDROMAsyncReader::WaitForReadToComplete()
 
   const u32 front = m_buffer_front.load();
   const double wait_time = wait_timer.GetTimeMilliseconds();
+  m_stats.wait_time_ms += static_cast<float>(wait_time);
   if (wait_time > 1.0f)
     Log_WarningPrintf("Had to wait %.2f msec for LBA %u", wait_time, m_buffers[front].lba);
 
@@ -310,6 +362,8 @@ void CDROMAsyncReader::CancelReadahead()
 
 void CDROMAsyncReader::WorkerThreadEntryPoint()
 {
+  Threading::SetNameOfCurrentThread("CDROM Read Thread");
+  Threading::ApplyAffinityPolicy(Threading::AffinityClass::Background);
   std::unique_lock lock(m_mutex);
 
   for (;;)
@@ -319,6 +373,7 @@ void CDROMAsyncReader::WorkerThreadEntryPoint()
     if (m_shutdown_flag.load())
       break;
 
+    TRACE_SCOPE("CDROMReadAhead");
     for (;;)
     {
       if (m_next_position_set.load())
@@ -359,9 +414,9 @@ void CDROMAsyncReader::WorkerThreadEntryPoint()
       if (!m_can_readahead.load())
         break;
 
-      // readahead time! read as many sectors as we have space for
-      Log_DebugPrintf("Reading ahead %u sectors...", static_cast<u32>(m_buffers.size()) - m_buffer_count.load());
-      while (m_buffer_count.load() < static_cast<u32>(m_buffers.size()))
+      // readahead time! read as many sectors as the current depth allows
+      Log_DebugPrintf("Reading ahead up to %u sectors...", m_readahead_depth.load());
+      while (m_buffer_count.load() < m_readahead_depth.load())
       {
         if (m_next_position_set.load())
         {
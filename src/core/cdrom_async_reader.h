@@ -16,6 +16,23 @@ class CDROMAsyncReader
 public:
   using SectorBuffer = std::array<u8, CDImage::RAW_SECTOR_SIZE>;
 
+  enum : u32
+  {
+    /// Readahead depth never drops below this while seeking around randomly.
+    MIN_READAHEAD_SECTORS = 2,
+
+    /// Sequential runs can grow the readahead depth up to this multiple of the configured count.
+    MAX_READAHEAD_MULTIPLIER = 4,
+  };
+
+  struct Stats
+  {
+    u32 readahead_hits;
+    u32 readahead_misses;
+    u32 waits;
+    float wait_time_ms;
+  };
+
   struct BufferSlot
   {
     CDImage::LBA lba;
@@ -32,7 +49,10 @@ public:
   const CDImage::SubChannelQ& GetSectorSubQ() const { return m_buffers[m_buffer_front.load()].subq; }
   u32 GetBufferedSectorCount() const { return m_buffer_count.load(); }
   bool HasBufferedSectors() const { return (m_buffer_count.load() > 0); }
-  u32 GetReadaheadCount() const { return static_cast<u32>(m_buffers.size()); }
+  u32 GetReadaheadCount() const { return m_readahead_count; }
+  u32 GetReadaheadDepth() const { return m_readahead_depth.load(); }
+  const Stats& GetStats() const { return m_stats; }
+  void ResetStats() { m_stats = {}; }
 
   bool HasMedia() const { return static_cast<bool>(m_media); }
   const CDImage* GetMedia() const { return m_media.get(); }
@@ -46,7 +66,8 @@ public:
   std::unique_ptr<CDImage> RemoveMedia();
 
   /// Precaches image, either to memory, or using the underlying image precache.
-  bool Precache(ProgressCallback* callback);
+  /// If compressed is set, sectors are kept compressed in memory and decompressed on demand.
+  bool Precache(ProgressCallback* callback, bool compressed);
 
   void QueueReadSector(CDImage::LBA lba);
 
@@ -62,6 +83,7 @@ private:
   void ReadSectorNonThreaded(CDImage::LBA lba);
   bool InternalReadSectorUncached(CDImage::LBA lba, CDImage::SubChannelQ* subq, SectorBuffer* data);
   void CancelReadahead();
+  void UpdateReadaheadDepth(bool sequential);
 
   void WorkerThreadEntryPoint();
 
@@ -84,4 +106,11 @@ private:
   std::atomic<u32> m_buffer_front{0};
   std::atomic<u32> m_buffer_back{0};
   std::atomic<u32> m_buffer_count{0};
+
+  // The worker only fills the first m_readahead_depth slots ahead, which grows with sequential reads and shrinks
+  // with random access. These are only touched by the CPU thread, apart from the depth.
+  std::atomic<u32> m_readahead_depth{0};
+  u32 m_readahead_count = 0;
+  u32 m_sequential_run = 0;
+  Stats m_stats = {};
 };
@@ -4,21 +4,34 @@
 #include "cheats.h"
 #include "bus.h"
 #include "common/assert.h"
+#include "common/bitutils.h"
 #include "common/byte_stream.h"
 #include "common/file_system.h"
 #include "common/log.h"
 #include "common/string.h"
 #include "common/string_util.h"
+#include "common/threading.h"
 #include "controller.h"
 #include "cpu_code_cache.h"
 #include "cpu_core.h"
 #include "host.h"
 #include "system.h"
 #include <cctype>
+#include <cstring>
 #include <iomanip>
 #include <sstream>
 #include <type_traits>
 Log_SetChannel(Cheats);
+
+#if defined(CPU_X64)
+#include <emmintrin.h>
+#elif defined(CPU_AARCH64)
+#ifdef _MSC_VER
+#include <arm64_neon.h>
+#else
+#include <arm_neon.h>
+#endif
+#endif
 static std::array<u32, 256> cht_register; // Used for D7 ,51 & 52 cheat types
 
 using KeyValuePairVector = std::vector<std::pair<std::string, std::string>>;
@@ -202,6 +215,7 @@ bool CheatList::LoadFromPCSXRFile(const char* filename)
 
 bool CheatList::LoadFromPCSXRString(const std::string& str)
 {
+  m_compiled_ops_dirty = true;
   std::istringstream iss(str);
 
   std::string line;
@@ -326,6 +340,7 @@ bool CheatList::LoadFromLibretroFile(const char* filename)
 
 bool CheatList::LoadFromLibretroString(const std::string& str)
 {
+  m_compiled_ops_dirty = true;
   std::istringstream iss(str);
   std::string line;
   KeyValuePairVector kvp;
@@ -420,6 +435,7 @@ bool CheatList::LoadFromLibretroString(const std::string& str)
 
 bool CheatList::LoadFromEPSXeString(const std::string& str)
 {
+  m_compiled_ops_dirty = true;
   std::istringstream iss(str);
 
   std::string line;
@@ -556,16 +572,309 @@ void CheatList::Apply()
   if (!m_master_enable)
     return;
 
-  for (const CheatCode& code : m_codes)
+  if (m_compiled_ops_dirty)
+    CompileCodes();
+
+  const u32 count = static_cast<u32>(m_compiled_ops.size());
+  for (u32 index = 0; index < count;)
+  {
+    const CompiledOp& op = m_compiled_ops[index];
+    switch (op.type)
+    {
+      case CompiledOp::Type::Write:
+        WriteOpValue(op, op.value);
+        break;
+
+      case CompiledOp::Type::Add:
+        WriteOpValue(op, ReadOpValue(op) + op.value);
+        break;
+
+      case CompiledOp::Type::Or:
+        WriteOpValue(op, ReadOpValue(op) | op.value);
+        break;
+
+      case CompiledOp::Type::And:
+        WriteOpValue(op, ReadOpValue(op) & op.value);
+        break;
+
+      case CompiledOp::Type::CompareEqual:
+      case CompiledOp::Type::CompareNotEqual:
+      case CompiledOp::Type::CompareLess:
+      case CompiledOp::Type::CompareGreater:
+      {
+        const u32 value = ReadOpValue(op);
+        bool result;
+        if (op.type == CompiledOp::Type::CompareEqual)
+          result = (value == op.value);
+        else if (op.type == CompiledOp::Type::CompareNotEqual)
+          result = (value != op.value);
+        else if (op.type == CompiledOp::Type::CompareLess)
+          result = (value < op.value);
+        else
+          result = (value > op.value);
+
+        if (!result)
+        {
+          index = op.skip_target;
+          continue;
+        }
+      }
+      break;
+
+      case CompiledOp::Type::Interpret:
+        m_codes[op.code_index].Apply();
+        break;
+
+      case CompiledOp::Type::Nop:
+      default:
+        break;
+    }
+
+    index++;
+  }
+}
+
+void CheatList::CompileCodes()
+{
+  m_compiled_ops.clear();
+  m_compiled_ops_dirty = false;
+
+  u32 num_compiled = 0;
+  u32 num_interpreted = 0;
+  for (u32 i = 0; i < static_cast<u32>(m_codes.size()); i++)
+  {
+    const CheatCode& cc = m_codes[i];
+    if (!cc.enabled)
+      continue;
+
+    if (CompileCode(cc, i))
+      num_compiled++;
+    else
+      num_interpreted++;
+  }
+
+  Log_DevPrintf("Compiled %u cheat codes to %zu ops, %u interpreted", num_compiled, m_compiled_ops.size(),
+                num_interpreted);
+}
+
+bool CheatList::CompileCode(const CheatCode& cc, u32 code_index)
+{
+  const u32 base = static_cast<u32>(m_compiled_ops.size());
+  const u32 count = static_cast<u32>(cc.instructions.size());
+
+  // One op per instruction, so skip targets map straight across.
+  for (u32 i = 0; i < count; i++)
+  {
+    const CheatCode::Instruction& inst = cc.instructions[i];
+    CompiledOp op = {};
+    op.address = inst.address;
+    op.skip_target = base + count;
+    op.code_index = code_index;
+
+    switch (inst.code)
+    {
+      case CheatCode::InstructionCode::Nop:
+        op.type = CompiledOp::Type::Nop;
+        break;
+
+      case CheatCode::InstructionCode::ConstantWrite8:
+      case CheatCode::InstructionCode::Increment8:
+      case CheatCode::InstructionCode::Decrement8:
+      case CheatCode::InstructionCode::ExtConstantBitSet8:
+      case CheatCode::InstructionCode::ExtConstantBitClear8:
+      case CheatCode::InstructionCode::CompareEqual8:
+      case CheatCode::InstructionCode::CompareNotEqual8:
+      case CheatCode::InstructionCode::CompareLess8:
+      case CheatCode::InstructionCode::CompareGreater8:
+        op.size = 1;
+        op.value = inst.value8;
+        break;
+
+      case CheatCode::InstructionCode::ConstantWrite16:
+      case CheatCode::InstructionCode::ScratchpadWrite16:
+      case CheatCode::InstructionCode::Increment16:
+      case CheatCode::InstructionCode::Decrement16:
+      case CheatCode::InstructionCode::ExtConstantBitSet16:
+      case CheatCode::InstructionCode::ExtConstantBitClear16:
+      case CheatCode::InstructionCode::CompareEqual16:
+      case CheatCode::InstructionCode::CompareNotEqual16:
+      case CheatCode::InstructionCode::CompareLess16:
+      case CheatCode::InstructionCode::CompareGreater16:
+        op.size = 2;
+        op.value = inst.value16;
+        break;
+
+      case CheatCode::InstructionCode::ExtConstantWrite32:
+      case CheatCode::InstructionCode::ExtScratchpadWrite32:
+      case CheatCode::InstructionCode::ExtIncrement32:
+      case CheatCode::InstructionCode::ExtDecrement32:
+      case CheatCode::InstructionCode::ExtConstantBitSet32:
+      case CheatCode::InstructionCode::ExtConstantBitClear32:
+      case CheatCode::InstructionCode::ExtCompareEqual32:
+      case CheatCode::InstructionCode::ExtCompareNotEqual32:
+      case CheatCode::InstructionCode::ExtCompareLess32:
+      case CheatCode::InstructionCode::ExtCompareGreater32:
+        op.size = 4;
+        op.value = inst.value32;
+        break;
+
+      default:
+      {
+        // Anything with state, multiple lines or button checks goes through the interpreter.
+        m_compiled_ops.resize(base);
+        op.type = CompiledOp::Type::Interpret;
+        m_compiled_ops.push_back(op);
+        return false;
+      }
+    }
+
+    const u32 size_mask = (op.size == 4) ? 0xFFFFFFFFu : ((1u << (op.size * 8)) - 1u);
+    switch (inst.code)
+    {
+      case CheatCode::InstructionCode::Nop:
+        break;
+
+      case CheatCode::InstructionCode::ScratchpadWrite16:
+      case CheatCode::InstructionCode::ExtScratchpadWrite32:
+        op.type = CompiledOp::Type::Write;
+        op.address = CPU::DCACHE_LOCATION | (inst.address & CPU::DCACHE_OFFSET_MASK);
+        break;
+
+      case CheatCode::InstructionCode::ConstantWrite8:
+      case CheatCode::InstructionCode::ConstantWrite16:
+      case CheatCode::InstructionCode::ExtConstantWrite32:
+        op.type = CompiledOp::Type::Write;
+        break;
+
+      case CheatCode::InstructionCode::Increment8:
+      case CheatCode::InstructionCode::Increment16:
+      case CheatCode::InstructionCode::ExtIncrement32:
+        op.type = CompiledOp::Type::Add;
+        break;
+
+      case CheatCode::InstructionCode::Decrement8:
+      case CheatCode::InstructionCode::Decrement16:
+      case CheatCode::InstructionCode::ExtDecrement32:
+        op.type = CompiledOp::Type::Add;
+        op.value = (0u - op.value) & size_mask;
+        break;
+
+      case CheatCode::InstructionCode::ExtConstantBitSet8:
+      case CheatCode::InstructionCode::ExtConstantBitSet16:
+      case CheatCode::InstructionCode::ExtConstantBitSet32:
+        op.type = CompiledOp::Type::Or;
+        break;
+
+      case CheatCode::InstructionCode::ExtConstantBitClear8:
+      case CheatCode::InstructionCode::ExtConstantBitClear16:
+      case CheatCode::InstructionCode::ExtConstantBitClear32:
+        op.type = CompiledOp::Type::And;
+        op.value = ~op.value & size_mask;
+        break;
+
+      case CheatCode::InstructionCode::CompareEqual8:
+      case CheatCode::InstructionCode::CompareEqual16:
+      case CheatCode::InstructionCode::ExtCompareEqual32:
+        op.type = CompiledOp::Type::CompareEqual;
+        break;
+
+      case CheatCode::InstructionCode::CompareNotEqual8:
+      case CheatCode::InstructionCode::CompareNotEqual16:
+      case CheatCode::InstructionCode::ExtCompareNotEqual32:
+        op.type = CompiledOp::Type::CompareNotEqual;
+        break;
+
+      case CheatCode::InstructionCode::CompareLess8:
+      case CheatCode::InstructionCode::CompareLess16:
+      case CheatCode::InstructionCode::ExtCompareLess32:
+        op.type = CompiledOp::Type::CompareLess;
+        break;
+
+      case CheatCode::InstructionCode::CompareGreater8:
+      case CheatCode::InstructionCode::CompareGreater16:
+      case CheatCode::InstructionCode::ExtCompareGreater32:
+      default:
+        op.type = CompiledOp::Type::CompareGreater;
+        break;
+    }
+
+    if (op.type >= CompiledOp::Type::CompareEqual)
+      op.skip_target = base + cc.GetNextNonConditionalInstruction(i);
+
+    // Aligned RAM and scratchpad accesses are done directly, everything else goes through the safe accessors.
+    op.region = CompiledOp::Region::Bus;
+    if (op.type != CompiledOp::Type::Nop && (op.address & (op.size - 1u)) == 0)
+    {
+      const u32 segment = op.address >> 29;
+      const u32 phys_address = op.address & CPU::PHYSICAL_MEMORY_ADDRESS_MASK;
+      if ((segment == 0x00 || segment == 0x04) && (phys_address & CPU::DCACHE_LOCATION_MASK) == CPU::DCACHE_LOCATION)
+        op.region = CompiledOp::Region::Scratchpad;
+      else if ((segment == 0x00 || segment == 0x04 || segment == 0x05) && phys_address < Bus::RAM_MIRROR_END)
+        op.region = CompiledOp::Region::RAM;
+    }
+
+    m_compiled_ops.push_back(op);
+  }
+
+  return true;
+}
+
+u32 CheatList::ReadOpValue(const CompiledOp& op)
+{
+  const u8* ptr;
+  switch (op.region)
   {
-    if (code.enabled)
-      code.Apply();
+    case CompiledOp::Region::RAM:
+      ptr = &Bus::g_ram[op.address & Bus::g_ram_mask];
+      break;
+
+    case CompiledOp::Region::Scratchpad:
+      ptr = &CPU::g_state.dcache[op.address & CPU::DCACHE_OFFSET_MASK];
+      break;
+
+    case CompiledOp::Region::Bus:
+    default:
+    {
+      if (op.size == 1)
+        return ZeroExtend32(DoMemoryRead<u8>(op.address));
+      else if (op.size == 2)
+        return ZeroExtend32(DoMemoryRead<u16>(op.address));
+      else
+        return DoMemoryRead<u32>(op.address);
+    }
   }
+
+  u32 value = 0;
+  std::memcpy(&value, ptr, op.size);
+  return value;
+}
+
+void CheatList::WriteOpValue(const CompiledOp& op, u32 value)
+{
+  if (op.region == CompiledOp::Region::Scratchpad)
+  {
+    std::memcpy(&CPU::g_state.dcache[op.address & CPU::DCACHE_OFFSET_MASK], &value, op.size);
+    return;
+  }
+
+  // Most cheats write the same value every frame, so check for that without going through the bus. Changed RAM
+  // still goes through it, since it has to invalidate any code compiled from that page.
+  const u32 size_mask = (op.size == 4) ? 0xFFFFFFFFu : ((1u << (op.size * 8)) - 1u);
+  if (op.region == CompiledOp::Region::RAM && ReadOpValue(op) == (value & size_mask))
+    return;
+
+  if (op.size == 1)
+    DoMemoryWrite<u8>(op.address, Truncate8(value));
+  else if (op.size == 2)
+    DoMemoryWrite<u16>(op.address, Truncate16(value));
+  else
+    DoMemoryWrite<u32>(op.address, value);
 }
 
 void CheatList::AddCode(CheatCode cc)
 {
   m_codes.push_back(std::move(cc));
+  m_compiled_ops_dirty = true;
 }
 
 void CheatList::SetCode(u32 index, CheatCode cc)
@@ -573,6 +882,7 @@ void CheatList::SetCode(u32 index, CheatCode cc)
   if (index > m_codes.size())
     return;
 
+  m_compiled_ops_dirty = true;
   if (index == m_codes.size())
   {
     m_codes.push_back(std::move(cc));
@@ -585,6 +895,7 @@ void CheatList::SetCode(u32 index, CheatCode cc)
 void CheatList::RemoveCode(u32 i)
 {
   m_codes.erase(m_codes.begin() + i);
+  m_compiled_ops_dirty = true;
 }
 
 std::optional<CheatList::Format> CheatList::DetectFileFormat(const char* filename)
@@ -689,6 +1000,8 @@ bool CheatList::SaveToPCSXRFile(const char* filename)
 
 bool CheatList::LoadFromPackage(const std::string& serial)
 {
+  m_compiled_ops_dirty = true;
+
   const std::optional<std::string> db_string(Host::ReadResourceFileToString("chtdb.txt"));
   if (!db_string.has_value())
     return false;
@@ -831,6 +1144,7 @@ void CheatList::SetCodeEnabled(u32 index, bool state)
     return;
 
   m_codes[index].enabled = state;
+  m_compiled_ops_dirty = true;
   if (!state)
     m_codes[index].ApplyOnDisable();
 }
@@ -2815,6 +3129,225 @@ std::optional<CheatCode::Activation> CheatCode::ParseActivationName(const char*
   return std::nullopt;
 }
 
+// Main RAM is scanned directly rather than through the bus, split into chunks which are searched in parallel.
+static constexpr u32 MEMORY_SCAN_CHUNK_SIZE = 256 * 1024;
+static constexpr u32 MEMORY_SCAN_RESULT_CHUNK_SIZE = 64 * 1024;
+
+static bool IsDirectScanAddress(PhysicalMemoryAddress address, u32 size)
+{
+  return (address < Bus::g_ram_size && (Bus::g_ram_size - address) >= size);
+}
+
+template<typename T>
+ALWAYS_INLINE static u32 ReadRAMScanValue(PhysicalMemoryAddress address, bool is_signed)
+{
+  T value;
+  std::memcpy(&value, &Bus::g_ram[address], sizeof(value));
+  if constexpr (sizeof(T) == sizeof(u32))
+    return value;
+  else
+    return is_signed ? SignExtend32(value) : ZeroExtend32(value);
+}
+
+static void RunMemoryScanJobs(u32 num_jobs, const std::function<void(u32)>& job)
+{
+  if (num_jobs <= 1)
+  {
+    if (num_jobs == 1)
+      job(0);
+
+    return;
+  }
+
+  // The waiting thread picks up queued chunks too, so nothing sits idle while the workers are busy.
+  Threading::TaskGroup group;
+  for (u32 i = 0; i < num_jobs; i++)
+    group.Submit([&job, i]() { job(i); });
+  group.Wait();
+}
+
+static void MergeMemoryScanResults(std::vector<MemoryScan::ResultVector>& chunk_results, MemoryScan::ResultVector* out)
+{
+  size_t count = 0;
+  for (const MemoryScan::ResultVector& results : chunk_results)
+    count += results.size();
+
+  out->clear();
+  out->reserve(count);
+  for (MemoryScan::ResultVector& results : chunk_results)
+  {
+    out->insert(out->end(), results.begin(), results.end());
+    MemoryScan::ResultVector().swap(results);
+  }
+}
+
+namespace {
+/// Comparisons against a constant as a range of the sign or zero-extended value, matching where the value is inside
+/// the range, or outside it if inverted.
+struct MemoryScanRange
+{
+  s64 min;
+  s64 max;
+  bool invert;
+};
+} // namespace
+
+#if defined(CPU_X64)
+
+/// Returns a 16-bit mask of the values in the next 16 elements which are outside the range. Values are biased so
+/// unsigned comparisons can use the signed compare instructions.
+template<typename T>
+ALWAYS_INLINE static u32 GetOutOfScanRangeMask(const u8* ptr, __m128i bias, __m128i min, __m128i max)
+{
+  const auto compare = [bias, min, max](const u8* p) {
+    const __m128i v = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p)), bias);
+    if constexpr (sizeof(T) == sizeof(u8))
+      return _mm_or_si128(_mm_cmpgt_epi8(min, v), _mm_cmpgt_epi8(v, max));
+    else if constexpr (sizeof(T) == sizeof(u16))
+      return _mm_or_si128(_mm_cmpgt_epi16(min, v), _mm_cmpgt_epi16(v, max));
+    else
+      return _mm_or_si128(_mm_cmpgt_epi32(min, v), _mm_cmpgt_epi32(v, max));
+  };
+
+  // Lane masks are all ones or zero, so saturating packs narrow them to one byte per element.
+  if constexpr (sizeof(T) == sizeof(u8))
+  {
+    return static_cast<u32>(_mm_movemask_epi8(compare(ptr)));
+  }
+  else if constexpr (sizeof(T) == sizeof(u16))
+  {
+    return static_cast<u32>(_mm_movemask_epi8(_mm_packs_epi16(compare(ptr), compare(ptr + 16))));
+  }
+  else
+  {
+    const __m128i lo = _mm_packs_epi32(compare(ptr), compare(ptr + 16));
+    const __m128i hi = _mm_packs_epi32(compare(ptr + 32), compare(ptr + 48));
+    return static_cast<u32>(_mm_movemask_epi8(_mm_packs_epi16(lo, hi)));
+  }
+}
+
+#elif defined(CPU_AARCH64)
+
+ALWAYS_INLINE static u32 MoveMaskU8(uint8x16_t mask)
+{
+  static constexpr u8 bits[16] = {1, 2, 4, 8, 16, 32, 64, 128, 1, 2, 4, 8, 16, 32, 64, 128};
+  const uint8x16_t masked = vandq_u8(mask, vld1q_u8(bits));
+  return static_cast<u32>(vaddv_u8(vget_low_u8(masked))) | (static_cast<u32>(vaddv_u8(vget_high_u8(masked))) << 8);
+}
+
+/// Returns a 16-bit mask of the values in the next 16 elements which are outside the range. Values are biased so
+/// unsigned comparisons can use the signed compare instructions.
+template<typename T>
+ALWAYS_INLINE static u32 GetOutOfScanRangeMask(const u8* ptr, s32 bias, s32 min, s32 max)
+{
+  if constexpr (sizeof(T) == sizeof(u8))
+  {
+    const int8x16_t v = veorq_s8(vld1q_s8(reinterpret_cast<const s8*>(ptr)), vdupq_n_s8(static_cast<s8>(bias)));
+    return MoveMaskU8(vorrq_u8(vcltq_s8(v, vdupq_n_s8(static_cast<s8>(min))),
+                               vcgtq_s8(v, vdupq_n_s8(static_cast<s8>(max)))));
+  }
+  else if constexpr (sizeof(T) == sizeof(u16))
+  {
+    const auto compare = [bias, min, max](const u8* p) {
+      const int16x8_t v =
+        veorq_s16(vld1q_s16(reinterpret_cast<const s16*>(p)), vdupq_n_s16(static_cast<s16>(bias)));
+      return vmovn_u16(vorrq_u16(vcltq_s16(v, vdupq_n_s16(static_cast<s16>(min))),
+                                 vcgtq_s16(v, vdupq_n_s16(static_cast<s16>(max)))));
+    };
+    return MoveMaskU8(vcombine_u8(compare(ptr), compare(ptr + 16)));
+  }
+  else
+  {
+    const auto compare = [bias, min, max](const u8* p) {
+      const int32x4_t v = veorq_s32(vld1q_s32(reinterpret_cast<const s32*>(p)), vdupq_n_s32(bias));
+      return vmovn_u32(vorrq_u32(vcltq_s32(v, vdupq_n_s32(min)), vcgtq_s32(v, vdupq_n_s32(max))));
+    };
+    const uint16x8_t lo = vcombine_u16(compare(ptr), compare(ptr + 16));
+    const uint16x8_t hi = vcombine_u16(compare(ptr + 32), compare(ptr + 48));
+    return MoveMaskU8(vcombine_u8(vmovn_u16(lo), vmovn_u16(hi)));
+  }
+}
+
+#endif
+
+template<typename T>
+static void ScanRAMChunk(PhysicalMemoryAddress start_address, u32 count, const MemoryScanRange& range, bool is_signed,
+                         MemoryScan::ResultVector* results)
+{
+  const auto add_result = [results, is_signed](PhysicalMemoryAddress address) {
+    const u32 value = ReadRAMScanValue<T>(address, is_signed);
+    results->push_back(MemoryScan::Result{address, value, value, false});
+  };
+
+  u32 i = 0;
+
+#if defined(CPU_X64) || defined(CPU_AARCH64)
+  {
+    // Bias and bounds in the element type, reinterpreted as signed.
+    using SignedType = std::make_signed_t<T>;
+    const T bias = is_signed ? static_cast<T>(0) : static_cast<T>(T(1) << (sizeof(T) * 8 - 1));
+    const s32 sbias = static_cast<SignedType>(bias);
+    const s32 smin = static_cast<SignedType>(static_cast<T>(static_cast<T>(range.min) ^ bias));
+    const s32 smax = static_cast<SignedType>(static_cast<T>(static_cast<T>(range.max) ^ bias));
+
+#if defined(CPU_X64)
+    const auto splat = [](s32 value) {
+      if constexpr (sizeof(T) == sizeof(u8))
+        return _mm_set1_epi8(static_cast<s8>(value));
+      else if constexpr (sizeof(T) == sizeof(u16))
+        return _mm_set1_epi16(static_cast<s16>(value));
+      else
+        return _mm_set1_epi32(value);
+    };
+    const __m128i vbias = splat(sbias);
+    const __m128i vmin = splat(smin);
+    const __m128i vmax = splat(smax);
+#else
+    const s32 vbias = sbias;
+    const s32 vmin = smin;
+    const s32 vmax = smax;
+#endif
+
+    const u32 invert_mask = range.invert ? 0u : 0xFFFFu;
+    const u8* ptr = &Bus::g_ram[start_address];
+    for (; (i + 16) <= count; i += 16, ptr += 16 * sizeof(T))
+    {
+      u32 mask = GetOutOfScanRangeMask<T>(ptr, vbias, vmin, vmax) ^ invert_mask;
+      while (mask != 0)
+      {
+        add_result(start_address + (i + CountTrailingZeros(mask)) * sizeof(T));
+        mask &= mask - 1;
+      }
+    }
+  }
+#endif
+
+  for (; i < count; i++)
+  {
+    const PhysicalMemoryAddress address = start_address + i * sizeof(T);
+    const u32 value = ReadRAMScanValue<T>(address, is_signed);
+    const s64 svalue = is_signed ? static_cast<s64>(static_cast<s32>(value)) : static_cast<s64>(value);
+    if ((svalue >= range.min && svalue <= range.max) != range.invert)
+      add_result(address);
+  }
+}
+
+template<typename T>
+static void ScanRAM(PhysicalMemoryAddress start_address, u32 count, const MemoryScanRange& range, bool is_signed,
+                    MemoryScan::ResultVector* results)
+{
+  const u32 values_per_chunk = MEMORY_SCAN_CHUNK_SIZE / sizeof(T);
+  const u32 num_chunks = (count + values_per_chunk - 1) / values_per_chunk;
+  std::vector<MemoryScan::ResultVector> chunk_results(num_chunks);
+  RunMemoryScanJobs(num_chunks, [start_address, count, values_per_chunk, &range, is_signed, &chunk_results](u32 i) {
+    const u32 first = i * values_per_chunk;
+    ScanRAMChunk<T>(start_address + first * sizeof(T), std::min(count - first, values_per_chunk), range, is_signed,
+                    &chunk_results[i]);
+  });
+
+  MergeMemoryScanResults(chunk_results, results);
+}
+
 MemoryScan::MemoryScan() = default;
 
 MemoryScan::~MemoryScan() = default;
@@ -2828,6 +3361,9 @@ void MemoryScan::Search()
 {
   m_results.clear();
 
+  if (SearchRAM())
+    return;
+
   switch (m_size)
   {
     case MemoryAccessSize::Byte:
@@ -2847,6 +3383,83 @@ void MemoryScan::Search()
   }
 }
 
+bool MemoryScan::SearchRAM()
+{
+  const u32 value_size = 1u << static_cast<u32>(m_size);
+  if (m_start_address >= m_end_address || (m_start_address % value_size) != 0 || m_end_address > Bus::g_ram_size)
+    return false;
+
+  const u32 count = (m_end_address - m_start_address + value_size - 1) / value_size;
+  const u32 value_bits = value_size * 8;
+  const s64 type_min = m_signed ? -(INT64_C(1) << (value_bits - 1)) : 0;
+  const s64 type_max = m_signed ? ((INT64_C(1) << (value_bits - 1)) - 1) : ((INT64_C(1) << value_bits) - 1);
+  const s64 value = m_signed ? static_cast<s64>(static_cast<s32>(m_value)) : static_cast<s64>(m_value);
+
+  MemoryScanRange range{type_min, type_max, false};
+  switch (m_operator)
+  {
+    case Operator::Equal:
+      range.min = range.max = value;
+      break;
+    case Operator::NotEqual:
+      range.min = range.max = value;
+      range.invert = true;
+      break;
+    case Operator::GreaterThan:
+      range.min = value + 1;
+      break;
+    case Operator::GreaterEqual:
+      range.min = value;
+      break;
+    case Operator::LessThan:
+      range.max = value - 1;
+      break;
+    case Operator::LessEqual:
+      range.max = value;
+      break;
+    case Operator::Any:
+      break;
+
+    default:
+    {
+      // Nothing has changed since the last value yet, so the relative operators match either everything or nothing.
+      const Result probe{0, 0, 0, false};
+      if (!probe.Filter(m_operator, m_value, m_signed))
+        return true;
+    }
+    break;
+  }
+
+  range.min = std::max(range.min, type_min);
+  range.max = std::min(range.max, type_max);
+  if (range.min > range.max)
+  {
+    // Constant outside what the value can hold.
+    if (!range.invert)
+      return true;
+
+    range = MemoryScanRange{type_min, type_max, false};
+  }
+
+  switch (m_size)
+  {
+    case MemoryAccessSize::Byte:
+      ScanRAM<u8>(m_start_address, count, range, m_signed, &m_results);
+      break;
+
+    case MemoryAccessSize::HalfWord:
+      ScanRAM<u16>(m_start_address, count, range, m_signed, &m_results);
+      break;
+
+    case MemoryAccessSize::Word:
+    default:
+      ScanRAM<u32>(m_start_address, count, range, m_signed, &m_results);
+      break;
+  }
+
+  return true;
+}
+
 void MemoryScan::SearchBytes()
 {
   for (PhysicalMemoryAddress address = m_start_address; address < m_end_address; address++)
@@ -2907,20 +3520,27 @@ void MemoryScan::SearchWords()
 
 void MemoryScan::SearchAgain()
 {
-  ResultVector new_results;
-  new_results.reserve(m_results.size());
-  for (Result& res : m_results)
-  {
-    res.UpdateValue(m_size, m_signed);
-
-    if (res.Filter(m_operator, m_value, m_signed))
+  const u32 num_results = static_cast<u32>(m_results.size());
+  const u32 num_chunks = (num_results + MEMORY_SCAN_RESULT_CHUNK_SIZE - 1) / MEMORY_SCAN_RESULT_CHUNK_SIZE;
+  std::vector<ResultVector> chunk_results(num_chunks);
+  RunMemoryScanJobs(num_chunks, [this, num_results, &chunk_results](u32 i) {
+    const u32 first = i * MEMORY_SCAN_RESULT_CHUNK_SIZE;
+    const u32 last = std::min(first + MEMORY_SCAN_RESULT_CHUNK_SIZE, num_results);
+    ResultVector& new_results = chunk_results[i];
+    for (u32 j = first; j < last; j++)
     {
-      res.last_value = res.value;
-      new_results.push_back(res);
+      Result& res = m_results[j];
+      res.UpdateValue(m_size, m_signed);
+
+      if (res.Filter(m_operator, m_value, m_signed))
+      {
+        res.last_value = res.value;
+        new_results.push_back(res);
+      }
     }
-  }
+  });
 
-  m_results.swap(new_results);
+  MergeMemoryScanResults(chunk_results, &m_results);
 }
 
 void MemoryScan::UpdateResultsValues()
@@ -3057,21 +3677,38 @@ void MemoryScan::Result::UpdateValue(MemoryAccessSize size, bool is_signed)
   {
     case MemoryAccessSize::Byte:
     {
-      u8 bvalue = DoMemoryRead<u8>(address);
-      value = is_signed ? SignExtend32(bvalue) : ZeroExtend32(bvalue);
+      if (IsDirectScanAddress(address, sizeof(u8)))
+      {
+        value = ReadRAMScanValue<u8>(address, is_signed);
+      }
+      else
+      {
+        u8 bvalue = DoMemoryRead<u8>(address);
+        value = is_signed ? SignExtend32(bvalue) : ZeroExtend32(bvalue);
+      }
     }
     break;
 
     case MemoryAccessSize::HalfWord:
     {
-      u16 bvalue = DoMemoryRead<u16>(address);
-      value = is_signed ? SignExtend32(bvalue) : ZeroExtend32(bvalue);
+      if (IsDirectScanAddress(address, sizeof(u16)))
+      {
+        value = ReadRAMScanValue<u16>(address, is_signed);
+      }
+      else
+      {
+        u16 bvalue = DoMemoryRead<u16>(address);
+        value = is_signed ? SignExtend32(bvalue) : ZeroExtend32(bvalue);
+      }
     }
     break;
 
     case MemoryAccessSize::Word:
     {
-      CPU::SafeReadMemoryWord(address, &value);
+      if (IsDirectScanAddress(address, sizeof(u32)))
+        value = ReadRAMScanValue<u32>(address, is_signed);
+      else
+        CPU::SafeReadMemoryWord(address, &value);
     }
     break;
   }
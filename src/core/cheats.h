@@ -151,7 +151,11 @@ public:
   ~CheatList();
 
   ALWAYS_INLINE const CheatCode& GetCode(u32 i) const { return m_codes[i]; }
-  ALWAYS_INLINE CheatCode& GetCode(u32 i) { return m_codes[i]; }
+  ALWAYS_INLINE CheatCode& GetCode(u32 i)
+  {
+    m_compiled_ops_dirty = true;
+    return m_codes[i];
+  }
   ALWAYS_INLINE u32 GetCodeCount() const { return static_cast<u32>(m_codes.size()); }
   ALWAYS_INLINE bool IsCodeEnabled(u32 index) const { return m_codes[index].enabled; }
 
@@ -195,7 +199,49 @@ public:
   void MergeList(const CheatList& cl);
 
 private:
+  /// Enabled codes are compiled to a flat list of operations, so Apply() doesn't have to decode every instruction
+  /// each frame. Codes using anything other than plain writes, arithmetic and comparisons are interpreted.
+  struct CompiledOp
+  {
+    enum class Type : u8
+    {
+      Nop,
+      Write,
+      Add,
+      Or,
+      And,
+      CompareEqual,
+      CompareNotEqual,
+      CompareLess,
+      CompareGreater,
+      Interpret,
+    };
+
+    enum class Region : u8
+    {
+      RAM,
+      Scratchpad,
+      Bus,
+    };
+
+    Type type;
+    Region region;
+    u8 size;          // 1, 2 or 4 bytes.
+    u32 address;      // Virtual address, masked when accessing RAM or the scratchpad directly.
+    u32 value;        // Zero-extended to 32 bits.
+    u32 skip_target;  // Op to continue at when a comparison fails.
+    u32 code_index;   // Code to interpret.
+  };
+
+  void CompileCodes();
+  bool CompileCode(const CheatCode& cc, u32 code_index);
+
+  static u32 ReadOpValue(const CompiledOp& op);
+  static void WriteOpValue(const CompiledOp& op, u32 value);
+
   std::vector<CheatCode> m_codes;
+  std::vector<CompiledOp> m_compiled_ops;
+  bool m_compiled_ops_dirty = true;
   bool m_master_enable = true;
 };
 
@@ -263,6 +309,9 @@ public:
   void SetResultValue(u32 index, u32 value);
 
 private:
+  /// Scans main RAM directly, returns false if the range has to go through the bus instead.
+  bool SearchRAM();
+
   void SearchBytes();
   void SearchHalfwords();
   void SearchWords();
@@ -37,6 +37,11 @@ bool Controller::DoState(StateWrapper& sw, bool apply_input_state)
   return !sw.HasError();
 }
 
+bool Controller::DoInputState(StateWrapper& sw)
+{
+  return !sw.HasError();
+}
+
 void Controller::ResetTransferState() {}
 
 bool Controller::Transfer(const u8 data_in, u8* data_out)
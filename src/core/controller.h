@@ -63,6 +63,10 @@ public:
   virtual void Reset();
   virtual bool DoState(StateWrapper& sw, bool apply_input_state);
 
+  /// Serializes only the input state which the host feeds in, such as buttons and stick positions, so it can be
+  /// recorded and replayed frame by frame.
+  virtual bool DoInputState(StateWrapper& sw);
+
   // Resets all state for the transferring to/from the device.
   virtual void ResetTransferState();
 
@@ -3,14 +3,31 @@
 
 #include "cpu_code_cache.h"
 #include "bus.h"
+#include "common/arena_allocator.h"
 #include "common/assert.h"
+#include "common/byte_stream.h"
+#include "common/file_system.h"
 #include "common/log.h"
+#include "common/path.h"
+#include "common/threading.h"
+#include "common/timer.h"
+#include "common/trace.h"
 #include "cpu_core.h"
 #include "cpu_core_private.h"
 #include "cpu_disasm.h"
+#include "host.h"
+#include "imgui.h"
 #include "settings.h"
 #include "system.h"
 #include "timing_event.h"
+#include "fmt/format.h"
+#include "xxhash.h"
+#include <algorithm>
+#include <atomic>
+#include <cinttypes>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
 Log_SetChannel(CPU::CodeCache);
 
 #ifdef WITH_RECOMPILER
@@ -25,6 +42,17 @@ static constexpr bool USE_BLOCK_LINKING = true;
 static constexpr u32 RECOMPILE_FRAMES_TO_FALL_BACK_TO_INTERPRETER = 100;
 static constexpr u32 RECOMPILE_COUNT_TO_FALL_BACK_TO_INTERPRETER = 20;
 static constexpr u32 INVALIDATE_THRESHOLD_TO_DISABLE_LINKING = 10;
+static constexpr u32 IDLE_LOOP_MAX_INSTRUCTIONS = 16;
+static constexpr u32 MAX_FOLLOWED_JUMPS_PER_BLOCK = 4;
+
+enum : u32
+{
+  BLOCK_CACHE_SIGNATURE = 0x4B434C42, // BLCK
+  BLOCK_CACHE_VERSION = 1,
+
+  // Don't let the cache file grow unbounded for games which generate lots of code.
+  BLOCK_CACHE_MAX_ENTRIES = 65536,
+};
 
 #ifdef WITH_RECOMPILER
 
@@ -43,12 +71,25 @@ static constexpr u32 RECOMPILER_FAR_CODE_CACHE_SIZE = 16 * 1024 * 1024;
 #endif
 static constexpr u32 CODE_WRITE_FAULT_THRESHOLD_FOR_SLOWMEM = 10;
 
+// When the code buffer fills up, the oldest region is thrown away instead of the whole buffer.
+static constexpr u32 RECOMPILER_CODE_REGION_COUNT = 8;
+
 #ifdef USE_STATIC_CODE_BUFFER
 static constexpr u32 RECOMPILER_GUARD_SIZE = 4096;
 alignas(Recompiler::CODE_STORAGE_ALIGNMENT) static u8
   s_code_storage[RECOMPILER_CODE_CACHE_SIZE + RECOMPILER_FAR_CODE_CACHE_SIZE];
 #endif
 
+// Compiling on another thread needs a second code buffer which is within branch range of the first, and relies on the
+// host keeping the instruction cache coherent with code written by another thread.
+#if defined(USE_STATIC_CODE_BUFFER) && defined(CPU_X64)
+#define USE_ASYNC_COMPILE 1
+static constexpr u32 ASYNC_CODE_CACHE_SIZE = 16 * 1024 * 1024;
+static constexpr u32 ASYNC_FAR_CODE_CACHE_SIZE = 8 * 1024 * 1024;
+alignas(Recompiler::CODE_STORAGE_ALIGNMENT) static u8
+  s_async_code_storage[ASYNC_CODE_CACHE_SIZE + ASYNC_FAR_CODE_CACHE_SIZE];
+#endif
+
 static JitCodeBuffer s_code_buffer;
 static FastMapTable s_fast_map[FAST_MAP_TABLE_COUNT];
 static std::unique_ptr<CodeBlock::HostCodePointer[]> s_fast_map_pointers;
@@ -150,11 +191,24 @@ static void AllocateFastMap()
   Assert(table_ptr == table_ptr_end);
 }
 
+static void ResetReturnAddressStack()
+{
+  // Every entry has to point at the slot for its pc, since recompiled code jumps through it on a match.
+  for (ReturnAddressStackEntry& entry : g_state.return_address_stack)
+  {
+    entry.pc = 0;
+    entry.fast_map_slot = OffsetFastMapPointer(s_fast_map[0], 0);
+  }
+  g_state.return_address_stack_offset = 0;
+}
+
 static void ResetFastMap()
 {
   if (!s_fast_map_pointers)
     return;
 
+  ResetReturnAddressStack();
+
   for (u32 i = 0; i < FAST_MAP_TABLE_COUNT; i++)
   {
     FastMapTable ptr = DecodeFastMapPointer(i, s_fast_map[i]);
@@ -204,7 +258,27 @@ static CodeBlock* LookupBlock(CodeBlockKey key, bool allow_flush);
 /// The block can also be flushed if recompilation failed, so ignore the pointer if false is returned.
 static bool RevalidateBlock(CodeBlock* block, bool allow_flush);
 
+/// Reads the guest instructions for the block, without generating any host code.
+static bool DecodeBlock(CodeBlock* block);
+
+/// Returns true if the block is a short loop back to itself which can't make progress until an event fires.
+static bool IsIdleLoopBlock(const CodeBlock* block);
+
+/// Returns true if the load's delay slot doesn't read the loaded register, so the value can be written immediately.
+static bool CanElideLoadDelay(const Instruction& load, const Instruction& next);
+
+/// Returns true if decoding can carry on at the target of the jump, instead of ending the block after its delay slot.
+static bool CanFollowJump(const CodeBlock* block, const CodeBlockInstruction& jump,
+                          const CodeBlockInstruction& delay_slot, u32 followed_jumps);
+static void UpdateFollowedJumpPages(CodeBlock* block);
+
 static bool CompileBlock(CodeBlock* block, bool allow_flush);
+
+/// Returns true if the guest instructions for the block haven't changed since it was decoded.
+static bool BlockInstructionsMatchMemory(const CodeBlock* block);
+
+/// Decodes a new block without compiling it, and inserts it into the block and page maps.
+static CodeBlock* DecodeNewBlock(CodeBlockKey key);
 static void RemoveReferencesToBlock(CodeBlock* block);
 static void AddBlockToPageMap(CodeBlock* block);
 static void RemoveBlockFromPageMap(CodeBlock* block);
@@ -217,9 +291,70 @@ static void UnlinkBlock(CodeBlock* block);
 
 static void ClearState();
 
+/// Creates a block which isn't in the cache yet. Depending on the mode, it's compiled now, later, or only once hot.
+static CodeBlock* CreateBlock(CodeBlockKey key, bool allow_flush);
+
+/// Compiles a new block and inserts it into the lookup tables.
+static CodeBlock* CompileNewBlock(CodeBlockKey key, bool allow_flush);
+
+/// Block cache, recording the RAM blocks a game has executed so they can be compiled ahead of time.
+struct BlockCacheEntry
+{
+  u32 key;
+  u32 instruction_count;
+  u64 instructions_hash;
+};
+static bool IsBlockCacheActive();
+static u64 HashRAMInstructions(u32 physical_address, u32 instruction_count);
+static bool IsValidRAMInstructionRange(u32 physical_address, u32 instruction_count);
+static void AddBlockToBlockCache(const CodeBlock* block);
+static void AddBlocksToBlockCache();
+static void PrecompileBlockCachePage(u32 page_index, bool user_mode);
+
+/// Blocks are allocated from slabs and recycled, rather than going through the heap for every compile. Freed blocks
+/// keep their vectors' storage, so a recycled block usually doesn't need to allocate either.
+static constexpr u32 BLOCK_POOL_SLAB_SIZE = 1024;
+static CodeBlock* AllocateBlock(CodeBlockKey key);
+static void FreeBlock(CodeBlock* block);
+static void ReleaseBlockPool();
+static std::vector<std::unique_ptr<CodeBlock[]>> s_block_pool_slabs;
+static std::vector<CodeBlock*> s_free_blocks;
+
 static BlockMap s_blocks;
 static std::array<std::vector<CodeBlock*>, Bus::RAM_8MB_CODE_PAGE_COUNT> m_ram_block_map;
 
+// Which parts of each code page contain blocks, so writes to data next to code can skip the page's block list.
+static constexpr u32 RAM_CODE_SUBPAGE_SIZE = 256;
+static constexpr u32 RAM_CODE_SUBPAGES_PER_PAGE = HOST_PAGE_SIZE / RAM_CODE_SUBPAGE_SIZE;
+static_assert(RAM_CODE_SUBPAGES_PER_PAGE <= 64, "sub-page bits fit in a u64");
+static std::array<u64, Bus::RAM_8MB_CODE_PAGE_COUNT> s_ram_code_subpage_bits;
+
+static u64 GetSubPageMask(u32 page_index, PhysicalMemoryAddress start_address, PhysicalMemoryAddress end_address);
+static u64 GetBlockSubPageMask(const CodeBlock* block, u32 page_index);
+static bool BlockOverlapsRange(const CodeBlock* block, PhysicalMemoryAddress start_address,
+                               PhysicalMemoryAddress end_address);
+static void UpdateSubPageBits(u32 page_index);
+
+static std::string s_block_cache_path;
+static std::unordered_map<u32, BlockCacheEntry> s_block_cache_entries;
+static std::array<std::vector<u32>, Bus::RAM_8MB_CODE_PAGE_COUNT> s_block_cache_page_map;
+static std::bitset<Bus::RAM_8MB_CODE_PAGE_COUNT> s_block_cache_precompiled_pages;
+
+static constexpr TickCount PROFILE_SAMPLE_INTERVAL = 8192;
+static constexpr u32 PROFILE_WINDOW_MAX_ROWS = 100;
+static void ProfileSampleEvent(void* param, TickCount ticks, TickCount ticks_late);
+static std::unique_ptr<TimingEvent> s_profile_event;
+static std::unordered_map<u32, u64> s_profile_samples;
+static u64 s_profile_total_samples = 0;
+
+static u32 s_compiled_block_count = 0;
+static u32 s_recompiled_block_count = 0;
+static double s_compile_time_ms = 0.0;
+static u64 s_compiled_instruction_count = 0;
+static u64 s_compiled_host_code_bytes = 0;
+static u64 s_compiled_far_code_bytes = 0;
+static constexpr u32 STATS_WINDOW_MAX_RECOMPILED_BLOCKS = 50;
+
 #ifdef WITH_RECOMPILER
 static HostCodeMap s_host_code_map;
 
@@ -228,12 +363,84 @@ static void RemoveBlockFromHostCodeMap(CodeBlock* block);
 
 static bool InitializeFastmem();
 static void ShutdownFastmem();
+/// Generates host code for a block which has already been decoded.
+static bool CompileBlockHostCode(CodeBlock* block, bool allow_flush);
+
+/// Runs a block which doesn't have host code yet.
+static void InterpretBlock(CodeBlock& block);
+
+/// Tiered compilation, blocks are interpreted until they've executed enough times to be worth compiling.
+static bool IsTieredCompileEnabled();
+static CodeBlock* CreateInterpretedBlock(CodeBlockKey key);
+static bool RevalidateInterpretedBlock(CodeBlock* block);
+static CodeBlock* PromoteInterpretedBlock(CodeBlock* block);
+
+static u32 s_interpreted_block_count = 0;
+static u32 s_promoted_block_count = 0;
+
+/// Breakpoints are checked by interpreting the blocks which contain them, the rest of the code stays compiled.
+static bool UseBreakpointBlocks();
+static bool s_flush_for_breakpoints = false;
+
+static bool HasCodeSpaceForBlock(const JitCodeBuffer& buffer, const CodeBlock* block, bool empty_region);
+static void EvictCodeRegion(JitCodeBuffer& buffer, u32 region);
+static void EvictNextCodeRegion();
+
+static u32 s_region_eviction_count = 0;
+static u32 s_evicted_block_count = 0;
+static u32 s_full_flush_count = 0;
+
+static Common::PageFaultHandler::Callback GetFastmemPageFaultHandler();
 static Common::PageFaultHandler::HandlerResult LUTPageFaultHandler(void* exception_pc, void* fault_address,
                                                                    bool is_write);
 #ifdef WITH_MMAP_FASTMEM
 static Common::PageFaultHandler::HandlerResult MMapPageFaultHandler(void* exception_pc, void* fault_address,
                                                                     bool is_write);
 #endif
+
+#ifdef USE_ASYNC_COMPILE
+/// Block waiting for host code from the compile thread. The registers are copied when the block is queued, since the
+/// compile thread can't look at the live CPU state.
+struct AsyncCompileJob
+{
+  CodeBlock* block;
+  std::array<u32, static_cast<u8>(Reg::count)> regs;
+  u32 cop0_sr;
+  bool result;
+  bool out_of_space;
+  u32 region;
+  u32 far_code_size;
+  float compile_time_ms;
+};
+
+static void UpdateAsyncCompiler();
+static void StartAsyncCompiler();
+static void StopAsyncCompiler();
+static void PauseAsyncCompiler();
+static void ResumeAsyncCompiler();
+static void AsyncCompilerThread();
+static CodeBlock* QueueAsyncCompile(CodeBlockKey key);
+static void QueueAsyncCompileJob(CodeBlock* block);
+static bool RevalidatePendingBlock(CodeBlock* block);
+static void PublishAsyncCompiledBlocks();
+static void DiscardAsyncCompileJobs();
+static void EvictNextAsyncCodeRegion();
+
+static JitCodeBuffer s_async_code_buffer;
+static Threading::Thread s_async_compile_thread;
+static std::mutex s_async_compile_mutex;
+static std::condition_variable s_async_compile_work_cv;
+static std::condition_variable s_async_compile_idle_cv;
+static std::deque<AsyncCompileJob> s_async_compile_queue;
+static std::vector<AsyncCompileJob> s_async_compile_results;
+static std::atomic_bool s_async_compile_results_ready{false};
+static bool s_async_compile_paused = true;
+static bool s_async_compile_busy = false;
+static bool s_async_compile_shutdown = false;
+
+// Only accessed on the CPU thread.
+static bool s_async_compile_running = false;
+#endif
 #endif // WITH_RECOMPILER
 
 void Initialize()
@@ -244,12 +451,14 @@ void Initialize()
   if (g_settings.IsUsingRecompiler())
   {
 #ifdef USE_STATIC_CODE_BUFFER
-    const bool has_buffer = s_code_buffer.Initialize(s_code_storage, sizeof(s_code_storage),
-                                                     RECOMPILER_FAR_CODE_CACHE_SIZE, RECOMPILER_GUARD_SIZE);
+    const bool has_buffer =
+      s_code_buffer.Initialize(s_code_storage, sizeof(s_code_storage), RECOMPILER_FAR_CODE_CACHE_SIZE,
+                               RECOMPILER_GUARD_SIZE, g_settings.cpu_use_large_pages);
 #else
     const bool has_buffer = false;
 #endif
-    if (!has_buffer && !s_code_buffer.Allocate(RECOMPILER_CODE_CACHE_SIZE, RECOMPILER_FAR_CODE_CACHE_SIZE))
+    if (!has_buffer && !s_code_buffer.Allocate(RECOMPILER_CODE_CACHE_SIZE, RECOMPILER_FAR_CODE_CACHE_SIZE,
+                                               g_settings.cpu_use_large_pages))
     {
       Panic("Failed to initialize code space");
     }
@@ -263,28 +472,71 @@ void Initialize()
     ResetFastMap();
   }
 #endif
+
+#ifdef USE_ASYNC_COMPILE
+  UpdateAsyncCompiler();
+#endif
+
+  UpdateProfiling();
+  ResetProfile();
 }
 
 void ClearState()
 {
+#ifdef USE_ASYNC_COMPILE
+  // The compile thread could be using the blocks, so it has to be drained first.
+  DiscardAsyncCompileJobs();
+#endif
+
+
+  // Remember what we had compiled, so it can be brought back quickly after the flush.
+  AddBlocksToBlockCache();
+  s_block_cache_precompiled_pages.reset();
+
   Bus::ClearRAMCodePageFlags();
   for (auto& it : m_ram_block_map)
     it.clear();
+  s_ram_code_subpage_bits.fill(0);
 
   for (const auto& it : s_blocks)
-    delete it.second;
+  {
+    if (it.second)
+      FreeBlock(it.second);
+  }
 
   s_blocks.clear();
 #ifdef WITH_RECOMPILER
   s_host_code_map.clear();
   s_code_buffer.Reset();
   ResetFastMap();
+  s_interpreted_block_count = 0;
+  s_promoted_block_count = 0;
+#endif
+#ifdef USE_ASYNC_COMPILE
+  if (s_async_compile_running)
+  {
+    s_async_code_buffer.Reset();
+    s_async_code_buffer.InitializeRegions(RECOMPILER_CODE_REGION_COUNT);
+  }
 #endif
 }
 
 void Shutdown()
 {
+  s_profile_event.reset();
   ClearState();
+  SaveBlockCache();
+  s_block_cache_path = {};
+  s_block_cache_entries.clear();
+  for (auto& it : s_block_cache_page_map)
+    it.clear();
+
+#ifdef USE_ASYNC_COMPILE
+  StopAsyncCompiler();
+#endif
+
+  ReleaseBlockPool();
+
 #ifdef WITH_RECOMPILER
   ShutdownFastmem();
   FreeFastMap();
@@ -335,7 +587,7 @@ static void ExecuteImpl()
 #endif
 
       if (g_settings.cpu_recompiler_icache)
-        CheckAndUpdateICacheTags(block->icache_line_count, block->uncached_fetch_ticks);
+        CheckAndUpdateICacheTags(block->icache_line_count, block->uncached_fetch_ticks, &block->icache_generation);
 
       InterpretCachedBlock<pgxp_mode>(*block);
 
@@ -347,6 +599,13 @@ static void ExecuteImpl()
       next_block_key = GetNextBlockKey();
       if (next_block_key.bits == block->key.bits)
       {
+        // nothing can change until the next event, so skip ahead to it
+        if (block->is_idle_loop && g_settings.cpu_idle_loop_skipping)
+        {
+          g_state.pending_ticks = g_state.downcount;
+          break;
+        }
+
         // we can jump straight to it if there's no pending interrupts
         // ensure it's not a self-modifying block
         if (!block->invalidated || RevalidateBlock(block, true))
@@ -423,6 +682,9 @@ void CompileDispatcher()
   }
 
   s_code_buffer.WriteProtect(true);
+
+  // The dispatchers stay put, everything after them gets recycled a region at a time.
+  s_code_buffer.InitializeRegions(RECOMPILER_CODE_REGION_COUNT);
 }
 
 FastMapTable* GetFastMapPointer()
@@ -430,11 +692,26 @@ FastMapTable* GetFastMapPointer()
   return s_fast_map;
 }
 
+const CodeBlock::HostCodePointer* GetFastMapSlotPointer(u32 pc)
+{
+  return OffsetFastMapPointer(s_fast_map[pc >> FAST_MAP_TABLE_SHIFT], pc);
+}
+
 void ExecuteRecompiler()
 {
+  if (s_flush_for_breakpoints)
+  {
+    s_flush_for_breakpoints = false;
+    Flush();
+  }
+
   g_using_interpreter = false;
   g_state.frame_done = false;
 
+#ifdef USE_ASYNC_COMPILE
+  ResumeAsyncCompiler();
+#endif
+
 #if 0
   while (!g_state.frame_done)
   {
@@ -462,6 +739,11 @@ void ExecuteRecompiler()
   s_asm_dispatcher();
 #endif
 
+#ifdef USE_ASYNC_COMPILE
+  // Settings and the code cache can change between frames, so don't let the compile thread run outside of execution.
+  PauseAsyncCompiler();
+#endif
+
   // in case we switch to interpreter...
   g_state.regs.npc = g_state.regs.pc;
 }
@@ -472,6 +754,10 @@ void Reinitialize()
 {
   ClearState();
 
+#ifdef USE_ASYNC_COMPILE
+  StopAsyncCompiler();
+#endif
+
 #ifdef WITH_RECOMPILER
 
   ShutdownFastmem();
@@ -482,9 +768,10 @@ void Reinitialize()
 
 #ifdef USE_STATIC_CODE_BUFFER
     if (!s_code_buffer.Initialize(s_code_storage, sizeof(s_code_storage), RECOMPILER_FAR_CODE_CACHE_SIZE,
-                                  RECOMPILER_GUARD_SIZE))
+                                  RECOMPILER_GUARD_SIZE, g_settings.cpu_use_large_pages))
 #else
-    if (!s_code_buffer.Allocate(RECOMPILER_CODE_CACHE_SIZE, RECOMPILER_FAR_CODE_CACHE_SIZE))
+    if (!s_code_buffer.Allocate(RECOMPILER_CODE_CACHE_SIZE, RECOMPILER_FAR_CODE_CACHE_SIZE,
+                                g_settings.cpu_use_large_pages))
 #endif
     {
       Panic("Failed to initialize code space");
@@ -498,6 +785,16 @@ void Reinitialize()
     ResetFastMap();
   }
 #endif
+
+#ifdef USE_ASYNC_COMPILE
+  UpdateAsyncCompiler();
+#endif
+
+  // the recompiler handles breakpoints itself, the other modes need the debug dispatcher
+#ifdef WITH_RECOMPILER
+  s_flush_for_breakpoints = false;
+#endif
+  UpdateDebugDispatcherFlag();
 }
 
 void Flush()
@@ -507,179 +804,705 @@ void Flush()
   if (g_settings.IsUsingRecompiler())
     CompileDispatcher();
 #endif
+#ifdef USE_ASYNC_COMPILE
+  UpdateAsyncCompiler();
+#endif
 }
 
-void LogCurrentState()
+void OnBreakpointsChanged()
 {
-  const auto& regs = g_state.regs;
-  WriteToExecutionLog("tick=%u pc=%08X zero=%08X at=%08X v0=%08X v1=%08X a0=%08X a1=%08X a2=%08X a3=%08X t0=%08X "
-                      "t1=%08X t2=%08X t3=%08X t4=%08X t5=%08X t6=%08X t7=%08X s0=%08X s1=%08X s2=%08X s3=%08X s4=%08X "
-                      "s5=%08X s6=%08X s7=%08X t8=%08X t9=%08X k0=%08X k1=%08X gp=%08X sp=%08X fp=%08X ra=%08X ldr=%s "
-                      "ldv=%08X\n",
-                      TimingEvents::GetGlobalTickCounter() + GetPendingTicks(), regs.pc, regs.zero, regs.at, regs.v0,
-                      regs.v1, regs.a0, regs.a1, regs.a2, regs.a3, regs.t0, regs.t1, regs.t2, regs.t3, regs.t4, regs.t5,
-                      regs.t6, regs.t7, regs.s0, regs.s1, regs.s2, regs.s3, regs.s4, regs.s5, regs.s6, regs.s7, regs.t8,
-                      regs.t9, regs.k0, regs.k1, regs.gp, regs.sp, regs.fp, regs.ra,
-                      (g_state.next_load_delay_reg == Reg::count) ? "NONE" : GetRegName(g_state.next_load_delay_reg),
-                      (g_state.next_load_delay_reg == Reg::count) ? 0 : g_state.next_load_delay_value);
+#ifdef WITH_RECOMPILER
+  if (!g_settings.IsUsingRecompiler())
+    return;
+
+  // Compiled blocks could be running over the new breakpoint, so get out of them now.
+  s_flush_for_breakpoints = true;
+  CPU::ForceDispatcherExit();
+#endif
 }
 
-CodeBlockKey GetNextBlockKey()
+TierStats GetTierStats()
 {
-  CodeBlockKey key = {};
-  key.SetPC(g_state.regs.pc);
-  key.user_mode = InUserMode();
-  return key;
+  TierStats stats = {};
+#ifdef WITH_RECOMPILER
+  stats.interpreted_blocks = s_interpreted_block_count;
+  stats.compiled_blocks = static_cast<u32>(s_host_code_map.size());
+  stats.promoted_blocks = s_promoted_block_count;
+#endif
+  return stats;
 }
 
-// assumes it has already been unlinked
-static void FallbackExistingBlockToInterpreter(CodeBlock* block)
+EvictionStats GetEvictionStats()
 {
-  // Replace with null so we don't try to compile it again.
-  s_blocks.emplace(block->key.bits, nullptr);
-  delete block;
+  EvictionStats stats = {};
+#ifdef WITH_RECOMPILER
+  stats.region_evictions = s_region_eviction_count;
+  stats.evicted_blocks = s_evicted_block_count;
+  stats.full_flushes = s_full_flush_count;
+#endif
+  return stats;
 }
 
-CodeBlock* LookupBlock(CodeBlockKey key, bool allow_flush)
+CompileStats GetCompileStats()
 {
-  BlockMap::iterator iter = s_blocks.find(key.bits);
-  if (iter != s_blocks.end())
+  CompileStats stats = {};
+  stats.compiled_blocks = s_compiled_block_count;
+  stats.recompiled_blocks = s_recompiled_block_count;
+  stats.compile_time_ms = s_compile_time_ms;
+  stats.compiled_instructions = s_compiled_instruction_count;
+  stats.host_code_bytes = s_compiled_host_code_bytes;
+  stats.far_code_bytes = s_compiled_far_code_bytes;
+  return stats;
+}
+
+#ifdef WITH_RECOMPILER
+static void DrawCodeBufferUsage(const char* name, const JitCodeBuffer& buffer)
+{
+  if (!buffer.IsValid())
+    return;
+
+  ImGui::Text("%s: %u / %u KB", name, buffer.GetCodeUsed() / 1024u, buffer.GetCodeSize() / 1024u);
+  if (buffer.GetRegionCount() > 1)
   {
-    // ensure it hasn't been invalidated
-    CodeBlock* existing_block = iter->second;
-    if (!existing_block || !existing_block->invalidated)
-      return existing_block;
+    ImGui::SameLine();
+    ImGui::Text("(region %u of %u, %u KB free)", buffer.GetCurrentRegion() + 1, buffer.GetRegionCount(),
+                buffer.GetFreeCodeSpace() / 1024u);
+  }
+}
+#endif
 
-    // if compilation fails or we're forced back to the interpreter, bail out
-    if (RevalidateBlock(existing_block, allow_flush))
-      return existing_block;
-    else
-      return nullptr;
+void DrawStatsWindow()
+{
+  const float framebuffer_scale = Host::GetOSDScale();
+
+  ImGui::SetNextWindowSize(ImVec2(500.0f * framebuffer_scale, 600.0f * framebuffer_scale), ImGuiCond_FirstUseEver);
+  if (!ImGui::Begin("Code Cache", nullptr))
+  {
+    ImGui::End();
+    return;
   }
 
-  CodeBlock* block = new CodeBlock(key);
-  block->recompile_frame_number = System::GetFrameNumber();
+  const TierStats ts = GetTierStats();
+  const CompileStats cs = GetCompileStats();
 
-  if (CompileBlock(block, allow_flush))
+  const double per_block = (cs.compiled_blocks > 0) ? (1.0 / static_cast<double>(cs.compiled_blocks)) : 0.0;
+  const double per_instruction =
+    (cs.compiled_instructions > 0) ? (1.0 / static_cast<double>(cs.compiled_instructions)) : 0.0;
+
+  if (ImGui::CollapsingHeader("Blocks", ImGuiTreeNodeFlags_DefaultOpen))
   {
-    // add it to the page map if it's in ram
-    AddBlockToPageMap(block);
+    ImGui::Text("Blocks: %zu (%u interpreted, %u compiled, %u promoted)", s_blocks.size(), ts.interpreted_blocks,
+                ts.compiled_blocks, ts.promoted_blocks);
+    ImGui::Text("Compiled: %u blocks, %u recompiled", cs.compiled_blocks, cs.recompiled_blocks);
+    ImGui::Text("Compile time: %.2f ms (%.2f us per block)", cs.compile_time_ms,
+                cs.compile_time_ms * 1000.0 * per_block);
+    ImGui::Text("Guest instructions: %" PRIu64 " (%.2f per block)", cs.compiled_instructions,
+                static_cast<double>(cs.compiled_instructions) * per_block);
+    ImGui::Text("Host bytes per instruction: %.2f near, %.2f far",
+                static_cast<double>(cs.host_code_bytes) * per_instruction,
+                static_cast<double>(cs.far_code_bytes) * per_instruction);
+  }
 
 #ifdef WITH_RECOMPILER
-    SetFastMap(block->GetPC(), block->host_code);
-    AddBlockToHostCodeMap(block);
+  if (ImGui::CollapsingHeader("Code Buffer", ImGuiTreeNodeFlags_DefaultOpen))
+  {
+    const EvictionStats es = GetEvictionStats();
+    DrawCodeBufferUsage("Code buffer", s_code_buffer);
+#ifdef USE_ASYNC_COMPILE
+    DrawCodeBufferUsage("Compile thread buffer", s_async_code_buffer);
 #endif
+    ImGui::Text("Region evictions: %u (%u blocks)", es.region_evictions, es.evicted_blocks);
+    ImGui::Text("Full flushes: %u", es.full_flushes);
   }
-  else
+#endif
+
+  if (ImGui::CollapsingHeader("Most Recompiled Blocks", ImGuiTreeNodeFlags_DefaultOpen))
   {
-    Log_ErrorPrintf("Failed to compile block at PC=0x%08X", key.GetPC());
-    delete block;
-    block = nullptr;
+    // recompile_count is reset when a block hasn't been modified for a while, so this is the recent SMC activity
+    std::vector<const CodeBlock*> blocks;
+    for (const auto& it : s_blocks)
+    {
+      if (it.second->recompile_count > 0)
+        blocks.push_back(it.second);
+    }
+    std::sort(blocks.begin(), blocks.end(), [](const CodeBlock* lhs, const CodeBlock* rhs) {
+      return (lhs->recompile_count != rhs->recompile_count) ? (lhs->recompile_count > rhs->recompile_count) :
+                                                              (lhs->GetPC() < rhs->GetPC());
+    });
+    if (blocks.size() > STATS_WINDOW_MAX_RECOMPILED_BLOCKS)
+      blocks.resize(STATS_WINDOW_MAX_RECOMPILED_BLOCKS);
+
+    const ImGuiTableFlags flags = ImGuiTableFlags_RowBg | ImGuiTableFlags_Borders;
+    if (ImGui::BeginTable("MostRecompiledBlocks", 5, flags))
+    {
+      ImGui::TableSetupColumn("Address");
+      ImGui::TableSetupColumn("Recompiles");
+      ImGui::TableSetupColumn("Instructions");
+      ImGui::TableSetupColumn("Host Bytes");
+      ImGui::TableSetupColumn("State");
+      ImGui::TableHeadersRow();
+
+      for (const CodeBlock* block : blocks)
+      {
+        ImGui::TableNextRow();
+        ImGui::TableNextColumn();
+        ImGui::Text("0x%08X", block->GetPC());
+        ImGui::TableNextColumn();
+        ImGui::Text("%u", block->recompile_count);
+        ImGui::TableNextColumn();
+        ImGui::Text("%zu", block->instructions.size());
+        ImGui::TableNextColumn();
+        ImGui::Text("%u", block->host_code_size);
+        ImGui::TableNextColumn();
+        ImGui::TextUnformatted(block->invalidated ? "Invalidated" : (block->interpreted ? "Interpreted" : "Compiled"));
+      }
+
+      ImGui::EndTable();
+    }
   }
 
-  if (block || allow_flush)
-    s_blocks.emplace(key.bits, block);
+  ImGui::End();
+}
 
-  return block;
+namespace {
+struct ProfileRow
+{
+  u32 address;
+  u32 function;
+  u64 samples;
+};
+} // namespace
+
+void ProfileSampleEvent(void* param, TickCount ticks, TickCount ticks_late)
+{
+  // Events only run between blocks, so this is the start of the next block with the recompiler.
+  s_profile_samples[g_state.regs.pc]++;
+  s_profile_total_samples++;
 }
 
-bool RevalidateBlock(CodeBlock* block, bool allow_flush)
+/// Returns the sorted targets of every jal in the cache, which are taken to be the start of functions.
+static std::vector<u32> GetProfileFunctionStarts()
 {
-  for (const CodeBlockInstruction& cbi : block->instructions)
+  std::vector<u32> starts;
+  for (const auto& it : s_blocks)
   {
-    u32 new_code = 0;
-    SafeReadInstruction(cbi.pc, &new_code);
-    if (cbi.instruction.bits != new_code)
+    for (const CodeBlockInstruction& cbi : it.second->instructions)
     {
-      Log_DebugPrintf("Block 0x%08X changed at PC 0x%08X - %08X to %08X - recompiling.", block->GetPC(), cbi.pc,
-                      cbi.instruction.bits, new_code);
-      goto recompile;
+      if (cbi.instruction.op == InstructionOp::jal)
+        starts.push_back(((cbi.pc + 4) & UINT32_C(0xF0000000)) | (cbi.instruction.j.target << 2));
     }
   }
 
-  // re-add it to the page map since it's still up-to-date
-  block->invalidated = false;
-  AddBlockToPageMap(block);
-#ifdef WITH_RECOMPILER
-  SetFastMap(block->GetPC(), block->host_code);
-#endif
-  return true;
+  std::sort(starts.begin(), starts.end());
+  starts.erase(std::unique(starts.begin(), starts.end()), starts.end());
+  return starts;
+}
 
-recompile:
-  // remove any references to the block from the lookup table.
-  // this is an edge case where compiling causes a flush-all due to no space,
-  // and we don't want to nuke the block we're compiling...
-  RemoveReferencesToBlock(block);
+static u32 GetProfileFunction(const std::vector<u32>& function_starts, u32 address)
+{
+  // Addresses before the first known function in their segment are treated as their own function.
+  auto iter = std::upper_bound(function_starts.begin(), function_starts.end(), address);
+  if (iter == function_starts.begin() || ((*(iter - 1) ^ address) & UINT32_C(0xF0000000)) != 0)
+    return address;
 
-#ifdef WITH_RECOMPILER
-  RemoveBlockFromHostCodeMap(block);
-#endif
+  return *(iter - 1);
+}
 
-  const u32 frame_number = System::GetFrameNumber();
-  const u32 frame_diff = frame_number - block->recompile_frame_number;
-  if (frame_diff <= RECOMPILE_FRAMES_TO_FALL_BACK_TO_INTERPRETER)
-  {
-    block->recompile_count++;
+static void SortProfileRows(std::vector<ProfileRow>& rows)
+{
+  std::sort(rows.begin(), rows.end(), [](const ProfileRow& lhs, const ProfileRow& rhs) {
+    return (lhs.samples != rhs.samples) ? (lhs.samples > rhs.samples) : (lhs.address < rhs.address);
+  });
+}
 
-    if (block->recompile_count >= RECOMPILE_COUNT_TO_FALL_BACK_TO_INTERPRETER)
-    {
-      Log_PerfPrintf("Block 0x%08X has been recompiled %u times in %u frames, falling back to interpreter",
-                     block->GetPC(), block->recompile_count, frame_diff);
+static std::vector<ProfileRow> GetProfileBlockRows()
+{
+  const std::vector<u32> function_starts = GetProfileFunctionStarts();
 
-      FallbackExistingBlockToInterpreter(block);
-      return false;
+  std::vector<ProfileRow> rows;
+  rows.reserve(s_profile_samples.size());
+  for (const auto& it : s_profile_samples)
+    rows.push_back(ProfileRow{it.first, GetProfileFunction(function_starts, it.first), it.second});
+
+  SortProfileRows(rows);
+  return rows;
+}
+
+static std::vector<ProfileRow> GetProfileFunctionRows(const std::vector<ProfileRow>& block_rows)
+{
+  std::unordered_map<u32, u64> function_samples;
+  for (const ProfileRow& row : block_rows)
+    function_samples[row.function] += row.samples;
+
+  std::vector<ProfileRow> rows;
+  rows.reserve(function_samples.size());
+  for (const auto& it : function_samples)
+    rows.push_back(ProfileRow{it.first, it.first, it.second});
+
+  SortProfileRows(rows);
+  return rows;
+}
+
+static void DrawProfileTable(const char* str_id, const std::vector<ProfileRow>& rows, bool show_function)
+{
+  const ImGuiTableFlags flags = ImGuiTableFlags_RowBg | ImGuiTableFlags_Borders;
+  if (!ImGui::BeginTable(str_id, show_function ? 4 : 3, flags))
+    return;
+
+  ImGui::TableSetupColumn("Address");
+  if (show_function)
+    ImGui::TableSetupColumn("Function");
+  ImGui::TableSetupColumn("Samples");
+  ImGui::TableSetupColumn("%");
+  ImGui::TableHeadersRow();
+
+  const double percent_scale =
+    (s_profile_total_samples > 0) ? (100.0 / static_cast<double>(s_profile_total_samples)) : 0.0;
+  const size_t num_rows = std::min<size_t>(rows.size(), PROFILE_WINDOW_MAX_ROWS);
+  for (size_t i = 0; i < num_rows; i++)
+  {
+    const ProfileRow& row = rows[i];
+    ImGui::TableNextRow();
+    ImGui::TableNextColumn();
+    ImGui::Text("0x%08X", row.address);
+    if (show_function)
+    {
+      ImGui::TableNextColumn();
+      ImGui::Text("0x%08X", row.function);
     }
+    ImGui::TableNextColumn();
+    ImGui::Text("%" PRIu64, row.samples);
+    ImGui::TableNextColumn();
+    ImGui::Text("%.2f", static_cast<double>(row.samples) * percent_scale);
   }
-  else
+
+  ImGui::EndTable();
+}
+
+static void ExportProfile()
+{
+  const std::string& serial = System::GetRunningSerial();
+  const std::string path =
+    Path::Combine(EmuFolders::Dumps, serial.empty() ? std::string("cpu_profile.json") :
+                                                      fmt::format("cpu_profile_{}.json", serial));
+  auto fp = FileSystem::OpenManagedCFile(path.c_str(), "wb");
+  if (fp)
   {
-    // It's been a while since this block was modified, so it's all good.
-    block->recompile_frame_number = frame_number;
-    block->recompile_count = 0;
+    WriteProfile(fp.get());
+    if (std::ferror(fp.get()))
+      fp.reset();
   }
 
-  block->instructions.clear();
-
-  if (!CompileBlock(block, allow_flush))
+  if (!fp)
   {
-    Log_PerfPrintf("Failed to recompile block 0x%08X, falling back to interpreter.", block->GetPC());
-    FallbackExistingBlockToInterpreter(block);
-    return false;
+    Host::AddFormattedOSDMessage(10.0f, "Failed to write CPU profile to '%s'.", path.c_str());
+    return;
   }
 
-  AddBlockToPageMap(block);
+  Host::AddFormattedOSDMessage(5.0f, "CPU profile written to '%s'.", path.c_str());
+}
 
-#ifdef WITH_RECOMPILER
-  // re-add to page map again
-  SetFastMap(block->GetPC(), block->host_code);
-  AddBlockToHostCodeMap(block);
-#endif
+void UpdateProfiling()
+{
+  const bool enabled = (g_settings.debugging.profile_cpu || g_settings.debugging.show_cpu_profile);
+  if (enabled == static_cast<bool>(s_profile_event))
+    return;
 
-  // block is valid again
-  block->invalidated = false;
+  // No event when disabled, so there's no cost at all.
+  if (enabled)
+  {
+    s_profile_event = TimingEvents::CreateTimingEvent("CPU Profile Sample", PROFILE_SAMPLE_INTERVAL,
+                                                      PROFILE_SAMPLE_INTERVAL, &ProfileSampleEvent, nullptr, true);
+  }
+  else
+  {
+    s_profile_event.reset();
+  }
+}
 
-  // re-insert into the block map since we removed it earlier.
-  s_blocks.emplace(block->key.bits, block);
-  return true;
+void ResetProfile()
+{
+  s_profile_samples.clear();
+  s_profile_total_samples = 0;
 }
 
-bool CompileBlock(CodeBlock* block, bool allow_flush)
+void DrawProfileWindow()
 {
-  u32 pc = block->GetPC();
-  bool is_branch_delay_slot = false;
-  bool is_load_delay_slot = false;
+  const float framebuffer_scale = Host::GetOSDScale();
 
-#if 0
-  if (pc == 0x0005aa90)
-    __debugbreak();
-#endif
+  ImGui::SetNextWindowSize(ImVec2(500.0f * framebuffer_scale, 600.0f * framebuffer_scale), ImGuiCond_FirstUseEver);
+  if (!ImGui::Begin("CPU Profile", nullptr))
+  {
+    ImGui::End();
+    return;
+  }
 
-  block->icache_line_count = 0;
-  block->uncached_fetch_ticks = 0;
+  if (ImGui::Button("Reset"))
+    ResetProfile();
+  ImGui::SameLine();
+  if (ImGui::Button("Export"))
+    ExportProfile();
+  ImGui::SameLine();
+  ImGui::Text("%" PRIu64 " samples", s_profile_total_samples);
+
+  const std::vector<ProfileRow> block_rows = GetProfileBlockRows();
+  const std::vector<ProfileRow> function_rows = GetProfileFunctionRows(block_rows);
+
+  if (ImGui::CollapsingHeader("Functions", ImGuiTreeNodeFlags_DefaultOpen))
+    DrawProfileTable("Functions", function_rows, false);
+
+  if (ImGui::CollapsingHeader("Blocks", ImGuiTreeNodeFlags_DefaultOpen))
+    DrawProfileTable("Blocks", block_rows, true);
+
+  ImGui::End();
+}
+
+void WriteProfile(std::FILE* fp)
+{
+  const std::vector<ProfileRow> block_rows = GetProfileBlockRows();
+  const std::vector<ProfileRow> function_rows = GetProfileFunctionRows(block_rows);
+
+  std::fprintf(fp, "{\n");
+  std::fprintf(fp, "  \"sample_interval\": %d,\n", PROFILE_SAMPLE_INTERVAL);
+  std::fprintf(fp, "  \"total_samples\": %" PRIu64 ",\n", s_profile_total_samples);
+  std::fprintf(fp, "  \"functions\": [");
+  for (size_t i = 0; i < function_rows.size(); i++)
+  {
+    const ProfileRow& row = function_rows[i];
+    std::fprintf(fp, "%s\n    {\"address\": \"0x%08X\", \"samples\": %" PRIu64 "}", (i > 0) ? "," : "",
+                 row.address, row.samples);
+  }
+  std::fprintf(fp, "\n  ],\n");
+
+  std::fprintf(fp, "  \"blocks\": [");
+  for (size_t i = 0; i < block_rows.size(); i++)
+  {
+    const ProfileRow& row = block_rows[i];
+    std::fprintf(fp, "%s\n    {\"address\": \"0x%08X\", \"function\": \"0x%08X\", \"samples\": %" PRIu64 "}",
+                 (i > 0) ? "," : "", row.address, row.function, row.samples);
+  }
+  std::fprintf(fp, "\n  ]\n");
+  std::fprintf(fp, "}\n");
+}
+
+void LogCurrentState()
+{
+  const auto& regs = g_state.regs;
+  WriteToExecutionLog("tick=%u pc=%08X zero=%08X at=%08X v0=%08X v1=%08X a0=%08X a1=%08X a2=%08X a3=%08X t0=%08X "
+                      "t1=%08X t2=%08X t3=%08X t4=%08X t5=%08X t6=%08X t7=%08X s0=%08X s1=%08X s2=%08X s3=%08X s4=%08X "
+                      "s5=%08X s6=%08X s7=%08X t8=%08X t9=%08X k0=%08X k1=%08X gp=%08X sp=%08X fp=%08X ra=%08X ldr=%s "
+                      "ldv=%08X\n",
+                      TimingEvents::GetGlobalTickCounter() + GetPendingTicks(), regs.pc, regs.zero, regs.at, regs.v0,
+                      regs.v1, regs.a0, regs.a1, regs.a2, regs.a3, regs.t0, regs.t1, regs.t2, regs.t3, regs.t4, regs.t5,
+                      regs.t6, regs.t7, regs.s0, regs.s1, regs.s2, regs.s3, regs.s4, regs.s5, regs.s6, regs.s7, regs.t8,
+                      regs.t9, regs.k0, regs.k1, regs.gp, regs.sp, regs.fp, regs.ra,
+                      (g_state.next_load_delay_reg == Reg::count) ? "NONE" : GetRegName(g_state.next_load_delay_reg),
+                      (g_state.next_load_delay_reg == Reg::count) ? 0 : g_state.next_load_delay_value);
+}
+
+CodeBlockKey GetNextBlockKey()
+{
+  CodeBlockKey key = {};
+  key.SetPC(g_state.regs.pc);
+  key.user_mode = InUserMode();
+  return key;
+}
+
+CodeBlock* AllocateBlock(CodeBlockKey key)
+{
+  if (s_free_blocks.empty())
+  {
+    std::unique_ptr<CodeBlock[]> slab = std::make_unique<CodeBlock[]>(BLOCK_POOL_SLAB_SIZE);
+    s_free_blocks.reserve(s_free_blocks.size() + BLOCK_POOL_SLAB_SIZE);
+    for (u32 i = BLOCK_POOL_SLAB_SIZE; i > 0; i--)
+      s_free_blocks.push_back(&slab[i - 1]);
+    s_block_pool_slabs.push_back(std::move(slab));
+  }
+
+  CodeBlock* block = s_free_blocks.back();
+  s_free_blocks.pop_back();
+
+  // Start from a fresh block, but hang on to the storage from its last use.
+  CodeBlock fresh_block(key);
+  fresh_block.instructions.swap(block->instructions);
+  fresh_block.link_predecessors.swap(block->link_predecessors);
+  fresh_block.link_successors.swap(block->link_successors);
+  fresh_block.followed_jump_pages.swap(block->followed_jump_pages);
+#ifdef WITH_RECOMPILER
+  fresh_block.loadstore_backpatch_info.swap(block->loadstore_backpatch_info);
+#endif
+  *block = std::move(fresh_block);
+  return block;
+}
+
+void FreeBlock(CodeBlock* block)
+{
+  block->instructions.clear();
+  block->link_predecessors.clear();
+  block->link_successors.clear();
+  block->followed_jump_pages.clear();
+#ifdef WITH_RECOMPILER
+  block->loadstore_backpatch_info.clear();
+#endif
+  s_free_blocks.push_back(block);
+}
+
+void ReleaseBlockPool()
+{
+  s_free_blocks.clear();
+  s_free_blocks.shrink_to_fit();
+  s_block_pool_slabs.clear();
+  s_block_pool_slabs.shrink_to_fit();
+}
+
+// assumes it has already been unlinked
+static void FallbackExistingBlockToInterpreter(CodeBlock* block)
+{
+  // Replace with null so we don't try to compile it again.
+  s_blocks.emplace(block->key.bits, nullptr);
+  FreeBlock(block);
+}
+
+CodeBlock* LookupBlock(CodeBlockKey key, bool allow_flush)
+{
+  BlockMap::iterator iter = s_blocks.find(key.bits);
+  if (iter != s_blocks.end())
+  {
+    // ensure it hasn't been invalidated
+    CodeBlock* existing_block = iter->second;
+    if (!existing_block || !existing_block->invalidated)
+      return existing_block;
+
+#ifdef WITH_RECOMPILER
+    if (existing_block->interpreted)
+      return RevalidateInterpretedBlock(existing_block) ? existing_block : nullptr;
+#endif
+
+#ifdef USE_ASYNC_COMPILE
+    if (existing_block->compile_pending)
+    {
+      if (RevalidatePendingBlock(existing_block))
+        return existing_block;
+
+      // The compile thread is still using the old block, so it's freed when the result comes back.
+      Log_DebugPrintf("Pending block 0x%08X changed, discarding.", existing_block->GetPC());
+      s_blocks.erase(iter);
+      return CreateBlock(key, allow_flush);
+    }
+#endif
+
+    // if compilation fails or we're forced back to the interpreter, bail out
+    if (RevalidateBlock(existing_block, allow_flush))
+      return existing_block;
+    else
+      return nullptr;
+  }
+
+  return CreateBlock(key, allow_flush);
+}
+
+CodeBlock* CreateBlock(CodeBlockKey key, bool allow_flush)
+{
+  CodeBlock* block;
+#ifdef WITH_RECOMPILER
+  if (UseBreakpointBlocks())
+  {
+    // Only the blocks which actually contain a breakpoint have to stay in the interpreter.
+    block = CreateInterpretedBlock(key);
+    if (block && !block->contains_breakpoint && !IsTieredCompileEnabled())
+      block = PromoteInterpretedBlock(block);
+
+    return block;
+  }
+  else if (IsTieredCompileEnabled())
+  {
+    block = CreateInterpretedBlock(key);
+  }
+#ifdef USE_ASYNC_COMPILE
+  else if (s_async_compile_running)
+    block = QueueAsyncCompile(key);
+#endif
+  else
+#endif
+    block = CompileNewBlock(key, allow_flush);
+
+  // pull in any other blocks we've seen this game execute from the same page
+  if (block && block->IsInRAM() && IsBlockCacheActive())
+    PrecompileBlockCachePage(block->GetStartPageIndex(), key.user_mode);
+
+  return block;
+}
+
+CodeBlock* CompileNewBlock(CodeBlockKey key, bool allow_flush)
+{
+  CodeBlock* block = AllocateBlock(key);
+  block->recompile_frame_number = System::GetFrameNumber();
+
+  if (CompileBlock(block, allow_flush))
+  {
+    // add it to the page map if it's in ram
+    AddBlockToPageMap(block);
+
+#ifdef WITH_RECOMPILER
+    SetFastMap(block->GetPC(), block->host_code);
+    AddBlockToHostCodeMap(block);
+#endif
+  }
+  else
+  {
+    Log_ErrorPrintf("Failed to compile block at PC=0x%08X", key.GetPC());
+    FreeBlock(block);
+    block = nullptr;
+  }
+
+  if (block || allow_flush)
+    s_blocks.emplace(key.bits, block);
+
+  return block;
+}
+
+CodeBlock* DecodeNewBlock(CodeBlockKey key)
+{
+  CodeBlock* block = AllocateBlock(key);
+  block->recompile_frame_number = System::GetFrameNumber();
+
+  if (!DecodeBlock(block))
+  {
+    Log_ErrorPrintf("Failed to compile block at PC=0x%08X", key.GetPC());
+    FreeBlock(block);
+    s_blocks.emplace(key.bits, nullptr);
+    return nullptr;
+  }
+
+  // Writes to the block's pages still have to be caught while it doesn't have host code, since it's interpreted.
+  AddBlockToPageMap(block);
+  s_blocks.emplace(key.bits, block);
+  return block;
+}
+
+bool BlockInstructionsMatchMemory(const CodeBlock* block)
+{
+  if (block->has_instructions_hash)
+  {
+    return (HashRAMInstructions(block->key.GetPCPhysicalAddress(), static_cast<u32>(block->instructions.size())) ==
+            block->instructions_hash);
+  }
+
+  for (const CodeBlockInstruction& cbi : block->instructions)
+  {
+    u32 new_code = 0;
+    SafeReadInstruction(cbi.pc, &new_code);
+    if (cbi.instruction.bits != new_code)
+      return false;
+  }
+
+  return true;
+}
+
+bool RevalidateBlock(CodeBlock* block, bool allow_flush)
+{
+  if (!BlockInstructionsMatchMemory(block))
+  {
+    Log_DebugPrintf("Block 0x%08X changed - recompiling.", block->GetPC());
+    goto recompile;
+  }
+
+  // re-add it to the page map since it's still up-to-date
+  block->invalidated = false;
+  AddBlockToPageMap(block);
+#ifdef WITH_RECOMPILER
+  SetFastMap(block->GetPC(), block->host_code);
+#endif
+  return true;
+
+recompile:
+  // remove any references to the block from the lookup table.
+  // this is an edge case where compiling causes a flush-all due to no space,
+  // and we don't want to nuke the block we're compiling...
+  RemoveReferencesToBlock(block);
+
+#ifdef WITH_RECOMPILER
+  RemoveBlockFromHostCodeMap(block);
+#endif
+
+  s_recompiled_block_count++;
+
+  const u32 frame_number = System::GetFrameNumber();
+  const u32 frame_diff = frame_number - block->recompile_frame_number;
+  if (frame_diff <= RECOMPILE_FRAMES_TO_FALL_BACK_TO_INTERPRETER)
+  {
+    block->recompile_count++;
+
+    if (block->recompile_count >= RECOMPILE_COUNT_TO_FALL_BACK_TO_INTERPRETER)
+    {
+      Log_PerfPrintf("Block 0x%08X has been recompiled %u times in %u frames, falling back to interpreter",
+                     block->GetPC(), block->recompile_count, frame_diff);
+
+      FallbackExistingBlockToInterpreter(block);
+      return false;
+    }
+  }
+  else
+  {
+    // It's been a while since this block was modified, so it's all good.
+    block->recompile_frame_number = frame_number;
+    block->recompile_count = 0;
+  }
+
+  block->instructions.clear();
+
+  if (!CompileBlock(block, allow_flush))
+  {
+    Log_PerfPrintf("Failed to recompile block 0x%08X, falling back to interpreter.", block->GetPC());
+    FallbackExistingBlockToInterpreter(block);
+    return false;
+  }
+
+  AddBlockToPageMap(block);
+
+#ifdef WITH_RECOMPILER
+  // re-add to page map again
+  SetFastMap(block->GetPC(), block->host_code);
+  AddBlockToHostCodeMap(block);
+#endif
+
+  // block is valid again
+  block->invalidated = false;
+
+  // re-insert into the block map since we removed it earlier.
+  s_blocks.emplace(block->key.bits, block);
+  return true;
+}
+
+bool DecodeBlock(CodeBlock* block)
+{
+  u32 pc = block->GetPC();
+  u32 followed_jumps = 0;
+  bool is_branch_delay_slot = false;
+  bool is_load_delay_slot = false;
+
+#if 0
+  if (pc == 0x0005aa90)
+    __debugbreak();
+#endif
+
+  block->icache_line_count = 0;
+  block->icache_generation = g_state.icache_generation - 1;
+  block->uncached_fetch_ticks = 0;
   block->contains_double_branches = false;
+  block->contains_followed_jumps = false;
   block->contains_loadstore_instructions = false;
+  block->contains_breakpoint = false;
+  block->is_idle_loop = false;
 
   u32 last_cache_line = ICACHE_LINES;
 
+  // decode into scratch memory first, so the block's own list is allocated once at the right size
+  ArenaAllocator& arena = ArenaAllocator::GetFrameArena();
+  ArenaAllocator::Scope arena_scope(arena);
+  ArenaVector<CodeBlockInstruction> instructions{ArenaAllocatorAdapter<CodeBlockInstruction>(arena)};
+  instructions.reserve(64);
+
   for (;;)
   {
     CodeBlockInstruction cbi = {};
@@ -697,6 +1520,7 @@ bool CompileBlock(CodeBlock* block, bool allow_flush)
     cbi.has_load_delay = InstructionHasLoadDelay(cbi.instruction);
     cbi.can_trap = CanInstructionTrap(cbi.instruction, InUserMode());
     cbi.is_direct_branch_instruction = IsDirectBranchInstruction(cbi.instruction);
+    DecodeCachedInterpreterInstruction(&cbi);
 
     if (g_settings.cpu_recompiler_icache)
     {
@@ -716,7 +1540,7 @@ bool CompileBlock(CodeBlock* block, bool allow_flush)
 
     if (is_branch_delay_slot && cbi.is_branch_instruction)
     {
-      const CodeBlockInstruction& prev_cbi = block->instructions.back();
+      const CodeBlockInstruction& prev_cbi = instructions.back();
       if (!prev_cbi.is_unconditional_branch_instruction || !prev_cbi.is_direct_branch_instruction)
       {
         Log_WarningPrintf("Conditional or indirect branch delay slot at %08X, skipping block", cbi.pc);
@@ -730,16 +1554,36 @@ bool CompileBlock(CodeBlock* block, bool allow_flush)
 
       // change the pc for the second branch's delay slot, it comes from the first branch
       pc = GetDirectBranchTarget(prev_cbi.instruction, prev_cbi.pc);
+      block->contains_double_branches = true;
       Log_DevPrintf("Double branch at %08X, using delay slot from %08X -> %08X", cbi.pc, prev_cbi.pc, pc);
     }
 
     // instruction is decoded now
-    block->instructions.push_back(cbi);
+    instructions.push_back(cbi);
 
     // if we're in a branch delay slot, the block is now done
     // except if this is a branch in a branch delay slot, then we grab the one after that, and so on...
     if (is_branch_delay_slot && !cbi.is_branch_instruction)
-      break;
+    {
+      // unconditional jumps can carry on decoding at the target instead, so the code doesn't go via the dispatcher
+      CodeBlockInstruction& jump = instructions[instructions.size() - 2];
+      const u32 target = GetDirectBranchTarget(jump.instruction, jump.pc);
+      if (!CanFollowJump(block, jump, cbi, followed_jumps) ||
+          std::any_of(instructions.begin(), instructions.end(),
+                      [target](const CodeBlockInstruction& it) { return (it.pc == target); }))
+      {
+        break;
+      }
+
+      Log_DebugPrintf("Following jump at %08X -> %08X", jump.pc, target);
+      jump.is_followed_jump = true;
+      block->contains_followed_jumps = true;
+      followed_jumps++;
+      pc = target;
+      is_branch_delay_slot = false;
+      is_load_delay_slot = cbi.has_load_delay;
+      continue;
+    }
 
     // if this is a branch, we grab the next instruction (delay slot), and then exit
     is_branch_delay_slot = cbi.is_branch_instruction;
@@ -752,10 +1596,46 @@ bool CompileBlock(CodeBlock* block, bool allow_flush)
       break;
   }
 
+  // the delay slot of a load is the next instruction in the list, even across double branches and followed jumps
+  for (size_t i = 1; i < instructions.size(); i++)
+  {
+    CodeBlockInstruction& load = instructions[i - 1];
+    if (CanElideLoadDelay(load.instruction, instructions[i].instruction))
+    {
+      load.is_load_delay_elided = true;
+      DecodeCachedInterpreterInstruction(&load);
+    }
+  }
+
+  block->instructions.clear();
+  block->instructions.reserve(instructions.size());
+  for (const CodeBlockInstruction& cbi : instructions)
+    block->instructions.push_back(cbi);
   if (!block->instructions.empty())
   {
     block->instructions.back().is_last_instruction = true;
 
+    const u32 address = block->key.GetPCPhysicalAddress();
+    const u32 instruction_count = static_cast<u32>(block->instructions.size());
+    block->has_instructions_hash = (block->IsInRAM() && !block->contains_double_branches &&
+                                    !block->contains_followed_jumps &&
+                                    IsValidRAMInstructionRange(address, instruction_count));
+    if (block->has_instructions_hash)
+      block->instructions_hash = HashRAMInstructions(address, instruction_count);
+
+    UpdateFollowedJumpPages(block);
+
+    block->is_idle_loop = IsIdleLoopBlock(block);
+    if (block->is_idle_loop)
+      Log_DevPrintf("Idle loop detected at 0x%08X (%u instructions)", block->GetPC(), instruction_count);
+
+    if (CPU::HasAnyBreakpoints())
+    {
+      block->contains_breakpoint =
+        std::any_of(block->instructions.begin(), block->instructions.end(),
+                    [](const CodeBlockInstruction& cbi) { return CPU::HasBreakpointAtAddress(cbi.pc); });
+    }
+
 #ifdef _DEBUG
     SmallString disasm;
     Log_DebugPrintf("Block at 0x%08X", block->GetPC());
@@ -773,38 +1653,277 @@ bool CompileBlock(CodeBlock* block, bool allow_flush)
     return false;
   }
 
-#ifdef WITH_RECOMPILER
-  if (g_settings.IsUsingRecompiler())
+  return true;
+}
+
+/// Gets the registers read/written by an instruction which is allowed in an idle loop.
+/// Anything with side effects other than register writes (stores, cop0, hi/lo, traps) isn't.
+static bool GetIdleLoopInstructionRegisters(const Instruction& inst, u32* read_mask, u32* write_mask)
+{
+  const auto bit = [](Reg reg) { return (1u << static_cast<u8>(reg)); };
+
+  switch (inst.op)
   {
-    // Ensure we're not going to run out of space while compiling this block.
-    if (s_code_buffer.GetFreeCodeSpace() <
-          (block->instructions.size() * Recompiler::MAX_NEAR_HOST_BYTES_PER_INSTRUCTION) ||
-        s_code_buffer.GetFreeFarCodeSpace() <
-          (block->instructions.size() * Recompiler::MAX_FAR_HOST_BYTES_PER_INSTRUCTION))
+    case InstructionOp::lb:
+    case InstructionOp::lbu:
+    case InstructionOp::lh:
+    case InstructionOp::lhu:
+    case InstructionOp::lw:
+    case InstructionOp::addiu:
+    case InstructionOp::slti:
+    case InstructionOp::sltiu:
+    case InstructionOp::andi:
+    case InstructionOp::ori:
+    case InstructionOp::xori:
+      *read_mask = bit(inst.i.rs);
+      *write_mask = bit(inst.i.rt);
+      return true;
+
+    case InstructionOp::lui:
+      *read_mask = 0;
+      *write_mask = bit(inst.i.rt);
+      return true;
+
+    case InstructionOp::beq:
+    case InstructionOp::bne:
+      *read_mask = bit(inst.i.rs) | bit(inst.i.rt);
+      *write_mask = 0;
+      return true;
+
+    case InstructionOp::blez:
+    case InstructionOp::bgtz:
+      *read_mask = bit(inst.i.rs);
+      *write_mask = 0;
+      return true;
+
+    case InstructionOp::b:
     {
-      if (allow_flush)
-      {
-        Log_WarningPrintf("Out of code space, flushing all blocks.");
-        Flush();
-      }
-      else
-      {
-        Log_ErrorPrintf("Out of code space and cannot flush while compiling %08X.", block->GetPC());
+      // bltzal/bgezal write ra
+      if ((static_cast<u8>(inst.i.rt.GetValue()) & u8(0x1E)) == u8(0x10))
         return false;
+
+      *read_mask = bit(inst.i.rs);
+      *write_mask = 0;
+      return true;
+    }
+
+    case InstructionOp::j:
+      *read_mask = 0;
+      *write_mask = 0;
+      return true;
+
+    case InstructionOp::funct:
+    {
+      switch (inst.r.funct)
+      {
+        case InstructionFunct::sll:
+        case InstructionFunct::srl:
+        case InstructionFunct::sra:
+          *read_mask = bit(inst.r.rt);
+          *write_mask = bit(inst.r.rd);
+          return true;
+
+        case InstructionFunct::sllv:
+        case InstructionFunct::srlv:
+        case InstructionFunct::srav:
+        case InstructionFunct::addu:
+        case InstructionFunct::subu:
+        case InstructionFunct::and_:
+        case InstructionFunct::or_:
+        case InstructionFunct::xor_:
+        case InstructionFunct::nor:
+        case InstructionFunct::slt:
+        case InstructionFunct::sltu:
+          *read_mask = bit(inst.r.rs) | bit(inst.r.rt);
+          *write_mask = bit(inst.r.rd);
+          return true;
+
+        default:
+          return false;
       }
     }
 
-    s_code_buffer.WriteProtect(false);
-    Recompiler::CodeGenerator codegen(&s_code_buffer);
-    const bool compile_result = codegen.CompileBlock(block, &block->host_code, &block->host_code_size);
-    s_code_buffer.WriteProtect(true);
+    default:
+      return false;
+  }
+}
+
+/// Only loads from RAM and the scratchpad can be polled by an idle loop. I/O registers such as the root counters can
+/// change without an event, and skipping to the next one would overshoot whatever the loop is waiting for.
+static bool IsIdleLoopLoadAddress(VirtualMemoryAddress address)
+{
+  const Segment segment = GetSegmentForAddress(address);
+  if (segment == Segment::KSEG2)
+    return false;
+
+  const PhysicalMemoryAddress paddr = VirtualAddressToPhysical(address);
+  if (segment != Segment::KSEG1 && (paddr & DCACHE_LOCATION_MASK) == DCACHE_LOCATION)
+    return true;
+
+  return Bus::IsRAMAddress(paddr);
+}
 
-    if (!compile_result)
+bool IsIdleLoopBlock(const CodeBlock* block)
+{
+  const u32 instruction_count = static_cast<u32>(block->instructions.size());
+  if (instruction_count < 2 || instruction_count > IDLE_LOOP_MAX_INSTRUCTIONS || block->contains_double_branches ||
+      block->contains_followed_jumps)
+  {
+    return false;
+  }
+
+  // must end with a direct branch back to the start of the block
+  const CodeBlockInstruction& branch = block->instructions[instruction_count - 2];
+  if (!branch.is_direct_branch_instruction || !block->instructions.back().is_branch_delay_slot ||
+      GetDirectBranchTarget(branch.instruction, branch.pc) != block->GetPC())
+  {
+    return false;
+  }
+
+  // Each iteration has to compute the same result from the same memory, i.e. no register which is written can be read
+  // before it's written, otherwise it's a counter or similar. Load delays are handled conservatively, the value is
+  // treated as not being written until after the following instruction.
+  //
+  // Load addresses have to be known when the block is compiled, so the base register must be built from lui/ori/addiu
+  // within the block. Registers which come from outside the loop could point anywhere the next time it's entered.
+  u32 live_in = 0;
+  u32 written = 0;
+  u32 pending_load = 0;
+  u32 constant_mask = 1u;
+  std::array<u32, static_cast<size_t>(Reg::count)> constant_values = {};
+  for (const CodeBlockInstruction& cbi : block->instructions)
+  {
+    const Instruction inst = cbi.instruction;
+    u32 read_mask, write_mask;
+    if (!GetIdleLoopInstructionRegisters(inst, &read_mask, &write_mask))
+      return false;
+
+    const u32 rs = static_cast<u32>(inst.i.rs.GetValue());
+    if (cbi.is_load_instruction &&
+        (!(constant_mask & (1u << rs)) || !IsIdleLoopLoadAddress(constant_values[rs] + inst.i.imm_sext32())))
     {
-      Log_ErrorPrintf("Failed to compile host code for block at 0x%08X", block->key.GetPC());
       return false;
     }
+
+    const u32 rt = static_cast<u32>(inst.i.rt.GetValue());
+    if (inst.op == InstructionOp::lui)
+    {
+      constant_values[rt] = inst.i.imm_zext32() << 16;
+      constant_mask |= (1u << rt);
+    }
+    else if ((inst.op == InstructionOp::addiu || inst.op == InstructionOp::ori) && (constant_mask & (1u << rs)))
+    {
+      constant_values[rt] = (inst.op == InstructionOp::addiu) ? (constant_values[rs] + inst.i.imm_sext32()) :
+                                                                 (constant_values[rs] | inst.i.imm_zext32());
+      constant_mask |= (1u << rt);
+    }
+    else
+    {
+      constant_mask &= ~write_mask;
+    }
+
+    // r0 stays zero, even if something tried to write it
+    constant_mask |= 1u;
+    constant_values[0] = 0;
+
+    live_in |= read_mask & ~written;
+    written |= pending_load;
+    pending_load = 0;
+    if (cbi.is_load_instruction)
+      pending_load = write_mask;
+    else
+      written |= write_mask;
+  }
+  written |= pending_load;
+
+  // r0 doesn't count
+  return ((live_in & written) & ~1u) == 0;
+}
+
+bool CanElideLoadDelay(const Instruction& load, const Instruction& next)
+{
+  // lwl/lwr in the delay slot merge with the pending value, and cop loads go through the interpreter anyway
+  switch (load.op)
+  {
+    case InstructionOp::lb:
+    case InstructionOp::lh:
+    case InstructionOp::lw:
+    case InstructionOp::lbu:
+    case InstructionOp::lhu:
+      break;
+
+    default:
+      return false;
+  }
+
+  // A non-delayed write in the delay slot replaces the loaded value either way, and an exception in it commits the
+  // load, so only reading the old value can tell the difference. A second delayed load to the same register drops
+  // the first one, leaving the old value visible for another instruction, so that can't be elided either.
+  const Reg rt = load.i.rt;
+  if (rt == Reg::zero || CanInstructionReadRegister(next, rt))
+    return false;
+
+  return !(InstructionHasLoadDelay(next) && next.i.rt == rt);
+}
+
+bool CanFollowJump(const CodeBlock* block, const CodeBlockInstruction& jump, const CodeBlockInstruction& delay_slot,
+                   u32 followed_jumps)
+{
+  // Only the recompiler benefits, and icache emulation assumes the block's lines are contiguous.
+  if (!g_settings.IsUsingRecompiler() || g_settings.cpu_recompiler_icache || !block->IsInRAM() ||
+      followed_jumps >= MAX_FOLLOWED_JUMPS_PER_BLOCK)
+  {
+    return false;
+  }
+
+  // j/jal only, the second branch of a double branch already has its delay slot somewhere else.
+  if ((jump.instruction.op != InstructionOp::j && jump.instruction.op != InstructionOp::jal) ||
+      jump.is_branch_delay_slot)
+  {
+    return false;
+  }
+
+  // Stores can truncate the block and cop0 writes can exit it, both of which need the pc after the delay slot.
+  if (delay_slot.is_store_instruction || delay_slot.instruction.op == InstructionOp::cop0 ||
+      IsExitBlockInstruction(delay_slot.instruction))
+  {
+    return false;
   }
+
+  // The target has to be in RAM, so writes to it are caught by the page map.
+  return (VirtualAddressToPhysical(GetDirectBranchTarget(jump.instruction, jump.pc)) < Bus::RAM_2MB_SIZE);
+}
+
+void UpdateFollowedJumpPages(CodeBlock* block)
+{
+  block->followed_jump_pages.clear();
+  if (!block->contains_followed_jumps)
+    return;
+
+  for (const CodeBlockInstruction& cbi : block->instructions)
+  {
+    const u32 address = VirtualAddressToPhysical(cbi.pc);
+    const u32 page_index = address / HOST_PAGE_SIZE;
+    const u64 bit = UINT64_C(1) << ((address % HOST_PAGE_SIZE) / RAM_CODE_SUBPAGE_SIZE);
+    auto iter = std::find_if(block->followed_jump_pages.begin(), block->followed_jump_pages.end(),
+                             [page_index](const std::pair<u32, u64>& it) { return (it.first == page_index); });
+    if (iter != block->followed_jump_pages.end())
+      iter->second |= bit;
+    else
+      block->followed_jump_pages.emplace_back(page_index, bit);
+  }
+}
+
+bool CompileBlock(CodeBlock* block, bool allow_flush)
+{
+  TRACE_SCOPE("CompileBlock");
+  if (!DecodeBlock(block))
+    return false;
+
+#ifdef WITH_RECOMPILER
+  // code can be loaded over the top of a compiled block, so it may have picked up a breakpoint
+  if (g_settings.IsUsingRecompiler() && (block->contains_breakpoint || !CompileBlockHostCode(block, allow_flush)))
+    return false;
 #endif
 
   return true;
@@ -812,12 +1931,232 @@ bool CompileBlock(CodeBlock* block, bool allow_flush)
 
 #ifdef WITH_RECOMPILER
 
+bool CompileBlockHostCode(CodeBlock* block, bool allow_flush)
+{
+  // Ensure we're not going to run out of space while compiling this block.
+  if (!HasCodeSpaceForBlock(s_code_buffer, block, false))
+  {
+    if (!HasCodeSpaceForBlock(s_code_buffer, block, true))
+    {
+      Log_ErrorPrintf("Block at %08X is too large for a code region.", block->GetPC());
+      return false;
+    }
+
+    if (allow_flush && s_code_buffer.GetRegionCount() > 1)
+    {
+      EvictNextCodeRegion();
+    }
+    else if (allow_flush)
+    {
+      Log_WarningPrintf("Out of code space, flushing all blocks.");
+      s_full_flush_count++;
+      Flush();
+    }
+    else
+    {
+      Log_ErrorPrintf("Out of code space and cannot flush while compiling %08X.", block->GetPC());
+      return false;
+    }
+  }
+
+  Common::Timer compile_timer;
+  s_code_buffer.WriteProtect(false);
+  Recompiler::CodeGenerator codegen(&s_code_buffer);
+  const bool compile_result = codegen.CompileBlock(block, &block->host_code, &block->host_code_size);
+  s_code_buffer.WriteProtect(true);
+  s_compile_time_ms += compile_timer.GetTimeMilliseconds();
+  s_compiled_block_count += static_cast<u32>(compile_result);
+
+  if (!compile_result)
+  {
+    Log_ErrorPrintf("Failed to compile host code for block at 0x%08X", block->key.GetPC());
+    return false;
+  }
+
+  s_compiled_instruction_count += block->instructions.size();
+  s_compiled_host_code_bytes += block->host_code_size;
+  s_compiled_far_code_bytes += codegen.GetLastFarCodeSize();
+
+  return true;
+}
+
+bool HasCodeSpaceForBlock(const JitCodeBuffer& buffer, const CodeBlock* block, bool empty_region)
+{
+  const u32 num_instructions = static_cast<u32>(block->instructions.size());
+  const u32 code_space = empty_region ? buffer.GetRegionCodeSize() : buffer.GetFreeCodeSpace();
+  const u32 far_code_space = empty_region ? buffer.GetRegionFarCodeSize() : buffer.GetFreeFarCodeSpace();
+  return (code_space >= (num_instructions * Recompiler::MAX_NEAR_HOST_BYTES_PER_INSTRUCTION) &&
+          far_code_space >= (num_instructions * Recompiler::MAX_FAR_HOST_BYTES_PER_INSTRUCTION));
+}
+
+void EvictCodeRegion(JitCodeBuffer& buffer, u32 region)
+{
+  // Blocks are keyed by their host code, so everything compiled into the region is contiguous in the map.
+  u8* const region_ptr = buffer.GetRegionCodePointer(region);
+  HostCodeMap::iterator hc_iter =
+    s_host_code_map.lower_bound(reinterpret_cast<CodeBlock::HostCodePointer>(region_ptr));
+  const HostCodeMap::iterator hc_end =
+    s_host_code_map.lower_bound(reinterpret_cast<CodeBlock::HostCodePointer>(region_ptr + buffer.GetRegionCodeSize()));
+
+  u32 num_evicted = 0;
+  while (hc_iter != hc_end)
+  {
+    CodeBlock* block = hc_iter->second;
+    hc_iter = s_host_code_map.erase(hc_iter);
+
+    const BlockMap::iterator iter = s_blocks.find(block->key.bits);
+    Assert(iter != s_blocks.end() && iter->second == block);
+    s_blocks.erase(iter);
+
+    // Blocks which are linked to this one go back to the resolver, so they'll pick up the new copy.
+    SetFastMap(block->GetPC(), FastCompileBlockFunction);
+    if (!block->invalidated)
+      RemoveBlockFromPageMap(block);
+    UnlinkBlock(block);
+
+    AddBlockToBlockCache(block);
+    FreeBlock(block);
+    num_evicted++;
+  }
+
+  s_region_eviction_count++;
+  s_evicted_block_count += num_evicted;
+  Log_DevPrintf("Evicted %u blocks from code region %u (%u evictions, %u full flushes)", num_evicted, region,
+                s_region_eviction_count, s_full_flush_count);
+}
+
+void EvictNextCodeRegion()
+{
+  const u32 region = s_code_buffer.GetNextRegion();
+  EvictCodeRegion(s_code_buffer, region);
+  s_code_buffer.SwitchToRegion(region);
+}
+
+bool IsTieredCompileEnabled()
+{
+  return (g_settings.IsUsingRecompiler() && g_settings.cpu_recompiler_tier_threshold > 0);
+}
+
+bool UseBreakpointBlocks()
+{
+  return (g_settings.IsUsingRecompiler() && CPU::HasAnyBreakpoints());
+}
+
+CodeBlock* CreateInterpretedBlock(CodeBlockKey key)
+{
+  CodeBlock* block = DecodeNewBlock(key);
+  if (!block)
+    return nullptr;
+
+  block->interpreted = true;
+  s_interpreted_block_count++;
+  return block;
+}
+
+bool RevalidateInterpretedBlock(CodeBlock* block)
+{
+  if (!BlockInstructionsMatchMemory(block))
+  {
+    // Nothing has been generated for it yet, so it can be decoded again in place.
+    // Blocks which keep changing start counting again, so they stay in the interpreter.
+    Log_DebugPrintf("Interpreted block 0x%08X changed, decoding again.", block->GetPC());
+    block->instructions.clear();
+    block->execution_count = 0;
+    if (!DecodeBlock(block))
+    {
+      s_blocks.erase(block->key.bits);
+      s_interpreted_block_count--;
+      FallbackExistingBlockToInterpreter(block);
+      return false;
+    }
+  }
+
+  block->invalidated = false;
+  AddBlockToPageMap(block);
+  return true;
+}
+
+CodeBlock* PromoteInterpretedBlock(CodeBlock* block)
+{
+  Log_DebugPrintf("Promoting block 0x%08X to the recompiler after %u executions.", block->GetPC(),
+                  block->execution_count);
+
+  block->interpreted = false;
+  s_interpreted_block_count--;
+
+#ifdef USE_ASYNC_COMPILE
+  if (s_async_compile_running)
+  {
+    QueueAsyncCompileJob(block);
+    s_promoted_block_count++;
+    return block;
+  }
+#endif
+
+  // Compiling can flush the cache, so take the block out of the lookup tables until it's done.
+  RemoveBlockFromPageMap(block);
+  s_blocks.erase(block->key.bits);
+
+  if (!CompileBlockHostCode(block, true))
+  {
+    FallbackExistingBlockToInterpreter(block);
+    return nullptr;
+  }
+
+  AddBlockToPageMap(block);
+  SetFastMap(block->GetPC(), block->host_code);
+  AddBlockToHostCodeMap(block);
+  s_blocks.emplace(block->key.bits, block);
+  s_promoted_block_count++;
+  return block;
+}
+
+void InterpretBlock(CodeBlock& block)
+{
+  // same fetch timing as the recompiled block
+  if (block.uncached_fetch_ticks > 0 || block.icache_line_count > 0)
+    CheckAndUpdateICacheTags(block.icache_line_count, block.uncached_fetch_ticks, &block.icache_generation);
+
+  if (g_settings.gpu_pgxp_enable)
+  {
+    if (g_settings.gpu_pgxp_cpu)
+      InterpretCachedBlock<PGXPMode::CPU>(block);
+    else
+      InterpretCachedBlock<PGXPMode::Memory>(block);
+  }
+  else
+  {
+    InterpretCachedBlock<PGXPMode::Disabled>(block);
+  }
+}
+
 void FastCompileBlockFunction()
 {
+#ifdef USE_ASYNC_COMPILE
+  if (s_async_compile_results_ready.load(std::memory_order_acquire))
+    PublishAsyncCompiledBlocks();
+#endif
+
   CodeBlock* block = LookupBlock(GetNextBlockKey(), true);
+
+  // blocks which couldn't be cached could have breakpoints in them too
+  if ((block && block->contains_breakpoint) || (!block && UseBreakpointBlocks()))
+  {
+    InterpretUncachedBlockWithBreakpoints();
+    return;
+  }
+
+  // promote blocks to the recompiler once they've executed enough times
+  if (block && block->interpreted && ++block->execution_count >= g_settings.cpu_recompiler_tier_threshold)
+    block = PromoteInterpretedBlock(block);
+
   if (block)
   {
-    s_single_block_asm_dispatcher(block->host_code);
+    if (block->interpreted || block->compile_pending)
+      InterpretBlock(*block);
+    else
+      s_single_block_asm_dispatcher(block->host_code);
+
     return;
   }
 
@@ -877,28 +2216,124 @@ static void InvalidateBlock(CodeBlock* block, bool allow_frame_invalidation)
     }
     else
     {
-      // don't trigger frame number based invalidation for this block (e.g. memory save states)
-      block->invalidate_frame_number = frame_number - INVALIDATE_THRESHOLD_TO_DISABLE_LINKING - 1;
+      // don't trigger frame number based invalidation for this block (e.g. memory save states)
+      block->invalidate_frame_number = frame_number - INVALIDATE_THRESHOLD_TO_DISABLE_LINKING - 1;
+    }
+  }
+
+  UnlinkBlock(block);
+
+#ifdef WITH_RECOMPILER
+  SetFastMap(block->GetPC(), FastCompileBlockFunction);
+#endif
+}
+
+void InvalidateBlocksWithPageIndex(u32 page_index)
+{
+  DebugAssert(page_index < Bus::RAM_8MB_CODE_PAGE_COUNT);
+  auto& blocks = m_ram_block_map[page_index];
+  for (CodeBlock* block : blocks)
+    InvalidateBlock(block, true);
+
+  // Block will be re-added next execution.
+  blocks.clear();
+  s_ram_code_subpage_bits[page_index] = 0;
+  Bus::ClearRAMCodePage(page_index);
+}
+
+void InvalidateBlocksInPageRange(u32 page_index, PhysicalMemoryAddress start_address, PhysicalMemoryAddress end_address)
+{
+  DebugAssert(page_index < Bus::RAM_8MB_CODE_PAGE_COUNT);
+  if ((s_ram_code_subpage_bits[page_index] & GetSubPageMask(page_index, start_address, end_address)) == 0)
+    return;
+
+  // Blocks can span multiple pages, so they have to come out of all of them, not just this one.
+  auto& blocks = m_ram_block_map[page_index];
+  for (size_t i = 0; i < blocks.size();)
+  {
+    CodeBlock* block = blocks[i];
+    if (!BlockOverlapsRange(block, start_address, end_address))
+    {
+      i++;
+      continue;
+    }
+
+    // Invalidating the whole page leaves blocks in the other pages they span, they're already dealt with.
+    if (block->invalidated)
+    {
+      blocks.erase(blocks.begin() + i);
+      UpdateSubPageBits(page_index);
+      continue;
+    }
+
+    RemoveBlockFromPageMap(block);
+    InvalidateBlock(block, true);
+  }
+
+  if (blocks.empty())
+    Bus::ClearRAMCodePage(page_index);
+}
+
+u64 GetSubPageMask(u32 page_index, PhysicalMemoryAddress start_address, PhysicalMemoryAddress end_address)
+{
+  const u32 page_start = page_index * HOST_PAGE_SIZE;
+  const u32 start = std::max<u32>(start_address, page_start) - page_start;
+  const u32 end = std::min<u32>(end_address, page_start + HOST_PAGE_SIZE) - page_start;
+  if (start >= end)
+    return 0;
+
+  const u32 first = start / RAM_CODE_SUBPAGE_SIZE;
+  const u32 count = ((end - 1) / RAM_CODE_SUBPAGE_SIZE) - first + 1;
+  return ((count == 64) ? ~UINT64_C(0) : ((UINT64_C(1) << count) - 1)) << first;
+}
+
+u64 GetBlockSubPageMask(const CodeBlock* block, u32 page_index)
+{
+  if (block->contains_double_branches)
+    return ~UINT64_C(0);
+
+  if (block->contains_followed_jumps)
+  {
+    for (const auto& it : block->followed_jump_pages)
+    {
+      if (it.first == page_index)
+        return it.second;
     }
+
+    return 0;
   }
 
-  UnlinkBlock(block);
+  const u32 block_start = block->key.GetPCPhysicalAddress();
+  return GetSubPageMask(page_index, block_start, block_start + block->GetSizeInBytes());
+}
 
-#ifdef WITH_RECOMPILER
-  SetFastMap(block->GetPC(), FastCompileBlockFunction);
-#endif
+bool BlockOverlapsRange(const CodeBlock* block, PhysicalMemoryAddress start_address,
+                        PhysicalMemoryAddress end_address)
+{
+  // The delay slot of a double branch lives at the branch target, rather than after the block, so be conservative.
+  if (block->contains_double_branches)
+    return true;
+
+  if (block->contains_followed_jumps)
+  {
+    return std::any_of(block->followed_jump_pages.begin(), block->followed_jump_pages.end(),
+                       [start_address, end_address](const std::pair<u32, u64>& it) {
+                         return ((it.second & GetSubPageMask(it.first, start_address, end_address)) != 0);
+                       });
+  }
+
+  const u32 block_start = block->key.GetPCPhysicalAddress();
+  const u32 block_end = block_start + block->GetSizeInBytes();
+  return (block_start < end_address && block_end > start_address);
 }
 
-void InvalidateBlocksWithPageIndex(u32 page_index)
+void UpdateSubPageBits(u32 page_index)
 {
-  DebugAssert(page_index < Bus::RAM_8MB_CODE_PAGE_COUNT);
-  auto& blocks = m_ram_block_map[page_index];
-  for (CodeBlock* block : blocks)
-    InvalidateBlock(block, true);
+  u64 bits = 0;
+  for (const CodeBlock* block : m_ram_block_map[page_index])
+    bits |= GetBlockSubPageMask(block, page_index);
 
-  // Block will be re-added next execution.
-  blocks.clear();
-  Bus::ClearRAMCodePage(page_index);
+  s_ram_code_subpage_bits[page_index] = bits;
 }
 
 void InvalidateAll()
@@ -913,6 +2348,7 @@ void InvalidateAll()
   Bus::ClearRAMCodePageFlags();
   for (auto& it : m_ram_block_map)
     it.clear();
+  s_ram_code_subpage_bits.fill(0);
 }
 
 void RemoveReferencesToBlock(CodeBlock* block)
@@ -942,12 +2378,24 @@ void AddBlockToPageMap(CodeBlock* block)
   if (!block->IsInRAM())
     return;
 
-  const u32 start_page = block->GetStartPageIndex();
-  const u32 end_page = block->GetEndPageIndex();
-  for (u32 page = start_page; page <= end_page; page++)
-  {
+  const auto add_page = [block](u32 page) {
     m_ram_block_map[page].push_back(block);
+    s_ram_code_subpage_bits[page] |= GetBlockSubPageMask(block, page);
     Bus::SetRAMCodePage(page);
+  };
+
+  // followed jumps can put the block's instructions in any page
+  if (block->contains_followed_jumps)
+  {
+    for (const auto& it : block->followed_jump_pages)
+      add_page(it.first);
+  }
+  else
+  {
+    const u32 start_page = block->GetStartPageIndex();
+    const u32 end_page = block->GetEndPageIndex();
+    for (u32 page = start_page; page <= end_page; page++)
+      add_page(page);
   }
 }
 
@@ -956,14 +2404,25 @@ void RemoveBlockFromPageMap(CodeBlock* block)
   if (!block->IsInRAM())
     return;
 
-  const u32 start_page = block->GetStartPageIndex();
-  const u32 end_page = block->GetEndPageIndex();
-  for (u32 page = start_page; page <= end_page; page++)
-  {
+  const auto remove_page = [block](u32 page) {
     auto& page_blocks = m_ram_block_map[page];
     auto page_block_iter = std::find(page_blocks.begin(), page_blocks.end(), block);
     Assert(page_block_iter != page_blocks.end());
     page_blocks.erase(page_block_iter);
+    UpdateSubPageBits(page);
+  };
+
+  if (block->contains_followed_jumps)
+  {
+    for (const auto& it : block->followed_jump_pages)
+      remove_page(it.first);
+  }
+  else
+  {
+    const u32 start_page = block->GetStartPageIndex();
+    const u32 end_page = block->GetEndPageIndex();
+    for (u32 page = start_page; page <= end_page; page++)
+      remove_page(page);
   }
 }
 
@@ -1049,6 +2508,463 @@ void UnlinkBlock(CodeBlock* block)
 #endif
 }
 
+bool IsBlockCacheActive()
+{
+  return !s_block_cache_path.empty();
+}
+
+u64 HashRAMInstructions(u32 physical_address, u32 instruction_count)
+{
+  const u32 offset = physical_address & Bus::g_ram_mask;
+  return XXH64(&Bus::g_ram[offset], instruction_count * sizeof(u32), 0);
+}
+
+bool IsValidRAMInstructionRange(u32 physical_address, u32 instruction_count)
+{
+  const u32 offset = physical_address & Bus::g_ram_mask;
+  return (instruction_count > 0 && (offset + instruction_count * sizeof(u32)) <= Bus::g_ram_size);
+}
+
+void AddBlocksToBlockCache()
+{
+  if (!IsBlockCacheActive())
+    return;
+
+  for (const auto& it : s_blocks)
+  {
+    if (it.second)
+      AddBlockToBlockCache(it.second);
+  }
+}
+
+void AddBlockToBlockCache(const CodeBlock* block)
+{
+  // double branches aren't contiguous in memory, so we can't hash them without the block
+  // blocks which never left the interpreter weren't hot enough to be worth compiling ahead of time
+  if (!IsBlockCacheActive() || block->invalidated || block->interpreted || !block->has_instructions_hash)
+    return;
+
+  auto iter = s_block_cache_entries.find(block->key.bits);
+  if (iter == s_block_cache_entries.end())
+  {
+    if (s_block_cache_entries.size() >= BLOCK_CACHE_MAX_ENTRIES)
+      return;
+
+    iter = s_block_cache_entries.emplace(block->key.bits, BlockCacheEntry{}).first;
+    s_block_cache_page_map[block->GetStartPageIndex()].push_back(block->key.bits);
+  }
+
+  BlockCacheEntry& entry = iter->second;
+  entry.key = block->key.bits;
+  entry.instruction_count = static_cast<u32>(block->instructions.size());
+  entry.instructions_hash = block->instructions_hash;
+}
+
+void PrecompileBlockCachePage(u32 page_index, bool user_mode)
+{
+  // Only try each page once per flush, otherwise code which is still being loaded gets hashed repeatedly.
+  if (s_block_cache_precompiled_pages[page_index])
+    return;
+  s_block_cache_precompiled_pages[page_index] = true;
+
+  u32 num_compiled = 0;
+  for (const u32 key_bits : s_block_cache_page_map[page_index])
+  {
+    CodeBlockKey key;
+    key.bits = key_bits;
+    if (key.user_mode != user_mode || s_blocks.find(key_bits) != s_blocks.end())
+      continue;
+
+    const auto iter = s_block_cache_entries.find(key_bits);
+    DebugAssert(iter != s_block_cache_entries.end());
+
+    // the game might have loaded something else here since the cache was written
+    const BlockCacheEntry& entry = iter->second;
+    const u32 address = key.GetPCPhysicalAddress();
+    if (!IsValidRAMInstructionRange(address, entry.instruction_count) ||
+        HashRAMInstructions(address, entry.instruction_count) != entry.instructions_hash)
+    {
+      continue;
+    }
+
+#ifdef WITH_RECOMPILER
+    // Precompiling should never be the reason we evict code.
+    if (s_code_buffer.GetFreeCodeSpace() < (RECOMPILER_CODE_CACHE_SIZE / RECOMPILER_CODE_REGION_COUNT / 4) ||
+        s_code_buffer.GetFreeFarCodeSpace() < (RECOMPILER_FAR_CODE_CACHE_SIZE / RECOMPILER_CODE_REGION_COUNT / 4))
+    {
+      break;
+    }
+#endif
+
+    if (CompileNewBlock(key, false))
+      num_compiled++;
+  }
+
+  if (num_compiled > 0)
+    Log_DevPrintf("Precompiled %u cached blocks in page %u", num_compiled, page_index);
+}
+
+void LoadBlockCache(const std::string_view& serial)
+{
+  SaveBlockCache();
+
+  s_block_cache_path = {};
+  s_block_cache_entries.clear();
+  s_block_cache_precompiled_pages.reset();
+  for (auto& it : s_block_cache_page_map)
+    it.clear();
+
+  if (serial.empty() || !g_settings.IsUsingRecompiler() || !g_settings.cpu_recompiler_block_cache)
+    return;
+
+  s_block_cache_path =
+    Path::Combine(EmuFolders::Cache, fmt::format("blocks_{}.cache", Path::SanitizeFileName(serial)));
+
+  std::unique_ptr<ByteStream> stream(
+    ByteStream::OpenFile(s_block_cache_path.c_str(), BYTESTREAM_OPEN_READ | BYTESTREAM_OPEN_STREAMED));
+  if (!stream)
+  {
+    Log_DevPrintf("Block cache '%s' does not exist, starting a new one.", s_block_cache_path.c_str());
+    return;
+  }
+
+  u32 signature, version, num_entries;
+  if (!stream->ReadU32(&signature) || !stream->ReadU32(&version) || !stream->ReadU32(&num_entries) ||
+      signature != BLOCK_CACHE_SIGNATURE || version != BLOCK_CACHE_VERSION || num_entries > BLOCK_CACHE_MAX_ENTRIES)
+  {
+    Log_WarningPrintf("Block cache '%s' is corrupted or version mismatch, recreating.", s_block_cache_path.c_str());
+    return;
+  }
+
+  s_block_cache_entries.reserve(num_entries);
+  for (u32 i = 0; i < num_entries; i++)
+  {
+    BlockCacheEntry entry;
+    if (!stream->ReadU32(&entry.key) || !stream->ReadU32(&entry.instruction_count) ||
+        !stream->ReadU64(&entry.instructions_hash))
+    {
+      Log_WarningPrintf("Block cache '%s' entry is corrupted, recreating.", s_block_cache_path.c_str());
+      s_block_cache_entries.clear();
+      for (auto& it : s_block_cache_page_map)
+        it.clear();
+      return;
+    }
+
+    CodeBlockKey key;
+    key.bits = entry.key;
+    const u32 page_index = key.GetPCPhysicalAddress() / HOST_PAGE_SIZE;
+    if (page_index >= Bus::RAM_8MB_CODE_PAGE_COUNT || !s_block_cache_entries.emplace(entry.key, entry).second)
+      continue;
+
+    s_block_cache_page_map[page_index].push_back(entry.key);
+  }
+
+  Log_InfoPrintf("Loaded %zu blocks from block cache '%s'.", s_block_cache_entries.size(), s_block_cache_path.c_str());
+}
+
+void SaveBlockCache()
+{
+  if (!IsBlockCacheActive())
+    return;
+
+  AddBlocksToBlockCache();
+
+  std::unique_ptr<ByteStream> stream(ByteStream::OpenFile(s_block_cache_path.c_str(),
+                                                          BYTESTREAM_OPEN_CREATE | BYTESTREAM_OPEN_WRITE |
+                                                            BYTESTREAM_OPEN_TRUNCATE | BYTESTREAM_OPEN_ATOMIC_UPDATE |
+                                                            BYTESTREAM_OPEN_STREAMED));
+  if (!stream)
+  {
+    Log_ErrorPrintf("Failed to open block cache '%s' for writing.", s_block_cache_path.c_str());
+    return;
+  }
+
+  bool result = stream->WriteU32(BLOCK_CACHE_SIGNATURE);
+  result = result && stream->WriteU32(BLOCK_CACHE_VERSION);
+  result = result && stream->WriteU32(static_cast<u32>(s_block_cache_entries.size()));
+  for (const auto& it : s_block_cache_entries)
+  {
+    const BlockCacheEntry& entry = it.second;
+    result = result && stream->WriteU32(entry.key);
+    result = result && stream->WriteU32(entry.instruction_count);
+    result = result && stream->WriteU64(entry.instructions_hash);
+  }
+
+  result = result && stream->Commit();
+  if (!result)
+  {
+    Log_ErrorPrintf("Failed to write block cache '%s'.", s_block_cache_path.c_str());
+    stream->Discard();
+    return;
+  }
+
+  Log_DevPrintf("Wrote %zu blocks to block cache '%s'.", s_block_cache_entries.size(), s_block_cache_path.c_str());
+}
+
+#ifdef USE_ASYNC_COMPILE
+
+void UpdateAsyncCompiler()
+{
+  const bool enable = g_settings.IsUsingRecompiler() && g_settings.cpu_recompiler_async_compile;
+  if (enable == s_async_compile_running)
+    return;
+
+  if (enable)
+    StartAsyncCompiler();
+  else
+    StopAsyncCompiler();
+}
+
+void StartAsyncCompiler()
+{
+  if (!s_async_code_buffer.Initialize(s_async_code_storage, sizeof(s_async_code_storage), ASYNC_FAR_CODE_CACHE_SIZE,
+                                      RECOMPILER_GUARD_SIZE, g_settings.cpu_use_large_pages))
+  {
+    Log_ErrorPrint("Failed to initialize async code space, compiling on the CPU thread.");
+    return;
+  }
+
+  if (g_settings.IsUsingFastmem() &&
+      !Common::PageFaultHandler::InstallHandler(&s_async_code_buffer, s_async_code_buffer.GetCodePointer(),
+                                                s_async_code_buffer.GetTotalSize(), GetFastmemPageFaultHandler()))
+  {
+    Log_ErrorPrint("Failed to install async code page fault handler, compiling on the CPU thread.");
+    s_async_code_buffer.Destroy();
+    return;
+  }
+
+  s_async_code_buffer.InitializeRegions(RECOMPILER_CODE_REGION_COUNT);
+  s_async_compile_paused = true;
+  s_async_compile_busy = false;
+  s_async_compile_shutdown = false;
+  if (!s_async_compile_thread.Start(AsyncCompilerThread))
+  {
+    Log_ErrorPrint("Failed to start compile thread, compiling on the CPU thread.");
+    Common::PageFaultHandler::RemoveHandler(&s_async_code_buffer);
+    s_async_code_buffer.Destroy();
+    return;
+  }
+
+  s_async_compile_running = true;
+  Log_InfoPrint("Compile thread started.");
+}
+
+void StopAsyncCompiler()
+{
+  if (!s_async_compile_running)
+    return;
+
+  {
+    std::unique_lock<std::mutex> lock(s_async_compile_mutex);
+    DebugAssert(s_async_compile_queue.empty() && s_async_compile_results.empty());
+    s_async_compile_shutdown = true;
+    s_async_compile_work_cv.notify_one();
+  }
+
+  s_async_compile_thread.Join();
+  s_async_compile_running = false;
+
+  Common::PageFaultHandler::RemoveHandler(&s_async_code_buffer);
+  s_async_code_buffer.Destroy();
+  Log_InfoPrint("Compile thread stopped.");
+}
+
+void PauseAsyncCompiler()
+{
+  if (!s_async_compile_running)
+    return;
+
+  std::unique_lock<std::mutex> lock(s_async_compile_mutex);
+  s_async_compile_paused = true;
+  s_async_compile_idle_cv.wait(lock, []() { return !s_async_compile_busy; });
+}
+
+void ResumeAsyncCompiler()
+{
+  if (!s_async_compile_running)
+    return;
+
+  std::unique_lock<std::mutex> lock(s_async_compile_mutex);
+  s_async_compile_paused = false;
+  if (!s_async_compile_queue.empty())
+    s_async_compile_work_cv.notify_one();
+}
+
+void AsyncCompilerThread()
+{
+  Threading::SetNameOfCurrentThread("CPU Compile Thread");
+  Threading::ApplyAffinityPolicy(Threading::AffinityClass::EmulationWorker);
+
+  std::unique_lock<std::mutex> lock(s_async_compile_mutex);
+  for (;;)
+  {
+    s_async_compile_work_cv.wait(lock, []() {
+      return s_async_compile_shutdown || (!s_async_compile_paused && !s_async_compile_queue.empty());
+    });
+    if (s_async_compile_shutdown)
+      break;
+
+    AsyncCompileJob job = s_async_compile_queue.front();
+    s_async_compile_queue.pop_front();
+    s_async_compile_busy = true;
+    lock.unlock();
+
+    // The CPU thread doesn't touch the block's host code or backpatch info until it's published.
+    // Blocks which wouldn't fit even after evicting a region just fail, rather than evicting forever.
+    CodeBlock* block = job.block;
+    job.out_of_space = (!HasCodeSpaceForBlock(s_async_code_buffer, block, false) &&
+                        HasCodeSpaceForBlock(s_async_code_buffer, block, true));
+    job.region = s_async_code_buffer.GetCurrentRegion();
+    job.compile_time_ms = 0.0f;
+    job.far_code_size = 0;
+    if (!job.out_of_space && HasCodeSpaceForBlock(s_async_code_buffer, block, false))
+    {
+      TRACE_SCOPE("AsyncCompileBlock");
+      Common::Timer compile_timer;
+      s_async_code_buffer.WriteProtect(false);
+      Recompiler::CodeGenerator codegen(&s_async_code_buffer);
+      codegen.SetSpeculativeRegisterSnapshot(job.regs.data(), job.cop0_sr);
+      job.result = codegen.CompileBlock(block, &block->host_code, &block->host_code_size);
+      job.far_code_size = codegen.GetLastFarCodeSize();
+      s_async_code_buffer.WriteProtect(true);
+      job.compile_time_ms = static_cast<float>(compile_timer.GetTimeMilliseconds());
+    }
+
+    lock.lock();
+    s_async_compile_busy = false;
+    s_async_compile_results.push_back(job);
+    s_async_compile_results_ready.store(true, std::memory_order_release);
+    s_async_compile_idle_cv.notify_all();
+  }
+}
+
+CodeBlock* QueueAsyncCompile(CodeBlockKey key)
+{
+  CodeBlock* block = DecodeNewBlock(key);
+  if (block)
+    QueueAsyncCompileJob(block);
+
+  return block;
+}
+
+void QueueAsyncCompileJob(CodeBlock* block)
+{
+  block->compile_pending = true;
+
+  AsyncCompileJob job;
+  job.block = block;
+  std::copy(std::begin(g_state.regs.r), std::end(g_state.regs.r), job.regs.begin());
+  job.cop0_sr = g_state.cop0_regs.sr.bits;
+  job.result = false;
+  job.out_of_space = false;
+  job.region = 0;
+  job.compile_time_ms = 0.0f;
+
+  std::unique_lock<std::mutex> lock(s_async_compile_mutex);
+  s_async_compile_queue.push_back(job);
+  if (!s_async_compile_paused)
+    s_async_compile_work_cv.notify_one();
+}
+
+bool RevalidatePendingBlock(CodeBlock* block)
+{
+  // Only the instructions can be checked, the compile thread may still be reading them.
+  if (!BlockInstructionsMatchMemory(block))
+    return false;
+
+  block->invalidated = false;
+  AddBlockToPageMap(block);
+  return true;
+}
+
+void PublishAsyncCompiledBlocks()
+{
+  std::vector<AsyncCompileJob> results;
+  {
+    std::unique_lock<std::mutex> lock(s_async_compile_mutex);
+    results.swap(s_async_compile_results);
+    s_async_compile_results_ready.store(false, std::memory_order_relaxed);
+  }
+
+  for (const AsyncCompileJob& job : results)
+  {
+    s_compile_time_ms += job.compile_time_ms;
+
+    CodeBlock* block = job.block;
+    BlockMap::iterator iter = s_blocks.find(block->key.bits);
+    if (iter == s_blocks.end() || iter->second != block)
+    {
+      // code changed while it was being compiled, and the block was replaced
+      FreeBlock(block);
+      continue;
+    }
+
+    if (job.out_of_space)
+    {
+      // Other jobs which ran out of space in the same region don't need another region freed.
+      if (job.region == s_async_code_buffer.GetCurrentRegion())
+        EvictNextAsyncCodeRegion();
+
+      QueueAsyncCompileJob(block);
+      continue;
+    }
+
+    if (!job.result)
+    {
+      Log_ErrorPrintf("Failed to compile host code for block at 0x%08X", block->GetPC());
+      if (!block->invalidated)
+        RemoveBlockFromPageMap(block);
+      s_blocks.erase(iter);
+      FallbackExistingBlockToInterpreter(block);
+      continue;
+    }
+
+    // If it was invalidated in the meantime, it'll be revalidated as usual on the next lookup.
+    s_compiled_block_count++;
+    s_compiled_instruction_count += block->instructions.size();
+    s_compiled_host_code_bytes += block->host_code_size;
+    s_compiled_far_code_bytes += job.far_code_size;
+    block->compile_pending = false;
+    AddBlockToHostCodeMap(block);
+    if (!block->invalidated)
+      SetFastMap(block->GetPC(), block->host_code);
+  }
+}
+
+void DiscardAsyncCompileJobs()
+{
+  if (!s_async_compile_running)
+    return;
+
+  std::unique_lock<std::mutex> lock(s_async_compile_mutex);
+  s_async_compile_idle_cv.wait(lock, []() { return !s_async_compile_busy; });
+
+  // Blocks which are still in the block map get freed with the rest of them.
+  const auto discard_job = [](const AsyncCompileJob& job) {
+    const BlockMap::iterator iter = s_blocks.find(job.block->key.bits);
+    if (iter == s_blocks.end() || iter->second != job.block)
+      FreeBlock(job.block);
+  };
+  std::for_each(s_async_compile_queue.begin(), s_async_compile_queue.end(), discard_job);
+  std::for_each(s_async_compile_results.begin(), s_async_compile_results.end(), discard_job);
+  s_async_compile_queue.clear();
+  s_async_compile_results.clear();
+  s_async_compile_results_ready.store(false, std::memory_order_relaxed);
+}
+
+void EvictNextAsyncCodeRegion()
+{
+  // The compile thread can't be writing code while the region is switched.
+  std::unique_lock<std::mutex> lock(s_async_compile_mutex);
+  s_async_compile_idle_cv.wait(lock, []() { return !s_async_compile_busy; });
+
+  const u32 region = s_async_code_buffer.GetNextRegion();
+  EvictCodeRegion(s_async_code_buffer, region);
+  s_async_code_buffer.SwitchToRegion(region);
+}
+
+#endif // USE_ASYNC_COMPILE
+
 #ifdef WITH_RECOMPILER
 
 void AddBlockToHostCodeMap(CodeBlock* block)
@@ -1070,26 +2986,31 @@ void RemoveBlockFromHostCodeMap(CodeBlock* block)
   s_host_code_map.erase(hc_iter);
 }
 
-bool InitializeFastmem()
+Common::PageFaultHandler::Callback GetFastmemPageFaultHandler()
 {
-  const CPUFastmemMode mode = g_settings.cpu_fastmem_mode;
-  Assert(mode != CPUFastmemMode::Disabled);
-
 #ifdef WITH_MMAP_FASTMEM
-  const auto handler = (mode == CPUFastmemMode::MMap) ? MMapPageFaultHandler : LUTPageFaultHandler;
+  return (Bus::GetFastmemMode() == CPUFastmemMode::MMap) ? MMapPageFaultHandler : LUTPageFaultHandler;
 #else
-  const auto handler = LUTPageFaultHandler;
-  Assert(mode != CPUFastmemMode::MMap);
+  Assert(Bus::GetFastmemMode() != CPUFastmemMode::MMap);
+  return LUTPageFaultHandler;
 #endif
+}
+
+bool InitializeFastmem()
+{
+  const CPUFastmemMode mode = g_settings.cpu_fastmem_mode;
+  Assert(mode != CPUFastmemMode::Disabled);
 
+  // Views are created first, since mmap fastmem can fall back to LUT if the region can't be reserved.
+  Bus::UpdateFastmemViews(mode);
   if (!Common::PageFaultHandler::InstallHandler(&s_host_code_map, s_code_buffer.GetCodePointer(),
-                                                s_code_buffer.GetTotalSize(), handler))
+                                                s_code_buffer.GetTotalSize(), GetFastmemPageFaultHandler()))
   {
     Log_ErrorPrintf("Failed to install page fault handler");
+    Bus::UpdateFastmemViews(CPUFastmemMode::Disabled);
     return false;
   }
 
-  Bus::UpdateFastmemViews(mode);
   CPU::UpdateFastmemBase();
   return true;
 }
@@ -1232,6 +3153,11 @@ void CPU::Recompiler::Thunks::ResolveBranch(CodeBlock* block, void* host_pc, voi
 
   CodeBlockKey key = GetNextBlockKey();
   CodeBlock* successor_block = LookupBlock(key, false);
+
+  // Leave the resolver in place until the successor has host code, then we can link to it.
+  if (successor_block && (successor_block->interpreted || successor_block->compile_pending))
+    return;
+
   if (!successor_block || (successor_block->invalidated && !RevalidateBlock(successor_block, false)) ||
       !block->can_link || !successor_block->can_link)
   {
@@ -8,9 +8,12 @@
 #include "util/jit_code_buffer.h"
 #include "util/page_fault_handler.h"
 #include <array>
+#include <cstdio>
 #include <map>
 #include <memory>
+#include <string_view>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 #ifdef WITH_RECOMPILER
@@ -47,6 +50,13 @@ struct CodeBlockInstruction
   Instruction instruction;
   u32 pc;
 
+  // Pre-decoded form for the cached interpreter, see DecodeCachedInterpreterInstruction().
+  u32 interpreter_imm;
+  u8 interpreter_op;
+  u8 interpreter_rs;
+  u8 interpreter_rt;
+  u8 interpreter_rd;
+
   bool is_branch_instruction : 1;
   bool is_direct_branch_instruction : 1;
   bool is_unconditional_branch_instruction : 1;
@@ -57,6 +67,12 @@ struct CodeBlockInstruction
   bool is_last_instruction : 1;
   bool has_load_delay : 1;
   bool can_trap : 1;
+
+  /// Load whose result isn't read by the following instruction, so it can be written without the load delay.
+  bool is_load_delay_elided : 1;
+
+  /// Unconditional jump whose target was decoded into the same block, following the delay slot.
+  bool is_followed_jump : 1;
 };
 
 struct CodeBlock
@@ -71,6 +87,7 @@ struct CodeBlock
     u32 host_pc_size;
   };
 
+  CodeBlock() = default;
   CodeBlock(const CodeBlockKey key_) : key(key_) {}
 
   CodeBlockKey key;
@@ -84,6 +101,9 @@ struct CodeBlock
   TickCount uncached_fetch_ticks = 0;
   u32 icache_line_count = 0;
 
+  /// Value of g_state.icache_generation when this block's lines were last checked. Updated by the block itself.
+  u32 icache_generation = 0;
+
 #ifdef WITH_RECOMPILER
   std::vector<Recompiler::LoadStoreBackpatchInfo> loadstore_backpatch_info;
 #endif
@@ -91,12 +111,37 @@ struct CodeBlock
   bool contains_loadstore_instructions = false;
   bool contains_double_branches = false;
   bool invalidated = false;
+
+  /// Jumps were followed into their targets, so the instructions aren't contiguous in memory. The RAM pages which
+  /// they live in are recorded with their subpage masks, for the page map.
+  bool contains_followed_jumps = false;
+  std::vector<std::pair<u32, u64>> followed_jump_pages;
+
   bool can_link = true;
 
+  /// Short loop back to itself which only polls memory, can skip ahead to the next event.
+  bool is_idle_loop = false;
+
+  /// Host code is still being generated on the compile thread, so the block has to be interpreted.
+  bool compile_pending = false;
+
+  /// Block hasn't executed enough times to be worth compiling yet, and runs in the interpreter.
+  bool interpreted = false;
+  u32 execution_count = 0;
+
+  /// One of the block's instructions has a breakpoint on it, so it's never compiled.
+  bool contains_breakpoint = false;
+
   u32 recompile_frame_number = 0;
   u32 recompile_count = 0;
   u32 invalidate_frame_number = 0;
 
+  /// Hash of the block's instructions in RAM, so invalidated blocks can be checked without reading every word.
+  /// Only valid when has_instructions_hash is set, double branches, followed jumps and non-RAM blocks aren't
+  /// contiguous/hashable.
+  u64 instructions_hash = 0;
+  bool has_instructions_hash = false;
+
   u32 GetPC() const { return key.GetPC(); }
   u32 GetSizeInBytes() const { return static_cast<u32>(instructions.size()) * sizeof(Instruction); }
   u32 GetStartPageIndex() const { return (key.GetPCPhysicalAddress() / HOST_PAGE_SIZE); }
@@ -128,36 +173,105 @@ using DispatcherFunction = void (*)();
 using SingleBlockDispatcherFunction = void (*)(const CodeBlock::HostCodePointer);
 
 FastMapTable* GetFastMapPointer();
+
+/// Returns the fast map entry for the specified pc, which always holds the code to dispatch to for it.
+const CodeBlock::HostCodePointer* GetFastMapSlotPointer(u32 pc);
+
 void ExecuteRecompiler();
 #endif
 
 /// Flushes the code cache, forcing all blocks to be recompiled.
 void Flush();
 
+/// Recompiled code doesn't check for breakpoints, so the blocks have to be rebuilt when they're added or removed.
+/// The cache is flushed before the next time the recompiler runs.
+void OnBreakpointsChanged();
+
 /// Changes whether the recompiler is enabled.
 void Reinitialize();
 
+/// Writes the block cache for the current game, and loads the block cache for the specified game.
+/// The block cache records which RAM blocks a game executes, so they can be compiled ahead of dispatch.
+void LoadBlockCache(const std::string_view& serial);
+
+/// Writes the block cache for the current game to disk.
+void SaveBlockCache();
+
+/// Number of blocks in each execution tier, for the performance overlay.
+struct TierStats
+{
+  u32 interpreted_blocks;
+  u32 compiled_blocks;
+  u32 promoted_blocks;
+};
+TierStats GetTierStats();
+
+/// How often the recompiler ran out of code space, for tuning the code buffer size.
+struct EvictionStats
+{
+  u32 region_evictions;
+  u32 evicted_blocks;
+  u32 full_flushes;
+};
+EvictionStats GetEvictionStats();
+
+/// Host code generation work since startup, for benchmarking. Includes blocks compiled on the compile thread.
+struct CompileStats
+{
+  u32 compiled_blocks;
+  u32 recompiled_blocks;
+  double compile_time_ms;
+  u64 compiled_instructions;
+  u64 host_code_bytes;
+  u64 far_code_bytes;
+};
+CompileStats GetCompileStats();
+
+/// Shows the compile stats, code buffer usage, and the blocks which are being recompiled most often.
+void DrawStatsWindow();
+
+/// Samples the guest PC every few thousand cycles while enabled in the debug settings, to find which blocks and
+/// functions a game spends its time in. Functions are found from the targets of jal instructions in cached blocks.
+/// Samples are cleared when the system starts.
+void UpdateProfiling();
+void ResetProfile();
+void DrawProfileWindow();
+
+/// Writes the sample counts as JSON, per function and per block, busiest first.
+void WriteProfile(std::FILE* fp);
+
 /// Invalidates all blocks which are in the range of the specified code page.
 void InvalidateBlocksWithPageIndex(u32 page_index);
 
+/// Invalidates only the blocks in the specified code page which overlap the written range [start_address, end_address).
+/// Writes to data which shares a page with code don't throw away the code.
+void InvalidateBlocksInPageRange(u32 page_index, PhysicalMemoryAddress start_address, PhysicalMemoryAddress end_address);
+
 /// Invalidates all blocks in the cache.
 void InvalidateAll();
 
+/// Fills in the pre-decoded fields of the instruction used by InterpretCachedBlock().
+void DecodeCachedInterpreterInstruction(CodeBlockInstruction* cbi);
+
 template<PGXPMode pgxp_mode>
 void InterpretCachedBlock(const CodeBlock& block);
 
 template<PGXPMode pgxp_mode>
 void InterpretUncachedBlock();
 
+/// Interprets a block, stopping at any breakpoints. Picks up at the same instruction when execution resumes.
+void InterpretUncachedBlockWithBreakpoints();
+
 /// Invalidates any code pages which overlap the specified range.
 ALWAYS_INLINE void InvalidateCodePages(PhysicalMemoryAddress address, u32 word_count)
 {
+  const u32 end_address = address + word_count * sizeof(u32);
   const u32 start_page = address / HOST_PAGE_SIZE;
-  const u32 end_page = (address + word_count * sizeof(u32) - sizeof(u32)) / HOST_PAGE_SIZE;
+  const u32 end_page = (end_address - sizeof(u32)) / HOST_PAGE_SIZE;
   for (u32 page = start_page; page <= end_page; page++)
   {
     if (Bus::m_ram_code_bits[page])
-      CPU::CodeCache::InvalidateBlocksWithPageIndex(page);
+      CPU::CodeCache::InvalidateBlocksInPageRange(page, address, end_address);
   }
 }
 
@@ -6,6 +6,7 @@
 #include "common/align.h"
 #include "common/file_system.h"
 #include "common/log.h"
+#include "common/threading.h"
 #include "cpu_core_private.h"
 #include "cpu_disasm.h"
 #include "cpu_recompiler_thunks.h"
@@ -17,12 +18,57 @@
 #include "system.h"
 #include "timing_event.h"
 #include "util/state_wrapper.h"
+#include <condition_variable>
 #include <cstdio>
+#include <deque>
+#include <mutex>
 
 Log_SetChannel(CPU::Core);
 
 namespace CPU {
 
+namespace {
+struct BinaryTraceFileHeader
+{
+  static constexpr u32 MAGIC = 0x54435344; // DSCT
+  static constexpr u32 VERSION = 1;
+
+  u32 magic;
+  u32 version;
+  u32 record_size;
+  u32 reserved;
+};
+
+struct BinaryTraceRecord
+{
+  enum : u8
+  {
+    FLAG_MEMORY_ACCESS = (1 << 0),
+    FLAG_BRANCH_DELAY_SLOT = (1 << 1),
+    FLAG_EXCEPTION = (1 << 2),
+    FLAG_LOAD_DELAY = (1 << 3),
+  };
+
+  u32 pc;
+  u32 bits;
+  u32 memory_address;
+  u32 reg_value;
+  u8 reg; // Reg::count when no register changed
+  u8 flags;
+  u16 reserved;
+};
+static_assert(sizeof(BinaryTraceRecord) == 20);
+
+struct BinaryTraceChunk
+{
+  // ~5MB, so the writer thread only wakes up every few hundred thousand instructions
+  static constexpr u32 NUM_RECORDS = 262144;
+
+  std::unique_ptr<BinaryTraceRecord[]> records;
+  u32 count;
+};
+} // namespace
+
 static void SetPC(u32 new_pc);
 static void UpdateLoadDelay();
 static void Branch(u32 target);
@@ -35,6 +81,21 @@ bool TRACE_EXECUTION = false;
 static std::FILE* s_log_file = nullptr;
 static bool s_log_file_opened = false;
 static bool s_trace_to_log = false;
+static TraceFormat s_trace_format = TraceFormat::Text;
+
+// The CPU thread fills a chunk, and hands it to the writer thread once it's full. The CPU thread waits if the writer
+// falls too far behind, rather than dropping records.
+static constexpr u32 MAX_QUEUED_BINARY_TRACE_CHUNKS = 8;
+static std::FILE* s_binary_trace_file = nullptr;
+static BinaryTraceChunk s_binary_trace_chunk = {};
+static BinaryTraceRecord* s_binary_trace_record = nullptr;
+static std::array<u32, static_cast<u32>(Reg::count)> s_binary_trace_regs = {};
+static Threading::Thread s_binary_trace_thread;
+static std::mutex s_binary_trace_mutex;
+static std::condition_variable s_binary_trace_cv;
+static std::deque<BinaryTraceChunk> s_binary_trace_queue;
+static std::vector<std::unique_ptr<BinaryTraceRecord[]>> s_binary_trace_free_chunks;
+static bool s_binary_trace_shutdown = false;
 
 static constexpr u32 INVALID_BREAKPOINT_PC = UINT32_C(0xFFFFFFFF);
 static std::vector<Breakpoint> s_breakpoints;
@@ -42,16 +103,164 @@ static u32 s_breakpoint_counter = 1;
 static u32 s_last_breakpoint_check_pc = INVALID_BREAKPOINT_PC;
 static bool s_single_step = false;
 
+/// Where InterpretUncachedBlockWithBreakpoints() stopped, the next instruction has already been fetched.
+static u32 s_breakpoint_resume_pc = INVALID_BREAKPOINT_PC;
+static bool s_breakpoint_resume_in_branch_delay_slot = false;
+
+static void OnBreakpointsChanged();
+
 bool IsTraceEnabled()
 {
   return s_trace_to_log;
 }
 
-void StartTrace()
+static void BinaryTraceThreadEntryPoint()
+{
+  Threading::SetNameOfCurrentThread("CPU Trace Writer");
+  Threading::ApplyAffinityPolicy(Threading::AffinityClass::Background);
+
+  std::unique_lock lock(s_binary_trace_mutex);
+  for (;;)
+  {
+    s_binary_trace_cv.wait(lock, []() { return (s_binary_trace_shutdown || !s_binary_trace_queue.empty()); });
+    if (s_binary_trace_queue.empty())
+      break;
+
+    BinaryTraceChunk chunk = std::move(s_binary_trace_queue.front());
+    s_binary_trace_queue.pop_front();
+    s_binary_trace_cv.notify_all();
+    lock.unlock();
+
+    if (std::fwrite(chunk.records.get(), sizeof(BinaryTraceRecord), chunk.count, s_binary_trace_file) != chunk.count)
+      Log_ErrorPrintf("Failed to write %u trace records", chunk.count);
+
+    lock.lock();
+    s_binary_trace_free_chunks.push_back(std::move(chunk.records));
+  }
+}
+
+static void SubmitBinaryTraceChunk()
+{
+  std::unique_lock lock(s_binary_trace_mutex);
+  if (s_binary_trace_chunk.count > 0)
+  {
+    s_binary_trace_cv.wait(lock, []() { return (s_binary_trace_queue.size() < MAX_QUEUED_BINARY_TRACE_CHUNKS); });
+    s_binary_trace_queue.push_back(std::move(s_binary_trace_chunk));
+    s_binary_trace_cv.notify_all();
+  }
+
+  if (!s_binary_trace_free_chunks.empty())
+  {
+    s_binary_trace_chunk.records = std::move(s_binary_trace_free_chunks.back());
+    s_binary_trace_free_chunks.pop_back();
+  }
+  else
+  {
+    s_binary_trace_chunk.records = std::make_unique<BinaryTraceRecord[]>(BinaryTraceChunk::NUM_RECORDS);
+  }
+  s_binary_trace_chunk.count = 0;
+}
+
+static bool StartBinaryTrace()
+{
+  s_binary_trace_file = FileSystem::OpenCFile("cpu_trace.bin", "wb");
+  if (!s_binary_trace_file)
+  {
+    Log_ErrorPrintf("Failed to open cpu_trace.bin");
+    return false;
+  }
+
+  const BinaryTraceFileHeader header = {BinaryTraceFileHeader::MAGIC, BinaryTraceFileHeader::VERSION,
+                                        static_cast<u32>(sizeof(BinaryTraceRecord)), 0};
+  std::fwrite(&header, sizeof(header), 1, s_binary_trace_file);
+
+  s_binary_trace_shutdown = false;
+  s_binary_trace_chunk = {};
+  SubmitBinaryTraceChunk();
+  s_binary_trace_thread.Start(BinaryTraceThreadEntryPoint);
+  return true;
+}
+
+static void StopBinaryTrace()
+{
+  SubmitBinaryTraceChunk();
+  {
+    std::unique_lock lock(s_binary_trace_mutex);
+    s_binary_trace_shutdown = true;
+    s_binary_trace_cv.notify_all();
+  }
+  s_binary_trace_thread.Join();
+
+  s_binary_trace_chunk = {};
+  s_binary_trace_free_chunks.clear();
+  std::fclose(s_binary_trace_file);
+  s_binary_trace_file = nullptr;
+}
+
+// Called before the instruction executes. The memory address has to be computed here, since the base register can
+// be overwritten by the load itself.
+static void BeginBinaryTraceRecord()
+{
+  if (s_binary_trace_chunk.count == BinaryTraceChunk::NUM_RECORDS)
+    SubmitBinaryTraceChunk();
+
+  BinaryTraceRecord* record = &s_binary_trace_chunk.records[s_binary_trace_chunk.count++];
+  const Instruction inst = g_state.current_instruction;
+  record->pc = g_state.current_instruction_pc;
+  record->bits = inst.bits;
+  record->reg = static_cast<u8>(Reg::count);
+  record->flags = g_state.current_instruction_in_branch_delay_slot ? BinaryTraceRecord::FLAG_BRANCH_DELAY_SLOT : 0;
+  record->reserved = 0;
+  record->reg_value = 0;
+
+  if (IsMemoryLoadInstruction(inst) || IsMemoryStoreInstruction(inst))
+  {
+    record->memory_address = g_state.regs.r[static_cast<u8>(inst.i.rs.GetValue())] + inst.i.imm_sext32();
+    record->flags |= BinaryTraceRecord::FLAG_MEMORY_ACCESS;
+  }
+  else
+  {
+    record->memory_address = 0;
+  }
+
+  std::memcpy(s_binary_trace_regs.data(), g_state.regs.r, sizeof(g_state.regs.r));
+  s_binary_trace_record = record;
+}
+
+static void EndBinaryTraceRecord()
+{
+  BinaryTraceRecord* record = s_binary_trace_record;
+  if (g_state.exception_raised)
+    record->flags |= BinaryTraceRecord::FLAG_EXCEPTION;
+
+  if (g_state.next_load_delay_reg != Reg::count)
+  {
+    record->reg = static_cast<u8>(g_state.next_load_delay_reg);
+    record->reg_value = g_state.next_load_delay_value;
+    record->flags |= BinaryTraceRecord::FLAG_LOAD_DELAY;
+    return;
+  }
+
+  for (u32 i = 1; i < static_cast<u32>(Reg::count); i++)
+  {
+    if (g_state.regs.r[i] != s_binary_trace_regs[i])
+    {
+      record->reg = static_cast<u8>(i);
+      record->reg_value = g_state.regs.r[i];
+      break;
+    }
+  }
+}
+
+void StartTrace(TraceFormat format /* = TraceFormat::Text */)
 {
   if (s_trace_to_log)
     return;
 
+  if (format == TraceFormat::Binary && !StartBinaryTrace())
+    return;
+
+  s_trace_format = format;
   s_trace_to_log = true;
   UpdateDebugDispatcherFlag();
 }
@@ -61,6 +270,9 @@ void StopTrace()
   if (!s_trace_to_log)
     return;
 
+  if (s_trace_format == TraceFormat::Binary)
+    StopBinaryTrace();
+
   if (s_log_file)
     std::fclose(s_log_file);
 
@@ -71,6 +283,10 @@ void StopTrace()
 
 void WriteToExecutionLog(const char* format, ...)
 {
+  // binary traces only contain instructions
+  if (s_trace_to_log && s_trace_format == TraceFormat::Binary)
+    return;
+
   if (!s_log_file_opened)
   {
     s_log_file = FileSystem::OpenCFile("cpu_log.txt", "wb");
@@ -99,6 +315,7 @@ void Initialize()
   s_breakpoints.clear();
   s_breakpoint_counter = 1;
   s_last_breakpoint_check_pc = INVALID_BREAKPOINT_PC;
+  s_breakpoint_resume_pc = INVALID_BREAKPOINT_PC;
   s_single_step = false;
 
   UpdateFastmemBase();
@@ -167,7 +384,7 @@ bool DoState(StateWrapper& sw)
   sw.Do(&g_state.next_load_delay_reg);
   sw.Do(&g_state.next_load_delay_value);
   sw.Do(&g_state.cache_control.bits);
-  sw.DoBytes(g_state.dcache.data(), g_state.dcache.size());
+  sw.DoBytes(g_state.dcache.data(), DCACHE_SIZE);
 
   if (!GTE::DoState(sw))
     return false;
@@ -181,6 +398,7 @@ bool DoState(StateWrapper& sw)
   {
     sw.Do(&g_state.icache_tags);
     sw.Do(&g_state.icache_data);
+    g_state.icache_generation++;
   }
 
   if (sw.IsReading())
@@ -614,6 +832,76 @@ static void LogInstruction(u32 bits, u32 pc, Registers* regs)
   WriteToExecutionLog("%08x: %08x %s\n", pc, bits, instr.GetCharArray());
 }
 
+bool ConvertBinaryTrace(const char* trace_filename, const char* output_filename)
+{
+  auto in_fp = FileSystem::OpenManagedCFile(trace_filename, "rb");
+  if (!in_fp)
+  {
+    Log_ErrorPrintf("Failed to open trace file '%s'", trace_filename);
+    return false;
+  }
+
+  BinaryTraceFileHeader header;
+  if (std::fread(&header, sizeof(header), 1, in_fp.get()) != 1 || header.magic != BinaryTraceFileHeader::MAGIC ||
+      header.version != BinaryTraceFileHeader::VERSION || header.record_size != sizeof(BinaryTraceRecord))
+  {
+    Log_ErrorPrintf("'%s' is not a supported trace file", trace_filename);
+    return false;
+  }
+
+  auto out_fp = FileSystem::OpenManagedCFile(output_filename, "wb");
+  if (!out_fp)
+  {
+    Log_ErrorPrintf("Failed to open output file '%s'", output_filename);
+    return false;
+  }
+
+  static constexpr u32 RECORDS_PER_READ = 65536;
+  std::unique_ptr<BinaryTraceRecord[]> records = std::make_unique<BinaryTraceRecord[]>(RECORDS_PER_READ);
+  SmallString line;
+  size_t count;
+  u64 total_records = 0;
+  while ((count = std::fread(records.get(), sizeof(BinaryTraceRecord), RECORDS_PER_READ, in_fp.get())) > 0)
+  {
+    for (size_t i = 0; i < count; i++)
+    {
+      const BinaryTraceRecord& record = records[i];
+      DisassembleInstruction(&line, record.pc, record.bits);
+
+      if (record.reg < static_cast<u8>(Reg::count) || record.flags & BinaryTraceRecord::FLAG_MEMORY_ACCESS ||
+          record.flags & BinaryTraceRecord::FLAG_EXCEPTION)
+      {
+        for (u32 j = line.GetLength(); j < 30; j++)
+          line.AppendCharacter(' ');
+        line.AppendString(";");
+        if (record.reg < static_cast<u8>(Reg::count))
+        {
+          line.AppendFormattedString(" %s%s=%08X",
+                                     (record.flags & BinaryTraceRecord::FLAG_LOAD_DELAY) ? "delayed " : "",
+                                     GetRegName(static_cast<Reg>(record.reg)), record.reg_value);
+        }
+        if (record.flags & BinaryTraceRecord::FLAG_MEMORY_ACCESS)
+          line.AppendFormattedString(" addr=%08X", record.memory_address);
+        if (record.flags & BinaryTraceRecord::FLAG_EXCEPTION)
+          line.AppendString(" exception");
+      }
+
+      std::fprintf(out_fp.get(), "%08x: %08x %s\n", record.pc, record.bits, line.GetCharArray());
+    }
+
+    total_records += count;
+  }
+
+  if (std::ferror(out_fp.get()))
+  {
+    Log_ErrorPrintf("Failed to write output file '%s'", output_filename);
+    return false;
+  }
+
+  Log_InfoPrintf("Disassembled %" PRIu64 " trace records to '%s'", total_records, output_filename);
+  return true;
+}
+
 const std::array<DebuggerRegisterListEntry, NUM_DEBUGGER_REGISTER_LIST_ENTRIES> g_debugger_register_list = {
   {{"zero", &CPU::g_state.regs.zero},
    {"at", &CPU::g_state.regs.at},
@@ -1750,7 +2038,12 @@ void DispatchInterrupt()
 
 void UpdateDebugDispatcherFlag()
 {
+  // The recompiler only interprets the blocks with breakpoints in them, instead of everything.
+#ifdef WITH_RECOMPILER
+  const bool has_any_breakpoints = !s_breakpoints.empty() && !g_settings.IsUsingRecompiler();
+#else
   const bool has_any_breakpoints = !s_breakpoints.empty();
+#endif
 
   // TODO: cop0 breakpoints
   const auto& dcic = g_state.cop0_regs.dcic;
@@ -1766,6 +2059,12 @@ void UpdateDebugDispatcherFlag()
   ForceDispatcherExit();
 }
 
+void OnBreakpointsChanged()
+{
+  UpdateDebugDispatcherFlag();
+  CodeCache::OnBreakpointsChanged();
+}
+
 void ForceDispatcherExit()
 {
   // zero the downcount so we break out and switch
@@ -1816,7 +2115,7 @@ bool AddBreakpoint(VirtualMemoryAddress address, bool auto_clear, bool enabled)
 
   Breakpoint bp{address, nullptr, auto_clear ? 0 : s_breakpoint_counter++, 0, auto_clear, enabled};
   s_breakpoints.push_back(std::move(bp));
-  UpdateDebugDispatcherFlag();
+  OnBreakpointsChanged();
 
   if (!auto_clear)
   {
@@ -1836,7 +2135,7 @@ bool AddBreakpointWithCallback(VirtualMemoryAddress address, BreakpointCallback
 
   Breakpoint bp{address, callback, 0, 0, false, true};
   s_breakpoints.push_back(std::move(bp));
-  UpdateDebugDispatcherFlag();
+  OnBreakpointsChanged();
   return true;
 }
 
@@ -1851,7 +2150,7 @@ bool RemoveBreakpoint(VirtualMemoryAddress address)
                                        address);
 
   s_breakpoints.erase(it);
-  UpdateDebugDispatcherFlag();
+  OnBreakpointsChanged();
 
   if (address == s_last_breakpoint_check_pc)
     s_last_breakpoint_check_pc = INVALID_BREAKPOINT_PC;
@@ -1864,7 +2163,8 @@ void ClearBreakpoints()
   s_breakpoints.clear();
   s_breakpoint_counter = 0;
   s_last_breakpoint_check_pc = INVALID_BREAKPOINT_PC;
-  UpdateDebugDispatcherFlag();
+  s_breakpoint_resume_pc = INVALID_BREAKPOINT_PC;
+  OnBreakpointsChanged();
 }
 
 bool AddStepOverBreakpoint()
@@ -1973,7 +2273,7 @@ ALWAYS_INLINE_RELEASE static bool BreakpointCheck()
       {
         s_breakpoints.erase(s_breakpoints.begin() + i);
         count--;
-        UpdateDebugDispatcherFlag();
+        OnBreakpointsChanged();
       }
       else
       {
@@ -1989,7 +2289,7 @@ ALWAYS_INLINE_RELEASE static bool BreakpointCheck()
         Host::ReportFormattedDebuggerMessage("Stopped execution at 0x%08X.", pc);
         s_breakpoints.erase(s_breakpoints.begin() + i);
         count--;
-        UpdateDebugDispatcherFlag();
+        OnBreakpointsChanged();
       }
       else
       {
@@ -2048,7 +2348,12 @@ static void ExecuteImpl()
       if constexpr (debug)
       {
         if (s_trace_to_log)
-          LogInstruction(g_state.current_instruction.bits, g_state.current_instruction_pc, &g_state.regs);
+        {
+          if (s_trace_format == TraceFormat::Binary)
+            BeginBinaryTraceRecord();
+          else
+            LogInstruction(g_state.current_instruction.bits, g_state.current_instruction_pc, &g_state.regs);
+        }
       }
 
 #if 0 // GTE flag test debugging
@@ -2062,6 +2367,12 @@ static void ExecuteImpl()
       // execute the instruction we previously fetched
       ExecuteInstruction<pgxp_mode, debug>();
 
+      if constexpr (debug)
+      {
+        if (s_trace_to_log && s_trace_format == TraceFormat::Binary)
+          EndBinaryTraceRecord();
+      }
+
       // next load delay
       UpdateLoadDelay();
     }
@@ -2109,6 +2420,261 @@ void SingleStep()
 
 namespace CodeCache {
 
+#if defined(__GNUC__) || defined(__clang__)
+#define CACHED_INTERPRETER_USE_COMPUTED_GOTO 1
+#endif
+
+namespace {
+/// Instructions which the cached interpreter executes from the pre-decoded form. Anything with side effects besides
+/// writing a register (loads, stores, branches, cop) goes through ExecuteInstruction().
+enum class CachedInterpreterOp : u8
+{
+  Generic,
+  Nop,
+  Sll,
+  Srl,
+  Sra,
+  Sllv,
+  Srlv,
+  Srav,
+  Addu,
+  Subu,
+  And,
+  Or,
+  Xor,
+  Nor,
+  Slt,
+  Sltu,
+  Addiu,
+  Slti,
+  Sltiu,
+  Andi,
+  Ori,
+  Xori,
+  Lui,
+  Lb,
+  Lbu,
+  Lh,
+  Lhu,
+  Lw,
+
+  Count
+};
+} // namespace
+
+void DecodeCachedInterpreterInstruction(CodeBlockInstruction* cbi)
+{
+  const Instruction inst = cbi->instruction;
+  CachedInterpreterOp op = CachedInterpreterOp::Generic;
+  u32 imm = 0;
+
+  if (inst.bits == 0)
+  {
+    op = CachedInterpreterOp::Nop;
+  }
+  else if (inst.op == InstructionOp::funct)
+  {
+    switch (inst.r.funct)
+    {
+        // clang-format off
+      case InstructionFunct::sll: op = CachedInterpreterOp::Sll; imm = inst.r.shamt; break;
+      case InstructionFunct::srl: op = CachedInterpreterOp::Srl; imm = inst.r.shamt; break;
+      case InstructionFunct::sra: op = CachedInterpreterOp::Sra; imm = inst.r.shamt; break;
+      case InstructionFunct::sllv: op = CachedInterpreterOp::Sllv; break;
+      case InstructionFunct::srlv: op = CachedInterpreterOp::Srlv; break;
+      case InstructionFunct::srav: op = CachedInterpreterOp::Srav; break;
+      case InstructionFunct::addu: op = CachedInterpreterOp::Addu; break;
+      case InstructionFunct::subu: op = CachedInterpreterOp::Subu; break;
+      case InstructionFunct::and_: op = CachedInterpreterOp::And; break;
+      case InstructionFunct::or_: op = CachedInterpreterOp::Or; break;
+      case InstructionFunct::xor_: op = CachedInterpreterOp::Xor; break;
+      case InstructionFunct::nor: op = CachedInterpreterOp::Nor; break;
+      case InstructionFunct::slt: op = CachedInterpreterOp::Slt; break;
+      case InstructionFunct::sltu: op = CachedInterpreterOp::Sltu; break;
+      default: break;
+        // clang-format on
+    }
+  }
+  else if (cbi->is_load_delay_elided)
+  {
+    // the next instruction doesn't read the loaded register, so the load doesn't have to be delayed
+    switch (inst.op)
+    {
+        // clang-format off
+      case InstructionOp::lb: op = CachedInterpreterOp::Lb; break;
+      case InstructionOp::lbu: op = CachedInterpreterOp::Lbu; break;
+      case InstructionOp::lh: op = CachedInterpreterOp::Lh; break;
+      case InstructionOp::lhu: op = CachedInterpreterOp::Lhu; break;
+      case InstructionOp::lw: op = CachedInterpreterOp::Lw; break;
+      default: break;
+        // clang-format on
+    }
+
+    imm = inst.i.imm_sext32();
+  }
+  else
+  {
+    switch (inst.op)
+    {
+        // clang-format off
+      case InstructionOp::addiu: op = CachedInterpreterOp::Addiu; imm = inst.i.imm_sext32(); break;
+      case InstructionOp::slti: op = CachedInterpreterOp::Slti; imm = inst.i.imm_sext32(); break;
+      case InstructionOp::sltiu: op = CachedInterpreterOp::Sltiu; imm = inst.i.imm_sext32(); break;
+      case InstructionOp::andi: op = CachedInterpreterOp::Andi; imm = inst.i.imm_zext32(); break;
+      case InstructionOp::ori: op = CachedInterpreterOp::Ori; imm = inst.i.imm_zext32(); break;
+      case InstructionOp::xori: op = CachedInterpreterOp::Xori; imm = inst.i.imm_zext32(); break;
+      case InstructionOp::lui: op = CachedInterpreterOp::Lui; imm = inst.i.imm_zext32() << 16; break;
+      default: break;
+        // clang-format on
+    }
+  }
+
+  cbi->interpreter_op = static_cast<u8>(op);
+  cbi->interpreter_rs = static_cast<u8>(inst.r.rs.GetValue());
+  cbi->interpreter_rt = static_cast<u8>(inst.r.rt.GetValue());
+  cbi->interpreter_rd = static_cast<u8>(inst.r.rd.GetValue());
+  cbi->interpreter_imm = imm;
+}
+
+ALWAYS_INLINE static void BeginCachedInstruction(const CodeBlockInstruction& cbi)
+{
+  g_state.pending_ticks++;
+
+  // now executing the instruction we previously fetched
+  g_state.current_instruction.bits = cbi.instruction.bits;
+  g_state.current_instruction_pc = cbi.pc;
+  g_state.current_instruction_in_branch_delay_slot = cbi.is_branch_delay_slot;
+  g_state.current_instruction_was_branch_taken = g_state.branch_was_taken;
+  g_state.branch_was_taken = false;
+  g_state.exception_raised = false;
+
+  // update pc
+  g_state.regs.pc = g_state.regs.npc;
+  g_state.regs.npc += 4;
+}
+
+/// Executes the block from the pre-decoded instructions. With computed goto, each handler jumps straight to the next
+/// instruction's handler, so there's no central switch for the host to mispredict.
+static void InterpretDecodedBlock(const CodeBlock& block)
+{
+  const CodeBlockInstruction* cbi = block.instructions.data();
+  const CodeBlockInstruction* const end = cbi + block.instructions.size();
+
+#define CI_RS() static_cast<Reg>(cbi->interpreter_rs)
+#define CI_RT() static_cast<Reg>(cbi->interpreter_rt)
+#define CI_RD() static_cast<Reg>(cbi->interpreter_rd)
+#define CI_IMM() cbi->interpreter_imm
+
+#ifdef CACHED_INTERPRETER_USE_COMPUTED_GOTO
+  static const void* const handlers[] = {
+    &&op_Generic, &&op_Nop,  &&op_Sll, &&op_Srl, &&op_Sra,  &&op_Sllv,  &&op_Srlv, &&op_Srav,
+    &&op_Addu,    &&op_Subu, &&op_And, &&op_Or,  &&op_Xor,  &&op_Nor,   &&op_Slt,  &&op_Sltu,
+    &&op_Addiu,   &&op_Slti, &&op_Sltiu, &&op_Andi, &&op_Ori, &&op_Xori, &&op_Lui,
+    &&op_Lb,      &&op_Lbu,  &&op_Lh,  &&op_Lhu, &&op_Lw,
+  };
+  static_assert(std::size(handlers) == static_cast<size_t>(CachedInterpreterOp::Count));
+
+#define CI_OP(name) op_##name:
+#define CI_DISPATCH() goto* handlers[cbi->interpreter_op]
+#else
+#define CI_OP(name) case CachedInterpreterOp::name:
+#define CI_DISPATCH() continue
+#endif
+
+#define CI_NEXT()                                                                                                      \
+  UpdateLoadDelay();                                                                                                   \
+  if (++cbi == end)                                                                                                    \
+    return;                                                                                                            \
+  BeginCachedInstruction(*cbi);                                                                                        \
+  CI_DISPATCH()
+
+  BeginCachedInstruction(*cbi);
+
+#ifdef CACHED_INTERPRETER_USE_COMPUTED_GOTO
+  CI_DISPATCH();
+#else
+  for (;;)
+  {
+    switch (static_cast<CachedInterpreterOp>(cbi->interpreter_op))
+    {
+#endif
+
+      CI_OP(Generic)
+      {
+        ExecuteInstruction<PGXPMode::Disabled, false>();
+        if (g_state.exception_raised)
+        {
+          UpdateLoadDelay();
+          return;
+        }
+        CI_NEXT();
+      }
+
+      CI_OP(Nop) { CI_NEXT(); }
+
+      // clang-format off
+      CI_OP(Sll) { WriteReg(CI_RD(), ReadReg(CI_RT()) << CI_IMM()); CI_NEXT(); }
+      CI_OP(Srl) { WriteReg(CI_RD(), ReadReg(CI_RT()) >> CI_IMM()); CI_NEXT(); }
+      CI_OP(Sra) { WriteReg(CI_RD(), static_cast<u32>(static_cast<s32>(ReadReg(CI_RT())) >> CI_IMM())); CI_NEXT(); }
+      CI_OP(Sllv) { WriteReg(CI_RD(), ReadReg(CI_RT()) << (ReadReg(CI_RS()) & UINT32_C(0x1F))); CI_NEXT(); }
+      CI_OP(Srlv) { WriteReg(CI_RD(), ReadReg(CI_RT()) >> (ReadReg(CI_RS()) & UINT32_C(0x1F))); CI_NEXT(); }
+      CI_OP(Srav) { WriteReg(CI_RD(), static_cast<u32>(static_cast<s32>(ReadReg(CI_RT())) >> (ReadReg(CI_RS()) & UINT32_C(0x1F)))); CI_NEXT(); }
+      CI_OP(Addu) { WriteReg(CI_RD(), ReadReg(CI_RS()) + ReadReg(CI_RT())); CI_NEXT(); }
+      CI_OP(Subu) { WriteReg(CI_RD(), ReadReg(CI_RS()) - ReadReg(CI_RT())); CI_NEXT(); }
+      CI_OP(And) { WriteReg(CI_RD(), ReadReg(CI_RS()) & ReadReg(CI_RT())); CI_NEXT(); }
+      CI_OP(Or) { WriteReg(CI_RD(), ReadReg(CI_RS()) | ReadReg(CI_RT())); CI_NEXT(); }
+      CI_OP(Xor) { WriteReg(CI_RD(), ReadReg(CI_RS()) ^ ReadReg(CI_RT())); CI_NEXT(); }
+      CI_OP(Nor) { WriteReg(CI_RD(), ~(ReadReg(CI_RS()) | ReadReg(CI_RT()))); CI_NEXT(); }
+      CI_OP(Slt) { WriteReg(CI_RD(), BoolToUInt32(static_cast<s32>(ReadReg(CI_RS())) < static_cast<s32>(ReadReg(CI_RT())))); CI_NEXT(); }
+      CI_OP(Sltu) { WriteReg(CI_RD(), BoolToUInt32(ReadReg(CI_RS()) < ReadReg(CI_RT()))); CI_NEXT(); }
+      CI_OP(Addiu) { WriteReg(CI_RT(), ReadReg(CI_RS()) + CI_IMM()); CI_NEXT(); }
+      CI_OP(Slti) { WriteReg(CI_RT(), BoolToUInt32(static_cast<s32>(ReadReg(CI_RS())) < static_cast<s32>(CI_IMM()))); CI_NEXT(); }
+      CI_OP(Sltiu) { WriteReg(CI_RT(), BoolToUInt32(ReadReg(CI_RS()) < CI_IMM())); CI_NEXT(); }
+      CI_OP(Andi) { WriteReg(CI_RT(), ReadReg(CI_RS()) & CI_IMM()); CI_NEXT(); }
+      CI_OP(Ori) { WriteReg(CI_RT(), ReadReg(CI_RS()) | CI_IMM()); CI_NEXT(); }
+      CI_OP(Xori) { WriteReg(CI_RT(), ReadReg(CI_RS()) ^ CI_IMM()); CI_NEXT(); }
+      CI_OP(Lui) { WriteReg(CI_RT(), CI_IMM()); CI_NEXT(); }
+        // clang-format on
+
+        // Loads with an elided delay, the value is written immediately since the next instruction doesn't read it.
+#define CI_LOAD(name, type, read_func, extend)                                                                         \
+  CI_OP(name)                                                                                                          \
+  {                                                                                                                    \
+    type value;                                                                                                        \
+    if (!read_func(ReadReg(CI_RS()) + CI_IMM(), &value))                                                               \
+    {                                                                                                                  \
+      UpdateLoadDelay();                                                                                               \
+      return;                                                                                                          \
+    }                                                                                                                  \
+    WriteReg(CI_RT(), extend(value));                                                                                  \
+    CI_NEXT();                                                                                                         \
+  }
+
+      CI_LOAD(Lb, u8, ReadMemoryByte, SignExtend32)
+      CI_LOAD(Lbu, u8, ReadMemoryByte, ZeroExtend32)
+      CI_LOAD(Lh, u16, ReadMemoryHalfWord, SignExtend32)
+      CI_LOAD(Lhu, u16, ReadMemoryHalfWord, ZeroExtend32)
+      CI_LOAD(Lw, u32, ReadMemoryWord, static_cast<u32>)
+
+#undef CI_LOAD
+
+#ifndef CACHED_INTERPRETER_USE_COMPUTED_GOTO
+      default:
+        UnreachableCode();
+        return;
+    }
+  }
+#endif
+
+#undef CI_NEXT
+#undef CI_DISPATCH
+#undef CI_OP
+#undef CI_IMM
+#undef CI_RD
+#undef CI_RT
+#undef CI_RS
+}
+
 template<PGXPMode pgxp_mode>
 void InterpretCachedBlock(const CodeBlock& block)
 {
@@ -2116,30 +2682,26 @@ void InterpretCachedBlock(const CodeBlock& block)
   DebugAssert(g_state.regs.pc == block.GetPC());
   g_state.regs.npc = block.GetPC() + 4;
 
-  for (const CodeBlockInstruction& cbi : block.instructions)
+  if constexpr (pgxp_mode == PGXPMode::Disabled)
   {
-    g_state.pending_ticks++;
-
-    // now executing the instruction we previously fetched
-    g_state.current_instruction.bits = cbi.instruction.bits;
-    g_state.current_instruction_pc = cbi.pc;
-    g_state.current_instruction_in_branch_delay_slot = cbi.is_branch_delay_slot;
-    g_state.current_instruction_was_branch_taken = g_state.branch_was_taken;
-    g_state.branch_was_taken = false;
-    g_state.exception_raised = false;
-
-    // update pc
-    g_state.regs.pc = g_state.regs.npc;
-    g_state.regs.npc += 4;
+    InterpretDecodedBlock(block);
+  }
+  else
+  {
+    // PGXP hooks the ALU instructions as well, so they all have to go through the full decode.
+    for (const CodeBlockInstruction& cbi : block.instructions)
+    {
+      BeginCachedInstruction(cbi);
 
-    // execute the instruction we previously fetched
-    ExecuteInstruction<pgxp_mode, false>();
+      // execute the instruction we previously fetched
+      ExecuteInstruction<pgxp_mode, false>();
 
-    // next load delay
-    UpdateLoadDelay();
+      // next load delay
+      UpdateLoadDelay();
 
-    if (g_state.exception_raised)
-      break;
+      if (g_state.exception_raised)
+        break;
+    }
   }
 
   // cleanup so the interpreter can kick in if needed
@@ -2150,18 +2712,37 @@ template void InterpretCachedBlock<PGXPMode::Disabled>(const CodeBlock& block);
 template void InterpretCachedBlock<PGXPMode::Memory>(const CodeBlock& block);
 template void InterpretCachedBlock<PGXPMode::CPU>(const CodeBlock& block);
 
-template<PGXPMode pgxp_mode>
-void InterpretUncachedBlock()
+template<PGXPMode pgxp_mode, bool check_breakpoints>
+static void InterpretUncachedBlockImpl()
 {
-  g_state.regs.npc = g_state.regs.pc;
-  if (!FetchInstructionForInterpreterFallback())
-    return;
+  bool in_branch_delay_slot = false;
+  if (check_breakpoints && g_state.regs.pc == s_breakpoint_resume_pc)
+  {
+    // We stopped at a breakpoint in this block, possibly in a delay slot, so the fetch has already happened.
+    in_branch_delay_slot = s_breakpoint_resume_in_branch_delay_slot;
+    s_breakpoint_resume_pc = INVALID_BREAKPOINT_PC;
+  }
+  else
+  {
+    g_state.regs.npc = g_state.regs.pc;
+    if (!FetchInstructionForInterpreterFallback())
+      return;
+  }
 
   // At this point, pc contains the last address executed (in the previous block). The instruction has not been fetched
   // yet. pc shouldn't be updated until the fetch occurs, that way the exception occurs in the delay slot.
-  bool in_branch_delay_slot = false;
   for (;;)
   {
+    if constexpr (check_breakpoints)
+    {
+      if (BreakpointCheck())
+      {
+        s_breakpoint_resume_pc = g_state.regs.pc;
+        s_breakpoint_resume_in_branch_delay_slot = in_branch_delay_slot;
+        return;
+      }
+    }
+
     g_state.pending_ticks++;
 
     // now executing the instruction we previously fetched
@@ -2199,12 +2780,37 @@ void InterpretUncachedBlock()
 
     in_branch_delay_slot = branch;
   }
+
+  // the breakpoint we resumed from can be hit again next time around
+  if constexpr (check_breakpoints)
+    s_last_breakpoint_check_pc = INVALID_BREAKPOINT_PC;
+}
+
+template<PGXPMode pgxp_mode>
+void InterpretUncachedBlock()
+{
+  InterpretUncachedBlockImpl<pgxp_mode, false>();
 }
 
 template void InterpretUncachedBlock<PGXPMode::Disabled>();
 template void InterpretUncachedBlock<PGXPMode::Memory>();
 template void InterpretUncachedBlock<PGXPMode::CPU>();
 
+void InterpretUncachedBlockWithBreakpoints()
+{
+  if (g_settings.gpu_pgxp_enable)
+  {
+    if (g_settings.gpu_pgxp_cpu)
+      InterpretUncachedBlockImpl<PGXPMode::CPU, true>();
+    else
+      InterpretUncachedBlockImpl<PGXPMode::Memory, true>();
+  }
+  else
+  {
+    InterpretUncachedBlockImpl<PGXPMode::Disabled, true>();
+  }
+}
+
 } // namespace CodeCache
 
 namespace Recompiler::Thunks {
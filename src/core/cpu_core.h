@@ -47,6 +47,23 @@ union CacheControl
   BitField<u32, bool, 11, 1> icache_enable;
 };
 
+/// Return address pushed by a recompiled jal, along with the fast map slot for it. The slot always matches the pc, so
+/// jr $ra can jump through it instead of going back to the dispatcher.
+struct ReturnAddressStackEntry
+{
+  u32 pc;
+  const void* fast_map_slot;
+};
+
+enum : u32
+{
+  RETURN_ADDRESS_STACK_SIZE = 8,
+  RAM_DIRTY_PAGE_COUNT = 0x800000 / HOST_PAGE_SIZE, // enough for 8MB RAM
+  RETURN_ADDRESS_STACK_OFFSET_MASK = (RETURN_ADDRESS_STACK_SIZE * sizeof(ReturnAddressStackEntry)) - 1,
+};
+static_assert((sizeof(ReturnAddressStackEntry) & (sizeof(ReturnAddressStackEntry) - 1)) == 0,
+              "return address stack entries are a power of two");
+
 struct State
 {
   // ticks the CPU has executed
@@ -85,11 +102,24 @@ struct State
 
   u8* fastmem_base = nullptr;
 
-  // data cache (used as scratchpad)
-  std::array<u8, DCACHE_SIZE> dcache = {};
+  // byte offset of the top entry, kept ahead of the caches so the recompiler can use small offsets
+  u32 return_address_stack_offset = 0;
+  std::array<ReturnAddressStackEntry, RETURN_ADDRESS_STACK_SIZE> return_address_stack = {};
+
+  // Bumped whenever an icache tag changes. Blocks remember the generation their lines were last checked against, and
+  // skip the per-line checks if it hasn't moved on, since none of their lines can have been evicted.
+  u32 icache_generation = 0;
+
   std::array<u32, ICACHE_LINES> icache_tags = {};
   std::array<u8, ICACHE_SIZE> icache_data = {};
 
+  // RAM pages written since the last memory save state, kept here so the recompiler can flag them relative to the
+  // state pointer. Nonzero means dirty.
+  std::array<u8, RAM_DIRTY_PAGE_COUNT> ram_dirty_pages = {};
+
+  // data cache (used as scratchpad), padded out to a whole page since the fastmem LUT maps it as one
+  std::array<u8, HOST_PAGE_SIZE> dcache = {};
+
   static constexpr u32 GPRRegisterOffset(u32 index) { return offsetof(State, regs.r) + (sizeof(u32) * index); }
   static constexpr u32 GTERegisterOffset(u32 index) { return offsetof(State, gte_regs.r32) + (sizeof(u32) * index); }
 };
@@ -165,10 +195,19 @@ void DisassembleAndPrint(u32 addr, u32 instructions_before, u32 instructions_aft
 void WriteToExecutionLog(const char* format, ...) printflike(1, 2);
 
 // Trace Routines
+enum class TraceFormat : u8
+{
+  Text,   // disassembly of each instruction, written to cpu_log.txt
+  Binary, // fixed-size records written to cpu_trace.bin on a separate thread, see ConvertBinaryTrace()
+};
+
 bool IsTraceEnabled();
-void StartTrace();
+void StartTrace(TraceFormat format = TraceFormat::Text);
 void StopTrace();
 
+// Disassembles a binary trace to a text file.
+bool ConvertBinaryTrace(const char* trace_filename, const char* output_filename);
+
 // Breakpoint callback - if the callback returns false, the breakpoint will be removed.
 using BreakpointCallback = bool (*)(VirtualMemoryAddress address);
 
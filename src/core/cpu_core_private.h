@@ -66,7 +66,7 @@ ALWAYS_INLINE bool CompareICacheTag(VirtualMemoryAddress address)
 TickCount GetInstructionReadTicks(VirtualMemoryAddress address);
 TickCount GetICacheFillTicks(VirtualMemoryAddress address);
 u32 FillICache(VirtualMemoryAddress address);
-void CheckAndUpdateICacheTags(u32 line_count, TickCount uncached_ticks);
+void CheckAndUpdateICacheTags(u32 line_count, TickCount uncached_ticks, u32* icache_generation);
 
 ALWAYS_INLINE Segment GetSegmentForAddress(VirtualMemoryAddress address)
 {
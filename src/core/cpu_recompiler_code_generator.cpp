@@ -30,6 +30,7 @@ bool CodeGenerator::CompileBlock(CodeBlock* block, CodeBlock::HostCodePointer* o
 
   m_fastmem_load_base_in_register = false;
   m_fastmem_store_base_in_register = false;
+  m_return_address_stack_exit = false;
 
   EmitBeginBlock(true);
   BlockPrologue();
@@ -52,7 +53,10 @@ bool CodeGenerator::CompileBlock(CodeBlock* block, CodeBlock::HostCodePointer* o
   if (!m_block_linked)
   {
     BlockEpilogue();
-    EmitEndBlock(true, true);
+    if (m_return_address_stack_exit)
+      EmitReturnAddressStackExit();
+    else
+      EmitEndBlock(true, true);
   }
 
   FinalizeBlock(out_host_code, out_host_code_size);
@@ -1495,7 +1499,11 @@ bool CodeGenerator::Compile_Load(const CodeBlockInstruction& cbi)
       break;
   }
 
-  m_register_cache.WriteGuestRegisterDelayed(cbi.instruction.i.rt, std::move(result));
+  // nothing reads the old value in the delay slot, so it can go straight into the register cache
+  if (cbi.is_load_delay_elided)
+    m_register_cache.WriteGuestRegister(cbi.instruction.i.rt, std::move(result));
+  else
+    m_register_cache.WriteGuestRegisterDelayed(cbi.instruction.i.rt, std::move(result));
   SpeculativeWriteReg(cbi.instruction.i.rt, value_spec);
 
   InstructionEpilogue(cbi);
@@ -1609,7 +1617,14 @@ bool CodeGenerator::Compile_Store(const CodeBlockInstruction& cbi)
       const PhysicalMemoryAddress block_start = VirtualAddressToPhysical(m_block->GetPC());
       const PhysicalMemoryAddress block_end = VirtualAddressToPhysical(
         m_block->GetPC() + static_cast<u32>(m_block->instructions.size()) * sizeof(Instruction));
-      if (phys_addr >= block_start && phys_addr < block_end)
+      const bool writes_to_block =
+        m_block->contains_followed_jumps ?
+          std::any_of(m_block_start, m_block_end,
+                      [phys_addr](const CodeBlockInstruction& it) {
+                        return (VirtualAddressToPhysical(it.pc) == (phys_addr & ~UINT32_C(3)));
+                      }) :
+          (phys_addr >= block_start && phys_addr < block_end);
+      if (writes_to_block)
       {
         Log_WarningPrintf("Instruction %08X speculatively writes to %08X inside block %08X-%08X. Truncating block.",
                           cbi.pc, phys_addr, block_start, block_end);
@@ -1863,8 +1878,7 @@ bool CodeGenerator::Compile_Add(const CodeBlockInstruction& cbi)
   // detect register moves and handle them for pgxp
   if (g_settings.gpu_pgxp_enable && rhs.HasConstantValue(0))
   {
-    EmitFunctionCall(nullptr, &PGXP::CPU_MOVE,
-                     Value::FromConstantU32((static_cast<u32>(dest) << 8) | (static_cast<u32>(lhs_src))), lhs);
+    EmitPGXPMove(dest, lhs_src, lhs);
   }
   else if (g_settings.UsingPGXPCPUMode())
   {
@@ -2287,6 +2301,10 @@ bool CodeGenerator::Compile_Branch(const CodeBlockInstruction& cbi)
 
       // now invalidate lr because it was possibly written in the branch
       m_register_cache.InvalidateGuestRegister(lr_reg);
+
+      // calls through ra are predicted for the matching jr $ra
+      if (lr_reg == Reg::ra && next_pc.IsConstant() && g_settings.cpu_recompiler_block_linking)
+        EmitPushReturnAddress(static_cast<u32>(next_pc.constant_value));
     }
 
     // we don't need to test the address of constant branches unless they're definitely misaligned, which would be
@@ -2339,6 +2357,11 @@ bool CodeGenerator::Compile_Branch(const CodeBlockInstruction& cbi)
       BlockEpilogue();
       m_block_linked = true;
 
+      // taking the branch back to the start of an idle loop skips to the next event
+      const bool is_idle_loop_branch = m_block->is_idle_loop && g_settings.cpu_idle_loop_skipping &&
+                                       branch_target.IsConstant() &&
+                                       static_cast<u32>(branch_target.constant_value) == m_block->GetPC();
+
       // check downcount
       Value pending_ticks = m_register_cache.AllocateScratch(RegSize_32);
       Value downcount = m_register_cache.AllocateScratch(RegSize_32);
@@ -2357,25 +2380,32 @@ bool CodeGenerator::Compile_Branch(const CodeBlockInstruction& cbi)
           EmitConditionalBranch(Condition::GreaterEqual, false, pending_ticks.GetHostRegister(), downcount,
                                 &return_to_dispatcher);
 
-          // we're committed at this point :D
-          EmitEndBlock(true, false);
-
-          const void* jump_pointer = GetCurrentCodePointer();
-          const void* resolve_pointer = GetCurrentFarCodePointer();
-          EmitBranch(resolve_pointer);
-          const u32 jump_size = static_cast<u32>(static_cast<const char*>(GetCurrentCodePointer()) -
-                                                 static_cast<const char*>(jump_pointer));
-          SwitchToFarCode();
-
-          EmitBeginBlock(true);
-          EmitFunctionCall(nullptr, &CPU::Recompiler::Thunks::ResolveBranch, Value::FromConstantPtr(m_block),
-                           Value::FromConstantPtr(jump_pointer), Value::FromConstantPtr(resolve_pointer),
-                           Value::FromConstantU32(jump_size));
-          EmitEndBlock(true, true);
+          if (is_idle_loop_branch)
+          {
+            EmitSkipIdleLoop(downcount, &return_to_dispatcher);
+          }
+          else
+          {
+            // we're committed at this point :D
+            EmitEndBlock(true, false);
+
+            const void* jump_pointer = GetCurrentCodePointer();
+            const void* resolve_pointer = GetCurrentFarCodePointer();
+            EmitBranch(resolve_pointer);
+            const u32 jump_size = static_cast<u32>(static_cast<const char*>(GetCurrentCodePointer()) -
+                                                   static_cast<const char*>(jump_pointer));
+            SwitchToFarCode();
+
+            EmitBeginBlock(true);
+            EmitFunctionCall(nullptr, &CPU::Recompiler::Thunks::ResolveBranch, Value::FromConstantPtr(m_block),
+                             Value::FromConstantPtr(jump_pointer), Value::FromConstantPtr(resolve_pointer),
+                             Value::FromConstantU32(jump_size));
+            EmitEndBlock(true, true);
+            SwitchToNearCode();
+          }
         }
         m_register_cache.PopState();
 
-        SwitchToNearCode();
         EmitBindLabel(&branch_not_taken);
       }
 
@@ -2393,6 +2423,9 @@ bool CodeGenerator::Compile_Branch(const CodeBlockInstruction& cbi)
       EmitConditionalBranch(Condition::GreaterEqual, false, pending_ticks.GetHostRegister(), downcount,
                             &return_to_dispatcher);
 
+      if (condition == Condition::Always && is_idle_loop_branch)
+        EmitSkipIdleLoop(downcount, &return_to_dispatcher);
+
       EmitEndBlock(true, false);
 
       const void* jump_pointer = GetCurrentCodePointer();
@@ -2449,6 +2482,31 @@ bool CodeGenerator::Compile_Branch(const CodeBlockInstruction& cbi)
       Value branch_target = OrValues(AndValues(CalculatePC(), Value::FromConstantU32(0xF0000000)),
                                      Value::FromConstantU32(cbi.instruction.j.target << 2));
 
+      // the target was decoded into the block after the delay slot, so there's nothing to branch to
+      if (cbi.is_followed_jump)
+      {
+        if (cbi.instruction.op == InstructionOp::jal)
+        {
+          EmitCancelInterpreterLoadDelayForReg(Reg::ra);
+          m_register_cache.WriteGuestRegister(Reg::ra, CalculatePC(4));
+
+          // the callee's jr $ra still exits the block, so it can be predicted
+          if (g_settings.cpu_recompiler_block_linking)
+            EmitPushReturnAddress(m_pc + 4);
+        }
+
+        DebugAssert(branch_target.IsConstant());
+        Assert((m_current_instruction + 1) != m_block_end);
+        InstructionEpilogue(cbi);
+        m_current_instruction++;
+        if (!CompileInstruction(*m_current_instruction))
+          return false;
+
+        // carry on from the target, the next instruction's prologue moves past it
+        m_pc = static_cast<u32>(branch_target.constant_value);
+        return true;
+      }
+
       return DoBranch(Condition::Always, Value(), Value(),
                       (cbi.instruction.op == InstructionOp::jal) ? Reg::ra : Reg::count, std::move(branch_target));
     }
@@ -2459,6 +2517,12 @@ bool CodeGenerator::Compile_Branch(const CodeBlockInstruction& cbi)
       {
         // npc = rs, link to rt
         Value branch_target = m_register_cache.ReadGuestRegister(cbi.instruction.r.rs);
+        if (cbi.instruction.r.funct == InstructionFunct::jr && cbi.instruction.r.rs == Reg::ra &&
+            g_settings.cpu_recompiler_block_linking)
+        {
+          m_return_address_stack_exit = true;
+        }
+
         return DoBranch(Condition::Always, Value(), Value(),
                         (cbi.instruction.r.funct == InstructionFunct::jalr) ? cbi.instruction.r.rd : Reg::count,
                         std::move(branch_target));
@@ -2553,7 +2617,7 @@ bool CodeGenerator::Compile_lui(const CodeBlockInstruction& cbi)
   InstructionPrologue(cbi, 1);
 
   if (g_settings.UsingPGXPCPUMode())
-    EmitFunctionCall(nullptr, &PGXP::CPU_LUI, Value::FromConstantU32(cbi.instruction.bits));
+    EmitPGXPLoadUpperImmediate(cbi.instruction.i.rt, static_cast<u16>(cbi.instruction.i.imm_zext32()));
 
   // rt <- (imm << 16)
   const u32 value = cbi.instruction.i.imm_zext32() << 16;
@@ -3046,8 +3110,23 @@ bool CodeGenerator::Compile_cop2(const CodeBlockInstruction& cbi)
   }
 }
 
+void CodeGenerator::SetSpeculativeRegisterSnapshot(const u32* regs, u32 cop0_sr)
+{
+  m_speculative_snapshot_regs = regs;
+  m_speculative_snapshot_cop0_sr = cop0_sr;
+}
+
 void CodeGenerator::InitSpeculativeRegs()
 {
+  if (m_speculative_snapshot_regs)
+  {
+    for (u8 i = 0; i < static_cast<u8>(Reg::count); i++)
+      m_speculative_constants.regs[i] = m_speculative_snapshot_regs[i];
+
+    m_speculative_constants.cop0_sr = m_speculative_snapshot_cop0_sr;
+    return;
+  }
+
   for (u8 i = 0; i < static_cast<u8>(Reg::count); i++)
     m_speculative_constants.regs[i] = g_state.regs.r[i];
 
@@ -3079,6 +3158,10 @@ CodeGenerator::SpeculativeValue CodeGenerator::SpeculativeReadMemory(VirtualMemo
   if (it != m_speculative_constants.memory.end())
     return it->second;
 
+  // memory can change underneath us when compiling on another thread
+  if (m_speculative_snapshot_regs)
+    return std::nullopt;
+
   u32 value;
   if ((phys_addr & DCACHE_LOCATION_MASK) == DCACHE_LOCATION)
   {
@@ -34,6 +34,13 @@ public:
 
   bool CompileBlock(CodeBlock* block, CodeBlock::HostCodePointer* out_host_code, u32* out_host_code_size);
 
+  /// Size of the far code (slow paths) emitted for the last block, which isn't included in the block's host code size.
+  ALWAYS_INLINE u32 GetLastFarCodeSize() const { return m_last_far_code_size; }
+
+  /// Uses a copy of the guest registers for speculative constants instead of the live CPU state, so blocks can be
+  /// compiled away from the CPU thread. Guest memory is not read speculatively in this mode.
+  void SetSpeculativeRegisterSnapshot(const u32* regs, u32 cop0_sr);
+
   CodeCache::DispatcherFunction CompileDispatcher();
   CodeCache::SingleBlockDispatcherFunction CompileSingleBlockDispatcher();
 
@@ -42,6 +49,19 @@ public:
   //////////////////////////////////////////////////////////////////////////
   void EmitBeginBlock(bool allocate_registers = true);
   void EmitEndBlock(bool free_registers = true, bool emit_return = true);
+
+  /// Return address prediction for jal/jr $ra. The exit jumps straight to the block for the predicted return address
+  /// if it matches the new pc and there's time left in the slice, otherwise it returns to the dispatcher.
+  void EmitPushReturnAddress(u32 return_pc);
+  void EmitReturnAddressStackExit();
+
+  /// Fast forwards to the next event when an idle loop branches back to itself.
+  void EmitSkipIdleLoop(const Value& downcount, LabelType* return_to_dispatcher);
+
+  /// Inline versions of the simple PGXP register updates, avoiding a call.
+  void EmitPGXPMove(Reg dest, Reg src, const Value& src_value);
+  void EmitPGXPLoadUpperImmediate(Reg rt, u16 imm);
+
   void EmitExceptionExit();
   void EmitExceptionExitOnBool(const Value& value);
   void FinalizeBlock(CodeBlock::HostCodePointer* out_host_code, u32* out_host_code_size);
@@ -91,7 +111,8 @@ public:
   Value EmitLoadGuestMemory(const CodeBlockInstruction& cbi, const Value& address, const SpeculativeValue& address_spec,
                             RegSize size);
   void EmitLoadGuestRAMFastmem(const Value& address, RegSize size, Value& result);
-  void EmitLoadGuestMemoryFastmem(const CodeBlockInstruction& cbi, const Value& address, RegSize size, Value& result);
+  void EmitLoadGuestMemoryFastmem(const CodeBlockInstruction& cbi, const Value& address, RegSize size, Value& result,
+                                  TickCount read_ticks);
   void EmitLoadGuestMemorySlowmem(const CodeBlockInstruction& cbi, const Value& address, RegSize size, Value& result,
                                   bool in_far_code);
   void EmitStoreGuestMemory(const CodeBlockInstruction& cbi, const Value& address, const SpeculativeValue& address_spec,
@@ -256,8 +277,10 @@ private:
   TickCount m_gte_done_cycle = 0;
 
   u32 m_pc = 0;
+  u32 m_last_far_code_size = 0;
   bool m_pc_valid = false;
   bool m_block_linked = false;
+  bool m_return_address_stack_exit = false;
 
   // whether various flags need to be reset.
   bool m_current_instruction_in_branch_delay_slot_dirty = false;
@@ -289,6 +312,8 @@ private:
   bool SpeculativeIsCacheIsolated();
 
   SpeculativeConstants m_speculative_constants;
+  const u32* m_speculative_snapshot_regs = nullptr;
+  u32 m_speculative_snapshot_cop0_sr = 0;
 };
 
 } // namespace CPU::Recompiler
@@ -80,6 +80,22 @@ static const a32::Register GetHostReg32(const Value& value)
   return a32::Register(value.host_reg);
 }
 
+static a32::MemOperand EmitFastmemAddress(a32::MacroAssembler* emit, HostReg fastmem_base, HostReg address_reg)
+{
+  if (Bus::GetFastmemMode() == CPUFastmemMode::MMap)
+  {
+    // The region only covers physical memory, since we can't reserve 4GB of address space.
+    emit->bic(GetHostReg32(RARG2), GetHostReg32(address_reg), ~PHYSICAL_MEMORY_ADDRESS_MASK);
+    return a32::MemOperand(GetHostReg32(fastmem_base), GetHostReg32(RARG2));
+  }
+
+  emit->lsr(GetHostReg32(RARG1), GetHostReg32(address_reg), 12);
+  emit->and_(GetHostReg32(RARG2), GetHostReg32(address_reg), HOST_PAGE_OFFSET_MASK);
+  emit->ldr(GetHostReg32(RARG1),
+            a32::MemOperand(GetHostReg32(fastmem_base), GetHostReg32(RARG1), a32::LSL, 2)); // pointer load
+  return a32::MemOperand(GetHostReg32(RARG1), GetHostReg32(RARG2));
+}
+
 static const a32::Register GetCPUPtrReg()
 {
   return GetHostReg32(RCPUPTR);
@@ -207,6 +223,16 @@ void CodeGenerator::EmitEndBlock(bool free_registers /* = true */, bool emit_ret
   }
 }
 
+void CodeGenerator::EmitPushReturnAddress(u32 return_pc)
+{
+  // Return address prediction isn't implemented here yet, returns always go through the dispatcher.
+}
+
+void CodeGenerator::EmitReturnAddressStackExit()
+{
+  EmitEndBlock(true, true);
+}
+
 void CodeGenerator::EmitExceptionExit()
 {
   // ensure all unflushed registers are written back
@@ -250,6 +276,7 @@ void CodeGenerator::FinalizeBlock(CodeBlock::HostCodePointer* out_host_code, u32
 
   *out_host_code = reinterpret_cast<CodeBlock::HostCodePointer>(m_code_buffer->GetFreeCodePointer());
   *out_host_code_size = static_cast<u32>(m_near_emitter.GetSizeOfCodeGenerated());
+  m_last_far_code_size = static_cast<u32>(m_far_emitter.GetSizeOfCodeGenerated());
 
   m_code_buffer->CommitCode(static_cast<u32>(m_near_emitter.GetSizeOfCodeGenerated()));
   m_code_buffer->CommitFarCode(static_cast<u32>(m_far_emitter.GetSizeOfCodeGenerated()));
@@ -1178,7 +1205,8 @@ Value CodeGenerator::GetFastmemStoreBase()
   if (!m_fastmem_store_base_in_register)
   {
     m_emit->ldr(GetHostReg32(val), a32::MemOperand(GetCPUPtrReg(), offsetof(CPU::State, fastmem_base)));
-    m_emit->add(GetHostReg32(val), GetHostReg32(val), sizeof(u32*) * Bus::FASTMEM_LUT_NUM_PAGES);
+    if (Bus::GetFastmemMode() == CPUFastmemMode::LUT)
+      m_emit->add(GetHostReg32(val), GetHostReg32(val), sizeof(u32*) * Bus::FASTMEM_LUT_NUM_PAGES);
     m_fastmem_store_base_in_register = true;
   }
 
@@ -1197,7 +1225,8 @@ void CodeGenerator::EmitUpdateFastmemBase()
   {
     Value val = Value::FromHostReg(&m_register_cache, RARG3, RegSize_32);
     m_emit->ldr(GetHostReg32(val), a32::MemOperand(GetCPUPtrReg(), offsetof(CPU::State, fastmem_base)));
-    m_emit->add(GetHostReg32(val), GetHostReg32(val), sizeof(u32*) * Bus::FASTMEM_LUT_NUM_PAGES);
+    if (Bus::GetFastmemMode() == CPUFastmemMode::LUT)
+      m_emit->add(GetHostReg32(val), GetHostReg32(val), sizeof(u32*) * Bus::FASTMEM_LUT_NUM_PAGES);
   }
 }
 
@@ -1216,23 +1245,20 @@ void CodeGenerator::EmitLoadGuestRAMFastmem(const Value& address, RegSize size,
     address_reg = address.host_reg;
   }
 
-  m_emit->lsr(GetHostReg32(RARG1), GetHostReg32(address_reg), 12);
-  m_emit->and_(GetHostReg32(RARG2), GetHostReg32(address_reg), HOST_PAGE_OFFSET_MASK);
-  m_emit->ldr(GetHostReg32(RARG1),
-              a32::MemOperand(GetHostReg32(fastmem_base), GetHostReg32(RARG1), a32::LSL, 2)); // pointer load
+  const a32::MemOperand actual_address = EmitFastmemAddress(m_emit, fastmem_base.host_reg, address_reg);
 
   switch (size)
   {
     case RegSize_8:
-      m_emit->ldrb(GetHostReg32(result.host_reg), a32::MemOperand(GetHostReg32(RARG1), GetHostReg32(RARG2)));
+      m_emit->ldrb(GetHostReg32(result.host_reg), actual_address);
       break;
 
     case RegSize_16:
-      m_emit->ldrh(GetHostReg32(result.host_reg), a32::MemOperand(GetHostReg32(RARG1), GetHostReg32(RARG2)));
+      m_emit->ldrh(GetHostReg32(result.host_reg), actual_address);
       break;
 
     case RegSize_32:
-      m_emit->ldr(GetHostReg32(result.host_reg), a32::MemOperand(GetHostReg32(RARG1), GetHostReg32(RARG2)));
+      m_emit->ldr(GetHostReg32(result.host_reg), actual_address);
       break;
 
     default:
@@ -1242,7 +1268,7 @@ void CodeGenerator::EmitLoadGuestRAMFastmem(const Value& address, RegSize size,
 }
 
 void CodeGenerator::EmitLoadGuestMemoryFastmem(const CodeBlockInstruction& cbi, const Value& address, RegSize size,
-                                               Value& result)
+                                               Value& result, TickCount read_ticks)
 {
   // fastmem
   LoadStoreBackpatchInfo bpi;
@@ -1264,10 +1290,7 @@ void CodeGenerator::EmitLoadGuestMemoryFastmem(const CodeBlockInstruction& cbi,
     address_reg = address.host_reg;
   }
 
-  m_emit->lsr(GetHostReg32(RARG1), GetHostReg32(address_reg), 12);
-  m_emit->and_(GetHostReg32(RARG2), GetHostReg32(address_reg), HOST_PAGE_OFFSET_MASK);
-  m_emit->ldr(GetHostReg32(RARG1),
-              a32::MemOperand(GetHostReg32(fastmem_base), GetHostReg32(RARG1), a32::LSL, 2)); // pointer load
+  const a32::MemOperand actual_address = EmitFastmemAddress(m_emit, fastmem_base.host_reg, address_reg);
 
   m_register_cache.InhibitAllocation();
   bpi.host_pc = GetCurrentNearCodePointer();
@@ -1275,15 +1298,15 @@ void CodeGenerator::EmitLoadGuestMemoryFastmem(const CodeBlockInstruction& cbi,
   switch (size)
   {
     case RegSize_8:
-      m_emit->ldrb(GetHostReg32(result.host_reg), a32::MemOperand(GetHostReg32(RARG1), GetHostReg32(RARG2)));
+      m_emit->ldrb(GetHostReg32(result.host_reg), actual_address);
       break;
 
     case RegSize_16:
-      m_emit->ldrh(GetHostReg32(result.host_reg), a32::MemOperand(GetHostReg32(RARG1), GetHostReg32(RARG2)));
+      m_emit->ldrh(GetHostReg32(result.host_reg), actual_address);
       break;
 
     case RegSize_32:
-      m_emit->ldr(GetHostReg32(result.host_reg), a32::MemOperand(GetHostReg32(RARG1), GetHostReg32(RARG2)));
+      m_emit->ldr(GetHostReg32(result.host_reg), actual_address);
       break;
 
     default:
@@ -1303,7 +1326,7 @@ void CodeGenerator::EmitLoadGuestMemoryFastmem(const CodeBlockInstruction& cbi,
   // we add the ticks *after* the add here, since we counted incorrectly, then correct for it below
   DebugAssert(m_delayed_cycles_add > 0);
   EmitAddCPUStructField(offsetof(State, pending_ticks), Value::FromConstantU32(static_cast<u32>(m_delayed_cycles_add)));
-  m_delayed_cycles_add += Bus::RAM_READ_TICKS;
+  m_delayed_cycles_add += read_ticks;
 
   EmitLoadGuestMemorySlowmem(cbi, address, size, result, true);
 
@@ -1423,11 +1446,7 @@ void CodeGenerator::EmitStoreGuestMemoryFastmem(const CodeBlockInstruction& cbi,
   }
 
   // TODO: if this gets backpatched, these instructions are wasted
-
-  m_emit->lsr(GetHostReg32(RARG1), GetHostReg32(address_reg), 12);
-  m_emit->and_(GetHostReg32(RARG2), GetHostReg32(address_reg), HOST_PAGE_OFFSET_MASK);
-  m_emit->ldr(GetHostReg32(RARG1),
-              a32::MemOperand(GetHostReg32(fastmem_base), GetHostReg32(RARG1), a32::LSL, 2)); // pointer load
+  const a32::MemOperand actual_address = EmitFastmemAddress(m_emit, fastmem_base.host_reg, address_reg);
 
   m_register_cache.InhibitAllocation();
   bpi.host_pc = GetCurrentNearCodePointer();
@@ -1435,15 +1454,15 @@ void CodeGenerator::EmitStoreGuestMemoryFastmem(const CodeBlockInstruction& cbi,
   switch (size)
   {
     case RegSize_8:
-      m_emit->strb(GetHostReg32(actual_value.host_reg), a32::MemOperand(GetHostReg32(RARG1), GetHostReg32(RARG2)));
+      m_emit->strb(GetHostReg32(actual_value.host_reg), actual_address);
       break;
 
     case RegSize_16:
-      m_emit->strh(GetHostReg32(actual_value.host_reg), a32::MemOperand(GetHostReg32(RARG1), GetHostReg32(RARG2)));
+      m_emit->strh(GetHostReg32(actual_value.host_reg), actual_address);
       break;
 
     case RegSize_32:
-      m_emit->str(GetHostReg32(actual_value.host_reg), a32::MemOperand(GetHostReg32(RARG1), GetHostReg32(RARG2)));
+      m_emit->str(GetHostReg32(actual_value.host_reg), actual_address);
       break;
 
     default:
@@ -1765,6 +1784,15 @@ void CodeGenerator::EmitICacheCheckAndUpdate()
     const auto& ticks_reg = a32::r0;
     const auto& current_tag_reg = a32::r1;
     const auto& existing_tag_reg = a32::r2;
+    const auto& generation_reg = a32::r3;
+
+    // skip the lines entirely if no tags have changed since the block last ran
+    a32::Label lines_valid;
+    m_emit->ldr(generation_reg, a32::MemOperand(GetCPUPtrReg(), offsetof(State, icache_generation)));
+    m_emit->Mov(current_tag_reg, reinterpret_cast<uintptr_t>(&m_block->icache_generation));
+    m_emit->ldr(existing_tag_reg, a32::MemOperand(current_tag_reg));
+    m_emit->cmp(existing_tag_reg, generation_reg);
+    m_emit->B(a32::eq, &lines_valid);
 
     VirtualMemoryAddress current_pc = m_pc & ICACHE_TAG_ADDRESS_MASK;
     m_emit->ldr(ticks_reg, a32::MemOperand(GetCPUPtrReg(), offsetof(State, pending_ticks)));
@@ -1786,6 +1814,7 @@ void CodeGenerator::EmitICacheCheckAndUpdate()
 
       m_emit->str(current_tag_reg, a32::MemOperand(GetCPUPtrReg(), offset));
       EmitAdd(0, 0, Value::FromConstantU32(static_cast<u32>(fill_ticks)), false);
+      m_emit->add(generation_reg, generation_reg, 1);
       m_emit->Bind(&cache_hit);
 
       if (i != (m_block->icache_line_count - 1))
@@ -1793,6 +1822,10 @@ void CodeGenerator::EmitICacheCheckAndUpdate()
     }
 
     m_emit->str(ticks_reg, a32::MemOperand(GetCPUPtrReg(), offsetof(State, pending_ticks)));
+    m_emit->str(generation_reg, a32::MemOperand(GetCPUPtrReg(), offsetof(State, icache_generation)));
+    m_emit->Mov(current_tag_reg, reinterpret_cast<uintptr_t>(&m_block->icache_generation));
+    m_emit->str(generation_reg, a32::MemOperand(current_tag_reg));
+    m_emit->Bind(&lines_valid);
   }
 }
 
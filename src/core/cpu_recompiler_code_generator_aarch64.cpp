@@ -244,6 +244,72 @@ void CodeGenerator::EmitEndBlock(bool free_registers /* = true */, bool emit_ret
     m_emit->Ret();
 }
 
+void CodeGenerator::EmitPushReturnAddress(u32 return_pc)
+{
+  Value offset = m_register_cache.AllocateScratch(RegSize_64);
+  Value temp = m_register_cache.AllocateScratch(RegSize_64);
+  const a64::MemOperand offset_field(GetCPUPtrReg(), offsetof(State, return_address_stack_offset));
+
+  // offset <- (offset + sizeof(entry)) & mask
+  m_emit->Ldr(GetHostReg32(offset), offset_field);
+  m_emit->Add(GetHostReg32(offset), GetHostReg32(offset), static_cast<u32>(sizeof(ReturnAddressStackEntry)));
+  m_emit->And(GetHostReg32(offset), GetHostReg32(offset), RETURN_ADDRESS_STACK_OFFSET_MASK);
+  m_emit->Str(GetHostReg32(offset), offset_field);
+
+  // entry <- { return_pc, fast_map[return_pc] }
+  m_emit->Add(GetHostReg64(offset), GetCPUPtrReg(), GetHostReg64(offset));
+  m_emit->Mov(GetHostReg32(temp), return_pc);
+  m_emit->Str(GetHostReg32(temp), a64::MemOperand(GetHostReg64(offset), offsetof(State, return_address_stack)));
+  m_emit->Mov(GetHostReg64(temp), reinterpret_cast<uintptr_t>(CodeCache::GetFastMapSlotPointer(return_pc)));
+  m_emit->Str(GetHostReg64(temp),
+              a64::MemOperand(GetHostReg64(offset), offsetof(State, return_address_stack) +
+                                                      offsetof(ReturnAddressStackEntry, fast_map_slot)));
+}
+
+void CodeGenerator::EmitReturnAddressStackExit()
+{
+  // Everything has been flushed by now, so the argument registers are free.
+  const a64::WRegister offset = a64::w0;
+  const a64::XRegister entry = a64::x1;
+  const a64::WRegister temp1 = a64::w2;
+  const a64::WRegister temp2 = a64::w3;
+  const a64::MemOperand offset_field(GetCPUPtrReg(), offsetof(State, return_address_stack_offset));
+  a64::Label return_to_dispatcher;
+
+  // pop the entry, whether or not it matches, so mispredictions don't stay on top
+  m_emit->Ldr(offset, offset_field);
+  m_emit->Add(entry, GetCPUPtrReg(), a64::XRegister(offset.GetCode()));
+  m_emit->Sub(temp1, offset, static_cast<u32>(sizeof(ReturnAddressStackEntry)));
+  m_emit->And(temp1, temp1, RETURN_ADDRESS_STACK_OFFSET_MASK);
+  m_emit->Str(temp1, offset_field);
+
+  // if (pc != entry.pc) goto return_to_dispatcher
+  m_emit->Ldr(temp1, a64::MemOperand(GetCPUPtrReg(), offsetof(State, regs.pc)));
+  m_emit->Ldr(temp2, a64::MemOperand(entry, offsetof(State, return_address_stack)));
+  m_emit->Cmp(temp1, temp2);
+  m_emit->B(a64::ne, &return_to_dispatcher);
+
+  // if (pending_ticks >= downcount) goto return_to_dispatcher
+  m_emit->Ldr(temp1, a64::MemOperand(GetCPUPtrReg(), offsetof(State, pending_ticks)));
+  m_emit->Ldr(temp2, a64::MemOperand(GetCPUPtrReg(), offsetof(State, downcount)));
+  m_emit->Cmp(temp1, temp2);
+  m_emit->B(a64::ge, &return_to_dispatcher);
+
+  // scratch <- *entry.fast_map_slot
+  m_emit->Ldr(GetHostReg64(RSCRATCH), a64::MemOperand(entry, offsetof(State, return_address_stack) +
+                                                                 offsetof(ReturnAddressStackEntry, fast_map_slot)));
+  m_emit->Ldr(GetHostReg64(RSCRATCH), a64::MemOperand(GetHostReg64(RSCRATCH)));
+
+  // same as the dispatcher calling it, except without returning first
+  m_register_cache.PushState();
+  EmitEndBlock(true, false);
+  m_emit->Br(GetHostReg64(RSCRATCH));
+  m_register_cache.PopState();
+
+  m_emit->Bind(&return_to_dispatcher);
+  EmitEndBlock(true, true);
+}
+
 void CodeGenerator::EmitExceptionExit()
 {
   // ensure all unflushed registers are written back
@@ -286,6 +352,7 @@ void CodeGenerator::FinalizeBlock(CodeBlock::HostCodePointer* out_host_code, u32
 
   *out_host_code = reinterpret_cast<CodeBlock::HostCodePointer>(m_code_buffer->GetFreeCodePointer());
   *out_host_code_size = static_cast<u32>(m_near_emitter.GetSizeOfCodeGenerated());
+  m_last_far_code_size = static_cast<u32>(m_far_emitter.GetSizeOfCodeGenerated());
 
   m_code_buffer->CommitCode(static_cast<u32>(m_near_emitter.GetSizeOfCodeGenerated()));
   m_code_buffer->CommitFarCode(static_cast<u32>(m_far_emitter.GetSizeOfCodeGenerated()));
@@ -1355,7 +1422,7 @@ void CodeGenerator::EmitLoadGuestRAMFastmem(const Value& address, RegSize size,
     address_reg = address.host_reg;
   }
 
-  if (g_settings.cpu_fastmem_mode == CPUFastmemMode::MMap)
+  if (Bus::GetFastmemMode() == CPUFastmemMode::MMap)
   {
     switch (size)
     {
@@ -1404,7 +1471,7 @@ void CodeGenerator::EmitLoadGuestRAMFastmem(const Value& address, RegSize size,
 }
 
 void CodeGenerator::EmitLoadGuestMemoryFastmem(const CodeBlockInstruction& cbi, const Value& address, RegSize size,
-                                               Value& result)
+                                               Value& result, TickCount read_ticks)
 {
   // fastmem
   LoadStoreBackpatchInfo bpi;
@@ -1426,7 +1493,7 @@ void CodeGenerator::EmitLoadGuestMemoryFastmem(const CodeBlockInstruction& cbi,
 
   m_register_cache.InhibitAllocation();
 
-  if (g_settings.cpu_fastmem_mode == CPUFastmemMode::MMap)
+  if (Bus::GetFastmemMode() == CPUFastmemMode::MMap)
   {
     bpi.host_pc = GetCurrentNearCodePointer();
 
@@ -1487,7 +1554,7 @@ void CodeGenerator::EmitLoadGuestMemoryFastmem(const CodeBlockInstruction& cbi,
   // we add the ticks *after* the add here, since we counted incorrectly, then correct for it below
   DebugAssert(m_delayed_cycles_add > 0);
   EmitAddCPUStructField(offsetof(State, pending_ticks), Value::FromConstantU32(static_cast<u32>(m_delayed_cycles_add)));
-  m_delayed_cycles_add += Bus::RAM_READ_TICKS;
+  m_delayed_cycles_add += read_ticks;
 
   EmitLoadGuestMemorySlowmem(cbi, address, size, result, true);
 
@@ -1601,7 +1668,7 @@ void CodeGenerator::EmitStoreGuestMemoryFastmem(const CodeBlockInstruction& cbi,
   }
 
   m_register_cache.InhibitAllocation();
-  if (g_settings.cpu_fastmem_mode == CPUFastmemMode::MMap)
+  if (Bus::GetFastmemMode() == CPUFastmemMode::MMap)
   {
     bpi.host_pc = GetCurrentNearCodePointer();
 
@@ -1672,6 +1739,26 @@ void CodeGenerator::EmitStoreGuestMemoryFastmem(const CodeBlockInstruction& cbi,
   EmitBranch(GetCurrentNearCodePointer(), false);
 
   SwitchToNearCode();
+
+  // flag the page for incremental memory states, this runs after the slowmem path too, but that's harmless
+  if (Bus::IsRAMDirtyTrackingEnabled())
+  {
+    m_emit->Add(GetHostReg64(RARG2), GetCPUPtrReg(), offsetof(State, ram_dirty_pages));
+    m_emit->Mov(GetHostReg32(RARG3), 1);
+    if (address.IsConstant())
+    {
+      // RSCRATCH was clobbered by the slowmem path
+      m_emit->strb(GetHostReg32(RARG3),
+                   a64::MemOperand(GetHostReg64(RARG2), Bus::GetRAMCodePageIndex(address.constant_value)));
+    }
+    else
+    {
+      m_emit->lsr(GetHostReg32(RARG1), GetHostReg32(address.host_reg), 12);
+      m_emit->and_(GetHostReg32(RARG1), GetHostReg32(RARG1), Bus::g_ram_mask >> 12);
+      m_emit->strb(GetHostReg32(RARG3), a64::MemOperand(GetHostReg64(RARG2), GetHostReg64(RARG1)));
+    }
+  }
+
   m_register_cache.UninhibitAllocation();
 
   m_block->loadstore_backpatch_info.push_back(bpi);
@@ -1953,6 +2040,16 @@ void CodeGenerator::EmitICacheCheckAndUpdate()
     const auto& ticks_reg = a64::w0;
     const auto& current_tag_reg = a64::w1;
     const auto& existing_tag_reg = a64::w2;
+    const auto& generation_reg = a64::w3;
+    const auto& block_generation_ptr_reg = a64::x4;
+
+    // skip the lines entirely if no tags have changed since the block last ran
+    a64::Label lines_valid;
+    m_emit->Ldr(generation_reg, a64::MemOperand(GetCPUPtrReg(), offsetof(State, icache_generation)));
+    m_emit->Mov(block_generation_ptr_reg, reinterpret_cast<uintptr_t>(&m_block->icache_generation));
+    m_emit->Ldr(existing_tag_reg, a64::MemOperand(block_generation_ptr_reg));
+    m_emit->Cmp(existing_tag_reg, generation_reg);
+    m_emit->B(&lines_valid, a64::eq);
 
     VirtualMemoryAddress current_pc = m_pc & ICACHE_TAG_ADDRESS_MASK;
     m_emit->Ldr(ticks_reg, a64::MemOperand(GetCPUPtrReg(), offsetof(State, pending_ticks)));
@@ -1974,6 +2071,7 @@ void CodeGenerator::EmitICacheCheckAndUpdate()
 
       m_emit->Str(current_tag_reg, a64::MemOperand(GetCPUPtrReg(), offset));
       EmitAdd(0, 0, Value::FromConstantU32(static_cast<u32>(fill_ticks)), false);
+      m_emit->Add(generation_reg, generation_reg, 1);
       m_emit->Bind(&cache_hit);
 
       if (i != (m_block->icache_line_count - 1))
@@ -1981,6 +2079,9 @@ void CodeGenerator::EmitICacheCheckAndUpdate()
     }
 
     m_emit->Str(ticks_reg, a64::MemOperand(GetCPUPtrReg(), offsetof(State, pending_ticks)));
+    m_emit->Str(generation_reg, a64::MemOperand(GetCPUPtrReg(), offsetof(State, icache_generation)));
+    m_emit->Str(generation_reg, a64::MemOperand(block_generation_ptr_reg));
+    m_emit->Bind(&lines_valid);
   }
 }
 
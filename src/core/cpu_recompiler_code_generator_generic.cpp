@@ -5,6 +5,7 @@
 #include "cpu_core.h"
 #include "cpu_core_private.h"
 #include "cpu_recompiler_code_generator.h"
+#include "pgxp.h"
 #include "settings.h"
 Log_SetChannel(Recompiler::CodeGenerator);
 
@@ -29,9 +30,59 @@ void CodeGenerator::EmitStoreInterpreterLoadDelay(Reg reg, const Value& value)
   m_load_delay_dirty = true;
 }
 
+void CodeGenerator::EmitSkipIdleLoop(const Value& downcount, LabelType* return_to_dispatcher)
+{
+  // nothing the loop reads can change until the next event, so fast forward to it
+  EmitStoreCPUStructField(offsetof(State, pending_ticks), downcount);
+  EmitBranch(return_to_dispatcher);
+}
+
+void CodeGenerator::EmitPGXPMove(Reg dest, Reg src, const Value& src_value)
+{
+  // PGXP::CPU_MOVE(): invalidate the source if it no longer matches the register, then copy it
+  u8* src_ptr = PGXP::GetCPURegisterShadow(static_cast<u32>(src));
+  u8* dest_ptr = PGXP::GetCPURegisterShadow(static_cast<u32>(dest));
+  Value value = m_register_cache.AllocateScratch(RegSize_32);
+  Value flags = m_register_cache.AllocateScratch(RegSize_32);
+
+  // flags &= ((value - 1) | INVALID_MASK), where value is (shadow != src_value)
+  EmitLoadGlobal(value.GetHostRegister(), RegSize_32, src_ptr + PGXP::SHADOW_VALUE_VALUE_OFFSET);
+  EmitLoadGlobal(flags.GetHostRegister(), RegSize_32, src_ptr + PGXP::SHADOW_VALUE_FLAGS_OFFSET);
+  EmitStoreGlobal(dest_ptr + PGXP::SHADOW_VALUE_VALUE_OFFSET, value);
+  EmitCmp(value.GetHostRegister(), src_value);
+  EmitSetConditionResult(value.GetHostRegister(), RegSize_32, Condition::NotEqual);
+  EmitSub(value.GetHostRegister(), value.GetHostRegister(), Value::FromConstantU32(1), false);
+  EmitOr(value.GetHostRegister(), value.GetHostRegister(), Value::FromConstantU32(PGXP::SHADOW_FLAGS_INVALID_MASK));
+  EmitAnd(flags.GetHostRegister(), flags.GetHostRegister(), value);
+  EmitStoreGlobal(src_ptr + PGXP::SHADOW_VALUE_FLAGS_OFFSET, flags);
+  EmitStoreGlobal(dest_ptr + PGXP::SHADOW_VALUE_FLAGS_OFFSET, flags);
+
+  for (u32 offset : {PGXP::SHADOW_VALUE_X_OFFSET, PGXP::SHADOW_VALUE_Y_OFFSET, PGXP::SHADOW_VALUE_Z_OFFSET})
+  {
+    EmitLoadGlobal(value.GetHostRegister(), RegSize_32, src_ptr + offset);
+    EmitStoreGlobal(dest_ptr + offset, value);
+  }
+}
+
+void CodeGenerator::EmitPGXPLoadUpperImmediate(Reg rt, u16 imm)
+{
+  // PGXP::CPU_LUI(): the result is known, so just store it
+  u8* ptr = PGXP::GetCPURegisterShadow(static_cast<u32>(rt));
+  const float y = static_cast<float>(static_cast<s16>(imm));
+  u32 y_bits;
+  std::memcpy(&y_bits, &y, sizeof(y_bits));
+
+  EmitStoreGlobal(ptr + PGXP::SHADOW_VALUE_X_OFFSET, Value::FromConstantU32(0));
+  EmitStoreGlobal(ptr + PGXP::SHADOW_VALUE_Y_OFFSET, Value::FromConstantU32(y_bits));
+  EmitStoreGlobal(ptr + PGXP::SHADOW_VALUE_Z_OFFSET, Value::FromConstantU32(0));
+  EmitStoreGlobal(ptr + PGXP::SHADOW_VALUE_FLAGS_OFFSET, Value::FromConstantU32(PGXP::SHADOW_FLAGS_VALID_01));
+  EmitStoreGlobal(ptr + PGXP::SHADOW_VALUE_VALUE_OFFSET, Value::FromConstantU32(static_cast<u32>(imm) << 16));
+}
+
 Value CodeGenerator::EmitLoadGuestMemory(const CodeBlockInstruction& cbi, const Value& address,
                                          const SpeculativeValue& address_spec, RegSize size)
 {
+  Thunks::DirectReadHandler io_handler = nullptr;
   if (address.IsConstant() && !SpeculativeIsCacheIsolated())
   {
     TickCount read_ticks;
@@ -58,6 +109,12 @@ Value CodeGenerator::EmitLoadGuestMemory(const CodeBlockInstruction& cbi, const
       m_delayed_cycles_add += read_ticks;
       return result;
     }
+
+    // I/O register with a known address, call the device directly instead of decoding the address at runtime.
+    io_handler = Thunks::GetDirectReadHandler(
+      static_cast<u32>(address.constant_value),
+      (size == RegSize_8) ? MemoryAccessSize::Byte :
+                            ((size == RegSize_16) ? MemoryAccessSize::HalfWord : MemoryAccessSize::Word));
   }
 
   Value result = m_register_cache.AllocateScratch(HostPointerSize);
@@ -78,9 +135,22 @@ Value CodeGenerator::EmitLoadGuestMemory(const CodeBlockInstruction& cbi, const
                       use_fastmem ? "yes" : "no");
   }
 
-  if (g_settings.IsUsingFastmem() && use_fastmem)
+  if (io_handler)
   {
-    EmitLoadGuestMemoryFastmem(cbi, address, size, result);
+    // Device handlers can't fault, so there's no exception check needed.
+    AddPendingCycles(true);
+    m_register_cache.FlushCallerSavedGuestRegisters(true, true);
+    EmitFunctionCall(&result, io_handler, address);
+  }
+  else if (g_settings.IsUsingFastmem() && use_fastmem)
+  {
+    // The LUT also maps the scratchpad and BIOS, so charge for whichever region the load is expected to hit.
+    const MemoryAccessSize access_size =
+      (size == RegSize_8) ? MemoryAccessSize::Byte :
+                            ((size == RegSize_16) ? MemoryAccessSize::HalfWord : MemoryAccessSize::Word);
+    const TickCount read_ticks =
+      address_spec ? Bus::GetFastmemReadTicks(*address_spec, access_size) : static_cast<TickCount>(Bus::RAM_READ_TICKS);
+    EmitLoadGuestMemoryFastmem(cbi, address, size, result, read_ticks);
   }
   else
   {
@@ -133,6 +203,19 @@ void CodeGenerator::EmitStoreGuestMemory(const CodeBlockInstruction& cbi, const
 
       return;
     }
+
+    // I/O register with a known address, call the device directly instead of decoding the address at runtime.
+    const Thunks::DirectWriteHandler handler = Thunks::GetDirectWriteHandler(
+      static_cast<u32>(address.constant_value),
+      (size == RegSize_8) ? MemoryAccessSize::Byte :
+                            ((size == RegSize_16) ? MemoryAccessSize::HalfWord : MemoryAccessSize::Word));
+    if (handler)
+    {
+      AddPendingCycles(true);
+      m_register_cache.FlushCallerSavedGuestRegisters(true, true);
+      EmitFunctionCall(nullptr, handler, address, value);
+      return;
+    }
   }
 
   const bool use_fastmem =
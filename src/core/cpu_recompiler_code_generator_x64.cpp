@@ -245,6 +245,62 @@ void CodeGenerator::EmitEndBlock(bool free_registers /* = true */, bool emit_ret
     m_emit->ret();
 }
 
+void CodeGenerator::EmitPushReturnAddress(u32 return_pc)
+{
+  Value offset = m_register_cache.AllocateScratch(RegSize_64);
+  Value slot = m_register_cache.AllocateScratch(RegSize_64);
+  const Xbyak::Reg32 offset32 = GetHostReg32(offset);
+  const Xbyak::Reg64 offset64 = GetHostReg64(offset);
+
+  // offset <- (offset + sizeof(entry)) & mask
+  m_emit->mov(offset32, m_emit->dword[GetCPUPtrReg() + offsetof(State, return_address_stack_offset)]);
+  m_emit->add(offset32, static_cast<u32>(sizeof(ReturnAddressStackEntry)));
+  m_emit->and_(offset32, RETURN_ADDRESS_STACK_OFFSET_MASK);
+  m_emit->mov(m_emit->dword[GetCPUPtrReg() + offsetof(State, return_address_stack_offset)], offset32);
+
+  // entry <- { return_pc, fast_map[return_pc] }
+  m_emit->mov(m_emit->dword[GetCPUPtrReg() + offset64 + offsetof(State, return_address_stack)], return_pc);
+  m_emit->mov(GetHostReg64(slot), reinterpret_cast<size_t>(CodeCache::GetFastMapSlotPointer(return_pc)));
+  m_emit->mov(m_emit->qword[GetCPUPtrReg() + offset64 + offsetof(State, return_address_stack) +
+                            offsetof(ReturnAddressStackEntry, fast_map_slot)],
+              GetHostReg64(slot));
+}
+
+void CodeGenerator::EmitReturnAddressStackExit()
+{
+  // Everything has been flushed by now, so the caller-saved registers are free.
+  Xbyak::Label return_to_dispatcher;
+
+  // pop the entry, whether or not it matches, so mispredictions don't stay on top
+  m_emit->mov(m_emit->eax, m_emit->dword[GetCPUPtrReg() + offsetof(State, return_address_stack_offset)]);
+  m_emit->lea(m_emit->edx, m_emit->dword[m_emit->rax - static_cast<s32>(sizeof(ReturnAddressStackEntry))]);
+  m_emit->and_(m_emit->edx, RETURN_ADDRESS_STACK_OFFSET_MASK);
+  m_emit->mov(m_emit->dword[GetCPUPtrReg() + offsetof(State, return_address_stack_offset)], m_emit->edx);
+
+  // if (pc != entry.pc) goto return_to_dispatcher
+  m_emit->mov(m_emit->ecx, m_emit->dword[GetCPUPtrReg() + offsetof(State, regs.pc)]);
+  m_emit->cmp(m_emit->ecx, m_emit->dword[GetCPUPtrReg() + m_emit->rax + offsetof(State, return_address_stack)]);
+  m_emit->jne(return_to_dispatcher);
+
+  // if (pending_ticks >= downcount) goto return_to_dispatcher
+  m_emit->mov(m_emit->ecx, m_emit->dword[GetCPUPtrReg() + offsetof(State, pending_ticks)]);
+  m_emit->cmp(m_emit->ecx, m_emit->dword[GetCPUPtrReg() + offsetof(State, downcount)]);
+  m_emit->jge(return_to_dispatcher);
+
+  // rcx <- entry.fast_map_slot
+  m_emit->mov(m_emit->rcx, m_emit->qword[GetCPUPtrReg() + m_emit->rax + offsetof(State, return_address_stack) +
+                                         offsetof(ReturnAddressStackEntry, fast_map_slot)]);
+
+  // same as the dispatcher calling it, except without returning first
+  m_register_cache.PushState();
+  EmitEndBlock(true, false);
+  m_emit->jmp(m_emit->qword[m_emit->rcx]);
+  m_register_cache.PopState();
+
+  m_emit->L(return_to_dispatcher);
+  EmitEndBlock(true, true);
+}
+
 void CodeGenerator::EmitExceptionExit()
 {
   AddPendingCycles(false);
@@ -285,6 +341,7 @@ void CodeGenerator::FinalizeBlock(CodeBlock::HostCodePointer* out_host_code, u32
   const u32 far_size = static_cast<u32>(m_far_emitter.getSize());
   *out_host_code = m_near_emitter.getCode<CodeBlock::HostCodePointer>();
   *out_host_code_size = near_size;
+  m_last_far_code_size = far_size;
   m_code_buffer->CommitCode(near_size);
   m_code_buffer->CommitFarCode(far_size);
 
@@ -1781,7 +1838,7 @@ void CodeGenerator::EmitAddCPUStructField(u32 offset, const Value& value)
 
 void CodeGenerator::EmitLoadGuestRAMFastmem(const Value& address, RegSize size, Value& result)
 {
-  if (g_settings.cpu_fastmem_mode == CPUFastmemMode::MMap)
+  if (Bus::GetFastmemMode() == CPUFastmemMode::MMap)
   {
     // can't store displacements > 0x80000000 in-line
     const Value* actual_address = &address;
@@ -1867,7 +1924,7 @@ void CodeGenerator::EmitLoadGuestRAMFastmem(const Value& address, RegSize size,
 }
 
 void CodeGenerator::EmitLoadGuestMemoryFastmem(const CodeBlockInstruction& cbi, const Value& address, RegSize size,
-                                               Value& result)
+                                               Value& result, TickCount read_ticks)
 {
   // fastmem
   LoadStoreBackpatchInfo bpi;
@@ -1877,7 +1934,7 @@ void CodeGenerator::EmitLoadGuestMemoryFastmem(const CodeBlockInstruction& cbi,
   bpi.guest_pc = m_current_instruction->pc;
   bpi.fault_count = 0;
 
-  if (g_settings.cpu_fastmem_mode == CPUFastmemMode::MMap)
+  if (Bus::GetFastmemMode() == CPUFastmemMode::MMap)
   {
     // can't store displacements > 0x80000000 in-line
     const Value* actual_address = &address;
@@ -1984,7 +2041,7 @@ void CodeGenerator::EmitLoadGuestMemoryFastmem(const CodeBlockInstruction& cbi,
   // we add the ticks *after* the add here, since we counted incorrectly, then correct for it below
   DebugAssert(m_delayed_cycles_add > 0);
   EmitAddCPUStructField(offsetof(State, pending_ticks), Value::FromConstantU32(static_cast<u32>(m_delayed_cycles_add)));
-  m_delayed_cycles_add += Bus::RAM_READ_TICKS;
+  m_delayed_cycles_add += read_ticks;
 
   EmitLoadGuestMemorySlowmem(cbi, address, size, result, true);
 
@@ -2083,7 +2140,7 @@ void CodeGenerator::EmitStoreGuestMemoryFastmem(const CodeBlockInstruction& cbi,
   bpi.guest_pc = m_current_instruction->pc;
   bpi.fault_count = 0;
 
-  if (g_settings.cpu_fastmem_mode == CPUFastmemMode::MMap)
+  if (Bus::GetFastmemMode() == CPUFastmemMode::MMap)
   {
     // can't store displacements > 0x80000000 in-line
     const Value* actual_address = &address;
@@ -2264,6 +2321,25 @@ void CodeGenerator::EmitStoreGuestMemoryFastmem(const CodeBlockInstruction& cbi,
   m_emit->jmp(GetCurrentNearCodePointer());
 
   SwitchToNearCode();
+
+  // flag the page for incremental memory states, this runs after the slowmem path too, but that's harmless
+  if (Bus::IsRAMDirtyTrackingEnabled())
+  {
+    if (address.IsConstant())
+    {
+      m_emit->mov(m_emit->byte[GetCPUPtrReg() + static_cast<u32>(offsetof(State, ram_dirty_pages)) +
+                               Bus::GetRAMCodePageIndex(address.constant_value)],
+                  1);
+    }
+    else
+    {
+      m_emit->mov(GetHostReg32(RRETURN), GetHostReg32(address.host_reg));
+      m_emit->shr(GetHostReg32(RRETURN), 12);
+      m_emit->and_(GetHostReg32(RRETURN), Bus::g_ram_mask >> 12);
+      m_emit->mov(m_emit->byte[GetCPUPtrReg() + GetHostReg64(RRETURN) + offsetof(State, ram_dirty_pages)], 1);
+    }
+  }
+
   m_register_cache.UninhibitAllocation();
 
   m_block->loadstore_backpatch_info.push_back(bpi);
@@ -2664,6 +2740,15 @@ void CodeGenerator::EmitICacheCheckAndUpdate()
   }
   else
   {
+    // skip the lines entirely if no tags have changed since the block last ran
+    const Xbyak::Reg32 generation_reg = GetHostReg32(RRETURN);
+    const Xbyak::Reg64 block_generation_ptr_reg = GetHostReg64(RARG1);
+    Xbyak::Label lines_valid;
+    m_emit->mov(generation_reg, m_emit->dword[GetCPUPtrReg() + offsetof(State, icache_generation)]);
+    m_emit->mov(block_generation_ptr_reg, reinterpret_cast<size_t>(&m_block->icache_generation));
+    m_emit->cmp(m_emit->dword[block_generation_ptr_reg], generation_reg);
+    m_emit->je(lines_valid);
+
     VirtualMemoryAddress current_pc = m_pc & ICACHE_TAG_ADDRESS_MASK;
     for (u32 i = 0; i < m_block->icache_line_count; i++, current_pc += ICACHE_LINE_SIZE)
     {
@@ -2680,8 +2765,13 @@ void CodeGenerator::EmitICacheCheckAndUpdate()
       m_emit->je(cache_hit);
       m_emit->mov(m_emit->dword[GetCPUPtrReg() + offset], tag);
       m_emit->add(m_emit->dword[GetCPUPtrReg() + offsetof(State, pending_ticks)], static_cast<u32>(fill_ticks));
+      m_emit->inc(generation_reg);
       m_emit->L(cache_hit);
     }
+
+    m_emit->mov(m_emit->dword[GetCPUPtrReg() + offsetof(State, icache_generation)], generation_reg);
+    m_emit->mov(m_emit->dword[block_generation_ptr_reg], generation_reg);
+    m_emit->L(lines_valid);
   }
 }
 
@@ -36,6 +36,13 @@ void UncheckedWriteMemoryByte(u32 address, u32 value);
 void UncheckedWriteMemoryHalfWord(u32 address, u32 value);
 void UncheckedWriteMemoryWord(u32 address, u32 value);
 
+// Direct I/O register accessors for constant addresses, bypassing the address decode.
+// Returns nullptr if the address is not a device register, or the access could raise an exception.
+using DirectReadHandler = u32 (*)(u32 address);
+using DirectWriteHandler = void (*)(u32 address, u32 value);
+DirectReadHandler GetDirectReadHandler(u32 address, MemoryAccessSize size);
+DirectWriteHandler GetDirectWriteHandler(u32 address, MemoryAccessSize size);
+
 void ResolveBranch(CodeBlock* block, void* host_pc, void* host_resolve_pc, u32 host_pc_size);
 void LogPC(u32 pc);
 
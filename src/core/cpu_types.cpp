@@ -367,6 +367,40 @@ bool CanInstructionTrap(const Instruction& instruction, bool in_user_mode)
   }
 }
 
+bool CanInstructionReadRegister(const Instruction& instruction, Reg reg)
+{
+  switch (instruction.op)
+  {
+    case InstructionOp::lui:
+    case InstructionOp::j:
+    case InstructionOp::jal:
+      return false;
+
+    case InstructionOp::b:
+    case InstructionOp::blez:
+    case InstructionOp::bgtz:
+    case InstructionOp::addi:
+    case InstructionOp::addiu:
+    case InstructionOp::slti:
+    case InstructionOp::sltiu:
+    case InstructionOp::andi:
+    case InstructionOp::ori:
+    case InstructionOp::xori:
+    case InstructionOp::lb:
+    case InstructionOp::lh:
+    case InstructionOp::lw:
+    case InstructionOp::lbu:
+    case InstructionOp::lhu:
+    case InstructionOp::lwc2:
+    case InstructionOp::swc2:
+      return (instruction.i.rs == reg);
+
+      // lwl/lwr merge with the old value of rt, the coprocessor moves only read rt but it doesn't hurt to include rs
+    default:
+      return (instruction.i.rs == reg || instruction.i.rt == reg);
+  }
+}
+
 bool IsInvalidInstruction(const Instruction& instruction)
 {
   // TODO
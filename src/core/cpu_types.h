@@ -234,6 +234,7 @@ bool IsMemoryStoreInstruction(const Instruction& instruction);
 bool InstructionHasLoadDelay(const Instruction& instruction);
 bool IsExitBlockInstruction(const Instruction& instruction);
 bool CanInstructionTrap(const Instruction& instruction, bool in_user_mode);
+bool CanInstructionReadRegister(const Instruction& instruction, Reg reg);
 bool IsInvalidInstruction(const Instruction& instruction);
 
 struct Registers
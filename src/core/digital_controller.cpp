@@ -35,6 +35,12 @@ bool DigitalController::DoState(StateWrapper& sw, bool apply_input_state)
   return true;
 }
 
+bool DigitalController::DoInputState(StateWrapper& sw)
+{
+  sw.Do(&m_button_state);
+  return !sw.HasError();
+}
+
 float DigitalController::GetBindState(u32 index) const
 {
   if (index < static_cast<u32>(Button::Count))
@@ -505,20 +505,33 @@ bool DMA::TransferChannel(Channel channel)
 
       u8* ram_pointer = Bus::g_ram;
       TickCount remaining_ticks = GetTransferSliceTicks();
+      TickCount header_ticks = 0;
       while (cs.request && remaining_ticks > 0)
       {
         u32 header;
         std::memcpy(&header, &ram_pointer[current_address & mask], sizeof(header));
-        CPU::AddPendingTicks(10);
+        header_ticks += 10;
         remaining_ticks -= 10;
 
+        // Ordering tables are mostly empty nodes. Nothing reaches the device for these, so the request can't change,
+        // and runs of them are followed here without going back through the packet path.
+        while ((header >> 24) == 0 && !(header & UINT32_C(0x800000)) && remaining_ticks > 0)
+        {
+          current_address = header & UINT32_C(0x00FFFFFF);
+          std::memcpy(&header, &ram_pointer[current_address & mask], sizeof(header));
+          header_ticks += 10;
+          remaining_ticks -= 10;
+        }
+
         const u32 word_count = header >> 24;
         const u32 next_address = header & UINT32_C(0x00FFFFFF);
         Log_TracePrintf(" .. linked list entry at 0x%08X size=%u(%u words) next=0x%08X", current_address & mask,
                         word_count * UINT32_C(4), word_count, next_address);
         if (word_count > 0)
         {
-          CPU::AddPendingTicks(5);
+          // The device may look at the CPU's pending ticks, e.g. to synchronize the CRTC, so catch up first.
+          CPU::AddPendingTicks(header_ticks + 5);
+          header_ticks = 0;
           remaining_ticks -= 5;
 
           const TickCount block_ticks =
@@ -532,6 +545,7 @@ bool DMA::TransferChannel(Channel channel)
           break;
       }
 
+      CPU::AddPendingTicks(header_ticks);
       cs.base_address = current_address;
 
       if (current_address & UINT32_C(0x800000))
@@ -684,14 +698,23 @@ TickCount DMA::TransferMemoryToDevice(Channel channel, u32 address, u32 incremen
     {
       if (g_gpu->BeginDMAWrite())
       {
-        u8* ram_pointer = Bus::g_ram;
-        for (u32 i = 0; i < word_count; i++)
+        if (increment == sizeof(u32) && ((address + (increment * word_count)) & mask) > address)
         {
-          u32 value;
-          std::memcpy(&value, &ram_pointer[address], sizeof(u32));
-          g_gpu->DMAWrite(address, value);
-          address = (address + increment) & mask;
+          g_gpu->DMAWrite(address, src_pointer, word_count);
         }
+        else
+        {
+          // The GPU needs the address of each word, so wrapping/decrementing transfers can't use the temp buffer.
+          u8* ram_pointer = Bus::g_ram;
+          for (u32 i = 0; i < word_count; i++)
+          {
+            u32 value;
+            std::memcpy(&value, &ram_pointer[address], sizeof(u32));
+            g_gpu->DMAWrite(address, value);
+            address = (address + increment) & mask;
+          }
+        }
+
         g_gpu->EndDMAWrite();
       }
     }
@@ -734,10 +757,15 @@ TickCount DMA::TransferDeviceToMemory(Channel channel, u32 address, u32 incremen
 
     const u32 terminator = UINT32_C(0xFFFFFF);
     std::memcpy(&ram_pointer[address], &terminator, sizeof(terminator));
+    Bus::MarkRAMDirty(address, word_count * sizeof(u32));
     CPU::CodeCache::InvalidateCodePages(address, word_count);
     return Bus::GetDMARAMTickCount(word_count);
   }
 
+  // decrementing transfers finish below where they started
+  Bus::MarkRAMDirty((static_cast<s32>(increment) < 0) ? ((address - ((word_count - 1) * sizeof(u32))) & mask) : address,
+                    word_count * sizeof(u32));
+
   u32* dest_pointer = reinterpret_cast<u32*>(&Bus::g_ram[address]);
   if (static_cast<s32>(increment) < 0 || ((address + (increment * word_count)) & mask) <= address)
   {
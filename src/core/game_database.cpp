@@ -3,7 +3,7 @@
 
 #include "game_database.h"
 #include "common/assert.h"
-#include "common/byte_stream.h"
+#include "common/file_system.h"
 #include "common/heterogeneous_containers.h"
 #include "common/log.h"
 #include "common/path.h"
@@ -15,8 +15,14 @@
 #include "system.h"
 #include "tinyxml2.h"
 #include "util/cd_image.h"
+#include "util/iso_reader.h"
+#include "util/mapped_file.h"
+#include <algorithm>
+#include <atomic>
+#include <cstring>
 #include <iomanip>
 #include <memory>
+#include <mutex>
 #include <optional>
 #include <sstream>
 Log_SetChannel(GameDatabase);
@@ -31,14 +37,105 @@ namespace GameDatabase {
 enum : u32
 {
   GAME_DATABASE_CACHE_SIGNATURE = 0x45434C48,
-  GAME_DATABASE_CACHE_VERSION = 2,
+  GAME_DATABASE_CACHE_VERSION = 3,
 };
 
+/// The compiled database is a header, then tables of fixed-size records, then a pool of the strings they reference.
+/// Entries are sorted by serial, codes and track hashes by their key, so lookups are binary searches in place.
+struct DBHeader
+{
+  u32 signature;
+  u32 version;
+  u64 gamedb_ts;
+  u64 gamesettings_ts;
+  u64 compat_ts;
+  u32 num_entries;
+  u32 num_codes;
+  u32 num_track_hashes;
+  u32 num_track_codes;
+  u32 string_pool_size;
+  u32 reserved;
+};
+
+struct DBString
+{
+  u32 offset;
+  u32 length;
+};
+
+struct DBEntry
+{
+  enum : u32
+  {
+    HAS_DISPLAY_ACTIVE_START_OFFSET = (1u << 0),
+    HAS_DISPLAY_ACTIVE_END_OFFSET = (1u << 1),
+    HAS_DISPLAY_LINE_START_OFFSET = (1u << 2),
+    HAS_DISPLAY_LINE_END_OFFSET = (1u << 3),
+    HAS_DMA_MAX_SLICE_TICKS = (1u << 4),
+    HAS_DMA_HALT_TICKS = (1u << 5),
+    HAS_GPU_FIFO_SIZE = (1u << 6),
+    HAS_GPU_MAX_RUN_AHEAD = (1u << 7),
+    HAS_GPU_PGXP_TOLERANCE = (1u << 8),
+    HAS_GPU_PGXP_DEPTH_THRESHOLD = (1u << 9),
+  };
+
+  DBString serial;
+  DBString title;
+  DBString genre;
+  DBString developer;
+  DBString publisher;
+  u64 release_date;
+  u32 supported_controllers;
+  u32 traits;
+  u32 optional_flags;
+  u8 min_players;
+  u8 max_players;
+  u8 min_blocks;
+  u8 max_blocks;
+  u8 compatibility;
+  s8 display_line_start_offset;
+  s8 display_line_end_offset;
+  u8 reserved;
+  s16 display_active_start_offset;
+  s16 display_active_end_offset;
+  u32 dma_max_slice_ticks;
+  u32 dma_halt_ticks;
+  u32 gpu_fifo_size;
+  u32 gpu_max_run_ahead;
+  float gpu_pgxp_tolerance;
+  float gpu_pgxp_depth_threshold;
+};
+
+struct DBCode
+{
+  DBString code;
+  u32 entry_index;
+  u32 reserved;
+};
+
+struct DBTrackHash
+{
+  CDImageHasher::Hash hash;
+  DBString revision_string;
+  u32 revision;
+  u32 first_code;
+  u32 num_codes;
+  u32 reserved;
+};
+
+static_assert(sizeof(DBHeader) == 56 && sizeof(DBEntry) == 96 && sizeof(DBCode) == 16 && sizeof(DBTrackHash) == 40,
+              "Database structures are packed");
+static_assert(static_cast<u32>(Trait::Count) <= 32, "Traits fit in a DBEntry");
+
 static Entry* GetMutableEntry(const std::string_view& serial);
 static const Entry* GetEntryForId(const std::string_view& code);
+static const Entry* GetCachedEntry(u32 index);
+static std::string_view GetDBString(const DBString& str);
 
-static bool LoadFromCache();
-static bool SaveToCache();
+static bool LoadCompiledDatabase();
+static bool SetCompiledDatabase(const u8* data, size_t size);
+static void CompileDatabase();
+static void UnloadCompiledDatabase();
 
 static bool LoadGameDBJson();
 static bool ParseJsonEntry(Entry* entry, const rapidjson::Value& value);
@@ -68,11 +165,28 @@ std::array<std::pair<const char*, const char*>, static_cast<u32>(GameDatabase::T
   {"ForceRecompilerMemoryExceptions", TRANSLATABLE("GameSettingsTrait", "Force Recompiler Memory Exceptions")},
   {"ForceRecompilerICache", TRANSLATABLE("GameSettingsTrait", "Force Recompiler ICache")},
   {"ForceRecompilerLUTFastmem", TRANSLATABLE("GameSettingsTrait", "Force Recompiler LUT Fastmem")},
+  {"DisableIdleLoopSkipping", TRANSLATABLE("GameSettingsTrait", "Disable Idle Loop Skipping")},
 }};
 
-static bool s_loaded = false;
+/// The database can be loaded ahead of time on a worker thread while a game is booting.
+static std::mutex s_load_mutex;
+static std::atomic_bool s_loaded{false};
 static bool s_track_hashes_loaded = false;
 
+static Common::MappedFile s_db_mapping;
+static std::vector<u8> s_db_buffer;
+static const DBHeader* s_db_header = nullptr;
+static const DBEntry* s_db_entries = nullptr;
+static const DBCode* s_db_codes = nullptr;
+static const DBTrackHash* s_db_track_hashes = nullptr;
+static const DBString* s_db_track_codes = nullptr;
+static const char* s_db_string_pool = nullptr;
+
+/// Entries are only unpacked from the compiled database when they're looked up.
+static std::mutex s_entry_cache_mutex;
+static std::vector<std::unique_ptr<GameDatabase::Entry>> s_entry_cache;
+
+// Only used while compiling the database from the source files.
 static std::vector<GameDatabase::Entry> s_entries;
 static UnorderedStringMap<u32> s_code_lookup;
 
@@ -81,40 +195,102 @@ static TrackHashesMap s_track_hashes_map;
 
 void GameDatabase::EnsureLoaded()
 {
-  if (s_loaded)
+  if (s_loaded.load(std::memory_order_acquire))
     return;
 
-  Common::Timer timer;
+  std::unique_lock lock(s_load_mutex);
+  if (s_loaded.load(std::memory_order_relaxed))
+    return;
 
-  s_loaded = true;
+  Common::Timer timer;
 
-  if (!LoadFromCache())
+  if (!LoadCompiledDatabase())
   {
-    s_entries = {};
-    s_code_lookup = {};
-
     LoadGameDBJson();
     LoadGameSettingsIni();
     LoadGameCompatibilityXml();
-    SaveToCache();
+    LoadTrackHashes();
+    CompileDatabase();
+
+    s_entries = {};
+    s_code_lookup = {};
+    s_track_hashes_map = {};
   }
 
+  s_loaded.store(true, std::memory_order_release);
   Log_InfoPrintf("Database load took %.2f ms", timer.GetTimeMilliseconds());
 }
 
 void GameDatabase::Unload()
 {
-  s_entries = {};
-  s_code_lookup = {};
-  s_loaded = false;
+  std::unique_lock lock(s_load_mutex);
+  UnloadCompiledDatabase();
+  s_track_hashes_map = {};
+  s_track_hashes_loaded = false;
+  s_loaded.store(false, std::memory_order_release);
+}
+
+std::string_view GameDatabase::GetDBString(const DBString& str)
+{
+  return std::string_view(s_db_string_pool + str.offset, str.length);
+}
+
+const GameDatabase::Entry* GameDatabase::GetCachedEntry(u32 index)
+{
+  std::unique_lock lock(s_entry_cache_mutex);
+  std::unique_ptr<Entry>& entry = s_entry_cache[index];
+  if (entry)
+    return entry.get();
+
+  const DBEntry& dbentry = s_db_entries[index];
+  entry = std::make_unique<Entry>();
+  entry->serial = GetDBString(dbentry.serial);
+  entry->title = GetDBString(dbentry.title);
+  entry->genre = GetDBString(dbentry.genre);
+  entry->developer = GetDBString(dbentry.developer);
+  entry->publisher = GetDBString(dbentry.publisher);
+  entry->release_date = dbentry.release_date;
+  entry->min_players = dbentry.min_players;
+  entry->max_players = dbentry.max_players;
+  entry->min_blocks = dbentry.min_blocks;
+  entry->max_blocks = dbentry.max_blocks;
+  entry->supported_controllers = dbentry.supported_controllers;
+  entry->compatibility = static_cast<CompatibilityRating>(dbentry.compatibility);
+  entry->traits = decltype(entry->traits)(dbentry.traits);
+
+#define UNPACK_OPTIONAL(flag, field)                                                                                   \
+  if (dbentry.optional_flags & DBEntry::flag)                                                                          \
+    entry->field = dbentry.field;
+
+  UNPACK_OPTIONAL(HAS_DISPLAY_ACTIVE_START_OFFSET, display_active_start_offset);
+  UNPACK_OPTIONAL(HAS_DISPLAY_ACTIVE_END_OFFSET, display_active_end_offset);
+  UNPACK_OPTIONAL(HAS_DISPLAY_LINE_START_OFFSET, display_line_start_offset);
+  UNPACK_OPTIONAL(HAS_DISPLAY_LINE_END_OFFSET, display_line_end_offset);
+  UNPACK_OPTIONAL(HAS_DMA_MAX_SLICE_TICKS, dma_max_slice_ticks);
+  UNPACK_OPTIONAL(HAS_DMA_HALT_TICKS, dma_halt_ticks);
+  UNPACK_OPTIONAL(HAS_GPU_FIFO_SIZE, gpu_fifo_size);
+  UNPACK_OPTIONAL(HAS_GPU_MAX_RUN_AHEAD, gpu_max_run_ahead);
+  UNPACK_OPTIONAL(HAS_GPU_PGXP_TOLERANCE, gpu_pgxp_tolerance);
+  UNPACK_OPTIONAL(HAS_GPU_PGXP_DEPTH_THRESHOLD, gpu_pgxp_depth_threshold);
+
+#undef UNPACK_OPTIONAL
+
+  return entry.get();
 }
 
 const GameDatabase::Entry* GameDatabase::GetEntryForId(const std::string_view& code)
 {
   EnsureLoaded();
-
-  auto iter = UnorderedStringMapFind(s_code_lookup, code);
-  return (iter != s_code_lookup.end()) ? &s_entries[iter->second] : nullptr;
+  if (!s_db_header)
+    return nullptr;
+
+  const DBCode* begin = s_db_codes;
+  const DBCode* end = s_db_codes + s_db_header->num_codes;
+  const DBCode* iter =
+    std::lower_bound(begin, end, code, [](const DBCode& lhs, const std::string_view& rhs) {
+      return GetDBString(lhs.code) < rhs;
+    });
+  return (iter != end && GetDBString(iter->code) == code) ? GetCachedEntry(iter->entry_index) : nullptr;
 }
 
 std::string GameDatabase::GetSerialForDisc(CDImage* image)
@@ -144,7 +320,19 @@ std::string GameDatabase::GetSerialForPath(const char* path)
 
 const GameDatabase::Entry* GameDatabase::GetEntryForDisc(CDImage* image)
 {
-  std::string id(System::GetGameIdFromImage(image, false));
+  ISOReader iso;
+  if (!iso.Open(image, 1))
+  {
+    Log_WarningPrintf("No entry found for disc (not an ISO9660 image)");
+    return nullptr;
+  }
+
+  return GetEntryForDisc(iso);
+}
+
+const GameDatabase::Entry* GameDatabase::GetEntryForDisc(ISOReader& iso)
+{
+  std::string id(System::GetGameIdFromImage(iso, false));
   if (!id.empty())
   {
     const Entry* entry = GetEntryForId(id);
@@ -152,7 +340,7 @@ const GameDatabase::Entry* GameDatabase::GetEntryForDisc(CDImage* image)
       return entry;
   }
 
-  std::string hash_id(System::GetGameHashIdFromImage(image));
+  std::string hash_id(System::GetGameHashIdFromImage(iso));
   if (!hash_id.empty())
   {
     const Entry* entry = GetEntryForId(hash_id);
@@ -167,8 +355,17 @@ const GameDatabase::Entry* GameDatabase::GetEntryForDisc(CDImage* image)
 const GameDatabase::Entry* GameDatabase::GetEntryForSerial(const std::string_view& serial)
 {
   EnsureLoaded();
-
-  return GetMutableEntry(serial);
+  if (!s_db_header)
+    return nullptr;
+
+  const DBEntry* begin = s_db_entries;
+  const DBEntry* end = s_db_entries + s_db_header->num_entries;
+  const DBEntry* iter =
+    std::lower_bound(begin, end, serial, [](const DBEntry& lhs, const std::string_view& rhs) {
+      return GetDBString(lhs.serial) < rhs;
+    });
+  return (iter != end && GetDBString(iter->serial) == serial) ? GetCachedEntry(static_cast<u32>(iter - begin)) :
+                                                                nullptr;
 }
 
 GameDatabase::Entry* GameDatabase::GetMutableEntry(const std::string_view& serial)
@@ -455,6 +652,12 @@ void GameDatabase::Entry::ApplySettings(Settings& settings, bool display_osd_mes
     settings.cpu_fastmem_mode = CPUFastmemMode::LUT;
   }
 
+  if (HasTrait(Trait::DisableIdleLoopSkipping))
+  {
+    Log_WarningPrint("Idle loop skipping disabled by game settings.");
+    settings.cpu_idle_loop_skipping = false;
+  }
+
 #define BIT_FOR(ctype) (static_cast<u32>(1) << static_cast<u32>(ctype))
 
   if (supported_controllers != 0 && supported_controllers != static_cast<u32>(-1))
@@ -513,197 +716,285 @@ static void GetTimestamps(u64* gamedb_ts, u64* gamesettings_ts, u64* compat_ts)
   *compat_ts = Host::GetResourceFileTimestamp("database/compatibility.xml").value_or(0);
 }
 
-template<typename T>
-bool ReadOptionalFromStream(ByteStream* stream, std::optional<T>* dest)
+static std::string GetCacheFile()
 {
-  bool has_value;
-  if (!stream->Read2(&has_value, sizeof(has_value)))
-    return false;
-
-  if (!has_value)
-    return true;
-
-  T value;
-  if (!stream->Read2(&value, sizeof(T)))
-    return false;
-
-  *dest = value;
-  return true;
+  return Path::Combine(EmuFolders::Cache, "gamedb.cache");
 }
 
-template<typename T>
-bool WriteOptionalToStream(ByteStream* stream, const std::optional<T>& src)
+bool GameDatabase::LoadCompiledDatabase()
 {
-  const bool has_value = src.has_value();
-  if (!stream->Write2(&has_value, sizeof(has_value)))
+  const std::string filename(GetCacheFile());
+  auto fp = FileSystem::OpenManagedCFile(filename.c_str(), "rb");
+  if (!fp)
+  {
+    Log_DevPrintf("Cache does not exist, loading full database.");
     return false;
+  }
 
-  if (!has_value)
-    return true;
-
-  return stream->Write2(&src.value(), sizeof(T));
-}
+  if (s_db_mapping.Map(fp.get()))
+  {
+    if (SetCompiledDatabase(s_db_mapping.GetData(), static_cast<size_t>(s_db_mapping.GetSize())))
+      return true;
+  }
+  else
+  {
+    std::optional<std::vector<u8>> data(FileSystem::ReadBinaryFile(fp.get()));
+    if (data.has_value())
+    {
+      s_db_buffer = std::move(data.value());
+      if (SetCompiledDatabase(s_db_buffer.data(), s_db_buffer.size()))
+        return true;
+    }
+  }
 
-static std::string GetCacheFile()
-{
-  return Path::Combine(EmuFolders::Cache, "gamedb.cache");
+  UnloadCompiledDatabase();
+  return false;
 }
 
-bool GameDatabase::LoadFromCache()
+bool GameDatabase::SetCompiledDatabase(const u8* data, size_t size)
 {
-  std::unique_ptr<ByteStream> stream(
-    ByteStream::OpenFile(GetCacheFile().c_str(), BYTESTREAM_OPEN_READ | BYTESTREAM_OPEN_STREAMED));
-  if (!stream)
+  if (size < sizeof(DBHeader))
   {
-    Log_DevPrintf("Cache does not exist, loading full database.");
+    Log_DevPrintf("Cache header is corrupted.");
     return false;
   }
 
   u64 gamedb_ts, gamesettings_ts, compat_ts;
   GetTimestamps(&gamedb_ts, &gamesettings_ts, &compat_ts);
 
-  u32 signature, version, num_entries, num_codes;
-  u64 file_gamedb_ts, file_gamesettings_ts, file_compat_ts;
-  if (!stream->ReadU32(&signature) || !stream->ReadU32(&version) || !stream->ReadU64(&file_gamedb_ts) ||
-      !stream->ReadU64(&file_gamesettings_ts) || !stream->ReadU64(&file_compat_ts) || !stream->ReadU32(&num_entries) ||
-      !stream->ReadU32(&num_codes) || signature != GAME_DATABASE_CACHE_SIGNATURE ||
-      version != GAME_DATABASE_CACHE_VERSION)
+  const DBHeader* header = reinterpret_cast<const DBHeader*>(data);
+  if (header->signature != GAME_DATABASE_CACHE_SIGNATURE || header->version != GAME_DATABASE_CACHE_VERSION)
   {
     Log_DevPrintf("Cache header is corrupted or version mismatch.");
     return false;
   }
 
-  if (gamedb_ts != file_gamedb_ts || gamesettings_ts != file_gamesettings_ts || compat_ts != file_compat_ts)
+  if (header->gamedb_ts != gamedb_ts || header->gamesettings_ts != gamesettings_ts || header->compat_ts != compat_ts)
   {
     Log_DevPrintf("Cache is out of date, recreating.");
     return false;
   }
 
-  s_entries.reserve(num_entries);
-
-  for (u32 i = 0; i < num_entries; i++)
+  const u64 expected_size = sizeof(DBHeader) + static_cast<u64>(header->num_entries) * sizeof(DBEntry) +
+                            static_cast<u64>(header->num_codes) * sizeof(DBCode) +
+                            static_cast<u64>(header->num_track_hashes) * sizeof(DBTrackHash) +
+                            static_cast<u64>(header->num_track_codes) * sizeof(DBString) + header->string_pool_size;
+  if (size != expected_size)
   {
-    Entry& entry = s_entries.emplace_back();
+    Log_DevPrintf("Cache size is incorrect.");
+    return false;
+  }
 
-    constexpr u32 num_bytes = (static_cast<u32>(Trait::Count) + 7) / 8;
-    std::array<u8, num_bytes> bits;
-    u8 compatibility;
-
-    if (!stream->ReadSizePrefixedString(&entry.serial) || !stream->ReadSizePrefixedString(&entry.title) ||
-        !stream->ReadSizePrefixedString(&entry.genre) || !stream->ReadSizePrefixedString(&entry.developer) ||
-        !stream->ReadSizePrefixedString(&entry.publisher) || !stream->ReadU64(&entry.release_date) ||
-        !stream->ReadU8(&entry.min_players) || !stream->ReadU8(&entry.max_players) ||
-        !stream->ReadU8(&entry.min_blocks) || !stream->ReadU8(&entry.max_blocks) ||
-        !stream->ReadU32(&entry.supported_controllers) || !stream->ReadU8(&compatibility) ||
-        compatibility >= static_cast<u8>(GameDatabase::CompatibilityRating::Count) ||
-        !stream->Read2(bits.data(), num_bytes) ||
-        !ReadOptionalFromStream(stream.get(), &entry.display_active_start_offset) ||
-        !ReadOptionalFromStream(stream.get(), &entry.display_active_end_offset) ||
-        !ReadOptionalFromStream(stream.get(), &entry.display_line_start_offset) ||
-        !ReadOptionalFromStream(stream.get(), &entry.display_line_end_offset) ||
-        !ReadOptionalFromStream(stream.get(), &entry.dma_max_slice_ticks) ||
-        !ReadOptionalFromStream(stream.get(), &entry.dma_halt_ticks) ||
-        !ReadOptionalFromStream(stream.get(), &entry.gpu_fifo_size) ||
-        !ReadOptionalFromStream(stream.get(), &entry.gpu_max_run_ahead) ||
-        !ReadOptionalFromStream(stream.get(), &entry.gpu_pgxp_tolerance) ||
-        !ReadOptionalFromStream(stream.get(), &entry.gpu_pgxp_depth_threshold))
+  const DBEntry* entries = reinterpret_cast<const DBEntry*>(header + 1);
+  const DBCode* codes = reinterpret_cast<const DBCode*>(entries + header->num_entries);
+  const DBTrackHash* track_hashes = reinterpret_cast<const DBTrackHash*>(codes + header->num_codes);
+  const DBString* track_codes = reinterpret_cast<const DBString*>(track_hashes + header->num_track_hashes);
+
+  // only bounds are checked here, the records themselves are left alone until they're looked up
+  const u32 pool_size = header->string_pool_size;
+  const auto string_valid = [pool_size](const DBString& str) {
+    return (str.offset <= pool_size && str.length <= (pool_size - str.offset));
+  };
+  for (u32 i = 0; i < header->num_entries; i++)
+  {
+    const DBEntry& entry = entries[i];
+    if (!string_valid(entry.serial) || !string_valid(entry.title) || !string_valid(entry.genre) ||
+        !string_valid(entry.developer) || !string_valid(entry.publisher) ||
+        entry.compatibility >= static_cast<u8>(CompatibilityRating::Count))
     {
       Log_DevPrintf("Cache entry is corrupted.");
       return false;
     }
-
-    entry.compatibility = static_cast<GameDatabase::CompatibilityRating>(compatibility);
-    entry.traits.reset();
-    for (u32 j = 0; j < static_cast<int>(Trait::Count); j++)
+  }
+  for (u32 i = 0; i < header->num_codes; i++)
+  {
+    if (!string_valid(codes[i].code) || codes[i].entry_index >= header->num_entries)
     {
-      if ((bits[j / 8] & (1u << (j % 8))) != 0)
-        entry.traits[j] = true;
+      Log_DevPrintf("Cache code entry is corrupted.");
+      return false;
     }
   }
-
-  for (u32 i = 0; i < num_codes; i++)
+  for (u32 i = 0; i < header->num_track_hashes; i++)
   {
-    std::string code;
-    u32 index;
-    if (!stream->ReadSizePrefixedString(&code) || !stream->ReadU32(&index) ||
-        index >= static_cast<u32>(s_entries.size()))
+    const DBTrackHash& th = track_hashes[i];
+    if (!string_valid(th.revision_string) || th.first_code > header->num_track_codes ||
+        th.num_codes > (header->num_track_codes - th.first_code))
     {
-      Log_DevPrintf("Cache code entry is corrupted.");
+      Log_DevPrintf("Cache track hash is corrupted.");
+      return false;
+    }
+  }
+  for (u32 i = 0; i < header->num_track_codes; i++)
+  {
+    if (!string_valid(track_codes[i]))
+    {
+      Log_DevPrintf("Cache track code is corrupted.");
       return false;
     }
-
-    s_code_lookup.emplace(std::move(code), index);
   }
 
+  s_db_header = header;
+  s_db_entries = entries;
+  s_db_codes = codes;
+  s_db_track_hashes = track_hashes;
+  s_db_track_codes = track_codes;
+  s_db_string_pool = reinterpret_cast<const char*>(track_codes + header->num_track_codes);
+  s_entry_cache.resize(header->num_entries);
   return true;
 }
 
-bool GameDatabase::SaveToCache()
+void GameDatabase::CompileDatabase()
 {
   u64 gamedb_ts, gamesettings_ts, compat_ts;
   GetTimestamps(&gamedb_ts, &gamesettings_ts, &compat_ts);
 
-  std::unique_ptr<ByteStream> stream(
-    ByteStream::OpenFile(GetCacheFile().c_str(), BYTESTREAM_OPEN_CREATE | BYTESTREAM_OPEN_WRITE |
-                                                   BYTESTREAM_OPEN_TRUNCATE | BYTESTREAM_OPEN_STREAMED));
-  if (!stream)
-    return false;
+  std::string string_pool;
+  UnorderedStringMap<DBString> pooled_strings;
+  const auto add_string = [&string_pool, &pooled_strings](const std::string_view& str) {
+    // genres, developers etc repeat a lot
+    auto iter = UnorderedStringMapFind(pooled_strings, str);
+    if (iter != pooled_strings.end())
+      return iter->second;
+
+    const DBString ret = {static_cast<u32>(string_pool.size()), static_cast<u32>(str.length())};
+    string_pool.append(str);
+    pooled_strings.emplace(str, ret);
+    return ret;
+  };
+
+  // entries are stored sorted by serial, so they can be searched
+  std::vector<u32> entry_order(s_entries.size());
+  std::vector<u32> entry_remap(s_entries.size());
+  for (u32 i = 0; i < static_cast<u32>(entry_order.size()); i++)
+    entry_order[i] = i;
+  std::stable_sort(entry_order.begin(), entry_order.end(),
+                   [](u32 lhs, u32 rhs) { return s_entries[lhs].serial < s_entries[rhs].serial; });
+
+  std::vector<DBEntry> entries;
+  entries.reserve(s_entries.size());
+  for (u32 index : entry_order)
+  {
+    const Entry& entry = s_entries[index];
+    entry_remap[index] = static_cast<u32>(entries.size());
+
+    DBEntry& dbentry = entries.emplace_back();
+    std::memset(&dbentry, 0, sizeof(dbentry));
+    dbentry.serial = add_string(entry.serial);
+    dbentry.title = add_string(entry.title);
+    dbentry.genre = add_string(entry.genre);
+    dbentry.developer = add_string(entry.developer);
+    dbentry.publisher = add_string(entry.publisher);
+    dbentry.release_date = entry.release_date;
+    dbentry.supported_controllers = entry.supported_controllers;
+    dbentry.traits = static_cast<u32>(entry.traits.to_ulong());
+    dbentry.min_players = entry.min_players;
+    dbentry.max_players = entry.max_players;
+    dbentry.min_blocks = entry.min_blocks;
+    dbentry.max_blocks = entry.max_blocks;
+    dbentry.compatibility = static_cast<u8>(entry.compatibility);
+
+#define PACK_OPTIONAL(flag, field)                                                                                     \
+  if (entry.field.has_value())                                                                                         \
+  {                                                                                                                    \
+    dbentry.optional_flags |= DBEntry::flag;                                                                           \
+    dbentry.field = entry.field.value();                                                                               \
+  }
 
-  bool result = stream->WriteU32(GAME_DATABASE_CACHE_SIGNATURE);
-  result = result && stream->WriteU32(GAME_DATABASE_CACHE_VERSION);
-  result = result && stream->WriteU64(static_cast<u64>(gamedb_ts));
-  result = result && stream->WriteU64(static_cast<u64>(gamesettings_ts));
-  result = result && stream->WriteU64(static_cast<u64>(compat_ts));
-
-  result = result && stream->WriteU32(static_cast<u32>(s_entries.size()));
-  result = result && stream->WriteU32(static_cast<u32>(s_code_lookup.size()));
-
-  for (const Entry& entry : s_entries)
-  {
-    result = result && stream->WriteSizePrefixedString(entry.serial);
-    result = result && stream->WriteSizePrefixedString(entry.title);
-    result = result && stream->WriteSizePrefixedString(entry.genre);
-    result = result && stream->WriteSizePrefixedString(entry.developer);
-    result = result && stream->WriteSizePrefixedString(entry.publisher);
-    result = result && stream->WriteU64(entry.release_date);
-    result = result && stream->WriteU8(entry.min_players);
-    result = result && stream->WriteU8(entry.max_players);
-    result = result && stream->WriteU8(entry.min_blocks);
-    result = result && stream->WriteU8(entry.max_blocks);
-    result = result && stream->WriteU32(entry.supported_controllers);
-    result = result && stream->WriteU8(static_cast<u8>(entry.compatibility));
-
-    constexpr u32 num_bytes = (static_cast<u32>(Trait::Count) + 7) / 8;
-    std::array<u8, num_bytes> bits;
-    bits.fill(0);
-    for (u32 j = 0; j < static_cast<int>(Trait::Count); j++)
-    {
-      if (entry.traits[j])
-        bits[j / 8] |= (1u << (j % 8));
-    }
+    PACK_OPTIONAL(HAS_DISPLAY_ACTIVE_START_OFFSET, display_active_start_offset);
+    PACK_OPTIONAL(HAS_DISPLAY_ACTIVE_END_OFFSET, display_active_end_offset);
+    PACK_OPTIONAL(HAS_DISPLAY_LINE_START_OFFSET, display_line_start_offset);
+    PACK_OPTIONAL(HAS_DISPLAY_LINE_END_OFFSET, display_line_end_offset);
+    PACK_OPTIONAL(HAS_DMA_MAX_SLICE_TICKS, dma_max_slice_ticks);
+    PACK_OPTIONAL(HAS_DMA_HALT_TICKS, dma_halt_ticks);
+    PACK_OPTIONAL(HAS_GPU_FIFO_SIZE, gpu_fifo_size);
+    PACK_OPTIONAL(HAS_GPU_MAX_RUN_AHEAD, gpu_max_run_ahead);
+    PACK_OPTIONAL(HAS_GPU_PGXP_TOLERANCE, gpu_pgxp_tolerance);
+    PACK_OPTIONAL(HAS_GPU_PGXP_DEPTH_THRESHOLD, gpu_pgxp_depth_threshold);
+
+#undef PACK_OPTIONAL
+  }
 
-    result = result && stream->Write2(bits.data(), num_bytes);
+  std::vector<DBCode> codes;
+  codes.reserve(s_code_lookup.size());
+  for (const auto& it : s_code_lookup)
+    codes.push_back(DBCode{add_string(it.first), entry_remap[it.second], 0});
+  std::sort(codes.begin(), codes.end(), [&string_pool](const DBCode& lhs, const DBCode& rhs) {
+    return std::string_view(string_pool).substr(lhs.code.offset, lhs.code.length) <
+           std::string_view(string_pool).substr(rhs.code.offset, rhs.code.length);
+  });
+
+  // the multimap is already ordered by hash
+  std::vector<DBTrackHash> track_hashes;
+  std::vector<DBString> track_codes;
+  track_hashes.reserve(s_track_hashes_map.size());
+  for (const auto& it : s_track_hashes_map)
+  {
+    DBTrackHash& th = track_hashes.emplace_back();
+    std::memset(&th, 0, sizeof(th));
+    th.hash = it.first;
+    th.revision_string = add_string(it.second.revisionString);
+    th.revision = it.second.revision;
+    th.first_code = static_cast<u32>(track_codes.size());
+    th.num_codes = static_cast<u32>(it.second.codes.size());
+    for (const std::string& code : it.second.codes)
+      track_codes.push_back(add_string(code));
+  }
 
-    result = result && WriteOptionalToStream(stream.get(), entry.display_active_start_offset);
-    result = result && WriteOptionalToStream(stream.get(), entry.display_active_end_offset);
-    result = result && WriteOptionalToStream(stream.get(), entry.display_line_start_offset);
-    result = result && WriteOptionalToStream(stream.get(), entry.display_line_end_offset);
-    result = result && WriteOptionalToStream(stream.get(), entry.dma_max_slice_ticks);
-    result = result && WriteOptionalToStream(stream.get(), entry.dma_halt_ticks);
-    result = result && WriteOptionalToStream(stream.get(), entry.gpu_fifo_size);
-    result = result && WriteOptionalToStream(stream.get(), entry.gpu_max_run_ahead);
-    result = result && WriteOptionalToStream(stream.get(), entry.gpu_pgxp_tolerance);
-    result = result && WriteOptionalToStream(stream.get(), entry.gpu_pgxp_depth_threshold);
+  DBHeader header = {};
+  header.signature = GAME_DATABASE_CACHE_SIGNATURE;
+  header.version = GAME_DATABASE_CACHE_VERSION;
+  header.gamedb_ts = gamedb_ts;
+  header.gamesettings_ts = gamesettings_ts;
+  header.compat_ts = compat_ts;
+  header.num_entries = static_cast<u32>(entries.size());
+  header.num_codes = static_cast<u32>(codes.size());
+  header.num_track_hashes = static_cast<u32>(track_hashes.size());
+  header.num_track_codes = static_cast<u32>(track_codes.size());
+  header.string_pool_size = static_cast<u32>(string_pool.size());
+
+  std::vector<u8> data;
+  data.reserve(sizeof(header) + entries.size() * sizeof(DBEntry) + codes.size() * sizeof(DBCode) +
+               track_hashes.size() * sizeof(DBTrackHash) + track_codes.size() * sizeof(DBString) + string_pool.size());
+  const auto append = [&data](const void* ptr, size_t size) {
+    data.insert(data.end(), static_cast<const u8*>(ptr), static_cast<const u8*>(ptr) + size);
+  };
+  append(&header, sizeof(header));
+  append(entries.data(), entries.size() * sizeof(DBEntry));
+  append(codes.data(), codes.size() * sizeof(DBCode));
+  append(track_hashes.data(), track_hashes.size() * sizeof(DBTrackHash));
+  append(track_codes.data(), track_codes.size() * sizeof(DBString));
+  append(string_pool.data(), string_pool.size());
+
+  // keep using the compiled copy even if it can't be saved, so there's only one lookup path
+  const std::string filename(GetCacheFile());
+  const std::string temp_filename(filename + ".tmp");
+  if (!FileSystem::WriteBinaryFile(temp_filename.c_str(), data.data(), data.size()) ||
+      !FileSystem::RenamePath(temp_filename.c_str(), filename.c_str()))
+  {
+    Log_ErrorPrintf("Failed to write game database cache '%s'", filename.c_str());
+    FileSystem::DeleteFile(temp_filename.c_str());
   }
 
-  for (const auto& it : s_code_lookup)
+  s_db_buffer = std::move(data);
+  if (!SetCompiledDatabase(s_db_buffer.data(), s_db_buffer.size()))
+    UnloadCompiledDatabase();
+}
+
+void GameDatabase::UnloadCompiledDatabase()
+{
   {
-    result = result && stream->WriteSizePrefixedString(it.first);
-    result = result && stream->WriteU32(it.second);
+    std::unique_lock lock(s_entry_cache_mutex);
+    s_entry_cache = std::vector<std::unique_ptr<Entry>>();
   }
 
-  result = result && stream->Flush();
-  return true;
+  s_db_header = nullptr;
+  s_db_entries = nullptr;
+  s_db_codes = nullptr;
+  s_db_track_hashes = nullptr;
+  s_db_track_codes = nullptr;
+  s_db_string_pool = nullptr;
+  s_db_mapping.Unmap();
+  s_db_buffer = {};
 }
 
 //////////////////////////////////////////////////////////////////////////
@@ -1070,8 +1361,24 @@ void GameDatabase::EnsureTrackHashesMapLoaded()
   if (s_track_hashes_loaded)
     return;
 
+  EnsureLoaded();
   s_track_hashes_loaded = true;
-  LoadTrackHashes();
+  if (!s_db_header)
+    return;
+
+  // inserting in key order lets the multimap append each one
+  for (u32 i = 0; i < s_db_header->num_track_hashes; i++)
+  {
+    const DBTrackHash& th = s_db_track_hashes[i];
+    std::vector<std::string> codes;
+    codes.reserve(th.num_codes);
+    for (u32 j = 0; j < th.num_codes; j++)
+      codes.emplace_back(GetDBString(s_db_track_codes[th.first_code + j]));
+
+    std::string revision_string(GetDBString(th.revision_string));
+    s_track_hashes_map.emplace_hint(s_track_hashes_map.end(), std::piecewise_construct, std::forward_as_tuple(th.hash),
+                                    std::forward_as_tuple(std::move(codes), std::move(revision_string), th.revision));
+  }
 }
 
 bool GameDatabase::LoadTrackHashes()
@@ -11,6 +11,7 @@
 #include <vector>
 
 class CDImage;
+class ISOReader;
 
 struct Settings;
 
@@ -47,6 +48,7 @@ enum class Trait : u32
   ForceRecompilerMemoryExceptions,
   ForceRecompilerICache,
   ForceRecompilerLUTFastmem,
+  DisableIdleLoopSkipping,
 
   Count
 };
@@ -88,6 +90,7 @@ void EnsureLoaded();
 void Unload();
 
 const Entry* GetEntryForDisc(CDImage* image);
+const Entry* GetEntryForDisc(ISOReader& iso);
 const Entry* GetEntryForSerial(const std::string_view& serial);
 std::string GetSerialForDisc(CDImage* image);
 std::string GetSerialForPath(const char* path);
@@ -159,14 +159,23 @@ static std::optional<std::string> Cmd$G(const std::string_view& data)
   return { "" };
 }
 
+/// Largest packet we accept, advertised so GDB reads and writes memory in big chunks rather than small ones.
+constexpr u32 MAX_PACKET_SIZE = 0x20000;
+
+/// Splits "<first><separator><second>" without copying.
+static std::pair<std::string_view, std::string_view> SplitPayload(const std::string_view& data, char separator)
+{
+  const std::string_view::size_type pos = data.find(separator);
+  if (pos == std::string_view::npos) {
+    return { data, {} };
+  }
+  return { data.substr(0, pos), data.substr(pos + 1) };
+}
+
 /// Get memory.
 static std::optional<std::string> Cmd$m(const std::string_view& data)
 {
-  std::stringstream ss{std::string{data}};
-  std::string dataAddress, dataLength;
-
-  std::getline(ss, dataAddress, ',');
-  std::getline(ss, dataLength, '\0');
+  const auto [dataAddress, dataLength] = SplitPayload(data, ',');
 
   auto address = StringUtil::FromChars<VirtualMemoryAddress>(dataAddress, 16);
   auto length = StringUtil::FromChars<u32>(dataLength, 16);
@@ -186,12 +195,8 @@ static std::optional<std::string> Cmd$m(const std::string_view& data)
 /// Set memory.
 static std::optional<std::string> Cmd$M(const std::string_view& data)
 {
-  std::stringstream ss{std::string{data}};
-  std::string dataAddress, dataLength, dataPayload;
-
-  std::getline(ss, dataAddress, ',');
-  std::getline(ss, dataLength, ':');
-  std::getline(ss, dataPayload, '\0');
+  const auto [dataAddress, dataRest] = SplitPayload(data, ',');
+  const auto [dataLength, dataPayload] = SplitPayload(dataRest, ':');
 
   auto address = StringUtil::FromChars<VirtualMemoryAddress>(dataAddress, 16);
   auto length = StringUtil::FromChars<u32>(dataLength, 16);
@@ -204,6 +209,7 @@ static std::optional<std::string> Cmd$M(const std::string_view& data)
     u8* ptr_data = GetMemoryPointer(phys_addr, phys_length);
     if (ptr_data) {
       memcpy(ptr_data, payload->data(), phys_length);
+      Bus::MarkRAMDirty(phys_addr, phys_length);
       return { "OK" };
     }
   }
@@ -244,7 +250,7 @@ static std::optional<std::string> Cmd$vMustReplyEmpty(const std::string_view& da
 
 static std::optional<std::string> Cmd$qSupported(const std::string_view& data)
 {
-  return { "" };
+  return { StringUtil::StdStringFromFormat("PacketSize=%x", MAX_PACKET_SIZE) };
 }
 
 /// List of all GDB remote protocol packets supported by us.
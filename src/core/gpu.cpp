@@ -7,6 +7,7 @@
 #include "common/log.h"
 #include "common/string_util.h"
 #include "dma.h"
+#include "gpu_dump.h"
 #include "host.h"
 #include "host_display.h"
 #include "imgui.h"
@@ -16,6 +17,7 @@
 #include "system.h"
 #include "timers.h"
 #include "util/state_wrapper.h"
+#include "xxhash.h"
 #include <cmath>
 Log_SetChannel(GPU);
 
@@ -54,7 +56,7 @@ bool GPU::Initialize()
     Host::AddOSDMessage(Host::TranslateStdString("OSDMessage", "Failed to load post processing shader chain."), 20.0f);
   }
 
-  g_host_display->SetGPUTimingEnabled(g_settings.display_show_gpu);
+  g_host_display->SetGPUTimingEnabled(g_settings.display_show_gpu || g_settings.gpu_dynamic_resolution);
 
   return true;
 }
@@ -75,7 +77,7 @@ void GPU::UpdateSettings()
   // Crop mode calls this, so recalculate the display area
   UpdateCRTCDisplayParameters();
 
-  g_host_display->SetGPUTimingEnabled(g_settings.display_show_gpu);
+  g_host_display->SetGPUTimingEnabled(g_settings.display_show_gpu || g_settings.gpu_dynamic_resolution);
 }
 
 bool GPU::IsHardwareRenderer()
@@ -91,6 +93,8 @@ void GPU::CPUClockChanged()
 
 void GPU::UpdateResolutionScale() {}
 
+void GPU::UpdateDynamicResolution(float gpu_time_ms, float frame_time_budget_ms) {}
+
 std::tuple<u32, u32> GPU::GetEffectiveDisplayResolution(bool scaled /* = true */)
 {
   return std::tie(m_crtc_state.display_vram_width, m_crtc_state.display_vram_height);
@@ -268,10 +272,17 @@ bool GPU::DoState(StateWrapper& sw, GPUTexture** host_texture, bool update_displ
 
     if (sw.IsReading())
     {
-      // Still need a temporary here.
-      HeapArray<u16, VRAM_WIDTH * VRAM_HEIGHT> temp;
-      sw.DoBytes(temp.data(), VRAM_WIDTH * VRAM_HEIGHT * sizeof(u16));
-      UpdateVRAM(0, 0, VRAM_WIDTH, VRAM_HEIGHT, temp.data(), false, false);
+      // Memory states can be uploaded straight from the stream, otherwise we still need a temporary here.
+      if (const void* vram = sw.MapBytes(VRAM_WIDTH * VRAM_HEIGHT * sizeof(u16), alignof(u16)))
+      {
+        UpdateVRAM(0, 0, VRAM_WIDTH, VRAM_HEIGHT, vram, false, false);
+      }
+      else
+      {
+        HeapArray<u16, VRAM_WIDTH * VRAM_HEIGHT> temp;
+        sw.DoBytes(temp.data(), VRAM_WIDTH * VRAM_HEIGHT * sizeof(u16));
+        UpdateVRAM(0, 0, VRAM_WIDTH, VRAM_HEIGHT, temp.data(), false, false);
+      }
     }
     else
     {
@@ -367,6 +378,8 @@ u32 GPU::ReadRegister(u32 offset)
   switch (offset)
   {
     case 0x00:
+      if (UNLIKELY(m_dump_recorder))
+        m_dump_recorder->WriteReadVRAM(1);
       return ReadGPUREAD();
 
     case 0x04:
@@ -392,12 +405,16 @@ void GPU::WriteRegister(u32 offset, u32 value)
   switch (offset)
   {
     case 0x00:
+      if (UNLIKELY(m_dump_recorder))
+        m_dump_recorder->WriteGP0(value);
       m_fifo.Push(value);
       ExecuteCommands();
       UpdateCommandTickEvent();
       return;
 
     case 0x04:
+      if (UNLIKELY(m_dump_recorder))
+        m_dump_recorder->WriteGP1(value);
       WriteGP1(value);
       return;
 
@@ -416,10 +433,44 @@ void GPU::DMARead(u32* words, u32 word_count)
     return;
   }
 
+  if (UNLIKELY(m_dump_recorder))
+    m_dump_recorder->WriteReadVRAM(word_count);
+
   for (u32 i = 0; i < word_count; i++)
     words[i] = ReadGPUREAD();
 }
 
+void GPU::DMAWrite(u32 address, const u32* words, u32 word_count)
+{
+  if (word_count > m_fifo.GetSpace())
+  {
+    Log_WarningPrintf("GPU FIFO overflow, dropping %u words", word_count - m_fifo.GetSpace());
+    word_count = m_fifo.GetSpace();
+  }
+
+  if (UNLIKELY(m_dump_recorder))
+    m_dump_recorder->WriteGP0(words, word_count);
+
+  // The RAM address of each word is kept in the upper half of the FIFO entry for PGXP.
+  while (word_count > 0)
+  {
+    const u32 count = std::min(word_count, m_fifo.GetContiguousSpace());
+    u64* fifo_ptr = m_fifo.GetWritePointer();
+    for (u32 i = 0; i < count; i++)
+      fifo_ptr[i] = (ZeroExtend64(address + (i * sizeof(u32))) << 32) | ZeroExtend64(words[i]);
+
+    m_fifo.AdvanceTail(count);
+    address += count * sizeof(u32);
+    words += count;
+    word_count -= count;
+  }
+}
+
+void GPU::RecordDumpGP0(u32 value)
+{
+  m_dump_recorder->WriteGP0(value);
+}
+
 void GPU::EndDMAWrite()
 {
   m_fifo_pushed = true;
@@ -468,11 +519,6 @@ TickCount GPU::SystemTicksToCRTCTicks(TickCount sysclk_ticks, TickCount* fractio
   return ticks;
 }
 
-void GPU::AddCommandTicks(TickCount ticks)
-{
-  m_pending_command_ticks += ticks;
-}
-
 void GPU::SynchronizeCRTC()
 {
   m_crtc_tick_event->InvokeEarly();
@@ -901,8 +947,10 @@ void GPU::CRTCTickEvent(TickCount ticks)
         InterruptController::InterruptRequest(InterruptController::IRQ::VBLANK);
 
         // flush any pending draws and "scan out" the image
+        // interlaced fields are woven with the previous one, so they can't be skipped
         FlushRender();
-        UpdateDisplay();
+        if (!m_skip_display_update || IsInterlacedDisplayEnabled())
+          UpdateDisplay();
         System::FrameDone();
 
         // switch fields early. this is needed so we draw to the correct one.
@@ -910,6 +958,15 @@ void GPU::CRTCTickEvent(TickCount ticks)
           m_crtc_state.interlaced_display_field = m_crtc_state.interlaced_field ^ 1u;
         else
           m_crtc_state.interlaced_display_field = 0;
+
+        if (UNLIKELY(m_dump_recorder))
+        {
+          const u32 field_state = ZeroExtend32(m_crtc_state.interlaced_field) |
+                                  (ZeroExtend32(m_crtc_state.interlaced_display_field) << 8) |
+                                  (ZeroExtend32(m_crtc_state.active_line_lsb) << 16);
+          if (!m_dump_recorder->WriteVSync(field_state))
+            StopRecordingDump();
+        }
       }
 
       Timers::SetGate(HBLANK_TIMER_INDEX, new_vblank);
@@ -976,6 +1033,80 @@ void GPU::UpdateCommandTickEvent()
     m_command_tick_event->SetIntervalAndSchedule(GPUTicksToSystemTicks(m_pending_command_ticks));
 }
 
+bool GPU::StartRecordingDump(const char* path, u32 num_frames)
+{
+  if (m_dump_recorder)
+    StopRecordingDump();
+
+  // Drawing has to be flushed before VRAM is read back for the initial state.
+  FlushRender();
+  m_dump_recorder = GPUDump::Recorder::Create(path, System::GetRegion(), num_frames);
+  return static_cast<bool>(m_dump_recorder);
+}
+
+void GPU::StopRecordingDump()
+{
+  if (!m_dump_recorder)
+    return;
+
+  std::unique_ptr<GPUDump::Recorder> recorder = std::move(m_dump_recorder);
+  if (recorder->Close())
+  {
+    Host::AddFormattedOSDMessage(5.0f, Host::TranslateString("OSDMessage", "Saved GPU dump to '%s'."),
+                                 recorder->GetPath().c_str());
+  }
+  else
+  {
+    Host::AddFormattedOSDMessage(10.0f, Host::TranslateString("OSDMessage", "Failed to save GPU dump to '%s'."),
+                                 recorder->GetPath().c_str());
+  }
+}
+
+void GPU::ReplayGP0(const u32* words, u32 word_count)
+{
+  // The dump was recorded with the FIFO never overflowing, so only running out of space between commands matters.
+  while (word_count > 0)
+  {
+    const u32 count = std::min(word_count, m_fifo.GetSpace());
+    for (u32 i = 0; i < count; i++)
+      m_fifo.Push(ZeroExtend64(words[i]));
+    words += count;
+    word_count -= count;
+
+    m_pending_command_ticks = 0;
+    ExecuteCommands();
+
+    if (word_count > 0 && m_fifo.GetSpace() == 0)
+    {
+      Log_WarningPrintf("GPU FIFO stalled in dump replay, dropping %u words", word_count);
+      break;
+    }
+  }
+
+  m_pending_command_ticks = 0;
+}
+
+void GPU::ReplayGP1(u32 value)
+{
+  WriteGP1(value);
+}
+
+void GPU::ReplayReadVRAM(u32 word_count)
+{
+  for (u32 i = 0; i < word_count; i++)
+    ReadGPUREAD();
+}
+
+void GPU::ReplayVSync(u32 field_state)
+{
+  FlushRender();
+  UpdateDisplay();
+
+  m_crtc_state.interlaced_field = Truncate8(field_state);
+  m_crtc_state.interlaced_display_field = Truncate8(field_state >> 8);
+  m_crtc_state.active_line_lsb = Truncate8(field_state >> 16);
+}
+
 bool GPU::ConvertScreenCoordinatesToBeamTicksAndLines(s32 window_x, s32 window_y, float x_scale, u32* out_tick,
                                                       u32* out_line) const
 {
@@ -1511,6 +1642,12 @@ void GPU::SetTextureWindow(u32 value)
   m_draw_mode.texture_window_changed = true;
 }
 
+u64 GPU::GetVRAMHash()
+{
+  ReadVRAM(0, 0, VRAM_WIDTH, VRAM_HEIGHT);
+  return XXH3_64bits(m_vram_ptr, VRAM_WIDTH * VRAM_HEIGHT * sizeof(u16));
+}
+
 bool GPU::DumpVRAMToFile(const char* filename)
 {
   ReadVRAM(0, 0, VRAM_WIDTH, VRAM_HEIGHT);
@@ -22,6 +22,10 @@ class GPUTexture;
 
 class TimingEvent;
 
+namespace GPUDump {
+class Recorder;
+}
+
 namespace Threading
 {
 class Thread;
@@ -82,6 +86,7 @@ public:
 
   virtual GPURenderer GetRendererType() const = 0;
   virtual const Threading::Thread* GetSWThread() const = 0;
+  virtual GPUBackendThreadStats GetAndResetSWThreadStats() = 0;
 
   virtual bool Initialize();
   virtual void Reset(bool clear_vram);
@@ -108,9 +113,26 @@ public:
   ALWAYS_INLINE void DMAWrite(u32 address, u32 value)
   {
     m_fifo.Push((ZeroExtend64(address) << 32) | ZeroExtend64(value));
+    if (UNLIKELY(m_dump_recorder))
+      RecordDumpGP0(value);
   }
+
+  /// Writes a block of words which were read from contiguous RAM starting at address.
+  void DMAWrite(u32 address, const u32* words, u32 word_count);
   void EndDMAWrite();
 
+  /// Records the current state and all commands sent to the GPU to a file. If num_frames is zero, recording
+  /// continues until StopRecordingDump() is called.
+  bool StartRecordingDump(const char* path, u32 num_frames);
+  void StopRecordingDump();
+  ALWAYS_INLINE bool IsRecordingDump() const { return static_cast<bool>(m_dump_recorder); }
+
+  // GPU dump replay, commands are executed immediately without any timing.
+  void ReplayGP0(const u32* words, u32 word_count);
+  void ReplayGP1(u32 value);
+  void ReplayReadVRAM(u32 word_count);
+  void ReplayVSync(u32 field_state);
+
   /// Returns true if no data is being sent from VRAM to the DAC or that no portion of VRAM would be visible on screen.
   ALWAYS_INLINE bool IsDisplayDisabled() const
   {
@@ -129,6 +151,14 @@ public:
     return (!m_force_progressive_scan) && m_GPUSTAT.SkipDrawingToActiveField();
   }
 
+  /// Skips the host-side display update at the next vblanks, for frames which are replaced before being presented.
+  /// Drawing still happens as normal, since later frames can sample anything written to VRAM.
+  ALWAYS_INLINE void SetSkipDisplayUpdate(bool skip) { m_skip_display_update = skip; }
+
+  /// Discards primitive draws instead of rendering them, for replayed runahead frames. VRAM writes, fills and copies
+  /// still happen. Only the hardware renderers honour this.
+  ALWAYS_INLINE void SetSkipRendering(bool skip) { m_skip_rendering = skip; }
+
   /// Returns true if we're in PAL mode, otherwise false if NTSC.
   ALWAYS_INLINE bool IsInPALMode() const { return m_GPUSTAT.pal_mode; }
 
@@ -151,6 +181,9 @@ public:
   /// Updates the resolution scale when it's set to automatic.
   virtual void UpdateResolutionScale();
 
+  /// Adjusts the resolution scale for dynamic resolution, from the GPU time of the frame which was just presented.
+  virtual void UpdateDynamicResolution(float gpu_time_ms, float frame_time_budget_ms);
+
   /// Returns the effective display resolution of the GPU.
   virtual std::tuple<u32, u32> GetEffectiveDisplayResolution(bool scaled = true);
 
@@ -192,6 +225,9 @@ public:
   // Dumps raw VRAM to a file.
   bool DumpVRAMToFile(const char* filename);
 
+  // Returns a hash of the entire VRAM, reading it back from the host GPU if needed.
+  u64 GetVRAMHash();
+
 protected:
   TickCount CRTCTicksToSystemTicks(TickCount crtc_ticks, TickCount fractional_ticks) const;
   TickCount SystemTicksToCRTCTicks(TickCount sysclk_ticks, TickCount* fractional_ticks) const;
@@ -278,9 +314,10 @@ protected:
       *y = m_drawing_area.bottom - 1;
   }
 
-  void AddCommandTicks(TickCount ticks);
+  ALWAYS_INLINE void AddCommandTicks(TickCount ticks) { m_pending_command_ticks += ticks; }
 
   void WriteGP1(u32 value);
+  void RecordDumpGP0(u32 value);
   void EndCommand();
   void ExecuteCommands();
   void HandleGetGPUInfoCommand(u32 value);
@@ -452,6 +489,8 @@ protected:
   bool m_drawing_area_changed = false;
   bool m_force_progressive_scan = false;
   bool m_force_ntsc_timings = false;
+  bool m_skip_display_update = false;
+  bool m_skip_rendering = false;
 
   struct CRTCState
   {
@@ -560,6 +599,8 @@ protected:
   TickCount m_max_run_ahead = 128;
   u32 m_fifo_size = 128;
 
+  std::unique_ptr<GPUDump::Recorder> m_dump_recorder;
+
   struct Stats
   {
     u32 num_vram_reads;
@@ -4,9 +4,13 @@
 #include "gpu_backend.h"
 #include "common/align.h"
 #include "common/log.h"
+#include "common/threading.h"
 #include "common/timer.h"
+#include "common/trace.h"
 #include "settings.h"
 #include "util/state_wrapper.h"
+#include <algorithm>
+#include <utility>
 Log_SetChannel(GPUBackend);
 
 std::unique_ptr<GPUBackend> g_gpu_backend;
@@ -158,17 +162,21 @@ void GPUBackend::PushCommand(GPUBackendCommand* cmd)
     const u32 new_write_ptr = m_command_fifo_write_ptr.fetch_add(cmd->size) + cmd->size;
     DebugAssert(new_write_ptr <= COMMAND_QUEUE_SIZE);
     UNREFERENCED_VARIABLE(new_write_ptr);
-    if (GetPendingCommandSize() >= THRESHOLD_TO_WAKE_GPU)
+
+    // A spinning GPU thread picks the command up by itself, so only consider waking it when it's parked.
+    if (m_gpu_thread_sleeping.load() && GetPendingCommandSize() >= m_wake_threshold)
       WakeGPUThread();
   }
 }
 
 void GPUBackend::WakeGPUThread()
 {
-  std::unique_lock<std::mutex> lock(m_sync_mutex);
+  // The sleeping flag is set with the lock held before the GPU thread re-checks the queue, so if it's clear here, the
+  // thread is guaranteed to see our write pointer without us having to take the lock.
   if (!m_gpu_thread_sleeping.load())
     return;
 
+  std::unique_lock<std::mutex> lock(m_sync_mutex);
   m_wake_gpu_thread_cv.notify_one();
 }
 
@@ -176,7 +184,11 @@ void GPUBackend::StartGPUThread()
 {
   m_gpu_loop_done.store(false);
   m_use_gpu_thread = true;
-  m_gpu_thread.Start([this]() { RunGPULoop(); });
+  m_gpu_thread.Start([this]() {
+    Threading::SetNameOfCurrentThread("GPU Thread");
+    Threading::ApplyAffinityPolicy(Threading::AffinityClass::EmulationGPU);
+    RunGPULoop();
+  });
   Log_InfoPrint("GPU thread started.");
 }
 
@@ -194,16 +206,69 @@ void GPUBackend::StopGPUThread()
 
 void GPUBackend::Sync(bool allow_sleep)
 {
+  static constexpr double SPIN_TIME_NS = 100 * 1000;
+
   if (!m_use_gpu_thread)
     return;
 
+  const bool has_pending_commands = (GetPendingCommandSize() > 0);
+
+  // The read pointer only moves past a batch once it's been flushed, so an empty queue means VRAM is already current.
+  // Readbacks from the mirrored software renderer hit this often, and don't need to wake a parked GPU thread for it.
+  // End-of-frame syncs still go through, they're what lets the GPU thread park and adjusts the wake threshold.
+  if (!has_pending_commands && !allow_sleep)
+    return;
+
   GPUBackendSyncCommand* cmd =
     static_cast<GPUBackendSyncCommand*>(AllocateCommand(GPUBackendCommandType::Sync, sizeof(GPUBackendSyncCommand)));
   cmd->allow_sleep = allow_sleep;
   PushCommand(cmd);
   WakeGPUThread();
 
-  m_sync_semaphore.Wait();
+  // Most syncs complete within a few microseconds, so spin before falling back to the semaphore.
+  const Common::Timer::Value start_time = Common::Timer::GetCurrentValue();
+  Common::Timer::Value current_time = start_time;
+  bool parked = false;
+  while (!m_sync_done.load())
+  {
+    current_time = Common::Timer::GetCurrentValue();
+    if (Common::Timer::ConvertValueToNanoseconds(current_time - start_time) < SPIN_TIME_NS)
+      continue;
+
+    // If the GPU thread finished after we set the flag but before it saw it, there won't be a post to consume.
+    m_cpu_thread_sleeping.store(true);
+    if (!m_sync_done.load() || !m_cpu_thread_sleeping.exchange(false))
+      m_sync_semaphore.Wait();
+
+    current_time = Common::Timer::GetCurrentValue();
+    parked = true;
+    break;
+  }
+  m_sync_done.store(false);
+
+  if (has_pending_commands)
+  {
+    m_sync_stalls++;
+    m_sync_stall_time += current_time - start_time;
+  }
+
+  // End-of-frame syncs tell us whether the GPU thread is keeping up. If we had to park, wake it sooner next frame,
+  // otherwise let more commands batch up so the CPU thread spends less time in the kernel.
+  if (allow_sleep)
+  {
+    m_wake_threshold = parked ? std::max<u32>(m_wake_threshold / 2, MIN_THRESHOLD_TO_WAKE_GPU) :
+                                std::min<u32>(m_wake_threshold * 2, MAX_THRESHOLD_TO_WAKE_GPU);
+  }
+}
+
+GPUBackendThreadStats GPUBackend::GetAndResetThreadStats()
+{
+  GPUBackendThreadStats stats;
+  stats.wakeups = m_gpu_thread_wakeups.exchange(0);
+  stats.sync_stalls = std::exchange(m_sync_stalls, 0u);
+  stats.sync_stall_time_ms =
+    static_cast<float>(Common::Timer::ConvertValueToMilliseconds(std::exchange(m_sync_stall_time, 0)));
+  return stats;
 }
 
 void GPUBackend::RunGPULoop()
@@ -225,6 +290,7 @@ void GPUBackend::RunGPULoop()
       m_gpu_thread_sleeping.store(true);
       m_wake_gpu_thread_cv.wait(lock, [this]() { return m_gpu_loop_done.load() || GetPendingCommandSize() > 0; });
       m_gpu_thread_sleeping.store(false);
+      m_gpu_thread_wakeups.fetch_add(1, std::memory_order_relaxed);
 
       if (m_gpu_loop_done.load())
         break;
@@ -235,6 +301,7 @@ void GPUBackend::RunGPULoop()
     if (write_ptr < read_ptr)
       write_ptr = COMMAND_QUEUE_SIZE;
 
+    TRACE_SCOPE("ProcessGPUCommands");
     bool allow_sleep = false;
     while (read_ptr < write_ptr)
     {
@@ -254,7 +321,10 @@ void GPUBackend::RunGPULoop()
         case GPUBackendCommandType::Sync:
         {
           DebugAssert(read_ptr == write_ptr);
-          m_sync_semaphore.Post();
+          FlushRender();
+          m_sync_done.store(true);
+          if (m_cpu_thread_sleeping.exchange(false))
+            m_sync_semaphore.Post();
           allow_sleep = static_cast<const GPUBackendSyncCommand*>(cmd)->allow_sleep;
         }
         break;
@@ -265,6 +335,9 @@ void GPUBackend::RunGPULoop()
       }
     }
 
+    // Commands can still be referenced by the renderer until it's flushed, so don't let them be overwritten.
+    FlushRender();
+
     last_command_time = allow_sleep ? 0 : Common::Timer::GetCurrentValue();
     m_command_fifo_read_ptr.store(read_ptr);
   }
@@ -4,6 +4,7 @@
 #pragma once
 #include "common/heap_array.h"
 #include "common/threading.h"
+#include "common/timer.h"
 #include "gpu_types.h"
 #include <atomic>
 #include <condition_variable>
@@ -41,6 +42,9 @@ public:
   void PushCommand(GPUBackendCommand* cmd);
   void Sync(bool allow_sleep);
 
+  /// Returns wakeup/stall counters accumulated since the last call. Must be called from the CPU thread.
+  GPUBackendThreadStats GetAndResetThreadStats();
+
   /// Processes all pending GPU commands.
   void RunGPULoop();
 
@@ -62,7 +66,7 @@ protected:
   virtual void FlushRender() = 0;
   virtual void DrawingAreaChanged() = 0;
 
-  void HandleCommand(const GPUBackendCommand* cmd);
+  virtual void HandleCommand(const GPUBackendCommand* cmd);
 
   u16* m_vram_ptr = nullptr;
 
@@ -75,16 +79,26 @@ protected:
   bool m_use_gpu_thread = false;
 
   std::mutex m_sync_mutex;
-  std::condition_variable m_sync_cpu_thread_cv;
   std::condition_variable m_wake_gpu_thread_cv;
-  bool m_sync_done = false;
+
+  // The GPU thread only posts the sync semaphore when the CPU thread gave up spinning and parked.
+  std::atomic_bool m_sync_done{false};
+  std::atomic_bool m_cpu_thread_sleeping{false};
 
   enum : u32
   {
     COMMAND_QUEUE_SIZE = 4 * 1024 * 1024,
-    THRESHOLD_TO_WAKE_GPU = 256
+    MIN_THRESHOLD_TO_WAKE_GPU = 256,
+    MAX_THRESHOLD_TO_WAKE_GPU = 16 * 1024
   };
 
+  // Pending bytes before a parked GPU thread is woken, adjusted at the end of each frame.
+  u32 m_wake_threshold = MIN_THRESHOLD_TO_WAKE_GPU;
+
+  std::atomic<u32> m_gpu_thread_wakeups{0};
+  u32 m_sync_stalls = 0;
+  Common::Timer::Value m_sync_stall_time = 0;
+
   HeapArray<u8, COMMAND_QUEUE_SIZE> m_command_fifo_data;
   alignas(64) std::atomic<u32> m_command_fifo_read_ptr{0};
   alignas(64) std::atomic<u32> m_command_fifo_write_ptr{0};
@@ -37,11 +37,17 @@ void GPU::ExecuteCommands()
       {
         case BlitterState::Idle:
         {
-          const u32 command = FifoPeek(0) >> 24;
-          if ((this->*s_GP0_command_handler_table[command])())
-            continue;
-          else
-            goto batch_done;
+          // Display lists are mostly runs of fully buffered primitives and state changes, so keep going here until a
+          // command is incomplete or starts a transfer, rather than going back through the checks above each time.
+          do
+          {
+            const u32 command = FifoPeek(0) >> 24;
+            if (!(this->*s_GP0_command_handler_table[command])())
+              goto batch_done;
+          } while (m_blitter_state == BlitterState::Idle && m_pending_command_ticks <= m_max_run_ahead &&
+                   !m_fifo.IsEmpty());
+
+          continue;
         }
 
         case BlitterState::WritingVRAM:
@@ -0,0 +1,334 @@
+// SPDX-FileCopyrightText: 2019-2023 Connor McLaughlin <stenzek@gmail.com>
+// SPDX-License-Identifier: (GPL-3.0 OR CC-BY-NC-ND-4.0)
+
+#include "gpu_dump.h"
+#include "common/byte_stream.h"
+#include "common/error.h"
+#include "common/file_system.h"
+#include "common/log.h"
+#include "gpu.h"
+#include "save_state_version.h"
+#include "settings.h"
+#include "util/state_wrapper.h"
+#include <algorithm>
+#include <cstring>
+#include <optional>
+Log_SetChannel(GPUDump);
+
+namespace GPUDump {
+
+static constexpr u32 DUMP_SIGNATURE = 0x504D4447; // GDMP
+static constexpr u32 DUMP_VERSION = 1;
+
+// Uncompressed, the remainder of the file is a zstd stream holding the GPU state size and data, then the packets.
+#pragma pack(push, 4)
+struct DumpHeader
+{
+  u32 signature;
+  u32 version;
+  u32 state_version;
+  u32 region;
+};
+#pragma pack(pop)
+
+// Each packet is the type, then the number of words which follow.
+static constexpr u32 PACKET_HEADER_SIZE = sizeof(u8) + sizeof(u32);
+
+Recorder::Recorder(std::string path, u32 num_frames) : m_path(std::move(path)), m_frames_remaining(num_frames) {}
+
+Recorder::~Recorder()
+{
+  if (m_file)
+    Close();
+}
+
+std::unique_ptr<Recorder> Recorder::Create(const char* path, ConsoleRegion region, u32 num_frames)
+{
+  std::unique_ptr<Recorder> recorder(new Recorder(path, num_frames));
+  recorder->m_file =
+    ByteStream::OpenFile(path, BYTESTREAM_OPEN_CREATE | BYTESTREAM_OPEN_WRITE | BYTESTREAM_OPEN_TRUNCATE |
+                                 BYTESTREAM_OPEN_ATOMIC_UPDATE | BYTESTREAM_OPEN_STREAMED);
+  if (!recorder->m_file)
+  {
+    Log_ErrorPrintf("Failed to open GPU dump '%s' for writing.", path);
+    return {};
+  }
+
+  const DumpHeader header = {DUMP_SIGNATURE, DUMP_VERSION, SAVE_STATE_VERSION, static_cast<u32>(region)};
+  if (!recorder->m_file->Write2(&header, sizeof(header)))
+  {
+    Log_ErrorPrintf("Failed to write GPU dump header to '%s'.", path);
+    recorder->m_file->Discard();
+    recorder->m_file.reset();
+    return {};
+  }
+
+  // The state goes through a temporary so its size can be written first.
+  std::unique_ptr<GrowableMemoryByteStream> state(ByteStream::CreateGrowableMemoryStream());
+  {
+    StateWrapper sw(state.get(), StateWrapper::Mode::Write, SAVE_STATE_VERSION);
+    if (!g_gpu->DoState(sw, nullptr, false))
+    {
+      Log_ErrorPrintf("Failed to save GPU state for dump.");
+      recorder->m_file->Discard();
+      recorder->m_file.reset();
+      return {};
+    }
+  }
+
+  const u32 state_size = static_cast<u32>(state->GetPosition());
+  recorder->m_stream = ByteStream::CreateZstdCompressStream(recorder->m_file.get(), 0);
+  if (!recorder->m_stream->WriteU32(state_size) || !recorder->m_stream->Write2(state->GetMemoryPointer(), state_size))
+  {
+    Log_ErrorPrintf("Failed to write GPU state to '%s'.", path);
+    recorder->m_stream.reset();
+    recorder->m_file->Discard();
+    recorder->m_file.reset();
+    return {};
+  }
+
+  Log_InfoPrintf("Started GPU dump to '%s' (%u bytes of state).", path, state_size);
+  return recorder;
+}
+
+void Recorder::WriteGP0(const u32* words, u32 word_count)
+{
+  m_gp0_buffer.insert(m_gp0_buffer.end(), words, words + word_count);
+}
+
+void Recorder::WriteGP1(u32 value)
+{
+  FlushGP0();
+  WritePacket(PacketType::GP1Write, &value, 1);
+}
+
+void Recorder::WriteReadVRAM(u32 word_count)
+{
+  // Reads are usually made one word at a time through the port, so they're merged until something else is written.
+  if (!m_gp0_buffer.empty())
+    FlushGP0();
+
+  m_pending_read_words += word_count;
+}
+
+bool Recorder::WriteVSync(u32 field_state)
+{
+  FlushGP0();
+  WritePacket(PacketType::VSync, &field_state, 1);
+  m_frames_recorded++;
+
+  return (m_frames_remaining == 0 || --m_frames_remaining > 0);
+}
+
+void Recorder::FlushGP0()
+{
+  if (m_pending_read_words > 0)
+  {
+    const u32 count = m_pending_read_words;
+    m_pending_read_words = 0;
+    WritePacket(PacketType::ReadVRAM, &count, 1);
+  }
+
+  if (!m_gp0_buffer.empty())
+  {
+    WritePacket(PacketType::GP0Data, m_gp0_buffer.data(), static_cast<u32>(m_gp0_buffer.size()));
+    m_gp0_buffer.clear();
+  }
+}
+
+void Recorder::WritePacket(PacketType type, const u32* words, u32 word_count)
+{
+  if (m_failed)
+    return;
+
+  if (!m_stream->WriteU8(static_cast<u8>(type)) || !m_stream->WriteU32(word_count) ||
+      !m_stream->Write2(words, word_count * sizeof(u32)))
+  {
+    Log_ErrorPrintf("Failed to write to GPU dump '%s', the rest of the recording will be dropped.", m_path.c_str());
+    m_failed = true;
+  }
+}
+
+bool Recorder::Close()
+{
+  FlushGP0();
+
+  const bool result = (!m_failed && m_stream->Commit() && m_file->Commit());
+  m_stream.reset();
+  if (!result)
+    m_file->Discard();
+  m_file.reset();
+
+  if (result)
+    Log_InfoPrintf("Finished GPU dump '%s' with %u frames.", m_path.c_str(), m_frames_recorded);
+  else
+    Log_ErrorPrintf("Failed to finish GPU dump '%s'.", m_path.c_str());
+
+  return result;
+}
+
+Player::Player(std::unique_ptr<GrowableMemoryByteStream> data, u32 data_size, ConsoleRegion region,
+               u32 state_version, u32 state_size)
+  : m_data(std::move(data)), m_data_size(data_size), m_region(region), m_state_version(state_version),
+    m_state_size(state_size)
+{
+}
+
+Player::~Player() = default;
+
+std::unique_ptr<Player> Player::Open(const char* path, Common::Error* error)
+{
+  std::optional<std::vector<u8>> file_data = FileSystem::ReadBinaryFile(path);
+  if (!file_data.has_value())
+  {
+    error->SetFormattedMessage("Failed to read '%s'.", path);
+    return {};
+  }
+
+  DumpHeader header;
+  if (file_data->size() < sizeof(header))
+  {
+    error->SetMessage("File is too small to be a GPU dump.");
+    return {};
+  }
+
+  std::memcpy(&header, file_data->data(), sizeof(header));
+  if (header.signature != DUMP_SIGNATURE || header.version != DUMP_VERSION)
+  {
+    error->SetMessage("File is not a GPU dump, or was created by an incompatible version.");
+    return {};
+  }
+  if (header.state_version < SAVE_STATE_MINIMUM_VERSION || header.state_version > SAVE_STATE_VERSION ||
+      header.region >= static_cast<u32>(ConsoleRegion::Count))
+  {
+    error->SetFormattedMessage("GPU dump uses an unsupported state version (%u).", header.state_version);
+    return {};
+  }
+
+  // Decompressed up front, so the replay only measures the GPU.
+  std::unique_ptr<GrowableMemoryByteStream> data(ByteStream::CreateGrowableMemoryStream());
+  {
+    std::unique_ptr<ByteStream> dstream(ByteStream::CreateZstdDecompressStream(
+      file_data->data() + sizeof(header), static_cast<u32>(file_data->size() - sizeof(header))));
+    u8 chunk[65536];
+    u32 bytes_read;
+    while ((bytes_read = dstream->Read(chunk, sizeof(chunk))) > 0)
+      data->Write(chunk, bytes_read);
+  }
+
+  u32 state_size = 0;
+  const u32 data_size = static_cast<u32>(data->GetPosition());
+  if (data_size >= sizeof(state_size))
+    std::memcpy(&state_size, data->GetMemoryPointer(), sizeof(state_size));
+  if (data_size < sizeof(state_size) || state_size > (data_size - sizeof(state_size)))
+  {
+    error->SetMessage("GPU dump is truncated.");
+    return {};
+  }
+
+  Log_InfoPrintf("Opened GPU dump '%s' (%u bytes, %u bytes of state).", path, data_size, state_size);
+  return std::unique_ptr<Player>(new Player(std::move(data), data_size, static_cast<ConsoleRegion>(header.region),
+                                            header.state_version, state_size));
+}
+
+bool Player::LoadInitialState()
+{
+  std::unique_ptr<ReadOnlyMemoryByteStream> stream(
+    ByteStream::CreateReadOnlyMemoryStream(m_data->GetMemoryPointer() + sizeof(u32), m_state_size));
+  StateWrapper sw(stream.get(), StateWrapper::Mode::Read, m_state_version);
+  if (!g_gpu->DoState(sw, nullptr, true))
+  {
+    Log_ErrorPrintf("Failed to load GPU state from dump.");
+    return false;
+  }
+
+  m_position = sizeof(u32) + m_state_size;
+  m_loop_timer.Reset();
+  m_last_frame_time = Common::Timer::GetCurrentValue();
+  m_loop_frames = 0;
+  m_min_frame_time = 0.0;
+  m_max_frame_time = 0.0;
+  return true;
+}
+
+void Player::ProcessFrame()
+{
+  const Common::Timer::Value current_time = Common::Timer::GetCurrentValue();
+  if (m_loop_frames > 0)
+  {
+    const double frame_time = Common::Timer::ConvertValueToMilliseconds(current_time - m_last_frame_time);
+    m_min_frame_time = (m_loop_frames == 1) ? frame_time : std::min(m_min_frame_time, frame_time);
+    m_max_frame_time = std::max(m_max_frame_time, frame_time);
+  }
+  m_last_frame_time = current_time;
+
+  const u8* data = m_data->GetMemoryPointer();
+  const u32 data_size = m_data_size;
+  bool looped = false;
+  for (;;)
+  {
+    if ((data_size - m_position) < PACKET_HEADER_SIZE)
+    {
+      // Don't spin on dumps without any frames.
+      LogLoopStatistics();
+      if (looped || !LoadInitialState())
+        return;
+
+      looped = true;
+      continue;
+    }
+
+    const PacketType type = static_cast<PacketType>(data[m_position]);
+    u32 word_count;
+    std::memcpy(&word_count, &data[m_position + 1], sizeof(word_count));
+    m_position += PACKET_HEADER_SIZE;
+    if (word_count > ((data_size - m_position) / sizeof(u32)))
+    {
+      Log_ErrorPrintf("Truncated packet in GPU dump, restarting.");
+      m_position = data_size;
+      continue;
+    }
+
+    const u32* words = reinterpret_cast<const u32*>(&data[m_position]);
+    m_position += word_count * sizeof(u32);
+    if (word_count == 0)
+      continue;
+
+    switch (type)
+    {
+      case PacketType::GP0Data:
+        g_gpu->ReplayGP0(words, word_count);
+        break;
+
+      case PacketType::GP1Write:
+        g_gpu->ReplayGP1(words[0]);
+        break;
+
+      case PacketType::ReadVRAM:
+        g_gpu->ReplayReadVRAM(words[0]);
+        break;
+
+      case PacketType::VSync:
+        g_gpu->ReplayVSync(words[0]);
+        m_loop_frames++;
+        return;
+
+      default:
+        Log_ErrorPrintf("Unknown packet type %u in GPU dump", static_cast<u32>(type));
+        break;
+    }
+  }
+}
+
+void Player::LogLoopStatistics()
+{
+  if (m_loop_frames == 0)
+    return;
+
+  const double total_time = m_loop_timer.GetTimeMilliseconds();
+  Log_InfoPrintf("GPU dump loop %u: %u frames in %.2f ms, %.3f ms/frame avg (%.3f min, %.3f max), %.2f FPS",
+                 ++m_loop_count, m_loop_frames, total_time, total_time / static_cast<double>(m_loop_frames),
+                 m_min_frame_time, m_max_frame_time, static_cast<double>(m_loop_frames) * 1000.0 / total_time);
+}
+
+} // namespace GPUDump
@@ -0,0 +1,105 @@
+// SPDX-FileCopyrightText: 2019-2023 Connor McLaughlin <stenzek@gmail.com>
+// SPDX-License-Identifier: (GPL-3.0 OR CC-BY-NC-ND-4.0)
+
+#pragma once
+#include "common/timer.h"
+#include "types.h"
+#include <memory>
+#include <string>
+#include <vector>
+
+class ByteStream;
+class GrowableMemoryByteStream;
+
+namespace Common {
+class Error;
+}
+
+/// GPU dumps hold the GPU state at the start of the recording, plus every GP0/GP1 write and GPUREAD made by the CPU.
+/// Replaying one drives the GPU on its own, so renderers can be measured on an identical workload.
+namespace GPUDump {
+
+enum class PacketType : u8
+{
+  GP0Data,   // Words written to GP0, through the port or DMA.
+  GP1Write,  // One word written to GP1.
+  ReadVRAM,  // Number of words read from GPUREAD.
+  VSync,     // End of a frame, the word holds the field state after the vblank.
+};
+
+static constexpr const char* FILE_EXTENSION = ".psxgpu";
+
+class Recorder
+{
+public:
+  ~Recorder();
+
+  /// Writes the current GPU state to a new dump file. If num_frames is zero, recording continues until closed.
+  static std::unique_ptr<Recorder> Create(const char* path, ConsoleRegion region, u32 num_frames);
+
+  ALWAYS_INLINE const std::string& GetPath() const { return m_path; }
+
+  ALWAYS_INLINE void WriteGP0(u32 word) { m_gp0_buffer.push_back(word); }
+  void WriteGP0(const u32* words, u32 word_count);
+  void WriteGP1(u32 value);
+  void WriteReadVRAM(u32 word_count);
+
+  /// Returns false once the requested number of frames have been recorded.
+  bool WriteVSync(u32 field_state);
+
+  bool Close();
+
+private:
+  Recorder(std::string path, u32 num_frames);
+
+  void FlushGP0();
+  void WritePacket(PacketType type, const u32* words, u32 word_count);
+
+  std::string m_path;
+  std::unique_ptr<ByteStream> m_file;
+  std::unique_ptr<ByteStream> m_stream;
+  std::vector<u32> m_gp0_buffer;
+
+  u32 m_pending_read_words = 0;
+  u32 m_frames_remaining;
+  u32 m_frames_recorded = 0;
+  bool m_failed = false;
+};
+
+class Player
+{
+public:
+  ~Player();
+
+  static std::unique_ptr<Player> Open(const char* path, Common::Error* error);
+
+  ALWAYS_INLINE ConsoleRegion GetRegion() const { return m_region; }
+
+  /// Restores the GPU state at the start of the dump.
+  bool LoadInitialState();
+
+  /// Replays packets up to and including the next vsync, looping back to the start at the end of the dump.
+  void ProcessFrame();
+
+private:
+  Player(std::unique_ptr<GrowableMemoryByteStream> data, u32 data_size, ConsoleRegion region, u32 state_version,
+         u32 state_size);
+
+  void LogLoopStatistics();
+
+  std::unique_ptr<GrowableMemoryByteStream> m_data;
+  u32 m_data_size;
+  ConsoleRegion m_region;
+  u32 m_state_version;
+  u32 m_state_size;
+  u32 m_position = 0;
+
+  u32 m_loop_count = 0;
+  u32 m_loop_frames = 0;
+  Common::Timer m_loop_timer;
+  Common::Timer::Value m_last_frame_time = 0;
+  double m_min_frame_time = 0.0;
+  double m_max_frame_time = 0.0;
+};
+
+} // namespace GPUDump
@@ -4,10 +4,13 @@
 #include "gpu_hw.h"
 #include "common/align.h"
 #include "common/assert.h"
+#include "common/bitutils.h"
 #include "common/log.h"
 #include "cpu_core.h"
+#include "gpu_backend.h"
 #include "gpu_sw_backend.h"
 #include "host.h"
+#include "host_display.h"
 #include "imgui.h"
 #include "pgxp.h"
 #include "settings.h"
@@ -33,11 +36,168 @@ ALWAYS_INLINE static bool ShouldUseUVLimits()
   return g_settings.gpu_pgxp_enable || g_settings.gpu_texture_filter != GPUTextureFilter::Nearest;
 }
 
+ALWAYS_INLINE static bool IsSameBatchTextureMode(GPUTextureMode mode1, GPUTextureMode mode2)
+{
+  // The palette mode is decoded from each vertex's texpage in the shader, so only untextured and raw texturing need a
+  // different pipeline.
+  if (mode1 == GPUTextureMode::Disabled || mode2 == GPUTextureMode::Disabled)
+    return (mode1 == mode2);
+
+  return ((mode1 & GPUTextureMode::RawTextureBit) == (mode2 & GPUTextureMode::RawTextureBit));
+}
+
 ALWAYS_INLINE static bool ShouldDisableColorPerspective()
 {
   return g_settings.gpu_pgxp_enable && g_settings.gpu_pgxp_texture_correction && !g_settings.gpu_pgxp_color_correction;
 }
 
+#ifdef _MSC_VER
+#pragma warning(push)
+#pragma warning(disable : 4200) // warning C4200: nonstandard extension used: zero-sized array in struct/union
+#endif
+
+// Replays recorded batches on a separate thread, so the emulation thread only has to generate vertices. Runs on the
+// same command FIFO as the software renderer, but never sees any of the software renderer's commands.
+class GPU_HW::RenderThread final : public GPUBackend
+{
+public:
+  enum : u32
+  {
+    STAGING_VERTEX_COUNT = (1024 * 1024) / sizeof(BatchVertex)
+  };
+
+  struct SetScissorCommand : public GPUBackendCommand
+  {
+    Common::Rectangle<u32> drawing_area;
+  };
+
+  struct UpdateVRAMReadTextureCommand : public GPUBackendCommand
+  {
+    Common::Rectangle<u32> rect;
+  };
+
+  struct DepthBufferCommand : public GPUBackendCommand
+  {
+    Common::Rectangle<u32> rect;
+  };
+
+  struct DecodePaletteTextureCommand : public GPUBackendCommand
+  {
+    u32 slot;
+    u32 texpage;
+  };
+
+  struct DrawBatchCommand : public GPUBackendCommand
+  {
+    BatchConfig batch;
+    BatchUBOData ubo_data;
+    bool ubo_dirty;
+    bool two_pass;
+    u32 num_vertices;
+    BatchVertex vertices[0];
+  };
+
+  RenderThread(GPU_HW* gpu) : m_gpu(gpu) {}
+
+  ALWAYS_INLINE BatchVertex* GetStagingVertices() { return m_staging_vertices.data(); }
+
+  template<typename T>
+  T* NewCommand(GPUBackendCommandType type, u32 size = sizeof(T))
+  {
+    return static_cast<T*>(AllocateCommand(type, size));
+  }
+
+  void UpdateSettings() override { Sync(true); }
+
+protected:
+  void FillVRAM(u32 x, u32 y, u32 width, u32 height, u32 color, GPUBackendCommandParameters params) override
+  {
+    UnreachableCode();
+  }
+  void UpdateVRAM(u32 x, u32 y, u32 width, u32 height, const void* data, GPUBackendCommandParameters params) override
+  {
+    UnreachableCode();
+  }
+  void CopyVRAM(u32 src_x, u32 src_y, u32 dst_x, u32 dst_y, u32 width, u32 height,
+                GPUBackendCommandParameters params) override
+  {
+    UnreachableCode();
+  }
+  void DrawPolygon(const GPUBackendDrawPolygonCommand* cmd) override { UnreachableCode(); }
+  void DrawRectangle(const GPUBackendDrawRectangleCommand* cmd) override { UnreachableCode(); }
+  void DrawLine(const GPUBackendDrawLineCommand* cmd) override { UnreachableCode(); }
+  void FlushRender() override {}
+  void DrawingAreaChanged() override {}
+
+  void HandleCommand(const GPUBackendCommand* cmd) override
+  {
+    switch (cmd->type)
+    {
+      case GPUBackendCommandType::HWSetScissor:
+      {
+        m_gpu->m_host_drawing_area = static_cast<const SetScissorCommand*>(cmd)->drawing_area;
+        m_gpu->SetScissorFromDrawingArea();
+      }
+      break;
+
+      case GPUBackendCommandType::HWClearDepthBuffer:
+        m_gpu->ClearDepthBuffer(static_cast<const DepthBufferCommand*>(cmd)->rect);
+        break;
+
+      case GPUBackendCommandType::HWUpdateDepthBufferFromMaskBit:
+        m_gpu->UpdateDepthBufferFromMaskBit(static_cast<const DepthBufferCommand*>(cmd)->rect);
+        break;
+
+      case GPUBackendCommandType::HWUpdateVRAMReadTexture:
+        g_host_display->SetGPUTimingScope(GPUTimingScope::VRAMTransfers);
+        m_gpu->CopyVRAMToReadTexture(static_cast<const UpdateVRAMReadTextureCommand*>(cmd)->rect);
+        break;
+
+      case GPUBackendCommandType::HWDecodePaletteTexture:
+      {
+        const DecodePaletteTextureCommand* ccmd = static_cast<const DecodePaletteTextureCommand*>(cmd);
+        g_host_display->SetGPUTimingScope(GPUTimingScope::VRAMTransfers);
+        m_gpu->DecodePaletteTexture(ccmd->slot, ccmd->texpage);
+      }
+      break;
+
+      case GPUBackendCommandType::HWDrawBatch:
+      {
+        const DrawBatchCommand* ccmd = static_cast<const DrawBatchCommand*>(cmd);
+        g_host_display->SetGPUTimingScope(GPUTimingScope::BatchDraws);
+        const u32 base_vertex = m_gpu->UploadBatchVertices(ccmd->vertices, ccmd->num_vertices);
+        if (ccmd->ubo_dirty)
+          m_gpu->UploadUniformBuffer(&ccmd->ubo_data, sizeof(ccmd->ubo_data));
+
+        if (ccmd->two_pass)
+        {
+          m_gpu->DrawBatchVertices(ccmd->batch, BatchRenderMode::OnlyOpaque, base_vertex, ccmd->num_vertices);
+          m_gpu->DrawBatchVertices(ccmd->batch, BatchRenderMode::OnlyTransparent, base_vertex, ccmd->num_vertices);
+        }
+        else
+        {
+          m_gpu->DrawBatchVertices(ccmd->batch, ccmd->batch.GetRenderMode(), base_vertex, ccmd->num_vertices);
+        }
+      }
+      break;
+
+      default:
+        UnreachableCode();
+        break;
+    }
+  }
+
+private:
+  GPU_HW* m_gpu;
+
+  // Vertices for the batch being recorded are written here and copied into the command once it's complete.
+  HeapArray<BatchVertex, STAGING_VERTEX_COUNT> m_staging_vertices;
+};
+
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif
+
 GPU_HW::GPU_HW() : GPU()
 {
   m_vram_ptr = m_vram_shadow.data();
@@ -45,6 +205,12 @@ GPU_HW::GPU_HW() : GPU()
 
 GPU_HW::~GPU_HW()
 {
+  if (m_render_thread)
+  {
+    m_render_thread->Shutdown();
+    m_render_thread.reset();
+  }
+
   if (m_sw_renderer)
   {
     m_sw_renderer->Shutdown();
@@ -57,6 +223,11 @@ const Threading::Thread* GPU_HW::GetSWThread() const
   return m_sw_renderer ? m_sw_renderer->GetThread() : nullptr;
 }
 
+GPUBackendThreadStats GPU_HW::GetAndResetSWThreadStats()
+{
+  return m_sw_renderer ? m_sw_renderer->GetAndResetThreadStats() : GPUBackendThreadStats{};
+}
+
 bool GPU_HW::Initialize()
 {
   if (!GPU::Initialize())
@@ -69,10 +240,14 @@ bool GPU_HW::Initialize()
   m_true_color = g_settings.gpu_true_color;
   m_scaled_dithering = g_settings.gpu_scaled_dithering;
   m_texture_filtering = g_settings.gpu_texture_filter;
+  m_adaptive_texture_filtering = g_settings.gpu_adaptive_texture_filtering;
   m_using_uv_limits = ShouldUseUVLimits();
   m_chroma_smoothing = g_settings.gpu_24bit_chroma_smoothing;
   m_downsample_mode = GetDownsampleMode(m_resolution_scale);
+  m_use_compute_downsampling = ShouldUseComputeDownsampling(m_downsample_mode);
   m_disable_color_perspective = m_supports_disable_color_perspective && ShouldDisableColorPerspective();
+  m_shader_mode = g_settings.gpu_shader_mode;
+  m_use_uber_shaders = (m_shader_mode != GPUShaderMode::Specialized);
 
   if (m_multisamples != g_settings.gpu_multisamples)
   {
@@ -103,8 +278,10 @@ bool GPU_HW::Initialize()
     Log_WarningPrint("Disable color perspective not supported, but should be used.");
 
   m_pgxp_depth_buffer = g_settings.UsingPGXPDepthBuffer();
+  InvalidatePaletteTextureCache();
 
   UpdateSoftwareRenderer(false);
+  UpdateRenderThread();
 
   PrintSettingsToLog();
   return true;
@@ -112,6 +289,7 @@ bool GPU_HW::Initialize()
 
 void GPU_HW::Reset(bool clear_vram)
 {
+  SyncRenderThread();
   GPU::Reset(clear_vram);
 
   m_batch_current_vertex_ptr = m_batch_start_vertex_ptr;
@@ -126,10 +304,13 @@ void GPU_HW::Reset(bool clear_vram)
   m_current_depth = 1;
 
   SetFullVRAMDirtyRectangle();
+  InvalidatePaletteTextureCache();
 }
 
 bool GPU_HW::DoState(StateWrapper& sw, GPUTexture** host_texture, bool update_display)
 {
+  SyncRenderThread();
+
   if (!GPU::DoState(sw, host_texture, update_display))
     return false;
 
@@ -138,6 +319,7 @@ bool GPU_HW::DoState(StateWrapper& sw, GPUTexture** host_texture, bool update_di
   {
     m_batch_current_vertex_ptr = m_batch_start_vertex_ptr;
     SetFullVRAMDirtyRectangle();
+    InvalidatePaletteTextureCache();
     ResetBatchVertexDepth();
   }
 
@@ -150,20 +332,25 @@ void GPU_HW::UpdateHWSettings(bool* framebuffer_changed, bool* shaders_changed)
   const u32 multisamples = std::min(m_max_multisamples, g_settings.gpu_multisamples);
   const bool per_sample_shading = g_settings.gpu_per_sample_shading && m_supports_per_sample_shading;
   const GPUDownsampleMode downsample_mode = GetDownsampleMode(resolution_scale);
+  const bool use_compute_downsampling = ShouldUseComputeDownsampling(downsample_mode);
   const bool use_uv_limits = ShouldUseUVLimits();
   const bool disable_color_perspective = m_supports_disable_color_perspective && ShouldDisableColorPerspective();
 
   *framebuffer_changed =
-    (m_resolution_scale != resolution_scale || m_multisamples != multisamples || m_downsample_mode != downsample_mode);
+    (m_resolution_scale != resolution_scale || m_multisamples != multisamples || m_downsample_mode != downsample_mode ||
+     m_use_compute_downsampling != use_compute_downsampling);
   *shaders_changed =
     (m_resolution_scale != resolution_scale || m_multisamples != multisamples ||
      m_true_color != g_settings.gpu_true_color || m_per_sample_shading != per_sample_shading ||
      m_scaled_dithering != g_settings.gpu_scaled_dithering || m_texture_filtering != g_settings.gpu_texture_filter ||
-     m_using_uv_limits != use_uv_limits || m_chroma_smoothing != g_settings.gpu_24bit_chroma_smoothing ||
-     m_downsample_mode != downsample_mode || m_pgxp_depth_buffer != g_settings.UsingPGXPDepthBuffer() ||
-     m_disable_color_perspective != disable_color_perspective);
-
-  if (m_resolution_scale != resolution_scale)
+     m_adaptive_texture_filtering != g_settings.gpu_adaptive_texture_filtering || m_using_uv_limits != use_uv_limits ||
+     m_chroma_smoothing != g_settings.gpu_24bit_chroma_smoothing ||
+     m_downsample_mode != downsample_mode || m_use_compute_downsampling != use_compute_downsampling ||
+     m_pgxp_depth_buffer != g_settings.UsingPGXPDepthBuffer() ||
+     m_disable_color_perspective != disable_color_perspective || m_shader_mode != g_settings.gpu_shader_mode);
+
+  // Dynamic resolution changes are logged instead, a message every time would be distracting.
+  if (m_resolution_scale != resolution_scale && !g_settings.gpu_dynamic_resolution)
   {
     Host::AddKeyedFormattedOSDMessage(
       "ResolutionScale", 10.0f,
@@ -194,10 +381,18 @@ void GPU_HW::UpdateHWSettings(bool* framebuffer_changed, bool* shaders_changed)
   m_true_color = g_settings.gpu_true_color;
   m_scaled_dithering = g_settings.gpu_scaled_dithering;
   m_texture_filtering = g_settings.gpu_texture_filter;
+  m_adaptive_texture_filtering = g_settings.gpu_adaptive_texture_filtering;
   m_using_uv_limits = use_uv_limits;
   m_chroma_smoothing = g_settings.gpu_24bit_chroma_smoothing;
   m_downsample_mode = downsample_mode;
+  m_use_compute_downsampling = use_compute_downsampling;
   m_disable_color_perspective = disable_color_perspective;
+  m_shader_mode = g_settings.gpu_shader_mode;
+
+  // Backends which compile the specialized shaders in the background clear this once they're ready, so only reset it
+  // when the shaders are being recompiled anyway.
+  if (*shaders_changed)
+    m_use_uber_shaders = (m_shader_mode != GPUShaderMode::Specialized);
 
   if (!m_supports_dual_source_blend && TextureFilterRequiresDualSourceBlend(m_texture_filtering))
     m_texture_filtering = GPUTextureFilter::Nearest;
@@ -206,11 +401,15 @@ void GPU_HW::UpdateHWSettings(bool* framebuffer_changed, bool* shaders_changed)
   {
     m_pgxp_depth_buffer = g_settings.UsingPGXPDepthBuffer();
     m_batch.use_depth_buffer = false;
+
+    // Nothing in the depth buffer is meaningful in the other mode.
+    m_vram_depth_dirty_page_mask = ALL_VRAM_PAGES_MASK;
     if (m_pgxp_depth_buffer)
-      ClearDepthBuffer();
+      ClearBatchDepthBuffer();
   }
 
   UpdateSoftwareRenderer(true);
+  UpdateRenderThread();
 
   PrintSettingsToLog();
 }
@@ -237,6 +436,9 @@ u32 GPU_HW::CalculateResolutionScale() const
     scale = static_cast<u32>(std::clamp<s32>(preferred_scale, 1, m_max_resolution_scale));
   }
 
+  if (g_settings.gpu_dynamic_resolution && m_dynamic_resolution_scale != 0)
+    scale = std::min(scale, m_dynamic_resolution_scale);
+
   if (g_settings.gpu_downsample_mode == GPUDownsampleMode::Adaptive && m_supports_adaptive_downsampling && scale > 1 &&
       !Common::IsPow2(scale))
   {
@@ -265,6 +467,85 @@ void GPU_HW::UpdateResolutionScale()
     UpdateSettings();
 }
 
+void GPU_HW::UpdateDynamicResolution(float gpu_time_ms, float frame_time_budget_ms)
+{
+  if (!g_settings.gpu_dynamic_resolution)
+    return;
+
+  // Smooth out single frame spikes, e.g. from uploads or shader compiles.
+  m_dynamic_resolution_gpu_time = (m_dynamic_resolution_gpu_time == 0.0f) ?
+                                    gpu_time_ms :
+                                    (m_dynamic_resolution_gpu_time * 0.9f + gpu_time_ms * 0.1f);
+  if (m_dynamic_resolution_hold_frames > 0)
+  {
+    m_dynamic_resolution_hold_frames--;
+    return;
+  }
+
+  // Leave some slack for the CPU side of presenting, and for the estimate being off.
+  const float target_time = frame_time_budget_ms * 0.9f;
+  const u32 min_scale = std::clamp<u32>(g_settings.gpu_dynamic_resolution_min_scale, 1, m_max_resolution_scale);
+  const bool pow2_only =
+    (g_settings.gpu_downsample_mode == GPUDownsampleMode::Adaptive && m_supports_adaptive_downsampling);
+
+  // The cost of rendering goes with the number of pixels, so the square of the scale.
+  u32 new_scale = m_resolution_scale;
+  if (m_dynamic_resolution_gpu_time > target_time && m_resolution_scale > min_scale)
+  {
+    m_dynamic_resolution_under_frames = 0;
+    if (++m_dynamic_resolution_over_frames >= DYNAMIC_RESOLUTION_DOWN_FRAMES)
+    {
+      // Go straight to the scale which should fit, rather than dropping frames at each step on the way.
+      const float fit_scale =
+        static_cast<float>(m_resolution_scale) * std::sqrt(target_time / m_dynamic_resolution_gpu_time);
+      new_scale = std::clamp<u32>(static_cast<u32>(fit_scale), min_scale, m_resolution_scale - 1);
+    }
+  }
+  else if (m_dynamic_resolution_scale != 0)
+  {
+    m_dynamic_resolution_over_frames = 0;
+
+    const u32 up_scale = pow2_only ? (m_resolution_scale * 2) : (m_resolution_scale + 1);
+    const float up_ratio = static_cast<float>(up_scale) / static_cast<float>(m_resolution_scale);
+    if ((m_dynamic_resolution_gpu_time * up_ratio * up_ratio) < (target_time * 0.85f))
+    {
+      if (++m_dynamic_resolution_under_frames >= DYNAMIC_RESOLUTION_UP_FRAMES)
+        new_scale = up_scale;
+    }
+    else
+    {
+      m_dynamic_resolution_under_frames = 0;
+    }
+  }
+  else
+  {
+    m_dynamic_resolution_over_frames = 0;
+    m_dynamic_resolution_under_frames = 0;
+  }
+
+  if (new_scale == m_resolution_scale)
+    return;
+
+  // Goes through the same path as changing the scale in the settings, which carries VRAM over to the new size.
+  const u32 old_scale = m_resolution_scale;
+  m_dynamic_resolution_scale = new_scale;
+  UpdateResolutionScale();
+  if (m_resolution_scale != old_scale)
+  {
+    Log_InfoPrintf("Dynamic resolution: GPU time %.2fms of %.2fms, changed scale from %ux to %ux",
+                   m_dynamic_resolution_gpu_time, frame_time_budget_ms, old_scale, m_resolution_scale);
+  }
+
+  // Once we're back at the configured scale, there's nothing left to cap.
+  if (m_resolution_scale < m_dynamic_resolution_scale)
+    m_dynamic_resolution_scale = 0;
+
+  m_dynamic_resolution_hold_frames = DYNAMIC_RESOLUTION_HOLD_FRAMES;
+  m_dynamic_resolution_over_frames = 0;
+  m_dynamic_resolution_under_frames = 0;
+  m_dynamic_resolution_gpu_time = 0.0f;
+}
+
 GPUDownsampleMode GPU_HW::GetDownsampleMode(u32 resolution_scale) const
 {
   if (resolution_scale == 1)
@@ -276,6 +557,11 @@ GPUDownsampleMode GPU_HW::GetDownsampleMode(u32 resolution_scale) const
   return g_settings.gpu_downsample_mode;
 }
 
+bool GPU_HW::ShouldUseComputeDownsampling(GPUDownsampleMode mode) const
+{
+  return (mode == GPUDownsampleMode::Adaptive && m_supports_compute_downsampling && g_settings.gpu_downsample_compute);
+}
+
 std::tuple<u32, u32> GPU_HW::GetEffectiveDisplayResolution(bool scaled /* = true */)
 {
   const u32 scale = scaled ? m_resolution_scale : 1u;
@@ -288,6 +574,22 @@ std::tuple<u32, u32> GPU_HW::GetFullDisplayResolution(bool scaled /* = true */)
   return std::make_tuple(m_crtc_state.display_width * scale, m_crtc_state.display_height * scale);
 }
 
+void GPU_HW::UpdateBatchUBOShaderFlags()
+{
+  // Anything that changes these also starts a new batch, same as the pipeline selection they stand in for.
+  const u32 textured = BoolToUInt32(m_batch.texture_mode != GPUTextureMode::Disabled);
+  const u32 raw_texture =
+    BoolToUInt32(textured && (m_batch.texture_mode & GPUTextureMode::RawTextureBit) == GPUTextureMode::RawTextureBit);
+  const u32 dithering = BoolToUInt32(m_batch.dithering);
+  const u32 interlacing = BoolToUInt32(m_batch.interlacing);
+  m_batch_ubo_dirty |= (m_batch_ubo_data.u_textured != textured || m_batch_ubo_data.u_raw_texture != raw_texture ||
+                        m_batch_ubo_data.u_dithering != dithering || m_batch_ubo_data.u_interlacing != interlacing);
+  m_batch_ubo_data.u_textured = textured;
+  m_batch_ubo_data.u_raw_texture = raw_texture;
+  m_batch_ubo_data.u_dithering = dithering;
+  m_batch_ubo_data.u_interlacing = interlacing;
+}
+
 void GPU_HW::PrintSettingsToLog()
 {
   Log_InfoPrintf("Resolution Scale: %u (%ux%u), maximum %u", m_resolution_scale, VRAM_WIDTH * m_resolution_scale,
@@ -299,14 +601,191 @@ void GPU_HW::PrintSettingsToLog()
   Log_InfoPrintf("Dual-source blending: %s", m_supports_dual_source_blend ? "Supported" : "Not supported");
   Log_InfoPrintf("Using UV limits: %s", m_using_uv_limits ? "YES" : "NO");
   Log_InfoPrintf("Depth buffer: %s", m_pgxp_depth_buffer ? "YES" : "NO");
-  Log_InfoPrintf("Downsampling: %s", Settings::GetDownsampleModeDisplayName(m_downsample_mode));
+  Log_InfoPrintf("Downsampling: %s%s", Settings::GetDownsampleModeDisplayName(m_downsample_mode),
+                 m_use_compute_downsampling ? " (Compute)" : "");
+  Log_InfoPrintf("Shader mode: %s%s", Settings::GetShaderModeDisplayName(m_shader_mode),
+                 m_use_uber_shaders ? " (using uber shaders)" : "");
   Log_InfoPrintf("Using software renderer for readbacks: %s", m_sw_renderer ? "YES" : "NO");
 }
 
 void GPU_HW::UpdateVRAMReadTexture()
+{
+  UpdateVRAMReadTexturePages(m_vram_dirty_page_mask);
+}
+
+void GPU_HW::UpdateVRAMReadTexturePages(u32 page_mask)
+{
+  page_mask &= m_vram_dirty_page_mask;
+  if (page_mask == 0)
+    return;
+
+  m_vram_dirty_page_mask &= ~page_mask;
+  while (page_mask != 0)
+  {
+    const u32 page = CountTrailingZeros(page_mask);
+    page_mask &= page_mask - 1;
+
+    QueueVRAMReadTextureCopy(m_vram_dirty_page_rects[page]);
+    m_vram_dirty_page_rects[page].SetInvalid();
+  }
+
+  // Shrink the overall bounds to what's left, so VRAM copies don't refresh areas which are already clean.
+  m_vram_dirty_rect.SetInvalid();
+  for (u32 remaining = m_vram_dirty_page_mask; remaining != 0; remaining &= remaining - 1)
+    m_vram_dirty_rect.Include(m_vram_dirty_page_rects[CountTrailingZeros(remaining)]);
+}
+
+void GPU_HW::QueueVRAMReadTextureCopy(const Common::Rectangle<u32>& rect)
 {
   m_renderer_stats.num_vram_read_texture_updates++;
-  ClearVRAMDirtyRectangle();
+  m_renderer_stats.num_vram_read_texture_bytes += rect.GetWidth() * rect.GetHeight() * sizeof(u16);
+  if (m_use_palette_texture_cache)
+    InvalidatePaletteTextures(rect);
+
+  if (m_render_thread_recording)
+  {
+    RenderThread::UpdateVRAMReadTextureCommand* cmd =
+      m_render_thread->NewCommand<RenderThread::UpdateVRAMReadTextureCommand>(
+        GPUBackendCommandType::HWUpdateVRAMReadTexture);
+    cmd->rect = rect;
+    m_render_thread->PushCommand(cmd);
+  }
+  else
+  {
+    g_host_display->SetGPUTimingScope(GPUTimingScope::VRAMTransfers);
+    CopyVRAMToReadTexture(rect);
+  }
+}
+
+bool GPU_HW::SupportsRenderThread() const
+{
+  return false;
+}
+
+u32 GPU_HW::UploadBatchVertices(const BatchVertex* vertices, u32 num_vertices)
+{
+  Panic("Renderer does not support a render thread");
+  return 0;
+}
+
+void GPU_HW::DecodePaletteTexture(u32 slot, u32 texpage)
+{
+  Panic("Renderer does not support a palette texture cache");
+}
+
+void GPU_HW::OnRenderThreadRecordingStarted() {}
+
+void GPU_HW::OnRenderThreadRecordingFinished() {}
+
+void GPU_HW::UpdateRenderThread()
+{
+  const bool current_enabled = (m_render_thread != nullptr);
+  const bool new_enabled = g_settings.gpu_use_render_thread && SupportsRenderThread();
+  if (current_enabled == new_enabled)
+    return;
+
+  if (!new_enabled)
+  {
+    SyncRenderThread();
+    m_render_thread->Shutdown();
+    m_render_thread.reset();
+    return;
+  }
+
+  std::unique_ptr<RenderThread> render_thread = std::make_unique<RenderThread>(this);
+  if (!render_thread->Initialize(true))
+    return;
+
+  m_render_thread = std::move(render_thread);
+}
+
+void GPU_HW::BeginRenderThreadRecording()
+{
+  if (m_render_thread_recording || !m_render_thread)
+    return;
+
+  // Anything already in the host vertex buffer has to be drawn before the render thread starts using it.
+  FlushRender();
+  OnRenderThreadRecordingStarted();
+  m_render_thread_recording = true;
+}
+
+void GPU_HW::SyncRenderThread(bool allow_sleep /* = false */)
+{
+  if (!m_render_thread_recording)
+    return;
+
+  FlushRender();
+  m_render_thread->Sync(allow_sleep);
+  m_render_thread_recording = false;
+  OnRenderThreadRecordingFinished();
+}
+
+void GPU_HW::ApplyDrawingAreaScissor()
+{
+  if (m_render_thread_recording)
+  {
+    RenderThread::SetScissorCommand* cmd =
+      m_render_thread->NewCommand<RenderThread::SetScissorCommand>(GPUBackendCommandType::HWSetScissor);
+    cmd->drawing_area = m_drawing_area;
+    m_render_thread->PushCommand(cmd);
+    return;
+  }
+
+  m_host_drawing_area = m_drawing_area;
+  SetScissorFromDrawingArea();
+}
+
+void GPU_HW::ClearBatchDepthBuffer()
+{
+  ResetDepthBufferPages(true);
+  m_last_depth_z = 1.0f;
+}
+
+void GPU_HW::UpdateDepthBufferPagesFromMaskBit()
+{
+  if (m_pgxp_depth_buffer)
+    return;
+
+  ResetDepthBufferPages(false);
+}
+
+void GPU_HW::ResetDepthBufferPages(bool clear)
+{
+  // Pages which haven't been written since the last reset already hold the values we'd be writing.
+  u32 page_mask = std::exchange(m_vram_depth_dirty_page_mask, 0u);
+  while (page_mask != 0)
+  {
+    const u32 first_page = CountTrailingZeros(page_mask);
+    const u32 page_y = first_page / NUM_VRAM_PAGES_X;
+    const u32 row_end_page = (page_y + 1) * NUM_VRAM_PAGES_X;
+    u32 end_page = first_page + 1;
+    while (end_page < row_end_page && (page_mask & (1u << end_page)) != 0)
+      end_page++;
+
+    const u32 num_pages = end_page - first_page;
+    page_mask &= ~(((1u << num_pages) - 1u) << first_page);
+    m_renderer_stats.num_depth_buffer_page_resets += num_pages;
+
+    const Common::Rectangle<u32> rect = Common::Rectangle<u32>::FromExtents(
+      (first_page % NUM_VRAM_PAGES_X) * VRAM_PAGE_WIDTH, page_y * VRAM_PAGE_HEIGHT, num_pages * VRAM_PAGE_WIDTH,
+      VRAM_PAGE_HEIGHT);
+    if (m_render_thread_recording)
+    {
+      RenderThread::DepthBufferCommand* cmd = m_render_thread->NewCommand<RenderThread::DepthBufferCommand>(
+        clear ? GPUBackendCommandType::HWClearDepthBuffer : GPUBackendCommandType::HWUpdateDepthBufferFromMaskBit);
+      cmd->rect = rect;
+      m_render_thread->PushCommand(cmd);
+    }
+    else if (clear)
+    {
+      ClearDepthBuffer(rect);
+    }
+    else
+    {
+      UpdateDepthBufferFromMaskBit(rect);
+    }
+  }
 }
 
 void GPU_HW::HandleFlippedQuadTextureCoordinates(BatchVertex* vertices)
@@ -450,7 +929,7 @@ void GPU_HW::CheckForDepthClear(const BatchVertex* vertices, u32 num_vertices)
       EnsureVertexBufferSpaceForCurrentCommand();
     }
 
-    ClearDepthBuffer();
+    ClearBatchDepthBuffer();
   }
 
   m_last_depth_z = average_z;
@@ -571,8 +1050,11 @@ void GPU_HW::DrawLine(float x0, float y0, u32 col0, float x1, float y1, u32 col1
   AddVertex(output[1]);
   AddVertex(output[2]);
   AddVertex(output[3]);
-  AddVertex(output[2]);
-  AddVertex(output[1]);
+  if (!m_use_quad_index_buffer)
+  {
+    AddVertex(output[2]);
+    AddVertex(output[1]);
+  }
 }
 
 void GPU_HW::LoadVertices()
@@ -581,14 +1063,17 @@ void GPU_HW::LoadVertices()
     m_current_depth++;
 
   const GPURenderCommand rc{m_render_command.bits};
-  const u32 texpage = ZeroExtend32(m_draw_mode.mode_reg.bits) | (ZeroExtend32(m_draw_mode.palette_reg) << 16);
+  u32 texpage = ZeroExtend32(m_draw_mode.mode_reg.bits) | (ZeroExtend32(m_draw_mode.palette_reg) << 16);
+  if ((texpage & PALETTE_TEXTURE_KEY_MASK) == m_palette_texture_cache_current_key)
+    texpage = (texpage & 0xFFFFu) | PALETTE_TEXTURE_CACHE_FLAG | (m_palette_texture_cache_current_slot << 16);
+
   const float depth = GetCurrentNormalizedVertexDepth();
 
   switch (rc.primitive)
   {
     case GPUPrimitive::Polygon:
     {
-      DebugAssert(GetBatchVertexSpace() >= (rc.quad_polygon ? 6u : 3u));
+      DebugAssert(GetBatchVertexSpace() >= (m_use_quad_index_buffer ? 4u : (rc.quad_polygon ? 6u : 3u)));
 
       const u32 first_color = rc.color_for_first_vertex;
       const bool shaded = rc.shading_enable;
@@ -655,6 +1140,8 @@ void GPU_HW::LoadVertices()
       const s32 min_y = std::min(min_y_12, native_vertex_positions[0][1]);
       const s32 max_y = std::max(max_y_12, native_vertex_positions[0][1]);
 
+      bool draw_first_half = false;
+      bool draw_second_half = false;
       if ((max_x - min_x) >= MAX_PRIMITIVE_WIDTH || (max_y - min_y) >= MAX_PRIMITIVE_HEIGHT)
       {
         Log_DebugPrintf("Culling too-large polygon: %d,%d %d,%d %d,%d", native_vertex_positions[0][0],
@@ -669,14 +1156,12 @@ void GPU_HW::LoadVertices()
         const u32 clip_bottom =
           static_cast<u32>(std::clamp<s32>(max_y, m_drawing_area.top, m_drawing_area.bottom)) + 1u;
 
-        m_vram_dirty_rect.Include(clip_left, clip_right, clip_top, clip_bottom);
+        IncludeVRAMDirtyPages(Common::Rectangle<u32>(clip_left, clip_top, clip_right, clip_bottom));
         AddDrawTriangleTicks(native_vertex_positions[0][0], native_vertex_positions[0][1],
                              native_vertex_positions[1][0], native_vertex_positions[1][1],
                              native_vertex_positions[2][0], native_vertex_positions[2][1], rc.shading_enable,
                              rc.texture_enable, rc.transparency_enable);
-
-        std::memcpy(m_batch_current_vertex_ptr, vertices.data(), sizeof(BatchVertex) * 3);
-        m_batch_current_vertex_ptr += 3;
+        draw_first_half = true;
       }
 
       // quads
@@ -703,12 +1188,46 @@ void GPU_HW::LoadVertices()
           const u32 clip_bottom =
             static_cast<u32>(std::clamp<s32>(max_y_123, m_drawing_area.top, m_drawing_area.bottom)) + 1u;
 
-          m_vram_dirty_rect.Include(clip_left, clip_right, clip_top, clip_bottom);
+          IncludeVRAMDirtyPages(Common::Rectangle<u32>(clip_left, clip_top, clip_right, clip_bottom));
           AddDrawTriangleTicks(native_vertex_positions[2][0], native_vertex_positions[2][1],
                                native_vertex_positions[1][0], native_vertex_positions[1][1],
                                native_vertex_positions[3][0], native_vertex_positions[3][1], rc.shading_enable,
                                rc.texture_enable, rc.transparency_enable);
+          draw_second_half = true;
+        }
+      }
 
+      if (m_use_quad_index_buffer)
+      {
+        // The index pattern draws [0,1,2] and [2,1,3], so either half can be dropped by repeating a vertex.
+        if (draw_first_half && draw_second_half)
+        {
+          std::memcpy(m_batch_current_vertex_ptr, vertices.data(), sizeof(BatchVertex) * 4);
+          m_batch_current_vertex_ptr += 4;
+        }
+        else if (draw_first_half)
+        {
+          std::memcpy(m_batch_current_vertex_ptr, vertices.data(), sizeof(BatchVertex) * 3);
+          m_batch_current_vertex_ptr += 3;
+          AddVertex(vertices[2]);
+        }
+        else if (draw_second_half)
+        {
+          AddVertex(vertices[2]);
+          AddVertex(vertices[1]);
+          AddVertex(vertices[3]);
+          AddVertex(vertices[3]);
+        }
+      }
+      else
+      {
+        if (draw_first_half)
+        {
+          std::memcpy(m_batch_current_vertex_ptr, vertices.data(), sizeof(BatchVertex) * 3);
+          m_batch_current_vertex_ptr += 3;
+        }
+        if (draw_second_half)
+        {
           AddVertex(vertices[2]);
           AddVertex(vertices[1]);
           AddVertex(vertices[3]);
@@ -804,9 +1323,11 @@ void GPU_HW::LoadVertices()
           AddNewVertex(quad_start_x, quad_start_y, depth, 1.0f, color, texpage, tex_left, tex_top, uv_limits);
           AddNewVertex(quad_end_x, quad_start_y, depth, 1.0f, color, texpage, tex_right, tex_top, uv_limits);
           AddNewVertex(quad_start_x, quad_end_y, depth, 1.0f, color, texpage, tex_left, tex_bottom, uv_limits);
-
-          AddNewVertex(quad_start_x, quad_end_y, depth, 1.0f, color, texpage, tex_left, tex_bottom, uv_limits);
-          AddNewVertex(quad_end_x, quad_start_y, depth, 1.0f, color, texpage, tex_right, tex_top, uv_limits);
+          if (!m_use_quad_index_buffer)
+          {
+            AddNewVertex(quad_start_x, quad_end_y, depth, 1.0f, color, texpage, tex_left, tex_bottom, uv_limits);
+            AddNewVertex(quad_end_x, quad_start_y, depth, 1.0f, color, texpage, tex_right, tex_top, uv_limits);
+          }
           AddNewVertex(quad_end_x, quad_end_y, depth, 1.0f, color, texpage, tex_right, tex_bottom, uv_limits);
 
           x_offset += quad_width;
@@ -824,7 +1345,7 @@ void GPU_HW::LoadVertices()
       const u32 clip_bottom =
         static_cast<u32>(std::clamp<s32>(pos_y + rectangle_height, m_drawing_area.top, m_drawing_area.bottom)) + 1u;
 
-      m_vram_dirty_rect.Include(clip_left, clip_right, clip_top, clip_bottom);
+      IncludeVRAMDirtyPages(Common::Rectangle<u32>(clip_left, clip_top, clip_right, clip_bottom));
       AddDrawRectangleTicks(clip_right - clip_left, clip_bottom - clip_top, rc.texture_enable, rc.transparency_enable);
 
       if (m_sw_renderer)
@@ -887,7 +1408,7 @@ void GPU_HW::LoadVertices()
         const u32 clip_bottom =
           static_cast<u32>(std::clamp<s32>(max_y, m_drawing_area.top, m_drawing_area.bottom)) + 1u;
 
-        m_vram_dirty_rect.Include(clip_left, clip_right, clip_top, clip_bottom);
+        IncludeVRAMDirtyPages(Common::Rectangle<u32>(clip_left, clip_top, clip_right, clip_bottom));
         AddDrawLineTicks(clip_right - clip_left, clip_bottom - clip_top, rc.shading_enable);
 
         // TODO: Should we do a PGXP lookup here? Most lines are 2D.
@@ -954,7 +1475,7 @@ void GPU_HW::LoadVertices()
             const u32 clip_bottom =
               static_cast<u32>(std::clamp<s32>(max_y, m_drawing_area.top, m_drawing_area.bottom)) + 1u;
 
-            m_vram_dirty_rect.Include(clip_left, clip_right, clip_top, clip_bottom);
+            IncludeVRAMDirtyPages(Common::Rectangle<u32>(clip_left, clip_top, clip_right, clip_bottom));
             AddDrawLineTicks(clip_right - clip_left, clip_bottom - clip_top, rc.shading_enable);
 
             // TODO: Should we do a PGXP lookup here? Most lines are 2D.
@@ -984,10 +1505,10 @@ void GPU_HW::LoadVertices()
 
 void GPU_HW::CalcScissorRect(int* left, int* top, int* right, int* bottom)
 {
-  *left = m_drawing_area.left * m_resolution_scale;
-  *right = std::max<u32>((m_drawing_area.right + 1) * m_resolution_scale, *left + 1);
-  *top = m_drawing_area.top * m_resolution_scale;
-  *bottom = std::max<u32>((m_drawing_area.bottom + 1) * m_resolution_scale, *top + 1);
+  *left = m_host_drawing_area.left * m_resolution_scale;
+  *right = std::max<u32>((m_host_drawing_area.right + 1) * m_resolution_scale, *left + 1);
+  *top = m_host_drawing_area.top * m_resolution_scale;
+  *bottom = std::max<u32>((m_host_drawing_area.bottom + 1) * m_resolution_scale, *top + 1);
 }
 
 GPU_HW::VRAMFillUBOData GPU_HW::GetVRAMFillUBOData(u32 x, u32 y, u32 width, u32 height, u32 color) const
@@ -1060,10 +1581,174 @@ GPU_HW::VRAMCopyUBOData GPU_HW::GetVRAMCopyUBOData(u32 src_x, u32 src_y, u32 dst
   return uniforms;
 }
 
-void GPU_HW::IncludeVRAMDirtyRectangle(const Common::Rectangle<u32>& rect)
+void GPU_HW::SetFullVRAMDirtyRectangle()
+{
+  m_vram_dirty_rect.Set(0, 0, VRAM_WIDTH, VRAM_HEIGHT);
+  for (u32 page = 0; page < NUM_VRAM_PAGES; page++)
+  {
+    const u32 page_x = (page % NUM_VRAM_PAGES_X) * VRAM_PAGE_WIDTH;
+    const u32 page_y = (page / NUM_VRAM_PAGES_X) * VRAM_PAGE_HEIGHT;
+    m_vram_dirty_page_rects[page] =
+      Common::Rectangle<u32>::FromExtents(page_x, page_y, VRAM_PAGE_WIDTH, VRAM_PAGE_HEIGHT);
+  }
+  m_vram_dirty_page_mask = ALL_VRAM_PAGES_MASK;
+  m_vram_depth_dirty_page_mask = ALL_VRAM_PAGES_MASK;
+  m_speculative_readback_rect.SetInvalid();
+  m_draw_mode.SetTexturePageChanged();
+}
+
+void GPU_HW::ClearVRAMDirtyRectangle()
+{
+  m_vram_dirty_rect.SetInvalid();
+  for (Common::Rectangle<u32>& rect : m_vram_dirty_page_rects)
+    rect.SetInvalid();
+  m_vram_dirty_page_mask = 0;
+}
+
+void GPU_HW::InvalidatePaletteTextureCache()
+{
+  for (PaletteTextureCacheEntry& entry : m_palette_texture_cache)
+  {
+    entry.key = INVALID_PALETTE_TEXTURE_KEY;
+    entry.last_used = 0;
+  }
+  m_palette_texture_cache_current_key = INVALID_PALETTE_TEXTURE_KEY;
+}
+
+void GPU_HW::InvalidatePaletteTextures(const Common::Rectangle<u32>& rect)
+{
+  // Texture pages and palettes wrap around to the left edge of VRAM, like the batch shaders sample them.
+  const auto intersects = [&rect](const Common::Rectangle<u32>& area) {
+    return (area.Intersects(rect) ||
+            (area.right > VRAM_WIDTH && Common::Rectangle<u32>(0, area.top, area.right - VRAM_WIDTH, area.bottom)
+                                          .Intersects(rect)));
+  };
+
+  for (PaletteTextureCacheEntry& entry : m_palette_texture_cache)
+  {
+    if (entry.key == INVALID_PALETTE_TEXTURE_KEY || (!intersects(entry.page_rect) && !intersects(entry.palette_rect)))
+      continue;
+
+    if (entry.key == m_palette_texture_cache_current_key)
+      m_palette_texture_cache_current_key = INVALID_PALETTE_TEXTURE_KEY;
+
+    entry.key = INVALID_PALETTE_TEXTURE_KEY;
+    entry.last_used = 0;
+  }
+}
+
+void GPU_HW::UpdatePaletteTexture()
+{
+  const u32 texpage = ZeroExtend32(m_draw_mode.mode_reg.bits) | (ZeroExtend32(m_draw_mode.palette_reg) << 16);
+  const u32 key = texpage & PALETTE_TEXTURE_KEY_MASK;
+  if (key == m_palette_texture_cache_current_key)
+    return;
+
+  // Invalid slots are never used, so they're picked first.
+  const u64 counter = ++m_palette_texture_cache_counter;
+  u32 slot = 0;
+  for (u32 i = 0; i < NUM_PALETTE_TEXTURE_CACHE_SLOTS; i++)
+  {
+    PaletteTextureCacheEntry& entry = m_palette_texture_cache[i];
+    if (entry.key == key)
+    {
+      entry.last_used = counter;
+      m_palette_texture_cache_current_key = key;
+      m_palette_texture_cache_current_slot = i;
+      return;
+    }
+
+    if (entry.last_used < m_palette_texture_cache[slot].last_used)
+      slot = i;
+  }
+
+  // The slot could still be in use by vertices in the current batch.
+  if (!IsFlushed())
+    FlushRender();
+
+  PaletteTextureCacheEntry& entry = m_palette_texture_cache[slot];
+  entry.key = key;
+  entry.last_used = counter;
+  entry.page_rect = m_draw_mode.mode_reg.GetTexturePageRectangle();
+  entry.palette_rect = m_draw_mode.GetTexturePaletteRectangle();
+  m_palette_texture_cache_current_key = key;
+  m_palette_texture_cache_current_slot = slot;
+  m_renderer_stats.num_palette_texture_decodes++;
+
+  if (m_render_thread_recording)
+  {
+    RenderThread::DecodePaletteTextureCommand* cmd =
+      m_render_thread->NewCommand<RenderThread::DecodePaletteTextureCommand>(
+        GPUBackendCommandType::HWDecodePaletteTexture);
+    cmd->slot = slot;
+    cmd->texpage = texpage;
+    m_render_thread->PushCommand(cmd);
+  }
+  else
+  {
+    g_host_display->SetGPUTimingScope(GPUTimingScope::VRAMTransfers);
+    DecodePaletteTexture(slot, texpage);
+  }
+}
+
+u32 GPU_HW::GetVRAMPageMask(const Common::Rectangle<u32>& rect)
+{
+  if (rect.left >= rect.right || rect.top >= rect.bottom)
+    return 0;
+
+  // Texture pages and palettes can extend past the edge of VRAM, the pages there are never dirty anyway.
+  const u32 start_x = std::min(rect.left / VRAM_PAGE_WIDTH, NUM_VRAM_PAGES_X - 1);
+  const u32 end_x = std::min((rect.right - 1) / VRAM_PAGE_WIDTH, NUM_VRAM_PAGES_X - 1);
+  const u32 start_y = std::min(rect.top / VRAM_PAGE_HEIGHT, NUM_VRAM_PAGES_Y - 1);
+  const u32 end_y = std::min((rect.bottom - 1) / VRAM_PAGE_HEIGHT, NUM_VRAM_PAGES_Y - 1);
+
+  u32 mask = 0;
+  for (u32 page_y = start_y; page_y <= end_y; page_y++)
+  {
+    for (u32 page_x = start_x; page_x <= end_x; page_x++)
+      mask |= 1u << (page_y * NUM_VRAM_PAGES_X + page_x);
+  }
+
+  return mask;
+}
+
+u32 GPU_HW::GetDirtyVRAMPages(const Common::Rectangle<u32>& rect) const
+{
+  u32 mask = GetVRAMPageMask(rect) & m_vram_dirty_page_mask;
+  for (u32 remaining = mask; remaining != 0; remaining &= remaining - 1)
+  {
+    const u32 page = CountTrailingZeros(remaining);
+    if (!m_vram_dirty_page_rects[page].Intersects(rect))
+      mask &= ~(1u << page);
+  }
+
+  return mask;
+}
+
+void GPU_HW::IncludeVRAMDirtyPages(const Common::Rectangle<u32>& rect)
 {
   m_vram_dirty_rect.Include(rect);
 
+  if (m_speculative_readback_rect.Valid() && m_speculative_readback_rect.Intersects(rect))
+    m_speculative_readback_rect.SetInvalid();
+
+  const u32 page_mask = GetVRAMPageMask(rect);
+  m_vram_dirty_page_mask |= page_mask;
+  m_vram_depth_dirty_page_mask |= page_mask;
+  for (u32 remaining = page_mask; remaining != 0; remaining &= remaining - 1)
+  {
+    const u32 page = CountTrailingZeros(remaining);
+    const u32 page_x = (page % NUM_VRAM_PAGES_X) * VRAM_PAGE_WIDTH;
+    const u32 page_y = (page / NUM_VRAM_PAGES_X) * VRAM_PAGE_HEIGHT;
+    m_vram_dirty_page_rects[page].Include(
+      rect.Clamped(page_x, page_y, page_x + VRAM_PAGE_WIDTH, page_y + VRAM_PAGE_HEIGHT));
+  }
+}
+
+void GPU_HW::IncludeVRAMDirtyRectangle(const Common::Rectangle<u32>& rect)
+{
+  IncludeVRAMDirtyPages(rect);
+
   // the vram area can include the texture page, but the game can leave it as-is. in this case, set it as dirty so the
   // shadow texture is updated
   if (!m_draw_mode.IsTexturePageChanged() &&
@@ -1084,7 +1769,7 @@ void GPU_HW::EnsureVertexBufferSpace(u32 required_vertices)
     FlushRender();
   }
 
-  MapBatchVertexPointer(required_vertices);
+  MapBatchVertices(required_vertices);
 }
 
 void GPU_HW::EnsureVertexBufferSpaceForCurrentCommand()
@@ -1093,7 +1778,7 @@ void GPU_HW::EnsureVertexBufferSpaceForCurrentCommand()
   switch (m_render_command.primitive)
   {
     case GPUPrimitive::Polygon:
-      required_vertices = m_render_command.quad_polygon ? 6 : 3;
+      required_vertices = m_use_quad_index_buffer ? 4 : (m_render_command.quad_polygon ? 6 : 3);
       break;
     case GPUPrimitive::Rectangle:
       required_vertices = MAX_VERTICES_FOR_RECTANGLE;
@@ -1118,7 +1803,7 @@ void GPU_HW::EnsureVertexBufferSpaceForCurrentCommand()
     FlushRender();
   }
 
-  MapBatchVertexPointer(required_vertices);
+  MapBatchVertices(required_vertices);
 }
 
 void GPU_HW::ResetBatchVertexDepth()
@@ -1128,11 +1813,29 @@ void GPU_HW::ResetBatchVertexDepth()
 
   Log_PerfPrint("Resetting batch vertex depth");
   FlushRender();
-  UpdateDepthBufferFromMaskBit();
-
+  UpdateDepthBufferPagesFromMaskBit();
   m_current_depth = 1;
 }
 
+void GPU_HW::MapBatchVertices(u32 required_vertices)
+{
+  if (!m_render_thread_recording)
+  {
+    MapBatchVertexPointer(required_vertices);
+
+    // The staging area below is already small enough to index.
+    if (m_use_quad_index_buffer && GetBatchVertexSpace() > MAX_INDEXED_BATCH_VERTEX_COUNT)
+      m_batch_end_vertex_ptr = m_batch_start_vertex_ptr + MAX_INDEXED_BATCH_VERTEX_COUNT;
+    return;
+  }
+
+  DebugAssert(required_vertices <= RenderThread::STAGING_VERTEX_COUNT);
+  m_batch_start_vertex_ptr = m_render_thread->GetStagingVertices();
+  m_batch_current_vertex_ptr = m_batch_start_vertex_ptr;
+  m_batch_end_vertex_ptr = m_batch_start_vertex_ptr + RenderThread::STAGING_VERTEX_COUNT;
+  m_batch_base_vertex = 0;
+}
+
 void GPU_HW::UpdateSoftwareRenderer(bool copy_vram_from_hw)
 {
   const bool current_enabled = (m_sw_renderer != nullptr);
@@ -1192,6 +1895,8 @@ void GPU_HW::FillDrawCommand(GPUBackendDrawCommand* cmd, GPURenderCommand rc) co
 void GPU_HW::ReadSoftwareRendererVRAM(u32 x, u32 y, u32 width, u32 height)
 {
   DebugAssert(m_sw_renderer);
+
+  // Draws are mirrored through the backend's FIFO and rasterized on its thread, this is the only point we wait on it.
   m_sw_renderer->Sync(false);
 }
 
@@ -1246,6 +1951,7 @@ void GPU_HW::UpdateVRAM(u32 x, u32 y, u32 width, u32 height, const void* data, b
 {
   DebugAssert((x + width) <= VRAM_WIDTH && (y + height) <= VRAM_HEIGHT);
   IncludeVRAMDirtyRectangle(Common::Rectangle<u32>::FromExtents(x, y, width, height));
+  m_renderer_stats.num_vram_writes++;
 
   if (check_mask)
   {
@@ -1254,6 +1960,91 @@ void GPU_HW::UpdateVRAM(u32 x, u32 y, u32 width, u32 height, const void* data, b
   }
 }
 
+void GPU_HW::FlushVRAMWrites()
+{
+  m_pending_vram_writes.clear();
+  m_merged_vram_write.Clear();
+}
+
+bool GPU_HW::HasPendingVRAMWrites(const Common::Rectangle<u32>& rect) const
+{
+  if (!m_merged_vram_write.IsEmpty() && m_merged_vram_write.bounds.Intersects(rect))
+    return true;
+
+  for (const PendingVRAMWrite& write : m_pending_vram_writes)
+  {
+    if (write.bounds.Intersects(rect))
+      return true;
+  }
+
+  return false;
+}
+
+bool GPU_HW::MergedVRAMWrite::Add(u32 x, u32 y, u32 width, u32 height, const void* write_data, bool write_set_mask,
+                                  float write_depth_value)
+{
+  // writes which wrap around VRAM are uploaded as they are
+  if ((x + width) > VRAM_WIDTH || (y + height) > VRAM_HEIGHT)
+    return false;
+
+  const Common::Rectangle<u32> write_bounds = Common::Rectangle<u32>::FromExtents(x, y, width, height);
+  if (pieces.empty())
+  {
+    pieces.push_back(Piece{write_bounds, 0});
+    bounds = write_bounds;
+    depth_value = write_depth_value;
+    set_mask = write_set_mask;
+  }
+  else
+  {
+    if (write_set_mask != set_mask || write_depth_value != depth_value)
+      return false;
+
+    // the last piece's data is at the end of the buffer, so growing it downwards keeps it contiguous
+    Piece& last = pieces.back();
+    if (x == last.bounds.left && width == last.bounds.GetWidth() && y == last.bounds.bottom)
+      last.bounds.bottom += height;
+    else if (x == bounds.right && y == bounds.top)
+      pieces.push_back(Piece{write_bounds, static_cast<u32>(data.size())});
+    else
+      return false;
+
+    bounds.Include(write_bounds);
+  }
+
+  const u16* src = static_cast<const u16*>(write_data);
+  data.insert(data.end(), src, src + (width * height));
+  return true;
+}
+
+bool GPU_HW::MergedVRAMWrite::Assemble(u16* dst) const
+{
+  for (const Piece& piece : pieces)
+  {
+    if (piece.bounds.top != bounds.top || piece.bounds.bottom != bounds.bottom)
+      return false;
+  }
+
+  const u32 row_width = bounds.GetWidth();
+  const u32 num_rows = bounds.GetHeight();
+  for (const Piece& piece : pieces)
+  {
+    const u32 piece_width = piece.bounds.GetWidth();
+    const u16* src = &data[piece.data_offset];
+    u16* piece_dst = dst + (piece.bounds.left - bounds.left);
+    for (u32 row = 0; row < num_rows; row++)
+      std::memcpy(piece_dst + (row * row_width), src + (row * piece_width), piece_width * sizeof(u16));
+  }
+
+  return true;
+}
+
+void GPU_HW::MergedVRAMWrite::Clear()
+{
+  pieces.clear();
+  data.clear();
+}
+
 void GPU_HW::CopyVRAM(u32 src_x, u32 src_y, u32 dst_x, u32 dst_y, u32 width, u32 height)
 {
   IncludeVRAMDirtyRectangle(
@@ -1268,6 +2059,18 @@ void GPU_HW::CopyVRAM(u32 src_x, u32 src_y, u32 dst_x, u32 dst_y, u32 width, u32
 
 void GPU_HW::DispatchRenderCommand()
 {
+  // Staged VRAM writes only have to be drawn before primitives which could overwrite them, anything sampling them
+  // goes through the read texture update. They can't be left pending while the render thread is recording, though.
+  if (HasPendingVRAMWrites() &&
+      (m_render_thread || HasPendingVRAMWrites(Common::Rectangle<u32>(m_drawing_area.left, m_drawing_area.top,
+                                                                      m_drawing_area.right + 1,
+                                                                      m_drawing_area.bottom + 1))))
+  {
+    FlushVRAMWrites();
+  }
+
+  BeginRenderThreadRecording();
+
   const GPURenderCommand rc{m_render_command.bits};
 
   GPUTextureMode texture_mode;
@@ -1277,18 +2080,24 @@ void GPU_HW::DispatchRenderCommand()
     if (m_draw_mode.IsTexturePageChanged())
     {
       m_draw_mode.ClearTexturePageChangedFlag();
-      if (m_vram_dirty_rect.Valid() && (m_draw_mode.mode_reg.GetTexturePageRectangle().Intersects(m_vram_dirty_rect) ||
-                                        (m_draw_mode.mode_reg.IsUsingPalette() &&
-                                         m_draw_mode.GetTexturePaletteRectangle().Intersects(m_vram_dirty_rect))))
+      const u32 dirty_pages =
+        m_vram_dirty_page_mask ?
+          (GetDirtyVRAMPages(m_draw_mode.mode_reg.GetTexturePageRectangle()) |
+           (m_draw_mode.mode_reg.IsUsingPalette() ? GetDirtyVRAMPages(m_draw_mode.GetTexturePaletteRectangle()) : 0u)) :
+          0u;
+      if (dirty_pages != 0)
       {
         // Log_DevPrintf("Invalidating VRAM read cache due to drawing area overlap");
         if (!IsFlushed())
           FlushRender();
 
-        UpdateVRAMReadTexture();
+        UpdateVRAMReadTexturePages(dirty_pages);
       }
     }
 
+    if (m_use_palette_texture_cache && m_draw_mode.mode_reg.IsUsingPalette())
+      UpdatePaletteTexture();
+
     texture_mode = m_draw_mode.mode_reg.texture_mode;
     if (rc.raw_texture_enable)
     {
@@ -1305,11 +2114,15 @@ void GPU_HW::DispatchRenderCommand()
   const GPUTransparencyMode transparency_mode =
     rc.transparency_enable ? m_draw_mode.mode_reg.transparency_mode : GPUTransparencyMode::Disabled;
   const bool dithering_enable = (!m_true_color && rc.IsDitheringEnabled()) ? m_GPUSTAT.dither_enable : false;
-  if (texture_mode != m_batch.texture_mode || transparency_mode != m_batch.transparency_mode ||
+  if (!IsSameBatchTextureMode(texture_mode, m_batch.texture_mode) || transparency_mode != m_batch.transparency_mode ||
       transparency_mode == GPUTransparencyMode::BackgroundMinusForeground || dithering_enable != m_batch.dithering)
   {
     FlushRender();
   }
+  else if (texture_mode != m_batch.texture_mode && !IsFlushed())
+  {
+    m_renderer_stats.num_merged_texture_mode_changes++;
+  }
 
   EnsureVertexBufferSpaceForCurrentCommand();
 
@@ -1349,6 +2162,8 @@ void GPU_HW::DispatchRenderCommand()
   m_batch.texture_mode = texture_mode;
   m_batch.transparency_mode = transparency_mode;
   m_batch.dithering = dithering_enable;
+  if (m_use_uber_shaders)
+    UpdateBatchUBOShaderFlags();
 
   if (m_draw_mode.IsTextureWindowChanged())
   {
@@ -1364,10 +2179,10 @@ void GPU_HW::DispatchRenderCommand()
   if (m_drawing_area_changed)
   {
     m_drawing_area_changed = false;
-    SetScissorFromDrawingArea();
+    ApplyDrawingAreaScissor();
 
     if (m_pgxp_depth_buffer && m_last_depth_z < 1.0f)
-      ClearDepthBuffer();
+      ClearBatchDepthBuffer();
 
     if (m_sw_renderer)
     {
@@ -1385,12 +2200,21 @@ void GPU_HW::FlushRender()
   if (!m_batch_current_vertex_ptr)
     return;
 
-  const u32 vertex_count = GetBatchVertexCount();
+  // skipped batches are thrown away, the UBO stays dirty for the next batch which is drawn
+  const u32 vertex_count = m_skip_rendering ? 0 : GetBatchVertexCount();
+  DebugAssert(!m_use_quad_index_buffer || (GetBatchVertexCount() % 4) == 0);
+  if (m_render_thread_recording)
+  {
+    QueueBatch(vertex_count);
+    return;
+  }
+
   UnmapBatchVertexPointer(vertex_count);
 
   if (vertex_count == 0)
     return;
 
+  g_host_display->SetGPUTimingScope(GPUTimingScope::BatchDraws);
   if (m_batch_ubo_dirty)
   {
     UploadUniformBuffer(&m_batch_ubo_data, sizeof(m_batch_ubo_data));
@@ -1400,16 +2224,41 @@ void GPU_HW::FlushRender()
   if (NeedsTwoPassRendering())
   {
     m_renderer_stats.num_batches += 2;
-    DrawBatchVertices(BatchRenderMode::OnlyOpaque, m_batch_base_vertex, vertex_count);
-    DrawBatchVertices(BatchRenderMode::OnlyTransparent, m_batch_base_vertex, vertex_count);
+    DrawBatchVertices(m_batch, BatchRenderMode::OnlyOpaque, m_batch_base_vertex, vertex_count);
+    DrawBatchVertices(m_batch, BatchRenderMode::OnlyTransparent, m_batch_base_vertex, vertex_count);
   }
   else
   {
     m_renderer_stats.num_batches++;
-    DrawBatchVertices(m_batch.GetRenderMode(), m_batch_base_vertex, vertex_count);
+    DrawBatchVertices(m_batch, m_batch.GetRenderMode(), m_batch_base_vertex, vertex_count);
   }
 }
 
+void GPU_HW::QueueBatch(u32 vertex_count)
+{
+  m_batch_start_vertex_ptr = nullptr;
+  m_batch_current_vertex_ptr = nullptr;
+  m_batch_end_vertex_ptr = nullptr;
+  if (vertex_count == 0)
+    return;
+
+  RenderThread::DrawBatchCommand* cmd = m_render_thread->NewCommand<RenderThread::DrawBatchCommand>(
+    GPUBackendCommandType::HWDrawBatch, sizeof(RenderThread::DrawBatchCommand) + (sizeof(BatchVertex) * vertex_count));
+  cmd->batch = m_batch;
+  cmd->ubo_dirty = m_batch_ubo_dirty;
+  if (m_batch_ubo_dirty)
+  {
+    cmd->ubo_data = m_batch_ubo_data;
+    m_batch_ubo_dirty = false;
+  }
+  cmd->two_pass = NeedsTwoPassRendering();
+  cmd->num_vertices = vertex_count;
+  std::memcpy(cmd->vertices, m_render_thread->GetStagingVertices(), sizeof(BatchVertex) * vertex_count);
+  m_render_thread->PushCommand(cmd);
+
+  m_renderer_stats.num_batches += cmd->two_pass ? 2 : 1;
+}
+
 void GPU_HW::DrawRendererStats(bool is_idle_frame)
 {
   if (!is_idle_frame)
@@ -1474,16 +2323,52 @@ void GPU_HW::DrawRendererStats(bool is_idle_frame)
     ImGui::Text("%u", stats.num_batches);
     ImGui::NextColumn();
 
+    ImGui::TextUnformatted("Texture Mode Merges:");
+    ImGui::NextColumn();
+    ImGui::Text("%u", stats.num_merged_texture_mode_changes);
+    ImGui::NextColumn();
+
+    ImGui::TextUnformatted("Palette Textures Decoded:");
+    ImGui::NextColumn();
+    ImGui::Text("%u", stats.num_palette_texture_decodes);
+    ImGui::NextColumn();
+
     ImGui::TextUnformatted("VRAM Read Texture Updates:");
     ImGui::NextColumn();
     ImGui::Text("%u", stats.num_vram_read_texture_updates);
     ImGui::NextColumn();
 
+    ImGui::TextUnformatted("VRAM Read Texture Copied:");
+    ImGui::NextColumn();
+    ImGui::Text("%u KB", stats.num_vram_read_texture_bytes / 1024);
+    ImGui::NextColumn();
+
     ImGui::TextUnformatted("Uniform Buffer Updates: ");
     ImGui::NextColumn();
     ImGui::Text("%u", stats.num_uniform_buffer_updates);
     ImGui::NextColumn();
 
+    ImGui::TextUnformatted("Readback Stalls Avoided:");
+    ImGui::NextColumn();
+    ImGui::Text("%u", stats.num_readback_stalls_avoided);
+    ImGui::NextColumn();
+
+    ImGui::TextUnformatted("VRAM Writes/Uploads:");
+    ImGui::NextColumn();
+    ImGui::Text("%u / %u", stats.num_vram_writes, stats.num_vram_write_uploads);
+    ImGui::NextColumn();
+
+    ImGui::TextUnformatted("Depth Buffer Pages Reset:");
+    ImGui::NextColumn();
+    ImGui::Text("%u", stats.num_depth_buffer_page_resets);
+    ImGui::NextColumn();
+
+    ImGui::TextUnformatted("Stream Buffer Waits/Grows:");
+    ImGui::NextColumn();
+    ImGui::Text("%u (%.2fms) / %u", stats.num_stream_buffer_waits,
+                static_cast<float>(stats.stream_buffer_wait_time_us) / 1000.0f, stats.num_stream_buffer_grows);
+    ImGui::NextColumn();
+
     ImGui::Columns(1);
   }
 }
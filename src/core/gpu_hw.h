@@ -5,6 +5,7 @@
 #include "common/heap_array.h"
 #include "gpu.h"
 #include "host_display.h"
+#include <array>
 #include <sstream>
 #include <string>
 #include <tuple>
@@ -33,16 +34,30 @@ public:
     SeparateFields
   };
 
+  enum : u32
+  {
+    // Decoded palette textures are whole texture pages at native resolution, packed into a square atlas. The slot
+    // takes the place of the palette in the vertex texpage, with PALETTE_TEXTURE_CACHE_FLAG set.
+    PALETTE_TEXTURE_CACHE_SLOT_SIZE = 256,
+    PALETTE_TEXTURE_CACHE_SLOTS_X = 8,
+    NUM_PALETTE_TEXTURE_CACHE_SLOTS = PALETTE_TEXTURE_CACHE_SLOTS_X * PALETTE_TEXTURE_CACHE_SLOTS_X,
+    PALETTE_TEXTURE_CACHE_SIZE = PALETTE_TEXTURE_CACHE_SLOT_SIZE * PALETTE_TEXTURE_CACHE_SLOTS_X,
+    PALETTE_TEXTURE_CACHE_FLAG = 0x80000000u,
+  };
+  static_assert(NUM_PALETTE_TEXTURE_CACHE_SLOTS <= 64, "Palette texture cache slot fits in the texpage palette x");
+
   GPU_HW();
   virtual ~GPU_HW();
 
   const Threading::Thread* GetSWThread() const override;
+  GPUBackendThreadStats GetAndResetSWThreadStats() override;
 
   virtual bool Initialize() override;
   virtual void Reset(bool clear_vram) override;
   virtual bool DoState(StateWrapper& sw, GPUTexture** host_texture, bool update_display) override;
 
   void UpdateResolutionScale() override final;
+  void UpdateDynamicResolution(float gpu_time_ms, float frame_time_budget_ms) override final;
   std::tuple<u32, u32> GetEffectiveDisplayResolution(bool scaled = true) override final;
   std::tuple<u32, u32> GetFullDisplayResolution(bool scaled = true) override final;
 
@@ -54,8 +69,27 @@ protected:
     UNIFORM_BUFFER_SIZE = 2 * 1024 * 1024,
     MAX_BATCH_VERTEX_COUNTER_IDS = 65536 - 2,
     MAX_VERTICES_FOR_RECTANGLE = 6 * (((MAX_PRIMITIVE_WIDTH + (TEXTURE_PAGE_WIDTH - 1)) / TEXTURE_PAGE_WIDTH) + 1u) *
-                                 (((MAX_PRIMITIVE_HEIGHT + (TEXTURE_PAGE_HEIGHT - 1)) / TEXTURE_PAGE_HEIGHT) + 1u)
+                                 (((MAX_PRIMITIVE_HEIGHT + (TEXTURE_PAGE_HEIGHT - 1)) / TEXTURE_PAGE_HEIGHT) + 1u),
+
+    // Quads are drawn from 16-bit indices, so a batch can't address more vertices than this.
+    MAX_INDEXED_BATCH_VERTEX_COUNT = 65536,
+
+    // Dirty tracking granularity for the VRAM read texture, matching the texture page base alignment.
+    VRAM_PAGE_WIDTH = 64,
+    VRAM_PAGE_HEIGHT = 256,
+    NUM_VRAM_PAGES_X = VRAM_WIDTH / VRAM_PAGE_WIDTH,
+    NUM_VRAM_PAGES_Y = VRAM_HEIGHT / VRAM_PAGE_HEIGHT,
+    NUM_VRAM_PAGES = NUM_VRAM_PAGES_X * NUM_VRAM_PAGES_Y,
+
+    // Dynamic resolution drops the scale quickly when over budget, but only raises it after a long stretch with
+    // headroom, and holds each change for a while, so it doesn't flip back and forth.
+    DYNAMIC_RESOLUTION_DOWN_FRAMES = 30,
+    DYNAMIC_RESOLUTION_UP_FRAMES = 300,
+    DYNAMIC_RESOLUTION_HOLD_FRAMES = 120,
   };
+  static_assert(NUM_VRAM_PAGES <= 32);
+  static constexpr u32 ALL_VRAM_PAGES_MASK =
+    (NUM_VRAM_PAGES == 32) ? UINT32_C(0xFFFFFFFF) : ((UINT32_C(1) << (NUM_VRAM_PAGES % 32)) - 1u);
   static_assert(VRAM_UPDATE_TEXTURE_BUFFER_SIZE >= VRAM_WIDTH * VRAM_HEIGHT * sizeof(u16));
 
   struct BatchVertex
@@ -127,6 +161,12 @@ protected:
     float u_dst_alpha_factor;
     u32 u_interlaced_displayed_field;
     u32 u_set_mask_while_drawing;
+
+    // Only read by uber shaders.
+    u32 u_textured;
+    u32 u_raw_texture;
+    u32 u_dithering;
+    u32 u_interlacing;
   };
 
   struct VRAMFillUBOData
@@ -169,8 +209,54 @@ protected:
   struct RendererStats
   {
     u32 num_batches;
+    u32 num_merged_texture_mode_changes;
+    u32 num_palette_texture_decodes;
     u32 num_vram_read_texture_updates;
+    u32 num_vram_read_texture_bytes;
     u32 num_uniform_buffer_updates;
+    u32 num_readback_stalls_avoided;
+    u32 num_vram_writes;
+    u32 num_vram_write_uploads;
+    u32 num_depth_buffer_page_resets;
+    u32 num_stream_buffer_waits;
+    u32 stream_buffer_wait_time_us;
+    u32 num_stream_buffer_grows;
+  };
+
+  /// CPU->VRAM write whose data is already in the backend's stream buffer, but hasn't been drawn to VRAM yet.
+  struct PendingVRAMWrite
+  {
+    Common::Rectangle<u32> bounds;
+    VRAMWriteUBOData uniforms;
+    bool check_mask;
+  };
+
+  /// Run of adjacent CPU->VRAM writes which is still on the CPU side, so it can be uploaded as a single rectangle.
+  /// Streamed FMV frames are written as a series of macroblock columns, which end up as one upload this way.
+  struct MergedVRAMWrite
+  {
+    struct Piece
+    {
+      Common::Rectangle<u32> bounds;
+      u32 data_offset;
+    };
+
+    std::vector<Piece> pieces;
+    std::vector<u16> data;
+    Common::Rectangle<u32> bounds;
+    float depth_value;
+    bool set_mask;
+
+    ALWAYS_INLINE bool IsEmpty() const { return pieces.empty(); }
+
+    /// Adds the write to the run if it continues the last column downwards, or starts a new column on the right.
+    bool Add(u32 x, u32 y, u32 width, u32 height, const void* write_data, bool write_set_mask, float write_depth_value);
+
+    /// Copies the data row-major over the bounds. Returns false if the columns aren't all the same height, in which
+    /// case each piece has to be uploaded on its own, from its data_offset.
+    bool Assemble(u16* dst) const;
+
+    void Clear();
   };
 
   class ShaderCompileProgressTracker
@@ -199,18 +285,58 @@ protected:
   }
 
   void UpdateHWSettings(bool* framebuffer_changed, bool* shaders_changed);
+  void UpdateBatchUBOShaderFlags();
 
-  virtual void UpdateVRAMReadTexture();
-  virtual void UpdateDepthBufferFromMaskBit() = 0;
-  virtual void ClearDepthBuffer() = 0;
+  virtual void CopyVRAMToReadTexture(const Common::Rectangle<u32>& rect) = 0;
+  virtual void UpdateDepthBufferFromMaskBit(const Common::Rectangle<u32>& rect) = 0;
+  virtual void ClearDepthBuffer(const Common::Rectangle<u32>& rect) = 0;
   virtual void SetScissorFromDrawingArea() = 0;
   virtual void MapBatchVertexPointer(u32 required_vertices) = 0;
   virtual void UnmapBatchVertexPointer(u32 used_vertices) = 0;
   virtual void UploadUniformBuffer(const void* uniforms, u32 uniforms_size) = 0;
-  virtual void DrawBatchVertices(BatchRenderMode render_mode, u32 base_vertex, u32 num_vertices) = 0;
+  virtual void DrawBatchVertices(const BatchConfig& batch, BatchRenderMode render_mode, u32 base_vertex,
+                                 u32 num_vertices) = 0;
+
+  /// Decodes the texture page and palette in texpage to RGBA8, in the palette texture cache slot. Only called when
+  /// the backend sets m_use_palette_texture_cache.
+  virtual void DecodePaletteTexture(u32 slot, u32 texpage);
+
+  /// Returns true if the backend can record draws from the render thread. Requires UploadBatchVertices().
+  virtual bool SupportsRenderThread() const;
+
+  /// Copies vertices into the vertex stream buffer without touching the batch pointers, returning the base vertex.
+  virtual u32 UploadBatchVertices(const BatchVertex* vertices, u32 num_vertices);
+
+  /// Called with the render thread idle, before it starts recording and once it has finished.
+  virtual void OnRenderThreadRecordingStarted();
+  virtual void OnRenderThreadRecordingFinished();
+
+  /// Starts or stops the render thread based on the current settings.
+  void UpdateRenderThread();
+
+  /// Waits for the render thread to finish all recorded work, after which the host API can be used directly.
+  void SyncRenderThread(bool allow_sleep = false);
+
+  /// Copies the dirty area of VRAM to the read texture, deferring to the render thread if it's recording.
+  void UpdateVRAMReadTexture();
+
+  /// Copies only the dirty parts of the specified VRAM pages to the read texture.
+  void UpdateVRAMReadTexturePages(u32 page_mask);
+
+  /// Draws all staged VRAM writes to the VRAM texture. Backends which stage writes must override this.
+  virtual void FlushVRAMWrites();
+
+  ALWAYS_INLINE bool HasPendingVRAMWrites() const
+  {
+    return (!m_pending_vram_writes.empty() || !m_merged_vram_write.IsEmpty());
+  }
+
+  /// Returns true if any staged or merged VRAM write overlaps the rectangle.
+  bool HasPendingVRAMWrites(const Common::Rectangle<u32>& rect) const;
 
   u32 CalculateResolutionScale() const;
   GPUDownsampleMode GetDownsampleMode(u32 resolution_scale) const;
+  bool ShouldUseComputeDownsampling(GPUDownsampleMode mode) const;
 
   ALWAYS_INLINE bool IsUsingMultisampling() const { return m_multisamples > 1; }
   ALWAYS_INLINE bool IsUsingDownsampling() const
@@ -218,16 +344,62 @@ protected:
     return (m_downsample_mode != GPUDownsampleMode::Disabled && !m_GPUSTAT.display_area_color_depth_24);
   }
 
-  void SetFullVRAMDirtyRectangle()
+  void SetFullVRAMDirtyRectangle();
+  void ClearVRAMDirtyRectangle();
+
+  /// Forgets every decoded palette texture, for when the backend's cache texture is recreated.
+  void InvalidatePaletteTextureCache();
+
+  /// Rebuilds the depth buffer from the mask bit, in the pages which have been written since it was last reset.
+  void UpdateDepthBufferPagesFromMaskBit();
+  void IncludeVRAMDirtyRectangle(const Common::Rectangle<u32>& rect);
+
+  /// Returns the mask of VRAM pages overlapping the rectangle.
+  static u32 GetVRAMPageMask(const Common::Rectangle<u32>& rect);
+
+  /// Returns the mask of pages whose dirty area overlaps the rectangle.
+  u32 GetDirtyVRAMPages(const Common::Rectangle<u32>& rect) const;
+
+  /// Returns true if the speculative readback holds up-to-date contents for the whole rectangle.
+  bool IsSpeculativeReadbackValid(const Common::Rectangle<u32>& rect) const
   {
-    m_vram_dirty_rect.Set(0, 0, VRAM_WIDTH, VRAM_HEIGHT);
-    m_draw_mode.SetTexturePageChanged();
+    return (m_speculative_readback_rect.Valid() && rect.left >= m_speculative_readback_rect.left &&
+            rect.right <= m_speculative_readback_rect.right && rect.top >= m_speculative_readback_rect.top &&
+            rect.bottom <= m_speculative_readback_rect.bottom);
   }
-  void ClearVRAMDirtyRectangle() { m_vram_dirty_rect.SetInvalid(); }
-  void IncludeVRAMDirtyRectangle(const Common::Rectangle<u32>& rect);
 
   bool IsFlushed() const { return m_batch_current_vertex_ptr == m_batch_start_vertex_ptr; }
 
+  /// Per-sample shading only applies to textured batches. Untextured batches have no texels to super-sample, so they
+  /// are shaded once per pixel and rely on MSAA coverage for their edges.
+  ALWAYS_INLINE bool UsingPerSampleShading() const { return (m_multisamples > 1 && m_per_sample_shading); }
+
+  /// Returns the state used to pick the batch shader/pipeline. Uber shaders read texturing, dithering and interlacing
+  /// from the uniform buffer, so every batch shares the same textured variant, except for untextured batches with
+  /// per-sample shading, which get their own coverage-only variant.
+  ALWAYS_INLINE BatchConfig GetBatchShaderConfig(const BatchConfig& batch) const
+  {
+    if (!m_use_uber_shaders)
+      return batch;
+
+    BatchConfig config = batch;
+    if (batch.texture_mode != GPUTextureMode::Disabled || !UsingPerSampleShading())
+      config.texture_mode = GPUTextureMode::Palette4Bit;
+    config.dithering = false;
+    config.interlacing = false;
+    return config;
+  }
+
+  /// Returns false for batch shader variants which are never used because the uber shader covers them.
+  ALWAYS_INLINE bool IsBatchShaderVariantUsed(bool uber_shaders, GPUTextureMode texture_mode, bool dithering,
+                                              bool interlacing) const
+  {
+    return (!uber_shaders ||
+            ((texture_mode == GPUTextureMode::Palette4Bit ||
+              (texture_mode == GPUTextureMode::Disabled && UsingPerSampleShading())) &&
+             !dithering && !interlacing));
+  }
+
   u32 GetBatchVertexSpace() const { return static_cast<u32>(m_batch_end_vertex_ptr - m_batch_current_vertex_ptr); }
   u32 GetBatchVertexCount() const { return static_cast<u32>(m_batch_current_vertex_ptr - m_batch_start_vertex_ptr); }
   void EnsureVertexBufferSpace(u32 required_vertices);
@@ -309,6 +481,7 @@ protected:
   void FlushRender() override;
   void DrawRendererStats(bool is_idle_frame) override;
 
+  /// Computes the scissor rectangle for the drawing area last passed to the host.
   void CalcScissorRect(int* left, int* top, int* right, int* bottom);
 
   std::tuple<s32, s32> ScaleVRAMCoordinates(s32 x, s32 y) const
@@ -368,6 +541,13 @@ protected:
   u32 m_resolution_scale = 1;
   u32 m_multisamples = 1;
   u32 m_max_resolution_scale = 1;
+
+  // Upper bound on the resolution scale set by dynamic resolution, or zero when it's at the configured scale.
+  u32 m_dynamic_resolution_scale = 0;
+  u32 m_dynamic_resolution_hold_frames = 0;
+  u32 m_dynamic_resolution_over_frames = 0;
+  u32 m_dynamic_resolution_under_frames = 0;
+  float m_dynamic_resolution_gpu_time = 0.0f;
   u32 m_max_multisamples = 1;
   RenderAPI m_render_api = RenderAPI::None;
   bool m_true_color = true;
@@ -388,8 +568,21 @@ protected:
 
   GPUTextureFilter m_texture_filtering = GPUTextureFilter::Nearest;
   GPUDownsampleMode m_downsample_mode = GPUDownsampleMode::Disabled;
+  GPUShaderMode m_shader_mode = GPUShaderMode::Specialized;
+  bool m_use_uber_shaders = false;
+  bool m_adaptive_texture_filtering = false;
   bool m_using_uv_limits = false;
   bool m_pgxp_depth_buffer = false;
+  bool m_supports_compute_downsampling = false;
+  bool m_use_compute_downsampling = false;
+
+  // Every primitive is written as four vertices and drawn through the static quad index buffer, [0,1,2,2,1,3] + 4n.
+  // Triangles repeat their last vertex, which makes the second triangle degenerate.
+  bool m_use_quad_index_buffer = false;
+
+  // Palette textures are decoded into a cache texture when they're first drawn with, so batches sample them with one
+  // fetch instead of an index fetch followed by a dependent palette fetch.
+  bool m_use_palette_texture_cache = false;
 
   BatchConfig m_batch;
   BatchUBOData m_batch_ubo_data = {};
@@ -397,6 +590,23 @@ protected:
   // Bounding box of VRAM area that the GPU has drawn into.
   Common::Rectangle<u32> m_vram_dirty_rect;
 
+  // Dirty area within each VRAM page, so textured draws only refresh the pages they sample.
+  std::array<Common::Rectangle<u32>, NUM_VRAM_PAGES> m_vram_dirty_page_rects;
+  u32 m_vram_dirty_page_mask = 0;
+
+  // Pages whose depth has been written since the depth buffer was last cleared or rebuilt from the mask bit.
+  u32 m_vram_depth_dirty_page_mask = 0;
+
+  // Area read back by the CPU since the last speculative readback was queued.
+  Common::Rectangle<u32> m_frame_readback_rect;
+
+  // Area held by the speculative readback, invalidated as soon as anything writes to it.
+  Common::Rectangle<u32> m_speculative_readback_rect;
+
+  // Consecutive VRAM writes, drawn together when something reads or draws over them, or at the end of the frame.
+  std::vector<PendingVRAMWrite> m_pending_vram_writes;
+  MergedVRAMWrite m_merged_vram_write = {};
+
   // Statistics
   RendererStats m_renderer_stats = {};
   RendererStats m_last_renderer_stats = {};
@@ -404,15 +614,62 @@ protected:
   // Changed state
   bool m_batch_ubo_dirty = true;
 
+  // Drawing area which the host scissor was last set from. Owned by the render thread while it's recording.
+  Common::Rectangle<u32> m_host_drawing_area{};
+
 private:
+  class RenderThread;
+
   enum : u32
   {
     MIN_BATCH_VERTEX_COUNT = 6,
-    MAX_BATCH_VERTEX_COUNT = VERTEX_BUFFER_SIZE / sizeof(BatchVertex)
+    MAX_BATCH_VERTEX_COUNT = VERTEX_BUFFER_SIZE / sizeof(BatchVertex),
+
+    // Texture page position, colour mode and palette. The rest of the texpage doesn't change the decoded texels.
+    PALETTE_TEXTURE_KEY_MASK = 0x7FFF019Fu,
+    INVALID_PALETTE_TEXTURE_KEY = 0xFFFFFFFFu,
+  };
+
+  struct PaletteTextureCacheEntry
+  {
+    u32 key;
+    u64 last_used;
+
+    // Areas of VRAM the texels were decoded from, which may extend past the right edge.
+    Common::Rectangle<u32> page_rect;
+    Common::Rectangle<u32> palette_rect;
   };
 
   void LoadVertices();
 
+  /// Makes sure the current texture page and palette are decoded in the palette texture cache.
+  void UpdatePaletteTexture();
+
+  /// Drops decoded palette textures which were read from the area, as the read texture is about to change there.
+  void InvalidatePaletteTextures(const Common::Rectangle<u32>& rect);
+
+  /// Adds the rectangle to the overall and per-page dirty areas.
+  void IncludeVRAMDirtyPages(const Common::Rectangle<u32>& rect);
+
+  /// Copies an area of VRAM to the read texture, or queues it while the render thread is recording.
+  void QueueVRAMReadTextureCopy(const Common::Rectangle<u32>& rect);
+
+  /// Hands the host API over to the render thread for the draws which follow.
+  void BeginRenderThreadRecording();
+
+  /// Maps the vertex stream buffer, or the render thread's staging area while recording.
+  void MapBatchVertices(u32 required_vertices);
+
+  /// Draw-path operations which are queued instead of executed while the render thread is recording.
+  void ApplyDrawingAreaScissor();
+  void ClearBatchDepthBuffer();
+
+  /// Clears or rebuilds the depth buffer in the dirty depth pages, merging horizontally adjacent pages.
+  void ResetDepthBufferPages(bool clear);
+
+  /// Moves the recorded batch into a draw command for the render thread.
+  void QueueBatch(u32 vertex_count);
+
   ALWAYS_INLINE void AddVertex(const BatchVertex& v)
   {
     std::memcpy(m_batch_current_vertex_ptr, &v, sizeof(BatchVertex));
@@ -427,4 +684,14 @@ private:
   }
 
   void PrintSettingsToLog();
+
+  std::unique_ptr<RenderThread> m_render_thread;
+  bool m_render_thread_recording = false;
+
+  std::array<PaletteTextureCacheEntry, NUM_PALETTE_TEXTURE_CACHE_SLOTS> m_palette_texture_cache;
+  u64 m_palette_texture_cache_counter = 0;
+
+  // Key and slot of the palette texture the current draw mode decodes to, so lookups only happen when it changes.
+  u32 m_palette_texture_cache_current_key = INVALID_PALETTE_TEXTURE_KEY;
+  u32 m_palette_texture_cache_current_slot = 0;
 };
@@ -14,10 +14,15 @@
 #include "util/state_wrapper.h"
 Log_SetChannel(GPU_HW_D3D11);
 
-GPU_HW_D3D11::GPU_HW_D3D11(ID3D11Device* device, ID3D11DeviceContext* context) : m_device(device), m_context(context) {}
+GPU_HW_D3D11::GPU_HW_D3D11(ID3D11Device* device, ID3D11DeviceContext* context)
+  : m_device(device), m_context(context), m_immediate_context(context)
+{
+}
 
 GPU_HW_D3D11::~GPU_HW_D3D11()
 {
+  SyncRenderThread();
+
   g_host_display->ClearDisplayTexture();
 
   DestroyShaders();
@@ -86,6 +91,8 @@ void GPU_HW_D3D11::Reset(bool clear_vram)
 
 bool GPU_HW_D3D11::DoState(StateWrapper& sw, GPUTexture** host_texture, bool update_display)
 {
+  SyncRenderThread();
+
   if (host_texture)
   {
     ComPtr<ID3D11Resource> resource;
@@ -127,6 +134,8 @@ bool GPU_HW_D3D11::DoState(StateWrapper& sw, GPUTexture** host_texture, bool upd
 
 void GPU_HW_D3D11::ResetGraphicsAPIState()
 {
+  SyncRenderThread(true);
+
   GPU_HW::ResetGraphicsAPIState();
 
   m_context->GSSetShader(nullptr, nullptr, 0);
@@ -136,6 +145,12 @@ void GPU_HW_D3D11::ResetGraphicsAPIState()
 }
 
 void GPU_HW_D3D11::RestoreGraphicsAPIState()
+{
+  SetBatchState();
+  m_batch_ubo_dirty = true;
+}
+
+void GPU_HW_D3D11::SetBatchState()
 {
   const UINT stride = sizeof(BatchVertex);
   const UINT offset = 0;
@@ -149,11 +164,12 @@ void GPU_HW_D3D11::RestoreGraphicsAPIState()
   m_context->RSSetState(m_cull_none_rasterizer_state.Get());
   SetViewport(0, 0, m_vram_texture.GetWidth(), m_vram_texture.GetHeight());
   SetScissorFromDrawingArea();
-  m_batch_ubo_dirty = true;
 }
 
 void GPU_HW_D3D11::UpdateSettings()
 {
+  SyncRenderThread();
+
   GPU_HW::UpdateSettings();
 
   bool framebuffer_changed, shaders_changed;
@@ -180,7 +196,7 @@ void GPU_HW_D3D11::UpdateSettings()
   {
     RestoreGraphicsAPIState();
     UpdateVRAM(0, 0, VRAM_WIDTH, VRAM_HEIGHT, m_vram_ptr, false, false);
-    UpdateDepthBufferFromMaskBit();
+    UpdateDepthBufferPagesFromMaskBit();
     UpdateDisplay();
     ResetGraphicsAPIState();
   }
@@ -217,8 +233,39 @@ void GPU_HW_D3D11::SetCapabilities()
   m_supports_dual_source_blend = true;
   m_supports_per_sample_shading = (m_device->GetFeatureLevel() >= D3D_FEATURE_LEVEL_10_1);
   m_supports_adaptive_downsampling = true;
+  m_supports_compute_downsampling = (m_device->GetFeatureLevel() >= D3D_FEATURE_LEVEL_11_0);
   m_supports_disable_color_perspective = true;
 
+  // Constant buffer offsets let uniforms be streamed like vertices, instead of discarding the buffer for every draw.
+  // Deferred contexts need the same D3D11.1 runtime support, to map the stream buffers with NO_OVERWRITE.
+  D3D11_FEATURE_DATA_D3D11_OPTIONS options = {};
+  if (SUCCEEDED(m_device->CheckFeatureSupport(D3D11_FEATURE_D3D11_OPTIONS, &options, sizeof(options))) &&
+      options.ConstantBufferOffsetting && options.MapNoOverwriteOnDynamicConstantBuffer)
+  {
+    m_context.As(&m_context1);
+  }
+  if (m_context1)
+  {
+    const HRESULT hr = m_device->CreateDeferredContext(0, m_deferred_context.ReleaseAndGetAddressOf());
+    if (FAILED(hr))
+    {
+      Log_WarningPrintf("CreateDeferredContext() failed: 0x%08X, render thread will not be available", hr);
+      m_deferred_context.Reset();
+    }
+
+    D3D11_FEATURE_DATA_THREADING threading = {};
+    if (m_deferred_context &&
+        SUCCEEDED(m_device->CheckFeatureSupport(D3D11_FEATURE_THREADING, &threading, sizeof(threading))) &&
+        !threading.DriverCommandLists)
+    {
+      Log_WarningPrintf("Driver does not support command lists, the render thread will be emulated by the runtime.");
+    }
+  }
+  else
+  {
+    Log_WarningPrintf("Constant buffer offsets are not supported, uniforms will not be streamed.");
+  }
+
   m_max_multisamples = 1;
   for (u32 multisamples = 2; multisamples < D3D11_MAX_MULTISAMPLE_SAMPLE_COUNT; multisamples++)
   {
@@ -253,7 +300,8 @@ bool GPU_HW_D3D11::CreateFramebuffer()
         m_device.Get(),
         ((m_downsample_mode == GPUDownsampleMode::Adaptive) ? VRAM_WIDTH : GPU_MAX_DISPLAY_WIDTH) * m_resolution_scale,
         GPU_MAX_DISPLAY_HEIGHT * m_resolution_scale, 1, 1, 1, texture_format,
-        D3D11_BIND_SHADER_RESOURCE | D3D11_BIND_RENDER_TARGET) ||
+        D3D11_BIND_SHADER_RESOURCE | D3D11_BIND_RENDER_TARGET |
+          (m_use_compute_downsampling ? D3D11_BIND_UNORDERED_ACCESS : 0)) ||
       !m_vram_encoding_texture.Create(m_device.Get(), VRAM_WIDTH / 2, VRAM_HEIGHT, 1, 1, 1, texture_format,
                                       D3D11_BIND_SHADER_RESOURCE | D3D11_BIND_RENDER_TARGET))
   {
@@ -268,7 +316,21 @@ bool GPU_HW_D3D11::CreateFramebuffer()
   if (FAILED(hr))
     return false;
 
-  if (m_downsample_mode == GPUDownsampleMode::Adaptive)
+  if (m_use_compute_downsampling)
+  {
+    // Only needs to hold a copy of the display texture, the compute shader does the rest in one dispatch.
+    if (!m_downsample_texture.Create(m_device.Get(), m_display_texture.GetWidth(), m_display_texture.GetHeight(), 1, 1,
+                                     1, texture_format, D3D11_BIND_SHADER_RESOURCE))
+    {
+      return false;
+    }
+
+    const CD3D11_UNORDERED_ACCESS_VIEW_DESC uav_desc(D3D11_UAV_DIMENSION_TEXTURE2D, m_display_texture.GetDXGIFormat());
+    hr = m_device->CreateUnorderedAccessView(m_display_texture, &uav_desc, m_display_uav.GetAddressOf());
+    if (FAILED(hr))
+      return false;
+  }
+  else if (m_downsample_mode == GPUDownsampleMode::Adaptive)
   {
     const u32 levels = GetAdaptiveDownsamplingMipLevels();
 
@@ -326,6 +388,7 @@ void GPU_HW_D3D11::ClearFramebuffer()
 
 void GPU_HW_D3D11::DestroyFramebuffer()
 {
+  m_display_uav.Reset();
   m_downsample_mip_views.clear();
   m_downsample_weight_texture.Destroy();
   m_downsample_texture.Destroy();
@@ -345,7 +408,8 @@ bool GPU_HW_D3D11::CreateVertexBuffer()
 
 bool GPU_HW_D3D11::CreateUniformBuffer()
 {
-  return m_uniform_stream_buffer.Create(m_device.Get(), D3D11_BIND_CONSTANT_BUFFER, MAX_UNIFORM_BUFFER_SIZE);
+  return m_uniform_stream_buffer.Create(m_device.Get(), D3D11_BIND_CONSTANT_BUFFER,
+                                        m_context1 ? UNIFORM_STREAM_BUFFER_SIZE : MAX_UNIFORM_BUFFER_SIZE);
 }
 
 bool GPU_HW_D3D11::CreateTextureBuffer()
@@ -491,8 +555,9 @@ bool GPU_HW_D3D11::CompileShaders()
                     g_settings.gpu_use_debug_device);
 
   GPU_HW_ShaderGen shadergen(g_host_display->GetRenderAPI(), m_resolution_scale, m_multisamples, m_per_sample_shading,
-                             m_true_color, m_scaled_dithering, m_texture_filtering, m_using_uv_limits,
-                             m_pgxp_depth_buffer, m_disable_color_perspective, m_supports_dual_source_blend);
+                             m_true_color, m_scaled_dithering, m_texture_filtering, m_adaptive_texture_filtering,
+                             m_using_uv_limits, m_pgxp_depth_buffer, m_disable_color_perspective,
+                             m_supports_dual_source_blend, m_use_palette_texture_cache);
 
   ShaderCompileProgressTracker progress("Compiling Shaders",
                                         1 + 1 + 2 + (4 * 9 * 2 * 2) + 1 + (2 * 2) + 4 + (2 * 3) + 1);
@@ -551,9 +616,21 @@ bool GPU_HW_D3D11::CompileShaders()
       {
         for (u8 interlacing = 0; interlacing < 2; interlacing++)
         {
-          const std::string ps = shadergen.GenerateBatchFragmentShader(
-            static_cast<BatchRenderMode>(render_mode), static_cast<GPUTextureMode>(texture_mode),
-            ConvertToBoolUnchecked(dithering), ConvertToBoolUnchecked(interlacing));
+          if (!IsBatchShaderVariantUsed(m_use_uber_shaders, static_cast<GPUTextureMode>(texture_mode),
+                                        ConvertToBoolUnchecked(dithering), ConvertToBoolUnchecked(interlacing)))
+          {
+            progress.Increment();
+            continue;
+          }
+
+          const std::string ps =
+            m_use_uber_shaders ?
+              shadergen.GenerateBatchUberFragmentShader(
+                static_cast<BatchRenderMode>(render_mode),
+                static_cast<GPUTextureMode>(texture_mode) != GPUTextureMode::Disabled) :
+              shadergen.GenerateBatchFragmentShader(
+                static_cast<BatchRenderMode>(render_mode), static_cast<GPUTextureMode>(texture_mode),
+                ConvertToBoolUnchecked(dithering), ConvertToBoolUnchecked(interlacing));
 
           m_batch_pixel_shaders[render_mode][texture_mode][dithering][interlacing] =
             shader_cache.GetPixelShader(m_device.Get(), ps);
@@ -627,7 +704,14 @@ bool GPU_HW_D3D11::CompileShaders()
     }
   }
 
-  if (m_downsample_mode == GPUDownsampleMode::Adaptive)
+  if (m_use_compute_downsampling)
+  {
+    m_downsample_compute_shader =
+      shader_cache.GetComputeShader(m_device.Get(), shadergen.GenerateAdaptiveDownsampleComputeShader());
+    if (!m_downsample_compute_shader)
+      return false;
+  }
+  else if (m_downsample_mode == GPUDownsampleMode::Adaptive)
   {
     m_downsample_first_pass_pixel_shader =
       shader_cache.GetPixelShader(m_device.Get(), shadergen.GenerateAdaptiveDownsampleMipFragmentShader(true));
@@ -661,6 +745,7 @@ bool GPU_HW_D3D11::CompileShaders()
 
 void GPU_HW_D3D11::DestroyShaders()
 {
+  m_downsample_compute_shader.Reset();
   m_downsample_composite_pixel_shader.Reset();
   m_downsample_blur_pass_pixel_shader.Reset();
   m_downsample_mid_pass_pixel_shader.Reset();
@@ -683,12 +768,29 @@ void GPU_HW_D3D11::UploadUniformBuffer(const void* data, u32 data_size)
 {
   Assert(data_size <= MAX_UNIFORM_BUFFER_SIZE);
 
-  const auto res = m_uniform_stream_buffer.Map(m_context.Get(), MAX_UNIFORM_BUFFER_SIZE, data_size);
-  std::memcpy(res.pointer, data, data_size);
-  m_uniform_stream_buffer.Unmap(m_context.Get(), data_size);
+  if (m_context1)
+  {
+    // Append to the stream buffer with NO_OVERWRITE, and bind just the range which was written.
+    const auto res = m_uniform_stream_buffer.Map(m_context.Get(), UNIFORM_BUFFER_ALIGNMENT, data_size);
+    std::memcpy(res.pointer, data, data_size);
+    m_uniform_stream_buffer.Unmap(m_context.Get(), data_size);
+
+    const UINT first_constant = res.buffer_offset / 16u;
+    const UINT num_constants = UNIFORM_BUFFER_ALIGNMENT / 16u;
+    m_context1->VSSetConstantBuffers1(0, 1, m_uniform_stream_buffer.GetD3DBufferArray(), &first_constant,
+                                      &num_constants);
+    m_context1->PSSetConstantBuffers1(0, 1, m_uniform_stream_buffer.GetD3DBufferArray(), &first_constant,
+                                      &num_constants);
+  }
+  else
+  {
+    const auto res = m_uniform_stream_buffer.Map(m_context.Get(), MAX_UNIFORM_BUFFER_SIZE, data_size);
+    std::memcpy(res.pointer, data, data_size);
+    m_uniform_stream_buffer.Unmap(m_context.Get(), data_size);
 
-  m_context->VSSetConstantBuffers(0, 1, m_uniform_stream_buffer.GetD3DBufferArray());
-  m_context->PSSetConstantBuffers(0, 1, m_uniform_stream_buffer.GetD3DBufferArray());
+    m_context->VSSetConstantBuffers(0, 1, m_uniform_stream_buffer.GetD3DBufferArray());
+    m_context->PSSetConstantBuffers(0, 1, m_uniform_stream_buffer.GetD3DBufferArray());
+  }
 
   m_renderer_stats.num_uniform_buffer_updates++;
 }
@@ -731,6 +833,9 @@ void GPU_HW_D3D11::DrawUtilityShader(ID3D11PixelShader* shader, const void* unif
 bool GPU_HW_D3D11::BlitVRAMReplacementTexture(const TextureReplacementTexture* tex, u32 dst_x, u32 dst_y, u32 width,
                                               u32 height)
 {
+  if (tex->IsCompressed())
+    return BlitCompressedVRAMReplacementTexture(tex, dst_x, dst_y, width, height);
+
   if (m_vram_replacement_texture.GetWidth() < tex->GetWidth() ||
       m_vram_replacement_texture.GetHeight() < tex->GetHeight())
   {
@@ -775,30 +880,122 @@ bool GPU_HW_D3D11::BlitVRAMReplacementTexture(const TextureReplacementTexture* t
   return true;
 }
 
-void GPU_HW_D3D11::DrawBatchVertices(BatchRenderMode render_mode, u32 base_vertex, u32 num_vertices)
+bool GPU_HW_D3D11::BlitCompressedVRAMReplacementTexture(const TextureReplacementTexture* tex, u32 dst_x, u32 dst_y,
+                                                        u32 width, u32 height)
 {
-  const bool textured = (m_batch.texture_mode != GPUTextureMode::Disabled);
+  static constexpr std::array<DXGI_FORMAT, static_cast<size_t>(TextureReplacementTexture::Format::Count)>
+    dxgi_formats = {{DXGI_FORMAT_R8G8B8A8_UNORM, DXGI_FORMAT_BC1_UNORM, DXGI_FORMAT_BC3_UNORM, DXGI_FORMAT_BC7_UNORM}};
+
+  const DXGI_FORMAT format = dxgi_formats[static_cast<size_t>(tex->GetFormat())];
+  UINT support = 0;
+  constexpr UINT required_support = D3D11_FORMAT_SUPPORT_TEXTURE2D | D3D11_FORMAT_SUPPORT_SHADER_SAMPLE;
+  if (FAILED(m_device->CheckFormatSupport(format, &support)) || (support & required_support) != required_support)
+  {
+    Log_WarningPrintf("%s replacement textures are not supported by the device, using original data",
+                      TextureReplacementTexture::GetFormatName(tex->GetFormat()));
+    return false;
+  }
+
+  // Blocks are uploaded as-is, and the texture is only used for this blit, so it can be immutable.
+  const CD3D11_TEXTURE2D_DESC desc(format, tex->GetWidth(), tex->GetHeight(), 1, 1, D3D11_BIND_SHADER_RESOURCE,
+                                   D3D11_USAGE_IMMUTABLE, 0, 1, 0, 0);
+  const D3D11_SUBRESOURCE_DATA srd = {tex->GetPixels(), tex->GetPitch(), 0};
+  ComPtr<ID3D11Texture2D> texture;
+  const HRESULT hr = m_device->CreateTexture2D(&desc, &srd, texture.GetAddressOf());
+  if (FAILED(hr))
+  {
+    Log_ErrorPrintf("Create compressed replacement texture failed: 0x%08X", hr);
+    return false;
+  }
+
+  D3D11::Texture rtex;
+  if (!rtex.Adopt(m_device.Get(), std::move(texture)))
+    return false;
+
+  m_context->OMSetDepthStencilState(m_depth_disabled_state.Get(), 0);
+  m_context->PSSetShaderResources(0, 1, rtex.GetD3DSRVArray());
+  m_context->PSSetSamplers(0, 1, m_linear_sampler_state.GetAddressOf());
+  SetViewportAndScissor(dst_x, dst_y, width, height);
+
+  const float uniforms[] = {0.0f, 0.0f, 1.0f, 1.0f};
+  DrawUtilityShader(m_copy_pixel_shader.Get(), uniforms, sizeof(uniforms));
+  RestoreGraphicsAPIState();
+  return true;
+}
+
+void GPU_HW_D3D11::DrawBatchVertices(const BatchConfig& batch, BatchRenderMode render_mode, u32 base_vertex,
+                                     u32 num_vertices)
+{
+  const BatchConfig shader_config = GetBatchShaderConfig(batch);
+  const bool textured = (shader_config.texture_mode != GPUTextureMode::Disabled);
 
   m_context->VSSetShader(m_batch_vertex_shaders[BoolToUInt8(textured)].Get(), nullptr, 0);
 
-  m_context->PSSetShader(m_batch_pixel_shaders[static_cast<u8>(render_mode)][static_cast<u8>(m_batch.texture_mode)]
-                                              [BoolToUInt8(m_batch.dithering)][BoolToUInt8(m_batch.interlacing)]
-                                                .Get(),
-                         nullptr, 0);
+  m_context->PSSetShader(
+    m_batch_pixel_shaders[static_cast<u8>(render_mode)][static_cast<u8>(shader_config.texture_mode)]
+                         [BoolToUInt8(shader_config.dithering)][BoolToUInt8(shader_config.interlacing)]
+                           .Get(),
+    nullptr, 0);
 
   const GPUTransparencyMode transparency_mode =
-    (render_mode == BatchRenderMode::OnlyOpaque) ? GPUTransparencyMode::Disabled : m_batch.transparency_mode;
+    (render_mode == BatchRenderMode::OnlyOpaque) ? GPUTransparencyMode::Disabled : batch.transparency_mode;
   m_context->OMSetBlendState(m_batch_blend_states[static_cast<u8>(transparency_mode)].Get(), nullptr, 0xFFFFFFFFu);
 
   m_context->OMSetDepthStencilState(
-    (m_batch.use_depth_buffer ?
+    (batch.use_depth_buffer ?
        m_depth_test_less_state.Get() :
-       (m_batch.check_mask_before_draw ? m_depth_test_greater_state.Get() : m_depth_test_always_state.Get())),
+       (batch.check_mask_before_draw ? m_depth_test_greater_state.Get() : m_depth_test_always_state.Get())),
     0);
 
   m_context->Draw(num_vertices, base_vertex);
 }
 
+bool GPU_HW_D3D11::SupportsRenderThread() const
+{
+  return static_cast<bool>(m_deferred_context);
+}
+
+u32 GPU_HW_D3D11::UploadBatchVertices(const BatchVertex* vertices, u32 num_vertices)
+{
+  const u32 size = num_vertices * sizeof(BatchVertex);
+  const D3D11::StreamBuffer::MappingResult res = m_vertex_stream_buffer.Map(m_context.Get(), sizeof(BatchVertex), size);
+  std::memcpy(res.pointer, vertices, size);
+  m_vertex_stream_buffer.Unmap(m_context.Get(), size);
+  return res.index_aligned;
+}
+
+void GPU_HW_D3D11::OnRenderThreadRecordingStarted()
+{
+  // The render thread records into the deferred context, which starts out with nothing bound.
+  SetCurrentContext(m_deferred_context.Get());
+  RestoreGraphicsAPIState();
+}
+
+void GPU_HW_D3D11::OnRenderThreadRecordingFinished()
+{
+  ComPtr<ID3D11CommandList> command_list;
+  const HRESULT hr = m_deferred_context->FinishCommandList(FALSE, command_list.GetAddressOf());
+  SetCurrentContext(m_immediate_context.Get());
+  if (SUCCEEDED(hr))
+    m_context->ExecuteCommandList(command_list.Get(), FALSE);
+  else
+    Log_ErrorPrintf("FinishCommandList() failed: 0x%08X", hr);
+
+  // Executing the command list leaves the immediate context with nothing bound.
+  RestoreGraphicsAPIState();
+}
+
+void GPU_HW_D3D11::SetCurrentContext(ID3D11DeviceContext* context)
+{
+  m_context = context;
+  if (m_context1)
+    m_context.As(&m_context1);
+
+  // Both contexts have to discard the stream buffers before they can append to them.
+  m_vertex_stream_buffer.Invalidate();
+  m_uniform_stream_buffer.Invalidate();
+}
+
 void GPU_HW_D3D11::SetScissorFromDrawingArea()
 {
   int left, top, right, bottom;
@@ -810,6 +1007,8 @@ void GPU_HW_D3D11::SetScissorFromDrawingArea()
 
 void GPU_HW_D3D11::ClearDisplay()
 {
+  SyncRenderThread();
+  g_host_display->SetGPUTimingScope(GPUTimingScope::Display);
   GPU_HW::ClearDisplay();
 
   g_host_display->ClearDisplayTexture();
@@ -820,6 +1019,8 @@ void GPU_HW_D3D11::ClearDisplay()
 
 void GPU_HW_D3D11::UpdateDisplay()
 {
+  SyncRenderThread();
+  g_host_display->SetGPUTimingScope(GPUTimingScope::Display);
   GPU_HW::UpdateDisplay();
 
   if (g_settings.debugging.show_vram)
@@ -915,6 +1116,9 @@ void GPU_HW_D3D11::ReadVRAM(u32 x, u32 y, u32 width, u32 height)
     return;
   }
 
+  SyncRenderThread();
+  g_host_display->SetGPUTimingScope(GPUTimingScope::VRAMReadbacks);
+
   // Get bounds with wrap-around handled.
   const Common::Rectangle<u32> copy_rect = GetVRAMTransferBounds(x, y, width, height);
   const u32 encoded_width = (copy_rect.GetWidth() + 1) / 2;
@@ -939,6 +1143,8 @@ void GPU_HW_D3D11::ReadVRAM(u32 x, u32 y, u32 width, u32 height)
 
 void GPU_HW_D3D11::FillVRAM(u32 x, u32 y, u32 width, u32 height, u32 color)
 {
+  SyncRenderThread();
+  g_host_display->SetGPUTimingScope(GPUTimingScope::VRAMTransfers);
   if (IsUsingSoftwareRendererForReadbacks())
     FillSoftwareRendererVRAM(x, y, width, height, color);
 
@@ -961,6 +1167,8 @@ void GPU_HW_D3D11::FillVRAM(u32 x, u32 y, u32 width, u32 height, u32 color)
 
 void GPU_HW_D3D11::UpdateVRAM(u32 x, u32 y, u32 width, u32 height, const void* data, bool set_mask, bool check_mask)
 {
+  SyncRenderThread();
+  g_host_display->SetGPUTimingScope(GPUTimingScope::VRAMTransfers);
   if (IsUsingSoftwareRendererForReadbacks())
     UpdateSoftwareRendererVRAM(x, y, width, height, data, set_mask, check_mask);
 
@@ -993,12 +1201,15 @@ void GPU_HW_D3D11::UpdateVRAM(u32 x, u32 y, u32 width, u32 height, const void* d
   SetScissor(scaled_bounds.left, scaled_bounds.top, scaled_bounds.GetWidth(), scaled_bounds.GetHeight());
 
   DrawUtilityShader(m_vram_write_pixel_shader.Get(), &uniforms, sizeof(uniforms));
+  m_renderer_stats.num_vram_write_uploads++;
 
   RestoreGraphicsAPIState();
 }
 
 void GPU_HW_D3D11::CopyVRAM(u32 src_x, u32 src_y, u32 dst_x, u32 dst_y, u32 width, u32 height)
 {
+  SyncRenderThread();
+  g_host_display->SetGPUTimingScope(GPUTimingScope::VRAMTransfers);
   if (IsUsingSoftwareRendererForReadbacks())
     CopySoftwareRendererVRAM(src_x, src_y, dst_x, dst_y, width, height);
 
@@ -1006,8 +1217,7 @@ void GPU_HW_D3D11::CopyVRAM(u32 src_x, u32 src_y, u32 dst_x, u32 dst_y, u32 widt
   {
     const Common::Rectangle<u32> src_bounds = GetVRAMTransferBounds(src_x, src_y, width, height);
     const Common::Rectangle<u32> dst_bounds = GetVRAMTransferBounds(dst_x, dst_y, width, height);
-    if (m_vram_dirty_rect.Intersects(src_bounds))
-      UpdateVRAMReadTexture();
+    UpdateVRAMReadTexturePages(GetDirtyVRAMPages(src_bounds));
     IncludeVRAMDirtyRectangle(dst_bounds);
 
     const VRAMCopyUBOData uniforms = GetVRAMCopyUBOData(src_x, src_y, dst_x, dst_y, width, height);
@@ -1032,8 +1242,8 @@ void GPU_HW_D3D11::CopyVRAM(u32 src_x, u32 src_y, u32 dst_x, u32 dst_y, u32 widt
   // We can't CopySubresourceRegion to the same resource. So use the shadow texture if we can, but that may need to be
   // updated first. Copying to the same resource seemed to work on Windows 10, but breaks on Windows 7. But, it's
   // against the API spec, so better to be safe than sorry.
-  if (m_vram_dirty_rect.Intersects(Common::Rectangle<u32>::FromExtents(src_x, src_y, width, height)))
-    UpdateVRAMReadTexture();
+  UpdateVRAMReadTexturePages(
+    GetDirtyVRAMPages(Common::Rectangle<u32>::FromExtents(src_x, src_y, width, height)));
 
   GPU_HW::CopyVRAM(src_x, src_y, dst_x, dst_y, width, height);
 
@@ -1048,9 +1258,9 @@ void GPU_HW_D3D11::CopyVRAM(u32 src_x, u32 src_y, u32 dst_x, u32 dst_y, u32 widt
   m_context->CopySubresourceRegion(m_vram_texture, 0, dst_x, dst_y, 0, m_vram_read_texture, 0, &src_box);
 }
 
-void GPU_HW_D3D11::UpdateVRAMReadTexture()
+void GPU_HW_D3D11::CopyVRAMToReadTexture(const Common::Rectangle<u32>& rect)
 {
-  const auto scaled_rect = m_vram_dirty_rect * m_resolution_scale;
+  const auto scaled_rect = rect * m_resolution_scale;
   const CD3D11_BOX src_box(scaled_rect.left, scaled_rect.top, 0, scaled_rect.right, scaled_rect.bottom, 1);
 
   if (m_vram_texture.IsMultisampled())
@@ -1063,16 +1273,16 @@ void GPU_HW_D3D11::UpdateVRAMReadTexture()
     m_context->CopySubresourceRegion(m_vram_read_texture, 0, scaled_rect.left, scaled_rect.top, 0, m_vram_texture, 0,
                                      &src_box);
   }
-
-  GPU_HW::UpdateVRAMReadTexture();
 }
 
-void GPU_HW_D3D11::UpdateDepthBufferFromMaskBit()
+void GPU_HW_D3D11::UpdateDepthBufferFromMaskBit(const Common::Rectangle<u32>& rect)
 {
   if (m_pgxp_depth_buffer)
     return;
 
-  SetViewportAndScissor(0, 0, m_vram_texture.GetWidth(), m_vram_texture.GetHeight());
+  const Common::Rectangle<u32> scaled_rect = rect * m_resolution_scale;
+  SetViewport(0, 0, m_vram_texture.GetWidth(), m_vram_texture.GetHeight());
+  SetScissor(scaled_rect.left, scaled_rect.top, scaled_rect.GetWidth(), scaled_rect.GetHeight());
 
   m_context->OMSetRenderTargets(0, nullptr, m_vram_depth_view.Get());
   m_context->OMSetDepthStencilState(m_depth_test_always_state.Get(), 0);
@@ -1081,21 +1291,24 @@ void GPU_HW_D3D11::UpdateDepthBufferFromMaskBit()
   m_context->PSSetShaderResources(0, 1, m_vram_texture.GetD3DSRVArray());
   DrawUtilityShader(m_vram_update_depth_pixel_shader.Get(), nullptr, 0);
 
-  m_context->PSSetShaderResources(0, 1, m_vram_read_texture.GetD3DSRVArray());
-  RestoreGraphicsAPIState();
+  // Can run on the render thread, so leave the batch UBO flag alone. The constant buffer binding isn't touched.
+  SetBatchState();
 }
 
-void GPU_HW_D3D11::ClearDepthBuffer()
+void GPU_HW_D3D11::ClearDepthBuffer(const Common::Rectangle<u32>& rect)
 {
   DebugAssert(m_pgxp_depth_buffer);
 
+  // D3D11 can't clear part of a depth view. Pages outside the rectangle are already clear, so this is still correct.
   m_context->ClearDepthStencilView(m_vram_depth_view.Get(), D3D11_CLEAR_DEPTH, 1.0f, 0);
-  m_last_depth_z = 1.0f;
 }
 
 void GPU_HW_D3D11::DownsampleFramebuffer(D3D11::Texture& source, u32 left, u32 top, u32 width, u32 height)
 {
-  if (m_downsample_mode == GPUDownsampleMode::Adaptive)
+  g_host_display->SetGPUTimingScope(GPUTimingScope::Downsample);
+  if (m_use_compute_downsampling)
+    DownsampleFramebufferAdaptiveCompute(source, left, top, width, height);
+  else if (m_downsample_mode == GPUDownsampleMode::Adaptive)
     DownsampleFramebufferAdaptive(source, left, top, width, height);
   else
     DownsampleFramebufferBoxFilter(source, left, top, width, height);
@@ -1170,6 +1383,45 @@ void GPU_HW_D3D11::DownsampleFramebufferAdaptive(D3D11::Texture& source, u32 lef
   g_host_display->SetDisplayTexture(&m_display_texture, left, top, width, height);
 }
 
+void GPU_HW_D3D11::DownsampleFramebufferAdaptiveCompute(D3D11::Texture& source, u32 left, u32 top, u32 width,
+                                                        u32 height)
+{
+  // The output goes to the display texture, so if that's also the source, it has to be copied out first.
+  ID3D11ShaderResourceView* srv = source.GetD3DSRV();
+  if (&source == &m_display_texture)
+  {
+    const CD3D11_BOX src_box(left, top, 0, left + width, top + height, 1);
+    m_context->CopySubresourceRegion(m_downsample_texture, 0, left, top, 0, source, 0, &src_box);
+    srv = m_downsample_texture.GetD3DSRV();
+  }
+
+  // Neither texture can stay bound as a render target while the compute shader accesses it.
+  m_context->OMSetRenderTargets(0, nullptr, nullptr);
+
+  const u32 uniforms[4] = {left, top, left + width, top + height};
+  UploadUniformBuffer(uniforms, sizeof(uniforms));
+  m_context->CSSetConstantBuffers(0, 1, m_uniform_stream_buffer.GetD3DBufferArray());
+  m_context->CSSetShaderResources(0, 1, &srv);
+  m_context->CSSetUnorderedAccessViews(1, 1, m_display_uav.GetAddressOf(), nullptr);
+  m_context->CSSetShader(m_downsample_compute_shader.Get(), nullptr, 0);
+
+  // One thread per native resolution pixel, in 8x8 groups.
+  const u32 native_width = width / m_resolution_scale;
+  const u32 native_height = height / m_resolution_scale;
+  m_context->Dispatch((native_width + 7) / 8, (native_height + 7) / 8, 1);
+
+  ID3D11ShaderResourceView* const null_srv = nullptr;
+  ID3D11UnorderedAccessView* const null_uav = nullptr;
+  m_context->CSSetShaderResources(0, 1, &null_srv);
+  m_context->CSSetUnorderedAccessViews(1, 1, &null_uav, nullptr);
+  m_context->CSSetShader(nullptr, nullptr, 0);
+  m_batch_ubo_dirty = true;
+
+  RestoreGraphicsAPIState();
+
+  g_host_display->SetDisplayTexture(&m_display_texture, left, top, width, height);
+}
+
 void GPU_HW_D3D11::DownsampleFramebufferBoxFilter(D3D11::Texture& source, u32 left, u32 top, u32 width, u32 height)
 {
   const u32 ds_left = left / m_resolution_scale;
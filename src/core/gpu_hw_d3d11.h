@@ -8,7 +8,7 @@
 #include "gpu_hw.h"
 #include "texture_replacements.h"
 #include <array>
-#include <d3d11.h>
+#include <d3d11_1.h>
 #include <memory>
 #include <tuple>
 #include <wrl/client.h>
@@ -39,20 +39,27 @@ protected:
   void FillVRAM(u32 x, u32 y, u32 width, u32 height, u32 color) override;
   void UpdateVRAM(u32 x, u32 y, u32 width, u32 height, const void* data, bool set_mask, bool check_mask) override;
   void CopyVRAM(u32 src_x, u32 src_y, u32 dst_x, u32 dst_y, u32 width, u32 height) override;
-  void UpdateVRAMReadTexture() override;
-  void UpdateDepthBufferFromMaskBit() override;
-  void ClearDepthBuffer() override;
+  void CopyVRAMToReadTexture(const Common::Rectangle<u32>& rect) override;
+  void UpdateDepthBufferFromMaskBit(const Common::Rectangle<u32>& rect) override;
+  void ClearDepthBuffer(const Common::Rectangle<u32>& rect) override;
   void SetScissorFromDrawingArea() override;
   void MapBatchVertexPointer(u32 required_vertices) override;
   void UnmapBatchVertexPointer(u32 used_vertices) override;
   void UploadUniformBuffer(const void* data, u32 data_size) override;
-  void DrawBatchVertices(BatchRenderMode render_mode, u32 base_vertex, u32 num_vertices) override;
+  void DrawBatchVertices(const BatchConfig& batch, BatchRenderMode render_mode, u32 base_vertex,
+                         u32 num_vertices) override;
+  bool SupportsRenderThread() const override;
+  u32 UploadBatchVertices(const BatchVertex* vertices, u32 num_vertices) override;
+  void OnRenderThreadRecordingStarted() override;
+  void OnRenderThreadRecordingFinished() override;
 
 private:
   enum : u32
   {
-    // Currently we don't stream uniforms, instead just re-map the buffer every time and let the driver take care of it.
-    MAX_UNIFORM_BUFFER_SIZE = 64
+    // Without constant buffer offsets, we re-map the buffer every time and let the driver take care of it.
+    MAX_UNIFORM_BUFFER_SIZE = 64,
+    UNIFORM_STREAM_BUFFER_SIZE = D3D11_REQ_CONSTANT_BUFFER_ELEMENT_COUNT * 16,
+    UNIFORM_BUFFER_ALIGNMENT = 256
   };
 
   void SetCapabilities();
@@ -72,16 +79,30 @@ private:
   void SetScissor(u32 x, u32 y, u32 width, u32 height);
   void SetViewportAndScissor(u32 x, u32 y, u32 width, u32 height);
 
+  /// Binds the state shared by all batches. Unlike RestoreGraphicsAPIState(), safe to call from the render thread.
+  void SetBatchState();
+
+  /// Switches between the immediate context and the render thread's deferred context.
+  void SetCurrentContext(ID3D11DeviceContext* context);
+
   void DrawUtilityShader(ID3D11PixelShader* shader, const void* uniforms, u32 uniforms_size);
 
   bool BlitVRAMReplacementTexture(const TextureReplacementTexture* tex, u32 dst_x, u32 dst_y, u32 width, u32 height);
+  bool BlitCompressedVRAMReplacementTexture(const TextureReplacementTexture* tex, u32 dst_x, u32 dst_y, u32 width,
+                                            u32 height);
 
   void DownsampleFramebuffer(D3D11::Texture& source, u32 left, u32 top, u32 width, u32 height);
   void DownsampleFramebufferAdaptive(D3D11::Texture& source, u32 left, u32 top, u32 width, u32 height);
+  void DownsampleFramebufferAdaptiveCompute(D3D11::Texture& source, u32 left, u32 top, u32 width, u32 height);
   void DownsampleFramebufferBoxFilter(D3D11::Texture& source, u32 left, u32 top, u32 width, u32 height);
 
   ComPtr<ID3D11Device> m_device;
+
+  // The deferred context replaces the immediate context while the render thread is recording.
   ComPtr<ID3D11DeviceContext> m_context;
+  ComPtr<ID3D11DeviceContext1> m_context1; // only set when constant buffer offsets are supported
+  ComPtr<ID3D11DeviceContext> m_immediate_context;
+  ComPtr<ID3D11DeviceContext> m_deferred_context;
 
   // downsample texture - used for readbacks at >1xIR.
   D3D11::Texture m_vram_texture;
@@ -140,4 +161,6 @@ private:
   D3D11::Texture m_downsample_texture;
   D3D11::Texture m_downsample_weight_texture;
   std::vector<std::pair<ComPtr<ID3D11ShaderResourceView>, ComPtr<ID3D11RenderTargetView>>> m_downsample_mip_views;
+  ComPtr<ID3D11ComputeShader> m_downsample_compute_shader;
+  ComPtr<ID3D11UnorderedAccessView> m_display_uav;
 };
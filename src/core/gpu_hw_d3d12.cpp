@@ -21,6 +21,8 @@ GPU_HW_D3D12::GPU_HW_D3D12() = default;
 
 GPU_HW_D3D12::~GPU_HW_D3D12()
 {
+  SyncRenderThread();
+
   g_host_display->ClearDisplayTexture();
 
   DestroyResources();
@@ -56,12 +58,6 @@ bool GPU_HW_D3D12::Initialize()
     return false;
   }
 
-  if (!CreateUniformBuffer())
-  {
-    Log_ErrorPrintf("Failed to create uniform buffer");
-    return false;
-  }
-
   if (!CreateTextureBuffer())
   {
     Log_ErrorPrintf("Failed to create texture buffer");
@@ -81,7 +77,7 @@ bool GPU_HW_D3D12::Initialize()
   }
 
   RestoreGraphicsAPIState();
-  UpdateDepthBufferFromMaskBit();
+  UpdateDepthBufferPagesFromMaskBit();
   return true;
 }
 
@@ -95,6 +91,8 @@ void GPU_HW_D3D12::Reset(bool clear_vram)
 
 void GPU_HW_D3D12::ResetGraphicsAPIState()
 {
+  SyncRenderThread(true);
+
   GPU_HW::ResetGraphicsAPIState();
 }
 
@@ -111,8 +109,7 @@ void GPU_HW_D3D12::RestoreGraphicsAPIState()
   cmdlist->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
 
   cmdlist->SetGraphicsRootSignature(m_batch_root_signature.Get());
-  cmdlist->SetGraphicsRootConstantBufferView(0,
-                                             m_uniform_stream_buffer.GetGPUPointer() + m_current_uniform_buffer_offset);
+  cmdlist->SetGraphicsRoot32BitConstants(0, sizeof(m_batch_root_constants) / sizeof(u32), &m_batch_root_constants, 0);
   cmdlist->SetGraphicsRootDescriptorTable(1, m_vram_read_texture.GetSRVDescriptor().gpu_handle);
   cmdlist->SetGraphicsRootDescriptorTable(2, m_point_sampler.gpu_handle);
 
@@ -123,6 +120,8 @@ void GPU_HW_D3D12::RestoreGraphicsAPIState()
 
 void GPU_HW_D3D12::UpdateSettings()
 {
+  SyncRenderThread();
+
   GPU_HW::UpdateSettings();
 
   bool framebuffer_changed, shaders_changed;
@@ -154,7 +153,7 @@ void GPU_HW_D3D12::UpdateSettings()
   {
     RestoreGraphicsAPIState();
     UpdateVRAM(0, 0, VRAM_WIDTH, VRAM_HEIGHT, m_vram_ptr, false, false);
-    UpdateDepthBufferFromMaskBit();
+    UpdateDepthBufferPagesFromMaskBit();
     UpdateDisplay();
     ResetGraphicsAPIState();
   }
@@ -193,21 +192,12 @@ void GPU_HW_D3D12::UnmapBatchVertexPointer(u32 used_vertices)
 
 void GPU_HW_D3D12::UploadUniformBuffer(const void* data, u32 data_size)
 {
-  if (!m_uniform_stream_buffer.ReserveMemory(data_size, D3D12_CONSTANT_BUFFER_DATA_PLACEMENT_ALIGNMENT))
-  {
-    Log_PerfPrintf("Executing command buffer while waiting for %u bytes in uniform stream buffer", data_size);
-    g_d3d12_context->ExecuteCommandList(false);
-    RestoreGraphicsAPIState();
-    if (!m_uniform_stream_buffer.ReserveMemory(data_size, D3D12_CONSTANT_BUFFER_DATA_PLACEMENT_ALIGNMENT))
-      Panic("Failed to reserve uniform stream buffer memory");
-  }
-
-  m_current_uniform_buffer_offset = m_uniform_stream_buffer.GetCurrentOffset();
-  std::memcpy(m_uniform_stream_buffer.GetCurrentHostPointer(), data, data_size);
-  m_uniform_stream_buffer.CommitMemory(data_size);
-
-  g_d3d12_context->GetCommandList()->SetGraphicsRootConstantBufferView(0, m_uniform_stream_buffer.GetGPUPointer() +
-                                                                            m_current_uniform_buffer_offset);
+  // Batch uniforms are small enough to live in the root signature, so there's nothing to allocate. The copy is kept
+  // to restore them after utility draws, which use a different root signature.
+  DebugAssert(data_size == sizeof(m_batch_root_constants));
+  std::memcpy(&m_batch_root_constants, data, sizeof(m_batch_root_constants));
+  g_d3d12_context->GetCommandList()->SetGraphicsRoot32BitConstants(0, sizeof(m_batch_root_constants) / sizeof(u32),
+                                                                    &m_batch_root_constants, 0);
 }
 
 void GPU_HW_D3D12::SetCapabilities()
@@ -253,7 +243,6 @@ void GPU_HW_D3D12::DestroyResources()
   g_d3d12_context->GetDescriptorHeapManager().Free(&m_texture_stream_buffer_srv);
 
   m_vertex_stream_buffer.Destroy(false);
-  m_uniform_stream_buffer.Destroy(false);
   m_texture_stream_buffer.Destroy(false);
 
   m_single_sampler_root_signature.Reset();
@@ -264,7 +253,7 @@ bool GPU_HW_D3D12::CreateRootSignatures()
 {
   D3D12::RootSignatureBuilder rsbuilder;
   rsbuilder.SetInputAssemblerFlag();
-  rsbuilder.AddCBVParameter(0, D3D12_SHADER_VISIBILITY_ALL);
+  rsbuilder.Add32BitConstants(0, sizeof(BatchUBOData) / sizeof(u32), D3D12_SHADER_VISIBILITY_ALL);
   rsbuilder.AddDescriptorTable(D3D12_DESCRIPTOR_RANGE_TYPE_SRV, 0, 1, D3D12_SHADER_VISIBILITY_PIXEL);
   rsbuilder.AddDescriptorTable(D3D12_DESCRIPTOR_RANGE_TYPE_SAMPLER, 0, 1, D3D12_SHADER_VISIBILITY_PIXEL);
   m_batch_root_signature = rsbuilder.Create();
@@ -374,15 +363,6 @@ bool GPU_HW_D3D12::CreateVertexBuffer()
   return true;
 }
 
-bool GPU_HW_D3D12::CreateUniformBuffer()
-{
-  if (!m_uniform_stream_buffer.Create(UNIFORM_BUFFER_SIZE))
-    return false;
-
-  D3D12::SetObjectName(m_vertex_stream_buffer.GetBuffer(), "Uniform Stream Buffer");
-  return true;
-}
-
 bool GPU_HW_D3D12::CreateTextureBuffer()
 {
   if (!m_texture_stream_buffer.Create(VRAM_UPDATE_TEXTURE_BUFFER_SIZE))
@@ -409,8 +389,9 @@ bool GPU_HW_D3D12::CompilePipelines()
   shader_cache.Open(EmuFolders::Cache, g_d3d12_context->GetFeatureLevel(), g_settings.gpu_use_debug_device);
 
   GPU_HW_ShaderGen shadergen(g_host_display->GetRenderAPI(), m_resolution_scale, m_multisamples, m_per_sample_shading,
-                             m_true_color, m_scaled_dithering, m_texture_filtering, m_using_uv_limits,
-                             m_pgxp_depth_buffer, m_disable_color_perspective, m_supports_dual_source_blend);
+                             m_true_color, m_scaled_dithering, m_texture_filtering, m_adaptive_texture_filtering,
+                             m_using_uv_limits, m_pgxp_depth_buffer, m_disable_color_perspective,
+                             m_supports_dual_source_blend, m_use_palette_texture_cache);
 
   ShaderCompileProgressTracker progress("Compiling Pipelines", 2 + (4 * 9 * 2 * 2) + (2 * 4 * 5 * 9 * 2 * 2) + 1 +
                                                                  (2 * 2) + 2 + 2 + 1 + 1 + (2 * 3) + 1);
@@ -438,9 +419,21 @@ bool GPU_HW_D3D12::CompilePipelines()
       {
         for (u8 interlacing = 0; interlacing < 2; interlacing++)
         {
-          const std::string fs = shadergen.GenerateBatchFragmentShader(
-            static_cast<BatchRenderMode>(render_mode), static_cast<GPUTextureMode>(texture_mode),
-            ConvertToBoolUnchecked(dithering), ConvertToBoolUnchecked(interlacing));
+          if (!IsBatchShaderVariantUsed(m_use_uber_shaders, static_cast<GPUTextureMode>(texture_mode),
+                                        ConvertToBoolUnchecked(dithering), ConvertToBoolUnchecked(interlacing)))
+          {
+            progress.Increment();
+            continue;
+          }
+
+          const std::string fs =
+            m_use_uber_shaders ?
+              shadergen.GenerateBatchUberFragmentShader(
+                static_cast<BatchRenderMode>(render_mode),
+                static_cast<GPUTextureMode>(texture_mode) != GPUTextureMode::Disabled) :
+              shadergen.GenerateBatchFragmentShader(
+                static_cast<BatchRenderMode>(render_mode), static_cast<GPUTextureMode>(texture_mode),
+                ConvertToBoolUnchecked(dithering), ConvertToBoolUnchecked(interlacing));
 
           batch_fragment_shaders[render_mode][texture_mode][dithering][interlacing] = shader_cache.GetPixelShader(fs);
           if (!batch_fragment_shaders[render_mode][texture_mode][dithering][interlacing])
@@ -467,6 +460,13 @@ bool GPU_HW_D3D12::CompilePipelines()
           {
             for (u8 interlacing = 0; interlacing < 2; interlacing++)
             {
+              if (!IsBatchShaderVariantUsed(m_use_uber_shaders, static_cast<GPUTextureMode>(texture_mode),
+                                            ConvertToBoolUnchecked(dithering), ConvertToBoolUnchecked(interlacing)))
+              {
+                progress.Increment();
+                continue;
+              }
+
               const bool textured = (static_cast<GPUTextureMode>(texture_mode) != GPUTextureMode::Disabled);
 
               gpbuilder.SetRootSignature(m_batch_root_signature.Get());
@@ -766,6 +766,9 @@ bool GPU_HW_D3D12::BlitVRAMReplacementTexture(const TextureReplacementTexture* t
   if (!CreateTextureReplacementStreamBuffer())
     return false;
 
+  if (tex->IsCompressed())
+    return BlitCompressedVRAMReplacementTexture(tex, dst_x, dst_y, width, height);
+
   if (m_vram_write_replacement_texture.GetWidth() < tex->GetWidth() ||
       m_vram_write_replacement_texture.GetHeight() < tex->GetHeight())
   {
@@ -817,21 +820,121 @@ bool GPU_HW_D3D12::BlitVRAMReplacementTexture(const TextureReplacementTexture* t
   return true;
 }
 
-void GPU_HW_D3D12::DrawBatchVertices(BatchRenderMode render_mode, u32 base_vertex, u32 num_vertices)
+bool GPU_HW_D3D12::BlitCompressedVRAMReplacementTexture(const TextureReplacementTexture* tex, u32 dst_x, u32 dst_y,
+                                                        u32 width, u32 height)
+{
+  static constexpr std::array<DXGI_FORMAT, static_cast<size_t>(TextureReplacementTexture::Format::Count)>
+    dxgi_formats = {{DXGI_FORMAT_R8G8B8A8_UNORM, DXGI_FORMAT_BC1_UNORM, DXGI_FORMAT_BC3_UNORM, DXGI_FORMAT_BC7_UNORM}};
+
+  // Block copies must cover the whole image when it isn't block-aligned, so keep the texture at the exact size.
+  const TextureReplacementTexture::Format format = tex->GetFormat();
+  const DXGI_FORMAT dxgi_format = dxgi_formats[static_cast<size_t>(format)];
+  if (format != m_vram_write_replacement_compressed_format ||
+      m_vram_write_replacement_compressed_texture.GetWidth() != tex->GetWidth() ||
+      m_vram_write_replacement_compressed_texture.GetHeight() != tex->GetHeight())
+  {
+    m_vram_write_replacement_compressed_format = TextureReplacementTexture::Format::Count;
+    m_vram_write_replacement_compressed_texture.Destroy(true);
+    if (!m_vram_write_replacement_compressed_texture.Create(tex->GetWidth(), tex->GetHeight(), 1, 1, 1, dxgi_format,
+                                                            dxgi_format, DXGI_FORMAT_UNKNOWN, DXGI_FORMAT_UNKNOWN,
+                                                            D3D12_RESOURCE_FLAG_NONE))
+    {
+      Log_ErrorPrint("Failed to create compressed VRAM write replacement texture");
+      return false;
+    }
+
+    m_vram_write_replacement_compressed_format = format;
+  }
+
+  const u32 copy_pitch = Common::AlignUpPow2<u32>(tex->GetPitch(), D3D12_TEXTURE_DATA_PITCH_ALIGNMENT);
+  const u32 required_size = copy_pitch * tex->GetRows();
+  if (!m_texture_replacment_stream_buffer.ReserveMemory(required_size, D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT))
+  {
+    Log_PerfPrint("Executing command buffer while waiting for texture replacement buffer space");
+    g_d3d12_context->ExecuteCommandList(false);
+    RestoreGraphicsAPIState();
+    if (!m_texture_replacment_stream_buffer.ReserveMemory(required_size, D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT))
+    {
+      Log_ErrorPrintf("Failed to allocate %u bytes from texture replacement streaming buffer", required_size);
+      return false;
+    }
+  }
+
+  // buffer -> texture, the footprint is in texels but the rows are block rows
+  const u32 sb_offset = m_texture_replacment_stream_buffer.GetCurrentOffset();
+  D3D12::Texture::CopyToUploadBuffer(tex->GetPixels(), tex->GetPitch(), tex->GetRows(),
+                                     m_texture_replacment_stream_buffer.GetCurrentHostPointer(), copy_pitch);
+  m_texture_replacment_stream_buffer.CommitMemory(required_size);
+
+  D3D12_TEXTURE_COPY_LOCATION src;
+  src.pResource = m_texture_replacment_stream_buffer.GetBuffer();
+  src.Type = D3D12_TEXTURE_COPY_TYPE_PLACED_FOOTPRINT;
+  src.PlacedFootprint.Offset = sb_offset;
+  src.PlacedFootprint.Footprint = {dxgi_format, tex->GetWidth(), tex->GetHeight(), 1, copy_pitch};
+
+  D3D12_TEXTURE_COPY_LOCATION dst;
+  dst.pResource = m_vram_write_replacement_compressed_texture.GetResource();
+  dst.Type = D3D12_TEXTURE_COPY_TYPE_SUBRESOURCE_INDEX;
+  dst.SubresourceIndex = 0;
+
+  ID3D12GraphicsCommandList* cmdlist = g_d3d12_context->GetCommandList();
+  m_vram_write_replacement_compressed_texture.TransitionToState(D3D12_RESOURCE_STATE_COPY_DEST);
+  cmdlist->CopyTextureRegion(&dst, 0, 0, 0, &src, nullptr);
+  m_vram_write_replacement_compressed_texture.TransitionToState(D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
+
+  // texture -> vram
+  const float uniforms[] = {0.0f, 0.0f, 1.0f, 1.0f};
+  cmdlist->SetGraphicsRootSignature(m_single_sampler_root_signature.Get());
+  cmdlist->SetGraphicsRoot32BitConstants(0, sizeof(uniforms) / sizeof(u32), uniforms, 0);
+  cmdlist->SetGraphicsRootDescriptorTable(1, m_vram_write_replacement_compressed_texture.GetSRVDescriptor());
+  cmdlist->SetGraphicsRootDescriptorTable(2, m_linear_sampler.gpu_handle);
+  cmdlist->SetPipelineState(m_copy_pipeline.Get());
+  D3D12::SetViewportAndScissor(cmdlist, dst_x, dst_y, width, height);
+  cmdlist->DrawInstanced(3, 1, 0, 0);
+  RestoreGraphicsAPIState();
+  return true;
+}
+
+void GPU_HW_D3D12::DrawBatchVertices(const BatchConfig& batch, BatchRenderMode render_mode, u32 base_vertex,
+                                     u32 num_vertices)
 {
   ID3D12GraphicsCommandList* cmdlist = g_d3d12_context->GetCommandList();
 
   // [primitive][depth_test][render_mode][texture_mode][transparency_mode][dithering][interlacing]
+  const BatchConfig shader_config = GetBatchShaderConfig(batch);
   ID3D12PipelineState* pipeline =
-    m_batch_pipelines[BoolToUInt8(m_batch.check_mask_before_draw || m_batch.use_depth_buffer)][static_cast<u8>(
-      render_mode)][static_cast<u8>(m_batch.texture_mode)][static_cast<u8>(m_batch.transparency_mode)]
-                     [BoolToUInt8(m_batch.dithering)][BoolToUInt8(m_batch.interlacing)]
+    m_batch_pipelines[BoolToUInt8(batch.check_mask_before_draw || batch.use_depth_buffer)][static_cast<u8>(
+      render_mode)][static_cast<u8>(shader_config.texture_mode)][static_cast<u8>(batch.transparency_mode)]
+                     [BoolToUInt8(shader_config.dithering)][BoolToUInt8(shader_config.interlacing)]
                        .Get();
 
   cmdlist->SetPipelineState(pipeline);
   cmdlist->DrawInstanced(num_vertices, 1, base_vertex, 0);
 }
 
+bool GPU_HW_D3D12::SupportsRenderThread() const
+{
+  return true;
+}
+
+u32 GPU_HW_D3D12::UploadBatchVertices(const BatchVertex* vertices, u32 num_vertices)
+{
+  const u32 size = num_vertices * sizeof(BatchVertex);
+  if (!m_vertex_stream_buffer.ReserveMemory(size, sizeof(BatchVertex)))
+  {
+    Log_PerfPrintf("Executing command buffer while waiting for %u bytes in vertex stream buffer", size);
+    g_d3d12_context->ExecuteCommandList(false);
+    RestoreGraphicsAPIState();
+    if (!m_vertex_stream_buffer.ReserveMemory(size, sizeof(BatchVertex)))
+      Panic("Failed to reserve vertex stream buffer memory");
+  }
+
+  const u32 base_vertex = m_vertex_stream_buffer.GetCurrentOffset() / sizeof(BatchVertex);
+  std::memcpy(m_vertex_stream_buffer.GetCurrentHostPointer(), vertices, size);
+  m_vertex_stream_buffer.CommitMemory(size);
+  return base_vertex;
+}
+
 void GPU_HW_D3D12::SetScissorFromDrawingArea()
 {
   int left, top, right, bottom;
@@ -842,6 +945,9 @@ void GPU_HW_D3D12::SetScissorFromDrawingArea()
 
 void GPU_HW_D3D12::ClearDisplay()
 {
+  SyncRenderThread();
+  g_host_display->SetGPUTimingScope(GPUTimingScope::Display);
+
   GPU_HW::ClearDisplay();
 
   g_host_display->ClearDisplayTexture();
@@ -854,6 +960,9 @@ void GPU_HW_D3D12::ClearDisplay()
 
 void GPU_HW_D3D12::UpdateDisplay()
 {
+  SyncRenderThread();
+  g_host_display->SetGPUTimingScope(GPUTimingScope::Display);
+
   GPU_HW::UpdateDisplay();
 
   if (g_settings.debugging.show_vram)
@@ -941,6 +1050,10 @@ void GPU_HW_D3D12::ReadVRAM(u32 x, u32 y, u32 width, u32 height)
     return;
   }
 
+  SyncRenderThread();
+
+  g_host_display->SetGPUTimingScope(GPUTimingScope::VRAMReadbacks);
+
   // Get bounds with wrap-around handled.
   const Common::Rectangle<u32> copy_rect = GetVRAMTransferBounds(x, y, width, height);
   const u32 encoded_width = (copy_rect.GetWidth() + 1) / 2;
@@ -977,6 +1090,9 @@ void GPU_HW_D3D12::ReadVRAM(u32 x, u32 y, u32 width, u32 height)
 
 void GPU_HW_D3D12::FillVRAM(u32 x, u32 y, u32 width, u32 height, u32 color)
 {
+  SyncRenderThread();
+  g_host_display->SetGPUTimingScope(GPUTimingScope::VRAMTransfers);
+
   if (IsUsingSoftwareRendererForReadbacks())
     FillSoftwareRendererVRAM(x, y, width, height, color);
 
@@ -1017,6 +1133,9 @@ void GPU_HW_D3D12::FillVRAM(u32 x, u32 y, u32 width, u32 height, u32 color)
 
 void GPU_HW_D3D12::UpdateVRAM(u32 x, u32 y, u32 width, u32 height, const void* data, bool set_mask, bool check_mask)
 {
+  SyncRenderThread();
+  g_host_display->SetGPUTimingScope(GPUTimingScope::VRAMTransfers);
+
   if (IsUsingSoftwareRendererForReadbacks())
     UpdateSoftwareRendererVRAM(x, y, width, height, data, set_mask, check_mask);
 
@@ -1065,12 +1184,16 @@ void GPU_HW_D3D12::UpdateVRAM(u32 x, u32 y, u32 width, u32 height, const void* d
                     scaled_bounds.GetHeight());
 
   cmdlist->DrawInstanced(3, 1, 0, 0);
+  m_renderer_stats.num_vram_write_uploads++;
 
   RestoreGraphicsAPIState();
 }
 
 void GPU_HW_D3D12::CopyVRAM(u32 src_x, u32 src_y, u32 dst_x, u32 dst_y, u32 width, u32 height)
 {
+  SyncRenderThread();
+  g_host_display->SetGPUTimingScope(GPUTimingScope::VRAMTransfers);
+
   if (IsUsingSoftwareRendererForReadbacks())
     CopySoftwareRendererVRAM(src_x, src_y, dst_x, dst_y, width, height);
 
@@ -1078,8 +1201,7 @@ void GPU_HW_D3D12::CopyVRAM(u32 src_x, u32 src_y, u32 dst_x, u32 dst_y, u32 widt
   {
     const Common::Rectangle<u32> src_bounds = GetVRAMTransferBounds(src_x, src_y, width, height);
     const Common::Rectangle<u32> dst_bounds = GetVRAMTransferBounds(dst_x, dst_y, width, height);
-    if (m_vram_dirty_rect.Intersects(src_bounds))
-      UpdateVRAMReadTexture();
+    UpdateVRAMReadTexturePages(GetDirtyVRAMPages(src_bounds));
     IncludeVRAMDirtyRectangle(dst_bounds);
 
     const VRAMCopyUBOData uniforms(GetVRAMCopyUBOData(src_x, src_y, dst_x, dst_y, width, height));
@@ -1102,8 +1224,8 @@ void GPU_HW_D3D12::CopyVRAM(u32 src_x, u32 src_y, u32 dst_x, u32 dst_y, u32 widt
     return;
   }
 
-  if (m_vram_dirty_rect.Intersects(Common::Rectangle<u32>::FromExtents(src_x, src_y, width, height)))
-    UpdateVRAMReadTexture();
+  UpdateVRAMReadTexturePages(
+    GetDirtyVRAMPages(Common::Rectangle<u32>::FromExtents(src_x, src_y, width, height)));
 
   GPU_HW::CopyVRAM(src_x, src_y, dst_x, dst_y, width, height);
 
@@ -1128,11 +1250,11 @@ void GPU_HW_D3D12::CopyVRAM(u32 src_x, u32 src_y, u32 dst_x, u32 dst_y, u32 widt
   m_vram_texture.TransitionToState(D3D12_RESOURCE_STATE_RENDER_TARGET);
 }
 
-void GPU_HW_D3D12::UpdateVRAMReadTexture()
+void GPU_HW_D3D12::CopyVRAMToReadTexture(const Common::Rectangle<u32>& rect)
 {
   ID3D12GraphicsCommandList* cmdlist = g_d3d12_context->GetCommandList();
 
-  const auto scaled_rect = m_vram_dirty_rect * m_resolution_scale;
+  const auto scaled_rect = rect * m_resolution_scale;
 
   if (m_vram_texture.IsMultisampled())
   {
@@ -1153,20 +1275,20 @@ void GPU_HW_D3D12::UpdateVRAMReadTexture()
 
   m_vram_read_texture.TransitionToState(D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
   m_vram_texture.TransitionToState(D3D12_RESOURCE_STATE_RENDER_TARGET);
-
-  GPU_HW::UpdateVRAMReadTexture();
 }
 
-void GPU_HW_D3D12::UpdateDepthBufferFromMaskBit()
+void GPU_HW_D3D12::UpdateDepthBufferFromMaskBit(const Common::Rectangle<u32>& rect)
 {
   ID3D12GraphicsCommandList* cmdlist = g_d3d12_context->GetCommandList();
+  const Common::Rectangle<u32> scaled_rect = rect * m_resolution_scale;
 
   m_vram_texture.TransitionToState(D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
 
   cmdlist->OMSetRenderTargets(0, nullptr, FALSE, &m_vram_depth_texture.GetRTVOrDSVDescriptor().cpu_handle);
   cmdlist->SetGraphicsRootDescriptorTable(1, m_vram_texture.GetSRVDescriptor());
   cmdlist->SetPipelineState(m_vram_update_depth_pipeline.Get());
-  D3D12::SetViewportAndScissor(cmdlist, 0, 0, m_vram_texture.GetWidth(), m_vram_texture.GetHeight());
+  D3D12::SetViewport(cmdlist, 0, 0, m_vram_texture.GetWidth(), m_vram_texture.GetHeight());
+  D3D12::SetScissor(cmdlist, scaled_rect.left, scaled_rect.top, scaled_rect.GetWidth(), scaled_rect.GetHeight());
   cmdlist->DrawInstanced(3, 1, 0, 0);
 
   m_vram_texture.TransitionToState(D3D12_RESOURCE_STATE_RENDER_TARGET);
@@ -1174,11 +1296,14 @@ void GPU_HW_D3D12::UpdateDepthBufferFromMaskBit()
   RestoreGraphicsAPIState();
 }
 
-void GPU_HW_D3D12::ClearDepthBuffer()
+void GPU_HW_D3D12::ClearDepthBuffer(const Common::Rectangle<u32>& rect)
 {
   ID3D12GraphicsCommandList* cmdlist = g_d3d12_context->GetCommandList();
+  const Common::Rectangle<u32> scaled_rect = rect * m_resolution_scale;
+  const D3D12_RECT clear_rect = {static_cast<LONG>(scaled_rect.left), static_cast<LONG>(scaled_rect.top),
+                                 static_cast<LONG>(scaled_rect.right), static_cast<LONG>(scaled_rect.bottom)};
   cmdlist->ClearDepthStencilView(m_vram_depth_texture.GetRTVOrDSVDescriptor(), D3D12_CLEAR_FLAG_DEPTH,
-                                 m_pgxp_depth_buffer ? 1.0f : 0.0f, 0, 0, nullptr);
+                                 m_pgxp_depth_buffer ? 1.0f : 0.0f, 0, 1, &clear_rect);
 }
 
 std::unique_ptr<GPU> GPU::CreateHardwareD3D12Renderer()
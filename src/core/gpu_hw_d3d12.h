@@ -37,14 +37,17 @@ protected:
   void FillVRAM(u32 x, u32 y, u32 width, u32 height, u32 color) override;
   void UpdateVRAM(u32 x, u32 y, u32 width, u32 height, const void* data, bool set_mask, bool check_mask) override;
   void CopyVRAM(u32 src_x, u32 src_y, u32 dst_x, u32 dst_y, u32 width, u32 height) override;
-  void UpdateVRAMReadTexture() override;
-  void UpdateDepthBufferFromMaskBit() override;
-  void ClearDepthBuffer() override;
+  void CopyVRAMToReadTexture(const Common::Rectangle<u32>& rect) override;
+  void UpdateDepthBufferFromMaskBit(const Common::Rectangle<u32>& rect) override;
+  void ClearDepthBuffer(const Common::Rectangle<u32>& rect) override;
   void SetScissorFromDrawingArea() override;
   void MapBatchVertexPointer(u32 required_vertices) override;
   void UnmapBatchVertexPointer(u32 used_vertices) override;
   void UploadUniformBuffer(const void* data, u32 data_size) override;
-  void DrawBatchVertices(BatchRenderMode render_mode, u32 base_vertex, u32 num_vertices) override;
+  void DrawBatchVertices(const BatchConfig& batch, BatchRenderMode render_mode, u32 base_vertex,
+                         u32 num_vertices) override;
+  bool SupportsRenderThread() const override;
+  u32 UploadBatchVertices(const BatchVertex* vertices, u32 num_vertices) override;
 
 private:
   enum : u32
@@ -63,7 +66,6 @@ private:
   void DestroyFramebuffer();
 
   bool CreateVertexBuffer();
-  bool CreateUniformBuffer();
   bool CreateTextureBuffer();
 
   bool CompilePipelines();
@@ -71,6 +73,8 @@ private:
 
   bool CreateTextureReplacementStreamBuffer();
   bool BlitVRAMReplacementTexture(const TextureReplacementTexture* tex, u32 dst_x, u32 dst_y, u32 width, u32 height);
+  bool BlitCompressedVRAMReplacementTexture(const TextureReplacementTexture* tex, u32 dst_x, u32 dst_y, u32 width,
+                                            u32 height);
 
   ComPtr<ID3D12RootSignature> m_batch_root_signature;
   ComPtr<ID3D12RootSignature> m_single_sampler_root_signature;
@@ -86,11 +90,10 @@ private:
   D3D12::DescriptorHandle m_linear_sampler;
 
   D3D12::StreamBuffer m_vertex_stream_buffer;
-  D3D12::StreamBuffer m_uniform_stream_buffer;
   D3D12::StreamBuffer m_texture_stream_buffer;
   D3D12::DescriptorHandle m_texture_stream_buffer_srv;
 
-  u32 m_current_uniform_buffer_offset = 0;
+  BatchUBOData m_batch_root_constants = {};
 
   // [depth_test][render_mode][texture_mode][transparency_mode][dithering][interlacing]
   DimensionalArray<ComPtr<ID3D12PipelineState>, 2, 2, 5, 9, 4, 2> m_batch_pipelines;
@@ -110,5 +113,8 @@ private:
 
   ComPtr<ID3D12PipelineState> m_copy_pipeline;
   D3D12::Texture m_vram_write_replacement_texture;
+  D3D12::Texture m_vram_write_replacement_compressed_texture;
+  TextureReplacementTexture::Format m_vram_write_replacement_compressed_format =
+    TextureReplacementTexture::Format::Count;
   D3D12::StreamBuffer m_texture_replacment_stream_buffer;
 };
@@ -27,6 +27,7 @@ GPU_HW_OpenGL::~GPU_HW_OpenGL()
     glDeleteVertexArrays(1, &m_attributeless_vao_id);
   if (m_texture_buffer_r16ui_texture != 0)
     glDeleteTextures(1, &m_texture_buffer_r16ui_texture);
+  DestroySpeculativeReadbackBuffer();
 
   g_host_display->ClearDisplayTexture();
 
@@ -194,6 +195,18 @@ void GPU_HW_OpenGL::ResetGraphicsAPIState()
 {
   GPU_HW::ResetGraphicsAPIState();
 
+  // Whatever the CPU read back this frame will probably be read again next frame, so copy it out while we're here
+  // and let it complete with the frame rather than stalling on it later.
+  if (m_frame_readback_rect.Valid())
+  {
+    if (m_supports_speculative_readback && !IsSpeculativeReadbackValid(m_frame_readback_rect))
+    {
+      FlushRender();
+      QueueSpeculativeReadback(m_frame_readback_rect);
+    }
+    m_frame_readback_rect.SetInvalid();
+  }
+
   glEnable(GL_CULL_FACE);
   glDisable(GL_SCISSOR_TEST);
   glDisable(GL_BLEND);
@@ -242,7 +255,7 @@ void GPU_HW_OpenGL::UpdateSettings()
   {
     RestoreGraphicsAPIState();
     UpdateVRAM(0, 0, VRAM_WIDTH, VRAM_HEIGHT, m_vram_ptr, false, false);
-    UpdateDepthBufferFromMaskBit();
+    UpdateDepthBufferPagesFromMaskBit();
     UpdateDisplay();
     ResetGraphicsAPIState();
   }
@@ -296,6 +309,10 @@ void GPU_HW_OpenGL::SetCapabilities()
   if (!GLAD_GL_VERSION_4_3 && !GLAD_GL_EXT_copy_image && !GLAD_GL_ES_VERSION_3_2 && !GLAD_GL_OES_copy_image)
     Log_WarningPrintf("GL_EXT/OES_copy_image missing, this may affect performance.");
 
+  // Fences tell us when a speculative readback into the pixel pack buffer has landed.
+  m_supports_speculative_readback = (GLAD_GL_VERSION_3_2 || GLAD_GL_ARB_sync || GLAD_GL_ES_VERSION_3_0);
+  Log_InfoPrintf("Speculative readbacks: %s", m_supports_speculative_readback ? "supported" : "not supported");
+
 #ifdef __APPLE__
   // Partial texture buffer uploads appear to be broken in macOS's OpenGL driver.
   m_use_texture_buffer_for_vram_writes = false;
@@ -488,6 +505,64 @@ bool GPU_HW_OpenGL::CreateTextureBuffer()
   return true;
 }
 
+bool GPU_HW_OpenGL::CreateSpeculativeReadbackBuffer()
+{
+  // Large enough for the whole of VRAM, since the encoded readback is the same size as the 16-bit source.
+  const u32 size = VRAM_WIDTH * VRAM_HEIGHT * sizeof(u16);
+
+  glGetError();
+  glGenBuffers(1, &m_speculative_readback_buffer_id);
+  glBindBuffer(GL_PIXEL_PACK_BUFFER, m_speculative_readback_buffer_id);
+
+  // Keep the buffer mapped where we can, otherwise it gets mapped for each read.
+  bool allocated = false;
+  if (GLAD_GL_VERSION_4_4 || GLAD_GL_ARB_buffer_storage || GLAD_GL_EXT_buffer_storage)
+  {
+    const GLbitfield flags = GL_MAP_READ_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+    if (GLAD_GL_VERSION_4_4 || GLAD_GL_ARB_buffer_storage)
+      glBufferStorage(GL_PIXEL_PACK_BUFFER, size, nullptr, flags);
+    else
+      glBufferStorageEXT(GL_PIXEL_PACK_BUFFER, size, nullptr, flags);
+
+    allocated = (glGetError() == GL_NO_ERROR);
+    if (allocated)
+      m_speculative_readback_map = static_cast<const u8*>(glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, size, flags));
+  }
+  if (!allocated)
+  {
+    glBufferData(GL_PIXEL_PACK_BUFFER, size, nullptr, GL_STREAM_READ);
+    allocated = (glGetError() == GL_NO_ERROR);
+  }
+
+  glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+  if (!allocated)
+  {
+    Log_ErrorPrintf("Failed to allocate speculative readback buffer");
+    DestroySpeculativeReadbackBuffer();
+    return false;
+  }
+
+  return true;
+}
+
+void GPU_HW_OpenGL::DestroySpeculativeReadbackBuffer()
+{
+  m_speculative_readback_rect.SetInvalid();
+  if (m_speculative_readback_fence)
+  {
+    glDeleteSync(m_speculative_readback_fence);
+    m_speculative_readback_fence = nullptr;
+  }
+
+  if (m_speculative_readback_buffer_id == 0)
+    return;
+
+  // unmapped as part of the buffer delete
+  glDeleteBuffers(1, &m_speculative_readback_buffer_id);
+  m_speculative_readback_buffer_id = 0;
+  m_speculative_readback_map = nullptr;
+}
+
 bool GPU_HW_OpenGL::CompilePrograms()
 {
   GL::ShaderCache shader_cache;
@@ -495,11 +570,24 @@ bool GPU_HW_OpenGL::CompilePrograms()
 
   const bool use_binding_layout = GPU_HW_ShaderGen::UseGLSLBindingLayout();
   GPU_HW_ShaderGen shadergen(g_host_display->GetRenderAPI(), m_resolution_scale, m_multisamples, m_per_sample_shading,
-                             m_true_color, m_scaled_dithering, m_texture_filtering, m_using_uv_limits,
-                             m_pgxp_depth_buffer, m_disable_color_perspective, m_supports_dual_source_blend);
+                             m_true_color, m_scaled_dithering, m_texture_filtering, m_adaptive_texture_filtering,
+                             m_using_uv_limits, m_pgxp_depth_buffer, m_disable_color_perspective,
+                             m_supports_dual_source_blend, m_use_palette_texture_cache);
 
   ShaderCompileProgressTracker progress("Compiling Programs", (4 * 9 * 2 * 2) + (2 * 3) + (2 * 2) + 1 + 1 + 1 + 1 + 1);
 
+  struct QueuedBatchProgram
+  {
+    u32 handle;
+    u8 render_mode;
+    u8 texture_mode;
+    u8 dithering;
+    u8 interlacing;
+    bool textured;
+  };
+  std::vector<QueuedBatchProgram> queued_batch_programs;
+  queued_batch_programs.reserve(4 * 9 * 2 * 2);
+
   for (u32 render_mode = 0; render_mode < 4; render_mode++)
   {
     for (u32 texture_mode = 0; texture_mode < 9; texture_mode++)
@@ -508,11 +596,21 @@ bool GPU_HW_OpenGL::CompilePrograms()
       {
         for (u8 interlacing = 0; interlacing < 2; interlacing++)
         {
+          if (!IsBatchShaderVariantUsed(m_use_uber_shaders, static_cast<GPUTextureMode>(texture_mode),
+                                        ConvertToBoolUnchecked(dithering), ConvertToBoolUnchecked(interlacing)))
+          {
+            progress.Increment();
+            continue;
+          }
+
           const bool textured = (static_cast<GPUTextureMode>(texture_mode) != GPUTextureMode::Disabled);
           const std::string batch_vs = shadergen.GenerateBatchVertexShader(textured);
-          const std::string fs = shadergen.GenerateBatchFragmentShader(
-            static_cast<BatchRenderMode>(render_mode), static_cast<GPUTextureMode>(texture_mode),
-            ConvertToBoolUnchecked(dithering), ConvertToBoolUnchecked(interlacing));
+          const std::string fs =
+            m_use_uber_shaders ?
+              shadergen.GenerateBatchUberFragmentShader(static_cast<BatchRenderMode>(render_mode), textured) :
+              shadergen.GenerateBatchFragmentShader(
+                static_cast<BatchRenderMode>(render_mode), static_cast<GPUTextureMode>(texture_mode),
+                ConvertToBoolUnchecked(dithering), ConvertToBoolUnchecked(interlacing));
 
           const auto link_callback = [this, textured, use_binding_layout](GL::Program& prog) {
             if (!use_binding_layout)
@@ -541,26 +639,34 @@ bool GPU_HW_OpenGL::CompilePrograms()
             }
           };
 
-          std::optional<GL::Program> prog = shader_cache.GetProgram(batch_vs, fs, link_callback);
-          if (!prog)
-            return false;
-
-          if (!use_binding_layout)
-          {
-            prog->BindUniformBlock("UBOBlock", 1);
-            if (textured)
-            {
-              prog->Bind();
-              prog->Uniform1i("samp0", 0);
-            }
-          }
+          queued_batch_programs.push_back({shader_cache.QueueProgram(batch_vs, fs, link_callback),
+                                           static_cast<u8>(render_mode), static_cast<u8>(texture_mode), dithering,
+                                           interlacing, textured});
+        }
+      }
+    }
+  }
 
-          m_render_programs[render_mode][texture_mode][dithering][interlacing] = std::move(*prog);
+  // the batch programs are all in flight now, so the driver can build them in parallel while we wait on each one
+  for (const QueuedBatchProgram& qbp : queued_batch_programs)
+  {
+    std::optional<GL::Program> prog = shader_cache.FinishProgram(qbp.handle);
+    if (!prog)
+      return false;
 
-          progress.Increment();
-        }
+    if (!use_binding_layout)
+    {
+      prog->BindUniformBlock("UBOBlock", 1);
+      if (qbp.textured)
+      {
+        prog->Bind();
+        prog->Uniform1i("samp0", 0);
       }
     }
+
+    m_render_programs[qbp.render_mode][qbp.texture_mode][qbp.dithering][qbp.interlacing] = std::move(*prog);
+
+    progress.Increment();
   }
 
   for (u8 depth_24bit = 0; depth_24bit < 2; depth_24bit++)
@@ -704,15 +810,18 @@ bool GPU_HW_OpenGL::CompilePrograms()
   return true;
 }
 
-void GPU_HW_OpenGL::DrawBatchVertices(BatchRenderMode render_mode, u32 base_vertex, u32 num_vertices)
+void GPU_HW_OpenGL::DrawBatchVertices(const BatchConfig& batch, BatchRenderMode render_mode, u32 base_vertex,
+                                      u32 num_vertices)
 {
-  const GL::Program& prog = m_render_programs[static_cast<u8>(render_mode)][static_cast<u8>(m_batch.texture_mode)]
-                                             [BoolToUInt8(m_batch.dithering)][BoolToUInt8(m_batch.interlacing)];
+  const BatchConfig shader_config = GetBatchShaderConfig(batch);
+  const GL::Program& prog =
+    m_render_programs[static_cast<u8>(render_mode)][static_cast<u8>(shader_config.texture_mode)]
+                     [BoolToUInt8(shader_config.dithering)][BoolToUInt8(shader_config.interlacing)];
   prog.Bind();
 
-  if (m_current_transparency_mode != m_batch.transparency_mode || m_current_render_mode != render_mode)
+  if (m_current_transparency_mode != batch.transparency_mode || m_current_render_mode != render_mode)
   {
-    m_current_transparency_mode = m_batch.transparency_mode;
+    m_current_transparency_mode = batch.transparency_mode;
     m_current_render_mode = render_mode;
     SetBlendMode();
   }
@@ -752,6 +861,19 @@ void GPU_HW_OpenGL::SetBlendMode()
 bool GPU_HW_OpenGL::BlitVRAMReplacementTexture(const TextureReplacementTexture* tex, u32 dst_x, u32 dst_y, u32 width,
                                                u32 height)
 {
+  // Compressed formats aren't guaranteed on GLES, so use the original data rather than decoding on the CPU.
+  if (tex->IsCompressed())
+  {
+    static bool warned = false;
+    if (!warned)
+    {
+      Log_WarningPrint("Compressed replacement textures are not supported by the OpenGL renderer");
+      warned = true;
+    }
+
+    return false;
+  }
+
   if (!m_vram_write_replacement_texture.IsValid())
   {
     if (!m_vram_write_replacement_texture.Create(tex->GetWidth(), tex->GetHeight(), 1, 1, 1,
@@ -818,8 +940,25 @@ void GPU_HW_OpenGL::UploadUniformBuffer(const void* data, u32 data_size)
   m_renderer_stats.num_uniform_buffer_updates++;
 }
 
+void GPU_HW_OpenGL::DrawRendererStats(bool is_idle_frame)
+{
+  for (GL::StreamBuffer* sb :
+       {m_vertex_stream_buffer.get(), m_uniform_stream_buffer.get(), m_texture_stream_buffer.get()})
+  {
+    if (!sb)
+      continue;
+
+    const GL::StreamBuffer::Stats sbs = sb->GetAndResetStats();
+    m_renderer_stats.num_stream_buffer_waits += sbs.num_waits;
+    m_renderer_stats.stream_buffer_wait_time_us += sbs.wait_time_us;
+  }
+
+  GPU_HW::DrawRendererStats(is_idle_frame);
+}
+
 void GPU_HW_OpenGL::ClearDisplay()
 {
+  g_host_display->SetGPUTimingScope(GPUTimingScope::Display);
   GPU_HW::ClearDisplay();
 
   g_host_display->ClearDisplayTexture();
@@ -834,6 +973,7 @@ void GPU_HW_OpenGL::ClearDisplay()
 
 void GPU_HW_OpenGL::UpdateDisplay()
 {
+  g_host_display->SetGPUTimingScope(GPUTimingScope::Display);
   GPU_HW::UpdateDisplay();
 
   if (g_settings.debugging.show_vram)
@@ -951,8 +1091,31 @@ void GPU_HW_OpenGL::ReadVRAM(u32 x, u32 y, u32 width, u32 height)
     return;
   }
 
+  g_host_display->SetGPUTimingScope(GPUTimingScope::VRAMReadbacks);
+
   // Get bounds with wrap-around handled.
   const Common::Rectangle<u32> copy_rect = GetVRAMTransferBounds(x, y, width, height);
+  m_frame_readback_rect.Include(copy_rect);
+  if (ReadSpeculativeVRAM(copy_rect))
+    return;
+
+  const u32 encoded_width = (copy_rect.GetWidth() + 1) / 2;
+  const u32 encoded_height = copy_rect.GetHeight();
+  EncodeVRAMForReadback(copy_rect);
+
+  // Readback encoded texture.
+  m_vram_encoding_texture.BindFramebuffer(GL_READ_FRAMEBUFFER);
+  glPixelStorei(GL_PACK_ALIGNMENT, 2);
+  glPixelStorei(GL_PACK_ROW_LENGTH, VRAM_WIDTH / 2);
+  glReadPixels(0, 0, encoded_width, encoded_height, GL_RGBA, GL_UNSIGNED_BYTE,
+               &m_vram_shadow[copy_rect.top * VRAM_WIDTH + copy_rect.left]);
+  glPixelStorei(GL_PACK_ALIGNMENT, 4);
+  glPixelStorei(GL_PACK_ROW_LENGTH, 0);
+  RestoreGraphicsAPIState();
+}
+
+void GPU_HW_OpenGL::EncodeVRAMForReadback(const Common::Rectangle<u32>& copy_rect)
+{
   const u32 encoded_width = (copy_rect.GetWidth() + 1) / 2;
   const u32 encoded_height = copy_rect.GetHeight();
 
@@ -967,20 +1130,85 @@ void GPU_HW_OpenGL::ReadVRAM(u32 x, u32 y, u32 width, u32 height)
   glViewport(0, 0, encoded_width, encoded_height);
   glBindVertexArray(m_attributeless_vao_id);
   glDrawArrays(GL_TRIANGLES, 0, 3);
+}
 
-  // Readback encoded texture.
+void GPU_HW_OpenGL::QueueSpeculativeReadback(const Common::Rectangle<u32>& rect)
+{
+  if (m_speculative_readback_buffer_id == 0 && !CreateSpeculativeReadbackBuffer())
+    return;
+
+  const u32 encoded_width = (rect.GetWidth() + 1) / 2;
+  const u32 encoded_height = rect.GetHeight();
+  EncodeVRAMForReadback(rect);
+
+  // Reading into a pixel pack buffer returns without waiting for the GPU.
   m_vram_encoding_texture.BindFramebuffer(GL_READ_FRAMEBUFFER);
-  glPixelStorei(GL_PACK_ALIGNMENT, 2);
-  glPixelStorei(GL_PACK_ROW_LENGTH, VRAM_WIDTH / 2);
-  glReadPixels(0, 0, encoded_width, encoded_height, GL_RGBA, GL_UNSIGNED_BYTE,
-               &m_vram_shadow[copy_rect.top * VRAM_WIDTH + copy_rect.left]);
-  glPixelStorei(GL_PACK_ALIGNMENT, 4);
-  glPixelStorei(GL_PACK_ROW_LENGTH, 0);
-  RestoreGraphicsAPIState();
+  glBindBuffer(GL_PIXEL_PACK_BUFFER, m_speculative_readback_buffer_id);
+  glReadPixels(0, 0, encoded_width, encoded_height, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+  glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+  if (m_speculative_readback_fence)
+    glDeleteSync(m_speculative_readback_fence);
+  m_speculative_readback_fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+  // Completes along with the rest of the frame, so by the time the CPU asks again it's usually already there.
+  m_speculative_readback_rect = rect;
+  m_speculative_readback_pitch = encoded_width * sizeof(u32);
+}
+
+bool GPU_HW_OpenGL::ReadSpeculativeVRAM(const Common::Rectangle<u32>& rect)
+{
+  if (!IsSpeculativeReadbackValid(rect))
+    return false;
+
+  const GLenum status = glClientWaitSync(m_speculative_readback_fence, 0, 0);
+  const bool stall_avoided = (status == GL_ALREADY_SIGNALED || status == GL_CONDITION_SATISFIED);
+  if (!stall_avoided &&
+      glClientWaitSync(m_speculative_readback_fence, GL_SYNC_FLUSH_COMMANDS_BIT, GL_TIMEOUT_IGNORED) == GL_WAIT_FAILED)
+  {
+    return false;
+  }
+
+  const Common::Rectangle<u32>& spec_rect = m_speculative_readback_rect;
+  const u8* map = m_speculative_readback_map;
+  if (!map)
+  {
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, m_speculative_readback_buffer_id);
+    map = static_cast<const u8*>(glMapBufferRange(
+      GL_PIXEL_PACK_BUFFER, 0, spec_rect.GetHeight() * m_speculative_readback_pitch, GL_MAP_READ_BIT));
+    if (!map)
+    {
+      glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+      return false;
+    }
+  }
+
+  // Two VRAM pixels are packed into each texel, so the pixel offset is simply in 16-bit units.
+  const u8* src = map + ((rect.top - spec_rect.top) * m_speculative_readback_pitch) +
+                  ((rect.left - spec_rect.left) * sizeof(u16));
+  u16* dst = &m_vram_shadow[rect.top * VRAM_WIDTH + rect.left];
+  for (u32 row = 0; row < rect.GetHeight(); row++)
+  {
+    std::memcpy(dst, src, rect.GetWidth() * sizeof(u16));
+    src += m_speculative_readback_pitch;
+    dst += VRAM_WIDTH;
+  }
+
+  if (!m_speculative_readback_map)
+  {
+    glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+  }
+
+  if (stall_avoided)
+    m_renderer_stats.num_readback_stalls_avoided++;
+
+  return true;
 }
 
 void GPU_HW_OpenGL::FillVRAM(u32 x, u32 y, u32 width, u32 height, u32 color)
 {
+  g_host_display->SetGPUTimingScope(GPUTimingScope::VRAMTransfers);
   if (IsUsingSoftwareRendererForReadbacks())
     FillSoftwareRendererVRAM(x, y, width, height, color);
 
@@ -1019,6 +1247,7 @@ void GPU_HW_OpenGL::FillVRAM(u32 x, u32 y, u32 width, u32 height, u32 color)
 
 void GPU_HW_OpenGL::UpdateVRAM(u32 x, u32 y, u32 width, u32 height, const void* data, bool set_mask, bool check_mask)
 {
+  g_host_display->SetGPUTimingScope(GPUTimingScope::VRAMTransfers);
   if (IsUsingSoftwareRendererForReadbacks())
     UpdateSoftwareRendererVRAM(x, y, width, height, data, set_mask, check_mask);
 
@@ -1061,6 +1290,7 @@ void GPU_HW_OpenGL::UpdateVRAM(u32 x, u32 y, u32 width, u32 height, const void*
     glScissor(scaled_bounds.left, scaled_bounds.top, scaled_bounds.GetWidth(), scaled_bounds.GetHeight());
     glBindVertexArray(m_attributeless_vao_id);
     glDrawArrays(GL_TRIANGLES, 0, 3);
+    m_renderer_stats.num_vram_write_uploads++;
 
     RestoreGraphicsAPIState();
   }
@@ -1112,6 +1342,7 @@ void GPU_HW_OpenGL::UpdateVRAM(u32 x, u32 y, u32 width, u32 height, const void*
     glTexSubImage2D(m_vram_texture.GetGLTarget(), 0, x, y, width, height, GL_RGBA, GL_UNSIGNED_BYTE,
                     reinterpret_cast<void*>(static_cast<uintptr_t>(map_result.buffer_offset)));
     m_texture_stream_buffer->Unbind();
+    m_renderer_stats.num_vram_write_uploads++;
 
     if (m_resolution_scale > 1)
     {
@@ -1131,17 +1362,17 @@ void GPU_HW_OpenGL::UpdateVRAM(u32 x, u32 y, u32 width, u32 height, const void*
 
 void GPU_HW_OpenGL::CopyVRAM(u32 src_x, u32 src_y, u32 dst_x, u32 dst_y, u32 width, u32 height)
 {
+  g_host_display->SetGPUTimingScope(GPUTimingScope::VRAMTransfers);
   if (IsUsingSoftwareRendererForReadbacks())
     CopySoftwareRendererVRAM(src_x, src_y, dst_x, dst_y, width, height);
 
   const Common::Rectangle<u32> dst_bounds = GetVRAMTransferBounds(dst_x, dst_y, width, height);
   const Common::Rectangle<u32> src_bounds = GetVRAMTransferBounds(src_x, src_y, width, height);
-  const bool src_dirty = m_vram_dirty_rect.Intersects(src_bounds);
+  const u32 src_dirty_pages = GetDirtyVRAMPages(src_bounds);
 
   if (UseVRAMCopyShader(src_x, src_y, dst_x, dst_y, width, height))
   {
-    if (src_dirty)
-      UpdateVRAMReadTexture();
+    UpdateVRAMReadTexturePages(src_dirty_pages);
     IncludeVRAMDirtyRectangle(dst_bounds);
 
     const VRAMCopyUBOData uniforms = GetVRAMCopyUBOData(src_x, src_y, dst_x, dst_y, width, height);
@@ -1195,8 +1426,7 @@ void GPU_HW_OpenGL::CopyVRAM(u32 src_x, u32 src_y, u32 dst_x, u32 dst_y, u32 wid
   {
     // glBlitFramebufer with same source/destination should be legal, but on Mali (at least Bifrost) it breaks.
     // So, blit from the shadow texture, like in the other renderers.
-    if (src_dirty)
-      UpdateVRAMReadTexture();
+    UpdateVRAMReadTexturePages(src_dirty_pages);
 
     glDisable(GL_SCISSOR_TEST);
     m_vram_read_texture.BindFramebuffer(GL_READ_FRAMEBUFFER);
@@ -1208,9 +1438,9 @@ void GPU_HW_OpenGL::CopyVRAM(u32 src_x, u32 src_y, u32 dst_x, u32 dst_y, u32 wid
   IncludeVRAMDirtyRectangle(dst_bounds);
 }
 
-void GPU_HW_OpenGL::UpdateVRAMReadTexture()
+void GPU_HW_OpenGL::CopyVRAMToReadTexture(const Common::Rectangle<u32>& rect)
 {
-  const auto scaled_rect = m_vram_dirty_rect * m_resolution_scale;
+  const auto scaled_rect = rect * m_resolution_scale;
   const u32 width = scaled_rect.GetWidth();
   const u32 height = scaled_rect.GetHeight();
   const u32 x = scaled_rect.left;
@@ -1241,16 +1471,15 @@ void GPU_HW_OpenGL::UpdateVRAMReadTexture()
     glEnable(GL_SCISSOR_TEST);
     glBindFramebuffer(GL_DRAW_FRAMEBUFFER, m_vram_fbo_id);
   }
-
-  GPU_HW::UpdateVRAMReadTexture();
 }
 
-void GPU_HW_OpenGL::UpdateDepthBufferFromMaskBit()
+void GPU_HW_OpenGL::UpdateDepthBufferFromMaskBit(const Common::Rectangle<u32>& rect)
 {
   if (m_pgxp_depth_buffer)
     return;
 
-  glDisable(GL_SCISSOR_TEST);
+  const Common::Rectangle<u32> scaled_rect = rect * m_resolution_scale;
+  glScissor(scaled_rect.left, scaled_rect.top, scaled_rect.GetWidth(), scaled_rect.GetHeight());
   glDisable(GL_BLEND);
   glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
   glDepthFunc(GL_ALWAYS);
@@ -1262,22 +1491,23 @@ void GPU_HW_OpenGL::UpdateDepthBufferFromMaskBit()
 
   glBindVertexArray(m_vao_id);
   glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
-  glEnable(GL_SCISSOR_TEST);
+  SetScissorFromDrawingArea();
 
   m_vram_read_texture.Bind();
 }
 
-void GPU_HW_OpenGL::ClearDepthBuffer()
+void GPU_HW_OpenGL::ClearDepthBuffer(const Common::Rectangle<u32>& rect)
 {
-  glDisable(GL_SCISSOR_TEST);
+  const Common::Rectangle<u32> scaled_rect = rect * m_resolution_scale;
+  glScissor(scaled_rect.left, scaled_rect.top, scaled_rect.GetWidth(), scaled_rect.GetHeight());
   IsGLES() ? glClearDepthf(1.0f) : glClearDepth(1.0f);
   glClear(GL_DEPTH_BUFFER_BIT);
-  glEnable(GL_SCISSOR_TEST);
-  m_last_depth_z = 1.0f;
+  SetScissorFromDrawingArea();
 }
 
 void GPU_HW_OpenGL::DownsampleFramebuffer(GL::Texture& source, u32 left, u32 top, u32 width, u32 height)
 {
+  g_host_display->SetGPUTimingScope(GPUTimingScope::Downsample);
   DebugAssert(m_downsample_mode != GPUDownsampleMode::Adaptive);
   DownsampleFramebufferBoxFilter(source, left, top, width, height);
 }
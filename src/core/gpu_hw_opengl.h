@@ -36,14 +36,16 @@ protected:
   void FillVRAM(u32 x, u32 y, u32 width, u32 height, u32 color) override;
   void UpdateVRAM(u32 x, u32 y, u32 width, u32 height, const void* data, bool set_mask, bool check_mask) override;
   void CopyVRAM(u32 src_x, u32 src_y, u32 dst_x, u32 dst_y, u32 width, u32 height) override;
-  void UpdateVRAMReadTexture() override;
-  void UpdateDepthBufferFromMaskBit() override;
-  void ClearDepthBuffer() override;
+  void CopyVRAMToReadTexture(const Common::Rectangle<u32>& rect) override;
+  void UpdateDepthBufferFromMaskBit(const Common::Rectangle<u32>& rect) override;
+  void ClearDepthBuffer(const Common::Rectangle<u32>& rect) override;
   void SetScissorFromDrawingArea() override;
   void MapBatchVertexPointer(u32 required_vertices) override;
   void UnmapBatchVertexPointer(u32 used_vertices) override;
   void UploadUniformBuffer(const void* data, u32 data_size) override;
-  void DrawBatchVertices(BatchRenderMode render_mode, u32 base_vertex, u32 num_vertices) override;
+  void DrawBatchVertices(const BatchConfig& batch, BatchRenderMode render_mode, u32 base_vertex,
+                         u32 num_vertices) override;
+  void DrawRendererStats(bool is_idle_frame) override;
 
 private:
   struct GLStats
@@ -67,6 +69,8 @@ private:
   bool CreateVertexBuffer();
   bool CreateUniformBuffer();
   bool CreateTextureBuffer();
+  bool CreateSpeculativeReadbackBuffer();
+  void DestroySpeculativeReadbackBuffer();
 
   bool CompilePrograms();
 
@@ -74,6 +78,10 @@ private:
   void SetDepthFunc(GLenum func);
   void SetBlendMode();
 
+  void EncodeVRAMForReadback(const Common::Rectangle<u32>& copy_rect);
+  void QueueSpeculativeReadback(const Common::Rectangle<u32>& rect);
+  bool ReadSpeculativeVRAM(const Common::Rectangle<u32>& rect);
+
   bool BlitVRAMReplacementTexture(const TextureReplacementTexture* tex, u32 dst_x, u32 dst_y, u32 width, u32 height);
   void DownsampleFramebuffer(GL::Texture& source, u32 left, u32 top, u32 width, u32 height);
   void DownsampleFramebufferBoxFilter(GL::Texture& source, u32 left, u32 top, u32 width, u32 height);
@@ -97,6 +105,12 @@ private:
   std::unique_ptr<GL::StreamBuffer> m_texture_stream_buffer;
   GLuint m_texture_buffer_r16ui_texture = 0;
 
+  // speculative readback, copied out at the end of the frame for the next ReadVRAM()
+  GLuint m_speculative_readback_buffer_id = 0;
+  GLsync m_speculative_readback_fence = nullptr;
+  const u8* m_speculative_readback_map = nullptr;
+  u32 m_speculative_readback_pitch = 0;
+
   std::array<std::array<std::array<std::array<GL::Program, 2>, 2>, 9>, 4>
     m_render_programs;                                          // [render_mode][texture_mode][dithering][interlacing]
   std::array<std::array<GL::Program, 3>, 2> m_display_programs; // [depth_24][interlaced]
@@ -111,6 +125,7 @@ private:
 
   bool m_use_texture_buffer_for_vram_writes = false;
   bool m_use_ssbo_for_vram_writes = false;
+  bool m_supports_speculative_readback = false;
 
   GLenum m_current_depth_test = 0;
   GPUTransparencyMode m_current_transparency_mode = GPUTransparencyMode::Disabled;
@@ -7,12 +7,15 @@
 
 GPU_HW_ShaderGen::GPU_HW_ShaderGen(RenderAPI render_api, u32 resolution_scale, u32 multisamples,
                                    bool per_sample_shading, bool true_color, bool scaled_dithering,
-                                   GPUTextureFilter texture_filtering, bool uv_limits, bool pgxp_depth,
-                                   bool disable_color_perspective, bool supports_dual_source_blend)
+                                   GPUTextureFilter texture_filtering, bool adaptive_texture_filtering,
+                                   bool uv_limits, bool pgxp_depth, bool disable_color_perspective,
+                                   bool supports_dual_source_blend, bool palette_texture_cache)
   : ShaderGen(render_api, supports_dual_source_blend), m_resolution_scale(resolution_scale),
     m_multisamples(multisamples), m_per_sample_shading(per_sample_shading), m_true_color(true_color),
-    m_scaled_dithering(scaled_dithering), m_texture_filter(texture_filtering), m_uv_limits(uv_limits),
-    m_pgxp_depth(pgxp_depth), m_disable_color_perspective(disable_color_perspective)
+    m_scaled_dithering(scaled_dithering), m_texture_filter(texture_filtering),
+    m_adaptive_texture_filtering(adaptive_texture_filtering && texture_filtering >= GPUTextureFilter::JINC2),
+    m_uv_limits(uv_limits), m_pgxp_depth(pgxp_depth),
+    m_disable_color_perspective(disable_color_perspective), m_palette_texture_cache(palette_texture_cache)
 {
 }
 
@@ -27,6 +30,13 @@ void GPU_HW_ShaderGen::WriteCommonFunctions(std::stringstream& ss)
   ss << "CONSTANT float2 RCP_VRAM_SIZE = float2(1.0, 1.0) / float2(VRAM_SIZE);\n";
   ss << "CONSTANT uint MULTISAMPLES = " << m_multisamples << "u;\n";
   ss << "CONSTANT bool PER_SAMPLE_SHADING = " << (m_per_sample_shading ? "true" : "false") << ";\n";
+  if (m_palette_texture_cache)
+  {
+    ss << "CONSTANT uint PALETTE_TEXTURE_CACHE_SLOT_SIZE = " << GPU_HW::PALETTE_TEXTURE_CACHE_SLOT_SIZE << "u;\n";
+    ss << "CONSTANT uint PALETTE_TEXTURE_CACHE_SLOTS_X = " << GPU_HW::PALETTE_TEXTURE_CACHE_SLOTS_X << "u;\n";
+    ss << "CONSTANT float2 RCP_PALETTE_TEXTURE_CACHE_SIZE = float2(1.0, 1.0) / float2("
+       << GPU_HW::PALETTE_TEXTURE_CACHE_SIZE << ".0, " << GPU_HW::PALETTE_TEXTURE_CACHE_SIZE << ".0);\n";
+  }
   ss << R"(
 uint RGBA8ToRGBA5551(float4 v)
 {
@@ -54,7 +64,8 @@ void GPU_HW_ShaderGen::WriteBatchUniformBuffer(std::stringstream& ss)
   DeclareUniformBuffer(ss,
                        {"uint2 u_texture_window_and", "uint2 u_texture_window_or", "float u_src_alpha_factor",
                         "float u_dst_alpha_factor", "uint u_interlaced_displayed_field",
-                        "bool u_set_mask_while_drawing"},
+                        "bool u_set_mask_while_drawing", "bool u_textured", "bool u_raw_texture", "bool u_dithering",
+                        "bool u_interlacing"},
                        false);
 }
 
@@ -65,6 +76,7 @@ std::string GPU_HW_ShaderGen::GenerateBatchVertexShader(bool textured)
   DefineMacro(ss, "TEXTURED", textured);
   DefineMacro(ss, "UV_LIMITS", m_uv_limits);
   DefineMacro(ss, "PGXP_DEPTH", m_pgxp_depth);
+  DefineMacro(ss, "PALETTE_TEXTURE_CACHE", m_palette_texture_cache);
 
   WriteCommonFunctions(ss);
   WriteBatchUniformBuffer(ss);
@@ -75,20 +87,23 @@ std::string GPU_HW_ShaderGen::GenerateBatchVertexShader(bool textured)
     {
       DeclareVertexEntryPoint(
         ss, {"float4 a_pos", "float4 a_col0", "uint a_texcoord", "uint a_texpage", "float4 a_uv_limits"}, 1, 1,
-        {{"nointerpolation", "uint4 v_texpage"}, {"nointerpolation", "float4 v_uv_limits"}}, false, "", UsingMSAA(),
-        UsingPerSampleShading(), m_disable_color_perspective);
+        {{"nointerpolation", "uint4 v_texpage"},
+         {"nointerpolation", "uint v_texmode"},
+         {"nointerpolation", "float4 v_uv_limits"}},
+        false, "", UsingMSAA(), UsingPerSampleShading(), m_disable_color_perspective);
     }
     else
     {
       DeclareVertexEntryPoint(ss, {"float4 a_pos", "float4 a_col0", "uint a_texcoord", "uint a_texpage"}, 1, 1,
-                              {{"nointerpolation", "uint4 v_texpage"}}, false, "", UsingMSAA(), UsingPerSampleShading(),
-                              m_disable_color_perspective);
+                              {{"nointerpolation", "uint4 v_texpage"}, {"nointerpolation", "uint v_texmode"}}, false,
+                              "", UsingMSAA(), UsingPerSampleShading(), m_disable_color_perspective);
     }
   }
   else
   {
-    DeclareVertexEntryPoint(ss, {"float4 a_pos", "float4 a_col0"}, 1, 0, {}, false, "", UsingMSAA(),
-                            UsingPerSampleShading(), m_disable_color_perspective);
+    // Untextured primitives only need MSAA coverage, per-sample shading is reserved for textured batches.
+    DeclareVertexEntryPoint(ss, {"float4 a_pos", "float4 a_col0"}, 1, 0, {}, false, "", UsingMSAA(), false,
+                            m_disable_color_perspective);
   }
 
   ss << R"(
@@ -134,6 +149,20 @@ std::string GPU_HW_ShaderGen::GenerateBatchVertexShader(bool textured)
     v_texpage.z = ((a_texpage >> 16) & 63u) * 16u * RESOLUTION_SCALE;
     v_texpage.w = ((a_texpage >> 22) & 511u) * RESOLUTION_SCALE;
 
+    // Colour mode from the texpage register, palettes are decoded per-primitive so they can share a batch.
+    v_texmode = (a_texpage >> 7) & 3u;
+
+    #if PALETTE_TEXTURE_CACHE
+      // Already decoded, the palette is replaced by the slot in the palette texture cache.
+      if ((a_texpage & 0x80000000u) != 0u)
+      {
+        uint slot = (a_texpage >> 16) & 63u;
+        v_texpage.xy = uint2(slot % PALETTE_TEXTURE_CACHE_SLOTS_X, slot / PALETTE_TEXTURE_CACHE_SLOTS_X) *
+                       PALETTE_TEXTURE_CACHE_SLOT_SIZE;
+        v_texmode = 4u;
+      }
+    #endif
+
     #if UV_LIMITS
       v_uv_limits = a_uv_limits * float4(255.0, 255.0, 255.0, 255.0);
     #endif
@@ -147,12 +176,17 @@ std::string GPU_HW_ShaderGen::GenerateBatchVertexShader(bool textured)
 void GPU_HW_ShaderGen::WriteBatchTextureFilter(std::stringstream& ss, GPUTextureFilter texture_filter)
 {
   // JINC2 and xBRZ shaders originally from beetle-psx, modified to support filtering mask channel.
-  if (texture_filter == GPUTextureFilter::Bilinear || texture_filter == GPUTextureFilter::BilinearBinAlpha)
+  const bool bilinear =
+    (texture_filter == GPUTextureFilter::Bilinear || texture_filter == GPUTextureFilter::BilinearBinAlpha);
+  DefineMacro(ss, "BINALPHA",
+              texture_filter == GPUTextureFilter::BilinearBinAlpha ||
+                texture_filter == GPUTextureFilter::JINC2BinAlpha || texture_filter == GPUTextureFilter::xBRBinAlpha);
+
+  // Adaptive filtering falls back to bilinear for minified primitives, so it's always needed.
+  if (bilinear || m_adaptive_texture_filtering)
   {
-    DefineMacro(ss, "BINALPHA", texture_filter == GPUTextureFilter::BilinearBinAlpha);
-    ss << R"(
-void FilteredSampleFromVRAM(uint4 texpage, float2 coords, float4 uv_limits,
-                            out float4 texcol, out float ialpha)
+    ss << "void " << (bilinear ? "FilteredSampleFromVRAM" : "BilinearSampleFromVRAM") << R"((
+  uint4 texpage, uint texmode, float2 coords, float4 uv_limits, out float4 texcol, out float ialpha)
 {
   // Compute the coordinates of the four texels we will be interpolating between.
   // Clamp this to the triangle texture coordinates.
@@ -162,10 +196,10 @@ void FilteredSampleFromVRAM(uint4 texpage, float2 coords, float4 uv_limits,
                         float4(0.0, 0.0, 0.0, 0.0));
 
   // Load four texels.
-  float4 s00 = SampleFromVRAM(texpage, clamp(fcoords.xy, uv_limits.xy, uv_limits.zw));
-  float4 s10 = SampleFromVRAM(texpage, clamp(fcoords.zy, uv_limits.xy, uv_limits.zw));
-  float4 s01 = SampleFromVRAM(texpage, clamp(fcoords.xw, uv_limits.xy, uv_limits.zw));
-  float4 s11 = SampleFromVRAM(texpage, clamp(fcoords.zw, uv_limits.xy, uv_limits.zw));
+  float4 s00 = SampleFromVRAM(texpage, texmode, clamp(fcoords.xy, uv_limits.xy, uv_limits.zw));
+  float4 s10 = SampleFromVRAM(texpage, texmode, clamp(fcoords.zy, uv_limits.xy, uv_limits.zw));
+  float4 s01 = SampleFromVRAM(texpage, texmode, clamp(fcoords.xw, uv_limits.xy, uv_limits.zw));
+  float4 s11 = SampleFromVRAM(texpage, texmode, clamp(fcoords.zw, uv_limits.xy, uv_limits.zw));
 
   // Compute alpha from how many texels aren't pixel color 0000h.
   float a00 = float(VECTOR_NEQ(s00, TRANSPARENT_PIXEL_COLOR));
@@ -188,9 +222,9 @@ void FilteredSampleFromVRAM(uint4 texpage, float2 coords, float4 uv_limits,
 }
 )";
   }
-  else if (texture_filter == GPUTextureFilter::JINC2 || texture_filter == GPUTextureFilter::JINC2BinAlpha)
+
+  if (texture_filter == GPUTextureFilter::JINC2 || texture_filter == GPUTextureFilter::JINC2BinAlpha)
   {
-    DefineMacro(ss, "BINALPHA", texture_filter == GPUTextureFilter::JINC2BinAlpha);
     ss << R"(
 CONSTANT float JINC2_WINDOW_SINC = 0.44;
 CONSTANT float JINC2_SINC = 0.82;
@@ -239,7 +273,7 @@ float4 resampler(float4 x)
    return res;
 }
 
-void FilteredSampleFromVRAM(uint4 texpage, float2 coords, float4 uv_limits,
+void FilteredSampleFromVRAM(uint4 texpage, uint texmode, float2 coords, float4 uv_limits,
                             out float4 texcol, out float ialpha)
 {
     float4 weights[4];
@@ -260,7 +294,7 @@ void FilteredSampleFromVRAM(uint4 texpage, float2 coords, float4 uv_limits,
     dy = dy;
     tc = tc;
 
-#define sample_texel(coords) SampleFromVRAM(texpage, clamp((coords), uv_limits.xy, uv_limits.zw))
+#define sample_texel(coords) SampleFromVRAM(texpage, texmode, clamp((coords), uv_limits.xy, uv_limits.zw))
 
     float4 c00 = sample_texel(tc    -dx    -dy);
     float a00 = float(VECTOR_NEQ(c00, TRANSPARENT_PIXEL_COLOR));
@@ -342,7 +376,6 @@ void FilteredSampleFromVRAM(uint4 texpage, float2 coords, float4 uv_limits,
   }
   else if (texture_filter == GPUTextureFilter::xBR || texture_filter == GPUTextureFilter::xBRBinAlpha)
   {
-    DefineMacro(ss, "BINALPHA", texture_filter == GPUTextureFilter::xBRBinAlpha);
     ss << R"(
 CONSTANT int BLEND_NONE = 0;
 CONSTANT int BLEND_NORMAL = 1;
@@ -383,9 +416,9 @@ float get_left_ratio(float2 center, float2 origin, float2 direction, float2 scal
   return smoothstep(-sqrt(2.0)/2.0, sqrt(2.0)/2.0, v);
 }
 
-#define P(coord, xoffs, yoffs) SampleFromVRAM(texpage, clamp(coords + float2((xoffs), (yoffs)), uv_limits.xy, uv_limits.zw))
+#define P(coord, xoffs, yoffs) SampleFromVRAM(texpage, texmode, clamp(coords + float2((xoffs), (yoffs)), uv_limits.xy, uv_limits.zw))
 
-void FilteredSampleFromVRAM(uint4 texpage, float2 coords, float4 uv_limits,
+void FilteredSampleFromVRAM(uint4 texpage, uint texmode, float2 coords, float4 uv_limits,
                             out float4 texcol, out float ialpha)
 {
   //---------------------------------------
@@ -629,10 +662,48 @@ void FilteredSampleFromVRAM(uint4 texpage, float2 coords, float4 uv_limits,
   }
 }
 
+void GPU_HW_ShaderGen::WritePaletteLookupFunction(std::stringstream& ss)
+{
+  // Shared with the palette texture decode shader, so decoded texels are exactly what the batch shaders would fetch.
+  ss << R"(
+float4 SampleFromPalette(uint4 texpage, bool palette_4bit, uint2 icoord)
+{
+  uint2 index_coord = uint2(icoord.x / (palette_4bit ? 4u : 2u), icoord.y);
+
+  // fixup coords
+  uint2 vicoord = texpage.xy + (index_coord * uint2(RESOLUTION_SCALE, RESOLUTION_SCALE));
+
+  // load colour/palette
+  float4 texel = SAMPLE_TEXTURE(samp0, float2(vicoord) * RCP_VRAM_SIZE);
+  uint vram_value = RGBA8ToRGBA5551(texel);
+
+  // apply palette
+  uint palette_index = palette_4bit ? ((vram_value >> ((icoord.x & 3u) * 4u)) & 0x0Fu) :
+                                      ((vram_value >> ((icoord.x & 1u) * 8u)) & 0xFFu);
+
+  // sample palette
+  uint2 palette_icoord = uint2(texpage.z + (palette_index * RESOLUTION_SCALE), texpage.w);
+  return SAMPLE_TEXTURE(samp0, float2(palette_icoord) * RCP_VRAM_SIZE);
+}
+)";
+}
+
 std::string GPU_HW_ShaderGen::GenerateBatchFragmentShader(GPU_HW::BatchRenderMode transparency,
                                                           GPUTextureMode texture_mode, bool dithering, bool interlacing)
 {
-  const GPUTextureMode actual_texture_mode = texture_mode & ~GPUTextureMode::RawTextureBit;
+  return GenerateBatchFragmentShader(transparency, texture_mode, dithering, interlacing, false);
+}
+
+std::string GPU_HW_ShaderGen::GenerateBatchUberFragmentShader(GPU_HW::BatchRenderMode transparency, bool textured)
+{
+  return GenerateBatchFragmentShader(transparency, textured ? GPUTextureMode::Palette4Bit : GPUTextureMode::Disabled,
+                                     false, false, true);
+}
+
+std::string GPU_HW_ShaderGen::GenerateBatchFragmentShader(GPU_HW::BatchRenderMode transparency,
+                                                          GPUTextureMode texture_mode, bool dithering, bool interlacing,
+                                                          bool uber_shader)
+{
   const bool raw_texture = (texture_mode & GPUTextureMode::RawTextureBit) == GPUTextureMode::RawTextureBit;
   const bool textured = (texture_mode != GPUTextureMode::Disabled);
   const bool use_dual_source =
@@ -646,23 +717,34 @@ std::string GPU_HW_ShaderGen::GenerateBatchFragmentShader(GPU_HW::BatchRenderMod
   DefineMacro(ss, "TRANSPARENCY_ONLY_OPAQUE", transparency == GPU_HW::BatchRenderMode::OnlyOpaque);
   DefineMacro(ss, "TRANSPARENCY_ONLY_TRANSPARENT", transparency == GPU_HW::BatchRenderMode::OnlyTransparent);
   DefineMacro(ss, "TEXTURED", textured);
-  DefineMacro(ss, "PALETTE",
-              actual_texture_mode == GPUTextureMode::Palette4Bit || actual_texture_mode == GPUTextureMode::Palette8Bit);
-  DefineMacro(ss, "PALETTE_4_BIT", actual_texture_mode == GPUTextureMode::Palette4Bit);
-  DefineMacro(ss, "PALETTE_8_BIT", actual_texture_mode == GPUTextureMode::Palette8Bit);
-  DefineMacro(ss, "RAW_TEXTURE", raw_texture);
-  DefineMacro(ss, "DITHERING", dithering);
   DefineMacro(ss, "DITHERING_SCALED", m_scaled_dithering);
-  DefineMacro(ss, "INTERLACING", interlacing);
+
+  // These are tested at runtime, and come from the uniform buffer with uber shaders.
+  auto define_flag = [&ss, uber_shader](const char* name, bool value, const char* uniform) {
+    ss << "#define " << name << " " << (uber_shader ? uniform : (value ? "true" : "false")) << "\n";
+  };
+  define_flag("TEXTURE_ENABLED", textured, "u_textured");
+  define_flag("RAW_TEXTURE", raw_texture, "u_raw_texture");
+  define_flag("DITHERING", dithering, "u_dithering");
+  define_flag("INTERLACING", interlacing, "u_interlacing");
   DefineMacro(ss, "TRUE_COLOR", m_true_color);
   DefineMacro(ss, "TEXTURE_FILTERING", m_texture_filter != GPUTextureFilter::Nearest);
+  DefineMacro(ss, "ADAPTIVE_TEXTURE_FILTERING", m_adaptive_texture_filtering);
   DefineMacro(ss, "UV_LIMITS", m_uv_limits);
   DefineMacro(ss, "USE_DUAL_SOURCE", use_dual_source);
   DefineMacro(ss, "PGXP_DEPTH", m_pgxp_depth);
+  DefineMacro(ss, "PALETTE_TEXTURE_CACHE", textured && m_palette_texture_cache);
 
   WriteCommonFunctions(ss);
   WriteBatchUniformBuffer(ss);
   DeclareTexture(ss, "samp0", 0);
+  if (textured)
+  {
+    if (m_palette_texture_cache)
+      DeclareTexture(ss, "samp1", 1);
+
+    WritePaletteLookupFunction(ss);
+  }
 
   if (m_glsl)
     ss << "CONSTANT int[16] s_dither_values = int[16]( ";
@@ -720,42 +802,29 @@ uint2 FloatToIntegerCoords(float2 coords)
   return uint2((RESOLUTION_SCALE == 1u) ? roundEven(coords) : floor(coords));
 }
 
-float4 SampleFromVRAM(uint4 texpage, float2 coords)
+float4 SampleFromVRAM(uint4 texpage, uint texmode, float2 coords)
 {
-  #if PALETTE
-    uint2 icoord = ApplyTextureWindow(FloatToIntegerCoords(coords));
-    uint2 index_coord = icoord;
-    #if PALETTE_4_BIT
-      index_coord.x /= 4u;
-    #elif PALETTE_8_BIT
-      index_coord.x /= 2u;
-    #endif
-
-    // fixup coords
-    uint2 vicoord = texpage.xy + (index_coord * uint2(RESOLUTION_SCALE, RESOLUTION_SCALE));
-
-    // load colour/palette
-    float4 texel = SAMPLE_TEXTURE(samp0, float2(vicoord) * RCP_VRAM_SIZE);
-    uint vram_value = RGBA8ToRGBA5551(texel);
-
-    // apply palette
-    #if PALETTE_4_BIT
-      uint subpixel = icoord.x & 3u;
-      uint palette_index = (vram_value >> (subpixel * 4u)) & 0x0Fu;
-    #elif PALETTE_8_BIT
-      uint subpixel = icoord.x & 1u;
-      uint palette_index = (vram_value >> (subpixel * 8u)) & 0xFFu;
-    #endif
+  #if PALETTE_TEXTURE_CACHE
+    if (texmode == 4u)
+    {
+      // Decoded palette texture, native resolution like the palette lookup below.
+      uint2 icoord = texpage.xy + ApplyTextureWindow(FloatToIntegerCoords(coords));
+      return SAMPLE_TEXTURE(samp1, float2(icoord) * RCP_PALETTE_TEXTURE_CACHE_SIZE);
+    }
+  #endif
 
-    // sample palette
-    uint2 palette_icoord = uint2(texpage.z + (palette_index * RESOLUTION_SCALE), texpage.w);
-    return SAMPLE_TEXTURE(samp0, float2(palette_icoord) * RCP_VRAM_SIZE);
-  #else
+  if (texmode < 2u)
+  {
+    // 4-bit or 8-bit palette.
+    return SampleFromPalette(texpage, texmode == 0u, ApplyTextureWindow(FloatToIntegerCoords(coords)));
+  }
+  else
+  {
     // Direct texturing. Render-to-texture effects. Use upscaled coordinates.
-    uint2 icoord = ApplyUpscaledTextureWindow(FloatToIntegerCoords(coords));    
+    uint2 icoord = ApplyUpscaledTextureWindow(FloatToIntegerCoords(coords));
     uint2 direct_icoord = texpage.xy + icoord;
     return SAMPLE_TEXTURE(samp0, float2(direct_icoord) * RCP_VRAM_SIZE);
-  #endif
+  }
 }
 
 #endif
@@ -769,21 +838,23 @@ float4 SampleFromVRAM(uint4 texpage, float2 coords)
     if (m_uv_limits)
     {
       DeclareFragmentEntryPoint(ss, 1, 1,
-                                {{"nointerpolation", "uint4 v_texpage"}, {"nointerpolation", "float4 v_uv_limits"}},
+                                {{"nointerpolation", "uint4 v_texpage"},
+                                 {"nointerpolation", "uint v_texmode"},
+                                 {"nointerpolation", "float4 v_uv_limits"}},
                                 true, use_dual_source ? 2 : 1, !m_pgxp_depth, UsingMSAA(), UsingPerSampleShading(),
                                 false, m_disable_color_perspective);
     }
     else
     {
-      DeclareFragmentEntryPoint(ss, 1, 1, {{"nointerpolation", "uint4 v_texpage"}}, true, use_dual_source ? 2 : 1,
-                                !m_pgxp_depth, UsingMSAA(), UsingPerSampleShading(), false,
-                                m_disable_color_perspective);
+      DeclareFragmentEntryPoint(ss, 1, 1, {{"nointerpolation", "uint4 v_texpage"}, {"nointerpolation", "uint v_texmode"}},
+                                true, use_dual_source ? 2 : 1, !m_pgxp_depth, UsingMSAA(), UsingPerSampleShading(),
+                                false, m_disable_color_perspective);
     }
   }
   else
   {
-    DeclareFragmentEntryPoint(ss, 1, 0, {}, true, use_dual_source ? 2 : 1, !m_pgxp_depth, UsingMSAA(),
-                              UsingPerSampleShading(), false, m_disable_color_perspective);
+    DeclareFragmentEntryPoint(ss, 1, 0, {}, true, use_dual_source ? 2 : 1, !m_pgxp_depth, UsingMSAA(), false, false,
+                              m_disable_color_perspective);
   }
 
   ss << R"(
@@ -795,40 +866,55 @@ float4 SampleFromVRAM(uint4 texpage, float2 coords)
   float ialpha;
   float oalpha;
 
-  #if INTERLACING
-    if ((uint(v_pos.y) & 1u) == u_interlaced_displayed_field)
-      discard;
+  #if TEXTURED && TEXTURE_FILTERING && ADAPTIVE_TEXTURE_FILTERING
+    // Texels covered by this pixel. Derivatives have to be taken before anything is discarded.
+    float2 texel_footprint = fwidth(v_tex0);
   #endif
 
-  #if TEXTURED
+  if (INTERLACING && (uint(v_pos.y) & 1u) == u_interlaced_displayed_field)
+    discard;
 
+  #if TEXTURED
+  if (TEXTURE_ENABLED)
+  {
     // We can't currently use upscaled coordinate for palettes because of how they're packed.
     // Not that it would be any benefit anyway, render-to-texture effects don't use palettes.
+    bool palette = (v_texmode < 2u || v_texmode == 4u);
     float2 coords = v_tex0;
-    #if PALETTE
+    if (palette)
       coords /= float2(RESOLUTION_SCALE, RESOLUTION_SCALE);
-    #endif
 
     #if UV_LIMITS
       float4 uv_limits = v_uv_limits;
-      #if !PALETTE
+      if (!palette)
+      {
         // Extend the UV range to all "upscaled" pixels. This means 1-pixel-high polygon-based 
         // framebuffer effects won't be downsampled. (e.g. Mega Man Legends 2 haze effect)
         uv_limits *= float(RESOLUTION_SCALE);
         uv_limits.zw += float(RESOLUTION_SCALE - 1u);
-      #endif
+      }
     #endif
 
     float4 texcol;
     #if TEXTURE_FILTERING
-      FilteredSampleFromVRAM(v_texpage, coords, uv_limits, texcol, ialpha);
+      #if ADAPTIVE_TEXTURE_FILTERING
+        // Minified primitives cover at least a texel per pixel, so the expensive filter can't add any detail.
+        if (palette)
+          texel_footprint /= float2(RESOLUTION_SCALE, RESOLUTION_SCALE);
+        if (max(texel_footprint.x, texel_footprint.y) >= 1.0)
+          BilinearSampleFromVRAM(v_texpage, v_texmode, coords, uv_limits, texcol, ialpha);
+        else
+          FilteredSampleFromVRAM(v_texpage, v_texmode, coords, uv_limits, texcol, ialpha);
+      #else
+        FilteredSampleFromVRAM(v_texpage, v_texmode, coords, uv_limits, texcol, ialpha);
+      #endif
       if (ialpha < 0.5)
         discard;
     #else
       #if UV_LIMITS
-        texcol = SampleFromVRAM(v_texpage, clamp(coords, uv_limits.xy, uv_limits.zw));
+        texcol = SampleFromVRAM(v_texpage, v_texmode, clamp(coords, uv_limits.xy, uv_limits.zw));
       #else
-        texcol = SampleFromVRAM(v_texpage, coords);
+        texcol = SampleFromVRAM(v_texpage, v_texmode, coords);
       #endif
       if (VECTOR_EQ(texcol, TRANSPARENT_PIXEL_COLOR))
         discard;
@@ -841,45 +927,51 @@ float4 SampleFromVRAM(uint4 texpage, float2 coords)
     // If not using true color, truncate the framebuffer colors to 5-bit.
     #if !TRUE_COLOR
       icolor = uint3(texcol.rgb * float3(255.0, 255.0, 255.0)) >> 3;
-      #if !RAW_TEXTURE
+      if (!RAW_TEXTURE)
+      {
         icolor = (icolor * vertcol) >> 4;
-        #if DITHERING
+        if (DITHERING)
           icolor = ApplyDithering(uint2(v_pos.xy), icolor);
-        #else
+        else
           icolor = min(icolor >> 3, uint3(31u, 31u, 31u));
-        #endif
-      #endif
+      }
     #else
       icolor = uint3(texcol.rgb * float3(255.0, 255.0, 255.0));
-      #if !RAW_TEXTURE
+      if (!RAW_TEXTURE)
+      {
         icolor = (icolor * vertcol) >> 7;
-        #if DITHERING
+        if (DITHERING)
           icolor = ApplyDithering(uint2(v_pos.xy), icolor);
-        #else
+        else
           icolor = min(icolor, uint3(255u, 255u, 255u));
-        #endif
-      #endif
+      }
     #endif
 
     // Compute output alpha (mask bit)
     oalpha = float(u_set_mask_while_drawing ? 1 : int(semitransparent));
-  #else
+  }
+  else
+  #endif
+  {
     // All pixels are semitransparent for untextured polygons.
     semitransparent = true;
     icolor = vertcol;
     ialpha = 1.0;
 
-    #if DITHERING
+    if (DITHERING)
+    {
       icolor = ApplyDithering(uint2(v_pos.xy), icolor);
-    #else
+    }
+    else
+    {
       #if !TRUE_COLOR
         icolor >>= 3;
       #endif
-    #endif
+    }
 
     // However, the mask bit is cleared if set mask bit is false.
     oalpha = float(u_set_mask_while_drawing);
-  #endif
+  }
 
   // Premultiply alpha so we don't need to use a colour output for it.
   float premultiply_alpha = ialpha;
@@ -1327,6 +1419,27 @@ std::string GPU_HW_ShaderGen::GenerateVRAMUpdateDepthFragmentShader()
   return ss.str();
 }
 
+std::string GPU_HW_ShaderGen::GeneratePaletteTextureDecodeFragmentShader()
+{
+  std::stringstream ss;
+  WriteHeader(ss);
+  WriteCommonFunctions(ss);
+  DeclareUniformBuffer(ss, {"uint4 u_texpage", "uint2 u_dst_offset", "bool u_palette_4bit"}, true);
+  DeclareTexture(ss, "samp0", 0);
+  WritePaletteLookupFunction(ss);
+  DeclareFragmentEntryPoint(ss, 0, 1, {}, true, 1);
+
+  ss << R"(
+{
+  // One fragment per texel of the texture page.
+  uint2 icoord = uint2(v_pos.xy) - u_dst_offset;
+  o_col0 = SampleFromPalette(u_texpage, u_palette_4bit, icoord);
+}
+)";
+
+  return ss.str();
+}
+
 std::string GPU_HW_ShaderGen::GenerateAdaptiveDownsampleMipFragmentShader(bool first_pass)
 {
   std::stringstream ss;
@@ -1443,6 +1556,92 @@ std::string GPU_HW_ShaderGen::GenerateAdaptiveDownsampleCompositeFragmentShader(
   return ss.str();
 }
 
+std::string GPU_HW_ShaderGen::GenerateAdaptiveDownsampleComputeShader()
+{
+  std::stringstream ss;
+  WriteHeader(ss);
+  WriteCommonFunctions(ss);
+  DeclareTexture(ss, "samp0", 0, false);
+  DeclareImage(ss, "out_image", 1);
+  DeclareUniformBuffer(ss, {"uint2 u_base_coords", "uint2 u_end_coords"}, true);
+
+  // Single pass version of the mip/blur/composite passes above. Each thread owns one native-resolution block of
+  // RESOLUTION_SCALE x RESOLUTION_SCALE texels. Block averages and biases for the tile plus a one block border are
+  // computed into shared memory, so the 3x3 bias blur doesn't need another pass, then each thread blends its texels
+  // towards the block average.
+  ss << R"(
+#define TILE_SIZE 8u
+#define HALO_SIZE 10u
+
+GROUP_SHARED float3 s_block_color[HALO_SIZE * HALO_SIZE];
+GROUP_SHARED float s_block_bias[HALO_SIZE * HALO_SIZE];
+
+float4 GetBlockColorAndBias(int2 block)
+{
+  int2 base_coords = int2(u_base_coords) + block * int(RESOLUTION_SCALE);
+  float3 sum = float3(0.0, 0.0, 0.0);
+  float sum_sq = 0.0;
+  for (uint offset_y = 0u; offset_y < RESOLUTION_SCALE; offset_y++)
+  {
+    for (uint offset_x = 0u; offset_x < RESOLUTION_SCALE; offset_x++)
+    {
+      float3 color = LOAD_TEXTURE(samp0, base_coords + int2(offset_x, offset_y), 0).rgb;
+      sum += color;
+      sum_sq += dot(color, color);
+    }
+  }
+
+  // Same energy measure as the fragment path, normalized to a 2x2 footprint.
+  float count = float(RESOLUTION_SCALE * RESOLUTION_SCALE);
+  float3 avg = sum / count;
+  float energy = max(sum_sq - count * dot(avg, avg), 0.0) * (4.0 / count);
+  return float4(avg, saturate(1.0 - log2(1000.0 * energy + 1.0)));
+}
+)";
+
+  DeclareComputeEntryPoint(ss, 8, 8);
+  ss << R"(
+{
+  int2 block_count = int2((u_end_coords - u_base_coords) / uint2(RESOLUTION_SCALE, RESOLUTION_SCALE));
+  int2 tile_start = int2(c_workgroup_id.xy * uint2(TILE_SIZE, TILE_SIZE)) - int2(1, 1);
+  for (uint i = c_local_id.y * TILE_SIZE + c_local_id.x; i < (HALO_SIZE * HALO_SIZE); i += (TILE_SIZE * TILE_SIZE))
+  {
+    int2 block = clamp(tile_start + int2(int(i % HALO_SIZE), int(i / HALO_SIZE)), int2(0, 0), block_count - int2(1, 1));
+    float4 color_and_bias = GetBlockColorAndBias(block);
+    s_block_color[i] = color_and_bias.rgb;
+    s_block_bias[i] = color_and_bias.a;
+  }
+
+  GROUP_MEMORY_BARRIER();
+
+  int2 block = int2(c_global_id.xy);
+  if (block.x >= block_count.x || block.y >= block_count.y)
+    return;
+
+  uint center = (c_local_id.y + 1u) * HALO_SIZE + (c_local_id.x + 1u);
+  float bias = 0.25 * s_block_bias[center];
+  bias += 0.125 * (s_block_bias[center - 1u] + s_block_bias[center + 1u] + s_block_bias[center - HALO_SIZE] +
+                   s_block_bias[center + HALO_SIZE]);
+  bias += 0.0625 * (s_block_bias[center - HALO_SIZE - 1u] + s_block_bias[center - HALO_SIZE + 1u] +
+                    s_block_bias[center + HALO_SIZE - 1u] + s_block_bias[center + HALO_SIZE + 1u]);
+
+  float3 avg = s_block_color[center];
+  int2 base_coords = int2(u_base_coords) + block * int(RESOLUTION_SCALE);
+  for (uint offset_y = 0u; offset_y < RESOLUTION_SCALE; offset_y++)
+  {
+    for (uint offset_x = 0u; offset_x < RESOLUTION_SCALE; offset_x++)
+    {
+      int2 coords = base_coords + int2(offset_x, offset_y);
+      float3 color = LOAD_TEXTURE(samp0, coords, 0).rgb;
+      STORE_IMAGE(out_image, coords, float4(lerp(color, avg, bias), 1.0));
+    }
+  }
+}
+)";
+
+  return ss.str();
+}
+
 std::string GPU_HW_ShaderGen::GenerateBoxSampleDownsampleFragmentShader()
 {
   std::stringstream ss;
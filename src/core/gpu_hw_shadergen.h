@@ -9,13 +9,15 @@ class GPU_HW_ShaderGen : public ShaderGen
 {
 public:
   GPU_HW_ShaderGen(RenderAPI render_api, u32 resolution_scale, u32 multisamples, bool per_sample_shading,
-                   bool true_color, bool scaled_dithering, GPUTextureFilter texture_filtering, bool uv_limits,
-                   bool pgxp_depth, bool disable_color_perspective, bool supports_dual_source_blend);
+                   bool true_color, bool scaled_dithering, GPUTextureFilter texture_filtering,
+                   bool adaptive_texture_filtering, bool uv_limits, bool pgxp_depth, bool disable_color_perspective,
+                   bool supports_dual_source_blend, bool palette_texture_cache);
   ~GPU_HW_ShaderGen();
 
   std::string GenerateBatchVertexShader(bool textured);
   std::string GenerateBatchFragmentShader(GPU_HW::BatchRenderMode transparency, GPUTextureMode texture_mode,
                                           bool dithering, bool interlacing);
+  std::string GenerateBatchUberFragmentShader(GPU_HW::BatchRenderMode transparency, bool textured);
   std::string GenerateDisplayFragmentShader(bool depth_24bit, GPU_HW::InterlacedRenderMode interlace_mode,
                                             bool smooth_chroma);
   std::string GenerateVRAMReadFragmentShader();
@@ -23,10 +25,12 @@ public:
   std::string GenerateVRAMCopyFragmentShader();
   std::string GenerateVRAMFillFragmentShader(bool wrapped, bool interlaced);
   std::string GenerateVRAMUpdateDepthFragmentShader();
+  std::string GeneratePaletteTextureDecodeFragmentShader();
 
   std::string GenerateAdaptiveDownsampleMipFragmentShader(bool first_pass);
   std::string GenerateAdaptiveDownsampleBlurFragmentShader();
   std::string GenerateAdaptiveDownsampleCompositeFragmentShader();
+  std::string GenerateAdaptiveDownsampleComputeShader();
   std::string GenerateBoxSampleDownsampleFragmentShader();
 
 private:
@@ -36,6 +40,10 @@ private:
   void WriteCommonFunctions(std::stringstream& ss);
   void WriteBatchUniformBuffer(std::stringstream& ss);
   void WriteBatchTextureFilter(std::stringstream& ss, GPUTextureFilter texture_filter);
+  void WritePaletteLookupFunction(std::stringstream& ss);
+
+  std::string GenerateBatchFragmentShader(GPU_HW::BatchRenderMode transparency, GPUTextureMode texture_mode,
+                                          bool dithering, bool interlacing, bool uber_shader);
 
   u32 m_resolution_scale;
   u32 m_multisamples;
@@ -43,7 +51,9 @@ private:
   bool m_true_color;
   bool m_scaled_dithering;
   GPUTextureFilter m_texture_filter;
+  bool m_adaptive_texture_filtering;
   bool m_uv_limits;
   bool m_pgxp_depth;
   bool m_disable_color_perspective;
+  bool m_palette_texture_cache;
 };
@@ -3,8 +3,12 @@
 
 #include "gpu_hw_vulkan.h"
 #include "common/assert.h"
+#include "common/byte_stream.h"
 #include "common/log.h"
+#include "common/path.h"
 #include "common/scoped_guard.h"
+#include "common/thirdparty/thread_pool.h"
+#include "common/threading.h"
 #include "common/timer.h"
 #include "common/vulkan/builders.h"
 #include "common/vulkan/context.h"
@@ -12,14 +16,25 @@
 #include "common/vulkan/util.h"
 #include "gpu_hw_shadergen.h"
 #include "host_display.h"
+#include "settings.h"
 #include "system.h"
 #include "util/state_wrapper.h"
+#include "fmt/format.h"
 Log_SetChannel(GPU_HW_Vulkan);
 
+enum : u32
+{
+  PIPELINE_USAGE_SIGNATURE = 0x55505356, // VSPU
+  PIPELINE_USAGE_VERSION = 1,
+};
+
 GPU_HW_Vulkan::GPU_HW_Vulkan() = default;
 
 GPU_HW_Vulkan::~GPU_HW_Vulkan()
 {
+  SyncRenderThread();
+  SaveBatchPipelineUsage();
+
   g_host_display->ClearDisplayTexture();
   DestroyResources();
 }
@@ -72,19 +87,22 @@ bool GPU_HW_Vulkan::Initialize()
     return false;
   }
 
+  LoadBatchPipelineUsage();
+
   if (!CompilePipelines())
   {
     Log_ErrorPrintf("Failed to compile pipelines");
     return false;
   }
 
-  UpdateDepthBufferFromMaskBit();
+  UpdateDepthBufferPagesFromMaskBit();
   RestoreGraphicsAPIState();
   return true;
 }
 
 void GPU_HW_Vulkan::Reset(bool clear_vram)
 {
+  FlushVRAMWrites();
   GPU_HW::Reset(clear_vram);
 
   EndRenderPass();
@@ -95,6 +113,9 @@ void GPU_HW_Vulkan::Reset(bool clear_vram)
 
 bool GPU_HW_Vulkan::DoState(StateWrapper& sw, GPUTexture** host_texture, bool update_display)
 {
+  SyncRenderThread();
+  FlushVRAMWrites();
+
   if (host_texture)
   {
     EndRenderPass();
@@ -165,10 +186,29 @@ bool GPU_HW_Vulkan::DoState(StateWrapper& sw, GPUTexture** host_texture, bool up
 
 void GPU_HW_Vulkan::ResetGraphicsAPIState()
 {
+  SyncRenderThread(true);
+  FlushVRAMWrites();
+
   GPU_HW::ResetGraphicsAPIState();
 
+  // A pending batch could draw over the area copied out for the speculative readback.
+  if (m_frame_readback_rect.Valid())
+    FlushRender();
+
   EndRenderPass();
 
+  // The render thread is idle here, so this is a safe point to swap in the specialized pipelines.
+  UpdateSpecializedPipelineCompile();
+
+  // Whatever the CPU read back this frame will probably be read again next frame, so copy it out while we're here
+  // and let it complete with the frame rather than stalling on it later.
+  if (m_frame_readback_rect.Valid())
+  {
+    if (!IsSpeculativeReadbackValid(m_frame_readback_rect))
+      QueueSpeculativeReadback(m_frame_readback_rect);
+    m_frame_readback_rect.SetInvalid();
+  }
+
   if (g_host_display->GetDisplayTextureHandle() == &m_vram_texture)
   {
     m_vram_texture.TransitionToLayout(g_vulkan_context->GetCurrentCommandBuffer(),
@@ -187,6 +227,7 @@ void GPU_HW_Vulkan::RestoreGraphicsAPIState()
 
   VkDeviceSize vertex_buffer_offset = 0;
   vkCmdBindVertexBuffers(cmdbuf, 0, 1, m_vertex_stream_buffer.GetBufferPointer(), &vertex_buffer_offset);
+  vkCmdBindIndexBuffer(cmdbuf, m_quad_index_buffer.GetBuffer(), 0, VK_INDEX_TYPE_UINT16);
   Vulkan::Util::SetViewport(cmdbuf, 0, 0, m_vram_texture.GetWidth(), m_vram_texture.GetHeight());
   vkCmdBindDescriptorSets(cmdbuf, VK_PIPELINE_BIND_POINT_GRAPHICS, m_batch_pipeline_layout, 0, 1,
                           &m_batch_descriptor_set, 1, &m_current_uniform_buffer_offset);
@@ -195,6 +236,13 @@ void GPU_HW_Vulkan::RestoreGraphicsAPIState()
 
 void GPU_HW_Vulkan::UpdateSettings()
 {
+  SyncRenderThread();
+  FlushVRAMWrites();
+
+  // The background compile reads the settings we're about to change. If the shaders don't change it's restarted
+  // below, and anything it already built comes straight out of the pipeline cache.
+  CancelSpecializedPipelineCompile();
+
   GPU_HW::UpdateSettings();
 
   bool framebuffer_changed, shaders_changed;
@@ -218,7 +266,19 @@ void GPU_HW_Vulkan::UpdateSettings()
   {
     // clear it since we draw a loading screen and it's not in the correct state
     DestroyPipelines();
-    CompilePipelines();
+    if (!CompilePipelines())
+      Panic("Failed to recompile pipelines");
+  }
+  else if (m_use_uber_shaders && m_shader_mode == GPUShaderMode::UberUntilSpecializedReady)
+  {
+    StartSpecializedPipelineCompile(BatchPipelineMask().set());
+  }
+  else if (!m_use_uber_shaders)
+  {
+    // A cancelled targeted compile leaves holes, which still have to be filled in.
+    const BatchPipelineMask missing = GetMissingBatchPipelines();
+    if (missing.any())
+      StartSpecializedPipelineCompile(missing);
   }
 
   // this has to be done here, because otherwise we're using destroyed pipelines in the same cmdbuffer
@@ -226,7 +286,7 @@ void GPU_HW_Vulkan::UpdateSettings()
   {
     RestoreGraphicsAPIState();
     UpdateVRAM(0, 0, VRAM_WIDTH, VRAM_HEIGHT, m_vram_ptr, false, false);
-    UpdateDepthBufferFromMaskBit();
+    UpdateDepthBufferPagesFromMaskBit();
     UpdateDisplay();
     ResetGraphicsAPIState();
   }
@@ -236,14 +296,7 @@ void GPU_HW_Vulkan::MapBatchVertexPointer(u32 required_vertices)
 {
   DebugAssert(!m_batch_start_vertex_ptr);
 
-  const u32 required_space = required_vertices * sizeof(BatchVertex);
-  if (!m_vertex_stream_buffer.ReserveMemory(required_space, sizeof(BatchVertex)))
-  {
-    Log_PerfPrintf("Executing command buffer while waiting for %u bytes in vertex stream buffer", required_space);
-    ExecuteCommandBuffer(false, true);
-    if (!m_vertex_stream_buffer.ReserveMemory(required_space, sizeof(BatchVertex)))
-      Panic("Failed to reserve vertex stream buffer memory");
-  }
+  ReserveVertexStreamBufferSpace(required_vertices * sizeof(BatchVertex));
 
   m_batch_start_vertex_ptr = reinterpret_cast<BatchVertex*>(m_vertex_stream_buffer.GetCurrentHostPointer());
   m_batch_current_vertex_ptr = m_batch_start_vertex_ptr;
@@ -251,6 +304,26 @@ void GPU_HW_Vulkan::MapBatchVertexPointer(u32 required_vertices)
   m_batch_base_vertex = m_vertex_stream_buffer.GetCurrentOffset() / sizeof(BatchVertex);
 }
 
+void GPU_HW_Vulkan::ReserveVertexStreamBufferSpace(u32 size)
+{
+  const VkBuffer old_buffer = m_vertex_stream_buffer.GetBuffer();
+  if (!m_vertex_stream_buffer.ReserveMemory(size, sizeof(BatchVertex)))
+  {
+    Log_PerfPrintf("Executing command buffer while waiting for %u bytes in vertex stream buffer", size);
+    ExecuteCommandBuffer(false, true);
+    if (!m_vertex_stream_buffer.ReserveMemory(size, sizeof(BatchVertex)))
+      Panic("Failed to reserve vertex stream buffer memory");
+  }
+
+  // grew instead of waiting for the GPU?
+  if (m_vertex_stream_buffer.GetBuffer() != old_buffer)
+  {
+    const VkDeviceSize vertex_buffer_offset = 0;
+    vkCmdBindVertexBuffers(g_vulkan_context->GetCurrentCommandBuffer(), 0, 1,
+                           m_vertex_stream_buffer.GetBufferPointer(), &vertex_buffer_offset);
+  }
+}
+
 void GPU_HW_Vulkan::UnmapBatchVertexPointer(u32 used_vertices)
 {
   DebugAssert(m_batch_start_vertex_ptr);
@@ -318,6 +391,9 @@ void GPU_HW_Vulkan::SetCapabilities()
   m_supports_dual_source_blend = g_vulkan_context->GetDeviceFeatures().dualSrcBlend;
   m_supports_per_sample_shading = g_vulkan_context->GetDeviceFeatures().sampleRateShading;
   m_supports_adaptive_downsampling = true;
+  m_supports_compute_downsampling = true;
+  m_use_quad_index_buffer = true;
+  m_use_palette_texture_cache = true;
   m_supports_disable_color_perspective = true;
 
   Log_InfoPrintf("Dual-source blend: %s", m_supports_dual_source_blend ? "supported" : "not supported");
@@ -344,17 +420,21 @@ void GPU_HW_Vulkan::DestroyResources()
   if (g_vulkan_context)
     g_vulkan_context->ExecuteCommandBuffer(true);
 
+  DestroySpeculativeReadbackBuffer();
   DestroyFramebuffer();
   DestroyPipelines();
 
   Vulkan::Util::SafeDestroyPipelineLayout(m_downsample_pipeline_layout);
   Vulkan::Util::SafeDestroyDescriptorSetLayout(m_downsample_composite_descriptor_set_layout);
   Vulkan::Util::SafeDestroyPipelineLayout(m_downsample_composite_pipeline_layout);
+  Vulkan::Util::SafeDestroyDescriptorSetLayout(m_downsample_compute_descriptor_set_layout);
+  Vulkan::Util::SafeDestroyPipelineLayout(m_downsample_compute_pipeline_layout);
 
   Vulkan::Util::SafeFreeGlobalDescriptorSet(m_vram_write_descriptor_set);
   Vulkan::Util::SafeDestroyBufferView(m_texture_stream_buffer_view);
 
   m_vertex_stream_buffer.Destroy(false);
+  m_quad_index_buffer.Destroy(false);
   m_uniform_stream_buffer.Destroy(false);
   m_texture_stream_buffer.Destroy(false);
 
@@ -408,6 +488,8 @@ void GPU_HW_Vulkan::EndRenderPass()
 
 void GPU_HW_Vulkan::ExecuteCommandBuffer(bool wait_for_completion, bool restore_state)
 {
+  // Staged writes reference stream buffer space which is released once this command buffer completes.
+  FlushVRAMWrites();
   EndRenderPass();
   g_vulkan_context->ExecuteCommandBuffer(wait_for_completion);
   m_batch_ubo_dirty = true;
@@ -423,6 +505,7 @@ bool GPU_HW_Vulkan::CreatePipelineLayouts()
   dslbuilder.AddBinding(0, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, 1,
                         VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT);
   dslbuilder.AddBinding(1, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1, VK_SHADER_STAGE_FRAGMENT_BIT);
+  dslbuilder.AddBinding(2, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1, VK_SHADER_STAGE_FRAGMENT_BIT);
   m_batch_descriptor_set_layout = dslbuilder.Create(device);
   if (m_batch_descriptor_set_layout == VK_NULL_HANDLE)
     return false;
@@ -504,6 +587,22 @@ bool GPU_HW_Vulkan::CreatePipelineLayouts()
   Vulkan::Util::SetObjectName(g_vulkan_context->GetDevice(), m_downsample_composite_pipeline_layout,
                               "Downsample Composite Pipeline Layout");
 
+  dslbuilder.AddBinding(1, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1, VK_SHADER_STAGE_COMPUTE_BIT);
+  dslbuilder.AddBinding(2, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 1, VK_SHADER_STAGE_COMPUTE_BIT);
+  m_downsample_compute_descriptor_set_layout = dslbuilder.Create(device);
+  if (m_downsample_compute_descriptor_set_layout == VK_NULL_HANDLE)
+    return false;
+  Vulkan::Util::SetObjectName(g_vulkan_context->GetDevice(), m_downsample_compute_descriptor_set_layout,
+                              "Downsample Compute Descriptor Set Layout");
+
+  plbuilder.AddDescriptorSet(m_downsample_compute_descriptor_set_layout);
+  plbuilder.AddPushConstants(VK_SHADER_STAGE_COMPUTE_BIT, 0, MAX_PUSH_CONSTANTS_SIZE);
+  m_downsample_compute_pipeline_layout = plbuilder.Create(device);
+  if (m_downsample_compute_pipeline_layout == VK_NULL_HANDLE)
+    return false;
+  Vulkan::Util::SetObjectName(g_vulkan_context->GetDevice(), m_downsample_compute_pipeline_layout,
+                              "Downsample Compute Pipeline Layout");
+
   return true;
 }
 
@@ -564,11 +663,15 @@ bool GPU_HW_Vulkan::CreateFramebuffer()
         GPU_MAX_DISPLAY_HEIGHT * m_resolution_scale, 1, 1, texture_format, VK_SAMPLE_COUNT_1_BIT, VK_IMAGE_VIEW_TYPE_2D,
         VK_IMAGE_TILING_OPTIMAL,
         VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT |
-          VK_IMAGE_USAGE_TRANSFER_DST_BIT,
+          VK_IMAGE_USAGE_TRANSFER_DST_BIT | (m_use_compute_downsampling ? VK_IMAGE_USAGE_STORAGE_BIT : 0),
         true) ||
       !m_vram_readback_texture.Create(VRAM_WIDTH, VRAM_HEIGHT, 1, 1, texture_format, VK_SAMPLE_COUNT_1_BIT,
                                       VK_IMAGE_VIEW_TYPE_2D, VK_IMAGE_TILING_OPTIMAL,
-                                      VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT, true))
+                                      VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT, true) ||
+      !m_palette_texture_cache_texture.Create(PALETTE_TEXTURE_CACHE_SIZE, PALETTE_TEXTURE_CACHE_SIZE, 1, 1,
+                                              texture_format, VK_SAMPLE_COUNT_1_BIT, VK_IMAGE_VIEW_TYPE_2D,
+                                              VK_IMAGE_TILING_OPTIMAL,
+                                              VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT, true))
   {
     return false;
   }
@@ -599,6 +702,13 @@ bool GPU_HW_Vulkan::CreateFramebuffer()
   Vulkan::Util::SetObjectName(g_vulkan_context->GetDevice(), m_vram_readback_texture.GetAllocation(),
                               "VRAM Readback Texture Memory");
 
+  Vulkan::Util::SetObjectName(g_vulkan_context->GetDevice(), m_palette_texture_cache_texture.GetImage(),
+                              "Palette Texture Cache");
+  Vulkan::Util::SetObjectName(g_vulkan_context->GetDevice(), m_palette_texture_cache_texture.GetView(),
+                              "Palette Texture Cache View");
+  Vulkan::Util::SetObjectName(g_vulkan_context->GetDevice(), m_palette_texture_cache_texture.GetAllocation(),
+                              "Palette Texture Cache Memory");
+
   m_vram_render_pass =
     g_vulkan_context->GetRenderPass(texture_format, depth_format, samples, VK_ATTACHMENT_LOAD_OP_LOAD);
   m_vram_update_depth_render_pass =
@@ -611,9 +721,13 @@ bool GPU_HW_Vulkan::CreateFramebuffer()
   m_vram_readback_render_pass =
     g_vulkan_context->GetRenderPass(m_vram_readback_texture.GetVkFormat(), VK_FORMAT_UNDEFINED,
                                     m_vram_readback_texture.GetVkSamples(), VK_ATTACHMENT_LOAD_OP_DONT_CARE);
+  m_palette_texture_decode_render_pass =
+    g_vulkan_context->GetRenderPass(m_palette_texture_cache_texture.GetVkFormat(), VK_FORMAT_UNDEFINED,
+                                    m_palette_texture_cache_texture.GetVkSamples(), VK_ATTACHMENT_LOAD_OP_LOAD);
 
   if (m_vram_render_pass == VK_NULL_HANDLE || m_vram_update_depth_render_pass == VK_NULL_HANDLE ||
-      m_display_load_render_pass == VK_NULL_HANDLE || m_vram_readback_render_pass == VK_NULL_HANDLE)
+      m_display_load_render_pass == VK_NULL_HANDLE || m_vram_readback_render_pass == VK_NULL_HANDLE ||
+      m_palette_texture_decode_render_pass == VK_NULL_HANDLE)
   {
     return false;
   }
@@ -623,6 +737,8 @@ bool GPU_HW_Vulkan::CreateFramebuffer()
                               "VRAM Update Depth Render Pass");
   Vulkan::Util::SetObjectName(g_vulkan_context->GetDevice(), m_display_load_render_pass, "Display Load Render Pass");
   Vulkan::Util::SetObjectName(g_vulkan_context->GetDevice(), m_vram_readback_render_pass, "VRAM Readback Render Pass");
+  Vulkan::Util::SetObjectName(g_vulkan_context->GetDevice(), m_palette_texture_decode_render_pass,
+                              "Palette Texture Decode Render Pass");
 
   // vram framebuffer has both colour and depth
   Vulkan::FramebufferBuilder fbb;
@@ -638,8 +754,10 @@ bool GPU_HW_Vulkan::CreateFramebuffer()
   m_vram_update_depth_framebuffer = m_vram_depth_texture.CreateFramebuffer(m_vram_update_depth_render_pass);
   m_vram_readback_framebuffer = m_vram_readback_texture.CreateFramebuffer(m_vram_readback_render_pass);
   m_display_framebuffer = m_display_texture.CreateFramebuffer(m_display_load_render_pass);
+  m_palette_texture_decode_framebuffer =
+    m_palette_texture_cache_texture.CreateFramebuffer(m_palette_texture_decode_render_pass);
   if (m_vram_update_depth_framebuffer == VK_NULL_HANDLE || m_vram_readback_framebuffer == VK_NULL_HANDLE ||
-      m_display_framebuffer == VK_NULL_HANDLE)
+      m_display_framebuffer == VK_NULL_HANDLE || m_palette_texture_decode_framebuffer == VK_NULL_HANDLE)
   {
     return false;
   }
@@ -647,6 +765,8 @@ bool GPU_HW_Vulkan::CreateFramebuffer()
                               "VRAM Update Depth Framebuffer");
   Vulkan::Util::SetObjectName(g_vulkan_context->GetDevice(), m_vram_readback_framebuffer, "VRAM Readback Framebuffer");
   Vulkan::Util::SetObjectName(g_vulkan_context->GetDevice(), m_display_framebuffer, "Display Framebuffer");
+  Vulkan::Util::SetObjectName(g_vulkan_context->GetDevice(), m_palette_texture_decode_framebuffer,
+                              "Palette Texture Decode Framebuffer");
 
   VkCommandBuffer cmdbuf = g_vulkan_context->GetCurrentCommandBuffer();
   const Vulkan::Util::DebugScope debugScope(cmdbuf, "GPU_HW_Vulkan::CreateFramebuffer");
@@ -654,6 +774,7 @@ bool GPU_HW_Vulkan::CreateFramebuffer()
   m_vram_texture.TransitionToLayout(cmdbuf, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
   m_vram_depth_texture.TransitionToLayout(cmdbuf, VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL);
   m_vram_read_texture.TransitionToLayout(cmdbuf, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+  m_palette_texture_cache_texture.TransitionToLayout(cmdbuf, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
 
   Vulkan::DescriptorSetUpdateBuilder dsubuilder;
 
@@ -671,6 +792,9 @@ bool GPU_HW_Vulkan::CreateFramebuffer()
                                       m_uniform_stream_buffer.GetBuffer(), 0, sizeof(BatchUBOData));
   dsubuilder.AddCombinedImageSamplerDescriptorWrite(m_batch_descriptor_set, 1, m_vram_read_texture.GetView(),
                                                     m_point_sampler, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+  dsubuilder.AddCombinedImageSamplerDescriptorWrite(m_batch_descriptor_set, 2,
+                                                    m_palette_texture_cache_texture.GetView(), m_point_sampler,
+                                                    VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
   dsubuilder.AddCombinedImageSamplerDescriptorWrite(m_vram_copy_descriptor_set, 1, m_vram_read_texture.GetView(),
                                                     m_point_sampler, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
   dsubuilder.AddCombinedImageSamplerDescriptorWrite(m_vram_read_descriptor_set, 1, m_vram_texture.GetView(),
@@ -679,7 +803,40 @@ bool GPU_HW_Vulkan::CreateFramebuffer()
                                                     m_point_sampler, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
   dsubuilder.Update(g_vulkan_context->GetDevice());
 
-  if (m_downsample_mode == GPUDownsampleMode::Adaptive)
+  if (m_use_compute_downsampling)
+  {
+    // Only needs to hold a copy of the display texture, the compute shader does the rest in one dispatch.
+    if (!m_downsample_texture.Create(m_display_texture.GetWidth(), m_display_texture.GetHeight(), 1, 1, texture_format,
+                                     VK_SAMPLE_COUNT_1_BIT, VK_IMAGE_VIEW_TYPE_2D, VK_IMAGE_TILING_OPTIMAL,
+                                     VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT))
+    {
+      return false;
+    }
+
+    m_downsample_texture.TransitionToLayout(cmdbuf, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+
+    for (VkDescriptorSet& ds : m_downsample_compute_descriptor_sets)
+    {
+      ds = g_vulkan_context->AllocateGlobalDescriptorSet(m_downsample_compute_descriptor_set_layout);
+      if (ds == VK_NULL_HANDLE)
+        return false;
+
+      dsubuilder.AddStorageImageDescriptorWrite(ds, 2, m_display_texture.GetView());
+    }
+
+    // VRAM can only be read directly when it's not multisampled, otherwise it goes through the display texture.
+    if (!IsUsingMultisampling())
+    {
+      dsubuilder.AddCombinedImageSamplerDescriptorWrite(m_downsample_compute_descriptor_sets[0], 1,
+                                                        m_vram_texture.GetView(), m_point_sampler,
+                                                        VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+    }
+    dsubuilder.AddCombinedImageSamplerDescriptorWrite(m_downsample_compute_descriptor_sets[1], 1,
+                                                      m_downsample_texture.GetView(), m_point_sampler,
+                                                      VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+    dsubuilder.Update(g_vulkan_context->GetDevice());
+  }
+  else if (m_downsample_mode == GPUDownsampleMode::Adaptive)
   {
     const u32 levels = GetAdaptiveDownsamplingMipLevels();
 
@@ -780,6 +937,7 @@ bool GPU_HW_Vulkan::CreateFramebuffer()
 
   ClearDisplay();
   SetFullVRAMDirtyRectangle();
+  InvalidatePaletteTextureCache();
   return true;
 }
 
@@ -808,6 +966,8 @@ void GPU_HW_Vulkan::ClearFramebuffer()
 void GPU_HW_Vulkan::DestroyFramebuffer()
 {
   Vulkan::Util::SafeFreeGlobalDescriptorSet(m_downsample_composite_descriptor_set);
+  for (VkDescriptorSet& ds : m_downsample_compute_descriptor_sets)
+    Vulkan::Util::SafeFreeGlobalDescriptorSet(ds);
 
   for (SmoothMipView& mv : m_downsample_mip_views)
   {
@@ -829,7 +989,9 @@ void GPU_HW_Vulkan::DestroyFramebuffer()
   Vulkan::Util::SafeDestroyFramebuffer(m_vram_update_depth_framebuffer);
   Vulkan::Util::SafeDestroyFramebuffer(m_vram_readback_framebuffer);
   Vulkan::Util::SafeDestroyFramebuffer(m_display_framebuffer);
+  Vulkan::Util::SafeDestroyFramebuffer(m_palette_texture_decode_framebuffer);
 
+  m_palette_texture_cache_texture.Destroy(false);
   m_vram_read_texture.Destroy(false);
   m_vram_depth_texture.Destroy(false);
   m_vram_texture.Destroy(false);
@@ -839,13 +1001,34 @@ void GPU_HW_Vulkan::DestroyFramebuffer()
 
 bool GPU_HW_Vulkan::CreateVertexBuffer()
 {
-  if (!m_vertex_stream_buffer.Create(VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, VERTEX_BUFFER_SIZE))
+  // The vertex buffer is bound directly, so it can grow if heavy scenes would otherwise wait on the GPU.
+  if (!m_vertex_stream_buffer.Create(VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, VERTEX_BUFFER_SIZE, MAX_VERTEX_BUFFER_SIZE))
     return false;
 
   Vulkan::Util::SetObjectName(g_vulkan_context->GetDevice(), m_vertex_stream_buffer.GetBuffer(),
                               "Vertex Stream Buffer");
   Vulkan::Util::SetObjectName(g_vulkan_context->GetDevice(), m_vertex_stream_buffer.GetAllocation(),
                               "Vertex Stream Buffer Memory");
+
+  // The quad indices never change, so they're written once and the buffer is never reserved from again.
+  if (!m_quad_index_buffer.Create(VK_BUFFER_USAGE_INDEX_BUFFER_BIT, QUAD_INDEX_BUFFER_SIZE) ||
+      !m_quad_index_buffer.ReserveMemory(QUAD_INDEX_BUFFER_SIZE, sizeof(u16)))
+  {
+    return false;
+  }
+
+  u16* indices = reinterpret_cast<u16*>(m_quad_index_buffer.GetCurrentHostPointer());
+  for (u32 base = 0; base < MAX_INDEXED_BATCH_VERTEX_COUNT; base += 4)
+  {
+    *(indices++) = static_cast<u16>(base + 0);
+    *(indices++) = static_cast<u16>(base + 1);
+    *(indices++) = static_cast<u16>(base + 2);
+    *(indices++) = static_cast<u16>(base + 2);
+    *(indices++) = static_cast<u16>(base + 1);
+    *(indices++) = static_cast<u16>(base + 3);
+  }
+  m_quad_index_buffer.CommitMemory(QUAD_INDEX_BUFFER_SIZE);
+  Vulkan::Util::SetObjectName(g_vulkan_context->GetDevice(), m_quad_index_buffer.GetBuffer(), "Quad Index Buffer");
   return true;
 }
 
@@ -909,156 +1092,81 @@ bool GPU_HW_Vulkan::CreateTextureBuffer()
   return true;
 }
 
+bool GPU_HW_Vulkan::CreateSpeculativeReadbackBuffer()
+{
+  // Large enough for the whole of VRAM, since the encoded readback is the same size as the 16-bit source.
+  const VkBufferCreateInfo bci = {VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
+                                  nullptr,
+                                  0u,
+                                  VRAM_WIDTH * VRAM_HEIGHT * sizeof(u16),
+                                  VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                                  VK_SHARING_MODE_EXCLUSIVE,
+                                  0u,
+                                  nullptr};
+
+  VmaAllocationCreateInfo aci = {};
+  aci.usage = VMA_MEMORY_USAGE_GPU_TO_CPU;
+  aci.flags = VMA_ALLOCATION_CREATE_MAPPED_BIT;
+  aci.preferredFlags = VK_MEMORY_PROPERTY_HOST_CACHED_BIT;
+
+  VmaAllocationInfo ai = {};
+  VkResult res = vmaCreateBuffer(g_vulkan_context->GetAllocator(), &bci, &aci, &m_speculative_readback_buffer,
+                                 &m_speculative_readback_allocation, &ai);
+  if (res != VK_SUCCESS)
+  {
+    LOG_VULKAN_ERROR(res, "vmaCreateBuffer() failed: ");
+    return false;
+  }
+
+  m_speculative_readback_map = static_cast<const u8*>(ai.pMappedData);
+  Vulkan::Util::SetObjectName(g_vulkan_context->GetDevice(), m_speculative_readback_buffer,
+                              "Speculative Readback Buffer");
+  return true;
+}
+
+void GPU_HW_Vulkan::DestroySpeculativeReadbackBuffer()
+{
+  m_speculative_readback_rect.SetInvalid();
+  if (m_speculative_readback_buffer == VK_NULL_HANDLE)
+    return;
+
+  // unmapped as part of the buffer destroy
+  vmaDestroyBuffer(g_vulkan_context->GetAllocator(), m_speculative_readback_buffer, m_speculative_readback_allocation);
+  m_speculative_readback_buffer = VK_NULL_HANDLE;
+  m_speculative_readback_allocation = VK_NULL_HANDLE;
+  m_speculative_readback_map = nullptr;
+}
+
 bool GPU_HW_Vulkan::CompilePipelines()
 {
   VkDevice device = g_vulkan_context->GetDevice();
   VkPipelineCache pipeline_cache = g_vulkan_shader_cache->GetPipelineCache();
 
   GPU_HW_ShaderGen shadergen(g_host_display->GetRenderAPI(), m_resolution_scale, m_multisamples, m_per_sample_shading,
-                             m_true_color, m_scaled_dithering, m_texture_filtering, m_using_uv_limits,
-                             m_pgxp_depth_buffer, m_disable_color_perspective, m_supports_dual_source_blend);
+                             m_true_color, m_scaled_dithering, m_texture_filtering, m_adaptive_texture_filtering,
+                             m_using_uv_limits, m_pgxp_depth_buffer, m_disable_color_perspective,
+                             m_supports_dual_source_blend, m_use_palette_texture_cache);
 
   ShaderCompileProgressTracker progress("Compiling Pipelines", 2 + (4 * 9 * 2 * 2) + (3 * 4 * 5 * 9 * 2 * 2) + 1 + 2 +
-                                                                 (2 * 2) + 2 + 1 + 1 + (2 * 3) + 1);
-
-  // vertex shaders - [textured]
-  // fragment shaders - [render_mode][texture_mode][dithering][interlacing]
-  DimensionalArray<VkShaderModule, 2> batch_vertex_shaders{};
-  DimensionalArray<VkShaderModule, 2, 2, 9, 4> batch_fragment_shaders{};
-  ScopedGuard batch_shader_guard([&batch_vertex_shaders, &batch_fragment_shaders]() {
-    batch_vertex_shaders.enumerate(Vulkan::Util::SafeDestroyShaderModule);
-    batch_fragment_shaders.enumerate(Vulkan::Util::SafeDestroyShaderModule);
-  });
-
-  for (u8 textured = 0; textured < 2; textured++)
-  {
-    const std::string vs = shadergen.GenerateBatchVertexShader(ConvertToBoolUnchecked(textured));
-    VkShaderModule shader = g_vulkan_shader_cache->GetVertexShader(vs);
-    if (shader == VK_NULL_HANDLE)
-      return false;
-
-    batch_vertex_shaders[textured] = shader;
-    progress.Increment();
-  }
+                                                                 (2 * 2) + 2 + 1 + 1 + 1 + (2 * 3) + 1);
 
-  for (u8 render_mode = 0; render_mode < 4; render_mode++)
   {
-    for (u8 texture_mode = 0; texture_mode < 9; texture_mode++)
+    // If we know which specialized pipelines this game uses, only those are needed before the first frame.
+    const bool targeted = (!m_use_uber_shaders && m_used_batch_pipelines.any());
+    const BatchPipelineMask mask = targeted ? m_used_batch_pipelines : BatchPipelineMask().set();
+    if (targeted)
     {
-      for (u8 dithering = 0; dithering < 2; dithering++)
-      {
-        for (u8 interlacing = 0; interlacing < 2; interlacing++)
-        {
-          const std::string fs = shadergen.GenerateBatchFragmentShader(
-            static_cast<BatchRenderMode>(render_mode), static_cast<GPUTextureMode>(texture_mode),
-            ConvertToBoolUnchecked(dithering), ConvertToBoolUnchecked(interlacing));
-
-          VkShaderModule shader = g_vulkan_shader_cache->GetFragmentShader(fs);
-          if (shader == VK_NULL_HANDLE)
-            return false;
-
-          batch_fragment_shaders[render_mode][texture_mode][dithering][interlacing] = shader;
-          progress.Increment();
-        }
-      }
+      Log_InfoPrintf("Compiling %zu of %u batch pipelines used by this game", mask.count(),
+                     static_cast<u32>(NUM_BATCH_PIPELINES));
     }
-  }
-
-  Vulkan::GraphicsPipelineBuilder gpbuilder;
-
-  // [depth_test][render_mode][texture_mode][transparency_mode][dithering][interlacing]
-  for (u8 depth_test = 0; depth_test < 3; depth_test++)
-  {
-    for (u8 render_mode = 0; render_mode < 4; render_mode++)
-    {
-      for (u8 transparency_mode = 0; transparency_mode < 5; transparency_mode++)
-      {
-        for (u8 texture_mode = 0; texture_mode < 9; texture_mode++)
-        {
-          for (u8 dithering = 0; dithering < 2; dithering++)
-          {
-            for (u8 interlacing = 0; interlacing < 2; interlacing++)
-            {
-              static constexpr std::array<VkCompareOp, 3> depth_test_values = {
-                VK_COMPARE_OP_ALWAYS, VK_COMPARE_OP_GREATER_OR_EQUAL, VK_COMPARE_OP_LESS_OR_EQUAL};
-              const bool textured = (static_cast<GPUTextureMode>(texture_mode) != GPUTextureMode::Disabled);
-
-              gpbuilder.SetPipelineLayout(m_batch_pipeline_layout);
-              gpbuilder.SetRenderPass(m_vram_render_pass, 0);
-
-              gpbuilder.AddVertexBuffer(0, sizeof(BatchVertex), VK_VERTEX_INPUT_RATE_VERTEX);
-              gpbuilder.AddVertexAttribute(0, 0, VK_FORMAT_R32G32B32A32_SFLOAT, offsetof(BatchVertex, x));
-              gpbuilder.AddVertexAttribute(1, 0, VK_FORMAT_R8G8B8A8_UNORM, offsetof(BatchVertex, color));
-              if (textured)
-              {
-                gpbuilder.AddVertexAttribute(2, 0, VK_FORMAT_R32_UINT, offsetof(BatchVertex, u));
-                gpbuilder.AddVertexAttribute(3, 0, VK_FORMAT_R32_UINT, offsetof(BatchVertex, texpage));
-                if (m_using_uv_limits)
-                  gpbuilder.AddVertexAttribute(4, 0, VK_FORMAT_R8G8B8A8_UNORM, offsetof(BatchVertex, uv_limits));
-              }
-
-              gpbuilder.SetPrimitiveTopology(VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST);
-              gpbuilder.SetVertexShader(batch_vertex_shaders[BoolToUInt8(textured)]);
-              gpbuilder.SetFragmentShader(batch_fragment_shaders[render_mode][texture_mode][dithering][interlacing]);
-
-              gpbuilder.SetRasterizationState(VK_POLYGON_MODE_FILL, VK_CULL_MODE_NONE, VK_FRONT_FACE_CLOCKWISE);
-              gpbuilder.SetDepthState(true, true, depth_test_values[depth_test]);
-              gpbuilder.SetNoBlendingState();
-              gpbuilder.SetMultisamples(m_multisamples, m_per_sample_shading);
 
-              if ((static_cast<GPUTransparencyMode>(transparency_mode) != GPUTransparencyMode::Disabled &&
-                   (static_cast<BatchRenderMode>(render_mode) != BatchRenderMode::TransparencyDisabled &&
-                    static_cast<BatchRenderMode>(render_mode) != BatchRenderMode::OnlyOpaque)) ||
-                  m_texture_filtering != GPUTextureFilter::Nearest)
-              {
-                if (m_supports_dual_source_blend)
-                {
-                  gpbuilder.SetBlendAttachment(
-                    0, true, VK_BLEND_FACTOR_ONE, VK_BLEND_FACTOR_SRC1_ALPHA,
-                    (static_cast<GPUTransparencyMode>(transparency_mode) ==
-                       GPUTransparencyMode::BackgroundMinusForeground &&
-                     static_cast<BatchRenderMode>(render_mode) != BatchRenderMode::TransparencyDisabled &&
-                     static_cast<BatchRenderMode>(render_mode) != BatchRenderMode::OnlyOpaque) ?
-                      VK_BLEND_OP_REVERSE_SUBTRACT :
-                      VK_BLEND_OP_ADD,
-                    VK_BLEND_FACTOR_ONE, VK_BLEND_FACTOR_ZERO, VK_BLEND_OP_ADD);
-                }
-                else
-                {
-                  const float factor = (static_cast<GPUTransparencyMode>(transparency_mode) ==
-                                        GPUTransparencyMode::HalfBackgroundPlusHalfForeground) ?
-                                         0.5f :
-                                         1.0f;
-                  gpbuilder.SetBlendAttachment(
-                    0, true, VK_BLEND_FACTOR_ONE, VK_BLEND_FACTOR_CONSTANT_ALPHA,
-                    (static_cast<GPUTransparencyMode>(transparency_mode) ==
-                       GPUTransparencyMode::BackgroundMinusForeground &&
-                     static_cast<BatchRenderMode>(render_mode) != BatchRenderMode::TransparencyDisabled &&
-                     static_cast<BatchRenderMode>(render_mode) != BatchRenderMode::OnlyOpaque) ?
-                      VK_BLEND_OP_REVERSE_SUBTRACT :
-                      VK_BLEND_OP_ADD,
-                    VK_BLEND_FACTOR_ONE, VK_BLEND_FACTOR_ZERO, VK_BLEND_OP_ADD);
-                  gpbuilder.SetBlendConstants(0.0f, 0.0f, 0.0f, factor);
-                }
-              }
-
-              gpbuilder.SetDynamicViewportAndScissorState();
-
-              VkPipeline pipeline = gpbuilder.Create(device, pipeline_cache);
-              if (pipeline == VK_NULL_HANDLE)
-                return false;
-
-              m_batch_pipelines[depth_test][render_mode][texture_mode][transparency_mode][dithering][interlacing] =
-                pipeline;
-              progress.Increment();
-            }
-          }
-        }
-      }
-    }
+    // The batch shaders and pipelines are the vast majority of the work, so spread them across all cores.
+    cb::ThreadPool pool(static_cast<int>(cb::ThreadPool::GetNumLogicalCores()));
+    if (!CompileBatchPipelines(shadergen, m_use_uber_shaders, pool, mask, m_batch_pipelines, &progress, nullptr))
+      return false;
   }
 
-  batch_shader_guard.Run();
+  Vulkan::GraphicsPipelineBuilder gpbuilder;
 
   VkShaderModule fullscreen_quad_vertex_shader =
     g_vulkan_shader_cache->GetVertexShader(shadergen.GenerateScreenQuadVertexShader());
@@ -1213,6 +1321,34 @@ bool GPU_HW_Vulkan::CompilePipelines()
 
   gpbuilder.Clear();
 
+  // Palette texture decode
+  {
+    VkShaderModule fs =
+      g_vulkan_shader_cache->GetFragmentShader(shadergen.GeneratePaletteTextureDecodeFragmentShader());
+    if (fs == VK_NULL_HANDLE)
+      return false;
+
+    gpbuilder.SetRenderPass(m_palette_texture_decode_render_pass, 0);
+    gpbuilder.SetPipelineLayout(m_single_sampler_pipeline_layout);
+    gpbuilder.SetVertexShader(fullscreen_quad_vertex_shader);
+    gpbuilder.SetFragmentShader(fs);
+    gpbuilder.SetNoCullRasterizationState();
+    gpbuilder.SetNoDepthTestState();
+    gpbuilder.SetNoBlendingState();
+    gpbuilder.SetDynamicViewportAndScissorState();
+
+    m_palette_texture_decode_pipeline = gpbuilder.Create(device, pipeline_cache, false);
+    vkDestroyShaderModule(device, fs, nullptr);
+    if (m_palette_texture_decode_pipeline == VK_NULL_HANDLE)
+      return false;
+    Vulkan::Util::SetObjectName(g_vulkan_context->GetDevice(), m_palette_texture_decode_pipeline,
+                                "Palette Texture Decode Pipeline");
+
+    progress.Increment();
+  }
+
+  gpbuilder.Clear();
+
   // Display
   {
     gpbuilder.SetRenderPass(m_display_load_render_pass, 0);
@@ -1244,7 +1380,25 @@ bool GPU_HW_Vulkan::CompilePipelines()
     }
   }
 
-  if (m_downsample_mode == GPUDownsampleMode::Adaptive)
+  if (m_use_compute_downsampling)
+  {
+    VkShaderModule cs =
+      g_vulkan_shader_cache->GetComputeShader(shadergen.GenerateAdaptiveDownsampleComputeShader());
+    if (cs == VK_NULL_HANDLE)
+      return false;
+
+    Vulkan::ComputePipelineBuilder cpbuilder;
+    cpbuilder.SetShader(cs);
+    cpbuilder.SetPipelineLayout(m_downsample_compute_pipeline_layout);
+    m_downsample_compute_pipeline = cpbuilder.Create(device, pipeline_cache, false);
+    vkDestroyShaderModule(device, cs, nullptr);
+    if (m_downsample_compute_pipeline == VK_NULL_HANDLE)
+      return false;
+
+    Vulkan::Util::SetObjectName(g_vulkan_context->GetDevice(), m_downsample_compute_pipeline,
+                                "Downsample Compute Pipeline");
+  }
+  else if (m_downsample_mode == GPUDownsampleMode::Adaptive)
   {
     gpbuilder.Clear();
     gpbuilder.SetRenderPass(m_downsample_render_pass, 0);
@@ -1337,62 +1491,660 @@ bool GPU_HW_Vulkan::CompilePipelines()
 
 #undef UPDATE_PROGRESS
 
+  // Write the cache out now rather than on shutdown, so the next boot is warm even without a clean exit.
+  g_vulkan_shader_cache->FlushPipelineCache();
+
+  if (m_use_uber_shaders && m_shader_mode == GPUShaderMode::UberUntilSpecializedReady)
+  {
+    StartSpecializedPipelineCompile(BatchPipelineMask().set());
+  }
+  else if (!m_use_uber_shaders)
+  {
+    const BatchPipelineMask missing = GetMissingBatchPipelines();
+    if (missing.any())
+      StartSpecializedPipelineCompile(missing);
+  }
+
   return true;
 }
 
-void GPU_HW_Vulkan::DestroyPipelines()
+bool GPU_HW_Vulkan::CompileBatchPipelines(GPU_HW_ShaderGen& shadergen, bool uber_shaders, cb::ThreadPool& pool,
+                                          const BatchPipelineMask& mask, BatchPipelineArray& pipelines,
+                                          ShaderCompileProgressTracker* progress, const std::atomic_bool* cancel)
 {
-  m_batch_pipelines.enumerate(Vulkan::Util::SafeDestroyPipeline);
+  // Only build the fragment shaders which at least one of the requested pipelines needs.
+  const auto is_fragment_shader_needed = [&mask](u8 render_mode, u8 texture_mode, u8 dithering, u8 interlacing) {
+    for (u8 depth_test = 0; depth_test < 3; depth_test++)
+    {
+      for (u8 transparency_mode = 0; transparency_mode < 5; transparency_mode++)
+      {
+        if (mask.test(GetBatchPipelineIndex(depth_test, render_mode, texture_mode, transparency_mode, dithering,
+                                            interlacing)))
+        {
+          return true;
+        }
+      }
+    }
 
-  m_vram_fill_pipelines.enumerate(Vulkan::Util::SafeDestroyPipeline);
+    return false;
+  };
 
-  for (VkPipeline& p : m_vram_write_pipelines)
-    Vulkan::Util::SafeDestroyPipeline(p);
+  // vertex shaders - [textured]
+  // fragment shaders - [render_mode][texture_mode][dithering][interlacing]
+  DimensionalArray<VkShaderModule, 2> batch_vertex_shaders{};
+  DimensionalArray<VkShaderModule, 2, 2, 9, 4> batch_fragment_shaders{};
+  ScopedGuard batch_shader_guard([&batch_vertex_shaders, &batch_fragment_shaders]() {
+    batch_vertex_shaders.enumerate(Vulkan::Util::SafeDestroyShaderModule);
+    batch_fragment_shaders.enumerate(Vulkan::Util::SafeDestroyShaderModule);
+  });
 
-  for (VkPipeline& p : m_vram_copy_pipelines)
-    Vulkan::Util::SafeDestroyPipeline(p);
+  for (u8 textured = 0; textured < 2; textured++)
+  {
+    const std::string vs = shadergen.GenerateBatchVertexShader(ConvertToBoolUnchecked(textured));
+    VkShaderModule shader = g_vulkan_shader_cache->GetVertexShader(vs);
+    if (shader == VK_NULL_HANDLE)
+      return false;
 
-  Vulkan::Util::SafeDestroyPipeline(m_vram_readback_pipeline);
-  Vulkan::Util::SafeDestroyPipeline(m_vram_update_depth_pipeline);
+    batch_vertex_shaders[textured] = shader;
+    if (progress)
+      progress->Increment();
+  }
 
-  Vulkan::Util::SafeDestroyPipeline(m_downsample_first_pass_pipeline);
-  Vulkan::Util::SafeDestroyPipeline(m_downsample_mid_pass_pipeline);
-  Vulkan::Util::SafeDestroyPipeline(m_downsample_blur_pass_pipeline);
-  Vulkan::Util::SafeDestroyPipeline(m_downsample_composite_pass_pipeline);
+  // Results are collected in submission order on this thread, which keeps the progress display here too.
+  bool batch_failed = false;
 
-  m_display_pipelines.enumerate(Vulkan::Util::SafeDestroyPipeline);
-}
+  DimensionalArray<std::future<VkShaderModule>, 2, 2, 9, 4> batch_fragment_shader_futures;
+  for (u8 render_mode = 0; render_mode < 4; render_mode++)
+  {
+    for (u8 texture_mode = 0; texture_mode < 9; texture_mode++)
+    {
+      for (u8 dithering = 0; dithering < 2; dithering++)
+      {
+        for (u8 interlacing = 0; interlacing < 2; interlacing++)
+        {
+          if (!IsBatchShaderVariantUsed(uber_shaders, static_cast<GPUTextureMode>(texture_mode),
+                                        ConvertToBoolUnchecked(dithering), ConvertToBoolUnchecked(interlacing)) ||
+              !is_fragment_shader_needed(render_mode, texture_mode, dithering, interlacing))
+          {
+            continue;
+          }
 
-void GPU_HW_Vulkan::DrawBatchVertices(BatchRenderMode render_mode, u32 base_vertex, u32 num_vertices)
-{
-  BeginVRAMRenderPass();
+          std::string fs =
+            uber_shaders ?
+              shadergen.GenerateBatchUberFragmentShader(
+                static_cast<BatchRenderMode>(render_mode),
+                static_cast<GPUTextureMode>(texture_mode) != GPUTextureMode::Disabled) :
+              shadergen.GenerateBatchFragmentShader(
+                static_cast<BatchRenderMode>(render_mode), static_cast<GPUTextureMode>(texture_mode),
+                ConvertToBoolUnchecked(dithering), ConvertToBoolUnchecked(interlacing));
+
+          batch_fragment_shader_futures[render_mode][texture_mode][dithering][interlacing] =
+            pool.ScheduleAndGetFuture([cancel, fs = std::move(fs)]() {
+              if (cancel && cancel->load(std::memory_order_relaxed))
+                return static_cast<VkShaderModule>(VK_NULL_HANDLE);
+
+              return g_vulkan_shader_cache->GetFragmentShader(fs);
+            });
+        }
+      }
+    }
+  }
 
-  VkCommandBuffer cmdbuf = g_vulkan_context->GetCurrentCommandBuffer();
-  const Vulkan::Util::DebugScope debugScope(cmdbuf, "GPU_HW_Vulkan::DrawBatchVertices: [%u,%u)", base_vertex,
-                                            base_vertex + num_vertices);
+  for (u8 render_mode = 0; render_mode < 4; render_mode++)
+  {
+    for (u8 texture_mode = 0; texture_mode < 9; texture_mode++)
+    {
+      for (u8 dithering = 0; dithering < 2; dithering++)
+      {
+        for (u8 interlacing = 0; interlacing < 2; interlacing++)
+        {
+          std::future<VkShaderModule>& future =
+            batch_fragment_shader_futures[render_mode][texture_mode][dithering][interlacing];
+          if (future.valid())
+          {
+            VkShaderModule shader = future.get();
+            batch_fragment_shaders[render_mode][texture_mode][dithering][interlacing] = shader;
+            batch_failed |= (shader == VK_NULL_HANDLE);
+          }
 
-  // [depth_test][render_mode][texture_mode][transparency_mode][dithering][interlacing]
-  const u8 depth_test = m_batch.use_depth_buffer ? static_cast<u8>(2) : BoolToUInt8(m_batch.check_mask_before_draw);
-  VkPipeline pipeline =
-    m_batch_pipelines[depth_test][static_cast<u8>(render_mode)][static_cast<u8>(m_batch.texture_mode)][static_cast<u8>(
-      m_batch.transparency_mode)][BoolToUInt8(m_batch.dithering)][BoolToUInt8(m_batch.interlacing)];
+          if (progress)
+            progress->Increment();
+        }
+      }
+    }
+  }
 
-  vkCmdBindPipeline(cmdbuf, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
-  vkCmdDraw(cmdbuf, num_vertices, 1, base_vertex, 0);
-}
+  if (batch_failed)
+    return false;
 
-void GPU_HW_Vulkan::SetScissorFromDrawingArea()
-{
-  int left, top, right, bottom;
-  CalcScissorRect(&left, &top, &right, &bottom);
-  const Vulkan::Util::DebugScope debugScope(g_vulkan_context->GetCurrentCommandBuffer(),
-                                            "GPU_HW_Vulkan::SetScissorFromDrawingArea: {%u,%u} {%u,%u}", left, top,
+  auto create_batch_pipeline = [this, cancel, &batch_vertex_shaders, &batch_fragment_shaders](
+                                 u8 depth_test, u8 render_mode, u8 transparency_mode, u8 texture_mode, u8 dithering,
+                                 u8 interlacing) {
+    if (cancel && cancel->load(std::memory_order_relaxed))
+      return static_cast<VkPipeline>(VK_NULL_HANDLE);
+
+    const bool textured = (static_cast<GPUTextureMode>(texture_mode) != GPUTextureMode::Disabled);
+    return CreateBatchPipeline(batch_vertex_shaders[BoolToUInt8(textured)],
+                               batch_fragment_shaders[render_mode][texture_mode][dithering][interlacing], depth_test,
+                               render_mode, texture_mode, transparency_mode);
+  };
+
+  // [depth_test][render_mode][texture_mode][transparency_mode][dithering][interlacing]
+  DimensionalArray<std::future<VkPipeline>, 2, 2, 5, 9, 4, 3> batch_pipeline_futures;
+  for (u8 depth_test = 0; depth_test < 3; depth_test++)
+  {
+    for (u8 render_mode = 0; render_mode < 4; render_mode++)
+    {
+      for (u8 transparency_mode = 0; transparency_mode < 5; transparency_mode++)
+      {
+        for (u8 texture_mode = 0; texture_mode < 9; texture_mode++)
+        {
+          for (u8 dithering = 0; dithering < 2; dithering++)
+          {
+            for (u8 interlacing = 0; interlacing < 2; interlacing++)
+            {
+              if (!IsBatchShaderVariantUsed(uber_shaders, static_cast<GPUTextureMode>(texture_mode),
+                                            ConvertToBoolUnchecked(dithering), ConvertToBoolUnchecked(interlacing)) ||
+                  !mask.test(GetBatchPipelineIndex(depth_test, render_mode, texture_mode, transparency_mode,
+                                                   dithering, interlacing)))
+              {
+                continue;
+              }
+
+              batch_pipeline_futures[depth_test][render_mode][texture_mode][transparency_mode][dithering][interlacing] =
+                pool.ScheduleAndGetFuture(create_batch_pipeline, depth_test, render_mode, transparency_mode,
+                                          texture_mode, dithering, interlacing);
+            }
+          }
+        }
+      }
+    }
+  }
+
+  // Wait for every pipeline even on failure, so none are leaked.
+  for (u8 depth_test = 0; depth_test < 3; depth_test++)
+  {
+    for (u8 render_mode = 0; render_mode < 4; render_mode++)
+    {
+      for (u8 transparency_mode = 0; transparency_mode < 5; transparency_mode++)
+      {
+        for (u8 texture_mode = 0; texture_mode < 9; texture_mode++)
+        {
+          for (u8 dithering = 0; dithering < 2; dithering++)
+          {
+            for (u8 interlacing = 0; interlacing < 2; interlacing++)
+            {
+              std::future<VkPipeline>& future =
+                batch_pipeline_futures[depth_test][render_mode][texture_mode][transparency_mode][dithering]
+                                      [interlacing];
+              if (future.valid())
+              {
+                VkPipeline pipeline = future.get();
+                pipelines[depth_test][render_mode][texture_mode][transparency_mode][dithering][interlacing] = pipeline;
+                batch_failed |= (pipeline == VK_NULL_HANDLE);
+              }
+
+              if (progress)
+                progress->Increment();
+            }
+          }
+        }
+      }
+    }
+  }
+
+  return !batch_failed;
+}
+
+VkPipeline GPU_HW_Vulkan::CreateBatchPipeline(VkShaderModule vertex_shader, VkShaderModule fragment_shader,
+                                              u8 depth_test, u8 render_mode, u8 texture_mode, u8 transparency_mode)
+{
+  Vulkan::GraphicsPipelineBuilder gpbuilder;
+
+  static constexpr std::array<VkCompareOp, 3> depth_test_values = {
+    VK_COMPARE_OP_ALWAYS, VK_COMPARE_OP_GREATER_OR_EQUAL, VK_COMPARE_OP_LESS_OR_EQUAL};
+  const bool textured = (static_cast<GPUTextureMode>(texture_mode) != GPUTextureMode::Disabled);
+
+  gpbuilder.SetPipelineLayout(m_batch_pipeline_layout);
+  gpbuilder.SetRenderPass(m_vram_render_pass, 0);
+
+  gpbuilder.AddVertexBuffer(0, sizeof(BatchVertex), VK_VERTEX_INPUT_RATE_VERTEX);
+  gpbuilder.AddVertexAttribute(0, 0, VK_FORMAT_R32G32B32A32_SFLOAT, offsetof(BatchVertex, x));
+  gpbuilder.AddVertexAttribute(1, 0, VK_FORMAT_R8G8B8A8_UNORM, offsetof(BatchVertex, color));
+  if (textured)
+  {
+    gpbuilder.AddVertexAttribute(2, 0, VK_FORMAT_R32_UINT, offsetof(BatchVertex, u));
+    gpbuilder.AddVertexAttribute(3, 0, VK_FORMAT_R32_UINT, offsetof(BatchVertex, texpage));
+    if (m_using_uv_limits)
+      gpbuilder.AddVertexAttribute(4, 0, VK_FORMAT_R8G8B8A8_UNORM, offsetof(BatchVertex, uv_limits));
+  }
+
+  gpbuilder.SetPrimitiveTopology(VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST);
+  gpbuilder.SetVertexShader(vertex_shader);
+  gpbuilder.SetFragmentShader(fragment_shader);
+
+  gpbuilder.SetRasterizationState(VK_POLYGON_MODE_FILL, VK_CULL_MODE_NONE, VK_FRONT_FACE_CLOCKWISE);
+  gpbuilder.SetDepthState(true, true, depth_test_values[depth_test]);
+  gpbuilder.SetNoBlendingState();
+  gpbuilder.SetMultisamples(m_multisamples, m_per_sample_shading && textured);
+
+  if ((static_cast<GPUTransparencyMode>(transparency_mode) != GPUTransparencyMode::Disabled &&
+       (static_cast<BatchRenderMode>(render_mode) != BatchRenderMode::TransparencyDisabled &&
+        static_cast<BatchRenderMode>(render_mode) != BatchRenderMode::OnlyOpaque)) ||
+      m_texture_filtering != GPUTextureFilter::Nearest)
+  {
+    if (m_supports_dual_source_blend)
+    {
+      gpbuilder.SetBlendAttachment(
+        0, true, VK_BLEND_FACTOR_ONE, VK_BLEND_FACTOR_SRC1_ALPHA,
+        (static_cast<GPUTransparencyMode>(transparency_mode) == GPUTransparencyMode::BackgroundMinusForeground &&
+         static_cast<BatchRenderMode>(render_mode) != BatchRenderMode::TransparencyDisabled &&
+         static_cast<BatchRenderMode>(render_mode) != BatchRenderMode::OnlyOpaque) ?
+          VK_BLEND_OP_REVERSE_SUBTRACT :
+          VK_BLEND_OP_ADD,
+        VK_BLEND_FACTOR_ONE, VK_BLEND_FACTOR_ZERO, VK_BLEND_OP_ADD);
+    }
+    else
+    {
+      const float factor = (static_cast<GPUTransparencyMode>(transparency_mode) ==
+                            GPUTransparencyMode::HalfBackgroundPlusHalfForeground) ?
+                             0.5f :
+                             1.0f;
+      gpbuilder.SetBlendAttachment(
+        0, true, VK_BLEND_FACTOR_ONE, VK_BLEND_FACTOR_CONSTANT_ALPHA,
+        (static_cast<GPUTransparencyMode>(transparency_mode) == GPUTransparencyMode::BackgroundMinusForeground &&
+         static_cast<BatchRenderMode>(render_mode) != BatchRenderMode::TransparencyDisabled &&
+         static_cast<BatchRenderMode>(render_mode) != BatchRenderMode::OnlyOpaque) ?
+          VK_BLEND_OP_REVERSE_SUBTRACT :
+          VK_BLEND_OP_ADD,
+        VK_BLEND_FACTOR_ONE, VK_BLEND_FACTOR_ZERO, VK_BLEND_OP_ADD);
+      gpbuilder.SetBlendConstants(0.0f, 0.0f, 0.0f, factor);
+    }
+  }
+
+  gpbuilder.SetDynamicViewportAndScissorState();
+
+  return gpbuilder.Create(g_vulkan_context->GetDevice(), g_vulkan_shader_cache->GetPipelineCache());
+}
+
+void GPU_HW_Vulkan::StartSpecializedPipelineCompile(const BatchPipelineMask& mask)
+{
+  DebugAssert(!m_specialized_compile_thread.joinable());
+
+  GPU_HW_ShaderGen shadergen(g_host_display->GetRenderAPI(), m_resolution_scale, m_multisamples, m_per_sample_shading,
+                             m_true_color, m_scaled_dithering, m_texture_filtering, m_adaptive_texture_filtering,
+                             m_using_uv_limits, m_pgxp_depth_buffer, m_disable_color_perspective,
+                             m_supports_dual_source_blend, m_use_palette_texture_cache);
+
+  Log_InfoPrintf("Compiling %zu specialized batch pipelines in the background", mask.count());
+  m_specialized_compile_cancel.store(false, std::memory_order_relaxed);
+  m_specialized_compile_done.store(false, std::memory_order_relaxed);
+  m_specialized_compile_thread = std::thread([this, shadergen = std::move(shadergen), mask]() mutable {
+    Threading::ApplyAffinityPolicy(Threading::AffinityClass::Background);
+
+    // Leave half the cores for the emulator itself, we're in no rush.
+    cb::ThreadPool pool(static_cast<int>(std::max(cb::ThreadPool::GetNumLogicalCores() / 2u, 1u)));
+    m_specialized_compile_result =
+      CompileBatchPipelines(shadergen, false, pool, mask, m_specialized_batch_pipelines, nullptr,
+                            &m_specialized_compile_cancel);
+    m_specialized_compile_done.store(true, std::memory_order_release);
+  });
+}
+
+void GPU_HW_Vulkan::UpdateSpecializedPipelineCompile()
+{
+  if (!m_specialized_compile_thread.joinable() || !m_specialized_compile_done.load(std::memory_order_acquire))
+    return;
+
+  m_specialized_compile_thread.join();
+  if (!m_specialized_compile_result)
+  {
+    if (m_use_uber_shaders)
+      Log_ErrorPrintf("Failed to compile specialized batch pipelines, staying on uber shaders");
+    else
+      Log_ErrorPrintf("Failed to compile remaining batch pipelines, they will be built on demand");
+
+    m_specialized_batch_pipelines.enumerate(Vulkan::Util::SafeDestroyPipeline);
+    return;
+  }
+
+  if (!m_use_uber_shaders)
+  {
+    // Filling in after a targeted compile. Anything drawn in the meantime was already built on demand.
+    for (u32 i = 0; i < NUM_BATCH_PIPELINES; i++)
+    {
+      VkPipeline& pipeline = GetBatchPipelineByIndex(m_batch_pipelines, i);
+      VkPipeline& specialized_pipeline = GetBatchPipelineByIndex(m_specialized_batch_pipelines, i);
+      if (specialized_pipeline == VK_NULL_HANDLE)
+        continue;
+
+      if (pipeline == VK_NULL_HANDLE)
+        pipeline = specialized_pipeline;
+      else
+        vkDestroyPipeline(g_vulkan_context->GetDevice(), specialized_pipeline, nullptr);
+
+      specialized_pipeline = VK_NULL_HANDLE;
+    }
+
+    Log_InfoPrintf("Remaining batch pipelines are ready");
+    g_vulkan_shader_cache->FlushPipelineCache();
+    return;
+  }
+
+  Log_InfoPrintf("Specialized batch pipelines are ready, switching from uber shaders");
+  std::swap(m_batch_pipelines, m_specialized_batch_pipelines);
+  m_specialized_batch_pipelines.enumerate([](VkPipeline& pipeline) {
+    if (pipeline != VK_NULL_HANDLE)
+    {
+      g_vulkan_context->DeferPipelineDestruction(pipeline);
+      pipeline = VK_NULL_HANDLE;
+    }
+  });
+
+  m_use_uber_shaders = false;
+  g_vulkan_shader_cache->FlushPipelineCache();
+}
+
+void GPU_HW_Vulkan::CancelSpecializedPipelineCompile()
+{
+  if (!m_specialized_compile_thread.joinable())
+    return;
+
+  m_specialized_compile_cancel.store(true, std::memory_order_relaxed);
+  m_specialized_compile_thread.join();
+  m_specialized_compile_cancel.store(false, std::memory_order_relaxed);
+  m_specialized_batch_pipelines.enumerate(Vulkan::Util::SafeDestroyPipeline);
+}
+
+void GPU_HW_Vulkan::DestroyPipelines()
+{
+  CancelSpecializedPipelineCompile();
+  m_batch_pipelines.enumerate(Vulkan::Util::SafeDestroyPipeline);
+
+  m_vram_fill_pipelines.enumerate(Vulkan::Util::SafeDestroyPipeline);
+
+  for (VkPipeline& p : m_vram_write_pipelines)
+    Vulkan::Util::SafeDestroyPipeline(p);
+
+  for (VkPipeline& p : m_vram_copy_pipelines)
+    Vulkan::Util::SafeDestroyPipeline(p);
+
+  Vulkan::Util::SafeDestroyPipeline(m_vram_readback_pipeline);
+  Vulkan::Util::SafeDestroyPipeline(m_vram_update_depth_pipeline);
+  Vulkan::Util::SafeDestroyPipeline(m_palette_texture_decode_pipeline);
+
+  Vulkan::Util::SafeDestroyPipeline(m_downsample_first_pass_pipeline);
+  Vulkan::Util::SafeDestroyPipeline(m_downsample_mid_pass_pipeline);
+  Vulkan::Util::SafeDestroyPipeline(m_downsample_blur_pass_pipeline);
+  Vulkan::Util::SafeDestroyPipeline(m_downsample_composite_pass_pipeline);
+  Vulkan::Util::SafeDestroyPipeline(m_downsample_compute_pipeline);
+
+  m_display_pipelines.enumerate(Vulkan::Util::SafeDestroyPipeline);
+}
+
+VkPipeline& GPU_HW_Vulkan::GetBatchPipelineByIndex(BatchPipelineArray& pipelines, u32 index)
+{
+  return pipelines[index / 720][(index / 180) % 4][(index / 20) % 9][(index / 4) % 5][(index / 2) % 2][index % 2];
+}
+
+GPU_HW_Vulkan::BatchPipelineMask GPU_HW_Vulkan::GetMissingBatchPipelines()
+{
+  BatchPipelineMask missing;
+  for (u32 i = 0; i < NUM_BATCH_PIPELINES; i++)
+    missing.set(i, GetBatchPipelineByIndex(m_batch_pipelines, i) == VK_NULL_HANDLE);
+
+  return missing;
+}
+
+VkPipeline GPU_HW_Vulkan::CompileBatchPipelineOnDemand(u8 depth_test, u8 render_mode, u8 texture_mode,
+                                                       u8 transparency_mode, u8 dithering, u8 interlacing)
+{
+  Common::Timer timer;
+
+  GPU_HW_ShaderGen shadergen(g_host_display->GetRenderAPI(), m_resolution_scale, m_multisamples, m_per_sample_shading,
+                             m_true_color, m_scaled_dithering, m_texture_filtering, m_adaptive_texture_filtering,
+                             m_using_uv_limits, m_pgxp_depth_buffer, m_disable_color_perspective,
+                             m_supports_dual_source_blend, m_use_palette_texture_cache);
+
+  const bool textured = (static_cast<GPUTextureMode>(texture_mode) != GPUTextureMode::Disabled);
+  VkShaderModule vertex_shader = g_vulkan_shader_cache->GetVertexShader(shadergen.GenerateBatchVertexShader(textured));
+  VkShaderModule fragment_shader = g_vulkan_shader_cache->GetFragmentShader(shadergen.GenerateBatchFragmentShader(
+    static_cast<BatchRenderMode>(render_mode), static_cast<GPUTextureMode>(texture_mode),
+    ConvertToBoolUnchecked(dithering), ConvertToBoolUnchecked(interlacing)));
+
+  VkPipeline pipeline = VK_NULL_HANDLE;
+  if (vertex_shader != VK_NULL_HANDLE && fragment_shader != VK_NULL_HANDLE)
+  {
+    pipeline = CreateBatchPipeline(vertex_shader, fragment_shader, depth_test, render_mode, texture_mode,
+                                   transparency_mode);
+  }
+
+  Vulkan::Util::SafeDestroyShaderModule(vertex_shader);
+  Vulkan::Util::SafeDestroyShaderModule(fragment_shader);
+
+  const u32 index =
+    GetBatchPipelineIndex(depth_test, render_mode, texture_mode, transparency_mode, dithering, interlacing);
+  if (pipeline == VK_NULL_HANDLE)
+  {
+    Log_ErrorPrintf("Failed to compile batch pipeline %u", index);
+    return VK_NULL_HANDLE;
+  }
+
+  Log_DevPrintf("Compiled batch pipeline %u on demand in %.2f ms", index, timer.GetTimeMilliseconds());
+  return pipeline;
+}
+
+void GPU_HW_Vulkan::LoadBatchPipelineUsage()
+{
+  m_batch_pipeline_usage_path = {};
+  m_recorded_batch_pipelines.reset();
+  m_used_batch_pipelines.reset();
+
+  const std::string& serial = System::GetRunningSerial();
+  if (serial.empty())
+    return;
+
+  m_batch_pipeline_usage_path =
+    Path::Combine(EmuFolders::Cache, fmt::format("pipelines_vk_{}.cache", Path::SanitizeFileName(serial)));
+
+  std::unique_ptr<ByteStream> stream(
+    ByteStream::OpenFile(m_batch_pipeline_usage_path.c_str(), BYTESTREAM_OPEN_READ | BYTESTREAM_OPEN_STREAMED));
+  if (!stream)
+  {
+    Log_DevPrintf("Pipeline usage '%s' does not exist, starting a new one.", m_batch_pipeline_usage_path.c_str());
+    return;
+  }
+
+  u32 signature, version, num_entries;
+  if (!stream->ReadU32(&signature) || !stream->ReadU32(&version) || !stream->ReadU32(&num_entries) ||
+      signature != PIPELINE_USAGE_SIGNATURE || version != PIPELINE_USAGE_VERSION || num_entries > NUM_BATCH_PIPELINES)
+  {
+    Log_WarningPrintf("Pipeline usage '%s' is corrupted or version mismatch, recreating.",
+                      m_batch_pipeline_usage_path.c_str());
+    return;
+  }
+
+  for (u32 i = 0; i < num_entries; i++)
+  {
+    u16 index;
+    if (!stream->ReadU16(&index) || index >= NUM_BATCH_PIPELINES)
+    {
+      Log_WarningPrintf("Pipeline usage '%s' entry is corrupted, recreating.", m_batch_pipeline_usage_path.c_str());
+      m_recorded_batch_pipelines.reset();
+      return;
+    }
+
+    m_recorded_batch_pipelines.set(index);
+  }
+
+  m_used_batch_pipelines = m_recorded_batch_pipelines;
+  Log_InfoPrintf("Loaded %zu batch pipelines from pipeline usage '%s'.", m_recorded_batch_pipelines.count(),
+                 m_batch_pipeline_usage_path.c_str());
+}
+
+void GPU_HW_Vulkan::SaveBatchPipelineUsage()
+{
+  // Only rewrite it if this session drew with something new.
+  if (m_batch_pipeline_usage_path.empty() || m_used_batch_pipelines == m_recorded_batch_pipelines)
+    return;
+
+  std::unique_ptr<ByteStream> stream(ByteStream::OpenFile(m_batch_pipeline_usage_path.c_str(),
+                                                          BYTESTREAM_OPEN_CREATE | BYTESTREAM_OPEN_WRITE |
+                                                            BYTESTREAM_OPEN_TRUNCATE | BYTESTREAM_OPEN_ATOMIC_UPDATE |
+                                                            BYTESTREAM_OPEN_STREAMED));
+  if (!stream)
+  {
+    Log_ErrorPrintf("Failed to open pipeline usage '%s' for writing.", m_batch_pipeline_usage_path.c_str());
+    return;
+  }
+
+  bool result = stream->WriteU32(PIPELINE_USAGE_SIGNATURE);
+  result = result && stream->WriteU32(PIPELINE_USAGE_VERSION);
+  result = result && stream->WriteU32(static_cast<u32>(m_used_batch_pipelines.count()));
+  for (u32 i = 0; i < NUM_BATCH_PIPELINES; i++)
+  {
+    if (m_used_batch_pipelines.test(i))
+      result = result && stream->WriteU16(static_cast<u16>(i));
+  }
+
+  result = result && stream->Commit();
+  if (!result)
+  {
+    Log_ErrorPrintf("Failed to write pipeline usage '%s'.", m_batch_pipeline_usage_path.c_str());
+    stream->Discard();
+    return;
+  }
+
+  m_recorded_batch_pipelines = m_used_batch_pipelines;
+  Log_DevPrintf("Wrote %zu batch pipelines to pipeline usage '%s'.", m_used_batch_pipelines.count(),
+                m_batch_pipeline_usage_path.c_str());
+}
+
+void GPU_HW_Vulkan::DrawBatchVertices(const BatchConfig& batch, BatchRenderMode render_mode, u32 base_vertex,
+                                      u32 num_vertices)
+{
+  // Every primitive is emitted as a whole quad, see QUAD_INDEX_BUFFER_SIZE.
+  DebugAssert((num_vertices % 4) == 0);
+  BeginVRAMRenderPass();
+
+  VkCommandBuffer cmdbuf = g_vulkan_context->GetCurrentCommandBuffer();
+  const Vulkan::Util::DebugScope debugScope(cmdbuf, "GPU_HW_Vulkan::DrawBatchVertices: [%u,%u)", base_vertex,
+                                            base_vertex + num_vertices);
+
+  // [depth_test][render_mode][texture_mode][transparency_mode][dithering][interlacing]
+  const BatchConfig shader_config = GetBatchShaderConfig(batch);
+  const u8 depth_test = batch.use_depth_buffer ? static_cast<u8>(2) : BoolToUInt8(batch.check_mask_before_draw);
+  VkPipeline& pipeline =
+    m_batch_pipelines[depth_test][static_cast<u8>(render_mode)][static_cast<u8>(shader_config.texture_mode)]
+                     [static_cast<u8>(batch.transparency_mode)][BoolToUInt8(shader_config.dithering)]
+                     [BoolToUInt8(shader_config.interlacing)];
+
+  // Always record the specialized variant, even with uber shaders, since that's what a later boot will compile.
+  m_used_batch_pipelines.set(GetBatchPipelineIndex(depth_test, static_cast<u8>(render_mode),
+                                                   static_cast<u8>(batch.texture_mode),
+                                                   static_cast<u8>(batch.transparency_mode),
+                                                   BoolToUInt8(batch.dithering), BoolToUInt8(batch.interlacing)));
+
+  if (UNLIKELY(pipeline == VK_NULL_HANDLE))
+  {
+    // Skipped by a targeted compile, and the background compile hasn't got to it yet.
+    pipeline = CompileBatchPipelineOnDemand(depth_test, static_cast<u8>(render_mode),
+                                            static_cast<u8>(shader_config.texture_mode),
+                                            static_cast<u8>(batch.transparency_mode),
+                                            BoolToUInt8(shader_config.dithering),
+                                            BoolToUInt8(shader_config.interlacing));
+    if (pipeline == VK_NULL_HANDLE)
+      return;
+  }
+
+  vkCmdBindPipeline(cmdbuf, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
+  vkCmdDrawIndexed(cmdbuf, (num_vertices / 4) * 6, 1, 0, static_cast<s32>(base_vertex), 0);
+}
+
+void GPU_HW_Vulkan::DecodePaletteTexture(u32 slot, u32 texpage)
+{
+  EndRenderPass();
+
+  VkCommandBuffer cmdbuf = g_vulkan_context->GetCurrentCommandBuffer();
+  const Vulkan::Util::DebugScope debugScope(cmdbuf, "GPU_HW_Vulkan::DecodePaletteTexture: %u", slot);
+
+  const u32 dst_x = (slot % PALETTE_TEXTURE_CACHE_SLOTS_X) * PALETTE_TEXTURE_CACHE_SLOT_SIZE;
+  const u32 dst_y = (slot / PALETTE_TEXTURE_CACHE_SLOTS_X) * PALETTE_TEXTURE_CACHE_SLOT_SIZE;
+
+  // Same fields as the batch vertex shader pulls out of the texpage attribute.
+  const u32 uniforms[7] = {(texpage & 15u) * 64u * m_resolution_scale,
+                           ((texpage >> 4) & 1u) * 256u * m_resolution_scale,
+                           ((texpage >> 16) & 63u) * 16u * m_resolution_scale,
+                           ((texpage >> 22) & 511u) * m_resolution_scale,
+                           dst_x,
+                           dst_y,
+                           BoolToUInt32(((texpage >> 7) & 3u) == 0u)};
+
+  m_palette_texture_cache_texture.TransitionToLayout(cmdbuf, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
+  BeginRenderPass(m_palette_texture_decode_render_pass, m_palette_texture_decode_framebuffer, dst_x, dst_y,
+                  PALETTE_TEXTURE_CACHE_SLOT_SIZE, PALETTE_TEXTURE_CACHE_SLOT_SIZE);
+
+  vkCmdBindPipeline(cmdbuf, VK_PIPELINE_BIND_POINT_GRAPHICS, m_palette_texture_decode_pipeline);
+  vkCmdPushConstants(cmdbuf, m_single_sampler_pipeline_layout, VK_SHADER_STAGE_FRAGMENT_BIT, 0, sizeof(uniforms),
+                     uniforms);
+  vkCmdBindDescriptorSets(cmdbuf, VK_PIPELINE_BIND_POINT_GRAPHICS, m_single_sampler_pipeline_layout, 0, 1,
+                          &m_vram_copy_descriptor_set, 0, nullptr);
+  Vulkan::Util::SetViewportAndScissor(cmdbuf, dst_x, dst_y, PALETTE_TEXTURE_CACHE_SLOT_SIZE,
+                                      PALETTE_TEXTURE_CACHE_SLOT_SIZE);
+  vkCmdDraw(cmdbuf, 3, 1, 0, 0);
+  EndRenderPass();
+
+  m_palette_texture_cache_texture.TransitionToLayout(cmdbuf, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+  RestoreGraphicsAPIState();
+}
+
+void GPU_HW_Vulkan::DrawRendererStats(bool is_idle_frame)
+{
+  // the stream buffers are used by the render thread
+  SyncRenderThread();
+
+  for (Vulkan::StreamBuffer* sb : {&m_vertex_stream_buffer, &m_uniform_stream_buffer, &m_texture_stream_buffer})
+  {
+    const Vulkan::StreamBuffer::Stats sbs = sb->GetAndResetStats();
+    m_renderer_stats.num_stream_buffer_waits += sbs.num_waits;
+    m_renderer_stats.stream_buffer_wait_time_us += sbs.wait_time_us;
+    m_renderer_stats.num_stream_buffer_grows += sbs.num_grows;
+  }
+
+  GPU_HW::DrawRendererStats(is_idle_frame);
+}
+
+bool GPU_HW_Vulkan::SupportsRenderThread() const
+{
+  return true;
+}
+
+u32 GPU_HW_Vulkan::UploadBatchVertices(const BatchVertex* vertices, u32 num_vertices)
+{
+  const u32 size = num_vertices * sizeof(BatchVertex);
+  ReserveVertexStreamBufferSpace(size);
+
+  const u32 base_vertex = m_vertex_stream_buffer.GetCurrentOffset() / sizeof(BatchVertex);
+  std::memcpy(m_vertex_stream_buffer.GetCurrentHostPointer(), vertices, size);
+  m_vertex_stream_buffer.CommitMemory(size);
+  return base_vertex;
+}
+
+void GPU_HW_Vulkan::SetScissorFromDrawingArea()
+{
+  int left, top, right, bottom;
+  CalcScissorRect(&left, &top, &right, &bottom);
+  const Vulkan::Util::DebugScope debugScope(g_vulkan_context->GetCurrentCommandBuffer(),
+                                            "GPU_HW_Vulkan::SetScissorFromDrawingArea: {%u,%u} {%u,%u}", left, top,
                                             right, bottom);
   Vulkan::Util::SetScissor(g_vulkan_context->GetCurrentCommandBuffer(), left, top, right - left, bottom - top);
 }
 
 void GPU_HW_Vulkan::ClearDisplay()
 {
+  SyncRenderThread();
+  g_host_display->SetGPUTimingScope(GPUTimingScope::Display);
+
   GPU_HW::ClearDisplay();
   EndRenderPass();
 
@@ -1409,6 +2161,10 @@ void GPU_HW_Vulkan::ClearDisplay()
 
 void GPU_HW_Vulkan::UpdateDisplay()
 {
+  SyncRenderThread();
+  FlushVRAMWrites();
+  g_host_display->SetGPUTimingScope(GPUTimingScope::Display);
+
   GPU_HW::UpdateDisplay();
   EndRenderPass();
 
@@ -1530,8 +2286,17 @@ void GPU_HW_Vulkan::ReadVRAM(u32 x, u32 y, u32 width, u32 height)
     return;
   }
 
+  SyncRenderThread();
+  FlushVRAMWrites();
+
+  g_host_display->SetGPUTimingScope(GPUTimingScope::VRAMReadbacks);
+
   // Get bounds with wrap-around handled.
   const Common::Rectangle<u32> copy_rect = GetVRAMTransferBounds(x, y, width, height);
+  m_frame_readback_rect.Include(copy_rect);
+  if (ReadSpeculativeVRAM(copy_rect))
+    return;
+
   const u32 encoded_width = (copy_rect.GetWidth() + 1) / 2;
   const u32 encoded_height = copy_rect.GetHeight();
 
@@ -1539,6 +2304,21 @@ void GPU_HW_Vulkan::ReadVRAM(u32 x, u32 y, u32 width, u32 height)
 
   VkCommandBuffer cmdbuf = g_vulkan_context->GetCurrentCommandBuffer();
   const Vulkan::Util::DebugScope debugScope(cmdbuf, "GPU_HW_Vulkan::ReadVRAM: %u %u %ux%u", x, y, width, height);
+  EncodeVRAMForReadback(copy_rect);
+
+  // Stage the readback and copy it into our shadow buffer (will execute command buffer and stall).
+  g_host_display->DownloadTexture(&m_vram_readback_texture, 0, 0, encoded_width, encoded_height,
+                                  &m_vram_shadow[copy_rect.top * VRAM_WIDTH + copy_rect.left],
+                                  VRAM_WIDTH * sizeof(u16));
+
+  RestoreGraphicsAPIState();
+}
+
+void GPU_HW_Vulkan::EncodeVRAMForReadback(const Common::Rectangle<u32>& copy_rect)
+{
+  const u32 encoded_width = (copy_rect.GetWidth() + 1) / 2;
+  const u32 encoded_height = copy_rect.GetHeight();
+  VkCommandBuffer cmdbuf = g_vulkan_context->GetCurrentCommandBuffer();
 
   m_vram_texture.TransitionToLayout(cmdbuf, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
   m_vram_readback_texture.TransitionToLayout(cmdbuf, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
@@ -1562,20 +2342,86 @@ void GPU_HW_Vulkan::ReadVRAM(u32 x, u32 y, u32 width, u32 height)
 
   m_vram_readback_texture.TransitionToLayout(cmdbuf, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL);
   m_vram_texture.TransitionToLayout(cmdbuf, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
+}
 
-  // Stage the readback and copy it into our shadow buffer (will execute command buffer and stall).
-  g_host_display->DownloadTexture(&m_vram_readback_texture, 0, 0, encoded_width, encoded_height,
-                                  &m_vram_shadow[copy_rect.top * VRAM_WIDTH + copy_rect.left],
-                                  VRAM_WIDTH * sizeof(u16));
+void GPU_HW_Vulkan::QueueSpeculativeReadback(const Common::Rectangle<u32>& rect)
+{
+  if (m_speculative_readback_buffer == VK_NULL_HANDLE && !CreateSpeculativeReadbackBuffer())
+    return;
 
-  RestoreGraphicsAPIState();
+  const u32 encoded_width = (rect.GetWidth() + 1) / 2;
+  const u32 encoded_height = rect.GetHeight();
+  const u32 pitch = encoded_width * sizeof(u32);
+
+  VkCommandBuffer cmdbuf = g_vulkan_context->GetCurrentCommandBuffer();
+  const Vulkan::Util::DebugScope debugScope(cmdbuf, "GPU_HW_Vulkan::QueueSpeculativeReadback: %u %u %ux%u", rect.left,
+                                            rect.top, rect.GetWidth(), rect.GetHeight());
+  EncodeVRAMForReadback(rect);
+
+  const VkBufferImageCopy image_copy = {0u,
+                                        encoded_width,
+                                        0u,
+                                        {VK_IMAGE_ASPECT_COLOR_BIT, 0u, 0u, 1u},
+                                        {0, 0, 0},
+                                        {encoded_width, encoded_height, 1u}};
+  vkCmdCopyImageToBuffer(cmdbuf, m_vram_readback_texture.GetImage(), VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                         m_speculative_readback_buffer, 1, &image_copy);
+  Vulkan::Util::BufferMemoryBarrier(cmdbuf, m_speculative_readback_buffer, VK_ACCESS_TRANSFER_WRITE_BIT,
+                                    VK_ACCESS_HOST_READ_BIT, 0, pitch * encoded_height, VK_PIPELINE_STAGE_TRANSFER_BIT,
+                                    VK_PIPELINE_STAGE_HOST_BIT);
+
+  // Completes along with the rest of the frame, so by the time the CPU asks again it's usually already there.
+  m_speculative_readback_rect = rect;
+  m_speculative_readback_pitch = pitch;
+  m_speculative_readback_fence_counter = g_vulkan_context->GetCurrentFenceCounter();
+}
+
+bool GPU_HW_Vulkan::ReadSpeculativeVRAM(const Common::Rectangle<u32>& rect)
+{
+  if (!IsSpeculativeReadbackValid(rect))
+    return false;
+
+  // Still in the command buffer being recorded, so we'd have to submit and stall anyway.
+  const u64 fence_counter = m_speculative_readback_fence_counter;
+  if (fence_counter == g_vulkan_context->GetCurrentFenceCounter())
+    return false;
+
+  if (g_vulkan_context->GetCompletedFenceCounter() >= fence_counter)
+    m_renderer_stats.num_readback_stalls_avoided++;
+  else
+    g_vulkan_context->WaitForFenceCounter(fence_counter);
+
+  const Common::Rectangle<u32>& spec_rect = m_speculative_readback_rect;
+  const VkResult res = vmaInvalidateAllocation(g_vulkan_context->GetAllocator(), m_speculative_readback_allocation, 0,
+                                               spec_rect.GetHeight() * m_speculative_readback_pitch);
+  if (res != VK_SUCCESS)
+    LOG_VULKAN_ERROR(res, "vmaInvalidateAllocation() failed: ");
+
+  // Two VRAM pixels are packed into each texel, so the pixel offset is simply in 16-bit units.
+  const u8* src = m_speculative_readback_map + ((rect.top - spec_rect.top) * m_speculative_readback_pitch) +
+                  ((rect.left - spec_rect.left) * sizeof(u16));
+  u16* dst = &m_vram_shadow[rect.top * VRAM_WIDTH + rect.left];
+  for (u32 row = 0; row < rect.GetHeight(); row++)
+  {
+    std::memcpy(dst, src, rect.GetWidth() * sizeof(u16));
+    src += m_speculative_readback_pitch;
+    dst += VRAM_WIDTH;
+  }
+
+  return true;
 }
 
 void GPU_HW_Vulkan::FillVRAM(u32 x, u32 y, u32 width, u32 height, u32 color)
 {
+  SyncRenderThread();
+  g_host_display->SetGPUTimingScope(GPUTimingScope::VRAMTransfers);
+
   if (IsUsingSoftwareRendererForReadbacks())
     FillSoftwareRendererVRAM(x, y, width, height, color);
 
+  if (HasPendingVRAMWrites(GetVRAMTransferBounds(x, y, width, height)))
+    FlushVRAMWrites();
+
   GPU_HW::FillVRAM(x, y, width, height, color);
 
   BeginVRAMRenderPass();
@@ -1601,12 +2447,19 @@ void GPU_HW_Vulkan::FillVRAM(u32 x, u32 y, u32 width, u32 height, u32 color)
 
 void GPU_HW_Vulkan::UpdateVRAM(u32 x, u32 y, u32 width, u32 height, const void* data, bool set_mask, bool check_mask)
 {
+  SyncRenderThread();
+  g_host_display->SetGPUTimingScope(GPUTimingScope::VRAMTransfers);
+
   if (IsUsingSoftwareRendererForReadbacks())
     UpdateSoftwareRendererVRAM(x, y, width, height, data, set_mask, check_mask);
 
   const Common::Rectangle<u32> bounds = GetVRAMTransferBounds(x, y, width, height);
   GPU_HW::UpdateVRAM(bounds.left, bounds.top, bounds.GetWidth(), bounds.GetHeight(), data, set_mask, check_mask);
 
+  // Only non-overlapping writes are staged together, anything else has to land on top of what's already there.
+  if (HasPendingVRAMWrites(bounds))
+    FlushVRAMWrites();
+
   if (!check_mask)
   {
     const TextureReplacementTexture* rtex = g_texture_replacements.GetVRAMWriteReplacement(width, height, data);
@@ -1617,7 +2470,37 @@ void GPU_HW_Vulkan::UpdateVRAM(u32 x, u32 y, u32 width, u32 height, const void*
     }
   }
 
+  // Writes continuing the previous one, like the columns of an FMV frame, are collected and uploaded together.
+  if (!check_mask && !m_pgxp_depth_buffer)
+  {
+    const float depth_value = GetCurrentNormalizedVertexDepth();
+    if (m_merged_vram_write.Add(x, y, width, height, data, set_mask, depth_value))
+      return;
+
+    if (!m_merged_vram_write.IsEmpty())
+    {
+      StageMergedVRAMWrite();
+      if (m_merged_vram_write.Add(x, y, width, height, data, set_mask, depth_value))
+        return;
+    }
+  }
+
   const u32 data_size = width * height * sizeof(u16);
+  u32 start_index;
+  u16* dst = ReserveVRAMWriteData(data_size, &start_index);
+  std::memcpy(dst, data, data_size);
+  m_texture_stream_buffer.CommitMemory(data_size);
+
+  m_pending_vram_writes.push_back(
+    PendingVRAMWrite{bounds, GetVRAMWriteUBOData(x, y, width, height, start_index, set_mask, check_mask), check_mask});
+
+  // The PGXP depth buffer gets cleared without regard to the drawing area, so don't leave writes pending across it.
+  if (m_pgxp_depth_buffer)
+    FlushVRAMWrites();
+}
+
+u16* GPU_HW_Vulkan::ReserveVRAMWriteData(u32 data_size, u32* start_index)
+{
   const u32 alignment = std::max<u32>(sizeof(u32), static_cast<u32>(m_use_ssbos_for_vram_writes ?
                                                                       g_vulkan_context->GetStorageBufferAlignment() :
                                                                       g_vulkan_context->GetTexelBufferAlignment()));
@@ -1626,40 +2509,105 @@ void GPU_HW_Vulkan::UpdateVRAM(u32 x, u32 y, u32 width, u32 height, const void*
     Log_PerfPrintf("Executing command buffer while waiting for %u bytes in stream buffer", data_size);
     ExecuteCommandBuffer(false, true);
     if (!m_texture_stream_buffer.ReserveMemory(data_size, alignment))
-    {
       Panic("Failed to allocate space in stream buffer for VRAM write");
-      return;
+  }
+
+  *start_index = m_texture_stream_buffer.GetCurrentOffset() / sizeof(u16);
+  return reinterpret_cast<u16*>(m_texture_stream_buffer.GetCurrentHostPointer());
+}
+
+void GPU_HW_Vulkan::StageMergedVRAMWrite()
+{
+  // Making space in the stream buffer can submit the command buffer, which flushes staged writes, so take the merged
+  // write out first.
+  MergedVRAMWrite merged = std::move(m_merged_vram_write);
+  m_merged_vram_write.Clear();
+
+  const u32 data_size = static_cast<u32>(merged.data.size() * sizeof(u16));
+  u32 start_index;
+  u16* dst = ReserveVRAMWriteData(data_size, &start_index);
+  if (merged.Assemble(dst))
+  {
+    const Common::Rectangle<u32>& rc = merged.bounds;
+    m_pending_vram_writes.push_back(PendingVRAMWrite{
+      rc, GetVRAMWriteUBOData(rc.left, rc.top, rc.GetWidth(), rc.GetHeight(), start_index, merged.set_mask, false),
+      false});
+    m_pending_vram_writes.back().uniforms.u_depth_value = merged.depth_value;
+  }
+  else
+  {
+    std::memcpy(dst, merged.data.data(), data_size);
+    for (const MergedVRAMWrite::Piece& piece : merged.pieces)
+    {
+      const Common::Rectangle<u32>& rc = piece.bounds;
+      m_pending_vram_writes.push_back(
+        PendingVRAMWrite{rc,
+                         GetVRAMWriteUBOData(rc.left, rc.top, rc.GetWidth(), rc.GetHeight(),
+                                             start_index + piece.data_offset, merged.set_mask, false),
+                         false});
+      m_pending_vram_writes.back().uniforms.u_depth_value = merged.depth_value;
     }
   }
 
-  const u32 start_index = m_texture_stream_buffer.GetCurrentOffset() / sizeof(u16);
-  std::memcpy(m_texture_stream_buffer.GetCurrentHostPointer(), data, data_size);
   m_texture_stream_buffer.CommitMemory(data_size);
+}
+
+void GPU_HW_Vulkan::FlushVRAMWrites()
+{
+  if (!m_merged_vram_write.IsEmpty())
+    StageMergedVRAMWrite();
+
+  if (m_pending_vram_writes.empty())
+    return;
+
+  g_host_display->SetGPUTimingScope(GPUTimingScope::VRAMTransfers);
 
   VkCommandBuffer cmdbuf = g_vulkan_context->GetCurrentCommandBuffer();
-  const Vulkan::Util::DebugScope debugScope(cmdbuf, "GPU_HW_Vulkan::UpdateVRAM: {%u,%u} %ux%u", x, y, width, height);
+  const Vulkan::Util::DebugScope debugScope(cmdbuf, "GPU_HW_Vulkan::FlushVRAMWrites: %zu writes",
+                                            m_pending_vram_writes.size());
 
   BeginVRAMRenderPass();
 
-  const VRAMWriteUBOData uniforms = GetVRAMWriteUBOData(x, y, width, height, start_index, set_mask, check_mask);
-  vkCmdPushConstants(cmdbuf, m_vram_write_pipeline_layout, VK_SHADER_STAGE_FRAGMENT_BIT, 0, sizeof(uniforms),
-                     &uniforms);
-  vkCmdBindPipeline(cmdbuf, VK_PIPELINE_BIND_POINT_GRAPHICS,
-                    m_vram_write_pipelines[BoolToUInt8(check_mask && !m_pgxp_depth_buffer)]);
   vkCmdBindDescriptorSets(cmdbuf, VK_PIPELINE_BIND_POINT_GRAPHICS, m_vram_write_pipeline_layout, 0, 1,
                           &m_vram_write_descriptor_set, 0, nullptr);
 
-  // the viewport should already be set to the full vram, so just adjust the scissor
-  const Common::Rectangle<u32> scaled_bounds = bounds * m_resolution_scale;
-  Vulkan::Util::SetScissor(cmdbuf, scaled_bounds.left, scaled_bounds.top, scaled_bounds.GetWidth(),
-                           scaled_bounds.GetHeight());
-  vkCmdDraw(cmdbuf, 3, 1, 0, 0);
+  // the viewport should already be set to the full vram, so just adjust the scissor for each write
+  VkPipeline current_pipeline = VK_NULL_HANDLE;
+  for (const PendingVRAMWrite& write : m_pending_vram_writes)
+  {
+    const VkPipeline pipeline = m_vram_write_pipelines[BoolToUInt8(write.check_mask && !m_pgxp_depth_buffer)];
+    if (pipeline != current_pipeline)
+    {
+      vkCmdBindPipeline(cmdbuf, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
+      current_pipeline = pipeline;
+    }
+
+    vkCmdPushConstants(cmdbuf, m_vram_write_pipeline_layout, VK_SHADER_STAGE_FRAGMENT_BIT, 0, sizeof(write.uniforms),
+                       &write.uniforms);
+
+    const Common::Rectangle<u32> scaled_bounds = write.bounds * m_resolution_scale;
+    Vulkan::Util::SetScissor(cmdbuf, scaled_bounds.left, scaled_bounds.top, scaled_bounds.GetWidth(),
+                             scaled_bounds.GetHeight());
+    vkCmdDraw(cmdbuf, 3, 1, 0, 0);
+  }
+
+  m_renderer_stats.num_vram_write_uploads++;
+  m_pending_vram_writes.clear();
 
   RestoreGraphicsAPIState();
 }
 
 void GPU_HW_Vulkan::CopyVRAM(u32 src_x, u32 src_y, u32 dst_x, u32 dst_y, u32 width, u32 height)
 {
+  SyncRenderThread();
+  g_host_display->SetGPUTimingScope(GPUTimingScope::VRAMTransfers);
+
+  if (HasPendingVRAMWrites(GetVRAMTransferBounds(src_x, src_y, width, height)) ||
+      HasPendingVRAMWrites(GetVRAMTransferBounds(dst_x, dst_y, width, height)))
+  {
+    FlushVRAMWrites();
+  }
+
   VkCommandBuffer cmdbuf = g_vulkan_context->GetCurrentCommandBuffer();
   const Vulkan::Util::DebugScope debugScope(cmdbuf, "GPU_HW_Vulkan::CopyVRAM: {%u, %u} {%u, %u} %ux%u", src_x, src_y,
                                             dst_x, dst_y, width, height);
@@ -1670,8 +2618,7 @@ void GPU_HW_Vulkan::CopyVRAM(u32 src_x, u32 src_y, u32 dst_x, u32 dst_y, u32 wid
   {
     const Common::Rectangle<u32> src_bounds = GetVRAMTransferBounds(src_x, src_y, width, height);
     const Common::Rectangle<u32> dst_bounds = GetVRAMTransferBounds(dst_x, dst_y, width, height);
-    if (m_vram_dirty_rect.Intersects(src_bounds))
-      UpdateVRAMReadTexture();
+    UpdateVRAMReadTexturePages(GetDirtyVRAMPages(src_bounds));
     IncludeVRAMDirtyRectangle(dst_bounds);
 
     const VRAMCopyUBOData uniforms(GetVRAMCopyUBOData(src_x, src_y, dst_x, dst_y, width, height));
@@ -1720,16 +2667,17 @@ void GPU_HW_Vulkan::CopyVRAM(u32 src_x, u32 src_y, u32 dst_x, u32 dst_y, u32 wid
   m_vram_texture.TransitionToLayout(cmdbuf, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
 }
 
-void GPU_HW_Vulkan::UpdateVRAMReadTexture()
+void GPU_HW_Vulkan::CopyVRAMToReadTexture(const Common::Rectangle<u32>& rect)
 {
+  FlushVRAMWrites();
   EndRenderPass();
 
   VkCommandBuffer cmdbuf = g_vulkan_context->GetCurrentCommandBuffer();
-  const Vulkan::Util::DebugScope debugScope(cmdbuf, "GPU_HW_Vulkan::UpdateVRAMReadTexture");
+  const Vulkan::Util::DebugScope debugScope(cmdbuf, "GPU_HW_Vulkan::CopyVRAMToReadTexture");
   m_vram_texture.TransitionToLayout(cmdbuf, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL);
   m_vram_read_texture.TransitionToLayout(cmdbuf, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
 
-  const auto scaled_rect = m_vram_dirty_rect * m_resolution_scale;
+  const auto scaled_rect = rect * m_resolution_scale;
 
   if (m_vram_texture.GetSamples() > VK_SAMPLE_COUNT_1_BIT)
   {
@@ -1755,26 +2703,31 @@ void GPU_HW_Vulkan::UpdateVRAMReadTexture()
 
   m_vram_read_texture.TransitionToLayout(cmdbuf, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
   m_vram_texture.TransitionToLayout(cmdbuf, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
-  GPU_HW::UpdateVRAMReadTexture();
 }
 
-void GPU_HW_Vulkan::UpdateDepthBufferFromMaskBit()
+void GPU_HW_Vulkan::UpdateDepthBufferFromMaskBit(const Common::Rectangle<u32>& rect)
 {
   if (m_pgxp_depth_buffer)
     return;
 
+  FlushVRAMWrites();
+
   EndRenderPass();
   VkCommandBuffer cmdbuf = g_vulkan_context->GetCurrentCommandBuffer();
-  const Vulkan::Util::DebugScope debugScope(cmdbuf, "GPU_HW_Vulkan::UpdateDepthBufferFromMaskBit");
+  const Vulkan::Util::DebugScope debugScope(cmdbuf, "GPU_HW_Vulkan::UpdateDepthBufferFromMaskBit: {%u,%u} %ux%u",
+                                            rect.left, rect.top, rect.GetWidth(), rect.GetHeight());
   m_vram_texture.TransitionToLayout(cmdbuf, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
 
-  BeginRenderPass(m_vram_update_depth_render_pass, m_vram_update_depth_framebuffer, 0, 0, m_vram_texture.GetWidth(),
-                  m_vram_texture.GetHeight());
+  const Common::Rectangle<u32> scaled_rect = rect * m_resolution_scale;
+  BeginRenderPass(m_vram_update_depth_render_pass, m_vram_update_depth_framebuffer, scaled_rect.left, scaled_rect.top,
+                  scaled_rect.GetWidth(), scaled_rect.GetHeight());
 
   vkCmdBindPipeline(cmdbuf, VK_PIPELINE_BIND_POINT_GRAPHICS, m_vram_update_depth_pipeline);
   vkCmdBindDescriptorSets(cmdbuf, VK_PIPELINE_BIND_POINT_GRAPHICS, m_single_sampler_pipeline_layout, 0, 1,
                           &m_vram_read_descriptor_set, 0, nullptr);
-  Vulkan::Util::SetViewportAndScissor(cmdbuf, 0, 0, m_vram_texture.GetWidth(), m_vram_texture.GetHeight());
+  Vulkan::Util::SetViewport(cmdbuf, 0, 0, m_vram_texture.GetWidth(), m_vram_texture.GetHeight());
+  Vulkan::Util::SetScissor(cmdbuf, scaled_rect.left, scaled_rect.top, scaled_rect.GetWidth(),
+                           scaled_rect.GetHeight());
   vkCmdDraw(cmdbuf, 3, 1, 0, 0);
 
   EndRenderPass();
@@ -1784,21 +2737,38 @@ void GPU_HW_Vulkan::UpdateDepthBufferFromMaskBit()
   RestoreGraphicsAPIState();
 }
 
-void GPU_HW_Vulkan::ClearDepthBuffer()
+void GPU_HW_Vulkan::ClearDepthBuffer(const Common::Rectangle<u32>& rect)
 {
-  EndRenderPass();
+  FlushVRAMWrites();
 
   VkCommandBuffer cmdbuf = g_vulkan_context->GetCurrentCommandBuffer();
-  const Vulkan::Util::DebugScope debugScope(cmdbuf, "GPU_HW_Vulkan::ClearDepthBuffer");
-  m_vram_depth_texture.TransitionToLayout(cmdbuf, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+  const Vulkan::Util::DebugScope debugScope(cmdbuf, "GPU_HW_Vulkan::ClearDepthBuffer: {%u,%u} %ux%u", rect.left,
+                                            rect.top, rect.GetWidth(), rect.GetHeight());
 
-  static const VkClearDepthStencilValue cds = {1.0f};
-  static constexpr VkImageSubresourceRange dsrr = {VK_IMAGE_ASPECT_DEPTH_BIT, 0u, 1u, 0u, 1u};
-  vkCmdClearDepthStencilImage(cmdbuf, m_vram_depth_texture.GetImage(), m_vram_depth_texture.GetLayout(), &cds, 1u,
-                              &dsrr);
+  // Clearing as an attachment lets us restrict it to the dirty area, and avoids breaking the render pass. This can
+  // also be called between frames, where VRAM may have been left in the layout for display.
+  const VkImageLayout vram_layout = m_vram_texture.GetLayout();
+  if (m_current_render_pass != m_vram_render_pass)
+  {
+    EndRenderPass();
+    m_vram_texture.TransitionToLayout(cmdbuf, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
+    BeginVRAMRenderPass();
+  }
 
-  m_vram_depth_texture.TransitionToLayout(cmdbuf, VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL);
-  m_last_depth_z = 1.0f;
+  const Common::Rectangle<u32> scaled_rect = rect * m_resolution_scale;
+  VkClearAttachment ca = {VK_IMAGE_ASPECT_DEPTH_BIT, 0u, {}};
+  ca.clearValue.depthStencil.depth = 1.0f;
+  const VkClearRect cr = {{{static_cast<s32>(scaled_rect.left), static_cast<s32>(scaled_rect.top)},
+                           {scaled_rect.GetWidth(), scaled_rect.GetHeight()}},
+                          0u,
+                          1u};
+  vkCmdClearAttachments(cmdbuf, 1, &ca, 1, &cr);
+
+  if (vram_layout != VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL)
+  {
+    EndRenderPass();
+    m_vram_texture.TransitionToLayout(cmdbuf, vram_layout);
+  }
 }
 
 bool GPU_HW_Vulkan::BlitVRAMReplacementTexture(const TextureReplacementTexture* tex, u32 dst_x, u32 dst_y, u32 width,
@@ -1807,6 +2777,10 @@ bool GPU_HW_Vulkan::BlitVRAMReplacementTexture(const TextureReplacementTexture*
   VkCommandBuffer cmdbuf = g_vulkan_context->GetCurrentCommandBuffer();
   const Vulkan::Util::DebugScope debugScope(cmdbuf, "GPU_HW_Vulkan::BlitVRAMReplacementTexture: {%u,%u} %ux%u", dst_x,
                                             dst_y, width, height);
+  EndRenderPass();
+  if (tex->IsCompressed())
+    return BlitCompressedVRAMReplacementTexture(tex, dst_x, dst_y, width, height);
+
   if (m_vram_write_replacement_texture.GetWidth() < tex->GetWidth() ||
       m_vram_write_replacement_texture.GetHeight() < tex->GetHeight())
   {
@@ -1841,9 +2815,90 @@ bool GPU_HW_Vulkan::BlitVRAMReplacementTexture(const TextureReplacementTexture*
   return true;
 }
 
+bool GPU_HW_Vulkan::BlitCompressedVRAMReplacementTexture(const TextureReplacementTexture* tex, u32 dst_x, u32 dst_y,
+                                                         u32 width, u32 height)
+{
+  static constexpr std::array<VkFormat, static_cast<size_t>(TextureReplacementTexture::Format::Count)> vk_formats = {
+    {VK_FORMAT_R8G8B8A8_UNORM, VK_FORMAT_BC1_RGBA_UNORM_BLOCK, VK_FORMAT_BC3_UNORM_BLOCK, VK_FORMAT_BC7_UNORM_BLOCK}};
+
+  const TextureReplacementTexture::Format format = tex->GetFormat();
+  const VkFormat vk_format = vk_formats[static_cast<size_t>(format)];
+  if (format != m_vram_write_replacement_compressed_format ||
+      m_vram_write_replacement_compressed_texture.GetWidth() != tex->GetWidth() ||
+      m_vram_write_replacement_compressed_texture.GetHeight() != tex->GetHeight())
+  {
+    // We're scaling with a blit, so the device has to be able to filter from the compressed format.
+    VkFormatProperties fp = {};
+    vkGetPhysicalDeviceFormatProperties(g_vulkan_context->GetPhysicalDevice(), vk_format, &fp);
+    const VkFormatFeatureFlags required =
+      VK_FORMAT_FEATURE_BLIT_SRC_BIT | VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT;
+    if ((fp.optimalTilingFeatures & required) != required)
+    {
+      Log_WarningPrintf("%s replacement textures are not supported by the device, using original data",
+                        TextureReplacementTexture::GetFormatName(format));
+      return false;
+    }
+
+    // Block copies must cover the whole image when it isn't block-aligned, so keep the texture at the exact size.
+    m_vram_write_replacement_compressed_format = TextureReplacementTexture::Format::Count;
+    m_vram_write_replacement_compressed_texture.Destroy(true);
+    if (!m_vram_write_replacement_compressed_texture.Create(
+          tex->GetWidth(), tex->GetHeight(), 1, 1, vk_format, VK_SAMPLE_COUNT_1_BIT, VK_IMAGE_VIEW_TYPE_2D,
+          VK_IMAGE_TILING_OPTIMAL, VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT))
+    {
+      Log_ErrorPrint("Failed to create compressed VRAM write replacement texture");
+      return false;
+    }
+
+    m_vram_write_replacement_compressed_format = format;
+  }
+
+  // Blocks go in as-is, the offset has to be a multiple of the block size as well as the copy alignment.
+  const u32 data_size = tex->GetDataSize();
+  const u32 alignment = std::max<u32>(g_vulkan_context->GetBufferCopyOffsetAlignment(), 16);
+  Vulkan::StreamBuffer& sbuffer = g_vulkan_context->GetTextureUploadBuffer();
+  if (!sbuffer.ReserveMemory(data_size, alignment))
+  {
+    ExecuteCommandBuffer(false, true);
+    if (!sbuffer.ReserveMemory(data_size, alignment))
+    {
+      Log_ErrorPrintf("Failed to reserve %u bytes for compressed replacement texture", data_size);
+      return false;
+    }
+  }
+
+  VkCommandBuffer cmdbuf = g_vulkan_context->GetCurrentCommandBuffer();
+  const u32 buffer_offset = sbuffer.GetCurrentOffset();
+  std::memcpy(sbuffer.GetCurrentHostPointer(), tex->GetPixels(), data_size);
+  sbuffer.CommitMemory(data_size);
+  m_vram_write_replacement_compressed_texture.UpdateFromBuffer(cmdbuf, 0, 0, 0, 0, tex->GetWidth(), tex->GetHeight(),
+                                                               sbuffer.GetBuffer(), buffer_offset, tex->GetWidth());
+
+  const VkImageBlit blit = {
+    {VK_IMAGE_ASPECT_COLOR_BIT, 0u, 0u, 1u},
+    {
+      {0, 0, 0},
+      {static_cast<int32_t>(tex->GetWidth()), static_cast<int32_t>(tex->GetHeight()), 1},
+    },
+    {VK_IMAGE_ASPECT_COLOR_BIT, 0u, 0u, 1u},
+    {{static_cast<int32_t>(dst_x), static_cast<int32_t>(dst_y), 0},
+     {static_cast<int32_t>(dst_x + width), static_cast<int32_t>(dst_y + height), 1}},
+  };
+  m_vram_write_replacement_compressed_texture.TransitionToLayout(cmdbuf, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL);
+  m_vram_texture.TransitionToLayout(cmdbuf, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+  vkCmdBlitImage(cmdbuf, m_vram_write_replacement_compressed_texture.GetImage(),
+                 m_vram_write_replacement_compressed_texture.GetLayout(), m_vram_texture.GetImage(),
+                 m_vram_texture.GetLayout(), 1, &blit, VK_FILTER_LINEAR);
+  m_vram_texture.TransitionToLayout(cmdbuf, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
+  return true;
+}
+
 void GPU_HW_Vulkan::DownsampleFramebuffer(Vulkan::Texture& source, u32 left, u32 top, u32 width, u32 height)
 {
-  if (m_downsample_mode == GPUDownsampleMode::Adaptive)
+  g_host_display->SetGPUTimingScope(GPUTimingScope::Downsample);
+  if (m_use_compute_downsampling)
+    DownsampleFramebufferAdaptiveCompute(source, left, top, width, height);
+  else if (m_downsample_mode == GPUDownsampleMode::Adaptive)
     DownsampleFramebufferAdaptive(source, left, top, width, height);
   else
     DownsampleFramebufferBoxFilter(source, left, top, width, height);
@@ -1979,6 +3034,56 @@ void GPU_HW_Vulkan::DownsampleFramebufferAdaptive(Vulkan::Texture& source, u32 l
   g_host_display->SetDisplayTexture(&m_display_texture, left, top, width, height);
 }
 
+void GPU_HW_Vulkan::DownsampleFramebufferAdaptiveCompute(Vulkan::Texture& source, u32 left, u32 top, u32 width,
+                                                         u32 height)
+{
+  VkCommandBuffer cmdbuf = g_vulkan_context->GetCurrentCommandBuffer();
+  const Vulkan::Util::DebugScope debugScope(cmdbuf, "Downsample Framebuffer Adaptive Compute: {%u,%u} %ux%u", left,
+                                            top, width, height);
+  EndRenderPass();
+
+  // The output goes to the display texture, so if that's also the source, it has to be copied out first.
+  Assert(&source == &m_vram_texture || &source == &m_display_texture);
+  const bool from_vram = (&source == &m_vram_texture);
+  if (!from_vram)
+  {
+    const VkImageCopy copy{{VK_IMAGE_ASPECT_COLOR_BIT, 0u, 0u, 1u},
+                           {static_cast<s32>(left), static_cast<s32>(top), 0},
+                           {VK_IMAGE_ASPECT_COLOR_BIT, 0u, 0u, 1u},
+                           {static_cast<s32>(left), static_cast<s32>(top), 0},
+                           {width, height, 1u}};
+
+    source.TransitionToLayout(cmdbuf, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL);
+    m_downsample_texture.TransitionToLayout(cmdbuf, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+    vkCmdCopyImage(cmdbuf, source.GetImage(), source.GetLayout(), m_downsample_texture.GetImage(),
+                   m_downsample_texture.GetLayout(), 1, &copy);
+    m_downsample_texture.TransitionToLayout(cmdbuf, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+  }
+  else
+  {
+    source.TransitionToLayout(cmdbuf, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+  }
+
+  m_display_texture.TransitionToLayout(cmdbuf, VK_IMAGE_LAYOUT_GENERAL);
+
+  const u32 uniforms[4] = {left, top, left + width, top + height};
+  vkCmdBindPipeline(cmdbuf, VK_PIPELINE_BIND_POINT_COMPUTE, m_downsample_compute_pipeline);
+  vkCmdBindDescriptorSets(cmdbuf, VK_PIPELINE_BIND_POINT_COMPUTE, m_downsample_compute_pipeline_layout, 0, 1,
+                          &m_downsample_compute_descriptor_sets[BoolToUInt8(!from_vram)], 0, nullptr);
+  vkCmdPushConstants(cmdbuf, m_downsample_compute_pipeline_layout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(uniforms),
+                     uniforms);
+
+  // One thread per native resolution pixel, in 8x8 groups.
+  const u32 native_width = width / m_resolution_scale;
+  const u32 native_height = height / m_resolution_scale;
+  vkCmdDispatch(cmdbuf, (native_width + 7) / 8, (native_height + 7) / 8, 1);
+
+  m_display_texture.TransitionToLayout(cmdbuf, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+  RestoreGraphicsAPIState();
+
+  g_host_display->SetDisplayTexture(&m_display_texture, left, top, width, height);
+}
+
 std::unique_ptr<GPU> GPU::CreateHardwareVulkanRenderer()
 {
   if (!Host::AcquireHostDisplay(RenderAPI::Vulkan))
@@ -8,9 +8,19 @@
 #include "gpu_hw.h"
 #include "texture_replacements.h"
 #include <array>
+#include <atomic>
+#include <bitset>
 #include <memory>
+#include <string>
+#include <thread>
 #include <tuple>
 
+namespace cb {
+class ThreadPool;
+}
+
+class GPU_HW_ShaderGen;
+
 class GPU_HW_Vulkan final : public GPU_HW
 {
 public:
@@ -34,20 +44,44 @@ protected:
   void FillVRAM(u32 x, u32 y, u32 width, u32 height, u32 color) override;
   void UpdateVRAM(u32 x, u32 y, u32 width, u32 height, const void* data, bool set_mask, bool check_mask) override;
   void CopyVRAM(u32 src_x, u32 src_y, u32 dst_x, u32 dst_y, u32 width, u32 height) override;
-  void UpdateVRAMReadTexture() override;
-  void UpdateDepthBufferFromMaskBit() override;
-  void ClearDepthBuffer() override;
+  void CopyVRAMToReadTexture(const Common::Rectangle<u32>& rect) override;
+  void UpdateDepthBufferFromMaskBit(const Common::Rectangle<u32>& rect) override;
+  void ClearDepthBuffer(const Common::Rectangle<u32>& rect) override;
   void SetScissorFromDrawingArea() override;
   void MapBatchVertexPointer(u32 required_vertices) override;
   void UnmapBatchVertexPointer(u32 used_vertices) override;
   void UploadUniformBuffer(const void* data, u32 data_size) override;
-  void DrawBatchVertices(BatchRenderMode render_mode, u32 base_vertex, u32 num_vertices) override;
+  void DrawBatchVertices(const BatchConfig& batch, BatchRenderMode render_mode, u32 base_vertex,
+                         u32 num_vertices) override;
+  void DecodePaletteTexture(u32 slot, u32 texpage) override;
+  bool SupportsRenderThread() const override;
+  u32 UploadBatchVertices(const BatchVertex* vertices, u32 num_vertices) override;
+  void FlushVRAMWrites() override;
+  void DrawRendererStats(bool is_idle_frame) override;
 
 private:
   enum : u32
   {
     MAX_PUSH_CONSTANTS_SIZE = 64,
+    MAX_VERTEX_BUFFER_SIZE = VERTEX_BUFFER_SIZE * 4,
+    QUAD_INDEX_BUFFER_SIZE = (MAX_INDEXED_BATCH_VERTEX_COUNT / 4) * 6 * sizeof(u16),
+    NUM_BATCH_PIPELINES = 3 * 4 * 9 * 5 * 2 * 2,
   };
+
+  // [depth_test][render_mode][texture_mode][transparency_mode][dithering][interlacing]
+  using BatchPipelineArray = DimensionalArray<VkPipeline, 2, 2, 5, 9, 4, 3>;
+
+  // Indexed by GetBatchPipelineIndex(), in the same order as BatchPipelineArray.
+  using BatchPipelineMask = std::bitset<NUM_BATCH_PIPELINES>;
+
+  static constexpr u32 GetBatchPipelineIndex(u8 depth_test, u8 render_mode, u8 texture_mode, u8 transparency_mode,
+                                             u8 dithering, u8 interlacing)
+  {
+    return ((((depth_test * 4u + render_mode) * 9u + texture_mode) * 5u + transparency_mode) * 2u + dithering) * 2u +
+           interlacing;
+  }
+  static VkPipeline& GetBatchPipelineByIndex(BatchPipelineArray& pipelines, u32 index);
+
   void SetCapabilities();
   void DestroyResources();
 
@@ -58,6 +92,15 @@ private:
   void EndRenderPass();
   void ExecuteCommandBuffer(bool wait_for_completion, bool restore_state);
 
+  /// Reserves space in the vertex stream buffer, rebinding it if it had to be grown.
+  void ReserveVertexStreamBufferSpace(u32 size);
+
+  /// Reserves space for VRAM write data in the texture stream buffer, returning the start index in halfwords.
+  u16* ReserveVRAMWriteData(u32 data_size, u32* start_index);
+
+  /// Moves the merged VRAM write into the stream buffer, and stages it to be drawn with the other writes.
+  void StageMergedVRAMWrite();
+
   bool CreatePipelineLayouts();
   bool CreateSamplers();
 
@@ -68,15 +111,45 @@ private:
   bool CreateVertexBuffer();
   bool CreateUniformBuffer();
   bool CreateTextureBuffer();
+  bool CreateSpeculativeReadbackBuffer();
+  void DestroySpeculativeReadbackBuffer();
 
   bool CompilePipelines();
+  bool CompileBatchPipelines(GPU_HW_ShaderGen& shadergen, bool uber_shaders, cb::ThreadPool& pool,
+                             const BatchPipelineMask& mask, BatchPipelineArray& pipelines,
+                             ShaderCompileProgressTracker* progress, const std::atomic_bool* cancel);
+  VkPipeline CreateBatchPipeline(VkShaderModule vertex_shader, VkShaderModule fragment_shader, u8 depth_test,
+                                 u8 render_mode, u8 texture_mode, u8 transparency_mode);
   void DestroyPipelines();
 
+  /// Builds a specialized pipeline which was skipped at startup and hasn't come from the background compile yet.
+  VkPipeline CompileBatchPipelineOnDemand(u8 depth_test, u8 render_mode, u8 texture_mode, u8 transparency_mode,
+                                          u8 dithering, u8 interlacing);
+  BatchPipelineMask GetMissingBatchPipelines();
+
+  // The pipelines each game has drawn with are recorded per serial, so the next boot only has to build those before
+  // the first frame. Everything else is left to the background compile.
+  void LoadBatchPipelineUsage();
+  void SaveBatchPipelineUsage();
+
+  // "Uber until specialized ready" builds the specialized pipelines on another thread, and swaps them in at the end
+  // of a frame once they're all done. The same thread fills in whatever a targeted startup compile skipped.
+  void StartSpecializedPipelineCompile(const BatchPipelineMask& mask);
+  void UpdateSpecializedPipelineCompile();
+  void CancelSpecializedPipelineCompile();
+
+  void EncodeVRAMForReadback(const Common::Rectangle<u32>& copy_rect);
+  void QueueSpeculativeReadback(const Common::Rectangle<u32>& rect);
+  bool ReadSpeculativeVRAM(const Common::Rectangle<u32>& rect);
+
   bool BlitVRAMReplacementTexture(const TextureReplacementTexture* tex, u32 dst_x, u32 dst_y, u32 width, u32 height);
+  bool BlitCompressedVRAMReplacementTexture(const TextureReplacementTexture* tex, u32 dst_x, u32 dst_y, u32 width,
+                                            u32 height);
 
   void DownsampleFramebuffer(Vulkan::Texture& source, u32 left, u32 top, u32 width, u32 height);
   void DownsampleFramebufferBoxFilter(Vulkan::Texture& source, u32 left, u32 top, u32 width, u32 height);
   void DownsampleFramebufferAdaptive(Vulkan::Texture& source, u32 left, u32 top, u32 width, u32 height);
+  void DownsampleFramebufferAdaptiveCompute(Vulkan::Texture& source, u32 left, u32 top, u32 width, u32 height);
 
   VkRenderPass m_current_render_pass = VK_NULL_HANDLE;
 
@@ -118,6 +191,7 @@ private:
   VkDescriptorSet m_display_descriptor_set = VK_NULL_HANDLE;
 
   Vulkan::StreamBuffer m_vertex_stream_buffer;
+  Vulkan::StreamBuffer m_quad_index_buffer;
   Vulkan::StreamBuffer m_uniform_stream_buffer;
   Vulkan::StreamBuffer m_texture_stream_buffer;
 
@@ -125,7 +199,17 @@ private:
   VkBufferView m_texture_stream_buffer_view = VK_NULL_HANDLE;
 
   // [depth_test][render_mode][texture_mode][transparency_mode][dithering][interlacing]
-  DimensionalArray<VkPipeline, 2, 2, 5, 9, 4, 3> m_batch_pipelines{};
+  BatchPipelineArray m_batch_pipelines{};
+
+  BatchPipelineArray m_specialized_batch_pipelines{};
+  std::thread m_specialized_compile_thread;
+  std::atomic_bool m_specialized_compile_cancel{false};
+  std::atomic_bool m_specialized_compile_done{false};
+  bool m_specialized_compile_result = false;
+
+  std::string m_batch_pipeline_usage_path;
+  BatchPipelineMask m_recorded_batch_pipelines;
+  BatchPipelineMask m_used_batch_pipelines;
 
   // [wrapped][interlaced]
   DimensionalArray<VkPipeline, 2, 2> m_vram_fill_pipelines{};
@@ -142,6 +226,16 @@ private:
 
   // texture replacements
   Vulkan::Texture m_vram_write_replacement_texture;
+  Vulkan::Texture m_vram_write_replacement_compressed_texture;
+  TextureReplacementTexture::Format m_vram_write_replacement_compressed_format =
+    TextureReplacementTexture::Format::Count;
+
+  // speculative readback, copied out at the end of the frame for the next ReadVRAM()
+  VkBuffer m_speculative_readback_buffer = VK_NULL_HANDLE;
+  VmaAllocation m_speculative_readback_allocation = VK_NULL_HANDLE;
+  const u8* m_speculative_readback_map = nullptr;
+  u32 m_speculative_readback_pitch = 0;
+  u64 m_speculative_readback_fence_counter = 0;
 
   // downsampling
   Vulkan::Texture m_downsample_texture;
@@ -166,4 +260,16 @@ private:
   VkPipeline m_downsample_mid_pass_pipeline = VK_NULL_HANDLE;
   VkPipeline m_downsample_blur_pass_pipeline = VK_NULL_HANDLE;
   VkPipeline m_downsample_composite_pass_pipeline = VK_NULL_HANDLE;
+
+  // [0] reads from VRAM, [1] reads from the copy of the display texture in m_downsample_texture
+  VkDescriptorSetLayout m_downsample_compute_descriptor_set_layout = VK_NULL_HANDLE;
+  VkPipelineLayout m_downsample_compute_pipeline_layout = VK_NULL_HANDLE;
+  std::array<VkDescriptorSet, 2> m_downsample_compute_descriptor_sets{};
+  VkPipeline m_downsample_compute_pipeline = VK_NULL_HANDLE;
+
+  // palette texture cache, native resolution
+  Vulkan::Texture m_palette_texture_cache_texture;
+  VkRenderPass m_palette_texture_decode_render_pass = VK_NULL_HANDLE;
+  VkFramebuffer m_palette_texture_decode_framebuffer = VK_NULL_HANDLE;
+  VkPipeline m_palette_texture_decode_pipeline = VK_NULL_HANDLE;
 };
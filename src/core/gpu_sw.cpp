@@ -52,6 +52,11 @@ const Threading::Thread* GPU_SW::GetSWThread() const
   return m_backend.GetThread();
 }
 
+GPUBackendThreadStats GPU_SW::GetAndResetSWThreadStats()
+{
+  return m_backend.GetAndResetThreadStats();
+}
+
 bool GPU_SW::Initialize()
 {
   if (!GPU::Initialize() || !m_backend.Initialize(false))
@@ -237,17 +242,283 @@ ALWAYS_INLINE void CopyOutRow16<GPUTexture::Format::RGB565, u16>(const u16* src_
 template<>
 ALWAYS_INLINE void CopyOutRow16<GPUTexture::Format::RGBA8, u32>(const u16* src_ptr, u32* dst_ptr, u32 width)
 {
-  for (u32 col = 0; col < width; col++)
+  u32 col = 0;
+
+#if defined(CPU_X64)
+  // Build R|G<<8 and B|A<<8 halves, then interleave them into RGBA8 dwords.
+  const u32 aligned_width = Common::AlignDownPow2(width, 8);
+  const __m128i single_mask = _mm_set1_epi16(0x1F);
+  const __m128i alpha_mask = _mm_set1_epi16(static_cast<s16>(static_cast<u16>(0xFF00)));
+  for (; col < aligned_width; col += 8)
+  {
+    const __m128i value = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src_ptr));
+    src_ptr += 8;
+    const __m128i r = _mm_slli_epi16(_mm_and_si128(value, single_mask), 3);
+    const __m128i g = _mm_slli_epi16(_mm_and_si128(_mm_srli_epi16(value, 5), single_mask), 11);
+    const __m128i b = _mm_slli_epi16(_mm_and_si128(_mm_srli_epi16(value, 10), single_mask), 3);
+    const __m128i a = _mm_and_si128(_mm_srai_epi16(value, 15), alpha_mask);
+    const __m128i rg = _mm_or_si128(r, g);
+    const __m128i ba = _mm_or_si128(b, a);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst_ptr), _mm_unpacklo_epi16(rg, ba));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst_ptr + 4), _mm_unpackhi_epi16(rg, ba));
+    dst_ptr += 8;
+  }
+#elif defined(CPU_AARCH64)
+  const u32 aligned_width = Common::AlignDownPow2(width, 8);
+  const uint16x8_t single_mask = vdupq_n_u16(0x1F);
+  const uint16x8_t alpha_mask = vdupq_n_u16(0xFF00);
+  for (; col < aligned_width; col += 8)
+  {
+    const uint16x8_t value = vld1q_u16(src_ptr);
+    src_ptr += 8;
+    const uint16x8_t r = vshlq_n_u16(vandq_u16(value, single_mask), 3);
+    const uint16x8_t g = vshlq_n_u16(vandq_u16(vshrq_n_u16(value, 5), single_mask), 11);
+    const uint16x8_t b = vshlq_n_u16(vandq_u16(vshrq_n_u16(value, 10), single_mask), 3);
+    const uint16x8_t a = vandq_u16(vtstq_u16(value, vdupq_n_u16(0x8000)), alpha_mask);
+    const uint16x8_t rg = vorrq_u16(r, g);
+    const uint16x8_t ba = vorrq_u16(b, a);
+    vst1q_u32(dst_ptr, vreinterpretq_u32_u16(vzip1q_u16(rg, ba)));
+    vst1q_u32(dst_ptr + 4, vreinterpretq_u32_u16(vzip2q_u16(rg, ba)));
+    dst_ptr += 8;
+  }
+#endif
+
+  for (; col < width; col++)
     *(dst_ptr++) = VRAM16ToOutput<GPUTexture::Format::RGBA8, u32>(*(src_ptr++));
 }
 
 template<>
 ALWAYS_INLINE void CopyOutRow16<GPUTexture::Format::BGRA8, u32>(const u16* src_ptr, u32* dst_ptr, u32 width)
 {
-  for (u32 col = 0; col < width; col++)
+  u32 col = 0;
+
+#if defined(CPU_X64)
+  const u32 aligned_width = Common::AlignDownPow2(width, 8);
+  const __m128i single_mask = _mm_set1_epi16(0x1F);
+  const __m128i alpha = _mm_set1_epi16(static_cast<s16>(static_cast<u16>(0xFF00)));
+  for (; col < aligned_width; col += 8)
+  {
+    const __m128i value = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src_ptr));
+    src_ptr += 8;
+    const __m128i r = _mm_slli_epi16(_mm_and_si128(value, single_mask), 3);
+    const __m128i g = _mm_slli_epi16(_mm_and_si128(_mm_srli_epi16(value, 5), single_mask), 11);
+    const __m128i b = _mm_slli_epi16(_mm_and_si128(_mm_srli_epi16(value, 10), single_mask), 3);
+    const __m128i bg = _mm_or_si128(b, g);
+    const __m128i ra = _mm_or_si128(r, alpha);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst_ptr), _mm_unpacklo_epi16(bg, ra));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst_ptr + 4), _mm_unpackhi_epi16(bg, ra));
+    dst_ptr += 8;
+  }
+#elif defined(CPU_AARCH64)
+  const u32 aligned_width = Common::AlignDownPow2(width, 8);
+  const uint16x8_t single_mask = vdupq_n_u16(0x1F);
+  const uint16x8_t alpha = vdupq_n_u16(0xFF00);
+  for (; col < aligned_width; col += 8)
+  {
+    const uint16x8_t value = vld1q_u16(src_ptr);
+    src_ptr += 8;
+    const uint16x8_t r = vshlq_n_u16(vandq_u16(value, single_mask), 3);
+    const uint16x8_t g = vshlq_n_u16(vandq_u16(vshrq_n_u16(value, 5), single_mask), 11);
+    const uint16x8_t b = vshlq_n_u16(vandq_u16(vshrq_n_u16(value, 10), single_mask), 3);
+    const uint16x8_t bg = vorrq_u16(b, g);
+    const uint16x8_t ra = vorrq_u16(r, alpha);
+    vst1q_u32(dst_ptr, vreinterpretq_u32_u16(vzip1q_u16(bg, ra)));
+    vst1q_u32(dst_ptr + 4, vreinterpretq_u32_u16(vzip2q_u16(bg, ra)));
+    dst_ptr += 8;
+  }
+#endif
+
+  for (; col < width; col++)
     *(dst_ptr++) = VRAM16ToOutput<GPUTexture::Format::BGRA8, u32>(*(src_ptr++));
 }
 
+template<GPUTexture::Format out_format, typename out_type>
+static void CopyOutRow24(const u8* src_ptr, out_type* dst_ptr, u32 width);
+
+#if defined(CPU_X64)
+// Loads four packed 24-bit pixels as 0x00BBGGRR. Reads 16 bytes, so there must be at least six pixels left.
+static ALWAYS_INLINE __m128i Load24BitPixels(const u8* src_ptr)
+{
+  // Shifting left by N bytes moves bytes 3N..3N+2 into dword N, then each dword is picked from its shifted copy.
+  const __m128i value = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src_ptr));
+  const __m128i dword0 = _mm_set_epi32(0, 0, 0, -1);
+  const __m128i dword1 = _mm_set_epi32(0, 0, -1, 0);
+  const __m128i dword2 = _mm_set_epi32(0, -1, 0, 0);
+  const __m128i dword3 = _mm_set_epi32(-1, 0, 0, 0);
+  const __m128i pixels =
+    _mm_or_si128(_mm_or_si128(_mm_and_si128(value, dword0), _mm_and_si128(_mm_slli_si128(value, 1), dword1)),
+                 _mm_or_si128(_mm_and_si128(_mm_slli_si128(value, 2), dword2),
+                              _mm_and_si128(_mm_slli_si128(value, 3), dword3)));
+  return _mm_and_si128(pixels, _mm_set1_epi32(0x00FFFFFF));
+}
+
+// Converts eight 0x00BBGGRR pixels to 16-bit, with the red/green/blue shifts and widths of the output format.
+template<int r_shift, int g_bits, int g_shift>
+static ALWAYS_INLINE __m128i Pack24BitPixelsTo16(__m128i lo, __m128i hi)
+{
+  const auto convert = [](__m128i value) {
+    const __m128i r = _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(value, 3), _mm_set1_epi32(0x1F)), r_shift);
+    const __m128i g = _mm_slli_epi32(
+      _mm_and_si128(_mm_srli_epi32(value, 16 - g_bits), _mm_set1_epi32((1 << g_bits) - 1)), g_shift);
+    const __m128i b = _mm_and_si128(_mm_srli_epi32(value, 19), _mm_set1_epi32(0x1F));
+
+    // biased so the signed saturating pack can't clamp
+    return _mm_sub_epi32(_mm_or_si128(_mm_or_si128(r, g), b), _mm_set1_epi32(0x8000));
+  };
+
+  return _mm_add_epi16(_mm_packs_epi32(convert(lo), convert(hi)), _mm_set1_epi16(static_cast<s16>(0x8000)));
+}
+#endif
+
+template<>
+ALWAYS_INLINE void CopyOutRow24<GPUTexture::Format::RGBA8, u32>(const u8* src_ptr, u32* dst_ptr, u32 width)
+{
+  u32 col = 0;
+
+#if defined(CPU_X64)
+  const __m128i alpha = _mm_set1_epi32(static_cast<s32>(0xFF000000u));
+  for (; (col + 6) <= width; col += 4)
+  {
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst_ptr), _mm_or_si128(Load24BitPixels(src_ptr), alpha));
+    src_ptr += 4 * 3;
+    dst_ptr += 4;
+  }
+#elif defined(CPU_AARCH64)
+  const u32 aligned_width = Common::AlignDownPow2(width, 16);
+  for (; col < aligned_width; col += 16)
+  {
+    const uint8x16x3_t rgb = vld3q_u8(src_ptr);
+    src_ptr += 16 * 3;
+    const uint8x16x4_t rgba = {{rgb.val[0], rgb.val[1], rgb.val[2], vdupq_n_u8(0xFF)}};
+    vst4q_u8(reinterpret_cast<u8*>(dst_ptr), rgba);
+    dst_ptr += 16;
+  }
+#endif
+
+  u8* dst_byte_ptr = reinterpret_cast<u8*>(dst_ptr);
+  for (; col < width; col++)
+  {
+    *(dst_byte_ptr++) = *(src_ptr++);
+    *(dst_byte_ptr++) = *(src_ptr++);
+    *(dst_byte_ptr++) = *(src_ptr++);
+    *(dst_byte_ptr++) = 0xFF;
+  }
+}
+
+template<>
+ALWAYS_INLINE void CopyOutRow24<GPUTexture::Format::BGRA8, u32>(const u8* src_ptr, u32* dst_ptr, u32 width)
+{
+  u32 col = 0;
+
+#if defined(CPU_X64)
+  const __m128i alpha_green = _mm_set1_epi32(static_cast<s32>(0xFF00FF00u));
+  const __m128i channel_mask = _mm_set1_epi32(0xFF);
+  for (; (col + 6) <= width; col += 4)
+  {
+    // swap red and blue, keeping green in place
+    const __m128i rgb = Load24BitPixels(src_ptr);
+    const __m128i r = _mm_slli_epi32(_mm_and_si128(rgb, channel_mask), 16);
+    const __m128i b = _mm_srli_epi32(rgb, 16);
+    const __m128i ga = _mm_or_si128(_mm_and_si128(rgb, alpha_green), _mm_set1_epi32(static_cast<s32>(0xFF000000u)));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst_ptr), _mm_or_si128(_mm_or_si128(r, b), ga));
+    src_ptr += 4 * 3;
+    dst_ptr += 4;
+  }
+#elif defined(CPU_AARCH64)
+  const u32 aligned_width = Common::AlignDownPow2(width, 16);
+  for (; col < aligned_width; col += 16)
+  {
+    const uint8x16x3_t rgb = vld3q_u8(src_ptr);
+    src_ptr += 16 * 3;
+    const uint8x16x4_t bgra = {{rgb.val[2], rgb.val[1], rgb.val[0], vdupq_n_u8(0xFF)}};
+    vst4q_u8(reinterpret_cast<u8*>(dst_ptr), bgra);
+    dst_ptr += 16;
+  }
+#endif
+
+  u8* dst_byte_ptr = reinterpret_cast<u8*>(dst_ptr);
+  for (; col < width; col++)
+  {
+    *(dst_byte_ptr++) = src_ptr[2];
+    *(dst_byte_ptr++) = src_ptr[1];
+    *(dst_byte_ptr++) = src_ptr[0];
+    *(dst_byte_ptr++) = 0xFF;
+    src_ptr += 3;
+  }
+}
+
+template<>
+ALWAYS_INLINE void CopyOutRow24<GPUTexture::Format::RGB565, u16>(const u8* src_ptr, u16* dst_ptr, u32 width)
+{
+  u32 col = 0;
+
+#if defined(CPU_X64)
+  for (; (col + 10) <= width; col += 8)
+  {
+    const __m128i lo = Load24BitPixels(src_ptr);
+    const __m128i hi = Load24BitPixels(src_ptr + 4 * 3);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst_ptr), Pack24BitPixelsTo16<11, 6, 5>(lo, hi));
+    src_ptr += 8 * 3;
+    dst_ptr += 8;
+  }
+#elif defined(CPU_AARCH64)
+  const u32 aligned_width = Common::AlignDownPow2(width, 8);
+  for (; col < aligned_width; col += 8)
+  {
+    const uint8x8x3_t rgb = vld3_u8(src_ptr);
+    src_ptr += 8 * 3;
+    const uint16x8_t r = vshlq_n_u16(vmovl_u8(vshr_n_u8(rgb.val[0], 3)), 11);
+    const uint16x8_t g = vshlq_n_u16(vmovl_u8(vshr_n_u8(rgb.val[1], 2)), 5);
+    const uint16x8_t b = vmovl_u8(vshr_n_u8(rgb.val[2], 3));
+    vst1q_u16(dst_ptr, vorrq_u16(vorrq_u16(r, g), b));
+    dst_ptr += 8;
+  }
+#endif
+
+  for (; col < width; col++)
+  {
+    *(dst_ptr++) = ((static_cast<u16>(src_ptr[0]) >> 3) << 11) | ((static_cast<u16>(src_ptr[1]) >> 2) << 5) |
+                   (static_cast<u16>(src_ptr[2]) >> 3);
+    src_ptr += 3;
+  }
+}
+
+template<>
+ALWAYS_INLINE void CopyOutRow24<GPUTexture::Format::RGBA5551, u16>(const u8* src_ptr, u16* dst_ptr, u32 width)
+{
+  u32 col = 0;
+
+#if defined(CPU_X64)
+  for (; (col + 10) <= width; col += 8)
+  {
+    const __m128i lo = Load24BitPixels(src_ptr);
+    const __m128i hi = Load24BitPixels(src_ptr + 4 * 3);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst_ptr), Pack24BitPixelsTo16<10, 5, 5>(lo, hi));
+    src_ptr += 8 * 3;
+    dst_ptr += 8;
+  }
+#elif defined(CPU_AARCH64)
+  const u32 aligned_width = Common::AlignDownPow2(width, 8);
+  for (; col < aligned_width; col += 8)
+  {
+    const uint8x8x3_t rgb = vld3_u8(src_ptr);
+    src_ptr += 8 * 3;
+    const uint16x8_t r = vshlq_n_u16(vmovl_u8(vshr_n_u8(rgb.val[0], 3)), 10);
+    const uint16x8_t g = vshlq_n_u16(vmovl_u8(vshr_n_u8(rgb.val[1], 3)), 5);
+    const uint16x8_t b = vmovl_u8(vshr_n_u8(rgb.val[2], 3));
+    vst1q_u16(dst_ptr, vorrq_u16(vorrq_u16(r, g), b));
+    dst_ptr += 8;
+  }
+#endif
+
+  for (; col < width; col++)
+  {
+    *(dst_ptr++) = ((static_cast<u16>(src_ptr[0]) >> 3) << 10) | ((static_cast<u16>(src_ptr[1]) >> 3) << 5) |
+                   (static_cast<u16>(src_ptr[2]) >> 3);
+    src_ptr += 3;
+  }
+}
+
 template<GPUTexture::Format display_format>
 void GPU_SW::CopyOut15Bit(u32 src_x, u32 src_y, u32 width, u32 height, u32 field, bool interlaced, bool interleaved)
 {
@@ -262,15 +533,15 @@ void GPU_SW::CopyOut15Bit(u32 src_x, u32 src_y, u32 width, u32 height, u32 field
   if (!texture)
     return;
 
-  if (!interlaced)
-  {
-    if (!g_host_display->BeginTextureUpdate(texture, width, height, reinterpret_cast<void**>(&dst_ptr), &dst_stride))
-      return;
-  }
-  else
+  // Progressive frames are converted straight into the backend's upload buffer. Interlaced frames have to go through
+  // our own buffer, since the other field has to be preserved. Fall back to it too if the texture can't be mapped.
+  const bool mapped =
+    (!interlaced &&
+     g_host_display->BeginTextureUpdate(texture, width, height, reinterpret_cast<void**>(&dst_ptr), &dst_stride));
+  if (!mapped)
   {
     dst_stride = GPU_MAX_DISPLAY_WIDTH * sizeof(OutputPixelType);
-    dst_ptr = m_display_texture_buffer.data() + (field != 0 ? dst_stride : 0);
+    dst_ptr = m_display_texture_buffer.data() + ((interlaced && field != 0) ? dst_stride : 0);
   }
 
   const u32 output_stride = dst_stride;
@@ -311,7 +582,7 @@ void GPU_SW::CopyOut15Bit(u32 src_x, u32 src_y, u32 width, u32 height, u32 field
     }
   }
 
-  if (!interlaced)
+  if (mapped)
     g_host_display->EndTextureUpdate(texture, 0, 0, width, height);
   else
     g_host_display->UpdateTexture(texture, 0, 0, width, height, m_display_texture_buffer.data(), output_stride);
@@ -356,15 +627,15 @@ void GPU_SW::CopyOut24Bit(u32 src_x, u32 src_y, u32 skip_x, u32 width, u32 heigh
   if (!texture)
     return;
 
-  if (!interlaced)
-  {
-    if (!g_host_display->BeginTextureUpdate(texture, width, height, reinterpret_cast<void**>(&dst_ptr), &dst_stride))
-      return;
-  }
-  else
+  // Progressive frames are converted straight into the backend's upload buffer. Interlaced frames have to go through
+  // our own buffer, since the other field has to be preserved. Fall back to it too if the texture can't be mapped.
+  const bool mapped =
+    (!interlaced &&
+     g_host_display->BeginTextureUpdate(texture, width, height, reinterpret_cast<void**>(&dst_ptr), &dst_stride));
+  if (!mapped)
   {
     dst_stride = Common::AlignUpPow2<u32>(width * sizeof(OutputPixelType), 4);
-    dst_ptr = m_display_texture_buffer.data() + (field != 0 ? dst_stride : 0);
+    dst_ptr = m_display_texture_buffer.data() + ((interlaced && field != 0) ? dst_stride : 0);
   }
 
   const u32 output_stride = dst_stride;
@@ -379,54 +650,7 @@ void GPU_SW::CopyOut24Bit(u32 src_x, u32 src_y, u32 skip_x, u32 width, u32 heigh
     const u32 src_stride = (VRAM_WIDTH << interleaved_shift) * sizeof(u16);
     for (u32 row = 0; row < rows; row++)
     {
-      if constexpr (display_format == GPUTexture::Format::RGBA8)
-      {
-        const u8* src_row_ptr = src_ptr;
-        u8* dst_row_ptr = reinterpret_cast<u8*>(dst_ptr);
-        for (u32 col = 0; col < width; col++)
-        {
-          *(dst_row_ptr++) = *(src_row_ptr++);
-          *(dst_row_ptr++) = *(src_row_ptr++);
-          *(dst_row_ptr++) = *(src_row_ptr++);
-          *(dst_row_ptr++) = 0xFF;
-        }
-      }
-      else if constexpr (display_format == GPUTexture::Format::BGRA8)
-      {
-        const u8* src_row_ptr = src_ptr;
-        u8* dst_row_ptr = reinterpret_cast<u8*>(dst_ptr);
-        for (u32 col = 0; col < width; col++)
-        {
-          *(dst_row_ptr++) = src_row_ptr[2];
-          *(dst_row_ptr++) = src_row_ptr[1];
-          *(dst_row_ptr++) = src_row_ptr[0];
-          *(dst_row_ptr++) = 0xFF;
-          src_row_ptr += 3;
-        }
-      }
-      else if constexpr (display_format == GPUTexture::Format::RGB565)
-      {
-        const u8* src_row_ptr = src_ptr;
-        u16* dst_row_ptr = reinterpret_cast<u16*>(dst_ptr);
-        for (u32 col = 0; col < width; col++)
-        {
-          *(dst_row_ptr++) = ((static_cast<u16>(src_row_ptr[0]) >> 3) << 11) |
-                             ((static_cast<u16>(src_row_ptr[1]) >> 2) << 5) | (static_cast<u16>(src_row_ptr[2]) >> 3);
-          src_row_ptr += 3;
-        }
-      }
-      else if constexpr (display_format == GPUTexture::Format::RGBA5551)
-      {
-        const u8* src_row_ptr = src_ptr;
-        u16* dst_row_ptr = reinterpret_cast<u16*>(dst_ptr);
-        for (u32 col = 0; col < width; col++)
-        {
-          *(dst_row_ptr++) = ((static_cast<u16>(src_row_ptr[0]) >> 3) << 10) |
-                             ((static_cast<u16>(src_row_ptr[1]) >> 3) << 5) | (static_cast<u16>(src_row_ptr[2]) >> 3);
-          src_row_ptr += 3;
-        }
-      }
-
+      CopyOutRow24<display_format>(src_ptr, reinterpret_cast<OutputPixelType*>(dst_ptr), width);
       src_ptr += src_stride;
       dst_ptr += dst_stride;
     }
@@ -469,7 +693,7 @@ void GPU_SW::CopyOut24Bit(u32 src_x, u32 src_y, u32 skip_x, u32 width, u32 heigh
     }
   }
 
-  if (!interlaced)
+  if (mapped)
     g_host_display->EndTextureUpdate(texture, 0, 0, width, height);
   else
     g_host_display->UpdateTexture(texture, 0, 0, width, height, m_display_texture_buffer.data(), output_stride);
@@ -499,6 +723,27 @@ void GPU_SW::CopyOut24Bit(GPUTexture::Format display_format, u32 src_x, u32 src_
   }
 }
 
+void GPU_SW::CopyOut24BitRow(GPUTexture::Format display_format, const u8* src_ptr, void* dst_ptr, u32 width)
+{
+  switch (display_format)
+  {
+    case GPUTexture::Format::RGBA5551:
+      CopyOutRow24<GPUTexture::Format::RGBA5551>(src_ptr, static_cast<u16*>(dst_ptr), width);
+      break;
+    case GPUTexture::Format::RGB565:
+      CopyOutRow24<GPUTexture::Format::RGB565>(src_ptr, static_cast<u16*>(dst_ptr), width);
+      break;
+    case GPUTexture::Format::RGBA8:
+      CopyOutRow24<GPUTexture::Format::RGBA8>(src_ptr, static_cast<u32*>(dst_ptr), width);
+      break;
+    case GPUTexture::Format::BGRA8:
+      CopyOutRow24<GPUTexture::Format::BGRA8>(src_ptr, static_cast<u32*>(dst_ptr), width);
+      break;
+    default:
+      break;
+  }
+}
+
 void GPU_SW::ClearDisplay()
 {
   std::memset(m_display_texture_buffer.data(), 0, m_display_texture_buffer.size());
@@ -27,12 +27,16 @@ public:
 
   GPURenderer GetRendererType() const override;
   const Threading::Thread* GetSWThread() const override;
+  GPUBackendThreadStats GetAndResetSWThreadStats() override;
 
   bool Initialize() override;
   bool DoState(StateWrapper& sw, GPUTexture** host_texture, bool update_display) override;
   void Reset(bool clear_vram) override;
   void UpdateSettings() override;
 
+  /// Converts a row of packed 24-bit VRAM pixels to the specified display format.
+  static void CopyOut24BitRow(GPUTexture::Format display_format, const u8* src_ptr, void* dst_ptr, u32 width);
+
 protected:
   void ReadVRAM(u32 x, u32 y, u32 width, u32 height) override;
   void FillVRAM(u32 x, u32 y, u32 width, u32 height, u32 color) override;
@@ -4,23 +4,58 @@
 #include "gpu_sw_backend.h"
 #include "common/assert.h"
 #include "common/log.h"
+#include "common/platform.h"
+#include "common/timer.h"
 #include "gpu_sw_backend.h"
 #include "host_display.h"
+#include "settings.h"
 #include "system.h"
 #include <algorithm>
+#include <cstring>
 Log_SetChannel(GPU_SW_Backend);
 
+#if defined(CPU_X64)
+#include <emmintrin.h>
+#elif defined(CPU_AARCH64)
+#ifdef _MSC_VER
+#include <arm64_neon.h>
+#else
+#include <arm_neon.h>
+#endif
+#endif
+
 GPU_SW_Backend::GPU_SW_Backend() : GPUBackend()
 {
   m_vram.fill(0);
   m_vram_ptr = m_vram.data();
 }
 
-GPU_SW_Backend::~GPU_SW_Backend() = default;
+GPU_SW_Backend::~GPU_SW_Backend()
+{
+  StopWorkerThreads();
+}
 
 bool GPU_SW_Backend::Initialize(bool force_thread)
 {
-  return GPUBackend::Initialize(force_thread);
+  if (!GPUBackend::Initialize(force_thread))
+    return false;
+
+  if (m_use_gpu_thread)
+    StartWorkerThreads(g_settings.gpu_sw_worker_threads);
+
+  return true;
+}
+
+void GPU_SW_Backend::UpdateSettings()
+{
+  GPUBackend::UpdateSettings();
+
+  const u32 worker_count = m_use_gpu_thread ? g_settings.gpu_sw_worker_threads : 0u;
+  if (m_worker_threads.size() != worker_count)
+  {
+    StopWorkerThreads();
+    StartWorkerThreads(worker_count);
+  }
 }
 
 void GPU_SW_Backend::Reset(bool clear_vram)
@@ -31,36 +66,322 @@ void GPU_SW_Backend::Reset(bool clear_vram)
     m_vram.fill(0);
 }
 
-void GPU_SW_Backend::DrawPolygon(const GPUBackendDrawPolygonCommand* cmd)
+void GPU_SW_Backend::Shutdown()
 {
-  const GPURenderCommand rc{cmd->rc.bits};
-  const bool dithering_enable = rc.IsDitheringEnabled() && cmd->draw_mode.dither_enable;
+  GPUBackend::Shutdown();
+  StopWorkerThreads();
+}
 
-  const DrawTriangleFunction DrawFunction = GetDrawTriangleFunction(
-    rc.shading_enable, rc.texture_enable, rc.raw_texture_enable, rc.transparency_enable, dithering_enable);
+void GPU_SW_Backend::StartWorkerThreads(u32 count)
+{
+  if (count == 0)
+    return;
 
-  (this->*DrawFunction)(cmd, &cmd->vertices[0], &cmd->vertices[1], &cmd->vertices[2]);
-  if (rc.quad_polygon)
-    (this->*DrawFunction)(cmd, &cmd->vertices[2], &cmd->vertices[1], &cmd->vertices[3]);
+  m_workers_shutdown = false;
+  m_queued_write_blocks = {};
+  m_queued_read_blocks = {};
+
+  const u32 position = m_queue_write_position.load();
+  m_worker_threads.reserve(count);
+  for (u32 i = 0; i < count; i++)
+  {
+    std::unique_ptr<WorkerThread> worker = std::make_unique<WorkerThread>();
+    worker->position.store(position);
+    worker->thread.Start(
+      [this, worker = worker.get(), i, count]() { WorkerThreadEntryPoint(worker, RasterBand{i + 1, count + 1}); });
+    m_worker_threads.push_back(std::move(worker));
+  }
+
+  Log_InfoPrintf("Started %u software renderer worker threads.", count);
 }
 
-void GPU_SW_Backend::DrawRectangle(const GPUBackendDrawRectangleCommand* cmd)
+void GPU_SW_Backend::StopWorkerThreads()
 {
-  const GPURenderCommand rc{cmd->rc.bits};
+  if (m_worker_threads.empty())
+    return;
+
+  WaitForWorkerThreads();
+
+  {
+    std::unique_lock<std::mutex> lock(m_worker_mutex);
+    m_workers_shutdown = true;
+    m_worker_wake_cv.notify_all();
+  }
 
-  const DrawRectangleFunction DrawFunction =
-    GetDrawRectangleFunction(rc.texture_enable, rc.raw_texture_enable, rc.transparency_enable);
+  for (std::unique_ptr<WorkerThread>& worker : m_worker_threads)
+    worker->thread.Join();
 
-  (this->*DrawFunction)(cmd);
+  m_worker_threads.clear();
+  Log_InfoPrint("Software renderer worker threads stopped.");
 }
 
-void GPU_SW_Backend::DrawLine(const GPUBackendDrawLineCommand* cmd)
+void GPU_SW_Backend::WorkerThreadEntryPoint(WorkerThread* worker, RasterBand band)
+{
+  static constexpr double SPIN_TIME_NS = 100 * 1000;
+
+  Threading::ApplyAffinityPolicy(Threading::AffinityClass::EmulationWorker);
+
+  u32 position = worker->position.load();
+  Common::Timer::Value last_command_time = Common::Timer::GetCurrentValue();
+
+  for (;;)
+  {
+    const u32 write_position = m_queue_write_position.load();
+    if (position != write_position)
+    {
+      do
+      {
+        RasterizeCommand(m_queued_commands[position % MAX_QUEUED_DRAW_COMMANDS], band);
+        position++;
+      } while (position != write_position);
+
+      worker->position.store(position);
+      if (m_waiting_for_workers.load())
+      {
+        std::unique_lock<std::mutex> lock(m_worker_mutex);
+        m_worker_done_cv.notify_one();
+      }
+
+      last_command_time = Common::Timer::GetCurrentValue();
+      continue;
+    }
+
+    const Common::Timer::Value current_time = Common::Timer::GetCurrentValue();
+    if (Common::Timer::ConvertValueToNanoseconds(current_time - last_command_time) < SPIN_TIME_NS)
+      continue;
+
+    std::unique_lock<std::mutex> lock(m_worker_mutex);
+    m_workers_sleeping.fetch_add(1);
+    m_worker_wake_cv.wait(lock,
+                          [this, position]() { return m_workers_shutdown || m_queue_write_position.load() != position; });
+    m_workers_sleeping.fetch_sub(1);
+    if (m_workers_shutdown)
+      break;
+
+    last_command_time = Common::Timer::GetCurrentValue();
+  }
+}
+
+void GPU_SW_Backend::WaitForWorkerThreads()
+{
+  const u32 write_position = m_queue_write_position.load();
+  const auto all_done = [this, write_position]() {
+    return std::all_of(m_worker_threads.begin(), m_worker_threads.end(),
+                       [write_position](const auto& worker) { return worker->position.load() == write_position; });
+  };
+
+  if (!all_done())
+  {
+    std::unique_lock<std::mutex> lock(m_worker_mutex);
+    m_waiting_for_workers.store(true);
+    m_worker_done_cv.wait(lock, all_done);
+    m_waiting_for_workers.store(false);
+  }
+
+  m_queued_write_blocks = {};
+  m_queued_read_blocks = {};
+}
+
+void GPU_SW_Backend::SubmitDrawCommand(const GPUBackendDrawCommand* cmd, const Common::Rectangle<u32>& draw_rect,
+                                       bool reads_texture)
+{
+  if (m_worker_threads.empty())
+  {
+    RasterizeCommand(cmd, RasterBand{0, 1});
+    return;
+  }
+
+  HazardBlockMask write_blocks{};
+  IncludeHazardBlocks(write_blocks, draw_rect);
+
+  HazardBlockMask read_blocks{};
+  if (reads_texture)
+  {
+    IncludeTextureReadBlocks(read_blocks, cmd);
+
+    // If the texture comes from an area which this or a queued primitive draws to, bands would see each other's
+    // writes out of order. Let everything else finish, and draw it on this thread.
+    if (HazardBlocksIntersect(read_blocks, write_blocks) || HazardBlocksIntersect(read_blocks, m_queued_write_blocks))
+    {
+      WaitForWorkerThreads();
+      RasterizeCommand(cmd, RasterBand{0, 1});
+      return;
+    }
+  }
+
+  // Likewise, a band which is ahead can't overwrite texels that a queued primitive has yet to read in another band.
+  bool wait_for_workers = HazardBlocksIntersect(write_blocks, m_queued_read_blocks);
+
+  const u32 write_position = m_queue_write_position.load();
+  for (const std::unique_ptr<WorkerThread>& worker : m_worker_threads)
+    wait_for_workers |= ((write_position - worker->position.load()) == MAX_QUEUED_DRAW_COMMANDS);
+  if (wait_for_workers)
+    WaitForWorkerThreads();
+
+  m_queued_commands[write_position % MAX_QUEUED_DRAW_COMMANDS] = cmd;
+  for (u32 i = 0; i < static_cast<u32>(write_blocks.size()); i++)
+  {
+    m_queued_write_blocks[i] |= write_blocks[i];
+    m_queued_read_blocks[i] |= read_blocks[i];
+  }
+
+  m_queue_write_position.store(write_position + 1);
+  if (m_workers_sleeping.load() > 0)
+  {
+    std::unique_lock<std::mutex> lock(m_worker_mutex);
+    m_worker_wake_cv.notify_all();
+  }
+
+  RasterizeCommand(cmd, RasterBand{0, static_cast<u32>(m_worker_threads.size()) + 1});
+}
+
+void GPU_SW_Backend::RasterizeCommand(const GPUBackendDrawCommand* cmd, RasterBand band)
+{
+  switch (cmd->type)
+  {
+    case GPUBackendCommandType::DrawPolygon:
+    {
+      const GPUBackendDrawPolygonCommand* pcmd = static_cast<const GPUBackendDrawPolygonCommand*>(cmd);
+      const GPURenderCommand rc{pcmd->rc.bits};
+      const bool dithering_enable = rc.IsDitheringEnabled() && pcmd->draw_mode.dither_enable;
+
+      const DrawTriangleFunction DrawFunction = GetDrawTriangleFunction(
+        rc.shading_enable, rc.texture_enable, rc.raw_texture_enable, rc.transparency_enable, dithering_enable);
+
+      (this->*DrawFunction)(pcmd, band, &pcmd->vertices[0], &pcmd->vertices[1], &pcmd->vertices[2]);
+      if (rc.quad_polygon)
+        (this->*DrawFunction)(pcmd, band, &pcmd->vertices[2], &pcmd->vertices[1], &pcmd->vertices[3]);
+    }
+    break;
+
+    case GPUBackendCommandType::DrawRectangle:
+    {
+      const GPUBackendDrawRectangleCommand* rcmd = static_cast<const GPUBackendDrawRectangleCommand*>(cmd);
+      const GPURenderCommand rc{rcmd->rc.bits};
+
+      const DrawRectangleFunction DrawFunction =
+        GetDrawRectangleFunction(rc.texture_enable, rc.raw_texture_enable, rc.transparency_enable);
+
+      (this->*DrawFunction)(rcmd, band);
+    }
+    break;
+
+    case GPUBackendCommandType::DrawLine:
+    {
+      const GPUBackendDrawLineCommand* lcmd = static_cast<const GPUBackendDrawLineCommand*>(cmd);
+      const DrawLineFunction DrawFunction =
+        GetDrawLineFunction(lcmd->rc.shading_enable, lcmd->rc.transparency_enable, lcmd->IsDitheringEnabled());
+
+      for (u16 i = 1; i < lcmd->num_vertices; i++)
+        (this->*DrawFunction)(lcmd, band, &lcmd->vertices[i - 1], &lcmd->vertices[i]);
+    }
+    break;
+
+    default:
+      break;
+  }
+}
+
+bool GPU_SW_Backend::TextureReadIntersects(const GPUBackendDrawCommand* cmd, const Common::Rectangle<u32>& rect)
+{
+  // Texel and palette lookups wrap around the right edge of VRAM.
+  const auto wrapped_intersects = [&rect](const Common::Rectangle<u32>& read_rect) {
+    return (read_rect.Intersects(rect) ||
+            (read_rect.right > VRAM_WIDTH &&
+             Common::Rectangle<u32>(0, read_rect.top, read_rect.right - VRAM_WIDTH, read_rect.bottom).Intersects(rect)));
+  };
+
+  if (wrapped_intersects(cmd->draw_mode.GetTexturePageRectangle()))
+    return true;
+
+  if (cmd->draw_mode.IsUsingPalette())
+  {
+    const u32 palette_width = (cmd->draw_mode.texture_mode == GPUTextureMode::Palette4Bit) ? 16 : 256;
+    return wrapped_intersects(
+      Common::Rectangle<u32>::FromExtents(cmd->palette.GetXBase(), cmd->palette.GetYBase(), palette_width, 1));
+  }
+
+  return false;
+}
+
+void GPU_SW_Backend::IncludeHazardBlocks(HazardBlockMask& mask, const Common::Rectangle<u32>& rect)
+{
+  if (!rect.HasExtents())
+    return;
+
+  const u32 first_column = rect.left / HAZARD_BLOCK_WIDTH;
+  const u32 last_column = std::min((rect.right - 1) / HAZARD_BLOCK_WIDTH, first_column + 15);
+  u16 columns = 0;
+  for (u32 column = first_column; column <= last_column; column++)
+    columns |= static_cast<u16>(1u << (column % 16));
+
+  const u32 last_row = std::min<u32>((rect.bottom - 1) / HAZARD_BLOCK_HEIGHT, static_cast<u32>(mask.size()) - 1);
+  for (u32 row = rect.top / HAZARD_BLOCK_HEIGHT; row <= last_row; row++)
+    mask[row] |= columns;
+}
+
+bool GPU_SW_Backend::HazardBlocksIntersect(const HazardBlockMask& lhs, const HazardBlockMask& rhs)
+{
+  u16 result = 0;
+  for (u32 i = 0; i < static_cast<u32>(lhs.size()); i++)
+    result |= lhs[i] & rhs[i];
+  return (result != 0);
+}
+
+void GPU_SW_Backend::IncludeTextureReadBlocks(HazardBlockMask& mask, const GPUBackendDrawCommand* cmd)
+{
+  IncludeHazardBlocks(mask, cmd->draw_mode.GetTexturePageRectangle());
+
+  if (cmd->draw_mode.IsUsingPalette())
+  {
+    const u32 palette_width = (cmd->draw_mode.texture_mode == GPUTextureMode::Palette4Bit) ? 16 : 256;
+    IncludeHazardBlocks(
+      mask, Common::Rectangle<u32>::FromExtents(cmd->palette.GetXBase(), cmd->palette.GetYBase(), palette_width, 1));
+  }
+}
+
+template<typename Vertex>
+Common::Rectangle<u32> GPU_SW_Backend::GetVertexDrawRectangle(const Vertex* vertices, u32 num_vertices) const
 {
-  const DrawLineFunction DrawFunction =
-    GetDrawLineFunction(cmd->rc.shading_enable, cmd->rc.transparency_enable, cmd->IsDitheringEnabled());
+  s32 min_x = vertices[0].x, max_x = vertices[0].x;
+  s32 min_y = vertices[0].y, max_y = vertices[0].y;
+  for (u32 i = 1; i < num_vertices; i++)
+  {
+    min_x = std::min(min_x, vertices[i].x);
+    max_x = std::max(max_x, vertices[i].x);
+    min_y = std::min(min_y, vertices[i].y);
+    max_y = std::max(max_y, vertices[i].y);
+  }
 
-  for (u16 i = 1; i < cmd->num_vertices; i++)
-    (this->*DrawFunction)(cmd, &cmd->vertices[i - 1], &cmd->vertices[i]);
+  Common::Rectangle<u32> rect(m_drawing_area.left, m_drawing_area.top, m_drawing_area.right + 1,
+                              m_drawing_area.bottom + 1);
+  if (min_x < -1024 || max_x > 1023 || min_y < -1024 || max_y > 1023)
+    return rect;
+
+  rect.left = std::max(rect.left, static_cast<u32>(std::max(min_x, 0)));
+  rect.top = std::max(rect.top, static_cast<u32>(std::max(min_y, 0)));
+  rect.right = std::min(rect.right, static_cast<u32>(std::max(max_x + 1, 0)));
+  rect.bottom = std::min(rect.bottom, static_cast<u32>(std::max(max_y + 1, 0)));
+  rect.right = std::max(rect.right, rect.left);
+  rect.bottom = std::max(rect.bottom, rect.top);
+  return rect;
+}
+
+void GPU_SW_Backend::DrawPolygon(const GPUBackendDrawPolygonCommand* cmd)
+{
+  SubmitDrawCommand(cmd, GetVertexDrawRectangle(cmd->vertices, cmd->num_vertices), cmd->rc.texture_enable);
+}
+
+void GPU_SW_Backend::DrawRectangle(const GPUBackendDrawRectangleCommand* cmd)
+{
+  const GPUBackendDrawPolygonCommand::Vertex corners[2] = {
+    {cmd->x, cmd->y}, {cmd->x + static_cast<s32>(cmd->width) - 1, cmd->y + static_cast<s32>(cmd->height) - 1}};
+  SubmitDrawCommand(cmd, GetVertexDrawRectangle(corners, 2), cmd->rc.texture_enable);
+}
+
+void GPU_SW_Backend::DrawLine(const GPUBackendDrawLineCommand* cmd)
+{
+  SubmitDrawCommand(cmd, GetVertexDrawRectangle(cmd->vertices, cmd->num_vertices), false);
 }
 
 constexpr GPU_SW_Backend::DitherLUT GPU_SW_Backend::ComputeDitherLUT()
@@ -82,51 +403,51 @@ constexpr GPU_SW_Backend::DitherLUT GPU_SW_Backend::ComputeDitherLUT()
 
 static constexpr GPU_SW_Backend::DitherLUT s_dither_lut = GPU_SW_Backend::ComputeDitherLUT();
 
-template<bool texture_enable, bool raw_texture_enable, bool transparency_enable, bool dithering_enable>
-void ALWAYS_INLINE_RELEASE GPU_SW_Backend::ShadePixel(const GPUBackendDrawCommand* cmd, u32 x, u32 y, u8 color_r,
-                                                      u8 color_g, u8 color_b, u8 texcoord_x, u8 texcoord_y)
+ALWAYS_INLINE_RELEASE u16 GPU_SW_Backend::GetTexel(const GPUBackendDrawCommand* cmd, u8 texcoord_x,
+                                                   u8 texcoord_y) const
 {
-  VRAMPixel color;
-  if constexpr (texture_enable)
-  {
-    // Apply texture window
-    texcoord_x = (texcoord_x & cmd->window.and_x) | cmd->window.or_x;
-    texcoord_y = (texcoord_y & cmd->window.and_y) | cmd->window.or_y;
+  // Apply texture window
+  texcoord_x = (texcoord_x & cmd->window.and_x) | cmd->window.or_x;
+  texcoord_y = (texcoord_y & cmd->window.and_y) | cmd->window.or_y;
 
-    VRAMPixel texture_color;
-    switch (cmd->draw_mode.texture_mode)
+  switch (cmd->draw_mode.texture_mode)
+  {
+    case GPUTextureMode::Palette4Bit:
     {
-      case GPUTextureMode::Palette4Bit:
-      {
-        const u16 palette_value =
-          GetPixel((cmd->draw_mode.GetTexturePageBaseX() + ZeroExtend32(texcoord_x / 4)) % VRAM_WIDTH,
-                   (cmd->draw_mode.GetTexturePageBaseY() + ZeroExtend32(texcoord_y)) % VRAM_HEIGHT);
-        const u16 palette_index = (palette_value >> ((texcoord_x % 4) * 4)) & 0x0Fu;
+      const u16 palette_value =
+        GetPixel((cmd->draw_mode.GetTexturePageBaseX() + ZeroExtend32(texcoord_x / 4)) % VRAM_WIDTH,
+                 (cmd->draw_mode.GetTexturePageBaseY() + ZeroExtend32(texcoord_y)) % VRAM_HEIGHT);
+      const u16 palette_index = (palette_value >> ((texcoord_x % 4) * 4)) & 0x0Fu;
 
-        texture_color.bits =
-          GetPixel((cmd->palette.GetXBase() + ZeroExtend32(palette_index)) % VRAM_WIDTH, cmd->palette.GetYBase());
-      }
-      break;
+      return GetPixel((cmd->palette.GetXBase() + ZeroExtend32(palette_index)) % VRAM_WIDTH, cmd->palette.GetYBase());
+    }
 
-      case GPUTextureMode::Palette8Bit:
-      {
-        const u16 palette_value =
-          GetPixel((cmd->draw_mode.GetTexturePageBaseX() + ZeroExtend32(texcoord_x / 2)) % VRAM_WIDTH,
-                   (cmd->draw_mode.GetTexturePageBaseY() + ZeroExtend32(texcoord_y)) % VRAM_HEIGHT);
-        const u16 palette_index = (palette_value >> ((texcoord_x % 2) * 8)) & 0xFFu;
-        texture_color.bits =
-          GetPixel((cmd->palette.GetXBase() + ZeroExtend32(palette_index)) % VRAM_WIDTH, cmd->palette.GetYBase());
-      }
-      break;
+    case GPUTextureMode::Palette8Bit:
+    {
+      const u16 palette_value =
+        GetPixel((cmd->draw_mode.GetTexturePageBaseX() + ZeroExtend32(texcoord_x / 2)) % VRAM_WIDTH,
+                 (cmd->draw_mode.GetTexturePageBaseY() + ZeroExtend32(texcoord_y)) % VRAM_HEIGHT);
+      const u16 palette_index = (palette_value >> ((texcoord_x % 2) * 8)) & 0xFFu;
+      return GetPixel((cmd->palette.GetXBase() + ZeroExtend32(palette_index)) % VRAM_WIDTH, cmd->palette.GetYBase());
+    }
 
-      default:
-      {
-        texture_color.bits = GetPixel((cmd->draw_mode.GetTexturePageBaseX() + ZeroExtend32(texcoord_x)) % VRAM_WIDTH,
-                                      (cmd->draw_mode.GetTexturePageBaseY() + ZeroExtend32(texcoord_y)) % VRAM_HEIGHT);
-      }
-      break;
+    default:
+    {
+      return GetPixel((cmd->draw_mode.GetTexturePageBaseX() + ZeroExtend32(texcoord_x)) % VRAM_WIDTH,
+                      (cmd->draw_mode.GetTexturePageBaseY() + ZeroExtend32(texcoord_y)) % VRAM_HEIGHT);
     }
+  }
+}
 
+template<bool texture_enable, bool raw_texture_enable, bool transparency_enable, bool dithering_enable>
+void ALWAYS_INLINE_RELEASE GPU_SW_Backend::ShadePixel(const GPUBackendDrawCommand* cmd, u32 x, u32 y, u8 color_r,
+                                                      u8 color_g, u8 color_b, u8 texcoord_x, u8 texcoord_y)
+{
+  VRAMPixel color;
+  if constexpr (texture_enable)
+  {
+    VRAMPixel texture_color;
+    texture_color.bits = GetTexel(cmd, texcoord_x, texcoord_y);
     if (texture_color.bits == 0)
       return;
 
@@ -223,31 +544,37 @@ void ALWAYS_INLINE_RELEASE GPU_SW_Backend::ShadePixel(const GPUBackendDrawComman
 }
 
 template<bool texture_enable, bool raw_texture_enable, bool transparency_enable>
-void GPU_SW_Backend::DrawRectangle(const GPUBackendDrawRectangleCommand* cmd)
+void GPU_SW_Backend::DrawRectangle(const GPUBackendDrawRectangleCommand* cmd, RasterBand band)
 {
   const s32 origin_x = cmd->x;
   const s32 origin_y = cmd->y;
   const auto [r, g, b] = UnpackColorRGB24(cmd->color);
   const auto [origin_texcoord_x, origin_texcoord_y] = UnpackTexcoord(cmd->texcoord);
 
-  for (u32 offset_y = 0; offset_y < cmd->height; offset_y++)
+  // Clip to the drawing area once, rather than testing every pixel.
+  const s32 start_x = std::max(origin_x, static_cast<s32>(m_drawing_area.left));
+  const s32 end_x = std::min(origin_x + static_cast<s32>(cmd->width) - 1, static_cast<s32>(m_drawing_area.right));
+  const s32 end_y = std::min(origin_y + static_cast<s32>(cmd->height) - 1, static_cast<s32>(m_drawing_area.bottom));
+  s32 start_y = std::max(origin_y, static_cast<s32>(m_drawing_area.top));
+
+  // Lines in the displayed field are never written when interlaced, so step over them entirely.
+  s32 step_y = 1;
+  if (cmd->params.interlaced_rendering)
   {
-    const s32 y = origin_y + static_cast<s32>(offset_y);
-    if (y < static_cast<s32>(m_drawing_area.top) || y > static_cast<s32>(m_drawing_area.bottom) ||
-        (cmd->params.interlaced_rendering && cmd->params.active_line_lsb == (Truncate8(static_cast<u32>(y)) & 1u)))
-    {
+    start_y += BoolToUInt8(cmd->params.active_line_lsb == (static_cast<u32>(start_y) & 1u));
+    step_y = 2;
+  }
+
+  for (s32 y = start_y; y <= end_y; y += step_y)
+  {
+    if (!IsLineInBand(y, band))
       continue;
-    }
 
-    const u8 texcoord_y = Truncate8(ZeroExtend32(origin_texcoord_y) + offset_y);
+    const u8 texcoord_y = Truncate8(ZeroExtend32(origin_texcoord_y) + static_cast<u32>(y - origin_y));
 
-    for (u32 offset_x = 0; offset_x < cmd->width; offset_x++)
+    for (s32 x = start_x; x <= end_x; x++)
     {
-      const s32 x = origin_x + static_cast<s32>(offset_x);
-      if (x < static_cast<s32>(m_drawing_area.left) || x > static_cast<s32>(m_drawing_area.right))
-        continue;
-
-      const u8 texcoord_x = Truncate8(ZeroExtend32(origin_texcoord_x) + offset_x);
+      const u8 texcoord_x = Truncate8(ZeroExtend32(origin_texcoord_x) + static_cast<u32>(x - origin_x));
 
       ShadePixel<texture_enable, raw_texture_enable, transparency_enable, false>(
         cmd, static_cast<u32>(x), static_cast<u32>(y), r, g, b, texcoord_x, texcoord_y);
@@ -361,13 +688,291 @@ void ALWAYS_INLINE_RELEASE GPU_SW_Backend::AddIDeltas_DY(i_group& ig, const i_de
   }
 }
 
+#if defined(CPU_X64) || defined(CPU_AARCH64)
+
+static constexpr s32 SPAN_VECTOR_WIDTH = 8;
+
+#if defined(CPU_X64)
+using SpanVector = __m128i;
+static ALWAYS_INLINE SpanVector SpanLoad(const u16* ptr)
+{
+  return _mm_loadu_si128(reinterpret_cast<const __m128i*>(ptr));
+}
+static ALWAYS_INLINE void SpanStore(u16* ptr, SpanVector v)
+{
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(ptr), v);
+}
+static ALWAYS_INLINE SpanVector SpanSet(u16 value)
+{
+  return _mm_set1_epi16(static_cast<s16>(value));
+}
+static ALWAYS_INLINE SpanVector SpanAdd(SpanVector a, SpanVector b)
+{
+  return _mm_add_epi16(a, b);
+}
+static ALWAYS_INLINE SpanVector SpanSub(SpanVector a, SpanVector b)
+{
+  return _mm_sub_epi16(a, b);
+}
+static ALWAYS_INLINE SpanVector SpanMul(SpanVector a, SpanVector b)
+{
+  return _mm_mullo_epi16(a, b);
+}
+static ALWAYS_INLINE SpanVector SpanAnd(SpanVector a, SpanVector b)
+{
+  return _mm_and_si128(a, b);
+}
+static ALWAYS_INLINE SpanVector SpanOr(SpanVector a, SpanVector b)
+{
+  return _mm_or_si128(a, b);
+}
+static ALWAYS_INLINE SpanVector SpanAndNot(SpanVector a, SpanVector b)
+{
+  return _mm_andnot_si128(b, a);
+}
+template<int shift>
+static ALWAYS_INLINE SpanVector SpanShiftLeft(SpanVector a)
+{
+  return _mm_slli_epi16(a, shift);
+}
+template<int shift>
+static ALWAYS_INLINE SpanVector SpanShiftRight(SpanVector a)
+{
+  return _mm_srli_epi16(a, shift);
+}
+static ALWAYS_INLINE SpanVector SpanMinS16(SpanVector a, SpanVector b)
+{
+  return _mm_min_epi16(a, b);
+}
+static ALWAYS_INLINE SpanVector SpanMaxS16(SpanVector a, SpanVector b)
+{
+  return _mm_max_epi16(a, b);
+}
+static ALWAYS_INLINE SpanVector SpanEqual(SpanVector a, SpanVector b)
+{
+  return _mm_cmpeq_epi16(a, b);
+}
+static ALWAYS_INLINE SpanVector SpanSelect(SpanVector mask, SpanVector a, SpanVector b)
+{
+  return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+}
+#elif defined(CPU_AARCH64)
+using SpanVector = uint16x8_t;
+static ALWAYS_INLINE SpanVector SpanLoad(const u16* ptr)
+{
+  return vld1q_u16(ptr);
+}
+static ALWAYS_INLINE void SpanStore(u16* ptr, SpanVector v)
+{
+  vst1q_u16(ptr, v);
+}
+static ALWAYS_INLINE SpanVector SpanSet(u16 value)
+{
+  return vdupq_n_u16(value);
+}
+static ALWAYS_INLINE SpanVector SpanAdd(SpanVector a, SpanVector b)
+{
+  return vaddq_u16(a, b);
+}
+static ALWAYS_INLINE SpanVector SpanSub(SpanVector a, SpanVector b)
+{
+  return vsubq_u16(a, b);
+}
+static ALWAYS_INLINE SpanVector SpanMul(SpanVector a, SpanVector b)
+{
+  return vmulq_u16(a, b);
+}
+static ALWAYS_INLINE SpanVector SpanAnd(SpanVector a, SpanVector b)
+{
+  return vandq_u16(a, b);
+}
+static ALWAYS_INLINE SpanVector SpanOr(SpanVector a, SpanVector b)
+{
+  return vorrq_u16(a, b);
+}
+static ALWAYS_INLINE SpanVector SpanAndNot(SpanVector a, SpanVector b)
+{
+  return vbicq_u16(a, b);
+}
+template<int shift>
+static ALWAYS_INLINE SpanVector SpanShiftLeft(SpanVector a)
+{
+  return vshlq_n_u16(a, shift);
+}
+template<int shift>
+static ALWAYS_INLINE SpanVector SpanShiftRight(SpanVector a)
+{
+  return vshrq_n_u16(a, shift);
+}
+static ALWAYS_INLINE SpanVector SpanMinS16(SpanVector a, SpanVector b)
+{
+  return vreinterpretq_u16_s16(vminq_s16(vreinterpretq_s16_u16(a), vreinterpretq_s16_u16(b)));
+}
+static ALWAYS_INLINE SpanVector SpanMaxS16(SpanVector a, SpanVector b)
+{
+  return vreinterpretq_u16_s16(vmaxq_s16(vreinterpretq_s16_u16(a), vreinterpretq_s16_u16(b)));
+}
+static ALWAYS_INLINE SpanVector SpanEqual(SpanVector a, SpanVector b)
+{
+  return vceqq_u16(a, b);
+}
+static ALWAYS_INLINE SpanVector SpanSelect(SpanVector mask, SpanVector a, SpanVector b)
+{
+  return vbslq_u16(mask, a, b);
+}
+#endif
+
+// Equivalent to a lookup in the dither LUT for values of up to 511.
+static ALWAYS_INLINE SpanVector SpanDither(SpanVector value, SpanVector dither)
+{
+  return SpanMinS16(SpanShiftRight<3>(SpanMaxS16(SpanAdd(value, dither), SpanSet(0))), SpanSet(31));
+}
+
+// Per-channel versions of the 15bpp blending in ShadePixel(). The results always have bit 15 set, as the scalar
+// path does when the foreground has it set.
+static ALWAYS_INLINE SpanVector SpanBlend(GPUTransparencyMode mode, SpanVector fg, SpanVector bg)
+{
+  const SpanVector channel_mask = SpanSet(0x1F);
+  SpanVector fg_channels[3] = {SpanAnd(fg, channel_mask), SpanAnd(SpanShiftRight<5>(fg), channel_mask),
+                               SpanAnd(SpanShiftRight<10>(fg), channel_mask)};
+  const SpanVector bg_channels[3] = {SpanAnd(bg, channel_mask), SpanAnd(SpanShiftRight<5>(bg), channel_mask),
+                                     SpanAnd(SpanShiftRight<10>(bg), channel_mask)};
+
+  SpanVector result[3];
+  switch (mode)
+  {
+    case GPUTransparencyMode::HalfBackgroundPlusHalfForeground:
+    {
+      for (u32 i = 0; i < 3; i++)
+        result[i] = SpanShiftRight<1>(SpanAdd(fg_channels[i], bg_channels[i]));
+    }
+    break;
+
+    case GPUTransparencyMode::BackgroundPlusForeground:
+    {
+      for (u32 i = 0; i < 3; i++)
+        result[i] = SpanMinS16(SpanAdd(fg_channels[i], bg_channels[i]), channel_mask);
+    }
+    break;
+
+    case GPUTransparencyMode::BackgroundMinusForeground:
+    {
+      for (u32 i = 0; i < 3; i++)
+        result[i] = SpanMaxS16(SpanSub(bg_channels[i], fg_channels[i]), SpanSet(0));
+    }
+    break;
+
+    case GPUTransparencyMode::BackgroundPlusQuarterForeground:
+    default:
+    {
+      for (u32 i = 0; i < 3; i++)
+        result[i] = SpanMinS16(SpanAdd(SpanShiftRight<2>(fg_channels[i]), bg_channels[i]), channel_mask);
+    }
+    break;
+  }
+
+  return SpanOr(SpanOr(result[0], SpanShiftLeft<5>(result[1])),
+                SpanOr(SpanShiftLeft<10>(result[2]), SpanSet(0x8000)));
+}
+
+template<bool shading_enable, bool texture_enable, bool raw_texture_enable, bool transparency_enable,
+         bool dithering_enable>
+void GPU_SW_Backend::DrawSpanVector(const GPUBackendDrawPolygonCommand* cmd, s32 y, s32& x, s32& w, i_group& ig,
+                                    const i_deltas& idl)
+{
+  // Offsets repeat every four pixels, so they're the same for every group. Without dithering, the LUT uses [2][3].
+  alignas(16) u16 dither_offsets[SPAN_VECTOR_WIDTH];
+  for (s32 i = 0; i < SPAN_VECTOR_WIDTH; i++)
+  {
+    dither_offsets[i] =
+      static_cast<u16>(dithering_enable ? DITHER_MATRIX[y & 3][(x + i) & 3] : DITHER_MATRIX[2][3]);
+  }
+
+  const SpanVector dither = SpanLoad(dither_offsets);
+  const SpanVector channel_mask = SpanSet(0x1F);
+  const SpanVector mask_and = SpanSet(cmd->params.GetMaskAND());
+  const SpanVector mask_or = SpanSet(cmd->params.GetMaskOR());
+  u16* const row_ptr = GetPixelPtr(0, static_cast<u32>(y));
+
+  do
+  {
+    alignas(16) u16 r_values[SPAN_VECTOR_WIDTH];
+    alignas(16) u16 g_values[SPAN_VECTOR_WIDTH];
+    alignas(16) u16 b_values[SPAN_VECTOR_WIDTH];
+    alignas(16) u16 texels[SPAN_VECTOR_WIDTH];
+    for (s32 i = 0; i < SPAN_VECTOR_WIDTH; i++)
+    {
+      r_values[i] = Truncate8(ig.r >> (COORD_FBS + COORD_POST_PADDING));
+      g_values[i] = Truncate8(ig.g >> (COORD_FBS + COORD_POST_PADDING));
+      b_values[i] = Truncate8(ig.b >> (COORD_FBS + COORD_POST_PADDING));
+      if constexpr (texture_enable)
+      {
+        texels[i] = GetTexel(cmd, Truncate8(ig.u >> (COORD_FBS + COORD_POST_PADDING)),
+                             Truncate8(ig.v >> (COORD_FBS + COORD_POST_PADDING)));
+      }
+
+      AddIDeltas_DX<shading_enable, texture_enable>(ig, idl);
+    }
+
+    const SpanVector bg = SpanLoad(&row_ptr[x]);
+    SpanVector write_mask = SpanEqual(SpanAnd(bg, mask_and), SpanSet(0));
+
+    SpanVector color;
+    if constexpr (texture_enable)
+    {
+      const SpanVector texel = SpanLoad(texels);
+      write_mask = SpanAndNot(write_mask, SpanEqual(texel, SpanSet(0)));
+
+      if constexpr (raw_texture_enable)
+      {
+        color = texel;
+      }
+      else
+      {
+        const SpanVector r =
+          SpanDither(SpanShiftRight<4>(SpanMul(SpanAnd(texel, channel_mask), SpanLoad(r_values))), dither);
+        const SpanVector g = SpanDither(
+          SpanShiftRight<4>(SpanMul(SpanAnd(SpanShiftRight<5>(texel), channel_mask), SpanLoad(g_values))), dither);
+        const SpanVector b = SpanDither(
+          SpanShiftRight<4>(SpanMul(SpanAnd(SpanShiftRight<10>(texel), channel_mask), SpanLoad(b_values))), dither);
+        color = SpanOr(SpanOr(r, SpanShiftLeft<5>(g)), SpanOr(SpanShiftLeft<10>(b), SpanAnd(texel, SpanSet(0x8000))));
+      }
+    }
+    else
+    {
+      const SpanVector r = SpanDither(SpanLoad(r_values), dither);
+      const SpanVector g = SpanDither(SpanLoad(g_values), dither);
+      const SpanVector b = SpanDither(SpanLoad(b_values), dither);
+      color = SpanOr(SpanOr(r, SpanShiftLeft<5>(g)), SpanShiftLeft<10>(b));
+    }
+
+    if constexpr (transparency_enable)
+    {
+      const SpanVector blended = SpanBlend(cmd->draw_mode.transparency_mode, color, bg);
+      if constexpr (texture_enable)
+        color = SpanSelect(SpanEqual(SpanAnd(color, SpanSet(0x8000)), SpanSet(0x8000)), blended, color);
+      else
+        color = SpanAnd(blended, SpanSet(0x7FFF));
+    }
+
+    SpanStore(&row_ptr[x], SpanSelect(write_mask, SpanOr(color, mask_or), bg));
+    x += SPAN_VECTOR_WIDTH;
+    w -= SPAN_VECTOR_WIDTH;
+  } while (w >= SPAN_VECTOR_WIDTH);
+}
+
+#endif
+
 template<bool shading_enable, bool texture_enable, bool raw_texture_enable, bool transparency_enable,
          bool dithering_enable>
-void GPU_SW_Backend::DrawSpan(const GPUBackendDrawPolygonCommand* cmd, s32 y, s32 x_start, s32 x_bound, i_group ig,
-                              const i_deltas& idl)
+void GPU_SW_Backend::DrawSpan(const GPUBackendDrawPolygonCommand* cmd, RasterBand band, s32 y, s32 x_start,
+                              s32 x_bound, i_group ig, const i_deltas& idl)
 {
-  if (cmd->params.interlaced_rendering && cmd->params.active_line_lsb == (Truncate8(static_cast<u32>(y)) & 1u))
+  if ((cmd->params.interlaced_rendering && cmd->params.active_line_lsb == (Truncate8(static_cast<u32>(y)) & 1u)) ||
+      !IsLineInBand(y, band))
+  {
     return;
+  }
 
   s32 x_ig_adjust = x_start;
   s32 w = x_bound - x_start;
@@ -390,6 +995,21 @@ void GPU_SW_Backend::DrawSpan(const GPUBackendDrawPolygonCommand* cmd, s32 y, s3
   AddIDeltas_DX<shading_enable, texture_enable>(ig, idl, x_ig_adjust);
   AddIDeltas_DY<shading_enable, texture_enable>(ig, idl, y);
 
+#if defined(CPU_X64) || defined(CPU_AARCH64)
+  // Texels are fetched for a whole group before it is written, so spans which could read their own output, or the
+  // output of earlier pixels in the span, have to be drawn one pixel at a time.
+  if (w >= SPAN_VECTOR_WIDTH &&
+      (!texture_enable ||
+       !TextureReadIntersects(cmd, Common::Rectangle<u32>::FromExtents(static_cast<u32>(x), static_cast<u32>(y),
+                                                                       static_cast<u32>(w), 1))))
+  {
+    DrawSpanVector<shading_enable, texture_enable, raw_texture_enable, transparency_enable, dithering_enable>(
+      cmd, y, x, w, ig, idl);
+    if (w == 0)
+      return;
+  }
+#endif
+
   do
   {
     const u32 r = ig.r >> (COORD_FBS + COORD_POST_PADDING);
@@ -409,7 +1029,7 @@ void GPU_SW_Backend::DrawSpan(const GPUBackendDrawPolygonCommand* cmd, s32 y, s3
 
 template<bool shading_enable, bool texture_enable, bool raw_texture_enable, bool transparency_enable,
          bool dithering_enable>
-void GPU_SW_Backend::DrawTriangle(const GPUBackendDrawPolygonCommand* cmd,
+void GPU_SW_Backend::DrawTriangle(const GPUBackendDrawPolygonCommand* cmd, RasterBand band,
                                   const GPUBackendDrawPolygonCommand::Vertex* v0,
                                   const GPUBackendDrawPolygonCommand::Vertex* v1,
                                   const GPUBackendDrawPolygonCommand::Vertex* v2)
@@ -574,7 +1194,7 @@ void GPU_SW_Backend::DrawTriangle(const GPUBackendDrawPolygonCommand* cmd,
           continue;
 
         DrawSpan<shading_enable, texture_enable, raw_texture_enable, transparency_enable, dithering_enable>(
-          cmd, yi, GetPolyXFP_Int(lc), GetPolyXFP_Int(rc), ig, idl);
+          cmd, band, yi, GetPolyXFP_Int(lc), GetPolyXFP_Int(rc), ig, idl);
       }
     }
     else
@@ -590,7 +1210,7 @@ void GPU_SW_Backend::DrawTriangle(const GPUBackendDrawPolygonCommand* cmd,
         {
 
           DrawSpan<shading_enable, texture_enable, raw_texture_enable, transparency_enable, dithering_enable>(
-            cmd, yi, GetPolyXFP_Int(lc), GetPolyXFP_Int(rc), ig, idl);
+            cmd, band, yi, GetPolyXFP_Int(lc), GetPolyXFP_Int(rc), ig, idl);
         }
 
         yi++;
@@ -635,8 +1255,8 @@ static ALWAYS_INLINE_RELEASE s64 LineDivide(s64 delta, s32 dk)
 }
 
 template<bool shading_enable, bool transparency_enable, bool dithering_enable>
-void GPU_SW_Backend::DrawLine(const GPUBackendDrawLineCommand* cmd, const GPUBackendDrawLineCommand::Vertex* p0,
-                              const GPUBackendDrawLineCommand::Vertex* p1)
+void GPU_SW_Backend::DrawLine(const GPUBackendDrawLineCommand* cmd, RasterBand band,
+                              const GPUBackendDrawLineCommand::Vertex* p0, const GPUBackendDrawLineCommand::Vertex* p1)
 {
   const s32 i_dx = std::abs(p1->x - p0->x);
   const s32 i_dy = std::abs(p1->y - p0->y);
@@ -697,7 +1317,8 @@ void GPU_SW_Backend::DrawLine(const GPUBackendDrawLineCommand* cmd, const GPUBac
 
     if ((!cmd->params.interlaced_rendering || cmd->params.active_line_lsb != (Truncate8(static_cast<u32>(y)) & 1u)) &&
         x >= static_cast<s32>(m_drawing_area.left) && x <= static_cast<s32>(m_drawing_area.right) &&
-        y >= static_cast<s32>(m_drawing_area.top) && y <= static_cast<s32>(m_drawing_area.bottom))
+        y >= static_cast<s32>(m_drawing_area.top) && y <= static_cast<s32>(m_drawing_area.bottom) &&
+        IsLineInBand(y, band))
     {
       const u8 r = shading_enable ? static_cast<u8>(cur_point.r >> Line_RGB_FractBits) : p0->r;
       const u8 g = shading_enable ? static_cast<u8>(cur_point.g >> Line_RGB_FractBits) : p0->g;
@@ -719,72 +1340,109 @@ void GPU_SW_Backend::DrawLine(const GPUBackendDrawLineCommand* cmd, const GPUBac
   }
 }
 
-void GPU_SW_Backend::FillVRAM(u32 x, u32 y, u32 width, u32 height, u32 color, GPUBackendCommandParameters params)
+static void FillVRAMRow(u16* dst, u32 width, u16 color)
 {
-  const u16 color16 = VRAMRGBA8888ToRGBA5551(color);
-  if ((x + width) <= VRAM_WIDTH && !params.interlaced_rendering)
+  u32 col = 0;
+#if defined(CPU_X64) || defined(CPU_AARCH64)
+  const SpanVector color_vec = SpanSet(color);
+  for (; (col + SPAN_VECTOR_WIDTH) <= width; col += SPAN_VECTOR_WIDTH)
+    SpanStore(&dst[col], color_vec);
+#endif
+  for (; col < width; col++)
+    dst[col] = color;
+}
+
+// Copies a row which doesn't wrap, applying the mask bits. Overlapping rows are handled the same as memmove(), which
+// gives the same result as the pixel-by-pixel copy in the direction the hardware uses.
+static void CopyVRAMRow(u16* dst, const u16* src, u32 width, u16 mask_and, u16 mask_or, bool reverse)
+{
+  if (mask_and == 0 && mask_or == 0)
   {
-    for (u32 yoffs = 0; yoffs < height; yoffs++)
-    {
-      const u32 row = (y + yoffs) % VRAM_HEIGHT;
-      std::fill_n(&m_vram_ptr[row * VRAM_WIDTH + x], width, color16);
-    }
+    std::memmove(dst, src, width * sizeof(u16));
+    return;
   }
-  else if (params.interlaced_rendering)
-  {
-    // Hardware tests show that fills seem to break on the first two lines when the offset matches the displayed field.
-    const u32 active_field = params.active_line_lsb;
-    for (u32 yoffs = 0; yoffs < height; yoffs++)
-    {
-      const u32 row = (y + yoffs) % VRAM_HEIGHT;
-      if ((row & u32(1)) == active_field)
-        continue;
 
-      u16* row_ptr = &m_vram_ptr[row * VRAM_WIDTH];
-      for (u32 xoffs = 0; xoffs < width; xoffs++)
-      {
-        const u32 col = (x + xoffs) % VRAM_WIDTH;
-        row_ptr[col] = color16;
-      }
-    }
+#if defined(CPU_X64) || defined(CPU_AARCH64)
+  const SpanVector mask_and_vec = SpanSet(mask_and);
+  const SpanVector mask_or_vec = SpanSet(mask_or);
+  const SpanVector zero = SpanSet(0);
+  const auto copy_vec = [dst, src, &mask_and_vec, &mask_or_vec, &zero](u32 col) {
+    // Both are loaded before storing, so overlap within the vector is fine.
+    const SpanVector src_vec = SpanLoad(&src[col]);
+    const SpanVector dst_vec = SpanLoad(&dst[col]);
+    const SpanVector writable = SpanEqual(SpanAnd(dst_vec, mask_and_vec), zero);
+    SpanStore(&dst[col], SpanSelect(writable, SpanOr(src_vec, mask_or_vec), dst_vec));
+  };
+#endif
+
+  const auto copy_pixel = [dst, src, mask_and, mask_or](u32 col) {
+    const u16 src_pixel = src[col];
+    if ((dst[col] & mask_and) == 0)
+      dst[col] = src_pixel | mask_or;
+  };
+
+  if (reverse)
+  {
+    u32 col = width;
+#if defined(CPU_X64) || defined(CPU_AARCH64)
+    for (; col >= SPAN_VECTOR_WIDTH; col -= SPAN_VECTOR_WIDTH)
+      copy_vec(col - SPAN_VECTOR_WIDTH);
+#endif
+    while (col > 0)
+      copy_pixel(--col);
   }
   else
   {
-    for (u32 yoffs = 0; yoffs < height; yoffs++)
-    {
-      const u32 row = (y + yoffs) % VRAM_HEIGHT;
-      u16* row_ptr = &m_vram_ptr[row * VRAM_WIDTH];
-      for (u32 xoffs = 0; xoffs < width; xoffs++)
-      {
-        const u32 col = (x + xoffs) % VRAM_WIDTH;
-        row_ptr[col] = color16;
-      }
-    }
+    u32 col = 0;
+#if defined(CPU_X64) || defined(CPU_AARCH64)
+    for (; (col + SPAN_VECTOR_WIDTH) <= width; col += SPAN_VECTOR_WIDTH)
+      copy_vec(col);
+#endif
+    for (; col < width; col++)
+      copy_pixel(col);
+  }
+}
+
+void GPU_SW_Backend::FillVRAM(u32 x, u32 y, u32 width, u32 height, u32 color, GPUBackendCommandParameters params)
+{
+  const u16 color16 = VRAMRGBA8888ToRGBA5551(color);
+
+  // Hardware tests show that fills seem to break on the first two lines when the offset matches the displayed field.
+  // VRAM height is even, so wrapping around preserves the field of each row.
+  const u32 start_row = params.interlaced_rendering ? BoolToUInt32((y & u32(1)) == params.active_line_lsb) : 0;
+  const u32 row_step = params.interlaced_rendering ? 2 : 1;
+
+  // Rows which wrap around horizontally are filled in two parts.
+  const u32 first_width = std::min<u32>(width, VRAM_WIDTH - x);
+  const u32 second_width = std::min<u32>(width - first_width, VRAM_WIDTH);
+  for (u32 yoffs = start_row; yoffs < height; yoffs += row_step)
+  {
+    u16* row_ptr = &m_vram_ptr[((y + yoffs) % VRAM_HEIGHT) * VRAM_WIDTH];
+    FillVRAMRow(&row_ptr[x], first_width, color16);
+    if (second_width > 0)
+      FillVRAMRow(row_ptr, second_width, color16);
   }
 }
 
 void GPU_SW_Backend::UpdateVRAM(u32 x, u32 y, u32 width, u32 height, const void* data,
                                 GPUBackendCommandParameters params)
 {
-  // Fast path when the copy is not oversized.
-  if ((x + width) <= VRAM_WIDTH && (y + height) <= VRAM_HEIGHT && !params.IsMaskingEnabled())
+  const u16* src_ptr = static_cast<const u16*>(data);
+  const u16 mask_and = params.GetMaskAND();
+  const u16 mask_or = params.GetMaskOR();
+
+  // Fast path when the rows don't wrap around, the source never overlaps VRAM.
+  if ((x + width) <= VRAM_WIDTH)
   {
-    const u16* src_ptr = static_cast<const u16*>(data);
-    u16* dst_ptr = &m_vram_ptr[y * VRAM_WIDTH + x];
-    for (u32 yoffs = 0; yoffs < height; yoffs++)
+    for (u32 row = 0; row < height; row++)
     {
-      std::copy_n(src_ptr, width, dst_ptr);
+      CopyVRAMRow(&m_vram_ptr[((y + row) % VRAM_HEIGHT) * VRAM_WIDTH + x], src_ptr, width, mask_and, mask_or, false);
       src_ptr += width;
-      dst_ptr += VRAM_WIDTH;
     }
   }
   else
   {
     // Slow path when we need to handle wrap-around.
-    const u16* src_ptr = static_cast<const u16*>(data);
-    const u16 mask_and = params.GetMaskAND();
-    const u16 mask_or = params.GetMaskOR();
-
     for (u32 row = 0; row < height;)
     {
       u16* dst_row_ptr = &m_vram_ptr[((y + row++) % VRAM_HEIGHT) * VRAM_WIDTH];
@@ -792,8 +1450,9 @@ void GPU_SW_Backend::UpdateVRAM(u32 x, u32 y, u32 width, u32 height, const void*
       {
         // TODO: Handle unaligned reads...
         u16* pixel_ptr = &dst_row_ptr[(x + col++) % VRAM_WIDTH];
+        const u16 src_pixel = *(src_ptr++);
         if (((*pixel_ptr) & mask_and) == 0)
-          *pixel_ptr = *(src_ptr++) | mask_or;
+          *pixel_ptr = src_pixel | mask_or;
       }
     }
   }
@@ -834,46 +1493,26 @@ void GPU_SW_Backend::CopyVRAM(u32 src_x, u32 src_y, u32 dst_x, u32 dst_y, u32 wi
     return;
   }
 
-  // This doesn't have a fast path, but do we really need one? It's not common.
+  // Rows don't wrap past this point, so they can be copied a vector at a time. Rows are still done in order, since
+  // a later source row can be an earlier destination row.
   const u16 mask_and = params.GetMaskAND();
   const u16 mask_or = params.GetMaskOR();
 
   // Copy in reverse when src_x < dst_x, this is verified on console.
-  if (src_x < dst_x || ((src_x + width - 1) % VRAM_WIDTH) < ((dst_x + width - 1) % VRAM_WIDTH))
+  const bool reverse = (src_x < dst_x);
+  for (u32 row = 0; row < height; row++)
   {
-    for (u32 row = 0; row < height; row++)
-    {
-      const u16* src_row_ptr = &m_vram_ptr[((src_y + row) % VRAM_HEIGHT) * VRAM_WIDTH];
-      u16* dst_row_ptr = &m_vram_ptr[((dst_y + row) % VRAM_HEIGHT) * VRAM_WIDTH];
-
-      for (s32 col = static_cast<s32>(width - 1); col >= 0; col--)
-      {
-        const u16 src_pixel = src_row_ptr[(src_x + static_cast<u32>(col)) % VRAM_WIDTH];
-        u16* dst_pixel_ptr = &dst_row_ptr[(dst_x + static_cast<u32>(col)) % VRAM_WIDTH];
-        if ((*dst_pixel_ptr & mask_and) == 0)
-          *dst_pixel_ptr = src_pixel | mask_or;
-      }
-    }
-  }
-  else
-  {
-    for (u32 row = 0; row < height; row++)
-    {
-      const u16* src_row_ptr = &m_vram_ptr[((src_y + row) % VRAM_HEIGHT) * VRAM_WIDTH];
-      u16* dst_row_ptr = &m_vram_ptr[((dst_y + row) % VRAM_HEIGHT) * VRAM_WIDTH];
-
-      for (u32 col = 0; col < width; col++)
-      {
-        const u16 src_pixel = src_row_ptr[(src_x + col) % VRAM_WIDTH];
-        u16* dst_pixel_ptr = &dst_row_ptr[(dst_x + col) % VRAM_WIDTH];
-        if ((*dst_pixel_ptr & mask_and) == 0)
-          *dst_pixel_ptr = src_pixel | mask_or;
-      }
-    }
+    const u16* src_row_ptr = &m_vram_ptr[((src_y + row) % VRAM_HEIGHT) * VRAM_WIDTH + src_x];
+    u16* dst_row_ptr = &m_vram_ptr[((dst_y + row) % VRAM_HEIGHT) * VRAM_WIDTH + dst_x];
+    CopyVRAMRow(dst_row_ptr, src_row_ptr, width, mask_and, mask_or, reverse);
   }
 }
 
-void GPU_SW_Backend::FlushRender() {}
+void GPU_SW_Backend::FlushRender()
+{
+  if (!m_worker_threads.empty())
+    WaitForWorkerThreads();
+}
 
 void GPU_SW_Backend::DrawingAreaChanged() {}
 
@@ -4,7 +4,10 @@
 #pragma once
 #include "gpu_backend.h"
 #include <array>
+#include <atomic>
+#include <condition_variable>
 #include <memory>
+#include <mutex>
 #include <vector>
 
 class GPU_SW_Backend final : public GPUBackend
@@ -14,7 +17,9 @@ public:
   ~GPU_SW_Backend() override;
 
   bool Initialize(bool force_thread) override;
+  void UpdateSettings() override;
   void Reset(bool clear_vram) override;
+  void Shutdown() override;
 
   ALWAYS_INLINE_RELEASE u16 GetPixel(const u32 x, const u32 y) const { return m_vram[VRAM_WIDTH * y + x]; }
   ALWAYS_INLINE_RELEASE const u16* GetPixelPtr(const u32 x, const u32 y) const { return &m_vram[VRAM_WIDTH * y + x]; }
@@ -98,17 +103,78 @@ protected:
   void FlushRender() override;
   void DrawingAreaChanged() override;
 
+  //////////////////////////////////////////////////////////////////////////
+  // Worker threads
+  //////////////////////////////////////////////////////////////////////////
+
+  /// The set of VRAM rows rasterized by one thread. Rows are handed out in pairs, so that interlaced rendering still
+  /// spreads across every band. The GPU thread always owns band 0.
+  struct RasterBand
+  {
+    u32 index;
+    u32 count;
+  };
+
+  enum : u32
+  {
+    MAX_QUEUED_DRAW_COMMANDS = 4096,
+    HAZARD_BLOCK_WIDTH = 64,
+    HAZARD_BLOCK_HEIGHT = 16,
+  };
+
+  /// VRAM areas read or written by queued commands, one bit per 64x16 block.
+  using HazardBlockMask = std::array<u16, VRAM_HEIGHT / HAZARD_BLOCK_HEIGHT>;
+  static_assert((VRAM_WIDTH / HAZARD_BLOCK_WIDTH) == 16);
+
+  struct WorkerThread
+  {
+    Threading::Thread thread;
+    alignas(64) std::atomic<u32> position{0};
+  };
+
+  static ALWAYS_INLINE bool IsLineInBand(s32 y, RasterBand band)
+  {
+    return (band.count == 1 || ((static_cast<u32>(y) >> 1) % band.count) == band.index);
+  }
+
+  void StartWorkerThreads(u32 count);
+  void StopWorkerThreads();
+  void WorkerThreadEntryPoint(WorkerThread* worker, RasterBand band);
+  void WaitForWorkerThreads();
+
+  /// Rasterizes the command on this thread, either alone or in parallel with the workers.
+  void SubmitDrawCommand(const GPUBackendDrawCommand* cmd, const Common::Rectangle<u32>& draw_rect,
+                         bool reads_texture);
+  void RasterizeCommand(const GPUBackendDrawCommand* cmd, RasterBand band);
+
+  /// Marks the blocks covered by the rectangle, which can extend past the right edge of VRAM and wrap around.
+  static void IncludeHazardBlocks(HazardBlockMask& mask, const Common::Rectangle<u32>& rect);
+  static bool HazardBlocksIntersect(const HazardBlockMask& lhs, const HazardBlockMask& rhs);
+
+  /// Returns true if texels the command can read fall within the specified rectangle.
+  static bool TextureReadIntersects(const GPUBackendDrawCommand* cmd, const Common::Rectangle<u32>& rect);
+
+  /// Marks the texture page and palette the command can read texels from.
+  static void IncludeTextureReadBlocks(HazardBlockMask& mask, const GPUBackendDrawCommand* cmd);
+
+  /// Returns the bounding rectangle of the vertices clipped to the drawing area, or the whole drawing area if the
+  /// vertices are far enough out of range that the rasterizer would wrap them around.
+  template<typename Vertex>
+  Common::Rectangle<u32> GetVertexDrawRectangle(const Vertex* vertices, u32 num_vertices) const;
+
   //////////////////////////////////////////////////////////////////////////
   // Rasterization
   //////////////////////////////////////////////////////////////////////////
+  u16 GetTexel(const GPUBackendDrawCommand* cmd, u8 texcoord_x, u8 texcoord_y) const;
+
   template<bool texture_enable, bool raw_texture_enable, bool transparency_enable, bool dithering_enable>
   void ShadePixel(const GPUBackendDrawCommand* cmd, u32 x, u32 y, u8 color_r, u8 color_g, u8 color_b, u8 texcoord_x,
                   u8 texcoord_y);
 
   template<bool texture_enable, bool raw_texture_enable, bool transparency_enable>
-  void DrawRectangle(const GPUBackendDrawRectangleCommand* cmd);
+  void DrawRectangle(const GPUBackendDrawRectangleCommand* cmd, RasterBand band);
 
-  using DrawRectangleFunction = void (GPU_SW_Backend::*)(const GPUBackendDrawRectangleCommand* cmd);
+  using DrawRectangleFunction = void (GPU_SW_Backend::*)(const GPUBackendDrawRectangleCommand* cmd, RasterBand band);
   DrawRectangleFunction GetDrawRectangleFunction(bool texture_enable, bool raw_texture_enable,
                                                  bool transparency_enable);
 
@@ -142,15 +208,21 @@ protected:
 
   template<bool shading_enable, bool texture_enable, bool raw_texture_enable, bool transparency_enable,
            bool dithering_enable>
-  void DrawSpan(const GPUBackendDrawPolygonCommand* cmd, s32 y, s32 x_start, s32 x_bound, i_group ig,
+  void DrawSpan(const GPUBackendDrawPolygonCommand* cmd, RasterBand band, s32 y, s32 x_start, s32 x_bound, i_group ig,
                 const i_deltas& idl);
 
+  /// Shades pixels of a span in groups of eight, leaving fewer than eight for the scalar loop.
+  template<bool shading_enable, bool texture_enable, bool raw_texture_enable, bool transparency_enable,
+           bool dithering_enable>
+  void DrawSpanVector(const GPUBackendDrawPolygonCommand* cmd, s32 y, s32& x, s32& w, i_group& ig, const i_deltas& idl);
+
   template<bool shading_enable, bool texture_enable, bool raw_texture_enable, bool transparency_enable,
            bool dithering_enable>
-  void DrawTriangle(const GPUBackendDrawPolygonCommand* cmd, const GPUBackendDrawPolygonCommand::Vertex* v0,
-                    const GPUBackendDrawPolygonCommand::Vertex* v1, const GPUBackendDrawPolygonCommand::Vertex* v2);
+  void DrawTriangle(const GPUBackendDrawPolygonCommand* cmd, RasterBand band,
+                    const GPUBackendDrawPolygonCommand::Vertex* v0, const GPUBackendDrawPolygonCommand::Vertex* v1,
+                    const GPUBackendDrawPolygonCommand::Vertex* v2);
 
-  using DrawTriangleFunction = void (GPU_SW_Backend::*)(const GPUBackendDrawPolygonCommand* cmd,
+  using DrawTriangleFunction = void (GPU_SW_Backend::*)(const GPUBackendDrawPolygonCommand* cmd, RasterBand band,
                                                         const GPUBackendDrawPolygonCommand::Vertex* v0,
                                                         const GPUBackendDrawPolygonCommand::Vertex* v1,
                                                         const GPUBackendDrawPolygonCommand::Vertex* v2);
@@ -158,13 +230,27 @@ protected:
                                                bool transparency_enable, bool dithering_enable);
 
   template<bool shading_enable, bool transparency_enable, bool dithering_enable>
-  void DrawLine(const GPUBackendDrawLineCommand* cmd, const GPUBackendDrawLineCommand::Vertex* p0,
+  void DrawLine(const GPUBackendDrawLineCommand* cmd, RasterBand band, const GPUBackendDrawLineCommand::Vertex* p0,
                 const GPUBackendDrawLineCommand::Vertex* p1);
 
-  using DrawLineFunction = void (GPU_SW_Backend::*)(const GPUBackendDrawLineCommand* cmd,
+  using DrawLineFunction = void (GPU_SW_Backend::*)(const GPUBackendDrawLineCommand* cmd, RasterBand band,
                                                     const GPUBackendDrawLineCommand::Vertex* p0,
                                                     const GPUBackendDrawLineCommand::Vertex* p1);
   DrawLineFunction GetDrawLineFunction(bool shading_enable, bool transparency_enable, bool dithering_enable);
 
   std::array<u16, VRAM_WIDTH * VRAM_HEIGHT> m_vram;
+
+  // Draw commands are queued by pointer into the command FIFO, which are kept alive until the workers catch up.
+  std::array<const GPUBackendDrawCommand*, MAX_QUEUED_DRAW_COMMANDS> m_queued_commands{};
+  alignas(64) std::atomic<u32> m_queue_write_position{0};
+  HazardBlockMask m_queued_write_blocks{};
+  HazardBlockMask m_queued_read_blocks{};
+
+  std::vector<std::unique_ptr<WorkerThread>> m_worker_threads;
+  std::mutex m_worker_mutex;
+  std::condition_variable m_worker_wake_cv;
+  std::condition_variable m_worker_done_cv;
+  std::atomic<u32> m_workers_sleeping{0};
+  std::atomic_bool m_waiting_for_workers{false};
+  bool m_workers_shutdown = false;
 };
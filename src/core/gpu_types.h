@@ -237,7 +237,15 @@ enum class GPUBackendCommandType : u8
   SetDrawingArea,
   DrawPolygon,
   DrawRectangle,
-  DrawLine
+  DrawLine,
+
+  // Only used by the hardware renderer's render thread.
+  HWSetScissor,
+  HWClearDepthBuffer,
+  HWUpdateDepthBufferFromMaskBit,
+  HWUpdateVRAMReadTexture,
+  HWDecodePaletteTexture,
+  HWDrawBatch
 };
 
 union GPUBackendCommandParameters
@@ -393,6 +401,13 @@ struct GPUBackendDrawLineCommand : public GPUBackendDrawCommand
   Vertex vertices[0];
 };
 
+struct GPUBackendThreadStats
+{
+  u32 wakeups;
+  u32 sync_stalls;
+  float sync_stall_time_ms;
+};
+
 #ifdef _MSC_VER
 #pragma warning(pop)
 #endif
@@ -4,6 +4,7 @@
 #include "gte.h"
 #include "common/assert.h"
 #include "common/bitutils.h"
+#include "common/platform.h"
 #include "util/state_wrapper.h"
 #include "cpu_core.h"
 #include "cpu_core_private.h"
@@ -158,6 +159,123 @@ ALWAYS_INLINE static u32 TruncateRGB(s32 value)
   return static_cast<u32>(value);
 }
 
+// The three rows of a matrix-vector product are independent, so they can be computed in parallel, one row per 64-bit
+// lane (the fourth lane is padding). The partial sums are checked and sign-extended at the same points as the scalar
+// path, so the results and flags are identical. This is only used on AArch64, where NEON is always available and has
+// 64-bit lane shifts and compares. On x86 the lane inserts/extracts cost more than the branchy scalar code saves, even
+// with AVX2, and MSVC doesn't support vector extensions anyway.
+#if (defined(__GNUC__) || defined(__clang__)) && defined(CPU_AARCH64)
+#define GTE_USE_VECTOR_MAC 1
+#endif
+
+#ifdef GTE_USE_VECTOR_MAC
+
+using s32x4 = s32 __attribute__((vector_size(16)));
+using s64x4 = s64 __attribute__((vector_size(32)));
+
+static constexpr s64x4 MAC123_MIN_VECTOR = {MAC123_MIN_VALUE, MAC123_MIN_VALUE, MAC123_MIN_VALUE, MAC123_MIN_VALUE};
+static constexpr s64x4 MAC123_MAX_VECTOR = {MAC123_MAX_VALUE, MAC123_MAX_VALUE, MAC123_MAX_VALUE, MAC123_MAX_VALUE};
+static constexpr s64x4 MAC123_OVERFLOW_FLAGS = {1 << 30, 1 << 29, 1 << 28, 0};
+static constexpr s64x4 MAC123_UNDERFLOW_FLAGS = {1 << 27, 1 << 26, 1 << 25, 0};
+static constexpr s64x4 IR123_SATURATED_FLAGS = {1 << 24, 1 << 23, 1 << 22, 0};
+
+ALWAYS_INLINE static void CheckMACOverflowVector(s64x4 value, s64x4& flags)
+{
+  // comparisons produce all-ones in lanes where they're true
+  flags |= (value < MAC123_MIN_VECTOR) & MAC123_UNDERFLOW_FLAGS;
+  flags |= (value > MAC123_MAX_VECTOR) & MAC123_OVERFLOW_FLAGS;
+}
+
+ALWAYS_INLINE static s64x4 SignExtendMACResultVector(s64x4 value, s64x4& flags)
+{
+  CheckMACOverflowVector(value, flags);
+  return (value << 20) >> 20;
+}
+
+/// Equivalent to s64(s32(value >> shift)) for each lane.
+ALWAYS_INLINE static s64x4 ShiftAndTruncateVector(s64x4 value, u8 shift)
+{
+  return __builtin_convertvector(__builtin_convertvector(value >> shift, s32x4), s64x4);
+}
+
+ALWAYS_INLINE static void ApplyFlagsVector(s64x4 flags)
+{
+  REGS.FLAG.bits |= static_cast<u32>(flags[0] | flags[1] | flags[2]);
+}
+
+/// Multiplies each column of M by the corresponding vector component. s16 * s16 can't overflow 32 bits, so the
+/// multiply is done in 32-bit lanes and widened afterwards.
+ALWAYS_INLINE static void MulMatColumnsVector(const s16 M[3][3], const s16 Vx, const s16 Vy, const s16 Vz, s64x4& p0,
+                                              s64x4& p1, s64x4& p2)
+{
+  const s32x4 col0 = {M[0][0], M[1][0], M[2][0], 0};
+  const s32x4 col1 = {M[0][1], M[1][1], M[2][1], 0};
+  const s32x4 col2 = {M[0][2], M[1][2], M[2][2], 0};
+  p0 = __builtin_convertvector(col0 * static_cast<s32>(Vx), s64x4);
+  p1 = __builtin_convertvector(col1 * static_cast<s32>(Vy), s64x4);
+  p2 = __builtin_convertvector(col2 * static_cast<s32>(Vz), s64x4);
+}
+
+/// Computes [T SHL 12] + M * V for all three rows, with the partial sum checks, but without the final check.
+template<bool translation>
+ALWAYS_INLINE static s64x4 MulMatVecVector(const s16 M[3][3], const s32 T[3], const s16 Vx, const s16 Vy,
+                                           const s16 Vz, s64x4& flags)
+{
+  s64x4 p0, p1, p2;
+  MulMatColumnsVector(M, Vx, Vy, Vz, p0, p1, p2);
+
+  s64x4 value;
+  if constexpr (translation)
+    value = SignExtendMACResultVector((s64x4{T[0], T[1], T[2], 0} << 12) + p0, flags);
+  else
+    value = p0;
+
+  return SignExtendMACResultVector(value + p1, flags) + p2;
+}
+
+ALWAYS_INLINE static void TruncateAndSetMACVector(s64x4 value, u8 shift, s64x4& flags)
+{
+  CheckMACOverflowVector(value, flags);
+
+  // shift should be done before storing to avoid losing precision
+  const s64x4 value32 = ShiftAndTruncateVector(value, shift);
+  REGS.dr32[25] = static_cast<u32>(value32[0]);
+  REGS.dr32[26] = static_cast<u32>(value32[1]);
+  REGS.dr32[27] = static_cast<u32>(value32[2]);
+}
+
+/// Saturates sign-extended 32-bit values, returning the IR values without storing them.
+ALWAYS_INLINE static s64x4 TruncateIRVector(s64x4 value32, bool lm, s64x4& flags)
+{
+  const s64 min_value = lm ? 0 : IR123_MIN_VALUE;
+  const s64x4 min_vector = {min_value, min_value, min_value, min_value};
+  const s64x4 max_vector = {IR123_MAX_VALUE, IR123_MAX_VALUE, IR123_MAX_VALUE, IR123_MAX_VALUE};
+  const s64x4 below = value32 < min_vector;
+  const s64x4 above = value32 > max_vector;
+  flags |= (below | above) & IR123_SATURATED_FLAGS;
+  return (value32 & ~(below | above)) | (min_vector & below) | (max_vector & above);
+}
+
+ALWAYS_INLINE static s64x4 TruncateAndSetMACAndIRVector(s64x4 value, u8 shift, bool lm, s64x4& flags)
+{
+  CheckMACOverflowVector(value, flags);
+
+  // shift should be done before storing to avoid losing precision
+  const s64x4 value32 = ShiftAndTruncateVector(value, shift);
+  REGS.dr32[25] = static_cast<u32>(value32[0]);
+  REGS.dr32[26] = static_cast<u32>(value32[1]);
+  REGS.dr32[27] = static_cast<u32>(value32[2]);
+
+  // store sign-extended 16-bit value as 32-bit
+  const s64x4 ir = TruncateIRVector(value32, lm, flags);
+  REGS.dr32[9] = static_cast<u32>(ir[0]);
+  REGS.dr32[10] = static_cast<u32>(ir[1]);
+  REGS.dr32[11] = static_cast<u32>(ir[2]);
+  return ir;
+}
+
+#endif
+
 void Initialize()
 {
   s_aspect_ratio = DisplayAspectRatio::R4_3;
@@ -427,6 +545,20 @@ static void PushRGBFromMAC()
   REGS.dr32[22] = r | (g << 8) | (b << 16) | (c << 24); // RGB2 <- Value
 }
 
+static constexpr std::array<u8, 257> GenerateUNRTable()
+{
+  // unr_table[i] = max(0, (40000h / (i + 100h) + 1) / 2 - 101h), with one extra entry for "(d-7FC0h)/80h"=100h
+  std::array<u8, 257> table = {};
+  for (u32 i = 0; i < static_cast<u32>(table.size()); i++)
+    table[i] = static_cast<u8>(std::max<s32>(0, static_cast<s32>((0x40000 / (i + 0x100) + 1) / 2) - 0x101));
+
+  return table;
+}
+
+static constexpr std::array<u8, 257> s_unr_table = GenerateUNRTable();
+static_assert(s_unr_table[0] == 0xFF && s_unr_table[0x80] == 0x54 && s_unr_table[0xFF] == 0x00 &&
+              s_unr_table[0x100] == 0x00);
+
 ALWAYS_INLINE static u32 UNRDivide(u32 lhs, u32 rhs)
 {
   if (rhs * 2 <= lhs)
@@ -435,32 +567,13 @@ ALWAYS_INLINE static u32 UNRDivide(u32 lhs, u32 rhs)
     return 0x1FFFF;
   }
 
-  const u32 shift = (rhs == 0) ? 16 : CountLeadingZeros(static_cast<u16>(rhs));
+  // rhs can't be zero here, that always overflows
+  const u32 shift = CountLeadingZeros(static_cast<u16>(rhs));
   lhs <<= shift;
   rhs <<= shift;
 
-  static constexpr std::array<u8, 257> unr_table = {{
-    0xFF, 0xFD, 0xFB, 0xF9, 0xF7, 0xF5, 0xF3, 0xF1, 0xEF, 0xEE, 0xEC, 0xEA, 0xE8, 0xE6, 0xE4, 0xE3, //
-    0xE1, 0xDF, 0xDD, 0xDC, 0xDA, 0xD8, 0xD6, 0xD5, 0xD3, 0xD1, 0xD0, 0xCE, 0xCD, 0xCB, 0xC9, 0xC8, //  00h..3Fh
-    0xC6, 0xC5, 0xC3, 0xC1, 0xC0, 0xBE, 0xBD, 0xBB, 0xBA, 0xB8, 0xB7, 0xB5, 0xB4, 0xB2, 0xB1, 0xB0, //
-    0xAE, 0xAD, 0xAB, 0xAA, 0xA9, 0xA7, 0xA6, 0xA4, 0xA3, 0xA2, 0xA0, 0x9F, 0x9E, 0x9C, 0x9B, 0x9A, //
-    0x99, 0x97, 0x96, 0x95, 0x94, 0x92, 0x91, 0x90, 0x8F, 0x8D, 0x8C, 0x8B, 0x8A, 0x89, 0x87, 0x86, //
-    0x85, 0x84, 0x83, 0x82, 0x81, 0x7F, 0x7E, 0x7D, 0x7C, 0x7B, 0x7A, 0x79, 0x78, 0x77, 0x75, 0x74, //  40h..7Fh
-    0x73, 0x72, 0x71, 0x70, 0x6F, 0x6E, 0x6D, 0x6C, 0x6B, 0x6A, 0x69, 0x68, 0x67, 0x66, 0x65, 0x64, //
-    0x63, 0x62, 0x61, 0x60, 0x5F, 0x5E, 0x5D, 0x5D, 0x5C, 0x5B, 0x5A, 0x59, 0x58, 0x57, 0x56, 0x55, //
-    0x54, 0x53, 0x53, 0x52, 0x51, 0x50, 0x4F, 0x4E, 0x4D, 0x4D, 0x4C, 0x4B, 0x4A, 0x49, 0x48, 0x48, //
-    0x47, 0x46, 0x45, 0x44, 0x43, 0x43, 0x42, 0x41, 0x40, 0x3F, 0x3F, 0x3E, 0x3D, 0x3C, 0x3C, 0x3B, //  80h..BFh
-    0x3A, 0x39, 0x39, 0x38, 0x37, 0x36, 0x36, 0x35, 0x34, 0x33, 0x33, 0x32, 0x31, 0x31, 0x30, 0x2F, //
-    0x2E, 0x2E, 0x2D, 0x2C, 0x2C, 0x2B, 0x2A, 0x2A, 0x29, 0x28, 0x28, 0x27, 0x26, 0x26, 0x25, 0x24, //
-    0x24, 0x23, 0x22, 0x22, 0x21, 0x20, 0x20, 0x1F, 0x1E, 0x1E, 0x1D, 0x1D, 0x1C, 0x1B, 0x1B, 0x1A, //
-    0x19, 0x19, 0x18, 0x18, 0x17, 0x16, 0x16, 0x15, 0x15, 0x14, 0x14, 0x13, 0x12, 0x12, 0x11, 0x11, //  C0h..FFh
-    0x10, 0x0F, 0x0F, 0x0E, 0x0E, 0x0D, 0x0D, 0x0C, 0x0C, 0x0B, 0x0A, 0x0A, 0x09, 0x09, 0x08, 0x08, //
-    0x07, 0x07, 0x06, 0x06, 0x05, 0x05, 0x04, 0x04, 0x03, 0x03, 0x02, 0x02, 0x01, 0x01, 0x00, 0x00, //
-    0x00 // <-- one extra table entry (for "(d-7FC0h)/80h"=100h)
-  }};
-
   const u32 divisor = rhs | 0x8000;
-  const s32 x = static_cast<s32>(0x101 + ZeroExtend32(unr_table[((divisor & 0x7FFF) + 0x40) >> 7]));
+  const s32 x = static_cast<s32>(0x101 + ZeroExtend32(s_unr_table[((divisor & 0x7FFF) + 0x40) >> 7]));
   const s32 d = ((static_cast<s32>(ZeroExtend32(divisor)) * -x) + 0x80) >> 8;
   const u32 recip = static_cast<u32>(((x * (0x20000 + d)) + 0x80) >> 8);
 
@@ -473,6 +586,11 @@ ALWAYS_INLINE static u32 UNRDivide(u32 lhs, u32 rhs)
 
 static void MulMatVec(const s16 M[3][3], const s16 Vx, const s16 Vy, const s16 Vz, u8 shift, bool lm)
 {
+#ifdef GTE_USE_VECTOR_MAC
+  s64x4 flags = {};
+  TruncateAndSetMACAndIRVector(MulMatVecVector<false>(M, nullptr, Vx, Vy, Vz, flags), shift, lm, flags);
+  ApplyFlagsVector(flags);
+#else
 #define dot3(i)                                                                                                        \
   TruncateAndSetMACAndIR<i + 1>(SignExtendMACResult<i + 1>((s64(M[i][0]) * s64(Vx)) + (s64(M[i][1]) * s64(Vy))) +      \
                                   (s64(M[i][2]) * s64(Vz)),                                                            \
@@ -483,10 +601,16 @@ static void MulMatVec(const s16 M[3][3], const s16 Vx, const s16 Vy, const s16 V
   dot3(2);
 
 #undef dot3
+#endif
 }
 
 static void MulMatVec(const s16 M[3][3], const s32 T[3], const s16 Vx, const s16 Vy, const s16 Vz, u8 shift, bool lm)
 {
+#ifdef GTE_USE_VECTOR_MAC
+  s64x4 flags = {};
+  TruncateAndSetMACAndIRVector(MulMatVecVector<true>(M, T, Vx, Vy, Vz, flags), shift, lm, flags);
+  ApplyFlagsVector(flags);
+#else
 #define dot3(i)                                                                                                        \
   TruncateAndSetMACAndIR<i + 1>(                                                                                       \
     SignExtendMACResult<i + 1>(SignExtendMACResult<i + 1>((s64(T[i]) << 12) + (s64(M[i][0]) * s64(Vx))) +              \
@@ -499,11 +623,24 @@ static void MulMatVec(const s16 M[3][3], const s32 T[3], const s16 Vx, const s16
   dot3(2);
 
 #undef dot3
+#endif
 }
 
 static void MulMatVecBuggy(const s16 M[3][3], const s32 T[3], const s16 Vx, const s16 Vy, const s16 Vz, u8 shift,
                            bool lm)
 {
+#ifdef GTE_USE_VECTOR_MAC
+  s64x4 flags = {};
+  s64x4 p0, p1, p2;
+  MulMatColumnsVector(M, Vx, Vy, Vz, p0, p1, p2);
+
+  // The result of the first step only affects the IR saturation flags, the registers are overwritten. The second MAC
+  // check on its sign-extended value, and the check on a single s16 * s16 product, can never fail.
+  const s64x4 tr = SignExtendMACResultVector((s64x4{T[0], T[1], T[2], 0} << 12) + p0, flags);
+  TruncateIRVector(ShiftAndTruncateVector(tr, shift), false, flags);
+  TruncateAndSetMACAndIRVector(p1 + p2, shift, lm, flags);
+  ApplyFlagsVector(flags);
+#else
 #define dot3(i)                                                                                                        \
   do                                                                                                                   \
   {                                                                                                                    \
@@ -520,6 +657,7 @@ static void MulMatVecBuggy(const s16 M[3][3], const s32 T[3], const s16 Vx, cons
   dot3(2);
 
 #undef dot3
+#endif
 }
 
 static void Execute_MVMVA(Instruction inst)
@@ -651,12 +789,22 @@ static void RTPS(const s16 V[3], u8 shift, bool lm, bool last)
   // IR1 = MAC1 = (TRX*1000h + RT11*VX0 + RT12*VY0 + RT13*VZ0) SAR (sf*12)
   // IR2 = MAC2 = (TRY*1000h + RT21*VX0 + RT22*VY0 + RT23*VZ0) SAR (sf*12)
   // IR3 = MAC3 = (TRZ*1000h + RT31*VX0 + RT32*VY0 + RT33*VZ0) SAR (sf*12)
+#ifdef GTE_USE_VECTOR_MAC
+  s64x4 flags = {};
+  const s64x4 xyz = MulMatVecVector<true>(REGS.RT, REGS.TR, V[0], V[1], V[2], flags);
+  TruncateAndSetMACVector(xyz, shift, flags);
+  ApplyFlagsVector(flags);
+  const s64 x = xyz[0];
+  const s64 y = xyz[1];
+  const s64 z = xyz[2];
+#else
   const s64 x = dot3(0);
   const s64 y = dot3(1);
   const s64 z = dot3(2);
   TruncateAndSetMAC<1>(x, shift);
   TruncateAndSetMAC<2>(y, shift);
   TruncateAndSetMAC<3>(z, shift);
+#endif
   TruncateAndSetIR<1>(REGS.MAC1, lm);
   TruncateAndSetIR<2>(REGS.MAC2, lm);
 
@@ -860,6 +1008,18 @@ static ALWAYS_INLINE void InterpolateColor(s64 in_MAC1, s64 in_MAC2, s64 in_MAC3
 {
   // [MAC1,MAC2,MAC3] = MAC+(FC-MAC)*IR0
   //   [IR1,IR2,IR3] = (([RFC,GFC,BFC] SHL 12) - [MAC1,MAC2,MAC3]) SAR (sf*12)
+#ifdef GTE_USE_VECTOR_MAC
+  s64x4 flags = {};
+  const s64x4 in_MAC = {in_MAC1, in_MAC2, in_MAC3, 0};
+  const s64x4 ir = TruncateAndSetMACAndIRVector((s64x4{REGS.FC[0], REGS.FC[1], REGS.FC[2], 0} << 12) - in_MAC, shift,
+                                                false, flags);
+
+  //   [MAC1,MAC2,MAC3] = (([IR1,IR2,IR3] * IR0) + [MAC1,MAC2,MAC3])
+  // [MAC1,MAC2,MAC3] = [MAC1,MAC2,MAC3] SAR (sf*12)
+  const s32x4 ir_ir0 = __builtin_convertvector(ir, s32x4) * static_cast<s32>(REGS.IR0);
+  TruncateAndSetMACAndIRVector(__builtin_convertvector(ir_ir0, s64x4) + in_MAC, shift, lm, flags);
+  ApplyFlagsVector(flags);
+#else
   TruncateAndSetMACAndIR<1>((s64(REGS.FC[0]) << 12) - in_MAC1, shift, false);
   TruncateAndSetMACAndIR<2>((s64(REGS.FC[1]) << 12) - in_MAC2, shift, false);
   TruncateAndSetMACAndIR<3>((s64(REGS.FC[2]) << 12) - in_MAC3, shift, false);
@@ -869,6 +1029,7 @@ static ALWAYS_INLINE void InterpolateColor(s64 in_MAC1, s64 in_MAC2, s64 in_MAC3
   TruncateAndSetMACAndIR<1>(s64(s32(REGS.IR1) * s32(REGS.IR0)) + in_MAC1, shift, lm);
   TruncateAndSetMACAndIR<2>(s64(s32(REGS.IR2) * s32(REGS.IR0)) + in_MAC2, shift, lm);
   TruncateAndSetMACAndIR<3>(s64(s32(REGS.IR3) * s32(REGS.IR0)) + in_MAC3, shift, lm);
+#endif
 }
 
 static void NCS(const s16 V[3], u8 shift, bool lm)
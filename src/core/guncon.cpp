@@ -7,6 +7,7 @@
 #include "gpu.h"
 #include "host.h"
 #include "host_display.h"
+#include "input_movie.h"
 #include "resources.h"
 #include "system.h"
 #include "util/state_wrapper.h"
@@ -51,6 +52,15 @@ bool GunCon::DoState(StateWrapper& sw, bool apply_input_state)
   return true;
 }
 
+bool GunCon::DoInputState(StateWrapper& sw)
+{
+  sw.Do(&m_button_state);
+  sw.Do(&m_position_x);
+  sw.Do(&m_position_y);
+  sw.Do(&m_shoot_offscreen);
+  return !sw.HasError();
+}
+
 float GunCon::GetBindState(u32 index) const
 {
   if (index >= s_button_indices.size())
@@ -176,6 +186,10 @@ bool GunCon::Transfer(const u8 data_in, u8* data_out)
 
 void GunCon::UpdatePosition()
 {
+  // replayed input movies supply the position
+  if (InputMovie::IsReplaying())
+    return;
+
   // get screen coordinates
   const s32 mouse_x = g_host_display->GetMousePositionX();
   const s32 mouse_y = g_host_display->GetMousePositionY();
@@ -30,6 +30,7 @@ public:
 
   void Reset() override;
   bool DoState(StateWrapper& sw, bool apply_input_state) override;
+  bool DoInputState(StateWrapper& sw) override;
   
   void LoadSettings(SettingsInterface& si, const char* section) override;
   bool GetSoftwareCursor(const Common::RGBA8Image** image, float* image_scale, bool* relative_mode) override;
@@ -73,6 +73,10 @@ void DisplayLoadingScreen(const char* message, int progress_min = -1, int progre
 /// Intensity is normalized from 0 to 1.
 void SetPadVibrationIntensity(u32 pad_index, float large_or_single_motor_intensity, float small_motor_intensity);
 
+/// Internal method used by pads to apply input which was received by the polling thread since the last frame.
+/// If poll_sources is set, the input sources are polled first when the polling thread isn't running.
+void ProcessQueuedInputEvents(bool poll_sources);
+
 /// Enables "relative" mouse mode, locking the cursor position and returning relative coordinates.
 void SetMouseMode(bool relative, bool hide_cursor);
 
@@ -7,7 +7,9 @@
 #include "common/file_system.h"
 #include "common/log.h"
 #include "common/string_util.h"
+#include "common/threading.h"
 #include "common/timer.h"
+#include "fmt/format.h"
 #include "settings.h"
 #include "stb_image.h"
 #include "stb_image_resize.h"
@@ -15,7 +17,6 @@
 #include <cerrno>
 #include <cmath>
 #include <cstring>
-#include <thread>
 #include <vector>
 Log_SetChannel(HostDisplay);
 
@@ -143,6 +144,8 @@ void HostDisplay::ThrottlePresentation()
   Common::Timer::SleepUntil(m_last_frame_displayed_time, false);
 }
 
+void HostDisplay::WaitForSwapChain() {}
+
 bool HostDisplay::GetHostRefreshRate(float* refresh_rate)
 {
   if (m_window_info.surface_refresh_rate > 0.0f)
@@ -164,6 +167,46 @@ float HostDisplay::GetAndResetAccumulatedGPUTime()
   return 0.0f;
 }
 
+HostDisplay::GPUTimingScopeTimes HostDisplay::GetAndResetAccumulatedGPUTimingScopeTimes()
+{
+  return {};
+}
+
+void HostDisplay::OnGPUTimingScopeChanged(u32 scope) {}
+
+const std::string& HostDisplay::GetGPUTimingScopeName(u32 scope) const
+{
+  static constexpr std::array<const char*, static_cast<size_t>(GPUTimingScope::PostProcessing)> fixed_names = {
+    {"Other", "Batch Draws", "VRAM Transfers", "VRAM Readbacks", "Downsample", "Display", "Overlays"}};
+  static const std::array<std::string, MAX_GPU_TIMING_SCOPES> default_names = []() {
+    std::array<std::string, MAX_GPU_TIMING_SCOPES> names;
+    for (u32 i = 0; i < MAX_GPU_TIMING_SCOPES; i++)
+    {
+      names[i] = (i < fixed_names.size()) ?
+                   std::string(fixed_names[i]) :
+                   fmt::format("Post Processing {}", i - static_cast<u32>(GPUTimingScope::PostProcessing) + 1);
+    }
+    return names;
+  }();
+
+  DebugAssert(scope < MAX_GPU_TIMING_SCOPES);
+  return m_gpu_timing_scope_names[scope].empty() ? default_names[scope] : m_gpu_timing_scope_names[scope];
+}
+
+void HostDisplay::SetPostProcessingGPUTimingScopeNames(const std::vector<std::string>& stage_names)
+{
+  for (u32 i = 0; i < MAX_POST_PROCESSING_TIMING_SCOPES; i++)
+  {
+    std::string& name = m_gpu_timing_scope_names[static_cast<u32>(GPUTimingScope::PostProcessing) + i];
+    if (i >= stage_names.size())
+      name.clear();
+    else if (i == (MAX_POST_PROCESSING_TIMING_SCOPES - 1) && stage_names.size() > MAX_POST_PROCESSING_TIMING_SCOPES)
+      name = "Post Processing (Remaining)";
+    else
+      name = fmt::format("Post Processing: {}", stage_names[i]);
+  }
+}
+
 void HostDisplay::SetSoftwareCursor(std::unique_ptr<GPUTexture> texture, float scale /*= 1.0f*/)
 {
   m_cursor_texture = std::move(texture);
@@ -379,7 +422,7 @@ std::tuple<float, float> HostDisplay::ConvertWindowCoordinatesToDisplayCoordinat
   return std::make_tuple(display_x, display_y);
 }
 
-static bool CompressAndWriteTextureToFile(u32 width, u32 height, std::string filename, FileSystem::ManagedCFilePtr fp,
+static bool CompressAndWriteTextureToFile(u32 width, u32 height, const std::string& filename, std::FILE* fp,
                                           bool clear_alpha, bool flip_y, u32 resize_width, u32 resize_height,
                                           std::vector<u32> texture_data, u32 texture_data_stride,
                                           GPUTexture::Format texture_format)
@@ -430,19 +473,19 @@ static bool CompressAndWriteTextureToFile(u32 width, u32 height, std::string fil
   if (StringUtil::Strcasecmp(extension, ".png") == 0)
   {
     result =
-      (stbi_write_png_to_func(write_func, fp.get(), width, height, 4, texture_data.data(), texture_data_stride) != 0);
+      (stbi_write_png_to_func(write_func, fp, width, height, 4, texture_data.data(), texture_data_stride) != 0);
   }
   else if (StringUtil::Strcasecmp(extension, ".jpg") == 0)
   {
-    result = (stbi_write_jpg_to_func(write_func, fp.get(), width, height, 4, texture_data.data(), 95) != 0);
+    result = (stbi_write_jpg_to_func(write_func, fp, width, height, 4, texture_data.data(), 95) != 0);
   }
   else if (StringUtil::Strcasecmp(extension, ".tga") == 0)
   {
-    result = (stbi_write_tga_to_func(write_func, fp.get(), width, height, 4, texture_data.data()) != 0);
+    result = (stbi_write_tga_to_func(write_func, fp, width, height, 4, texture_data.data()) != 0);
   }
   else if (StringUtil::Strcasecmp(extension, ".bmp") == 0)
   {
-    result = (stbi_write_bmp_to_func(write_func, fp.get(), width, height, 4, texture_data.data()) != 0);
+    result = (stbi_write_bmp_to_func(write_func, fp, width, height, 4, texture_data.data()) != 0);
   }
 
   if (!result)
@@ -454,6 +497,35 @@ static bool CompressAndWriteTextureToFile(u32 width, u32 height, std::string fil
   return true;
 }
 
+static Threading::TaskGroup& GetScreenshotWriteGroup()
+{
+  static Threading::TaskGroup group;
+  return group;
+}
+
+static void QueueCompressAndWriteTextureToFile(u32 width, u32 height, std::string filename,
+                                               FileSystem::ManagedCFilePtr fp, bool clear_alpha, bool flip_y,
+                                               u32 resize_width, u32 resize_height, std::vector<u32> texture_data,
+                                               u32 texture_data_stride, GPUTexture::Format texture_format)
+{
+  // Each queued screenshot holds onto its pixels, so don't let them pile up if we're dumping every frame.
+  static constexpr u32 MAX_PENDING_SCREENSHOT_WRITES = 8;
+  Threading::TaskGroup& group = GetScreenshotWriteGroup();
+  if (group.GetPendingCount() >= MAX_PENDING_SCREENSHOT_WRITES)
+    group.Wait();
+
+  // Tasks have to be copyable, the file handle isn't.
+  std::shared_ptr<std::FILE> shared_fp(fp.release(), [](std::FILE* fp) { std::fclose(fp); });
+  group.Submit(
+    [width, height, filename = std::move(filename), shared_fp = std::move(shared_fp), clear_alpha, flip_y,
+     resize_width, resize_height, texture_data = std::move(texture_data), texture_data_stride,
+     texture_format]() mutable {
+      CompressAndWriteTextureToFile(width, height, filename, shared_fp.get(), clear_alpha, flip_y, resize_width,
+                                    resize_height, std::move(texture_data), texture_data_stride, texture_format);
+    },
+    Threading::TaskPool::Priority::Low);
+}
+
 bool HostDisplay::WriteTextureToFile(GPUTexture* texture, u32 x, u32 y, u32 width, u32 height, std::string filename,
                                      bool clear_alpha /* = true */, bool flip_y /* = false */,
                                      u32 resize_width /* = 0 */, u32 resize_height /* = 0 */,
@@ -476,15 +548,14 @@ bool HostDisplay::WriteTextureToFile(GPUTexture* texture, u32 x, u32 y, u32 widt
 
   if (!compress_on_thread)
   {
-    return CompressAndWriteTextureToFile(width, height, std::move(filename), std::move(fp), clear_alpha, flip_y,
-                                         resize_width, resize_height, std::move(texture_data), texture_data_stride,
+    return CompressAndWriteTextureToFile(width, height, filename, fp.get(), clear_alpha, flip_y, resize_width,
+                                         resize_height, std::move(texture_data), texture_data_stride,
                                          texture->GetFormat());
   }
 
-  std::thread compress_thread(CompressAndWriteTextureToFile, width, height, std::move(filename), std::move(fp),
-                              clear_alpha, flip_y, resize_width, resize_height, std::move(texture_data),
-                              texture_data_stride, texture->GetFormat());
-  compress_thread.detach();
+  QueueCompressAndWriteTextureToFile(width, height, std::move(filename), std::move(fp), clear_alpha, flip_y,
+                                     resize_width, resize_height, std::move(texture_data), texture_data_stride,
+                                     texture->GetFormat());
   return true;
 }
 
@@ -612,12 +683,17 @@ bool HostDisplay::WriteDisplayTextureToBuffer(std::vector<u32>* buffer, u32 resi
   }
   else
   {
-    *buffer = texture_data;
+    *buffer = std::move(texture_data);
   }
 
   return true;
 }
 
+void HostDisplay::WaitForScreenshotWrites()
+{
+  GetScreenshotWriteGroup().Wait();
+}
+
 bool HostDisplay::WriteScreenshotToFile(std::string filename, bool internal_resolution /* = false */,
                                         bool compress_on_thread /* = false */)
 {
@@ -691,12 +767,11 @@ bool HostDisplay::WriteScreenshotToFile(std::string filename, bool internal_reso
 
   if (!compress_on_thread)
   {
-    return CompressAndWriteTextureToFile(width, height, std::move(filename), std::move(fp), true, UsesLowerLeftOrigin(),
-                                         width, height, std::move(pixels), pixels_stride, pixels_format);
+    return CompressAndWriteTextureToFile(width, height, filename, fp.get(), true, UsesLowerLeftOrigin(), width,
+                                         height, std::move(pixels), pixels_stride, pixels_format);
   }
 
-  std::thread compress_thread(CompressAndWriteTextureToFile, width, height, std::move(filename), std::move(fp), true,
-                              UsesLowerLeftOrigin(), width, height, std::move(pixels), pixels_stride, pixels_format);
-  compress_thread.detach();
+  QueueCompressAndWriteTextureToFile(width, height, std::move(filename), std::move(fp), true, UsesLowerLeftOrigin(),
+                                     width, height, std::move(pixels), pixels_stride, pixels_format);
   return true;
 }
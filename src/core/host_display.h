@@ -6,6 +6,9 @@
 #include "common/rectangle.h"
 #include "common/window_info.h"
 #include "types.h"
+#include <algorithm>
+#include <array>
+#include <cstdlib>
 #include <memory>
 #include <string>
 #include <string_view>
@@ -22,10 +25,30 @@ enum class RenderAPI : u32
   OpenGLES
 };
 
+// Phases of the frame which GPU time is broken down into, when GPU timing is enabled.
+// Post-processing stages are numbered from PostProcessing.
+enum class GPUTimingScope : u8
+{
+  Other,
+  BatchDraws,
+  VRAMTransfers,
+  VRAMReadbacks,
+  Downsample,
+  Display,
+  Overlays,
+  PostProcessing,
+};
+
 // Interface to the frontend's renderer.
 class HostDisplay
 {
 public:
+  static constexpr u32 MAX_GPU_TIMING_SCOPES = 16;
+  static constexpr u32 MAX_POST_PROCESSING_TIMING_SCOPES =
+    MAX_GPU_TIMING_SCOPES - static_cast<u32>(GPUTimingScope::PostProcessing);
+
+  using GPUTimingScopeTimes = std::array<float, MAX_GPU_TIMING_SCOPES>;
+
   struct AdapterAndModeList
   {
     std::vector<std::string> adapter_names;
@@ -58,6 +81,8 @@ public:
   }
 
   ALWAYS_INLINE const void* GetDisplayTextureHandle() const { return m_display_texture; }
+  ALWAYS_INLINE s32 GetDisplayTextureViewWidth() const { return m_display_texture_view_width; }
+  ALWAYS_INLINE s32 GetDisplayTextureViewHeight() const { return std::abs(m_display_texture_view_height); }
   ALWAYS_INLINE s32 GetDisplayWidth() const { return m_display_width; }
   ALWAYS_INLINE s32 GetDisplayHeight() const { return m_display_height; }
   ALWAYS_INLINE float GetDisplayAspectRatio() const { return m_display_aspect_ratio; }
@@ -110,6 +135,10 @@ public:
   ALWAYS_INLINE bool IsVsyncEnabled() const { return m_vsync_enabled; }
   virtual void SetVSync(bool enabled) = 0;
 
+  /// Blocks until the swap chain can queue another frame without stalling in Render(). Only does anything for swap
+  /// chains with a frame latency waitable object, where presenting doesn't block.
+  virtual void WaitForSwapChain();
+
   /// ImGui context management, usually called by derived classes.
   virtual bool CreateImGuiContext() = 0;
   virtual void DestroyImGuiContext() = 0;
@@ -172,6 +201,28 @@ public:
   /// Returns the amount of GPU time utilized since the last time this method was called.
   virtual float GetAndResetAccumulatedGPUTime();
 
+  /// Attributes GPU work from this point onwards to the specified scope. Only does anything when timing is enabled.
+  ALWAYS_INLINE void SetGPUTimingScope(GPUTimingScope scope) { SetGPUTimingScope(static_cast<u32>(scope)); }
+  ALWAYS_INLINE void SetPostProcessingGPUTimingScope(u32 stage)
+  {
+    SetGPUTimingScope(static_cast<u32>(GPUTimingScope::PostProcessing) +
+                      std::min(stage, MAX_POST_PROCESSING_TIMING_SCOPES - 1));
+  }
+  ALWAYS_INLINE void SetGPUTimingScope(u32 scope)
+  {
+    if (m_gpu_timing_enabled && m_gpu_timing_scope != scope)
+    {
+      m_gpu_timing_scope = scope;
+      OnGPUTimingScopeChanged(scope);
+    }
+  }
+
+  /// Returns the GPU time in milliseconds for each scope since the last time this method was called.
+  virtual GPUTimingScopeTimes GetAndResetAccumulatedGPUTimingScopeTimes();
+
+  /// Returns the display name for a timing scope. Post-processing stages are named after their shader.
+  const std::string& GetGPUTimingScopeName(u32 scope) const;
+
   /// Sets the software cursor to the specified texture. Ownership of the texture is transferred.
   void SetSoftwareCursor(std::unique_ptr<GPUTexture> texture, float scale = 1.0f);
 
@@ -208,6 +259,9 @@ public:
   /// Helper function to save screenshot to PNG.
   bool WriteScreenshotToFile(std::string filename, bool internal_resolution = false, bool compress_on_thread = false);
 
+  /// Blocks until any screenshots being compressed in the background have been written.
+  static void WaitForScreenshotWrites();
+
 protected:
   ALWAYS_INLINE bool HasSoftwareCursor() const { return static_cast<bool>(m_cursor_texture); }
   ALWAYS_INLINE bool HasDisplayTexture() const { return (m_display_texture != nullptr); }
@@ -221,6 +275,12 @@ protected:
   std::tuple<s32, s32, s32, s32> CalculateSoftwareCursorDrawRect() const;
   std::tuple<s32, s32, s32, s32> CalculateSoftwareCursorDrawRect(s32 cursor_x, s32 cursor_y) const;
 
+  /// Called when the timing scope changes, the backend should write a timestamp marking the start of the new scope.
+  virtual void OnGPUTimingScopeChanged(u32 scope);
+
+  /// Names the post-processing timing scopes after the shaders in the chain.
+  void SetPostProcessingGPUTimingScopeNames(const std::vector<std::string>& stage_names);
+
   WindowInfo m_window_info;
 
   u64 m_last_frame_displayed_time = 0;
@@ -246,6 +306,9 @@ protected:
   std::unique_ptr<GPUTexture> m_cursor_texture;
   float m_cursor_texture_scale = 1.0f;
 
+  std::array<std::string, MAX_GPU_TIMING_SCOPES> m_gpu_timing_scope_names;
+  u32 m_gpu_timing_scope = 0;
+
   bool m_display_changed = false;
   bool m_gpu_timing_enabled = false;
   bool m_vsync_enabled = false;
@@ -0,0 +1,358 @@
+// SPDX-FileCopyrightText: 2019-2022 Connor McLaughlin <stenzek@gmail.com>
+// SPDX-License-Identifier: (GPL-3.0 OR CC-BY-NC-ND-4.0)
+
+#include "input_movie.h"
+#include "IconsFontAwesome5.h"
+#include "bus.h"
+#include "common/byte_stream.h"
+#include "common/file_system.h"
+#include "common/log.h"
+#include "common/path.h"
+#include "controller.h"
+#include "fmt/format.h"
+#include "host.h"
+#include "pad.h"
+#include "save_state_version.h"
+#include "settings.h"
+#include "system.h"
+#include "util/state_wrapper.h"
+#include "xxhash.h"
+#include <array>
+#include <cstring>
+Log_SetChannel(InputMovie);
+
+namespace InputMovie {
+
+static constexpr u32 MOVIE_MAGIC = 0x4D495344; // DSIM
+static constexpr u32 MOVIE_VERSION = 1;
+
+#pragma pack(push, 4)
+struct MOVIE_HEADER
+{
+  u32 magic;
+  u32 version;
+  u32 state_version;
+  u32 frame_count;
+  u32 state_size;
+  u32 frame_data_size;
+  u64 settings_hash;
+  std::array<u8, NUM_CONTROLLER_AND_CARD_PORTS> controller_types;
+};
+#pragma pack(pop)
+
+enum class Mode : u8
+{
+  None,
+  Recording,
+  Replaying
+};
+
+static u64 GetSettingsHash();
+static std::array<u8, NUM_CONTROLLER_AND_CARD_PORTS> GetControllerTypes();
+static bool DoControllerInputState(StateWrapper& sw);
+static bool WriteRecording();
+
+static Mode s_mode = Mode::None;
+static std::string s_filename;
+static MOVIE_HEADER s_header = {};
+static u32 s_frame = 0;
+static u32 s_desync_count = 0;
+
+// Recording: the starting state and the frames so far are kept in memory, and written when the movie stops.
+static std::unique_ptr<GrowableMemoryByteStream> s_record_state;
+static std::unique_ptr<GrowableMemoryByteStream> s_record_frames;
+
+// Replaying: the whole file is read in, and the frames are read out of it as they're needed.
+static std::vector<u8> s_replay_data;
+static std::unique_ptr<ReadOnlyMemoryByteStream> s_replay_frames;
+
+} // namespace InputMovie
+
+u64 InputMovie::GetSettingsHash()
+{
+  // Only settings which change what the emulated machine does, rendering and speed don't affect the RAM contents.
+  const std::string str(
+    fmt::format("{} {} {} {} {} {} {} {} {} {} {} {} {} {} {} {}", static_cast<u32>(g_settings.region),
+                static_cast<u32>(g_settings.cpu_execution_mode), g_settings.cpu_overclock_active,
+                g_settings.cpu_overclock_numerator, g_settings.cpu_overclock_denominator,
+                g_settings.cpu_recompiler_icache, g_settings.gpu_pgxp_enable, g_settings.cdrom_read_speedup,
+                g_settings.cdrom_seek_speedup, g_settings.cdrom_readahead_sectors, g_settings.dma_max_slice_ticks,
+                g_settings.dma_halt_ticks, g_settings.gpu_fifo_size, g_settings.gpu_max_run_ahead,
+                g_settings.enable_8mb_ram, g_settings.runahead_frames));
+  return XXH64(str.data(), str.size(), 0);
+}
+
+std::array<u8, NUM_CONTROLLER_AND_CARD_PORTS> InputMovie::GetControllerTypes()
+{
+  std::array<u8, NUM_CONTROLLER_AND_CARD_PORTS> types;
+  for (u32 i = 0; i < NUM_CONTROLLER_AND_CARD_PORTS; i++)
+  {
+    const Controller* controller = Pad::GetController(i);
+    types[i] = static_cast<u8>(controller ? controller->GetType() : ControllerType::None);
+  }
+
+  return types;
+}
+
+bool InputMovie::DoControllerInputState(StateWrapper& sw)
+{
+  for (u32 i = 0; i < NUM_CONTROLLER_AND_CARD_PORTS; i++)
+  {
+    Controller* controller = Pad::GetController(i);
+    if (controller && !controller->DoInputState(sw))
+      return false;
+  }
+
+  return !sw.HasError();
+}
+
+bool InputMovie::StartRecording(const char* filename)
+{
+  Stop();
+
+  if (!System::IsValid())
+    return false;
+
+  std::unique_ptr<GrowableMemoryByteStream> state = ByteStream::CreateGrowableMemoryStream();
+  if (!System::SaveStateToStream(state.get()))
+  {
+    Log_ErrorPrintf("Failed to save starting state for input movie.");
+    return false;
+  }
+
+  s_header = {};
+  s_header.magic = MOVIE_MAGIC;
+  s_header.version = MOVIE_VERSION;
+  s_header.state_version = SAVE_STATE_VERSION;
+  s_header.state_size = static_cast<u32>(state->GetSize());
+  s_header.settings_hash = GetSettingsHash();
+  s_header.controller_types = GetControllerTypes();
+
+  s_filename = filename;
+  s_record_state = std::move(state);
+  s_record_frames = ByteStream::CreateGrowableMemoryStream();
+  s_frame = 0;
+  s_mode = Mode::Recording;
+
+  Log_InfoPrintf("Recording input movie to '%s'.", filename);
+  Host::AddIconOSDMessage("input_movie", ICON_FA_VIDEO,
+                          fmt::format(Host::TranslateString("InputMovie", "Recording input to '{}'.").GetCharArray(),
+                                      Path::GetFileName(FileSystem::GetDisplayNameFromPath(filename))),
+                          5.0f);
+  return true;
+}
+
+bool InputMovie::StartReplay(const char* filename)
+{
+  Stop();
+
+  if (!System::IsValid())
+    return false;
+
+  std::optional<std::vector<u8>> data = FileSystem::ReadBinaryFile(filename);
+  if (!data.has_value() || data->size() < sizeof(MOVIE_HEADER))
+  {
+    Log_ErrorPrintf("Failed to read input movie '%s'.", filename);
+    return false;
+  }
+
+  MOVIE_HEADER header;
+  std::memcpy(&header, data->data(), sizeof(header));
+  if (header.magic != MOVIE_MAGIC || header.version != MOVIE_VERSION ||
+      header.state_version < SAVE_STATE_MINIMUM_VERSION || header.state_version > SAVE_STATE_VERSION ||
+      header.frame_count == 0 ||
+      (sizeof(header) + static_cast<u64>(header.state_size) + header.frame_data_size) > data->size())
+  {
+    Log_ErrorPrintf("Input movie '%s' is invalid or from an incompatible version.", filename);
+    return false;
+  }
+
+  std::unique_ptr<ReadOnlyMemoryByteStream> state =
+    ByteStream::CreateReadOnlyMemoryStream(data->data() + sizeof(header), header.state_size);
+  if (!System::LoadStateFromStream(state.get()))
+  {
+    Log_ErrorPrintf("Failed to load starting state for input movie '%s'.", filename);
+    return false;
+  }
+
+  // the recorded input is laid out per controller, so the controllers have to match
+  if (header.controller_types != GetControllerTypes())
+  {
+    Log_ErrorPrintf("Controller types differ from those used to record input movie '%s'.", filename);
+    return false;
+  }
+
+  if (header.settings_hash != GetSettingsHash())
+  {
+    Log_WarningPrintf("Settings differ from those used to record input movie '%s', the replay may desync.", filename);
+    Host::AddIconOSDMessage(
+      "input_movie_settings", ICON_FA_VIDEO,
+      Host::TranslateStdString("InputMovie", "Settings differ from the recording, the replay may desync."), 10.0f);
+  }
+
+  s_header = header;
+  s_filename = filename;
+  s_replay_data = std::move(data.value());
+  s_replay_frames = ByteStream::CreateReadOnlyMemoryStream(
+    s_replay_data.data() + sizeof(header) + header.state_size, header.frame_data_size);
+  s_frame = 0;
+  s_desync_count = 0;
+  s_mode = Mode::Replaying;
+
+  Log_InfoPrintf("Replaying %u frames of input from '%s'.", header.frame_count, filename);
+  Host::AddIconOSDMessage("input_movie", ICON_FA_VIDEO,
+                          fmt::format(Host::TranslateString("InputMovie", "Replaying input from '{}'.").GetCharArray(),
+                                      Path::GetFileName(FileSystem::GetDisplayNameFromPath(filename))),
+                          5.0f);
+  return true;
+}
+
+bool InputMovie::WriteRecording()
+{
+  s_header.frame_count = s_frame;
+  s_header.frame_data_size = static_cast<u32>(s_record_frames->GetSize());
+
+  std::unique_ptr<ByteStream> stream =
+    ByteStream::OpenFile(s_filename.c_str(), BYTESTREAM_OPEN_CREATE | BYTESTREAM_OPEN_WRITE | BYTESTREAM_OPEN_TRUNCATE |
+                                               BYTESTREAM_OPEN_ATOMIC_UPDATE | BYTESTREAM_OPEN_STREAMED);
+  if (!stream || !stream->Write2(&s_header, sizeof(s_header)) ||
+      !stream->Write2(s_record_state->GetMemoryPointer(), s_header.state_size) ||
+      !stream->Write2(s_record_frames->GetMemoryPointer(), s_header.frame_data_size))
+  {
+    Log_ErrorPrintf("Failed to write input movie '%s'.", s_filename.c_str());
+    if (stream)
+      stream->Discard();
+
+    return false;
+  }
+
+  stream->Commit();
+  Log_InfoPrintf("Wrote %u frames of input to '%s'.", s_frame, s_filename.c_str());
+  return true;
+}
+
+void InputMovie::Stop()
+{
+  if (s_mode == Mode::Recording)
+  {
+    if (WriteRecording())
+    {
+      Host::AddIconOSDMessage(
+        "input_movie", ICON_FA_VIDEO,
+        fmt::format(Host::TranslateString("InputMovie", "Recorded {} frames of input.").GetCharArray(), s_frame), 5.0f);
+    }
+    else
+    {
+      Host::ReportFormattedErrorAsync(Host::TranslateString("InputMovie", "Input Movie"),
+                                      Host::TranslateString("InputMovie", "Failed to write input movie '%s'."),
+                                      s_filename.c_str());
+    }
+
+    s_record_frames.reset();
+    s_record_state.reset();
+  }
+  else if (s_mode == Mode::Replaying)
+  {
+    if (s_frame < s_header.frame_count)
+      Log_WarningPrintf("Input movie replay stopped after %u of %u frames.", s_frame, s_header.frame_count);
+
+    s_replay_frames.reset();
+    s_replay_data = {};
+  }
+
+  s_mode = Mode::None;
+  s_filename = {};
+}
+
+bool InputMovie::IsActive()
+{
+  return (s_mode != Mode::None);
+}
+
+bool InputMovie::IsRecording()
+{
+  return (s_mode == Mode::Recording);
+}
+
+bool InputMovie::IsReplaying()
+{
+  return (s_mode == Mode::Replaying);
+}
+
+u32 InputMovie::GetFrameCount()
+{
+  return (s_mode == Mode::Recording) ? s_frame : s_header.frame_count;
+}
+
+u32 InputMovie::GetDesyncCount()
+{
+  return s_desync_count;
+}
+
+void InputMovie::OnFrameStarted()
+{
+  if (s_mode != Mode::Replaying)
+    return;
+
+  StateWrapper sw(s_replay_frames.get(), StateWrapper::Mode::Read, s_header.state_version);
+  if (!DoControllerInputState(sw))
+  {
+    Log_ErrorPrintf("Failed to read input for frame %u, stopping replay.", s_frame);
+    Stop();
+  }
+}
+
+void InputMovie::OnFrameFinished()
+{
+  if (s_mode == Mode::None)
+    return;
+
+  // Hashed at the end of the frame, since pointer devices only pick up the host position when the game polls them.
+  u64 ram_hash = XXH3_64bits(Bus::g_ram, Bus::g_ram_size);
+
+  if (s_mode == Mode::Recording)
+  {
+    StateWrapper sw(s_record_frames.get(), StateWrapper::Mode::Write, SAVE_STATE_VERSION);
+    const bool result = DoControllerInputState(sw);
+    sw.Do(&ram_hash);
+    if (!result || sw.HasError())
+    {
+      Log_ErrorPrintf("Failed to record input for frame %u.", s_frame);
+      Stop();
+      return;
+    }
+
+    s_frame++;
+    return;
+  }
+
+  u64 recorded_ram_hash = 0;
+  StateWrapper sw(s_replay_frames.get(), StateWrapper::Mode::Read, s_header.state_version);
+  sw.Do(&recorded_ram_hash);
+  if (recorded_ram_hash != ram_hash)
+  {
+    // everything after the first desync is going to differ too, so only that one is worth reporting
+    if (s_desync_count == 0)
+    {
+      Log_ErrorPrintf("Input movie desynced at frame %u.", s_frame);
+      Host::AddIconOSDMessage(
+        "input_movie_desync", ICON_FA_VIDEO,
+        fmt::format(Host::TranslateString("InputMovie", "Replay desynced at frame {}.").GetCharArray(), s_frame),
+        10.0f);
+    }
+
+    s_desync_count++;
+  }
+
+  s_frame++;
+  if (s_frame == s_header.frame_count)
+  {
+    Log_InfoPrintf("Input movie replay finished, %u of %u frames desynced.", s_desync_count, s_frame);
+    Host::AddIconOSDMessage(
+      "input_movie", ICON_FA_VIDEO,
+      fmt::format(Host::TranslateString("InputMovie", "Replay finished, {} of {} frames desynced.").GetCharArray(),
+                  s_desync_count, s_frame),
+      5.0f);
+    Stop();
+  }
+}
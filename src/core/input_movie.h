@@ -0,0 +1,37 @@
+// SPDX-FileCopyrightText: 2019-2022 Connor McLaughlin <stenzek@gmail.com>
+// SPDX-License-Identifier: (GPL-3.0 OR CC-BY-NC-ND-4.0)
+
+#pragma once
+#include "types.h"
+
+//////////////////////////////////////////////////////////////////////////
+// Input movies: a state to start from, plus the controller input and a RAM hash for every frame after it.
+// Replaying a movie runs the exact same frames again, so it can be used to compare performance between builds.
+//////////////////////////////////////////////////////////////////////////
+
+namespace InputMovie {
+
+/// Saves the current state to start the movie from, and records the input of every frame until stopped.
+bool StartRecording(const char* filename);
+
+/// Loads the movie's starting state, and replaces the host input with the recorded input until the movie ends.
+bool StartReplay(const char* filename);
+
+/// Stops the current movie. Recordings are written out at this point.
+void Stop();
+
+bool IsActive();
+bool IsRecording();
+bool IsReplaying();
+
+/// Returns the number of frames recorded so far, or the length of the movie being replayed.
+u32 GetFrameCount();
+
+/// Returns the number of frames where the RAM did not match the recording, for the current or last replay.
+u32 GetDesyncCount();
+
+/// Called by System around each frame.
+void OnFrameStarted();
+void OnFrameFinished();
+
+} // namespace InputMovie
@@ -17,6 +17,9 @@ static void UpdateCPUInterruptRequest();
 static u32 s_interrupt_status_register = 0;
 static u32 s_interrupt_mask_register = DEFAULT_INTERRUPT_MASK;
 
+// (I_STAT & I_MASK) != 0, i.e. the state of the line into CAUSE.Ip bit 2, so the CPU is only poked on changes
+static bool s_interrupt_line_state = false;
+
 } // namespace InterruptController
 
 void InterruptController::Initialize()
@@ -30,6 +33,7 @@ void InterruptController::Reset()
 {
   s_interrupt_status_register = 0;
   s_interrupt_mask_register = DEFAULT_INTERRUPT_MASK;
+  s_interrupt_line_state = false;
 }
 
 bool InterruptController::DoState(StateWrapper& sw)
@@ -37,6 +41,10 @@ bool InterruptController::DoState(StateWrapper& sw)
   sw.Do(&s_interrupt_status_register);
   sw.Do(&s_interrupt_mask_register);
 
+  // CAUSE is restored by the CPU, so only resync our copy of the line
+  if (sw.IsReading())
+    s_interrupt_line_state = ((s_interrupt_status_register & s_interrupt_mask_register) != 0);
+
   return !sw.HasError();
 }
 
@@ -49,6 +57,11 @@ void InterruptController::InterruptRequest(IRQ irq)
 {
   const u32 bit = (u32(1) << static_cast<u32>(irq));
   s_interrupt_status_register |= bit;
+
+  // masked, or the line is already raised, nothing for the CPU to do
+  if (s_interrupt_line_state || !(s_interrupt_mask_register & bit))
+    return;
+
   UpdateCPUInterruptRequest();
 }
 
@@ -99,7 +112,12 @@ void InterruptController::WriteRegister(u32 offset, u32 value)
 void InterruptController::UpdateCPUInterruptRequest()
 {
   // external interrupts set bit 10 only?
-  if ((s_interrupt_status_register & s_interrupt_mask_register) != 0)
+  const bool state = ((s_interrupt_status_register & s_interrupt_mask_register) != 0);
+  if (state == s_interrupt_line_state)
+    return;
+
+  s_interrupt_line_state = state;
+  if (state)
     CPU::SetExternalInterrupt(2);
   else
     CPU::ClearExternalInterrupt(2);
@@ -5,6 +5,8 @@
 #include "common/bitfield.h"
 #include "common/fifo_queue.h"
 #include "common/log.h"
+#include "common/platform.h"
+#include "common/threading.h"
 #include "cpu_core.h"
 #include "dma.h"
 #include "host.h"
@@ -13,10 +15,22 @@
 #include "system.h"
 #include "util/state_wrapper.h"
 #include <array>
+#include <condition_variable>
 #include <memory>
+#include <mutex>
 
 Log_SetChannel(MDEC);
 
+#if defined(CPU_X64)
+#include <emmintrin.h>
+#elif defined(CPU_AARCH64)
+#ifdef _MSC_VER
+#include <arm64_neon.h>
+#else
+#include <arm_neon.h>
+#endif
+#endif
+
 namespace MDEC {
 static constexpr u32 DATA_IN_FIFO_SIZE = 1024;
 static constexpr u32 DATA_OUT_FIFO_SIZE = 768;
@@ -49,6 +63,14 @@ enum class State : u8
   NoCommand
 };
 
+struct DecodeJob
+{
+  u32 first_raw_block;
+  u32 num_blocks;
+  bool signed_output;
+  bool old_routines;
+};
+
 union StatusRegister
 {
   u32 bits;
@@ -100,18 +122,26 @@ static void HandleSetScaleCommand();
 
 static bool DecodeMonoMacroblock();
 static bool DecodeColoredMacroblock();
+static void FinishMacroblock(bool mono);
+static void DecodeMacroblockOutput(const DecodeJob& job);
+static void FlushRawBlocks();
 static void ScheduleBlockCopyOut(TickCount ticks);
 static void CopyOutBlock(void* param, TickCount ticks, TickCount ticks_late);
 
 // from nocash spec
 static bool rl_decode_block(s16* blk, const u8* qt);
-static void IDCT(s16* blk);
+static void IDCT(s16* blk, bool old_routines);
 static void IDCT_New(s16* blk);
 static void IDCT_Old(s16* blk);
 static void yuv_to_rgb(u32 xx, u32 yy, const std::array<s16, 64>& Crblk, const std::array<s16, 64>& Cbblk,
-                       const std::array<s16, 64>& Yblk);
+                       const std::array<s16, 64>& Yblk, bool signed_output);
 static void y_to_mono(const std::array<s16, 64>& Yblk);
 
+static void StartDecodeThread();
+static void StopDecodeThread();
+static void WaitForDecodeThread();
+static void DecodeThread();
+
 static StatusRegister s_status = {};
 static bool s_enable_dma_in = false;
 static bool s_enable_dma_out = false;
@@ -130,6 +160,7 @@ static std::array<s16, 64> s_scale_table{};
 // blocks, for colour: 0 - Crblk, 1 - Cbblk, 2-5 - Y 1-4
 static std::array<std::array<s16, 64>, NUM_BLOCKS> s_blocks;
 static u32 s_current_block = 0;        // block (0-5)
+static u32 s_first_raw_block = 0;      // blocks from here up to the current block haven't been through the IDCT yet
 static u32 s_current_coefficient = 64; // k (in block)
 static u16 s_current_q_scale = 0;
 
@@ -137,6 +168,20 @@ alignas(16) static std::array<u32, 256> s_block_rgb{};
 static std::unique_ptr<TimingEvent> s_block_copy_out_event;
 
 static u32 s_total_blocks_decoded = 0;
+
+// The IDCT and colour conversion of a macroblock can be done on a worker thread. The run-length decoding stays on the
+// CPU thread as the data arrives, since it drives the FIFO and status register. The output is picked up when the copy
+// out event fires, so the timing doesn't change.
+static Threading::Thread s_decode_thread;
+static std::mutex s_decode_mutex;
+static std::condition_variable s_decode_work_cv;
+static std::condition_variable s_decode_done_cv;
+static DecodeJob s_decode_job = {};
+static bool s_decode_job_pending = false;
+static bool s_decode_thread_shutdown = false;
+
+// Only accessed on the CPU thread.
+static bool s_decode_thread_running = false;
 } // namespace MDEC
 
 void MDEC::Initialize()
@@ -145,13 +190,26 @@ void MDEC::Initialize()
     TimingEvents::CreateTimingEvent("MDEC Block Copy Out", 1, 1, &MDEC::CopyOutBlock, nullptr, false);
   s_total_blocks_decoded = 0;
   Reset();
+  UpdateDecodeThread();
 }
 
 void MDEC::Shutdown()
 {
+  StopDecodeThread();
   s_block_copy_out_event.reset();
 }
 
+void MDEC::UpdateDecodeThread()
+{
+  if (g_settings.mdec_decode_thread == s_decode_thread_running)
+    return;
+
+  if (g_settings.mdec_decode_thread)
+    StartDecodeThread();
+  else
+    StopDecodeThread();
+}
+
 void MDEC::Reset()
 {
   s_block_copy_out_event->Deactivate();
@@ -160,6 +218,10 @@ void MDEC::Reset()
 
 bool MDEC::DoState(StateWrapper& sw)
 {
+  // states always have the IDCT applied to completed blocks
+  WaitForDecodeThread();
+  FlushRawBlocks();
+
   sw.Do(&s_status.bits);
   sw.Do(&s_enable_dma_in);
   sw.Do(&s_enable_dma_out);
@@ -175,6 +237,8 @@ bool MDEC::DoState(StateWrapper& sw)
   sw.Do(&s_current_coefficient);
   sw.Do(&s_current_q_scale);
   sw.Do(&s_block_rgb);
+  if (sw.IsReading())
+    s_first_raw_block = s_current_block;
 
   bool block_copy_out_pending = HasPendingBlockCopyOut();
   sw.Do(&block_copy_out_pending);
@@ -277,6 +341,9 @@ bool MDEC::HasPendingBlockCopyOut()
 
 void MDEC::SoftReset()
 {
+  WaitForDecodeThread();
+  FlushRawBlocks();
+
   s_status.bits = 0;
   s_enable_dma_in = false;
   s_enable_dma_out = false;
@@ -285,6 +352,7 @@ void MDEC::SoftReset()
   s_state = State::Idle;
   s_remaining_halfwords = 0;
   s_current_block = 0;
+  s_first_raw_block = 0;
   s_current_coefficient = 64;
   s_current_q_scale = 0;
   s_block_copy_out_event->Deactivate();
@@ -294,6 +362,7 @@ void MDEC::SoftReset()
 void MDEC::ResetDecoder()
 {
   s_current_block = 0;
+  s_first_raw_block = 0;
   s_current_coefficient = 64;
   s_current_q_scale = 0;
 }
@@ -421,6 +490,7 @@ void MDEC::Execute()
         if (s_remaining_halfwords == 0 && s_current_block != NUM_BLOCKS)
         {
           // expecting data, but nothing more will be coming. bail out
+          FlushRawBlocks();
           ResetDecoder();
           s_state = State::Idle;
           continue;
@@ -499,16 +569,8 @@ bool MDEC::DecodeMonoMacroblock()
   if (!rl_decode_block(s_blocks[0].data(), s_iq_y.data()))
     return false;
 
-  IDCT(s_blocks[0].data());
-
   Log_DebugPrintf("Decoded mono macroblock, %u words remaining", s_remaining_halfwords / 2);
-  ResetDecoder();
-  s_state = State::WritingMacroblock;
-
-  y_to_mono(s_blocks[0]);
-
-  ScheduleBlockCopyOut(TICKS_PER_BLOCK * 6);
-
+  FinishMacroblock(true);
   s_total_blocks_decoded++;
   return true;
 }
@@ -519,8 +581,6 @@ bool MDEC::DecodeColoredMacroblock()
   {
     if (!rl_decode_block(s_blocks[s_current_block].data(), (s_current_block >= 2) ? s_iq_y.data() : s_iq_uv.data()))
       return false;
-
-    IDCT(s_blocks[s_current_block].data());
   }
 
   if (!s_data_out_fifo.IsEmpty())
@@ -528,17 +588,119 @@ bool MDEC::DecodeColoredMacroblock()
 
   // done decoding
   Log_DebugPrintf("Decoded colored macroblock, %u words remaining", s_remaining_halfwords / 2);
+  FinishMacroblock(false);
+  s_total_blocks_decoded += 4;
+  return true;
+}
+
+void MDEC::FinishMacroblock(bool mono)
+{
+  // the IDCT is deferred until the whole macroblock is in, so it can go to the worker thread along with the conversion
+  const DecodeJob job = {mono ? 0 : s_first_raw_block, mono ? 1 : NUM_BLOCKS, s_status.data_output_signed,
+                         g_settings.use_old_mdec_routines};
   ResetDecoder();
   s_state = State::WritingMacroblock;
 
-  yuv_to_rgb(0, 0, s_blocks[0], s_blocks[1], s_blocks[2]);
-  yuv_to_rgb(8, 0, s_blocks[0], s_blocks[1], s_blocks[3]);
-  yuv_to_rgb(0, 8, s_blocks[0], s_blocks[1], s_blocks[4]);
-  yuv_to_rgb(8, 8, s_blocks[0], s_blocks[1], s_blocks[5]);
-  s_total_blocks_decoded += 4;
+  if (s_decode_thread_running)
+  {
+    std::unique_lock<std::mutex> lock(s_decode_mutex);
+    DebugAssert(!s_decode_job_pending);
+    s_decode_job = job;
+    s_decode_job_pending = true;
+    s_decode_work_cv.notify_one();
+  }
+  else
+  {
+    DecodeMacroblockOutput(job);
+  }
 
   ScheduleBlockCopyOut(TICKS_PER_BLOCK * 6);
-  return true;
+}
+
+void MDEC::DecodeMacroblockOutput(const DecodeJob& job)
+{
+  for (u32 i = job.first_raw_block; i < job.num_blocks; i++)
+    IDCT(s_blocks[i].data(), job.old_routines);
+
+  if (job.num_blocks == 1)
+  {
+    y_to_mono(s_blocks[0]);
+  }
+  else
+  {
+    yuv_to_rgb(0, 0, s_blocks[0], s_blocks[1], s_blocks[2], job.signed_output);
+    yuv_to_rgb(8, 0, s_blocks[0], s_blocks[1], s_blocks[3], job.signed_output);
+    yuv_to_rgb(0, 8, s_blocks[0], s_blocks[1], s_blocks[4], job.signed_output);
+    yuv_to_rgb(8, 8, s_blocks[0], s_blocks[1], s_blocks[5], job.signed_output);
+  }
+}
+
+void MDEC::FlushRawBlocks()
+{
+  for (; s_first_raw_block < s_current_block; s_first_raw_block++)
+    IDCT(s_blocks[s_first_raw_block].data(), g_settings.use_old_mdec_routines);
+}
+
+void MDEC::StartDecodeThread()
+{
+  s_decode_job_pending = false;
+  s_decode_thread_shutdown = false;
+  if (!s_decode_thread.Start(DecodeThread))
+  {
+    Log_ErrorPrint("Failed to start MDEC decode thread, decoding on the CPU thread.");
+    return;
+  }
+
+  s_decode_thread_running = true;
+  Log_InfoPrint("MDEC decode thread started.");
+}
+
+void MDEC::StopDecodeThread()
+{
+  if (!s_decode_thread_running)
+    return;
+
+  {
+    std::unique_lock<std::mutex> lock(s_decode_mutex);
+    s_decode_done_cv.wait(lock, []() { return !s_decode_job_pending; });
+    s_decode_thread_shutdown = true;
+    s_decode_work_cv.notify_one();
+  }
+
+  s_decode_thread.Join();
+  s_decode_thread_running = false;
+  Log_InfoPrint("MDEC decode thread stopped.");
+}
+
+void MDEC::WaitForDecodeThread()
+{
+  if (!s_decode_thread_running)
+    return;
+
+  std::unique_lock<std::mutex> lock(s_decode_mutex);
+  s_decode_done_cv.wait(lock, []() { return !s_decode_job_pending; });
+}
+
+void MDEC::DecodeThread()
+{
+  Threading::SetNameOfCurrentThread("MDEC Decode Thread");
+  Threading::ApplyAffinityPolicy(Threading::AffinityClass::EmulationWorker);
+
+  std::unique_lock<std::mutex> lock(s_decode_mutex);
+  for (;;)
+  {
+    s_decode_work_cv.wait(lock, []() { return s_decode_thread_shutdown || s_decode_job_pending; });
+    if (s_decode_thread_shutdown)
+      break;
+
+    const DecodeJob job = s_decode_job;
+    lock.unlock();
+    DecodeMacroblockOutput(job);
+    lock.lock();
+
+    s_decode_job_pending = false;
+    s_decode_done_cv.notify_one();
+  }
 }
 
 void MDEC::ScheduleBlockCopyOut(TickCount ticks)
@@ -553,6 +715,7 @@ void MDEC::CopyOutBlock(void* param, TickCount ticks, TickCount ticks_late)
 {
   Assert(s_state == State::WritingMacroblock);
   s_block_copy_out_event->Deactivate();
+  WaitForDecodeThread();
 
   switch (s_status.data_output_depth)
   {
@@ -761,10 +924,102 @@ bool MDEC::rl_decode_block(s16* blk, const u8* qt)
   return false;
 }
 
-void MDEC::IDCT(s16* blk)
+#if defined(CPU_X64)
+
+static void TransposeIDCTBlock(__m128i rows[8])
+{
+  const __m128i t0 = _mm_unpacklo_epi16(rows[0], rows[1]);
+  const __m128i t1 = _mm_unpackhi_epi16(rows[0], rows[1]);
+  const __m128i t2 = _mm_unpacklo_epi16(rows[2], rows[3]);
+  const __m128i t3 = _mm_unpackhi_epi16(rows[2], rows[3]);
+  const __m128i t4 = _mm_unpacklo_epi16(rows[4], rows[5]);
+  const __m128i t5 = _mm_unpackhi_epi16(rows[4], rows[5]);
+  const __m128i t6 = _mm_unpacklo_epi16(rows[6], rows[7]);
+  const __m128i t7 = _mm_unpackhi_epi16(rows[6], rows[7]);
+  const __m128i u0 = _mm_unpacklo_epi32(t0, t2);
+  const __m128i u1 = _mm_unpackhi_epi32(t0, t2);
+  const __m128i u2 = _mm_unpacklo_epi32(t1, t3);
+  const __m128i u3 = _mm_unpackhi_epi32(t1, t3);
+  const __m128i u4 = _mm_unpacklo_epi32(t4, t6);
+  const __m128i u5 = _mm_unpackhi_epi32(t4, t6);
+  const __m128i u6 = _mm_unpacklo_epi32(t5, t7);
+  const __m128i u7 = _mm_unpackhi_epi32(t5, t7);
+  rows[0] = _mm_unpacklo_epi64(u0, u4);
+  rows[1] = _mm_unpackhi_epi64(u0, u4);
+  rows[2] = _mm_unpacklo_epi64(u1, u5);
+  rows[3] = _mm_unpackhi_epi64(u1, u5);
+  rows[4] = _mm_unpacklo_epi64(u2, u6);
+  rows[5] = _mm_unpackhi_epi64(u2, u6);
+  rows[6] = _mm_unpacklo_epi64(u3, u7);
+  rows[7] = _mm_unpackhi_epi64(u3, u7);
+}
+
+// (sum + 0xfff) / 0x2000, rounding towards zero like the scalar division does.
+static __m128i IDCTRound(__m128i sum)
+{
+  const __m128i v = _mm_add_epi32(sum, _mm_set1_epi32(0xfff));
+  return _mm_srai_epi32(_mm_add_epi32(v, _mm_srli_epi32(_mm_srai_epi32(v, 31), 19)), 13);
+}
+
+// One pass of the IDCT: out[x + y * 8] = sum(in[y + z * 8] * scale[x + z * 8]). scale_pairs holds rows z and z+1 of
+// the scale table interleaved, so madd can do two steps of the sum at once. The coefficients are at most 11 bits and
+// the scale 13 bits, so neither the products nor the intermediate results of the first pass overflow.
+static void IDCTPass(__m128i rows[8], const __m128i scale_pairs[8])
+{
+  TransposeIDCTBlock(rows);
+  for (u32 y = 0; y < 8; y++)
+  {
+    const __m128i c0 = _mm_shuffle_epi32(rows[y], _MM_SHUFFLE(0, 0, 0, 0));
+    const __m128i c1 = _mm_shuffle_epi32(rows[y], _MM_SHUFFLE(1, 1, 1, 1));
+    const __m128i c2 = _mm_shuffle_epi32(rows[y], _MM_SHUFFLE(2, 2, 2, 2));
+    const __m128i c3 = _mm_shuffle_epi32(rows[y], _MM_SHUFFLE(3, 3, 3, 3));
+    const __m128i lo = _mm_add_epi32(
+      _mm_add_epi32(_mm_madd_epi16(c0, scale_pairs[0]), _mm_madd_epi16(c1, scale_pairs[2])),
+      _mm_add_epi32(_mm_madd_epi16(c2, scale_pairs[4]), _mm_madd_epi16(c3, scale_pairs[6])));
+    const __m128i hi = _mm_add_epi32(
+      _mm_add_epi32(_mm_madd_epi16(c0, scale_pairs[1]), _mm_madd_epi16(c1, scale_pairs[3])),
+      _mm_add_epi32(_mm_madd_epi16(c2, scale_pairs[5]), _mm_madd_epi16(c3, scale_pairs[7])));
+    rows[y] = _mm_packs_epi32(IDCTRound(lo), IDCTRound(hi));
+  }
+}
+
+#elif defined(CPU_AARCH64)
+
+// (sum + 0xfff) / 0x2000, rounding towards zero like the scalar division does.
+static int32x4_t IDCTRound(int32x4_t sum)
+{
+  const int32x4_t v = vaddq_s32(sum, vdupq_n_s32(0xfff));
+  const int32x4_t bias = vreinterpretq_s32_u32(vshrq_n_u32(vreinterpretq_u32_s32(vshrq_n_s32(v, 31)), 19));
+  return vshrq_n_s32(vaddq_s32(v, bias), 13);
+}
+
+// One pass of the IDCT: out[x + y * 8] = sum(in[y + z * 8] * scale[x + z * 8]). The coefficients are at most 11 bits
+// and the scale 13 bits, so neither the products nor the intermediate results of the first pass overflow.
+static void IDCTPass(const s16* in, s16* out, const int16x8_t scale[8], bool clamp)
+{
+  for (u32 y = 0; y < 8; y++)
+  {
+    int32x4_t lo = vdupq_n_s32(0);
+    int32x4_t hi = vdupq_n_s32(0);
+    for (u32 z = 0; z < 8; z++)
+    {
+      lo = vmlal_n_s16(lo, vget_low_s16(scale[z]), in[y + z * 8]);
+      hi = vmlal_n_s16(hi, vget_high_s16(scale[z]), in[y + z * 8]);
+    }
+
+    int16x8_t res = vcombine_s16(vqmovn_s32(IDCTRound(lo)), vqmovn_s32(IDCTRound(hi)));
+    if (clamp)
+      res = vminq_s16(vmaxq_s16(res, vdupq_n_s16(-128)), vdupq_n_s16(127));
+    vst1q_s16(&out[y * 8], res);
+  }
+}
+
+#endif
+
+void MDEC::IDCT(s16* blk, bool old_routines)
 {
   // people have made texture packs using the old conversion routines.. best to just leave them be.
-  if (UNLIKELY(g_settings.use_old_mdec_routines))
+  if (UNLIKELY(old_routines))
     IDCT_Old(blk);
   else
     IDCT_New(blk);
@@ -772,13 +1027,53 @@ void MDEC::IDCT(s16* blk)
 
 void MDEC::IDCT_New(s16* blk)
 {
+#if defined(CPU_X64)
+  // scale / 8, rounding towards zero
+  __m128i scale[8];
+  for (u32 i = 0; i < 8; i++)
+  {
+    const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&s_scale_table[i * 8]));
+    scale[i] = _mm_srai_epi16(_mm_add_epi16(v, _mm_srli_epi16(_mm_srai_epi16(v, 15), 13)), 3);
+  }
+
+  __m128i scale_pairs[8];
+  for (u32 i = 0; i < 8; i += 2)
+  {
+    scale_pairs[i] = _mm_unpacklo_epi16(scale[i], scale[i + 1]);
+    scale_pairs[i + 1] = _mm_unpackhi_epi16(scale[i], scale[i + 1]);
+  }
+
+  __m128i rows[8];
+  for (u32 i = 0; i < 8; i++)
+    rows[i] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&blk[i * 8]));
+
+  IDCTPass(rows, scale_pairs);
+  IDCTPass(rows, scale_pairs);
+
+  for (u32 i = 0; i < 8; i++)
+  {
+    const __m128i res = _mm_min_epi16(_mm_max_epi16(rows[i], _mm_set1_epi16(-128)), _mm_set1_epi16(127));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(&blk[i * 8]), res);
+  }
+#elif defined(CPU_AARCH64)
+  // scale / 8, rounding towards zero
+  int16x8_t scale[8];
+  for (u32 i = 0; i < 8; i++)
+  {
+    const int16x8_t v = vld1q_s16(&s_scale_table[i * 8]);
+    const int16x8_t bias = vreinterpretq_s16_u16(vshrq_n_u16(vreinterpretq_u16_s16(vshrq_n_s16(v, 15)), 13));
+    scale[i] = vshrq_n_s16(vaddq_s16(v, bias), 3);
+  }
+
+  alignas(16) std::array<s16, 64> temp;
+  IDCTPass(blk, temp.data(), scale, false);
+  IDCTPass(temp.data(), blk, scale, true);
+#else
   std::array<s32, 64> temp;
   for (u32 x = 0; x < 8; x++)
   {
     for (u32 y = 0; y < 8; y++)
     {
-      // TODO: We could alter zigzag and invert scale_table to get these in row-major order,
-      // in which case we could do optimize this to a vector multiply.
       s32 sum = 0;
       for (u32 z = 0; z < 8; z++)
         sum += s32(blk[y + z * 8]) * s32(s_scale_table[x + z * 8] / 8);
@@ -795,6 +1090,7 @@ void MDEC::IDCT_New(s16* blk)
       blk[x + y * 8] = static_cast<s16>(std::clamp<s32>((sum + 0xfff) / 0x2000, -128, 127));
     }
   }
+#endif
 }
 
 void MDEC::IDCT_Old(s16* blk)
@@ -825,9 +1121,86 @@ void MDEC::IDCT_Old(s16* blk)
 }
 
 void MDEC::yuv_to_rgb(u32 xx, u32 yy, const std::array<s16, 64>& Crblk, const std::array<s16, 64>& Cbblk,
-                      const std::array<s16, 64>& Yblk)
+                      const std::array<s16, 64>& Yblk, bool signed_output)
 {
-  const s16 addval = s_status.data_output_signed ? 0 : 0x80;
+  const s16 addval = signed_output ? 0 : 0x80;
+
+#if defined(CPU_X64)
+  // Each row of chroma covers two rows of eight pixels, four samples per row. The float math is done with separate
+  // multiplies and adds in the same order as the scalar version, so the truncated results are identical.
+  const __m128i min = _mm_set1_epi16(-128);
+  const __m128i max = _mm_set1_epi16(127);
+  const __m128i add = _mm_set1_epi16(addval);
+  for (u32 y = 0; y < 8; y++)
+  {
+    const u32 chroma_offset = (xx / 2) + ((y + yy) / 2) * 8;
+    const __m128i cr = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(&Crblk[chroma_offset]));
+    const __m128i cb = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(&Cbblk[chroma_offset]));
+    const __m128 crf = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(cr, cr), 16));
+    const __m128 cbf = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(cb, cb), 16));
+    const __m128i g32 =
+      _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(-0.3437f), cbf), _mm_mul_ps(_mm_set1_ps(-0.7143f), crf)));
+    const __m128i r32 = _mm_cvttps_epi32(_mm_mul_ps(_mm_set1_ps(1.402f), crf));
+    const __m128i b32 = _mm_cvttps_epi32(_mm_mul_ps(_mm_set1_ps(1.772f), cbf));
+
+    // two pixels per chroma sample
+    const __m128i r16 = _mm_packs_epi32(r32, r32);
+    const __m128i g16 = _mm_packs_epi32(g32, g32);
+    const __m128i b16 = _mm_packs_epi32(b32, b32);
+    const __m128i r = _mm_unpacklo_epi16(r16, r16);
+    const __m128i g = _mm_unpacklo_epi16(g16, g16);
+    const __m128i b = _mm_unpacklo_epi16(b16, b16);
+
+    const __m128i Y = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&Yblk[y * 8]));
+    const __m128i R = _mm_add_epi16(_mm_min_epi16(_mm_max_epi16(_mm_add_epi16(Y, r), min), max), add);
+    const __m128i G = _mm_add_epi16(_mm_min_epi16(_mm_max_epi16(_mm_add_epi16(Y, g), min), max), add);
+    const __m128i B = _mm_add_epi16(_mm_min_epi16(_mm_max_epi16(_mm_add_epi16(Y, b), min), max), add);
+
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i lo =
+      _mm_or_si128(_mm_or_si128(_mm_unpacklo_epi16(R, zero), _mm_slli_epi32(_mm_unpacklo_epi16(G, zero), 8)),
+                   _mm_unpacklo_epi16(zero, B));
+    const __m128i hi =
+      _mm_or_si128(_mm_or_si128(_mm_unpackhi_epi16(R, zero), _mm_slli_epi32(_mm_unpackhi_epi16(G, zero), 8)),
+                   _mm_unpackhi_epi16(zero, B));
+    u32* out = &s_block_rgb[xx + ((y + yy) * 16)];
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out), lo);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 4), hi);
+  }
+#elif defined(CPU_AARCH64)
+  // Each row of chroma covers two rows of eight pixels, four samples per row. The float math is done with separate
+  // multiplies and adds in the same order as the scalar version, so the truncated results are identical.
+  const int16x8_t min = vdupq_n_s16(-128);
+  const int16x8_t max = vdupq_n_s16(127);
+  const int16x8_t add = vdupq_n_s16(addval);
+  for (u32 y = 0; y < 8; y++)
+  {
+    const u32 chroma_offset = (xx / 2) + ((y + yy) / 2) * 8;
+    const float32x4_t crf = vcvtq_f32_s32(vmovl_s16(vld1_s16(&Crblk[chroma_offset])));
+    const float32x4_t cbf = vcvtq_f32_s32(vmovl_s16(vld1_s16(&Cbblk[chroma_offset])));
+    const int16x4_t r16 = vmovn_s32(vcvtq_s32_f32(vmulq_n_f32(crf, 1.402f)));
+    const int16x4_t g16 = vmovn_s32(vcvtq_s32_f32(vaddq_f32(vmulq_n_f32(cbf, -0.3437f), vmulq_n_f32(crf, -0.7143f))));
+    const int16x4_t b16 = vmovn_s32(vcvtq_s32_f32(vmulq_n_f32(cbf, 1.772f)));
+
+    // two pixels per chroma sample
+    const int16x8_t r = vcombine_s16(vzip1_s16(r16, r16), vzip2_s16(r16, r16));
+    const int16x8_t g = vcombine_s16(vzip1_s16(g16, g16), vzip2_s16(g16, g16));
+    const int16x8_t b = vcombine_s16(vzip1_s16(b16, b16), vzip2_s16(b16, b16));
+
+    const int16x8_t Y = vld1q_s16(&Yblk[y * 8]);
+    const int16x8_t R = vaddq_s16(vminq_s16(vmaxq_s16(vaddq_s16(Y, r), min), max), add);
+    const int16x8_t G = vaddq_s16(vminq_s16(vmaxq_s16(vaddq_s16(Y, g), min), max), add);
+    const int16x8_t B = vaddq_s16(vminq_s16(vmaxq_s16(vaddq_s16(Y, b), min), max), add);
+
+    const uint16x8_t Ru = vreinterpretq_u16_s16(R);
+    const uint16x8_t Gu = vreinterpretq_u16_s16(G);
+    const uint16x8_t Bu = vreinterpretq_u16_s16(B);
+    u32* out = &s_block_rgb[xx + ((y + yy) * 16)];
+    vst1q_u32(out, vorrq_u32(vorrq_u32(vmovl_u16(vget_low_u16(Ru)), vshll_n_u16(vget_low_u16(Gu), 8)),
+                             vshll_n_u16(vget_low_u16(Bu), 16)));
+    vst1q_u32(out + 4, vorrq_u32(vorrq_u32(vmovl_high_u16(Ru), vshll_high_n_u16(Gu, 8)), vshll_high_n_u16(Bu, 16)));
+  }
+#else
   for (u32 y = 0; y < 8; y++)
   {
     for (u32 x = 0; x < 8; x++)
@@ -849,10 +1222,31 @@ void MDEC::yuv_to_rgb(u32 xx, u32 yy, const std::array<s16, 64>& Crblk, const st
                                                 (ZeroExtend32(static_cast<u16>(B)) << 16);
     }
   }
+#endif
 }
 
 void MDEC::y_to_mono(const std::array<s16, 64>& Yblk)
 {
+#if defined(CPU_X64)
+  const __m128i zero = _mm_setzero_si128();
+  for (u32 i = 0; i < 64; i += 8)
+  {
+    __m128i Y = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&Yblk[i]));
+    Y = _mm_min_epi16(_mm_max_epi16(Y, _mm_set1_epi16(-128)), _mm_set1_epi16(127));
+    Y = _mm_and_si128(_mm_add_epi16(Y, _mm_set1_epi16(128)), _mm_set1_epi16(0xFF));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(&s_block_rgb[i]), _mm_unpacklo_epi16(Y, zero));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(&s_block_rgb[i + 4]), _mm_unpackhi_epi16(Y, zero));
+  }
+#elif defined(CPU_AARCH64)
+  for (u32 i = 0; i < 64; i += 8)
+  {
+    int16x8_t Y = vld1q_s16(&Yblk[i]);
+    Y = vminq_s16(vmaxq_s16(Y, vdupq_n_s16(-128)), vdupq_n_s16(127));
+    const uint16x8_t Yu = vandq_u16(vreinterpretq_u16_s16(vaddq_s16(Y, vdupq_n_s16(128))), vdupq_n_u16(0xFF));
+    vst1q_u32(&s_block_rgb[i], vmovl_u16(vget_low_u16(Yu)));
+    vst1q_u32(&s_block_rgb[i + 4], vmovl_high_u16(Yu));
+  }
+#else
   for (u32 i = 0; i < 64; i++)
   {
     s16 Y = Yblk[i];
@@ -861,6 +1255,7 @@ void MDEC::y_to_mono(const std::array<s16, 64>& Yblk)
     Y += 128;
     s_block_rgb[i] = static_cast<u32>(Y) & 0xFF;
   }
+#endif
 }
 
 void MDEC::HandleSetQuantTableCommand()
@@ -13,6 +13,9 @@ void Shutdown();
 void Reset();
 bool DoState(StateWrapper& sw);
 
+/// Starts or stops the decode thread when the setting changes.
+void UpdateDecodeThread();
+
 // I/O
 u32 ReadRegister(u32 offset);
 void WriteRegister(u32 offset, u32 value);
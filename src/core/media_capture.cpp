@@ -0,0 +1,663 @@
+// SPDX-FileCopyrightText: 2019-2022 Connor McLaughlin <stenzek@gmail.com>
+// SPDX-License-Identifier: (GPL-3.0 OR CC-BY-NC-ND-4.0)
+
+#include "media_capture.h"
+#include "IconsFontAwesome5.h"
+#include "common/file_system.h"
+#include "common/log.h"
+#include "common/path.h"
+#include "common/threading.h"
+#include "gpu.h"
+#include "host.h"
+#include "host_display.h"
+#include "util/wav_writer.h"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <condition_variable>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+#include "common/string_util.h"
+#include "common/windows_headers.h"
+#include <mfapi.h>
+#include <mfidl.h>
+#include <mfreadwrite.h>
+#include <wrl/client.h>
+#pragma comment(lib, "mfplat.lib")
+#pragma comment(lib, "mfreadwrite.lib")
+#pragma comment(lib, "mfuuid.lib")
+#endif
+
+Log_SetChannel(MediaCapture);
+
+namespace MediaCapture {
+
+/// Interface to the platform's encoder. Only used on the capture thread.
+class Encoder
+{
+public:
+  virtual ~Encoder() = default;
+
+  virtual bool Open(const std::string& filename, u32 width, u32 height, float frame_rate, u32 sample_rate) = 0;
+
+  /// Pixels are RGBA8. The timestamp is the number of audio frames written before this video frame.
+  virtual bool WriteVideoFrame(const u32* pixels, u64 timestamp) = 0;
+
+  /// Frames are interleaved stereo.
+  virtual bool WriteAudioFrames(const s16* frames, u32 num_frames) = 0;
+};
+
+/// Uncompressed fallback, writes Y4M video and a WAV file next to it. Both can be fed straight into an encoder.
+class RawEncoder final : public Encoder
+{
+public:
+  ~RawEncoder() override;
+
+  bool Open(const std::string& filename, u32 width, u32 height, float frame_rate, u32 sample_rate) override;
+  bool WriteVideoFrame(const u32* pixels, u64 timestamp) override;
+  bool WriteAudioFrames(const s16* frames, u32 num_frames) override;
+
+private:
+  void ConvertToI420(const u32* pixels);
+
+  std::FILE* m_video_file = nullptr;
+  Common::WAVWriter m_audio_writer;
+  std::vector<u8> m_frame_buffer;
+  u32 m_width = 0;
+  u32 m_height = 0;
+  u32 m_sample_rate = 0;
+  u32 m_frame_rate_numerator = 0;
+  u32 m_frame_rate_denominator = 0;
+  u64 m_frames_written = 0;
+};
+
+#ifdef _WIN32
+
+/// Writes H.264/AAC to MP4 through Media Foundation. The sink writer picks up hardware encoder MFTs (NVENC, QSV, AMF)
+/// when they're installed, and falls back to the software encoder otherwise.
+class MediaFoundationEncoder final : public Encoder
+{
+public:
+  ~MediaFoundationEncoder() override;
+
+  bool Open(const std::string& filename, u32 width, u32 height, float frame_rate, u32 sample_rate) override;
+  bool WriteVideoFrame(const u32* pixels, u64 timestamp) override;
+  bool WriteAudioFrames(const s16* frames, u32 num_frames) override;
+
+private:
+  static constexpr u32 AUDIO_BITRATE = 192000;
+  static constexpr LONGLONG TIME_UNITS_PER_SECOND = 10000000;
+
+  bool WriteSample(DWORD stream_index, const void* data, u32 size, LONGLONG time, LONGLONG duration);
+
+  Microsoft::WRL::ComPtr<IMFSinkWriter> m_writer;
+  DWORD m_video_stream_index = 0;
+  DWORD m_audio_stream_index = 0;
+  bool m_com_initialized = false;
+  bool m_mf_started = false;
+
+  std::vector<u32> m_frame_buffer;
+  u32 m_width = 0;
+  u32 m_height = 0;
+  u32 m_sample_rate = 0;
+  LONGLONG m_frame_duration = 0;
+  LONGLONG m_last_video_time = -1;
+  u64 m_audio_frames_written = 0;
+};
+
+#endif
+
+static constexpr u32 VIDEO_FRAME_QUEUE_SIZE = 8;
+
+struct QueuedVideoFrame
+{
+  std::vector<u32> pixels;
+  u64 timestamp;
+};
+
+static std::unique_ptr<Encoder> CreateEncoder();
+static bool SetCaptureSize();
+static void CaptureThreadEntryPoint();
+
+static std::string s_filename;
+static u32 s_sample_rate = 0;
+static float s_frame_rate = 0.0f;
+static u32 s_width = 0;
+static u32 s_height = 0;
+
+// CPU thread state.
+static Threading::Thread s_thread;
+static bool s_capturing = false;
+static bool s_started_video = false;
+static u64 s_audio_position = 0;
+
+// Slots [head, head + count) are waiting for, or being written by, the capture thread. The CPU thread fills the slot
+// after them, so the two threads never touch the same frame.
+static std::mutex s_mutex;
+static std::condition_variable s_work_cv;
+static std::array<QueuedVideoFrame, VIDEO_FRAME_QUEUE_SIZE> s_video_frames;
+static u32 s_video_queue_head = 0;
+static u32 s_video_queue_count = 0;
+static std::vector<s16> s_audio_queue;
+static bool s_shutdown = false;
+
+static std::atomic_bool s_encoder_failed{false};
+static std::atomic<u32> s_frame_count{0};
+static std::atomic<u32> s_dropped_frame_count{0};
+
+} // namespace MediaCapture
+
+MediaCapture::RawEncoder::~RawEncoder()
+{
+  if (m_video_file)
+    std::fclose(m_video_file);
+}
+
+bool MediaCapture::RawEncoder::Open(const std::string& filename, u32 width, u32 height, float frame_rate,
+                                    u32 sample_rate)
+{
+  m_video_file = FileSystem::OpenCFile(filename.c_str(), "wb");
+  if (!m_video_file)
+  {
+    Log_ErrorPrintf("Failed to open '%s' for writing", filename.c_str());
+    return false;
+  }
+
+  const std::string audio_filename = Path::ReplaceExtension(filename, "wav");
+  if (!m_audio_writer.Open(audio_filename.c_str(), sample_rate, 2))
+  {
+    Log_ErrorPrintf("Failed to open '%s' for writing", audio_filename.c_str());
+    return false;
+  }
+
+  m_width = width;
+  m_height = height;
+  m_sample_rate = sample_rate;
+  m_frame_rate_numerator = static_cast<u32>(std::round(frame_rate * 1000.0f));
+  m_frame_rate_denominator = 1000;
+  m_frame_buffer.resize((width * height) + ((width / 2) * (height / 2) * 2));
+
+  return (std::fprintf(m_video_file, "YUV4MPEG2 W%u H%u F%u:%u Ip A1:1 C420jpeg\n", width, height,
+                       m_frame_rate_numerator, m_frame_rate_denominator) > 0);
+}
+
+bool MediaCapture::RawEncoder::WriteVideoFrame(const u32* pixels, u64 timestamp)
+{
+  // Y4M is fixed rate, so frames are repeated to fill gaps and skipped when they arrive faster than the stream rate.
+  const u64 target_frame =
+    (timestamp * m_frame_rate_numerator) / (static_cast<u64>(m_sample_rate) * m_frame_rate_denominator);
+  if (target_frame < m_frames_written)
+    return true;
+
+  ConvertToI420(pixels);
+  for (; m_frames_written <= target_frame; m_frames_written++)
+  {
+    if (std::fputs("FRAME\n", m_video_file) < 0 ||
+        std::fwrite(m_frame_buffer.data(), m_frame_buffer.size(), 1, m_video_file) != 1)
+    {
+      Log_ErrorPrintf("Failed to write video frame");
+      return false;
+    }
+  }
+
+  return true;
+}
+
+bool MediaCapture::RawEncoder::WriteAudioFrames(const s16* frames, u32 num_frames)
+{
+  m_audio_writer.WriteFrames(frames, num_frames);
+  return true;
+}
+
+void MediaCapture::RawEncoder::ConvertToI420(const u32* pixels)
+{
+  // BT.601, limited range.
+  const auto get_y = [](s32 r, s32 g, s32 b) { return static_cast<u8>(((66 * r + 129 * g + 25 * b + 128) >> 8) + 16); };
+  const auto get_u = [](s32 r, s32 g, s32 b) {
+    return static_cast<u8>(((-38 * r - 74 * g + 112 * b + 128) >> 8) + 128);
+  };
+  const auto get_v = [](s32 r, s32 g, s32 b) {
+    return static_cast<u8>(((112 * r - 94 * g - 18 * b + 128) >> 8) + 128);
+  };
+
+  const u32 chroma_width = m_width / 2;
+  u8* y_plane = m_frame_buffer.data();
+  u8* u_plane = y_plane + (m_width * m_height);
+  u8* v_plane = u_plane + (chroma_width * (m_height / 2));
+
+  for (u32 row = 0; row < m_height; row += 2)
+  {
+    const u32* row0 = pixels + (row * m_width);
+    const u32* row1 = row0 + m_width;
+    u8* y_row0 = y_plane + (row * m_width);
+    u8* y_row1 = y_row0 + m_width;
+    u8* u_row = u_plane + ((row / 2) * chroma_width);
+    u8* v_row = v_plane + ((row / 2) * chroma_width);
+
+    for (u32 col = 0; col < m_width; col += 2)
+    {
+      s32 r_sum = 0, g_sum = 0, b_sum = 0;
+      const u32 quad[4] = {row0[col], row0[col + 1], row1[col], row1[col + 1]};
+      u8* const quad_y[4] = {&y_row0[col], &y_row0[col + 1], &y_row1[col], &y_row1[col + 1]};
+      for (u32 i = 0; i < 4; i++)
+      {
+        const s32 r = static_cast<s32>(quad[i] & 0xFF);
+        const s32 g = static_cast<s32>((quad[i] >> 8) & 0xFF);
+        const s32 b = static_cast<s32>((quad[i] >> 16) & 0xFF);
+        *quad_y[i] = get_y(r, g, b);
+        r_sum += r;
+        g_sum += g;
+        b_sum += b;
+      }
+
+      u_row[col / 2] = get_u(r_sum / 4, g_sum / 4, b_sum / 4);
+      v_row[col / 2] = get_v(r_sum / 4, g_sum / 4, b_sum / 4);
+    }
+  }
+}
+
+#ifdef _WIN32
+
+MediaCapture::MediaFoundationEncoder::~MediaFoundationEncoder()
+{
+  if (m_writer)
+  {
+    const HRESULT hr = m_writer->Finalize();
+    if (FAILED(hr))
+      Log_ErrorPrintf("IMFSinkWriter::Finalize() failed: %08X", hr);
+    m_writer.Reset();
+  }
+
+  if (m_mf_started)
+    MFShutdown();
+  if (m_com_initialized)
+    CoUninitialize();
+}
+
+bool MediaCapture::MediaFoundationEncoder::Open(const std::string& filename, u32 width, u32 height, float frame_rate,
+                                                u32 sample_rate)
+{
+  m_com_initialized = SUCCEEDED(CoInitializeEx(nullptr, COINIT_MULTITHREADED));
+
+  HRESULT hr = MFStartup(MF_VERSION, MFSTARTUP_NOSOCKET);
+  if (FAILED(hr))
+  {
+    Log_ErrorPrintf("MFStartup() failed: %08X", hr);
+    return false;
+  }
+  m_mf_started = true;
+
+  Microsoft::WRL::ComPtr<IMFAttributes> attributes;
+  if (FAILED(hr = MFCreateAttributes(attributes.GetAddressOf(), 2)) ||
+      FAILED(hr = attributes->SetUINT32(MF_READWRITE_ENABLE_HARDWARE_TRANSFORMS, TRUE)) ||
+      FAILED(hr = attributes->SetUINT32(MF_SINK_WRITER_DISABLE_THROTTLING, TRUE)))
+  {
+    Log_ErrorPrintf("Failed to create sink writer attributes: %08X", hr);
+    return false;
+  }
+
+  const std::wstring wfilename = StringUtil::UTF8StringToWideString(filename);
+  hr = MFCreateSinkWriterFromURL(wfilename.c_str(), nullptr, attributes.Get(), m_writer.GetAddressOf());
+  if (FAILED(hr))
+  {
+    Log_ErrorPrintf("MFCreateSinkWriterFromURL() failed: %08X", hr);
+    return false;
+  }
+
+  const UINT32 frame_rate_numerator = static_cast<UINT32>(std::round(frame_rate * 1000.0f));
+  const UINT32 frame_rate_denominator = 1000;
+  const UINT32 video_bitrate = std::max(static_cast<UINT32>(width * height * frame_rate * 0.2f), 1000000u);
+
+  Microsoft::WRL::ComPtr<IMFMediaType> video_output_type;
+  if (FAILED(hr = MFCreateMediaType(video_output_type.GetAddressOf())) ||
+      FAILED(hr = video_output_type->SetGUID(MF_MT_MAJOR_TYPE, MFMediaType_Video)) ||
+      FAILED(hr = video_output_type->SetGUID(MF_MT_SUBTYPE, MFVideoFormat_H264)) ||
+      FAILED(hr = video_output_type->SetUINT32(MF_MT_AVG_BITRATE, video_bitrate)) ||
+      FAILED(hr = video_output_type->SetUINT32(MF_MT_INTERLACE_MODE, MFVideoInterlace_Progressive)) ||
+      FAILED(hr = MFSetAttributeSize(video_output_type.Get(), MF_MT_FRAME_SIZE, width, height)) ||
+      FAILED(hr = MFSetAttributeRatio(video_output_type.Get(), MF_MT_FRAME_RATE, frame_rate_numerator,
+                                      frame_rate_denominator)) ||
+      FAILED(hr = MFSetAttributeRatio(video_output_type.Get(), MF_MT_PIXEL_ASPECT_RATIO, 1, 1)) ||
+      FAILED(hr = m_writer->AddStream(video_output_type.Get(), &m_video_stream_index)))
+  {
+    Log_ErrorPrintf("Failed to add video stream: %08X", hr);
+    return false;
+  }
+
+  // Frames are top-down, so the stride has to be set explicitly, RGB defaults to bottom-up.
+  Microsoft::WRL::ComPtr<IMFMediaType> video_input_type;
+  if (FAILED(hr = MFCreateMediaType(video_input_type.GetAddressOf())) ||
+      FAILED(hr = video_input_type->SetGUID(MF_MT_MAJOR_TYPE, MFMediaType_Video)) ||
+      FAILED(hr = video_input_type->SetGUID(MF_MT_SUBTYPE, MFVideoFormat_RGB32)) ||
+      FAILED(hr = video_input_type->SetUINT32(MF_MT_INTERLACE_MODE, MFVideoInterlace_Progressive)) ||
+      FAILED(hr = video_input_type->SetUINT32(MF_MT_DEFAULT_STRIDE, width * sizeof(u32))) ||
+      FAILED(hr = MFSetAttributeSize(video_input_type.Get(), MF_MT_FRAME_SIZE, width, height)) ||
+      FAILED(hr = MFSetAttributeRatio(video_input_type.Get(), MF_MT_FRAME_RATE, frame_rate_numerator,
+                                      frame_rate_denominator)) ||
+      FAILED(hr = MFSetAttributeRatio(video_input_type.Get(), MF_MT_PIXEL_ASPECT_RATIO, 1, 1)) ||
+      FAILED(hr = m_writer->SetInputMediaType(m_video_stream_index, video_input_type.Get(), nullptr)))
+  {
+    Log_ErrorPrintf("Failed to set video input type: %08X", hr);
+    return false;
+  }
+
+  Microsoft::WRL::ComPtr<IMFMediaType> audio_output_type;
+  if (FAILED(hr = MFCreateMediaType(audio_output_type.GetAddressOf())) ||
+      FAILED(hr = audio_output_type->SetGUID(MF_MT_MAJOR_TYPE, MFMediaType_Audio)) ||
+      FAILED(hr = audio_output_type->SetGUID(MF_MT_SUBTYPE, MFAudioFormat_AAC)) ||
+      FAILED(hr = audio_output_type->SetUINT32(MF_MT_AUDIO_BITS_PER_SAMPLE, 16)) ||
+      FAILED(hr = audio_output_type->SetUINT32(MF_MT_AUDIO_SAMPLES_PER_SECOND, sample_rate)) ||
+      FAILED(hr = audio_output_type->SetUINT32(MF_MT_AUDIO_NUM_CHANNELS, 2)) ||
+      FAILED(hr = audio_output_type->SetUINT32(MF_MT_AUDIO_AVG_BYTES_PER_SECOND, AUDIO_BITRATE / 8)) ||
+      FAILED(hr = m_writer->AddStream(audio_output_type.Get(), &m_audio_stream_index)))
+  {
+    Log_ErrorPrintf("Failed to add audio stream: %08X", hr);
+    return false;
+  }
+
+  Microsoft::WRL::ComPtr<IMFMediaType> audio_input_type;
+  if (FAILED(hr = MFCreateMediaType(audio_input_type.GetAddressOf())) ||
+      FAILED(hr = audio_input_type->SetGUID(MF_MT_MAJOR_TYPE, MFMediaType_Audio)) ||
+      FAILED(hr = audio_input_type->SetGUID(MF_MT_SUBTYPE, MFAudioFormat_PCM)) ||
+      FAILED(hr = audio_input_type->SetUINT32(MF_MT_AUDIO_BITS_PER_SAMPLE, 16)) ||
+      FAILED(hr = audio_input_type->SetUINT32(MF_MT_AUDIO_SAMPLES_PER_SECOND, sample_rate)) ||
+      FAILED(hr = audio_input_type->SetUINT32(MF_MT_AUDIO_NUM_CHANNELS, 2)) ||
+      FAILED(hr = audio_input_type->SetUINT32(MF_MT_AUDIO_BLOCK_ALIGNMENT, sizeof(s16) * 2)) ||
+      FAILED(hr = audio_input_type->SetUINT32(MF_MT_AUDIO_AVG_BYTES_PER_SECOND, sample_rate * sizeof(s16) * 2)) ||
+      FAILED(hr = m_writer->SetInputMediaType(m_audio_stream_index, audio_input_type.Get(), nullptr)))
+  {
+    Log_ErrorPrintf("Failed to set audio input type: %08X", hr);
+    return false;
+  }
+
+  if (FAILED(hr = m_writer->BeginWriting()))
+  {
+    Log_ErrorPrintf("IMFSinkWriter::BeginWriting() failed: %08X", hr);
+    return false;
+  }
+
+  m_width = width;
+  m_height = height;
+  m_sample_rate = sample_rate;
+  m_frame_duration = (TIME_UNITS_PER_SECOND * frame_rate_denominator) / frame_rate_numerator;
+  m_frame_buffer.resize(width * height);
+  return true;
+}
+
+bool MediaCapture::MediaFoundationEncoder::WriteVideoFrame(const u32* pixels, u64 timestamp)
+{
+  // RGBA -> BGRX
+  const u32 pixel_count = m_width * m_height;
+  for (u32 i = 0; i < pixel_count; i++)
+  {
+    const u32 rgba = pixels[i];
+    m_frame_buffer[i] = (rgba & 0xFF00FF00u) | ((rgba & 0xFFu) << 16) | ((rgba >> 16) & 0xFFu);
+  }
+
+  LONGLONG time = static_cast<LONGLONG>((timestamp * TIME_UNITS_PER_SECOND) / m_sample_rate);
+  if (time <= m_last_video_time)
+    time = m_last_video_time + 1;
+  m_last_video_time = time;
+
+  return WriteSample(m_video_stream_index, m_frame_buffer.data(), pixel_count * sizeof(u32), time, m_frame_duration);
+}
+
+bool MediaCapture::MediaFoundationEncoder::WriteAudioFrames(const s16* frames, u32 num_frames)
+{
+  const LONGLONG time = static_cast<LONGLONG>((m_audio_frames_written * TIME_UNITS_PER_SECOND) / m_sample_rate);
+  const LONGLONG duration = static_cast<LONGLONG>((num_frames * TIME_UNITS_PER_SECOND) / m_sample_rate);
+  m_audio_frames_written += num_frames;
+  return WriteSample(m_audio_stream_index, frames, num_frames * sizeof(s16) * 2, time, duration);
+}
+
+bool MediaCapture::MediaFoundationEncoder::WriteSample(DWORD stream_index, const void* data, u32 size, LONGLONG time,
+                                                       LONGLONG duration)
+{
+  Microsoft::WRL::ComPtr<IMFMediaBuffer> buffer;
+  HRESULT hr = MFCreateMemoryBuffer(size, buffer.GetAddressOf());
+  if (FAILED(hr))
+  {
+    Log_ErrorPrintf("MFCreateMemoryBuffer() failed: %08X", hr);
+    return false;
+  }
+
+  BYTE* buffer_data;
+  if (FAILED(hr = buffer->Lock(&buffer_data, nullptr, nullptr)))
+  {
+    Log_ErrorPrintf("IMFMediaBuffer::Lock() failed: %08X", hr);
+    return false;
+  }
+  std::memcpy(buffer_data, data, size);
+  buffer->Unlock();
+
+  Microsoft::WRL::ComPtr<IMFSample> sample;
+  if (FAILED(hr = buffer->SetCurrentLength(size)) || FAILED(hr = MFCreateSample(sample.GetAddressOf())) ||
+      FAILED(hr = sample->AddBuffer(buffer.Get())) || FAILED(hr = sample->SetSampleTime(time)) ||
+      FAILED(hr = sample->SetSampleDuration(duration)) ||
+      FAILED(hr = m_writer->WriteSample(stream_index, sample.Get())))
+  {
+    Log_ErrorPrintf("Failed to write sample: %08X", hr);
+    return false;
+  }
+
+  return true;
+}
+
+#endif
+
+const char* MediaCapture::GetFileExtension()
+{
+#ifdef _WIN32
+  return "mp4";
+#else
+  return "y4m";
+#endif
+}
+
+std::unique_ptr<MediaCapture::Encoder> MediaCapture::CreateEncoder()
+{
+#ifdef _WIN32
+  return std::make_unique<MediaFoundationEncoder>();
+#else
+  return std::make_unique<RawEncoder>();
+#endif
+}
+
+bool MediaCapture::Start(const char* filename, u32 audio_sample_rate)
+{
+  Stop();
+
+  s_filename = filename;
+  s_sample_rate = audio_sample_rate;
+  s_frame_rate = g_gpu ? g_gpu->ComputeVerticalFrequency() : 60.0f;
+  s_width = 0;
+  s_height = 0;
+  s_started_video = false;
+  s_audio_position = 0;
+  s_video_queue_head = 0;
+  s_video_queue_count = 0;
+  s_audio_queue.clear();
+  s_shutdown = false;
+  s_encoder_failed.store(false, std::memory_order_relaxed);
+  s_frame_count.store(0, std::memory_order_relaxed);
+  s_dropped_frame_count.store(0, std::memory_order_relaxed);
+
+  if (!s_thread.Start(CaptureThreadEntryPoint))
+  {
+    Log_ErrorPrintf("Failed to start media capture thread");
+    return false;
+  }
+
+  Log_InfoPrintf("Capturing media to '%s'.", filename);
+  s_capturing = true;
+  return true;
+}
+
+void MediaCapture::Stop()
+{
+  if (!s_capturing)
+    return;
+
+  {
+    std::unique_lock<std::mutex> lock(s_mutex);
+    s_shutdown = true;
+    s_work_cv.notify_one();
+  }
+
+  s_thread.Join();
+  s_capturing = false;
+
+  for (QueuedVideoFrame& frame : s_video_frames)
+    frame.pixels = std::vector<u32>();
+  s_audio_queue = std::vector<s16>();
+
+  Log_InfoPrintf("Stopped capturing media to '%s', %u frames written, %u dropped.", s_filename.c_str(),
+                 s_frame_count.load(std::memory_order_relaxed), s_dropped_frame_count.load(std::memory_order_relaxed));
+}
+
+bool MediaCapture::IsCapturing()
+{
+  return s_capturing;
+}
+
+u32 MediaCapture::GetFrameCount()
+{
+  return s_frame_count.load(std::memory_order_relaxed);
+}
+
+u32 MediaCapture::GetDroppedFrameCount()
+{
+  return s_dropped_frame_count.load(std::memory_order_relaxed);
+}
+
+bool MediaCapture::SetCaptureSize()
+{
+  // Frames are scaled to the display aspect ratio at the internal resolution. 4:2:0 needs even dimensions.
+  const u32 height = static_cast<u32>(g_host_display->GetDisplayTextureViewHeight()) & ~1u;
+  const u32 width = static_cast<u32>(std::round(static_cast<float>(height) * g_host_display->GetDisplayAspectRatio())) &
+                    ~1u;
+  if (width == 0 || height == 0)
+    return false;
+
+  Log_InfoPrintf("Media capture size is %ux%u @ %.2f hz", width, height, s_frame_rate);
+  s_width = width;
+  s_height = height;
+  return true;
+}
+
+void MediaCapture::CaptureFrame()
+{
+  if (!s_capturing)
+    return;
+
+  if (s_encoder_failed.load(std::memory_order_relaxed))
+  {
+    Stop();
+    Host::AddIconOSDMessage("media_capture", ICON_FA_VIDEO,
+                            Host::TranslateStdString("OSDMessage", "Media capture failed, check the log for details."),
+                            10.0f);
+    return;
+  }
+
+  if (!g_host_display->GetDisplayTextureHandle() || (s_width == 0 && !SetCaptureSize()))
+    return;
+
+  u32 slot;
+  {
+    std::unique_lock<std::mutex> lock(s_mutex);
+    if (s_video_queue_count == VIDEO_FRAME_QUEUE_SIZE)
+    {
+      s_dropped_frame_count.fetch_add(1, std::memory_order_relaxed);
+      return;
+    }
+
+    slot = (s_video_queue_head + s_video_queue_count) % VIDEO_FRAME_QUEUE_SIZE;
+  }
+
+  QueuedVideoFrame& frame = s_video_frames[slot];
+  if (!g_host_display->WriteDisplayTextureToBuffer(&frame.pixels, s_width, s_height))
+    return;
+
+  frame.timestamp = s_audio_position;
+  s_started_video = true;
+
+  std::unique_lock<std::mutex> lock(s_mutex);
+  s_video_queue_count++;
+  s_work_cv.notify_one();
+}
+
+void MediaCapture::WriteAudioFrames(const s16* frames, u32 num_frames)
+{
+  // Audio starts with the first frame, so that's time zero for both streams.
+  if (!s_started_video)
+    return;
+
+  s_audio_position += num_frames;
+
+  std::unique_lock<std::mutex> lock(s_mutex);
+  s_audio_queue.insert(s_audio_queue.end(), frames, frames + (num_frames * 2));
+  s_work_cv.notify_one();
+}
+
+void MediaCapture::CaptureThreadEntryPoint()
+{
+  Threading::SetNameOfCurrentThread("Media Capture Thread");
+  Threading::ApplyAffinityPolicy(Threading::AffinityClass::Background);
+
+  std::unique_ptr<Encoder> encoder;
+  std::vector<s16> audio_frames;
+
+  std::unique_lock<std::mutex> lock(s_mutex);
+  for (;;)
+  {
+    // anything still queued is written before shutting down
+    s_work_cv.wait(lock, []() { return s_shutdown || s_video_queue_count > 0 || !s_audio_queue.empty(); });
+    if (s_video_queue_count == 0 && s_audio_queue.empty())
+      break;
+
+    audio_frames.swap(s_audio_queue);
+    const QueuedVideoFrame* frame = (s_video_queue_count > 0) ? &s_video_frames[s_video_queue_head] : nullptr;
+    lock.unlock();
+
+    if (!s_encoder_failed.load(std::memory_order_relaxed))
+    {
+      bool result = true;
+      if (!encoder)
+      {
+        // the size is known by now, audio isn't queued until the first frame is
+        encoder = CreateEncoder();
+        result = encoder->Open(s_filename, s_width, s_height, s_frame_rate, s_sample_rate);
+      }
+
+      if (result && !audio_frames.empty())
+        result = encoder->WriteAudioFrames(audio_frames.data(), static_cast<u32>(audio_frames.size() / 2));
+
+      if (result && frame)
+      {
+        result = encoder->WriteVideoFrame(frame->pixels.data(), frame->timestamp);
+        s_frame_count.fetch_add(1, std::memory_order_relaxed);
+      }
+
+      if (!result)
+        s_encoder_failed.store(true, std::memory_order_relaxed);
+    }
+
+    audio_frames.clear();
+
+    lock.lock();
+    if (frame)
+    {
+      s_video_queue_head = (s_video_queue_head + 1) % VIDEO_FRAME_QUEUE_SIZE;
+      s_video_queue_count--;
+    }
+  }
+
+  lock.unlock();
+  encoder.reset();
+}
@@ -0,0 +1,37 @@
+// SPDX-FileCopyrightText: 2019-2022 Connor McLaughlin <stenzek@gmail.com>
+// SPDX-License-Identifier: (GPL-3.0 OR CC-BY-NC-ND-4.0)
+
+#pragma once
+#include "types.h"
+
+//////////////////////////////////////////////////////////////////////////
+// Media capture: records the displayed frames and the SPU output to a video file.
+// Frames are read back on the CPU thread, and converted/encoded on a worker thread. Frames are dropped rather than
+// stalling emulation when the encoder can't keep up. Video timestamps are taken from the audio position, so the two
+// streams stay in sync regardless of the emulation speed.
+//////////////////////////////////////////////////////////////////////////
+
+namespace MediaCapture {
+
+/// Returns the extension (without the dot) of the files written by the encoder for this platform.
+const char* GetFileExtension();
+
+/// Starts capturing to the specified file. The encoder is opened when the first frame is captured.
+bool Start(const char* filename, u32 audio_sample_rate);
+
+/// Stops capturing, waiting for the frames queued so far to be written out.
+void Stop();
+
+bool IsCapturing();
+
+/// Returns the number of frames written so far, and the number dropped because the encoder was behind.
+u32 GetFrameCount();
+u32 GetDroppedFrameCount();
+
+/// Called by System after each frame, reads back the current display texture.
+void CaptureFrame();
+
+/// Called by the SPU with each batch of output frames.
+void WriteAudioFrames(const s16* frames, u32 num_frames);
+
+} // namespace MediaCapture
@@ -8,12 +8,46 @@
 #include "common/log.h"
 #include "common/path.h"
 #include "common/string_util.h"
+#include "common/threading.h"
 #include "host.h"
 #include "system.h"
 #include "util/state_wrapper.h"
+#include <algorithm>
+#include <condition_variable>
 #include <cstdio>
+#include <deque>
+#include <mutex>
 Log_SetChannel(MemoryCard);
 
+namespace {
+struct MemoryCardSaveJob
+{
+  std::string filename;
+  MemoryCardImage::DataArray data;
+  bool display_osd_message;
+};
+} // namespace
+
+static void QueueMemoryCardSave(const std::string& filename, const MemoryCardImage::DataArray& data,
+                                const std::bitset<MemoryCardImage::NUM_FRAMES>& dirty_frames,
+                                bool display_osd_message);
+static void WaitForMemoryCardSaves();
+static void StopMemoryCardSaveThread();
+static void MemoryCardSaveThread();
+static void WriteMemoryCardSave(const MemoryCardSaveJob& job);
+
+// Card images are written on a separate thread, since the atomic update can block for a while on slow storage.
+static Threading::Thread s_save_thread;
+static std::mutex s_save_mutex;
+static std::condition_variable s_save_work_cv;
+static std::condition_variable s_save_idle_cv;
+static std::deque<MemoryCardSaveJob> s_save_queue;
+static bool s_save_busy = false;
+static bool s_save_shutdown = false;
+
+// Only accessed on the CPU thread.
+static bool s_save_thread_running = false;
+
 MemoryCard::MemoryCard()
 {
   m_FLAG.no_write_yet = true;
@@ -29,6 +63,12 @@ MemoryCard::~MemoryCard()
   SaveIfChanged(false);
 }
 
+void MemoryCard::Shutdown()
+{
+  // Writes everything still queued before returning.
+  StopMemoryCardSaveThread();
+}
+
 std::string MemoryCard::SanitizeGameTitleForFileName(const std::string_view& name)
 {
   std::string ret(name);
@@ -69,6 +109,10 @@ bool MemoryCard::DoState(StateWrapper& sw)
   sw.Do(&m_data);
   sw.Do(&m_changed);
 
+  // the loaded contents can differ anywhere from what was last saved
+  if (sw.IsReading())
+    m_dirty_frames.set();
+
   return !sw.HasError();
 }
 
@@ -181,7 +225,11 @@ bool MemoryCard::Transfer(const u8 data_in, u8* data_out)
       }
 
       const u32 offset = ZeroExtend32(m_address) * MemoryCardImage::FRAME_SIZE + m_sector_offset;
-      m_changed |= (m_data[offset] != data_in);
+      if (m_data[offset] != data_in)
+      {
+        m_changed = true;
+        m_dirty_frames.set(m_address);
+      }
       m_data[offset] = data_in;
 
       *data_out = m_last_byte;
@@ -275,6 +323,9 @@ std::unique_ptr<MemoryCard> MemoryCard::Open(std::string_view filename)
 {
   std::unique_ptr<MemoryCard> mc = std::make_unique<MemoryCard>();
   mc->m_filename = filename;
+
+  // the file may still have a save on its way from a card which was just closed
+  WaitForMemoryCardSaves();
   if (!mc->LoadFromFile())
   {
     Log_InfoPrintf("Memory card at '%s' could not be read, formatting.", mc->m_filename.c_str());
@@ -291,6 +342,7 @@ void MemoryCard::Format()
 {
   MemoryCardImage::Format(&m_data);
   m_changed = true;
+  m_dirty_frames.set();
 }
 
 bool MemoryCard::LoadFromFile()
@@ -298,29 +350,137 @@ bool MemoryCard::LoadFromFile()
   return MemoryCardImage::LoadFromFile(&m_data, m_filename.c_str());
 }
 
-bool MemoryCard::SaveIfChanged(bool display_osd_message)
+void MemoryCard::SaveIfChanged(bool display_osd_message)
 {
   m_save_event->Deactivate();
 
   if (!m_changed)
-    return true;
+    return;
 
   m_changed = false;
 
   if (m_filename.empty())
-    return false;
+    return;
+
+  QueueMemoryCardSave(m_filename, m_data, m_dirty_frames, display_osd_message);
+  m_dirty_frames.reset();
+}
+
+void MemoryCard::QueueFileSave()
+{
+  // skip if the event is already pending, or we don't have a backing file
+  if (m_save_event->IsActive() || m_filename.empty())
+    return;
 
+  // save in one second, that should be long enough for everything to finish writing
+  m_save_event->Schedule(GetSaveDelayInTicks());
+}
+
+void QueueMemoryCardSave(const std::string& filename, const MemoryCardImage::DataArray& data,
+                         const std::bitset<MemoryCardImage::NUM_FRAMES>& dirty_frames, bool display_osd_message)
+{
+  if (!s_save_thread_running)
+  {
+    s_save_busy = false;
+    s_save_shutdown = false;
+    s_save_thread_running = s_save_thread.Start(MemoryCardSaveThread);
+    if (!s_save_thread_running)
+    {
+      Log_ErrorPrint("Failed to start memory card save thread, saving on the CPU thread.");
+      WriteMemoryCardSave(MemoryCardSaveJob{filename, data, display_osd_message});
+      return;
+    }
+  }
+
+  std::unique_lock<std::mutex> lock(s_save_mutex);
+
+  // If the previous save of this card hasn't been written yet, it only needs the frames written since.
+  for (MemoryCardSaveJob& job : s_save_queue)
+  {
+    if (job.filename != filename)
+      continue;
+
+    for (u32 i = 0; i < MemoryCardImage::NUM_FRAMES; i++)
+    {
+      if (dirty_frames[i])
+      {
+        std::copy_n(data.begin() + (i * MemoryCardImage::FRAME_SIZE), MemoryCardImage::FRAME_SIZE,
+                    job.data.begin() + (i * MemoryCardImage::FRAME_SIZE));
+      }
+    }
+
+    job.display_osd_message |= display_osd_message;
+    return;
+  }
+
+  s_save_queue.push_back(MemoryCardSaveJob{filename, data, display_osd_message});
+  s_save_work_cv.notify_one();
+}
+
+void WaitForMemoryCardSaves()
+{
+  if (!s_save_thread_running)
+    return;
+
+  std::unique_lock<std::mutex> lock(s_save_mutex);
+  s_save_idle_cv.wait(lock, []() { return s_save_queue.empty() && !s_save_busy; });
+}
+
+void StopMemoryCardSaveThread()
+{
+  if (!s_save_thread_running)
+    return;
+
+  {
+    std::unique_lock<std::mutex> lock(s_save_mutex);
+    s_save_shutdown = true;
+    s_save_work_cv.notify_one();
+  }
+
+  s_save_thread.Join();
+  s_save_thread_running = false;
+}
+
+void MemoryCardSaveThread()
+{
+  Threading::SetNameOfCurrentThread("Memory Card Save Thread");
+  Threading::ApplyAffinityPolicy(Threading::AffinityClass::Background);
+
+  std::unique_lock<std::mutex> lock(s_save_mutex);
+  for (;;)
+  {
+    // anything still queued is written before shutting down
+    s_save_work_cv.wait(lock, []() { return s_save_shutdown || !s_save_queue.empty(); });
+    if (s_save_queue.empty())
+      break;
+
+    const MemoryCardSaveJob job = std::move(s_save_queue.front());
+    s_save_queue.pop_front();
+    s_save_busy = true;
+    lock.unlock();
+
+    WriteMemoryCardSave(job);
+
+    lock.lock();
+    s_save_busy = false;
+    if (s_save_queue.empty())
+      s_save_idle_cv.notify_all();
+  }
+}
+
+void WriteMemoryCardSave(const MemoryCardSaveJob& job)
+{
   std::string osd_key;
   std::string display_name;
-  if (display_osd_message)
+  if (job.display_osd_message)
   {
-    osd_key = fmt::format("memory_card_save_{}", m_filename);
-    display_name = FileSystem::GetDisplayNameFromPath(m_filename);
+    osd_key = fmt::format("memory_card_save_{}", job.filename);
+    display_name = FileSystem::GetDisplayNameFromPath(job.filename);
   }
 
-  if (!MemoryCardImage::SaveToFile(m_data, m_filename.c_str()))
+  if (!MemoryCardImage::SaveToFile(job.data, job.filename.c_str()))
   {
-    if (display_osd_message)
+    if (job.display_osd_message)
     {
       Host::AddIconOSDMessage(
         std::move(osd_key), ICON_FA_SD_CARD,
@@ -329,10 +489,10 @@ bool MemoryCard::SaveIfChanged(bool display_osd_message)
         20.0f);
     }
 
-    return false;
+    return;
   }
 
-  if (display_osd_message)
+  if (job.display_osd_message)
   {
     Host::AddIconOSDMessage(
       std::move(osd_key), ICON_FA_SD_CARD,
@@ -340,16 +500,4 @@ bool MemoryCard::SaveIfChanged(bool display_osd_message)
                   Path::GetFileName(display_name)),
       5.0f);
   }
-
-  return true;
-}
-
-void MemoryCard::QueueFileSave()
-{
-  // skip if the event is already pending, or we don't have a backing file
-  if (m_save_event->IsActive() || m_filename.empty())
-    return;
-
-  // save in one second, that should be long enough for everything to finish writing
-  m_save_event->Schedule(GetSaveDelayInTicks());
 }
@@ -6,6 +6,7 @@
 #include "controller.h"
 #include "memory_card_image.h"
 #include <array>
+#include <bitset>
 #include <memory>
 #include <string>
 #include <string_view>
@@ -25,6 +26,9 @@ public:
   static std::unique_ptr<MemoryCard> Create();
   static std::unique_ptr<MemoryCard> Open(std::string_view filename);
 
+  /// Flushes pending saves and stops the save thread. Call after all cards have been destroyed.
+  static void Shutdown();
+
   const MemoryCardImage::DataArray& GetData() const { return m_data; }
   MemoryCardImage::DataArray& GetData() { return m_data; }
   const std::string& GetFilename() const { return m_filename; }
@@ -84,7 +88,9 @@ private:
   static TickCount GetSaveDelayInTicks();
 
   bool LoadFromFile();
-  bool SaveIfChanged(bool display_osd_message);
+
+  /// Hands the card's contents to the save thread if they've changed. The file is written in the background.
+  void SaveIfChanged(bool display_osd_message);
   void QueueFileSave();
 
   std::unique_ptr<TimingEvent> m_save_event;
@@ -99,5 +105,8 @@ private:
 
   MemoryCardImage::DataArray m_data{};
 
+  // Frames written since the last save was queued, so only those need copying into a save which hasn't run yet.
+  std::bitset<MemoryCardImage::NUM_FRAMES> m_dirty_frames;
+
   std::string m_filename;
 };
@@ -12,7 +12,9 @@
 #include "util/state_wrapper.h"
 #include <algorithm>
 #include <cstdio>
+#include <mutex>
 #include <optional>
+#include <unordered_map>
 Log_SetChannel(MemoryCard);
 
 namespace MemoryCardImage {
@@ -226,7 +228,7 @@ u32 GetFreeBlockCount(const DataArray& data)
   return count;
 }
 
-std::vector<FileInfo> EnumerateFiles(const DataArray& data, bool include_deleted)
+std::vector<FileInfo> EnumerateFiles(const DataArray& data, bool include_deleted, bool decode_icons)
 {
   std::vector<FileInfo> files;
 
@@ -279,33 +281,97 @@ std::vector<FileInfo> EnumerateFiles(const DataArray& data, bool include_deleted
       continue;
     }
 
-    char title_sjis[sizeof(tf->title) + 2];
-    std::memcpy(title_sjis, tf->title, sizeof(tf->title));
-    title_sjis[sizeof(tf->title)] = 0;
-    title_sjis[sizeof(tf->title) + 1] = 0;
-    char* title_utf8 = sjis2utf8(title_sjis);
-    fi.title = title_utf8;
-    std::free(title_utf8);
+    fi.title = sjis2utf8(std::string_view(reinterpret_cast<const char*>(tf->title), sizeof(tf->title)));
+    fi.num_icon_frames = num_icon_frames;
+    if (decode_icons)
+      DecodeIcons(data, &fi);
 
-    fi.icon_frames.resize(num_icon_frames);
-    for (u32 icon_frame = 0; icon_frame < num_icon_frames; icon_frame++)
+    files.push_back(std::move(fi));
+  }
+
+  return files;
+}
+
+void DecodeIcons(const DataArray& data, FileInfo* fi)
+{
+  if (fi->icon_frames.size() == fi->num_icon_frames)
+    return;
+
+  const TitleFrame* tf = GetFramePtr<TitleFrame>(data, fi->first_block, 0);
+  fi->icon_frames.resize(fi->num_icon_frames);
+  for (u32 icon_frame = 0; icon_frame < fi->num_icon_frames; icon_frame++)
+  {
+    const u8* indices_ptr = GetFramePtr<u8>(data, fi->first_block, 1 + icon_frame);
+    u32* pixels_ptr = fi->icon_frames[icon_frame].pixels;
+    for (u32 i = 0; i < ICON_WIDTH * ICON_HEIGHT; i += 2)
     {
-      const u8* indices_ptr = GetFramePtr<u8>(data, dir_frame, 1 + icon_frame);
-      u32* pixels_ptr = fi.icon_frames[icon_frame].pixels;
-      for (u32 i = 0; i < ICON_WIDTH * ICON_HEIGHT; i += 2)
-      {
-        *(pixels_ptr++) = RGBA5551ToRGBA8888(tf->icon_palette[*indices_ptr & 0xF]);
-        *(pixels_ptr++) = RGBA5551ToRGBA8888(tf->icon_palette[*indices_ptr >> 4]);
-        indices_ptr++;
-      }
+      *(pixels_ptr++) = RGBA5551ToRGBA8888(tf->icon_palette[*indices_ptr & 0xF]);
+      *(pixels_ptr++) = RGBA5551ToRGBA8888(tf->icon_palette[*indices_ptr >> 4]);
+      indices_ptr++;
     }
+  }
+}
 
-    files.push_back(std::move(fi));
+namespace {
+struct CachedCardFiles
+{
+  std::time_t modification_time;
+  s64 size;
+  std::vector<FileInfo> files;
+};
+} // namespace
+
+static std::mutex s_file_cache_mutex;
+static std::unordered_map<std::string, CachedCardFiles> s_file_cache;
+
+std::vector<FileInfo> EnumerateFilesCached(const char* filename, const DataArray& data, bool include_deleted)
+{
+  FILESYSTEM_STAT_DATA sd;
+  if (!FileSystem::StatFile(filename, &sd))
+    return EnumerateFiles(data, include_deleted, false);
+
+  std::unique_lock lock(s_file_cache_mutex);
+  auto it = s_file_cache.find(filename);
+  if (it == s_file_cache.end() || it->second.modification_time != sd.ModificationTime || it->second.size != sd.Size)
+  {
+    lock.unlock();
+    CachedCardFiles entry{sd.ModificationTime, sd.Size, EnumerateFiles(data, true, false)};
+    lock.lock();
+    it = s_file_cache.insert_or_assign(filename, std::move(entry)).first;
+  }
+  else
+  {
+    Log_DevPrintf("Using cached file list for '%s'", filename);
+  }
+
+  std::vector<FileInfo> files;
+  files.reserve(it->second.files.size());
+  for (const FileInfo& fi : it->second.files)
+  {
+    if (include_deleted || !fi.deleted)
+      files.push_back(fi);
   }
 
   return files;
 }
 
+void UpdateCachedIcons(const char* filename, const FileInfo& fi)
+{
+  std::unique_lock lock(s_file_cache_mutex);
+  const auto it = s_file_cache.find(filename);
+  if (it == s_file_cache.end())
+    return;
+
+  for (FileInfo& cached_fi : it->second.files)
+  {
+    if (cached_fi.first_block == fi.first_block && cached_fi.num_icon_frames == fi.num_icon_frames)
+    {
+      cached_fi.icon_frames = fi.icon_frames;
+      break;
+    }
+  }
+}
+
 bool ReadFile(const DataArray& data, const FileInfo& fi, std::vector<u8>* buffer)
 {
   buffer->resize(fi.num_blocks * BLOCK_SIZE);
@@ -42,14 +42,22 @@ struct FileInfo
   u32 size;
   u32 first_block;
   u32 num_blocks;
+  u32 num_icon_frames;
   bool deleted;
 
+  // Empty until DecodeIcons() is called, if the files were enumerated without icons.
   std::vector<IconFrame> icon_frames;
 };
 
 bool IsValid(const DataArray& data);
 u32 GetFreeBlockCount(const DataArray& data);
-std::vector<FileInfo> EnumerateFiles(const DataArray& data, bool include_deleted);
+std::vector<FileInfo> EnumerateFiles(const DataArray& data, bool include_deleted, bool decode_icons = true);
+void DecodeIcons(const DataArray& data, FileInfo* fi);
+
+/// Enumerates the files of a card loaded from filename, reusing the previous parse while the file's modification
+/// time and size are unchanged. Icons are only present if they were previously stored with UpdateCachedIcons().
+std::vector<FileInfo> EnumerateFilesCached(const char* filename, const DataArray& data, bool include_deleted);
+void UpdateCachedIcons(const char* filename, const FileInfo& fi);
 bool ReadFile(const DataArray& data, const FileInfo& fi, std::vector<u8>* buffer);
 bool WriteFile(DataArray* data, const std::string_view& filename, const std::vector<u8>& buffer);
 bool DeleteFile(DataArray* data, const FileInfo& fi, bool clear_sectors);
@@ -45,6 +45,14 @@ bool NeGcon::DoState(StateWrapper& sw, bool apply_input_state)
   return true;
 }
 
+bool NeGcon::DoInputState(StateWrapper& sw)
+{
+  sw.Do(&m_button_state);
+  sw.Do(&m_axis_state);
+  sw.Do(&m_half_axis_state);
+  return !sw.HasError();
+}
+
 float NeGcon::GetBindState(u32 index) const
 {
   if (index == (static_cast<u32>(Button::Count) + static_cast<u32>(HalfAxis::SteeringLeft)) ||
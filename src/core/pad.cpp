@@ -147,6 +147,9 @@ void Pad::Shutdown()
     s_controllers[i].reset();
     s_memory_cards[i].reset();
   }
+  s_dummy_card.reset();
+
+  MemoryCard::Shutdown();
 }
 
 void Pad::Reset()
@@ -763,6 +766,10 @@ void Pad::DoTransfer(TickCount ticks_late)
 
   const u8 data_out = s_transmit_value;
 
+  // Start of a controller poll, pick up any input which arrived since the frame started.
+  if (s_active_device == ActiveDevice::None && data_out == 0x01)
+    System::OnControllerRead();
+
   u8 data_in = 0xFF;
   bool ack = false;
 
@@ -882,11 +889,19 @@ void Pad::DoACK()
     InterruptController::InterruptRequest(InterruptController::IRQ::IRQ7);
   }
 
-  EndTransfer();
-  UpdateJoyStat();
+  if (!CanTransfer())
+  {
+    EndTransfer();
+    UpdateJoyStat();
+    return;
+  }
 
-  if (CanTransfer())
-    BeginTransfer();
+  // The next byte was queued while we were waiting for the ACK, so chain straight into it. The event stays active
+  // and is just rescheduled, rather than being pulled out of the queue and inserted again for every byte.
+  Log_DebugPrintf("Continuing transfer");
+  s_state = State::Idle;
+  UpdateJoyStat();
+  BeginTransfer();
 }
 
 void Pad::EndTransfer()
@@ -2,16 +2,23 @@
 // SPDX-License-Identifier: (GPL-3.0 OR CC-BY-NC-ND-4.0)
 
 #include "pcdrv.h"
+#include "bus.h"
 #include "common/file_system.h"
 #include "common/log.h"
 #include "common/path.h"
 #include "common/string_util.h"
+#include "cpu_code_cache.h"
 #include "cpu_core.h"
+#include "cpu_core_private.h"
 #include "settings.h"
+#include <cstring>
 Log_SetChannel(PCDrv);
 
 static constexpr u32 MAX_FILES = 100;
 
+/// Host files get a bigger buffer than the stdio default, homebrew tends to read assets in small pieces.
+static constexpr u32 FILE_BUFFER_SIZE = 256 * 1024;
+
 static std::vector<FileSystem::ManagedCFilePtr> s_files;
 
 enum PCDrvAttribute : u32
@@ -75,6 +82,32 @@ static bool CloseFileHandle(u32 handle)
   return true;
 }
 
+/// Returns a pointer into RAM for the guest range, if it's all in RAM without wrapping around, otherwise null.
+static u8* GetRAMPointerForRange(VirtualMemoryAddress address, u32 size)
+{
+  if (CPU::GetSegmentForAddress(address) == CPU::Segment::KSEG2)
+    return nullptr;
+
+  const PhysicalMemoryAddress phys_addr = address & CPU::PHYSICAL_MEMORY_ADDRESS_MASK;
+  if (!Bus::IsRAMAddress(phys_addr))
+    return nullptr;
+
+  const u32 offset = phys_addr & Bus::g_ram_mask;
+  if (size > Bus::g_ram_size - offset)
+    return nullptr;
+
+  return &Bus::g_ram[offset];
+}
+
+/// Flags RAM written by a transfer, so the code cache and memory save states pick up the changes.
+static void MarkRAMWritten(VirtualMemoryAddress address, u32 size)
+{
+  const u32 offset = (address & CPU::PHYSICAL_MEMORY_ADDRESS_MASK) & Bus::g_ram_mask;
+  const u32 aligned_offset = offset & ~3u;
+  Bus::MarkRAMDirty(offset, size);
+  CPU::CodeCache::InvalidateCodePages(aligned_offset, (offset - aligned_offset + size + 3) / 4);
+}
+
 static std::string ResolveHostPath(const std::string& path)
 {
   // Double-check that it falls within the directory of the elf.
@@ -188,6 +221,8 @@ bool PCDrv::HandleSyscall(u32 instruction_bits, CPU::Registers& regs)
         return true;
       }
 
+      std::setvbuf(s_files[handle].get(), nullptr, _IOFBF, FILE_BUFFER_SIZE);
+
       Log_DebugPrintf("PCDrv: Opened '%s' => %d", filename.c_str(), handle);
       regs.v0 = 0;
       regs.v1 = static_cast<u32>(handle);
@@ -221,25 +256,46 @@ bool PCDrv::HandleSyscall(u32 instruction_bits, CPU::Registers& regs)
       }
 
       const u32 count = regs.a2;
-      u32 dstaddr = regs.a3;
-      for (u32 i = 0; i < count; i++)
+      const u32 dstaddr = regs.a3;
+
+      // Reads straight into RAM where possible, anywhere else goes through a buffer and is written a byte at a time.
+      // Does not stop at EOF according to psx-spx.
+      if (u8* ram_ptr = GetRAMPointerForRange(dstaddr, count); ram_ptr && count > 0)
+      {
+        const size_t bytes_read = std::fread(ram_ptr, 1, count, fp);
+        if (bytes_read != count)
+          std::memset(ram_ptr + bytes_read, 0, count - bytes_read);
+
+        MarkRAMWritten(dstaddr, count);
+        if (std::ferror(fp) != 0)
+        {
+          RETURN_ERROR();
+          return true;
+        }
+      }
+      else
       {
-        // Certainly less than optimal, but it's not like you're going to be reading megabytes of data here.
-        u8 val;
-        if (std::fread(&val, 1, 1, fp) != 1)
+        std::vector<u8> buffer(std::min(count, FILE_BUFFER_SIZE));
+        for (u32 done = 0; done < count;)
         {
-          // Does not stop at EOF according to psx-spx.
-          if (std::ferror(fp) != 0)
+          const u32 chunk = std::min(count - done, FILE_BUFFER_SIZE);
+          const size_t bytes_read = std::fread(buffer.data(), 1, chunk, fp);
+          if (bytes_read != chunk)
           {
-            RETURN_ERROR();
-            return true;
+            if (std::ferror(fp) != 0)
+            {
+              RETURN_ERROR();
+              return true;
+            }
+
+            std::memset(buffer.data() + bytes_read, 0, chunk - bytes_read);
           }
 
-          val = 0;
-        }
+          for (u32 i = 0; i < chunk; i++)
+            CPU::SafeWriteMemoryByte(dstaddr + done + i, buffer[i]);
 
-        CPU::SafeWriteMemoryByte(dstaddr, val);
-        dstaddr++;
+          done += chunk;
+        }
       }
 
       regs.v0 = 0;
@@ -259,22 +315,45 @@ bool PCDrv::HandleSyscall(u32 instruction_bits, CPU::Registers& regs)
       }
 
       const u32 count = regs.a2;
-      u32 srcaddr = regs.a3;
+      const u32 srcaddr = regs.a3;
       u32 written = 0;
-      for (u32 i = 0; i < count; i++)
+      if (const u8* ram_ptr = GetRAMPointerForRange(srcaddr, count); ram_ptr && count > 0)
       {
-        u8 val;
-        if (!CPU::SafeReadMemoryByte(srcaddr, &val))
-          break;
-
-        if (std::fwrite(&val, 1, 1, fp) != 1)
+        if (std::fwrite(ram_ptr, 1, count, fp) != count)
         {
           RETURN_ERROR();
           return true;
         }
 
-        srcaddr++;
-        written++;
+        written = count;
+      }
+      else
+      {
+        // Stops at the first byte which can't be read.
+        std::vector<u8> buffer;
+        buffer.reserve(std::min(count, FILE_BUFFER_SIZE));
+        bool readable = true;
+        while (readable && written < count)
+        {
+          buffer.clear();
+          const u32 chunk = std::min(count - written, FILE_BUFFER_SIZE);
+          for (u32 i = 0; i < chunk; i++)
+          {
+            u8 val;
+            if (!(readable = CPU::SafeReadMemoryByte(srcaddr + written + i, &val)))
+              break;
+
+            buffer.push_back(val);
+          }
+
+          if (!buffer.empty() && std::fwrite(buffer.data(), 1, buffer.size(), fp) != buffer.size())
+          {
+            RETURN_ERROR();
+            return true;
+          }
+
+          written += static_cast<u32>(buffer.size());
+        }
       }
 
       regs.v0 = 0;
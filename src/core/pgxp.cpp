@@ -23,6 +23,7 @@
 #include "common/log.h"
 #include "cpu_core.h"
 #include "settings.h"
+#include <array>
 #include <climits>
 #include <cmath>
 Log_SetChannel(PGXP);
@@ -31,11 +32,19 @@ namespace PGXP {
 
 enum : u32
 {
-  VERTEX_CACHE_WIDTH = 0x800 * 2,
-  VERTEX_CACHE_HEIGHT = 0x800 * 2,
-  VERTEX_CACHE_SIZE = VERTEX_CACHE_WIDTH * VERTEX_CACHE_HEIGHT,
+  // Vertex cache is a hash table keyed by screen coordinates, a frame only touches a few thousand distinct vertices.
+  VERTEX_CACHE_BITS = 16,
+  VERTEX_CACHE_SIZE = 1u << VERTEX_CACHE_BITS,
+  VERTEX_CACHE_MASK = VERTEX_CACHE_SIZE - 1,
+  VERTEX_CACHE_MAX_PROBES = 8,
   PGXP_MEM_SIZE = (Bus::RAM_8MB_SIZE + CPU::DCACHE_SIZE) / 4,
-  PGXP_MEM_SCRATCH_OFFSET = Bus::RAM_8MB_SIZE / 4
+  PGXP_MEM_SCRATCH_OFFSET = Bus::RAM_8MB_SIZE / 4,
+
+  // Shadow memory is allocated in pages on first write, most of RAM never holds precise values.
+  PGXP_MEM_PAGE_SHIFT = 10,
+  PGXP_MEM_PAGE_SIZE = 1u << PGXP_MEM_PAGE_SHIFT,
+  PGXP_MEM_PAGE_MASK = PGXP_MEM_PAGE_SIZE - 1,
+  PGXP_MEM_PAGE_COUNT = (PGXP_MEM_SIZE + PGXP_MEM_PAGE_MASK) / PGXP_MEM_PAGE_SIZE
 };
 
 #define NONE 0
@@ -86,6 +95,7 @@ typedef union
   s32 sd;
 } psx_value;
 
+static void InvalidateVertexCache();
 static void PGXP_CacheVertex(s16 sx, s16 sy, const PGXP_value& vertex);
 
 static void MakeValid(PGXP_value* pV, u32 psxV);
@@ -96,8 +106,11 @@ static double f16Sign(double in);
 static double f16Unsign(double in);
 static double f16Overflow(double in);
 
+static u32 GetMemIndex(u32 addr);
+static PGXP_value* AllocateMemPage(u32 page);
 static PGXP_value* GetPtr(u32 addr);
 static PGXP_value* ReadMem(u32 addr);
+static void FreeMemPages();
 
 static const PGXP_value PGXP_value_invalid = {0.f, 0.f, 0.f, {0}, 0};
 static const PGXP_value PGXP_value_zero = {0.f, 0.f, 0.f, {VALID_ALL}, 0};
@@ -111,8 +124,34 @@ static PGXP_value CP0_reg[32];
 static PGXP_value GTE_data_reg[32];
 static PGXP_value GTE_ctrl_reg[32];
 
-static PGXP_value* Mem = nullptr;
-static PGXP_value* vertexCache = nullptr;
+static std::array<PGXP_value*, PGXP_MEM_PAGE_COUNT> MemPages = {};
+
+// Returned for reads of pages which have not been written. Validating an invalid value leaves it unchanged, so this
+// stays zero even though the read paths can write to it.
+static PGXP_value MemZeroValue = {};
+
+// Entries are tagged with the frame they were written in, and are only used for the following frame. Bumping the
+// generation discards the whole cache without touching it.
+struct VertexCacheEntry
+{
+  u32 key;
+  u32 generation;
+  PGXP_value value;
+};
+
+static VertexCacheEntry* vertexCache = nullptr;
+static u32 vertexCacheGeneration = 0;
+
+static_assert(sizeof(PGXP_value) == SHADOW_VALUE_SIZE && offsetof(PGXP_value, x) == SHADOW_VALUE_X_OFFSET &&
+              offsetof(PGXP_value, y) == SHADOW_VALUE_Y_OFFSET && offsetof(PGXP_value, z) == SHADOW_VALUE_Z_OFFSET &&
+              offsetof(PGXP_value, flags) == SHADOW_VALUE_FLAGS_OFFSET &&
+              offsetof(PGXP_value, value) == SHADOW_VALUE_VALUE_OFFSET);
+static_assert(VALID_01 == SHADOW_FLAGS_VALID_01 && INV_VALID_ALL == SHADOW_FLAGS_INVALID_MASK);
+
+u8* GetCPURegisterShadow(u32 index)
+{
+  return reinterpret_cast<u8*>(&CPU_reg[index]);
+}
 
 ALWAYS_INLINE_RELEASE void MakeValid(PGXP_value* pV, u32 psxV)
 {
@@ -155,26 +194,67 @@ ALWAYS_INLINE_RELEASE double f16Overflow(double in)
   return out;
 }
 
-ALWAYS_INLINE_RELEASE PGXP_value* GetPtr(u32 addr)
+ALWAYS_INLINE_RELEASE u32 GetMemIndex(u32 addr)
 {
   if ((addr & CPU::DCACHE_LOCATION_MASK) == CPU::DCACHE_LOCATION)
-    return &Mem[PGXP_MEM_SCRATCH_OFFSET + ((addr & CPU::DCACHE_OFFSET_MASK) >> 2)];
+    return PGXP_MEM_SCRATCH_OFFSET + ((addr & CPU::DCACHE_OFFSET_MASK) >> 2);
 
   const u32 paddr = (addr & CPU::PHYSICAL_MEMORY_ADDRESS_MASK);
   if (paddr < Bus::RAM_MIRROR_END)
-    return &Mem[(paddr & Bus::g_ram_mask) >> 2];
+    return (paddr & Bus::g_ram_mask) >> 2;
   else
+    return PGXP_MEM_SIZE;
+}
+
+PGXP_value* AllocateMemPage(u32 page)
+{
+  PGXP_value* ptr = static_cast<PGXP_value*>(std::calloc(PGXP_MEM_PAGE_SIZE, sizeof(PGXP_value)));
+  if (!ptr)
+  {
+    std::fprintf(stderr, "Failed to allocate PGXP memory\n");
+    std::abort();
+  }
+
+  MemPages[page] = ptr;
+  return ptr;
+}
+
+ALWAYS_INLINE_RELEASE PGXP_value* GetPtr(u32 addr)
+{
+  const u32 index = GetMemIndex(addr);
+  if (index >= PGXP_MEM_SIZE)
     return nullptr;
+
+  const u32 page = index >> PGXP_MEM_PAGE_SHIFT;
+  PGXP_value* ptr = MemPages[page];
+  if (!ptr)
+    ptr = AllocateMemPage(page);
+
+  return &ptr[index & PGXP_MEM_PAGE_MASK];
 }
 
 ALWAYS_INLINE_RELEASE PGXP_value* ReadMem(u32 addr)
 {
-  return GetPtr(addr);
+  const u32 index = GetMemIndex(addr);
+  if (index >= PGXP_MEM_SIZE)
+    return nullptr;
+
+  PGXP_value* ptr = MemPages[index >> PGXP_MEM_PAGE_SHIFT];
+  return ptr ? &ptr[index & PGXP_MEM_PAGE_MASK] : &MemZeroValue;
+}
+
+void FreeMemPages()
+{
+  for (PGXP_value*& page : MemPages)
+  {
+    std::free(page);
+    page = nullptr;
+  }
 }
 
 ALWAYS_INLINE_RELEASE void ValidateAndCopyMem(PGXP_value* dest, u32 addr, u32 value)
 {
-  PGXP_value* pMem = GetPtr(addr);
+  PGXP_value* pMem = ReadMem(addr);
   if (pMem != NULL)
   {
     Validate(pMem, value);
@@ -189,7 +269,7 @@ ALWAYS_INLINE_RELEASE static void ValidateAndCopyMem16(PGXP_value* dest, u32 add
 {
   u32 validMask = 0;
   psx_value val, mask;
-  PGXP_value* pMem = GetPtr(addr);
+  PGXP_value* pMem = ReadMem(addr);
   if (pMem != NULL)
   {
     mask.d = val.d = 0;
@@ -230,6 +310,15 @@ ALWAYS_INLINE_RELEASE static void ValidateAndCopyMem16(PGXP_value* dest, u32 add
 
 ALWAYS_INLINE_RELEASE void WriteMem(const PGXP_value* value, u32 addr)
 {
+  // don't allocate a page just to store an invalid value, reads already return one
+  if (value == &PGXP_value_invalid)
+  {
+    PGXP_value* pMem = ReadMem(addr);
+    if (pMem && pMem != &MemZeroValue)
+      *pMem = *value;
+    return;
+  }
+
   PGXP_value* pMem = GetPtr(addr);
 
   if (pMem)
@@ -277,19 +366,9 @@ void Initialize()
   std::memset(GTE_data_reg, 0, sizeof(GTE_data_reg));
   std::memset(GTE_ctrl_reg, 0, sizeof(GTE_ctrl_reg));
 
-  if (!Mem)
-  {
-    Mem = static_cast<PGXP_value*>(std::calloc(PGXP_MEM_SIZE, sizeof(PGXP_value)));
-    if (!Mem)
-    {
-      std::fprintf(stderr, "Failed to allocate PGXP memory\n");
-      std::abort();
-    }
-  }
-
   if (g_settings.gpu_pgxp_vertex_cache && !vertexCache)
   {
-    vertexCache = static_cast<PGXP_value*>(std::calloc(VERTEX_CACHE_SIZE, sizeof(PGXP_value)));
+    vertexCache = static_cast<VertexCacheEntry*>(std::calloc(VERTEX_CACHE_SIZE, sizeof(VertexCacheEntry)));
     if (!vertexCache)
     {
       Log_ErrorPrint("Failed to allocate memory for vertex cache, disabling.");
@@ -297,8 +376,7 @@ void Initialize()
     }
   }
 
-  if (vertexCache)
-    std::memset(vertexCache, 0, sizeof(PGXP_value) * VERTEX_CACHE_SIZE);
+  InvalidateVertexCache();
 }
 
 void Reset()
@@ -309,11 +387,8 @@ void Reset()
   std::memset(GTE_data_reg, 0, sizeof(GTE_data_reg));
   std::memset(GTE_ctrl_reg, 0, sizeof(GTE_ctrl_reg));
 
-  if (Mem)
-    std::memset(Mem, 0, sizeof(PGXP_value) * PGXP_MEM_SIZE);
-
-  if (vertexCache)
-    std::memset(vertexCache, 0, sizeof(PGXP_value) * VERTEX_CACHE_SIZE);
+  FreeMemPages();
+  InvalidateVertexCache();
 }
 
 void Shutdown()
@@ -323,11 +398,7 @@ void Shutdown()
     std::free(vertexCache);
     vertexCache = nullptr;
   }
-  if (Mem)
-  {
-    std::free(Mem);
-    Mem = nullptr;
-  }
+  FreeMemPages();
 
   std::memset(GTE_data_reg, 0, sizeof(GTE_data_reg));
   std::memset(GTE_ctrl_reg, 0, sizeof(GTE_ctrl_reg));
@@ -485,21 +556,71 @@ void CPU_SWC2(u32 instr, u32 rtVal, u32 addr)
   WriteMem(&GTE_data_reg[rt(instr)], addr);
 }
 
+void InvalidateVertexCache()
+{
+  // Entries from the current or previous generation are live, so skip two to drop everything.
+  vertexCacheGeneration += 2;
+}
+
+void NewFrame()
+{
+  vertexCacheGeneration++;
+}
+
+static ALWAYS_INLINE u32 GetVertexCacheKey(s16 sx, s16 sy)
+{
+  return ZeroExtend32(static_cast<u16>(sx)) | (ZeroExtend32(static_cast<u16>(sy)) << 16);
+}
+
+static ALWAYS_INLINE u32 GetVertexCacheSlot(u32 key)
+{
+  return (key * 0x9E3779B1u) >> (32 - VERTEX_CACHE_BITS);
+}
+
+static ALWAYS_INLINE bool IsVertexCacheEntryLive(const VertexCacheEntry& entry)
+{
+  return ((vertexCacheGeneration - entry.generation) <= 1);
+}
+
 ALWAYS_INLINE_RELEASE void PGXP_CacheVertex(s16 sx, s16 sy, const PGXP_value& vertex)
 {
-  if (sx >= -0x800 && sx <= 0x7ff && sy >= -0x800 && sy <= 0x7ff)
+  const u32 key = GetVertexCacheKey(sx, sy);
+  const u32 home = GetVertexCacheSlot(key);
+
+  // Reuse the entry for these coordinates, otherwise the first stale slot. If the probe window is full of live
+  // entries, the home slot is replaced.
+  VertexCacheEntry* slot = nullptr;
+  for (u32 i = 0; i < VERTEX_CACHE_MAX_PROBES; i++)
   {
-    // Write vertex into cache
-    vertexCache[(sy + 0x800) * VERTEX_CACHE_WIDTH + (sx + 0x800)] = vertex;
+    VertexCacheEntry& entry = vertexCache[(home + i) & VERTEX_CACHE_MASK];
+    if (!IsVertexCacheEntryLive(entry))
+    {
+      if (!slot)
+        slot = &entry;
+    }
+    else if (entry.key == key)
+    {
+      slot = &entry;
+      break;
+    }
   }
+  if (!slot)
+    slot = &vertexCache[home];
+
+  slot->key = key;
+  slot->generation = vertexCacheGeneration;
+  slot->value = vertex;
 }
 
-static ALWAYS_INLINE_RELEASE PGXP_value* PGXP_GetCachedVertex(short sx, short sy)
+static ALWAYS_INLINE_RELEASE const PGXP_value* PGXP_GetCachedVertex(short sx, short sy)
 {
-  if (sx >= -0x800 && sx <= 0x7ff && sy >= -0x800 && sy <= 0x7ff)
+  const u32 key = GetVertexCacheKey(sx, sy);
+  const u32 home = GetVertexCacheSlot(key);
+  for (u32 i = 0; i < VERTEX_CACHE_MAX_PROBES; i++)
   {
-    // Return pointer to cache entry
-    return &vertexCache[(sy + 0x800) * VERTEX_CACHE_WIDTH + (sx + 0x800)];
+    const VertexCacheEntry& entry = vertexCache[(home + i) & VERTEX_CACHE_MASK];
+    if (entry.key == key && IsVertexCacheEntryLive(entry))
+      return &entry.value;
   }
 
   return nullptr;
@@ -27,6 +27,26 @@ void Initialize();
 void Reset();
 void Shutdown();
 
+// Ages the vertex cache, entries are only matched in the frame they were written and the one after.
+void NewFrame();
+
+// Layout of the shadow values, so the recompiler can update simple cases inline.
+enum : u32
+{
+  SHADOW_VALUE_X_OFFSET = 0,
+  SHADOW_VALUE_Y_OFFSET = 4,
+  SHADOW_VALUE_Z_OFFSET = 8,
+  SHADOW_VALUE_FLAGS_OFFSET = 12,
+  SHADOW_VALUE_VALUE_OFFSET = 16,
+  SHADOW_VALUE_SIZE = 20,
+
+  SHADOW_FLAGS_VALID_01 = 0x00000101,
+  SHADOW_FLAGS_INVALID_MASK = 0xFEFEFEFE
+};
+
+// Returns the shadow value for a CPU register (0-31, 32 = hi, 33 = lo).
+u8* GetCPURegisterShadow(u32 index);
+
 // -- GTE functions
 // Transforms
 void GTE_PushSXYZ2f(float x, float y, float z, u32 v);
@@ -7,6 +7,7 @@
 #include "gpu.h"
 #include "host.h"
 #include "host_display.h"
+#include "input_movie.h"
 #include "system.h"
 #include "util/state_wrapper.h"
 #include <array>
@@ -54,6 +55,14 @@ bool PlayStationMouse::DoState(StateWrapper& sw, bool apply_input_state)
   return true;
 }
 
+bool PlayStationMouse::DoInputState(StateWrapper& sw)
+{
+  sw.Do(&m_button_state);
+  sw.Do(&m_delta_x);
+  sw.Do(&m_delta_y);
+  return !sw.HasError();
+}
+
 float PlayStationMouse::GetBindState(u32 index) const
 {
   if (index >= s_button_indices.size())
@@ -156,6 +165,10 @@ bool PlayStationMouse::Transfer(const u8 data_in, u8* data_out)
 
 void PlayStationMouse::UpdatePosition()
 {
+  // replayed input movies supply the movement
+  if (InputMovie::IsReplaying())
+    return;
+
   // get screen coordinates
   const s32 mouse_x = g_host_display->GetMousePositionX();
   const s32 mouse_y = g_host_display->GetMousePositionY();
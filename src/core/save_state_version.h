@@ -5,7 +5,7 @@
 #include "types.h"
 
 static constexpr u32 SAVE_STATE_MAGIC = 0x43435544;
-static constexpr u32 SAVE_STATE_VERSION = 58;
+static constexpr u32 SAVE_STATE_VERSION = 59;
 static constexpr u32 SAVE_STATE_MINIMUM_VERSION = 42;
 
 static_assert(SAVE_STATE_VERSION >= SAVE_STATE_MINIMUM_VERSION);
@@ -21,6 +21,7 @@ struct SAVE_STATE_HEADER
     COMPRESSION_TYPE_NONE = 0,
     COMPRESSION_TYPE_ZLIB = 1,
     COMPRESSION_TYPE_ZSTD = 2,
+    COMPRESSION_TYPE_ZSTD_SECTIONS = 3,
   };
 
   u32 magic;
@@ -43,4 +44,13 @@ struct SAVE_STATE_HEADER
   u32 data_uncompressed_size;
   u32 offset_to_data;
 };
+
+/// With COMPRESSION_TYPE_ZSTD_SECTIONS, the state data starts with a u32 section count and a table of these, followed
+/// by one independent zstd frame per section. Sections are split at the state markers, so a section can be decoded
+/// without decompressing the ones before it.
+struct SAVE_STATE_SECTION
+{
+  u32 uncompressed_size;
+  u32 compressed_size;
+};
 #pragma pack(pop)
@@ -164,6 +164,11 @@ void Settings::Load(SettingsInterface& si)
   turbo_speed = si.GetFloatValue("Main", "TurboSpeed", 0.0f);
   sync_to_host_refresh_rate = si.GetBoolValue("Main", "SyncToHostRefreshRate", false);
   increase_timer_resolution = si.GetBoolValue("Main", "IncreaseTimerResolution", true);
+  thread_affinity_policy =
+    ParseThreadAffinityPolicy(
+      si.GetStringValue("Main", "ThreadAffinityPolicy", GetThreadAffinityPolicyName(DEFAULT_THREAD_AFFINITY_POLICY))
+        .c_str())
+      .value_or(DEFAULT_THREAD_AFFINITY_POLICY);
   inhibit_screensaver = si.GetBoolValue("Main", "InhibitScreensaver", true);
   start_paused = si.GetBoolValue("Main", "StartPaused", false);
   start_fullscreen = si.GetBoolValue("Main", "StartFullscreen", false);
@@ -181,7 +186,9 @@ void Settings::Load(SettingsInterface& si)
   rewind_enable = si.GetBoolValue("Main", "RewindEnable", false);
   rewind_save_frequency = si.GetFloatValue("Main", "RewindFrequency", 10.0f);
   rewind_save_slots = static_cast<u32>(si.GetIntValue("Main", "RewindSaveSlots", 10));
+  rewind_native_vram = si.GetBoolValue("Main", "RewindNativeVRAM", false);
   runahead_frames = static_cast<u32>(si.GetIntValue("Main", "RunaheadFrameCount", 0));
+  runahead_skip_rendering = si.GetBoolValue("Main", "RunaheadSkipRendering", false);
 
   cpu_execution_mode =
     ParseCPUExecutionMode(
@@ -194,18 +201,29 @@ void Settings::Load(SettingsInterface& si)
   cpu_recompiler_memory_exceptions = si.GetBoolValue("CPU", "RecompilerMemoryExceptions", false);
   cpu_recompiler_block_linking = si.GetBoolValue("CPU", "RecompilerBlockLinking", true);
   cpu_recompiler_icache = si.GetBoolValue("CPU", "RecompilerICache", false);
+  cpu_recompiler_block_cache = si.GetBoolValue("CPU", "RecompilerBlockCache", false);
+  cpu_recompiler_async_compile = si.GetBoolValue("CPU", "RecompilerAsyncCompile", false);
+  cpu_recompiler_tier_threshold = si.GetUIntValue("CPU", "RecompilerTierThreshold", 0u);
+  cpu_idle_loop_skipping = si.GetBoolValue("CPU", "IdleLoopSkipping", false);
   cpu_fastmem_mode = ParseCPUFastmemMode(
                        si.GetStringValue("CPU", "FastmemMode", GetCPUFastmemModeName(DEFAULT_CPU_FASTMEM_MODE)).c_str())
                        .value_or(DEFAULT_CPU_FASTMEM_MODE);
+  cpu_use_large_pages = si.GetBoolValue("CPU", "UseLargePages", false);
 
   gpu_renderer = ParseRendererName(si.GetStringValue("GPU", "Renderer", GetRendererName(DEFAULT_GPU_RENDERER)).c_str())
                    .value_or(DEFAULT_GPU_RENDERER);
   gpu_adapter = si.GetStringValue("GPU", "Adapter", "");
   gpu_resolution_scale = static_cast<u32>(si.GetIntValue("GPU", "ResolutionScale", 1));
+  gpu_dynamic_resolution = si.GetBoolValue("GPU", "DynamicResolution", false);
+  gpu_dynamic_resolution_min_scale =
+    static_cast<u32>(std::max<int>(si.GetIntValue("GPU", "DynamicResolutionMinScale", 1), 1));
   gpu_multisamples = static_cast<u32>(si.GetIntValue("GPU", "Multisamples", 1));
   gpu_use_debug_device = si.GetBoolValue("GPU", "UseDebugDevice", false);
   gpu_per_sample_shading = si.GetBoolValue("GPU", "PerSampleShading", false);
   gpu_use_thread = si.GetBoolValue("GPU", "UseThread", true);
+  gpu_sw_worker_threads = static_cast<u8>(
+    std::clamp<int>(si.GetIntValue("GPU", "SoftwareWorkerThreads", 0), 0, GPU_SW_MAX_WORKER_THREADS));
+  gpu_use_render_thread = si.GetBoolValue("GPU", "UseRenderThread", false);
   gpu_use_software_renderer_for_readbacks = si.GetBoolValue("GPU", "UseSoftwareRendererForReadbacks", false);
   gpu_threaded_presentation = si.GetBoolValue("GPU", "ThreadedPresentation", true);
   gpu_true_color = si.GetBoolValue("GPU", "TrueColor", true);
@@ -214,10 +232,15 @@ void Settings::Load(SettingsInterface& si)
     ParseTextureFilterName(
       si.GetStringValue("GPU", "TextureFilter", GetTextureFilterName(DEFAULT_GPU_TEXTURE_FILTER)).c_str())
       .value_or(DEFAULT_GPU_TEXTURE_FILTER);
+  gpu_adaptive_texture_filtering = si.GetBoolValue("GPU", "AdaptiveTextureFiltering", false);
   gpu_downsample_mode =
     ParseDownsampleModeName(
       si.GetStringValue("GPU", "DownsampleMode", GetDownsampleModeName(DEFAULT_GPU_DOWNSAMPLE_MODE)).c_str())
       .value_or(DEFAULT_GPU_DOWNSAMPLE_MODE);
+  gpu_downsample_compute = si.GetBoolValue("GPU", "DownsampleCompute", true);
+  gpu_shader_mode =
+    ParseShaderModeName(si.GetStringValue("GPU", "ShaderMode", GetShaderModeName(DEFAULT_GPU_SHADER_MODE)).c_str())
+      .value_or(DEFAULT_GPU_SHADER_MODE);
   gpu_disable_interlacing = si.GetBoolValue("GPU", "DisableInterlacing", true);
   gpu_force_ntsc_timings = si.GetBoolValue("GPU", "ForceNTSCTimings", false);
   gpu_widescreen_hack = si.GetBoolValue("GPU", "WidescreenHack", false);
@@ -258,6 +281,7 @@ void Settings::Load(SettingsInterface& si)
   display_integer_scaling = si.GetBoolValue("Display", "IntegerScaling", false);
   display_stretch = si.GetBoolValue("Display", "Stretch", false);
   display_post_processing = si.GetBoolValue("Display", "PostProcessing", false);
+  display_post_process_fusion = si.GetBoolValue("Display", "PostProcessFusion", true);
   display_show_osd_messages = si.GetBoolValue("Display", "ShowOSDMessages", true);
   display_show_fps = si.GetBoolValue("Display", "ShowFPS", false);
   display_show_speed = si.GetBoolValue("Display", "ShowSpeed", false);
@@ -269,9 +293,12 @@ void Settings::Load(SettingsInterface& si)
   display_show_inputs = si.GetBoolValue("Display", "ShowInputs", false);
   display_show_enhancements = si.GetBoolValue("Display", "ShowEnhancements", false);
   display_all_frames = si.GetBoolValue("Display", "DisplayAllFrames", false);
+  display_low_latency_pacing = si.GetBoolValue("Display", "LowLatencyPacing", false);
+  display_late_input_latch = si.GetBoolValue("Display", "LateInputLatch", false);
   display_internal_resolution_screenshots = si.GetBoolValue("Display", "InternalResolutionScreenshots", false);
   display_stretch_vertically = si.GetBoolValue("Display", "StretchVertically", false);
   video_sync_enabled = si.GetBoolValue("Display", "VSync", DEFAULT_VSYNC_VALUE);
+  display_triple_buffering = si.GetBoolValue("Display", "TripleBuffering", false);
   display_post_process_chain = si.GetStringValue("Display", "PostProcessChain", "");
   display_max_fps = si.GetFloatValue("Display", "MaxFPS", DEFAULT_DISPLAY_MAX_FPS);
   display_osd_scale = si.GetFloatValue("Display", "OSDScale", DEFAULT_OSD_SCALE);
@@ -280,7 +307,11 @@ void Settings::Load(SettingsInterface& si)
     static_cast<u8>(si.GetIntValue("CDROM", "ReadaheadSectors", DEFAULT_CDROM_READAHEAD_SECTORS));
   cdrom_region_check = si.GetBoolValue("CDROM", "RegionCheck", false);
   cdrom_load_image_to_ram = si.GetBoolValue("CDROM", "LoadImageToRAM", false);
+  cdrom_load_image_to_ram_compressed = si.GetBoolValue("CDROM", "LoadImageToRAMCompressed", false);
   cdrom_load_image_patches = si.GetBoolValue("CDROM", "LoadImagePatches", false);
+  cdrom_decompression_cache_blocks = static_cast<u8>(
+    si.GetIntValue("CDROM", "DecompressionCacheBlocks", DEFAULT_CDROM_DECOMPRESSION_CACHE_BLOCKS));
+  cdrom_decompression_prefetch = si.GetBoolValue("CDROM", "DecompressionPrefetch", false);
   cdrom_mute_cd_audio = si.GetBoolValue("CDROM", "MuteCDAudio", false);
   cdrom_read_speedup = si.GetIntValue("CDROM", "ReadSpeedup", 1);
   cdrom_seek_speedup = si.GetIntValue("CDROM", "SeekSpeedup", 1);
@@ -294,6 +325,7 @@ void Settings::Load(SettingsInterface& si)
     AudioStream::ParseStretchMode(
       si.GetStringValue("Audio", "StretchMode", AudioStream::GetStretchModeName(DEFAULT_AUDIO_STRETCH_MODE)).c_str())
       .value_or(DEFAULT_AUDIO_STRETCH_MODE);
+  audio_stretch_thread = si.GetBoolValue("Audio", "StretchThread", false);
   audio_output_latency_ms = si.GetUIntValue("Audio", "OutputLatencyMS", DEFAULT_AUDIO_OUTPUT_LATENCY_MS);
   audio_buffer_ms = si.GetUIntValue("Audio", "BufferMS", DEFAULT_AUDIO_BUFFER_MS);
   audio_output_volume = si.GetUIntValue("Audio", "OutputVolume", 100);
@@ -303,6 +335,7 @@ void Settings::Load(SettingsInterface& si)
   audio_dump_on_boot = si.GetBoolValue("Audio", "DumpOnBoot", false);
 
   use_old_mdec_routines = si.GetBoolValue("Hacks", "UseOldMDECRoutines", false);
+  mdec_decode_thread = si.GetBoolValue("Hacks", "MDECDecodeThread", false);
   pcdrv_enable = si.GetBoolValue("PCDrv", "Enabled", false);
   pcdrv_enable_writes = si.GetBoolValue("PCDrv", "EnableWrites", false);
   pcdrv_root = si.GetStringValue("PCDrv", "Root");
@@ -314,6 +347,7 @@ void Settings::Load(SettingsInterface& si)
 
   bios_patch_tty_enable = si.GetBoolValue("BIOS", "PatchTTYEnable", false);
   bios_patch_fast_boot = si.GetBoolValue("BIOS", "PatchFastBoot", DEFAULT_FAST_BOOT_VALUE);
+  bios_exe_boot_snapshot = si.GetBoolValue("BIOS", "EXEBootSnapshot", false);
 
   multitap_mode =
     ParseMultitapModeName(
@@ -374,22 +408,32 @@ void Settings::Load(SettingsInterface& si)
   log_to_debug = si.GetBoolValue("Logging", "LogToDebug", false);
   log_to_window = si.GetBoolValue("Logging", "LogToWindow", false);
   log_to_file = si.GetBoolValue("Logging", "LogToFile", false);
+  log_async_output = si.GetBoolValue("Logging", "AsyncOutput", false);
 
   debugging.show_vram = si.GetBoolValue("Debug", "ShowVRAM");
   debugging.dump_cpu_to_vram_copies = si.GetBoolValue("Debug", "DumpCPUToVRAMCopies");
   debugging.dump_vram_to_cpu_copies = si.GetBoolValue("Debug", "DumpVRAMToCPUCopies");
   debugging.enable_gdb_server = si.GetBoolValue("Debug", "EnableGDBServer");
   debugging.gdb_server_port = static_cast<u16>(si.GetIntValue("Debug", "GDBServerPort"));
+  debugging.count_io_accesses = si.GetBoolValue("Debug", "CountIOAccesses");
+  debugging.profile_cpu = si.GetBoolValue("Debug", "ProfileCPU");
+  debugging.dump_frame_time_histograms = si.GetBoolValue("Debug", "DumpFrameTimeHistograms");
   debugging.show_gpu_state = si.GetBoolValue("Debug", "ShowGPUState");
   debugging.show_cdrom_state = si.GetBoolValue("Debug", "ShowCDROMState");
   debugging.show_spu_state = si.GetBoolValue("Debug", "ShowSPUState");
   debugging.show_timers_state = si.GetBoolValue("Debug", "ShowTimersState");
   debugging.show_mdec_state = si.GetBoolValue("Debug", "ShowMDECState");
   debugging.show_dma_state = si.GetBoolValue("Debug", "ShowDMAState");
+  debugging.show_io_access_counts = si.GetBoolValue("Debug", "ShowIOAccessCounts");
+  debugging.show_cpu_profile = si.GetBoolValue("Debug", "ShowCPUProfile");
+  debugging.show_code_cache_stats = si.GetBoolValue("Debug", "ShowCodeCacheStats");
+  debugging.show_timing_events = si.GetBoolValue("Debug", "ShowTimingEvents");
 
   texture_replacements.enable_vram_write_replacements =
     si.GetBoolValue("TextureReplacements", "EnableVRAMWriteReplacements", false);
   texture_replacements.preload_textures = si.GetBoolValue("TextureReplacements", "PreloadTextures", false);
+  texture_replacements.async_loading = si.GetBoolValue("TextureReplacements", "AsyncLoading", false);
+  texture_replacements.max_cache_size_mb = si.GetUIntValue("TextureReplacements", "MaxCacheSize", 0u);
   texture_replacements.dump_vram_writes = si.GetBoolValue("TextureReplacements", "DumpVRAMWrites", false);
   texture_replacements.dump_vram_write_force_alpha_channel =
     si.GetBoolValue("TextureReplacements", "DumpVRAMWriteForceAlphaChannel", true);
@@ -409,6 +453,7 @@ void Settings::Save(SettingsInterface& si) const
   si.SetFloatValue("Main", "TurboSpeed", turbo_speed);
   si.SetBoolValue("Main", "SyncToHostRefreshRate", sync_to_host_refresh_rate);
   si.SetBoolValue("Main", "IncreaseTimerResolution", increase_timer_resolution);
+  si.SetStringValue("Main", "ThreadAffinityPolicy", GetThreadAffinityPolicyName(thread_affinity_policy));
   si.SetBoolValue("Main", "InhibitScreensaver", inhibit_screensaver);
   si.SetBoolValue("Main", "StartPaused", start_paused);
   si.SetBoolValue("Main", "StartFullscreen", start_fullscreen);
@@ -426,7 +471,9 @@ void Settings::Save(SettingsInterface& si) const
   si.SetBoolValue("Main", "RewindEnable", rewind_enable);
   si.SetFloatValue("Main", "RewindFrequency", rewind_save_frequency);
   si.SetIntValue("Main", "RewindSaveSlots", rewind_save_slots);
+  si.SetBoolValue("Main", "RewindNativeVRAM", rewind_native_vram);
   si.SetIntValue("Main", "RunaheadFrameCount", runahead_frames);
+  si.SetBoolValue("Main", "RunaheadSkipRendering", runahead_skip_rendering);
 
   si.SetStringValue("CPU", "ExecutionMode", GetCPUExecutionModeName(cpu_execution_mode));
   si.SetBoolValue("CPU", "OverclockEnable", cpu_overclock_enable);
@@ -435,21 +482,33 @@ void Settings::Save(SettingsInterface& si) const
   si.SetBoolValue("CPU", "RecompilerMemoryExceptions", cpu_recompiler_memory_exceptions);
   si.SetBoolValue("CPU", "RecompilerBlockLinking", cpu_recompiler_block_linking);
   si.SetBoolValue("CPU", "RecompilerICache", cpu_recompiler_icache);
+  si.SetBoolValue("CPU", "RecompilerBlockCache", cpu_recompiler_block_cache);
+  si.SetBoolValue("CPU", "RecompilerAsyncCompile", cpu_recompiler_async_compile);
+  si.SetUIntValue("CPU", "RecompilerTierThreshold", cpu_recompiler_tier_threshold);
+  si.SetBoolValue("CPU", "IdleLoopSkipping", cpu_idle_loop_skipping);
   si.SetStringValue("CPU", "FastmemMode", GetCPUFastmemModeName(cpu_fastmem_mode));
+  si.SetBoolValue("CPU", "UseLargePages", cpu_use_large_pages);
 
   si.SetStringValue("GPU", "Renderer", GetRendererName(gpu_renderer));
   si.SetStringValue("GPU", "Adapter", gpu_adapter.c_str());
   si.SetIntValue("GPU", "ResolutionScale", static_cast<long>(gpu_resolution_scale));
+  si.SetBoolValue("GPU", "DynamicResolution", gpu_dynamic_resolution);
+  si.SetIntValue("GPU", "DynamicResolutionMinScale", static_cast<long>(gpu_dynamic_resolution_min_scale));
   si.SetIntValue("GPU", "Multisamples", static_cast<long>(gpu_multisamples));
   si.SetBoolValue("GPU", "UseDebugDevice", gpu_use_debug_device);
   si.SetBoolValue("GPU", "PerSampleShading", gpu_per_sample_shading);
   si.SetBoolValue("GPU", "UseThread", gpu_use_thread);
+  si.SetIntValue("GPU", "SoftwareWorkerThreads", gpu_sw_worker_threads);
+  si.SetBoolValue("GPU", "UseRenderThread", gpu_use_render_thread);
   si.SetBoolValue("GPU", "ThreadedPresentation", gpu_threaded_presentation);
   si.SetBoolValue("GPU", "UseSoftwareRendererForReadbacks", gpu_use_software_renderer_for_readbacks);
   si.SetBoolValue("GPU", "TrueColor", gpu_true_color);
   si.SetBoolValue("GPU", "ScaledDithering", gpu_scaled_dithering);
   si.SetStringValue("GPU", "TextureFilter", GetTextureFilterName(gpu_texture_filter));
+  si.SetBoolValue("GPU", "AdaptiveTextureFiltering", gpu_adaptive_texture_filtering);
   si.SetStringValue("GPU", "DownsampleMode", GetDownsampleModeName(gpu_downsample_mode));
+  si.SetBoolValue("GPU", "DownsampleCompute", gpu_downsample_compute);
+  si.SetStringValue("GPU", "ShaderMode", GetShaderModeName(gpu_shader_mode));
   si.SetBoolValue("GPU", "DisableInterlacing", gpu_disable_interlacing);
   si.SetBoolValue("GPU", "ForceNTSCTimings", gpu_force_ntsc_timings);
   si.SetBoolValue("GPU", "WidescreenHack", gpu_widescreen_hack);
@@ -479,6 +538,7 @@ void Settings::Save(SettingsInterface& si) const
   si.SetBoolValue("Display", "IntegerScaling", display_integer_scaling);
   si.SetBoolValue("Display", "Stretch", display_stretch);
   si.SetBoolValue("Display", "PostProcessing", display_post_processing);
+  si.SetBoolValue("Display", "PostProcessFusion", display_post_process_fusion);
   si.SetBoolValue("Display", "ShowOSDMessages", display_show_osd_messages);
   si.SetBoolValue("Display", "ShowFPS", display_show_fps);
   si.SetBoolValue("Display", "ShowSpeed", display_show_speed);
@@ -490,9 +550,12 @@ void Settings::Save(SettingsInterface& si) const
   si.SetBoolValue("Display", "ShowInputs", display_show_inputs);
   si.SetBoolValue("Display", "ShowEnhancements", display_show_enhancements);
   si.SetBoolValue("Display", "DisplayAllFrames", display_all_frames);
+  si.SetBoolValue("Display", "LowLatencyPacing", display_low_latency_pacing);
+  si.SetBoolValue("Display", "LateInputLatch", display_late_input_latch);
   si.SetBoolValue("Display", "InternalResolutionScreenshots", display_internal_resolution_screenshots);
   si.SetBoolValue("Display", "StretchVertically", display_stretch_vertically);
   si.SetBoolValue("Display", "VSync", video_sync_enabled);
+  si.SetBoolValue("Display", "TripleBuffering", display_triple_buffering);
   if (display_post_process_chain.empty())
     si.DeleteValue("Display", "PostProcessChain");
   else
@@ -503,7 +566,10 @@ void Settings::Save(SettingsInterface& si) const
   si.SetIntValue("CDROM", "ReadaheadSectors", cdrom_readahead_sectors);
   si.SetBoolValue("CDROM", "RegionCheck", cdrom_region_check);
   si.SetBoolValue("CDROM", "LoadImageToRAM", cdrom_load_image_to_ram);
+  si.SetBoolValue("CDROM", "LoadImageToRAMCompressed", cdrom_load_image_to_ram_compressed);
   si.SetBoolValue("CDROM", "LoadImagePatches", cdrom_load_image_patches);
+  si.SetIntValue("CDROM", "DecompressionCacheBlocks", cdrom_decompression_cache_blocks);
+  si.SetBoolValue("CDROM", "DecompressionPrefetch", cdrom_decompression_prefetch);
   si.SetBoolValue("CDROM", "MuteCDAudio", cdrom_mute_cd_audio);
   si.SetIntValue("CDROM", "ReadSpeedup", cdrom_read_speedup);
   si.SetIntValue("CDROM", "SeekSpeedup", cdrom_seek_speedup);
@@ -512,6 +578,7 @@ void Settings::Save(SettingsInterface& si) const
   si.SetStringValue("Audio", "Driver", audio_driver.c_str());
   si.SetStringValue("Audio", "OutputDevice", audio_output_device.c_str());
   si.SetStringValue("Audio", "StretchMode", AudioStream::GetStretchModeName(audio_stretch_mode));
+  si.SetBoolValue("Audio", "StretchThread", audio_stretch_thread);
   si.SetUIntValue("Audio", "BufferMS", audio_buffer_ms);
   si.SetUIntValue("Audio", "OutputLatencyMS", audio_output_latency_ms);
   si.SetUIntValue("Audio", "OutputVolume", audio_output_volume);
@@ -520,6 +587,7 @@ void Settings::Save(SettingsInterface& si) const
   si.SetBoolValue("Audio", "DumpOnBoot", audio_dump_on_boot);
 
   si.SetBoolValue("Hacks", "UseOldMDECRoutines", use_old_mdec_routines);
+  si.SetBoolValue("Hacks", "MDECDecodeThread", mdec_decode_thread);
   si.SetIntValue("Hacks", "DMAMaxSliceTicks", dma_max_slice_ticks);
   si.SetIntValue("Hacks", "DMAHaltTicks", dma_halt_ticks);
   si.SetIntValue("Hacks", "GPUFIFOSize", gpu_fifo_size);
@@ -531,6 +599,7 @@ void Settings::Save(SettingsInterface& si) const
 
   si.SetBoolValue("BIOS", "PatchTTYEnable", bios_patch_tty_enable);
   si.SetBoolValue("BIOS", "PatchFastBoot", bios_patch_fast_boot);
+  si.SetBoolValue("BIOS", "EXEBootSnapshot", bios_exe_boot_snapshot);
 
   for (u32 i = 0; i < NUM_CONTROLLER_AND_CARD_PORTS; i++)
     si.SetStringValue(Controller::GetSettingsSection(i).c_str(), "Type", GetControllerTypeName(controller_types[i]));
@@ -570,6 +639,7 @@ void Settings::Save(SettingsInterface& si) const
   si.SetBoolValue("Logging", "LogToDebug", log_to_debug);
   si.SetBoolValue("Logging", "LogToWindow", log_to_window);
   si.SetBoolValue("Logging", "LogToFile", log_to_file);
+  si.SetBoolValue("Logging", "AsyncOutput", log_async_output);
 
   si.SetBoolValue("Debug", "ShowVRAM", debugging.show_vram);
   si.SetBoolValue("Debug", "DumpCPUToVRAMCopies", debugging.dump_cpu_to_vram_copies);
@@ -580,10 +650,16 @@ void Settings::Save(SettingsInterface& si) const
   si.SetBoolValue("Debug", "ShowTimersState", debugging.show_timers_state);
   si.SetBoolValue("Debug", "ShowMDECState", debugging.show_mdec_state);
   si.SetBoolValue("Debug", "ShowDMAState", debugging.show_dma_state);
+  si.SetBoolValue("Debug", "ShowIOAccessCounts", debugging.show_io_access_counts);
+  si.SetBoolValue("Debug", "ShowCPUProfile", debugging.show_cpu_profile);
+  si.SetBoolValue("Debug", "ShowCodeCacheStats", debugging.show_code_cache_stats);
+  si.SetBoolValue("Debug", "ShowTimingEvents", debugging.show_timing_events);
 
   si.SetBoolValue("TextureReplacements", "EnableVRAMWriteReplacements",
                   texture_replacements.enable_vram_write_replacements);
   si.SetBoolValue("TextureReplacements", "PreloadTextures", texture_replacements.preload_textures);
+  si.SetBoolValue("TextureReplacements", "AsyncLoading", texture_replacements.async_loading);
+  si.SetUIntValue("TextureReplacements", "MaxCacheSize", texture_replacements.max_cache_size_mb);
   si.SetBoolValue("TextureReplacements", "DumpVRAMWrites", texture_replacements.dump_vram_writes);
   si.SetBoolValue("TextureReplacements", "DumpVRAMWriteForceAlphaChannel",
                   texture_replacements.dump_vram_write_force_alpha_channel);
@@ -602,6 +678,7 @@ void Settings::FixIncompatibleSettings(bool display_osd_messages)
     g_settings.cpu_overclock_active = false;
     g_settings.enable_8mb_ram = false;
     g_settings.gpu_resolution_scale = 1;
+    g_settings.gpu_dynamic_resolution = false;
     g_settings.gpu_multisamples = 1;
     g_settings.gpu_per_sample_shading = false;
     g_settings.gpu_true_color = false;
@@ -722,6 +799,10 @@ void Settings::FixIncompatibleSettings(bool display_osd_messages)
     g_settings.debugging.show_timers_state = false;
     g_settings.debugging.show_mdec_state = false;
     g_settings.debugging.show_dma_state = false;
+    g_settings.debugging.show_io_access_counts = false;
+    g_settings.debugging.show_cpu_profile = false;
+    g_settings.debugging.show_code_cache_stats = false;
+    g_settings.debugging.show_timing_events = false;
     g_settings.debugging.dump_cpu_to_vram_copies = false;
     g_settings.debugging.dump_vram_to_cpu_copies = false;
   }
@@ -878,6 +959,37 @@ const char* Settings::GetCPUFastmemModeDisplayName(CPUFastmemMode mode)
   return s_cpu_fastmem_mode_display_names[static_cast<u8>(mode)];
 }
 
+static std::array<const char*, static_cast<u32>(ThreadAffinityPolicy::Count)> s_thread_affinity_policy_names = {
+  {"Disabled", "Automatic", "Always"}};
+static std::array<const char*, static_cast<u32>(ThreadAffinityPolicy::Count)>
+  s_thread_affinity_policy_display_names = {{TRANSLATABLE("ThreadAffinityPolicy", "Disabled (Let OS Decide)"),
+                                             TRANSLATABLE("ThreadAffinityPolicy", "Automatic (Hybrid CPUs Only)"),
+                                             TRANSLATABLE("ThreadAffinityPolicy", "Always Pin Emulation Threads")}};
+
+std::optional<ThreadAffinityPolicy> Settings::ParseThreadAffinityPolicy(const char* str)
+{
+  u8 index = 0;
+  for (const char* name : s_thread_affinity_policy_names)
+  {
+    if (StringUtil::Strcasecmp(name, str) == 0)
+      return static_cast<ThreadAffinityPolicy>(index);
+
+    index++;
+  }
+
+  return std::nullopt;
+}
+
+const char* Settings::GetThreadAffinityPolicyName(ThreadAffinityPolicy policy)
+{
+  return s_thread_affinity_policy_names[static_cast<u8>(policy)];
+}
+
+const char* Settings::GetThreadAffinityPolicyDisplayName(ThreadAffinityPolicy policy)
+{
+  return s_thread_affinity_policy_display_names[static_cast<u8>(policy)];
+}
+
 static constexpr auto s_gpu_renderer_names = make_array(
 #ifdef _WIN32
   "D3D11", "D3D12",
@@ -1011,6 +1123,35 @@ const char* Settings::GetDownsampleModeDisplayName(GPUDownsampleMode mode)
   return s_downsample_mode_display_names[static_cast<int>(mode)];
 }
 
+static constexpr auto s_shader_mode_names = make_array("Specialized", "Uber", "UberUntilSpecializedReady");
+static constexpr auto s_shader_mode_display_names =
+  make_array(TRANSLATABLE("GPUShaderMode", "Specialized"), TRANSLATABLE("GPUShaderMode", "Uber Shader"),
+             TRANSLATABLE("GPUShaderMode", "Uber Shader Until Specialized Ready"));
+
+std::optional<GPUShaderMode> Settings::ParseShaderModeName(const char* str)
+{
+  int index = 0;
+  for (const char* name : s_shader_mode_names)
+  {
+    if (StringUtil::Strcasecmp(name, str) == 0)
+      return static_cast<GPUShaderMode>(index);
+
+    index++;
+  }
+
+  return std::nullopt;
+}
+
+const char* Settings::GetShaderModeName(GPUShaderMode mode)
+{
+  return s_shader_mode_names[static_cast<int>(mode)];
+}
+
+const char* Settings::GetShaderModeDisplayName(GPUShaderMode mode)
+{
+  return s_shader_mode_display_names[static_cast<int>(mode)];
+}
+
 static std::array<const char*, 3> s_display_crop_mode_names = {{"None", "Overscan", "Borders"}};
 static std::array<const char*, 3> s_display_crop_mode_display_names = {
   {TRANSLATABLE("DisplayCropMode", "None"), TRANSLATABLE("DisplayCropMode", "Only Overscan Area"),
@@ -1408,7 +1549,9 @@ bool EmuFolders::EnsureFoldersExist()
   result = FileSystem::EnsureDirectoryExists(Covers.c_str(), false) && result;
   result = FileSystem::EnsureDirectoryExists(Dumps.c_str(), false) && result;
   result = FileSystem::EnsureDirectoryExists(Path::Combine(Dumps, "audio").c_str(), false) && result;
+  result = FileSystem::EnsureDirectoryExists(Path::Combine(Dumps, "gpu").c_str(), false) && result;
   result = FileSystem::EnsureDirectoryExists(Path::Combine(Dumps, "textures").c_str(), false) && result;
+  result = FileSystem::EnsureDirectoryExists(Path::Combine(Dumps, "video").c_str(), false) && result;
   result = FileSystem::EnsureDirectoryExists(GameSettings.c_str(), false) && result;
   result = FileSystem::EnsureDirectoryExists(InputProfiles.c_str(), false) && result;
   result = FileSystem::EnsureDirectoryExists(MemoryCards.c_str(), false) && result;
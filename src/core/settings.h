@@ -64,13 +64,19 @@ struct Settings
   bool cpu_recompiler_memory_exceptions = false;
   bool cpu_recompiler_block_linking = true;
   bool cpu_recompiler_icache = false;
+  bool cpu_recompiler_block_cache = false;
+  bool cpu_recompiler_async_compile = false;
+  u32 cpu_recompiler_tier_threshold = 0;
+  bool cpu_idle_loop_skipping = false;
   CPUFastmemMode cpu_fastmem_mode = DEFAULT_CPU_FASTMEM_MODE;
+  bool cpu_use_large_pages = false;
 
   float emulation_speed = 1.0f;
   float fast_forward_speed = 0.0f;
   float turbo_speed = 0.0f;
   bool sync_to_host_refresh_rate = false;
   bool increase_timer_resolution = true;
+  ThreadAffinityPolicy thread_affinity_policy = DEFAULT_THREAD_AFFINITY_POLICY;
   bool inhibit_screensaver = true;
   bool start_paused = false;
   bool start_fullscreen = false;
@@ -89,14 +95,20 @@ struct Settings
   bool rewind_enable = false;
   float rewind_save_frequency = 10.0f;
   u32 rewind_save_slots = 10;
+  bool rewind_native_vram = false;
   u32 runahead_frames = 0;
+  bool runahead_skip_rendering = false;
 
   GPURenderer gpu_renderer = DEFAULT_GPU_RENDERER;
   std::string gpu_adapter;
   std::string display_post_process_chain;
   u32 gpu_resolution_scale = 1;
+  bool gpu_dynamic_resolution = false;
+  u32 gpu_dynamic_resolution_min_scale = 1;
   u32 gpu_multisamples = 1;
   bool gpu_use_thread = true;
+  u8 gpu_sw_worker_threads = 0;
+  bool gpu_use_render_thread = false;
   bool gpu_use_software_renderer_for_readbacks = false;
   bool gpu_threaded_presentation = true;
   bool gpu_use_debug_device = false;
@@ -104,7 +116,10 @@ struct Settings
   bool gpu_true_color = true;
   bool gpu_scaled_dithering = true;
   GPUTextureFilter gpu_texture_filter = DEFAULT_GPU_TEXTURE_FILTER;
+  bool gpu_adaptive_texture_filtering = false;
   GPUDownsampleMode gpu_downsample_mode = DEFAULT_GPU_DOWNSAMPLE_MODE;
+  bool gpu_downsample_compute = true;
+  GPUShaderMode gpu_shader_mode = DEFAULT_GPU_SHADER_MODE;
   bool gpu_disable_interlacing = true;
   bool gpu_force_ntsc_timings = false;
   bool gpu_widescreen_hack = false;
@@ -131,6 +146,7 @@ struct Settings
   bool display_integer_scaling = false;
   bool display_stretch = false;
   bool display_post_processing = false;
+  bool display_post_process_fusion = true;
   bool display_show_osd_messages = true;
   bool display_show_fps = false;
   bool display_show_speed = false;
@@ -142,9 +158,12 @@ struct Settings
   bool display_show_inputs = false;
   bool display_show_enhancements = false;
   bool display_all_frames = false;
+  bool display_low_latency_pacing = false;
+  bool display_late_input_latch = false;
   bool display_internal_resolution_screenshots = false;
   bool display_stretch_vertically = false;
   bool video_sync_enabled = DEFAULT_VSYNC_VALUE;
+  bool display_triple_buffering = false;
   float display_osd_scale = 100.0f;
   float display_max_fps = DEFAULT_DISPLAY_MAX_FPS;
   float gpu_pgxp_tolerance = -1.0f;
@@ -153,13 +172,17 @@ struct Settings
   u8 cdrom_readahead_sectors = DEFAULT_CDROM_READAHEAD_SECTORS;
   bool cdrom_region_check = false;
   bool cdrom_load_image_to_ram = false;
+  bool cdrom_load_image_to_ram_compressed = false;
   bool cdrom_load_image_patches = false;
+  u8 cdrom_decompression_cache_blocks = DEFAULT_CDROM_DECOMPRESSION_CACHE_BLOCKS;
+  bool cdrom_decompression_prefetch = false;
   bool cdrom_mute_cd_audio = false;
   u32 cdrom_read_speedup = 1;
   u32 cdrom_seek_speedup = 1;
 
   AudioBackend audio_backend = DEFAULT_AUDIO_BACKEND;
   AudioStretchMode audio_stretch_mode = DEFAULT_AUDIO_STRETCH_MODE;
+  bool audio_stretch_thread = false;
   std::string audio_driver;
   std::string audio_output_device;
   u32 audio_output_latency_ms = DEFAULT_AUDIO_OUTPUT_LATENCY_MS;
@@ -170,6 +193,7 @@ struct Settings
   bool audio_dump_on_boot = false;
 
   bool use_old_mdec_routines = false;
+  bool mdec_decode_thread = false;
   bool pcdrv_enable = false;
 
   // timing hacks section
@@ -201,6 +225,10 @@ struct Settings
     bool enable_gdb_server = false;
     u16 gdb_server_port = 1234;
 
+    bool count_io_accesses = false;
+    bool profile_cpu = false;
+    bool dump_frame_time_histograms = false;
+
     // Mutable because the imgui window can close itself.
     mutable bool show_gpu_state = false;
     mutable bool show_cdrom_state = false;
@@ -208,6 +236,10 @@ struct Settings
     mutable bool show_timers_state = false;
     mutable bool show_mdec_state = false;
     mutable bool show_dma_state = false;
+    mutable bool show_io_access_counts = false;
+    mutable bool show_cpu_profile = false;
+    mutable bool show_code_cache_stats = false;
+    mutable bool show_timing_events = false;
   } debugging;
 
   // texture replacements
@@ -215,6 +247,8 @@ struct Settings
   {
     bool enable_vram_write_replacements = false;
     bool preload_textures = false;
+    bool async_loading = false;
+    u32 max_cache_size_mb = 0;
 
     bool dump_vram_writes = false;
     bool dump_vram_write_force_alpha_channel = true;
@@ -231,6 +265,7 @@ struct Settings
 
   bool bios_patch_tty_enable = false;
   bool bios_patch_fast_boot = DEFAULT_FAST_BOOT_VALUE;
+  bool bios_exe_boot_snapshot = false;
   bool enable_8mb_ram = false;
 
   std::array<ControllerType, NUM_CONTROLLER_AND_CARD_PORTS> controller_types{};
@@ -253,6 +288,7 @@ struct Settings
   bool log_to_debug = false;
   bool log_to_window = false;
   bool log_to_file = false;
+  bool log_async_output = false;
 
   ALWAYS_INLINE bool IsUsingCodeCache() const { return (cpu_execution_mode != CPUExecutionMode::Interpreter); }
   ALWAYS_INLINE bool IsUsingRecompiler() const { return (cpu_execution_mode == CPUExecutionMode::Recompiler); }
@@ -357,6 +393,10 @@ struct Settings
   static const char* GetCPUFastmemModeName(CPUFastmemMode mode);
   static const char* GetCPUFastmemModeDisplayName(CPUFastmemMode mode);
 
+  static std::optional<ThreadAffinityPolicy> ParseThreadAffinityPolicy(const char* str);
+  static const char* GetThreadAffinityPolicyName(ThreadAffinityPolicy policy);
+  static const char* GetThreadAffinityPolicyDisplayName(ThreadAffinityPolicy policy);
+
   static std::optional<GPURenderer> ParseRendererName(const char* str);
   static const char* GetRendererName(GPURenderer renderer);
   static const char* GetRendererDisplayName(GPURenderer renderer);
@@ -370,6 +410,10 @@ struct Settings
   static const char* GetDownsampleModeName(GPUDownsampleMode mode);
   static const char* GetDownsampleModeDisplayName(GPUDownsampleMode mode);
 
+  static std::optional<GPUShaderMode> ParseShaderModeName(const char* str);
+  static const char* GetShaderModeName(GPUShaderMode mode);
+  static const char* GetShaderModeDisplayName(GPUShaderMode mode);
+
   static std::optional<DisplayCropMode> ParseDisplayCropMode(const char* str);
   static const char* GetDisplayCropModeName(DisplayCropMode crop_mode);
   static const char* GetDisplayCropModeDisplayName(DisplayCropMode crop_mode);
@@ -411,8 +455,11 @@ struct Settings
 #endif
   static constexpr GPUTextureFilter DEFAULT_GPU_TEXTURE_FILTER = GPUTextureFilter::Nearest;
   static constexpr GPUDownsampleMode DEFAULT_GPU_DOWNSAMPLE_MODE = GPUDownsampleMode::Disabled;
+  static constexpr GPUShaderMode DEFAULT_GPU_SHADER_MODE = GPUShaderMode::Specialized;
   static constexpr ConsoleRegion DEFAULT_CONSOLE_REGION = ConsoleRegion::Auto;
+  static constexpr ThreadAffinityPolicy DEFAULT_THREAD_AFFINITY_POLICY = ThreadAffinityPolicy::Automatic;
   static constexpr float DEFAULT_GPU_PGXP_DEPTH_THRESHOLD = 300.0f;
+  static constexpr u8 GPU_SW_MAX_WORKER_THREADS = 15;
   static constexpr float GPU_PGXP_DEPTH_THRESHOLD_SCALE = 4096.0f;
 
 #ifdef WITH_RECOMPILER
@@ -443,6 +490,7 @@ struct Settings
   static constexpr float DEFAULT_OSD_SCALE = 100.0f;
 
   static constexpr u8 DEFAULT_CDROM_READAHEAD_SECTORS = 8;
+  static constexpr u8 DEFAULT_CDROM_DECOMPRESSION_CACHE_BLOCKS = 16;
 
 #ifndef __ANDROID__
   // Android still defaults to digital controller for now.
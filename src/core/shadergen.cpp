@@ -215,6 +215,9 @@ void ShaderGen::WriteHeader(std::stringstream& ss)
     ss << "#define LOAD_TEXTURE_BUFFER(name, index) texelFetch(name, index)\n";
     ss << "#define BEGIN_ARRAY(type, size) type[size](\n";
     ss << "#define END_ARRAY )\n";
+    ss << "#define STORE_IMAGE(name, coords, value) imageStore(name, coords, value)\n";
+    ss << "#define GROUP_SHARED shared\n";
+    ss << "#define GROUP_MEMORY_BARRIER() barrier()\n";
 
     ss << "float saturate(float value) { return clamp(value, 0.0, 1.0); }\n";
     ss << "float2 saturate(float2 value) { return clamp(value, float2(0.0, 0.0), float2(1.0, 1.0)); }\n";
@@ -261,6 +264,9 @@ void ShaderGen::WriteHeader(std::stringstream& ss)
     ss << "#define LOAD_TEXTURE_BUFFER(name, index) name.Load(index)\n";
     ss << "#define BEGIN_ARRAY(type, size) {\n";
     ss << "#define END_ARRAY }\n";
+    ss << "#define STORE_IMAGE(name, coords, value) name[coords] = value\n";
+    ss << "#define GROUP_SHARED groupshared\n";
+    ss << "#define GROUP_MEMORY_BARRIER() GroupMemoryBarrierWithGroupSync()\n";
   }
 
   ss << "\n";
@@ -335,6 +341,23 @@ void ShaderGen::DeclareTextureBuffer(std::stringstream& ss, const char* name, u3
   }
 }
 
+void ShaderGen::DeclareImage(std::stringstream& ss, const char* name, u32 index)
+{
+  if (m_glsl)
+  {
+    if (IsVulkan())
+      ss << "layout(set = 0, binding = " << (index + 1u) << ", rgba8) ";
+    else
+      ss << "layout(binding = " << index << ", rgba8) ";
+
+    ss << "uniform restrict writeonly image2D " << name << ";\n";
+  }
+  else
+  {
+    ss << "RWTexture2D<float4> " << name << " : register(u" << index << ");\n";
+  }
+}
+
 const char* ShaderGen::GetInterpolationQualifier(bool interface_block, bool centroid_interpolation,
                                                  bool sample_interpolation, bool is_out) const
 {
@@ -589,6 +612,24 @@ void ShaderGen::DeclareFragmentEntryPoint(
   }
 }
 
+void ShaderGen::DeclareComputeEntryPoint(std::stringstream& ss, u32 local_size_x, u32 local_size_y)
+{
+  if (m_glsl)
+  {
+    ss << "layout(local_size_x = " << local_size_x << ", local_size_y = " << local_size_y << ") in;\n\n";
+    ss << "#define c_local_id gl_LocalInvocationID\n";
+    ss << "#define c_global_id gl_GlobalInvocationID\n";
+    ss << "#define c_workgroup_id gl_WorkGroupID\n\n";
+    ss << "void main()\n";
+  }
+  else
+  {
+    ss << "[numthreads(" << local_size_x << ", " << local_size_y << ", 1)]\n";
+    ss << "void main(uint3 c_local_id : SV_GroupThreadID, uint3 c_global_id : SV_DispatchThreadID,\n";
+    ss << "          uint3 c_workgroup_id : SV_GroupID)\n";
+  }
+}
+
 std::string ShaderGen::GenerateScreenQuadVertexShader()
 {
   std::stringstream ss;
@@ -38,6 +38,7 @@ protected:
                             bool push_constant_on_vulkan);
   void DeclareTexture(std::stringstream& ss, const char* name, u32 index, bool multisampled = false);
   void DeclareTextureBuffer(std::stringstream& ss, const char* name, u32 index, bool is_int, bool is_unsigned);
+  void DeclareImage(std::stringstream& ss, const char* name, u32 index);
   void DeclareVertexEntryPoint(std::stringstream& ss, const std::initializer_list<const char*>& attributes,
                                u32 num_color_outputs, u32 num_texcoord_outputs,
                                const std::initializer_list<std::pair<const char*, const char*>>& additional_outputs,
@@ -48,6 +49,7 @@ protected:
                                  bool declare_fragcoord = false, u32 num_color_outputs = 1, bool depth_output = false,
                                  bool msaa = false, bool ssaa = false, bool declare_sample_id = false,
                                  bool noperspective_color = false);
+  void DeclareComputeEntryPoint(std::stringstream& ss, u32 local_size_x, u32 local_size_y);
 
   RenderAPI m_render_api;
   bool m_glsl;
@@ -7,17 +7,30 @@
 #include "common/fifo_queue.h"
 #include "common/log.h"
 #include "common/path.h"
+#include "common/platform.h"
 #include "dma.h"
 #include "host.h"
 #include "imgui.h"
 #include "interrupt_controller.h"
+#include "media_capture.h"
 #include "system.h"
 #include "util/audio_stream.h"
 #include "util/state_wrapper.h"
 #include "util/wav_writer.h"
+#include "xxhash.h"
 #include <memory>
 Log_SetChannel(SPU);
 
+#if defined(CPU_X64)
+#include <emmintrin.h>
+#elif defined(CPU_AARCH64)
+#ifdef _MSC_VER
+#include <arm64_neon.h>
+#else
+#include <arm_neon.h>
+#endif
+#endif
+
 // Enable to dump all voices of the SPU audio individually.
 // #define SPU_DUMP_ALL_VOICES 1
 
@@ -41,6 +54,8 @@ enum : u32
   VOICE_ADDRESS_SHIFT = 3,
   NUM_SAMPLES_PER_ADPCM_BLOCK = 28,
   NUM_SAMPLES_FROM_LAST_ADPCM_BLOCK = 3,
+  NUM_DECODED_ADPCM_BLOCKS = 512,
+  INVALID_DECODED_ADPCM_BLOCK = 0xFFFFFFFFu,
   SYSCLK_TICKS_PER_SPU_TICK = System::MASTER_CLOCK / SAMPLE_RATE, // 0x300
   CAPTURE_BUFFER_SIZE_PER_CHANNEL = 0x400,
   MINIMUM_TICKS_BETWEEN_KEY_ON_OFF = 2,
@@ -175,6 +190,16 @@ union ADPCMFlags
   BitField<u8, bool, 2, 1> loop_start;
 };
 
+/// A block decoded to PCM, cached by its SPU RAM address. The filter history going into the block is part of the key,
+/// since the same block decodes differently depending on what was played before it.
+struct DecodedADPCMBlock
+{
+  u32 address = INVALID_DECODED_ADPCM_BLOCK;
+  std::array<s16, 2> last_samples;
+  ADPCMFlags flags;
+  std::array<s16, NUM_SAMPLES_PER_ADPCM_BLOCK> samples;
+};
+
 struct ADPCMBlock
 {
   union
@@ -255,8 +280,10 @@ struct Voice
   void KeyOff();
   void ForceOff();
 
-  void DecodeBlock(const ADPCMBlock& block);
-  s32 Interpolate() const;
+  void SetBlock(const DecodedADPCMBlock& block);
+
+  // Returns the four samples and Gaussian weights for the current position.
+  void GetInterpolationTaps(s16 samples[4], s16 weights[4]) const;
 
   // Switches to the specified phase, filling in target.
   void UpdateADSREnvelope();
@@ -302,6 +329,50 @@ struct ReverbRegisters
   };
 };
 
+/// Per-voice mixer inputs and outputs for one output frame, in SoA form so all voices can be mixed in parallel.
+/// Interpolation taps are stored in pairs, {0, 1} and {2, 3}, matching a 16-bit multiply-add.
+struct VoiceMixState
+{
+  alignas(16) std::array<s16, NUM_VOICES * 2> samples_01;
+  alignas(16) std::array<s16, NUM_VOICES * 2> weights_01;
+  alignas(16) std::array<s16, NUM_VOICES * 2> samples_23;
+  alignas(16) std::array<s16, NUM_VOICES * 2> weights_23;
+  alignas(16) std::array<s16, NUM_VOICES> adsr_volume;
+  alignas(16) std::array<s16, NUM_VOICES> left_volume;
+  alignas(16) std::array<s16, NUM_VOICES> right_volume;
+
+  // Voice output after ADSR volume, used for pitch modulation and capture.
+  alignas(16) std::array<s32, NUM_VOICES> output;
+};
+
+struct VoiceMixSums
+{
+  s32 left;
+  s32 right;
+  s32 reverb_left;
+  s32 reverb_right;
+};
+
+/// Reverb work area offsets for one channel, in halfwords relative to the current address. Derived from the reverb
+/// registers when they're written, so each sample only has to add the current address and wrap.
+struct ReverbTaps
+{
+  u32 iir_src_a;
+  u32 iir_src_b;
+  u32 iir_dest_a;
+  u32 iir_dest_a_prev;
+  u32 iir_dest_b;
+  u32 iir_dest_b_prev;
+  u32 acc_src_a;
+  u32 acc_src_b;
+  u32 acc_src_c;
+  u32 acc_src_d;
+  u32 mix_dest_a;
+  u32 mix_dest_b;
+  u32 fb_src_a;
+  u32 fb_src_b;
+};
+
 static ADSRPhase GetNextADSRPhase(ADSRPhase phase);
 
 bool IsVoiceReverbEnabled(u32 i);
@@ -321,16 +392,24 @@ static void WriteToCaptureBuffer(u32 index, s16 value);
 static void IncrementCaptureBufferPosition();
 
 static void ReadADPCMBlock(u16 address, ADPCMBlock* block);
-static std::tuple<s32, s32> SampleVoice(u32 voice_index);
+static void DecodeADPCMBlock(const ADPCMBlock& block, DecodedADPCMBlock* decoded);
+static const DecodedADPCMBlock& GetDecodedADPCMBlock(u16 address, const std::array<s16, 2>& last_samples);
+static void InvalidateDecodedADPCMBlocks(u32 ram_address, u32 size);
+static void InvalidateAllDecodedADPCMBlocks();
+static bool PrepareVoiceMix(u32 voice_index);
+static VoiceMixSums MixVoices(u32 reverb_on_register);
+static void AdvanceVoice(u32 voice_index);
 
 static void UpdateNoise();
 
-static u32 ReverbMemoryAddress(u32 address);
-static s16 ReverbRead(u32 address, s32 offset = 0);
-static void ReverbWrite(u32 address, s16 data);
+static void UpdateReverbTaps();
+static u32 ReverbMemoryAddress(u32 offset);
+static s16 ReverbRead(u32 offset);
+static void ReverbWrite(u32 offset, s16 data);
 static void ProcessReverb(s16 left_in, s16 right_in, s32* left_out, s32* right_out);
 
 static void Execute(void* param, TickCount ticks, TickCount ticks_late);
+static u32 GetFramesUntilRAMIRQ();
 static void UpdateEventInterval();
 
 static void ExecuteFIFOWriteToRAM(TickCount& ticks);
@@ -345,6 +424,7 @@ static void CreateOutputStream();
 static std::unique_ptr<TimingEvent> s_tick_event;
 static std::unique_ptr<TimingEvent> s_transfer_event;
 static std::unique_ptr<Common::WAVWriter> s_dump_writer;
+static XXH64_state_t* s_output_hash_state = nullptr;
 static std::unique_ptr<AudioStream> s_audio_stream;
 static std::unique_ptr<AudioStream> s_null_audio_stream;
 static bool s_audio_output_muted = false;
@@ -387,16 +467,21 @@ static u32 s_reverb_on_register = 0;
 static u32 s_reverb_base_address = 0;
 static u32 s_reverb_current_address = 0;
 static ReverbRegisters s_reverb_registers{};
+static std::array<ReverbTaps, 2> s_reverb_taps{};
 static std::array<std::array<s16, 128>, 2> s_reverb_downsample_buffer;
 static std::array<std::array<s16, 64>, 2> s_reverb_upsample_buffer;
 static s32 s_reverb_resample_buffer_position = 0;
 
 static std::array<Voice, NUM_VOICES> s_voices{};
+static VoiceMixState s_voice_mix;
 
 static InlineFIFOQueue<u16, FIFO_SIZE_IN_HALFWORDS> s_transfer_fifo;
 
 static std::array<u8, RAM_SIZE> s_ram{};
 
+// Direct-mapped, by address in 8-byte units. Looping samples hit here instead of decoding the same blocks again.
+static std::array<DecodedADPCMBlock, NUM_DECODED_ADPCM_BLOCKS> s_decoded_adpcm_blocks;
+
 #ifdef SPU_DUMP_ALL_VOICES
 // +1 for reverb output
 static std::array<std::unique_ptr<Common::WAVWriter>, NUM_VOICES + 1> s_voice_dump_writers;
@@ -435,6 +520,7 @@ void SPU::CreateOutputStream()
     s_audio_stream = AudioStream::CreateNullStream(SAMPLE_RATE, NUM_CHANNELS, g_settings.audio_buffer_ms);
   }
 
+  s_audio_stream->SetStretchThreaded(g_settings.audio_stretch_thread);
   s_audio_stream->SetOutputVolume(System::GetAudioOutputVolume());
   s_audio_stream->SetPaused(System::IsPaused());
 }
@@ -457,6 +543,7 @@ void SPU::CPUClockChanged()
 void SPU::Shutdown()
 {
   StopDumpingAudio();
+  SetOutputHashingEnabled(false);
   s_tick_event.reset();
   s_transfer_event.reset();
   s_audio_stream.reset();
@@ -493,6 +580,7 @@ void SPU::Reset()
   s_reverb_registers = {};
   s_reverb_registers.mBASE = 0;
   s_reverb_base_address = s_reverb_current_address = ZeroExtend32(s_reverb_registers.mBASE) << 2;
+  UpdateReverbTaps();
   s_reverb_downsample_buffer = {};
   s_reverb_upsample_buffer = {};
   s_reverb_resample_buffer_position = 0;
@@ -517,6 +605,7 @@ void SPU::Reset()
   s_transfer_fifo.Clear();
   s_transfer_event->Deactivate();
   s_ram.fill(0);
+  InvalidateAllDecodedADPCMBlocks();
   UpdateEventInterval();
 }
 
@@ -583,6 +672,8 @@ bool SPU::DoState(StateWrapper& sw)
 
   if (sw.IsReading())
   {
+    InvalidateAllDecodedADPCMBlocks();
+    UpdateReverbTaps();
     UpdateEventInterval();
     UpdateTransferEvent();
   }
@@ -757,6 +848,7 @@ void SPU::WriteRegister(u32 offset, u16 value)
       Log_DebugPrintf("SPU key on low <- 0x%04X", ZeroExtend32(value));
       GeneratePendingSamples();
       s_key_on_register = (s_key_on_register & 0xFFFF0000) | ZeroExtend32(value);
+      UpdateEventInterval();
     }
     break;
 
@@ -765,6 +857,7 @@ void SPU::WriteRegister(u32 offset, u16 value)
       Log_DebugPrintf("SPU key on high <- 0x%04X", ZeroExtend32(value));
       GeneratePendingSamples();
       s_key_on_register = (s_key_on_register & 0x0000FFFF) | (ZeroExtend32(value) << 16);
+      UpdateEventInterval();
     }
     break;
 
@@ -852,6 +945,7 @@ void SPU::WriteRegister(u32 offset, u16 value)
       if (IsRAMIRQTriggerable())
         CheckForLateRAMIRQs();
 
+      UpdateEventInterval();
       return;
     }
 
@@ -989,6 +1083,7 @@ void SPU::WriteRegister(u32 offset, u16 value)
         Log_DebugPrintf("SPU reverb register %u <- 0x%04X", reg, value);
         GeneratePendingSamples();
         s_reverb_registers.rev[reg] = value;
+        UpdateReverbTaps();
         return;
       }
 
@@ -1181,6 +1276,7 @@ void SPU::WriteToCaptureBuffer(u32 index, s16 value)
   const u32 ram_address = (index * CAPTURE_BUFFER_SIZE_PER_CHANNEL) | ZeroExtend16(s_capture_buffer_position);
   // Log_DebugPrintf("write to capture buffer %u (0x%08X) <- 0x%04X", index, ram_address, u16(value));
   std::memcpy(&s_ram[ram_address], &value, sizeof(value));
+  InvalidateDecodedADPCMBlocks(ram_address, sizeof(value));
   if (IsRAMIRQTriggerable() && CheckRAMIRQ(ram_address))
   {
     Log_DebugPrintf("Trigger IRQ @ %08X %04X from capture buffer", ram_address, ram_address / 8);
@@ -1215,10 +1311,31 @@ ALWAYS_INLINE_RELEASE void SPU::ExecuteFIFOReadFromRAM(TickCount& ticks)
 
 ALWAYS_INLINE_RELEASE void SPU::ExecuteFIFOWriteToRAM(TickCount& ticks)
 {
+  // Without an IRQ to check after each halfword, write everything the ticks allow for as a block.
+  if (ticks > 0 && !IsRAMIRQTriggerable())
+  {
+    u32 count = std::min(s_transfer_fifo.GetSize(),
+                         static_cast<u32>((ticks - 1) / static_cast<TickCount>(TRANSFER_TICKS_PER_HALFWORD)) + 1);
+    ticks -= static_cast<TickCount>(count * TRANSFER_TICKS_PER_HALFWORD);
+    while (count > 0)
+    {
+      const u32 chunk = std::min({count, s_transfer_fifo.GetContiguousSize(),
+                                  static_cast<u32>((RAM_SIZE - s_transfer_address) / sizeof(u16))});
+      std::memcpy(&s_ram[s_transfer_address], s_transfer_fifo.GetReadPointer(), chunk * sizeof(u16));
+      InvalidateDecodedADPCMBlocks(s_transfer_address, chunk * sizeof(u16));
+      s_transfer_fifo.Remove(chunk);
+      s_transfer_address = (s_transfer_address + (chunk * sizeof(u16))) & RAM_MASK;
+      count -= chunk;
+    }
+
+    return;
+  }
+
   while (ticks > 0 && !s_transfer_fifo.IsEmpty())
   {
     u16 value = s_transfer_fifo.Pop();
     std::memcpy(&s_ram[s_transfer_address], &value, sizeof(u16));
+    InvalidateDecodedADPCMBlocks(s_transfer_address, sizeof(u16));
     s_transfer_address = (s_transfer_address + sizeof(u16)) & RAM_MASK;
     ticks -= TRANSFER_TICKS_PER_HALFWORD;
 
@@ -1294,6 +1411,7 @@ void SPU::ManualTransferWrite(u16 value)
   }
 
   std::memcpy(&s_ram[s_transfer_address], &value, sizeof(u16));
+  InvalidateDecodedADPCMBlocks(s_transfer_address, sizeof(u16));
   s_transfer_address = (s_transfer_address + sizeof(u16)) & RAM_MASK;
 
   if (IsRAMIRQTriggerable() && CheckRAMIRQ(s_transfer_address))
@@ -1505,6 +1623,33 @@ bool SPU::StartDumpingAudio(const char* filename)
   return true;
 }
 
+void SPU::SetOutputHashingEnabled(bool enabled)
+{
+  if (enabled == (s_output_hash_state != nullptr))
+    return;
+
+  if (enabled)
+  {
+    s_output_hash_state = XXH64_createState();
+    XXH64_reset(s_output_hash_state, 0);
+  }
+  else
+  {
+    XXH64_freeState(s_output_hash_state);
+    s_output_hash_state = nullptr;
+  }
+}
+
+u64 SPU::GetAndResetOutputHash()
+{
+  if (!s_output_hash_state)
+    return 0;
+
+  const u64 hash = XXH64_digest(s_output_hash_state);
+  XXH64_reset(s_output_hash_state, 0);
+  return hash;
+}
+
 bool SPU::StopDumpingAudio()
 {
   if (!s_dump_writer)
@@ -1527,6 +1672,8 @@ const std::array<u8, SPU::RAM_SIZE>& SPU::GetRAM()
 
 std::array<u8, SPU::RAM_SIZE>& SPU::GetWritableRAM()
 {
+  // Caller can write anywhere.
+  InvalidateAllDecodedADPCMBlocks();
   return s_ram;
 }
 
@@ -1773,40 +1920,20 @@ void SPU::Voice::TickADSR()
   }
 }
 
-void SPU::Voice::DecodeBlock(const ADPCMBlock& block)
+void SPU::Voice::SetBlock(const DecodedADPCMBlock& block)
 {
-  static constexpr std::array<s32, 5> filter_table_pos = {{0, 60, 115, 98, 122}};
-  static constexpr std::array<s32, 5> filter_table_neg = {{0, 0, -52, -55, -60}};
-
   // store samples needed for interpolation
   current_block_samples[2] = current_block_samples[NUM_SAMPLES_FROM_LAST_ADPCM_BLOCK + NUM_SAMPLES_PER_ADPCM_BLOCK - 1];
   current_block_samples[1] = current_block_samples[NUM_SAMPLES_FROM_LAST_ADPCM_BLOCK + NUM_SAMPLES_PER_ADPCM_BLOCK - 2];
   current_block_samples[0] = current_block_samples[NUM_SAMPLES_FROM_LAST_ADPCM_BLOCK + NUM_SAMPLES_PER_ADPCM_BLOCK - 3];
 
-  // pre-lookup
-  const u8 shift = block.GetShift();
-  const u8 filter_index = block.GetFilter();
-  const s32 filter_pos = filter_table_pos[filter_index];
-  const s32 filter_neg = filter_table_neg[filter_index];
-  s16 last_samples[2] = {adpcm_last_samples[0], adpcm_last_samples[1]};
-
-  // samples
-  for (u32 i = 0; i < NUM_SAMPLES_PER_ADPCM_BLOCK; i++)
-  {
-    // extend 4-bit to 16-bit, apply shift from header and mix in previous samples
-    s32 sample = s32(static_cast<s16>(ZeroExtend16(block.GetNibble(i)) << 12) >> shift);
-    sample += (last_samples[0] * filter_pos) >> 6;
-    sample += (last_samples[1] * filter_neg) >> 6;
-
-    last_samples[1] = last_samples[0];
-    current_block_samples[NUM_SAMPLES_FROM_LAST_ADPCM_BLOCK + i] = last_samples[0] = static_cast<s16>(Clamp16(sample));
-  }
-
-  std::copy(last_samples, last_samples + countof(last_samples), adpcm_last_samples.begin());
+  std::copy(block.samples.begin(), block.samples.end(), &current_block_samples[NUM_SAMPLES_FROM_LAST_ADPCM_BLOCK]);
+  adpcm_last_samples[0] = block.samples[NUM_SAMPLES_PER_ADPCM_BLOCK - 1];
+  adpcm_last_samples[1] = block.samples[NUM_SAMPLES_PER_ADPCM_BLOCK - 2];
   current_block_flags.bits = block.flags.bits;
 }
 
-s32 SPU::Voice::Interpolate() const
+void SPU::Voice::GetInterpolationTaps(s16 samples[4], s16 weights[4]) const
 {
   static constexpr std::array<s16, 0x200> gauss = {{
     -0x001, -0x001, -0x001, -0x001, -0x001, -0x001, -0x001, -0x001, //
@@ -1878,21 +2005,19 @@ s32 SPU::Voice::Interpolate() const
   const u8 i = counter.interpolation_index;
   const u32 s = NUM_SAMPLES_FROM_LAST_ADPCM_BLOCK + ZeroExtend32(counter.sample_index.GetValue());
 
-  s32 out = s32(gauss[0x0FF - i]) * s32(current_block_samples[s - 3]);
-  out += s32(gauss[0x1FF - i]) * s32(current_block_samples[s - 2]);
-  out += s32(gauss[0x100 + i]) * s32(current_block_samples[s - 1]);
-  out += s32(gauss[0x000 + i]) * s32(current_block_samples[s - 0]);
-  return out >> 15;
+  samples[0] = current_block_samples[s - 3];
+  samples[1] = current_block_samples[s - 2];
+  samples[2] = current_block_samples[s - 1];
+  samples[3] = current_block_samples[s - 0];
+  weights[0] = gauss[0x0FF - i];
+  weights[1] = gauss[0x1FF - i];
+  weights[2] = gauss[0x100 + i];
+  weights[3] = gauss[0x000 + i];
 }
 
 void SPU::ReadADPCMBlock(u16 address, ADPCMBlock* block)
 {
   u32 ram_address = (ZeroExtend32(address) * 8) & RAM_MASK;
-  if (IsRAMIRQTriggerable() && (CheckRAMIRQ(ram_address) || CheckRAMIRQ((ram_address + 8) & RAM_MASK)))
-  {
-    Log_DebugPrintf("Trigger IRQ @ %08X %04X from ADPCM reader", ram_address, ram_address / 8);
-    TriggerRAMIRQ();
-  }
 
   // fast path - no wrap-around
   if ((ram_address + sizeof(ADPCMBlock)) <= RAM_SIZE)
@@ -1912,29 +2037,94 @@ void SPU::ReadADPCMBlock(u16 address, ADPCMBlock* block)
   }
 }
 
-ALWAYS_INLINE_RELEASE std::tuple<s32, s32> SPU::SampleVoice(u32 voice_index)
+void SPU::DecodeADPCMBlock(const ADPCMBlock& block, DecodedADPCMBlock* decoded)
 {
-  Voice& voice = s_voices[voice_index];
-  if (!voice.IsOn() && !s_SPUCNT.irq9_enable)
+  static constexpr std::array<s32, 5> filter_table_pos = {{0, 60, 115, 98, 122}};
+  static constexpr std::array<s32, 5> filter_table_neg = {{0, 0, -52, -55, -60}};
+
+  // pre-lookup
+  const u8 shift = block.GetShift();
+  const u8 filter_index = block.GetFilter();
+  const s32 filter_pos = filter_table_pos[filter_index];
+  const s32 filter_neg = filter_table_neg[filter_index];
+  s16 last_samples[2] = {decoded->last_samples[0], decoded->last_samples[1]};
+
+  // samples
+  for (u32 i = 0; i < NUM_SAMPLES_PER_ADPCM_BLOCK; i++)
   {
-    voice.last_volume = 0;
+    // extend 4-bit to 16-bit, apply shift from header and mix in previous samples
+    s32 sample = s32(static_cast<s16>(ZeroExtend16(block.GetNibble(i)) << 12) >> shift);
+    sample += (last_samples[0] * filter_pos) >> 6;
+    sample += (last_samples[1] * filter_neg) >> 6;
 
-#ifdef SPU_DUMP_ALL_VOICES
-    if (s_voice_dump_writers[voice_index])
-    {
-      const s16 dump_samples[2] = {0, 0};
-      s_voice_dump_writers[voice_index]->WriteFrames(dump_samples, 1);
-    }
-#endif
+    last_samples[1] = last_samples[0];
+    decoded->samples[i] = last_samples[0] = static_cast<s16>(Clamp16(sample));
+  }
+
+  decoded->flags.bits = block.flags.bits;
+}
 
-    return {};
+const SPU::DecodedADPCMBlock& SPU::GetDecodedADPCMBlock(u16 address, const std::array<s16, 2>& last_samples)
+{
+  // The IRQ has to fire whether or not the block comes from the cache.
+  const u32 ram_address = (ZeroExtend32(address) * 8) & RAM_MASK;
+  if (IsRAMIRQTriggerable() && (CheckRAMIRQ(ram_address) || CheckRAMIRQ((ram_address + 8) & RAM_MASK)))
+  {
+    Log_DebugPrintf("Trigger IRQ @ %08X %04X from ADPCM reader", ram_address, ram_address / 8);
+    TriggerRAMIRQ();
+  }
+
+  DecodedADPCMBlock& decoded = s_decoded_adpcm_blocks[(address >> 1) % NUM_DECODED_ADPCM_BLOCKS];
+  if (decoded.address == address && decoded.last_samples == last_samples)
+    return decoded;
+
+  ADPCMBlock block;
+  ReadADPCMBlock(address, &block);
+  decoded.address = address;
+  decoded.last_samples = last_samples;
+  DecodeADPCMBlock(block, &decoded);
+  return decoded;
+}
+
+void SPU::InvalidateDecodedADPCMBlocks(u32 ram_address, u32 size)
+{
+  // Blocks are 16 bytes but can start on any 8-byte boundary, so the unit before the write can be affected too.
+  const u32 first = (ram_address / 8) - 1;
+  const u32 last = (ram_address + size - 1) / 8;
+  for (u32 unit = first; unit != (last + 1); unit++)
+  {
+    const u16 address = Truncate16(unit);
+    DecodedADPCMBlock& decoded = s_decoded_adpcm_blocks[(address >> 1) % NUM_DECODED_ADPCM_BLOCKS];
+    if (decoded.address == address)
+      decoded.address = INVALID_DECODED_ADPCM_BLOCK;
+  }
+}
+
+void SPU::InvalidateAllDecodedADPCMBlocks()
+{
+  for (DecodedADPCMBlock& decoded : s_decoded_adpcm_blocks)
+    decoded.address = INVALID_DECODED_ADPCM_BLOCK;
+}
+
+ALWAYS_INLINE_RELEASE bool SPU::PrepareVoiceMix(u32 voice_index)
+{
+  Voice& voice = s_voices[voice_index];
+  s16* samples_01 = &s_voice_mix.samples_01[voice_index * 2];
+  s16* weights_01 = &s_voice_mix.weights_01[voice_index * 2];
+  s16* samples_23 = &s_voice_mix.samples_23[voice_index * 2];
+  s16* weights_23 = &s_voice_mix.weights_23[voice_index * 2];
+  if (!voice.IsOn() && !s_SPUCNT.irq9_enable)
+  {
+    // zero volume makes the voice's contribution zero, regardless of the taps
+    s_voice_mix.adsr_volume[voice_index] = 0;
+    s_voice_mix.left_volume[voice_index] = 0;
+    s_voice_mix.right_volume[voice_index] = 0;
+    return false;
   }
 
   if (!voice.has_samples)
   {
-    ADPCMBlock block;
-    ReadADPCMBlock(voice.current_address, &block);
-    voice.DecodeBlock(block);
+    voice.SetBlock(GetDecodedADPCMBlock(voice.current_address, voice.adpcm_last_samples));
     voice.has_samples = true;
 
     if (voice.current_block_flags.loop_start && !voice.ignore_loop_address)
@@ -1944,25 +2134,183 @@ ALWAYS_INLINE_RELEASE std::tuple<s32, s32> SPU::SampleVoice(u32 voice_index)
     }
   }
 
-  // skip interpolation when the volume is muted anyway
-  s32 volume;
-  if (voice.regs.adsr_volume != 0)
+  if (IsVoiceNoiseEnabled(voice_index))
   {
-    // interpolate/sample and apply ADSR volume
-    s32 sample;
-    if (IsVoiceNoiseEnabled(voice_index))
-      sample = GetVoiceNoiseLevel();
-    else
-      sample = voice.Interpolate();
-
-    volume = ApplyVolume(sample, voice.regs.adsr_volume);
+    // noise * 0x4000 * 2 >> 15 passes the noise level through unchanged
+    const s16 noise = GetVoiceNoiseLevel();
+    samples_01[0] = noise;
+    samples_01[1] = noise;
+    weights_01[0] = 0x4000;
+    weights_01[1] = 0x4000;
+    samples_23[0] = 0;
+    samples_23[1] = 0;
+    weights_23[0] = 0;
+    weights_23[1] = 0;
   }
   else
   {
-    volume = 0;
+    s16 samples[4], weights[4];
+    voice.GetInterpolationTaps(samples, weights);
+    samples_01[0] = samples[0];
+    samples_01[1] = samples[1];
+    weights_01[0] = weights[0];
+    weights_01[1] = weights[1];
+    samples_23[0] = samples[2];
+    samples_23[1] = samples[3];
+    weights_23[0] = weights[2];
+    weights_23[1] = weights[3];
+  }
+
+  s_voice_mix.adsr_volume[voice_index] = voice.regs.adsr_volume;
+  s_voice_mix.left_volume[voice_index] = voice.left_volume.current_level;
+  s_voice_mix.right_volume[voice_index] = voice.right_volume.current_level;
+  return true;
+}
+
+ALWAYS_INLINE_RELEASE SPU::VoiceMixSums SPU::MixVoices(u32 reverb_on_register)
+{
+  // Every multiply here is 16x16->32. The interpolated sample always fits in 16 bits given the Gaussian table, but the
+  // voice output can reach 0x8000 when a noise level of -0x8000 meets an ADSR volume of -0x8000. That case is handled
+  // by saturating to 0x7FFF and adding the channel volume once more, since 0x8000 * v == 0x7FFF * v + v.
+#if defined(CPU_X64)
+  __m128i left_sum = _mm_setzero_si128();
+  __m128i right_sum = _mm_setzero_si128();
+  __m128i reverb_left_sum = _mm_setzero_si128();
+  __m128i reverb_right_sum = _mm_setzero_si128();
+  const __m128i reverb_bits = _mm_set_epi32(8, 4, 2, 1);
+  const __m128i max_s16 = _mm_set1_epi32(0x7FFF);
+
+  for (u32 i = 0; i < NUM_VOICES; i += 4)
+  {
+    const __m128i interp_01 =
+      _mm_madd_epi16(_mm_load_si128(reinterpret_cast<const __m128i*>(&s_voice_mix.samples_01[i * 2])),
+                     _mm_load_si128(reinterpret_cast<const __m128i*>(&s_voice_mix.weights_01[i * 2])));
+    const __m128i interp_23 =
+      _mm_madd_epi16(_mm_load_si128(reinterpret_cast<const __m128i*>(&s_voice_mix.samples_23[i * 2])),
+                     _mm_load_si128(reinterpret_cast<const __m128i*>(&s_voice_mix.weights_23[i * 2])));
+    const __m128i interp = _mm_srai_epi32(_mm_add_epi32(interp_01, interp_23), 15);
+    const __m128i interp16 = _mm_packs_epi32(interp, interp);
+
+    const __m128i adsr_volume = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(&s_voice_mix.adsr_volume[i]));
+    const __m128i volume = _mm_srai_epi32(
+      _mm_unpacklo_epi16(_mm_mullo_epi16(interp16, adsr_volume), _mm_mulhi_epi16(interp16, adsr_volume)), 15);
+    _mm_store_si128(reinterpret_cast<__m128i*>(&s_voice_mix.output[i]), volume);
+
+    const __m128i volume16 = _mm_packs_epi32(volume, volume);
+    const __m128i volume_carry = _mm_cmpgt_epi32(volume, max_s16);
+
+    const __m128i left_volume = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(&s_voice_mix.left_volume[i]));
+    const __m128i right_volume = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(&s_voice_mix.right_volume[i]));
+    const __m128i left = _mm_srai_epi32(
+      _mm_add_epi32(
+        _mm_unpacklo_epi16(_mm_mullo_epi16(volume16, left_volume), _mm_mulhi_epi16(volume16, left_volume)),
+        _mm_and_si128(volume_carry, _mm_srai_epi32(_mm_unpacklo_epi16(left_volume, left_volume), 16))),
+      15);
+    const __m128i right = _mm_srai_epi32(
+      _mm_add_epi32(
+        _mm_unpacklo_epi16(_mm_mullo_epi16(volume16, right_volume), _mm_mulhi_epi16(volume16, right_volume)),
+        _mm_and_si128(volume_carry, _mm_srai_epi32(_mm_unpacklo_epi16(right_volume, right_volume), 16))),
+      15);
+
+    const __m128i reverb_mask =
+      _mm_cmpeq_epi32(_mm_and_si128(_mm_set1_epi32(static_cast<s32>(reverb_on_register >> i)), reverb_bits),
+                      reverb_bits);
+    left_sum = _mm_add_epi32(left_sum, left);
+    right_sum = _mm_add_epi32(right_sum, right);
+    reverb_left_sum = _mm_add_epi32(reverb_left_sum, _mm_and_si128(left, reverb_mask));
+    reverb_right_sum = _mm_add_epi32(reverb_right_sum, _mm_and_si128(right, reverb_mask));
+  }
+
+  const auto hsum = [](__m128i v) {
+    v = _mm_add_epi32(v, _mm_shuffle_epi32(v, _MM_SHUFFLE(1, 0, 3, 2)));
+    v = _mm_add_epi32(v, _mm_shuffle_epi32(v, _MM_SHUFFLE(2, 3, 0, 1)));
+    return _mm_cvtsi128_si32(v);
+  };
+
+  return VoiceMixSums{hsum(left_sum), hsum(right_sum), hsum(reverb_left_sum), hsum(reverb_right_sum)};
+#elif defined(CPU_AARCH64)
+  int32x4_t left_sum = vdupq_n_s32(0);
+  int32x4_t right_sum = vdupq_n_s32(0);
+  int32x4_t reverb_left_sum = vdupq_n_s32(0);
+  int32x4_t reverb_right_sum = vdupq_n_s32(0);
+  static constexpr u32 reverb_bits_values[4] = {1, 2, 4, 8};
+  const uint32x4_t reverb_bits = vld1q_u32(reverb_bits_values);
+  const int32x4_t max_s16 = vdupq_n_s32(0x7FFF);
+
+  for (u32 i = 0; i < NUM_VOICES; i += 4)
+  {
+    const int16x8_t samples_01 = vld1q_s16(&s_voice_mix.samples_01[i * 2]);
+    const int16x8_t weights_01 = vld1q_s16(&s_voice_mix.weights_01[i * 2]);
+    const int16x8_t samples_23 = vld1q_s16(&s_voice_mix.samples_23[i * 2]);
+    const int16x8_t weights_23 = vld1q_s16(&s_voice_mix.weights_23[i * 2]);
+    const int32x4_t interp_01 = vpaddq_s32(vmull_s16(vget_low_s16(samples_01), vget_low_s16(weights_01)),
+                                           vmull_high_s16(samples_01, weights_01));
+    const int32x4_t interp_23 = vpaddq_s32(vmull_s16(vget_low_s16(samples_23), vget_low_s16(weights_23)),
+                                           vmull_high_s16(samples_23, weights_23));
+    const int16x4_t interp16 = vmovn_s32(vshrq_n_s32(vaddq_s32(interp_01, interp_23), 15));
+
+    const int32x4_t volume = vshrq_n_s32(vmull_s16(interp16, vld1_s16(&s_voice_mix.adsr_volume[i])), 15);
+    vst1q_s32(&s_voice_mix.output[i], volume);
+
+    const int16x4_t volume16 = vqmovn_s32(volume);
+    const int32x4_t volume_carry = vreinterpretq_s32_u32(vcgtq_s32(volume, max_s16));
+
+    const int16x4_t left_volume = vld1_s16(&s_voice_mix.left_volume[i]);
+    const int16x4_t right_volume = vld1_s16(&s_voice_mix.right_volume[i]);
+    const int32x4_t left = vshrq_n_s32(
+      vaddq_s32(vmull_s16(volume16, left_volume), vandq_s32(volume_carry, vmovl_s16(left_volume))), 15);
+    const int32x4_t right = vshrq_n_s32(
+      vaddq_s32(vmull_s16(volume16, right_volume), vandq_s32(volume_carry, vmovl_s16(right_volume))), 15);
+
+    const int32x4_t reverb_mask = vreinterpretq_s32_u32(vtstq_u32(vdupq_n_u32(reverb_on_register >> i), reverb_bits));
+    left_sum = vaddq_s32(left_sum, left);
+    right_sum = vaddq_s32(right_sum, right);
+    reverb_left_sum = vaddq_s32(reverb_left_sum, vandq_s32(left, reverb_mask));
+    reverb_right_sum = vaddq_s32(reverb_right_sum, vandq_s32(right, reverb_mask));
   }
 
-  voice.last_volume = volume;
+  return VoiceMixSums{vaddvq_s32(left_sum), vaddvq_s32(right_sum), vaddvq_s32(reverb_left_sum),
+                      vaddvq_s32(reverb_right_sum)};
+#else
+  VoiceMixSums sums = {};
+  for (u32 i = 0; i < NUM_VOICES; i++)
+  {
+    const s32 interp = (s32(s_voice_mix.samples_01[i * 2 + 0]) * s32(s_voice_mix.weights_01[i * 2 + 0]) +
+                        s32(s_voice_mix.samples_01[i * 2 + 1]) * s32(s_voice_mix.weights_01[i * 2 + 1]) +
+                        s32(s_voice_mix.samples_23[i * 2 + 0]) * s32(s_voice_mix.weights_23[i * 2 + 0]) +
+                        s32(s_voice_mix.samples_23[i * 2 + 1]) * s32(s_voice_mix.weights_23[i * 2 + 1])) >>
+                       15;
+    const s32 volume = ApplyVolume(interp, s_voice_mix.adsr_volume[i]);
+    s_voice_mix.output[i] = volume;
+
+    const s32 left = ApplyVolume(volume, s_voice_mix.left_volume[i]);
+    const s32 right = ApplyVolume(volume, s_voice_mix.right_volume[i]);
+    sums.left += left;
+    sums.right += right;
+    if ((reverb_on_register >> i) & 1u)
+    {
+      sums.reverb_left += left;
+      sums.reverb_right += right;
+    }
+  }
+
+  return sums;
+#endif
+}
+
+ALWAYS_INLINE_RELEASE void SPU::AdvanceVoice(u32 voice_index)
+{
+  Voice& voice = s_voices[voice_index];
+
+#ifdef SPU_DUMP_ALL_VOICES
+  if (s_voice_dump_writers[voice_index])
+  {
+    const s16 dump_samples[2] = {
+      static_cast<s16>(Clamp16(ApplyVolume(voice.last_volume, voice.left_volume.current_level))),
+      static_cast<s16>(Clamp16(ApplyVolume(voice.last_volume, voice.right_volume.current_level)))};
+    s_voice_dump_writers[voice_index]->WriteFrames(dump_samples, 1);
+  }
+#endif
 
   if (voice.adsr_phase != ADSRPhase::Off)
     voice.TickADSR();
@@ -2008,21 +2356,9 @@ ALWAYS_INLINE_RELEASE std::tuple<s32, s32> SPU::SampleVoice(u32 voice_index)
     }
   }
 
-  // apply per-channel volume
-  const s32 left = ApplyVolume(volume, voice.left_volume.current_level);
-  const s32 right = ApplyVolume(volume, voice.right_volume.current_level);
+  // step per-channel volume sweeps
   voice.left_volume.Tick();
   voice.right_volume.Tick();
-
-#ifdef SPU_DUMP_ALL_VOICES
-  if (s_voice_dump_writers[voice_index])
-  {
-    const s16 dump_samples[2] = {static_cast<s16>(Clamp16(left)), static_cast<s16>(Clamp16(right))};
-    s_voice_dump_writers[voice_index]->WriteFrames(dump_samples, 1);
-  }
-#endif
-
-  return std::make_tuple(left, right);
 }
 
 void SPU::UpdateNoise()
@@ -2054,32 +2390,59 @@ void SPU::UpdateNoise()
 /* Reverb algorithm from Mednafen-PSX                                   */
 /************************************************************************/
 
-u32 SPU::ReverbMemoryAddress(u32 address)
+void SPU::UpdateReverbTaps()
+{
+  static constexpr u32 MASK = (RAM_SIZE - 1) / 2;
+  const auto tap = [](u32 address, s32 offset = 0) { return ((address << 2) + offset) & MASK; };
+
+  const ReverbRegisters& regs = s_reverb_registers;
+  for (u32 lr = 0; lr < 2; lr++)
+  {
+    ReverbTaps& taps = s_reverb_taps[lr];
+    taps.iir_src_a = tap(regs.IIR_SRC_A[lr ^ 0]);
+    taps.iir_src_b = tap(regs.IIR_SRC_B[lr ^ 1]);
+    taps.iir_dest_a = tap(regs.IIR_DEST_A[lr]);
+    taps.iir_dest_a_prev = tap(regs.IIR_DEST_A[lr], -1);
+    taps.iir_dest_b = tap(regs.IIR_DEST_B[lr]);
+    taps.iir_dest_b_prev = tap(regs.IIR_DEST_B[lr], -1);
+    taps.acc_src_a = tap(regs.ACC_SRC_A[lr]);
+    taps.acc_src_b = tap(regs.ACC_SRC_B[lr]);
+    taps.acc_src_c = tap(regs.ACC_SRC_C[lr]);
+    taps.acc_src_d = tap(regs.ACC_SRC_D[lr]);
+    taps.mix_dest_a = tap(regs.MIX_DEST_A[lr]);
+    taps.mix_dest_b = tap(regs.MIX_DEST_B[lr]);
+    taps.fb_src_a = tap(static_cast<u32>(regs.MIX_DEST_A[lr] - regs.FB_SRC_A));
+    taps.fb_src_b = tap(static_cast<u32>(regs.MIX_DEST_B[lr] - regs.FB_SRC_B));
+  }
+}
+
+u32 SPU::ReverbMemoryAddress(u32 offset)
 {
   // Ensures address does not leave the reverb work area.
   static constexpr u32 MASK = (RAM_SIZE - 1) / 2;
-  u32 offset = s_reverb_current_address + (address & MASK);
+  offset += s_reverb_current_address;
   offset += s_reverb_base_address & ((s32)(offset << 13) >> 31);
 
   // We address RAM in bytes. TODO: Change this to words.
   return (offset & MASK) * 2u;
 }
 
-s16 SPU::ReverbRead(u32 address, s32 offset)
+s16 SPU::ReverbRead(u32 offset)
 {
   // TODO: This should check interrupts.
-  const u32 real_address = ReverbMemoryAddress((address << 2) + offset);
+  const u32 real_address = ReverbMemoryAddress(offset);
 
   s16 data;
   std::memcpy(&data, &s_ram[real_address], sizeof(data));
   return data;
 }
 
-void SPU::ReverbWrite(u32 address, s16 data)
+void SPU::ReverbWrite(u32 offset, s16 data)
 {
   // TODO: This should check interrupts.
-  const u32 real_address = ReverbMemoryAddress(address << 2);
+  const u32 real_address = ReverbMemoryAddress(offset);
   std::memcpy(&s_ram[real_address], &data, sizeof(data));
+  InvalidateDecodedADPCMBlocks(real_address, sizeof(data));
 }
 
 // Zeroes optimized out; middle removed too(it's 16384)
@@ -2089,15 +2452,67 @@ static constexpr std::array<s16, 20> s_reverb_resample_coefficients = {
 static s16 s_last_reverb_input[2];
 static s32 s_last_reverb_output[2];
 
-ALWAYS_INLINE static s32 Reverb4422(const s16* src)
+// The same coefficients, laid out for a contiguous dot product. Downsampling reads every other input sample, so the
+// coefficients are interleaved with zeros, and the middle tap lands on the odd index between them. Upsampling is
+// padded to a multiple of eight taps.
+struct ReverbFIRCoefficients
 {
-  s32 out = 0; // 32-bits is adequate(it won't overflow)
-  for (u32 i = 0; i < 20; i++)
-    out += s_reverb_resample_coefficients[i] * src[i * 2];
+  alignas(16) std::array<s16, 40> downsample;
+  alignas(16) std::array<s16, 24> upsample;
+};
+
+static constexpr ReverbFIRCoefficients ComputeReverbFIRCoefficients()
+{
+  ReverbFIRCoefficients coefficients = {};
+  for (u32 i = 0; i < s_reverb_resample_coefficients.size(); i++)
+  {
+    coefficients.downsample[i * 2] = s_reverb_resample_coefficients[i];
+    coefficients.upsample[i] = s_reverb_resample_coefficients[i];
+  }
 
   // Middle non-zero
-  out += 0x4000 * src[19];
-  out >>= 15;
+  coefficients.downsample[19] = 0x4000;
+  return coefficients;
+}
+
+static constexpr ReverbFIRCoefficients s_reverb_fir_coefficients = ComputeReverbFIRCoefficients();
+
+template<u32 num_taps>
+ALWAYS_INLINE static s32 ReverbDotProduct(const s16* src, const s16* coefficients)
+{
+  static_assert((num_taps % 8) == 0);
+
+  // 32-bits is adequate(it won't overflow)
+#if defined(CPU_X64)
+  __m128i sum = _mm_setzero_si128();
+  for (u32 i = 0; i < num_taps; i += 8)
+  {
+    sum = _mm_add_epi32(sum, _mm_madd_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(&src[i])),
+                                            _mm_load_si128(reinterpret_cast<const __m128i*>(&coefficients[i]))));
+  }
+  sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(1, 0, 3, 2)));
+  sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(2, 3, 0, 1)));
+  return _mm_cvtsi128_si32(sum);
+#elif defined(CPU_AARCH64)
+  int32x4_t sum = vdupq_n_s32(0);
+  for (u32 i = 0; i < num_taps; i += 8)
+  {
+    const int16x8_t s = vld1q_s16(&src[i]);
+    const int16x8_t c = vld1q_s16(&coefficients[i]);
+    sum = vmlal_high_s16(vmlal_s16(sum, vget_low_s16(s), vget_low_s16(c)), s, c);
+  }
+  return vaddvq_s32(sum);
+#else
+  s32 sum = 0;
+  for (u32 i = 0; i < num_taps; i++)
+    sum += s32(src[i]) * s32(coefficients[i]);
+  return sum;
+#endif
+}
+
+ALWAYS_INLINE static s32 Reverb4422(const s16* src)
+{
+  const s32 out = ReverbDotProduct<40>(src, s_reverb_fir_coefficients.downsample.data()) >> 15;
   return std::clamp<s32>(out, -32768, 32767);
 }
 
@@ -2112,11 +2527,8 @@ ALWAYS_INLINE static s32 Reverb2244(const s16* src)
   }
   else
   {
-    out = 0;
-    for (u32 i = 0; i < 20; i++)
-      out += s_reverb_resample_coefficients[i] * src[i];
-
-    out >>= 14;
+    // Reads 4 samples past the filter, the zero taps, which are still within the buffer.
+    out = ReverbDotProduct<24>(src, s_reverb_fir_coefficients.upsample.data()) >> 14;
     out = std::clamp<s32>(out, -32768, 32767);
   }
 
@@ -2167,36 +2579,37 @@ void SPU::ProcessReverb(s16 left_in, s16 right_in, s32* left_out, s32* right_out
 
     for (unsigned lr = 0; lr < 2; lr++)
     {
+      const ReverbTaps& taps = s_reverb_taps[lr];
       if (s_SPUCNT.reverb_master_enable)
       {
         const s16 IIR_INPUT_A =
-          ReverbSat((((ReverbRead(s_reverb_registers.IIR_SRC_A[lr ^ 0]) * s_reverb_registers.IIR_COEF) >> 14) +
+          ReverbSat((((ReverbRead(taps.iir_src_a) * s_reverb_registers.IIR_COEF) >> 14) +
                      ((downsampled[lr] * s_reverb_registers.IN_COEF[lr]) >> 14)) >>
                     1);
         const s16 IIR_INPUT_B =
-          ReverbSat((((ReverbRead(s_reverb_registers.IIR_SRC_B[lr ^ 1]) * s_reverb_registers.IIR_COEF) >> 14) +
+          ReverbSat((((ReverbRead(taps.iir_src_b) * s_reverb_registers.IIR_COEF) >> 14) +
                      ((downsampled[lr] * s_reverb_registers.IN_COEF[lr]) >> 14)) >>
                     1);
         const s16 IIR_A =
           ReverbSat((((IIR_INPUT_A * s_reverb_registers.IIR_ALPHA) >> 14) +
-                     (IIASM(s_reverb_registers.IIR_ALPHA, ReverbRead(s_reverb_registers.IIR_DEST_A[lr], -1)) >> 14)) >>
+                     (IIASM(s_reverb_registers.IIR_ALPHA, ReverbRead(taps.iir_dest_a_prev)) >> 14)) >>
                     1);
         const s16 IIR_B =
           ReverbSat((((IIR_INPUT_B * s_reverb_registers.IIR_ALPHA) >> 14) +
-                     (IIASM(s_reverb_registers.IIR_ALPHA, ReverbRead(s_reverb_registers.IIR_DEST_B[lr], -1)) >> 14)) >>
+                     (IIASM(s_reverb_registers.IIR_ALPHA, ReverbRead(taps.iir_dest_b_prev)) >> 14)) >>
                     1);
 
-        ReverbWrite(s_reverb_registers.IIR_DEST_A[lr], IIR_A);
-        ReverbWrite(s_reverb_registers.IIR_DEST_B[lr], IIR_B);
+        ReverbWrite(taps.iir_dest_a, IIR_A);
+        ReverbWrite(taps.iir_dest_b, IIR_B);
       }
 
-      const s32 ACC = ((ReverbRead(s_reverb_registers.ACC_SRC_A[lr]) * s_reverb_registers.ACC_COEF_A) >> 14) +
-                      ((ReverbRead(s_reverb_registers.ACC_SRC_B[lr]) * s_reverb_registers.ACC_COEF_B) >> 14) +
-                      ((ReverbRead(s_reverb_registers.ACC_SRC_C[lr]) * s_reverb_registers.ACC_COEF_C) >> 14) +
-                      ((ReverbRead(s_reverb_registers.ACC_SRC_D[lr]) * s_reverb_registers.ACC_COEF_D) >> 14);
+      const s32 ACC = ((ReverbRead(taps.acc_src_a) * s_reverb_registers.ACC_COEF_A) >> 14) +
+                      ((ReverbRead(taps.acc_src_b) * s_reverb_registers.ACC_COEF_B) >> 14) +
+                      ((ReverbRead(taps.acc_src_c) * s_reverb_registers.ACC_COEF_C) >> 14) +
+                      ((ReverbRead(taps.acc_src_d) * s_reverb_registers.ACC_COEF_D) >> 14);
 
-      const s16 FB_A = ReverbRead(s_reverb_registers.MIX_DEST_A[lr] - s_reverb_registers.FB_SRC_A);
-      const s16 FB_B = ReverbRead(s_reverb_registers.MIX_DEST_B[lr] - s_reverb_registers.FB_SRC_B);
+      const s16 FB_A = ReverbRead(taps.fb_src_a);
+      const s16 FB_B = ReverbRead(taps.fb_src_b);
       const s16 MDA = ReverbSat((ACC + ((FB_A * ReverbNeg(s_reverb_registers.FB_ALPHA)) >> 14)) >> 1);
       const s16 MDB = ReverbSat(
         FB_A +
@@ -2205,8 +2618,8 @@ void SPU::ProcessReverb(s16 left_in, s16 right_in, s32* left_out, s32* right_out
 
       if (s_SPUCNT.reverb_master_enable)
       {
-        ReverbWrite(s_reverb_registers.MIX_DEST_A[lr], MDA);
-        ReverbWrite(s_reverb_registers.MIX_DEST_B[lr], MDB);
+        ReverbWrite(taps.mix_dest_a, MDA);
+        ReverbWrite(taps.mix_dest_b, MDB);
       }
 
       s_reverb_upsample_buffer[lr][(s_reverb_resample_buffer_position >> 1) | 0x20] =
@@ -2270,25 +2683,31 @@ void SPU::Execute(void* param, TickCount ticks, TickCount ticks_late)
     const u32 frames_in_this_batch = std::min(remaining_frames, output_frame_space);
     for (u32 i = 0; i < frames_in_this_batch; i++)
     {
-      s32 left_sum = 0;
-      s32 right_sum = 0;
-      s32 reverb_in_left = 0;
-      s32 reverb_in_right = 0;
+      // Fetch and decode samples, mix all voices at once, then step each voice's pitch counter and envelopes.
+      u32 active_voices = 0;
+      for (u32 voice = 0; voice < NUM_VOICES; voice++)
+        active_voices |= BoolToUInt32(PrepareVoiceMix(voice)) << voice;
 
-      u32 reverb_on_register = s_reverb_on_register;
+      const VoiceMixSums sums = MixVoices(s_reverb_on_register);
+      s32 left_sum = sums.left;
+      s32 right_sum = sums.right;
+      s32 reverb_in_left = sums.reverb_left;
+      s32 reverb_in_right = sums.reverb_right;
 
       for (u32 voice = 0; voice < NUM_VOICES; voice++)
       {
-        const auto [left, right] = SampleVoice(voice);
-        left_sum += left;
-        right_sum += right;
+        // Pitch modulation reads the previous voice's output, so this has to happen in order.
+        s_voices[voice].last_volume = s_voice_mix.output[voice];
+        if (active_voices & (1u << voice))
+          AdvanceVoice(voice);
 
-        if (reverb_on_register & 1u)
+#ifdef SPU_DUMP_ALL_VOICES
+        if (!(active_voices & (1u << voice)) && s_voice_dump_writers[voice])
         {
-          reverb_in_left += left;
-          reverb_in_right += right;
+          const s16 dump_samples[2] = {0, 0};
+          s_voice_dump_writers[voice]->WriteFrames(dump_samples, 1);
         }
-        reverb_on_register >>= 1;
+#endif
       }
 
       if (!s_SPUCNT.mute_n)
@@ -2366,10 +2785,53 @@ void SPU::Execute(void* param, TickCount ticks, TickCount ticks_late)
 
     if (s_dump_writer)
       s_dump_writer->WriteFrames(output_frame_start, frames_in_this_batch);
+    if (MediaCapture::IsCapturing())
+      MediaCapture::WriteAudioFrames(output_frame_start, frames_in_this_batch);
+    if (s_output_hash_state)
+      XXH64_update(s_output_hash_state, output_frame_start, frames_in_this_batch * sizeof(s16) * 2);
 
     output_stream->EndWrite(frames_in_this_batch);
     remaining_frames -= frames_in_this_batch;
   }
+
+  // The voices have moved on, so the next point an IRQ could be raised has too.
+  UpdateEventInterval();
+}
+
+u32 SPU::GetFramesUntilRAMIRQ()
+{
+  // Returns a lower bound on the number of frames that can be run before the one which could raise the IRQ, counting
+  // that frame. Running the event at that interval keeps the IRQ timing exact, without running it every sample.
+  if (!IsRAMIRQTriggerable())
+    return std::numeric_limits<u32>::max();
+
+  // Voices are keyed on after the first frame, and fetch their first block in the second.
+  if (s_key_on_register != 0)
+    return 2;
+
+  // The capture buffers are written every frame, at a position which we know ahead of time.
+  u32 frames = std::numeric_limits<u32>::max();
+  const u32 irq_address = ZeroExtend32(s_irq_address) * 8;
+  if (irq_address < (CAPTURE_BUFFER_SIZE_PER_CHANNEL * 4))
+  {
+    const u32 distance = (irq_address - ZeroExtend32(s_capture_buffer_position)) % CAPTURE_BUFFER_SIZE_PER_CHANNEL;
+    frames = (distance / sizeof(s16)) + 1;
+  }
+
+  // Voices only check the IRQ when they fetch a block. The step is capped at 0x3FFF, so that's the soonest each voice
+  // can get to the end of its current block, and it fetches the next one in the following frame.
+  static constexpr u32 MAX_STEP = 0x3FFF;
+  static constexpr u32 BLOCK_END = NUM_SAMPLES_PER_ADPCM_BLOCK << 12;
+  for (const Voice& voice : s_voices)
+  {
+    if (!voice.has_samples)
+      return 1;
+
+    const u32 remaining = BLOCK_END - (voice.counter.bits & 0x1FFFFu);
+    frames = std::min(frames, ((remaining + (MAX_STEP - 1)) / MAX_STEP) + 1);
+  }
+
+  return frames;
 }
 
 void SPU::UpdateEventInterval()
@@ -2379,13 +2841,15 @@ void SPU::UpdateEventInterval()
   // the SPU state.
   const u32 max_slice_frames = s_audio_stream->GetBufferSize();
 
-  // TODO: Make this predict how long until the interrupt will be hit instead...
-  const u32 interval = (s_SPUCNT.enable && s_SPUCNT.irq9_enable) ? 1 : max_slice_frames;
+  // When the IRQ is enabled, only run up to the frame which could raise it. Register accesses catch up before they
+  // happen, so the batch size doesn't matter to the CPU.
+  const u32 interval = std::min(GetFramesUntilRAMIRQ(), max_slice_frames);
   const TickCount interval_ticks = static_cast<TickCount>(interval) * s_cpu_ticks_per_spu_tick;
   if (s_tick_event->IsActive() && s_tick_event->GetInterval() == interval_ticks)
     return;
 
-  // Ensure all pending ticks have been executed, since we won't get them back after rescheduling.
+  // Ensure all pending ticks have been executed, since we won't get them back after rescheduling. This is a no-op
+  // when called from Execute(), since there's nothing pending.
   s_tick_event->InvokeEarly(true);
   s_tick_event->SetInterval(interval_ticks);
 
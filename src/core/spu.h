@@ -45,6 +45,12 @@ bool StartDumpingAudio(const char* filename);
 /// Stops dumping audio to file, if started.
 bool StopDumpingAudio();
 
+/// Hashes the output frames as they're generated, so audio can be compared between runs.
+void SetOutputHashingEnabled(bool enabled);
+
+/// Returns the hash of the frames output since the last call.
+u64 GetAndResetOutputHash();
+
 /// Access to SPU RAM.
 const std::array<u8, RAM_SIZE>& GetRAM();
 std::array<u8, RAM_SIZE>& GetWritableRAM();
@@ -8,13 +8,16 @@
 #include "bus.h"
 #include "cdrom.h"
 #include "cheats.h"
+#include "common/arena_allocator.h"
 #include "common/error.h"
 #include "common/file_system.h"
 #include "common/log.h"
 #include "common/make_array.h"
 #include "common/path.h"
 #include "common/string_util.h"
+#include "common/thirdparty/thread_pool.h"
 #include "common/threading.h"
+#include "common/trace.h"
 #include "controller.h"
 #include "cpu_code_cache.h"
 #include "cpu_core.h"
@@ -23,14 +26,17 @@
 #include "fmt/format.h"
 #include "game_database.h"
 #include "gpu.h"
+#include "gpu_dump.h"
 #include "gte.h"
 #include "host.h"
 #include "host_display.h"
 #include "host_interface_progress_callback.h"
 #include "host_settings.h"
+#include "input_movie.h"
 #include "interrupt_controller.h"
 #include "libcrypt_serials.h"
 #include "mdec.h"
+#include "media_capture.h"
 #include "memory_card.h"
 #include "multitap.h"
 #include "pad.h"
@@ -46,16 +52,23 @@
 #include "util/cd_image.h"
 #include "util/ini_settings_interface.h"
 #include "util/iso_reader.h"
+#include "util/mapped_file.h"
 #include "util/state_wrapper.h"
 #include "xxhash.h"
+#include <algorithm>
+#include <array>
 #include <cctype>
 #include <cinttypes>
 #include <cmath>
+#include <condition_variable>
 #include <cstdio>
+#include <cstring>
 #include <deque>
 #include <fstream>
 #include <limits>
+#include <mutex>
 #include <thread>
+#include <vector>
 Log_SetChannel(System);
 
 #ifdef _WIN32
@@ -79,17 +92,61 @@ struct MemorySaveState
 {
   std::unique_ptr<GPUTexture> vram_texture;
   std::unique_ptr<GrowableMemoryByteStream> state_stream;
+  Bus::RAMSnapshot ram_snapshot;
+
+  /// VRAM is read back into the state stream like a regular save state, instead of copying the scaled texture.
+  /// The scaled texture is rebuilt from it on load, so the state doesn't scale with the resolution multiplier.
+  bool native_vram = false;
+};
+
+/// Part of an older rewind state, rebuilt from the state after it. The bytes are copied from the newer state at
+/// source_offset, or taken from the literal data when source_offset is REWIND_DELTA_LITERAL.
+struct RewindDeltaRun
+{
+  u32 source_offset;
+  u32 length;
+};
+
+/// Only the newest rewind state is kept in full. Older states are stored as the difference from the state after them,
+/// so dropping the oldest state never invalidates the others, and stepping back only has to decode one delta.
+/// The literal data of a delta is zstd compressed in the background, and is decompressed again when it's needed.
+struct RewindSaveState
+{
+  MemorySaveState mss;
+  std::vector<u32> section_offsets;
+  std::vector<RewindDeltaRun> delta_runs;
+  std::vector<u8> delta_literals;
+  u32 delta_literals_size = 0;
+  u32 state_size = 0;
+  bool delta_compressed = false;
+};
+
+/// A save state captured uncompressed in memory, which still has to be compressed and written out.
+struct SaveStateWriteJob
+{
+  std::string filename;
+  std::unique_ptr<GrowableMemoryByteStream> state;
+  std::vector<u32> section_offsets;
+  bool compress;
+  bool backup_existing_save;
 };
 
 namespace System {
 static std::optional<ExtendedSaveStateInfo> InternalGetExtendedSaveStateInfo(ByteStream* stream);
 static bool InternalSaveState(ByteStream* state, u32 screenshot_size = 256,
-                              u32 compression_method = SAVE_STATE_HEADER::COMPRESSION_TYPE_NONE);
-static bool SaveMemoryState(MemorySaveState* mss);
+                              u32 compression_method = SAVE_STATE_HEADER::COMPRESSION_TYPE_NONE,
+                              std::vector<u32>* section_offsets = nullptr);
+static bool SaveMemoryState(MemorySaveState* mss, std::vector<u32>* section_offsets = nullptr);
 static bool LoadMemoryState(const MemorySaveState& mss);
 
 static bool LoadEXE(const char* filename);
 
+/// EXE/PSF boots can restore the state the BIOS leaves behind before starting the executable, instead of running it.
+static std::string GetEXEBootSnapshotPath(bool psf);
+static bool LoadEXEBootSnapshot(const std::string& path);
+static bool SaveEXEBootSnapshot(const std::string& path);
+static void CheckForEXEBootSnapshot();
+
 static std::string GetExecutableNameForImage(ISOReader& iso, bool strip_subdirectories);
 
 static bool ReadExecutableFromImage(ISOReader& iso, std::string* out_executable_name,
@@ -97,12 +154,17 @@ static bool ReadExecutableFromImage(ISOReader& iso, std::string* out_executable_
 
 static void StallCPU(TickCount ticks);
 
-static bool LoadBIOS();
+static bool LoadBIOS(const std::optional<BIOS::Image>& bios_image);
 static void InternalReset();
 static void ClearRunningGame();
 static void DestroySystem();
+
+static void AddStartupPhase(const char* name, const Common::Timer& timer);
+static void LogStartupPhases();
 static std::string GetMediaPathFromSaveState(const char* path);
-static bool DoLoadState(ByteStream* stream, bool force_software_renderer, bool update_display);
+static std::unique_ptr<ByteStream> OpenSaveStateFile(const char* path, Common::MappedFile* mapping);
+static bool DoLoadState(ByteStream* stream, bool force_software_renderer, bool update_display,
+                        const u8* state_data = nullptr);
 static bool DoState(StateWrapper& sw, GPUTexture** host_texture, bool update_display, bool is_memory_state);
 static void DoRunFrame();
 static bool CreateGPU(GPURenderer renderer);
@@ -110,9 +172,25 @@ static bool SaveUndoLoadState();
 
 static void SetRewinding(bool enabled);
 static bool SaveRewindState();
+static void EncodeRewindDelta(RewindSaveState* rss, const RewindSaveState& next);
+static bool DecodeRewindDelta(RewindSaveState* rss, const RewindSaveState& next);
+static void PopRewindState();
+static void StartRewindCompressor();
+static void StopRewindCompressor();
+static void RewindCompressorThread();
+static void QueueRewindCompression(RewindSaveState* rss);
+static void CancelRewindCompression(const RewindSaveState* rss);
+static void QueueSaveStateWrite(SaveStateWriteJob job);
+static void StopSaveStateWriter();
+static void SaveStateWriterThread();
+static bool WriteSaveStateFile(const SaveStateWriteJob& job);
+static bool WriteSaveStateSections(ByteStream* stream, const u8* data, u32 size, u32 data_offset,
+                                   const std::vector<u32>& section_offsets);
 static void DoRewind();
 
 static void SaveRunaheadState();
+static void RecycleRunaheadStates();
+static void UpdateRAMDirtyTracking();
 static void DoRunahead();
 
 static void DoMemorySaveStates();
@@ -125,6 +203,14 @@ static bool CheckForSBIFile(CDImage* image);
 static std::unique_ptr<MemoryCard> GetMemoryCardForSlot(u32 slot, MemoryCardType type);
 
 static void SetTimerResolutionIncreased(bool enabled);
+static void UpdateThreadAffinityPolicy();
+static Common::Timer::Value GetLatePacingDelay(Common::Timer::Value period);
+static void WaitForLowLatencyPacing();
+static Common::Timer::Value PreciseSleepUntil(Common::Timer::Value wake_time);
+
+static void ResetFrameTimeHistograms();
+static void AddFrameTimeHistogramSample(FrameTimeHistogram histogram, float time_ms);
+static void UpdateFrameTimePercentiles();
 } // namespace System
 
 static constexpr const float PERFORMANCE_COUNTER_UPDATE_INTERVAL = 1.0f;
@@ -144,6 +230,16 @@ static u32 s_internal_frame_number = 1;
 static const BIOS::ImageInfo* s_bios_image_info = nullptr;
 static BIOS::Hash s_bios_hash = {};
 
+static constexpr u32 EXE_BOOT_SNAPSHOT_SIGNATURE = 0x544F4245; // EBOT
+
+/// Set while the BIOS is running up to the point the snapshot is taken, the executable is loaded after that.
+static std::string s_exe_boot_snapshot_path;
+static std::string s_exe_boot_snapshot_filename;
+static bool s_exe_boot_snapshot_psf = false;
+
+/// Replaces CPU execution when booting a GPU dump.
+static std::unique_ptr<GPUDump::Player> s_gpu_dump_player;
+
 static std::string s_running_game_path;
 static std::string s_running_game_serial;
 static std::string s_running_game_title;
@@ -161,6 +257,26 @@ static bool s_throttler_enabled = true;
 static bool s_display_all_frames = true;
 static bool s_syncing_to_host = false;
 
+// Decided before each host frame runs, so the GPU can skip display-only work for frames that won't be presented.
+static bool s_skip_presenting_frame = false;
+
+// Low latency pacing, only used when host vsync is doing the throttling.
+static constexpr double LOW_LATENCY_PACING_MARGIN_MS = 2.0;
+static bool s_low_latency_pacing = false;
+static Common::Timer::Value s_host_frame_period = 0;
+static Common::Timer::Value s_last_present_time = 0;
+static std::array<Common::Timer::Value, 8> s_frame_work_times = {};
+static u32 s_frame_work_time_index = 0;
+
+// How long before a deadline we stop sleeping and spin, going by how late the OS has been waking us up.
+static constexpr double MIN_THROTTLE_SLEEP_MARGIN_MS = 0.05;
+static constexpr double MAX_THROTTLE_SLEEP_MARGIN_MS = 2.0;
+static Common::Timer::Value s_throttle_sleep_margin = 0;
+
+// Late input latching, input is polled when the game reads the controller, and the throttler starts frames late.
+static bool s_late_input_latch = false;
+static Common::Timer::Value s_input_latch_time = 0;
+
 static float s_average_frame_time_accumulator = 0.0f;
 static float s_minimum_frame_time_accumulator = 0.0f;
 static float s_maximum_frame_time_accumulator = 0.0f;
@@ -173,19 +289,41 @@ static float s_maximum_frame_time = 0.0f;
 static float s_average_frame_time = 0.0f;
 static float s_cpu_thread_usage = 0.0f;
 static float s_cpu_thread_time = 0.0f;
+static float s_cpu_thread_allocations_per_frame = 0.0f;
+static u64 s_last_cpu_thread_allocations = 0;
 static float s_sw_thread_usage = 0.0f;
 static float s_sw_thread_time = 0.0f;
+static float s_sw_thread_wakeup_rate = 0.0f;
+static float s_sw_thread_sync_stall_rate = 0.0f;
+static float s_sw_thread_sync_stall_time = 0.0f;
 static float s_average_gpu_time = 0.0f;
 static float s_accumulated_gpu_time = 0.0f;
 static float s_gpu_usage = 0.0f;
+static HostDisplay::GPUTimingScopeTimes s_average_gpu_scope_times = {};
+static HostDisplay::GPUTimingScopeTimes s_accumulated_gpu_scope_times = {};
 static System::FrameTimeHistory s_frame_time_history;
 static u32 s_frame_time_history_pos = 0;
+
+struct FrameTimeHistogramData
+{
+  // 0.1ms buckets up to 100ms, anything longer is counted in the last bucket.
+  static constexpr float BUCKET_WIDTH_MS = 0.1f;
+  static constexpr u32 NUM_BUCKETS = 1000;
+
+  std::array<u32, NUM_BUCKETS> buckets;
+  u32 samples;
+  System::FrameTimePercentiles percentiles;
+};
+static std::array<FrameTimeHistogramData, static_cast<size_t>(System::FrameTimeHistogram::Count)>
+  s_frame_time_histograms;
+static u64 s_histogram_last_cpu_time = 0;
 static u32 s_last_frame_number = 0;
 static u32 s_last_internal_frame_number = 0;
 static u32 s_last_global_tick_counter = 0;
 static u64 s_last_cpu_time = 0;
 static u64 s_last_sw_time = 0;
 static u32 s_presents_since_last_update = 0;
+static u32 s_performance_counter_update_count = 0;
 static Common::Timer s_fps_timer;
 static Common::Timer s_frame_timer;
 static Threading::ThreadHandle s_cpu_thread_handle;
@@ -197,7 +335,45 @@ static std::unique_ptr<ByteStream> m_undo_load_state;
 
 static bool s_memory_saves_enabled = false;
 
-static std::deque<MemorySaveState> s_rewind_states;
+static constexpr u32 REWIND_DELTA_LITERAL = 0xFFFFFFFFu;
+static constexpr u32 REWIND_DELTA_PAGE_SIZE = 4096;
+static constexpr u32 REWIND_DELTA_CHUNK_SIZE = 32;
+
+static std::deque<RewindSaveState> s_rewind_states;
+static std::unique_ptr<GrowableMemoryByteStream> s_rewind_spare_stream;
+
+static constexpr int REWIND_COMPRESSION_LEVEL = 1;
+static Threading::Thread s_rewind_compress_thread;
+static std::mutex s_rewind_compress_mutex;
+static std::condition_variable s_rewind_compress_work_cv;
+static std::condition_variable s_rewind_compress_idle_cv;
+static std::deque<RewindSaveState*> s_rewind_compress_queue;
+static const RewindSaveState* s_rewind_compress_active = nullptr;
+static bool s_rewind_compress_shutdown = false;
+
+// Only accessed on the CPU thread.
+static bool s_rewind_compress_running = false;
+
+static Threading::Thread s_save_state_write_thread;
+static std::mutex s_save_state_write_mutex;
+static std::condition_variable s_save_state_write_work_cv;
+static std::condition_variable s_save_state_write_idle_cv;
+static std::deque<SaveStateWriteJob> s_save_state_write_queue;
+static bool s_save_state_write_active = false;
+static bool s_save_state_write_shutdown = false;
+
+/// Compresses the sections of a state in parallel. Only used by whichever thread is writing states.
+static std::unique_ptr<cb::ThreadPool> s_save_state_compress_pool;
+
+/// Time taken by each phase of booting, logged once the first frame has been presented. Some phases run on worker
+/// threads, hence the lock.
+static std::mutex s_startup_phases_mutex;
+static std::vector<std::pair<const char*, float>> s_startup_phases;
+static Common::Timer s_startup_timer;
+static bool s_startup_profile_pending = false;
+
+// Only accessed on the CPU thread.
+static bool s_save_state_write_running = false;
 static s32 s_rewind_load_frequency = -1;
 static s32 s_rewind_load_counter = -1;
 static s32 s_rewind_save_frequency = -1;
@@ -205,6 +381,7 @@ static s32 s_rewind_save_counter = -1;
 static bool s_rewinding_first_save = false;
 
 static std::deque<MemorySaveState> s_runahead_states;
+static std::vector<MemorySaveState> s_runahead_spare_states;
 static bool s_runahead_replay_pending = false;
 static u32 s_runahead_frames = 0;
 
@@ -306,6 +483,8 @@ u32 System::GetInternalFrameNumber()
 void System::FrameDone()
 {
   s_frame_number++;
+  if (g_settings.gpu_pgxp_enable && g_settings.gpu_pgxp_vertex_cache)
+    PGXP::NewFrame();
   CPU::g_state.frame_done = true;
   CPU::g_state.downcount = 0;
 }
@@ -344,6 +523,11 @@ const BIOS::Hash& System::GetBIOSHash()
   return s_bios_hash;
 }
 
+u32 System::GetPerformanceCounterUpdateCount()
+{
+  return s_performance_counter_update_count;
+}
+
 float System::GetFPS()
 {
   return s_fps;
@@ -380,6 +564,11 @@ float System::GetCPUThreadAverageTime()
 {
   return s_cpu_thread_time;
 }
+float System::GetCPUThreadAllocationsPerFrame()
+{
+  return s_cpu_thread_allocations_per_frame;
+}
+
 float System::GetSWThreadUsage()
 {
   return s_sw_thread_usage;
@@ -388,6 +577,18 @@ float System::GetSWThreadAverageTime()
 {
   return s_sw_thread_time;
 }
+float System::GetSWThreadWakeupRate()
+{
+  return s_sw_thread_wakeup_rate;
+}
+float System::GetSWThreadSyncStallRate()
+{
+  return s_sw_thread_sync_stall_rate;
+}
+float System::GetSWThreadSyncStallTime()
+{
+  return s_sw_thread_sync_stall_time;
+}
 float System::GetGPUUsage()
 {
   return s_gpu_usage;
@@ -396,6 +597,10 @@ float System::GetGPUAverageTime()
 {
   return s_average_gpu_time;
 }
+float System::GetGPUAverageScopeTime(u32 scope)
+{
+  return (scope < s_average_gpu_scope_times.size()) ? s_average_gpu_scope_times[scope] : 0.0f;
+}
 const System::FrameTimeHistory& System::GetFrameTimeHistory()
 {
   return s_frame_time_history;
@@ -404,6 +609,10 @@ u32 System::GetFrameTimeHistoryPos()
 {
   return s_frame_time_history_pos;
 }
+const System::FrameTimePercentiles& System::GetFrameTimePercentiles(FrameTimeHistogram histogram)
+{
+  return s_frame_time_histograms[static_cast<size_t>(histogram)].percentiles;
+}
 
 bool System::IsExeFileName(const std::string_view& path)
 {
@@ -416,13 +625,18 @@ bool System::IsPsfFileName(const std::string_view& path)
   return (StringUtil::EndsWithNoCase(path, ".psf") || StringUtil::EndsWithNoCase(path, ".minipsf"));
 }
 
+bool System::IsGPUDumpFileName(const std::string_view& path)
+{
+  return StringUtil::EndsWithNoCase(path, GPUDump::FILE_EXTENSION);
+}
+
 bool System::IsLoadableFilename(const std::string_view& path)
 {
   static constexpr auto extensions = make_array(".bin", ".cue", ".img", ".iso", ".chd", ".ecm", ".mds", // discs
                                                 ".exe", ".psexe", ".ps-exe",                            // exes
                                                 ".psf", ".minipsf",                                     // psf
                                                 ".m3u",                                                 // playlists
-                                                ".pbp");
+                                                ".pbp", GPUDump::FILE_EXTENSION);
 
   for (const char* test_extension : extensions)
   {
@@ -466,7 +680,16 @@ std::string System::GetGameSerialForPath(const char* image_path, bool fallback_t
 
 std::string System::GetGameIdFromImage(CDImage* cdi, bool fallback_to_hash)
 {
-  std::string code(GetExecutableNameForImage(cdi));
+  ISOReader iso;
+  if (!iso.Open(cdi, 1))
+    return {};
+
+  return GetGameIdFromImage(iso, fallback_to_hash);
+}
+
+std::string System::GetGameIdFromImage(ISOReader& iso, bool fallback_to_hash)
+{
+  std::string code(GetExecutableNameForImage(iso, true));
   if (!code.empty())
   {
     // SCES_123.45 -> SCES-12345
@@ -492,7 +715,7 @@ std::string System::GetGameIdFromImage(CDImage* cdi, bool fallback_to_hash)
   if (!fallback_to_hash)
     return {};
 
-  return GetGameHashIdFromImage(cdi);
+  return GetGameHashIdFromImage(iso);
 }
 
 std::string System::GetGameHashIdFromImage(CDImage* cdi)
@@ -501,12 +724,17 @@ std::string System::GetGameHashIdFromImage(CDImage* cdi)
   if (!iso.Open(cdi, 1))
     return {};
 
+  return GetGameHashIdFromImage(iso);
+}
+
+std::string System::GetGameHashIdFromImage(ISOReader& iso)
+{
   std::string exe_name;
   std::vector<u8> exe_buffer;
-  if (!ReadExecutableFromImage(cdi, &exe_name, &exe_buffer))
+  if (!ReadExecutableFromImage(iso, &exe_name, &exe_buffer))
     return {};
 
-  const u32 track_1_length = cdi->GetTrackLength(1);
+  const u32 track_1_length = iso.GetImage()->GetTrackLength(1);
 
   XXH64_state_t* state = XXH64_createState();
   XXH64_reset(state, 0x4242D00C);
@@ -963,6 +1191,9 @@ void System::ResetSystem()
     ApplySettings(false);
 #endif
 
+  // the movie's frames only make sense following on from its starting state
+  InputMovie::Stop();
+
   InternalReset();
   ResetPerformanceCounters();
   ResetThrottler();
@@ -1008,7 +1239,13 @@ bool System::LoadState(const char* filename)
 
   Common::Timer load_timer;
 
-  std::unique_ptr<ByteStream> stream = ByteStream::OpenFile(filename, BYTESTREAM_OPEN_READ | BYTESTREAM_OPEN_STREAMED);
+  // the state could have only just been saved
+  WaitForSaveStateWrites();
+
+  InputMovie::Stop();
+
+  Common::MappedFile mapping;
+  std::unique_ptr<ByteStream> stream = OpenSaveStateFile(filename, &mapping);
   if (!stream)
     return false;
 
@@ -1023,9 +1260,11 @@ bool System::LoadState(const char* filename)
       5.0f);
   }
 
+  Common::Timer undo_timer;
   SaveUndoLoadState();
+  Log_VerbosePrintf("Saving undo load state took %.2f msec", undo_timer.GetTimeMilliseconds());
 
-  if (!DoLoadState(stream.get(), false, true))
+  if (!DoLoadState(stream.get(), false, true, mapping.GetData()))
   {
     Host::ReportFormattedErrorAsync(
       "Load State Error", Host::TranslateString("OSDMessage", "Loading state from '%s' failed. Resetting."), filename);
@@ -1045,32 +1284,151 @@ bool System::LoadState(const char* filename)
 
 bool System::SaveState(const char* filename, bool backup_existing_save)
 {
-  if (backup_existing_save && FileSystem::FileExists(filename))
+  Common::Timer save_timer;
+
+  Log_InfoPrintf("Saving state to '%s'...", filename);
+
+  // only the snapshot has to be taken on the CPU thread, compression and file IO happen on the writer thread
+  SaveStateWriteJob job;
+  job.filename = filename;
+  job.state = ByteStream::CreateGrowableMemoryStream(nullptr, MAX_SAVE_STATE_SIZE);
+  job.compress = g_settings.compress_save_states;
+  job.backup_existing_save = backup_existing_save;
+
+  const u32 screenshot_size = 256;
+  if (!InternalSaveState(job.state.get(), screenshot_size, SAVE_STATE_HEADER::COMPRESSION_TYPE_NONE,
+                         &job.section_offsets))
+  {
+    Host::ReportFormattedErrorAsync(Host::TranslateString("OSDMessage", "Save State"),
+                                    Host::TranslateString("OSDMessage", "Saving state to '%s' failed."), filename);
+    return false;
+  }
+
+  Log_VerbosePrintf("Capturing state took %.2f msec", save_timer.GetTimeMilliseconds());
+  QueueSaveStateWrite(std::move(job));
+  return true;
+}
+
+void System::QueueSaveStateWrite(SaveStateWriteJob job)
+{
+  if (!s_save_state_write_running)
+  {
+    s_save_state_write_shutdown = false;
+    if (!s_save_state_write_thread.Start(SaveStateWriterThread))
+    {
+      Log_ErrorPrint("Failed to start save state writer thread, writing on the CPU thread.");
+      WriteSaveStateFile(job);
+      return;
+    }
+
+    s_save_state_write_running = true;
+  }
+
+  std::unique_lock<std::mutex> lock(s_save_state_write_mutex);
+  s_save_state_write_queue.push_back(std::move(job));
+  s_save_state_write_work_cv.notify_one();
+}
+
+void System::WaitForSaveStateWrites()
+{
+  std::unique_lock<std::mutex> lock(s_save_state_write_mutex);
+  s_save_state_write_idle_cv.wait(lock,
+                                  []() { return s_save_state_write_queue.empty() && !s_save_state_write_active; });
+}
+
+void System::StopSaveStateWriter()
+{
+  if (!s_save_state_write_running)
+    return;
+
+  // pending states still get written, so the resume state isn't lost at shutdown
+  WaitForSaveStateWrites();
+
+  {
+    std::unique_lock<std::mutex> lock(s_save_state_write_mutex);
+    s_save_state_write_shutdown = true;
+    s_save_state_write_work_cv.notify_one();
+  }
+
+  s_save_state_write_thread.Join();
+  s_save_state_write_running = false;
+  s_save_state_compress_pool.reset();
+}
+
+void System::SaveStateWriterThread()
+{
+  Threading::SetNameOfCurrentThread("Save State Writer Thread");
+  Threading::ApplyAffinityPolicy(Threading::AffinityClass::Background);
+
+  std::unique_lock<std::mutex> lock(s_save_state_write_mutex);
+  for (;;)
+  {
+    s_save_state_write_work_cv.wait(lock,
+                                    []() { return s_save_state_write_shutdown || !s_save_state_write_queue.empty(); });
+    if (s_save_state_write_shutdown)
+      break;
+
+    SaveStateWriteJob job = std::move(s_save_state_write_queue.front());
+    s_save_state_write_queue.pop_front();
+    s_save_state_write_active = true;
+    lock.unlock();
+
+    WriteSaveStateFile(job);
+    job.state.reset();
+
+    lock.lock();
+    s_save_state_write_active = false;
+    s_save_state_write_idle_cv.notify_all();
+  }
+}
+
+bool System::WriteSaveStateFile(const SaveStateWriteJob& job)
+{
+  Common::Timer write_timer;
+
+  const char* filename = job.filename.c_str();
+  if (job.backup_existing_save && FileSystem::FileExists(filename))
   {
     const std::string backup_filename(Path::ReplaceExtension(filename, "bak"));
     if (!FileSystem::RenamePath(filename, backup_filename.c_str()))
       Log_ErrorPrintf("Failed to rename save state backup '%s'", backup_filename.c_str());
   }
 
-  Common::Timer save_timer;
-
   std::unique_ptr<ByteStream> stream =
     ByteStream::OpenFile(filename, BYTESTREAM_OPEN_CREATE | BYTESTREAM_OPEN_WRITE | BYTESTREAM_OPEN_TRUNCATE |
                                      BYTESTREAM_OPEN_ATOMIC_UPDATE | BYTESTREAM_OPEN_STREAMED);
-  if (!stream)
-    return false;
-
-  Log_InfoPrintf("Saving state to '%s'...", filename);
+  bool result = static_cast<bool>(stream);
+  if (result)
+  {
+    const u8* data = job.state->GetMemoryPointer();
+    if (!job.compress)
+    {
+      result = stream->Write2(data, static_cast<u32>(job.state->GetSize()));
+    }
+    else
+    {
+      // everything before the state data is unchanged, so only the header's compression fields need updating
+      SAVE_STATE_HEADER header;
+      std::memcpy(&header, data, sizeof(header));
+      header.data_compression_type = SAVE_STATE_HEADER::COMPRESSION_TYPE_ZSTD_SECTIONS;
+
+      result = stream->Write2(data, header.offset_to_data) &&
+               WriteSaveStateSections(stream.get(), data + header.offset_to_data, header.data_uncompressed_size,
+                                      header.offset_to_data, job.section_offsets);
+
+      const u64 end_position = stream->GetPosition();
+      header.data_compressed_size = static_cast<u32>(end_position - header.offset_to_data);
+      result = result && stream->SeekAbsolute(0) && stream->Write2(&header, sizeof(header)) &&
+               stream->SeekAbsolute(end_position);
+    }
+  }
 
-  const u32 screenshot_size = 256;
-  const bool result = InternalSaveState(stream.get(), screenshot_size,
-                                        g_settings.compress_save_states ? SAVE_STATE_HEADER::COMPRESSION_TYPE_ZSTD :
-                                                                          SAVE_STATE_HEADER::COMPRESSION_TYPE_NONE);
   if (!result)
   {
     Host::ReportFormattedErrorAsync(Host::TranslateString("OSDMessage", "Save State"),
                                     Host::TranslateString("OSDMessage", "Saving state to '%s' failed."), filename);
-    stream->Discard();
+    if (stream)
+      stream->Discard();
   }
   else
   {
@@ -1082,10 +1440,98 @@ bool System::SaveState(const char* filename, bool backup_existing_save)
     stream->Commit();
   }
 
-  Log_VerbosePrintf("Saving state took %.2f msec", save_timer.GetTimeMilliseconds());
+  Log_VerbosePrintf("Writing state took %.2f msec", write_timer.GetTimeMilliseconds());
   return result;
 }
 
+bool System::WriteSaveStateSections(ByteStream* stream, const u8* data, u32 size, u32 data_offset,
+                                    const std::vector<u32>& section_offsets)
+{
+  static constexpr u32 MIN_SECTION_SIZE = 64 * 1024;
+
+  // Split at the markers, but merge small components into the next one, since a frame per component would cost more
+  // in frame overhead and lost context than it gains in parallelism.
+  std::vector<std::pair<u32, u32>> sections;
+  u32 section_start = 0;
+  for (const u32 marker_offset : section_offsets)
+  {
+    if (marker_offset < data_offset || (marker_offset - data_offset) > size)
+      continue;
+
+    const u32 offset = marker_offset - data_offset;
+    if (offset > section_start && (offset - section_start) >= MIN_SECTION_SIZE)
+    {
+      sections.emplace_back(section_start, offset - section_start);
+      section_start = offset;
+    }
+  }
+  if (section_start < size || sections.empty())
+    sections.emplace_back(section_start, size - section_start);
+
+  if (!s_save_state_compress_pool)
+  {
+    const unsigned int num_workers = std::clamp(cb::ThreadPool::GetNumLogicalCores() / 2u, 1u, 4u);
+    s_save_state_compress_pool = std::make_unique<cb::ThreadPool>(static_cast<int>(num_workers));
+  }
+
+  std::vector<std::future<std::unique_ptr<GrowableMemoryByteStream>>> frames;
+  frames.reserve(sections.size());
+  for (const auto& [start, length] : sections)
+  {
+    frames.push_back(s_save_state_compress_pool->ScheduleAndGetFuture(
+      [section_data = data + start, length = length]() -> std::unique_ptr<GrowableMemoryByteStream> {
+        std::unique_ptr<GrowableMemoryByteStream> frame = ByteStream::CreateGrowableMemoryStream(nullptr, length / 2);
+        std::unique_ptr<ByteStream> cstream(ByteStream::CreateZstdCompressStream(frame.get(), 0));
+        if (!cstream->Write2(section_data, length) || !cstream->Commit())
+          return {};
+
+        return frame;
+      }));
+  }
+
+  // wait for everything before returning, the workers are still reading from data
+  std::vector<std::unique_ptr<GrowableMemoryByteStream>> frame_streams;
+  frame_streams.reserve(frames.size());
+  for (auto& frame : frames)
+    frame_streams.push_back(frame.get());
+
+  const u32 num_sections = static_cast<u32>(sections.size());
+  std::vector<SAVE_STATE_SECTION> table(num_sections);
+  for (u32 i = 0; i < num_sections; i++)
+  {
+    if (!frame_streams[i])
+      return false;
+
+    table[i].uncompressed_size = sections[i].second;
+    table[i].compressed_size = static_cast<u32>(frame_streams[i]->GetSize());
+  }
+
+  if (!stream->Write2(&num_sections, sizeof(num_sections)) ||
+      !stream->Write2(table.data(), num_sections * sizeof(SAVE_STATE_SECTION)))
+  {
+    return false;
+  }
+
+  for (const std::unique_ptr<GrowableMemoryByteStream>& frame : frame_streams)
+  {
+    if (!stream->Write2(frame->GetMemoryPointer(), static_cast<u32>(frame->GetSize())))
+      return false;
+  }
+
+  Log_DevPrintf("Compressed %u bytes of state data in %u sections", size, num_sections);
+  return true;
+}
+
+bool System::SaveStateToStream(ByteStream* stream)
+{
+  return InternalSaveState(stream, 0, SAVE_STATE_HEADER::COMPRESSION_TYPE_ZSTD);
+}
+
+bool System::LoadStateFromStream(ByteStream* stream)
+{
+  return IsValid() && DoLoadState(stream, false, true);
+}
+
 bool System::SaveResumeState()
 {
   if (s_running_game_serial.empty())
@@ -1114,14 +1560,51 @@ bool System::BootSystem(SystemBootParameters parameters)
   s_state = State::Starting;
   s_startup_cancelled.store(false);
   s_region = g_settings.region;
+  {
+    std::unique_lock lock(s_startup_phases_mutex);
+    s_startup_phases.clear();
+    s_startup_timer.Reset();
+    s_startup_profile_pending = true;
+  }
   Host::OnSystemStarting();
 
+  // Independent parts of the boot process are run on the task pool, overlapping with the disc being opened and the
+  // GPU being created. Anything returning early waits for them in the group's destructor, so the results need to
+  // be declared before it.
+  std::optional<BIOS::Image> bios_image;
+  Threading::TaskGroup boot_tasks;
+
+  // The game database isn't needed until the disc has been identified.
+  boot_tasks.Submit(
+    []() {
+      Common::Timer timer;
+      GameDatabase::EnsureLoaded();
+      AddStartupPhase("Game database (async)", timer);
+    },
+    Threading::TaskPool::Priority::High);
+
   // Load CD image up and detect region.
   Common::Error error;
   std::unique_ptr<CDImage> media;
   std::string exe_boot;
   std::string psf_boot;
-  if (!parameters.filename.empty())
+  if (!parameters.filename.empty() && IsGPUDumpFileName(parameters.filename))
+  {
+    // Nothing but the GPU runs, so the rest of the boot only sets up the display.
+    s_gpu_dump_player = GPUDump::Player::Open(parameters.filename.c_str(), &error);
+    if (!s_gpu_dump_player)
+    {
+      Host::ReportErrorAsync("Error", fmt::format("Failed to load GPU dump '{}': {}",
+                                                  Path::GetFileName(parameters.filename), error.GetCodeAndMessage()));
+      s_state = State::Shutdown;
+      Host::OnSystemDestroyed();
+      return false;
+    }
+
+    if (s_region == ConsoleRegion::Auto)
+      s_region = s_gpu_dump_player->GetRegion();
+  }
+  else if (!parameters.filename.empty())
   {
     const bool do_exe_boot = IsExeFileName(parameters.filename);
     const bool do_psf_boot = (!do_exe_boot && IsPsfFileName(parameters.filename));
@@ -1142,7 +1625,9 @@ bool System::BootSystem(SystemBootParameters parameters)
     else
     {
       Log_InfoPrintf("Loading CD image '%s'...", parameters.filename.c_str());
+      Common::Timer timer;
       media = CDImage::Open(parameters.filename.c_str(), g_settings.cdrom_load_image_patches, &error);
+      AddStartupPhase("Disc open", timer);
       if (!media)
       {
         Host::ReportErrorAsync("Error", fmt::format("Failed to load CD image '{}': {}",
@@ -1180,6 +1665,16 @@ bool System::BootSystem(SystemBootParameters parameters)
 
   Log_InfoPrintf("Console Region: %s", Settings::GetConsoleRegionDisplayName(s_region));
 
+  // The BIOS only depends on the region, so find and hash it while the game settings are applied and the GPU is
+  // created. It's not copied into memory until after Initialize().
+  boot_tasks.Submit(
+    [&bios_image, region = s_region]() {
+      Common::Timer timer;
+      bios_image = BIOS::GetBIOSImage(region);
+      AddStartupPhase("BIOS load (async)", timer);
+    },
+    Threading::TaskPool::Priority::High);
+
   // Switch subimage.
   if (media && parameters.media_playlist_index != 0 && !media->SwitchSubImage(parameters.media_playlist_index, &error))
   {
@@ -1192,7 +1687,9 @@ bool System::BootSystem(SystemBootParameters parameters)
   }
 
   // Update running game, this will apply settings as well.
+  Common::Timer phase_timer;
   UpdateRunningGame(media ? media->GetFileName().c_str() : parameters.filename.c_str(), media.get(), true);
+  AddStartupPhase("Game settings", phase_timer);
 
   if (!parameters.override_exe.empty())
   {
@@ -1230,31 +1727,52 @@ bool System::BootSystem(SystemBootParameters parameters)
   }
 #endif
 
-  // Load BIOS image.
-  if (!LoadBIOS())
+  // Component setup.
+  phase_timer.Reset();
+  if (!Initialize(parameters.force_software_renderer))
   {
     s_state = State::Shutdown;
     ClearRunningGame();
     Host::OnSystemDestroyed();
     return false;
   }
+  AddStartupPhase("Component initialization", phase_timer);
 
-  // Component setup.
-  if (!Initialize(parameters.force_software_renderer))
+  // Load BIOS image.
+  phase_timer.Reset();
+  boot_tasks.Wait();
+  AddStartupPhase("Waiting for async tasks", phase_timer);
+  if (!s_gpu_dump_player && !LoadBIOS(bios_image))
   {
-    s_state = State::Shutdown;
-    ClearRunningGame();
-    Host::OnSystemDestroyed();
+    DestroySystem();
     return false;
   }
 
   // Allow controller analog mode for EXEs and PSFs.
   s_running_bios = s_running_game_path.empty() && exe_boot.empty() && psf_boot.empty();
 
+  phase_timer.Reset();
   UpdateControllers();
   UpdateMemoryCardTypes();
   UpdateMultitaps();
+  AddStartupPhase("Controllers and memory cards", phase_timer);
+
+  phase_timer.Reset();
   InternalReset();
+  AddStartupPhase("Reset", phase_timer);
+
+  if (s_gpu_dump_player)
+  {
+    g_gpu->RestoreGraphicsAPIState();
+    const bool result = s_gpu_dump_player->LoadInitialState();
+    g_gpu->ResetGraphicsAPIState();
+    if (!result)
+    {
+      Host::ReportFormattedErrorAsync("Error", "Failed to load GPU state from '%s'.", parameters.filename.c_str());
+      DestroySystem();
+      return false;
+    }
+  }
 
   // Enable tty by patching bios.
   if (g_settings.bios_patch_tty_enable)
@@ -1265,6 +1783,27 @@ bool System::BootSystem(SystemBootParameters parameters)
       Log_ErrorPrintf("Not patching TTY enable, as BIOS is not patch compatible.");
   }
 
+  // Skip the BIOS startup by restoring a snapshot of it, or run it this time and take the snapshot at the end.
+  if ((!exe_boot.empty() || !psf_boot.empty()) && g_settings.bios_exe_boot_snapshot && s_bios_image_info &&
+      s_bios_image_info->patch_compatible)
+  {
+    phase_timer.Reset();
+    std::string snapshot_path = GetEXEBootSnapshotPath(!psf_boot.empty());
+    if (LoadEXEBootSnapshot(snapshot_path))
+    {
+      AddStartupPhase("EXE boot snapshot load", phase_timer);
+    }
+    else
+    {
+      BIOS::PatchBIOSHaltForEXE(Bus::g_bios, Bus::BIOS_SIZE);
+      s_exe_boot_snapshot_path = std::move(snapshot_path);
+      s_exe_boot_snapshot_psf = !psf_boot.empty();
+      s_exe_boot_snapshot_filename = std::move(s_exe_boot_snapshot_psf ? psf_boot : exe_boot);
+      exe_boot = {};
+      psf_boot = {};
+    }
+  }
+
   // Load EXE late after BIOS.
   if (!exe_boot.empty() && !LoadEXE(exe_boot.c_str()))
   {
@@ -1306,8 +1845,9 @@ bool System::BootSystem(SystemBootParameters parameters)
   // try to load the state, if it fails, bail out
   if (!parameters.save_state.empty())
   {
-    std::unique_ptr<ByteStream> stream =
-      ByteStream::OpenFile(parameters.save_state.c_str(), BYTESTREAM_OPEN_READ | BYTESTREAM_OPEN_STREAMED);
+    phase_timer.Reset();
+    Common::MappedFile mapping;
+    std::unique_ptr<ByteStream> stream = OpenSaveStateFile(parameters.save_state.c_str(), &mapping);
     if (!stream)
     {
       Host::ReportErrorAsync(
@@ -1318,15 +1858,30 @@ bool System::BootSystem(SystemBootParameters parameters)
       return false;
     }
 
-    if (!DoLoadState(stream.get(), false, true))
+    if (!DoLoadState(stream.get(), false, true, mapping.GetData()))
     {
       DestroySystem();
       return false;
     }
+    AddStartupPhase("Save state load", phase_timer);
+  }
+
+  if ((!parameters.replay_input_movie.empty() && !InputMovie::StartReplay(parameters.replay_input_movie.c_str())) ||
+      (!parameters.record_input_movie.empty() && !InputMovie::StartRecording(parameters.record_input_movie.c_str())))
+  {
+    Host::ReportErrorAsync(
+      Host::TranslateString("System", "Error"),
+      Host::TranslateString("System", "Failed to start input movie, check the log for details."));
+    DestroySystem();
+    return false;
   }
 
   if (parameters.load_image_to_ram || g_settings.cdrom_load_image_to_ram)
+  {
+    phase_timer.Reset();
     CDROM::PrecacheMedia();
+    AddStartupPhase("Disc precache", phase_timer);
+  }
 
   if (g_settings.audio_dump_on_boot)
     StartDumpingAudio();
@@ -1335,11 +1890,18 @@ bool System::BootSystem(SystemBootParameters parameters)
   if (IsRunning())
     UpdateSpeedLimiterState();
 
+  // Nothing is presented while paused, so don't wait for a first frame.
+  if (s_state == State::Paused)
+    LogStartupPhases();
+
   return true;
 }
 
 bool System::Initialize(bool force_software_renderer)
 {
+  // before any of the worker threads get created, so they pin themselves accordingly
+  UpdateThreadAffinityPolicy();
+
   g_ticks_per_second = ScaleTicksToOverclock(MASTER_CLOCK);
   s_max_slice_ticks = ScaleTicksToOverclock(MASTER_CLOCK / 10);
   s_frame_number = 1;
@@ -1364,20 +1926,29 @@ bool System::Initialize(bool force_software_renderer)
   s_average_frame_time = 0.0f;
   s_cpu_thread_usage = 0.0f;
   s_cpu_thread_time = 0.0f;
+  s_cpu_thread_allocations_per_frame = 0.0f;
+  s_last_cpu_thread_allocations = GetThreadHeapAllocationCount();
   s_sw_thread_usage = 0.0f;
   s_sw_thread_time = 0.0f;
+  s_sw_thread_wakeup_rate = 0.0f;
+  s_sw_thread_sync_stall_rate = 0.0f;
+  s_sw_thread_sync_stall_time = 0.0f;
   s_average_gpu_time = 0.0f;
   s_accumulated_gpu_time = 0.0f;
   s_gpu_usage = 0.0f;
+  s_average_gpu_scope_times = {};
+  s_accumulated_gpu_scope_times = {};
   s_last_frame_number = 0;
   s_last_internal_frame_number = 0;
   s_last_global_tick_counter = 0;
   s_presents_since_last_update = 0;
+  s_performance_counter_update_count++;
   s_last_cpu_time = 0;
   s_fps_timer.Reset();
   s_frame_timer.Reset();
   s_frame_time_history.fill(0.0f);
   s_frame_time_history_pos = 0;
+  ResetFrameTimeHistograms();
 
   TimingEvents::Initialize();
 
@@ -1389,12 +1960,14 @@ bool System::Initialize(bool force_software_renderer)
     return false;
   }
 
+  Common::Timer gpu_timer;
   if (!CreateGPU(force_software_renderer ? GPURenderer::Software : g_settings.gpu_renderer))
   {
     Bus::Shutdown();
     CPU::Shutdown();
     return false;
   }
+  AddStartupPhase("GPU and display creation", gpu_timer);
 
   GTE::UpdateAspectRatio();
 
@@ -1468,17 +2041,51 @@ bool System::Initialize(bool force_software_renderer)
   return true;
 }
 
+void System::AddStartupPhase(const char* name, const Common::Timer& timer)
+{
+  const float time = static_cast<float>(timer.GetTimeMilliseconds());
+  std::unique_lock lock(s_startup_phases_mutex);
+  if (s_startup_profile_pending)
+    s_startup_phases.emplace_back(name, time);
+}
+
+void System::LogStartupPhases()
+{
+  std::unique_lock lock(s_startup_phases_mutex);
+  if (!s_startup_profile_pending)
+    return;
+
+  s_startup_profile_pending = false;
+  Log_InfoPrintf("Startup took %.2f ms to the first frame:", s_startup_timer.GetTimeMilliseconds());
+  for (const auto& [name, time] : s_startup_phases)
+    Log_InfoPrintf("  %s: %.2f ms", name, time);
+}
+
 void System::DestroySystem()
 {
   if (s_state == State::Shutdown)
     return;
 
+  s_startup_profile_pending = false;
   SetTimerResolutionIncreased(false);
 
+  if (g_settings.debugging.dump_frame_time_histograms &&
+      s_frame_time_histograms[static_cast<size_t>(FrameTimeHistogram::Frame)].samples > 0)
+  {
+    SaveFrameTimeHistograms();
+  }
+
   s_cpu_thread_usage = {};
 
+  InputMovie::Stop();
+  MediaCapture::Stop();
   ClearMemorySaveStates();
 
+  // Don't leave screenshots or frame dumps half-written.
+  HostDisplay::WaitForScreenshotWrites();
+  StopRewindCompressor();
+  StopSaveStateWriter();
+
   g_texture_replacements.Shutdown();
 
   PCDrv::Shutdown();
@@ -1510,6 +2117,9 @@ void System::DestroySystem()
 
   s_bios_hash = {};
   s_bios_image_info = nullptr;
+  s_exe_boot_snapshot_path = {};
+  s_exe_boot_snapshot_filename = {};
+  s_gpu_dump_player.reset();
 
   Host::OnSystemDestroyed();
 }
@@ -1534,10 +2144,23 @@ void System::Execute()
 {
   while (System::IsRunning())
   {
+    const Common::Timer::Value work_start_time = Common::Timer::GetCurrentValue();
+
+    // Captures need every frame's display, and interlaced fields are still woven by the GPU regardless.
+    s_skip_presenting_frame = g_host_display->ShouldSkipDisplayingFrame() && !MediaCapture::IsCapturing();
     if (s_display_all_frames)
+    {
+      g_gpu->SetSkipDisplayUpdate(s_skip_presenting_frame);
       System::RunFrame();
+      g_gpu->SetSkipDisplayUpdate(false);
+    }
     else
+    {
       System::RunFrames();
+    }
+
+    s_frame_work_times[s_frame_work_time_index] = Common::Timer::GetCurrentValue() - work_start_time;
+    s_frame_work_time_index = (s_frame_work_time_index + 1) % static_cast<u32>(s_frame_work_times.size());
 
     // this can shut us down
     Host::PumpMessagesOnCPUThread();
@@ -1550,17 +2173,61 @@ void System::Execute()
       PauseSystem(true);
     }
 
-    const bool skip_present = g_host_display->ShouldSkipDisplayingFrame();
+    if (MediaCapture::IsCapturing())
+      MediaCapture::CaptureFrame();
+
+    const bool skip_present = s_skip_presenting_frame;
     Host::RenderDisplay(skip_present);
+    if (s_startup_profile_pending && !skip_present)
+      LogStartupPhases();
     if (!skip_present && g_host_display->IsGPUTimingEnabled())
     {
-      s_accumulated_gpu_time += g_host_display->GetAndResetAccumulatedGPUTime();
+      const float gpu_time = g_host_display->GetAndResetAccumulatedGPUTime();
+      s_accumulated_gpu_time += gpu_time;
+      AddFrameTimeHistogramSample(FrameTimeHistogram::GPU, gpu_time);
+      const HostDisplay::GPUTimingScopeTimes scope_times = g_host_display->GetAndResetAccumulatedGPUTimingScopeTimes();
+      for (u32 i = 0; i < HostDisplay::MAX_GPU_TIMING_SCOPES; i++)
+        s_accumulated_gpu_scope_times[i] += scope_times[i];
       s_presents_since_last_update++;
+
+      // Only at normal speed, fast forward would drop the resolution for nothing.
+      if (s_throttler_enabled && !s_fast_forward_enabled && !s_turbo_enabled)
+        g_gpu->UpdateDynamicResolution(gpu_time, 1000.0f / (s_throttle_frequency * s_target_speed));
+    }
+
+    // Measures from the first controller read of the frame to the end of the present.
+    if (!skip_present && s_input_latch_time != 0)
+    {
+      AddFrameTimeHistogramSample(
+        FrameTimeHistogram::InputLatency,
+        static_cast<float>(Common::Timer::ConvertValueToMilliseconds(Common::Timer::GetCurrentValue() -
+                                                                       s_input_latch_time)));
     }
 
     if (s_throttler_enabled)
+    {
       System::Throttle();
 
+      // Frames start late when latching input late, so the input polled before throttling is stale.
+      if (s_late_input_latch)
+      {
+        Host::PumpMessagesOnCPUThread();
+        if (!IsValid())
+          return;
+      }
+    }
+    else if (s_low_latency_pacing && !skip_present)
+    {
+      // Swap chains with a latency waitable object don't block in present, so wait for the vblank here instead.
+      // Poll input again after the delay, otherwise the next frame would see what was there before we slept.
+      g_host_display->WaitForSwapChain();
+      s_last_present_time = Common::Timer::GetCurrentValue();
+      WaitForLowLatencyPacing();
+      Host::PumpMessagesOnCPUThread();
+      if (!IsValid())
+        return;
+    }
+
     // Update perf counters *after* throttling, we want to measure from start-of-frame
     // to start-of-frame, not end-of-frame to end-of-frame (will be noisy due to different
     // amounts of computation happening in each frame).
@@ -1665,10 +2332,14 @@ bool System::DoState(StateWrapper& sw, GPUTexture** host_texture, bool update_di
   sw.Do(&s_internal_frame_number);
 
   // Don't bother checking this at all for memory states, since they won't have a different BIOS...
+  bool same_bios = true;
   if (!is_memory_state)
   {
     BIOS::Hash bios_hash = s_bios_hash;
     sw.DoBytesEx(bios_hash.bytes, sizeof(bios_hash.bytes), 58, s_bios_hash.bytes);
+
+    // older states overwrite the BIOS with their own copy
+    same_bios = (bios_hash == s_bios_hash && sw.GetVersion() >= 58);
     if (bios_hash != s_bios_hash)
     {
       Log_WarningPrintf("BIOS hash mismatch: System: %s | State: %s", s_bios_hash.ToString().c_str(),
@@ -1684,9 +2355,10 @@ bool System::DoState(StateWrapper& sw, GPUTexture** host_texture, bool update_di
   if (!sw.DoMarker("CPU") || !CPU::DoState(sw))
     return false;
 
+  // With the same BIOS, blocks only have to be revalidated against the loaded RAM rather than all recompiled.
   if (sw.IsReading())
   {
-    if (is_memory_state)
+    if (same_bios)
       CPU::CodeCache::InvalidateAll();
     else
       CPU::CodeCache::Flush();
@@ -1706,11 +2378,14 @@ bool System::DoState(StateWrapper& sw, GPUTexture** host_texture, bool update_di
   if (!sw.DoMarker("InterruptController") || !InterruptController::DoState(sw))
     return false;
 
+  Common::Timer gpu_timer;
   g_gpu->RestoreGraphicsAPIState();
   const bool gpu_result = sw.DoMarker("GPU") && g_gpu->DoState(sw, host_texture, update_display);
   g_gpu->ResetGraphicsAPIState();
   if (!gpu_result)
     return false;
+  if (sw.IsReading() && !is_memory_state)
+    Log_VerbosePrintf("Loading GPU state took %.2f msec", gpu_timer.GetTimeMilliseconds());
 
   if (!sw.DoMarker("CDROM") || !CDROM::DoState(sw))
     return false;
@@ -1786,9 +2461,8 @@ bool System::DoState(StateWrapper& sw, GPUTexture** host_texture, bool update_di
   return !sw.HasError();
 }
 
-bool System::LoadBIOS()
+bool System::LoadBIOS(const std::optional<BIOS::Image>& bios_image)
 {
-  std::optional<BIOS::Image> bios_image(BIOS::GetBIOSImage(s_region));
   if (!bios_image.has_value())
   {
     Host::ReportFormattedErrorAsync("Error", Host::TranslateString("System", "Failed to load %s BIOS."),
@@ -1874,10 +2548,27 @@ std::string System::GetMediaPathFromSaveState(const char* path)
   return ret;
 }
 
-bool System::DoLoadState(ByteStream* state, bool force_software_renderer, bool update_display)
+std::unique_ptr<ByteStream> System::OpenSaveStateFile(const char* path, Common::MappedFile* mapping)
+{
+  // mapped states are decompressed straight out of the page cache, without going through any read buffers
+  auto fp = FileSystem::OpenManagedCFile(path, "rb");
+  if (!fp)
+    return {};
+
+  if (mapping->Map(fp.get()) && mapping->GetSize() <= std::numeric_limits<u32>::max())
+    return ByteStream::CreateReadOnlyMemoryStream(mapping->GetData(), static_cast<u32>(mapping->GetSize()));
+
+  mapping->Unmap();
+  return ByteStream::OpenFile(path, BYTESTREAM_OPEN_READ | BYTESTREAM_OPEN_STREAMED);
+}
+
+bool System::DoLoadState(ByteStream* state, bool force_software_renderer, bool update_display,
+                         const u8* state_data /* = nullptr */)
 {
   Assert(IsValid());
 
+  Common::Timer media_timer;
+
   SAVE_STATE_HEADER header;
   if (!state->Read2(&header, sizeof(header)))
     return false;
@@ -2000,6 +2691,9 @@ bool System::DoLoadState(ByteStream* state, bool force_software_renderer, bool u
   if (!state->SeekAbsolute(header.offset_to_data))
     return false;
 
+  Log_VerbosePrintf("Loading media and resetting CD-ROM took %.2f msec", media_timer.GetTimeMilliseconds());
+
+  Common::Timer data_timer;
   if (header.data_compression_type == SAVE_STATE_HEADER::COMPRESSION_TYPE_NONE)
   {
     StateWrapper sw(state, StateWrapper::Mode::Read, header.version);
@@ -2008,9 +2702,60 @@ bool System::DoLoadState(ByteStream* state, bool force_software_renderer, bool u
   }
   else if (header.data_compression_type == SAVE_STATE_HEADER::COMPRESSION_TYPE_ZSTD)
   {
-    std::unique_ptr<ByteStream> dstream(ByteStream::CreateZstdDecompressStream(state, header.data_compressed_size));
-    StateWrapper sw(dstream.get(), StateWrapper::Mode::Read, header.version);
-    if (!DoState(sw, nullptr, update_display, false))
+    std::unique_ptr<ByteStream> dstream;
+    if (state_data)
+    {
+      if ((static_cast<u64>(header.offset_to_data) + header.data_compressed_size) > state->GetSize())
+        return false;
+
+      dstream = ByteStream::CreateZstdDecompressStream(state_data + header.offset_to_data, header.data_compressed_size);
+    }
+    else
+    {
+      dstream = ByteStream::CreateZstdDecompressStream(state, header.data_compressed_size);
+    }
+
+    StateWrapper sw(dstream.get(), StateWrapper::Mode::Read, header.version);
+    if (!DoState(sw, nullptr, update_display, false))
+      return false;
+  }
+  else if (header.data_compression_type == SAVE_STATE_HEADER::COMPRESSION_TYPE_ZSTD_SECTIONS)
+  {
+    // the frames follow each other, and zstd decodes concatenated frames as one stream
+    u32 num_sections;
+    if (!state->Read2(&num_sections, sizeof(num_sections)) || num_sections == 0 ||
+        num_sections > (header.data_compressed_size / sizeof(SAVE_STATE_SECTION)))
+    {
+      return false;
+    }
+
+    std::vector<SAVE_STATE_SECTION> table(num_sections);
+    if (!state->Read2(table.data(), num_sections * sizeof(SAVE_STATE_SECTION)))
+      return false;
+
+    const u32 table_size = sizeof(num_sections) + num_sections * static_cast<u32>(sizeof(SAVE_STATE_SECTION));
+    u64 frames_size = 0;
+    for (const SAVE_STATE_SECTION& section : table)
+      frames_size += section.compressed_size;
+    if ((table_size + frames_size) > header.data_compressed_size)
+      return false;
+
+    std::unique_ptr<ByteStream> dstream;
+    if (state_data)
+    {
+      if ((static_cast<u64>(header.offset_to_data) + header.data_compressed_size) > state->GetSize())
+        return false;
+
+      dstream = ByteStream::CreateZstdDecompressStream(state_data + header.offset_to_data + table_size,
+                                                       static_cast<u32>(frames_size));
+    }
+    else
+    {
+      dstream = ByteStream::CreateZstdDecompressStream(state, static_cast<u32>(frames_size));
+    }
+
+    StateWrapper sw(dstream.get(), StateWrapper::Mode::Read, header.version);
+    if (!DoState(sw, nullptr, update_display, false))
       return false;
   }
   else
@@ -2019,6 +2764,8 @@ bool System::DoLoadState(ByteStream* state, bool force_software_renderer, bool u
     return false;
   }
 
+  Log_VerbosePrintf("Loading state data took %.2f msec", data_timer.GetTimeMilliseconds());
+
   if (s_state == State::Starting)
     s_state = State::Running;
 
@@ -2028,7 +2775,8 @@ bool System::DoLoadState(ByteStream* state, bool force_software_renderer, bool u
 }
 
 bool System::InternalSaveState(ByteStream* state, u32 screenshot_size /* = 256 */,
-                               u32 compression_method /* = SAVE_STATE_HEADER::COMPRESSION_TYPE_NONE*/)
+                               u32 compression_method /* = SAVE_STATE_HEADER::COMPRESSION_TYPE_NONE*/,
+                               std::vector<u32>* section_offsets /* = nullptr */)
 {
   if (IsShutdown())
     return false;
@@ -2114,6 +2862,12 @@ bool System::InternalSaveState(ByteStream* state, u32 screenshot_size /* = 256 *
     if (compression_method == SAVE_STATE_HEADER::COMPRESSION_TYPE_NONE)
     {
       StateWrapper sw(state, StateWrapper::Mode::Write, SAVE_STATE_VERSION);
+      if (section_offsets)
+      {
+        section_offsets->clear();
+        sw.SetMarkerOffsets(section_offsets);
+      }
+
       result = DoState(sw, nullptr, false, false);
       header.data_uncompressed_size = static_cast<u32>(state->GetPosition() - header.offset_to_data);
     }
@@ -2163,9 +2917,15 @@ void System::SingleStepCPU()
 
 void System::DoRunFrame()
 {
+  TRACE_SCOPE("DoRunFrame");
   g_gpu->RestoreGraphicsAPIState();
 
-  if (CPU::g_state.use_debug_dispatcher)
+  if (s_gpu_dump_player)
+  {
+    s_gpu_dump_player->ProcessFrame();
+    FrameDone();
+  }
+  else if (CPU::g_state.use_debug_dispatcher)
   {
     CPU::ExecuteDebug();
   }
@@ -2203,17 +2963,29 @@ void System::DoRunFrame()
 
 void System::RunFrame()
 {
+  // nothing allocated from the frame arena on this thread lives past the end of the previous frame
+  ArenaAllocator::GetFrameArena().Reset();
+
   if (s_rewind_load_counter >= 0)
   {
+    InputMovie::Stop();
     DoRewind();
     return;
   }
 
+  InputMovie::OnFrameStarted();
+
   if (s_runahead_frames > 0)
     DoRunahead();
 
+  s_input_latch_time = 0;
   DoRunFrame();
 
+  if (!s_exe_boot_snapshot_path.empty())
+    CheckForEXEBootSnapshot();
+
+  InputMovie::OnFrameFinished();
+
   s_next_frame_time += s_frame_period;
 
   if (s_memory_saves_enabled)
@@ -2265,15 +3037,89 @@ void System::Throttle()
     return;
   }
 
-  // Use a spinwait if we undersleep for all platforms except android.. don't want to burn battery.
-  // Linux also seems to do a much better job of waking up at the requested time.
-#if !defined(__linux__) && !defined(__ANDROID__)
-  Common::Timer::SleepUntil(s_next_frame_time, g_settings.display_all_frames);
+  // With late input latching, the frame still has to finish by the next frame time, otherwise it'd be dropped.
+  const Common::Timer::Value wake_time =
+    s_next_frame_time + (s_late_input_latch ? GetLatePacingDelay(s_frame_period) : 0);
+
+  const Common::Timer::Value woke_time = PreciseSleepUntil(wake_time);
+  AddFrameTimeHistogramSample(FrameTimeHistogram::ThrottleJitter,
+                              static_cast<float>(Common::Timer::ConvertValueToMilliseconds(woke_time - wake_time)));
+}
+
+Common::Timer::Value System::PreciseSleepUntil(Common::Timer::Value wake_time)
+{
+#ifdef __ANDROID__
+  // Don't want to burn battery spinning.
+  Common::Timer::SleepUntil(wake_time, false);
+  return std::max(Common::Timer::GetCurrentValue(), wake_time);
 #else
-  Common::Timer::SleepUntil(s_next_frame_time, false);
+  const Common::Timer::Value min_margin = Common::Timer::ConvertMillisecondsToValue(MIN_THROTTLE_SLEEP_MARGIN_MS);
+  const Common::Timer::Value max_margin = Common::Timer::ConvertMillisecondsToValue(MAX_THROTTLE_SLEEP_MARGIN_MS);
+  if (s_throttle_sleep_margin == 0)
+    s_throttle_sleep_margin = max_margin;
+
+  // SleepUntil() uses a high resolution waitable timer on Windows, and an absolute clock_nanosleep() on Linux, but
+  // both can still wake us late. Sleep up to the margin, then measure how late we actually were.
+  Common::Timer::Value current_time = Common::Timer::GetCurrentValue();
+  if (wake_time > (current_time + s_throttle_sleep_margin))
+  {
+    const Common::Timer::Value sleep_until = wake_time - s_throttle_sleep_margin;
+    Common::Timer::SleepUntil(sleep_until, false);
+    current_time = Common::Timer::GetCurrentValue();
+
+    // Keep twice the overshoot to cover the odd slower wakeup. Grow straight away so the next frame isn't late, but
+    // shrink slowly so one good wakeup doesn't undo it.
+    const Common::Timer::Value overshoot = (current_time > sleep_until) ? (current_time - sleep_until) : 0;
+    const Common::Timer::Value target = std::clamp(overshoot * 2, min_margin, max_margin);
+    s_throttle_sleep_margin = (target > s_throttle_sleep_margin) ?
+                                target :
+                                (s_throttle_sleep_margin - (s_throttle_sleep_margin - target) / 16);
+  }
+
+  // Give the rest of the margin to other threads where we can, and spin once it's nearly up.
+  while (current_time < wake_time)
+  {
+    if ((wake_time - current_time) > min_margin)
+      std::this_thread::yield();
+    current_time = Common::Timer::GetCurrentValue();
+  }
+
+  return current_time;
 #endif
 }
 
+Common::Timer::Value System::GetLatePacingDelay(Common::Timer::Value period)
+{
+  // Start the frame as late as possible while still finishing within the period, going by the slowest of the last
+  // few frames.
+  const Common::Timer::Value work_time = *std::max_element(s_frame_work_times.begin(), s_frame_work_times.end()) +
+                                         Common::Timer::ConvertMillisecondsToValue(LOW_LATENCY_PACING_MARGIN_MS);
+  return (work_time < period) ? (period - work_time) : 0;
+}
+
+void System::WaitForLowLatencyPacing()
+{
+  // With vsync, presenting blocks until the swap chain releases an image at vblank, so the next vblank is roughly one
+  // host refresh after it returned.
+  const Common::Timer::Value delay = GetLatePacingDelay(s_host_frame_period);
+  if (delay > 0)
+    PreciseSleepUntil(s_last_present_time + delay);
+}
+
+void System::OnControllerRead()
+{
+  // Games usually read both ports back to back, only the first read in a frame needs to poll.
+  const bool first_read = (s_input_latch_time == 0);
+  if (first_read)
+    s_input_latch_time = Common::Timer::GetCurrentValue();
+
+  // Movies and runahead need the input to only change at frame boundaries, otherwise replaying it won't match.
+  if (InputMovie::IsActive() || s_runahead_frames > 0)
+    return;
+
+  Host::ProcessQueuedInputEvents(s_late_input_latch && first_read);
+}
+
 void System::RunFrames()
 {
   // If we're running more than this in a single loop... we're in for a bad time.
@@ -2286,12 +3132,18 @@ void System::RunFrames()
     if (value < s_next_frame_time)
       break;
 
+    // If we're far enough behind that another frame will run straight after this one, this one is never shown.
+    g_gpu->SetSkipDisplayUpdate(s_skip_presenting_frame || ((frames_run + 1) < max_frames_to_run &&
+                                                            value >= (s_next_frame_time + s_frame_period)));
+
     RunFrame();
     frames_run++;
 
     value = Common::Timer::GetCurrentValue();
   }
 
+  g_gpu->SetSkipDisplayUpdate(false);
+
   if (frames_run != 1)
     Log_VerbosePrintf("Ran %u frames in a single host frame", frames_run);
 }
@@ -2305,6 +3157,17 @@ void System::UpdatePerformanceCounters()
   s_maximum_frame_time_accumulator = std::max(s_maximum_frame_time_accumulator, frame_time);
   s_frame_time_history[s_frame_time_history_pos] = frame_time;
   s_frame_time_history_pos = (s_frame_time_history_pos + 1) % NUM_FRAME_TIME_SAMPLES;
+  AddFrameTimeHistogramSample(FrameTimeHistogram::Frame, frame_time);
+
+  if (s_cpu_thread_handle)
+  {
+    const u64 cpu_time = s_cpu_thread_handle.GetCPUTime();
+    AddFrameTimeHistogramSample(
+      FrameTimeHistogram::CPUThread,
+      static_cast<float>(static_cast<double>(cpu_time - s_histogram_last_cpu_time) * 1000.0 /
+                         static_cast<double>(Threading::GetThreadTicksPerSecond())));
+    s_histogram_last_cpu_time = cpu_time;
+  }
 
   // update fps counter
   const Common::Timer::Value now_ticks = Common::Timer::GetCurrentValue();
@@ -2346,19 +3209,38 @@ void System::UpdatePerformanceCounters()
 
   s_cpu_thread_usage = static_cast<float>(static_cast<double>(cpu_delta) * pct_divider);
   s_cpu_thread_time = static_cast<float>(static_cast<double>(cpu_delta) * time_divider);
+
+  const u64 cpu_allocations = GetThreadHeapAllocationCount();
+  s_cpu_thread_allocations_per_frame =
+    static_cast<float>(static_cast<double>(cpu_allocations - s_last_cpu_thread_allocations) / frames_run);
+  s_last_cpu_thread_allocations = cpu_allocations;
   s_sw_thread_usage = static_cast<float>(static_cast<double>(sw_delta) * pct_divider);
   s_sw_thread_time = static_cast<float>(static_cast<double>(sw_delta) * time_divider);
 
+  const GPUBackendThreadStats sw_stats = g_gpu->GetAndResetSWThreadStats();
+  s_sw_thread_wakeup_rate = static_cast<float>(sw_stats.wakeups) / time;
+  s_sw_thread_sync_stall_rate = static_cast<float>(sw_stats.sync_stalls) / time;
+  s_sw_thread_sync_stall_time = sw_stats.sync_stall_time_ms / frames_run;
+
   s_fps_timer.ResetTo(now_ticks);
 
   if (g_host_display->IsGPUTimingEnabled())
   {
     s_average_gpu_time = s_accumulated_gpu_time / static_cast<float>(std::max(s_presents_since_last_update, 1u));
     s_gpu_usage = s_accumulated_gpu_time / (time * 10.0f);
+    for (u32 i = 0; i < HostDisplay::MAX_GPU_TIMING_SCOPES; i++)
+    {
+      s_average_gpu_scope_times[i] =
+        s_accumulated_gpu_scope_times[i] / static_cast<float>(std::max(s_presents_since_last_update, 1u));
+    }
   }
   s_accumulated_gpu_time = 0.0f;
+  s_accumulated_gpu_scope_times = {};
   s_presents_since_last_update = 0;
 
+  UpdateFrameTimePercentiles();
+  s_performance_counter_update_count++;
+
   Log_VerbosePrintf("FPS: %.2f VPS: %.2f CPU: %.2f GPU: %.2f Average: %.2fms Min: %.2fms Max: %.2f ms", s_fps, s_vps,
                     s_cpu_thread_usage, s_gpu_usage, s_average_frame_time, s_minimum_frame_time, s_maximum_frame_time);
 
@@ -2371,10 +3253,12 @@ void System::ResetPerformanceCounters()
   s_last_internal_frame_number = s_internal_frame_number;
   s_last_global_tick_counter = TimingEvents::GetGlobalTickCounter();
   s_last_cpu_time = s_cpu_thread_handle ? s_cpu_thread_handle.GetCPUTime() : 0;
+  s_histogram_last_cpu_time = s_last_cpu_time;
   if (const Threading::Thread* sw_thread = g_gpu->GetSWThread(); sw_thread)
     s_last_sw_time = sw_thread->GetCPUTime();
   else
     s_last_sw_time = 0;
+  g_gpu->GetAndResetSWThreadStats();
 
   s_average_frame_time_accumulator = 0.0f;
   s_minimum_frame_time_accumulator = 0.0f;
@@ -2384,6 +3268,151 @@ void System::ResetPerformanceCounters()
   ResetThrottler();
 }
 
+void System::ResetFrameTimeHistograms()
+{
+  for (FrameTimeHistogramData& hist : s_frame_time_histograms)
+  {
+    hist.buckets.fill(0);
+    hist.samples = 0;
+    hist.percentiles = {};
+  }
+  s_histogram_last_cpu_time = s_cpu_thread_handle ? s_cpu_thread_handle.GetCPUTime() : 0;
+}
+
+void System::AddFrameTimeHistogramSample(FrameTimeHistogram histogram, float time_ms)
+{
+  FrameTimeHistogramData& hist = s_frame_time_histograms[static_cast<size_t>(histogram)];
+  const u32 bucket = static_cast<u32>(std::max(time_ms, 0.0f) / FrameTimeHistogramData::BUCKET_WIDTH_MS);
+  hist.buckets[std::min(bucket, FrameTimeHistogramData::NUM_BUCKETS - 1)]++;
+  hist.samples++;
+}
+
+void System::UpdateFrameTimePercentiles()
+{
+  static constexpr std::array<float, 4> fractions = {{0.5f, 0.95f, 0.99f, 0.999f}};
+
+  for (FrameTimeHistogramData& hist : s_frame_time_histograms)
+  {
+    std::array<float, 4> values = {};
+    if (hist.samples > 0)
+    {
+      // Walk the buckets once, reporting the upper edge of the bucket each percentile lands in.
+      u32 cumulative = 0;
+      u32 bucket = 0;
+      for (size_t i = 0; i < fractions.size(); i++)
+      {
+        const u32 target = std::max(static_cast<u32>(std::ceil(static_cast<double>(hist.samples) * fractions[i])), 1u);
+        while (bucket < FrameTimeHistogramData::NUM_BUCKETS && (cumulative + hist.buckets[bucket]) < target)
+          cumulative += hist.buckets[bucket++];
+
+        values[i] = static_cast<float>(std::min(bucket + 1, FrameTimeHistogramData::NUM_BUCKETS)) *
+                    FrameTimeHistogramData::BUCKET_WIDTH_MS;
+      }
+    }
+
+    hist.percentiles = FrameTimePercentiles{values[0], values[1], values[2], values[3]};
+  }
+}
+
+bool System::SaveFrameTimeHistograms(const char* filename /* = nullptr */)
+{
+  static constexpr std::array<const char*, static_cast<size_t>(FrameTimeHistogram::Count)> names = {
+    {"frame", "cpu_thread", "gpu", "input_latency", "throttle_jitter"}};
+
+  std::string auto_filename;
+  if (!filename)
+  {
+    const std::string& serial = GetRunningSerial();
+    if (serial.empty())
+    {
+      auto_filename =
+        Path::Combine(EmuFolders::Dumps, fmt::format("frametimes_{}.csv", GetTimestampStringForFileName()));
+    }
+    else
+    {
+      auto_filename =
+        Path::Combine(EmuFolders::Dumps, fmt::format("frametimes_{}_{}.csv", serial, GetTimestampStringForFileName()));
+    }
+
+    filename = auto_filename.c_str();
+  }
+
+  auto fp = FileSystem::OpenManagedCFile(filename, "wb");
+  if (!fp)
+  {
+    Host::AddFormattedOSDMessage(10.0f, Host::TranslateString("OSDMessage", "Failed to save frame times to '%s'."),
+                                 filename);
+    return false;
+  }
+
+  UpdateFrameTimePercentiles();
+
+  if (StringUtil::EndsWithNoCase(filename, ".json"))
+  {
+    std::fprintf(fp.get(), "{\n  \"bucket_width_ms\": %.1f", FrameTimeHistogramData::BUCKET_WIDTH_MS);
+    for (size_t i = 0; i < s_frame_time_histograms.size(); i++)
+    {
+      const FrameTimeHistogramData& hist = s_frame_time_histograms[i];
+      std::fprintf(fp.get(),
+                   ",\n  \"%s\": {\n    \"samples\": %u,\n    \"p50\": %.1f,\n    \"p95\": %.1f,\n"
+                   "    \"p99\": %.1f,\n    \"p99.9\": %.1f,\n    \"buckets\": {",
+                   names[i], hist.samples, hist.percentiles.p50, hist.percentiles.p95, hist.percentiles.p99,
+                   hist.percentiles.p999);
+
+      bool first = true;
+      for (u32 j = 0; j < FrameTimeHistogramData::NUM_BUCKETS; j++)
+      {
+        if (hist.buckets[j] == 0)
+          continue;
+
+        std::fprintf(fp.get(), "%s\"%.1f\": %u", first ? "" : ", ",
+                     static_cast<float>(j) * FrameTimeHistogramData::BUCKET_WIDTH_MS, hist.buckets[j]);
+        first = false;
+      }
+      std::fputs("}\n  }", fp.get());
+    }
+    std::fputs("\n}\n", fp.get());
+  }
+  else
+  {
+    // Percentiles first, then the count in each bucket, keyed by the bucket's lower edge in milliseconds.
+    std::fputs("ms", fp.get());
+    for (const char* name : names)
+      std::fprintf(fp.get(), ",%s", name);
+    std::fputc('\n', fp.get());
+
+    static constexpr std::array<const char*, 4> percentile_names = {{"p50", "p95", "p99", "p99.9"}};
+    for (size_t i = 0; i < percentile_names.size(); i++)
+    {
+      std::fputs(percentile_names[i], fp.get());
+      for (const FrameTimeHistogramData& hist : s_frame_time_histograms)
+      {
+        const std::array<float, 4> values = {
+          {hist.percentiles.p50, hist.percentiles.p95, hist.percentiles.p99, hist.percentiles.p999}};
+        std::fprintf(fp.get(), ",%.1f", values[i]);
+      }
+      std::fputc('\n', fp.get());
+    }
+
+    for (u32 j = 0; j < FrameTimeHistogramData::NUM_BUCKETS; j++)
+    {
+      if (std::none_of(s_frame_time_histograms.begin(), s_frame_time_histograms.end(),
+                       [j](const FrameTimeHistogramData& hist) { return hist.buckets[j] != 0; }))
+      {
+        continue;
+      }
+
+      std::fprintf(fp.get(), "%.1f", static_cast<float>(j) * FrameTimeHistogramData::BUCKET_WIDTH_MS);
+      for (const FrameTimeHistogramData& hist : s_frame_time_histograms)
+        std::fprintf(fp.get(), ",%u", hist.buckets[j]);
+      std::fputc('\n', fp.get());
+    }
+  }
+
+  Host::AddFormattedOSDMessage(5.0f, Host::TranslateString("OSDMessage", "Frame times saved to '%s'."), filename);
+  return true;
+}
+
 void System::UpdateSpeedLimiterState()
 {
   const float old_target_speed = s_target_speed;
@@ -2394,10 +3423,14 @@ void System::UpdateSpeedLimiterState()
   s_display_all_frames = !s_throttler_enabled || g_settings.display_all_frames;
 
   s_syncing_to_host = false;
+  s_low_latency_pacing = false;
+  s_late_input_latch = g_settings.display_late_input_latch;
+  s_frame_work_times.fill(0);
+
+  float host_refresh_rate = 0.0f;
   if (g_settings.sync_to_host_refresh_rate && (g_settings.audio_stretch_mode != AudioStretchMode::Off) &&
       s_target_speed == 1.0f && IsValid())
   {
-    float host_refresh_rate;
     if (g_host_display->GetHostRefreshRate(&host_refresh_rate))
     {
       const float ratio = host_refresh_rate / System::GetThrottleFrequency();
@@ -2414,6 +3447,13 @@ void System::UpdateSpeedLimiterState()
   {
     Log_InfoPrintf("Using host vsync for throttling.");
     s_throttler_enabled = false;
+
+    if (g_settings.display_low_latency_pacing || s_late_input_latch)
+    {
+      Log_InfoPrintf("Using low latency frame pacing.");
+      s_low_latency_pacing = true;
+      s_host_frame_period = Common::Timer::ConvertSecondsToValue(1.0 / static_cast<double>(host_refresh_rate));
+    }
   }
 
   Log_VerbosePrintf("Target speed: %f%%", s_target_speed * 100.0f);
@@ -2426,7 +3466,9 @@ void System::UpdateSpeedLimiterState()
 
     // Adjust nominal rate when resampling, or syncing to host.
     const bool rate_adjust =
-      (s_syncing_to_host || g_settings.audio_stretch_mode == AudioStretchMode::Resample) && s_target_speed > 0.0f;
+      (s_syncing_to_host || g_settings.audio_stretch_mode == AudioStretchMode::Resample ||
+       g_settings.audio_stretch_mode == AudioStretchMode::RateControl) &&
+      s_target_speed > 0.0f;
     stream->SetNominalRate(rate_adjust ? s_target_speed : 1.0f);
 
     if (old_target_speed < s_target_speed)
@@ -2448,7 +3490,19 @@ void System::UpdateDisplaySync()
 {
   const bool video_sync_enabled = ShouldUseVSync();
   const bool syncing_to_host_vsync = (s_syncing_to_host && video_sync_enabled && s_display_all_frames);
-  const float max_display_fps = (s_throttler_enabled || s_syncing_to_host) ? 0.0f : g_settings.display_max_fps;
+  float max_display_fps = (s_throttler_enabled || s_syncing_to_host) ? 0.0f : g_settings.display_max_fps;
+
+  // Fast forward and turbo only present as often as the host can show frames, so the speedup is bound by emulation
+  // rather than presentation and postprocessing.
+  float host_refresh_rate;
+  if ((s_fast_forward_enabled || s_turbo_enabled) && s_target_speed != 1.0f)
+  {
+    if (!g_host_display->GetHostRefreshRate(&host_refresh_rate) || host_refresh_rate <= 0.0f)
+      host_refresh_rate = 60.0f;
+
+    max_display_fps = (max_display_fps > 0.0f) ? std::min(max_display_fps, host_refresh_rate) : host_refresh_rate;
+  }
+
   Log_VerbosePrintf("Using vsync: %s%s", video_sync_enabled ? "YES" : "NO",
                     syncing_to_host_vsync ? " (for throttling)" : "");
   Log_VerbosePrintf("Max display fps: %f (%s)", max_display_fps,
@@ -2627,6 +3681,111 @@ bool System::LoadEXE(const char* filename)
   return LoadEXEToRAM(filename, true);
 }
 
+std::string System::GetEXEBootSnapshotPath(bool psf)
+{
+  // RAM size and the TTY patch change what the kernel sets up, PSFs run without memory cards.
+  const char* ram_suffix = g_settings.enable_8mb_ram ? "_8mb" : "";
+  const char* tty_suffix = g_settings.bios_patch_tty_enable ? "_tty" : "";
+  return Path::Combine(EmuFolders::Cache, fmt::format("exeboot_{}{}{}{}.cache", s_bios_hash.ToString(), ram_suffix,
+                                                      tty_suffix, psf ? "_psf" : ""));
+}
+
+bool System::LoadEXEBootSnapshot(const std::string& path)
+{
+  std::unique_ptr<ByteStream> stream(
+    ByteStream::OpenFile(path.c_str(), BYTESTREAM_OPEN_READ | BYTESTREAM_OPEN_STREAMED));
+  if (!stream)
+  {
+    Log_InfoPrintf("No EXE boot snapshot at '%s', running the BIOS startup.", path.c_str());
+    return false;
+  }
+
+  u32 signature, version, compressed_size;
+  if (!stream->ReadU32(&signature) || !stream->ReadU32(&version) || !stream->ReadU32(&compressed_size) ||
+      signature != EXE_BOOT_SNAPSHOT_SIGNATURE || version != SAVE_STATE_VERSION)
+  {
+    Log_WarningPrintf("EXE boot snapshot '%s' is corrupted or out of date, recreating.", path.c_str());
+    return false;
+  }
+
+  std::unique_ptr<ByteStream> dstream(ByteStream::CreateZstdDecompressStream(stream.get(), compressed_size));
+  StateWrapper sw(dstream.get(), StateWrapper::Mode::Read, version);
+  if (!DoState(sw, nullptr, false, true))
+  {
+    // whatever was read has to be thrown away
+    Log_WarningPrintf("Failed to load EXE boot snapshot '%s', recreating.", path.c_str());
+    InternalReset();
+    return false;
+  }
+
+  Log_InfoPrintf("Restored EXE boot snapshot from '%s'.", path.c_str());
+  return true;
+}
+
+bool System::SaveEXEBootSnapshot(const std::string& path)
+{
+  // compressed up front, since the size goes in the header
+  std::unique_ptr<GrowableMemoryByteStream> data(ByteStream::CreateGrowableMemoryStream());
+  {
+    std::unique_ptr<ByteStream> cstream(ByteStream::CreateZstdCompressStream(data.get(), 0));
+    StateWrapper sw(cstream.get(), StateWrapper::Mode::Write, SAVE_STATE_VERSION);
+    if (!DoState(sw, nullptr, false, true) || !cstream->Commit())
+    {
+      Log_ErrorPrintf("Failed to create EXE boot snapshot.");
+      return false;
+    }
+  }
+
+  std::unique_ptr<ByteStream> stream(
+    ByteStream::OpenFile(path.c_str(), BYTESTREAM_OPEN_CREATE | BYTESTREAM_OPEN_WRITE | BYTESTREAM_OPEN_TRUNCATE |
+                                         BYTESTREAM_OPEN_ATOMIC_UPDATE | BYTESTREAM_OPEN_STREAMED));
+  if (!stream)
+  {
+    Log_ErrorPrintf("Failed to open EXE boot snapshot '%s' for writing.", path.c_str());
+    return false;
+  }
+
+  const u32 size = static_cast<u32>(data->GetPosition());
+  if (!stream->WriteU32(EXE_BOOT_SNAPSHOT_SIGNATURE) || !stream->WriteU32(SAVE_STATE_VERSION) ||
+      !stream->WriteU32(size) || !stream->Write2(data->GetMemoryPointer(), size) || !stream->Commit())
+  {
+    Log_ErrorPrintf("Failed to write EXE boot snapshot '%s'.", path.c_str());
+    stream->Discard();
+    return false;
+  }
+
+  Log_InfoPrintf("Saved EXE boot snapshot to '%s' (%u bytes).", path.c_str(), size);
+  return true;
+}
+
+void System::CheckForEXEBootSnapshot()
+{
+  // the patched BIOS spins in a jump to itself, so this can be either side of the delay slot
+  const u32 pc = CPU::g_state.regs.pc & CPU::PHYSICAL_MEMORY_ADDRESS_MASK;
+  const u32 halt_pc = BIOS::EXE_BOOT_ADDRESS & CPU::PHYSICAL_MEMORY_ADDRESS_MASK;
+  if (pc != halt_pc && pc != (halt_pc + sizeof(u32)))
+    return;
+
+  SaveEXEBootSnapshot(s_exe_boot_snapshot_path);
+  s_exe_boot_snapshot_path = {};
+
+  const std::string filename = std::move(s_exe_boot_snapshot_filename);
+  s_exe_boot_snapshot_filename = {};
+  const bool result = s_exe_boot_snapshot_psf ? PSFLoader::Load(filename.c_str()) : LoadEXE(filename.c_str());
+
+  // Loading replaces the halt with the jump to the executable, which the recompiler won't notice by itself.
+  // Rewinding to before this point would jump into a program which isn't there.
+  CPU::CodeCache::Flush();
+  ClearMemorySaveStates();
+
+  if (!result)
+  {
+    Host::ReportFormattedErrorAsync("Error", "Failed to load %s file '%s'", s_exe_boot_snapshot_psf ? "PSF" : "EXE",
+                                    filename.c_str());
+    Host::RequestSystemShutdown(false, false);
+  }
+}
+
 bool System::InjectEXEFromBuffer(const void* buffer, u32 buffer_size, bool patch_bios)
 {
   const u8* buffer_ptr = static_cast<const u8*>(buffer);
@@ -2979,6 +4138,27 @@ bool System::DumpSPURAM(const char* filename)
   return FileSystem::WriteBinaryFile(filename, SPU::GetRAM().data(), SPU::RAM_SIZE);
 }
 
+u64 System::GetStateHash()
+{
+  if (!IsValid())
+    return 0;
+
+  // Each region seeds the next, so a difference anywhere changes the result. Only architectural CPU state is
+  // included, since bookkeeping such as the current instruction isn't maintained by every execution mode.
+  u64 hash = XXH3_64bits(Bus::g_ram, Bus::g_ram_size);
+  hash = XXH3_64bits_withSeed(CPU::g_state.dcache.data(), CPU::DCACHE_SIZE, hash);
+  hash = XXH3_64bits_withSeed(SPU::GetRAM().data(), SPU::RAM_SIZE, hash);
+  hash = XXH3_64bits_withSeed(&CPU::g_state.regs, sizeof(CPU::g_state.regs), hash);
+  hash = XXH3_64bits_withSeed(&CPU::g_state.cop0_regs, sizeof(CPU::g_state.cop0_regs), hash);
+  hash = XXH3_64bits_withSeed(&CPU::g_state.gte_regs, sizeof(CPU::g_state.gte_regs), hash);
+
+  const u64 vram_hash = g_gpu->GetVRAMHash();
+  const u64 events_hash = TimingEvents::GetStateHash();
+  hash = XXH3_64bits_withSeed(&vram_hash, sizeof(vram_hash), hash);
+  hash = XXH3_64bits_withSeed(&events_hash, sizeof(events_hash), hash);
+  return hash;
+}
+
 bool System::HasMedia()
 {
   return CDROM::HasMedia();
@@ -3083,6 +4263,8 @@ void System::UpdateRunningGame(const char* path, CDImage* image, bool booting)
   UpdateGameSettingsLayer();
   ApplySettings(true);
 
+  CPU::CodeCache::LoadBlockCache(s_running_game_serial);
+
   s_cheat_list.reset();
   if (g_settings.auto_load_cheats && !Achievements::ChallengeModeActive())
     LoadCheatListFromGameTitle();
@@ -3241,6 +4423,9 @@ void System::CheckForSettingsChanges(const Settings& old_settings)
   {
     ClearMemorySaveStates();
 
+    if (g_settings.thread_affinity_policy != old_settings.thread_affinity_policy)
+      UpdateThreadAffinityPolicy();
+
     if (g_settings.cpu_overclock_active != old_settings.cpu_overclock_active ||
         (g_settings.cpu_overclock_active &&
          (g_settings.cpu_overclock_numerator != old_settings.cpu_overclock_numerator ||
@@ -3263,6 +4448,8 @@ void System::CheckForSettingsChanges(const Settings& old_settings)
     }
     if (g_settings.audio_stretch_mode != old_settings.audio_stretch_mode)
       SPU::GetOutputStream()->SetStretchMode(g_settings.audio_stretch_mode);
+    if (g_settings.audio_stretch_thread != old_settings.audio_stretch_thread)
+      SPU::GetOutputStream()->SetStretchThreaded(g_settings.audio_stretch_thread);
     if (g_settings.audio_buffer_ms != old_settings.audio_buffer_ms ||
         g_settings.audio_output_latency_ms != old_settings.audio_output_latency_ms ||
         g_settings.audio_stretch_mode != old_settings.audio_stretch_mode)
@@ -3274,6 +4461,21 @@ void System::CheckForSettingsChanges(const Settings& old_settings)
     if (g_settings.emulation_speed != old_settings.emulation_speed)
       UpdateThrottlePeriod();
 
+    if (g_settings.mdec_decode_thread != old_settings.mdec_decode_thread)
+      MDEC::UpdateDecodeThread();
+
+    if (g_settings.debugging.count_io_accesses != old_settings.debugging.count_io_accesses ||
+        g_settings.debugging.show_io_access_counts != old_settings.debugging.show_io_access_counts)
+    {
+      Bus::UpdateIOAccessCounting();
+    }
+
+    if (g_settings.debugging.profile_cpu != old_settings.debugging.profile_cpu ||
+        g_settings.debugging.show_cpu_profile != old_settings.debugging.show_cpu_profile)
+    {
+      CPU::CodeCache::UpdateProfiling();
+    }
+
     if (g_settings.cpu_execution_mode != old_settings.cpu_execution_mode ||
         g_settings.cpu_fastmem_mode != old_settings.cpu_fastmem_mode)
     {
@@ -3281,6 +4483,7 @@ void System::CheckForSettingsChanges(const Settings& old_settings)
                                    Host::TranslateString("CPUExecutionMode", Settings::GetCPUExecutionModeDisplayName(
                                                                                g_settings.cpu_execution_mode))
                                      .GetCharArray());
+      UpdateRAMDirtyTracking();
       CPU::CodeCache::Reinitialize();
       CPU::ClearICache();
     }
@@ -3288,14 +4491,20 @@ void System::CheckForSettingsChanges(const Settings& old_settings)
     if (g_settings.cpu_execution_mode == CPUExecutionMode::Recompiler &&
         (g_settings.cpu_recompiler_memory_exceptions != old_settings.cpu_recompiler_memory_exceptions ||
          g_settings.cpu_recompiler_block_linking != old_settings.cpu_recompiler_block_linking ||
-         g_settings.cpu_recompiler_icache != old_settings.cpu_recompiler_icache))
+         g_settings.cpu_recompiler_icache != old_settings.cpu_recompiler_icache ||
+         g_settings.cpu_recompiler_async_compile != old_settings.cpu_recompiler_async_compile ||
+         g_settings.cpu_recompiler_tier_threshold != old_settings.cpu_recompiler_tier_threshold ||
+         g_settings.cpu_idle_loop_skipping != old_settings.cpu_idle_loop_skipping))
     {
       Host::AddOSDMessage(Host::TranslateStdString("OSDMessage", "Recompiler options changed, flushing all blocks."),
                           5.0f);
 
       // changing memory exceptions can re-enable fastmem
       if (g_settings.cpu_recompiler_memory_exceptions != old_settings.cpu_recompiler_memory_exceptions)
+      {
+        UpdateRAMDirtyTracking();
         CPU::CodeCache::Reinitialize();
+      }
       else
         CPU::CodeCache::Flush();
 
@@ -3306,19 +4515,26 @@ void System::CheckForSettingsChanges(const Settings& old_settings)
     SPU::GetOutputStream()->SetOutputVolume(GetAudioOutputVolume());
 
     if (g_settings.gpu_resolution_scale != old_settings.gpu_resolution_scale ||
+        g_settings.gpu_dynamic_resolution != old_settings.gpu_dynamic_resolution ||
+        g_settings.gpu_dynamic_resolution_min_scale != old_settings.gpu_dynamic_resolution_min_scale ||
         g_settings.gpu_multisamples != old_settings.gpu_multisamples ||
         g_settings.gpu_per_sample_shading != old_settings.gpu_per_sample_shading ||
         g_settings.gpu_use_thread != old_settings.gpu_use_thread ||
+        g_settings.gpu_sw_worker_threads != old_settings.gpu_sw_worker_threads ||
+        g_settings.gpu_use_render_thread != old_settings.gpu_use_render_thread ||
         g_settings.gpu_use_software_renderer_for_readbacks != old_settings.gpu_use_software_renderer_for_readbacks ||
         g_settings.gpu_fifo_size != old_settings.gpu_fifo_size ||
         g_settings.gpu_max_run_ahead != old_settings.gpu_max_run_ahead ||
         g_settings.gpu_true_color != old_settings.gpu_true_color ||
         g_settings.gpu_scaled_dithering != old_settings.gpu_scaled_dithering ||
         g_settings.gpu_texture_filter != old_settings.gpu_texture_filter ||
+        g_settings.gpu_adaptive_texture_filtering != old_settings.gpu_adaptive_texture_filtering ||
         g_settings.gpu_disable_interlacing != old_settings.gpu_disable_interlacing ||
         g_settings.gpu_force_ntsc_timings != old_settings.gpu_force_ntsc_timings ||
         g_settings.gpu_24bit_chroma_smoothing != old_settings.gpu_24bit_chroma_smoothing ||
         g_settings.gpu_downsample_mode != old_settings.gpu_downsample_mode ||
+        g_settings.gpu_downsample_compute != old_settings.gpu_downsample_compute ||
+        g_settings.gpu_shader_mode != old_settings.gpu_shader_mode ||
         g_settings.display_crop_mode != old_settings.display_crop_mode ||
         g_settings.display_aspect_ratio != old_settings.display_aspect_ratio ||
         g_settings.display_alignment != old_settings.display_alignment ||
@@ -3382,6 +4598,7 @@ void System::CheckForSettingsChanges(const Settings& old_settings)
     if (g_settings.rewind_enable != old_settings.rewind_enable ||
         g_settings.rewind_save_frequency != old_settings.rewind_save_frequency ||
         g_settings.rewind_save_slots != old_settings.rewind_save_slots ||
+        g_settings.rewind_native_vram != old_settings.rewind_native_vram ||
         g_settings.runahead_frames != old_settings.runahead_frames)
     {
       UpdateMemorySaveStateSettings();
@@ -3389,7 +4606,9 @@ void System::CheckForSettingsChanges(const Settings& old_settings)
 
     if (g_settings.texture_replacements.enable_vram_write_replacements !=
           old_settings.texture_replacements.enable_vram_write_replacements ||
-        g_settings.texture_replacements.preload_textures != old_settings.texture_replacements.preload_textures)
+        g_settings.texture_replacements.preload_textures != old_settings.texture_replacements.preload_textures ||
+        g_settings.texture_replacements.async_loading != old_settings.texture_replacements.async_loading ||
+        g_settings.texture_replacements.max_cache_size_mb != old_settings.texture_replacements.max_cache_size_mb)
     {
       g_texture_replacements.Reload();
     }
@@ -3399,17 +4618,21 @@ void System::CheckForSettingsChanges(const Settings& old_settings)
 
     if (g_settings.audio_backend != old_settings.audio_backend ||
         g_settings.video_sync_enabled != old_settings.video_sync_enabled ||
+        g_settings.display_triple_buffering != old_settings.display_triple_buffering ||
         g_settings.increase_timer_resolution != old_settings.increase_timer_resolution ||
         g_settings.emulation_speed != old_settings.emulation_speed ||
         g_settings.fast_forward_speed != old_settings.fast_forward_speed ||
         g_settings.display_max_fps != old_settings.display_max_fps ||
         g_settings.display_all_frames != old_settings.display_all_frames ||
+        g_settings.display_low_latency_pacing != old_settings.display_low_latency_pacing ||
+        g_settings.display_late_input_latch != old_settings.display_late_input_latch ||
         g_settings.sync_to_host_refresh_rate != old_settings.sync_to_host_refresh_rate)
     {
       UpdateSpeedLimiterState();
     }
 
     if (g_settings.display_post_processing != old_settings.display_post_processing ||
+        g_settings.display_post_process_fusion != old_settings.display_post_process_fusion ||
         g_settings.display_post_process_chain != old_settings.display_post_process_chain)
     {
       if (g_settings.display_post_processing && !g_settings.display_post_process_chain.empty())
@@ -3450,17 +4673,23 @@ void System::CheckForSettingsChanges(const Settings& old_settings)
     UpdateMultitaps();
 }
 
-void System::CalculateRewindMemoryUsage(u32 num_saves, u64* ram_usage, u64* vram_usage)
+void System::CalculateRewindMemoryUsage(u32 num_saves, bool native_vram, u64* ram_usage, u64* vram_usage)
 {
+  // native VRAM is already accounted for in the state size
+  const u64 resolution_scale = std::max(g_settings.gpu_resolution_scale, 1u);
   *ram_usage = MAX_SAVE_STATE_SIZE * static_cast<u64>(num_saves);
-  *vram_usage = (VRAM_WIDTH * VRAM_HEIGHT * 4) * static_cast<u64>(std::max(g_settings.gpu_resolution_scale, 1u)) *
-                static_cast<u64>(g_settings.gpu_multisamples) * static_cast<u64>(num_saves);
+  *vram_usage = native_vram ? 0 :
+                              ((VRAM_WIDTH * VRAM_HEIGHT * 4) * resolution_scale * resolution_scale *
+                               static_cast<u64>(g_settings.gpu_multisamples) * static_cast<u64>(num_saves));
 }
 
 void System::ClearMemorySaveStates()
 {
+  CancelRewindCompression(nullptr);
   s_rewind_states.clear();
+  s_rewind_spare_stream.reset();
   s_runahead_states.clear();
+  s_runahead_spare_states.clear();
 }
 
 void System::UpdateMemorySaveStateSettings()
@@ -3475,15 +4704,19 @@ void System::UpdateMemorySaveStateSettings()
     s_rewind_save_counter = 0;
 
     u64 ram_usage, vram_usage;
-    CalculateRewindMemoryUsage(g_settings.rewind_save_slots, &ram_usage, &vram_usage);
+    CalculateRewindMemoryUsage(g_settings.rewind_save_slots, g_settings.rewind_native_vram, &ram_usage, &vram_usage);
     Log_InfoPrintf(
       "Rewind is enabled, saving every %d frames, with %u slots and %" PRIu64 "MB RAM and %" PRIu64 "MB VRAM usage",
       std::max(s_rewind_save_frequency, 1), g_settings.rewind_save_slots, ram_usage / 1048576, vram_usage / 1048576);
+
+    StartRewindCompressor();
   }
   else
   {
     s_rewind_save_frequency = -1;
     s_rewind_save_counter = -1;
+
+    StopRewindCompressor();
   }
 
   s_rewind_load_frequency = -1;
@@ -3493,6 +4726,25 @@ void System::UpdateMemorySaveStateSettings()
   s_runahead_replay_pending = false;
   if (s_runahead_frames > 0)
     Log_InfoPrintf("Runahead is active with %u frames", s_runahead_frames);
+
+  UpdateRAMDirtyTracking();
+}
+
+void System::UpdateRAMDirtyTracking()
+{
+  // only runahead rewrites the same memory states, and the aarch32 recompiler doesn't flag pages on fastmem stores
+  bool enabled = (s_runahead_frames > 0);
+#ifdef CPU_AARCH32
+  enabled = enabled && !g_settings.IsUsingFastmem();
+#endif
+  if (enabled == Bus::IsRAMDirtyTrackingEnabled())
+    return;
+
+  Bus::SetRAMDirtyTracking(enabled);
+
+  // blocks compiled with the previous setting are missing the page flagging, or have it unnecessarily
+  if (g_settings.IsUsingRecompiler())
+    CPU::CodeCache::Flush();
 }
 
 bool System::LoadMemoryState(const MemorySaveState& mss)
@@ -3501,7 +4753,7 @@ bool System::LoadMemoryState(const MemorySaveState& mss)
 
   StateWrapper sw(mss.state_stream.get(), StateWrapper::Mode::Read, SAVE_STATE_VERSION);
   GPUTexture* host_texture = mss.vram_texture.get();
-  if (!DoState(sw, &host_texture, true, true))
+  if (!DoState(sw, mss.native_vram ? nullptr : &host_texture, true, true))
   {
     Host::ReportErrorAsync("Error", "Failed to load memory save state, resetting.");
     InternalReset();
@@ -3511,16 +4763,31 @@ bool System::LoadMemoryState(const MemorySaveState& mss)
   return true;
 }
 
-bool System::SaveMemoryState(MemorySaveState* mss)
+bool System::SaveMemoryState(MemorySaveState* mss, std::vector<u32>* section_offsets /* = nullptr */)
 {
   if (!mss->state_stream)
+  {
     mss->state_stream = std::make_unique<GrowableMemoryByteStream>(nullptr, MAX_SAVE_STATE_SIZE);
+  }
   else
+  {
+    // not truncated, so RAM pages which haven't changed since this stream was last written can be left alone
     mss->state_stream->SeekAbsolute(0);
+  }
 
-  GPUTexture* host_texture = mss->vram_texture.release();
+  // a texture left over from a recycled slot is freed below if the state is native resolution
+  GPUTexture* host_texture = mss->native_vram ? nullptr : mss->vram_texture.release();
   StateWrapper sw(mss->state_stream.get(), StateWrapper::Mode::Write, SAVE_STATE_VERSION);
-  if (!DoState(sw, &host_texture, false, true))
+  if (section_offsets)
+  {
+    section_offsets->clear();
+    sw.SetMarkerOffsets(section_offsets);
+  }
+
+  Bus::SetMemoryStateRAMSnapshot(Bus::IsRAMDirtyTrackingEnabled() ? &mss->ram_snapshot : nullptr);
+  const bool result = DoState(sw, mss->native_vram ? nullptr : &host_texture, false, true);
+  Bus::SetMemoryStateRAMSnapshot(nullptr);
+  if (!result)
   {
     Log_ErrorPrint("Failed to create rewind state.");
     delete host_texture;
@@ -3537,33 +4804,321 @@ bool System::SaveRewindState()
   Common::Timer save_timer;
 #endif
 
-  // try to reuse the frontmost slot
+  // try to reuse the frontmost slot's texture, and the buffer of the state which is about to become a delta
   const u32 save_slots = g_settings.rewind_save_slots;
-  MemorySaveState mss;
+  RewindSaveState rss;
   while (s_rewind_states.size() >= save_slots)
   {
-    mss = std::move(s_rewind_states.front());
+    CancelRewindCompression(&s_rewind_states.front());
+    rss.mss.vram_texture = std::move(s_rewind_states.front().mss.vram_texture);
     s_rewind_states.pop_front();
   }
 
-  if (!SaveMemoryState(&mss))
+  rss.mss.state_stream = std::move(s_rewind_spare_stream);
+  rss.mss.native_vram = g_settings.rewind_native_vram;
+  if (!SaveMemoryState(&rss.mss, &rss.section_offsets))
     return false;
 
-  s_rewind_states.push_back(std::move(mss));
+  rss.state_size = static_cast<u32>(rss.mss.state_stream->GetPosition());
+
+  if (!s_rewind_states.empty())
+  {
+    RewindSaveState& prev = s_rewind_states.back();
+    EncodeRewindDelta(&prev, rss);
+    s_rewind_spare_stream = std::move(prev.mss.state_stream);
+    QueueRewindCompression(&prev);
+  }
+
+  s_rewind_states.push_back(std::move(rss));
 
 #ifdef PROFILE_MEMORY_SAVE_STATES
-  Log_DevPrintf("Saved rewind state (%" PRIu64 " bytes, took %.4f ms)", s_rewind_states.back().state_stream->GetSize(),
-                save_timer.GetTimeMilliseconds());
+  if (s_rewind_states.size() > 1)
+  {
+    const RewindSaveState& prev = s_rewind_states[s_rewind_states.size() - 2];
+    Log_DevPrintf("Saved rewind state (%u bytes, previous delta %zu bytes, took %.4f ms)",
+                  s_rewind_states.back().state_size,
+                  prev.delta_literals_size + prev.delta_runs.size() * sizeof(RewindDeltaRun),
+                  save_timer.GetTimeMilliseconds());
+  }
 #endif
 
   return true;
 }
 
+void System::EncodeRewindDelta(RewindSaveState* rss, const RewindSaveState& next)
+{
+  const u8* old_data = rss->mss.state_stream->GetMemoryPointer();
+  const u8* new_data = next.mss.state_stream->GetMemoryPointer();
+
+  rss->delta_runs.clear();
+  rss->delta_literals.clear();
+
+  // runs are always added in order, so neighbouring literals can be merged, as can copies of adjacent source data
+  const auto add_copy = [rss](u32 source_offset, u32 length) {
+    if (!rss->delta_runs.empty() && rss->delta_runs.back().source_offset != REWIND_DELTA_LITERAL &&
+        (rss->delta_runs.back().source_offset + rss->delta_runs.back().length) == source_offset)
+    {
+      rss->delta_runs.back().length += length;
+    }
+    else
+    {
+      rss->delta_runs.push_back(RewindDeltaRun{source_offset, length});
+    }
+  };
+  const auto add_literal = [rss, old_data](u32 offset, u32 length) {
+    if (!rss->delta_runs.empty() && rss->delta_runs.back().source_offset == REWIND_DELTA_LITERAL)
+      rss->delta_runs.back().length += length;
+    else
+      rss->delta_runs.push_back(RewindDeltaRun{REWIND_DELTA_LITERAL, length});
+
+    rss->delta_literals.insert(rss->delta_literals.end(), old_data + offset, old_data + offset + length);
+  };
+
+  // Variable-sized data such as FIFOs moves everything after it, so the states are lined up at each marker. Within a
+  // section, pages are looked for both from the start and the end, since e.g. SPU RAM follows the transfer FIFO.
+  const u32 num_sections = (rss->section_offsets.size() == next.section_offsets.size()) ?
+                             (static_cast<u32>(rss->section_offsets.size()) + 1) :
+                             1;
+  for (u32 section = 0; section < num_sections; section++)
+  {
+    const u32 old_start = (section > 0) ? rss->section_offsets[section - 1] : 0;
+    const u32 old_end = (section < (num_sections - 1)) ? rss->section_offsets[section] : rss->state_size;
+    const u32 new_start = (section > 0) ? next.section_offsets[section - 1] : 0;
+    const u32 new_end = (section < (num_sections - 1)) ? next.section_offsets[section] : next.state_size;
+    const u32 new_length = new_end - new_start;
+    bool from_end = false;
+
+    for (u32 offset = old_start; offset < old_end; offset += REWIND_DELTA_PAGE_SIZE)
+    {
+      const u32 length = std::min(old_end - offset, REWIND_DELTA_PAGE_SIZE);
+      const bool start_valid = ((offset - old_start) + length) <= new_length;
+      const bool end_valid = (old_end - offset) <= new_length;
+      const u32 start_source = new_start + (offset - old_start);
+      const u32 end_source = new_end - (old_end - offset);
+      if (start_valid && std::memcmp(old_data + offset, new_data + start_source, length) == 0)
+      {
+        add_copy(start_source, length);
+        from_end = false;
+        continue;
+      }
+      else if (end_valid && std::memcmp(old_data + offset, new_data + end_source, length) == 0)
+      {
+        add_copy(end_source, length);
+        from_end = true;
+        continue;
+      }
+
+      // dirty page, compare it in chunks against wherever the last clean page in this section lined up
+      u32 source;
+      if (end_valid && (from_end || !start_valid))
+        source = end_source;
+      else if (start_valid)
+        source = start_source;
+      else
+      {
+        add_literal(offset, length);
+        continue;
+      }
+
+      for (u32 pos = 0; pos < length; pos += REWIND_DELTA_CHUNK_SIZE)
+      {
+        const u32 chunk_length = std::min(length - pos, REWIND_DELTA_CHUNK_SIZE);
+        if (std::memcmp(old_data + offset + pos, new_data + source + pos, chunk_length) == 0)
+          add_copy(source + pos, chunk_length);
+        else
+          add_literal(offset + pos, chunk_length);
+      }
+    }
+  }
+
+  rss->delta_runs.shrink_to_fit();
+  rss->delta_literals.shrink_to_fit();
+  rss->delta_literals_size = static_cast<u32>(rss->delta_literals.size());
+  rss->delta_compressed = false;
+}
+
+bool System::DecodeRewindDelta(RewindSaveState* rss, const RewindSaveState& next)
+{
+  CancelRewindCompression(rss);
+  if (rss->delta_compressed)
+  {
+    std::vector<u8> literals(rss->delta_literals_size);
+    std::unique_ptr<ByteStream> dstream =
+      ByteStream::CreateZstdDecompressStream(rss->delta_literals.data(), static_cast<u32>(rss->delta_literals.size()));
+    if (!dstream->Read2(literals.data(), rss->delta_literals_size))
+    {
+      Log_ErrorPrint("Failed to decompress rewind state.");
+      return false;
+    }
+
+    rss->delta_literals = std::move(literals);
+    rss->delta_compressed = false;
+  }
+
+  std::unique_ptr<GrowableMemoryByteStream> stream = std::move(s_rewind_spare_stream);
+  if (!stream)
+    stream = std::make_unique<GrowableMemoryByteStream>(nullptr, MAX_SAVE_STATE_SIZE);
+
+  stream->Resize(rss->state_size);
+
+  u8* dst = stream->GetMemoryPointer();
+  const u8* src = next.mss.state_stream->GetMemoryPointer();
+  const u8* literals = rss->delta_literals.data();
+  for (const RewindDeltaRun& run : rss->delta_runs)
+  {
+    if (run.source_offset == REWIND_DELTA_LITERAL)
+    {
+      std::memcpy(dst, literals, run.length);
+      literals += run.length;
+    }
+    else
+    {
+      std::memcpy(dst, src + run.source_offset, run.length);
+    }
+
+    dst += run.length;
+  }
+
+  rss->mss.state_stream = std::move(stream);
+  rss->delta_runs = {};
+  rss->delta_literals = {};
+  return true;
+}
+
+void System::PopRewindState()
+{
+  RewindSaveState rss = std::move(s_rewind_states.back());
+  s_rewind_states.pop_back();
+
+  // the new newest state has to be rebuilt before the state it was based on is gone, and everything before it is
+  // unusable if that fails
+  if (!s_rewind_states.empty() && !DecodeRewindDelta(&s_rewind_states.back(), rss))
+  {
+    CancelRewindCompression(nullptr);
+    s_rewind_states.clear();
+  }
+
+  s_rewind_spare_stream = std::move(rss.mss.state_stream);
+}
+
+void System::StartRewindCompressor()
+{
+  if (s_rewind_compress_running)
+    return;
+
+  s_rewind_compress_shutdown = false;
+  if (!s_rewind_compress_thread.Start(RewindCompressorThread))
+  {
+    Log_ErrorPrint("Failed to start rewind compression thread, rewind states will not be compressed.");
+    return;
+  }
+
+  s_rewind_compress_running = true;
+}
+
+void System::StopRewindCompressor()
+{
+  if (!s_rewind_compress_running)
+    return;
+
+  {
+    std::unique_lock<std::mutex> lock(s_rewind_compress_mutex);
+    s_rewind_compress_queue.clear();
+    s_rewind_compress_shutdown = true;
+    s_rewind_compress_work_cv.notify_one();
+  }
+
+  s_rewind_compress_thread.Join();
+  s_rewind_compress_running = false;
+}
+
+void System::RewindCompressorThread()
+{
+  Threading::SetNameOfCurrentThread("Rewind Compression Thread");
+  Threading::ApplyAffinityPolicy(Threading::AffinityClass::Background);
+
+  std::unique_lock<std::mutex> lock(s_rewind_compress_mutex);
+  for (;;)
+  {
+    s_rewind_compress_work_cv.wait(lock,
+                                   []() { return s_rewind_compress_shutdown || !s_rewind_compress_queue.empty(); });
+    if (s_rewind_compress_shutdown)
+      break;
+
+    RewindSaveState* rss = s_rewind_compress_queue.front();
+    s_rewind_compress_queue.pop_front();
+    s_rewind_compress_active = rss;
+    lock.unlock();
+
+    // The CPU thread doesn't touch the state again until it's cancelled the compression, which waits for us.
+    std::unique_ptr<GrowableMemoryByteStream> compressed =
+      ByteStream::CreateGrowableMemoryStream(nullptr, rss->delta_literals_size / 2);
+    std::unique_ptr<ByteStream> cstream =
+      ByteStream::CreateZstdCompressStream(compressed.get(), REWIND_COMPRESSION_LEVEL);
+    const bool result = cstream->Write2(rss->delta_literals.data(), rss->delta_literals_size) && cstream->Commit();
+    cstream.reset();
+
+    // only keep the compressed copy if it actually saves memory
+    std::vector<u8> data;
+    if (result && compressed->GetSize() < rss->delta_literals_size)
+    {
+      data.assign(compressed->GetMemoryPointer(), compressed->GetMemoryPointer() + compressed->GetSize());
+      compressed.reset();
+    }
+
+    lock.lock();
+    if (!data.empty())
+    {
+      rss->delta_literals = std::move(data);
+      rss->delta_compressed = true;
+    }
+
+    s_rewind_compress_active = nullptr;
+    s_rewind_compress_idle_cv.notify_all();
+  }
+}
+
+void System::QueueRewindCompression(RewindSaveState* rss)
+{
+  if (!s_rewind_compress_running || rss->delta_literals_size == 0)
+    return;
+
+  std::unique_lock<std::mutex> lock(s_rewind_compress_mutex);
+  s_rewind_compress_queue.push_back(rss);
+  s_rewind_compress_work_cv.notify_one();
+}
+
+void System::CancelRewindCompression(const RewindSaveState* rss)
+{
+  if (!s_rewind_compress_running)
+    return;
+
+  // null cancels everything, for when all the states are thrown away
+  std::unique_lock<std::mutex> lock(s_rewind_compress_mutex);
+  if (!rss)
+  {
+    s_rewind_compress_queue.clear();
+    s_rewind_compress_idle_cv.wait(lock, []() { return !s_rewind_compress_active; });
+    return;
+  }
+
+  for (auto it = s_rewind_compress_queue.begin(); it != s_rewind_compress_queue.end(); ++it)
+  {
+    if (*it == rss)
+    {
+      s_rewind_compress_queue.erase(it);
+      return;
+    }
+  }
+
+  s_rewind_compress_idle_cv.wait(lock, [rss]() { return s_rewind_compress_active != rss; });
+}
+
 bool System::LoadRewindState(u32 skip_saves /*= 0*/, bool consume_state /*=true */)
 {
   while (skip_saves > 0 && !s_rewind_states.empty())
   {
-    s_rewind_states.pop_back();
+    PopRewindState();
     skip_saves--;
   }
 
@@ -3574,11 +5129,11 @@ bool System::LoadRewindState(u32 skip_saves /*= 0*/, bool consume_state /*=true
   Common::Timer load_timer;
 #endif
 
-  if (!LoadMemoryState(s_rewind_states.back()))
+  if (!LoadMemoryState(s_rewind_states.back().mss))
     return false;
 
   if (consume_state)
-    s_rewind_states.pop_back();
+    PopRewindState();
 
 #ifdef PROFILE_MEMORY_SAVE_STATES
   Log_DevPrintf("Rewind load took %.4f ms", load_timer.GetTimeMilliseconds());
@@ -3630,13 +5185,18 @@ void System::DoRewind()
 
 void System::SaveRunaheadState()
 {
-  // try to reuse the frontmost slot
+  // try to reuse the frontmost slot, or one which was thrown away by a replay
   MemorySaveState mss;
   while (s_runahead_states.size() >= s_runahead_frames)
   {
     mss = std::move(s_runahead_states.front());
     s_runahead_states.pop_front();
   }
+  if (!mss.state_stream && !s_runahead_spare_states.empty())
+  {
+    mss = std::move(s_runahead_spare_states.back());
+    s_runahead_spare_states.pop_back();
+  }
 
   if (!SaveMemoryState(&mss))
   {
@@ -3647,6 +5207,14 @@ void System::SaveRunaheadState()
   s_runahead_states.push_back(std::move(mss));
 }
 
+void System::RecycleRunaheadStates()
+{
+  // keep the buffers and textures, otherwise every replay reallocates a full set of states
+  for (MemorySaveState& mss : s_runahead_states)
+    s_runahead_spare_states.push_back(std::move(mss));
+  s_runahead_states.clear();
+}
+
 void System::DoRunahead()
 {
 #ifdef PROFILE_MEMORY_SAVE_STATES
@@ -3660,13 +5228,13 @@ void System::DoRunahead()
     s_runahead_replay_pending = false;
     if (s_runahead_states.empty() || !LoadMemoryState(s_runahead_states.front()))
     {
-      s_runahead_states.clear();
+      RecycleRunaheadStates();
       return;
     }
 
     // and throw away all the states, forcing us to catch up below
     // TODO: can we leave one frame here and run, avoiding the extra save?
-    s_runahead_states.clear();
+    RecycleRunaheadStates();
 
 #ifdef PROFILE_MEMORY_SAVE_STATES
     Log_VerbosePrintf("Rewound to frame %u, took %.2f ms", s_frame_number, timer.GetTimeMilliseconds());
@@ -3683,14 +5251,19 @@ void System::DoRunahead()
 #endif
 
     SPU::SetAudioOutputMuted(true);
+    g_gpu->SetSkipDisplayUpdate(true);
 
     while (frames_to_run > 0)
     {
+      // the last replayed frame is still drawn, since it's what the next displayed frame is built on/flipped to
+      g_gpu->SetSkipRendering(g_settings.runahead_skip_rendering && frames_to_run > 1);
       DoRunFrame();
       SaveRunaheadState();
       frames_to_run--;
     }
 
+    g_gpu->SetSkipRendering(false);
+    g_gpu->SetSkipDisplayUpdate(s_skip_presenting_frame);
     SPU::SetAudioOutputMuted(false);
 
 #ifdef PROFILE_MEMORY_SAVE_STATES
@@ -3880,6 +5453,114 @@ void System::StopDumpingAudio()
   Host::AddOSDMessage(Host::TranslateStdString("OSDMessage", "Stopped dumping audio."), 5.0f);
 }
 
+bool System::IsCapturingMedia()
+{
+  return MediaCapture::IsCapturing();
+}
+
+bool System::StartMediaCapture(const char* filename)
+{
+  if (!System::IsValid())
+    return false;
+
+  std::string auto_filename;
+  if (!filename)
+  {
+    const auto& serial = System::GetRunningSerial();
+    const char* extension = MediaCapture::GetFileExtension();
+    if (serial.empty())
+    {
+      auto_filename = Path::Combine(EmuFolders::Dumps, fmt::format("video" FS_OSPATH_SEPARATOR_STR "{}.{}",
+                                                                   GetTimestampStringForFileName(), extension));
+    }
+    else
+    {
+      auto_filename = Path::Combine(EmuFolders::Dumps, fmt::format("video" FS_OSPATH_SEPARATOR_STR "{}_{}.{}", serial,
+                                                                   GetTimestampStringForFileName(), extension));
+    }
+
+    filename = auto_filename.c_str();
+  }
+
+  if (MediaCapture::Start(filename, SPU::SAMPLE_RATE))
+  {
+    Host::AddFormattedOSDMessage(5.0f, Host::TranslateString("OSDMessage", "Started capturing media to '%s'."),
+                                 filename);
+    return true;
+  }
+  else
+  {
+    Host::AddFormattedOSDMessage(10.0f, Host::TranslateString("OSDMessage", "Failed to start capturing media to '%s'."),
+                                 filename);
+    return false;
+  }
+}
+
+void System::StopMediaCapture()
+{
+  if (!MediaCapture::IsCapturing())
+    return;
+
+  MediaCapture::Stop();
+  Host::AddFormattedOSDMessage(5.0f,
+                               Host::TranslateString("OSDMessage", "Stopped capturing media, %u frames written."),
+                               MediaCapture::GetFrameCount());
+}
+
+bool System::IsRecordingGPUDump()
+{
+  return (g_gpu && g_gpu->IsRecordingDump());
+}
+
+bool System::StartRecordingGPUDump(const char* filename /* = nullptr */, u32 num_frames /* = 0 */)
+{
+  if (!System::IsValid() || s_gpu_dump_player)
+    return false;
+
+  std::string auto_filename;
+  if (!filename)
+  {
+    const auto& serial = System::GetRunningSerial();
+    if (serial.empty())
+    {
+      auto_filename = Path::Combine(EmuFolders::Dumps, fmt::format("gpu" FS_OSPATH_SEPARATOR_STR "{}{}",
+                                                                   GetTimestampStringForFileName(),
+                                                                   GPUDump::FILE_EXTENSION));
+    }
+    else
+    {
+      auto_filename = Path::Combine(EmuFolders::Dumps, fmt::format("gpu" FS_OSPATH_SEPARATOR_STR "{}_{}{}", serial,
+                                                                   GetTimestampStringForFileName(),
+                                                                   GPUDump::FILE_EXTENSION));
+    }
+
+    filename = auto_filename.c_str();
+  }
+
+  g_gpu->RestoreGraphicsAPIState();
+  const bool result = g_gpu->StartRecordingDump(filename, num_frames);
+  g_gpu->ResetGraphicsAPIState();
+
+  if (result)
+  {
+    Host::AddFormattedOSDMessage(5.0f, Host::TranslateString("OSDMessage", "Started recording GPU dump to '%s'."),
+                                 filename);
+  }
+  else
+  {
+    Host::AddFormattedOSDMessage(10.0f, Host::TranslateString("OSDMessage", "Failed to start GPU dump to '%s'."),
+                                 filename);
+  }
+
+  return result;
+}
+
+void System::StopRecordingGPUDump()
+{
+  if (g_gpu)
+    g_gpu->StopRecordingDump();
+}
+
 bool System::SaveScreenshot(const char* filename /* = nullptr */, bool full_resolution /* = true */,
                             bool apply_aspect_ratio /* = true */, bool compress_on_thread /* = true */)
 {
@@ -3982,6 +5663,8 @@ std::optional<SaveStateInfo> System::GetSaveStateInfo(const char* serial, s32 sl
 
 std::optional<ExtendedSaveStateInfo> System::GetExtendedSaveStateInfo(const char* path)
 {
+  WaitForSaveStateWrites();
+
   FILESYSTEM_STAT_DATA sd;
   if (!FileSystem::StatFile(path, &sd))
     return std::nullopt;
@@ -4048,6 +5731,8 @@ std::optional<ExtendedSaveStateInfo> System::InternalGetExtendedSaveStateInfo(By
 
 void System::DeleteSaveStates(const char* serial, bool resume)
 {
+  WaitForSaveStateWrites();
+
   const std::vector<SaveStateInfo> states(GetAvailableSaveStates(serial));
   for (const SaveStateInfo& si : states)
   {
@@ -4434,3 +6119,19 @@ void System::SetTimerResolutionIncreased(bool enabled)
     timeEndPeriod(1);
 #endif
 }
+
+void System::UpdateThreadAffinityPolicy()
+{
+  const Threading::CPUTopology& topo = Threading::GetCPUTopology();
+  const bool enabled = (g_settings.thread_affinity_policy == ThreadAffinityPolicy::Always ||
+                        (g_settings.thread_affinity_policy == ThreadAffinityPolicy::Automatic && topo.IsHybrid()));
+  if (enabled != Threading::IsAffinityPolicyEnabled())
+  {
+    Log_InfoPrintf("%s thread affinity policy (%zu performance cores, %s)", enabled ? "Enabling" : "Disabling",
+                   topo.performance_cores.size(), topo.IsHybrid() ? "hybrid" : "homogeneous");
+    Threading::SetAffinityPolicyEnabled(enabled);
+  }
+
+  // we're on the CPU thread, the others pick it up when they next start
+  Threading::ApplyAffinityPolicy(Threading::AffinityClass::EmulationCPU);
+}
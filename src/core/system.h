@@ -12,6 +12,7 @@
 
 class ByteStream;
 class CDImage;
+class ISOReader;
 class StateWrapper;
 
 class Controller;
@@ -39,6 +40,8 @@ struct SystemBootParameters
   std::optional<bool> override_fast_boot;
   std::optional<bool> override_fullscreen;
   std::optional<bool> override_start_paused;
+  std::string record_input_movie;
+  std::string replay_input_movie;
   u32 media_playlist_index = 0;
   bool load_image_to_ram = false;
   bool force_software_renderer = false;
@@ -96,6 +99,9 @@ bool IsExeFileName(const std::string_view& path);
 /// Returns true if the filename is a Portable Sound Format file we can uncompress/load.
 bool IsPsfFileName(const std::string_view& path);
 
+/// Returns true if the filename is a recording of GPU commands, which is replayed without the rest of the system.
+bool IsGPUDumpFileName(const std::string_view& path);
+
 /// Returns true if the filename is one we can load.
 bool IsLoadableFilename(const std::string_view& path);
 
@@ -110,6 +116,10 @@ bool ReadExecutableFromImage(CDImage* cdi, std::string* out_executable_name, std
 
 std::string GetGameHashIdFromImage(CDImage* cdi);
 std::string GetGameIdFromImage(CDImage* cdi, bool fallback_to_hash);
+
+/// Variants which share an already-open reader, so the disc's directories are only read once across lookups.
+std::string GetGameHashIdFromImage(ISOReader& iso);
+std::string GetGameIdFromImage(ISOReader& iso, bool fallback_to_hash);
 std::string GetGameSerialForPath(const char* image_path, bool fallback_to_hash);
 DiscRegion GetRegionForSerial(std::string_view serial);
 DiscRegion GetRegionFromSystemArea(CDImage* cdi);
@@ -198,13 +208,48 @@ float GetMaximumFrameTime();
 float GetThrottleFrequency();
 float GetCPUThreadUsage();
 float GetCPUThreadAverageTime();
+
+/// Heap allocations made by the CPU thread per frame. Only counted in debug builds, zero otherwise.
+float GetCPUThreadAllocationsPerFrame();
 float GetSWThreadUsage();
 float GetSWThreadAverageTime();
+float GetSWThreadWakeupRate();
+float GetSWThreadSyncStallRate();
+float GetSWThreadSyncStallTime();
 float GetGPUUsage();
 float GetGPUAverageTime();
+
+/// Incremented every time the performance counters above are recalculated, so overlays can cache their text.
+u32 GetPerformanceCounterUpdateCount();
+
+/// Returns the average GPU time per presented frame spent in the specified timing scope.
+float GetGPUAverageScopeTime(u32 scope);
 const FrameTimeHistory& GetFrameTimeHistory();
 u32 GetFrameTimeHistoryPos();
 
+/// Frame time distributions, collected from when the system was booted.
+enum class FrameTimeHistogram : u8
+{
+  Frame,
+  CPUThread,
+  GPU,
+  InputLatency,
+  ThrottleJitter,
+  Count
+};
+struct FrameTimePercentiles
+{
+  float p50;
+  float p95;
+  float p99;
+  float p999;
+};
+const FrameTimePercentiles& GetFrameTimePercentiles(FrameTimeHistogram histogram);
+
+/// Writes the frame time histograms and percentiles to a file, as JSON if the filename ends in .json, otherwise CSV.
+/// If no filename is given, a CSV is written to the dumps directory.
+bool SaveFrameTimeHistograms(const char* filename = nullptr);
+
 /// Loads global settings (i.e. EmuConfig).
 void LoadSettings(bool display_osd_messages);
 void SetDefaultSettings(SettingsInterface& si);
@@ -221,9 +266,19 @@ void ResetSystem();
 
 /// Loads state from the specified filename.
 bool LoadState(const char* filename);
+
+/// Captures the state in memory, then compresses and writes it to the specified filename in the background.
+/// Failures to write the file are reported asynchronously.
 bool SaveState(const char* filename, bool backup_existing_save);
 bool SaveResumeState();
 
+/// Waits for any save states which are still being written in the background.
+void WaitForSaveStateWrites();
+
+/// Saves/loads a compressed state without a screenshot, for embedding in other files such as input movies.
+bool SaveStateToStream(ByteStream* stream);
+bool LoadStateFromStream(ByteStream* stream);
+
 /// Runs the VM until the CPU execution is canceled.
 void Execute();
 
@@ -250,6 +305,10 @@ void ResetThrottler();
 /// Throttles the system, i.e. sleeps until it's time to execute the next frame.
 void Throttle();
 
+/// Called by the pad when the game starts reading a controller. Applies any input which arrived since the frame
+/// started, and with late input latching, polls the input sources first.
+void OnControllerRead();
+
 void UpdatePerformanceCounters();
 void ResetPerformanceCounters();
 
@@ -279,6 +338,10 @@ bool DumpVRAM(const char* filename);
 /// Dumps sound RAM to a file.
 bool DumpSPURAM(const char* filename);
 
+/// Returns a hash of the emulated machine's state: RAM, scratchpad, sound RAM, VRAM, the CPU and GTE registers, and
+/// the event schedule. Two runs which produce the same hash every frame are executing identically.
+u64 GetStateHash();
+
 bool HasMedia();
 std::string GetMediaFileName();
 bool InsertMedia(const char* path);
@@ -384,6 +447,25 @@ bool StartDumpingAudio(const char* filename = nullptr);
 /// Stops dumping audio to file if it has been started.
 void StopDumpingAudio();
 
+/// Returns true if currently capturing video and audio.
+bool IsCapturingMedia();
+
+/// Starts capturing video and audio to a file. If no file name is provided, one will be generated automatically.
+bool StartMediaCapture(const char* filename = nullptr);
+
+/// Stops capturing video and audio if it has been started.
+void StopMediaCapture();
+
+/// Returns true if GPU commands are being recorded.
+bool IsRecordingGPUDump();
+
+/// Records GPU commands for the specified number of frames, or until stopped if zero. If no file name is provided,
+/// one will be generated automatically.
+bool StartRecordingGPUDump(const char* filename = nullptr, u32 num_frames = 0);
+
+/// Stops recording GPU commands if it has been started.
+void StopRecordingGPUDump();
+
 /// Saves a screenshot to the specified file. IF no file name is provided, one will be generated automatically.
 bool SaveScreenshot(const char* filename = nullptr, bool full_resolution = true, bool apply_aspect_ratio = true,
                     bool compress_on_thread = true);
@@ -446,7 +528,7 @@ void HostDisplayResized();
 //////////////////////////////////////////////////////////////////////////
 // Memory Save States (Rewind and Runahead)
 //////////////////////////////////////////////////////////////////////////
-void CalculateRewindMemoryUsage(u32 num_saves, u64* ram_usage, u64* vram_usage);
+void CalculateRewindMemoryUsage(u32 num_saves, bool native_vram, u64* ram_usage, u64* vram_usage);
 void ClearMemorySaveStates();
 void UpdateMemorySaveStateSettings();
 bool LoadRewindState(u32 skip_saves = 0, bool consume_state = true);
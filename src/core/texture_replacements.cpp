@@ -2,11 +2,14 @@
 // SPDX-License-Identifier: (GPL-3.0 OR CC-BY-NC-ND-4.0)
 
 #include "texture_replacements.h"
+#include "common/align.h"
+#include "common/assert.h"
 #include "common/file_system.h"
 #include "common/log.h"
 #include "common/path.h"
 #include "common/platform.h"
 #include "common/string_util.h"
+#include "common/thirdparty/thread_pool.h"
 #include "common/timer.h"
 #include "fmt/format.h"
 #include "host.h"
@@ -15,11 +18,109 @@
 #if defined(CPU_X86) || defined(CPU_X64)
 #include "xxh_x86dispatch.h"
 #endif
+#include <algorithm>
+#include <array>
+#include <chrono>
 #include <cinttypes>
+#include <cstring>
 Log_SetChannel(TextureReplacements);
 
 TextureReplacements g_texture_replacements;
 
+// Packs are a header, an index sorted by hash, then the texture data. Data is stored exactly as it's uploaded, and
+// aligned, so the file could be mapped and streamed straight from.
+static constexpr u32 PACK_MAGIC = 0x4B505344; // DSPK
+static constexpr u32 PACK_VERSION = 1;
+static constexpr u32 PACK_DATA_ALIGNMENT = 16;
+static constexpr u32 MAX_PACK_ENTRIES = 1024 * 1024;
+static constexpr const char* PACK_EXTENSION = ".dspack";
+
+namespace {
+#pragma pack(push, 1)
+struct PackHeader
+{
+  u32 magic;
+  u32 version;
+  u32 num_entries;
+  u32 reserved;
+};
+
+struct PackEntry
+{
+  u64 hash_low;
+  u64 hash_high;
+  u8 type;
+  u8 format;
+  u16 reserved;
+  u32 width;
+  u32 height;
+  u32 size;
+  u64 offset;
+};
+#pragma pack(pop)
+static_assert(sizeof(PackEntry) == 40);
+
+static constexpr u32 DDS_MAGIC = 0x20534444;        // "DDS "
+static constexpr u32 DDS_FOURCC_DXT1 = 0x31545844;  // "DXT1"
+static constexpr u32 DDS_FOURCC_DXT5 = 0x35545844;  // "DXT5"
+static constexpr u32 DDS_FOURCC_DX10 = 0x30315844;  // "DX10"
+static constexpr u32 DDS_PIXEL_FORMAT_FOURCC = 0x4;
+
+// Only the DXGI formats we can load, there's no point pulling in the D3D headers for these.
+enum : u32
+{
+  DDS_DXGI_FORMAT_BC1_UNORM = 71,
+  DDS_DXGI_FORMAT_BC1_UNORM_SRGB = 72,
+  DDS_DXGI_FORMAT_BC3_UNORM = 77,
+  DDS_DXGI_FORMAT_BC3_UNORM_SRGB = 78,
+  DDS_DXGI_FORMAT_BC7_UNORM = 98,
+  DDS_DXGI_FORMAT_BC7_UNORM_SRGB = 99,
+};
+
+#pragma pack(push, 1)
+struct DDSPixelFormat
+{
+  u32 size;
+  u32 flags;
+  u32 fourcc;
+  u32 rgb_bit_count;
+  u32 r_mask;
+  u32 g_mask;
+  u32 b_mask;
+  u32 a_mask;
+};
+
+struct DDSHeader
+{
+  u32 magic;
+  u32 size;
+  u32 flags;
+  u32 height;
+  u32 width;
+  u32 pitch_or_linear_size;
+  u32 depth;
+  u32 mip_map_count;
+  u32 reserved1[11];
+  DDSPixelFormat pixel_format;
+  u32 caps;
+  u32 caps2;
+  u32 caps3;
+  u32 caps4;
+  u32 reserved2;
+};
+
+struct DDSHeaderDX10
+{
+  u32 dxgi_format;
+  u32 resource_dimension;
+  u32 misc_flag;
+  u32 array_size;
+  u32 misc_flags2;
+};
+#pragma pack(pop)
+static_assert(sizeof(DDSHeader) == 128);
+} // namespace
+
 static constexpr u32 VRAMRGBA5551ToRGBA8888(u16 color)
 {
   u8 r = Truncate8(color & 31);
@@ -56,6 +157,44 @@ bool TextureReplacementHash::ParseString(const std::string_view& sv)
   return true;
 }
 
+TextureReplacementTexture::TextureReplacementTexture() = default;
+
+TextureReplacementTexture::TextureReplacementTexture(Format format, u32 width, u32 height, std::vector<u8> data)
+  : m_data(std::move(data)), m_width(width), m_height(height), m_format(format)
+{
+}
+
+TextureReplacementTexture::TextureReplacementTexture(const Common::RGBA8Image& image)
+  : m_width(image.GetWidth()), m_height(image.GetHeight()), m_format(Format::RGBA8)
+{
+  m_data.resize(image.GetPitch() * image.GetHeight());
+  std::memcpy(m_data.data(), image.GetPixels(), m_data.size());
+}
+
+u32 TextureReplacementTexture::GetPitch(Format format, u32 width)
+{
+  const u32 blocks_wide = (width + 3) / 4;
+  switch (format)
+  {
+    case Format::BC1:
+      return blocks_wide * 8;
+
+    case Format::BC3:
+    case Format::BC7:
+      return blocks_wide * 16;
+
+    case Format::RGBA8:
+    default:
+      return width * sizeof(u32);
+  }
+}
+
+const char* TextureReplacementTexture::GetFormatName(Format format)
+{
+  static constexpr std::array<const char*, static_cast<size_t>(Format::Count)> names = {{"RGBA8", "BC1", "BC3", "BC7"}};
+  return names[static_cast<size_t>(format)];
+}
+
 TextureReplacements::TextureReplacements() = default;
 
 TextureReplacements::~TextureReplacements() = default;
@@ -66,6 +205,7 @@ void TextureReplacements::SetGameID(std::string game_id)
     return;
 
   m_game_id = game_id;
+  m_dump_index_loaded = false;
   Reload();
 }
 
@@ -77,35 +217,64 @@ const TextureReplacementTexture* TextureReplacements::GetVRAMWriteReplacement(u3
   if (it == m_vram_write_replacements.end())
     return nullptr;
 
-  return LoadTexture(it->second);
+  return LoadTexture(it->first, it->second);
 }
 
 void TextureReplacements::DumpVRAMWrite(u32 width, u32 height, const void* pixels)
 {
-  std::string filename = GetVRAMWriteDumpFilename(width, height, pixels);
-  if (filename.empty())
+  if (m_game_id.empty())
     return;
 
-  Common::RGBA8Image image;
-  image.SetSize(width, height);
+  if (!m_dump_index_loaded)
+    LoadDumpIndex();
 
-  const u16* src_pixels = reinterpret_cast<const u16*>(pixels);
+  const TextureReplacementHash hash = GetVRAMWriteHash(width, height, pixels);
+  if (!m_dumped_textures.insert(hash).second)
+    return;
 
-  for (u32 y = 0; y < height; y++)
+  // Encoding can fall behind during bursts of uploads, only hold up the CPU thread once we're over budget.
+  const u32 data_size = width * height * sizeof(u16);
   {
-    for (u32 x = 0; x < width; x++)
+    std::unique_lock lock(m_dump_mutex);
+    if (m_dump_queue_size > 0 && (m_dump_queue_size + data_size) > MAX_DUMP_QUEUE_SIZE)
     {
-      image.SetPixel(x, y, VRAMRGBA5551ToRGBA8888(*src_pixels));
-      src_pixels++;
+      Log_PerfPrintf("Waiting for texture dump queue, %u bytes pending", m_dump_queue_size);
+      m_dump_cv.wait(lock, [this, data_size]() {
+        return (m_dump_queue_size == 0 || (m_dump_queue_size + data_size) <= MAX_DUMP_QUEUE_SIZE);
+      });
     }
+
+    m_dump_queue_size += data_size;
   }
 
-  if (g_settings.texture_replacements.dump_vram_write_force_alpha_channel)
+  std::vector<u16> data(width * height);
+  std::memcpy(data.data(), pixels, data_size);
+
+  std::string filename(Path::Combine(GetDumpDirectory(), fmt::format("vram-write-{}.png", hash.ToString())));
+  const bool force_alpha_channel = g_settings.texture_replacements.dump_vram_write_force_alpha_channel;
+  GetDumpPool()->Schedule(
+    [this, filename = std::move(filename), width, height, data = std::move(data), force_alpha_channel]() {
+      WriteVRAMWriteDump(filename, width, height, data.data(), force_alpha_channel);
+
+      std::unique_lock lock(m_dump_mutex);
+      m_dump_queue_size -= static_cast<u32>(data.size() * sizeof(u16));
+      m_dump_cv.notify_one();
+    });
+}
+
+void TextureReplacements::WriteVRAMWriteDump(const std::string& filename, u32 width, u32 height, const u16* pixels,
+                                             bool force_alpha_channel)
+{
+  Common::RGBA8Image image;
+  image.SetSize(width, height);
+
+  const u32 alpha_mask = force_alpha_channel ? 0xFF000000u : 0u;
+  for (u32 y = 0; y < height; y++)
   {
-    for (u32 y = 0; y < height; y++)
+    for (u32 x = 0; x < width; x++)
     {
-      for (u32 x = 0; x < width; x++)
-        image.SetPixel(x, y, image.GetPixel(x, y) | 0xFF000000u);
+      image.SetPixel(x, y, VRAMRGBA5551ToRGBA8888(*pixels) | alpha_mask);
+      pixels++;
     }
   }
 
@@ -114,9 +283,67 @@ void TextureReplacements::DumpVRAMWrite(u32 width, u32 height, const void* pixel
     Log_ErrorPrintf("Failed to dump %ux%u VRAM write to '%s'", width, height, filename.c_str());
 }
 
+void TextureReplacements::LoadDumpIndex()
+{
+  // Scanned once per game, after that the set is kept up to date as textures are queued.
+  m_dumped_textures.clear();
+  m_dump_index_loaded = true;
+
+  const std::string dump_directory(GetDumpDirectory());
+  if (!FileSystem::EnsureDirectoryExists(dump_directory.c_str(), false))
+    Log_ErrorPrintf("Failed to create texture dump directory '%s'", dump_directory.c_str());
+
+  FileSystem::FindResultsArray files;
+  FileSystem::FindFiles(dump_directory.c_str(), "vram-write-*", FILESYSTEM_FIND_FILES, &files);
+  for (const FILESYSTEM_FIND_DATA& fd : files)
+  {
+    TextureReplacementHash hash;
+    ReplacmentType type;
+    if (ParseReplacementFilename(fd.FileName, &hash, &type))
+      m_dumped_textures.insert(hash);
+  }
+
+  Log_DevPrintf("Found %zu previously dumped textures in '%s'", m_dumped_textures.size(), dump_directory.c_str());
+}
+
+cb::ThreadPool* TextureReplacements::GetDumpPool()
+{
+  // One writer keeps the dumps in order and off the load workers.
+  if (!m_dump_pool)
+    m_dump_pool = std::make_unique<cb::ThreadPool>(1);
+
+  return m_dump_pool.get();
+}
+
+void TextureReplacements::FlushDumps()
+{
+  // Destroying the pool drains the queue.
+  m_dump_pool.reset();
+}
+
+TextureReplacements::CacheStats TextureReplacements::GetCacheStats() const
+{
+  CacheStats stats;
+  stats.pending_textures = static_cast<u32>(m_pending_loads.size());
+  stats.resident_textures = static_cast<u32>(m_texture_cache.size());
+  stats.resident_bytes = m_texture_cache_size;
+  stats.evicted_textures = m_evicted_textures;
+  return stats;
+}
+
 void TextureReplacements::Shutdown()
 {
+  FlushDumps();
+  m_dumped_textures.clear();
+  m_dump_index_loaded = false;
+
+  // Abandoned futures don't block, the pool finishes whatever's already running when it's destroyed.
+  m_pending_loads.clear();
+  m_load_pool.reset();
   m_texture_cache.clear();
+  m_texture_lru.clear();
+  m_texture_cache_size = 0;
+  m_evicted_textures = 0;
   m_vram_write_replacements.clear();
   m_game_id.clear();
 }
@@ -137,27 +364,10 @@ TextureReplacementHash TextureReplacements::GetVRAMWriteHash(u32 width, u32 heig
   return {hash.low64, hash.high64};
 }
 
-std::string TextureReplacements::GetVRAMWriteDumpFilename(u32 width, u32 height, const void* pixels) const
-{
-  if (m_game_id.empty())
-    return {};
-
-  const TextureReplacementHash hash = GetVRAMWriteHash(width, height, pixels);
-  const std::string dump_directory(GetDumpDirectory());
-  std::string filename(Path::Combine(dump_directory, fmt::format("vram-write-{}.png", hash.ToString())));
-
-  if (FileSystem::FileExists(filename.c_str()))
-    return {};
-
-  if (!FileSystem::EnsureDirectoryExists(dump_directory.c_str(), false))
-    return {};
-
-  return filename;
-}
-
 void TextureReplacements::Reload()
 {
   m_vram_write_replacements.clear();
+  m_pending_loads.clear();
 
   if (g_settings.texture_replacements.AnyReplacementsEnabled())
     FindTextures(GetSourceDirectory());
@@ -166,19 +376,22 @@ void TextureReplacements::Reload()
     PreloadTextures();
 
   PurgeUnreferencedTexturesFromCache();
+  EvictTextures();
 }
 
 void TextureReplacements::PurgeUnreferencedTexturesFromCache()
 {
-  TextureCache old_map = std::move(m_texture_cache);
-  for (const auto& it : m_vram_write_replacements)
+  for (auto it = m_texture_cache.begin(); it != m_texture_cache.end();)
   {
-    auto it2 = old_map.find(it.second);
-    if (it2 != old_map.end())
+    if (m_vram_write_replacements.find(it->first) != m_vram_write_replacements.end())
     {
-      m_texture_cache[it.second] = std::move(it2->second);
-      old_map.erase(it2);
+      ++it;
+      continue;
     }
+
+    m_texture_lru.erase(it->second.lru_it);
+    m_texture_cache_size -= it->second.image.GetDataSize();
+    it = m_texture_cache.erase(it);
   }
 }
 
@@ -217,7 +430,7 @@ bool TextureReplacements::ParseReplacementFilename(const std::string& filename,
   extension++;
 
   bool valid_extension = false;
-  for (const char* test_extension : {"png", "jpg", "tga", "bmp"})
+  for (const char* test_extension : {"png", "jpg", "tga", "bmp", "dds"})
   {
     if (StringUtil::Strcasecmp(extension, test_extension) == 0)
     {
@@ -229,11 +442,74 @@ bool TextureReplacements::ParseReplacementFilename(const std::string& filename,
   return valid_extension;
 }
 
+
+bool TextureReplacements::LoadPackIndex(const std::string& filename)
+{
+  auto fp = FileSystem::OpenManagedCFile(filename.c_str(), "rb");
+  if (!fp)
+  {
+    Log_ErrorPrintf("Failed to open texture pack '%s'", filename.c_str());
+    return false;
+  }
+
+  PackHeader header;
+  if (std::fread(&header, sizeof(header), 1, fp.get()) != 1 || header.magic != PACK_MAGIC ||
+      header.version != PACK_VERSION || header.num_entries > MAX_PACK_ENTRIES)
+  {
+    Log_ErrorPrintf("'%s' is not a valid texture pack", filename.c_str());
+    return false;
+  }
+
+  std::vector<PackEntry> entries(header.num_entries);
+  if (!entries.empty() && std::fread(entries.data(), sizeof(PackEntry), entries.size(), fp.get()) != entries.size())
+  {
+    Log_ErrorPrintf("Failed to read index of texture pack '%s'", filename.c_str());
+    return false;
+  }
+
+  u32 num_textures = 0;
+  for (const PackEntry& entry : entries)
+  {
+    if (entry.type != static_cast<u8>(ReplacmentType::VRAMWrite) ||
+        entry.format >= static_cast<u8>(TextureReplacementTexture::Format::Count))
+    {
+      continue;
+    }
+
+    ReplacementSource source;
+    source.filename = filename;
+    source.pack_offset = entry.offset;
+    source.pack_size = entry.size;
+    source.width = entry.width;
+    source.height = entry.height;
+    source.format = static_cast<TextureReplacementTexture::Format>(entry.format);
+    source.in_pack = true;
+    if (m_vram_write_replacements.emplace(TextureReplacementHash{entry.hash_low, entry.hash_high}, std::move(source))
+          .second)
+    {
+      num_textures++;
+    }
+  }
+
+  Log_InfoPrintf("Found %u replacement textures in pack '%s'", num_textures, filename.c_str());
+  return true;
+}
+
 void TextureReplacements::FindTextures(const std::string& dir)
 {
   FileSystem::FindResultsArray files;
   FileSystem::FindFiles(dir.c_str(), "*", FILESYSTEM_FIND_FILES | FILESYSTEM_FIND_RECURSIVE, &files);
 
+  // Packs go first, so loose files can override individual textures in them.
+  for (const FILESYSTEM_FIND_DATA& fd : files)
+  {
+    if (!(fd.Attributes & FILESYSTEM_FILE_ATTRIBUTE_DIRECTORY) &&
+        StringUtil::EndsWithNoCase(fd.FileName, PACK_EXTENSION))
+    {
+      LoadPackIndex(fd.FileName);
+    }
+  }
+
   for (FILESYSTEM_FIND_DATA& fd : files)
   {
     if (fd.Attributes & FILESYSTEM_FILE_ATTRIBUTE_DIRECTORY)
@@ -249,13 +525,16 @@ void TextureReplacements::FindTextures(const std::string& dir)
       case ReplacmentType::VRAMWrite:
       {
         auto it = m_vram_write_replacements.find(hash);
-        if (it != m_vram_write_replacements.end())
+        if (it != m_vram_write_replacements.end() && !it->second.in_pack)
         {
-          Log_WarningPrintf("Duplicate VRAM write replacement: '%s' and '%s'", it->second.c_str(), fd.FileName.c_str());
+          Log_WarningPrintf("Duplicate VRAM write replacement: '%s' and '%s'", it->second.filename.c_str(),
+                            fd.FileName.c_str());
           continue;
         }
 
-        m_vram_write_replacements.emplace(hash, std::move(fd.FileName));
+        ReplacementSource source = {};
+        source.filename = std::move(fd.FileName);
+        m_vram_write_replacements[hash] = std::move(source);
       }
       break;
     }
@@ -264,22 +543,220 @@ void TextureReplacements::FindTextures(const std::string& dir)
   Log_InfoPrintf("Found %zu replacement VRAM writes for '%s'", m_vram_write_replacements.size(), m_game_id.c_str());
 }
 
-const TextureReplacementTexture* TextureReplacements::LoadTexture(const std::string& filename)
+std::optional<TextureReplacementTexture> TextureReplacements::DecodeTexture(const ReplacementSource& source)
 {
-  auto it = m_texture_cache.find(filename);
-  if (it != m_texture_cache.end())
-    return &it->second;
+  if (source.in_pack)
+  {
+    std::vector<u8> data(source.pack_size);
+    auto fp = FileSystem::OpenManagedCFile(source.filename.c_str(), "rb");
+    if (!fp || FileSystem::FSeek64(fp.get(), static_cast<s64>(source.pack_offset), SEEK_SET) != 0 ||
+        (!data.empty() && std::fread(data.data(), data.size(), 1, fp.get()) != 1))
+    {
+      Log_ErrorPrintf("Failed to read texture at %" PRIu64 " in pack '%s'", source.pack_offset,
+                      source.filename.c_str());
+      return std::nullopt;
+    }
+
+    TextureReplacementTexture tex(source.format, source.width, source.height, std::move(data));
+    if (tex.GetDataSize() != (tex.GetPitch() * tex.GetRows()))
+    {
+      Log_ErrorPrintf("Texture at %" PRIu64 " in pack '%s' has the wrong size", source.pack_offset,
+                      source.filename.c_str());
+      return std::nullopt;
+    }
+
+    return tex;
+  }
+
+  if (StringUtil::EndsWithNoCase(source.filename, ".dds"))
+    return LoadDDS(source.filename);
 
   Common::RGBA8Image image;
-  if (!image.LoadFromFile(filename.c_str()))
+  if (!image.LoadFromFile(source.filename.c_str()))
+  {
+    Log_ErrorPrintf("Failed to load '%s'", source.filename.c_str());
+    return std::nullopt;
+  }
+
+  Log_InfoPrintf("Loaded '%s': %ux%u", source.filename.c_str(), image.GetWidth(), image.GetHeight());
+  return TextureReplacementTexture(image);
+}
+
+std::optional<TextureReplacementTexture> TextureReplacements::LoadDDS(const std::string& filename)
+{
+  std::optional<std::vector<u8>> data = FileSystem::ReadBinaryFile(filename.c_str());
+  if (!data.has_value() || data->size() < sizeof(DDSHeader))
   {
     Log_ErrorPrintf("Failed to load '%s'", filename.c_str());
+    return std::nullopt;
+  }
+
+  DDSHeader header;
+  std::memcpy(&header, data->data(), sizeof(header));
+  if (header.magic != DDS_MAGIC || header.size != (sizeof(DDSHeader) - sizeof(header.magic)) ||
+      !(header.pixel_format.flags & DDS_PIXEL_FORMAT_FOURCC))
+  {
+    Log_ErrorPrintf("'%s' is not a block compressed DDS file", filename.c_str());
+    return std::nullopt;
+  }
+
+  // Only the top level is used, the replacement is scaled to fit the write anyway.
+  size_t data_offset = sizeof(DDSHeader);
+  std::optional<TextureReplacementTexture::Format> format;
+  if (header.pixel_format.fourcc == DDS_FOURCC_DXT1)
+  {
+    format = TextureReplacementTexture::Format::BC1;
+  }
+  else if (header.pixel_format.fourcc == DDS_FOURCC_DXT5)
+  {
+    format = TextureReplacementTexture::Format::BC3;
+  }
+  else if (header.pixel_format.fourcc == DDS_FOURCC_DX10 && data->size() >= (data_offset + sizeof(DDSHeaderDX10)))
+  {
+    DDSHeaderDX10 dx10_header;
+    std::memcpy(&dx10_header, data->data() + data_offset, sizeof(dx10_header));
+    data_offset += sizeof(DDSHeaderDX10);
+
+    // sRGB is loaded as-is, VRAM is never colour managed.
+    switch (dx10_header.dxgi_format)
+    {
+      case DDS_DXGI_FORMAT_BC1_UNORM:
+      case DDS_DXGI_FORMAT_BC1_UNORM_SRGB:
+        format = TextureReplacementTexture::Format::BC1;
+        break;
+      case DDS_DXGI_FORMAT_BC3_UNORM:
+      case DDS_DXGI_FORMAT_BC3_UNORM_SRGB:
+        format = TextureReplacementTexture::Format::BC3;
+        break;
+      case DDS_DXGI_FORMAT_BC7_UNORM:
+      case DDS_DXGI_FORMAT_BC7_UNORM_SRGB:
+        format = TextureReplacementTexture::Format::BC7;
+        break;
+      default:
+        break;
+    }
+  }
+
+  if (!format.has_value())
+  {
+    Log_ErrorPrintf("'%s' is not in a supported format (BC1, BC3 or BC7)", filename.c_str());
+    return std::nullopt;
+  }
+
+  // D3D requires the top level of block compressed textures to be a whole number of blocks.
+  if (header.width == 0 || header.height == 0 || (header.width % 4) != 0 || (header.height % 4) != 0)
+  {
+    Log_ErrorPrintf("'%s' has dimensions %ux%u which are not a multiple of 4", filename.c_str(), header.width,
+                    header.height);
+    return std::nullopt;
+  }
+
+  const size_t size = static_cast<size_t>(TextureReplacementTexture::GetPitch(format.value(), header.width)) *
+                      static_cast<size_t>(header.height / 4);
+  if (data->size() < (data_offset + size))
+  {
+    Log_ErrorPrintf("'%s' is truncated", filename.c_str());
+    return std::nullopt;
+  }
+
+  Log_InfoPrintf("Loaded '%s': %ux%u %s", filename.c_str(), header.width, header.height,
+                 TextureReplacementTexture::GetFormatName(format.value()));
+  return TextureReplacementTexture(format.value(), header.width, header.height,
+                                   std::vector<u8>(data->begin() + data_offset, data->begin() + data_offset + size));
+}
+
+cb::ThreadPool* TextureReplacements::GetLoadPool()
+{
+  if (!m_load_pool)
+  {
+    // Decoding is mostly zlib, leave the rest of the cores to the emulator.
+    const unsigned int num_workers = std::clamp(cb::ThreadPool::GetNumLogicalCores() / 2u, 1u, 4u);
+    m_load_pool = std::make_unique<cb::ThreadPool>(static_cast<int>(num_workers));
+  }
+
+  return m_load_pool.get();
+}
+
+const TextureReplacementTexture* TextureReplacements::LoadTexture(const TextureReplacementHash& hash,
+                                                                  const ReplacementSource& source)
+{
+  if (!m_pending_loads.empty())
+    CollectPendingLoads();
+
+  auto it = m_texture_cache.find(hash);
+  if (it != m_texture_cache.end())
+  {
+    m_texture_lru.splice(m_texture_lru.begin(), m_texture_lru, it->second.lru_it);
+    return &it->second.image;
+  }
+
+  // The original write goes through until the decode finishes, rather than stalling emulation on it.
+  if (g_settings.texture_replacements.async_loading)
+  {
+    if (m_pending_loads.find(hash) == m_pending_loads.end())
+      m_pending_loads.emplace(hash, GetLoadPool()->ScheduleAndGetFuture([source]() { return DecodeTexture(source); }));
+
+    return nullptr;
+  }
+
+  std::optional<TextureReplacementTexture> image = DecodeTexture(source);
+  if (!image.has_value())
     return nullptr;
+
+  return InsertTexture(hash, std::move(image.value()));
+}
+
+const TextureReplacementTexture* TextureReplacements::InsertTexture(const TextureReplacementHash& hash,
+                                                                    TextureReplacementTexture image)
+{
+  m_texture_cache_size += image.GetDataSize();
+  m_texture_lru.push_front(hash);
+
+  CachedTexture& ct = m_texture_cache[hash];
+  ct.image = std::move(image);
+  ct.lru_it = m_texture_lru.begin();
+
+  // Never evicts the texture we just added, since it's at the front.
+  EvictTextures();
+  return &ct.image;
+}
+
+void TextureReplacements::CollectPendingLoads()
+{
+  for (auto it = m_pending_loads.begin(); it != m_pending_loads.end();)
+  {
+    if (it->second.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+    {
+      ++it;
+      continue;
+    }
+
+    // Failures are dropped, so the next hit tries again, same as synchronous loading.
+    std::optional<TextureReplacementTexture> image = it->second.get();
+    if (image.has_value() && m_texture_cache.find(it->first) == m_texture_cache.end())
+      InsertTexture(it->first, std::move(image.value()));
+
+    it = m_pending_loads.erase(it);
   }
+}
 
-  Log_InfoPrintf("Loaded '%s': %ux%u", filename.c_str(), image.GetWidth(), image.GetHeight());
-  it = m_texture_cache.emplace(filename, std::move(image)).first;
-  return &it->second;
+void TextureReplacements::EvictTextures()
+{
+  const u64 max_size = static_cast<u64>(g_settings.texture_replacements.max_cache_size_mb) * 1048576u;
+  if (max_size == 0)
+    return;
+
+  while (m_texture_cache_size > max_size && m_texture_lru.size() > 1)
+  {
+    auto it = m_texture_cache.find(m_texture_lru.back());
+    DebugAssert(it != m_texture_cache.end());
+    Log_DevPrintf("Evicting %s from replacement texture cache", it->first.ToString().c_str());
+
+    m_texture_cache_size -= it->second.image.GetDataSize();
+    m_texture_cache.erase(it);
+    m_texture_lru.pop_back();
+    m_evicted_textures++;
+  }
 }
 
 void TextureReplacements::PreloadTextures()
@@ -298,13 +775,143 @@ void TextureReplacements::PreloadTextures()
     last_update_time.Reset();                                                                                          \
   }
 
+  // Decode on the worker pool, the loading screen is the only thing we're waiting on.
+  const u32 evicted_before = m_evicted_textures;
+  cb::ThreadPool* pool = GetLoadPool();
+  std::vector<std::pair<TextureReplacementHash, std::future<std::optional<TextureReplacementTexture>>>> loads;
+  loads.reserve(total_textures);
   for (const auto& it : m_vram_write_replacements)
+  {
+    if (m_texture_cache.find(it.first) != m_texture_cache.end())
+      continue;
+
+    const ReplacementSource* source = &it.second;
+    loads.emplace_back(it.first, pool->ScheduleAndGetFuture([source]() { return DecodeTexture(*source); }));
+  }
+
+  num_textures_loaded = total_textures - static_cast<u32>(loads.size());
+  for (auto& it : loads)
   {
     UPDATE_PROGRESS();
 
-    LoadTexture(it.second);
+    std::optional<TextureReplacementTexture> image = it.second.get();
+    if (image.has_value())
+      InsertTexture(it.first, std::move(image.value()));
+
     num_textures_loaded++;
   }
 
 #undef UPDATE_PROGRESS
+
+  if (m_evicted_textures != evicted_before)
+  {
+    Log_WarningPrintf("Replacement textures exceed the %u MB cache limit, %u will be reloaded when used",
+                      g_settings.texture_replacements.max_cache_size_mb, m_evicted_textures - evicted_before);
+  }
+}
+
+bool TextureReplacements::CompilePack(const char* source_directory, const char* output_filename)
+{
+  FileSystem::FindResultsArray files;
+  FileSystem::FindFiles(source_directory, "*", FILESYSTEM_FIND_FILES | FILESYSTEM_FIND_RECURSIVE, &files);
+
+  std::vector<std::pair<TextureReplacementHash, std::string>> sources;
+  for (FILESYSTEM_FIND_DATA& fd : files)
+  {
+    TextureReplacementHash hash;
+    ReplacmentType type;
+    if ((fd.Attributes & FILESYSTEM_FILE_ATTRIBUTE_DIRECTORY) || !ParseReplacementFilename(fd.FileName, &hash, &type))
+      continue;
+
+    sources.emplace_back(hash, std::move(fd.FileName));
+  }
+
+  // Sorted so duplicates are adjacent, and lookups can binary search the index if it's ever mapped directly.
+  std::sort(sources.begin(), sources.end(),
+            [](const auto& lhs, const auto& rhs) { return (lhs.first < rhs.first); });
+  sources.erase(std::unique(sources.begin(), sources.end(),
+                            [](const auto& lhs, const auto& rhs) {
+                              if (lhs.first != rhs.first)
+                                return false;
+
+                              Log_WarningPrintf("Duplicate replacement: '%s' and '%s'", lhs.second.c_str(),
+                                                rhs.second.c_str());
+                              return true;
+                            }),
+                sources.end());
+
+  if (sources.empty())
+  {
+    Log_ErrorPrintf("No replacement textures found in '%s'", source_directory);
+    return false;
+  }
+
+  auto fp = FileSystem::OpenManagedCFile(output_filename, "wb");
+  if (!fp)
+  {
+    Log_ErrorPrintf("Failed to open '%s' for writing", output_filename);
+    return false;
+  }
+
+  static constexpr std::array<u8, PACK_DATA_ALIGNMENT> padding = {};
+  const u64 data_start = Common::AlignUpPow2(sizeof(PackHeader) + sizeof(PackEntry) * sources.size(),
+                                             PACK_DATA_ALIGNMENT);
+  u64 offset = data_start;
+  bool okay = (FileSystem::FSeek64(fp.get(), static_cast<s64>(data_start), SEEK_SET) == 0);
+
+  std::vector<PackEntry> entries;
+  entries.reserve(sources.size());
+  for (size_t i = 0; i < sources.size() && okay; i++)
+  {
+    ReplacementSource source = {};
+    source.filename = sources[i].second;
+
+    std::optional<TextureReplacementTexture> tex = DecodeTexture(source);
+    if (!tex.has_value())
+    {
+      Log_WarningPrintf("Skipping '%s'", source.filename.c_str());
+      continue;
+    }
+
+    PackEntry entry = {};
+    entry.hash_low = sources[i].first.low;
+    entry.hash_high = sources[i].first.high;
+    entry.type = static_cast<u8>(ReplacmentType::VRAMWrite);
+    entry.format = static_cast<u8>(tex->GetFormat());
+    entry.width = tex->GetWidth();
+    entry.height = tex->GetHeight();
+    entry.size = tex->GetDataSize();
+    entry.offset = offset;
+    entries.push_back(entry);
+
+    const u32 padding_size = Common::AlignUpPow2(entry.size, PACK_DATA_ALIGNMENT) - entry.size;
+    okay = (std::fwrite(tex->GetPixels(), entry.size, 1, fp.get()) == 1 &&
+            (padding_size == 0 || std::fwrite(padding.data(), padding_size, 1, fp.get()) == 1));
+    offset += entry.size + padding_size;
+
+    Log_InfoPrintf("[%zu/%zu] %s: %ux%u %s", i + 1, sources.size(), source.filename.c_str(), entry.width,
+                   entry.height, TextureReplacementTexture::GetFormatName(tex->GetFormat()));
+  }
+
+  PackHeader header = {};
+  header.magic = PACK_MAGIC;
+  header.version = PACK_VERSION;
+  header.num_entries = static_cast<u32>(entries.size());
+  okay = okay && FileSystem::FSeek64(fp.get(), 0, SEEK_SET) == 0 &&
+         std::fwrite(&header, sizeof(header), 1, fp.get()) == 1 &&
+         (entries.empty() ||
+          std::fwrite(entries.data(), sizeof(PackEntry), entries.size(), fp.get()) == entries.size());
+  okay = (std::fflush(fp.get()) == 0) && okay;
+  fp.reset();
+
+  if (!okay)
+  {
+    Log_ErrorPrintf("Failed to write '%s'", output_filename);
+    FileSystem::DeleteFile(output_filename);
+    return false;
+  }
+
+  Log_InfoPrintf("Wrote %zu replacement textures (%.2f MB) to '%s'", entries.size(),
+                 static_cast<double>(offset) / 1048576.0, output_filename);
+  return true;
 }
@@ -5,11 +5,22 @@
 #include "common/hash_combine.h"
 #include "common/image.h"
 #include "types.h"
+#include <condition_variable>
+#include <future>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <optional>
 #include <string>
 #include <tuple>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
+namespace cb {
+class ThreadPool;
+}
+
 struct TextureReplacementHash
 {
   u64 low;
@@ -36,7 +47,44 @@ struct hash<TextureReplacementHash>
 };
 } // namespace std
 
-using TextureReplacementTexture = Common::RGBA8Image;
+class TextureReplacementTexture
+{
+public:
+  enum class Format : u8
+  {
+    RGBA8,
+    BC1,
+    BC3,
+    BC7,
+    Count
+  };
+
+  TextureReplacementTexture();
+  TextureReplacementTexture(Format format, u32 width, u32 height, std::vector<u8> data);
+  explicit TextureReplacementTexture(const Common::RGBA8Image& image);
+
+  ALWAYS_INLINE Format GetFormat() const { return m_format; }
+  ALWAYS_INLINE bool IsCompressed() const { return (m_format != Format::RGBA8); }
+  ALWAYS_INLINE u32 GetWidth() const { return m_width; }
+  ALWAYS_INLINE u32 GetHeight() const { return m_height; }
+  ALWAYS_INLINE const void* GetPixels() const { return m_data.data(); }
+  ALWAYS_INLINE u32 GetDataSize() const { return static_cast<u32>(m_data.size()); }
+
+  /// Bytes per row of pixels, or per row of 4x4 blocks for compressed formats.
+  ALWAYS_INLINE u32 GetPitch() const { return GetPitch(m_format, m_width); }
+
+  /// Rows of pixels, or rows of blocks for compressed formats.
+  ALWAYS_INLINE u32 GetRows() const { return IsCompressed() ? ((m_height + 3) / 4) : m_height; }
+
+  static u32 GetPitch(Format format, u32 width);
+  static const char* GetFormatName(Format format);
+
+private:
+  std::vector<u8> m_data;
+  u32 m_width = 0;
+  u32 m_height = 0;
+  Format m_format = Format::RGBA8;
+};
 
 class TextureReplacements
 {
@@ -46,6 +94,14 @@ public:
     VRAMWrite
   };
 
+  struct CacheStats
+  {
+    u32 pending_textures;
+    u32 resident_textures;
+    u64 resident_bytes;
+    u32 evicted_textures;
+  };
+
   TextureReplacements();
   ~TextureReplacements();
 
@@ -57,16 +113,42 @@ public:
   const TextureReplacementTexture* GetVRAMWriteReplacement(u32 width, u32 height, const void* pixels);
   void DumpVRAMWrite(u32 width, u32 height, const void* pixels);
 
+  CacheStats GetCacheStats() const;
+
   void Shutdown();
 
+  /// Packs every replacement in a directory into a single pack file, which is loaded in place of the loose files.
+  static bool CompilePack(const char* source_directory, const char* output_filename);
+
 private:
   struct ReplacementHashMapHash
   {
     size_t operator()(const TextureReplacementHash& hash);
   };
 
-  using VRAMWriteReplacementMap = std::unordered_map<TextureReplacementHash, std::string>;
-  using TextureCache = std::unordered_map<std::string, TextureReplacementTexture>;
+  struct ReplacementSource
+  {
+    // Texture file, or the pack holding it.
+    std::string filename;
+
+    u64 pack_offset;
+    u32 pack_size;
+    u32 width;
+    u32 height;
+    TextureReplacementTexture::Format format;
+    bool in_pack;
+  };
+
+  struct CachedTexture
+  {
+    TextureReplacementTexture image;
+    std::list<TextureReplacementHash>::iterator lru_it;
+  };
+
+  using VRAMWriteReplacementMap = std::unordered_map<TextureReplacementHash, ReplacementSource>;
+  using TextureCache = std::unordered_map<TextureReplacementHash, CachedTexture>;
+  using PendingLoadMap =
+    std::unordered_map<TextureReplacementHash, std::future<std::optional<TextureReplacementTexture>>>;
 
   static bool ParseReplacementFilename(const std::string& filename, TextureReplacementHash* replacement_hash,
                                        ReplacmentType* replacement_type);
@@ -75,19 +157,52 @@ private:
   std::string GetDumpDirectory() const;
 
   TextureReplacementHash GetVRAMWriteHash(u32 width, u32 height, const void* pixels) const;
-  std::string GetVRAMWriteDumpFilename(u32 width, u32 height, const void* pixels) const;
 
   void FindTextures(const std::string& dir);
+  bool LoadPackIndex(const std::string& filename);
+
+  static std::optional<TextureReplacementTexture> DecodeTexture(const ReplacementSource& source);
+  static std::optional<TextureReplacementTexture> LoadDDS(const std::string& filename);
+
+  cb::ThreadPool* GetLoadPool();
+  cb::ThreadPool* GetDumpPool();
 
-  const TextureReplacementTexture* LoadTexture(const std::string& filename);
+  static void WriteVRAMWriteDump(const std::string& filename, u32 width, u32 height, const u16* pixels,
+                                 bool force_alpha_channel);
+  void LoadDumpIndex();
+  void FlushDumps();
+
+  const TextureReplacementTexture* LoadTexture(const TextureReplacementHash& hash, const ReplacementSource& source);
+  const TextureReplacementTexture* InsertTexture(const TextureReplacementHash& hash, TextureReplacementTexture image);
+  void CollectPendingLoads();
+  void EvictTextures();
   void PreloadTextures();
   void PurgeUnreferencedTexturesFromCache();
 
   std::string m_game_id;
 
+  // Most recently used at the front, evicted from the back once over the size limit.
   TextureCache m_texture_cache;
+  std::list<TextureReplacementHash> m_texture_lru;
+  u64 m_texture_cache_size = 0;
+  u32 m_evicted_textures = 0;
+
+  std::unique_ptr<cb::ThreadPool> m_load_pool;
+  PendingLoadMap m_pending_loads;
 
   VRAMWriteReplacementMap m_vram_write_replacements;
+
+  // Dumps are encoded and written on a background thread. The hashes are tracked here so the dump directory is only
+  // scanned once, and the queue is capped so a burst of uploads doesn't build up unbounded copies.
+  static constexpr u32 MAX_DUMP_QUEUE_SIZE = 64 * 1024 * 1024;
+  std::unordered_set<TextureReplacementHash> m_dumped_textures;
+  std::mutex m_dump_mutex;
+  std::condition_variable m_dump_cv;
+  u32 m_dump_queue_size = 0;
+  bool m_dump_index_loaded = false;
+
+  // Declared last so it's drained before the state the jobs use is destroyed.
+  std::unique_ptr<cb::ThreadPool> m_dump_pool;
 };
 
-extern TextureReplacements g_texture_replacements;
\ No newline at end of file
+extern TextureReplacements g_texture_replacements;
@@ -55,6 +55,7 @@ struct CounterState
 };
 
 static void UpdateCountingEnabled(CounterState& cs);
+static bool CanRaiseIRQ(const CounterState& cs);
 static void CheckForIRQ(u32 index, u32 old_counter);
 static void UpdateIRQ(u32 index);
 
@@ -63,6 +64,10 @@ static void AddSysClkTicks(void*, TickCount sysclk_ticks, TickCount ticks_late);
 static TickCount GetTicksUntilNextInterrupt();
 static void UpdateSysClkEvent();
 
+// When no timer can raise an IRQ, counters are only brought up to date when they're accessed, and the event just
+// keeps the number of ticks pending for it within range. This is in (overclocked) CPU ticks.
+static constexpr TickCount IDLE_EVENT_TICKS = 0x10000000;
+
 static std::unique_ptr<TimingEvent> s_sysclk_event;
 
 static std::array<CounterState, NUM_TIMERS> s_states{};
@@ -410,6 +415,14 @@ void Timers::UpdateCountingEnabled(CounterState& cs)
   cs.external_counting_enabled = cs.use_external_clock && cs.counting_enabled;
 }
 
+bool Timers::CanRaiseIRQ(const CounterState& cs)
+{
+  // Once a one-shot IRQ has fired, reaching the target/overflow again only changes the sticky reached flags, which
+  // are updated when the mode register is read. Toggle mode still flips the request bit, so that has to be tracked.
+  return ((cs.mode.irq_at_target || cs.mode.irq_on_overflow) &&
+          (cs.mode.irq_repeat || cs.mode.irq_pulse_n || !cs.irq_done));
+}
+
 void Timers::UpdateIRQ(u32 index)
 {
   CounterState& cs = s_states[index];
@@ -424,15 +437,12 @@ void Timers::UpdateIRQ(u32 index)
 
 TickCount Timers::GetTicksUntilNextInterrupt()
 {
-  TickCount min_ticks = System::GetMaxSliceTicks();
+  TickCount min_ticks = std::numeric_limits<TickCount>::max();
   for (u32 i = 0; i < NUM_TIMERS; i++)
   {
     const CounterState& cs = s_states[i];
-    if (!cs.counting_enabled || (i < 2 && cs.external_counting_enabled) ||
-        (!cs.mode.irq_at_target && !cs.mode.irq_on_overflow && (cs.mode.irq_repeat || !cs.irq_done)))
-    {
+    if (!cs.counting_enabled || (i < 2 && cs.external_counting_enabled) || !CanRaiseIRQ(cs))
       continue;
-    }
 
     if (cs.mode.irq_at_target)
     {
@@ -453,6 +463,9 @@ TickCount Timers::GetTicksUntilNextInterrupt()
     }
   }
 
+  if (min_ticks == std::numeric_limits<TickCount>::max())
+    return IDLE_EVENT_TICKS;
+
   return System::ScaleTicksToOverclock(std::max<TickCount>(1, min_ticks));
 }
 
@@ -4,20 +4,44 @@
 #include "timing_event.h"
 #include "common/assert.h"
 #include "common/log.h"
+#include "common/timer.h"
+#include "common/trace.h"
 #include "cpu_core.h"
 #include "cpu_core_private.h"
+#include "host.h"
+#include "imgui.h"
+#include "settings.h"
 #include "system.h"
 #include "util/state_wrapper.h"
+#include "xxhash.h"
+#include <algorithm>
+#include <array>
+#include <cinttypes>
 Log_SetChannel(TimingEvents);
 
 namespace TimingEvents {
 
-static TimingEvent* s_active_events_head;
-static TimingEvent* s_active_events_tail;
+// Active events are kept in a binary min-heap ordered by downcount, so the next event is always at the front.
+// The array is fixed so the recompiler dispatchers can read the front event through a stable pointer.
+static constexpr u32 MAX_ACTIVE_EVENTS = 32;
+static std::array<TimingEvent*, MAX_ACTIVE_EVENTS> s_active_events = {};
 static TimingEvent* s_current_event = nullptr;
 static u32 s_active_event_count = 0;
+
+// Events with the same downcount are ordered by these counters, which reproduce the sorted list this replaced.
+static s64 s_next_front_order = 0;
+static s64 s_next_back_order = 1;
 static u32 s_global_tick_counter = 0;
 
+// All events, active or not, for the statistics window.
+static std::vector<TimingEvent*> s_all_events;
+static bool s_callback_timing_enabled = false;
+
+static bool ShouldTimeCallbacks()
+{
+  return s_callback_timing_enabled || g_settings.debugging.show_timing_events;
+}
+
 u32 GetGlobalTickCounter()
 {
   return s_global_tick_counter;
@@ -53,208 +77,158 @@ void UpdateCPUDowncount()
 {
   if (!CPU::g_state.frame_done && (!CPU::HasPendingInterrupt() || CPU::g_using_interpreter))
   {
-    CPU::g_state.downcount = s_active_events_head->GetDowncount();
+    CPU::g_state.downcount = s_active_events[0]->GetDowncount();
   }
 }
 
 TimingEvent** GetHeadEventPtr()
 {
-  return &s_active_events_head;
+  return &s_active_events[0];
 }
 
-static void SortEvent(TimingEvent* event)
+static bool IsEventBefore(const TimingEvent* lhs, const TimingEvent* rhs)
 {
-  const TickCount event_downcount = event->m_downcount;
+  return (lhs->m_downcount < rhs->m_downcount || (lhs->m_downcount == rhs->m_downcount && lhs->m_order < rhs->m_order));
+}
 
-  if (event->prev && event->prev->m_downcount > event_downcount)
+static void SiftUp(u32 index)
+{
+  TimingEvent* event = s_active_events[index];
+  while (index > 0)
   {
-    // move backwards
-    TimingEvent* current = event->prev;
-    while (current && current->m_downcount > event_downcount)
-      current = current->prev;
-
-    // unlink
-    if (event->prev)
-      event->prev->next = event->next;
-    else
-      s_active_events_head = event->next;
-    if (event->next)
-      event->next->prev = event->prev;
-    else
-      s_active_events_tail = event->prev;
-
-    // insert after current
-    if (current)
-    {
-      event->next = current->next;
-      if (current->next)
-        current->next->prev = event;
-      else
-        s_active_events_tail = event;
+    const u32 parent = (index - 1) / 2;
+    if (!IsEventBefore(event, s_active_events[parent]))
+      break;
 
-      event->prev = current;
-      current->next = event;
-    }
-    else
-    {
-      // insert at front
-      DebugAssert(s_active_events_head);
-      s_active_events_head->prev = event;
-      event->prev = nullptr;
-      event->next = s_active_events_head;
-      s_active_events_head = event;
-      UpdateCPUDowncount();
-    }
+    s_active_events[index] = s_active_events[parent];
+    s_active_events[index]->m_heap_index = index;
+    index = parent;
   }
-  else if (event->next && event_downcount > event->next->m_downcount)
+
+  s_active_events[index] = event;
+  event->m_heap_index = index;
+}
+
+static void SiftDown(u32 index)
+{
+  TimingEvent* event = s_active_events[index];
+  for (;;)
   {
-    // move forwards
-    TimingEvent* current = event->next;
-    while (current && event_downcount > current->m_downcount)
-      current = current->next;
-
-    // unlink
-    if (event->prev)
-      event->prev->next = event->next;
-    else
-      s_active_events_head = event->next;
-    if (event->next)
-      event->next->prev = event->prev;
-    else
-      s_active_events_tail = event->prev;
+    u32 child = (index * 2) + 1;
+    if (child >= s_active_event_count)
+      break;
+    if ((child + 1) < s_active_event_count && IsEventBefore(s_active_events[child + 1], s_active_events[child]))
+      child++;
+    if (!IsEventBefore(s_active_events[child], event))
+      break;
+
+    s_active_events[index] = s_active_events[child];
+    s_active_events[index]->m_heap_index = index;
+    index = child;
+  }
 
-    // insert before current
-    if (current)
-    {
-      event->next = current;
-      event->prev = current->prev;
+  s_active_events[index] = event;
+  event->m_heap_index = index;
+}
 
-      if (current->prev)
-        current->prev->next = event;
-      else
-        s_active_events_head = event;
+static void InsertEvent(TimingEvent* event)
+{
+  if (s_active_event_count == MAX_ACTIVE_EVENTS)
+    Panic("Too many active timing events");
 
-      current->prev = event;
-    }
-    else
-    {
-      // insert at back
-      DebugAssert(s_active_events_tail);
-      s_active_events_tail->next = event;
-      event->next = nullptr;
-      event->prev = s_active_events_tail;
-      s_active_events_tail = event;
-    }
-  }
+  const u32 index = s_active_event_count++;
+  s_active_events[index] = event;
+  SiftUp(index);
 }
 
-static void AddActiveEvent(TimingEvent* event)
+static void RemoveEvent(TimingEvent* event)
 {
-  DebugAssert(!event->prev && !event->next);
-  s_active_event_count++;
+  const u32 index = event->m_heap_index;
+  DebugAssert(index < s_active_event_count && s_active_events[index] == event);
 
-  TimingEvent* current = nullptr;
-  TimingEvent* next = s_active_events_head;
-  while (next && event->m_downcount > next->m_downcount)
+  const u32 last = --s_active_event_count;
+  if (index != last)
   {
-    current = next;
-    next = next->next;
+    s_active_events[index] = s_active_events[last];
+    s_active_events[index]->m_heap_index = index;
+    if (index > 0 && IsEventBefore(s_active_events[index], s_active_events[(index - 1) / 2]))
+      SiftUp(index);
+    else
+      SiftDown(index);
   }
 
-  if (!next)
+  s_active_events[last] = nullptr;
+  event->m_heap_index = TimingEvent::INVALID_HEAP_INDEX;
+}
+
+static void SortEvent(TimingEvent* event, TickCount old_downcount)
+{
+  // An event moving earlier goes after any others with the same downcount, and one moving later goes before them.
+  const u32 old_index = event->m_heap_index;
+  if (event->m_downcount < old_downcount)
   {
-    // new tail
-    event->prev = s_active_events_tail;
-    if (s_active_events_tail)
-    {
-      s_active_events_tail->next = event;
-      s_active_events_tail = event;
-    }
-    else
-    {
-      // first event
-      s_active_events_tail = event;
-      s_active_events_head = event;
+    event->m_order = s_next_back_order++;
+    SiftUp(old_index);
+    if (old_index != 0 && event->m_heap_index == 0)
       UpdateCPUDowncount();
-    }
-  }
-  else if (!current)
-  {
-    // new head
-    event->next = s_active_events_head;
-    s_active_events_head->prev = event;
-    s_active_events_head = event;
-    UpdateCPUDowncount();
   }
-  else
+  else if (event->m_downcount > old_downcount)
   {
-    // inbetween current < event > next
-    event->prev = current;
-    event->next = next;
-    current->next = event;
-    next->prev = event;
+    event->m_order = s_next_front_order--;
+    SiftDown(old_index);
   }
 }
 
-static void RemoveActiveEvent(TimingEvent* event)
+static void AddActiveEvent(TimingEvent* event)
 {
-  DebugAssert(s_active_event_count > 0);
+  DebugAssert(event->m_heap_index == TimingEvent::INVALID_HEAP_INDEX);
 
-  if (event->next)
-  {
-    event->next->prev = event->prev;
-  }
-  else
-  {
-    s_active_events_tail = event->prev;
-  }
+  // New events go before any others with the same downcount.
+  event->m_order = s_next_front_order--;
+  InsertEvent(event);
+  if (event->m_heap_index == 0)
+    UpdateCPUDowncount();
+}
 
-  if (event->prev)
-  {
-    event->prev->next = event->next;
-  }
-  else
+static void RemoveActiveEvent(TimingEvent* event)
+{
+  // The event being run is taken out of the heap during its callback.
+  if (event->m_heap_index == TimingEvent::INVALID_HEAP_INDEX)
   {
-    s_active_events_head = event->next;
-    if (s_active_events_head)
-      UpdateCPUDowncount();
+    DebugAssert(event == s_current_event);
+    return;
   }
 
-  event->prev = nullptr;
-  event->next = nullptr;
-
-  s_active_event_count--;
+  const bool was_head = (event->m_heap_index == 0);
+  RemoveEvent(event);
+  if (was_head && s_active_event_count > 0)
+    UpdateCPUDowncount();
 }
 
-static void SortEvents()
+static u32 GetSortedActiveEvents(std::array<TimingEvent*, MAX_ACTIVE_EVENTS>* events)
 {
-  std::vector<TimingEvent*> events;
-  events.reserve(s_active_event_count);
-
-  TimingEvent* next = s_active_events_head;
-  while (next)
-  {
-    TimingEvent* current = next;
-    events.push_back(current);
-    next = current->next;
-    current->prev = nullptr;
-    current->next = nullptr;
-  }
+  std::copy_n(s_active_events.begin(), s_active_event_count, events->begin());
+  std::sort(events->begin(), events->begin() + s_active_event_count, IsEventBefore);
+  return s_active_event_count;
+}
 
-  s_active_events_head = nullptr;
-  s_active_events_tail = nullptr;
+static void SortEvents(const std::array<TimingEvent*, MAX_ACTIVE_EVENTS>& events, u32 count)
+{
+  for (u32 i = 0; i < s_active_event_count; i++)
+    s_active_events[i]->m_heap_index = TimingEvent::INVALID_HEAP_INDEX;
+  s_active_events.fill(nullptr);
   s_active_event_count = 0;
 
-  for (TimingEvent* event : events)
-    AddActiveEvent(event);
+  for (u32 i = 0; i < count; i++)
+    AddActiveEvent(events[i]);
 }
 
 static TimingEvent* FindActiveEvent(const char* name)
 {
-  for (TimingEvent* event = s_active_events_head; event; event = event->next)
+  for (u32 i = 0; i < s_active_event_count; i++)
   {
-    if (event->GetName().compare(name) == 0)
-      return event;
+    if (s_active_events[i]->GetName().compare(name) == 0)
+      return s_active_events[i];
   }
 
   return nullptr;
@@ -263,40 +237,62 @@ static TimingEvent* FindActiveEvent(const char* name)
 void RunEvents()
 {
   DebugAssert(!s_current_event);
+  TRACE_SCOPE("RunEvents");
 
+  const bool time_callbacks = ShouldTimeCallbacks();
   TickCount pending_ticks = CPU::GetPendingTicks();
   CPU::ResetPendingTicks();
   while (pending_ticks > 0)
   {
-    const TickCount time = std::min(pending_ticks, s_active_events_head->GetDowncount());
+    const TickCount time = std::min(pending_ticks, s_active_events[0]->GetDowncount());
     s_global_tick_counter += static_cast<u32>(time);
     pending_ticks -= time;
 
-    // Apply downcount to all events.
+    // Apply downcount to all events. Since every event moves by the same amount, the heap order doesn't change.
     // This will result in a negative downcount for those events which are late.
-    for (TimingEvent* event = s_active_events_head; event; event = event->next)
+    for (u32 i = 0; i < s_active_event_count; i++)
     {
+      TimingEvent* event = s_active_events[i];
       event->m_downcount -= time;
       event->m_time_since_last_run += time;
     }
 
     // Now we can actually run the callbacks.
-    while (s_active_events_head->m_downcount <= 0)
+    while (s_active_events[0]->m_downcount <= 0)
     {
-      // move it to the end, since that'll likely be its new position
-      TimingEvent* event = s_active_events_head;
+      // Take the event out of the heap while the callback runs, it's put back afterwards if it's still active.
+      TimingEvent* event = s_active_events[0];
       s_current_event = event;
+      RemoveEvent(event);
 
       // Factor late time into the time for the next invocation.
+      const TickCount old_downcount = event->m_downcount;
       const TickCount ticks_late = -event->m_downcount;
       const TickCount ticks_to_execute = event->m_time_since_last_run;
       event->m_downcount += event->m_interval;
       event->m_time_since_last_run = 0;
 
+      event->m_stats.invocations++;
+      event->m_stats.ticks_executed += static_cast<u64>(std::max(ticks_to_execute, 0));
+
       // The cycles_late is only an indicator, it doesn't modify the cycles to execute.
-      event->m_callback(event->m_callback_param, ticks_to_execute, ticks_late);
-      if (event->m_active)
-        SortEvent(event);
+      if (time_callbacks)
+      {
+        const Common::Timer::Value start_time = Common::Timer::GetCurrentValue();
+        event->m_callback(event->m_callback_param, ticks_to_execute, ticks_late);
+        event->m_stats.callback_time += Common::Timer::GetCurrentValue() - start_time;
+      }
+      else
+      {
+        event->m_callback(event->m_callback_param, ticks_to_execute, ticks_late);
+      }
+      if (event->m_active && event->m_heap_index == TimingEvent::INVALID_HEAP_INDEX)
+      {
+        event->m_order = (event->m_downcount < old_downcount) ? s_next_back_order++ : s_next_front_order--;
+        InsertEvent(event);
+      }
+
+      DebugAssert(s_active_event_count > 0);
     }
   }
 
@@ -315,6 +311,10 @@ bool DoState(StateWrapper& sw)
     u32 event_count = 0;
     sw.Do(&event_count);
 
+    // Events are re-added in their current order once the new times are loaded.
+    std::array<TimingEvent*, MAX_ACTIVE_EVENTS> events;
+    const u32 active_event_count = GetSortedActiveEvents(&events);
+
     for (u32 i = 0; i < event_count; i++)
     {
       std::string event_name;
@@ -348,15 +348,18 @@ bool DoState(StateWrapper& sw)
     }
 
     Log_DevPrintf("Loaded %u events from save state.", event_count);
-    SortEvents();
+    SortEvents(events, active_event_count);
   }
   else
   {
+    // Written in order of execution, the same as the old sorted list.
+    std::array<TimingEvent*, MAX_ACTIVE_EVENTS> events;
+    u32 active_event_count = GetSortedActiveEvents(&events);
+    sw.Do(&active_event_count);
 
-    sw.Do(&s_active_event_count);
-
-    for (TimingEvent* event = s_active_events_head; event; event = event->next)
+    for (u32 i = 0; i < active_event_count; i++)
     {
+      TimingEvent* event = events[i];
       sw.Do(&event->m_name);
       sw.Do(&event->m_downcount);
       sw.Do(&event->m_time_since_last_run);
@@ -370,6 +373,139 @@ bool DoState(StateWrapper& sw)
   return !sw.HasError();
 }
 
+u64 GetStateHash()
+{
+  std::array<TimingEvent*, MAX_ACTIVE_EVENTS> events;
+  const u32 active_event_count = GetSortedActiveEvents(&events);
+
+  u64 hash = XXH3_64bits(&s_global_tick_counter, sizeof(s_global_tick_counter));
+  for (u32 i = 0; i < active_event_count; i++)
+  {
+    const TimingEvent* event = events[i];
+    const std::array<TickCount, 4> timing = {event->m_downcount, event->m_time_since_last_run, event->m_period,
+                                             event->m_interval};
+    hash = XXH3_64bits_withSeed(event->m_name.data(), event->m_name.size(), hash);
+    hash = XXH3_64bits_withSeed(timing.data(), sizeof(timing), hash);
+  }
+
+  return hash;
+}
+
+std::vector<EventStats> GetEventStats()
+{
+  std::vector<EventStats> ret;
+  ret.reserve(s_all_events.size());
+  for (const TimingEvent* event : s_all_events)
+    ret.push_back(EventStats{event->GetName(), event->GetStats(), event->IsActive()});
+
+  return ret;
+}
+
+void ResetEventStats()
+{
+  for (TimingEvent* event : s_all_events)
+    event->m_stats = {};
+}
+
+void SetCallbackTimingEnabled(bool enabled)
+{
+  s_callback_timing_enabled = enabled;
+}
+
+void DrawStatsWindow()
+{
+  enum : u32
+  {
+    COLUMN_NAME,
+    COLUMN_INVOCATIONS,
+    COLUMN_RESCHEDULES,
+    COLUMN_AVERAGE_TICKS,
+    COLUMN_CALLBACK_TIME,
+  };
+
+  const float framebuffer_scale = Host::GetOSDScale();
+
+  ImGui::SetNextWindowSize(ImVec2(600.0f * framebuffer_scale, 400.0f * framebuffer_scale), ImGuiCond_FirstUseEver);
+  if (!ImGui::Begin("Timing Events", nullptr))
+  {
+    ImGui::End();
+    return;
+  }
+
+  if (ImGui::Button("Reset"))
+    ResetEventStats();
+
+  ImGui::SameLine();
+  ImGui::Text("%u of %zu events active", s_active_event_count, s_all_events.size());
+
+  std::vector<EventStats> rows = GetEventStats();
+
+  const ImGuiTableFlags flags = ImGuiTableFlags_Sortable | ImGuiTableFlags_RowBg | ImGuiTableFlags_Borders;
+  if (ImGui::BeginTable("TimingEvents", 5, flags))
+  {
+    ImGui::TableSetupColumn("Event", 0, 0.0f, COLUMN_NAME);
+    ImGui::TableSetupColumn("Invocations", ImGuiTableColumnFlags_PreferSortDescending, 0.0f, COLUMN_INVOCATIONS);
+    ImGui::TableSetupColumn("Reschedules", ImGuiTableColumnFlags_PreferSortDescending, 0.0f, COLUMN_RESCHEDULES);
+    ImGui::TableSetupColumn("Avg Ticks", ImGuiTableColumnFlags_PreferSortDescending, 0.0f, COLUMN_AVERAGE_TICKS);
+    ImGui::TableSetupColumn("Callback ms",
+                            ImGuiTableColumnFlags_DefaultSort | ImGuiTableColumnFlags_PreferSortDescending, 0.0f,
+                            COLUMN_CALLBACK_TIME);
+    ImGui::TableHeadersRow();
+
+    const auto average_ticks = [](const TimingEvent::Stats& stats) {
+      return (stats.invocations > 0) ? (static_cast<double>(stats.ticks_executed) / stats.invocations) : 0.0;
+    };
+
+    const ImGuiTableSortSpecs* sort_specs = ImGui::TableGetSortSpecs();
+    if (sort_specs && sort_specs->SpecsCount > 0)
+    {
+      const ImGuiTableColumnSortSpecs& spec = sort_specs->Specs[0];
+      const bool descending = (spec.SortDirection == ImGuiSortDirection_Descending);
+      std::sort(rows.begin(), rows.end(),
+                [column = spec.ColumnUserID, descending, &average_ticks](const EventStats& lhs, const EventStats& rhs) {
+                  const EventStats& a = descending ? rhs : lhs;
+                  const EventStats& b = descending ? lhs : rhs;
+                  switch (column)
+                  {
+                    case COLUMN_INVOCATIONS:
+                      return a.stats.invocations < b.stats.invocations;
+                    case COLUMN_RESCHEDULES:
+                      return a.stats.reschedules < b.stats.reschedules;
+                    case COLUMN_AVERAGE_TICKS:
+                      return average_ticks(a.stats) < average_ticks(b.stats);
+                    case COLUMN_CALLBACK_TIME:
+                      return a.stats.callback_time < b.stats.callback_time;
+                    case COLUMN_NAME:
+                    default:
+                      return a.name < b.name;
+                  }
+                });
+    }
+
+    for (const EventStats& row : rows)
+    {
+      ImGui::TableNextRow();
+      ImGui::TableNextColumn();
+      if (row.active)
+        ImGui::TextUnformatted(row.name.c_str());
+      else
+        ImGui::TextDisabled("%s", row.name.c_str());
+      ImGui::TableNextColumn();
+      ImGui::Text("%" PRIu64, row.stats.invocations);
+      ImGui::TableNextColumn();
+      ImGui::Text("%" PRIu64, row.stats.reschedules);
+      ImGui::TableNextColumn();
+      ImGui::Text("%.1f", average_ticks(row.stats));
+      ImGui::TableNextColumn();
+      ImGui::Text("%.3f", Common::Timer::ConvertValueToMilliseconds(row.stats.callback_time));
+    }
+
+    ImGui::EndTable();
+  }
+
+  ImGui::End();
+}
+
 } // namespace TimingEvents
 
 TimingEvent::TimingEvent(std::string name, TickCount period, TickCount interval, TimingEventCallback callback,
@@ -377,12 +513,17 @@ TimingEvent::TimingEvent(std::string name, TickCount period, TickCount interval,
   : m_callback(callback), m_callback_param(callback_param), m_downcount(interval), m_time_since_last_run(0),
     m_period(period), m_interval(interval), m_name(std::move(name))
 {
+  TimingEvents::s_all_events.push_back(this);
 }
 
 TimingEvent::~TimingEvent()
 {
   if (m_active)
     TimingEvents::RemoveActiveEvent(this);
+
+  auto it = std::find(TimingEvents::s_all_events.begin(), TimingEvents::s_all_events.end(), this);
+  if (it != TimingEvents::s_all_events.end())
+    TimingEvents::s_all_events.erase(it);
 }
 
 TickCount TimingEvent::GetTicksSinceLastExecution() const
@@ -403,16 +544,20 @@ void TimingEvent::Delay(TickCount ticks)
     return;
   }
 
+  const TickCount old_downcount = m_downcount;
   m_downcount += ticks;
+  m_stats.reschedules++;
 
   DebugAssert(TimingEvents::s_current_event != this);
-  TimingEvents::SortEvent(this);
+  TimingEvents::SortEvent(this, old_downcount);
 }
 
 void TimingEvent::Schedule(TickCount ticks)
 {
   const TickCount pending_ticks = CPU::GetPendingTicks();
+  const TickCount old_downcount = m_downcount;
   m_downcount = pending_ticks + ticks;
+  m_stats.reschedules++;
 
   if (!m_active)
   {
@@ -426,7 +571,7 @@ void TimingEvent::Schedule(TickCount ticks)
     // Event is already active, so we leave the time since last run alone, and just modify the downcount.
     // If this is a call from an IO handler for example, re-sort the event queue.
     if (TimingEvents::s_current_event != this)
-      TimingEvents::SortEvent(this);
+      TimingEvents::SortEvent(this, old_downcount);
   }
 }
 
@@ -448,10 +593,12 @@ void TimingEvent::Reset()
   if (!m_active)
     return;
 
+  const TickCount old_downcount = m_downcount;
   m_downcount = m_interval;
   m_time_since_last_run = 0;
+  m_stats.reschedules++;
   if (TimingEvents::s_current_event != this)
-    TimingEvents::SortEvent(this);
+    TimingEvents::SortEvent(this, old_downcount);
 }
 
 void TimingEvent::InvokeEarly(bool force /* = false */)
@@ -464,13 +611,27 @@ void TimingEvent::InvokeEarly(bool force /* = false */)
   if ((!force && ticks_to_execute < m_period) || ticks_to_execute <= 0)
     return;
 
+  const TickCount old_downcount = m_downcount;
   m_downcount = pending_ticks + m_interval;
   m_time_since_last_run -= ticks_to_execute;
-  m_callback(m_callback_param, ticks_to_execute, 0);
 
-  // Since we've changed the downcount, we need to re-sort the events.
+  // Since we've changed the downcount, we need to re-sort the events. Do it before the callback, so the queue is in
+  // order if the callback reschedules or deactivates this event.
   DebugAssert(TimingEvents::s_current_event != this);
-  TimingEvents::SortEvent(this);
+  TimingEvents::SortEvent(this, old_downcount);
+
+  m_stats.invocations++;
+  m_stats.ticks_executed += static_cast<u64>(ticks_to_execute);
+  if (TimingEvents::ShouldTimeCallbacks())
+  {
+    const Common::Timer::Value start_time = Common::Timer::GetCurrentValue();
+    m_callback(m_callback_param, ticks_to_execute, 0);
+    m_stats.callback_time += Common::Timer::GetCurrentValue() - start_time;
+  }
+  else
+  {
+    m_callback(m_callback_param, ticks_to_execute, 0);
+  }
 }
 
 void TimingEvent::Activate()
@@ -17,6 +17,20 @@ using TimingEventCallback = void (*)(void* param, TickCount ticks, TickCount tic
 class TimingEvent
 {
 public:
+  enum : u32
+  {
+    INVALID_HEAP_INDEX = 0xFFFFFFFFu
+  };
+
+  // Scheduling statistics, for finding which events are worth optimizing.
+  struct Stats
+  {
+    u64 invocations;
+    u64 reschedules;
+    u64 ticks_executed;
+    u64 callback_time; // Common::Timer ticks, only collected while callback timing is enabled.
+  };
+
   TimingEvent(std::string name, TickCount period, TickCount interval, TimingEventCallback callback,
               void* callback_param);
   ~TimingEvent();
@@ -28,6 +42,7 @@ public:
   ALWAYS_INLINE TickCount GetPeriod() const { return m_period; }
   ALWAYS_INLINE TickCount GetInterval() const { return m_interval; }
   ALWAYS_INLINE TickCount GetDowncount() const { return m_downcount; }
+  ALWAYS_INLINE const Stats& GetStats() const { return m_stats; }
 
   // Includes pending time.
   TickCount GetTicksSinceLastExecution() const;
@@ -63,8 +78,9 @@ public:
   void SetInterval(TickCount interval) { m_interval = interval; }
   void SetPeriod(TickCount period) { m_period = period; }
 
-  TimingEvent* prev = nullptr;
-  TimingEvent* next = nullptr;
+  // Position in the active event heap, and ordering between events with the same downcount.
+  u32 m_heap_index = INVALID_HEAP_INDEX;
+  s64 m_order = 0;
 
   TimingEventCallback m_callback;
   void* m_callback_param;
@@ -75,6 +91,8 @@ public:
   TickCount m_interval;
   bool m_active = false;
 
+  Stats m_stats = {};
+
   std::string m_name;
 };
 
@@ -93,10 +111,27 @@ std::unique_ptr<TimingEvent> CreateTimingEvent(std::string name, TickCount perio
 /// Serialization.
 bool DoState(StateWrapper& sw);
 
+/// Returns a hash of the global tick counter and the timing of the active events, in execution order.
+u64 GetStateHash();
+
 void RunEvents();
 
 void UpdateCPUDowncount();
 
 TimingEvent** GetHeadEventPtr();
 
+/// Statistics for every event which currently exists, whether active or not.
+struct EventStats
+{
+  std::string name;
+  TimingEvent::Stats stats;
+  bool active;
+};
+std::vector<EventStats> GetEventStats();
+void ResetEventStats();
+
+/// Callbacks are timed while this is enabled or the debug window is shown, since it costs two timer reads per event.
+void SetCallbackTimingEnabled(bool enabled);
+void DrawStatsWindow();
+
 } // namespace TimingEvents
\ No newline at end of file
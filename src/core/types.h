@@ -91,6 +91,14 @@ enum class GPUDownsampleMode : u8
   Count
 };
 
+enum class GPUShaderMode : u8
+{
+  Specialized,
+  Uber,
+  UberUntilSpecializedReady,
+  Count
+};
+
 enum class DisplayCropMode : u8
 {
   None,
@@ -182,6 +190,14 @@ enum class CPUFastmemMode
   Count
 };
 
+enum class ThreadAffinityPolicy : u8
+{
+  Disabled,
+  Automatic,
+  Always,
+  Count
+};
+
 enum : size_t
 {
   HOST_PAGE_SIZE = 4096,
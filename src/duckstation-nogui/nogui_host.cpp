@@ -10,6 +10,8 @@
 #include "common/path.h"
 #include "common/string_util.h"
 #include "common/threading.h"
+#include "common/timer.h"
+#include "common/trace.h"
 #include "core/controller.h"
 #include "core/gpu.h"
 #include "core/host.h"
@@ -17,6 +19,7 @@
 #include "core/host_settings.h"
 #include "core/settings.h"
 #include "core/system.h"
+#include "core/texture_replacements.h"
 #include "frontend-common/common_host.h"
 #include "frontend-common/fullscreen_ui.h"
 #include "frontend-common/game_list.h"
@@ -50,6 +53,7 @@ Log_SetChannel(NoGUIHost);
 static constexpr u32 SETTINGS_VERSION = 3;
 static constexpr auto CPU_THREAD_POLL_INTERVAL =
   std::chrono::milliseconds(8); // how often we'll poll controllers when paused
+static constexpr double IDLE_RENDER_INTERVAL = 0.5; // how often the paused UI is redrawn when nothing is happening
 
 std::unique_ptr<NoGUIPlatform> g_nogui_window;
 
@@ -637,6 +641,8 @@ void NoGUIHost::CPUThreadEntryPoint()
 
 void NoGUIHost::CPUThreadMainLoop()
 {
+  Common::Timer::Value last_render_time = 0;
+
   while (s_running.load(std::memory_order_acquire))
   {
     if (System::IsRunning())
@@ -646,7 +652,20 @@ void NoGUIHost::CPUThreadMainLoop()
     }
 
     Host::PumpMessagesOnCPUThread();
+
+    // while paused with nothing changing on screen, sleep until the next poll instead of redrawing every vblank
+    if (System::IsPaused() && ImGuiManager::IsUIIdle() &&
+        Common::Timer::ConvertValueToSeconds(Common::Timer::GetCurrentValue() - last_render_time) <
+          IDLE_RENDER_INTERVAL)
+    {
+      std::unique_lock lock(s_cpu_thread_events_mutex);
+      s_cpu_thread_event_posted.wait_for(lock, CPU_THREAD_POLL_INTERVAL,
+                                         []() { return !s_cpu_thread_events.empty(); });
+      continue;
+    }
+
     Host::RenderDisplay(false);
+    last_render_time = Common::Timer::GetCurrentValue();
     if (!g_host_display->IsVsyncEnabled())
       g_host_display->ThrottlePresentation();
   }
@@ -798,7 +817,10 @@ void Host::RenderDisplay(bool skip_present)
   ImGuiManager::RenderOverlayWindows();
   ImGuiManager::RenderDebugWindows();
 
-  g_host_display->Render(skip_present);
+  {
+    TRACE_SCOPE("HostDisplay::Render");
+    g_host_display->Render(skip_present);
+  }
 
   ImGuiManager::NewFrame();
 }
@@ -1080,12 +1102,17 @@ void NoGUIHost::PrintCommandLineHelp(const char* progname)
   std::fprintf(stderr, "  -statefile <filename>: Loads state from the specified filename.\n"
                        "    No boot filename is required with this option.\n");
   std::fprintf(stderr, "  -exe <filename>: Boot the specified exe instead of loading from disc.\n");
+  std::fprintf(stderr, "  -record <filename>: Records controller input to an input movie until\n"
+                       "    the system is shut down.\n");
+  std::fprintf(stderr, "  -replay <filename>: Replays the input from an input movie.\n");
   std::fprintf(stderr, "  -fullscreen: Enters fullscreen mode immediately after starting.\n");
   std::fprintf(stderr, "  -nofullscreen: Prevents fullscreen mode from triggering if enabled.\n");
   std::fprintf(stderr, "  -portable: Forces \"portable mode\", data in same directory.\n");
   std::fprintf(stderr, "  -settings <filename>: Loads a custom settings configuration from the\n"
                        "    specified filename. Default settings applied if file not found.\n");
   std::fprintf(stderr, "  -earlyconsole: Creates console as early as possible, for logging.\n");
+  std::fprintf(stderr, "  -compiletexturepack <directory> <filename>: Packs the replacement textures in\n"
+                       "    the specified directory into a single indexed file, and exits.\n");
   std::fprintf(stderr, "  --: Signals that no more arguments will follow and the remaining\n"
                        "    parameters make up the filename. Use when the filename contains\n"
                        "    spaces or starts with a dash.\n");
@@ -1181,6 +1208,18 @@ bool NoGUIHost::ParseCommandLineParametersAndInitializeConfig(int argc, char* ar
         Log_InfoPrintf("Command Line: Overriding EXE file: '%s'", autoboot->override_exe.c_str());
         continue;
       }
+      else if (CHECK_ARG_PARAM("-record"))
+      {
+        AutoBoot(autoboot)->record_input_movie = argv[++i];
+        Log_InfoPrintf("Command Line: Recording input movie: '%s'", autoboot->record_input_movie.c_str());
+        continue;
+      }
+      else if (CHECK_ARG_PARAM("-replay"))
+      {
+        AutoBoot(autoboot)->replay_input_movie = argv[++i];
+        Log_InfoPrintf("Command Line: Replaying input movie: '%s'", autoboot->replay_input_movie.c_str());
+        continue;
+      }
       else if (CHECK_ARG("-fullscreen"))
       {
         Log_InfoPrintf("Command Line: Using fullscreen.");
@@ -1211,6 +1250,13 @@ bool NoGUIHost::ParseCommandLineParametersAndInitializeConfig(int argc, char* ar
         InitializeEarlyConsole();
         continue;
       }
+      else if (CHECK_ARG("-compiletexturepack") && (i + 2) < argc)
+      {
+        InitializeEarlyConsole();
+        const char* source_directory = argv[++i];
+        const char* output_filename = argv[++i];
+        std::exit(TextureReplacements::CompilePack(source_directory, output_filename) ? EXIT_SUCCESS : EXIT_FAILURE);
+      }
       else if (CHECK_ARG("--"))
       {
         no_more_args = true;
@@ -10,8 +10,11 @@
 #include "nogui_host.h"
 #include "resource.h"
 #include "vty_key_names.h"
+#include <cerrno>
 #include <fcntl.h>
 #include <linux/input-event-codes.h>
+#include <poll.h>
+#include <sys/eventfd.h>
 #include <thread>
 #include <unistd.h>
 Log_SetChannel(VTYNoGUIPlatform);
@@ -28,6 +31,9 @@ VTYNoGUIPlatform::VTYNoGUIPlatform()
 VTYNoGUIPlatform::~VTYNoGUIPlatform()
 {
   CloseEVDevFDs();
+
+  if (m_wakeup_fd >= 0)
+    close(m_wakeup_fd);
 }
 
 std::unique_ptr<NoGUIPlatform> NoGUIPlatform::CreateVTYPlatform()
@@ -40,6 +46,13 @@ std::unique_ptr<NoGUIPlatform> NoGUIPlatform::CreateVTYPlatform()
 
 bool VTYNoGUIPlatform::Initialize()
 {
+  m_wakeup_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  if (m_wakeup_fd < 0)
+  {
+    Log_ErrorPrintf("eventfd() failed: %d", errno);
+    return false;
+  }
+
   OpenEVDevFDs();
   return true;
 }
@@ -96,11 +109,14 @@ std::optional<WindowInfo> VTYNoGUIPlatform::GetPlatformWindowInfo()
     if (!DRMDisplay::GetCurrentMode(&wi.surface_width, &wi.surface_height, &wi.surface_refresh_rate))
       Log_ErrorPrintf("Failed to get current mode, will use default.");
   }
+
+  // rendering below the mode resolution, the display controller scales up on scanout
+  wi.surface_render_scale = std::clamp(Host::GetFloatSettingValue("Display", "DRMRenderScale", 1.0f), 0.25f, 1.0f);
 #endif
 
   // This isn't great, but it's an approximation at least..
   if (wi.surface_width > 0)
-    wi.surface_scale = std::max(0.1f, static_cast<float>(wi.surface_width) / 1280.0f);
+    wi.surface_scale = std::max(0.1f, static_cast<float>(wi.surface_width) * wi.surface_render_scale / 1280.0f);
 
   return wi;
 }
@@ -151,20 +167,62 @@ void VTYNoGUIPlatform::RunMessageLoop()
       }
     }
 
-    // TODO: Make this suck less.
-    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    if (!m_message_loop_running.load(std::memory_order_acquire))
+      break;
+
+    // Block until a keyboard has input or we're woken.
+    std::vector<pollfd> fds;
+    fds.reserve(m_evdev_keyboards.size() + 1);
+    fds.push_back(pollfd{m_wakeup_fd, POLLIN, 0});
+    for (const EvDevKeyboard& kb : m_evdev_keyboards)
+      fds.push_back(pollfd{kb.fd, POLLIN, 0});
+
+    if (poll(fds.data(), static_cast<nfds_t>(fds.size()), -1) > 0)
+    {
+      if (fds[0].revents & POLLIN)
+      {
+        u64 value;
+        while (read(m_wakeup_fd, &value, sizeof(value)) > 0)
+          ;
+      }
+
+      // unplugged keyboards would otherwise wake us up continuously
+      for (size_t i = m_evdev_keyboards.size(); i > 0; i--)
+      {
+        if (!(fds[i].revents & (POLLERR | POLLHUP | POLLNVAL)))
+          continue;
+
+        const EvDevKeyboard& kb = m_evdev_keyboards[i - 1];
+        Log_WarningPrintf("Removing keyboard %s", libevdev_get_name(kb.obj));
+        libevdev_free(kb.obj);
+        close(kb.fd);
+        m_evdev_keyboards.erase(m_evdev_keyboards.begin() + (i - 1));
+      }
+    }
   }
 }
 
 void VTYNoGUIPlatform::ExecuteInMessageLoop(std::function<void()> func)
 {
-  std::unique_lock lock(m_callback_queue_mutex);
-  m_callback_queue.push_back(std::move(func));
+  {
+    std::unique_lock lock(m_callback_queue_mutex);
+    m_callback_queue.push_back(std::move(func));
+  }
+
+  WakeMessageLoop();
 }
 
 void VTYNoGUIPlatform::QuitMessageLoop()
 {
   m_message_loop_running.store(false, std::memory_order_release);
+  WakeMessageLoop();
+}
+
+void VTYNoGUIPlatform::WakeMessageLoop()
+{
+  const u64 value = 1;
+  if (write(m_wakeup_fd, &value, sizeof(value)) < 0 && errno != EAGAIN)
+    Log_ErrorPrintf("Failed to wake message loop: %d", errno);
 }
 
 void VTYNoGUIPlatform::OpenEVDevFDs()
@@ -46,6 +46,7 @@ private:
   void OpenEVDevFDs();
   void CloseEVDevFDs();
   void PollEvDevKeyboards();
+  void WakeMessageLoop();
   void SetImGuiKeyMap();
 
   struct EvDevKeyboard
@@ -59,5 +60,8 @@ private:
   std::deque<std::function<void()>> m_callback_queue;
   std::mutex m_callback_queue_mutex;
 
+  // Signalled when a callback is queued or the loop should exit, so the loop can block on it with the display.
+  int m_wakeup_fd = -1;
+
   std::atomic_bool m_message_loop_running{false};
 };
@@ -11,7 +11,10 @@
 #include "nogui_host.h"
 #include "nogui_platform.h"
 
+#include <cerrno>
 #include <linux/input-event-codes.h>
+#include <poll.h>
+#include <sys/eventfd.h>
 #include <sys/mman.h>
 #include <thread>
 #include <unistd.h>
@@ -25,6 +28,8 @@ WaylandNoGUIPlatform::WaylandNoGUIPlatform()
 
 WaylandNoGUIPlatform::~WaylandNoGUIPlatform()
 {
+  if (m_wakeup_fd >= 0)
+    close(m_wakeup_fd);
   if (m_xkb_state)
     xkb_state_unref(m_xkb_state);
   if (m_xkb_keymap)
@@ -43,6 +48,13 @@ WaylandNoGUIPlatform::~WaylandNoGUIPlatform()
 
 bool WaylandNoGUIPlatform::Initialize()
 {
+  m_wakeup_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  if (m_wakeup_fd < 0)
+  {
+    Log_ErrorPrintf("eventfd() failed: %d", errno);
+    return false;
+  }
+
   m_xkb_context = xkb_context_new(XKB_CONTEXT_NO_FLAGS);
   if (!m_xkb_context)
   {
@@ -431,20 +443,52 @@ void WaylandNoGUIPlatform::RunMessageLoop()
       }
     }
 
-    // TODO: Make this suck less.
-    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    if (!m_message_loop_running.load(std::memory_order_acquire))
+      break;
+
+    // Block until the compositor sends something or we're woken. prepare_read() fails if events were queued in the
+    // meantime, in which case they get dispatched first.
+    if (wl_display_prepare_read(m_display) != 0)
+      continue;
+
+    wl_display_flush(m_display);
+
+    pollfd fds[2] = {{wl_display_get_fd(m_display), POLLIN, 0}, {m_wakeup_fd, POLLIN, 0}};
+    if (poll(fds, std::size(fds), -1) > 0 && (fds[0].revents & POLLIN))
+      wl_display_read_events(m_display);
+    else
+      wl_display_cancel_read(m_display);
+
+    if (fds[1].revents & POLLIN)
+    {
+      u64 value;
+      while (read(m_wakeup_fd, &value, sizeof(value)) > 0)
+        ;
+    }
   }
 }
 
 void WaylandNoGUIPlatform::ExecuteInMessageLoop(std::function<void()> func)
 {
-  std::unique_lock lock(m_callback_queue_mutex);
-  m_callback_queue.push_back(std::move(func));
+  {
+    std::unique_lock lock(m_callback_queue_mutex);
+    m_callback_queue.push_back(std::move(func));
+  }
+
+  WakeMessageLoop();
 }
 
 void WaylandNoGUIPlatform::QuitMessageLoop()
 {
   m_message_loop_running.store(false, std::memory_order_release);
+  WakeMessageLoop();
+}
+
+void WaylandNoGUIPlatform::WakeMessageLoop()
+{
+  const u64 value = 1;
+  if (write(m_wakeup_fd, &value, sizeof(value)) < 0 && errno != EAGAIN)
+    Log_ErrorPrintf("Failed to wake message loop: %d", errno);
 }
 
 void WaylandNoGUIPlatform::SetFullscreen(bool enabled)
@@ -49,6 +49,7 @@ public:
 
 private:
   void InitializeKeyMap();
+  void WakeMessageLoop();
 
   static void GlobalRegistryHandler(void* data, wl_registry* registry, uint32_t id, const char* interface,
                                     uint32_t version);
@@ -101,4 +102,7 @@ private:
 
   std::deque<std::function<void()>> m_callback_queue;
   std::mutex m_callback_queue_mutex;
+
+  // Signalled when a callback is queued or the loop should exit, so the loop can block on it with the display.
+  int m_wakeup_fd = -1;
 };
@@ -12,6 +12,9 @@ X11NoGUIPlatform::X11NoGUIPlatform()
 
 X11NoGUIPlatform::~X11NoGUIPlatform()
 {
+  if (m_wakeup_fd >= 0)
+    close(m_wakeup_fd);
+
   if (m_display)
   {
     // Segfaults somewhere in an unloaded module on Ubuntu 22.04 :S
@@ -34,6 +37,13 @@ bool X11NoGUIPlatform::Initialize()
     return false;
   }
 
+  m_wakeup_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  if (m_wakeup_fd < 0)
+  {
+    Log_ErrorPrintf("eventfd() failed: %d", errno);
+    return false;
+  }
+
   return true;
 }
 
@@ -263,20 +273,51 @@ void X11NoGUIPlatform::RunMessageLoop()
       }
     }
 
-    // TODO: Make this suck less.
-    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    if (!m_message_loop_running.load(std::memory_order_acquire))
+      break;
+
+    // Sleep until the server sends something or we're woken. Other threads share the connection and can pull events
+    // into the queue without the socket becoming readable again, so don't block forever.
+    {
+      XDisplayLocker locker(m_display);
+      if (XEventsQueued(m_display, QueuedAfterFlush) > 0)
+        continue;
+    }
+
+    pollfd fds[2] = {{ConnectionNumber(m_display), POLLIN, 0}, {m_wakeup_fd, POLLIN, 0}};
+    if (poll(fds, std::size(fds), 100) > 0)
+    {
+      if (fds[1].revents & POLLIN)
+      {
+        u64 value;
+        while (read(m_wakeup_fd, &value, sizeof(value)) > 0)
+          ;
+      }
+    }
   }
 }
 
 void X11NoGUIPlatform::ExecuteInMessageLoop(std::function<void()> func)
 {
-  std::unique_lock lock(m_callback_queue_mutex);
-  m_callback_queue.push_back(std::move(func));
+  {
+    std::unique_lock lock(m_callback_queue_mutex);
+    m_callback_queue.push_back(std::move(func));
+  }
+
+  WakeMessageLoop();
 }
 
 void X11NoGUIPlatform::QuitMessageLoop()
 {
   m_message_loop_running.store(false, std::memory_order_release);
+  WakeMessageLoop();
+}
+
+void X11NoGUIPlatform::WakeMessageLoop()
+{
+  const u64 value = 1;
+  if (write(m_wakeup_fd, &value, sizeof(value)) < 0 && errno != EAGAIN)
+    Log_ErrorPrintf("Failed to wake message loop: %d", errno);
 }
 
 void X11NoGUIPlatform::SetFullscreen(bool enabled)
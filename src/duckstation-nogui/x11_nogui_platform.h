@@ -20,6 +20,8 @@
 #include <deque>
 #include <linux/input-event-codes.h>
 #include <mutex>
+#include <poll.h>
+#include <sys/eventfd.h>
 #include <sys/mman.h>
 #include <thread>
 #include <unistd.h>
@@ -70,6 +72,7 @@ private:
   void InitializeKeyMap();
   void SaveWindowGeometry();
   void ProcessXEvents();
+  void WakeMessageLoop();
 
   std::atomic_bool m_message_loop_running{false};
   std::atomic_bool m_fullscreen{false};
@@ -83,6 +86,9 @@ private:
 
   std::deque<std::function<void()>> m_callback_queue;
   std::mutex m_callback_queue_mutex;
+
+  // Signalled when a callback is queued or the loop should exit, so the loop can block on it with the display.
+  int m_wakeup_fd = -1;
 };
 
 class XDisplayLocker
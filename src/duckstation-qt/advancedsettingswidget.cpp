@@ -238,6 +238,7 @@ AdvancedSettingsWidget::AdvancedSettingsWidget(SettingsDialog* dialog, QWidget*
   SettingWidgetBinder::BindWidgetToBoolSetting(sif, m_ui.logToDebug, "Logging", "LogToDebug", false);
   SettingWidgetBinder::BindWidgetToBoolSetting(sif, m_ui.logToWindow, "Logging", "LogToWindow", false);
   SettingWidgetBinder::BindWidgetToBoolSetting(sif, m_ui.logToFile, "Logging", "LogToFile", false);
+  SettingWidgetBinder::BindWidgetToBoolSetting(sif, m_ui.logAsyncOutput, "Logging", "AsyncOutput", false);
 
   SettingWidgetBinder::BindWidgetToBoolSetting(sif, m_ui.showDebugMenu, "Main", "ShowDebugMenu", false);
 
@@ -260,6 +261,10 @@ AdvancedSettingsWidget::AdvancedSettingsWidget(SettingsDialog* dialog, QWidget*
                              tr("Logs messages to the window."));
   dialog->registerWidgetHelp(m_ui.logToFile, tr("Log To File"), tr("User Preference"),
                              tr("Logs messages to duckstation.log in the user directory."));
+  dialog->registerWidgetHelp(
+    m_ui.logAsyncOutput, tr("Asynchronous Log Output"), tr("Unchecked"),
+    tr("Writes log messages to the console and file from a separate thread, so verbose logging doesn't slow down "
+       "emulation. Messages may show up slightly later than they were logged."));
   dialog->registerWidgetHelp(m_ui.showDebugMenu, tr("Show Debug Menu"), tr("Unchecked"),
                              tr("Shows a debug menu bar with additional statistics and quick settings."));
 }
@@ -278,6 +283,17 @@ void AdvancedSettingsWidget::addTweakOptions()
   addIntRangeTweakOption(m_dialog, m_ui.tweakOptionTable, tr("Display FPS Limit"), "Display", "MaxFPS", 0, 1000, 0);
 
   addMSAATweakOption(m_dialog, m_ui.tweakOptionTable, tr("Multisample Antialiasing"));
+  addIntRangeTweakOption(m_dialog, m_ui.tweakOptionTable, tr("Software Renderer Worker Threads"), "GPU",
+                         "SoftwareWorkerThreads", 0, Settings::GPU_SW_MAX_WORKER_THREADS, 0);
+  addBooleanTweakOption(m_dialog, m_ui.tweakOptionTable, tr("Hardware Renderer Command Thread"), "GPU",
+                        "UseRenderThread", false);
+  addChoiceTweakOption(m_dialog, m_ui.tweakOptionTable, tr("Hardware Renderer Shader Mode"), "GPU", "ShaderMode",
+                       Settings::ParseShaderModeName, Settings::GetShaderModeName, Settings::GetShaderModeDisplayName,
+                       "GPUShaderMode", static_cast<u32>(GPUShaderMode::Count), Settings::DEFAULT_GPU_SHADER_MODE);
+  addBooleanTweakOption(m_dialog, m_ui.tweakOptionTable, tr("Use Compute Shaders For Adaptive Downsampling"), "GPU",
+                        "DownsampleCompute", true);
+  addBooleanTweakOption(m_dialog, m_ui.tweakOptionTable, tr("Fuse Single Sample Post-Processing Shaders"), "Display",
+                        "PostProcessFusion", true);
 
   if (m_dialog->isPerGameSettings())
   {
@@ -301,17 +317,32 @@ void AdvancedSettingsWidget::addTweakOptions()
                         "RecompilerMemoryExceptions", false);
   addBooleanTweakOption(m_dialog, m_ui.tweakOptionTable, tr("Enable Recompiler Block Linking"), "CPU",
                         "RecompilerBlockLinking", true);
+  addBooleanTweakOption(m_dialog, m_ui.tweakOptionTable, tr("Enable Recompiler Block Cache"), "CPU",
+                        "RecompilerBlockCache", false);
+  addBooleanTweakOption(m_dialog, m_ui.tweakOptionTable, tr("Enable Recompiler Compile Thread"), "CPU",
+                        "RecompilerAsyncCompile", false);
+  addIntRangeTweakOption(m_dialog, m_ui.tweakOptionTable, tr("Recompiler Tier Threshold"), "CPU",
+                         "RecompilerTierThreshold", 0, 1000, 0);
+  addBooleanTweakOption(m_dialog, m_ui.tweakOptionTable, tr("Enable Idle Loop Skipping"), "CPU", "IdleLoopSkipping",
+                        false);
   addChoiceTweakOption(m_dialog, m_ui.tweakOptionTable, tr("Enable Recompiler Fast Memory Access"), "CPU",
                        "FastmemMode", Settings::ParseCPUFastmemMode, Settings::GetCPUFastmemModeName,
                        Settings::GetCPUFastmemModeDisplayName, "CPUFastmemMode",
                        static_cast<u32>(CPUFastmemMode::Count), Settings::DEFAULT_CPU_FASTMEM_MODE);
+  addBooleanTweakOption(m_dialog, m_ui.tweakOptionTable, tr("Use Large Pages"), "CPU", "UseLargePages", false);
 
   addBooleanTweakOption(m_dialog, m_ui.tweakOptionTable, tr("Use Old MDEC Routines"), "Hacks", "UseOldMDECRoutines",
                         false);
+  addBooleanTweakOption(m_dialog, m_ui.tweakOptionTable, tr("Decode MDEC On Worker Thread"), "Hacks",
+                        "MDECDecodeThread", false);
   addBooleanTweakOption(m_dialog, m_ui.tweakOptionTable, tr("Enable VRAM Write Texture Replacement"),
                         "TextureReplacements", "EnableVRAMWriteReplacements", false);
   addBooleanTweakOption(m_dialog, m_ui.tweakOptionTable, tr("Preload Texture Replacements"), "TextureReplacements",
                         "PreloadTextures", false);
+  addBooleanTweakOption(m_dialog, m_ui.tweakOptionTable, tr("Load Texture Replacements Asynchronously"),
+                        "TextureReplacements", "AsyncLoading", false);
+  addIntRangeTweakOption(m_dialog, m_ui.tweakOptionTable, tr("Texture Replacement Cache Size (MB, 0 = Unlimited)"),
+                         "TextureReplacements", "MaxCacheSize", 0, 65536, 0);
   addBooleanTweakOption(m_dialog, m_ui.tweakOptionTable, tr("Dump Replaceable VRAM Writes"), "TextureReplacements",
                         "DumpVRAMWrites", false);
   addBooleanTweakOption(m_dialog, m_ui.tweakOptionTable, tr("Set Dumped VRAM Write Alpha Channel"),
@@ -339,6 +370,10 @@ void AdvancedSettingsWidget::addTweakOptions()
 
   addBooleanTweakOption(m_dialog, m_ui.tweakOptionTable, tr("Increase Timer Resolution"), "Main",
                         "IncreaseTimerResolution", true);
+  addChoiceTweakOption(m_dialog, m_ui.tweakOptionTable, tr("Thread Affinity Policy"), "Main", "ThreadAffinityPolicy",
+                       Settings::ParseThreadAffinityPolicy, Settings::GetThreadAffinityPolicyName,
+                       Settings::GetThreadAffinityPolicyDisplayName, "ThreadAffinityPolicy",
+                       static_cast<u32>(ThreadAffinityPolicy::Count), Settings::DEFAULT_THREAD_AFFINITY_POLICY);
 
   addBooleanTweakOption(m_dialog, m_ui.tweakOptionTable, tr("Allow Booting Without SBI File"), "CDROM",
                         "AllowBootingWithoutSBIFile", false);
@@ -363,16 +398,30 @@ void AdvancedSettingsWidget::onResetToDefaultClicked()
     setBooleanTweakOption(m_ui.tweakOptionTable, i++, true);     // Apply compatibility settings
     setIntRangeTweakOption(m_ui.tweakOptionTable, i++, 0);       // Display FPS limit
     setChoiceTweakOption(m_ui.tweakOptionTable, i++, 0);         // Multisample antialiasing
+    setIntRangeTweakOption(m_ui.tweakOptionTable, i++, 0);       // Software renderer worker threads
+    setBooleanTweakOption(m_ui.tweakOptionTable, i++, false);    // Hardware renderer command thread
+    setChoiceTweakOption(m_ui.tweakOptionTable, i++,
+                         Settings::DEFAULT_GPU_SHADER_MODE);             // Hardware renderer shader mode
+    setBooleanTweakOption(m_ui.tweakOptionTable, i++, true);     // Compute shader adaptive downsampling
+    setBooleanTweakOption(m_ui.tweakOptionTable, i++, true);     // Fuse post-processing shaders
     setBooleanTweakOption(m_ui.tweakOptionTable, i++, false);    // PGXP vertex cache
     setFloatRangeTweakOption(m_ui.tweakOptionTable, i++, -1.0f); // PGXP geometry tolerance
     setFloatRangeTweakOption(m_ui.tweakOptionTable, i++,
                              Settings::DEFAULT_GPU_PGXP_DEPTH_THRESHOLD); // PGXP depth clear threshold
     setBooleanTweakOption(m_ui.tweakOptionTable, i++, false);             // Recompiler memory exceptions
     setBooleanTweakOption(m_ui.tweakOptionTable, i++, true);              // Recompiler block linking
+    setBooleanTweakOption(m_ui.tweakOptionTable, i++, false);             // Recompiler block cache
+    setBooleanTweakOption(m_ui.tweakOptionTable, i++, false);             // Recompiler compile thread
+    setIntRangeTweakOption(m_ui.tweakOptionTable, i++, 0);                // Recompiler tier threshold
+    setBooleanTweakOption(m_ui.tweakOptionTable, i++, true);              // Idle loop skipping
     setChoiceTweakOption(m_ui.tweakOptionTable, i++, Settings::DEFAULT_CPU_FASTMEM_MODE); // Recompiler fastmem mode
+    setBooleanTweakOption(m_ui.tweakOptionTable, i++, false);                             // Use large pages
     setBooleanTweakOption(m_ui.tweakOptionTable, i++, false);                             // Use Old MDEC Routines
+    setBooleanTweakOption(m_ui.tweakOptionTable, i++, false);                             // MDEC decode thread
     setBooleanTweakOption(m_ui.tweakOptionTable, i++, false); // VRAM write texture replacement
     setBooleanTweakOption(m_ui.tweakOptionTable, i++, false); // Preload texture replacements
+    setBooleanTweakOption(m_ui.tweakOptionTable, i++, false); // Load texture replacements asynchronously
+    setIntRangeTweakOption(m_ui.tweakOptionTable, i++, 0);    // Texture replacement cache size
     setBooleanTweakOption(m_ui.tweakOptionTable, i++, false); // Dump replacable VRAM writes
     setBooleanTweakOption(m_ui.tweakOptionTable, i++, true);  // Set dumped VRAM write alpha channel
     setIntRangeTweakOption(m_ui.tweakOptionTable, i++,
@@ -390,6 +439,8 @@ void AdvancedSettingsWidget::onResetToDefaultClicked()
     setBooleanTweakOption(m_ui.tweakOptionTable, i++, false);                      // Use debug host GPU device
     setBooleanTweakOption(m_ui.tweakOptionTable, i++, false);                      // Stretch Display Vertically
     setBooleanTweakOption(m_ui.tweakOptionTable, i++, true);                       // Increase Timer Resolution
+    setChoiceTweakOption(m_ui.tweakOptionTable, i++,
+                         Settings::DEFAULT_THREAD_AFFINITY_POLICY); // Thread Affinity Policy
     setBooleanTweakOption(m_ui.tweakOptionTable, i++, false);                      // Allow booting without SBI file
     setBooleanTweakOption(m_ui.tweakOptionTable, i++, false);                      // Create save state backups
     setBooleanTweakOption(m_ui.tweakOptionTable, i++, false);                      // Enable PCDRV
@@ -414,19 +465,30 @@ void AdvancedSettingsWidget::onResetToDefaultClicked()
   sif->DeleteValue("Display", "StretchVertically");
   sif->DeleteValue("GPU", "Multisamples");
   sif->DeleteValue("GPU", "PerSampleShading");
+  sif->DeleteValue("GPU", "SoftwareWorkerThreads");
+  sif->DeleteValue("GPU", "UseRenderThread");
+  sif->DeleteValue("GPU", "ShaderMode");
   sif->DeleteValue("GPU", "PGXPVertexCache");
   sif->DeleteValue("GPU", "PGXPTolerance");
   sif->DeleteValue("GPU", "PGXPDepthClearThreshold");
   sif->DeleteValue("CPU", "RecompilerMemoryExceptions");
   sif->DeleteValue("CPU", "RecompilerBlockLinking");
+  sif->DeleteValue("CPU", "RecompilerBlockCache");
+  sif->DeleteValue("CPU", "RecompilerAsyncCompile");
+  sif->DeleteValue("CPU", "RecompilerTierThreshold");
+  sif->DeleteValue("CPU", "IdleLoopSkipping");
   sif->DeleteValue("CPU", "FastmemMode");
+  sif->DeleteValue("CPU", "UseLargePages");
   sif->DeleteValue("TextureReplacements", "EnableVRAMWriteReplacements");
   sif->DeleteValue("TextureReplacements", "PreloadTextures");
+  sif->DeleteValue("TextureReplacements", "AsyncLoading");
+  sif->DeleteValue("TextureReplacements", "MaxCacheSize");
   sif->DeleteValue("TextureReplacements", "DumpVRAMWrites");
   sif->DeleteValue("TextureReplacements", "DumpVRAMWriteForceAlphaChannel");
   sif->DeleteValue("TextureReplacements", "DumpVRAMWriteWidthThreshold");
   sif->DeleteValue("TextureReplacements", "DumpVRAMWriteHeightThreshold");
   sif->DeleteValue("Hacks", "UseOldMDECRoutines");
+  sif->DeleteValue("Hacks", "MDECDecodeThread");
   sif->DeleteValue("Hacks", "DMAMaxSliceTicks");
   sif->DeleteValue("Hacks", "DMAHaltTicks");
   sif->DeleteValue("Hacks", "GPUFIFOSize");
@@ -434,6 +496,7 @@ void AdvancedSettingsWidget::onResetToDefaultClicked()
   sif->DeleteValue("GPU", "UseDebugDevice");
   sif->DeleteValue("Display", "StretchVertically");
   sif->DeleteValue("Main", "IncreaseTimerResolution");
+  sif->DeleteValue("Main", "ThreadAffinityPolicy");
   sif->DeleteValue("CDROM", "AllowBootingWithoutSBIFile");
   sif->DeleteValue("General", "CreateSaveStateBackups");
   sif->DeleteValue("PCDrv", "Enabled");
@@ -31,6 +31,7 @@ AudioSettingsWidget::AudioSettingsWidget(SettingsDialog* dialog, QWidget* parent
   SettingWidgetBinder::BindWidgetToIntSetting(sif, m_ui.outputLatencyMS, "Audio", "OutputLatencyMS",
                                               Settings::DEFAULT_AUDIO_OUTPUT_LATENCY_MS);
   SettingWidgetBinder::BindWidgetToBoolSetting(sif, m_ui.startDumpingOnBoot, "Audio", "DumpOnBoot", false);
+  SettingWidgetBinder::BindWidgetToBoolSetting(sif, m_ui.stretchThread, "Audio", "StretchThread", false);
   SettingWidgetBinder::BindWidgetToBoolSetting(sif, m_ui.muteCDAudio, "CDROM", "MuteCDAudio", false);
   connect(m_ui.audioBackend, &QComboBox::currentIndexChanged, this, &AudioSettingsWidget::updateDriverNames);
   updateDriverNames();
@@ -87,7 +88,11 @@ AudioSettingsWidget::AudioSettingsWidget(SettingsDialog* dialog, QWidget* parent
   dialog->registerWidgetHelp(
     m_ui.stretchMode, tr("Stretch Mode"), tr("Time Stretching"),
     tr("When running outside of 100% speed, adjusts the tempo on audio instead of dropping frames. Produces "
-       "much nicer fast forward/slowdown audio at a small cost to performance."));
+       "much nicer fast forward/slowdown audio at a small cost to performance. Dynamic Rate Control resamples "
+       "instead, adjusting the rate slightly to keep the buffer as small as the host can sustain without underruns."));
+  dialog->registerWidgetHelp(m_ui.stretchThread, tr("Stretch On Worker Thread"), tr("Unchecked"),
+                             tr("Performs resampling and time stretching on a separate thread, instead of the "
+                                "emulation thread. Can help performance on systems with spare CPU cores."));
 }
 
 AudioSettingsWidget::~AudioSettingsWidget() = default;
@@ -18,6 +18,7 @@ BIOSSettingsWidget::BIOSSettingsWidget(SettingsDialog* dialog, QWidget* parent)
 
   SettingWidgetBinder::BindWidgetToBoolSetting(sif, m_ui.enableTTYOutput, "BIOS", "PatchTTYEnable", false);
   SettingWidgetBinder::BindWidgetToBoolSetting(sif, m_ui.fastBoot, "BIOS", "PatchFastBoot", false);
+  SettingWidgetBinder::BindWidgetToBoolSetting(sif, m_ui.exeBootSnapshot, "BIOS", "EXEBootSnapshot", false);
 
   dialog->registerWidgetHelp(m_ui.fastBoot, tr("Fast Boot"), tr("Unchecked"),
                              tr("Patches the BIOS to skip the console's boot animation. Does not work with all games, "
@@ -25,6 +26,10 @@ BIOSSettingsWidget::BIOSSettingsWidget(SettingsDialog* dialog, QWidget* parent)
   dialog->registerWidgetHelp(
     m_ui.enableTTYOutput, tr("Enable TTY Output"), tr("Unchecked"),
     tr("Patches the BIOS to log calls to printf(). Only use when debugging, can break games."));
+  dialog->registerWidgetHelp(
+    m_ui.exeBootSnapshot, tr("Skip BIOS Startup For Executables"), tr("Unchecked"),
+    tr("Saves the state the BIOS is in once it has started up, and restores it when booting an EXE or PSF instead of "
+       "running the BIOS again. The first boot with each BIOS still runs it in full."));
 
   connect(m_ui.imageNTSCJ, QOverload<int>::of(&QComboBox::currentIndexChanged), [this](int index) {
     if (m_dialog->isPerGameSettings() && index == 0)
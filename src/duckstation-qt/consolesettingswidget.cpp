@@ -52,7 +52,11 @@ ConsoleSettingsWidget::ConsoleSettingsWidget(SettingsDialog* dialog, QWidget* pa
                                               Settings::DEFAULT_CDROM_READAHEAD_SECTORS);
   SettingWidgetBinder::BindWidgetToBoolSetting(sif, m_ui.cdromRegionCheck, "CDROM", "RegionCheck", false);
   SettingWidgetBinder::BindWidgetToBoolSetting(sif, m_ui.cdromLoadImageToRAM, "CDROM", "LoadImageToRAM", false);
+  SettingWidgetBinder::BindWidgetToBoolSetting(sif, m_ui.cdromLoadImageToRAMCompressed, "CDROM",
+                                               "LoadImageToRAMCompressed", false);
   SettingWidgetBinder::BindWidgetToBoolSetting(sif, m_ui.cdromLoadImagePatches, "CDROM", "LoadImagePatches", false);
+  SettingWidgetBinder::BindWidgetToBoolSetting(sif, m_ui.cdromDecompressionPrefetch, "CDROM", "DecompressionPrefetch",
+                                               false);
   SettingWidgetBinder::BindWidgetToIntSetting(sif, m_ui.cdromSeekSpeedup, "CDROM", "SeekSpeedup", 1);
   SettingWidgetBinder::BindWidgetToIntSetting(sif, m_ui.cdromReadSpeedup, "CDROM", "ReadSpeedup", 1, 1);
 
@@ -97,6 +101,14 @@ ConsoleSettingsWidget::ConsoleSettingsWidget(SettingsDialog* dialog, QWidget* pa
     m_ui.cdromLoadImageToRAM, tr("Preload Image to RAM"), tr("Unchecked"),
     tr("Loads the game image into RAM. Useful for network paths that may become unreliable during gameplay. In some "
        "cases also eliminates stutter when games initiate audio track playback."));
+  dialog->registerWidgetHelp(
+    m_ui.cdromLoadImageToRAMCompressed, tr("Compress Preloaded Image"), tr("Unchecked"),
+    tr("Keeps the preloaded image compressed in RAM, decompressing small groups of sectors as they are read. Uses a "
+       "fraction of the memory of a full preload, and allows multi-disc playlists to be preloaded."));
+  dialog->registerWidgetHelp(
+    m_ui.cdromDecompressionPrefetch, tr("Prefetch Compressed Blocks"), tr("Unchecked"),
+    tr("Decompresses the blocks of compressed images such as CHD which follow the current read on a worker thread, "
+       "before the emulated drive gets to them. Reduces stutter when streaming from CHDs on slower CPUs."));
   dialog->registerWidgetHelp(m_ui.cdromLoadImagePatches, tr("Apply Image Patches"), tr("Unchecked"),
                              tr("Automatically applies patches to disc images when they are present in the same "
                                 "directory. Currently only PPF patches are supported with this option."));
@@ -56,7 +56,7 @@ void DebuggerWindow::refreshAll()
 {
   m_registers_model->invalidateView();
   m_stack_model->invalidateView();
-  m_ui.memoryView->repaint();
+  m_ui.memoryView->refreshSnapshot();
 
   m_code_model->setPC(CPU::g_state.regs.pc);
   scrollToPC();
@@ -132,15 +132,21 @@ void DebuggerWindow::onTraceTriggered()
 {
   if (!CPU::IsTraceEnabled())
   {
-    QMessageBox::critical(
-      this, windowTitle(),
-      tr("Trace logging started to cpu_log.txt.\nThis file can be several gigabytes, so be aware of SSD wear."));
-    CPU::StartTrace();
+    const bool binary =
+      (QMessageBox::question(this, windowTitle(),
+                             tr("Write a compact binary trace to cpu_trace.bin instead of disassembly to cpu_log.txt?\n"
+                                "Binary traces are much faster to write, and can be disassembled later with "
+                                "duckstation-regtest -converttrace.")) == QMessageBox::Yes);
+    QMessageBox::critical(this, windowTitle(),
+                          tr("Trace logging started to %1.\nThis file can be several gigabytes, so be aware of SSD "
+                             "wear.")
+                            .arg(binary ? QStringLiteral("cpu_trace.bin") : QStringLiteral("cpu_log.txt")));
+    CPU::StartTrace(binary ? CPU::TraceFormat::Binary : CPU::TraceFormat::Text);
   }
   else
   {
     CPU::StopTrace();
-    QMessageBox::critical(this, windowTitle(), tr("Trace logging to cpu_log.txt stopped."));
+    QMessageBox::critical(this, windowTitle(), tr("Trace logging stopped."));
   }
 }
 
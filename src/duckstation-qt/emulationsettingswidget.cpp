@@ -19,10 +19,14 @@ EmulationSettingsWidget::EmulationSettingsWidget(SettingsDialog* dialog, QWidget
 
   SettingWidgetBinder::BindWidgetToBoolSetting(sif, m_ui.syncToHostRefreshRate, "Main", "SyncToHostRefreshRate", false);
   SettingWidgetBinder::BindWidgetToBoolSetting(sif, m_ui.displayAllFrames, "Display", "DisplayAllFrames", false);
+  SettingWidgetBinder::BindWidgetToBoolSetting(sif, m_ui.lowLatencyPacing, "Display", "LowLatencyPacing", false);
+  SettingWidgetBinder::BindWidgetToBoolSetting(sif, m_ui.lateInputLatch, "Display", "LateInputLatch", false);
   SettingWidgetBinder::BindWidgetToBoolSetting(sif, m_ui.rewindEnable, "Main", "RewindEnable", false);
   SettingWidgetBinder::BindWidgetToFloatSetting(sif, m_ui.rewindSaveFrequency, "Main", "RewindFrequency", 10.0f);
   SettingWidgetBinder::BindWidgetToIntSetting(sif, m_ui.rewindSaveSlots, "Main", "RewindSaveSlots", 10);
+  SettingWidgetBinder::BindWidgetToBoolSetting(sif, m_ui.rewindNativeVRAM, "Main", "RewindNativeVRAM", false);
   SettingWidgetBinder::BindWidgetToIntSetting(sif, m_ui.runaheadFrames, "Main", "RunaheadFrameCount", 0);
+  SettingWidgetBinder::BindWidgetToBoolSetting(sif, m_ui.runaheadSkipRendering, "Main", "RunaheadSkipRendering", false);
 
   const float effective_emulation_speed = m_dialog->getEffectiveFloatValue("Main", "EmulationSpeed", 1.0f);
   fillComboBoxWithEmulationSpeeds(m_ui.emulationSpeed, effective_emulation_speed);
@@ -74,6 +78,7 @@ EmulationSettingsWidget::EmulationSettingsWidget(SettingsDialog* dialog, QWidget
           &EmulationSettingsWidget::updateRewind);
   connect(m_ui.rewindSaveSlots, QOverload<int>::of(&QSpinBox::valueChanged), this,
           &EmulationSettingsWidget::updateRewind);
+  connect(m_ui.rewindNativeVRAM, &QCheckBox::stateChanged, this, &EmulationSettingsWidget::updateRewind);
   connect(m_ui.runaheadFrames, QOverload<int>::of(&QComboBox::currentIndexChanged), this,
           &EmulationSettingsWidget::updateRewind);
 
@@ -99,6 +104,16 @@ EmulationSettingsWidget::EmulationSettingsWidget(SettingsDialog* dialog, QWidget
                              tr("Enable this option will ensure every frame the console renders is displayed to the "
                                 "screen, for optimal frame pacing. If you are having difficulties maintaining full "
                                 "speed, or are getting audio glitches, try disabling this option."));
+  dialog->registerWidgetHelp(
+    m_ui.lowLatencyPacing, tr("Low Latency Frame Pacing"), tr("Unchecked"),
+    tr("When the emulator is using host vsync for throttling, delays the start of each frame so that it finishes just "
+       "before the next vertical blank, reducing input latency. Only takes effect when Sync To Host Refresh Rate, "
+       "VSync and Optimal Frame Pacing are all active. Disable if you are getting frame drops."));
+  dialog->registerWidgetHelp(
+    m_ui.lateInputLatch, tr("Late Input Latching"), tr("Unchecked"),
+    tr("Polls controllers when the game reads them instead of at the start of the frame, and delays the start of each "
+       "frame so that it finishes just before it is due to be displayed. Reduces input latency, but has no effect "
+       "with runahead or while recording or playing back a movie. Disable if you are getting frame drops."));
   dialog->registerWidgetHelp(
     m_ui.rewindEnable, tr("Rewinding"), tr("Unchecked"),
     tr("<b>Enable Rewinding:</b> Saves state periodically so you can rewind any mistakes while playing.<br> "
@@ -106,10 +121,20 @@ EmulationSettingsWidget::EmulationSettingsWidget(SettingsDialog* dialog, QWidget
        "requirements.<br> "
        "<b>Rewind Buffer Size:</b> How many saves will be kept for rewinding. Higher values have greater memory "
        "requirements."));
+  dialog->registerWidgetHelp(
+    m_ui.rewindNativeVRAM, tr("Store Rewind VRAM At Native Resolution"), tr("Unchecked"),
+    tr("Keeps VRAM at the console's resolution in rewind states, instead of a copy of the upscaled VRAM texture. "
+       "Rewinding no longer uses video memory at high resolution scales, but the first frame after rewinding will be "
+       "at native resolution, and saving states takes slightly longer."));
   dialog->registerWidgetHelp(
     m_ui.runaheadFrames, tr("Runahead"), tr("Disabled"),
     tr(
       "Simulates the system ahead of time and rolls back/replays to reduce input lag. Very high system requirements."));
+  dialog->registerWidgetHelp(
+    m_ui.runaheadSkipRendering, tr("Skip Rendering Replayed Frames"), tr("Unchecked"),
+    tr("Discards the draws of all but the last frame replayed by runahead, greatly reducing its GPU cost. Only applies "
+       "to the hardware renderers. Games which do not redraw the whole screen every frame may show missing "
+       "graphics."));
 
   updateRewind();
 }
@@ -181,6 +206,7 @@ void EmulationSettingsWidget::updateRewind()
   const bool rewind_enabled = m_dialog->getEffectiveBoolValue("Main", "RewindEnable", false);
   const bool runahead_enabled = m_dialog->getIntValue("Main", "RunaheadFrameCount", 0) > 0;
   m_ui.rewindEnable->setEnabled(!runahead_enabled);
+  m_ui.runaheadSkipRendering->setEnabled(runahead_enabled);
 
   if (!runahead_enabled && rewind_enabled)
   {
@@ -190,7 +216,7 @@ void EmulationSettingsWidget::updateRewind()
       ((frequency <= std::numeric_limits<float>::epsilon()) ? (1.0f / 60.0f) : frequency) * static_cast<float>(frames);
 
     u64 ram_usage, vram_usage;
-    System::CalculateRewindMemoryUsage(frames, &ram_usage, &vram_usage);
+    System::CalculateRewindMemoryUsage(frames, m_ui.rewindNativeVRAM->isChecked(), &ram_usage, &vram_usage);
 
     m_ui.rewindSummary->setText(
       tr("Rewind for %n frame(s), lasting %1 second(s) will require up to %2MB of RAM and %3MB of VRAM.", "", frames)
@@ -199,6 +225,7 @@ void EmulationSettingsWidget::updateRewind()
         .arg(vram_usage / 1048576));
     m_ui.rewindSaveFrequency->setEnabled(true);
     m_ui.rewindSaveSlots->setEnabled(true);
+    m_ui.rewindNativeVRAM->setEnabled(true);
   }
   else
   {
@@ -214,5 +241,6 @@ void EmulationSettingsWidget::updateRewind()
     }
     m_ui.rewindSaveFrequency->setEnabled(false);
     m_ui.rewindSaveSlots->setEnabled(false);
+    m_ui.rewindNativeVRAM->setEnabled(false);
   }
 }
@@ -17,6 +17,9 @@ EnhancementSettingsWidget::EnhancementSettingsWidget(SettingsDialog* dialog, QWi
   setupAdditionalUi();
 
   SettingWidgetBinder::BindWidgetToIntSetting(sif, m_ui.resolutionScale, "GPU", "ResolutionScale", 1);
+  SettingWidgetBinder::BindWidgetToBoolSetting(sif, m_ui.dynamicResolution, "GPU", "DynamicResolution", false);
+  SettingWidgetBinder::BindWidgetToIntSetting(sif, m_ui.dynamicResolutionMinScale, "GPU", "DynamicResolutionMinScale",
+                                              1);
   SettingWidgetBinder::BindWidgetToEnumSetting(sif, m_ui.gpuDownsampleMode, "GPU", "DownsampleMode",
                                                &Settings::ParseDownsampleModeName, &Settings::GetDownsampleModeName,
                                                Settings::DEFAULT_GPU_DOWNSAMPLE_MODE);
@@ -29,6 +32,8 @@ EnhancementSettingsWidget::EnhancementSettingsWidget(SettingsDialog* dialog, QWi
   SettingWidgetBinder::BindWidgetToEnumSetting(sif, m_ui.textureFiltering, "GPU", "TextureFilter",
                                                &Settings::ParseTextureFilterName, &Settings::GetTextureFilterName,
                                                Settings::DEFAULT_GPU_TEXTURE_FILTER);
+  SettingWidgetBinder::BindWidgetToBoolSetting(sif, m_ui.adaptiveTextureFiltering, "GPU", "AdaptiveTextureFiltering",
+                                               false);
   SettingWidgetBinder::BindWidgetToBoolSetting(sif, m_ui.widescreenHack, "GPU", "WidescreenHack", false);
   SettingWidgetBinder::BindWidgetToBoolSetting(sif, m_ui.useSoftwareRendererForReadbacks, "GPU",
                                                "UseSoftwareRendererForReadbacks", false);
@@ -46,6 +51,10 @@ EnhancementSettingsWidget::EnhancementSettingsWidget(SettingsDialog* dialog, QWi
   connect(m_ui.trueColor, &QCheckBox::stateChanged, this, &EnhancementSettingsWidget::updateScaledDitheringEnabled);
   updateScaledDitheringEnabled();
 
+  connect(m_ui.dynamicResolution, &QCheckBox::stateChanged, this,
+          &EnhancementSettingsWidget::updateDynamicResolutionEnabled);
+  updateDynamicResolutionEnabled();
+
   connect(m_ui.pgxpEnable, &QCheckBox::stateChanged, this, &EnhancementSettingsWidget::updatePGXPSettingsEnabled);
   connect(m_ui.pgxpTextureCorrection, &QCheckBox::stateChanged, this,
           &EnhancementSettingsWidget::updatePGXPSettingsEnabled);
@@ -66,6 +75,13 @@ EnhancementSettingsWidget::EnhancementSettingsWidget(SettingsDialog* dialog, QWi
     tr("Setting this beyond 1x will enhance the resolution of rendered 3D polygons and lines. Only applies "
        "to the hardware backends. <br>This option is usually safe, with most games looking fine at "
        "higher resolutions. Higher resolutions require a more powerful GPU."));
+  dialog->registerWidgetHelp(
+    m_ui.dynamicResolution, tr("Dynamic Resolution"), tr("Unchecked"),
+    tr("Lowers the resolution scale when the GPU can't finish frames in time, and raises it back towards the selected "
+       "scale when there is headroom again. Keeps the frame rate steady on devices with variable GPU power. Only "
+       "applies to the hardware renderers."));
+  dialog->registerWidgetHelp(m_ui.dynamicResolutionMinScale, tr("Minimum Scale"), "1x",
+                             tr("The lowest resolution scale dynamic resolution will drop to."));
   dialog->registerWidgetHelp(
     m_ui.trueColor, tr("True Color Rendering (24-bit, disables dithering)"), tr("Unchecked"),
     tr("Forces the precision of colours output to the console's framebuffer to use the full 8 bits of precision per "
@@ -95,6 +111,10 @@ EnhancementSettingsWidget::EnhancementSettingsWidget(SettingsDialog* dialog, QWi
     tr("Smooths out the blockiness of magnified textures on 3D object by using filtering. <br>Will have a "
        "greater effect on higher resolution scales. Only applies to the hardware renderers. <br>The JINC2 and "
        "especially xBR filtering modes are very demanding, and may not be worth the speed penalty."));
+  dialog->registerWidgetHelp(
+    m_ui.adaptiveTextureFiltering, tr("Adaptive Texture Filtering"), tr("Unchecked"),
+    tr("Uses bilinear filtering instead of JINC2 or xBR for textures which are drawn smaller than their native size, "
+       "where the more expensive filters can't add any detail. Reduces the cost of these filters in busy scenes."));
   dialog->registerWidgetHelp(
     m_ui.widescreenHack, tr("Widescreen Hack"), tr("Unchecked"),
     tr("Scales vertex positions in screen-space to a widescreen aspect ratio, essentially "
@@ -141,6 +161,11 @@ void EnhancementSettingsWidget::updateScaledDitheringEnabled()
   m_ui.scaledDithering->setEnabled(allow_scaled_dithering);
 }
 
+void EnhancementSettingsWidget::updateDynamicResolutionEnabled()
+{
+  m_ui.dynamicResolutionMinScale->setEnabled(m_dialog->getEffectiveBoolValue("GPU", "DynamicResolution", false));
+}
+
 void EnhancementSettingsWidget::setupAdditionalUi()
 {
   QtUtils::FillComboBoxWithResolutionScales(m_ui.resolutionScale);
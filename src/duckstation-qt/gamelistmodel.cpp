@@ -25,6 +25,7 @@ static constexpr int COVER_ART_WIDTH = 512;
 static constexpr int COVER_ART_HEIGHT = 512;
 static constexpr int COVER_ART_SPACING = 32;
 static constexpr int MIN_COVER_CACHE_SIZE = 256;
+static constexpr int COVER_PREFETCH_SCREENS = 1;
 
 static int DPRScale(int size, float dpr)
 {
@@ -36,7 +37,9 @@ static int DPRUnscale(int size, float dpr)
   return static_cast<int>(static_cast<float>(size) / dpr);
 }
 
-static void resizeAndPadPixmap(QPixmap* pm, int expected_width, int expected_height, float dpr)
+// Covers are loaded and scaled on the thread pool, so these work on QImage rather than QPixmap, which must only be
+// used on the GUI thread.
+static void resizeAndPadImage(QImage* pm, int expected_width, int expected_height, float dpr)
 {
   const int dpr_expected_width = DPRScale(expected_width, dpr);
   const int dpr_expected_height = DPRScale(expected_height, dpr);
@@ -55,14 +58,14 @@ static void resizeAndPadPixmap(QPixmap* pm, int expected_width, int expected_hei
   if (pm->height() < dpr_expected_height)
     yoffs = DPRUnscale((dpr_expected_height - pm->height()) / 2, dpr);
 
-  QPixmap padded_image(dpr_expected_width, dpr_expected_height);
+  QImage padded_image(dpr_expected_width, dpr_expected_height, QImage::Format_ARGB32_Premultiplied);
   padded_image.setDevicePixelRatio(dpr);
   padded_image.fill(Qt::transparent);
   QPainter painter;
   if (painter.begin(&padded_image))
   {
     painter.setCompositionMode(QPainter::CompositionMode_Source);
-    painter.drawPixmap(xoffs, yoffs, *pm);
+    painter.drawImage(xoffs, yoffs, *pm);
     painter.setCompositionMode(QPainter::CompositionMode_Destination);
     painter.fillRect(padded_image.rect(), QColor(0, 0, 0, 0));
     painter.end();
@@ -71,16 +74,15 @@ static void resizeAndPadPixmap(QPixmap* pm, int expected_width, int expected_hei
   *pm = padded_image;
 }
 
-static QPixmap createPlaceholderImage(const QPixmap& placeholder_pixmap, int width, int height, float scale,
-                                      const std::string& title)
+static QImage createPlaceholderImage(const QImage& placeholder_image, int width, int height, float scale, float dpr,
+                                     const std::string& title)
 {
-  const float dpr = qApp->devicePixelRatio();
-  QPixmap pm(placeholder_pixmap.copy());
+  QImage pm(placeholder_image.copy());
   pm.setDevicePixelRatio(dpr);
   if (pm.isNull())
-    return QPixmap();
+    return QImage();
 
-  resizeAndPadPixmap(&pm, width, height, dpr);
+  resizeAndPadImage(&pm, width, height, dpr);
   QPainter painter;
   if (painter.begin(&pm))
   {
@@ -129,6 +131,7 @@ void GameListModel::setCoverScale(float scale)
     return;
 
   m_cover_pixmap_cache.Clear();
+  m_cover_generation++;
   m_cover_scale = scale;
   m_loading_pixmap = QPixmap(getCoverArtWidth(), getCoverArtHeight());
   m_loading_pixmap.fill(QColor(0, 0, 0, 0));
@@ -137,6 +140,7 @@ void GameListModel::setCoverScale(float scale)
 void GameListModel::refreshCovers()
 {
   m_cover_pixmap_cache.Clear();
+  m_cover_generation++;
   refresh();
 }
 
@@ -147,7 +151,10 @@ void GameListModel::updateCacheSize(int width, int height)
   const int cover_height = getCoverArtHeight();
   const int num_columns = ((width + (cover_width - 1)) / cover_width);
   const int num_rows = ((height + (cover_height - 1)) / cover_height);
-  m_cover_pixmap_cache.SetMaxCapacity(static_cast<int>(std::max(num_columns * num_rows, MIN_COVER_CACHE_SIZE)));
+
+  // Leave room for the screens either side of the viewport, otherwise prefetching would evict visible covers.
+  const int num_cached = num_columns * num_rows * (1 + COVER_PREFETCH_SCREENS * 2);
+  m_cover_pixmap_cache.SetMaxCapacity(static_cast<int>(std::max(num_cached, MIN_COVER_CACHE_SIZE)));
 }
 
 void GameListModel::reloadCommonImages()
@@ -156,49 +163,80 @@ void GameListModel::reloadCommonImages()
   refresh();
 }
 
-void GameListModel::loadOrGenerateCover(const GameList::Entry* ge)
+void GameListModel::prefetchCovers(const std::vector<int>& rows)
 {
-  QFuture<QPixmap> future =
-    QtConcurrent::run([this, path = ge->path, title = ge->title, serial = ge->serial]() -> QPixmap {
-      QPixmap image;
+  auto lock = GameList::GetLock();
+  const u32 count = GameList::GetEntryCount();
+  for (const int row : rows)
+  {
+    if (row < 0 || static_cast<u32>(row) >= count)
+      continue;
+
+    const GameList::Entry* ge = GameList::GetEntryByIndex(static_cast<u32>(row));
+    if (m_cover_pixmap_cache.Lookup(ge->path))
+      continue;
+
+    loadOrGenerateCover(ge, row);
+    m_cover_pixmap_cache.Insert(ge->path, m_loading_pixmap);
+  }
+}
+
+void GameListModel::loadOrGenerateCover(const GameList::Entry* ge, int row)
+{
+  // Everything the job needs is captured by value, the model can change scale while it's running.
+  QFuture<QImage> future = QtConcurrent::run(
+    [path = ge->path, title = ge->title, serial = ge->serial, width = getCoverArtWidth(), height = getCoverArtHeight(),
+     scale = m_cover_scale, dpr = static_cast<float>(qApp->devicePixelRatio()),
+     placeholder = m_placeholder_image]() -> QImage {
+      QImage image;
       const std::string cover_path(GameList::GetCoverImagePath(path, serial, title));
       if (!cover_path.empty())
       {
-        const float dpr = qApp->devicePixelRatio();
-        image = QPixmap(QString::fromStdString(cover_path));
+        image = QImage(QString::fromStdString(cover_path));
         if (!image.isNull())
         {
           image.setDevicePixelRatio(dpr);
-          resizeAndPadPixmap(&image, getCoverArtWidth(), getCoverArtHeight(), dpr);
+          resizeAndPadImage(&image, width, height, dpr);
         }
       }
 
       if (image.isNull())
-        image =
-          createPlaceholderImage(m_placeholder_pixmap, getCoverArtWidth(), getCoverArtHeight(), m_cover_scale, title);
+        image = createPlaceholderImage(placeholder, width, height, scale, dpr, title);
 
       return image;
     });
 
   // Context must be 'this' so we run on the UI thread.
-  future.then(this, [this, path = ge->path](QPixmap pm) {
-    m_cover_pixmap_cache.Insert(std::move(path), std::move(pm));
-    invalidateCoverForPath(path);
+  future.then(this, [this, path = ge->path, row, generation = m_cover_generation](QImage image) {
+    // Scale changed or covers were refreshed while we were loading, a new job will be queued for this one.
+    if (generation != m_cover_generation)
+      return;
+
+    m_cover_pixmap_cache.Insert(path, QPixmap::fromImage(std::move(image)));
+    invalidateCoverForPath(path, row);
   });
 }
 
-void GameListModel::invalidateCoverForPath(const std::string& path)
+void GameListModel::invalidateCoverForPath(const std::string& path, int row_hint)
 {
-  // This isn't ideal, but not sure how else we can get the row, when it might change while scanning...
   auto lock = GameList::GetLock();
   const u32 count = GameList::GetEntryCount();
   std::optional<u32> row;
-  for (u32 i = 0; i < count; i++)
+  if (row_hint >= 0 && static_cast<u32>(row_hint) < count &&
+      GameList::GetEntryByIndex(static_cast<u32>(row_hint))->path == path)
+  {
+    row = static_cast<u32>(row_hint);
+  }
+  else
   {
-    if (GameList::GetEntryByIndex(i)->path == path)
+    // This isn't ideal, but not sure how else we can get the row, when it might change while scanning...
+    for (u32 i = 0; i < count; i++)
     {
-      row = i;
-      break;
+      if (GameList::GetEntryByIndex(i)->path == path)
+      {
+        row = i;
+        break;
+      }
     }
   }
   if (!row.has_value())
@@ -408,7 +446,7 @@ QVariant GameListModel::data(const QModelIndex& index, int role) const
 
           // We insert the placeholder into the cache, so that we don't repeatedly
           // queue loading jobs for this game.
-          const_cast<GameListModel*>(this)->loadOrGenerateCover(ge);
+          const_cast<GameListModel*>(this)->loadOrGenerateCover(ge, index.row());
           return *m_cover_pixmap_cache.Insert(ge->path, m_loading_pixmap);
         }
         break;
@@ -597,7 +635,11 @@ void GameListModel::loadCommonImages()
     m_compatibility_pixmaps[i] =
       QtUtils::GetIconForCompatibility(static_cast<GameDatabase::CompatibilityRating>(i)).pixmap(96, 24);
 
-  m_placeholder_pixmap.load(QStringLiteral("%1/images/cover-placeholder.png").arg(QtHost::GetResourcesBasePath()));
+  m_placeholder_image.load(QStringLiteral("%1/images/cover-placeholder.png").arg(QtHost::GetResourcesBasePath()));
+
+  // The title gets painted over it, which doesn't work for paletted images.
+  if (!m_placeholder_image.isNull())
+    m_placeholder_image = m_placeholder_image.convertToFormat(QImage::Format_ARGB32_Premultiplied);
 }
 
 void GameListModel::setColumnDisplayNames()
@@ -8,10 +8,12 @@
 #include "core/types.h"
 #include "frontend-common/game_list.h"
 #include <QtCore/QAbstractTableModel>
+#include <QtGui/QImage>
 #include <QtGui/QPixmap>
 #include <algorithm>
 #include <array>
 #include <optional>
+#include <vector>
 
 class GameListModel final : public QAbstractTableModel
 {
@@ -70,11 +72,14 @@ public:
   void updateCacheSize(int width, int height);
   void reloadCommonImages();
 
+  /// Queues loading of covers for the specified rows which aren't already cached or in flight.
+  void prefetchCovers(const std::vector<int>& rows);
+
 private:
   void loadCommonImages();
   void setColumnDisplayNames();
-  void loadOrGenerateCover(const GameList::Entry* ge);
-  void invalidateCoverForPath(const std::string& path);
+  void loadOrGenerateCover(const GameList::Entry* ge, int row);
+  void invalidateCoverForPath(const std::string& path, int row_hint);
 
   float m_cover_scale = 0.0f;
   bool m_show_titles_for_covers = false;
@@ -84,8 +89,9 @@ private:
   std::array<QPixmap, static_cast<int>(DiscRegion::Count)> m_region_pixmaps;
   std::array<QPixmap, static_cast<int>(GameDatabase::CompatibilityRating::Count)> m_compatibility_pixmaps;
 
-  QPixmap m_placeholder_pixmap;
+  QImage m_placeholder_image;
   QPixmap m_loading_pixmap;
 
   mutable LRUCache<std::string, QPixmap> m_cover_pixmap_cache;
+  u32 m_cover_generation = 0;
 };
\ No newline at end of file
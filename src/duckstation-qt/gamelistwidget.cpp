@@ -17,6 +17,7 @@
 #include <QtGui/QWheelEvent>
 #include <QtWidgets/QHeaderView>
 #include <QtWidgets/QMenu>
+#include <QtWidgets/QScrollBar>
 
 static constexpr float MIN_SCALE = 0.1f;
 static constexpr float MAX_SCALE = 2.0f;
@@ -175,6 +176,7 @@ void GameListWidget::initialize()
   connect(m_list_view, &GameListGridListView::zoomOut, this, &GameListWidget::gridZoomOut);
   connect(m_list_view, &QListView::activated, this, &GameListWidget::onListViewItemActivated);
   connect(m_list_view, &QListView::customContextMenuRequested, this, &GameListWidget::onListViewContextMenuRequested);
+  connect(m_list_view->verticalScrollBar(), &QScrollBar::valueChanged, this, &GameListWidget::prefetchGridCovers);
 
   m_ui.stack->insertWidget(1, m_list_view);
 
@@ -446,6 +448,43 @@ void GameListWidget::resizeEvent(QResizeEvent* event)
 {
   QWidget::resizeEvent(event);
   resizeTableViewColumnsToFit();
+  m_model->updateCacheSize(width(), height());
+  prefetchGridCovers();
+}
+
+void GameListWidget::prefetchGridCovers()
+{
+  if (!isShowingGameGrid())
+    return;
+
+  const int row_count = m_sort_model->rowCount();
+  if (row_count == 0)
+    return;
+
+  // All items are the same size, so work out the visible range from the first one instead of hit testing.
+  const int spacing = m_list_view->spacing();
+  const QRect item_rect(m_list_view->visualRect(m_sort_model->index(0, GameListModel::Column_Cover)));
+  const int item_width = std::max(item_rect.width() + spacing * 2, 1);
+  const int item_height = std::max(item_rect.height() + spacing * 2, 1);
+  const QSize viewport_size(m_list_view->viewport()->size());
+  const int items_per_row = std::max(viewport_size.width() / item_width, 1);
+  const int visible_rows = (viewport_size.height() + item_height - 1) / item_height;
+  const int first_visible_row = m_list_view->verticalScrollBar()->value() / item_height;
+
+  // One screen above and below, nearest rows first.
+  const int first_row = std::max(first_visible_row - visible_rows, 0);
+  const int last_row = first_visible_row + visible_rows * 2;
+  const int first_item = first_row * items_per_row;
+  const int last_item = std::min((last_row + 1) * items_per_row, row_count);
+
+  std::vector<int> rows;
+  rows.reserve(static_cast<size_t>(std::max(last_item - first_item, 0)));
+  for (int i = first_visible_row * items_per_row; i < last_item; i++)
+    rows.push_back(m_sort_model->mapToSource(m_sort_model->index(i, GameListModel::Column_Cover)).row());
+  for (int i = std::min(first_visible_row * items_per_row, last_item) - 1; i >= first_item; i--)
+    rows.push_back(m_sort_model->mapToSource(m_sort_model->index(i, GameListModel::Column_Cover)).row());
+
+  m_model->prefetchCovers(rows);
 }
 
 void GameListWidget::resizeTableViewColumnsToFit()
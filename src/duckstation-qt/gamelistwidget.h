@@ -83,6 +83,7 @@ public Q_SLOTS:
   void gridZoomOut();
   void gridIntScale(int int_scale);
   void refreshGridCovers();
+  void prefetchGridCovers();
 
 protected:
   void resizeEvent(QResizeEvent* event);
@@ -8,6 +8,7 @@
 #include "common/assert.h"
 #include "common/file_system.h"
 #include "common/log.h"
+#include "common/trace.h"
 #include "core/achievements.h"
 #include "core/host.h"
 #include "core/host_display.h"
@@ -28,10 +29,13 @@
 #include "settingwidgetbinder.h"
 #include "util/cd_image.h"
 
+#include <QtCore/QDateTime>
 #include <QtCore/QDebug>
+#include <QtCore/QDir>
 #include <QtCore/QFile>
 #include <QtCore/QFileInfo>
 #include <QtCore/QMimeData>
+#include <QtCore/QTimer>
 #include <QtCore/QUrl>
 #include <QtGui/QActionGroup>
 #include <QtGui/QCursor>
@@ -54,13 +58,15 @@
 
 Log_SetChannel(MainWindow);
 
+static constexpr int PERFORMANCE_COUNTERS_POLL_INTERVAL_MS = 250;
+
 static constexpr char DISC_IMAGE_FILTER[] = QT_TRANSLATE_NOOP(
   "MainWindow",
   "All File Types (*.bin *.img *.iso *.cue *.chd *.ecm *.mds *.pbp *.exe *.psexe *.ps-exe *.psf *.minipsf "
-  "*.m3u);;Single-Track "
+  "*.m3u *.psxgpu);;Single-Track "
   "Raw Images (*.bin *.img *.iso);;Cue Sheets (*.cue);;MAME CHD Images (*.chd);;Error Code Modeler Images "
   "(*.ecm);;Media Descriptor Sidecar Images (*.mds);;PlayStation EBOOTs (*.pbp *.PBP);;PlayStation Executables (*.exe "
-  "*.psexe *.ps-exe);;Portable Sound Format Files (*.psf *.minipsf);;Playlists (*.m3u)");
+  "*.psexe *.ps-exe);;Portable Sound Format Files (*.psf *.minipsf);;Playlists (*.m3u);;GPU Dumps (*.psxgpu)");
 
 #ifdef __APPLE__
 const char* DEFAULT_THEME_NAME = "";
@@ -1559,6 +1565,12 @@ void MainWindow::setupAdditionalUi()
   m_status_vps_widget->setFixedSize(125, 16);
   m_status_vps_widget->hide();
 
+  // The emu thread only publishes the counters, we pick them up from here.
+  m_performance_counters_timer = new QTimer(this);
+  m_performance_counters_timer->setInterval(PERFORMANCE_COUNTERS_POLL_INTERVAL_MS);
+  connect(m_performance_counters_timer, &QTimer::timeout, this, &MainWindow::updatePerformanceCounters);
+  m_performance_counters_timer->start();
+
   m_settings_toolbar_menu = new QMenu(m_ui.toolBar);
   m_settings_toolbar_menu->addAction(m_ui.actionSettings);
   m_settings_toolbar_menu->addAction(m_ui.actionViewGameProperties);
@@ -1766,6 +1778,56 @@ void MainWindow::updateStatusBarWidgetVisibility()
   Update(m_status_vps_widget, s_system_valid && !s_system_paused, 0);
 }
 
+void MainWindow::updatePerformanceCounters()
+{
+  EmuThread::PerformanceCounters counters;
+  if (!g_emu_thread->getPerformanceCounters(&counters, &m_performance_counters_seq))
+    return;
+
+  if (!counters.valid)
+  {
+    m_last_speed = std::numeric_limits<float>::infinity();
+    m_last_game_fps = std::numeric_limits<float>::infinity();
+    m_last_video_fps = std::numeric_limits<float>::infinity();
+    m_last_render_width = std::numeric_limits<u32>::max();
+    m_last_render_height = std::numeric_limits<u32>::max();
+    m_last_renderer = GPURenderer::Count;
+
+    m_status_renderer_widget->clear();
+    m_status_resolution_widget->clear();
+    m_status_fps_widget->clear();
+    m_status_vps_widget->clear();
+    return;
+  }
+
+  if (counters.renderer != m_last_renderer)
+  {
+    m_status_renderer_widget->setText(QString::fromUtf8(Settings::GetRendererName(counters.renderer)));
+    m_last_renderer = counters.renderer;
+  }
+  if (counters.render_width != m_last_render_width || counters.render_height != m_last_render_height)
+  {
+    // Strings are still translated in the EmuThread context, which is where they used to be formatted.
+    m_status_resolution_widget->setText(
+      qApp->translate("EmuThread", "%1x%2").arg(counters.render_width).arg(counters.render_height));
+    m_last_render_width = counters.render_width;
+    m_last_render_height = counters.render_height;
+  }
+  if (counters.game_fps != m_last_game_fps)
+  {
+    m_status_fps_widget->setText(qApp->translate("EmuThread", "Game: %1 FPS").arg(counters.game_fps, 0, 'f', 0));
+    m_last_game_fps = counters.game_fps;
+  }
+  if (counters.speed != m_last_speed || counters.video_fps != m_last_video_fps)
+  {
+    m_status_vps_widget->setText(qApp->translate("EmuThread", "Video: %1 FPS (%2%)")
+                                   .arg(counters.video_fps, 0, 'f', 0)
+                                   .arg(counters.speed, 0, 'f', 0));
+    m_last_speed = counters.speed;
+    m_last_video_fps = counters.video_fps;
+  }
+}
+
 void MainWindow::updateWindowTitle()
 {
   QString suffix(QtHost::GetAppConfigSuffix());
@@ -2082,6 +2144,31 @@ void MainWindow::connectSignals()
                                                false);
   SettingWidgetBinder::BindWidgetToBoolSetting(nullptr, m_ui.actionDebugShowMDECState, "Debug", "ShowMDECState", false);
   SettingWidgetBinder::BindWidgetToBoolSetting(nullptr, m_ui.actionDebugShowDMAState, "Debug", "ShowDMAState", false);
+  SettingWidgetBinder::BindWidgetToBoolSetting(nullptr, m_ui.actionDebugShowIOAccessCounts, "Debug",
+                                               "ShowIOAccessCounts", false);
+  SettingWidgetBinder::BindWidgetToBoolSetting(nullptr, m_ui.actionDebugShowCPUProfile, "Debug", "ShowCPUProfile",
+                                               false);
+  SettingWidgetBinder::BindWidgetToBoolSetting(nullptr, m_ui.actionDebugShowCodeCacheStats, "Debug",
+                                               "ShowCodeCacheStats", false);
+  SettingWidgetBinder::BindWidgetToBoolSetting(nullptr, m_ui.actionDebugShowTimingEvents, "Debug", "ShowTimingEvents",
+                                               false);
+#ifdef WITH_TRACING
+  connect(m_ui.actionDebugCaptureTrace, &QAction::toggled, [this](bool checked) {
+    if (checked)
+    {
+      Trace::StartCapture();
+      return;
+    }
+
+    const QString timestamp = QDateTime::currentDateTime().toString(QStringLiteral("yyyyMMdd_HHmmss"));
+    const QString filename =
+      QDir(QString::fromStdString(EmuFolders::DataRoot)).filePath(QStringLiteral("trace_%1.json").arg(timestamp));
+    if (Trace::StopCapture(filename.toUtf8().constData()))
+      Host::AddOSDMessage(tr("Trace written to '%1'.").arg(filename).toStdString(), 10.0f);
+  });
+#else
+  m_ui.actionDebugCaptureTrace->setVisible(false);
+#endif
 
   addThemeToMenu(tr("Default"), QStringLiteral("default"));
   addThemeToMenu(tr("Fusion"), QStringLiteral("fusion"));
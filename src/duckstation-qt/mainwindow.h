@@ -7,6 +7,7 @@
 #include <QtWidgets/QMainWindow>
 #include <QtWidgets/QMenu>
 #include <QtWidgets/QStackedWidget>
+#include <limits>
 #include <memory>
 #include <optional>
 
@@ -20,6 +21,7 @@
 class QLabel;
 class QThread;
 class QProgressBar;
+class QTimer;
 
 class GameListWidget;
 class EmuThread;
@@ -118,6 +120,7 @@ private Q_SLOTS:
   void onMouseModeRequested(bool relative_mode, bool hide_cursor);
 
   void onSettingsResetToDefault();
+  void updatePerformanceCounters();
   void onSystemStarting();
   void onSystemStarted();
   void onSystemDestroyed();
@@ -264,6 +267,15 @@ private:
   QLabel* m_status_vps_widget = nullptr;
   QLabel* m_status_resolution_widget = nullptr;
 
+  QTimer* m_performance_counters_timer = nullptr;
+  u32 m_performance_counters_seq = 0;
+  float m_last_speed = std::numeric_limits<float>::infinity();
+  float m_last_game_fps = std::numeric_limits<float>::infinity();
+  float m_last_video_fps = std::numeric_limits<float>::infinity();
+  u32 m_last_render_width = std::numeric_limits<u32>::max();
+  u32 m_last_render_height = std::numeric_limits<u32>::max();
+  GPURenderer m_last_renderer = GPURenderer::Count;
+
   QMenu* m_settings_toolbar_menu = nullptr;
 
   SettingsDialog* m_settings_dialog = nullptr;
@@ -11,6 +11,8 @@
 #include <QtCore/QFileInfo>
 #include <QtWidgets/QFileDialog>
 #include <QtWidgets/QMessageBox>
+#include <QtWidgets/QScrollBar>
+#include <algorithm>
 
 static constexpr char MEMORY_CARD_IMAGE_FILTER[] = QT_TRANSLATE_NOOP(
   "MemoryCardEditorDialog", "All Memory Card Types (*.mcd *.mcr *.mc *.srm *.psm *.ps *.ddf *.mem *.vgs *.psx)");
@@ -103,6 +105,8 @@ void MemoryCardEditorDialog::resizeEvent(QResizeEvent* ev)
 {
   QtUtils::ResizeColumnsForTableView(m_card_a.table, {32, -1, 155, 45});
   QtUtils::ResizeColumnsForTableView(m_card_b.table, {32, -1, 155, 45});
+  updateVisibleIcons(&m_card_a);
+  updateVisibleIcons(&m_card_b);
 }
 
 void MemoryCardEditorDialog::closeEvent(QCloseEvent* ev)
@@ -125,6 +129,7 @@ void MemoryCardEditorDialog::connectCardUi(Card* card, QDialogButtonBox* buttonB
   connect(card->format_button, &QPushButton::clicked, [this, card] { formatCard(card); });
   connect(card->import_file_button, &QPushButton::clicked, [this, card] { importSaveFile(card); });
   connect(card->import_button, &QPushButton::clicked, [this, card] { importCard(card); });
+  connect(card->table->verticalScrollBar(), &QScrollBar::valueChanged, [this, card] { updateVisibleIcons(card); });
 }
 
 void MemoryCardEditorDialog::connectUi()
@@ -234,7 +239,7 @@ bool MemoryCardEditorDialog::loadCard(const QString& filename, Card* card)
   }
 
   card->filename = std::move(filename_str);
-  updateCardTable(card);
+  updateCardTable(card, true);
   updateCardBlocksFree(card);
   updateButtonState();
   return true;
@@ -250,27 +255,19 @@ static void setCardTableItemProperties(QTableWidgetItem* item, const MemoryCardI
   }
 }
 
-void MemoryCardEditorDialog::updateCardTable(Card* card)
+void MemoryCardEditorDialog::updateCardTable(Card* card, bool from_file /* = false */)
 {
   card->table->setRowCount(0);
 
-  card->files = MemoryCardImage::EnumerateFiles(card->data, true);
+  // Icons are decoded once their row is scrolled into view.
+  card->files = from_file ? MemoryCardImage::EnumerateFilesCached(card->filename.c_str(), card->data, true) :
+                            MemoryCardImage::EnumerateFiles(card->data, true, false);
+  card->files_from_file = from_file;
   for (const MemoryCardImage::FileInfo& fi : card->files)
   {
     const int row = card->table->rowCount();
     card->table->insertRow(row);
 
-    if (!fi.icon_frames.empty())
-    {
-      const QImage image(reinterpret_cast<const u8*>(fi.icon_frames[0].pixels), MemoryCardImage::ICON_WIDTH,
-                         MemoryCardImage::ICON_HEIGHT, QImage::Format_RGBA8888);
-
-      QTableWidgetItem* icon = new QTableWidgetItem();
-      setCardTableItemProperties(icon, fi);
-      icon->setIcon(QIcon(QPixmap::fromImage(image)));
-      card->table->setItem(row, 0, icon);
-    }
-
     QString title_str(QString::fromStdString(fi.title));
     if (fi.deleted)
       title_str += tr(" (Deleted)");
@@ -287,6 +284,45 @@ void MemoryCardEditorDialog::updateCardTable(Card* card)
     setCardTableItemProperties(item, fi);
     card->table->setItem(row, 3, item);
   }
+
+  updateVisibleIcons(card);
+}
+
+void MemoryCardEditorDialog::updateVisibleIcons(Card* card)
+{
+  const int row_count = card->table->rowCount();
+  if (row_count == 0)
+    return;
+
+  const int first_row = std::max(card->table->rowAt(0), 0);
+  int last_row = card->table->rowAt(card->table->viewport()->height() - 1);
+  if (last_row < 0)
+    last_row = row_count - 1;
+
+  for (int row = first_row; row <= last_row && static_cast<size_t>(row) < card->files.size(); row++)
+  {
+    if (card->table->item(row, 0))
+      continue;
+
+    MemoryCardImage::FileInfo& fi = card->files[row];
+    if (fi.num_icon_frames == 0)
+      continue;
+
+    if (fi.icon_frames.empty())
+    {
+      MemoryCardImage::DecodeIcons(card->data, &fi);
+      if (card->files_from_file)
+        MemoryCardImage::UpdateCachedIcons(card->filename.c_str(), fi);
+    }
+
+    const QImage image(reinterpret_cast<const u8*>(fi.icon_frames[0].pixels), MemoryCardImage::ICON_WIDTH,
+                       MemoryCardImage::ICON_HEIGHT, QImage::Format_RGBA8888);
+
+    QTableWidgetItem* icon = new QTableWidgetItem();
+    setCardTableItemProperties(icon, fi);
+    icon->setIcon(QIcon(QPixmap::fromImage(image)));
+    card->table->setItem(row, 0, icon);
+  }
 }
 
 void MemoryCardEditorDialog::updateCardBlocksFree(Card* card)
@@ -352,7 +388,7 @@ void MemoryCardEditorDialog::openCard(Card* card)
   }
 
   card->filename = filename.toStdString();
-  updateCardTable(card);
+  updateCardTable(card, true);
   updateCardBlocksFree(card);
   updateButtonState();
 }
@@ -41,6 +41,7 @@ private:
     std::string filename;
     MemoryCardImage::DataArray data;
     std::vector<MemoryCardImage::FileInfo> files;
+    bool files_from_file = false;
     u32 blocks_free = 0;
     bool dirty = false;
 
@@ -61,7 +62,8 @@ private:
   void clearSelection();
   void loadCardFromComboBox(Card* card, int index);
   bool loadCard(const QString& filename, Card* card);
-  void updateCardTable(Card* card);
+  void updateCardTable(Card* card, bool from_file = false);
+  void updateVisibleIcons(Card* card);
   void updateCardBlocksFree(Card* card);
   void setCardDirty(Card* card);
   void newCard(Card* card);
@@ -1,6 +1,8 @@
 #include "memoryviewwidget.h"
 #include <QtGui/QPainter>
+#include <QtGui/QPaintEvent>
 #include <QtWidgets/QScrollBar>
+#include <algorithm>
 #include <cstring>
 
 MemoryViewWidget::MemoryViewWidget(QWidget* parent /* = nullptr */, size_t address_offset /* = 0 */,
@@ -50,6 +52,76 @@ void MemoryViewWidget::setData(size_t address_offset, const void* data_ptr, size
   adjustContent();
 }
 
+size_t MemoryViewWidget::snapshotSize() const
+{
+  // The last visible row can be partially cut off, but it's still drawn.
+  const size_t num_rows = (m_end_offset - m_start_offset) / m_bytes_per_line + 1;
+  return std::min(num_rows * m_bytes_per_line, m_data_size - m_start_offset);
+}
+
+void MemoryViewWidget::takeSnapshot()
+{
+  if (!m_data || m_start_offset >= m_data_size)
+  {
+    m_snapshot.clear();
+    m_snapshot_changed.clear();
+    return;
+  }
+
+  m_snapshot_offset = m_start_offset;
+  m_snapshot.resize(snapshotSize());
+  std::memcpy(m_snapshot.data(), static_cast<const unsigned char*>(m_data) + m_snapshot_offset, m_snapshot.size());
+  m_snapshot_changed.assign(m_snapshot.size(), false);
+}
+
+QRect MemoryViewWidget::rowRect(unsigned row) const
+{
+  // Rows start after the header, and the highlight extends a little below the baseline.
+  return QRect(0, static_cast<int>(row + 1) * m_char_height, viewport()->width(), m_char_height + 4);
+}
+
+void MemoryViewWidget::refreshSnapshot()
+{
+  if (!m_data)
+    return;
+
+  if (m_snapshot_offset != m_start_offset || m_snapshot.size() != snapshotSize())
+  {
+    // window moved, nothing to compare against
+    takeSnapshot();
+    viewport()->update();
+    return;
+  }
+
+  m_previous_snapshot.swap(m_snapshot);
+  m_snapshot.resize(m_previous_snapshot.size());
+  std::memcpy(m_snapshot.data(), static_cast<const unsigned char*>(m_data) + m_snapshot_offset, m_snapshot.size());
+
+  QRegion dirty_region;
+  const size_t size = m_snapshot.size();
+  for (size_t row_start = 0, row = 0; row_start < size; row_start += m_bytes_per_line, row++)
+  {
+    const size_t row_end = std::min(row_start + m_bytes_per_line, size);
+    const bool row_data_changed =
+      (std::memcmp(&m_snapshot[row_start], &m_previous_snapshot[row_start], row_end - row_start) != 0);
+
+    bool row_dirty = false;
+    for (size_t i = row_start; i < row_end; i++)
+    {
+      // rows which were highlighted last time need repainting too, to clear it
+      const bool changed = row_data_changed && (m_snapshot[i] != m_previous_snapshot[i]);
+      row_dirty |= (changed || m_snapshot_changed[i]);
+      m_snapshot_changed[i] = changed;
+    }
+
+    if (row_dirty)
+      dirty_region += rowRect(static_cast<unsigned>(row));
+  }
+
+  if (!dirty_region.isEmpty())
+    viewport()->update(dirty_region);
+}
+
 void MemoryViewWidget::setHighlightRange(size_t start, size_t end)
 {
   m_highlight_start = start;
@@ -95,25 +167,35 @@ static bool RangesOverlap(T x1, T x2, T y1, T y2)
   return (x2 >= y1 && x1 < y2);
 }
 
-void MemoryViewWidget::paintEvent(QPaintEvent*)
+void MemoryViewWidget::paintEvent(QPaintEvent* event)
 {
   QPainter painter(viewport());
   painter.setFont(font());
-  if (!m_data)
+  if (!m_data || m_snapshot.empty())
     return;
 
   const QColor highlight_color(100, 100, 0);
+  const QColor changed_color(255, 64, 64);
+  const QColor text_color(viewport()->palette().color(QPalette::WindowText));
   const int offsetX = horizontalScrollBar()->value();
 
   int y = m_char_height;
   QString address;
 
-  painter.setPen(viewport()->palette().color(QPalette::WindowText));
+  painter.setPen(text_color);
 
   y += m_char_height;
 
+  // Only rows which intersect the update rect need drawing, typically just the ones which changed.
   const unsigned num_rows = static_cast<unsigned>(m_end_offset - m_start_offset) / m_bytes_per_line;
-  for (unsigned row = 0; row <= num_rows; row++)
+  const QRect& update_rect = event->rect();
+  const unsigned first_row =
+    static_cast<unsigned>(std::max(update_rect.top() / std::max(m_char_height, 1) - 2, 0));
+  const unsigned last_row =
+    std::min(static_cast<unsigned>(std::max(update_rect.bottom() / std::max(m_char_height, 1), 0)), num_rows);
+
+  y += m_char_height * first_row;
+  for (unsigned row = first_row; row <= last_row; row++)
   {
     const size_t data_offset = m_start_offset + (row * m_bytes_per_line);
     const unsigned row_address = static_cast<unsigned>(m_address_offset + data_offset);
@@ -154,22 +236,26 @@ void MemoryViewWidget::paintEvent(QPaintEvent*)
   painter.drawLine(0, y + 3, width(), y + 3);
   y += m_char_height;
 
-  size_t offset = m_start_offset;
-  for (unsigned row = 0; row <= num_rows; row++)
+  const size_t snapshot_end = m_snapshot_offset + m_snapshot.size();
+  y += m_char_height * first_row;
+  size_t offset = m_start_offset + first_row * m_bytes_per_line;
+  for (unsigned row = first_row; row <= last_row; row++)
   {
     x = lx - offsetX + m_char_width;
-    for (unsigned col = 0; col < m_bytes_per_line && offset < m_data_size; col++, offset++)
+    for (unsigned col = 0; col < m_bytes_per_line && offset < snapshot_end; col++, offset++)
     {
-      unsigned char value;
-      std::memcpy(&value, static_cast<const unsigned char*>(m_data) + offset, sizeof(value));
+      const size_t snapshot_index = offset - m_snapshot_offset;
+      const unsigned char value = m_snapshot[snapshot_index];
       if (offset >= m_highlight_start && offset < m_highlight_end)
         painter.fillRect(x - m_char_width, y - m_char_height + 3, HEX_CHAR_WIDTH, m_char_height, highlight_color);
 
+      painter.setPen(m_snapshot_changed[snapshot_index] ? changed_color : text_color);
       painter.drawText(x, y, QString::asprintf("%02X", value));
       x += HEX_CHAR_WIDTH;
     }
     y += m_char_height;
   }
+  painter.setPen(text_color);
 
   lx = addressWidth() + hexWidth();
   painter.drawLine(lx - offsetX, 0, lx - offsetX, height());
@@ -187,19 +273,21 @@ void MemoryViewWidget::paintEvent(QPaintEvent*)
 
   y += m_char_height;
 
-  offset = m_start_offset;
-  for (unsigned row = 0; row <= num_rows; row++)
+  y += m_char_height * first_row;
+  offset = m_start_offset + first_row * m_bytes_per_line;
+  for (unsigned row = first_row; row <= last_row; row++)
   {
     x = lx - offsetX;
-    for (unsigned col = 0; col < m_bytes_per_line && offset < m_data_size; col++, offset++)
+    for (unsigned col = 0; col < m_bytes_per_line && offset < snapshot_end; col++, offset++)
     {
-      unsigned char value;
-      std::memcpy(&value, static_cast<const unsigned char*>(m_data) + offset, sizeof(value));
+      const size_t snapshot_index = offset - m_snapshot_offset;
+      unsigned char value = m_snapshot[snapshot_index];
       if (offset >= m_highlight_start && offset < m_highlight_end)
         painter.fillRect(x, y - m_char_height + 3, 2 * m_char_width, m_char_height, highlight_color);
 
       if (!std::isprint(value))
         value = '.';
+      painter.setPen(m_snapshot_changed[snapshot_index] ? changed_color : text_color);
       painter.drawText(x, y, static_cast<QChar>(value));
       x += 2 * m_char_width;
     }
@@ -232,5 +320,6 @@ void MemoryViewWidget::adjustContent()
   verticalScrollBar()->setRange(0, lineCount - m_rows_visible);
   verticalScrollBar()->setPageStep(m_rows_visible);
 
+  takeSnapshot();
   viewport()->update();
 }
\ No newline at end of file
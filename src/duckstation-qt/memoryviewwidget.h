@@ -1,5 +1,6 @@
 #pragma once
 #include <QtWidgets/QAbstractScrollArea>
+#include <vector>
 
 // Based on https://stackoverflow.com/questions/46375673/how-can-realize-my-own-memory-viewer-by-qt
 
@@ -21,6 +22,10 @@ public:
   void scrollToAddress(size_t address);
   void setFont(const QFont& font);
 
+  /// Re-reads the visible window from the data, and only repaints the rows which changed since the last refresh.
+  /// Bytes which changed are highlighted until the next refresh.
+  void refreshSnapshot();
+
 protected:
   void paintEvent(QPaintEvent*);
   void resizeEvent(QResizeEvent*);
@@ -33,6 +38,9 @@ private:
   int hexWidth() const;
   int asciiWidth() const;
   void updateMetrics();
+  size_t snapshotSize() const;
+  void takeSnapshot();
+  QRect rowRect(unsigned row) const;
 
   const void* m_data;
   size_t m_data_size;
@@ -50,4 +58,10 @@ private:
   int m_char_height;
 
   int m_rows_visible;
+
+  // Painting is done from a copy of the visible window, rather than reading the data byte-by-byte.
+  std::vector<unsigned char> m_snapshot;
+  std::vector<unsigned char> m_previous_snapshot;
+  std::vector<bool> m_snapshot_changed;
+  size_t m_snapshot_offset = 0;
 };
\ No newline at end of file
@@ -9,6 +9,8 @@
 #include "common/log.h"
 #include "common/path.h"
 #include "common/string_util.h"
+#include "common/timer.h"
+#include "common/trace.h"
 #include "common/window_info.h"
 #include "core/cheats.h"
 #include "core/controller.h"
@@ -69,6 +71,9 @@ static constexpr u32 BACKGROUND_CONTROLLER_POLLING_INTERVAL = 100;
 /// Poll at half the vsync rate for FSUI to reduce the chance of getting a press+release in the same frame.
 static constexpr u32 FULLSCREEN_UI_CONTROLLER_POLLING_INTERVAL = 8;
 
+/// How often the paused fullscreen UI is redrawn when there's no input or messages.
+static constexpr double IDLE_RENDER_INTERVAL = 0.5;
+
 //////////////////////////////////////////////////////////////////////////
 // Local function declarations
 //////////////////////////////////////////////////////////////////////////
@@ -1412,6 +1417,7 @@ void EmuThread::run()
   startBackgroundControllerPollTimer();
 
   // main loop
+  Common::Timer::Value last_render_time = 0;
   while (!m_shutdown_flag)
   {
     if (System::IsRunning())
@@ -1428,11 +1434,23 @@ void EmuThread::run()
         continue;
       }
 
+      // while paused with nothing changing on screen, sleep until the next controller poll or event instead of
+      // redrawing every vblank
+      if (System::IsPaused() && ImGuiManager::IsUIIdle() &&
+          Common::Timer::ConvertValueToSeconds(Common::Timer::GetCurrentValue() - last_render_time) <
+            IDLE_RENDER_INTERVAL)
+      {
+        m_event_loop->processEvents(QEventLoop::AllEvents | QEventLoop::WaitForMoreEvents);
+        CommonHost::PumpMessagesOnCPUThread();
+        continue;
+      }
+
       m_event_loop->processEvents(QEventLoop::AllEvents);
       CommonHost::PumpMessagesOnCPUThread();
       if (g_host_display)
       {
         renderDisplay(false);
+        last_render_time = Common::Timer::GetCurrentValue();
         if (!g_host_display->IsVsyncEnabled())
           g_host_display->ThrottlePresentation();
       }
@@ -1465,7 +1483,10 @@ void EmuThread::renderDisplay(bool skip_present)
   ImGuiManager::RenderOverlayWindows();
   ImGuiManager::RenderDebugWindows();
 
-  g_host_display->Render(skip_present);
+  {
+    TRACE_SCOPE("HostDisplay::Render");
+    g_host_display->Render(skip_present);
+  }
 
   ImGuiManager::NewFrame();
 }
@@ -1617,68 +1638,74 @@ void Host::ReleaseHostDisplay()
 
 void EmuThread::updatePerformanceCounters()
 {
-  GPURenderer renderer = GPURenderer::Count;
-  u32 render_width = 0;
-  u32 render_height = 0;
-
+  PerformanceCounters counters;
+  counters.renderer = GPURenderer::Count;
+  counters.render_width = 0;
+  counters.render_height = 0;
   if (g_gpu)
   {
-    renderer = g_gpu->GetRendererType();
-    std::tie(render_width, render_height) = g_gpu->GetEffectiveDisplayResolution();
+    counters.renderer = g_gpu->GetRendererType();
+    std::tie(counters.render_width, counters.render_height) = g_gpu->GetEffectiveDisplayResolution();
   }
 
-  if (renderer != m_last_renderer)
-  {
-    QMetaObject::invokeMethod(g_main_window->getStatusRendererWidget(), "setText", Qt::QueuedConnection,
-                              Q_ARG(const QString&, QString::fromUtf8(Settings::GetRendererName(renderer))));
-    m_last_renderer = renderer;
-  }
-  if (render_width != m_last_render_width || render_height != m_last_render_height)
-  {
-    QMetaObject::invokeMethod(g_main_window->getStatusResolutionWidget(), "setText", Qt::QueuedConnection,
-                              Q_ARG(const QString&, tr("%1x%2").arg(render_width).arg(render_height)));
-    m_last_render_width = render_width;
-    m_last_render_height = render_height;
-  }
+  counters.game_fps = System::GetFPS();
+  counters.video_fps = System::GetVPS();
+  counters.speed = System::GetEmulationSpeed();
+  counters.valid = true;
+  publishPerformanceCounters(counters);
+}
 
-  const float gfps = System::GetFPS();
-  if (gfps != m_last_game_fps)
-  {
-    QMetaObject::invokeMethod(g_main_window->getStatusFPSWidget(), "setText", Qt::QueuedConnection,
-                              Q_ARG(const QString&, tr("Game: %1 FPS").arg(gfps, 0, 'f', 0)));
-    m_last_game_fps = gfps;
-  }
+void EmuThread::resetPerformanceCounters()
+{
+  PerformanceCounters counters = {};
+  counters.renderer = GPURenderer::Count;
+  counters.valid = false;
+  publishPerformanceCounters(counters);
+}
 
-  const float speed = System::GetEmulationSpeed();
-  const float vfps = System::GetVPS();
-  if (speed != m_last_speed || vfps != m_last_video_fps)
-  {
-    QMetaObject::invokeMethod(
-      g_main_window->getStatusVPSWidget(), "setText", Qt::QueuedConnection,
-      Q_ARG(const QString&, tr("Video: %1 FPS (%2%)").arg(vfps, 0, 'f', 0).arg(speed, 0, 'f', 0)));
-    m_last_speed = speed;
-    m_last_video_fps = vfps;
-  }
+void EmuThread::publishPerformanceCounters(const PerformanceCounters& counters)
+{
+  // Only ever written from the emu thread.
+  const u32 seq = m_performance_counters_seq.load(std::memory_order_relaxed);
+  m_performance_counters_seq.store(seq + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+
+  m_performance_renderer.store(counters.renderer, std::memory_order_relaxed);
+  m_performance_render_width.store(counters.render_width, std::memory_order_relaxed);
+  m_performance_render_height.store(counters.render_height, std::memory_order_relaxed);
+  m_performance_game_fps.store(counters.game_fps, std::memory_order_relaxed);
+  m_performance_video_fps.store(counters.video_fps, std::memory_order_relaxed);
+  m_performance_speed.store(counters.speed, std::memory_order_relaxed);
+  m_performance_valid.store(counters.valid, std::memory_order_relaxed);
+
+  m_performance_counters_seq.store(seq + 2, std::memory_order_release);
 }
 
-void EmuThread::resetPerformanceCounters()
+bool EmuThread::getPerformanceCounters(PerformanceCounters* counters, u32* seq) const
 {
-  m_last_speed = std::numeric_limits<float>::infinity();
-  m_last_game_fps = std::numeric_limits<float>::infinity();
-  m_last_video_fps = std::numeric_limits<float>::infinity();
-  m_last_render_width = std::numeric_limits<u32>::max();
-  m_last_render_height = std::numeric_limits<u32>::max();
-  m_last_renderer = GPURenderer::Count;
-
-  QString blank;
-  QMetaObject::invokeMethod(g_main_window->getStatusRendererWidget(), "setText", Qt::QueuedConnection,
-                            Q_ARG(const QString&, blank));
-  QMetaObject::invokeMethod(g_main_window->getStatusResolutionWidget(), "setText", Qt::QueuedConnection,
-                            Q_ARG(const QString&, blank));
-  QMetaObject::invokeMethod(g_main_window->getStatusFPSWidget(), "setText", Qt::QueuedConnection,
-                            Q_ARG(const QString&, blank));
-  QMetaObject::invokeMethod(g_main_window->getStatusVPSWidget(), "setText", Qt::QueuedConnection,
-                            Q_ARG(const QString&, blank));
+  for (;;)
+  {
+    const u32 start_seq = m_performance_counters_seq.load(std::memory_order_acquire);
+    if (start_seq == *seq)
+      return false;
+    if (start_seq & 1u)
+      continue;
+
+    counters->renderer = m_performance_renderer.load(std::memory_order_relaxed);
+    counters->render_width = m_performance_render_width.load(std::memory_order_relaxed);
+    counters->render_height = m_performance_render_height.load(std::memory_order_relaxed);
+    counters->game_fps = m_performance_game_fps.load(std::memory_order_relaxed);
+    counters->video_fps = m_performance_video_fps.load(std::memory_order_relaxed);
+    counters->speed = m_performance_speed.load(std::memory_order_relaxed);
+    counters->valid = m_performance_valid.load(std::memory_order_relaxed);
+
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (m_performance_counters_seq.load(std::memory_order_relaxed) == start_seq)
+    {
+      *seq = start_seq;
+      return true;
+    }
+  }
 }
 
 void Host::OnPerformanceCountersUpdated()
@@ -110,9 +110,23 @@ public:
 
   void bootOrLoadState(std::string path);
 
+  struct PerformanceCounters
+  {
+    GPURenderer renderer;
+    u32 render_width;
+    u32 render_height;
+    float game_fps;
+    float video_fps;
+    float speed;
+    bool valid;
+  };
+
   void updatePerformanceCounters();
   void resetPerformanceCounters();
 
+  /// Copies out the most recently published counters, if they changed since seq. Safe to call from any thread.
+  bool getPerformanceCounters(PerformanceCounters* counters, u32* seq) const;
+
   /// Locks the system by pausing it, while a popup dialog is displayed.
   /// This version is **only** for the system thread. UI thread should use the MainWindow variant.
   SystemLock pauseAndLockSystem();
@@ -210,6 +224,7 @@ private:
   void destroyBackgroundControllerPollTimer();
   void setInitialState(std::optional<bool> override_fullscreen);
   void updateDisplayState();
+  void publishPerformanceCounters(const PerformanceCounters& counters);
 
   QThread* m_ui_thread;
   QSemaphore m_started_semaphore;
@@ -227,12 +242,16 @@ private:
 
   bool m_was_paused_by_focus_loss = false;
 
-  float m_last_speed = std::numeric_limits<float>::infinity();
-  float m_last_game_fps = std::numeric_limits<float>::infinity();
-  float m_last_video_fps = std::numeric_limits<float>::infinity();
-  u32 m_last_render_width = std::numeric_limits<u32>::max();
-  u32 m_last_render_height = std::numeric_limits<u32>::max();
-  GPURenderer m_last_renderer = GPURenderer::Count;
+  // Performance counters are published by the emu thread and polled by the UI thread through a sequence lock, so
+  // neither side blocks, and nothing is allocated or queued per update. The sequence is odd while a write is going on.
+  std::atomic<u32> m_performance_counters_seq{0};
+  std::atomic<GPURenderer> m_performance_renderer{GPURenderer::Count};
+  std::atomic<u32> m_performance_render_width{0};
+  std::atomic<u32> m_performance_render_height{0};
+  std::atomic<float> m_performance_game_fps{0.0f};
+  std::atomic<float> m_performance_video_fps{0.0f};
+  std::atomic<float> m_performance_speed{0.0f};
+  std::atomic_bool m_performance_valid{false};
 };
 
 extern EmuThread* g_emu_thread;
@@ -8,17 +8,31 @@
 #include "common/memory_settings_interface.h"
 #include "common/path.h"
 #include "common/string_util.h"
+#include "common/threading.h"
+#include "common/timer.h"
+#include "core/bus.h"
+#include "core/cpu_code_cache.h"
+#include "core/cpu_core.h"
+#include "core/gpu.h"
 #include "core/host.h"
 #include "core/host_display.h"
 #include "core/host_settings.h"
+#include "core/input_movie.h"
+#include "core/spu.h"
 #include "core/system.h"
+#include "core/timing_event.h"
 #include "frontend-common/common_host.h"
 #include "frontend-common/game_list.h"
 #include "frontend-common/input_manager.h"
 #include "regtest_host_display.h"
 #include "scmversion/scmversion.h"
+#include "xxhash.h"
+#include <algorithm>
+#include <cmath>
 #include <csignal>
+#include <cinttypes>
 #include <cstdio>
+#include <vector>
 Log_SetChannel(RegTestHost);
 
 #ifdef WITH_CHEEVOS
@@ -35,8 +49,33 @@ static void HookSignals();
 static void SetAppRoot();
 static bool SetFolders();
 static std::string GetFrameDumpFilename(u32 frame);
+static bool OpenGPUTimingsFile();
+static void WriteGPUTimings(u32 frame, float gpu_time);
+static void WriteBenchmarkStats(std::FILE* fp, const char* name, std::vector<float> values);
+static bool WriteBenchmarkReport(double total_time_ms, const CPU::CodeCache::CompileStats& compile_stats);
+static bool WriteIOAccessCounts();
+static bool WriteCPUProfile();
+static bool OpenFrameHashFile();
+static bool LoadFrameHashReference();
+static void WriteFrameHashes(u32 frame);
 } // namespace RegTestHost
 
+struct BenchmarkFrame
+{
+  float frame_time;
+  float cpu_thread_time;
+  float sw_thread_time;
+  float gpu_time;
+};
+
+struct FrameHashes
+{
+  u64 display;
+  u64 vram;
+  u64 audio;
+  u64 state;
+};
+
 static std::unique_ptr<MemorySettingsInterface> s_base_settings_interface;
 
 static u32 s_frames_to_run = 60 * 60;
@@ -44,6 +83,24 @@ static u32 s_frame_dump_interval = 0;
 static std::string s_dump_base_directory;
 static std::string s_dump_game_directory;
 static GPURenderer s_renderer_to_use = GPURenderer::Software;
+static std::string s_gpu_timings_filename;
+static std::FILE* s_gpu_timings_file = nullptr;
+static std::string s_benchmark_filename;
+static std::vector<BenchmarkFrame> s_benchmark_frames;
+static std::string s_io_counts_filename;
+static std::string s_cpu_profile_filename;
+static std::string s_convert_trace_input;
+static std::string s_convert_trace_output;
+static float s_frame_gpu_time = 0.0f;
+static std::string s_frame_hash_filename;
+static std::string s_frame_hash_reference_filename;
+static std::FILE* s_frame_hash_file = nullptr;
+static std::vector<std::optional<FrameHashes>> s_frame_hash_reference;
+static std::vector<u32> s_frame_hash_pixels;
+static u32 s_frame_hash_mismatches = 0;
+static bool s_hash_vram = false;
+static bool s_hash_audio = false;
+static bool s_hash_state = false;
 
 bool RegTestHost::SetFolders()
 {
@@ -302,7 +359,18 @@ void Host::RenderDisplay(bool skip_present)
   if (s_frame_dump_interval > 0 && (s_frame_dump_interval == 1 || (frame % s_frame_dump_interval) == 0))
   {
     std::string dump_filename(RegTestHost::GetFrameDumpFilename(frame));
-    g_host_display->WriteDisplayTextureToFile(std::move(dump_filename));
+    g_host_display->WriteDisplayTextureToFile(std::move(dump_filename), true, true, true);
+  }
+
+  if (s_frame_hash_file)
+    RegTestHost::WriteFrameHashes(frame);
+
+  // GPU time is reset when it's read, so it's read once here for both the timings file and the benchmark
+  if (g_host_display->IsGPUTimingEnabled())
+  {
+    s_frame_gpu_time = g_host_display->GetAndResetAccumulatedGPUTime();
+    if (s_gpu_timings_file)
+      RegTestHost::WriteGPUTimings(frame, s_frame_gpu_time);
   }
 }
 
@@ -416,9 +484,27 @@ void RegTestHost::PrintCommandLineHelp(const char* progname)
   std::fprintf(stderr, "  -version: Displays version information and exits.\n");
   std::fprintf(stderr, "  -dumpdir: Set frame dump base directory (will be dumped to basedir/gametitle).\n");
   std::fprintf(stderr, "  -dumpinterval: Dumps every N frames.\n");
+  std::fprintf(stderr, "  -hashframes <file>: Writes a hash of every displayed frame to a text file.\n");
+  std::fprintf(stderr, "  -hashvram: Also hashes VRAM for every frame.\n");
+  std::fprintf(stderr, "  -hashaudio: Also hashes the audio output of every frame.\n");
+  std::fprintf(stderr, "  -hashstate: Also hashes RAM, VRAM, sound RAM, CPU registers and events every frame.\n");
+  std::fprintf(stderr, "  -hashreference <file>: Compares the hashes against an earlier -hashframes file,\n"
+                       "    dumping frames which differ to the dump directory. Exits with an error if any differ.\n");
   std::fprintf(stderr, "  -frames: Sets the number of frames to execute.\n");
   std::fprintf(stderr, "  -log <level>: Sets the log level. Defaults to verbose.\n");
   std::fprintf(stderr, "  -renderer <renderer>: Sets the graphics renderer. Default to software.\n");
+  std::fprintf(stderr, "  -gputimings <file>: Writes per-frame GPU timing scopes to a CSV file.\n");
+  std::fprintf(stderr, "  -benchmark <file>: Times every frame, and writes a JSON report with percentiles\n"
+                       "    of the frame, CPU thread, software renderer thread and GPU times, and\n"
+                       "    per timing event scheduling counts.\n");
+  std::fprintf(stderr, "  -iocounts <file>: Counts accesses to each I/O register, and writes them to a\n"
+                       "    JSON file.\n");
+  std::fprintf(stderr, "  -cpuprofile <file>: Samples the guest PC, and writes the busiest functions and\n"
+                       "    blocks to a JSON file.\n");
+  std::fprintf(stderr, "  -converttrace <trace> <output>: Disassembles a binary CPU trace (cpu_trace.bin)\n"
+                       "    to a text file, and exits.\n");
+  std::fprintf(stderr, "  -replay <file>: Replays an input movie, running for its length. Exits with\n"
+                       "    an error if the RAM does not match the recording.\n");
   std::fprintf(stderr, "  --: Signals that no more arguments will follow and the remaining\n"
                        "    parameters make up the filename. Use when the filename contains\n"
                        "    spaces or starts with a dash.\n");
@@ -475,6 +561,43 @@ bool RegTestHost::ParseCommandLineParameters(int argc, char* argv[], std::option
 
         continue;
       }
+      else if (CHECK_ARG_PARAM("-hashframes"))
+      {
+        s_frame_hash_filename = argv[++i];
+        if (s_frame_hash_filename.empty())
+        {
+          Log_ErrorPrintf("Invalid frame hash filename specified.");
+          return false;
+        }
+
+        continue;
+      }
+      else if (CHECK_ARG("-hashvram"))
+      {
+        s_hash_vram = true;
+        continue;
+      }
+      else if (CHECK_ARG("-hashaudio"))
+      {
+        s_hash_audio = true;
+        continue;
+      }
+      else if (CHECK_ARG("-hashstate"))
+      {
+        s_hash_state = true;
+        continue;
+      }
+      else if (CHECK_ARG_PARAM("-hashreference"))
+      {
+        s_frame_hash_reference_filename = argv[++i];
+        if (s_frame_hash_reference_filename.empty())
+        {
+          Log_ErrorPrintf("Invalid frame hash reference filename specified.");
+          return false;
+        }
+
+        continue;
+      }
       else if (CHECK_ARG_PARAM("-frames"))
       {
         s_frames_to_run = StringUtil::FromChars<u32>(argv[++i]).value_or(0);
@@ -486,6 +609,65 @@ bool RegTestHost::ParseCommandLineParameters(int argc, char* argv[], std::option
 
         continue;
       }
+      else if (CHECK_ARG_PARAM("-gputimings"))
+      {
+        s_gpu_timings_filename = argv[++i];
+        if (s_gpu_timings_filename.empty())
+        {
+          Log_ErrorPrintf("Invalid GPU timings filename specified.");
+          return false;
+        }
+
+        continue;
+      }
+      else if (CHECK_ARG_PARAM("-benchmark"))
+      {
+        s_benchmark_filename = argv[++i];
+        if (s_benchmark_filename.empty())
+        {
+          Log_ErrorPrintf("Invalid benchmark report filename specified.");
+          return false;
+        }
+
+        // frames are never throttled here, but the speed also affects e.g. the audio resampler
+        s_base_settings_interface->SetFloatValue("Main", "EmulationSpeed", 0.0f);
+        continue;
+      }
+      else if (CHECK_ARG_PARAM("-iocounts"))
+      {
+        s_io_counts_filename = argv[++i];
+        if (s_io_counts_filename.empty())
+        {
+          Log_ErrorPrintf("Invalid I/O access counts filename specified.");
+          return false;
+        }
+
+        s_base_settings_interface->SetBoolValue("Debug", "CountIOAccesses", true);
+        continue;
+      }
+      else if (CHECK_ARG_PARAM("-cpuprofile"))
+      {
+        s_cpu_profile_filename = argv[++i];
+        if (s_cpu_profile_filename.empty())
+        {
+          Log_ErrorPrintf("Invalid CPU profile filename specified.");
+          return false;
+        }
+
+        s_base_settings_interface->SetBoolValue("Debug", "ProfileCPU", true);
+        continue;
+      }
+      else if (CHECK_ARG("-converttrace") && (i + 2) < argc)
+      {
+        s_convert_trace_input = argv[++i];
+        s_convert_trace_output = argv[++i];
+        continue;
+      }
+      else if (CHECK_ARG_PARAM("-replay"))
+      {
+        AutoBoot(autoboot)->replay_input_movie = argv[++i];
+        continue;
+      }
       else if (CHECK_ARG_PARAM("-log"))
       {
         std::optional<LOGLEVEL> level = Settings::ParseLogLevelName(argv[++i]);
@@ -538,6 +720,292 @@ std::string RegTestHost::GetFrameDumpFilename(u32 frame)
   return Path::Combine(s_dump_game_directory, fmt::format("frame_{:05d}.png", frame));
 }
 
+bool RegTestHost::OpenGPUTimingsFile()
+{
+  if (!g_host_display->SetGPUTimingEnabled(true))
+  {
+    Log_ErrorPrintf("GPU timing is not supported by the host display.");
+    return false;
+  }
+
+  s_gpu_timings_file = FileSystem::OpenCFile(s_gpu_timings_filename.c_str(), "wb");
+  if (!s_gpu_timings_file)
+  {
+    Log_ErrorPrintf("Failed to open GPU timings file '%s'.", s_gpu_timings_filename.c_str());
+    return false;
+  }
+
+  std::fputs("Frame,Total", s_gpu_timings_file);
+  for (u32 i = 0; i < HostDisplay::MAX_GPU_TIMING_SCOPES; i++)
+    std::fprintf(s_gpu_timings_file, ",%s", g_host_display->GetGPUTimingScopeName(i).c_str());
+  std::fputc('\n', s_gpu_timings_file);
+  return true;
+}
+
+void RegTestHost::WriteGPUTimings(u32 frame, float gpu_time)
+{
+  // timestamps are read back a few frames late, so each row is the GPU time which became available this frame.
+  std::fprintf(s_gpu_timings_file, "%u,%.4f", frame, gpu_time);
+
+  const HostDisplay::GPUTimingScopeTimes scope_times = g_host_display->GetAndResetAccumulatedGPUTimingScopeTimes();
+  for (const float time : scope_times)
+    std::fprintf(s_gpu_timings_file, ",%.4f", time);
+  std::fputc('\n', s_gpu_timings_file);
+}
+
+void RegTestHost::WriteBenchmarkStats(std::FILE* fp, const char* name, std::vector<float> values)
+{
+  std::sort(values.begin(), values.end());
+
+  // nearest-rank percentiles, so every reported value is a real frame
+  const auto percentile = [&values](double pct) {
+    const size_t rank = static_cast<size_t>(std::ceil(pct / 100.0 * static_cast<double>(values.size())));
+    return values[std::clamp<size_t>(rank, 1, values.size()) - 1];
+  };
+
+  double sum = 0.0;
+  for (const float value : values)
+    sum += value;
+
+  std::fprintf(fp,
+               "  \"%s\": {\"mean\": %.4f, \"min\": %.4f, \"p50\": %.4f, \"p90\": %.4f, \"p95\": %.4f, "
+               "\"p99\": %.4f, \"max\": %.4f},\n",
+               name, sum / static_cast<double>(values.size()), values.front(), percentile(50.0), percentile(90.0),
+               percentile(95.0), percentile(99.0), values.back());
+}
+
+bool RegTestHost::WriteBenchmarkReport(double total_time_ms, const CPU::CodeCache::CompileStats& compile_stats)
+{
+  if (s_benchmark_frames.empty())
+  {
+    Log_ErrorPrintf("No frames were run, not writing benchmark report.");
+    return false;
+  }
+
+  auto fp = FileSystem::OpenManagedCFile(s_benchmark_filename.c_str(), "wb");
+  if (!fp)
+  {
+    Log_ErrorPrintf("Failed to open benchmark report '%s'.", s_benchmark_filename.c_str());
+    return false;
+  }
+
+  const auto escape = [](const std::string& str) {
+    std::string ret;
+    for (const char ch : str)
+    {
+      if (ch == '"' || ch == '\\')
+        ret.push_back('\\');
+      if (static_cast<unsigned char>(ch) >= 0x20)
+        ret.push_back(ch);
+    }
+    return ret;
+  };
+
+  const u32 num_frames = static_cast<u32>(s_benchmark_frames.size());
+  std::fprintf(fp.get(), "{\n");
+  std::fprintf(fp.get(), "  \"version\": \"%s\",\n", escape(g_scm_tag_str).c_str());
+  std::fprintf(fp.get(), "  \"serial\": \"%s\",\n", escape(System::GetRunningSerial()).c_str());
+  std::fprintf(fp.get(), "  \"title\": \"%s\",\n", escape(System::GetRunningTitle()).c_str());
+  std::fprintf(fp.get(), "  \"renderer\": \"%s\",\n", Settings::GetRendererName(g_settings.gpu_renderer));
+  std::fprintf(fp.get(), "  \"cpu_execution_mode\": \"%s\",\n",
+               Settings::GetCPUExecutionModeName(g_settings.cpu_execution_mode));
+  std::fprintf(fp.get(), "  \"frames\": %u,\n", num_frames);
+  std::fprintf(fp.get(), "  \"total_time_ms\": %.4f,\n", total_time_ms);
+  std::fprintf(fp.get(), "  \"vps\": %.4f,\n", static_cast<double>(num_frames) * 1000.0 / total_time_ms);
+
+  std::vector<float> values(num_frames);
+  const auto write_stats = [&fp, &values](const char* name, float BenchmarkFrame::*member) {
+    std::transform(s_benchmark_frames.begin(), s_benchmark_frames.end(), values.begin(),
+                   [member](const BenchmarkFrame& bf) { return bf.*member; });
+    WriteBenchmarkStats(fp.get(), name, values);
+  };
+  write_stats("frame_time_ms", &BenchmarkFrame::frame_time);
+  write_stats("cpu_thread_time_ms", &BenchmarkFrame::cpu_thread_time);
+  if (g_gpu->GetSWThread())
+    write_stats("sw_thread_time_ms", &BenchmarkFrame::sw_thread_time);
+  if (g_host_display->IsGPUTimingEnabled())
+    write_stats("gpu_time_ms", &BenchmarkFrame::gpu_time);
+
+  const CPU::CodeCache::EvictionStats eviction_stats = CPU::CodeCache::GetEvictionStats();
+  const double per_instruction =
+    (compile_stats.compiled_instructions > 0) ? (1.0 / static_cast<double>(compile_stats.compiled_instructions)) : 0.0;
+  std::fprintf(fp.get(), "  \"compiled_blocks\": %u,\n", compile_stats.compiled_blocks);
+  std::fprintf(fp.get(), "  \"recompiled_blocks\": %u,\n", compile_stats.recompiled_blocks);
+  std::fprintf(fp.get(), "  \"compiled_instructions\": %" PRIu64 ",\n", compile_stats.compiled_instructions);
+  std::fprintf(fp.get(), "  \"host_bytes_per_instruction\": %.4f,\n",
+               static_cast<double>(compile_stats.host_code_bytes) * per_instruction);
+  std::fprintf(fp.get(), "  \"far_bytes_per_instruction\": %.4f,\n",
+               static_cast<double>(compile_stats.far_code_bytes) * per_instruction);
+  std::fprintf(fp.get(), "  \"region_evictions\": %u,\n", eviction_stats.region_evictions);
+  std::fprintf(fp.get(), "  \"full_flushes\": %u,\n", eviction_stats.full_flushes);
+
+  std::vector<TimingEvents::EventStats> event_stats = TimingEvents::GetEventStats();
+  std::sort(event_stats.begin(), event_stats.end(),
+            [](const TimingEvents::EventStats& lhs, const TimingEvents::EventStats& rhs) {
+              return lhs.stats.callback_time > rhs.stats.callback_time;
+            });
+  std::fprintf(fp.get(), "  \"timing_events\": {");
+  for (size_t i = 0; i < event_stats.size(); i++)
+  {
+    const TimingEvent::Stats& es = event_stats[i].stats;
+    const double average_ticks =
+      (es.invocations > 0) ? (static_cast<double>(es.ticks_executed) / static_cast<double>(es.invocations)) : 0.0;
+    std::fprintf(fp.get(),
+                 "%s\n    \"%s\": {\"invocations\": %" PRIu64 ", \"reschedules\": %" PRIu64
+                 ", \"avg_ticks\": %.2f, \"callback_time_ms\": %.4f}",
+                 (i > 0) ? "," : "", escape(event_stats[i].name).c_str(), es.invocations, es.reschedules,
+                 average_ticks, Common::Timer::ConvertValueToMilliseconds(es.callback_time));
+  }
+  std::fprintf(fp.get(), "\n  },\n");
+  std::fprintf(fp.get(), "  \"compile_time_ms\": %.4f\n", compile_stats.compile_time_ms);
+  std::fprintf(fp.get(), "}\n");
+
+  if (std::ferror(fp.get()))
+  {
+    Log_ErrorPrintf("Failed to write benchmark report '%s'.", s_benchmark_filename.c_str());
+    return false;
+  }
+
+  Log_InfoPrintf("Wrote benchmark report for %u frames to '%s', %.2f VPS.", num_frames, s_benchmark_filename.c_str(),
+                 static_cast<double>(num_frames) * 1000.0 / total_time_ms);
+  return true;
+}
+
+bool RegTestHost::WriteIOAccessCounts()
+{
+  auto fp = FileSystem::OpenManagedCFile(s_io_counts_filename.c_str(), "wb");
+  if (!fp)
+  {
+    Log_ErrorPrintf("Failed to open I/O access counts file '%s'.", s_io_counts_filename.c_str());
+    return false;
+  }
+
+  Bus::WriteIOAccessCounts(fp.get());
+  if (std::ferror(fp.get()))
+  {
+    Log_ErrorPrintf("Failed to write I/O access counts file '%s'.", s_io_counts_filename.c_str());
+    return false;
+  }
+
+  Log_InfoPrintf("Wrote I/O access counts to '%s'.", s_io_counts_filename.c_str());
+  return true;
+}
+
+bool RegTestHost::OpenFrameHashFile()
+{
+  if (!s_frame_hash_reference_filename.empty() && !LoadFrameHashReference())
+    return false;
+
+  s_frame_hash_file = FileSystem::OpenCFile(s_frame_hash_filename.c_str(), "wb");
+  if (!s_frame_hash_file)
+  {
+    Log_ErrorPrintf("Failed to open frame hash file '%s'.", s_frame_hash_filename.c_str());
+    return false;
+  }
+
+  // hashes which aren't enabled are written as zero, so every file has the same layout
+  std::fputs("# frame display vram audio state\n", s_frame_hash_file);
+  if (s_hash_audio)
+    SPU::SetOutputHashingEnabled(true);
+
+  return true;
+}
+
+bool RegTestHost::LoadFrameHashReference()
+{
+  std::optional<std::string> data = FileSystem::ReadFileToString(s_frame_hash_reference_filename.c_str());
+  if (!data.has_value())
+  {
+    Log_ErrorPrintf("Failed to read frame hash reference '%s'.", s_frame_hash_reference_filename.c_str());
+    return false;
+  }
+
+  for (const std::string_view& line : StringUtil::SplitString(data.value(), '\n'))
+  {
+    if (line.empty() || line[0] == '#')
+      continue;
+
+    const std::vector<std::string_view> fields = StringUtil::SplitString(line, ' ');
+    std::optional<u32> frame;
+    std::optional<u64> display, vram, audio, state;
+
+    // files written before state hashing was added have one less column
+    if ((fields.size() != 4 && fields.size() != 5) || !(frame = StringUtil::FromChars<u32>(fields[0])).has_value() ||
+        !(display = StringUtil::FromChars<u64>(fields[1], 16)).has_value() ||
+        !(vram = StringUtil::FromChars<u64>(fields[2], 16)).has_value() ||
+        !(audio = StringUtil::FromChars<u64>(fields[3], 16)).has_value() ||
+        !(state = (fields.size() > 4) ? StringUtil::FromChars<u64>(fields[4], 16) : std::optional<u64>(0)).has_value())
+    {
+      Log_ErrorPrintf("Malformed line in frame hash reference: '%.*s'", static_cast<int>(line.size()), line.data());
+      return false;
+    }
+
+    if (frame.value() >= s_frame_hash_reference.size())
+      s_frame_hash_reference.resize(frame.value() + 1);
+    s_frame_hash_reference[frame.value()] = FrameHashes{display.value(), vram.value(), audio.value(), state.value()};
+  }
+
+  Log_InfoPrintf("Loaded frame hash reference from '%s'.", s_frame_hash_reference_filename.c_str());
+  return true;
+}
+
+void RegTestHost::WriteFrameHashes(u32 frame)
+{
+  FrameHashes hashes = {};
+  if (g_host_display->WriteDisplayTextureToBuffer(&s_frame_hash_pixels))
+    hashes.display = XXH3_64bits(s_frame_hash_pixels.data(), s_frame_hash_pixels.size() * sizeof(u32));
+  if (s_hash_vram)
+    hashes.vram = g_gpu->GetVRAMHash();
+  if (s_hash_audio)
+    hashes.audio = SPU::GetAndResetOutputHash();
+  if (s_hash_state)
+    hashes.state = System::GetStateHash();
+
+  std::fprintf(s_frame_hash_file, "%u %016" PRIx64 " %016" PRIx64 " %016" PRIx64 " %016" PRIx64 "\n", frame,
+               hashes.display, hashes.vram, hashes.audio, hashes.state);
+
+  if (frame >= s_frame_hash_reference.size() || !s_frame_hash_reference[frame].has_value())
+    return;
+
+  // only compare the hashes which were enabled for both runs
+  const FrameHashes& ref = s_frame_hash_reference[frame].value();
+  const bool display_differs = (hashes.display != ref.display);
+  const bool vram_differs = (hashes.vram != 0 && ref.vram != 0 && hashes.vram != ref.vram);
+  const bool audio_differs = (hashes.audio != 0 && ref.audio != 0 && hashes.audio != ref.audio);
+  const bool state_differs = (hashes.state != 0 && ref.state != 0 && hashes.state != ref.state);
+  if (!display_differs && !vram_differs && !audio_differs && !state_differs)
+    return;
+
+  Log_WarningPrintf("Frame %u differs from the reference:%s%s%s%s", frame, display_differs ? " display" : "",
+                    vram_differs ? " vram" : "", audio_differs ? " audio" : "", state_differs ? " state" : "");
+  s_frame_hash_mismatches++;
+
+  // frames on the dump interval have already been written
+  const bool already_dumped = (s_frame_dump_interval > 0 && (frame % s_frame_dump_interval) == 0);
+  if (display_differs && !already_dumped && !s_dump_game_directory.empty())
+    g_host_display->WriteDisplayTextureToFile(GetFrameDumpFilename(frame), true, true, true);
+}
+
+bool RegTestHost::WriteCPUProfile()
+{
+  auto fp = FileSystem::OpenManagedCFile(s_cpu_profile_filename.c_str(), "wb");
+  if (!fp)
+  {
+    Log_ErrorPrintf("Failed to open CPU profile file '%s'.", s_cpu_profile_filename.c_str());
+    return false;
+  }
+
+  CPU::CodeCache::WriteProfile(fp.get());
+  if (std::ferror(fp.get()))
+  {
+    Log_ErrorPrintf("Failed to write CPU profile file '%s'.", s_cpu_profile_filename.c_str());
+    return false;
+  }
+
+  Log_InfoPrintf("Wrote CPU profile to '%s'.", s_cpu_profile_filename.c_str());
+  return true;
+}
+
 int main(int argc, char* argv[])
 {
   RegTestHost::InitializeEarlyConsole();
@@ -549,6 +1017,12 @@ int main(int argc, char* argv[])
   if (!RegTestHost::ParseCommandLineParameters(argc, argv, autoboot))
     return EXIT_FAILURE;
 
+  if (!s_convert_trace_input.empty())
+  {
+    return CPU::ConvertBinaryTrace(s_convert_trace_input.c_str(), s_convert_trace_output.c_str()) ? EXIT_SUCCESS :
+                                                                                                   EXIT_FAILURE;
+  }
+
   if (!autoboot || autoboot->filename.empty())
   {
     Log_ErrorPrintf("No boot path specified.");
@@ -576,18 +1050,108 @@ int main(int argc, char* argv[])
     Log_InfoPrintf("Dumping every %dth frame to '%s'.", s_frame_dump_interval, s_dump_base_directory.c_str());
   }
 
+  if (!s_gpu_timings_filename.empty() && !RegTestHost::OpenGPUTimingsFile())
+    goto cleanup;
+
+  if (!s_frame_hash_filename.empty() && !RegTestHost::OpenFrameHashFile())
+    goto cleanup;
+
+  if (InputMovie::IsReplaying())
+    s_frames_to_run = InputMovie::GetFrameCount();
+
+  if (!s_benchmark_filename.empty())
+  {
+    s_benchmark_frames.reserve(s_frames_to_run);
+    if (!g_host_display->IsGPUTimingEnabled() && !g_host_display->SetGPUTimingEnabled(true))
+      Log_WarningPrintf("GPU timing is not supported by the host display, GPU times will not be reported.");
+
+    TimingEvents::SetCallbackTimingEnabled(true);
+    TimingEvents::ResetEventStats();
+  }
+
   Log_InfoPrintf("Running for %d frames...", s_frames_to_run);
 
-  for (u32 frame = 0; frame < s_frames_to_run; frame++)
   {
-    System::RunFrame();
-    Host::RenderDisplay(false);
-    System::UpdatePerformanceCounters();
+    const Threading::ThreadHandle cpu_thread = Threading::ThreadHandle::GetForCallingThread();
+    const double thread_ticks_to_ms = 1000.0 / static_cast<double>(Threading::GetThreadTicksPerSecond());
+    const CPU::CodeCache::CompileStats start_compile_stats = CPU::CodeCache::GetCompileStats();
+    Common::Timer total_timer;
+
+    for (u32 frame = 0; frame < s_frames_to_run; frame++)
+    {
+      if (s_benchmark_filename.empty())
+      {
+        System::RunFrame();
+        Host::RenderDisplay(false);
+        System::UpdatePerformanceCounters();
+        continue;
+      }
+
+      const Threading::Thread* sw_thread = g_gpu->GetSWThread();
+      const u64 cpu_start = cpu_thread.GetCPUTime();
+      const u64 sw_start = sw_thread ? sw_thread->GetCPUTime() : 0;
+      Common::Timer frame_timer;
+
+      System::RunFrame();
+      Host::RenderDisplay(false);
+
+      BenchmarkFrame& bf = s_benchmark_frames.emplace_back();
+      bf.frame_time = static_cast<float>(frame_timer.GetTimeMilliseconds());
+      bf.cpu_thread_time = static_cast<float>(static_cast<double>(cpu_thread.GetCPUTime() - cpu_start) *
+                                              thread_ticks_to_ms);
+      bf.sw_thread_time =
+        sw_thread ? static_cast<float>(static_cast<double>(sw_thread->GetCPUTime() - sw_start) * thread_ticks_to_ms) :
+                    0.0f;
+      bf.gpu_time = std::exchange(s_frame_gpu_time, 0.0f);
+
+      System::UpdatePerformanceCounters();
+    }
+
+    if (!s_benchmark_filename.empty())
+    {
+      CPU::CodeCache::CompileStats compile_stats = CPU::CodeCache::GetCompileStats();
+      compile_stats.compiled_blocks -= start_compile_stats.compiled_blocks;
+      compile_stats.recompiled_blocks -= start_compile_stats.recompiled_blocks;
+      compile_stats.compile_time_ms -= start_compile_stats.compile_time_ms;
+      compile_stats.compiled_instructions -= start_compile_stats.compiled_instructions;
+      compile_stats.host_code_bytes -= start_compile_stats.host_code_bytes;
+      compile_stats.far_code_bytes -= start_compile_stats.far_code_bytes;
+      if (!RegTestHost::WriteBenchmarkReport(total_timer.GetTimeMilliseconds(), compile_stats))
+        goto cleanup;
+    }
   }
 
+  if (!s_io_counts_filename.empty() && !RegTestHost::WriteIOAccessCounts())
+    goto cleanup;
+
+  if (!s_cpu_profile_filename.empty() && !RegTestHost::WriteCPUProfile())
+    goto cleanup;
+
   Log_InfoPrintf("All done, shutting down system.");
+  if (s_gpu_timings_file)
+  {
+    std::fclose(s_gpu_timings_file);
+    s_gpu_timings_file = nullptr;
+  }
+  if (s_frame_hash_file)
+  {
+    std::fclose(s_frame_hash_file);
+    s_frame_hash_file = nullptr;
+  }
   System::ShutdownSystem(false);
 
+  if (s_frame_hash_mismatches > 0)
+  {
+    Log_ErrorPrintf("%u frames differ from the frame hash reference.", s_frame_hash_mismatches);
+    goto cleanup;
+  }
+
+  if (InputMovie::GetDesyncCount() > 0)
+  {
+    Log_ErrorPrintf("Input movie desynced on %u frames.", InputMovie::GetDesyncCount());
+    goto cleanup;
+  }
+
   Log_InfoPrintf("Exiting with success.");
   result = 0;
 
@@ -34,6 +34,7 @@
 #include <atomic>
 #include <cstdarg>
 #include <cstdlib>
+#include <cstring>
 #include <ctime>
 #include <functional>
 #include <string>
@@ -1997,6 +1998,25 @@ void Achievements::CheevosEventHandler(const rc_runtime_event_t* runtime_event)
 
 unsigned Achievements::PeekMemory(unsigned address, unsigned num_bytes, void* ud)
 {
+  // Nearly every memref is in main RAM, so read it directly rather than going through the bus for each one.
+  // Anything which would cross the end of RAM or the scratchpad takes the slow path.
+  if (num_bytes == 1 || num_bytes == 2 || num_bytes == 4)
+  {
+    const u8* ptr = nullptr;
+    if (address < Bus::RAM_MIRROR_END && ((address & Bus::g_ram_mask) + num_bytes) <= Bus::g_ram_size)
+      ptr = &Bus::g_ram[address & Bus::g_ram_mask];
+    else if ((address & CPU::DCACHE_LOCATION_MASK) == CPU::DCACHE_LOCATION &&
+             ((address & CPU::DCACHE_OFFSET_MASK) + num_bytes) <= CPU::DCACHE_SIZE)
+      ptr = &CPU::g_state.dcache[address & CPU::DCACHE_OFFSET_MASK];
+
+    if (ptr)
+    {
+      u32 value = 0;
+      std::memcpy(&value, ptr, num_bytes);
+      return value;
+    }
+  }
+
   switch (num_bytes)
   {
     case 1:
@@ -10,6 +10,7 @@
 #include "common/log.h"
 #include "common/path.h"
 #include "common/string_util.h"
+#include "core/bus.h"
 #include "core/cdrom.h"
 #include "core/cheats.h"
 #include "core/controller.h"
@@ -27,6 +28,7 @@
 #include "core/spu.h"
 #include "core/system.h"
 #include "core/texture_replacements.h"
+#include "core/timing_event.h"
 #include "core/timers.h"
 #include "fullscreen_ui.h"
 #include "game_list.h"
@@ -123,6 +125,9 @@ void CommonHost::Shutdown()
 #endif
 
   InputManager::CloseSources();
+
+  // write out anything still queued, the output thread can't outlive the host
+  Log::SetAsyncOutput(false);
 }
 
 void CommonHost::PumpMessagesOnCPUThread()
@@ -217,6 +222,7 @@ std::unique_ptr<AudioStream> Host::CreateAudioStream(AudioBackend backend, u32 s
 void CommonHost::UpdateLogSettings()
 {
   Log::SetFilterLevel(g_settings.log_level);
+  Log::SetAsyncOutput(g_settings.log_async_output);
   Log::SetConsoleOutputParams(g_settings.log_to_console,
                               g_settings.log_filter.empty() ? nullptr : g_settings.log_filter.c_str(),
                               g_settings.log_level);
@@ -252,6 +258,7 @@ void CommonHost::OnSystemStarted()
 void CommonHost::OnSystemPaused()
 {
   FullscreenUI::OnSystemPaused();
+  ImGuiManager::NotifyUIActivity();
 
   InputManager::PauseVibration();
 
@@ -387,7 +394,8 @@ void CommonHost::CheckForSettingsChanges(const Settings& old_settings)
   if (g_settings.log_level != old_settings.log_level || g_settings.log_filter != old_settings.log_filter ||
       g_settings.log_to_console != old_settings.log_to_console ||
       g_settings.log_to_debug != old_settings.log_to_debug || g_settings.log_to_window != old_settings.log_to_window ||
-      g_settings.log_to_file != old_settings.log_to_file)
+      g_settings.log_to_file != old_settings.log_to_file ||
+      g_settings.log_async_output != old_settings.log_async_output)
   {
     UpdateLogSettings();
   }
@@ -423,6 +431,14 @@ void Host::SetPadVibrationIntensity(u32 pad_index, float large_or_single_motor_i
   InputManager::SetPadVibrationIntensity(pad_index, large_or_single_motor_intensity, small_motor_intensity);
 }
 
+void Host::ProcessQueuedInputEvents(bool poll_sources)
+{
+  if (poll_sources)
+    InputManager::PollSourcesDeferred();
+
+  InputManager::ProcessQueuedEvents(true);
+}
+
 void Host::DisplayLoadingScreen(const char* message, int progress_min /*= -1*/, int progress_max /*= -1*/,
                                 int progress_value /*= -1*/)
 {
@@ -499,6 +515,14 @@ void ImGuiManager::RenderDebugWindows()
       MDEC::DrawDebugStateWindow();
     if (g_settings.debugging.show_dma_state)
       DMA::DrawDebugStateWindow();
+    if (g_settings.debugging.show_io_access_counts)
+      Bus::DrawIOAccessCountsWindow();
+    if (g_settings.debugging.show_cpu_profile)
+      CPU::CodeCache::DrawProfileWindow();
+    if (g_settings.debugging.show_code_cache_stats)
+      CPU::CodeCache::DrawStatsWindow();
+    if (g_settings.debugging.show_timing_events)
+      TimingEvents::DrawStatsWindow();
   }
 }
 
@@ -731,6 +755,34 @@ DEFINE_HOTKEY("Screenshot", TRANSLATABLE("Hotkeys", "General"), TRANSLATABLE("Ho
                   System::SaveScreenshot();
               })
 
+DEFINE_HOTKEY("ToggleMediaCapture", TRANSLATABLE("Hotkeys", "General"), TRANSLATABLE("Hotkeys", "Toggle Media Capture"),
+              [](s32 pressed) {
+                if (!pressed && System::IsValid())
+                {
+                  if (System::IsCapturingMedia())
+                    System::StopMediaCapture();
+                  else
+                    System::StartMediaCapture();
+                }
+              })
+
+DEFINE_HOTKEY("ToggleGPUDump", TRANSLATABLE("Hotkeys", "General"), TRANSLATABLE("Hotkeys", "Toggle GPU Dump"),
+              [](s32 pressed) {
+                if (!pressed && System::IsValid())
+                {
+                  if (System::IsRecordingGPUDump())
+                    System::StopRecordingGPUDump();
+                  else
+                    System::StartRecordingGPUDump();
+                }
+              })
+
+DEFINE_HOTKEY("SaveFrameTimes", TRANSLATABLE("Hotkeys", "General"), TRANSLATABLE("Hotkeys", "Save Frame Times"),
+              [](s32 pressed) {
+                if (!pressed && System::IsValid())
+                  System::SaveFrameTimeHistograms();
+              })
+
 #if !defined(__ANDROID__) && defined(WITH_CHEEVOS)
 DEFINE_HOTKEY("OpenAchievements", TRANSLATABLE("Hotkeys", "General"), TRANSLATABLE("Hotkeys", "Open Achievement List"),
               [](s32 pressed) {
@@ -198,6 +198,22 @@ bool D3D11HostDisplay::GetHostRefreshRate(float* refresh_rate)
 void D3D11HostDisplay::SetVSync(bool enabled)
 {
   m_vsync_enabled = enabled;
+
+  // only the buffer count depends on triple buffering, so we can get away with resizing
+  if (m_triple_buffering != g_settings.display_triple_buffering)
+  {
+    m_triple_buffering = g_settings.display_triple_buffering;
+    ResizeWindow(0, 0);
+  }
+}
+
+void D3D11HostDisplay::WaitForSwapChain()
+{
+  if (!m_swap_chain_waitable || !m_swap_chain_wait_pending)
+    return;
+
+  m_swap_chain_wait_pending = false;
+  WaitForSingleObjectEx(m_swap_chain_waitable, 1000, TRUE);
 }
 
 bool D3D11HostDisplay::CreateDevice(const WindowInfo& wi, bool vsync)
@@ -310,6 +326,7 @@ bool D3D11HostDisplay::CreateDevice(const WindowInfo& wi, bool vsync)
 
   m_window_info = wi;
   m_vsync_enabled = vsync;
+  m_triple_buffering = g_settings.display_triple_buffering;
 
   if (m_window_info.type != WindowInfo::Type::Surfaceless && !CreateSwapChain(nullptr))
   {
@@ -358,7 +375,7 @@ bool D3D11HostDisplay::CreateSwapChain(const DXGI_MODE_DESC* fullscreen_mode)
   swap_chain_desc.BufferDesc.Height = height;
   swap_chain_desc.BufferDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
   swap_chain_desc.SampleDesc.Count = 1;
-  swap_chain_desc.BufferCount = 2;
+  swap_chain_desc.BufferCount = m_triple_buffering ? 3 : 2;
   swap_chain_desc.BufferUsage = DXGI_USAGE_RENDER_TARGET_OUTPUT;
   swap_chain_desc.OutputWindow = window_hwnd;
   swap_chain_desc.Windowed = TRUE;
@@ -375,6 +392,10 @@ bool D3D11HostDisplay::CreateSwapChain(const DXGI_MODE_DESC* fullscreen_mode)
     swap_chain_desc.BufferDesc = *fullscreen_mode;
   }
 
+  // With the waitable object, Present() no longer blocks, and WaitForSwapChain() does instead.
+  if (m_using_flip_model_swap_chain)
+    swap_chain_desc.Flags |= DXGI_SWAP_CHAIN_FLAG_FRAME_LATENCY_WAITABLE_OBJECT;
+
   Log_InfoPrintf("Creating a %dx%d %s %s swap chain", swap_chain_desc.BufferDesc.Width,
                  swap_chain_desc.BufferDesc.Height, m_using_flip_model_swap_chain ? "flip-discard" : "discard",
                  swap_chain_desc.Windowed ? "windowed" : "full-screen");
@@ -396,6 +417,18 @@ bool D3D11HostDisplay::CreateSwapChain(const DXGI_MODE_DESC* fullscreen_mode)
     }
   }
 
+  m_swap_chain_flags = swap_chain_desc.Flags;
+  if (m_swap_chain_flags & DXGI_SWAP_CHAIN_FLAG_FRAME_LATENCY_WAITABLE_OBJECT)
+  {
+    ComPtr<IDXGISwapChain2> swap_chain2;
+    if (SUCCEEDED(m_swap_chain.As(&swap_chain2)))
+    {
+      swap_chain2->SetMaximumFrameLatency(1);
+      m_swap_chain_waitable = swap_chain2->GetFrameLatencyWaitableObject();
+      m_swap_chain_wait_pending = true;
+    }
+  }
+
   ComPtr<IDXGIFactory> dxgi_factory;
   hr = m_swap_chain->GetParent(IID_PPV_ARGS(dxgi_factory.GetAddressOf()));
   if (SUCCEEDED(hr))
@@ -467,6 +500,18 @@ void D3D11HostDisplay::DestroySurface()
   if (IsFullscreen())
     SetFullscreen(false, 0, 0, 0.0f);
 
+  DestroySwapChain();
+}
+
+void D3D11HostDisplay::DestroySwapChain()
+{
+  if (m_swap_chain_waitable)
+  {
+    CloseHandle(m_swap_chain_waitable);
+    m_swap_chain_waitable = NULL;
+    m_swap_chain_wait_pending = false;
+  }
+
   m_swap_chain_rtv.Reset();
   m_swap_chain.Reset();
 }
@@ -478,8 +523,8 @@ void D3D11HostDisplay::ResizeWindow(s32 new_window_width, s32 new_window_height)
 
   m_swap_chain_rtv.Reset();
 
-  HRESULT hr = m_swap_chain->ResizeBuffers(0, 0, 0, DXGI_FORMAT_UNKNOWN,
-                                           m_using_allow_tearing ? DXGI_SWAP_CHAIN_FLAG_ALLOW_TEARING : 0);
+  HRESULT hr =
+    m_swap_chain->ResizeBuffers(m_triple_buffering ? 3 : 2, 0, 0, DXGI_FORMAT_UNKNOWN, m_swap_chain_flags);
   if (FAILED(hr))
     Log_ErrorPrintf("ResizeBuffers() failed: 0x%08X", hr);
 
@@ -545,8 +590,7 @@ bool D3D11HostDisplay::SetFullscreen(bool fullscreen, u32 width, u32 height, flo
     return true;
   }
 
-  m_swap_chain_rtv.Reset();
-  m_swap_chain.Reset();
+  DestroySwapChain();
 
   if (!CreateSwapChain(&closest_mode))
   {
@@ -636,8 +680,9 @@ void D3D11HostDisplay::DestroyResources()
   HostDisplay::DestroyResources();
 
   m_post_processing_chain.ClearStages();
-  m_post_processing_input_texture.Destroy();
-  m_post_processing_stages.clear();
+  for (D3D11::Texture& texture : m_post_processing_textures)
+    texture.Destroy();
+  m_post_processing_passes.clear();
 
   m_display_uniform_buffer.Release();
   m_border_sampler.Reset();
@@ -677,6 +722,9 @@ bool D3D11HostDisplay::Render(bool skip_present)
     return false;
   }
 
+  // no-op if System already waited before starting the frame
+  WaitForSwapChain();
+
   // When using vsync, the time here seems to include the time for the buffer to become available.
   // This blows our our GPU usage number considerably, so read the timestamp before the final blit
   // in this configuration. It does reduce accuracy a little, but better than seeing 100% all of
@@ -686,6 +734,7 @@ bool D3D11HostDisplay::Render(bool skip_present)
 
   RenderDisplay();
 
+  SetGPUTimingScope(GPUTimingScope::Overlays);
   if (ImGui::GetCurrentContext())
     RenderImGui();
 
@@ -694,11 +743,14 @@ bool D3D11HostDisplay::Render(bool skip_present)
   if (!m_vsync_enabled && m_gpu_timing_enabled)
     PopTimestampQuery();
 
-  if (!m_vsync_enabled && m_using_allow_tearing)
+  // triple buffering shows the newest frame at the next refresh instead of tearing
+  if (!m_vsync_enabled && m_using_allow_tearing && !m_triple_buffering)
     m_swap_chain->Present(0, DXGI_PRESENT_ALLOW_TEARING);
   else
     m_swap_chain->Present(BoolToUInt32(m_vsync_enabled), 0);
+  m_swap_chain_wait_pending = true;
 
+  SetGPUTimingScope(GPUTimingScope::Other);
   if (m_gpu_timing_enabled)
     KickTimestampQuery();
 
@@ -750,11 +802,18 @@ bool D3D11HostDisplay::RenderScreenshot(u32 width, u32 height, const Common::Rec
 void D3D11HostDisplay::RenderImGui()
 {
   ImGui::Render();
-  ImGui_ImplDX11_RenderDrawData(ImGui::GetDrawData());
+
+  // nothing on screen most of the time while playing, so skip setting up the pipeline state
+  ImDrawData* draw_data = ImGui::GetDrawData();
+  if (draw_data->TotalVtxCount == 0)
+    return;
+
+  ImGui_ImplDX11_RenderDrawData(draw_data);
 }
 
 void D3D11HostDisplay::RenderDisplay()
 {
+  SetGPUTimingScope(GPUTimingScope::Display);
   const auto [left, top, width, height] = CalculateDrawRect(GetWindowWidth(), GetWindowHeight());
 
   if (HasDisplayTexture() && !m_post_processing_chain.IsEmpty())
@@ -930,83 +989,106 @@ bool D3D11HostDisplay::SetPostProcessingChain(const std::string_view& config)
 {
   if (config.empty())
   {
-    m_post_processing_input_texture.Destroy();
-    m_post_processing_stages.clear();
+    for (D3D11::Texture& texture : m_post_processing_textures)
+      texture.Destroy();
+    m_post_processing_passes.clear();
     m_post_processing_chain.ClearStages();
+    SetPostProcessingGPUTimingScopeNames({});
     return true;
   }
 
   if (!m_post_processing_chain.CreateFromString(config))
     return false;
 
-  m_post_processing_stages.clear();
-
-  D3D11::ShaderCache shader_cache;
-  shader_cache.Open(EmuFolders::Cache, m_device->GetFeatureLevel(), SHADER_CACHE_VERSION,
-                    g_settings.gpu_use_debug_device);
-
-  FrontendCommon::PostProcessingShaderGen shadergen(RenderAPI::D3D11, true);
-  u32 max_ubo_size = 0;
-
-  for (u32 i = 0; i < m_post_processing_chain.GetStageCount(); i++)
+  m_post_processing_chain.SetFusionEnabled(g_settings.display_post_process_fusion);
+  if (!CompilePostProcessingPasses())
   {
-    const FrontendCommon::PostProcessingShader& shader = m_post_processing_chain.GetShaderStage(i);
-    const std::string vs = shadergen.GeneratePostProcessingVertexShader(shader);
-    const std::string ps = shadergen.GeneratePostProcessingFragmentShader(shader);
-
-    PostProcessingStage stage;
-    stage.uniforms_size = shader.GetUniformsSize();
-    stage.vertex_shader = shader_cache.GetVertexShader(m_device.Get(), vs);
-    stage.pixel_shader = shader_cache.GetPixelShader(m_device.Get(), ps);
-    if (!stage.vertex_shader || !stage.pixel_shader)
+    if (!m_post_processing_chain.HasFusedPasses())
     {
-      Log_ErrorPrintf("Failed to compile one or more post-processing shaders, disabling.");
-      m_post_processing_stages.clear();
       m_post_processing_chain.ClearStages();
       return false;
     }
 
-    max_ubo_size = std::max(max_ubo_size, stage.uniforms_size);
-    m_post_processing_stages.push_back(std::move(stage));
+    Log_WarningPrintf("Failed to compile fused post-processing passes, retrying with one pass per shader.");
+    m_post_processing_chain.SetFusionEnabled(false);
+    if (!CompilePostProcessingPasses())
+    {
+      m_post_processing_chain.ClearStages();
+      return false;
+    }
   }
 
+  u32 max_ubo_size = 0;
+  for (const PostProcessingPass& pass : m_post_processing_passes)
+    max_ubo_size = std::max(max_ubo_size, pass.uniforms_size);
+
   if (m_display_uniform_buffer.GetSize() < max_ubo_size &&
       !m_display_uniform_buffer.Create(m_device.Get(), D3D11_BIND_CONSTANT_BUFFER, max_ubo_size))
   {
     Log_ErrorPrintf("Failed to allocate %u byte constant buffer for postprocessing", max_ubo_size);
-    m_post_processing_stages.clear();
+    m_post_processing_passes.clear();
     m_post_processing_chain.ClearStages();
     return false;
   }
 
   m_post_processing_timer.Reset();
+  SetPostProcessingGPUTimingScopeNames(m_post_processing_chain.GetPassNames());
   return true;
 }
 
-bool D3D11HostDisplay::CheckPostProcessingRenderTargets(u32 target_width, u32 target_height)
+bool D3D11HostDisplay::CompilePostProcessingPasses()
 {
-  DebugAssert(!m_post_processing_stages.empty());
+  m_post_processing_passes.clear();
 
-  const GPUTexture::Format format = GPUTexture::Format::RGBA8;
-  const u32 bind_flags = D3D11_BIND_RENDER_TARGET | D3D11_BIND_SHADER_RESOURCE;
+  D3D11::ShaderCache shader_cache;
+  shader_cache.Open(EmuFolders::Cache, m_device->GetFeatureLevel(), SHADER_CACHE_VERSION,
+                    g_settings.gpu_use_debug_device);
 
-  if (m_post_processing_input_texture.GetWidth() != target_width ||
-      m_post_processing_input_texture.GetHeight() != target_height)
+  FrontendCommon::PostProcessingShaderGen shadergen(RenderAPI::D3D11, true);
+
+  for (u32 i = 0; i < m_post_processing_chain.GetPassCount(); i++)
   {
-    if (!m_post_processing_input_texture.Create(m_device.Get(), target_width, target_height, 1, 1, 1, format,
-                                                bind_flags))
+    const std::string vs = shadergen.GeneratePostProcessingVertexShader(m_post_processing_chain, i);
+    const std::string ps = shadergen.GeneratePostProcessingFragmentShader(m_post_processing_chain, i);
+
+    PostProcessingPass pass;
+    pass.uniforms_size = m_post_processing_chain.GetPassUniformsSize(i);
+    pass.vertex_shader = shader_cache.GetVertexShader(m_device.Get(), vs);
+    pass.pixel_shader = shader_cache.GetPixelShader(m_device.Get(), ps);
+    if (!pass.vertex_shader || !pass.pixel_shader)
     {
+      Log_ErrorPrintf("Failed to compile one or more post-processing shaders.");
+      m_post_processing_passes.clear();
       return false;
     }
+
+    m_post_processing_passes.push_back(std::move(pass));
   }
 
-  const u32 target_count = (static_cast<u32>(m_post_processing_stages.size()) - 1);
-  for (u32 i = 0; i < target_count; i++)
+  return true;
+}
+
+bool D3D11HostDisplay::CheckPostProcessingRenderTargets(u32 target_width, u32 target_height)
+{
+  DebugAssert(!m_post_processing_passes.empty());
+
+  const GPUTexture::Format format = GPUTexture::Format::RGBA8;
+  const u32 bind_flags = D3D11_BIND_RENDER_TARGET | D3D11_BIND_SHADER_RESOURCE;
+
+  // a single pass goes straight from the display copy to the final target
+  const u32 target_count = (m_post_processing_passes.size() > 1) ? 2u : 1u;
+  for (u32 i = 0; i < static_cast<u32>(m_post_processing_textures.size()); i++)
   {
-    PostProcessingStage& pps = m_post_processing_stages[i];
-    if (pps.output_texture.GetWidth() != target_width || pps.output_texture.GetHeight() != target_height)
+    D3D11::Texture& texture = m_post_processing_textures[i];
+    if (i >= target_count)
     {
-      if (!pps.output_texture.Create(m_device.Get(), target_width, target_height, 1, 1, 1, format, bind_flags))
+      texture.Destroy();
+      continue;
+    }
+
+    if (texture.GetWidth() != target_width || texture.GetHeight() != target_height)
+    {
+      if (!texture.Create(m_device.Get(), target_width, target_height, 1, 1, 1, format, bind_flags))
         return false;
     }
   }
@@ -1027,50 +1109,56 @@ void D3D11HostDisplay::ApplyPostProcessingChain(ID3D11RenderTargetView* final_ta
   }
 
   // downsample/upsample - use same viewport for remainder
-  m_context->ClearRenderTargetView(m_post_processing_input_texture.GetD3DRTV(), s_clear_color.data());
-  m_context->OMSetRenderTargets(1, m_post_processing_input_texture.GetD3DRTVArray(), nullptr);
+  D3D11::Texture& input_texture = m_post_processing_textures[0];
+  m_context->ClearRenderTargetView(input_texture.GetD3DRTV(), s_clear_color.data());
+  m_context->OMSetRenderTargets(1, input_texture.GetD3DRTVArray(), nullptr);
   RenderDisplay(final_left, final_top, final_width, final_height, texture, texture_view_x, texture_view_y,
                 texture_view_width, texture_view_height, IsUsingLinearFiltering());
 
   const s32 orig_texture_width = texture_view_width;
   const s32 orig_texture_height = texture_view_height;
-  texture = &m_post_processing_input_texture;
+  texture = &input_texture;
   texture_view_x = final_left;
   texture_view_y = final_top;
   texture_view_width = final_width;
   texture_view_height = final_height;
 
-  const u32 final_stage = static_cast<u32>(m_post_processing_stages.size()) - 1u;
-  for (u32 i = 0; i < static_cast<u32>(m_post_processing_stages.size()); i++)
+  ID3D11ShaderResourceView* null_srv = nullptr;
+  const u32 final_pass = static_cast<u32>(m_post_processing_passes.size()) - 1u;
+  for (u32 i = 0; i < static_cast<u32>(m_post_processing_passes.size()); i++)
   {
-    PostProcessingStage& pps = m_post_processing_stages[i];
-    ID3D11RenderTargetView* rtv = (i == final_stage) ? final_target : pps.output_texture.GetD3DRTV();
+    PostProcessingPass& ppp = m_post_processing_passes[i];
+    SetPostProcessingGPUTimingScope(i);
+
+    // pass N reads target N % 2, and writes to the other one, which may still be bound from the previous pass
+    D3D11::Texture& output_texture = m_post_processing_textures[(i + 1) & 1u];
+    ID3D11RenderTargetView* rtv = (i == final_pass) ? final_target : output_texture.GetD3DRTV();
+    m_context->PSSetShaderResources(0, 1, &null_srv);
     m_context->ClearRenderTargetView(rtv, s_clear_color.data());
     m_context->OMSetRenderTargets(1, &rtv, nullptr);
 
     m_context->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
-    m_context->VSSetShader(pps.vertex_shader.Get(), nullptr, 0);
-    m_context->PSSetShader(pps.pixel_shader.Get(), nullptr, 0);
+    m_context->VSSetShader(ppp.vertex_shader.Get(), nullptr, 0);
+    m_context->PSSetShader(ppp.pixel_shader.Get(), nullptr, 0);
     m_context->PSSetShaderResources(0, 1, texture->GetD3DSRVArray());
     m_context->PSSetSamplers(0, 1, m_border_sampler.GetAddressOf());
 
     const auto map =
-      m_display_uniform_buffer.Map(m_context.Get(), m_display_uniform_buffer.GetSize(), pps.uniforms_size);
-    m_post_processing_chain.GetShaderStage(i).FillUniformBuffer(
-      map.pointer, texture->GetWidth(), texture->GetHeight(), texture_view_x, texture_view_y, texture_view_width,
+      m_display_uniform_buffer.Map(m_context.Get(), m_display_uniform_buffer.GetSize(), ppp.uniforms_size);
+    m_post_processing_chain.FillPassUniformBuffer(
+      i, map.pointer, texture->GetWidth(), texture->GetHeight(), texture_view_x, texture_view_y, texture_view_width,
       texture_view_height, GetWindowWidth(), GetWindowHeight(), orig_texture_width, orig_texture_height,
       static_cast<float>(m_post_processing_timer.GetTimeSeconds()));
-    m_display_uniform_buffer.Unmap(m_context.Get(), pps.uniforms_size);
+    m_display_uniform_buffer.Unmap(m_context.Get(), ppp.uniforms_size);
     m_context->VSSetConstantBuffers(0, 1, m_display_uniform_buffer.GetD3DBufferArray());
     m_context->PSSetConstantBuffers(0, 1, m_display_uniform_buffer.GetD3DBufferArray());
 
     m_context->Draw(3, 0);
 
-    if (i != final_stage)
-      texture = &pps.output_texture;
+    if (i != final_pass)
+      texture = &output_texture;
   }
 
-  ID3D11ShaderResourceView* null_srv = nullptr;
   m_context->PSSetShaderResources(0, 1, &null_srv);
 }
 
@@ -1088,6 +1176,18 @@ bool D3D11HostDisplay::CreateTimestampQueries()
         return false;
       }
     }
+
+    for (ComPtr<ID3D11Query>& query : m_scope_timestamp_queries[i].queries)
+    {
+      const CD3D11_QUERY_DESC qdesc(D3D11_QUERY_TIMESTAMP);
+      const HRESULT hr = m_device->CreateQuery(&qdesc, query.ReleaseAndGetAddressOf());
+      if (FAILED(hr))
+      {
+        m_timestamp_queries = {};
+        m_scope_timestamp_queries = {};
+        return false;
+      }
+    }
   }
 
   KickTimestampQuery();
@@ -1103,6 +1203,7 @@ void D3D11HostDisplay::DestroyTimestampQueries()
     m_context->End(m_timestamp_queries[m_write_timestamp_query][1].Get());
 
   m_timestamp_queries = {};
+  m_scope_timestamp_queries = {};
   m_read_timestamp_query = 0;
   m_write_timestamp_query = 0;
   m_waiting_timestamp_queries = 0;
@@ -1136,9 +1237,34 @@ void D3D11HostDisplay::PopTimestampQuery()
                                                 D3D11_ASYNC_GETDATA_DONOTFLUSH);
       if (start_hr == S_OK && end_hr == S_OK)
       {
-        const float delta =
-          static_cast<float>(static_cast<double>(end - start) / (static_cast<double>(disjoint.Frequency) / 1000.0));
+        const double ticks_per_ms = static_cast<double>(disjoint.Frequency) / 1000.0;
+        const float delta = static_cast<float>(static_cast<double>(end - start) / ticks_per_ms);
         m_accumulated_gpu_time += delta;
+
+        // queries complete in order, so the scope switches before the end timestamp are also available.
+        const ScopeTimestampQueries& sq = m_scope_timestamp_queries[m_read_timestamp_query];
+        u64 scope_start = start;
+        u32 scope = sq.first_scope;
+        for (u32 i = 0; i <= sq.num_queries; i++)
+        {
+          u64 scope_end = end;
+          if (i < sq.num_queries && m_context->GetData(sq.queries[i].Get(), &scope_end, sizeof(scope_end),
+                                                       D3D11_ASYNC_GETDATA_DONOTFLUSH) != S_OK)
+          {
+            scope_end = scope_start;
+          }
+
+          if (scope_end > scope_start)
+          {
+            m_accumulated_scope_times[scope] +=
+              static_cast<float>(static_cast<double>(scope_end - scope_start) / ticks_per_ms);
+            scope_start = scope_end;
+          }
+
+          if (i < sq.num_queries)
+            scope = sq.scope_ids[i];
+        }
+
         m_read_timestamp_query = (m_read_timestamp_query + 1) % NUM_TIMESTAMP_QUERIES;
         m_waiting_timestamp_queries--;
       }
@@ -1162,9 +1288,22 @@ void D3D11HostDisplay::KickTimestampQuery()
 
   m_context->Begin(m_timestamp_queries[m_write_timestamp_query][0].Get());
   m_context->End(m_timestamp_queries[m_write_timestamp_query][1].Get());
+  m_scope_timestamp_queries[m_write_timestamp_query].first_scope = static_cast<u8>(m_gpu_timing_scope);
+  m_scope_timestamp_queries[m_write_timestamp_query].num_queries = 0;
   m_timestamp_query_started = true;
 }
 
+void D3D11HostDisplay::OnGPUTimingScopeChanged(u32 scope)
+{
+  ScopeTimestampQueries& sq = m_scope_timestamp_queries[m_write_timestamp_query];
+  if (!m_timestamp_query_started || sq.num_queries == MAX_SCOPE_TIMESTAMP_QUERIES)
+    return;
+
+  sq.scope_ids[sq.num_queries] = static_cast<u8>(scope);
+  m_context->End(sq.queries[sq.num_queries].Get());
+  sq.num_queries++;
+}
+
 bool D3D11HostDisplay::SetGPUTimingEnabled(bool enabled)
 {
   if (m_gpu_timing_enabled == enabled)
@@ -1192,3 +1331,10 @@ float D3D11HostDisplay::GetAndResetAccumulatedGPUTime()
   m_accumulated_gpu_time = 0.0f;
   return value;
 }
+
+HostDisplay::GPUTimingScopeTimes D3D11HostDisplay::GetAndResetAccumulatedGPUTimingScopeTimes()
+{
+  const GPUTimingScopeTimes value = m_accumulated_scope_times;
+  m_accumulated_scope_times = {};
+  return value;
+}
@@ -10,7 +10,7 @@
 #include "core/host_display.h"
 #include "frontend-common/postprocessing_chain.h"
 #include <d3d11.h>
-#include <dxgi.h>
+#include <dxgi1_3.h>
 #include <memory>
 #include <string>
 #include <string_view>
@@ -63,8 +63,10 @@ public:
 
   bool SetGPUTimingEnabled(bool enabled) override;
   float GetAndResetAccumulatedGPUTime() override;
+  GPUTimingScopeTimes GetAndResetAccumulatedGPUTimingScopeTimes() override;
 
   void SetVSync(bool enabled) override;
+  void WaitForSwapChain() override;
 
   bool Render(bool skip_present) override;
   bool RenderScreenshot(u32 width, u32 height, const Common::Rectangle<s32>& draw_rect, std::vector<u32>* out_pixels,
@@ -75,6 +77,7 @@ public:
 protected:
   static constexpr u32 DISPLAY_UNIFORM_BUFFER_SIZE = 16;
   static constexpr u8 NUM_TIMESTAMP_QUERIES = 3;
+  static constexpr u32 MAX_SCOPE_TIMESTAMP_QUERIES = 64;
 
   static AdapterAndModeList GetAdapterAndModeList(IDXGIFactory* dxgi_factory);
 
@@ -90,6 +93,7 @@ protected:
 
   bool CreateSwapChain(const DXGI_MODE_DESC* fullscreen_mode);
   bool CreateSwapChainRTV();
+  void DestroySwapChain();
 
   void RenderDisplay();
   void RenderSoftwareCursor();
@@ -99,29 +103,42 @@ protected:
                      s32 texture_view_y, s32 texture_view_width, s32 texture_view_height, bool linear_filter);
   void RenderSoftwareCursor(s32 left, s32 top, s32 width, s32 height, GPUTexture* texture_handle);
 
-  struct PostProcessingStage
+  struct PostProcessingPass
   {
     ComPtr<ID3D11VertexShader> vertex_shader;
     ComPtr<ID3D11PixelShader> pixel_shader;
-    D3D11::Texture output_texture;
     u32 uniforms_size;
   };
 
+  bool CompilePostProcessingPasses();
   bool CheckPostProcessingRenderTargets(u32 target_width, u32 target_height);
   void ApplyPostProcessingChain(ID3D11RenderTargetView* final_target, s32 final_left, s32 final_top, s32 final_width,
                                 s32 final_height, D3D11::Texture* texture, s32 texture_view_x, s32 texture_view_y,
                                 s32 texture_view_width, s32 texture_view_height, u32 target_width, u32 target_height);
 
+  struct ScopeTimestampQueries
+  {
+    std::array<ComPtr<ID3D11Query>, MAX_SCOPE_TIMESTAMP_QUERIES> queries;
+    std::array<u8, MAX_SCOPE_TIMESTAMP_QUERIES> scope_ids;
+    u32 num_queries = 0;
+    u8 first_scope = 0;
+  };
+
   bool CreateTimestampQueries();
   void DestroyTimestampQueries();
   void PopTimestampQuery();
   void KickTimestampQuery();
+  void OnGPUTimingScopeChanged(u32 scope) override;
 
   ComPtr<ID3D11Device> m_device;
   ComPtr<ID3D11DeviceContext> m_context;
 
   ComPtr<IDXGIFactory> m_dxgi_factory;
   ComPtr<IDXGISwapChain> m_swap_chain;
+  HANDLE m_swap_chain_waitable = NULL;
+  UINT m_swap_chain_flags = 0;
+  bool m_swap_chain_wait_pending = false;
+  bool m_triple_buffering = false;
   ComPtr<ID3D11RenderTargetView> m_swap_chain_rtv;
 
   ComPtr<ID3D11RasterizerState> m_display_rasterizer_state;
@@ -146,8 +163,10 @@ protected:
   bool m_using_allow_tearing = false;
 
   FrontendCommon::PostProcessingChain m_post_processing_chain;
-  D3D11::Texture m_post_processing_input_texture;
-  std::vector<PostProcessingStage> m_post_processing_stages;
+
+  // Passes alternate between two targets of the same size, [0] receives the display and is the first pass's input.
+  std::array<D3D11::Texture, 2> m_post_processing_textures;
+  std::vector<PostProcessingPass> m_post_processing_passes;
   Common::Timer m_post_processing_timer;
 
   std::array<std::array<ComPtr<ID3D11Query>, 3>, NUM_TIMESTAMP_QUERIES> m_timestamp_queries = {};
@@ -156,4 +175,7 @@ protected:
   u8 m_waiting_timestamp_queries = 0;
   bool m_timestamp_query_started = false;
   float m_accumulated_gpu_time = 0.0f;
+
+  std::array<ScopeTimestampQueries, NUM_TIMESTAMP_QUERIES> m_scope_timestamp_queries;
+  GPUTimingScopeTimes m_accumulated_scope_times = {};
 };
@@ -144,6 +144,22 @@ bool D3D12HostDisplay::GetHostRefreshRate(float* refresh_rate)
 void D3D12HostDisplay::SetVSync(bool enabled)
 {
   m_vsync_enabled = enabled;
+
+  // only the buffer count depends on triple buffering, so we can get away with resizing
+  if (m_triple_buffering != g_settings.display_triple_buffering)
+  {
+    m_triple_buffering = g_settings.display_triple_buffering;
+    ResizeWindow(0, 0);
+  }
+}
+
+void D3D12HostDisplay::WaitForSwapChain()
+{
+  if (!m_swap_chain_waitable || !m_swap_chain_wait_pending)
+    return;
+
+  m_swap_chain_wait_pending = false;
+  WaitForSingleObjectEx(m_swap_chain_waitable, 1000, TRUE);
 }
 
 bool D3D12HostDisplay::CreateDevice(const WindowInfo& wi, bool vsync)
@@ -203,6 +219,7 @@ bool D3D12HostDisplay::CreateDevice(const WindowInfo& wi, bool vsync)
 
   m_window_info = wi;
   m_vsync_enabled = vsync;
+  m_triple_buffering = g_settings.display_triple_buffering;
 
   if (m_window_info.type != WindowInfo::Type::Surfaceless && !CreateSwapChain(nullptr))
   {
@@ -249,7 +266,7 @@ bool D3D12HostDisplay::CreateSwapChain(const DXGI_MODE_DESC* fullscreen_mode)
   swap_chain_desc.BufferDesc.Height = height;
   swap_chain_desc.BufferDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
   swap_chain_desc.SampleDesc.Count = 1;
-  swap_chain_desc.BufferCount = 2;
+  swap_chain_desc.BufferCount = m_triple_buffering ? 3 : 2;
   swap_chain_desc.BufferUsage = DXGI_USAGE_RENDER_TARGET_OUTPUT;
   swap_chain_desc.OutputWindow = window_hwnd;
   swap_chain_desc.Windowed = TRUE;
@@ -266,6 +283,9 @@ bool D3D12HostDisplay::CreateSwapChain(const DXGI_MODE_DESC* fullscreen_mode)
     swap_chain_desc.BufferDesc = *fullscreen_mode;
   }
 
+  // With the waitable object, Present() no longer blocks, and WaitForSwapChain() does instead.
+  swap_chain_desc.Flags |= DXGI_SWAP_CHAIN_FLAG_FRAME_LATENCY_WAITABLE_OBJECT;
+
   Log_InfoPrintf("Creating a %dx%d %s swap chain", swap_chain_desc.BufferDesc.Width, swap_chain_desc.BufferDesc.Height,
                  swap_chain_desc.Windowed ? "windowed" : "full-screen");
 
@@ -277,6 +297,15 @@ bool D3D12HostDisplay::CreateSwapChain(const DXGI_MODE_DESC* fullscreen_mode)
     return false;
   }
 
+  m_swap_chain_flags = swap_chain_desc.Flags;
+  ComPtr<IDXGISwapChain2> swap_chain2;
+  if (SUCCEEDED(m_swap_chain.As(&swap_chain2)))
+  {
+    swap_chain2->SetMaximumFrameLatency(1);
+    m_swap_chain_waitable = swap_chain2->GetFrameLatencyWaitableObject();
+    m_swap_chain_wait_pending = true;
+  }
+
   hr = m_dxgi_factory->MakeWindowAssociation(swap_chain_desc.OutputWindow, DXGI_MWA_NO_WINDOW_CHANGES);
   if (FAILED(hr))
     Log_WarningPrintf("MakeWindowAssociation() to disable ALT+ENTER failed");
@@ -361,6 +390,18 @@ void D3D12HostDisplay::DestroySurface()
   if (IsFullscreen())
     SetFullscreen(false, 0, 0, 0.0f);
 
+  DestroySwapChain();
+}
+
+void D3D12HostDisplay::DestroySwapChain()
+{
+  if (m_swap_chain_waitable)
+  {
+    CloseHandle(m_swap_chain_waitable);
+    m_swap_chain_waitable = NULL;
+    m_swap_chain_wait_pending = false;
+  }
+
   DestroySwapChainRTVs();
   m_swap_chain.Reset();
 }
@@ -375,8 +416,8 @@ void D3D12HostDisplay::ResizeWindow(s32 new_window_width, s32 new_window_height)
 
   DestroySwapChainRTVs();
 
-  HRESULT hr = m_swap_chain->ResizeBuffers(0, 0, 0, DXGI_FORMAT_UNKNOWN,
-                                           m_using_allow_tearing ? DXGI_SWAP_CHAIN_FLAG_ALLOW_TEARING : 0);
+  HRESULT hr =
+    m_swap_chain->ResizeBuffers(m_triple_buffering ? 3 : 2, 0, 0, DXGI_FORMAT_UNKNOWN, m_swap_chain_flags);
   if (FAILED(hr))
     Log_ErrorPrintf("ResizeBuffers() failed: 0x%08X", hr);
 
@@ -443,8 +484,7 @@ bool D3D12HostDisplay::SetFullscreen(bool fullscreen, u32 width, u32 height, flo
   }
 
   g_d3d12_context->ExecuteCommandList(true);
-  DestroySwapChainRTVs();
-  m_swap_chain.Reset();
+  DestroySwapChain();
 
   if (!CreateSwapChain(&closest_mode))
   {
@@ -549,8 +589,9 @@ void D3D12HostDisplay::DestroyResources()
 
   m_post_processing_cbuffer.Destroy(false);
   m_post_processing_chain.ClearStages();
-  m_post_processing_input_texture.Destroy();
-  m_post_processing_stages.clear();
+  for (D3D12::Texture& texture : m_post_processing_textures)
+    texture.Destroy();
+  m_post_processing_passes.clear();
   m_post_processing_cb_root_signature.Reset();
   m_post_processing_root_signature.Reset();
 
@@ -593,12 +634,16 @@ bool D3D12HostDisplay::Render(bool skip_present)
     return false;
   }
 
+  // no-op if System already waited before starting the frame
+  WaitForSwapChain();
+
   D3D12::Texture& swap_chain_buf = m_swap_chain_buffers[m_current_swap_chain_buffer];
   m_current_swap_chain_buffer = ((m_current_swap_chain_buffer + 1) % static_cast<u32>(m_swap_chain_buffers.size()));
 
   ID3D12GraphicsCommandList* cmdlist = g_d3d12_context->GetCommandList();
   RenderDisplay(cmdlist, &swap_chain_buf);
 
+  SetGPUTimingScope(GPUTimingScope::Overlays);
   if (ImGui::GetCurrentContext())
     RenderImGui(cmdlist);
 
@@ -606,11 +651,14 @@ bool D3D12HostDisplay::Render(bool skip_present)
 
   swap_chain_buf.TransitionToState(D3D12_RESOURCE_STATE_PRESENT);
   g_d3d12_context->ExecuteCommandList(false);
+  SetGPUTimingScope(GPUTimingScope::Other);
 
-  if (!m_vsync_enabled && m_using_allow_tearing)
+  // triple buffering shows the newest frame at the next refresh instead of tearing
+  if (!m_vsync_enabled && m_using_allow_tearing && !m_triple_buffering)
     m_swap_chain->Present(0, DXGI_PRESENT_ALLOW_TEARING);
   else
     m_swap_chain->Present(BoolToUInt32(m_vsync_enabled), 0);
+  m_swap_chain_wait_pending = true;
 
   return true;
 }
@@ -677,14 +725,32 @@ float D3D12HostDisplay::GetAndResetAccumulatedGPUTime()
   return g_d3d12_context->GetAndResetAccumulatedGPUTime();
 }
 
+HostDisplay::GPUTimingScopeTimes D3D12HostDisplay::GetAndResetAccumulatedGPUTimingScopeTimes()
+{
+  static_assert(MAX_GPU_TIMING_SCOPES == D3D12::Context::MAX_TIMING_SCOPES);
+  return g_d3d12_context->GetAndResetAccumulatedScopeTimes();
+}
+
+void D3D12HostDisplay::OnGPUTimingScopeChanged(u32 scope)
+{
+  g_d3d12_context->SetTimingScope(scope);
+}
+
 void D3D12HostDisplay::RenderImGui(ID3D12GraphicsCommandList* cmdlist)
 {
   ImGui::Render();
-  ImGui_ImplDX12_RenderDrawData(ImGui::GetDrawData());
+
+  // nothing on screen most of the time while playing, so skip setting up the pipeline state
+  ImDrawData* draw_data = ImGui::GetDrawData();
+  if (draw_data->TotalVtxCount == 0)
+    return;
+
+  ImGui_ImplDX12_RenderDrawData(draw_data);
 }
 
 void D3D12HostDisplay::RenderDisplay(ID3D12GraphicsCommandList* cmdlist, D3D12::Texture* swap_chain_buf)
 {
+  SetGPUTimingScope(GPUTimingScope::Display);
   const auto [left, top, width, height] = CalculateDrawRect(GetWindowWidth(), GetWindowHeight());
 
   if (HasDisplayTexture() && !m_post_processing_chain.IsEmpty())
@@ -836,58 +902,87 @@ HostDisplay::AdapterAndModeList D3D12HostDisplay::GetAdapterAndModeList(IDXGIFac
   return adapter_info;
 }
 
-D3D12HostDisplay::PostProcessingStage::PostProcessingStage(PostProcessingStage&& move)
-  : pipeline(std::move(move.pipeline)), output_texture(std::move(move.output_texture)),
-    uniforms_size(move.uniforms_size)
-{
-  move.uniforms_size = 0;
-}
-
-D3D12HostDisplay::PostProcessingStage::~PostProcessingStage()
-{
-  output_texture.Destroy(true);
-}
-
 bool D3D12HostDisplay::SetPostProcessingChain(const std::string_view& config)
 {
   g_d3d12_context->ExecuteCommandList(true);
 
   if (config.empty())
   {
-    m_post_processing_stages.clear();
+    m_post_processing_passes.clear();
     m_post_processing_chain.ClearStages();
+    SetPostProcessingGPUTimingScopeNames({});
     return true;
   }
 
   if (!m_post_processing_chain.CreateFromString(config))
     return false;
 
-  m_post_processing_stages.clear();
+  m_post_processing_chain.SetFusionEnabled(g_settings.display_post_process_fusion);
+  if (!CompilePostProcessingPasses())
+  {
+    if (!m_post_processing_chain.HasFusedPasses())
+    {
+      m_post_processing_chain.ClearStages();
+      return false;
+    }
+
+    Log_WarningPrintf("Failed to compile fused post-processing passes, retrying with one pass per shader.");
+    m_post_processing_chain.SetFusionEnabled(false);
+    if (!CompilePostProcessingPasses())
+    {
+      m_post_processing_chain.ClearStages();
+      return false;
+    }
+  }
+
+  bool only_use_push_constants = true;
+  for (u32 i = 0; i < m_post_processing_chain.GetPassCount(); i++)
+    only_use_push_constants &= m_post_processing_chain.PassUsesPushConstants(i);
+
+  constexpr u32 UBO_SIZE = 1 * 1024 * 1024;
+  if (!only_use_push_constants && m_post_processing_cbuffer.GetSize() < UBO_SIZE)
+  {
+    if (!m_post_processing_cbuffer.Create(UBO_SIZE))
+    {
+      Log_ErrorPrintf("Failed to allocate %u byte constant buffer for postprocessing", UBO_SIZE);
+      m_post_processing_passes.clear();
+      m_post_processing_chain.ClearStages();
+      return false;
+    }
+
+    D3D12::SetObjectName(m_post_processing_cbuffer.GetBuffer(), "Post Processing Uniform Buffer");
+  }
+
+  m_post_processing_timer.Reset();
+  SetPostProcessingGPUTimingScopeNames(m_post_processing_chain.GetPassNames());
+  return true;
+}
+
+bool D3D12HostDisplay::CompilePostProcessingPasses()
+{
+  m_post_processing_passes.clear();
 
   D3D12::ShaderCache shader_cache;
   shader_cache.Open(EmuFolders::Cache, g_d3d12_context->GetFeatureLevel(), g_settings.gpu_use_debug_device);
 
   FrontendCommon::PostProcessingShaderGen shadergen(RenderAPI::D3D12, false);
-  bool only_use_push_constants = true;
+  const std::vector<std::string> pass_names(m_post_processing_chain.GetPassNames());
 
-  for (u32 i = 0; i < m_post_processing_chain.GetStageCount(); i++)
+  for (u32 i = 0; i < m_post_processing_chain.GetPassCount(); i++)
   {
-    const FrontendCommon::PostProcessingShader& shader = m_post_processing_chain.GetShaderStage(i);
-    const std::string vs = shadergen.GeneratePostProcessingVertexShader(shader);
-    const std::string ps = shadergen.GeneratePostProcessingFragmentShader(shader);
-    const bool use_push_constants = shader.UsePushConstants();
-    only_use_push_constants &= use_push_constants;
+    const std::string vs = shadergen.GeneratePostProcessingVertexShader(m_post_processing_chain, i);
+    const std::string ps = shadergen.GeneratePostProcessingFragmentShader(m_post_processing_chain, i);
+    const bool use_push_constants = m_post_processing_chain.PassUsesPushConstants(i);
 
-    PostProcessingStage stage;
-    stage.uniforms_size = shader.GetUniformsSize();
+    PostProcessingPass pass;
+    pass.uniforms_size = m_post_processing_chain.GetPassUniformsSize(i);
 
     ComPtr<ID3DBlob> vs_blob(shader_cache.GetVertexShader(vs));
     ComPtr<ID3DBlob> ps_blob(shader_cache.GetPixelShader(ps));
     if (!vs_blob || !ps_blob)
     {
-      Log_ErrorPrintf("Failed to compile one or more post-processing shaders, disabling.");
-      m_post_processing_stages.clear();
-      m_post_processing_chain.ClearStages();
+      Log_ErrorPrintf("Failed to compile one or more post-processing shaders.");
+      m_post_processing_passes.clear();
       return false;
     }
 
@@ -902,69 +997,48 @@ bool D3D12HostDisplay::SetPostProcessingChain(const std::string_view& config)
                                                     m_post_processing_cb_root_signature.Get());
     gpbuilder.SetRenderTarget(0, DXGI_FORMAT_R8G8B8A8_UNORM);
 
-    stage.pipeline = gpbuilder.Create(g_d3d12_context->GetDevice(), shader_cache);
-    if (!stage.pipeline)
-    {
-      Log_ErrorPrintf("Failed to compile one or more post-processing pipelines, disabling.");
-      m_post_processing_stages.clear();
-      m_post_processing_chain.ClearStages();
-      return false;
-    }
-    D3D12::SetObjectNameFormatted(stage.pipeline.Get(), "%s Pipeline", shader.GetName().c_str());
-
-    m_post_processing_stages.push_back(std::move(stage));
-  }
-
-  constexpr u32 UBO_SIZE = 1 * 1024 * 1024;
-  if (!only_use_push_constants && m_post_processing_cbuffer.GetSize() < UBO_SIZE)
-  {
-    if (!m_post_processing_cbuffer.Create(UBO_SIZE))
+    pass.pipeline = gpbuilder.Create(g_d3d12_context->GetDevice(), shader_cache);
+    if (!pass.pipeline)
     {
-      Log_ErrorPrintf("Failed to allocate %u byte constant buffer for postprocessing", UBO_SIZE);
-      m_post_processing_stages.clear();
-      m_post_processing_chain.ClearStages();
+      Log_ErrorPrintf("Failed to compile one or more post-processing pipelines.");
+      m_post_processing_passes.clear();
       return false;
     }
+    D3D12::SetObjectNameFormatted(pass.pipeline.Get(), "%s Pipeline", pass_names[i].c_str());
 
-    D3D12::SetObjectName(m_post_processing_cbuffer.GetBuffer(), "Post Processing Uniform Buffer");
+    m_post_processing_passes.push_back(std::move(pass));
   }
 
-  m_post_processing_timer.Reset();
   return true;
 }
 
 bool D3D12HostDisplay::CheckPostProcessingRenderTargets(u32 target_width, u32 target_height)
 {
-  DebugAssert(!m_post_processing_stages.empty());
+  DebugAssert(!m_post_processing_passes.empty());
 
   const DXGI_FORMAT tex_format = DXGI_FORMAT_R8G8B8A8_UNORM;
   const DXGI_FORMAT srv_format = DXGI_FORMAT_R8G8B8A8_UNORM;
   const DXGI_FORMAT rtv_format = DXGI_FORMAT_R8G8B8A8_UNORM;
 
-  if (m_post_processing_input_texture.GetWidth() != target_width ||
-      m_post_processing_input_texture.GetHeight() != target_height)
+  // a single pass goes straight from the display copy to the final target
+  const u32 target_count = (m_post_processing_passes.size() > 1) ? 2u : 1u;
+  for (u32 i = 0; i < static_cast<u32>(m_post_processing_textures.size()); i++)
   {
-    if (!m_post_processing_input_texture.Create(target_width, target_height, 1, 1, 1, tex_format, srv_format,
-                                                rtv_format, DXGI_FORMAT_UNKNOWN,
-                                                D3D12_RESOURCE_FLAG_ALLOW_RENDER_TARGET))
+    D3D12::Texture& texture = m_post_processing_textures[i];
+    if (i >= target_count)
     {
-      return false;
+      texture.Destroy(true);
+      continue;
     }
-    D3D12::SetObjectName(m_post_processing_input_texture.GetResource(), "Post Processing Input Texture");
-  }
 
-  const u32 target_count = (static_cast<u32>(m_post_processing_stages.size()) - 1);
-  for (u32 i = 0; i < target_count; i++)
-  {
-    PostProcessingStage& pps = m_post_processing_stages[i];
-    if (pps.output_texture.GetWidth() != target_width || pps.output_texture.GetHeight() != target_height)
+    if (texture.GetWidth() != target_width || texture.GetHeight() != target_height)
     {
-      if (!pps.output_texture.Create(target_width, target_height, 1, 1, 1, tex_format, srv_format, rtv_format,
-                                     DXGI_FORMAT_UNKNOWN, D3D12_RESOURCE_FLAG_ALLOW_RENDER_TARGET))
+      if (!texture.Create(target_width, target_height, 1, 1, 1, tex_format, srv_format, rtv_format,
+                          DXGI_FORMAT_UNKNOWN, D3D12_RESOURCE_FLAG_ALLOW_RENDER_TARGET))
       {
         return false;
       }
-      D3D12::SetObjectNameFormatted(pps.output_texture.GetResource(), "Post Processing Output Texture %u", i);
+      D3D12::SetObjectNameFormatted(texture.GetResource(), "Post Processing Texture %u", i);
     }
   }
 
@@ -989,34 +1063,35 @@ void D3D12HostDisplay::ApplyPostProcessingChain(ID3D12GraphicsCommandList* cmdli
   }
 
   // downsample/upsample - use same viewport for remainder
-  m_post_processing_input_texture.TransitionToState(D3D12_RESOURCE_STATE_RENDER_TARGET);
-  cmdlist->ClearRenderTargetView(m_post_processing_input_texture.GetRTVOrDSVDescriptor(), s_clear_color.data(), 0,
-                                 nullptr);
-  cmdlist->OMSetRenderTargets(1, &m_post_processing_input_texture.GetRTVOrDSVDescriptor().cpu_handle, FALSE, nullptr);
+  D3D12::Texture& input_texture = m_post_processing_textures[0];
+  input_texture.TransitionToState(D3D12_RESOURCE_STATE_RENDER_TARGET);
+  cmdlist->ClearRenderTargetView(input_texture.GetRTVOrDSVDescriptor(), s_clear_color.data(), 0, nullptr);
+  cmdlist->OMSetRenderTargets(1, &input_texture.GetRTVOrDSVDescriptor().cpu_handle, FALSE, nullptr);
   RenderDisplay(cmdlist, final_left, final_top, final_width, final_height, texture, texture_view_x, texture_view_y,
                 texture_view_width, texture_view_height, IsUsingLinearFiltering());
-  m_post_processing_input_texture.TransitionToState(D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
+  input_texture.TransitionToState(D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
 
   const s32 orig_texture_width = texture_view_width;
   const s32 orig_texture_height = texture_view_height;
-  texture = &m_post_processing_input_texture;
+  texture = &input_texture;
   texture_view_x = final_left;
   texture_view_y = final_top;
   texture_view_width = final_width;
   texture_view_height = final_height;
 
-  const u32 final_stage = static_cast<u32>(m_post_processing_stages.size()) - 1u;
-  for (u32 i = 0; i < static_cast<u32>(m_post_processing_stages.size()); i++)
+  const u32 final_pass = static_cast<u32>(m_post_processing_passes.size()) - 1u;
+  for (u32 i = 0; i < static_cast<u32>(m_post_processing_passes.size()); i++)
   {
-    PostProcessingStage& pps = m_post_processing_stages[i];
+    PostProcessingPass& ppp = m_post_processing_passes[i];
+    SetPostProcessingGPUTimingScope(i);
 
-    const bool use_push_constants = m_post_processing_chain.GetShaderStage(i).UsePushConstants();
+    const bool use_push_constants = m_post_processing_chain.PassUsesPushConstants(i);
     if (use_push_constants)
     {
       u8 buffer[FrontendCommon::PostProcessingShader::PUSH_CONSTANT_SIZE_THRESHOLD];
-      Assert(pps.uniforms_size <= sizeof(buffer));
-      m_post_processing_chain.GetShaderStage(i).FillUniformBuffer(
-        buffer, texture->GetWidth(), texture->GetHeight(), texture_view_x, texture_view_y, texture_view_width,
+      Assert(ppp.uniforms_size <= sizeof(buffer));
+      m_post_processing_chain.FillPassUniformBuffer(
+        i, buffer, texture->GetWidth(), texture->GetHeight(), texture_view_x, texture_view_y, texture_view_width,
         texture_view_height, GetWindowWidth(), GetWindowHeight(), orig_texture_width, orig_texture_height,
         static_cast<float>(m_post_processing_timer.GetTimeSeconds()));
 
@@ -1025,38 +1100,40 @@ void D3D12HostDisplay::ApplyPostProcessingChain(ID3D12GraphicsCommandList* cmdli
     }
     else
     {
-      if (!m_post_processing_cbuffer.ReserveMemory(pps.uniforms_size, D3D12_CONSTANT_BUFFER_DATA_PLACEMENT_ALIGNMENT))
+      if (!m_post_processing_cbuffer.ReserveMemory(ppp.uniforms_size, D3D12_CONSTANT_BUFFER_DATA_PLACEMENT_ALIGNMENT))
       {
         Panic("Failed to reserve space in post-processing UBO");
       }
 
       const u32 offset = m_post_processing_cbuffer.GetCurrentOffset();
-      m_post_processing_chain.GetShaderStage(i).FillUniformBuffer(
-        m_post_processing_cbuffer.GetCurrentHostPointer(), texture->GetWidth(), texture->GetHeight(), texture_view_x,
-        texture_view_y, texture_view_width, texture_view_height, GetWindowWidth(), GetWindowHeight(),
+      m_post_processing_chain.FillPassUniformBuffer(
+        i, m_post_processing_cbuffer.GetCurrentHostPointer(), texture->GetWidth(), texture->GetHeight(),
+        texture_view_x, texture_view_y, texture_view_width, texture_view_height, GetWindowWidth(), GetWindowHeight(),
         orig_texture_width, orig_texture_height, static_cast<float>(m_post_processing_timer.GetTimeSeconds()));
-      m_post_processing_cbuffer.CommitMemory(pps.uniforms_size);
+      m_post_processing_cbuffer.CommitMemory(ppp.uniforms_size);
 
       cmdlist->SetGraphicsRootSignature(m_post_processing_cb_root_signature.Get());
       cmdlist->SetGraphicsRootConstantBufferView(0, m_post_processing_cbuffer.GetGPUPointer() + offset);
     }
 
-    D3D12::Texture* rt = (i != final_stage) ? &pps.output_texture : final_target;
+    // pass N reads target N % 2, and writes to the other one
+    D3D12::Texture& output_texture = m_post_processing_textures[(i + 1) & 1u];
+    D3D12::Texture* rt = (i != final_pass) ? &output_texture : final_target;
     rt->TransitionToState(D3D12_RESOURCE_STATE_RENDER_TARGET);
     cmdlist->ClearRenderTargetView(rt->GetRTVOrDSVDescriptor(), s_clear_color.data(), 0, nullptr);
     cmdlist->OMSetRenderTargets(1, &rt->GetRTVOrDSVDescriptor().cpu_handle, FALSE, nullptr);
 
-    cmdlist->SetPipelineState(pps.pipeline.Get());
+    cmdlist->SetPipelineState(ppp.pipeline.Get());
     cmdlist->SetGraphicsRootDescriptorTable(1, texture->GetSRVDescriptor());
     cmdlist->SetGraphicsRootDescriptorTable(2, m_border_sampler);
 
     cmdlist->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
     cmdlist->DrawInstanced(3, 1, 0, 0);
 
-    if (i != final_stage)
+    if (i != final_pass)
     {
-      pps.output_texture.TransitionToState(D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
-      texture = &pps.output_texture;
+      output_texture.TransitionToState(D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
+      texture = &output_texture;
     }
   }
 }
@@ -11,8 +11,9 @@
 #include "common/windows_headers.h"
 #include "core/host_display.h"
 #include "postprocessing_chain.h"
+#include <array>
 #include <d3d12.h>
-#include <dxgi.h>
+#include <dxgi1_3.h>
 #include <memory>
 #include <string>
 #include <string_view>
@@ -64,6 +65,7 @@ public:
   bool GetHostRefreshRate(float* refresh_rate) override;
 
   void SetVSync(bool enabled) override;
+  void WaitForSwapChain() override;
 
   bool Render(bool skip_present) override;
   bool RenderScreenshot(u32 width, u32 height, const Common::Rectangle<s32>& draw_rect, std::vector<u32>* out_pixels,
@@ -71,23 +73,21 @@ public:
 
   bool SetGPUTimingEnabled(bool enabled) override;
   float GetAndResetAccumulatedGPUTime() override;
+  GPUTimingScopeTimes GetAndResetAccumulatedGPUTimingScopeTimes() override;
 
   static AdapterAndModeList StaticGetAdapterAndModeList();
 
 protected:
-  struct PostProcessingStage
+  struct PostProcessingPass
   {
-    PostProcessingStage() = default;
-    PostProcessingStage(PostProcessingStage&& move);
-    ~PostProcessingStage();
-
     ComPtr<ID3D12PipelineState> pipeline;
-    D3D12::Texture output_texture;
     u32 uniforms_size = 0;
   };
 
   static AdapterAndModeList GetAdapterAndModeList(IDXGIFactory* dxgi_factory);
 
+  void OnGPUTimingScopeChanged(u32 scope) override;
+
   virtual bool CreateResources() override;
   virtual void DestroyResources() override;
 
@@ -97,6 +97,7 @@ protected:
 
   bool CreateSwapChain(const DXGI_MODE_DESC* fullscreen_mode);
   bool CreateSwapChainRTV();
+  void DestroySwapChain();
   void DestroySwapChainRTVs();
 
   void RenderDisplay(ID3D12GraphicsCommandList* cmdlist, D3D12::Texture* swap_chain_buf);
@@ -109,6 +110,7 @@ protected:
   void RenderSoftwareCursor(ID3D12GraphicsCommandList* cmdlist, s32 left, s32 top, s32 width, s32 height,
                             GPUTexture* texture_handle);
 
+  bool CompilePostProcessingPasses();
   bool CheckPostProcessingRenderTargets(u32 target_width, u32 target_height);
   void ApplyPostProcessingChain(ID3D12GraphicsCommandList* cmdlist, D3D12::Texture* final_target, s32 final_left,
                                 s32 final_top, s32 final_width, s32 final_height, D3D12::Texture* texture,
@@ -117,6 +119,10 @@ protected:
 
   ComPtr<IDXGIFactory> m_dxgi_factory;
   ComPtr<IDXGISwapChain> m_swap_chain;
+  HANDLE m_swap_chain_waitable = NULL;
+  UINT m_swap_chain_flags = 0;
+  bool m_swap_chain_wait_pending = false;
+  bool m_triple_buffering = false;
   std::vector<D3D12::Texture> m_swap_chain_buffers;
   u32 m_current_swap_chain_buffer = 0;
 
@@ -134,8 +140,10 @@ protected:
   ComPtr<ID3D12RootSignature> m_post_processing_cb_root_signature;
   FrontendCommon::PostProcessingChain m_post_processing_chain;
   D3D12::StreamBuffer m_post_processing_cbuffer;
-  D3D12::Texture m_post_processing_input_texture;
-  std::vector<PostProcessingStage> m_post_processing_stages;
+
+  // Passes alternate between two targets of the same size, [0] receives the display and is the first pass's input.
+  std::array<D3D12::Texture, 2> m_post_processing_textures;
+  std::vector<PostProcessingPass> m_post_processing_passes;
   Common::Timer m_post_processing_timer;
 
   bool m_allow_tearing_supported = false;
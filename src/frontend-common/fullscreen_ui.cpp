@@ -538,6 +538,7 @@ void FullscreenUI::AsyncOpThreadEntryPoint(std::function<void(::ProgressCallback
                                            FullscreenUI::ProgressCallback* progress)
 {
   Threading::SetNameOfCurrentThread(fmt::format("{} Async Op", progress->GetName()).c_str());
+  Threading::ApplyAffinityPolicy(Threading::AffinityClass::Background);
 
   callback(progress);
 
@@ -2841,6 +2842,13 @@ void FullscreenUI::DrawConsoleSettingsPage()
     bsi, "Readahead Sectors",
     "Reduces hitches in emulation by reading/decompressing CD data asynchronously on a worker thread.", "CDROM",
     "ReadaheadSectors", Settings::DEFAULT_CDROM_READAHEAD_SECTORS, 0, 32, "%d sectors");
+  DrawIntRangeSetting(bsi, "Decompression Cache",
+                      "Number of decompressed blocks of compressed images (e.g. CHD) kept in memory.", "CDROM",
+                      "DecompressionCacheBlocks", Settings::DEFAULT_CDROM_DECOMPRESSION_CACHE_BLOCKS, 1, 64,
+                      "%d blocks");
+  DrawToggleSetting(bsi, "Prefetch Compressed Blocks",
+                    "Decompresses the blocks following the current read ahead of time on a worker thread.", "CDROM",
+                    "DecompressionPrefetch", false);
 
   DrawToggleSetting(bsi, "Enable Region Check", "Simulates the region check present in original, unmodified consoles.",
                     "CDROM", "RegionCheck", false);
@@ -2848,6 +2856,10 @@ void FullscreenUI::DrawConsoleSettingsPage()
     bsi, "Preload Images to RAM",
     "Loads the game image into RAM. Useful for network paths that may become unreliable during gameplay.", "CDROM",
     "LoadImageToRAM", false);
+  DrawToggleSetting(bsi, "Compress Preloaded Images",
+                    "Keeps preloaded images compressed in RAM, allowing multi-disc playlists to be preloaded.", "CDROM",
+                    "LoadImageToRAMCompressed", false,
+                    GetEffectiveBoolSetting(bsi, "CDROM", "LoadImageToRAM", false));
   DrawToggleSetting(
     bsi, "Apply Image Patches",
     "Automatically applies patches to disc images when they are present, currently only PPF is supported.", "CDROM",
@@ -2905,6 +2917,10 @@ void FullscreenUI::DrawEmulationSettingsPage()
   DrawIntRangeSetting(bsi, "Rewind Save Slots",
                       "How many saves will be kept for rewinding. Higher values have greater memory requirements.",
                       "Main", "RewindSaveSlots", 10, 1, 10000, "%d Frames");
+  DrawToggleSetting(bsi, "Store Rewind VRAM At Native Resolution",
+                    "Rewind states no longer use video memory at high resolution scales, but the first frame after "
+                    "rewinding is at native resolution.",
+                    "Main", "RewindNativeVRAM", false);
 
   const s32 runahead_frames = GetEffectiveIntSetting(bsi, "Main", "RunaheadFrameCount", 0);
   const bool runahead_enabled = (runahead_frames > 0);
@@ -2918,6 +2934,10 @@ void FullscreenUI::DrawEmulationSettingsPage()
     bsi, "Runahead",
     "Simulates the system ahead of time and rolls back/replays to reduce input lag. Very high system requirements.",
     "Main", "RunaheadFrameCount", 0, runahead_options.data(), runahead_options.size());
+  DrawToggleSetting(bsi, "Skip Rendering Replayed Frames",
+                    "Discards the draws of replayed runahead frames except the last. Reduces GPU load, but may cause "
+                    "missing graphics.",
+                    "Main", "RunaheadSkipRendering", false, runahead_enabled);
 
   TinyString rewind_summary;
   if (runahead_enabled)
@@ -2934,7 +2954,9 @@ void FullscreenUI::DrawEmulationSettingsPage()
       static_cast<float>(rewind_save_slots);
 
     u64 ram_usage, vram_usage;
-    System::CalculateRewindMemoryUsage(rewind_save_slots, &ram_usage, &vram_usage);
+    System::CalculateRewindMemoryUsage(rewind_save_slots,
+                                       GetEffectiveBoolSetting(bsi, "Main", "RewindNativeVRAM", false), &ram_usage,
+                                       &vram_usage);
     rewind_summary.Format("Rewind for %u frames, lasting %.2f seconds will require up to %" PRIu64
                           "MB of RAM and %" PRIu64 "MB of VRAM.",
                           rewind_save_slots, duration, ram_usage / 1048576, vram_usage / 1048576);
@@ -3127,6 +3149,9 @@ void FullscreenUI::DrawControllerSettingsPage()
                     "The XInput source provides support for XBox 360/XBox One/XBox Series controllers.", "InputSources",
                     "XInput", false);
 #endif
+  DrawToggleSetting(bsi, ICON_FA_COG " Poll Input On Separate Thread",
+                    "Polls controllers at 1000Hz, and applies changes right before the game reads the controller.",
+                    "InputSources", "PollingThread", false);
 
   MenuHeading("Multitap");
   DrawEnumSetting(bsi, ICON_FA_PLUS_SQUARE " Multitap Mode",
@@ -3633,6 +3658,10 @@ void FullscreenUI::DrawDisplaySettingsPage()
       DrawToggleSetting(bsi, "Use Blit Swap Chain",
                         "Uses a blit presentation model instead of flipping. This may be needed on some systems.",
                         "Display", "UseBlitSwapChain", false);
+      DrawToggleSetting(bsi, "Threaded Command Submission",
+                        "Records draws into a deferred context on a separate thread. May help polygon-heavy games on "
+                        "drivers which support command lists.",
+                        "GPU", "UseRenderThread", false);
     }
     break;
 #endif
@@ -3643,6 +3672,21 @@ void FullscreenUI::DrawDisplaySettingsPage()
       DrawToggleSetting(bsi, "Threaded Presentation",
                         "Presents frames on a background thread when fast forwarding or vsync is disabled.", "GPU",
                         "ThreadedPresentation", true);
+      DrawToggleSetting(bsi, "Threaded Command Submission",
+                        "Submits draws to the host GPU from a separate thread. May help polygon-heavy games at high "
+                        "resolution scales.",
+                        "GPU", "UseRenderThread", false);
+    }
+    break;
+#endif
+
+#ifdef _WIN32
+    case GPURenderer::HardwareD3D12:
+    {
+      DrawToggleSetting(bsi, "Threaded Command Submission",
+                        "Submits draws to the host GPU from a separate thread. May help polygon-heavy games at high "
+                        "resolution scales.",
+                        "GPU", "UseRenderThread", false);
     }
     break;
 #endif
@@ -3652,6 +3696,10 @@ void FullscreenUI::DrawDisplaySettingsPage()
       DrawToggleSetting(bsi, "Threaded Rendering",
                         "Uses a second thread for drawing graphics. Speed boost, and safe to use.", "GPU", "UseThread",
                         true);
+      DrawIntRangeSetting(bsi, "Worker Threads",
+                          "Splits rasterization across additional threads. Requires threaded rendering.", "GPU",
+                          "SoftwareWorkerThreads", 0, 0, Settings::GPU_SW_MAX_WORKER_THREADS, "%d threads",
+                          GetEffectiveBoolSetting(bsi, "GPU", "UseThread", true));
     }
     break;
 
@@ -3665,12 +3713,22 @@ void FullscreenUI::DrawDisplaySettingsPage()
                       "Runs the software renderer in parallel for VRAM readbacks. On some systems, this may result "
                       "in greater performance.",
                       "GPU", "UseSoftwareRendererForReadbacks", false);
+    DrawEnumSetting(bsi, "Shader Mode",
+                    "Uber shaders avoid compile stutter at a small GPU cost. Specialized shaders can be compiled in "
+                    "the background on Vulkan.",
+                    "GPU", "ShaderMode", Settings::DEFAULT_GPU_SHADER_MODE, &Settings::ParseShaderModeName,
+                    &Settings::GetShaderModeName, &Settings::GetShaderModeDisplayName, GPUShaderMode::Count);
   }
 
   DrawToggleSetting(bsi, "Enable VSync",
                     "Synchronizes presentation of the console's frames to the host. Enable for smoother animations.",
                     "Display", "VSync", Settings::DEFAULT_VSYNC_VALUE);
 
+  DrawToggleSetting(bsi, "Triple Buffering",
+                    "Shows the newest frame at each refresh without tearing when VSync is disabled. Not supported by "
+                    "the OpenGL renderer.",
+                    "Display", "TripleBuffering", false);
+
   DrawToggleSetting(bsi, "Sync To Host Refresh Rate",
                     "Adjusts the emulation speed so the console's refresh rate matches the host when VSync and Audio "
                     "Resampling are enabled.",
@@ -3681,6 +3739,16 @@ void FullscreenUI::DrawDisplaySettingsPage()
     "Ensures every frame generated is displayed for optimal pacing. Disable if you are having speed or sound issues.",
     "Display", "DisplayAllFrames", false);
 
+  DrawToggleSetting(bsi, "Low Latency Frame Pacing",
+                    "Delays the start of each frame so it finishes just before vblank when syncing to the host with "
+                    "VSync. Reduces input latency.",
+                    "Display", "LowLatencyPacing", false);
+
+  DrawToggleSetting(bsi, "Late Input Latching",
+                    "Polls controllers when the game reads them, and starts each frame as late as possible. Reduces "
+                    "input latency.",
+                    "Display", "LateInputLatch", false);
+
   MenuHeading("Rendering");
 
   DrawIntListSetting(
@@ -3688,6 +3756,16 @@ void FullscreenUI::DrawDisplaySettingsPage()
     "Scales internal VRAM resolution by the specified multiplier. Some games require 1x VRAM resolution.", "GPU",
     "ResolutionScale", 1, resolution_scales.data(), resolution_scales.size(), 0, is_hardware);
 
+  DrawToggleSetting(bsi, "Dynamic Resolution",
+                    "Lowers the resolution scale when the GPU can't finish frames in time, and raises it back when "
+                    "there is headroom again.",
+                    "GPU", "DynamicResolution", false, is_hardware);
+
+  DrawIntRangeSetting(bsi, "Minimum Dynamic Resolution Scale",
+                      "The lowest resolution scale dynamic resolution will drop to.", "GPU",
+                      "DynamicResolutionMinScale", 1, 1, 16, "%dx",
+                      is_hardware && GetEffectiveBoolSetting(bsi, "GPU", "DynamicResolution", false));
+
   DrawEnumSetting(bsi, "Texture Filtering",
                   "Smooths out the blockiness of magnified textures on 3D objects. Will have a greater effect "
                   "on higher resolution scales. The JINC2 and especially xBR filtering modes are very demanding,"
@@ -3696,6 +3774,11 @@ void FullscreenUI::DrawDisplaySettingsPage()
                   &Settings::GetTextureFilterName, &Settings::GetTextureFilterDisplayName, GPUTextureFilter::Count,
                   is_hardware);
 
+  DrawToggleSetting(bsi, "Adaptive Texture Filtering",
+                    "Uses bilinear filtering instead of JINC2 or xBR for textures which are drawn smaller than their "
+                    "native size, where the more expensive filters can't add any detail.",
+                    "GPU", "AdaptiveTextureFiltering", false, is_hardware);
+
   DrawToggleSetting(bsi, "True Color Rendering",
                     "Disables dithering and uses the full 8 bits per channel of color information. May break "
                     "rendering in some games.",
@@ -3734,6 +3817,10 @@ void FullscreenUI::DrawDisplaySettingsPage()
                   &Settings::GetDownsampleModeName, &Settings::GetDownsampleModeDisplayName, GPUDownsampleMode::Count,
                   (renderer != GPURenderer::Software));
 
+  DrawToggleSetting(bsi, "Compute Shader Downsampling",
+                    "Performs adaptive downsampling in a single compute shader pass, where supported by the renderer.",
+                    "GPU", "DownsampleCompute", true, (renderer != GPURenderer::Software));
+
   DrawToggleSetting(bsi, "Linear Upscaling",
                     "Uses a bilinear filter when upscaling to display, smoothing out the image.", "Display",
                     "LinearFiltering", true);
@@ -3803,6 +3890,12 @@ void FullscreenUI::DrawDisplaySettingsPage()
   DrawToggleSetting(bsi, "Preload Replacement Textures",
                     "Loads all replacement texture to RAM, reducing stuttering at runtime.", "TextureReplacements",
                     "PreloadTextures", false);
+  DrawToggleSetting(bsi, "Load Replacement Textures Asynchronously",
+                    "Decodes replacement textures on worker threads. The original texture is used until it's ready.",
+                    "TextureReplacements", "AsyncLoading", false);
+  DrawIntRangeSetting(bsi, "Replacement Texture Cache Size",
+                      "Least recently used replacement textures are unloaded past this limit. 0 means unlimited.",
+                      "TextureReplacements", "MaxCacheSize", 0, 0, 65536, "%d MB");
 
   EndMenuButtons();
 }
@@ -3850,6 +3943,10 @@ void FullscreenUI::DrawPostProcessingSettingsPage()
                     "If not enabled, the current post processing chain will be ignored.", "Display", "PostProcessing",
                     false);
 
+  DrawToggleSetting(bsi, ICON_FA_LAYER_GROUP " Fuse Single Sample Shaders",
+                    "Combines consecutive shaders which only read the current pixel into a single pass.", "Display",
+                    "PostProcessFusion", true);
+
   if (MenuButton(ICON_FA_SEARCH " Reload Shaders", "Reloads the shaders from disk, applying any changes.",
                  bsi->GetBoolValue("Display", "PostProcessing", false)))
   {
@@ -4222,6 +4319,9 @@ void FullscreenUI::DrawAudioSettingsPage()
   DrawEnumSetting(bsi, "Stretch Mode", "Determines quality of audio when not running at 100% speed.", "Audio",
                   "StretchMode", Settings::DEFAULT_AUDIO_STRETCH_MODE, &AudioStream::ParseStretchMode,
                   &AudioStream::GetStretchModeName, &AudioStream::GetStretchModeDisplayName, AudioStretchMode::Count);
+  DrawToggleSetting(bsi, "Stretch On Worker Thread",
+                    "Resamples or time stretches audio on a separate thread, freeing up the emulation thread.", "Audio",
+                    "StretchThread", false);
   DrawIntRangeSetting(bsi, "Buffer Size",
                       "Determines the amount of audio buffered before being pulled by the host API.", "Audio",
                       "BufferMS", Settings::DEFAULT_AUDIO_BUFFER_MS, 10, 500, "%d ms");
@@ -4474,6 +4574,9 @@ void FullscreenUI::DrawAdvancedSettingsPage()
                     "LogToDebug", false);
   DrawToggleSetting(bsi, "Log To File", "Logs messages to duckstation.log in the user directory.", "Logging",
                     "LogToFile", false);
+  DrawToggleSetting(bsi, "Asynchronous Log Output",
+                    "Writes log messages from a separate thread, so logging doesn't slow down emulation.", "Logging",
+                    "AsyncOutput", false);
 
   MenuHeading("Debugging Settings");
 
@@ -4489,6 +4592,12 @@ void FullscreenUI::DrawAdvancedSettingsPage()
                     "Main", "IncreaseTimerResolution", true);
 #endif
 
+  DrawEnumSetting(bsi, "Thread Affinity Policy",
+                  "Keeps the CPU and GPU threads on their own performance cores, and background work off them.",
+                  "Main", "ThreadAffinityPolicy", Settings::DEFAULT_THREAD_AFFINITY_POLICY,
+                  &Settings::ParseThreadAffinityPolicy, &Settings::GetThreadAffinityPolicyName,
+                  &Settings::GetThreadAffinityPolicyDisplayName, ThreadAffinityPolicy::Count);
+
   DrawToggleSetting(bsi, "Allow Booting Without SBI File",
                     "Allows loading protected games without subchannel information.", "CDROM",
                     "AllowBootingWithoutSBIFile", false);
@@ -4543,10 +4652,26 @@ void FullscreenUI::DrawAdvancedSettingsPage()
   DrawToggleSetting(bsi, "Enable Recompiler Block Linking",
                     "Performance enhancement - jumps directly between blocks instead of returning to the dispatcher.",
                     "CPU", "RecompilerBlockLinking", true);
+  DrawToggleSetting(bsi, "Enable Recompiler Block Cache",
+                    "Remembers which code each game runs, and compiles it ahead of time on later boots.", "CPU",
+                    "RecompilerBlockCache", false);
+  DrawToggleSetting(bsi, "Enable Recompiler Compile Thread",
+                    "Compiles new code on a worker thread, interpreting it in the meantime to reduce stutter.", "CPU",
+                    "RecompilerAsyncCompile", false);
+  DrawIntRangeSetting(bsi, "Recompiler Tier Threshold",
+                      "Interprets new code until it has run this many times, so run-once code isn't compiled.",
+                      "CPU", "RecompilerTierThreshold", 0, 0, 1000, "%d Executions");
+  DrawToggleSetting(bsi, "Enable Idle Loop Skipping",
+                    "Fast forwards to the next event when code is spinning on a status flag. Reduces host CPU usage.",
+                    "CPU", "IdleLoopSkipping", false);
   DrawEnumSetting(bsi, "Recompiler Fast Memory Access",
                   "Avoids calls to C++ code, significantly speeding up the recompiler.", "CPU", "FastmemMode",
                   Settings::DEFAULT_CPU_FASTMEM_MODE, &Settings::ParseCPUFastmemMode, &Settings::GetCPUFastmemModeName,
                   &Settings::GetCPUFastmemModeDisplayName, CPUFastmemMode::Count);
+  DrawToggleSetting(bsi, "Use Large Pages",
+                    "Backs guest RAM and recompiled code with huge pages where the host allows, reducing TLB misses. "
+                    "Takes effect on the next boot.",
+                    "CPU", "UseLargePages", false);
 
   EndMenuButtons();
 }
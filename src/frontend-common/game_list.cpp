@@ -3,7 +3,6 @@
 
 #include "game_list.h"
 #include "common/assert.h"
-#include "common/byte_stream.h"
 #include "common/file_system.h"
 #include "common/heterogeneous_containers.h"
 #include "common/http_downloader.h"
@@ -12,6 +11,7 @@
 #include "common/path.h"
 #include "common/progress_callback.h"
 #include "common/string_util.h"
+#include "common/timer.h"
 #include "core/bios.h"
 #include "core/host.h"
 #include "core/host_settings.h"
@@ -19,11 +19,18 @@
 #include "core/settings.h"
 #include "core/system.h"
 #include "util/cd_image.h"
+#include "util/iso_reader.h"
+#include "util/mapped_file.h"
 #include <algorithm>
 #include <array>
+#include <atomic>
 #include <cctype>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
 #include <ctime>
 #include <string_view>
+#include <thread>
 #include <tinyxml2.h>
 #include <unordered_map>
 #include <utility>
@@ -37,13 +44,17 @@ namespace GameList {
 enum : u32
 {
   GAME_LIST_CACHE_SIGNATURE = 0x45434C47,
-  GAME_LIST_CACHE_VERSION = 32,
+  GAME_LIST_CACHE_VERSION = 33,
 
   PLAYED_TIME_SERIAL_LENGTH = 32,
   PLAYED_TIME_LAST_TIME_LENGTH = 20,  // uint64
   PLAYED_TIME_TOTAL_TIME_LENGTH = 20, // uint64
   PLAYED_TIME_LINE_LENGTH =
     PLAYED_TIME_SERIAL_LENGTH + 1 + PLAYED_TIME_LAST_TIME_LENGTH + 1 + PLAYED_TIME_TOTAL_TIME_LENGTH,
+
+  // Scanning is mostly waiting on I/O, so it's worth having more threads than cores on slow storage, within reason.
+  MAX_SCAN_THREADS = 16,
+  SCAN_PROGRESS_UPDATE_INTERVAL_MS = 50,
 };
 
 struct PlayedTimeEntry
@@ -52,27 +63,69 @@ struct PlayedTimeEntry
   std::time_t total_played_time;
 };
 
-using CacheMap = UnorderedStringMap<Entry>;
+/// The cache is a record table followed by a pool of the strings they reference, so it can be mapped and looked up
+/// in place. Entries are only unpacked when a file with a matching path is found.
+struct CacheHeader
+{
+  u32 signature;
+  u32 version;
+  u32 num_records;
+  u32 string_pool_size;
+};
+
+struct CacheString
+{
+  u32 offset;
+  u32 length;
+};
+
+struct CacheRecord
+{
+  CacheString path;
+  CacheString serial;
+  CacheString title;
+  CacheString genre;
+  CacheString publisher;
+  CacheString developer;
+  u64 file_size;
+  s64 last_modified_time;
+  u64 total_size;
+  u64 release_date;
+  u32 supported_controllers;
+  u8 type;
+  u8 region;
+  u8 compatibility;
+  u8 min_players;
+  u8 max_players;
+  u8 min_blocks;
+  u8 max_blocks;
+  u8 reserved[5];
+};
+static_assert(sizeof(CacheHeader) == 16 && sizeof(CacheRecord) == 96, "Cache structures are packed");
+
+/// Path to record index, the keys point into the cache data.
+using CacheMap = std::unordered_map<std::string_view, u32>;
 using PlayedTimeMap = UnorderedStringMap<PlayedTimeEntry>;
 
 static bool GetExeListEntry(const std::string& path, Entry* entry);
 static bool GetPsfListEntry(const std::string& path, Entry* entry);
 static bool GetDiscListEntry(const std::string& path, Entry* entry);
 
+static std::string_view GetCacheString(const CacheString& str);
 static bool GetGameListEntryFromCache(const std::string& path, Entry* entry);
-static void ScanDirectory(const char* path, bool recursive, bool only_cache,
-                          const std::vector<std::string>& excluded_paths, const PlayedTimeMap& played_time_map,
-                          ProgressCallback* progress);
-static bool AddFileFromCache(const std::string& path, std::time_t timestamp, const PlayedTimeMap& played_time_map);
-static bool ScanFile(std::string path, std::time_t timestamp, std::unique_lock<std::recursive_mutex>& lock,
-                     const PlayedTimeMap& played_time_map);
+static void ParallelFor(u32 count, const std::function<void(u32)>& func, ProgressCallback* progress);
+static void ScanDirectories(const std::vector<std::string>& dirs, const std::vector<std::string>& recursive_dirs,
+                            bool only_cache, const std::vector<std::string>& excluded_paths,
+                            const PlayedTimeMap& played_time_map, ProgressCallback* progress);
+static bool AddFileFromCache(const std::string& path, std::time_t timestamp, u64 file_size,
+                             const PlayedTimeMap& played_time_map);
+static bool ScanFile(std::string path, std::time_t timestamp, u64 file_size, const PlayedTimeMap& played_time_map);
 
 static std::string GetCacheFilename();
 static void LoadCache();
-static bool LoadEntriesFromCache(ByteStream* stream);
-static bool OpenCacheForWriting();
-static bool WriteEntryToCache(const Entry* entry);
-static void CloseCacheFileStream();
+static bool ValidateCache(const u8* data, size_t size);
+static void SaveCache();
+static void CloseCache();
 static void DeleteCacheFile();
 
 static std::string GetPlayedTimeFile();
@@ -86,7 +139,11 @@ static PlayedTimeEntry UpdatePlayedTimeFile(const std::string& path, const std::
 static std::vector<GameList::Entry> s_entries;
 static std::recursive_mutex s_mutex;
 static GameList::CacheMap s_cache_map;
-static std::unique_ptr<ByteStream> s_cache_write_stream;
+static Common::MappedFile s_cache_mapping;
+static std::vector<u8> s_cache_buffer;
+static const GameList::CacheRecord* s_cache_records = nullptr;
+static const char* s_cache_string_pool = nullptr;
+static bool s_cache_dirty = false;
 
 static bool m_game_list_loaded = false;
 
@@ -111,8 +168,8 @@ bool GameList::IsGameListLoaded()
 
 bool GameList::IsScannableFilename(const std::string_view& path)
 {
-  // we don't scan bin files because they'll duplicate
-  if (StringUtil::EndsWithNoCase(path, ".bin"))
+  // we don't scan bin files because they'll duplicate, and GPU dumps aren't games
+  if (StringUtil::EndsWithNoCase(path, ".bin") || System::IsGPUDumpFileName(path))
     return false;
 
   return System::IsLoadableFilename(path);
@@ -204,8 +261,12 @@ bool GameList::GetDiscListEntry(const std::string& path, Entry* entry)
   entry->type = EntryType::Disc;
   entry->compatibility = GameDatabase::CompatibilityRating::Unknown;
 
+  // share the reader between the lookups, so the directories are only read once
+  ISOReader iso;
+  const bool is_iso = iso.Open(cdi.get(), 1);
+
   // try the database first
-  const GameDatabase::Entry* dentry = GameDatabase::GetEntryForDisc(cdi.get());
+  const GameDatabase::Entry* dentry = is_iso ? GameDatabase::GetEntryForDisc(iso) : nullptr;
   if (dentry)
   {
     // pull from database
@@ -227,7 +288,7 @@ bool GameList::GetDiscListEntry(const std::string& path, Entry* entry)
     const std::string display_name(FileSystem::GetDisplayNameFromPath(path));
 
     // no game code, so use the filename title
-    entry->serial = System::GetGameIdFromImage(cdi.get(), true);
+    entry->serial = is_iso ? System::GetGameIdFromImage(iso, true) : std::string();
     entry->title = Path::GetFileTitle(display_name);
     entry->compatibility = GameDatabase::CompatibilityRating::Unknown;
     entry->release_date = 0;
@@ -277,89 +338,83 @@ bool GameList::PopulateEntryFromPath(const std::string& path, Entry* entry)
   return GetDiscListEntry(path, entry);
 }
 
+std::string_view GameList::GetCacheString(const CacheString& str)
+{
+  return std::string_view(s_cache_string_pool + str.offset, str.length);
+}
+
 bool GameList::GetGameListEntryFromCache(const std::string& path, Entry* entry)
 {
-  auto iter = UnorderedStringMapFind(s_cache_map, path);
+  auto iter = s_cache_map.find(path);
   if (iter == s_cache_map.end())
     return false;
 
-  *entry = std::move(iter->second);
+  const CacheRecord& rec = s_cache_records[iter->second];
   s_cache_map.erase(iter);
+
+  entry->type = static_cast<EntryType>(rec.type);
+  entry->region = static_cast<DiscRegion>(rec.region);
+  entry->path = GetCacheString(rec.path);
+  entry->serial = GetCacheString(rec.serial);
+  entry->title = GetCacheString(rec.title);
+  entry->genre = GetCacheString(rec.genre);
+  entry->publisher = GetCacheString(rec.publisher);
+  entry->developer = GetCacheString(rec.developer);
+  entry->total_size = rec.total_size;
+  entry->file_size = rec.file_size;
+  entry->last_modified_time = static_cast<std::time_t>(rec.last_modified_time);
+  entry->release_date = rec.release_date;
+  entry->supported_controllers = rec.supported_controllers;
+  entry->min_players = rec.min_players;
+  entry->max_players = rec.max_players;
+  entry->min_blocks = rec.min_blocks;
+  entry->max_blocks = rec.max_blocks;
+  entry->compatibility = static_cast<GameDatabase::CompatibilityRating>(rec.compatibility);
   return true;
 }
 
-bool GameList::LoadEntriesFromCache(ByteStream* stream)
+bool GameList::ValidateCache(const u8* data, size_t size)
 {
-  u32 file_signature, file_version;
-  if (!stream->ReadU32(&file_signature) || !stream->ReadU32(&file_version) ||
-      file_signature != GAME_LIST_CACHE_SIGNATURE || file_version != GAME_LIST_CACHE_VERSION)
+  CacheHeader header;
+  if (size < sizeof(header))
+    return false;
+
+  std::memcpy(&header, data, sizeof(header));
+  if (header.signature != GAME_LIST_CACHE_SIGNATURE || header.version != GAME_LIST_CACHE_VERSION ||
+      size != (sizeof(header) + static_cast<u64>(header.num_records) * sizeof(CacheRecord) + header.string_pool_size))
   {
     Log_WarningPrintf("Game list cache is corrupted");
     return false;
   }
 
-  while (stream->GetPosition() != stream->GetSize())
+  const CacheRecord* records = reinterpret_cast<const CacheRecord*>(data + sizeof(header));
+  const auto string_valid = [&header](const CacheString& str) {
+    return (str.offset <= header.string_pool_size && str.length <= (header.string_pool_size - str.offset));
+  };
+  for (u32 i = 0; i < header.num_records; i++)
   {
-    std::string path;
-    Entry ge;
-
-    u8 type;
-    u8 region;
-    u8 compatibility_rating;
-
-    if (!stream->ReadU8(&type) || !stream->ReadU8(&region) || !stream->ReadSizePrefixedString(&path) ||
-        !stream->ReadSizePrefixedString(&ge.serial) || !stream->ReadSizePrefixedString(&ge.title) ||
-        !stream->ReadSizePrefixedString(&ge.genre) || !stream->ReadSizePrefixedString(&ge.publisher) ||
-        !stream->ReadSizePrefixedString(&ge.developer) || !stream->ReadU64(&ge.total_size) ||
-        !stream->ReadU64(reinterpret_cast<u64*>(&ge.last_modified_time)) || !stream->ReadU64(&ge.release_date) ||
-        !stream->ReadU32(&ge.supported_controllers) || !stream->ReadU8(&ge.min_players) ||
-        !stream->ReadU8(&ge.max_players) || !stream->ReadU8(&ge.min_blocks) || !stream->ReadU8(&ge.max_blocks) ||
-        !stream->ReadU8(&compatibility_rating) || region >= static_cast<u8>(DiscRegion::Count) ||
-        type >= static_cast<u8>(EntryType::Count) ||
-        compatibility_rating >= static_cast<u8>(GameDatabase::CompatibilityRating::Count))
+    const CacheRecord& rec = records[i];
+    if (!string_valid(rec.path) || !string_valid(rec.serial) || !string_valid(rec.title) ||
+        !string_valid(rec.genre) || !string_valid(rec.publisher) || !string_valid(rec.developer) ||
+        rec.region >= static_cast<u8>(DiscRegion::Count) || rec.type >= static_cast<u8>(EntryType::Count) ||
+        rec.compatibility >= static_cast<u8>(GameDatabase::CompatibilityRating::Count))
     {
       Log_WarningPrintf("Game list cache entry is corrupted");
       return false;
     }
+  }
 
-    ge.path = path;
-    ge.region = static_cast<DiscRegion>(region);
-    ge.type = static_cast<EntryType>(type);
-    ge.compatibility = static_cast<GameDatabase::CompatibilityRating>(compatibility_rating);
+  s_cache_records = records;
+  s_cache_string_pool = reinterpret_cast<const char*>(records + header.num_records);
 
-    auto iter = UnorderedStringMapFind(s_cache_map, ge.path);
-    if (iter != s_cache_map.end())
-      iter->second = std::move(ge);
-    else
-      s_cache_map.emplace(std::move(path), std::move(ge));
-  }
+  // later records replace earlier ones for the same path
+  s_cache_map.reserve(header.num_records);
+  for (u32 i = 0; i < header.num_records; i++)
+    s_cache_map[GetCacheString(records[i].path)] = i;
 
   return true;
 }
 
-bool GameList::WriteEntryToCache(const Entry* entry)
-{
-  bool result = true;
-  result &= s_cache_write_stream->WriteU8(static_cast<u8>(entry->type));
-  result &= s_cache_write_stream->WriteU8(static_cast<u8>(entry->region));
-  result &= s_cache_write_stream->WriteSizePrefixedString(entry->path);
-  result &= s_cache_write_stream->WriteSizePrefixedString(entry->serial);
-  result &= s_cache_write_stream->WriteSizePrefixedString(entry->title);
-  result &= s_cache_write_stream->WriteSizePrefixedString(entry->genre);
-  result &= s_cache_write_stream->WriteSizePrefixedString(entry->publisher);
-  result &= s_cache_write_stream->WriteSizePrefixedString(entry->developer);
-  result &= s_cache_write_stream->WriteU64(entry->total_size);
-  result &= s_cache_write_stream->WriteU64(entry->last_modified_time);
-  result &= s_cache_write_stream->WriteU64(entry->release_date);
-  result &= s_cache_write_stream->WriteU32(entry->supported_controllers);
-  result &= s_cache_write_stream->WriteU8(entry->min_players);
-  result &= s_cache_write_stream->WriteU8(entry->max_players);
-  result &= s_cache_write_stream->WriteU8(entry->min_blocks);
-  result &= s_cache_write_stream->WriteU8(entry->max_blocks);
-  result &= s_cache_write_stream->WriteU8(static_cast<u8>(entry->compatibility));
-  return result;
-}
-
 static std::string GameList::GetCacheFilename()
 {
   return Path::Combine(EmuFolders::Cache, "gamelist.cache");
@@ -368,75 +423,129 @@ static std::string GameList::GetCacheFilename()
 void GameList::LoadCache()
 {
   std::string filename(GetCacheFilename());
-  std::unique_ptr<ByteStream> stream =
-    ByteStream::OpenFile(filename.c_str(), BYTESTREAM_OPEN_READ | BYTESTREAM_OPEN_STREAMED);
-  if (!stream)
+  auto fp = FileSystem::OpenManagedCFile(filename.c_str(), "rb");
+  if (!fp)
     return;
 
-  if (!LoadEntriesFromCache(stream.get()))
+  // map the cache where we can, so only the records of files which are actually found get touched
+  const u8* data;
+  size_t size;
+  if (s_cache_mapping.Map(fp.get()))
+  {
+    data = s_cache_mapping.GetData();
+    size = static_cast<size_t>(s_cache_mapping.GetSize());
+  }
+  else
+  {
+    std::optional<std::vector<u8>> buffer(FileSystem::ReadBinaryFile(fp.get()));
+    if (!buffer.has_value())
+      return;
+
+    s_cache_buffer = std::move(buffer.value());
+    data = s_cache_buffer.data();
+    size = s_cache_buffer.size();
+  }
+  fp.reset();
+
+  if (!ValidateCache(data, size))
   {
     Log_WarningPrintf("Deleting corrupted cache file '%s'", filename.c_str());
-    stream.reset();
-    s_cache_map.clear();
+    CloseCache();
     DeleteCacheFile();
     return;
   }
+
+  Log_DevPrintf("Loaded %zu entries from game list cache", s_cache_map.size());
 }
 
-bool GameList::OpenCacheForWriting()
+void GameList::SaveCache()
 {
-  const std::string cache_filename(GetCacheFilename());
-  Assert(!s_cache_write_stream);
+  std::vector<CacheRecord> records;
+  std::string string_pool;
+  const auto add_string = [&string_pool](const std::string_view& str) {
+    const CacheString ret = {static_cast<u32>(string_pool.size()), static_cast<u32>(str.length())};
+    string_pool.append(str);
+    return ret;
+  };
 
-  s_cache_write_stream = ByteStream::OpenFile(cache_filename.c_str(),
-                                              BYTESTREAM_OPEN_READ | BYTESTREAM_OPEN_WRITE | BYTESTREAM_OPEN_SEEKABLE);
-  if (s_cache_write_stream)
   {
-    // check the header
-    u32 signature, version;
-    if (s_cache_write_stream->ReadU32(&signature) && signature == GAME_LIST_CACHE_SIGNATURE &&
-        s_cache_write_stream->ReadU32(&version) && version == GAME_LIST_CACHE_VERSION &&
-        s_cache_write_stream->SeekToEnd())
+    std::unique_lock lock(s_mutex);
+    records.reserve(s_entries.size() + s_cache_map.size());
+    for (const Entry& entry : s_entries)
     {
-      return true;
+      CacheRecord& rec = records.emplace_back();
+      std::memset(&rec, 0, sizeof(rec));
+      rec.path = add_string(entry.path);
+      rec.serial = add_string(entry.serial);
+      rec.title = add_string(entry.title);
+      rec.genre = add_string(entry.genre);
+      rec.publisher = add_string(entry.publisher);
+      rec.developer = add_string(entry.developer);
+      rec.file_size = entry.file_size;
+      rec.last_modified_time = static_cast<s64>(entry.last_modified_time);
+      rec.total_size = entry.total_size;
+      rec.release_date = entry.release_date;
+      rec.supported_controllers = entry.supported_controllers;
+      rec.type = static_cast<u8>(entry.type);
+      rec.region = static_cast<u8>(entry.region);
+      rec.compatibility = static_cast<u8>(entry.compatibility);
+      rec.min_players = entry.min_players;
+      rec.max_players = entry.max_players;
+      rec.min_blocks = entry.min_blocks;
+      rec.max_blocks = entry.max_blocks;
     }
+  }
 
-    s_cache_write_stream.reset();
+  // keep entries which weren't found this time, the directory may just be unavailable at the moment
+  for (const auto& it : s_cache_map)
+  {
+    CacheRecord& rec = records.emplace_back(s_cache_records[it.second]);
+    rec.path = add_string(GetCacheString(rec.path));
+    rec.serial = add_string(GetCacheString(rec.serial));
+    rec.title = add_string(GetCacheString(rec.title));
+    rec.genre = add_string(GetCacheString(rec.genre));
+    rec.publisher = add_string(GetCacheString(rec.publisher));
+    rec.developer = add_string(GetCacheString(rec.developer));
   }
 
-  Log_InfoPrintf("Creating new game list cache file: '%s'", cache_filename.c_str());
+  // can't replace the file while it's still mapped on Windows
+  CloseCache();
 
-  s_cache_write_stream = ByteStream::OpenFile(
-    cache_filename.c_str(), BYTESTREAM_OPEN_CREATE | BYTESTREAM_OPEN_TRUNCATE | BYTESTREAM_OPEN_WRITE);
-  if (!s_cache_write_stream)
-    return false;
+  const CacheHeader header = {GAME_LIST_CACHE_SIGNATURE, GAME_LIST_CACHE_VERSION, static_cast<u32>(records.size()),
+                              static_cast<u32>(string_pool.size())};
+  std::vector<u8> data(sizeof(header) + records.size() * sizeof(CacheRecord) + string_pool.size());
+  std::memcpy(data.data(), &header, sizeof(header));
+  if (!records.empty())
+    std::memcpy(data.data() + sizeof(header), records.data(), records.size() * sizeof(CacheRecord));
+  if (!string_pool.empty())
+    std::memcpy(data.data() + sizeof(header) + records.size() * sizeof(CacheRecord), string_pool.data(),
+                string_pool.size());
 
-  // new cache file, write header
-  if (!s_cache_write_stream->WriteU32(GAME_LIST_CACHE_SIGNATURE) ||
-      !s_cache_write_stream->WriteU32(GAME_LIST_CACHE_VERSION))
+  // write to a temporary file first, so a crash doesn't leave a truncated cache behind
+  const std::string filename(GetCacheFilename());
+  const std::string temp_filename(filename + ".tmp");
+  if (!FileSystem::WriteBinaryFile(temp_filename.c_str(), data.data(), data.size()) ||
+      !FileSystem::RenamePath(temp_filename.c_str(), filename.c_str()))
   {
-    Log_ErrorPrintf("Failed to write game list cache header");
-    s_cache_write_stream.reset();
-    FileSystem::DeleteFile(cache_filename.c_str());
-    return false;
+    Log_ErrorPrintf("Failed to write game list cache '%s'", filename.c_str());
+    FileSystem::DeleteFile(temp_filename.c_str());
+    return;
   }
 
-  return true;
+  Log_InfoPrintf("Wrote %zu entries to game list cache", records.size());
 }
 
-void GameList::CloseCacheFileStream()
+void GameList::CloseCache()
 {
-  if (!s_cache_write_stream)
-    return;
-
-  s_cache_write_stream->Commit();
-  s_cache_write_stream.reset();
+  s_cache_map.clear();
+  s_cache_records = nullptr;
+  s_cache_string_pool = nullptr;
+  s_cache_mapping.Unmap();
+  s_cache_buffer = {};
 }
 
 void GameList::DeleteCacheFile()
 {
-  Assert(!s_cache_write_stream);
-
   const std::string filename(GetCacheFilename());
   if (!FileSystem::FileExists(filename.c_str()))
     return;
@@ -452,58 +561,138 @@ static bool IsPathExcluded(const std::vector<std::string>& excluded_paths, const
   return (std::find(excluded_paths.begin(), excluded_paths.end(), path) != excluded_paths.end());
 }
 
-void GameList::ScanDirectory(const char* path, bool recursive, bool only_cache,
-                             const std::vector<std::string>& excluded_paths, const PlayedTimeMap& played_time_map,
-                             ProgressCallback* progress)
+void GameList::ParallelFor(u32 count, const std::function<void(u32)>& func, ProgressCallback* progress)
 {
-  Log_InfoPrintf("Scanning %s%s", path, recursive ? " (recursively)" : "");
-
-  progress->SetFormattedStatusText("Scanning directory '%s'%s...", path, recursive ? " (recursively)" : "");
-
-  FileSystem::FindResultsArray files;
-  FileSystem::FindFiles(path, "*",
-                        recursive ? (FILESYSTEM_FIND_FILES | FILESYSTEM_FIND_HIDDEN_FILES | FILESYSTEM_FIND_RECURSIVE) :
-                                    (FILESYSTEM_FIND_FILES | FILESYSTEM_FIND_HIDDEN_FILES),
-                        &files);
-  if (files.empty())
+  progress->SetProgressRange(count);
+  progress->SetProgressValue(0);
+  if (count == 0)
     return;
 
-  progress->PushState();
-  progress->SetProgressRange(static_cast<u32>(files.size()));
-  progress->SetProgressValue(0);
+  const u32 num_threads =
+    std::min(count, std::clamp<u32>(std::thread::hardware_concurrency(), 1u, static_cast<u32>(MAX_SCAN_THREADS)));
+
+  std::atomic<u32> next_index{0};
+  std::atomic<u32> completed{0};
+  std::atomic_bool cancelled{false};
+  std::mutex mutex;
+  std::condition_variable done_cv;
+  u32 threads_running = num_threads;
 
-  u32 files_scanned = 0;
-  for (FILESYSTEM_FIND_DATA& ffd : files)
+  // workers pull the next item when they finish, so a slow file doesn't hold up the rest
+  std::vector<std::thread> threads;
+  threads.reserve(num_threads);
+  for (u32 i = 0; i < num_threads; i++)
   {
-    files_scanned++;
+    threads.emplace_back([count, &func, &next_index, &completed, &cancelled, &mutex, &done_cv, &threads_running]() {
+      while (!cancelled.load())
+      {
+        const u32 index = next_index.fetch_add(1);
+        if (index >= count)
+          break;
+
+        func(index);
+        completed.fetch_add(1);
+      }
 
-    if (progress->IsCancelled() || !GameList::IsScannableFilename(ffd.FileName) ||
-        IsPathExcluded(excluded_paths, ffd.FileName))
+      std::unique_lock lock(mutex);
+      threads_running--;
+      done_cv.notify_one();
+    });
+  }
+
+  // progress callbacks aren't thread safe, so only touch it from here
+  {
+    std::unique_lock lock(mutex);
+    while (threads_running > 0)
     {
-      continue;
+      done_cv.wait_for(lock, std::chrono::milliseconds(SCAN_PROGRESS_UPDATE_INTERVAL_MS));
+
+      lock.unlock();
+      progress->SetProgressValue(completed.load());
+      if (progress->IsCancelled())
+        cancelled.store(true);
+      lock.lock();
     }
+  }
 
+  for (std::thread& thread : threads)
+    thread.join();
+
+  progress->SetProgressValue(completed.load());
+}
+
+void GameList::ScanDirectories(const std::vector<std::string>& dirs, const std::vector<std::string>& recursive_dirs,
+                               bool only_cache, const std::vector<std::string>& excluded_paths,
+                               const PlayedTimeMap& played_time_map, ProgressCallback* progress)
+{
+  const u32 num_dirs = static_cast<u32>(dirs.size() + recursive_dirs.size());
+  std::vector<FileSystem::FindResultsArray> dir_files(num_dirs);
+
+  progress->SetStatusText("Scanning directories...");
+  ParallelFor(
+    num_dirs,
+    [&dirs, &recursive_dirs, &dir_files](u32 index) {
+      const bool recursive = (index >= dirs.size());
+      const std::string& path = recursive ? recursive_dirs[index - dirs.size()] : dirs[index];
+      Log_InfoPrintf("Scanning %s%s", path.c_str(), recursive ? " (recursively)" : "");
+
+      FileSystem::FindFiles(path.c_str(), "*",
+                            recursive ?
+                              (FILESYSTEM_FIND_FILES | FILESYSTEM_FIND_HIDDEN_FILES | FILESYSTEM_FIND_RECURSIVE) :
+                              (FILESYSTEM_FIND_FILES | FILESYSTEM_FIND_HIDDEN_FILES),
+                            &dir_files[index]);
+    },
+    progress);
+  if (progress->IsCancelled())
+    return;
+
+  // cached entries are cheap, so pick those up first, and only open what's new or changed
+  FileSystem::FindResultsArray files_to_scan;
+  {
+    UnorderedStringSet queued_paths;
     std::unique_lock lock(s_mutex);
-    if (GetEntryForPath(ffd.FileName.c_str()) ||
-        AddFileFromCache(ffd.FileName, ffd.ModificationTime, played_time_map) || only_cache)
+    for (FileSystem::FindResultsArray& files : dir_files)
     {
-      continue;
-    }
+      for (FILESYSTEM_FIND_DATA& ffd : files)
+      {
+        if (!GameList::IsScannableFilename(ffd.FileName) || IsPathExcluded(excluded_paths, ffd.FileName) ||
+            GetEntryForPath(ffd.FileName.c_str()) ||
+            AddFileFromCache(ffd.FileName, ffd.ModificationTime, static_cast<u64>(ffd.Size), played_time_map) ||
+            only_cache ||
+            !queued_paths.insert(ffd.FileName).second)
+        {
+          continue;
+        }
 
-    progress->SetFormattedStatusText("Scanning '%s'...", FileSystem::GetDisplayNameFromPath(ffd.FileName).c_str());
-    ScanFile(std::move(ffd.FileName), ffd.ModificationTime, lock, played_time_map);
-    progress->SetProgressValue(files_scanned);
+        files_to_scan.push_back(std::move(ffd));
+      }
+    }
   }
+  if (files_to_scan.empty())
+    return;
 
-  progress->SetProgressValue(files_scanned);
-  progress->PopState();
+  // the database isn't safe to lazily load from multiple threads
+  GameDatabase::EnsureLoaded();
+
+  progress->SetFormattedStatusText("Scanning %zu files...", files_to_scan.size());
+  ParallelFor(
+    static_cast<u32>(files_to_scan.size()),
+    [&files_to_scan, &played_time_map](u32 index) {
+      FILESYSTEM_FIND_DATA& ffd = files_to_scan[index];
+      ScanFile(std::move(ffd.FileName), ffd.ModificationTime, static_cast<u64>(ffd.Size), played_time_map);
+    },
+    progress);
 }
 
-bool GameList::AddFileFromCache(const std::string& path, std::time_t timestamp, const PlayedTimeMap& played_time_map)
+bool GameList::AddFileFromCache(const std::string& path, std::time_t timestamp, u64 file_size,
+                                const PlayedTimeMap& played_time_map)
 {
   Entry entry;
-  if (!GetGameListEntryFromCache(path, &entry) || entry.last_modified_time != timestamp)
+  if (!GetGameListEntryFromCache(path, &entry) || entry.last_modified_time != timestamp ||
+      entry.file_size != file_size)
+  {
     return false;
+  }
 
   auto iter = UnorderedStringMapFind(played_time_map, entry.serial);
   if (iter != played_time_map.end())
@@ -516,12 +705,9 @@ bool GameList::AddFileFromCache(const std::string& path, std::time_t timestamp,
   return true;
 }
 
-bool GameList::ScanFile(std::string path, std::time_t timestamp, std::unique_lock<std::recursive_mutex>& lock,
-                        const PlayedTimeMap& played_time_map)
+bool GameList::ScanFile(std::string path, std::time_t timestamp, u64 file_size, const PlayedTimeMap& played_time_map)
 {
-  // don't block UI while scanning
-  lock.unlock();
-
+  // called from the scan threads, only take the lock once the entry is ready
   Log_DevPrintf("Scanning '%s'...", path.c_str());
 
   Entry entry;
@@ -529,14 +715,9 @@ bool GameList::ScanFile(std::string path, std::time_t timestamp, std::unique_loc
     return false;
 
   entry.path = std::move(path);
+  entry.file_size = file_size;
   entry.last_modified_time = timestamp;
 
-  if (s_cache_write_stream || OpenCacheForWriting())
-  {
-    if (!WriteEntryToCache(&entry))
-      Log_WarningPrintf("Failed to write entry '%s' to cache", entry.path.c_str());
-  }
-
   auto iter = UnorderedStringMapFind(played_time_map, entry.serial);
   if (iter != played_time_map.end())
   {
@@ -544,7 +725,8 @@ bool GameList::ScanFile(std::string path, std::time_t timestamp, std::unique_loc
     entry.total_played_time = iter->second.total_played_time;
   }
 
-  lock.lock();
+  std::unique_lock lock(s_mutex);
+  s_cache_dirty = true;
   s_entries.push_back(std::move(entry));
   return true;
 }
@@ -615,33 +797,18 @@ void GameList::Refresh(bool invalidate_cache, bool only_cache, ProgressCallback*
   const PlayedTimeMap played_time(LoadPlayedTimeMap(GetPlayedTimeFile()));
 
   if (!dirs.empty() || !recursive_dirs.empty())
-  {
-    progress->SetProgressRange(static_cast<u32>(dirs.size() + recursive_dirs.size()));
-    progress->SetProgressValue(0);
-
-    // we manually count it here, because otherwise pop state updates it itself
-    int directory_counter = 0;
-    for (const std::string& dir : dirs)
-    {
-      if (progress->IsCancelled())
-        break;
-
-      ScanDirectory(dir.c_str(), false, only_cache, excluded_paths, played_time, progress);
-      progress->SetProgressValue(++directory_counter);
-    }
-    for (const std::string& dir : recursive_dirs)
-    {
-      if (progress->IsCancelled())
-        break;
+    ScanDirectories(dirs, recursive_dirs, only_cache, excluded_paths, played_time, progress);
 
-      ScanDirectory(dir.c_str(), true, only_cache, excluded_paths, played_time, progress);
-      progress->SetProgressValue(++directory_counter);
-    }
+  // only rewrite the cache when something had to be scanned
+  if (s_cache_dirty)
+  {
+    SaveCache();
+    s_cache_dirty = false;
+  }
+  else
+  {
+    CloseCache();
   }
-
-  // don't need unused cache entries
-  CloseCacheFileStream();
-  s_cache_map.clear();
 }
 
 std::string GameList::GetCoverImagePathForEntry(const Entry* entry)
@@ -1015,7 +1182,8 @@ TinyString GameList::FormatTimespan(std::time_t timespan, bool long_format)
 }
 
 bool GameList::DownloadCovers(const std::vector<std::string>& url_templates, bool use_serial,
-                              ProgressCallback* progress, std::function<void(const Entry*, std::string)> save_callback)
+                              ProgressCallback* progress, std::function<void(const Entry*, std::string)> save_callback,
+                              u32 max_concurrent_downloads)
 {
   if (!progress)
     progress = ProgressCallback::NullProgressCallback;
@@ -1038,7 +1206,14 @@ bool GameList::DownloadCovers(const std::vector<std::string>& url_templates, boo
     return false;
   }
 
-  std::vector<std::pair<std::string, std::string>> download_urls;
+  struct CoverDownload
+  {
+    std::string entry_path;
+    std::vector<std::string> urls;
+    size_t next_url;
+  };
+
+  std::vector<CoverDownload> downloads;
   {
     std::unique_lock lock(s_mutex);
     for (const GameList::Entry& entry : s_entries)
@@ -1047,6 +1222,9 @@ bool GameList::DownloadCovers(const std::vector<std::string>& url_templates, boo
       if (!existing_path.empty())
         continue;
 
+      CoverDownload& dl = downloads.emplace_back();
+      dl.entry_path = entry.path;
+      dl.next_url = 0;
       for (const std::string& url_template : url_templates)
       {
         std::string url(url_template);
@@ -1061,11 +1239,11 @@ bool GameList::DownloadCovers(const std::vector<std::string>& url_templates, boo
         if (has_serial)
           StringUtil::ReplaceAll(&url, "${serial}", Common::HTTPDownloader::URLEncode(entry.serial));
 
-        download_urls.emplace_back(entry.path, std::move(url));
+        dl.urls.push_back(std::move(url));
       }
     }
   }
-  if (download_urls.empty())
+  if (downloads.empty())
   {
     progress->DisplayError("No URLs to download enumerated.");
     return false;
@@ -1078,64 +1256,108 @@ bool GameList::DownloadCovers(const std::vector<std::string>& url_templates, boo
     return false;
   }
 
+  const u32 max_active_downloads = std::max<u32>(max_concurrent_downloads, 1);
+  downloader->SetMaxActiveRequests(max_active_downloads);
+
   progress->SetCancellable(true);
-  progress->SetProgressRange(static_cast<u32>(download_urls.size()));
+  progress->SetProgressRange(static_cast<u32>(downloads.size()));
 
-  for (auto& [entry_path, url] : download_urls)
-  {
-    if (progress->IsCancelled())
-      break;
+  // Completion callbacks run on this thread from PollRequests(), so the bookkeeping below doesn't need locking.
+  // An entry only moves on to its next URL template when the previous one failed.
+  std::vector<size_t> retry_queue;
+  size_t next_download = 0;
+  u32 active_downloads = 0;
 
-    // make sure it didn't get done already
+  for (;;)
+  {
+    while (!progress->IsCancelled() && active_downloads < max_active_downloads &&
+           (!retry_queue.empty() || next_download < downloads.size()))
     {
-      std::unique_lock lock(s_mutex);
-      const GameList::Entry* entry = GetEntryForPath(entry_path.c_str());
-      if (!entry || !GetCoverImagePathForEntry(entry).empty())
+      size_t index;
+      if (!retry_queue.empty())
       {
-        progress->IncrementProgressValue();
-        continue;
+        index = retry_queue.back();
+        retry_queue.pop_back();
+      }
+      else
+      {
+        index = next_download++;
       }
 
-      progress->SetFormattedStatusText("Downloading cover for %s...", entry->title.c_str());
-    }
-
-    // we could actually do a few in parallel here...
-    std::string filename(Common::HTTPDownloader::URLDecode(url));
-    downloader->CreateRequest(
-      std::move(url), [use_serial, &save_callback, entry_path = std::move(entry_path), filename = std::move(filename)](
-                        s32 status_code, std::string content_type, Common::HTTPDownloader::Request::Data data) {
-        if (status_code != Common::HTTPDownloader::HTTP_OK || data.empty())
-          return;
+      CoverDownload& dl = downloads[index];
 
+      // make sure it didn't get done already
+      {
         std::unique_lock lock(s_mutex);
-        const GameList::Entry* entry = GetEntryForPath(entry_path.c_str());
+        const GameList::Entry* entry = GetEntryForPath(dl.entry_path.c_str());
         if (!entry || !GetCoverImagePathForEntry(entry).empty())
-          return;
-
-        // prefer the content type from the response for the extension
-        // otherwise, if it's missing, and the request didn't have an extension.. fall back to jpegs.
-        std::string template_filename;
-        std::string content_type_extension(Common::HTTPDownloader::GetExtensionForContentType(content_type));
-
-        // don't treat the domain name as an extension..
-        const std::string::size_type last_slash = filename.find('/');
-        const std::string::size_type last_dot = filename.find('.');
-        if (!content_type_extension.empty())
-          template_filename = fmt::format("cover.{}", content_type_extension);
-        else if (last_slash != std::string::npos && last_dot != std::string::npos && last_dot > last_slash)
-          template_filename = Path::GetFileName(filename);
-        else
-          template_filename = "cover.jpg";
-
-        std::string write_path(GetNewCoverImagePathForEntry(entry, template_filename.c_str(), use_serial));
-        if (write_path.empty())
-          return;
-
-        if (FileSystem::WriteBinaryFile(write_path.c_str(), data.data(), data.size()) && save_callback)
-          save_callback(entry, std::move(write_path));
-      });
-    downloader->WaitForAllRequests();
-    progress->IncrementProgressValue();
+        {
+          progress->IncrementProgressValue();
+          continue;
+        }
+
+        progress->SetFormattedStatusText("Downloading cover for %s...", entry->title.c_str());
+      }
+
+      std::string url(dl.urls[dl.next_url++]);
+      std::string filename(Common::HTTPDownloader::URLDecode(url));
+      active_downloads++;
+      downloader->CreateRequest(
+        std::move(url), [use_serial, &save_callback, &downloads, &retry_queue, &active_downloads, progress, index,
+                         filename = std::move(filename)](s32 status_code, std::string content_type,
+                                                         Common::HTTPDownloader::Request::Data data) {
+          active_downloads--;
+
+          const CoverDownload& dl = downloads[index];
+          if (status_code != Common::HTTPDownloader::HTTP_OK || data.empty())
+          {
+            if (dl.next_url < dl.urls.size())
+              retry_queue.push_back(index);
+            else
+              progress->IncrementProgressValue();
+
+            return;
+          }
+
+          progress->IncrementProgressValue();
+
+          std::unique_lock lock(s_mutex);
+          const GameList::Entry* entry = GetEntryForPath(dl.entry_path.c_str());
+          if (!entry || !GetCoverImagePathForEntry(entry).empty())
+            return;
+
+          // prefer the content type from the response for the extension
+          // otherwise, if it's missing, and the request didn't have an extension.. fall back to jpegs.
+          std::string template_filename;
+          std::string content_type_extension(Common::HTTPDownloader::GetExtensionForContentType(content_type));
+
+          // don't treat the domain name as an extension..
+          const std::string::size_type last_slash = filename.find('/');
+          const std::string::size_type last_dot = filename.find('.');
+          if (!content_type_extension.empty())
+            template_filename = fmt::format("cover.{}", content_type_extension);
+          else if (last_slash != std::string::npos && last_dot != std::string::npos && last_dot > last_slash)
+            template_filename = Path::GetFileName(filename);
+          else
+            template_filename = "cover.jpg";
+
+          std::string write_path(GetNewCoverImagePathForEntry(entry, template_filename.c_str(), use_serial));
+          if (write_path.empty())
+            return;
+
+          if (FileSystem::WriteBinaryFile(write_path.c_str(), data.data(), data.size()) && save_callback)
+            save_callback(entry, std::move(write_path));
+        });
+    }
+
+    if (active_downloads == 0)
+      break;
+
+    // don't spin while waiting for the transfers
+    const u32 prev_active_downloads = active_downloads;
+    downloader->PollRequests();
+    if (active_downloads == prev_active_downloads)
+      Common::Timer::NanoSleep(1000000);
   }
 
   return true;
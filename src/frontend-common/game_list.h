@@ -38,6 +38,7 @@ struct Entry
   std::string publisher;
   std::string developer;
   u64 total_size = 0;
+  u64 file_size = 0;
   std::time_t last_modified_time = 0;
   std::time_t last_played_time = 0;
   std::time_t total_played_time = 0;
@@ -96,11 +97,16 @@ std::string GetCoverImagePathForEntry(const Entry* entry);
 std::string GetCoverImagePath(const std::string& path, const std::string& serial, const std::string& title);
 std::string GetNewCoverImagePathForEntry(const Entry* entry, const char* new_filename, bool use_serial);
 
+/// Number of cover requests kept in flight by DownloadCovers() unless otherwise specified.
+static constexpr u32 DEFAULT_COVER_DOWNLOAD_CONCURRENCY = 8;
+
 /// Downloads covers using the specified URL templates. By default, covers are saved by title, but this can be changed
 /// with the use_serial parameter. save_callback optionall takes the entry and the path the new cover is saved to.
+/// Up to max_concurrent_downloads covers are fetched at once; each entry tries the templates in order until one hits.
 bool DownloadCovers(const std::vector<std::string>& url_templates, bool use_serial = false,
                     ProgressCallback* progress = nullptr,
-                    std::function<void(const Entry*, std::string)> save_callback = {});
+                    std::function<void(const Entry*, std::string)> save_callback = {},
+                    u32 max_concurrent_downloads = DEFAULT_COVER_DOWNLOAD_CONCURRENCY);
 }; // namespace GameList
 
 namespace Host {
@@ -8,6 +8,7 @@
 #include "common/assert.h"
 #include "common/easing.h"
 #include "common/file_system.h"
+#include "common/heterogeneous_containers.h"
 #include "common/image.h"
 #include "common/log.h"
 #include "common/lru_cache.h"
@@ -21,6 +22,7 @@
 #include "imgui_internal.h"
 #include "imgui_stdlib.h"
 
+#include <algorithm>
 #include <array>
 #include <cmath>
 #include <condition_variable>
@@ -37,6 +39,8 @@ using MessageDialogCallbackVariant = std::variant<InfoMessageDialogCallback, Con
 static std::optional<Common::RGBA8Image> LoadTextureImage(const char* path);
 static std::shared_ptr<GPUTexture> UploadTexture(const char* path, const Common::RGBA8Image& image);
 static void TextureLoaderThread();
+static void CancelStaleTextureLoads();
+static void EvictTexturesOverBudget();
 
 static void DrawFileSelector();
 static void DrawChoiceDialog();
@@ -81,14 +85,36 @@ static u32 s_menu_button_index = 0;
 static u32 s_close_button_state = 0;
 static bool s_focus_reset_queued = false;
 
+namespace {
+struct TextureLoadRequest
+{
+  u64 last_request_frame;
+  bool in_progress;
+};
+} // namespace
+
+/// Maximum number of worker threads decoding textures in the background.
+static constexpr u32 MAX_TEXTURE_LOAD_THREADS = 4;
+
+/// Pending loads which have not been requested for this many frames are dropped, i.e. scrolled off-screen.
+static constexpr u64 TEXTURE_LOAD_CANCEL_FRAMES = 2;
+
+/// Largest size, in layout units, that asynchronously loaded images are displayed at. Anything bigger is downscaled.
+static constexpr float LAYOUT_ASYNC_TEXTURE_MAX_SIZE = 400.0f;
+
+/// Upper bound on the GPU memory used by cached textures, excluding the placeholder.
+static constexpr u64 TEXTURE_CACHE_VRAM_BUDGET = 64 * 1024 * 1024;
+
 static LRUCache<std::string, std::shared_ptr<GPUTexture>> s_texture_cache(128, true);
 static std::shared_ptr<GPUTexture> s_placeholder_texture;
 static std::atomic_bool s_texture_load_thread_quit{false};
+static std::atomic<u32> s_texture_load_max_size{0};
 static std::mutex s_texture_load_mutex;
 static std::condition_variable s_texture_load_cv;
-static std::deque<std::string> s_texture_load_queue;
+static StringMap<TextureLoadRequest> s_texture_load_requests;
 static std::deque<std::pair<std::string, Common::RGBA8Image>> s_texture_upload_queue;
-static std::thread s_texture_load_thread;
+static std::vector<std::thread> s_texture_load_threads;
+static u64 s_texture_load_frame = 0;
 
 static bool s_choice_dialog_open = false;
 static bool s_choice_dialog_checkable = false;
@@ -189,22 +215,31 @@ bool ImGuiFullscreen::Initialize(const char* placeholder_image_path)
   }
 
   s_texture_load_thread_quit.store(false, std::memory_order_release);
-  s_texture_load_thread = std::thread(TextureLoaderThread);
+  s_texture_load_max_size.store(0, std::memory_order_release);
+  s_texture_load_frame = 0;
+
+  const u32 num_threads = std::clamp(std::thread::hardware_concurrency() / 2, 1u, MAX_TEXTURE_LOAD_THREADS);
+  for (u32 i = 0; i < num_threads; i++)
+    s_texture_load_threads.emplace_back(TextureLoaderThread);
+
   return true;
 }
 
 void ImGuiFullscreen::Shutdown()
 {
-  if (s_texture_load_thread.joinable())
+  if (!s_texture_load_threads.empty())
   {
     {
       std::unique_lock lock(s_texture_load_mutex);
       s_texture_load_thread_quit.store(true, std::memory_order_release);
-      s_texture_load_cv.notify_one();
+      s_texture_load_cv.notify_all();
     }
-    s_texture_load_thread.join();
+    for (std::thread& thread : s_texture_load_threads)
+      thread.join();
+    s_texture_load_threads.clear();
   }
 
+  s_texture_load_requests.clear();
   s_texture_upload_queue.clear();
   s_placeholder_texture.reset();
   g_standard_font = nullptr;
@@ -313,10 +348,26 @@ GPUTexture* ImGuiFullscreen::GetCachedTextureAsync(const std::string_view& name)
     // insert the placeholder
     tex_ptr = s_texture_cache.Insert(std::string(name), s_placeholder_texture);
 
-    // queue the actual load
+    // queue the actual load, or bump the priority if it's already pending
     std::unique_lock lock(s_texture_load_mutex);
-    s_texture_load_queue.emplace_back(name);
-    s_texture_load_cv.notify_one();
+    auto iter = s_texture_load_requests.find(name);
+    if (iter != s_texture_load_requests.end())
+    {
+      iter->second.last_request_frame = s_texture_load_frame;
+    }
+    else
+    {
+      s_texture_load_requests.emplace(std::string(name), TextureLoadRequest{s_texture_load_frame, false});
+      s_texture_load_cv.notify_one();
+    }
+  }
+  else if (tex_ptr->get() == s_placeholder_texture.get())
+  {
+    // still visible, so keep it at the front of the queue
+    std::unique_lock lock(s_texture_load_mutex);
+    auto iter = s_texture_load_requests.find(name);
+    if (iter != s_texture_load_requests.end())
+      iter->second.last_request_frame = s_texture_load_frame;
   }
 
   return tex_ptr->get();
@@ -329,6 +380,13 @@ bool ImGuiFullscreen::InvalidateCachedTexture(const std::string& path)
 
 void ImGuiFullscreen::UploadAsyncTextures()
 {
+  // decode at the size we'll actually be drawing at, no point keeping 4K scans of covers around
+  s_texture_load_max_size.store(static_cast<u32>(std::ceil(LayoutScale(LAYOUT_ASYNC_TEXTURE_MAX_SIZE))),
+                                std::memory_order_release);
+
+  CancelStaleTextureLoads();
+  s_texture_load_frame++;
+
   std::unique_lock lock(s_texture_load_mutex);
   while (!s_texture_upload_queue.empty())
   {
@@ -344,37 +402,101 @@ void ImGuiFullscreen::UploadAsyncTextures()
   }
 }
 
+void ImGuiFullscreen::CancelStaleTextureLoads()
+{
+  std::unique_lock lock(s_texture_load_mutex);
+  for (auto iter = s_texture_load_requests.begin(); iter != s_texture_load_requests.end();)
+  {
+    if (iter->second.in_progress ||
+        (iter->second.last_request_frame + TEXTURE_LOAD_CANCEL_FRAMES) > s_texture_load_frame)
+    {
+      ++iter;
+      continue;
+    }
+
+    // drop the placeholder too, so it gets queued again when it comes back on screen
+    std::shared_ptr<GPUTexture>* tex_ptr = s_texture_cache.Lookup(iter->first);
+    if (tex_ptr && tex_ptr->get() == s_placeholder_texture.get())
+      s_texture_cache.Remove(iter->first);
+
+    iter = s_texture_load_requests.erase(iter);
+  }
+}
+
+void ImGuiFullscreen::EvictTexturesOverBudget()
+{
+  for (;;)
+  {
+    u64 total_size = 0;
+    s_texture_cache.ForEachValue([&total_size](const std::shared_ptr<GPUTexture>& tex) {
+      if (tex && tex != s_placeholder_texture)
+        total_size += static_cast<u64>(tex->GetWidth()) * tex->GetHeight() * tex->GetPixelSize();
+    });
+
+    if (total_size <= TEXTURE_CACHE_VRAM_BUDGET || s_texture_cache.GetSize() <= 1)
+      break;
+
+    s_texture_cache.Evict();
+  }
+}
+
 void ImGuiFullscreen::TextureLoaderThread()
 {
   Threading::SetNameOfCurrentThread("ImGuiFullscreen Texture Loader");
+  Threading::ApplyAffinityPolicy(Threading::AffinityClass::Background);
 
   std::unique_lock lock(s_texture_load_mutex);
 
   for (;;)
   {
-    s_texture_load_cv.wait(lock, []() {
-      return (s_texture_load_thread_quit.load(std::memory_order_acquire) || !s_texture_load_queue.empty());
+    // most recently requested first, that's whatever is currently on screen
+    auto next = s_texture_load_requests.end();
+    s_texture_load_cv.wait(lock, [&next]() {
+      if (s_texture_load_thread_quit.load(std::memory_order_acquire))
+        return true;
+
+      next = s_texture_load_requests.end();
+      for (auto iter = s_texture_load_requests.begin(); iter != s_texture_load_requests.end(); ++iter)
+      {
+        if (!iter->second.in_progress &&
+            (next == s_texture_load_requests.end() ||
+             iter->second.last_request_frame > next->second.last_request_frame))
+        {
+          next = iter;
+        }
+      }
+
+      return (next != s_texture_load_requests.end());
     });
 
     if (s_texture_load_thread_quit.load(std::memory_order_acquire))
       break;
 
-    while (!s_texture_load_queue.empty())
+    // map iterators stay valid while in_progress is set, since nothing else erases in-progress requests
+    next->second.in_progress = true;
+    const std::string& path = next->first;
+    const u32 max_size = s_texture_load_max_size.load(std::memory_order_acquire);
+
+    lock.unlock();
+    std::optional<Common::RGBA8Image> image(LoadTextureImage(path.c_str()));
+    if (image.has_value() && max_size > 0 && (image->GetWidth() > max_size || image->GetHeight() > max_size))
     {
-      std::string path(std::move(s_texture_load_queue.front()));
-      s_texture_load_queue.pop_front();
+      const float scale =
+        static_cast<float>(max_size) / static_cast<float>(std::max(image->GetWidth(), image->GetHeight()));
+      const u32 new_width = std::max(static_cast<u32>(static_cast<float>(image->GetWidth()) * scale), 1u);
+      const u32 new_height = std::max(static_cast<u32>(static_cast<float>(image->GetHeight()) * scale), 1u);
+      Log_DevPrintf("Downscaling '%s' from %ux%u to %ux%u", path.c_str(), image->GetWidth(), image->GetHeight(),
+                    new_width, new_height);
+      image->Resize(new_width, new_height);
+    }
+    lock.lock();
 
-      lock.unlock();
-      std::optional<Common::RGBA8Image> image(LoadTextureImage(path.c_str()));
-      lock.lock();
+    // don't bother queuing back if it doesn't exist
+    if (image.has_value())
+      s_texture_upload_queue.emplace_back(path, std::move(image.value()));
 
-      // don't bother queuing back if it doesn't exist
-      if (image)
-        s_texture_upload_queue.emplace_back(std::move(path), std::move(image.value()));
-    }
+    s_texture_load_requests.erase(next);
   }
-
-  s_texture_load_queue.clear();
 }
 
 bool ImGuiFullscreen::UpdateLayoutScale()
@@ -443,6 +565,7 @@ void ImGuiFullscreen::BeginLayout()
   // we evict from the texture cache at the start of the frame, in case we go over mid-frame,
   // we need to keep all those textures alive until the end of the frame
   s_texture_cache.ManualEvict();
+  EvictTexturesOverBudget();
   PushResetLayout();
 }
 
@@ -6,12 +6,14 @@
 #include "common/assert.h"
 #include "common/file_system.h"
 #include "common/log.h"
+#include "common/path.h"
 #include "common/string_util.h"
 #include "common/timer.h"
 #include "common_host.h"
 #include "core/gpu.h"
 #include "core/host.h"
 #include "core/host_display.h"
+#include "core/settings.h"
 #include "core/system.h"
 #include "fmt/format.h"
 #include "fullscreen_ui.h"
@@ -19,6 +21,7 @@
 #include "imgui_fullscreen.h"
 #include "imgui_internal.h"
 #include "input_manager.h"
+#include "xxhash.h"
 #include <atomic>
 #include <chrono>
 #include <cmath>
@@ -36,6 +39,10 @@ static bool AddImGuiFonts(bool fullscreen_fonts);
 static ImFont* AddTextFont(float size);
 static ImFont* AddFixedFont(float size);
 static bool AddIconFonts(float size);
+static u64 GetFontAtlasCacheKey();
+static std::string GetFontAtlasCachePath(u64 key);
+static bool LoadFontAtlasCache(u64 key);
+static void SaveFontAtlasCache(u64 key);
 static void AcquirePendingOSDMessages();
 static void DrawOSDMessages();
 } // namespace ImGuiManager
@@ -54,6 +61,37 @@ static std::vector<u8> s_standard_font_data;
 static std::vector<u8> s_fixed_font_data;
 static std::vector<u8> s_icon_font_data;
 
+/// How long the UI keeps being redrawn every frame after the last input, so transitions can finish.
+static constexpr double UI_IDLE_TIMEOUT = 1.0;
+static std::atomic<Common::Timer::Value> s_last_ui_activity_time{0};
+static u64 s_font_data_hash = 0;
+
+// Baked font atlases are cached on disk, since rasterizing large glyph ranges takes a while.
+static constexpr u32 FONT_ATLAS_CACHE_SIGNATURE = 0x46434944; // DICF
+static constexpr u32 FONT_ATLAS_CACHE_VERSION = 1;
+
+namespace {
+#pragma pack(push, 1)
+struct FontAtlasCacheHeader
+{
+  u32 signature;
+  u32 version;
+  u64 key;
+  u32 tex_width;
+  u32 tex_height;
+  u32 num_custom_rects;
+  u32 num_fonts;
+};
+
+struct FontAtlasCacheFont
+{
+  float ascent;
+  float descent;
+  u32 num_glyphs;
+};
+#pragma pack(pop)
+} // namespace
+
 static Common::Timer s_last_render_time;
 
 // cached copies of WantCaptureKeyboard/Mouse, used to know when to dispatch events
@@ -151,6 +189,8 @@ void ImGuiManager::Shutdown()
 
 void ImGuiManager::WindowResized()
 {
+  NotifyUIActivity();
+
   const u32 new_width = g_host_display ? g_host_display->GetWindowWidth() : 0;
   const u32 new_height = g_host_display ? g_host_display->GetWindowHeight() : 0;
 
@@ -419,6 +459,9 @@ bool ImGuiManager::LoadFontData()
     s_icon_font_data = std::move(font_data.value());
   }
 
+  s_font_data_hash = XXH64(s_standard_font_data.data(), s_standard_font_data.size(), 0);
+  s_font_data_hash = XXH64(s_fixed_font_data.data(), s_fixed_font_data.size(), s_font_data_hash);
+  s_font_data_hash = XXH64(s_icon_font_data.data(), s_icon_font_data.size(), s_font_data_hash);
   return true;
 }
 
@@ -522,7 +565,192 @@ bool ImGuiManager::AddImGuiFonts(bool fullscreen_fonts)
 
   ImGuiFullscreen::SetFonts(s_standard_font, s_medium_font, s_large_font);
 
-  return io.Fonts->Build();
+  const u64 cache_key = GetFontAtlasCacheKey();
+  if (LoadFontAtlasCache(cache_key))
+    return true;
+
+  if (!io.Fonts->Build())
+    return false;
+
+  SaveFontAtlasCache(cache_key);
+  return true;
+}
+
+u64 ImGuiManager::GetFontAtlasCacheKey()
+{
+  const ImFontAtlas* atlas = ImGui::GetIO().Fonts;
+
+  std::vector<u8> key_data;
+  const auto append = [&key_data](const auto& value) {
+    const u8* ptr = reinterpret_cast<const u8*>(&value);
+    key_data.insert(key_data.end(), ptr, ptr + sizeof(value));
+  };
+
+  append(FONT_ATLAS_CACHE_VERSION);
+  append(IMGUI_VERSION_NUM);
+  append(s_font_data_hash);
+  append(atlas->Flags);
+  append(atlas->TexDesiredWidth);
+  append(atlas->TexGlyphPadding);
+  for (const ImFontConfig& cfg : atlas->ConfigData)
+  {
+    append(cfg.FontDataSize);
+    append(cfg.FontNo);
+    append(cfg.SizePixels);
+    append(cfg.OversampleH);
+    append(cfg.OversampleV);
+    append(cfg.PixelSnapH);
+    append(cfg.GlyphExtraSpacing);
+    append(cfg.GlyphOffset);
+    append(cfg.GlyphMinAdvanceX);
+    append(cfg.GlyphMaxAdvanceX);
+    append(cfg.MergeMode);
+    append(cfg.FontBuilderFlags);
+    append(cfg.RasterizerMultiply);
+    append(atlas->Fonts.index_from_ptr(atlas->Fonts.find(cfg.DstFont)));
+    for (const ImWchar* range = cfg.GlyphRanges; range && *range != 0; range++)
+      append(*range);
+    append(static_cast<ImWchar>(0));
+  }
+
+  return XXH64(key_data.data(), key_data.size(), 0);
+}
+
+std::string ImGuiManager::GetFontAtlasCachePath(u64 key)
+{
+  return Path::Combine(EmuFolders::Cache, fmt::format("fontatlas_{:016X}.cache", key));
+}
+
+bool ImGuiManager::LoadFontAtlasCache(u64 key)
+{
+  if (EmuFolders::Cache.empty())
+    return false;
+
+  std::optional<std::vector<u8>> data = FileSystem::ReadBinaryFile(GetFontAtlasCachePath(key).c_str());
+  if (!data.has_value())
+    return false;
+
+  size_t offset = 0;
+  const auto read = [&data, &offset](void* dst, size_t size) {
+    if ((data->size() - offset) < size)
+      return false;
+
+    std::memcpy(dst, data->data() + offset, size);
+    offset += size;
+    return true;
+  };
+
+  ImFontAtlas* atlas = ImGui::GetIO().Fonts;
+  ImFontAtlasBuildInit(atlas);
+
+  FontAtlasCacheHeader header;
+  if (!read(&header, sizeof(header)) || header.signature != FONT_ATLAS_CACHE_SIGNATURE ||
+      header.version != FONT_ATLAS_CACHE_VERSION || header.key != key || header.tex_width == 0 ||
+      header.tex_height == 0 || header.num_custom_rects != static_cast<u32>(atlas->CustomRects.Size) ||
+      header.num_fonts != static_cast<u32>(atlas->Fonts.Size))
+  {
+    Log_WarningPrintf("Font atlas cache for %016llX is out of date.", static_cast<unsigned long long>(key));
+    return false;
+  }
+
+  // read everything before touching the atlas, so a bad file leaves it ready to build
+  std::vector<std::pair<u16, u16>> rects(header.num_custom_rects);
+  std::vector<FontAtlasCacheFont> fonts(header.num_fonts);
+  std::vector<std::vector<ImFontGlyph>> glyphs(header.num_fonts);
+  if (!read(rects.data(), rects.size() * sizeof(rects[0])))
+    return false;
+  for (u32 i = 0; i < header.num_fonts; i++)
+  {
+    if (!read(&fonts[i], sizeof(fonts[i])) || fonts[i].num_glyphs > (data->size() / sizeof(ImFontGlyph)))
+      return false;
+
+    glyphs[i].resize(fonts[i].num_glyphs);
+    if (!read(glyphs[i].data(), glyphs[i].size() * sizeof(ImFontGlyph)))
+      return false;
+  }
+
+  const size_t pixels_size = static_cast<size_t>(header.tex_width) * static_cast<size_t>(header.tex_height);
+  if ((data->size() - offset) != pixels_size)
+    return false;
+
+  for (u32 i = 0; i < header.num_custom_rects; i++)
+  {
+    atlas->CustomRects[i].X = rects[i].first;
+    atlas->CustomRects[i].Y = rects[i].second;
+  }
+
+  atlas->TexID = nullptr;
+  atlas->ClearTexData();
+  atlas->TexWidth = static_cast<int>(header.tex_width);
+  atlas->TexHeight = static_cast<int>(header.tex_height);
+  atlas->TexUvScale = ImVec2(1.0f / atlas->TexWidth, 1.0f / atlas->TexHeight);
+  atlas->TexPixelsAlpha8 = static_cast<unsigned char*>(IM_ALLOC(pixels_size));
+  std::memcpy(atlas->TexPixelsAlpha8, data->data() + offset, pixels_size);
+
+  for (ImFontConfig& cfg : atlas->ConfigData)
+  {
+    const FontAtlasCacheFont& font = fonts[atlas->Fonts.index_from_ptr(atlas->Fonts.find(cfg.DstFont))];
+    ImFontAtlasBuildSetupFont(atlas, cfg.DstFont, &cfg, font.ascent, font.descent);
+  }
+
+  for (u32 i = 0; i < header.num_fonts; i++)
+  {
+    ImFont* font = atlas->Fonts[i];
+    font->Glyphs.resize(static_cast<int>(glyphs[i].size()));
+    std::memcpy(font->Glyphs.Data, glyphs[i].data(), glyphs[i].size() * sizeof(ImFontGlyph));
+    font->DirtyLookupTables = true;
+  }
+
+  // renders the cursors/lines and builds the lookup tables, same as the end of a normal build
+  ImFontAtlasBuildFinish(atlas);
+  Log_DevPrintf("Loaded %dx%d font atlas from cache.", atlas->TexWidth, atlas->TexHeight);
+  return true;
+}
+
+void ImGuiManager::SaveFontAtlasCache(u64 key)
+{
+  const ImFontAtlas* atlas = ImGui::GetIO().Fonts;
+  if (EmuFolders::Cache.empty() || !atlas->TexPixelsAlpha8)
+    return;
+
+  std::vector<u8> data;
+  const auto append = [&data](const void* ptr, size_t size) {
+    data.insert(data.end(), static_cast<const u8*>(ptr), static_cast<const u8*>(ptr) + size);
+  };
+
+  FontAtlasCacheHeader header = {};
+  header.signature = FONT_ATLAS_CACHE_SIGNATURE;
+  header.version = FONT_ATLAS_CACHE_VERSION;
+  header.key = key;
+  header.tex_width = static_cast<u32>(atlas->TexWidth);
+  header.tex_height = static_cast<u32>(atlas->TexHeight);
+  header.num_custom_rects = static_cast<u32>(atlas->CustomRects.Size);
+  header.num_fonts = static_cast<u32>(atlas->Fonts.Size);
+  append(&header, sizeof(header));
+
+  for (const ImFontAtlasCustomRect& rect : atlas->CustomRects)
+  {
+    const std::pair<u16, u16> pos(rect.X, rect.Y);
+    append(&pos, sizeof(pos));
+  }
+
+  for (const ImFont* font : atlas->Fonts)
+  {
+    const FontAtlasCacheFont cfont = {font->Ascent, font->Descent, static_cast<u32>(font->Glyphs.Size)};
+    append(&cfont, sizeof(cfont));
+    append(font->Glyphs.Data, font->Glyphs.size_in_bytes());
+  }
+
+  append(atlas->TexPixelsAlpha8, static_cast<size_t>(atlas->TexWidth) * static_cast<size_t>(atlas->TexHeight));
+
+  const std::string filename(GetFontAtlasCachePath(key));
+  const std::string temp_filename(filename + ".tmp");
+  if (!FileSystem::WriteBinaryFile(temp_filename.c_str(), data.data(), data.size()) ||
+      !FileSystem::RenamePath(temp_filename.c_str(), filename.c_str()))
+  {
+    Log_ErrorPrintf("Failed to write font atlas cache '%s'", filename.c_str());
+    FileSystem::DeleteFile(temp_filename.c_str());
+  }
 }
 
 bool ImGuiManager::AddFullscreenFontsIfMissing()
@@ -628,6 +856,26 @@ void Host::ClearOSDMessages()
   s_osd_active_messages.clear();
 }
 
+void ImGuiManager::NotifyUIActivity()
+{
+  s_last_ui_activity_time.store(Common::Timer::GetCurrentValue(), std::memory_order_relaxed);
+}
+
+bool ImGuiManager::IsUIIdle()
+{
+  if (!s_osd_active_messages.empty())
+    return false;
+
+  {
+    std::unique_lock lock(s_osd_messages_lock);
+    if (!s_osd_posted_messages.empty())
+      return false;
+  }
+
+  const Common::Timer::Value last_activity = s_last_ui_activity_time.load(std::memory_order_relaxed);
+  return (Common::Timer::ConvertValueToSeconds(Common::Timer::GetCurrentValue() - last_activity) >= UI_IDLE_TIMEOUT);
+}
+
 void ImGuiManager::AcquirePendingOSDMessages()
 {
   std::atomic_thread_fence(std::memory_order_consume);
@@ -764,6 +1012,8 @@ void ImGuiManager::AddTextInput(std::string str)
   if (!ImGui::GetCurrentContext())
     return;
 
+  NotifyUIActivity();
+
   if (!s_imgui_wants_keyboard.load(std::memory_order_acquire))
     return;
 
@@ -777,6 +1027,7 @@ void ImGuiManager::UpdateMousePosition(float x, float y)
 
   ImGui::GetIO().MousePos = ImVec2(x, y);
   std::atomic_thread_fence(std::memory_order_release);
+  NotifyUIActivity();
 }
 
 bool ImGuiManager::ProcessPointerButtonEvent(InputBindingKey key, float value)
@@ -786,6 +1037,7 @@ bool ImGuiManager::ProcessPointerButtonEvent(InputBindingKey key, float value)
 
   // still update state anyway
   ImGui::GetIO().AddMouseButtonEvent(key.data, value != 0.0f);
+  NotifyUIActivity();
 
   return s_imgui_wants_mouse.load(std::memory_order_acquire);
 }
@@ -798,6 +1050,7 @@ bool ImGuiManager::ProcessPointerAxisEvent(InputBindingKey key, float value)
   // still update state anyway
   const bool horizontal = (key.data == static_cast<u32>(InputPointerAxis::WheelX));
   ImGui::GetIO().AddMouseWheelEvent(horizontal ? value : 0.0f, horizontal ? 0.0f : value);
+  NotifyUIActivity();
 
   return s_imgui_wants_mouse.load(std::memory_order_acquire);
 }
@@ -810,6 +1063,7 @@ bool ImGuiManager::ProcessHostKeyEvent(InputBindingKey key, float value)
 
   // still update state anyway
   ImGui::GetIO().AddKeyEvent(iter->second, value != 0.0);
+  NotifyUIActivity();
 
   return s_imgui_wants_keyboard.load(std::memory_order_acquire);
 }
@@ -845,6 +1099,9 @@ bool ImGuiManager::ProcessGenericInputEvent(GenericInputBinding key, float value
     ImGuiKey_GamepadL2,        // R2
   };
 
+  // any controller input can change what's on screen, e.g. through hotkeys
+  NotifyUIActivity();
+
   if (!ImGui::GetCurrentContext() || !s_imgui_wants_keyboard.load(std::memory_order_acquire))
     return false;
 
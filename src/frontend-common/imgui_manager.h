@@ -82,4 +82,11 @@ bool ProcessHostKeyEvent(InputBindingKey key, float value);
 
 /// Called on the CPU thread when any input event fires. Allows imgui to take over controller navigation.
 bool ProcessGenericInputEvent(GenericInputBinding key, float value);
+
+/// Marks the UI as active, so it keeps being redrawn every frame while the system is paused.
+void NotifyUIActivity();
+
+/// Returns true if there hasn't been any input or on-screen messages for a while, in which case the paused UI
+/// only needs to be redrawn occasionally.
+bool IsUIIdle();
 } // namespace ImGuiManager
@@ -4,6 +4,7 @@
 #include "imgui_overlays.h"
 #include "IconsFontAwesome5.h"
 #include "common/align.h"
+#include "common/arena_allocator.h"
 #include "common/assert.h"
 #include "common/file_system.h"
 #include "common/log.h"
@@ -11,6 +12,7 @@
 #include "common/timer.h"
 #include "common_host.h"
 #include "core/controller.h"
+#include "core/cpu_code_cache.h"
 #include "core/gpu.h"
 #include "core/host.h"
 #include "core/host_display.h"
@@ -18,6 +20,7 @@
 #include "core/settings.h"
 #include "core/spu.h"
 #include "core/system.h"
+#include "core/texture_replacements.h"
 #include "fmt/chrono.h"
 #include "fmt/format.h"
 #include "fullscreen_ui.h"
@@ -33,6 +36,7 @@
 #include <chrono>
 #include <cmath>
 #include <deque>
+#include <iterator>
 #include <mutex>
 #include <unordered_map>
 
@@ -50,6 +54,7 @@ Log_SetChannel(ImGuiManager);
 
 namespace ImGuiManager {
 static void FormatProcessorStat(String& text, double usage, double time);
+static void UpdatePerformanceOverlayLines(System::State state);
 static void DrawPerformanceOverlay();
 static void DrawEnhancementsOverlay();
 static void DrawInputsOverlay();
@@ -71,8 +76,8 @@ static std::tuple<float, float> GetMinMax(gsl::span<const float> values)
   for (; i < aligned_count; i += 4)
   {
     const __m128 v(_mm_loadu_ps(&values[i]));
-    vmin = _mm_min_ps(v);
-    vmax = _mm_max_ps(v);
+    vmin = _mm_min_ps(vmin, v);
+    vmax = _mm_max_ps(vmax, v);
   }
 
 #ifdef _MSC_VER
@@ -99,8 +104,8 @@ static std::tuple<float, float> GetMinMax(gsl::span<const float> values)
   for (; i < aligned_count; i += 4)
   {
     const float32x4_t v(vld1q_f32(&values[i]));
-    vmin = vminq_f32(v);
-    vmax = vmaxq_f32(v);
+    vmin = vminq_f32(vmin, v);
+    vmax = vmaxq_f32(vmax, v);
   }
 
   float min = vminvq_f32(vmin);
@@ -128,6 +133,40 @@ static std::tuple<float, float> GetMinMax(gsl::span<const float> values)
 
 static bool s_save_state_selector_ui_open = false;
 
+namespace ImGuiManager {
+namespace {
+struct PerformanceOverlayLine
+{
+  std::string text;
+  ImFont* font;
+  ImU32 color;
+  ImVec2 size;
+};
+
+/// Everything the performance overlay text depends on. The lines are only rebuilt when this changes.
+struct PerformanceOverlayKey
+{
+  ImFont* fixed_font;
+  ImFont* standard_font;
+  u32 update_count;
+  u32 state;
+  u32 effective_width;
+  u32 effective_height;
+  u32 flags;
+
+  bool operator!=(const PerformanceOverlayKey& rhs) const
+  {
+    return (fixed_font != rhs.fixed_font || standard_font != rhs.standard_font || update_count != rhs.update_count ||
+            state != rhs.state || effective_width != rhs.effective_width || effective_height != rhs.effective_height ||
+            flags != rhs.flags);
+  }
+};
+} // namespace
+
+static std::vector<PerformanceOverlayLine> s_performance_overlay_lines;
+static PerformanceOverlayKey s_performance_overlay_key = {};
+} // namespace ImGuiManager
+
 void ImGuiManager::RenderTextOverlays()
 {
   const System::State state = System::GetState();
@@ -164,44 +203,24 @@ void ImGuiManager::FormatProcessorStat(String& text, double usage, double time)
     text.AppendFmtString("{:.1f}% ({:.2f}ms)", usage, time);
 }
 
-void ImGuiManager::DrawPerformanceOverlay()
+void ImGuiManager::UpdatePerformanceOverlayLines(System::State state)
 {
-  if (!(g_settings.display_show_fps || g_settings.display_show_speed || g_settings.display_show_resolution ||
-        g_settings.display_show_cpu ||
-        (g_settings.display_show_status_indicators &&
-         (System::IsPaused() || System::IsFastForwardEnabled() || System::IsTurboEnabled()))))
-  {
-    return;
-  }
+  s_performance_overlay_lines.clear();
 
-  const float scale = ImGuiManager::GetGlobalScale();
-  const float shadow_offset = std::ceil(1.0f * scale);
-  const float margin = std::ceil(10.0f * scale);
-  const float spacing = std::ceil(5.0f * scale);
   ImFont* fixed_font = ImGuiManager::GetFixedFont();
   ImFont* standard_font = ImGuiManager::GetStandardFont();
-  float position_y = margin;
-
-  ImDrawList* dl = ImGui::GetBackgroundDrawList();
   SmallString text;
-  ImVec2 text_size;
   bool first = true;
 
-#define DRAW_LINE(font, text, color)                                                                                   \
+#define ADD_LINE(font, text, color)                                                                                    \
   do                                                                                                                   \
   {                                                                                                                    \
-    text_size =                                                                                                        \
-      font->CalcTextSizeA(font->FontSize, std::numeric_limits<float>::max(), -1.0f, (text), nullptr, nullptr);         \
-    dl->AddText(                                                                                                       \
-      font, font->FontSize,                                                                                            \
-      ImVec2(ImGui::GetIO().DisplaySize.x - margin - text_size.x + shadow_offset, position_y + shadow_offset),         \
-      IM_COL32(0, 0, 0, 100), text, text.GetCharArray() + text.GetLength());                                           \
-    dl->AddText(font, font->FontSize, ImVec2(ImGui::GetIO().DisplaySize.x - margin - text_size.x, position_y), color,  \
-                (text));                                                                                               \
-    position_y += text_size.y + spacing;                                                                               \
+    const ImVec2 text_size = font->CalcTextSizeA(font->FontSize, std::numeric_limits<float>::max(), -1.0f,             \
+                                                 (text).GetCharArray(), (text).GetCharArray() + (text).GetLength());   \
+    s_performance_overlay_lines.push_back(                                                                             \
+      PerformanceOverlayLine{std::string((text).GetCharArray(), (text).GetLength()), font, (color), text_size});       \
   } while (0)
 
-  const System::State state = System::GetState();
   if (state == System::State::Running)
   {
     const float speed = System::GetEmulationSpeed();
@@ -232,7 +251,7 @@ void ImGuiManager::DrawPerformanceOverlay()
       else
         color = IM_COL32(255, 255, 255, 255);
 
-      DRAW_LINE(fixed_font, text, color);
+      ADD_LINE(fixed_font, text, color);
     }
 
     if (g_settings.display_show_resolution)
@@ -242,7 +261,7 @@ void ImGuiManager::DrawPerformanceOverlay()
       const bool pal = g_gpu->IsInPALMode();
       text.Fmt("{}x{} {} {}", effective_width, effective_height, pal ? "PAL" : "NTSC",
                interlaced ? "Interlaced" : "Progressive");
-      DRAW_LINE(fixed_font, text, IM_COL32(255, 255, 255, 255));
+      ADD_LINE(fixed_font, text, IM_COL32(255, 255, 255, 255));
     }
 
     if (g_settings.display_show_cpu)
@@ -250,7 +269,7 @@ void ImGuiManager::DrawPerformanceOverlay()
       text.Clear();
       text.AppendFmtString("{:.2f}ms | {:.2f}ms | {:.2f}ms", System::GetMinimumFrameTime(),
                            System::GetAverageFrameTime(), System::GetMaximumFrameTime());
-      DRAW_LINE(fixed_font, text, IM_COL32(255, 255, 255, 255));
+      ADD_LINE(fixed_font, text, IM_COL32(255, 255, 255, 255));
 
       text.Clear();
       if (g_settings.cpu_overclock_active || (!g_settings.IsUsingRecompiler() || g_settings.cpu_recompiler_icache ||
@@ -294,13 +313,42 @@ void ImGuiManager::DrawPerformanceOverlay()
         text.Assign("CPU: ");
       }
       FormatProcessorStat(text, System::GetCPUThreadUsage(), System::GetCPUThreadAverageTime());
-      DRAW_LINE(fixed_font, text, IM_COL32(255, 255, 255, 255));
+      ADD_LINE(fixed_font, text, IM_COL32(255, 255, 255, 255));
 
       if (g_gpu->GetSWThread())
       {
         text.Assign("SW: ");
         FormatProcessorStat(text, System::GetSWThreadUsage(), System::GetSWThreadAverageTime());
-        DRAW_LINE(fixed_font, text, IM_COL32(255, 255, 255, 255));
+        ADD_LINE(fixed_font, text, IM_COL32(255, 255, 255, 255));
+
+        text.Fmt("SW: {:.0f} wakeups/s | {:.0f} stalls/s ({:.2f}ms)", System::GetSWThreadWakeupRate(),
+                 System::GetSWThreadSyncStallRate(), System::GetSWThreadSyncStallTime());
+        ADD_LINE(fixed_font, text, IM_COL32(255, 255, 255, 255));
+      }
+
+#ifdef WITH_ALLOCATION_COUNTER
+      text.Fmt("CPU: {:.1f} allocations/frame", System::GetCPUThreadAllocationsPerFrame());
+      ADD_LINE(fixed_font, text, IM_COL32(255, 255, 255, 255));
+#endif
+
+      if (g_settings.IsUsingRecompiler() && g_settings.cpu_recompiler_tier_threshold > 0)
+      {
+        const CPU::CodeCache::TierStats ts = CPU::CodeCache::GetTierStats();
+        text.Fmt("JIT: {} interpreted | {} compiled | {} promoted", ts.interpreted_blocks, ts.compiled_blocks,
+                 ts.promoted_blocks);
+        ADD_LINE(fixed_font, text, IM_COL32(255, 255, 255, 255));
+      }
+
+      if (g_settings.IsUsingRecompiler())
+      {
+        // only worth showing once the code buffer has filled up
+        const CPU::CodeCache::EvictionStats es = CPU::CodeCache::GetEvictionStats();
+        if (es.region_evictions > 0 || es.full_flushes > 0)
+        {
+          text.Fmt("JIT: {} evictions ({} blocks) | {} flushes", es.region_evictions, es.evicted_blocks,
+                   es.full_flushes);
+          ADD_LINE(fixed_font, text, IM_COL32(255, 255, 255, 255));
+        }
       }
 
 #if 0
@@ -309,7 +357,7 @@ void ImGuiManager::DrawPerformanceOverlay()
         const u32 frames = stream->GetBufferedFramesRelaxed();
         text.Clear();
         text.Fmt("Audio: {:<4u}f/{:<3u}ms", frames, AudioStream::GetMSForBufferSize(stream->GetSampleRate(), frames));
-        DRAW_LINE(fixed_font, text, IM_COL32(255, 255, 255, 255));
+        ADD_LINE(fixed_font, text, IM_COL32(255, 255, 255, 255));
       }
 #endif
     }
@@ -318,7 +366,25 @@ void ImGuiManager::DrawPerformanceOverlay()
     {
       text.Assign("GPU: ");
       FormatProcessorStat(text, System::GetGPUUsage(), System::GetGPUAverageTime());
-      DRAW_LINE(fixed_font, text, IM_COL32(255, 255, 255, 255));
+      ADD_LINE(fixed_font, text, IM_COL32(255, 255, 255, 255));
+
+      for (u32 i = 0; i < HostDisplay::MAX_GPU_TIMING_SCOPES; i++)
+      {
+        const float scope_time = System::GetGPUAverageScopeTime(i);
+        if (scope_time < 0.01f)
+          continue;
+
+        text.Fmt("  {}: {:.2f}ms", g_host_display->GetGPUTimingScopeName(i), scope_time);
+        ADD_LINE(fixed_font, text, IM_COL32(255, 255, 255, 255));
+      }
+    }
+
+    if (g_settings.display_show_gpu && g_settings.texture_replacements.AnyReplacementsEnabled())
+    {
+      const TextureReplacements::CacheStats cs = g_texture_replacements.GetCacheStats();
+      text.Fmt("Replacements: {} pending | {} resident ({:.1f}MB) | {} evicted", cs.pending_textures,
+               cs.resident_textures, static_cast<double>(cs.resident_bytes) / 1048576.0, cs.evicted_textures);
+      ADD_LINE(fixed_font, text, IM_COL32(255, 255, 255, 255));
     }
 
     if (g_settings.display_show_status_indicators)
@@ -327,82 +393,165 @@ void ImGuiManager::DrawPerformanceOverlay()
       if (rewinding || System::IsFastForwardEnabled() || System::IsTurboEnabled())
       {
         text.Assign(rewinding ? ICON_FA_FAST_BACKWARD : ICON_FA_FAST_FORWARD);
-        DRAW_LINE(standard_font, text, IM_COL32(255, 255, 255, 255));
+        ADD_LINE(standard_font, text, IM_COL32(255, 255, 255, 255));
       }
     }
 
     if (g_settings.display_show_frame_times)
     {
-      const ImVec2 history_size(200.0f * scale, 50.0f * scale);
-      ImGui::SetNextWindowSize(ImVec2(history_size.x, history_size.y));
-      ImGui::SetNextWindowPos(ImVec2(ImGui::GetIO().DisplaySize.x - margin - history_size.x, position_y));
-      ImGui::PushStyleColor(ImGuiCol_WindowBg, ImVec4(0.0f, 0.0f, 0.0f, 0.25f));
-      ImGui::PushStyleColor(ImGuiCol_FrameBg, ImVec4(0.0f, 0.0f, 0.0f, 0.0f));
-      ImGui::PushStyleColor(ImGuiCol_PlotLines, ImVec4(1.0f, 1.0f, 1.0f, 1.0f));
-      ImGui::PushStyleVar(ImGuiStyleVar_WindowRounding, 0.0f);
-      ImGui::PushStyleVar(ImGuiStyleVar_WindowPadding, ImVec2(0.0f, 0.0f));
-      ImGui::PushStyleVar(ImGuiStyleVar_WindowBorderSize, 0.0f);
-      ImGui::PushStyleVar(ImGuiStyleVar_FramePadding, ImVec2(0.0f, 0.0f));
-      ImGui::PushStyleVar(ImGuiStyleVar_FrameBorderSize, 0.0f);
-      ImGui::PushFont(fixed_font);
-      if (ImGui::Begin("##frame_times", nullptr, ImGuiWindowFlags_NoDecoration | ImGuiWindowFlags_NoInputs))
-      {
-        auto [min, max] = GetMinMax(System::GetFrameTimeHistory());
-
-        // add a little bit of space either side, so we're not constantly resizing
-        if ((max - min) < 4.0f)
-        {
-          min = min - std::fmod(min, 1.0f);
-          max = max - std::fmod(max, 1.0f) + 1.0f;
-          min = std::max(min - 2.0f, 0.0f);
-          max += 2.0f;
-        }
-
-        ImGui::PlotEx(
-          ImGuiPlotType_Lines, "##frame_times",
-          [](void*, int idx) -> float {
-            return System::GetFrameTimeHistory()[((System::GetFrameTimeHistoryPos() + idx) %
-                                                  System::NUM_FRAME_TIME_SAMPLES)];
-          },
-          nullptr, System::NUM_FRAME_TIME_SAMPLES, 0, nullptr, min, max, history_size);
-
-        ImDrawList* win_dl = ImGui::GetCurrentWindow()->DrawList;
-        const ImVec2 wpos(ImGui::GetCurrentWindow()->Pos);
-
-        text.Clear();
-        text.AppendFmtString("{:.1f} ms", max);
-        text_size = fixed_font->CalcTextSizeA(fixed_font->FontSize, FLT_MAX, 0.0f, text.GetCharArray(),
-                                              text.GetCharArray() + text.GetLength());
-        win_dl->AddText(ImVec2(wpos.x + history_size.x - text_size.x - spacing + shadow_offset, wpos.y + shadow_offset),
-                        IM_COL32(0, 0, 0, 100), text.GetCharArray(), text.GetCharArray() + text.GetLength());
-        win_dl->AddText(ImVec2(wpos.x + history_size.x - text_size.x - spacing, wpos.y), IM_COL32(255, 255, 255, 255),
-                        text.GetCharArray(), text.GetCharArray() + text.GetLength());
-
-        text.Clear();
-        text.AppendFmtString("{:.1f} ms", min);
-        text_size = fixed_font->CalcTextSizeA(fixed_font->FontSize, FLT_MAX, 0.0f, text.GetCharArray(),
-                                              text.GetCharArray() + text.GetLength());
-        win_dl->AddText(ImVec2(wpos.x + history_size.x - text_size.x - spacing + shadow_offset,
-                               wpos.y + history_size.y - fixed_font->FontSize + shadow_offset),
-                        IM_COL32(0, 0, 0, 100), text.GetCharArray(), text.GetCharArray() + text.GetLength());
-        win_dl->AddText(
-          ImVec2(wpos.x + history_size.x - text_size.x - spacing, wpos.y + history_size.y - fixed_font->FontSize),
-          IM_COL32(255, 255, 255, 255), text.GetCharArray(), text.GetCharArray() + text.GetLength());
-      }
-      ImGui::End();
-      ImGui::PopFont();
-      ImGui::PopStyleVar(5);
-      ImGui::PopStyleColor(3);
+      const auto add_percentiles = [&](const char* label, System::FrameTimeHistogram histogram) {
+        const System::FrameTimePercentiles& pct = System::GetFrameTimePercentiles(histogram);
+        text.Fmt("{} p50/95/99/99.9: {:.1f} | {:.1f} | {:.1f} | {:.1f}ms", label, pct.p50, pct.p95, pct.p99,
+                 pct.p999);
+        ADD_LINE(fixed_font, text, IM_COL32(255, 255, 255, 255));
+      };
+      add_percentiles("Frame", System::FrameTimeHistogram::Frame);
+      add_percentiles("CPU", System::FrameTimeHistogram::CPUThread);
+      if (g_host_display->IsGPUTimingEnabled())
+        add_percentiles("GPU", System::FrameTimeHistogram::GPU);
+      if (System::GetFrameTimePercentiles(System::FrameTimeHistogram::InputLatency).p50 > 0.0f)
+        add_percentiles("Input", System::FrameTimeHistogram::InputLatency);
+      if (System::GetFrameTimePercentiles(System::FrameTimeHistogram::ThrottleJitter).p50 > 0.0f)
+        add_percentiles("Pacing", System::FrameTimeHistogram::ThrottleJitter);
     }
   }
   else if (g_settings.display_show_status_indicators && state == System::State::Paused &&
            !FullscreenUI::HasActiveWindow())
   {
     text.Assign(ICON_FA_PAUSE);
-    DRAW_LINE(standard_font, text, IM_COL32(255, 255, 255, 255));
+    ADD_LINE(standard_font, text, IM_COL32(255, 255, 255, 255));
+  }
+
+#undef ADD_LINE
+}
+
+void ImGuiManager::DrawPerformanceOverlay()
+{
+  if (!(g_settings.display_show_fps || g_settings.display_show_speed || g_settings.display_show_resolution ||
+        g_settings.display_show_cpu ||
+        (g_settings.display_show_status_indicators &&
+         (System::IsPaused() || System::IsFastForwardEnabled() || System::IsTurboEnabled()))))
+  {
+    return;
+  }
+
+  const float scale = ImGuiManager::GetGlobalScale();
+  const float shadow_offset = std::ceil(1.0f * scale);
+  const float margin = std::ceil(10.0f * scale);
+  const float spacing = std::ceil(5.0f * scale);
+  ImFont* fixed_font = ImGuiManager::GetFixedFont();
+  const System::State state = System::GetState();
+
+  // The text only changes when the counters are recalculated (once a second), or something it shows changes, so
+  // don't bother formatting and measuring it every frame.
+  PerformanceOverlayKey key = {};
+  key.fixed_font = fixed_font;
+  key.standard_font = ImGuiManager::GetStandardFont();
+  key.update_count = System::GetPerformanceCounterUpdateCount();
+  key.state = static_cast<u32>(state);
+  if (state == System::State::Running)
+  {
+    const auto [effective_width, effective_height] = g_gpu->GetEffectiveDisplayResolution();
+    key.effective_width = effective_width;
+    key.effective_height = effective_height;
+  }
+  key.flags = (g_settings.display_show_fps ? (1u << 0) : 0u) | (g_settings.display_show_speed ? (1u << 1) : 0u) |
+              (g_settings.display_show_resolution ? (1u << 2) : 0u) | (g_settings.display_show_cpu ? (1u << 3) : 0u) |
+              (g_settings.display_show_gpu ? (1u << 4) : 0u) |
+              (g_settings.display_show_status_indicators ? (1u << 5) : 0u) |
+              (g_settings.display_show_frame_times ? (1u << 6) : 0u) |
+              (g_host_display->IsGPUTimingEnabled() ? (1u << 7) : 0u) |
+              ((state == System::State::Running && g_gpu->IsInterlacedDisplayEnabled()) ? (1u << 8) : 0u) |
+              ((state == System::State::Running && g_gpu->IsInPALMode()) ? (1u << 9) : 0u) |
+              (System::IsFastForwardEnabled() ? (1u << 10) : 0u) | (System::IsTurboEnabled() ? (1u << 11) : 0u) |
+              (System::IsRewinding() ? (1u << 12) : 0u) | (FullscreenUI::HasActiveWindow() ? (1u << 13) : 0u);
+  if (key != s_performance_overlay_key)
+  {
+    s_performance_overlay_key = key;
+    UpdatePerformanceOverlayLines(state);
   }
 
-#undef DRAW_LINE
+  ImDrawList* dl = ImGui::GetBackgroundDrawList();
+  const float display_width = ImGui::GetIO().DisplaySize.x;
+  float position_y = margin;
+  for (const PerformanceOverlayLine& line : s_performance_overlay_lines)
+  {
+    const char* text_start = line.text.c_str();
+    const char* text_end = text_start + line.text.length();
+    dl->AddText(line.font, line.font->FontSize,
+                ImVec2(display_width - margin - line.size.x + shadow_offset, position_y + shadow_offset),
+                IM_COL32(0, 0, 0, 100), text_start, text_end);
+    dl->AddText(line.font, line.font->FontSize, ImVec2(display_width - margin - line.size.x, position_y), line.color,
+                text_start, text_end);
+    position_y += line.size.y + spacing;
+  }
+
+  // the frame time graph scrolls every frame, so it's always drawn live
+  if (state == System::State::Running && g_settings.display_show_frame_times)
+  {
+    SmallString text;
+    ImVec2 text_size;
+    const ImVec2 history_size(200.0f * scale, 50.0f * scale);
+    ImGui::SetNextWindowSize(ImVec2(history_size.x, history_size.y));
+    ImGui::SetNextWindowPos(ImVec2(ImGui::GetIO().DisplaySize.x - margin - history_size.x, position_y));
+    ImGui::PushStyleColor(ImGuiCol_WindowBg, ImVec4(0.0f, 0.0f, 0.0f, 0.25f));
+    ImGui::PushStyleColor(ImGuiCol_FrameBg, ImVec4(0.0f, 0.0f, 0.0f, 0.0f));
+    ImGui::PushStyleColor(ImGuiCol_PlotLines, ImVec4(1.0f, 1.0f, 1.0f, 1.0f));
+    ImGui::PushStyleVar(ImGuiStyleVar_WindowRounding, 0.0f);
+    ImGui::PushStyleVar(ImGuiStyleVar_WindowPadding, ImVec2(0.0f, 0.0f));
+    ImGui::PushStyleVar(ImGuiStyleVar_WindowBorderSize, 0.0f);
+    ImGui::PushStyleVar(ImGuiStyleVar_FramePadding, ImVec2(0.0f, 0.0f));
+    ImGui::PushStyleVar(ImGuiStyleVar_FrameBorderSize, 0.0f);
+    ImGui::PushFont(fixed_font);
+    if (ImGui::Begin("##frame_times", nullptr, ImGuiWindowFlags_NoDecoration | ImGuiWindowFlags_NoInputs))
+    {
+      auto [min, max] = GetMinMax(System::GetFrameTimeHistory());
+
+      // add a little bit of space either side, so we're not constantly resizing
+      if ((max - min) < 4.0f)
+      {
+        min = min - std::fmod(min, 1.0f);
+        max = max - std::fmod(max, 1.0f) + 1.0f;
+        min = std::max(min - 2.0f, 0.0f);
+        max += 2.0f;
+      }
+
+      ImGui::PlotEx(
+        ImGuiPlotType_Lines, "##frame_times",
+        [](void*, int idx) -> float {
+          return System::GetFrameTimeHistory()[((System::GetFrameTimeHistoryPos() + idx) %
+                                                System::NUM_FRAME_TIME_SAMPLES)];
+        },
+        nullptr, System::NUM_FRAME_TIME_SAMPLES, 0, nullptr, min, max, history_size);
+
+      ImDrawList* win_dl = ImGui::GetCurrentWindow()->DrawList;
+      const ImVec2 wpos(ImGui::GetCurrentWindow()->Pos);
+
+      text.Clear();
+      text.AppendFmtString("{:.1f} ms", max);
+      text_size = fixed_font->CalcTextSizeA(fixed_font->FontSize, FLT_MAX, 0.0f, text.GetCharArray(),
+                                            text.GetCharArray() + text.GetLength());
+      win_dl->AddText(ImVec2(wpos.x + history_size.x - text_size.x - spacing + shadow_offset, wpos.y + shadow_offset),
+                      IM_COL32(0, 0, 0, 100), text.GetCharArray(), text.GetCharArray() + text.GetLength());
+      win_dl->AddText(ImVec2(wpos.x + history_size.x - text_size.x - spacing, wpos.y), IM_COL32(255, 255, 255, 255),
+                      text.GetCharArray(), text.GetCharArray() + text.GetLength());
+
+      text.Clear();
+      text.AppendFmtString("{:.1f} ms", min);
+      text_size = fixed_font->CalcTextSizeA(fixed_font->FontSize, FLT_MAX, 0.0f, text.GetCharArray(),
+                                            text.GetCharArray() + text.GetLength());
+      win_dl->AddText(ImVec2(wpos.x + history_size.x - text_size.x - spacing + shadow_offset,
+                             wpos.y + history_size.y - fixed_font->FontSize + shadow_offset),
+                      IM_COL32(0, 0, 0, 100), text.GetCharArray(), text.GetCharArray() + text.GetLength());
+      win_dl->AddText(
+        ImVec2(wpos.x + history_size.x - text_size.x - spacing, wpos.y + history_size.y - fixed_font->FontSize),
+        IM_COL32(255, 255, 255, 255), text.GetCharArray(), text.GetCharArray() + text.GetLength());
+    }
+    ImGui::End();
+    ImGui::PopFont();
+    ImGui::PopStyleVar(5);
+    ImGui::PopStyleColor(3);
+  }
 }
 
 void ImGuiManager::DrawEnhancementsOverlay()
@@ -503,7 +652,10 @@ void ImGuiManager::DrawInputsOverlay()
 
   const ImVec4 clip_rect(current_x, current_y, display_size.x - margin, display_size.y - margin);
 
-  LargeString text;
+  // controllers with lots of bindings can overflow a stack string, so spill into the frame arena instead of the heap
+  ArenaAllocator& arena = ArenaAllocator::GetFrameArena();
+  ArenaAllocator::Scope arena_scope(arena);
+  fmt::basic_memory_buffer<char, 256, ArenaAllocatorAdapter<char>> text{ArenaAllocatorAdapter<char>(arena)};
 
   for (u32 port = 0; port < NUM_CONTROLLER_AND_CARD_PORTS; port++)
   {
@@ -516,7 +668,8 @@ void ImGuiManager::DrawInputsOverlay()
     if (!cinfo)
       continue;
 
-    text.Fmt("P{} |", port + 1u);
+    text.clear();
+    fmt::format_to(std::back_inserter(text), "P{} |", port + 1u);
 
     for (u32 bind = 0; bind < cinfo->num_bindings; bind++)
     {
@@ -529,9 +682,9 @@ void ImGuiManager::DrawInputsOverlay()
           // axes are always shown
           const float value = controller->GetBindState(bi.bind_index);
           if (value >= (254.0f / 255.0f))
-            text.AppendFmtString(" {}", bi.name);
+            fmt::format_to(std::back_inserter(text), " {}", bi.name);
           else if (value > (1.0f / 255.0f))
-            text.AppendFmtString(" {}: {:.2f}", bi.name, value);
+            fmt::format_to(std::back_inserter(text), " {}: {:.2f}", bi.name, value);
         }
         break;
 
@@ -540,7 +693,7 @@ void ImGuiManager::DrawInputsOverlay()
           // buttons only shown when active
           const float value = controller->GetBindState(bi.bind_index);
           if (value >= 0.5f)
-            text.AppendFmtString(" {}", bi.name);
+            fmt::format_to(std::back_inserter(text), " {}", bi.name);
         }
         break;
 
@@ -554,9 +707,9 @@ void ImGuiManager::DrawInputsOverlay()
     }
 
     dl->AddText(font, font->FontSize, ImVec2(current_x + shadow_offset, current_y + shadow_offset), shadow_color,
-                text.GetCharArray(), text.GetCharArray() + text.GetLength(), 0.0f, &clip_rect);
-    dl->AddText(font, font->FontSize, ImVec2(current_x, current_y), text_color, text.GetCharArray(),
-                text.GetCharArray() + text.GetLength(), 0.0f, &clip_rect);
+                text.data(), text.data() + text.size(), 0.0f, &clip_rect);
+    dl->AddText(font, font->FontSize, ImVec2(current_x, current_y), text_color, text.data(),
+                text.data() + text.size(), 0.0f, &clip_rect);
 
     current_y += font->FontSize + spacing;
   }
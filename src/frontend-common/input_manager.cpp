@@ -7,6 +7,7 @@
 #include "common/log.h"
 #include "common/path.h"
 #include "common/string_util.h"
+#include "common/threading.h"
 #include "common/timer.h"
 #include "core/controller.h"
 #include "core/host.h"
@@ -18,6 +19,8 @@
 
 #include <array>
 #include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <memory>
 #include <mutex>
 #include <sstream>
@@ -35,6 +38,8 @@ enum : u32
 {
   MAX_KEYS_PER_BINDING = 4,
   MAX_MOTORS_PER_PAD = 2,
+  POLLING_THREAD_INTERVAL_US = 1000,
+  QUEUED_EVENT_COUNT = 4096,
   FIRST_EXTERNAL_INPUT_SOURCE = static_cast<u32>(InputSourceType::Pointer) + 1u,
   LAST_EXTERNAL_INPUT_SOURCE = static_cast<u32>(InputSourceType::Count),
 };
@@ -54,6 +59,9 @@ struct InputBinding
   u8 num_keys = 0;
   u8 full_mask = 0;
   u8 current_mask = 0;
+
+  // Only changes controller state, so it's safe to fire while the CPU is executing.
+  bool pad_binding = false;
 };
 
 struct PadVibrationBinding
@@ -88,6 +96,13 @@ struct MacroButton
   bool trigger_state;       ///< Whether the macro button is active.
 };
 
+struct QueuedInputEvent
+{
+  InputBindingKey key;
+  float value;
+  GenericInputBinding generic_key;
+};
+
 // ------------------------------------------------------------------------
 // Forward Declarations (for static qualifier)
 // ------------------------------------------------------------------------
@@ -101,7 +116,8 @@ static std::optional<InputBindingKey> ParseSensorKey(const std::string_view& sou
 
 static std::vector<std::string_view> SplitChord(const std::string_view& binding);
 static bool SplitBinding(const std::string_view& binding, std::string_view* source, std::string_view* sub_binding);
-static void AddBindings(const std::vector<std::string>& bindings, const InputEventHandler& handler);
+static void AddBindings(const std::vector<std::string>& bindings, const InputEventHandler& handler,
+                        bool pad_binding = false);
 
 static bool IsAxisHandler(const InputEventHandler& handler);
 
@@ -121,6 +137,13 @@ static void UpdateMacroButtons();
 
 static void UpdateInputSourceState(SettingsInterface& si, std::unique_lock<std::mutex>& settings_lock,
                                    InputSourceType type, std::unique_ptr<InputSource> (*factory_function)());
+
+static bool CanPollSourceOnThread(u32 index);
+static void UpdatePollingThread();
+static void StopPollingThread();
+static void PollingThreadEntryPoint();
+static void QueueEvent(InputBindingKey key, float value, GenericInputBinding generic_key);
+static bool CanInvokeEventsWhileRunning(InputBindingKey key);
 } // namespace InputManager
 
 // ------------------------------------------------------------------------
@@ -141,6 +164,25 @@ static InputInterceptHook::Callback m_event_intercept_callback;
 // Input sources. Keyboard/mouse don't exist here.
 static std::array<std::unique_ptr<InputSource>, static_cast<u32>(InputSourceType::Count)> s_input_sources;
 
+// Polling thread. While it's running, it owns polling of the sources, and the events it generates are queued until
+// the CPU thread applies them, either when a controller is read, or at the end of the frame.
+static Threading::Thread s_polling_thread;
+static std::mutex s_polling_thread_lock;
+static std::condition_variable s_polling_thread_cv;
+static std::atomic_bool s_polling_thread_shutdown{false};
+
+// Set on the polling thread, and on the CPU thread while polling mid-frame.
+static thread_local bool s_queue_invoked_events = false;
+
+// Only accessed on the CPU thread.
+static bool s_polling_thread_enabled = false;
+static bool s_polling_thread_running = false;
+
+// Single producer (polling thread), single consumer (CPU thread).
+static std::array<QueuedInputEvent, QUEUED_EVENT_COUNT> s_queued_events;
+static std::atomic<u32> s_queued_events_read_pos{0};
+static std::atomic<u32> s_queued_events_write_pos{0};
+
 // Macro buttons.
 static std::array<std::array<MacroButton, InputManager::NUM_MACRO_BUTTONS_PER_CONTROLLER>,
                   NUM_CONTROLLER_AND_CARD_PORTS>
@@ -359,13 +401,15 @@ std::string InputManager::ConvertInputBindingKeysToString(InputBindingInfo::Type
   return ss.str();
 }
 
-void InputManager::AddBindings(const std::vector<std::string>& bindings, const InputEventHandler& handler)
+void InputManager::AddBindings(const std::vector<std::string>& bindings, const InputEventHandler& handler,
+                               bool pad_binding /* = false */)
 {
   for (const std::string& binding : bindings)
-    AddBinding(binding, handler);
+    AddBinding(binding, handler, pad_binding);
 }
 
-void InputManager::AddBinding(const std::string_view& binding, const InputEventHandler& handler)
+void InputManager::AddBinding(const std::string_view& binding, const InputEventHandler& handler,
+                              bool pad_binding /* = false */)
 {
   std::shared_ptr<InputBinding> ibinding;
   const std::vector<std::string_view> chord_bindings(SplitChord(binding));
@@ -384,6 +428,7 @@ void InputManager::AddBinding(const std::string_view& binding, const InputEventH
     {
       ibinding = std::make_shared<InputBinding>();
       ibinding->handler = handler;
+      ibinding->pad_binding = pad_binding;
     }
 
     if (ibinding->num_keys == MAX_KEYS_PER_BINDING)
@@ -716,7 +761,8 @@ void InputManager::AddPadBindings(SettingsInterface& si, const std::string& sect
                     Controller* c = System::GetController(pad_index);
                     if (c)
                       c->SetBindState(bind_index, value);
-                  }});
+                  }},
+                  true);
     }
   }
 
@@ -731,7 +777,8 @@ void InputManager::AddPadBindings(SettingsInterface& si, const std::string& sect
                       return;
 
                     SetMacroButtonState(pad_index, macro_button_index, state);
-                  }});
+                  }},
+                  true);
     }
   }
 
@@ -801,6 +848,13 @@ bool InputManager::IsAxisHandler(const InputEventHandler& handler)
 
 bool InputManager::InvokeEvents(InputBindingKey key, float value, GenericInputBinding generic_key)
 {
+  if (s_queue_invoked_events)
+  {
+    // Bindings can be reloaded by the CPU thread at any time, so they're only looked at when the event is applied.
+    QueueEvent(key, value, generic_key);
+    return true;
+  }
+
   if (DoEventHook(key, value))
     return true;
 
@@ -1267,6 +1321,7 @@ void InputManager::OnInputDeviceDisconnected(const std::string_view& identifier)
 void InputManager::SetPadVibrationIntensity(u32 pad_index, float large_or_single_motor_intensity,
                                             float small_motor_intensity)
 {
+  std::unique_lock lock(s_polling_thread_lock);
   for (PadVibrationBinding& pad : s_pad_vibration_array)
   {
     if (pad.pad_index != pad_index)
@@ -1317,6 +1372,7 @@ void InputManager::SetPadVibrationIntensity(u32 pad_index, float large_or_single
 
 void InputManager::PauseVibration()
 {
+  std::unique_lock lock(s_polling_thread_lock);
   for (PadVibrationBinding& binding : s_pad_vibration_array)
   {
     for (u32 motor_index = 0; motor_index < MAX_MOTORS_PER_PAD; motor_index++)
@@ -1335,6 +1391,7 @@ void InputManager::PauseVibration()
 void InputManager::UpdateContinuedVibration()
 {
   // update vibration intensities, so if the game does a long effect, it continues
+  std::unique_lock lock(s_polling_thread_lock);
   const u64 current_time = Common::Timer::GetCurrentValue();
   for (PadVibrationBinding& pad : s_pad_vibration_array)
   {
@@ -1726,6 +1783,7 @@ bool InputManager::ReloadDevices()
 {
   bool changed = false;
 
+  std::unique_lock lock(s_polling_thread_lock);
   for (u32 i = FIRST_EXTERNAL_INPUT_SOURCE; i < LAST_EXTERNAL_INPUT_SOURCE; i++)
   {
     if (s_input_sources[i])
@@ -1737,6 +1795,8 @@ bool InputManager::ReloadDevices()
 
 void InputManager::CloseSources()
 {
+  StopPollingThread();
+
   for (u32 i = FIRST_EXTERNAL_INPUT_SOURCE; i < LAST_EXTERNAL_INPUT_SOURCE; i++)
   {
     if (s_input_sources[i])
@@ -1749,9 +1809,12 @@ void InputManager::CloseSources()
 
 void InputManager::PollSources()
 {
+  UpdatePollingThread();
+  ProcessQueuedEvents(false);
+
   for (u32 i = FIRST_EXTERNAL_INPUT_SOURCE; i < LAST_EXTERNAL_INPUT_SOURCE; i++)
   {
-    if (s_input_sources[i])
+    if (s_input_sources[i] && (!s_polling_thread_running || !CanPollSourceOnThread(i)))
       s_input_sources[i]->PollEvents();
   }
 
@@ -1772,6 +1835,7 @@ std::vector<std::pair<std::string, std::string>> InputManager::EnumerateDevices(
   ret.emplace_back("Keyboard", "Keyboard");
   ret.emplace_back("Mouse", "Mouse");
 
+  std::unique_lock lock(s_polling_thread_lock);
   for (u32 i = FIRST_EXTERNAL_INPUT_SOURCE; i < LAST_EXTERNAL_INPUT_SOURCE; i++)
   {
     if (s_input_sources[i])
@@ -1791,6 +1855,7 @@ std::vector<InputBindingKey> InputManager::EnumerateMotors()
 {
   std::vector<InputBindingKey> ret;
 
+  std::unique_lock lock(s_polling_thread_lock);
   for (u32 i = FIRST_EXTERNAL_INPUT_SOURCE; i < LAST_EXTERNAL_INPUT_SOURCE; i++)
   {
     if (s_input_sources[i])
@@ -1851,6 +1916,7 @@ GenericInputBindingMapping InputManager::GetGenericBindingMapping(const std::str
 
   if (!GetInternalGenericBindingMapping(device, &mapping))
   {
+    std::unique_lock lock(s_polling_thread_lock);
     for (u32 i = FIRST_EXTERNAL_INPUT_SOURCE; i < LAST_EXTERNAL_INPUT_SOURCE; i++)
     {
       if (s_input_sources[i] && s_input_sources[i]->GetGenericBindingMapping(device, &mapping))
@@ -1906,6 +1972,10 @@ void InputManager::UpdateInputSourceState(SettingsInterface& si, std::unique_loc
 
 void InputManager::ReloadSources(SettingsInterface& si, std::unique_lock<std::mutex>& settings_lock)
 {
+  // Sources can't change while they're being polled, the thread is restarted on the next poll if it's still enabled.
+  StopPollingThread();
+  s_polling_thread_enabled = si.GetBoolValue("InputSources", "PollingThread", false);
+
 #ifdef _WIN32
   UpdateInputSourceState(si, settings_lock, InputSourceType::DInput, &InputSource::CreateDInputSource);
   UpdateInputSourceState(si, settings_lock, InputSourceType::XInput, &InputSource::CreateXInputSource);
@@ -1921,3 +1991,149 @@ void InputManager::ReloadSources(SettingsInterface& si, std::unique_lock<std::mu
   UpdateInputSourceState(si, settings_lock, InputSourceType::Android, &InputSource::CreateAndroidSource);
 #endif
 }
+
+// ------------------------------------------------------------------------
+// Polling Thread
+// ------------------------------------------------------------------------
+
+bool InputManager::CanPollSourceOnThread(u32 index)
+{
+#ifdef _WIN32
+  // Raw input arrives as window messages, which can only be received on the thread which created the window.
+  return (index != static_cast<u32>(InputSourceType::RawInput));
+#else
+  return true;
+#endif
+}
+
+void InputManager::PollSourcesDeferred()
+{
+  // Already as fresh as it's going to get.
+  if (s_polling_thread_running)
+    return;
+
+  // Hotkeys can't run mid-frame, so everything goes through the queue, same as events from the polling thread.
+  s_queue_invoked_events = true;
+  for (u32 i = FIRST_EXTERNAL_INPUT_SOURCE; i < LAST_EXTERNAL_INPUT_SOURCE; i++)
+  {
+    if (s_input_sources[i])
+      s_input_sources[i]->PollEvents();
+  }
+  s_queue_invoked_events = false;
+}
+
+void InputManager::UpdatePollingThread()
+{
+  // Only worth running while the game is, otherwise nothing is reading the controllers.
+  const bool wanted = (s_polling_thread_enabled && System::GetState() == System::State::Running);
+  if (wanted == s_polling_thread_running)
+    return;
+
+  if (!wanted)
+  {
+    StopPollingThread();
+    return;
+  }
+
+  s_polling_thread_shutdown.store(false, std::memory_order_relaxed);
+  s_polling_thread_running = s_polling_thread.Start(&InputManager::PollingThreadEntryPoint);
+  if (!s_polling_thread_running)
+  {
+    Log_ErrorPrintf("Failed to start input polling thread, polling on the CPU thread instead.");
+    s_polling_thread_enabled = false;
+    return;
+  }
+
+  Log_InfoPrintf("Input polling thread started.");
+}
+
+void InputManager::StopPollingThread()
+{
+  if (!s_polling_thread_running)
+    return;
+
+  {
+    std::unique_lock lock(s_polling_thread_lock);
+    s_polling_thread_shutdown.store(true, std::memory_order_relaxed);
+    s_polling_thread_cv.notify_one();
+  }
+
+  s_polling_thread.Join();
+  s_polling_thread_running = false;
+  Log_InfoPrintf("Input polling thread stopped.");
+
+  // Anything still queued is applied by the next PollSources() call.
+}
+
+void InputManager::PollingThreadEntryPoint()
+{
+  Threading::SetNameOfCurrentThread("Input Polling Thread");
+  s_queue_invoked_events = true;
+
+  std::unique_lock lock(s_polling_thread_lock);
+  while (!s_polling_thread_shutdown.load(std::memory_order_relaxed))
+  {
+    for (u32 i = FIRST_EXTERNAL_INPUT_SOURCE; i < LAST_EXTERNAL_INPUT_SOURCE; i++)
+    {
+      if (s_input_sources[i] && CanPollSourceOnThread(i))
+        s_input_sources[i]->PollEvents();
+    }
+
+    // The lock is released while waiting, so the CPU thread can use the sources in between polls.
+    s_polling_thread_cv.wait_for(lock, std::chrono::microseconds(POLLING_THREAD_INTERVAL_US),
+                                 []() { return s_polling_thread_shutdown.load(std::memory_order_relaxed); });
+  }
+}
+
+void InputManager::QueueEvent(InputBindingKey key, float value, GenericInputBinding generic_key)
+{
+  const u32 write_pos = s_queued_events_write_pos.load(std::memory_order_relaxed);
+  if ((write_pos - s_queued_events_read_pos.load(std::memory_order_acquire)) >= QUEUED_EVENT_COUNT)
+  {
+    // The CPU thread drains the queue at least once per frame, so this shouldn't happen.
+    Log_WarningPrintf("Input event queue is full, dropping event.");
+    return;
+  }
+
+  s_queued_events[write_pos % QUEUED_EVENT_COUNT] = QueuedInputEvent{key, value, generic_key};
+  s_queued_events_write_pos.store(write_pos + 1, std::memory_order_release);
+}
+
+bool InputManager::CanInvokeEventsWhileRunning(InputBindingKey key)
+{
+  // Binding hooks and hotkeys expect to be called between frames.
+  {
+    std::unique_lock lock(m_event_intercept_mutex);
+    if (m_event_intercept_callback)
+      return false;
+  }
+
+  const auto range = s_binding_map.equal_range(key.MaskDirection());
+  for (auto it = range.first; it != range.second; ++it)
+  {
+    if (!it->second->pad_binding)
+      return false;
+  }
+
+  return true;
+}
+
+void InputManager::ProcessQueuedEvents(bool pad_bindings_only)
+{
+  u32 read_pos = s_queued_events_read_pos.load(std::memory_order_relaxed);
+  const u32 write_pos = s_queued_events_write_pos.load(std::memory_order_acquire);
+  if (read_pos == write_pos)
+    return;
+
+  // Events have to be applied in order, so stop at the first one which can't be applied yet.
+  for (; read_pos != write_pos; read_pos++)
+  {
+    const QueuedInputEvent& event = s_queued_events[read_pos % QUEUED_EVENT_COUNT];
+    if (pad_bindings_only && !CanInvokeEventsWhileRunning(event.key))
+      break;
+
+    InvokeEvents(event.key, event.value, event.generic_key);
+  }
+
+  s_queued_events_read_pos.store(read_pos, std::memory_order_release);
+}
@@ -262,6 +262,14 @@ void CloseSources();
 /// Polls input sources for events (e.g. external controllers).
 void PollSources();
 
+/// Polls input sources like PollSources(), but queues the events for ProcessQueuedEvents() instead of applying them.
+/// Does nothing while the polling thread is running.
+void PollSourcesDeferred();
+
+/// Applies events which were queued by the polling thread. When pad_bindings_only is set, stops at the first event
+/// that would fire anything other than a controller binding, so it can be called while the CPU is executing.
+void ProcessQueuedEvents(bool pad_bindings_only);
+
 /// Returns true if any bindings exist for the specified key.
 /// Can be safely called on another thread.
 bool HasAnyBindingsForKey(InputBindingKey key);
@@ -274,7 +282,8 @@ bool HasAnyBindingsForSource(InputBindingKey key);
 bool ParseBindingAndGetSource(const std::string_view& binding, InputBindingKey* key, InputSource** source);
 
 /// Externally adds a fixed binding. Be sure to call *after* ReloadBindings() otherwise it will be lost.
-void AddBinding(const std::string_view& binding, const InputEventHandler& handler);
+/// Pad bindings only change controller state, so they can be fired while the CPU is executing.
+void AddBinding(const std::string_view& binding, const InputEventHandler& handler, bool pad_binding = false);
 
 /// Adds an external vibration binding.
 void AddVibrationBinding(u32 pad_index, const InputBindingKey* motor_0_binding, InputSource* motor_0_source,
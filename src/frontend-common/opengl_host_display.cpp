@@ -620,9 +620,10 @@ void OpenGLHostDisplay::DestroyResources()
   HostDisplay::DestroyResources();
 
   m_post_processing_chain.ClearStages();
-  m_post_processing_input_texture.Destroy();
+  for (GL::Texture& texture : m_post_processing_textures)
+    texture.Destroy();
   m_post_processing_ubo.reset();
-  m_post_processing_stages.clear();
+  m_post_processing_passes.clear();
 
   if (m_display_vao != 0)
   {
@@ -664,6 +665,7 @@ bool OpenGLHostDisplay::Render(bool skip_present)
 
   RenderDisplay();
 
+  SetGPUTimingScope(GPUTimingScope::Overlays);
   if (ImGui::GetCurrentContext())
     RenderImGui();
 
@@ -674,6 +676,7 @@ bool OpenGLHostDisplay::Render(bool skip_present)
 
   m_gl_context->SwapBuffers();
 
+  SetGPUTimingScope(GPUTimingScope::Other);
   if (m_gpu_timing_enabled)
     KickTimestampQuery();
 
@@ -726,12 +729,19 @@ bool OpenGLHostDisplay::RenderScreenshot(u32 width, u32 height, const Common::Re
 void OpenGLHostDisplay::RenderImGui()
 {
   ImGui::Render();
-  ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+
+  // nothing on screen most of the time while playing, so skip setting up the pipeline state
+  ImDrawData* draw_data = ImGui::GetDrawData();
+  if (draw_data->TotalVtxCount == 0)
+    return;
+
+  ImGui_ImplOpenGL3_RenderDrawData(draw_data);
   GL::Program::ResetLastProgram();
 }
 
 void OpenGLHostDisplay::RenderDisplay()
 {
+  SetGPUTimingScope(GPUTimingScope::Display);
   const auto [left, top, width, height] = CalculateDrawRect(GetWindowWidth(), GetWindowHeight());
 
   if (HasDisplayTexture() && !m_post_processing_chain.IsEmpty())
@@ -858,51 +868,33 @@ bool OpenGLHostDisplay::SetPostProcessingChain(const std::string_view& config)
 {
   if (config.empty())
   {
-    m_post_processing_input_texture.Destroy();
-    m_post_processing_stages.clear();
+    for (GL::Texture& texture : m_post_processing_textures)
+      texture.Destroy();
+    m_post_processing_passes.clear();
     m_post_processing_chain.ClearStages();
+    SetPostProcessingGPUTimingScopeNames({});
     return true;
   }
 
   if (!m_post_processing_chain.CreateFromString(config))
     return false;
 
-  m_post_processing_stages.clear();
-
-  FrontendCommon::PostProcessingShaderGen shadergen(GetRenderAPI(), false);
-
-  for (u32 i = 0; i < m_post_processing_chain.GetStageCount(); i++)
+  m_post_processing_chain.SetFusionEnabled(g_settings.display_post_process_fusion);
+  if (!CompilePostProcessingPasses())
   {
-    const FrontendCommon::PostProcessingShader& shader = m_post_processing_chain.GetShaderStage(i);
-    const std::string vs = shadergen.GeneratePostProcessingVertexShader(shader);
-    const std::string ps = shadergen.GeneratePostProcessingFragmentShader(shader);
-
-    PostProcessingStage stage;
-    stage.uniforms_size = shader.GetUniformsSize();
-    if (!stage.program.Compile(vs, ps))
+    if (!m_post_processing_chain.HasFusedPasses())
     {
-      Log_InfoPrintf("Failed to compile post-processing program, disabling.");
-      m_post_processing_stages.clear();
       m_post_processing_chain.ClearStages();
       return false;
     }
 
-    if (!shadergen.UseGLSLBindingLayout())
-    {
-      stage.program.BindUniformBlock("UBOBlock", 1);
-      stage.program.Bind();
-      stage.program.Uniform1i("samp0", 0);
-    }
-
-    if (!stage.program.Link())
+    Log_WarningPrintf("Failed to compile fused post-processing passes, retrying with one pass per shader.");
+    m_post_processing_chain.SetFusionEnabled(false);
+    if (!CompilePostProcessingPasses())
     {
-      Log_InfoPrintf("Failed to link post-processing program, disabling.");
-      m_post_processing_stages.clear();
       m_post_processing_chain.ClearStages();
       return false;
     }
-
-    m_post_processing_stages.push_back(std::move(stage));
   }
 
   if (!m_post_processing_ubo)
@@ -911,7 +903,7 @@ bool OpenGLHostDisplay::SetPostProcessingChain(const std::string_view& config)
     if (!m_post_processing_ubo)
     {
       Log_InfoPrintf("Failed to allocate uniform buffer for postprocessing");
-      m_post_processing_stages.clear();
+      m_post_processing_passes.clear();
       m_post_processing_chain.ClearStages();
       return false;
     }
@@ -920,31 +912,69 @@ bool OpenGLHostDisplay::SetPostProcessingChain(const std::string_view& config)
   }
 
   m_post_processing_timer.Reset();
+  SetPostProcessingGPUTimingScopeNames(m_post_processing_chain.GetPassNames());
   return true;
 }
 
-bool OpenGLHostDisplay::CheckPostProcessingRenderTargets(u32 target_width, u32 target_height)
+bool OpenGLHostDisplay::CompilePostProcessingPasses()
 {
-  DebugAssert(!m_post_processing_stages.empty());
+  m_post_processing_passes.clear();
+
+  FrontendCommon::PostProcessingShaderGen shadergen(GetRenderAPI(), false);
 
-  if (m_post_processing_input_texture.GetWidth() != target_width ||
-      m_post_processing_input_texture.GetHeight() != target_height)
+  for (u32 i = 0; i < m_post_processing_chain.GetPassCount(); i++)
   {
-    if (!m_post_processing_input_texture.Create(target_width, target_height, 1, 1, 1, GPUTexture::Format::RGBA8) ||
-        !m_post_processing_input_texture.CreateFramebuffer())
+    const std::string vs = shadergen.GeneratePostProcessingVertexShader(m_post_processing_chain, i);
+    const std::string ps = shadergen.GeneratePostProcessingFragmentShader(m_post_processing_chain, i);
+
+    PostProcessingPass pass;
+    pass.uniforms_size = m_post_processing_chain.GetPassUniformsSize(i);
+    if (!pass.program.Compile(vs, ps))
     {
+      Log_InfoPrintf("Failed to compile post-processing program.");
+      m_post_processing_passes.clear();
       return false;
     }
+
+    if (!shadergen.UseGLSLBindingLayout())
+    {
+      pass.program.BindUniformBlock("UBOBlock", 1);
+      pass.program.Bind();
+      pass.program.Uniform1i("samp0", 0);
+    }
+
+    if (!pass.program.Link())
+    {
+      Log_InfoPrintf("Failed to link post-processing program.");
+      m_post_processing_passes.clear();
+      return false;
+    }
+
+    m_post_processing_passes.push_back(std::move(pass));
   }
 
-  const u32 target_count = (static_cast<u32>(m_post_processing_stages.size()) - 1);
-  for (u32 i = 0; i < target_count; i++)
+  return true;
+}
+
+bool OpenGLHostDisplay::CheckPostProcessingRenderTargets(u32 target_width, u32 target_height)
+{
+  DebugAssert(!m_post_processing_passes.empty());
+
+  // a single pass goes straight from the display copy to the final target
+  const u32 target_count = (m_post_processing_passes.size() > 1) ? 2u : 1u;
+  for (u32 i = 0; i < static_cast<u32>(m_post_processing_textures.size()); i++)
   {
-    PostProcessingStage& pps = m_post_processing_stages[i];
-    if (pps.output_texture.GetWidth() != target_width || pps.output_texture.GetHeight() != target_height)
+    GL::Texture& texture = m_post_processing_textures[i];
+    if (i >= target_count)
     {
-      if (!pps.output_texture.Create(target_width, target_height, 1, 1, 1, GPUTexture::Format::RGBA8) ||
-          !pps.output_texture.CreateFramebuffer())
+      texture.Destroy();
+      continue;
+    }
+
+    if (texture.GetWidth() != target_width || texture.GetHeight() != target_height)
+    {
+      if (!texture.Create(target_width, target_height, 1, 1, 1, GPUTexture::Format::RGBA8) ||
+          !texture.CreateFramebuffer())
       {
         return false;
       }
@@ -967,14 +997,15 @@ void OpenGLHostDisplay::ApplyPostProcessingChain(GLuint final_target, s32 final_
   }
 
   // downsample/upsample - use same viewport for remainder
-  m_post_processing_input_texture.BindFramebuffer(GL_FRAMEBUFFER);
+  GL::Texture& input_texture = m_post_processing_textures[0];
+  input_texture.BindFramebuffer(GL_FRAMEBUFFER);
   glClear(GL_COLOR_BUFFER_BIT);
   RenderDisplay(final_left, target_height - final_top - final_height, final_width, final_height, texture,
                 texture_view_x, texture_view_y, texture_view_width, texture_view_height, IsUsingLinearFiltering());
 
   const s32 orig_texture_width = texture_view_width;
   const s32 orig_texture_height = texture_view_height;
-  texture = &m_post_processing_input_texture;
+  texture = &input_texture;
   texture_view_x = final_left;
   texture_view_y = final_top;
   texture_view_width = final_width;
@@ -982,31 +1013,35 @@ void OpenGLHostDisplay::ApplyPostProcessingChain(GLuint final_target, s32 final_
 
   m_post_processing_ubo->Bind();
 
-  const u32 final_stage = static_cast<u32>(m_post_processing_stages.size()) - 1u;
-  for (u32 i = 0; i < static_cast<u32>(m_post_processing_stages.size()); i++)
+  const u32 final_pass = static_cast<u32>(m_post_processing_passes.size()) - 1u;
+  for (u32 i = 0; i < static_cast<u32>(m_post_processing_passes.size()); i++)
   {
-    PostProcessingStage& pps = m_post_processing_stages[i];
-    glBindFramebuffer(GL_FRAMEBUFFER, (i == final_stage) ? final_target : pps.output_texture.GetGLFramebufferID());
+    PostProcessingPass& ppp = m_post_processing_passes[i];
+    SetPostProcessingGPUTimingScope(i);
+
+    // pass N reads target N % 2, and writes to the other one
+    GL::Texture& output_texture = m_post_processing_textures[(i + 1) & 1u];
+    glBindFramebuffer(GL_FRAMEBUFFER, (i == final_pass) ? final_target : output_texture.GetGLFramebufferID());
     glClear(GL_COLOR_BUFFER_BIT);
 
-    pps.program.Bind();
+    ppp.program.Bind();
 
     static_cast<const GL::Texture*>(texture)->Bind();
     glBindSampler(0, m_display_border_sampler);
 
-    const auto map_result = m_post_processing_ubo->Map(m_uniform_buffer_alignment, pps.uniforms_size);
-    m_post_processing_chain.GetShaderStage(i).FillUniformBuffer(
-      map_result.pointer, texture->GetWidth(), texture->GetHeight(), texture_view_x, texture_view_y, texture_view_width,
-      texture_view_height, GetWindowWidth(), GetWindowHeight(), orig_texture_width, orig_texture_height,
-      static_cast<float>(m_post_processing_timer.GetTimeSeconds()));
-    m_post_processing_ubo->Unmap(pps.uniforms_size);
+    const auto map_result = m_post_processing_ubo->Map(m_uniform_buffer_alignment, ppp.uniforms_size);
+    m_post_processing_chain.FillPassUniformBuffer(
+      i, map_result.pointer, texture->GetWidth(), texture->GetHeight(), texture_view_x, texture_view_y,
+      texture_view_width, texture_view_height, GetWindowWidth(), GetWindowHeight(), orig_texture_width,
+      orig_texture_height, static_cast<float>(m_post_processing_timer.GetTimeSeconds()));
+    m_post_processing_ubo->Unmap(ppp.uniforms_size);
     glBindBufferRange(GL_UNIFORM_BUFFER, 1, m_post_processing_ubo->GetGLBufferId(), map_result.buffer_offset,
-                      pps.uniforms_size);
+                      ppp.uniforms_size);
 
     glDrawArrays(GL_TRIANGLES, 0, 3);
 
-    if (i != final_stage)
-      texture = &pps.output_texture;
+    if (i != final_pass)
+      texture = &output_texture;
   }
 
   glBindSampler(0, 0);
@@ -1019,6 +1054,15 @@ void OpenGLHostDisplay::CreateTimestampQueries()
   const auto GenQueries = gles ? glGenQueriesEXT : glGenQueries;
 
   GenQueries(static_cast<u32>(m_timestamp_queries.size()), m_timestamp_queries.data());
+
+  // per-scope timing needs timestamp counters, which aren't guaranteed on GLES.
+  m_scope_timestamps_supported = gles ? (glQueryCounterEXT != nullptr) : (glQueryCounter != nullptr);
+  if (m_scope_timestamps_supported)
+  {
+    for (ScopeTimestampQueries& sq : m_scope_timestamp_queries)
+      GenQueries(static_cast<u32>(sq.queries.size()), sq.queries.data());
+  }
+
   KickTimestampQuery();
 }
 
@@ -1038,6 +1082,13 @@ void OpenGLHostDisplay::DestroyTimestampQueries()
 
   DeleteQueries(static_cast<u32>(m_timestamp_queries.size()), m_timestamp_queries.data());
   m_timestamp_queries.fill(0);
+  if (m_scope_timestamps_supported)
+  {
+    for (ScopeTimestampQueries& sq : m_scope_timestamp_queries)
+      DeleteQueries(static_cast<u32>(sq.queries.size()), sq.queries.data());
+    m_scope_timestamp_queries = {};
+    m_scope_timestamps_supported = false;
+  }
   m_read_timestamp_query = 0;
   m_write_timestamp_query = 0;
   m_waiting_timestamp_queries = 0;
@@ -1078,6 +1129,34 @@ void OpenGLHostDisplay::PopTimestampQuery()
     u64 result = 0;
     GetQueryObjectui64v(m_timestamp_queries[m_read_timestamp_query], GL_QUERY_RESULT, &result);
     m_accumulated_gpu_time += static_cast<float>(static_cast<double>(result) / 1000000.0);
+
+    if (m_scope_timestamps_supported)
+    {
+      // the end timestamp was issued alongside the elapsed query, so everything before it should be ready too.
+      const ScopeTimestampQueries& sq = m_scope_timestamp_queries[m_read_timestamp_query];
+      u64 scope_start = 0, end = 0;
+      GetQueryObjectui64v(sq.queries[0], GL_QUERY_RESULT, &scope_start);
+      GetQueryObjectui64v(sq.queries[1], GL_QUERY_RESULT, &end);
+
+      u32 scope = sq.first_scope;
+      for (u32 i = 0; i <= sq.num_queries; i++)
+      {
+        u64 scope_end = end;
+        if (i < sq.num_queries)
+          GetQueryObjectui64v(sq.queries[2 + i], GL_QUERY_RESULT, &scope_end);
+
+        if (scope_end > scope_start)
+        {
+          m_accumulated_scope_times[scope] +=
+            static_cast<float>(static_cast<double>(scope_end - scope_start) / 1000000.0);
+          scope_start = scope_end;
+        }
+
+        if (i < sq.num_queries)
+          scope = sq.scope_ids[i];
+      }
+    }
+
     m_read_timestamp_query = (m_read_timestamp_query + 1) % NUM_TIMESTAMP_QUERIES;
     m_waiting_timestamp_queries--;
   }
@@ -1086,6 +1165,11 @@ void OpenGLHostDisplay::PopTimestampQuery()
   {
     const auto EndQuery = gles ? glEndQueryEXT : glEndQuery;
     EndQuery(GL_TIME_ELAPSED);
+    if (m_scope_timestamps_supported)
+    {
+      const auto QueryCounter = gles ? glQueryCounterEXT : glQueryCounter;
+      QueryCounter(m_scope_timestamp_queries[m_write_timestamp_query].queries[1], GL_TIMESTAMP);
+    }
 
     m_write_timestamp_query = (m_write_timestamp_query + 1) % NUM_TIMESTAMP_QUERIES;
     m_timestamp_query_started = false;
@@ -1102,9 +1186,30 @@ void OpenGLHostDisplay::KickTimestampQuery()
   const auto BeginQuery = gles ? glBeginQueryEXT : glBeginQuery;
 
   BeginQuery(GL_TIME_ELAPSED, m_timestamp_queries[m_write_timestamp_query]);
+  if (m_scope_timestamps_supported)
+  {
+    const auto QueryCounter = gles ? glQueryCounterEXT : glQueryCounter;
+    ScopeTimestampQueries& sq = m_scope_timestamp_queries[m_write_timestamp_query];
+    QueryCounter(sq.queries[0], GL_TIMESTAMP);
+    sq.first_scope = static_cast<u8>(m_gpu_timing_scope);
+    sq.num_queries = 0;
+  }
+
   m_timestamp_query_started = true;
 }
 
+void OpenGLHostDisplay::OnGPUTimingScopeChanged(u32 scope)
+{
+  ScopeTimestampQueries& sq = m_scope_timestamp_queries[m_write_timestamp_query];
+  if (!m_timestamp_query_started || !m_scope_timestamps_supported || sq.num_queries == MAX_SCOPE_TIMESTAMP_QUERIES)
+    return;
+
+  const auto QueryCounter = m_gl_context->IsGLES() ? glQueryCounterEXT : glQueryCounter;
+  sq.scope_ids[sq.num_queries] = static_cast<u8>(scope);
+  QueryCounter(sq.queries[2 + sq.num_queries], GL_TIMESTAMP);
+  sq.num_queries++;
+}
+
 bool OpenGLHostDisplay::SetGPUTimingEnabled(bool enabled)
 {
   if (m_gpu_timing_enabled == enabled)
@@ -1132,6 +1237,13 @@ float OpenGLHostDisplay::GetAndResetAccumulatedGPUTime()
   return value;
 }
 
+HostDisplay::GPUTimingScopeTimes OpenGLHostDisplay::GetAndResetAccumulatedGPUTimingScopeTimes()
+{
+  const GPUTimingScopeTimes value = m_accumulated_scope_times;
+  m_accumulated_scope_times = {};
+  return value;
+}
+
 GL::StreamBuffer* OpenGLHostDisplay::GetTextureStreamBuffer()
 {
   if (m_use_gles2_draw_path || m_texture_stream_buffer)
@@ -11,6 +11,7 @@
 #include "common/window_info.h"
 #include "core/host_display.h"
 #include "postprocessing_chain.h"
+#include <array>
 #include <memory>
 
 class OpenGLHostDisplay final : public HostDisplay
@@ -60,6 +61,7 @@ public:
 
   bool SetGPUTimingEnabled(bool enabled) override;
   float GetAndResetAccumulatedGPUTime() override;
+  GPUTimingScopeTimes GetAndResetAccumulatedGPUTimingScopeTimes() override;
 
   ALWAYS_INLINE GL::Context* GetGLContext() const { return m_gl_context.get(); }
   ALWAYS_INLINE bool UsePBOForUploads() const { return m_use_pbo_for_pixels; }
@@ -70,6 +72,7 @@ public:
 
 protected:
   static constexpr u8 NUM_TIMESTAMP_QUERIES = 3;
+  static constexpr u32 MAX_SCOPE_TIMESTAMP_QUERIES = 64;
 
   const char* GetGLSLVersionString() const;
   std::string GetGLSLVersionHeader() const;
@@ -91,13 +94,13 @@ protected:
                      s32 texture_view_y, s32 texture_view_width, s32 texture_view_height, bool linear_filter);
   void RenderSoftwareCursor(s32 left, s32 bottom, s32 width, s32 height, GPUTexture* texture_handle);
 
-  struct PostProcessingStage
+  struct PostProcessingPass
   {
     GL::Program program;
-    GL::Texture output_texture;
     u32 uniforms_size;
   };
 
+  bool CompilePostProcessingPasses();
   bool CheckPostProcessingRenderTargets(u32 target_width, u32 target_height);
   void ApplyPostProcessingChain(GLuint final_target, s32 final_left, s32 final_top, s32 final_width, s32 final_height,
                                 GL::Texture* texture, s32 texture_view_x, s32 texture_view_y, s32 texture_view_width,
@@ -107,6 +110,16 @@ protected:
   void DestroyTimestampQueries();
   void PopTimestampQuery();
   void KickTimestampQuery();
+  void OnGPUTimingScopeChanged(u32 scope) override;
+
+  struct ScopeTimestampQueries
+  {
+    // [0] = start, [1] = end, [2..] = scope switches
+    std::array<GLuint, 2 + MAX_SCOPE_TIMESTAMP_QUERIES> queries;
+    std::array<u8, MAX_SCOPE_TIMESTAMP_QUERIES> scope_ids;
+    u32 num_queries = 0;
+    u8 first_scope = 0;
+  };
 
   std::unique_ptr<GL::Context> m_gl_context;
 
@@ -123,9 +136,11 @@ protected:
   u32 m_texture_stream_buffer_offset = 0;
 
   FrontendCommon::PostProcessingChain m_post_processing_chain;
-  GL::Texture m_post_processing_input_texture;
+
+  // Passes alternate between two targets of the same size, [0] receives the display and is the first pass's input.
+  std::array<GL::Texture, 2> m_post_processing_textures;
   std::unique_ptr<GL::StreamBuffer> m_post_processing_ubo;
-  std::vector<PostProcessingStage> m_post_processing_stages;
+  std::vector<PostProcessingPass> m_post_processing_passes;
   Common::Timer m_post_processing_timer;
 
   std::array<GLuint, NUM_TIMESTAMP_QUERIES> m_timestamp_queries = {};
@@ -135,6 +150,10 @@ protected:
   u8 m_waiting_timestamp_queries = 0;
   bool m_timestamp_query_started = false;
 
+  std::array<ScopeTimestampQueries, NUM_TIMESTAMP_QUERIES> m_scope_timestamp_queries = {};
+  GPUTimingScopeTimes m_accumulated_scope_times = {};
+  bool m_scope_timestamps_supported = false;
+
   bool m_use_gles2_draw_path = false;
   bool m_use_pbo_for_pixels = false;
 };
@@ -39,6 +39,7 @@ PostProcessingChain::~PostProcessingChain() = default;
 void PostProcessingChain::AddShader(PostProcessingShader shader)
 {
   m_shaders.push_back(std::move(shader));
+  UpdatePasses();
 }
 
 bool PostProcessingChain::AddStage(const std::string_view& name)
@@ -48,9 +49,56 @@ bool PostProcessingChain::AddStage(const std::string_view& name)
     return false;
 
   m_shaders.push_back(std::move(shader));
+  UpdatePasses();
   return true;
 }
 
+void PostProcessingChain::SetFusionEnabled(bool enabled)
+{
+  if (m_fusion_enabled == enabled)
+    return;
+
+  m_fusion_enabled = enabled;
+  UpdatePasses();
+}
+
+bool PostProcessingChain::HasFusedPasses() const
+{
+  return (m_passes.size() != m_shaders.size());
+}
+
+bool PostProcessingChain::HasConflictingOptions(const Pass& pass, const PostProcessingShader& shader) const
+{
+  // fused stages share a uniform block, so option names have to be unique within the pass
+  for (u32 i = 0; i < pass.num_stages; i++)
+  {
+    for (const PostProcessingShader::Option& option : shader.GetOptions())
+    {
+      if (m_shaders[pass.first_stage + i].GetOptionByName(option.name))
+        return true;
+    }
+  }
+
+  return false;
+}
+
+void PostProcessingChain::UpdatePasses()
+{
+  m_passes.clear();
+
+  for (u32 i = 0; i < static_cast<u32>(m_shaders.size()); i++)
+  {
+    if (m_fusion_enabled && !m_passes.empty() && m_shaders[i].SamplesOnlyCurrentPixel() &&
+        !HasConflictingOptions(m_passes.back(), m_shaders[i]))
+    {
+      m_passes.back().num_stages++;
+      continue;
+    }
+
+    m_passes.push_back(Pass{i, 1});
+  }
+}
+
 std::string PostProcessingChain::GetConfigString() const
 {
   std::stringstream ss;
@@ -72,6 +120,70 @@ std::string PostProcessingChain::GetConfigString() const
   return ss.str();
 }
 
+std::vector<std::string> PostProcessingChain::GetStageNames() const
+{
+  std::vector<std::string> names;
+  names.reserve(m_shaders.size());
+  for (const PostProcessingShader& shader : m_shaders)
+    names.push_back(shader.GetName());
+
+  return names;
+}
+
+std::vector<std::string> PostProcessingChain::GetPassNames() const
+{
+  std::vector<std::string> names;
+  names.reserve(m_passes.size());
+  for (const Pass& pass : m_passes)
+  {
+    std::string name(m_shaders[pass.first_stage].GetName());
+    for (u32 i = 1; i < pass.num_stages; i++)
+    {
+      name += " + ";
+      name += m_shaders[pass.first_stage + i].GetName();
+    }
+
+    names.push_back(std::move(name));
+  }
+
+  return names;
+}
+
+bool PostProcessingChain::PassUsesPushConstants(u32 pass) const
+{
+  return GetPassUniformsSize(pass) <= PostProcessingShader::PUSH_CONSTANT_SIZE_THRESHOLD;
+}
+
+u32 PostProcessingChain::GetPassUniformsSize(u32 pass) const
+{
+  // options of the fused stages follow the first stage's uniforms
+  const Pass& p = m_passes[pass];
+  u32 size = m_shaders[p.first_stage].GetUniformsSize();
+  for (u32 i = 1; i < p.num_stages; i++)
+    size += m_shaders[p.first_stage + i].GetOptionUniformsSize();
+
+  return size;
+}
+
+void PostProcessingChain::FillPassUniformBuffer(u32 pass, void* buffer, u32 texture_width, s32 texture_height,
+                                                s32 texture_view_x, s32 texture_view_y, s32 texture_view_width,
+                                                s32 texture_view_height, u32 window_width, u32 window_height,
+                                                s32 original_width, s32 original_height, float time) const
+{
+  const Pass& p = m_passes[pass];
+  const PostProcessingShader& first = m_shaders[p.first_stage];
+  first.FillUniformBuffer(buffer, texture_width, texture_height, texture_view_x, texture_view_y, texture_view_width,
+                          texture_view_height, window_width, window_height, original_width, original_height, time);
+
+  u8* option_values = static_cast<u8*>(buffer) + first.GetUniformsSize();
+  for (u32 i = 1; i < p.num_stages; i++)
+  {
+    const PostProcessingShader& shader = m_shaders[p.first_stage + i];
+    shader.FillOptionUniformBuffer(option_values);
+    option_values += shader.GetOptionUniformsSize();
+  }
+}
+
 bool PostProcessingChain::CreateFromString(const std::string_view& chain_config)
 {
   std::vector<PostProcessingShader> shaders;
@@ -111,7 +223,8 @@ bool PostProcessingChain::CreateFromString(const std::string_view& chain_config)
   }
 
   m_shaders = std::move(shaders);
-  Log_InfoPrintf("Loaded postprocessing chain of %zu shaders", m_shaders.size());
+  UpdatePasses();
+  Log_InfoPrintf("Loaded postprocessing chain of %zu shaders in %zu passes", m_shaders.size(), m_passes.size());
   return true;
 }
 
@@ -153,6 +266,7 @@ void PostProcessingChain::RemoveStage(u32 index)
 {
   Assert(index < m_shaders.size());
   m_shaders.erase(m_shaders.begin() + index);
+  UpdatePasses();
 }
 
 void PostProcessingChain::MoveStageUp(u32 index)
@@ -164,6 +278,7 @@ void PostProcessingChain::MoveStageUp(u32 index)
   PostProcessingShader shader = std::move(m_shaders[index]);
   m_shaders.erase(m_shaders.begin() + index);
   m_shaders.insert(m_shaders.begin() + (index - 1u), std::move(shader));
+  UpdatePasses();
 }
 
 void PostProcessingChain::MoveStageDown(u32 index)
@@ -175,11 +290,13 @@ void PostProcessingChain::MoveStageDown(u32 index)
   PostProcessingShader shader = std::move(m_shaders[index]);
   m_shaders.erase(m_shaders.begin() + index);
   m_shaders.insert(m_shaders.begin() + (index + 1u), std::move(shader));
+  UpdatePasses();
 }
 
 void PostProcessingChain::ClearStages()
 {
   m_shaders.clear();
+  m_passes.clear();
 }
 
 } // namespace FrontendCommon
\ No newline at end of file
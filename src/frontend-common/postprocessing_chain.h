@@ -11,6 +11,14 @@ namespace FrontendCommon {
 class PostProcessingChain
 {
 public:
+  /// Consecutive stages which are rendered with a single draw. Only the first stage of a pass reads the input
+  /// texture, the remaining stages operate on the previous stage's output for the current pixel.
+  struct Pass
+  {
+    u32 first_stage;
+    u32 num_stages;
+  };
+
   PostProcessingChain();
   ~PostProcessingChain();
 
@@ -19,6 +27,12 @@ public:
   ALWAYS_INLINE const PostProcessingShader& GetShaderStage(u32 i) const { return m_shaders[i]; }
   ALWAYS_INLINE PostProcessingShader& GetShaderStage(u32 i) { return m_shaders[i]; }
 
+  ALWAYS_INLINE u32 GetPassCount() const { return static_cast<u32>(m_passes.size()); }
+  ALWAYS_INLINE const Pass& GetPass(u32 i) const { return m_passes[i]; }
+  ALWAYS_INLINE bool IsFusionEnabled() const { return m_fusion_enabled; }
+  void SetFusionEnabled(bool enabled);
+  bool HasFusedPasses() const;
+
   void AddShader(PostProcessingShader shader);
   bool AddStage(const std::string_view& name);
   void RemoveStage(u32 index);
@@ -27,13 +41,26 @@ public:
   void ClearStages();
 
   std::string GetConfigString() const;
+  std::vector<std::string> GetStageNames() const;
+  std::vector<std::string> GetPassNames() const;
+
+  bool PassUsesPushConstants(u32 pass) const;
+  u32 GetPassUniformsSize(u32 pass) const;
+  void FillPassUniformBuffer(u32 pass, void* buffer, u32 texture_width, s32 texture_height, s32 texture_view_x,
+                             s32 texture_view_y, s32 texture_view_width, s32 texture_view_height, u32 window_width,
+                             u32 window_height, s32 original_width, s32 original_height, float time) const;
 
   bool CreateFromString(const std::string_view& chain_config);
 
   static std::vector<std::string> GetAvailableShaderNames();
 
 private:
+  bool HasConflictingOptions(const Pass& pass, const PostProcessingShader& shader) const;
+  void UpdatePasses();
+
   std::vector<PostProcessingShader> m_shaders;
+  std::vector<Pass> m_passes;
+  bool m_fusion_enabled = false;
 };
 
 } // namespace FrontendCommon
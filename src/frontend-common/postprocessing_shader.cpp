@@ -238,6 +238,20 @@ void PostProcessingShader::SetConfigString(const std::string_view& str)
   }
 }
 
+bool PostProcessingShader::SamplesOnlyCurrentPixel() const
+{
+  // Conservative, any direct texture access or sampling at another location needs the whole input image.
+  static constexpr std::array<const char*, 4> non_local_tokens = {
+    {"SampleLocation", "SampleOffset", "texture", "samp0"}};
+  for (const char* token : non_local_tokens)
+  {
+    if (m_code.find(token) != std::string::npos)
+      return false;
+  }
+
+  return true;
+}
+
 bool PostProcessingShader::UsePushConstants() const
 {
   return GetUniformsSize() <= PUSH_CONSTANT_SIZE_THRESHOLD;
@@ -246,7 +260,12 @@ bool PostProcessingShader::UsePushConstants() const
 u32 PostProcessingShader::GetUniformsSize() const
 {
   // lazy packing. todo improve.
-  return sizeof(CommonUniforms) + (sizeof(Option::ValueVector) * static_cast<u32>(m_options.size()));
+  return sizeof(CommonUniforms) + GetOptionUniformsSize();
+}
+
+u32 PostProcessingShader::GetOptionUniformsSize() const
+{
+  return sizeof(Option::ValueVector) * static_cast<u32>(m_options.size());
 }
 
 void PostProcessingShader::FillUniformBuffer(void* buffer, u32 texture_width, s32 texture_height, s32 texture_view_x,
@@ -285,7 +304,12 @@ void PostProcessingShader::FillUniformBuffer(void* buffer, u32 texture_width, s3
 
   common->time = time;
 
-  u8* option_values = reinterpret_cast<u8*>(common + 1);
+  FillOptionUniformBuffer(common + 1);
+}
+
+void PostProcessingShader::FillOptionUniformBuffer(void* buffer) const
+{
+  u8* option_values = static_cast<u8*>(buffer);
   for (const Option& option : m_options)
   {
     std::memcpy(option_values, option.value.data(), sizeof(Option::ValueVector));
@@ -82,11 +82,17 @@ public:
   bool LoadFromFile(std::string name, const char* filename);
   bool LoadFromString(std::string name, std::string code);
 
+  /// Returns true if the shader only ever reads its input at the current coordinates, i.e. through Sample().
+  /// Such shaders can be fused into the shader of the previous stage, skipping the intermediate render target.
+  bool SamplesOnlyCurrentPixel() const;
+
   bool UsePushConstants() const;
   u32 GetUniformsSize() const;
+  u32 GetOptionUniformsSize() const;
   void FillUniformBuffer(void* buffer, u32 texture_width, s32 texture_height, s32 texture_view_x, s32 texture_view_y,
                          s32 texture_view_width, s32 texture_view_height, u32 window_width, u32 window_height,
                          s32 original_width, s32 original_height, float time) const;
+  void FillOptionUniformBuffer(void* buffer) const;
 
 private:
   struct CommonUniforms
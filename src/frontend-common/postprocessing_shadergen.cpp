@@ -12,13 +12,14 @@ PostProcessingShaderGen::PostProcessingShaderGen(RenderAPI render_api, bool supp
 
 PostProcessingShaderGen::~PostProcessingShaderGen() = default;
 
-std::string PostProcessingShaderGen::GeneratePostProcessingVertexShader(const PostProcessingShader& shader)
+std::string PostProcessingShaderGen::GeneratePostProcessingVertexShader(const PostProcessingChain& chain,
+                                                                        u32 pass_index)
 {
   std::stringstream ss;
 
   WriteHeader(ss);
   DeclareTexture(ss, "samp0", 0);
-  WriteUniformBuffer(ss, shader, shader.UsePushConstants());
+  WriteUniformBuffer(ss, chain, pass_index);
 
   DeclareVertexEntryPoint(ss, {}, 0, 1, {}, true);
   ss << R"(
@@ -35,21 +36,26 @@ std::string PostProcessingShaderGen::GeneratePostProcessingVertexShader(const Po
   return ss.str();
 }
 
-std::string PostProcessingShaderGen::GeneratePostProcessingFragmentShader(const PostProcessingShader& shader)
+std::string PostProcessingShaderGen::GeneratePostProcessingFragmentShader(const PostProcessingChain& chain,
+                                                                          u32 pass_index)
 {
+  const PostProcessingChain::Pass& pass = chain.GetPass(pass_index);
+  const bool fused = (pass.num_stages > 1);
   std::stringstream ss;
 
   WriteHeader(ss);
   DeclareTexture(ss, "samp0", 0);
-  WriteUniformBuffer(ss, shader, shader.UsePushConstants());
+  WriteUniformBuffer(ss, chain, pass_index);
 
   // Rename main, since we need to set up globals
   if (!m_glsl)
   {
     // TODO: vecn -> floatn
 
+    if (!fused)
+      ss << "#define main real_main\n";
+
     ss << R"(
-#define main real_main
 static float2 v_tex0;
 static float4 v_pos;
 static float4 o_col0;
@@ -129,7 +135,13 @@ void SetOutput(float4 color)
 #define OptionEnabled(x) ((x) != 0)
 )";
 
-  ss << shader.GetCode();
+  if (fused)
+  {
+    WriteFusedStages(ss, chain, pass_index);
+    return ss.str();
+  }
+
+  ss << chain.GetShaderStage(pass.first_stage).GetCode();
 
   if (!m_glsl)
   {
@@ -148,12 +160,57 @@ void main(in float2 v_tex0_ : TEXCOORD0, in float4 v_pos_ : SV_Position, out flo
   return ss.str();
 }
 
-void PostProcessingShaderGen::WriteUniformBuffer(std::stringstream& ss, const PostProcessingShader& shader,
-                                                 bool use_push_constants)
+void PostProcessingShaderGen::WriteFusedStages(std::stringstream& ss, const PostProcessingChain& chain,
+                                               u32 pass_index)
+{
+  // Each stage's main() is renamed, and later stages read the previous stage's output instead of sampling.
+  // The intermediate value is clamped, since it would otherwise have been written to a UNORM render target.
+  const PostProcessingChain::Pass& pass = chain.GetPass(pass_index);
+  ss << "\nGLOBAL float4 pp_stage_input;\n";
+  for (u32 i = 0; i < pass.num_stages; i++)
+  {
+    if (i == 1)
+      ss << "#define Sample() (pp_stage_input)\n";
+
+    ss << "#define main pp_stage" << i << "_main\n";
+    ss << chain.GetShaderStage(pass.first_stage + i).GetCode() << "\n";
+    ss << "#undef main\n";
+  }
+  ss << "#undef Sample\n";
+
+  if (!m_glsl)
+  {
+    ss << "void main(in float2 v_tex0_ : TEXCOORD0, in float4 v_pos_ : SV_Position, out float4 o_col0_ : SV_Target)\n";
+    ss << "{\n";
+    ss << "  v_pos = v_pos_;\n";
+    ss << "  v_tex0 = v_tex0_;\n";
+  }
+  else
+  {
+    ss << "void main()\n";
+    ss << "{\n";
+  }
+
+  for (u32 i = 0; i < pass.num_stages; i++)
+  {
+    if (i > 0)
+      ss << "  pp_stage_input = saturate(o_col0);\n";
+    ss << "  pp_stage" << i << "_main();\n";
+  }
+
+  if (!m_glsl)
+    ss << "  o_col0_ = o_col0;\n";
+
+  ss << "}\n";
+}
+
+void PostProcessingShaderGen::WriteUniformBuffer(std::stringstream& ss, const PostProcessingChain& chain,
+                                                 u32 pass_index)
 {
+  const PostProcessingChain::Pass& pass = chain.GetPass(pass_index);
   u32 pad_counter = 0;
 
-  WriteUniformBufferDeclaration(ss, use_push_constants);
+  WriteUniformBufferDeclaration(ss, chain.PassUsesPushConstants(pass_index));
   ss << "{\n";
   ss << "  float4 src_rect;\n";
   ss << "  float2 src_size;\n";
@@ -169,32 +226,35 @@ void PostProcessingShaderGen::WriteUniformBuffer(std::stringstream& ss, const Po
 
   static constexpr std::array<const char*, PostProcessingShader::Option::MAX_VECTOR_COMPONENTS + 1> vector_size_suffix =
     {{"", "", "2", "3", "4"}};
-  for (const PostProcessingShader::Option& option : shader.GetOptions())
+  for (u32 stage = 0; stage < pass.num_stages; stage++)
   {
-    switch (option.type)
+    for (const PostProcessingShader::Option& option : chain.GetShaderStage(pass.first_stage + stage).GetOptions())
     {
-      case PostProcessingShader::Option::Type::Bool:
-        ss << "  int " << option.name << ";\n";
-        for (u32 i = option.vector_size; i < PostProcessingShader::Option::MAX_VECTOR_COMPONENTS; i++)
-          ss << "  int ubo_pad" << (pad_counter++) << ";\n";
-        break;
-
-      case PostProcessingShader::Option::Type::Int:
+      switch (option.type)
       {
-        ss << "  int" << vector_size_suffix[option.vector_size] << " " << option.name << ";\n";
-        for (u32 i = option.vector_size; i < PostProcessingShader::Option::MAX_VECTOR_COMPONENTS; i++)
-          ss << "  int ubo_pad" << (pad_counter++) << ";\n";
-      }
-      break;
+        case PostProcessingShader::Option::Type::Bool:
+          ss << "  int " << option.name << ";\n";
+          for (u32 i = option.vector_size; i < PostProcessingShader::Option::MAX_VECTOR_COMPONENTS; i++)
+            ss << "  int ubo_pad" << (pad_counter++) << ";\n";
+          break;
 
-      case PostProcessingShader::Option::Type::Float:
-      default:
-      {
-        ss << "  float" << vector_size_suffix[option.vector_size] << " " << option.name << ";\n";
-        for (u32 i = option.vector_size; i < PostProcessingShader::Option::MAX_VECTOR_COMPONENTS; i++)
-          ss << "  float ubo_pad" << (pad_counter++) << ";\n";
+        case PostProcessingShader::Option::Type::Int:
+        {
+          ss << "  int" << vector_size_suffix[option.vector_size] << " " << option.name << ";\n";
+          for (u32 i = option.vector_size; i < PostProcessingShader::Option::MAX_VECTOR_COMPONENTS; i++)
+            ss << "  int ubo_pad" << (pad_counter++) << ";\n";
+        }
+        break;
+
+        case PostProcessingShader::Option::Type::Float:
+        default:
+        {
+          ss << "  float" << vector_size_suffix[option.vector_size] << " " << option.name << ";\n";
+          for (u32 i = option.vector_size; i < PostProcessingShader::Option::MAX_VECTOR_COMPONENTS; i++)
+            ss << "  float ubo_pad" << (pad_counter++) << ";\n";
+        }
+        break;
       }
-      break;
     }
   }
 
@@ -3,7 +3,7 @@
 
 #pragma once
 #include "core/shadergen.h"
-#include "postprocessing_shader.h"
+#include "postprocessing_chain.h"
 #include <sstream>
 
 namespace FrontendCommon {
@@ -14,11 +14,12 @@ public:
   PostProcessingShaderGen(RenderAPI render_api, bool supports_dual_source_blend);
   ~PostProcessingShaderGen();
 
-  std::string GeneratePostProcessingVertexShader(const PostProcessingShader& shader);
-  std::string GeneratePostProcessingFragmentShader(const PostProcessingShader& shader);
+  std::string GeneratePostProcessingVertexShader(const PostProcessingChain& chain, u32 pass_index);
+  std::string GeneratePostProcessingFragmentShader(const PostProcessingChain& chain, u32 pass_index);
 
 private:
-  void WriteUniformBuffer(std::stringstream& ss, const PostProcessingShader& shader, bool use_push_constants);
+  void WriteUniformBuffer(std::stringstream& ss, const PostProcessingChain& chain, u32 pass_index);
+  void WriteFusedStages(std::stringstream& ss, const PostProcessingChain& chain, u32 pass_index);
 };
 
 } // namespace FrontendCommon
\ No newline at end of file
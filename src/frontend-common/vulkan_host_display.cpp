@@ -211,12 +211,15 @@ bool VulkanHostDisplay::SupportsTextureFormat(GPUTexture::Format format) const
 
 void VulkanHostDisplay::SetVSync(bool enabled)
 {
-  if (!m_swap_chain || m_swap_chain->IsVSyncEnabled() == enabled)
+  if (!m_swap_chain || (m_swap_chain->IsVSyncEnabled() == enabled &&
+                        m_swap_chain->IsTripleBufferingEnabled() == g_settings.display_triple_buffering))
+  {
     return;
+  }
 
   // This swap chain should not be used by the current buffer, thus safe to destroy.
   g_vulkan_context->WaitForGPUIdle();
-  m_swap_chain->SetVSync(enabled);
+  m_swap_chain->SetVSync(enabled, g_settings.display_triple_buffering);
   m_vsync_enabled = m_swap_chain->IsVSyncEnabled();
 }
 
@@ -551,9 +554,12 @@ void VulkanHostDisplay::DestroyResources()
   Vulkan::Util::SafeDestroyPipelineLayout(m_post_process_ubo_pipeline_layout);
   Vulkan::Util::SafeDestroyDescriptorSetLayout(m_post_process_descriptor_set_layout);
   Vulkan::Util::SafeDestroyDescriptorSetLayout(m_post_process_ubo_descriptor_set_layout);
-  m_post_processing_input_texture.Destroy(false);
-  Vulkan::Util::SafeDestroyFramebuffer(m_post_processing_input_framebuffer);
-  m_post_processing_stages.clear();
+  for (u32 i = 0; i < static_cast<u32>(m_post_processing_textures.size()); i++)
+  {
+    m_post_processing_textures[i].Destroy(false);
+    Vulkan::Util::SafeDestroyFramebuffer(m_post_processing_framebuffers[i]);
+  }
+  m_post_processing_passes.clear();
   m_post_processing_ubo.Destroy(true);
   m_post_processing_chain.ClearStages();
 
@@ -658,6 +664,7 @@ bool VulkanHostDisplay::Render(bool skip_present)
 
     RenderDisplay();
 
+    SetGPUTimingScope(GPUTimingScope::Overlays);
     if (ImGui::GetCurrentContext())
       RenderImGui();
 
@@ -673,6 +680,7 @@ bool VulkanHostDisplay::Render(bool skip_present)
                                         m_swap_chain->GetRenderingFinishedSemaphore(), m_swap_chain->GetSwapChain(),
                                         m_swap_chain->GetCurrentImageIndex(), !m_swap_chain->IsVSyncEnabled());
   g_vulkan_context->MoveToNextCommandBuffer();
+  SetGPUTimingScope(GPUTimingScope::Other);
 
   return true;
 }
@@ -792,6 +800,7 @@ void VulkanHostDisplay::RenderDisplay()
 {
   const Vulkan::Util::DebugScope debugScope(g_vulkan_context->GetCurrentCommandBuffer(),
                                             "VulkanHostDisplay::RenderDisplay");
+  SetGPUTimingScope(GPUTimingScope::Display);
   if (!HasDisplayTexture())
   {
     BeginSwapChainRenderPass(m_swap_chain->GetCurrentFramebuffer(), m_swap_chain->GetWidth(),
@@ -858,7 +867,13 @@ void VulkanHostDisplay::RenderImGui()
 {
   const Vulkan::Util::DebugScope debugScope(g_vulkan_context->GetCurrentCommandBuffer(), "Imgui");
   ImGui::Render();
-  ImGui_ImplVulkan_RenderDrawData(ImGui::GetDrawData());
+
+  // nothing on screen most of the time while playing, so skip setting up the pipeline state
+  ImDrawData* draw_data = ImGui::GetDrawData();
+  if (draw_data->TotalVtxCount == 0)
+    return;
+
+  ImGui_ImplVulkan_RenderDrawData(draw_data);
 }
 
 void VulkanHostDisplay::RenderSoftwareCursor()
@@ -914,6 +929,17 @@ float VulkanHostDisplay::GetAndResetAccumulatedGPUTime()
   return g_vulkan_context->GetAndResetAccumulatedGPUTime();
 }
 
+HostDisplay::GPUTimingScopeTimes VulkanHostDisplay::GetAndResetAccumulatedGPUTimingScopeTimes()
+{
+  static_assert(MAX_GPU_TIMING_SCOPES == Vulkan::Context::MAX_TIMING_SCOPES);
+  return g_vulkan_context->GetAndResetAccumulatedScopeTimes();
+}
+
+void VulkanHostDisplay::OnGPUTimingScopeChanged(u32 scope)
+{
+  g_vulkan_context->SetTimingScope(scope);
+}
+
 HostDisplay::AdapterAndModeList VulkanHostDisplay::StaticGetAdapterAndModeList(const WindowInfo* wi)
 {
   AdapterAndModeList ret;
@@ -954,21 +980,15 @@ HostDisplay::AdapterAndModeList VulkanHostDisplay::StaticGetAdapterAndModeList(c
   return ret;
 }
 
-VulkanHostDisplay::PostProcessingStage::PostProcessingStage(PostProcessingStage&& move)
-  : pipeline(move.pipeline), output_framebuffer(move.output_framebuffer),
-    output_texture(std::move(move.output_texture)), uniforms_size(move.uniforms_size)
+VulkanHostDisplay::PostProcessingPass::PostProcessingPass(PostProcessingPass&& move)
+  : pipeline(move.pipeline), uniforms_size(move.uniforms_size), name(std::move(move.name))
 {
-  move.output_framebuffer = VK_NULL_HANDLE;
   move.pipeline = VK_NULL_HANDLE;
   move.uniforms_size = 0;
 }
 
-VulkanHostDisplay::PostProcessingStage::~PostProcessingStage()
+VulkanHostDisplay::PostProcessingPass::~PostProcessingPass()
 {
-  if (output_framebuffer != VK_NULL_HANDLE)
-    g_vulkan_context->DeferFramebufferDestruction(output_framebuffer);
-
-  output_texture.Destroy(true);
   if (pipeline != VK_NULL_HANDLE)
     g_vulkan_context->DeferPipelineDestruction(pipeline);
 }
@@ -979,43 +999,83 @@ bool VulkanHostDisplay::SetPostProcessingChain(const std::string_view& config)
 
   if (config.empty())
   {
-    m_post_processing_stages.clear();
+    m_post_processing_passes.clear();
     m_post_processing_chain.ClearStages();
+    SetPostProcessingGPUTimingScopeNames({});
     return true;
   }
 
   if (!m_post_processing_chain.CreateFromString(config))
     return false;
 
-  m_post_processing_stages.clear();
+  m_post_processing_chain.SetFusionEnabled(g_settings.display_post_process_fusion);
+  if (!CompilePostProcessingPasses())
+  {
+    // shaders which are fine on their own can still clash when fused, e.g. duplicate function names
+    if (!m_post_processing_chain.HasFusedPasses())
+    {
+      m_post_processing_chain.ClearStages();
+      return false;
+    }
+
+    Log_WarningPrintf("Failed to compile fused post-processing passes, retrying with one pass per shader.");
+    m_post_processing_chain.SetFusionEnabled(false);
+    if (!CompilePostProcessingPasses())
+    {
+      m_post_processing_chain.ClearStages();
+      return false;
+    }
+  }
 
-  FrontendCommon::PostProcessingShaderGen shadergen(RenderAPI::Vulkan, false);
   bool only_use_push_constants = true;
+  for (u32 i = 0; i < m_post_processing_chain.GetPassCount(); i++)
+    only_use_push_constants &= m_post_processing_chain.PassUsesPushConstants(i);
+
+  constexpr u32 UBO_SIZE = 1 * 1024 * 1024;
+  if (!only_use_push_constants && m_post_processing_ubo.GetCurrentSize() < UBO_SIZE &&
+      !m_post_processing_ubo.Create(VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, UBO_SIZE))
+  {
+    Log_ErrorPrintf("Failed to allocate %u byte uniform buffer for postprocessing", UBO_SIZE);
+    m_post_processing_passes.clear();
+    m_post_processing_chain.ClearStages();
+    return false;
+  }
+  Vulkan::Util::SetObjectName(g_vulkan_context->GetDevice(), m_post_processing_ubo.GetBuffer(),
+                              "Post Processing Uniform Buffer");
+  m_post_processing_timer.Reset();
+  SetPostProcessingGPUTimingScopeNames(m_post_processing_chain.GetPassNames());
+  return true;
+}
+
+bool VulkanHostDisplay::CompilePostProcessingPasses()
+{
+  m_post_processing_passes.clear();
+
+  FrontendCommon::PostProcessingShaderGen shadergen(RenderAPI::Vulkan, false);
+  const std::vector<std::string> pass_names(m_post_processing_chain.GetPassNames());
 
-  for (u32 i = 0; i < m_post_processing_chain.GetStageCount(); i++)
+  for (u32 i = 0; i < m_post_processing_chain.GetPassCount(); i++)
   {
-    const FrontendCommon::PostProcessingShader& shader = m_post_processing_chain.GetShaderStage(i);
-    const std::string vs = shadergen.GeneratePostProcessingVertexShader(shader);
-    const std::string ps = shadergen.GeneratePostProcessingFragmentShader(shader);
-    const bool use_push_constants = shader.UsePushConstants();
-    only_use_push_constants &= use_push_constants;
+    const std::string vs = shadergen.GeneratePostProcessingVertexShader(m_post_processing_chain, i);
+    const std::string ps = shadergen.GeneratePostProcessingFragmentShader(m_post_processing_chain, i);
+    const bool use_push_constants = m_post_processing_chain.PassUsesPushConstants(i);
 
-    PostProcessingStage stage;
-    stage.uniforms_size = shader.GetUniformsSize();
+    PostProcessingPass pass;
+    pass.uniforms_size = m_post_processing_chain.GetPassUniformsSize(i);
+    pass.name = pass_names[i];
 
     VkShaderModule vs_mod = g_vulkan_shader_cache->GetVertexShader(vs);
     VkShaderModule fs_mod = g_vulkan_shader_cache->GetFragmentShader(ps);
     if (vs_mod == VK_NULL_HANDLE || fs_mod == VK_NULL_HANDLE)
     {
-      Log_ErrorPrintf("Failed to compile one or more post-processing shaders, disabling.");
+      Log_ErrorPrintf("Failed to compile one or more post-processing shaders.");
 
       if (vs_mod != VK_NULL_HANDLE)
         vkDestroyShaderModule(g_vulkan_context->GetDevice(), vs_mod, nullptr);
       if (fs_mod != VK_NULL_HANDLE)
-        vkDestroyShaderModule(g_vulkan_context->GetDevice(), vs_mod, nullptr);
+        vkDestroyShaderModule(g_vulkan_context->GetDevice(), fs_mod, nullptr);
 
-      m_post_processing_stages.clear();
-      m_post_processing_chain.ClearStages();
+      m_post_processing_passes.clear();
       return false;
     }
 
@@ -1031,91 +1091,63 @@ bool VulkanHostDisplay::SetPostProcessingChain(const std::string_view& config)
                                                      m_post_process_ubo_pipeline_layout);
     gpbuilder.SetRenderPass(GetRenderPassForDisplay(), 0);
 
-    stage.pipeline = gpbuilder.Create(g_vulkan_context->GetDevice(), g_vulkan_shader_cache->GetPipelineCache());
+    pass.pipeline = gpbuilder.Create(g_vulkan_context->GetDevice(), g_vulkan_shader_cache->GetPipelineCache());
     vkDestroyShaderModule(g_vulkan_context->GetDevice(), vs_mod, nullptr);
     vkDestroyShaderModule(g_vulkan_context->GetDevice(), fs_mod, nullptr);
-    if (!stage.pipeline)
+    if (!pass.pipeline)
     {
-      Log_ErrorPrintf("Failed to compile one or more post-processing pipelines, disabling.");
-      m_post_processing_stages.clear();
-      m_post_processing_chain.ClearStages();
+      Log_ErrorPrintf("Failed to compile one or more post-processing pipelines.");
+      m_post_processing_passes.clear();
       return false;
     }
-    Vulkan::Util::SetObjectName(g_vulkan_context->GetDevice(), stage.pipeline, (shader.GetName() + "Pipeline").c_str());
+    Vulkan::Util::SetObjectName(g_vulkan_context->GetDevice(), pass.pipeline, (pass.name + " Pipeline").c_str());
 
-    m_post_processing_stages.push_back(std::move(stage));
+    m_post_processing_passes.push_back(std::move(pass));
   }
 
-  constexpr u32 UBO_SIZE = 1 * 1024 * 1024;
-  if (!only_use_push_constants && m_post_processing_ubo.GetCurrentSize() < UBO_SIZE &&
-      !m_post_processing_ubo.Create(VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, UBO_SIZE))
-  {
-    Log_ErrorPrintf("Failed to allocate %u byte uniform buffer for postprocessing", UBO_SIZE);
-    m_post_processing_stages.clear();
-    m_post_processing_chain.ClearStages();
-    return false;
-  }
-  Vulkan::Util::SetObjectName(g_vulkan_context->GetDevice(), m_post_processing_ubo.GetBuffer(),
-                              "Post Processing Uniform Buffer");
-  m_post_processing_timer.Reset();
   return true;
 }
 
 bool VulkanHostDisplay::CheckPostProcessingRenderTargets(u32 target_width, u32 target_height)
 {
-  DebugAssert(!m_post_processing_stages.empty());
+  DebugAssert(!m_post_processing_passes.empty());
 
-  if (m_post_processing_input_texture.GetWidth() != target_width ||
-      m_post_processing_input_texture.GetHeight() != target_height)
+  // a single pass goes straight from the display copy to the final target
+  const u32 target_count = (m_post_processing_passes.size() > 1) ? 2u : 1u;
+  const VkFormat format = m_swap_chain->GetTextureFormat();
+  for (u32 i = 0; i < static_cast<u32>(m_post_processing_textures.size()); i++)
   {
-    if (m_post_processing_input_framebuffer != VK_NULL_HANDLE)
+    Vulkan::Texture& texture = m_post_processing_textures[i];
+    VkFramebuffer& framebuffer = m_post_processing_framebuffers[i];
+    if (i < target_count && texture.GetWidth() == target_width && texture.GetHeight() == target_height &&
+        texture.GetVkFormat() == format)
     {
-      g_vulkan_context->DeferFramebufferDestruction(m_post_processing_input_framebuffer);
-      m_post_processing_input_framebuffer = VK_NULL_HANDLE;
+      continue;
     }
 
-    if (!m_post_processing_input_texture.Create(target_width, target_height, 1, 1, m_swap_chain->GetTextureFormat(),
-                                                VK_SAMPLE_COUNT_1_BIT, VK_IMAGE_VIEW_TYPE_2D, VK_IMAGE_TILING_OPTIMAL,
-                                                VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT) ||
-        (m_post_processing_input_framebuffer =
-           m_post_processing_input_texture.CreateFramebuffer(GetRenderPassForDisplay())) == VK_NULL_HANDLE)
+    if (framebuffer != VK_NULL_HANDLE)
     {
-      return false;
+      g_vulkan_context->DeferFramebufferDestruction(framebuffer);
+      framebuffer = VK_NULL_HANDLE;
     }
-    Vulkan::Util::SetObjectName(g_vulkan_context->GetDevice(), m_post_processing_input_texture.GetImage(),
-                                "Post Processing Input Texture");
-    Vulkan::Util::SetObjectName(g_vulkan_context->GetDevice(), m_post_processing_input_texture.GetView(),
-                                "Post Processing Input Texture View");
-    Vulkan::Util::SetObjectName(g_vulkan_context->GetDevice(), m_post_processing_input_texture.GetAllocation(),
-                                "Post Processing Input Texture Memory");
-  }
 
-  const u32 target_count = (static_cast<u32>(m_post_processing_stages.size()) - 1);
-  for (u32 i = 0; i < target_count; i++)
-  {
-    PostProcessingStage& pps = m_post_processing_stages[i];
-    if (pps.output_texture.GetWidth() != target_width || pps.output_texture.GetHeight() != target_height)
+    if (i >= target_count)
     {
-      if (pps.output_framebuffer != VK_NULL_HANDLE)
-      {
-        g_vulkan_context->DeferFramebufferDestruction(pps.output_framebuffer);
-        pps.output_framebuffer = VK_NULL_HANDLE;
-      }
+      texture.Destroy(true);
+      continue;
+    }
 
-      if (!pps.output_texture.Create(target_width, target_height, 1, 1, m_swap_chain->GetTextureFormat(),
-                                     VK_SAMPLE_COUNT_1_BIT, VK_IMAGE_VIEW_TYPE_2D, VK_IMAGE_TILING_OPTIMAL,
-                                     VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT) ||
-          (pps.output_framebuffer = pps.output_texture.CreateFramebuffer(GetRenderPassForDisplay())) == VK_NULL_HANDLE)
-      {
-        return false;
-      }
-      Vulkan::Util::SetObjectName(g_vulkan_context->GetDevice(), pps.output_texture.GetImage(),
-                                  "Post Processing Output Texture %u", i);
-      Vulkan::Util::SetObjectName(g_vulkan_context->GetDevice(), pps.output_texture.GetAllocation(),
-                                  "Post Processing Output Texture Memory %u", i);
-      Vulkan::Util::SetObjectName(g_vulkan_context->GetDevice(), pps.output_texture.GetView(),
-                                  "Post Processing Output Texture View %u", i);
+    if (!texture.Create(target_width, target_height, 1, 1, format, VK_SAMPLE_COUNT_1_BIT, VK_IMAGE_VIEW_TYPE_2D,
+                        VK_IMAGE_TILING_OPTIMAL, VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT) ||
+        (framebuffer = texture.CreateFramebuffer(GetRenderPassForDisplay())) == VK_NULL_HANDLE)
+    {
+      return false;
     }
+    Vulkan::Util::SetObjectName(g_vulkan_context->GetDevice(), texture.GetImage(), "Post Processing Texture %u", i);
+    Vulkan::Util::SetObjectName(g_vulkan_context->GetDevice(), texture.GetView(), "Post Processing Texture View %u",
+                                i);
+    Vulkan::Util::SetObjectName(g_vulkan_context->GetDevice(), texture.GetAllocation(),
+                                "Post Processing Texture Memory %u", i);
   }
 
   return true;
@@ -1138,40 +1170,45 @@ void VulkanHostDisplay::ApplyPostProcessingChain(VkFramebuffer target_fb, s32 fi
   }
 
   // downsample/upsample - use same viewport for remainder
-  m_post_processing_input_texture.TransitionToLayout(cmdbuffer, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
-  BeginSwapChainRenderPass(m_post_processing_input_framebuffer, target_width, target_height);
+  Vulkan::Texture& input_texture = m_post_processing_textures[0];
+  input_texture.TransitionToLayout(cmdbuffer, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
+  BeginSwapChainRenderPass(m_post_processing_framebuffers[0], target_width, target_height);
   RenderDisplay(final_left, final_top, final_width, final_height, texture, texture_view_x, texture_view_y,
                 texture_view_width, texture_view_height, IsUsingLinearFiltering());
   vkCmdEndRenderPass(cmdbuffer);
   Vulkan::Util::EndDebugScope(g_vulkan_context->GetCurrentCommandBuffer());
-  m_post_processing_input_texture.TransitionToLayout(cmdbuffer, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+  input_texture.TransitionToLayout(cmdbuffer, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
 
   const s32 orig_texture_width = texture_view_width;
   const s32 orig_texture_height = texture_view_height;
-  texture = &m_post_processing_input_texture;
+  texture = &input_texture;
   texture_view_x = final_left;
   texture_view_y = final_top;
   texture_view_width = final_width;
   texture_view_height = final_height;
 
-  const u32 final_stage = static_cast<u32>(m_post_processing_stages.size()) - 1u;
-  for (u32 i = 0; i < static_cast<u32>(m_post_processing_stages.size()); i++)
+  const u32 final_pass = static_cast<u32>(m_post_processing_passes.size()) - 1u;
+  for (u32 i = 0; i < static_cast<u32>(m_post_processing_passes.size()); i++)
   {
-    PostProcessingStage& pps = m_post_processing_stages[i];
-    const Vulkan::Util::DebugScope stage_scope(g_vulkan_context->GetCurrentCommandBuffer(), "Post Processing Stage: %s",
-                                               m_post_processing_chain.GetShaderStage(i).GetName().c_str());
-
-    if (i != final_stage)
+    PostProcessingPass& ppp = m_post_processing_passes[i];
+    SetPostProcessingGPUTimingScope(i);
+    const Vulkan::Util::DebugScope pass_scope(g_vulkan_context->GetCurrentCommandBuffer(), "Post Processing Pass: %s",
+                                              ppp.name.c_str());
+
+    // pass N reads target N % 2, and writes to the other one
+    const u32 output_index = (i + 1) & 1u;
+    Vulkan::Texture& output_texture = m_post_processing_textures[output_index];
+    if (i != final_pass)
     {
-      pps.output_texture.TransitionToLayout(cmdbuffer, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
-      BeginSwapChainRenderPass(pps.output_framebuffer, target_width, target_height);
+      output_texture.TransitionToLayout(cmdbuffer, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
+      BeginSwapChainRenderPass(m_post_processing_framebuffers[output_index], target_width, target_height);
     }
     else
     {
       BeginSwapChainRenderPass(target_fb, target_width, target_height);
     }
 
-    const bool use_push_constants = m_post_processing_chain.GetShaderStage(i).UsePushConstants();
+    const bool use_push_constants = m_post_processing_chain.PassUsesPushConstants(i);
     VkDescriptorSet ds = g_vulkan_context->AllocateDescriptorSet(
       use_push_constants ? m_post_process_descriptor_set_layout : m_post_process_ubo_descriptor_set_layout);
     if (ds == VK_NULL_HANDLE)
@@ -1186,14 +1223,14 @@ void VulkanHostDisplay::ApplyPostProcessingChain(VkFramebuffer target_fb, s32 fi
     if (use_push_constants)
     {
       u8 buffer[FrontendCommon::PostProcessingShader::PUSH_CONSTANT_SIZE_THRESHOLD];
-      Assert(pps.uniforms_size <= sizeof(buffer));
-      m_post_processing_chain.GetShaderStage(i).FillUniformBuffer(
-        buffer, texture->GetWidth(), texture->GetHeight(), texture_view_x, texture_view_y, texture_view_width,
+      Assert(ppp.uniforms_size <= sizeof(buffer));
+      m_post_processing_chain.FillPassUniformBuffer(
+        i, buffer, texture->GetWidth(), texture->GetHeight(), texture_view_x, texture_view_y, texture_view_width,
         texture_view_height, GetWindowWidth(), GetWindowHeight(), orig_texture_width, orig_texture_height,
         static_cast<float>(m_post_processing_timer.GetTimeSeconds()));
 
       vkCmdPushConstants(cmdbuffer, m_post_process_pipeline_layout,
-                         VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT, 0, pps.uniforms_size, buffer);
+                         VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT, 0, ppp.uniforms_size, buffer);
 
       dsupdate.Update(g_vulkan_context->GetDevice());
       vkCmdBindDescriptorSets(cmdbuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_post_process_pipeline_layout, 0, 1, &ds, 0,
@@ -1201,36 +1238,36 @@ void VulkanHostDisplay::ApplyPostProcessingChain(VkFramebuffer target_fb, s32 fi
     }
     else
     {
-      if (!m_post_processing_ubo.ReserveMemory(pps.uniforms_size,
+      if (!m_post_processing_ubo.ReserveMemory(ppp.uniforms_size,
                                                static_cast<u32>(g_vulkan_context->GetUniformBufferAlignment())))
       {
         Panic("Failed to reserve space in post-processing UBO");
       }
 
       const u32 offset = m_post_processing_ubo.GetCurrentOffset();
-      m_post_processing_chain.GetShaderStage(i).FillUniformBuffer(
-        m_post_processing_ubo.GetCurrentHostPointer(), texture->GetWidth(), texture->GetHeight(), texture_view_x,
+      m_post_processing_chain.FillPassUniformBuffer(
+        i, m_post_processing_ubo.GetCurrentHostPointer(), texture->GetWidth(), texture->GetHeight(), texture_view_x,
         texture_view_y, texture_view_width, texture_view_height, GetWindowWidth(), GetWindowHeight(),
         orig_texture_width, orig_texture_height, static_cast<float>(m_post_processing_timer.GetTimeSeconds()));
-      m_post_processing_ubo.CommitMemory(pps.uniforms_size);
+      m_post_processing_ubo.CommitMemory(ppp.uniforms_size);
 
       dsupdate.AddBufferDescriptorWrite(ds, 0, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC,
-                                        m_post_processing_ubo.GetBuffer(), 0, pps.uniforms_size);
+                                        m_post_processing_ubo.GetBuffer(), 0, ppp.uniforms_size);
       dsupdate.Update(g_vulkan_context->GetDevice());
       vkCmdBindDescriptorSets(cmdbuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_post_process_ubo_pipeline_layout, 0, 1, &ds,
                               1, &offset);
     }
 
-    vkCmdBindPipeline(cmdbuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pps.pipeline);
+    vkCmdBindPipeline(cmdbuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, ppp.pipeline);
 
     vkCmdDraw(cmdbuffer, 3, 1, 0, 0);
 
-    if (i != final_stage)
+    if (i != final_pass)
     {
       vkCmdEndRenderPass(cmdbuffer);
       Vulkan::Util::EndDebugScope(g_vulkan_context->GetCurrentCommandBuffer());
-      pps.output_texture.TransitionToLayout(cmdbuffer, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
-      texture = &pps.output_texture;
+      output_texture.TransitionToLayout(cmdbuffer, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+      texture = &output_texture;
     }
   }
 }
@@ -9,6 +9,7 @@
 #include "common/window_info.h"
 #include "core/host_display.h"
 #include "postprocessing_chain.h"
+#include <array>
 #include <memory>
 #include <string_view>
 
@@ -64,6 +65,7 @@ public:
 
   bool SetGPUTimingEnabled(bool enabled) override;
   float GetAndResetAccumulatedGPUTime() override;
+  GPUTimingScopeTimes GetAndResetAccumulatedGPUTimingScopeTimes() override;
 
   static AdapterAndModeList StaticGetAdapterAndModeList(const WindowInfo* wi);
 
@@ -76,18 +78,20 @@ protected:
     float src_rect_height;
   };
 
-  struct PostProcessingStage
+  struct PostProcessingPass
   {
-    PostProcessingStage() = default;
-    PostProcessingStage(PostProcessingStage&& move);
-    ~PostProcessingStage();
+    PostProcessingPass() = default;
+    PostProcessingPass(PostProcessingPass&& move);
+    ~PostProcessingPass();
 
     VkPipeline pipeline = VK_NULL_HANDLE;
-    VkFramebuffer output_framebuffer = VK_NULL_HANDLE;
-    Vulkan::Texture output_texture;
     u32 uniforms_size = 0;
+    std::string name;
   };
 
+  void OnGPUTimingScopeChanged(u32 scope) override;
+
+  bool CompilePostProcessingPasses();
   bool CheckPostProcessingRenderTargets(u32 target_width, u32 target_height);
   void ApplyPostProcessingChain(VkFramebuffer target_fb, s32 final_left, s32 final_top, s32 final_width,
                                 s32 final_height, Vulkan::Texture* texture, s32 texture_view_x, s32 texture_view_y,
@@ -136,9 +140,12 @@ protected:
   VkPipelineLayout m_post_process_ubo_pipeline_layout = VK_NULL_HANDLE;
 
   FrontendCommon::PostProcessingChain m_post_processing_chain;
-  Vulkan::Texture m_post_processing_input_texture;
-  VkFramebuffer m_post_processing_input_framebuffer = VK_NULL_HANDLE;
+
+  // All passes render at the target size in the swap chain format, so the passes alternate between two targets
+  // regardless of the chain length. [0] receives the display, and is the input of the first pass.
+  std::array<Vulkan::Texture, 2> m_post_processing_textures;
+  std::array<VkFramebuffer, 2> m_post_processing_framebuffers{};
   Vulkan::StreamBuffer m_post_processing_ubo;
-  std::vector<PostProcessingStage> m_post_processing_stages;
+  std::vector<PostProcessingPass> m_post_processing_passes;
   Common::Timer m_post_processing_timer;
 };
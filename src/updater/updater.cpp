@@ -8,11 +8,16 @@
 #include "common/string_util.h"
 #include "common/win32_progress_callback.h"
 #include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <cstdio>
 #include <cstring>
 #include <memory>
+#include <mutex>
 #include <set>
 #include <string>
+#include <thread>
 #include <vector>
 
 #ifdef _WIN32
@@ -52,6 +57,8 @@ bool Updater::OpenUpdateZip(const char* path)
   if (!m_zf)
     return false;
 
+  m_zip_path = path;
+
   m_progress->SetStatusText("Parsing update zip...");
   return ParseZip();
 }
@@ -70,7 +77,7 @@ bool Updater::RecursiveDeleteDirectory(const char* path)
 
   return (SHFileOperationW(&op) == 0 && !op.fAnyOperationsAborted);
 #else
-  return FileSystem::DeleteDirectory(path, true);
+  return FileSystem::RecursiveDeleteDirectory(path);
 #endif
 }
 
@@ -95,6 +102,14 @@ bool Updater::ParseZip()
 
     FileToUpdate entry;
     entry.original_zip_filename = zip_filename_buffer;
+    entry.uncompressed_size = file_info.uncompressed_size;
+    entry.crc32 = static_cast<u32>(file_info.crc);
+    entry.changed = true;
+    if (unzGetFilePos64(m_zf, &entry.zip_position) != UNZ_OK)
+    {
+      m_progress->ModalError("unzGetFilePos64() failed");
+      return false;
+    }
 
     // replace forward slashes with backslashes
     size_t len = std::strlen(zip_filename_buffer);
@@ -195,72 +210,200 @@ bool Updater::PrepareStagingDirectory()
   return true;
 }
 
-bool Updater::StageUpdate()
+bool Updater::IsFileUnchanged(const char* path, u64 expected_size, u32 expected_crc32)
 {
-  m_progress->SetProgressRange(static_cast<u32>(m_update_paths.size()));
-  m_progress->SetProgressValue(0);
+  FILESYSTEM_STAT_DATA sd;
+  if (!FileSystem::StatFile(path, &sd) || static_cast<u64>(sd.Size) != expected_size)
+    return false;
 
-  for (const FileToUpdate& ftu : m_update_paths)
+  std::FILE* fp = FileSystem::OpenCFile(path, "rb");
+  if (!fp)
+    return false;
+
+  static constexpr u32 CHUNK_SIZE = 65536;
+  std::unique_ptr<u8[]> buffer = std::make_unique<u8[]>(CHUNK_SIZE);
+  uLong crc = crc32(0L, Z_NULL, 0);
+  size_t bytes_read;
+  while ((bytes_read = std::fread(buffer.get(), 1, CHUNK_SIZE, fp)) > 0)
+    crc = crc32(crc, buffer.get(), static_cast<uInt>(bytes_read));
+
+  const bool result = (std::ferror(fp) == 0 && static_cast<u32>(crc) == expected_crc32);
+  std::fclose(fp);
+  return result;
+}
+
+bool Updater::StageFile(unzFile zf, FileToUpdate& ftu, std::string* error)
+{
+  // the zip's central directory doubles as the manifest: files which already match are left alone
+  const std::string installed_file = StringUtil::StdStringFromFormat(
+    "%s" FS_OSPATH_SEPARATOR_STR "%s", m_destination_directory.c_str(), ftu.destination_filename.c_str());
+  if (IsFileUnchanged(installed_file.c_str(), ftu.uncompressed_size, ftu.crc32))
+  {
+    ftu.changed = false;
+    return true;
+  }
+
+  if (unzGoToFilePos64(zf, &ftu.zip_position) != UNZ_OK)
+  {
+    *error = StringUtil::StdStringFromFormat("Unable to locate file '%s' in zip", ftu.original_zip_filename.c_str());
+    return false;
+  }
+  else if (unzOpenCurrentFile(zf) != UNZ_OK)
+  {
+    *error = StringUtil::StdStringFromFormat("Failed to open file '%s' in zip", ftu.original_zip_filename.c_str());
+    return false;
+  }
+
+  const std::string destination_file = StringUtil::StdStringFromFormat(
+    "%s" FS_OSPATH_SEPARATOR_STR "%s", m_staging_directory.c_str(), ftu.destination_filename.c_str());
+  std::FILE* fp = FileSystem::OpenCFile(destination_file.c_str(), "wb");
+  if (!fp)
   {
-    m_progress->SetFormattedStatusText("Extracting '%s'...", ftu.original_zip_filename.c_str());
+    *error = StringUtil::StdStringFromFormat("Failed to open staging output file '%s'", destination_file.c_str());
+    unzCloseCurrentFile(zf);
+    return false;
+  }
 
-    if (unzLocateFile(m_zf, ftu.original_zip_filename.c_str(), 0) != UNZ_OK)
+  static constexpr u32 CHUNK_SIZE = 65536;
+  std::unique_ptr<u8[]> buffer = std::make_unique<u8[]>(CHUNK_SIZE);
+  for (;;)
+  {
+    int byte_count = unzReadCurrentFile(zf, buffer.get(), CHUNK_SIZE);
+    if (byte_count < 0)
     {
-      m_progress->DisplayFormattedModalError("Unable to locate file '%s' in zip", ftu.original_zip_filename.c_str());
+      *error = StringUtil::StdStringFromFormat("Failed to read file '%s' from zip", ftu.original_zip_filename.c_str());
+      std::fclose(fp);
+      FileSystem::DeleteFile(destination_file.c_str());
+      unzCloseCurrentFile(zf);
       return false;
     }
-    else if (unzOpenCurrentFile(m_zf) != UNZ_OK)
+    else if (byte_count == 0)
     {
-      m_progress->DisplayFormattedModalError("Failed to open file '%s' in zip", ftu.original_zip_filename.c_str());
+      // end of file
+      break;
+    }
+
+    if (std::fwrite(buffer.get(), static_cast<size_t>(byte_count), 1, fp) != 1)
+    {
+      *error = StringUtil::StdStringFromFormat("Failed to write to file '%s'", destination_file.c_str());
+      std::fclose(fp);
+      FileSystem::DeleteFile(destination_file.c_str());
+      unzCloseCurrentFile(zf);
       return false;
     }
+  }
 
-    m_progress->DisplayFormattedInformation("Extracting '%s'...", ftu.destination_filename.c_str());
+  std::fclose(fp);
 
-    const std::string destination_file = StringUtil::StdStringFromFormat(
-      "%s" FS_OSPATH_SEPARATOR_STR "%s", m_staging_directory.c_str(), ftu.destination_filename.c_str());
-    std::FILE* fp = FileSystem::OpenCFile(destination_file.c_str(), "wb");
-    if (!fp)
+  // minizip checks the CRC of the decompressed data when the file is closed after a full read
+  if (unzCloseCurrentFile(zf) != UNZ_OK)
+  {
+    *error = StringUtil::StdStringFromFormat("CRC mismatch in '%s'", ftu.original_zip_filename.c_str());
+    FileSystem::DeleteFile(destination_file.c_str());
+    return false;
+  }
+
+  return true;
+}
+
+bool Updater::StageUpdate()
+{
+  const u32 num_files = static_cast<u32>(m_update_paths.size());
+  const u32 num_workers = std::clamp<u32>(std::thread::hardware_concurrency(), 1u, std::min(num_files, 8u));
+
+  m_progress->SetStatusText("Extracting changed files...");
+  m_progress->SetProgressRange(num_files);
+  m_progress->SetProgressValue(0);
+
+  std::mutex mutex;
+  std::condition_variable done_cv;
+  std::atomic<u32> next_file{0};
+  std::atomic<u32> files_done{0};
+  std::atomic_bool failed{false};
+  std::string error;
+  u32 workers_running = 0;
+
+  // Workers pull files off a shared index, each through its own unzFile since minizip handles aren't thread-safe.
+  // The progress callback is only touched from this thread.
+  auto worker = [this, num_files, &mutex, &done_cv, &next_file, &files_done, &failed, &error, &workers_running]() {
+    std::string worker_error;
+    unzFile zf = MinizipHelpers::OpenUnzFile(m_zip_path.c_str());
+    if (!zf)
     {
-      m_progress->DisplayFormattedModalError("Failed to open staging output file '%s'", destination_file.c_str());
-      unzCloseCurrentFile(m_zf);
-      return false;
+      worker_error = StringUtil::StdStringFromFormat("Failed to reopen update zip '%s'", m_zip_path.c_str());
+      failed.store(true);
     }
 
-    static constexpr u32 CHUNK_SIZE = 4096;
-    u8 buffer[CHUNK_SIZE];
-    for (;;)
+    while (zf && !failed.load(std::memory_order_relaxed))
     {
-      int byte_count = unzReadCurrentFile(m_zf, buffer, CHUNK_SIZE);
-      if (byte_count < 0)
-      {
-        m_progress->DisplayFormattedModalError("Failed to read file '%s' from zip", ftu.original_zip_filename.c_str());
-        std::fclose(fp);
-        FileSystem::DeleteFile(destination_file.c_str());
-        unzCloseCurrentFile(m_zf);
-        return false;
-      }
-      else if (byte_count == 0)
-      {
-        // end of file
+      const u32 index = next_file.fetch_add(1, std::memory_order_relaxed);
+      if (index >= num_files)
         break;
-      }
 
-      if (std::fwrite(buffer, static_cast<size_t>(byte_count), 1, fp) != 1)
+      if (!StageFile(zf, m_update_paths[index], &worker_error))
       {
-        m_progress->DisplayFormattedModalError("Failed to write to file '%s'", destination_file.c_str());
-        std::fclose(fp);
-        FileSystem::DeleteFile(destination_file.c_str());
-        unzCloseCurrentFile(m_zf);
-        return false;
+        failed.store(true);
+        break;
       }
+
+      files_done.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    if (zf)
+      unzClose(zf);
+
+    std::unique_lock lock(mutex);
+    if (!worker_error.empty() && error.empty())
+      error = std::move(worker_error);
+    workers_running--;
+    done_cv.notify_all();
+  };
+
+  std::vector<std::thread> threads;
+  {
+    std::unique_lock lock(mutex);
+    workers_running = num_workers;
+  }
+  for (u32 i = 0; i < num_workers; i++)
+    threads.emplace_back(worker);
+
+  {
+    std::unique_lock lock(mutex);
+    while (workers_running > 0)
+    {
+      done_cv.wait_for(lock, std::chrono::milliseconds(100));
+
+      lock.unlock();
+      m_progress->SetProgressValue(files_done.load());
+      lock.lock();
     }
+  }
+
+  for (std::thread& thread : threads)
+    thread.join();
 
-    std::fclose(fp);
-    unzCloseCurrentFile(m_zf);
-    m_progress->IncrementProgressValue();
+  if (failed.load())
+  {
+    m_progress->DisplayFormattedModalError("%s", error.c_str());
+    return false;
   }
 
+  u32 files_changed = 0;
+  for (const FileToUpdate& ftu : m_update_paths)
+  {
+    if (ftu.changed)
+    {
+      m_progress->DisplayFormattedInformation("Extracted '%s'", ftu.destination_filename.c_str());
+      files_changed++;
+    }
+    else
+    {
+      m_progress->DisplayFormattedDebugMessage("Skipping unchanged '%s'", ftu.destination_filename.c_str());
+    }
+  }
+
+  m_progress->DisplayFormattedInformation("%u of %u files changed", files_changed, num_files);
+  m_progress->SetProgressValue(num_files);
   return true;
 }
 
@@ -284,6 +427,9 @@ bool Updater::CommitUpdate()
   // move files to target
   for (const FileToUpdate& ftu : m_update_paths)
   {
+    if (!ftu.changed)
+      continue;
+
     const std::string staging_file_name = StringUtil::StdStringFromFormat(
       "%s" FS_OSPATH_SEPARATOR_STR "%s", m_staging_directory.c_str(), ftu.destination_filename.c_str());
     const std::string dest_file_name = StringUtil::StdStringFromFormat(
@@ -28,10 +28,18 @@ private:
   {
     std::string original_zip_filename;
     std::string destination_filename;
+    unz64_file_pos zip_position;
+    u64 uncompressed_size;
+    u32 crc32;
+    bool changed;
   };
 
   bool ParseZip();
 
+  static bool IsFileUnchanged(const char* path, u64 expected_size, u32 expected_crc32);
+  bool StageFile(unzFile zf, FileToUpdate& ftu, std::string* error);
+
+  std::string m_zip_path;
   std::string m_destination_directory;
   std::string m_staging_directory;
 
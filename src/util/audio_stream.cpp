@@ -8,7 +8,9 @@
 #include "common/log.h"
 #include "common/make_array.h"
 #include "common/platform.h"
+#include "common/threading.h"
 #include "common/timer.h"
+#include "common/trace.h"
 #include <algorithm>
 #include <cmath>
 #include <cstring>
@@ -38,6 +40,7 @@ AudioStream::AudioStream(u32 sample_rate, u32 channels, u32 buffer_ms, AudioStre
 
 AudioStream::~AudioStream()
 {
+  StopStretchThread();
   DestroyBuffer();
 }
 
@@ -65,8 +68,9 @@ u32 AudioStream::GetMSForBufferSize(u32 sample_rate, u32 buffer_size)
   return (buffer_size * 1000u) / sample_rate;
 }
 
-static constexpr const auto s_stretch_mode_names = make_array("None", "Resample", "TimeStretch");
-static constexpr const auto s_stretch_mode_display_names = make_array("None", "Resampling", "Time Stretching");
+static constexpr const auto s_stretch_mode_names = make_array("None", "Resample", "TimeStretch", "RateControl");
+static constexpr const auto s_stretch_mode_display_names =
+  make_array("None", "Resampling", "Time Stretching", "Dynamic Rate Control");
 
 const char* AudioStream::GetStretchModeName(AudioStretchMode mode)
 {
@@ -100,6 +104,7 @@ u32 AudioStream::GetBufferedFramesRelaxed() const
 
 void AudioStream::ReadFrames(s16* bData, u32 nFrames)
 {
+  TRACE_SCOPE("AudioReadFrames");
   const u32 available_frames = GetBufferedFramesRelaxed();
   u32 frames_to_read = nFrames;
   u32 silence_frames = 0;
@@ -126,6 +131,7 @@ void AudioStream::ReadFrames(s16* bData, u32 nFrames)
     silence_frames = frames_to_read - available_frames;
     frames_to_read = available_frames;
     m_filling = true;
+    m_underrun_count.fetch_add(1, std::memory_order_relaxed);
 
     if (m_stretch_mode == AudioStretchMode::TimeStretch)
       StretchUnderrun();
@@ -263,7 +269,10 @@ void AudioStream::DestroyBuffer()
 
 void AudioStream::EmptyBuffer()
 {
-  if (m_stretch_mode != AudioStretchMode::Off)
+  auto lock = LockStretcher();
+  m_stretch_queue_count = 0;
+
+  if (m_soundtouch)
   {
     m_soundtouch->clear();
     if (m_stretch_mode == AudioStretchMode::TimeStretch)
@@ -275,6 +284,7 @@ void AudioStream::EmptyBuffer()
 
 void AudioStream::SetNominalRate(float tempo)
 {
+  auto lock = LockStretcher();
   m_nominal_rate = tempo;
   if (m_stretch_mode == AudioStretchMode::Resample)
     m_soundtouch->setRate(tempo);
@@ -285,6 +295,8 @@ void AudioStream::UpdateTargetTempo(float tempo)
   if (m_stretch_mode != AudioStretchMode::TimeStretch)
     return;
 
+  auto lock = LockStretcher();
+
   // undo sqrt()
   if (tempo)
     tempo *= tempo;
@@ -309,8 +321,9 @@ void AudioStream::SetStretchMode(AudioStretchMode mode)
   if (!paused)
     SetPaused(true);
 
-  DestroyBuffer();
+  // stop the worker thread before freeing the buffer it writes to
   StretchDestroy();
+  DestroyBuffer();
   m_stretch_mode = mode;
 
   AllocateBuffer();
@@ -321,6 +334,18 @@ void AudioStream::SetStretchMode(AudioStretchMode mode)
     SetPaused(false);
 }
 
+void AudioStream::SetStretchThreaded(bool enabled)
+{
+  if (m_stretch_threaded == enabled)
+    return;
+
+  m_stretch_threaded = enabled;
+  if (!enabled)
+    StopStretchThread();
+  else if (m_soundtouch)
+    StartStretchThread();
+}
+
 void AudioStream::SetPaused(bool paused)
 {
   m_paused = paused;
@@ -356,8 +381,12 @@ void AudioStream::EndWrite(u32 num_frames)
 
   m_staging_buffer_pos = 0;
 
-  if (m_stretch_mode != AudioStretchMode::Off)
-    StretchWrite();
+  if (m_stretch_thread.joinable())
+    QueueStretchChunk(m_staging_buffer.data());
+  else if (m_stretch_mode == AudioStretchMode::RateControl)
+    RateControlWrite(m_staging_buffer.data());
+  else if (m_stretch_mode != AudioStretchMode::Off)
+    StretchWrite(m_staging_buffer.data());
   else
     InternalWriteFrames(m_staging_buffer.data(), CHUNK_SIZE);
 }
@@ -507,6 +536,14 @@ void AudioStream::StretchAllocate()
   if (m_stretch_mode == AudioStretchMode::Off)
     return;
 
+  // rate control doesn't need soundtouch
+  if (m_stretch_mode == AudioStretchMode::RateControl)
+  {
+    RateControlReset();
+    m_staging_buffer_pos = 0;
+    return;
+  }
+
   m_soundtouch = std::make_unique<soundtouch::SoundTouch>();
   m_soundtouch->setSampleRate(m_sample_rate);
   m_soundtouch->setChannels(m_channels);
@@ -531,24 +568,29 @@ void AudioStream::StretchAllocate()
   m_average_available = 0;
 
   m_staging_buffer_pos = 0;
+
+  if (m_stretch_threaded)
+    StartStretchThread();
 }
 
 void AudioStream::StretchDestroy()
 {
+  StopStretchThread();
   m_soundtouch.reset();
 }
 
-void AudioStream::StretchWrite()
+void AudioStream::StretchWrite(s32* chunk)
 {
-  S16ChunkToFloat(m_staging_buffer.data(), m_float_buffer.data());
+  S16ChunkToFloat(chunk, m_float_buffer.data());
 
   m_soundtouch->putSamples(m_float_buffer.data(), CHUNK_SIZE);
 
+  // the input chunk has been consumed, so it can hold the output
   int tempProgress;
   while (tempProgress = m_soundtouch->receiveSamples((float*)m_float_buffer.data(), CHUNK_SIZE), tempProgress != 0)
   {
-    FloatChunkToS16(m_staging_buffer.data(), m_float_buffer.data(), tempProgress);
-    InternalWriteFrames(m_staging_buffer.data(), tempProgress);
+    FloatChunkToS16(chunk, m_float_buffer.data(), tempProgress);
+    InternalWriteFrames(chunk, tempProgress);
   }
 
   if (m_stretch_mode == AudioStretchMode::TimeStretch)
@@ -684,3 +726,169 @@ void AudioStream::StretchOverrun()
   const u32 discard = CHUNK_SIZE * 2;
   m_rpos.store((m_rpos.load(std::memory_order_acquire) + discard) % m_buffer_size, std::memory_order_release);
 }
+
+void AudioStream::StartStretchThread()
+{
+  if (m_stretch_thread.joinable())
+    return;
+
+  if (!m_stretch_queue)
+    m_stretch_queue = std::make_unique<s32[]>(STRETCH_QUEUE_CHUNKS * CHUNK_SIZE);
+
+  m_stretch_queue_rpos = 0;
+  m_stretch_queue_count = 0;
+  m_stretch_thread_busy = false;
+  m_stretch_thread_shutdown = false;
+  m_stretch_thread = std::thread(&AudioStream::StretchThreadEntryPoint, this);
+}
+
+void AudioStream::StopStretchThread()
+{
+  if (!m_stretch_thread.joinable())
+    return;
+
+  {
+    std::unique_lock lock(m_stretch_mutex);
+    m_stretch_thread_shutdown = true;
+    m_stretch_wake_cv.notify_one();
+  }
+
+  m_stretch_thread.join();
+}
+
+void AudioStream::StretchThreadEntryPoint()
+{
+  Threading::SetNameOfCurrentThread("Audio Stretch Thread");
+  Threading::ApplyAffinityPolicy(Threading::AffinityClass::Background);
+
+  std::unique_lock lock(m_stretch_mutex);
+  for (;;)
+  {
+    m_stretch_wake_cv.wait(lock, [this]() { return (m_stretch_queue_count > 0 || m_stretch_thread_shutdown); });
+
+    // finish off anything queued before shutting down
+    if (m_stretch_queue_count == 0)
+      break;
+
+    std::memcpy(m_stretch_chunk.data(), &m_stretch_queue[m_stretch_queue_rpos * CHUNK_SIZE],
+                sizeof(s32) * CHUNK_SIZE);
+    m_stretch_queue_rpos = (m_stretch_queue_rpos + 1) % STRETCH_QUEUE_CHUNKS;
+    m_stretch_queue_count--;
+    m_stretch_thread_busy = true;
+    lock.unlock();
+
+    StretchWrite(m_stretch_chunk.data());
+
+    lock.lock();
+    m_stretch_thread_busy = false;
+    m_stretch_done_cv.notify_one();
+  }
+}
+
+void AudioStream::QueueStretchChunk(const s32* chunk)
+{
+  std::unique_lock lock(m_stretch_mutex);
+
+  // if the worker has fallen this far behind, we would have had to do the work ourselves anyway
+  m_stretch_done_cv.wait(lock, [this]() { return (m_stretch_queue_count < STRETCH_QUEUE_CHUNKS); });
+
+  const u32 wpos = (m_stretch_queue_rpos + m_stretch_queue_count) % STRETCH_QUEUE_CHUNKS;
+  std::memcpy(&m_stretch_queue[wpos * CHUNK_SIZE], chunk, sizeof(s32) * CHUNK_SIZE);
+  m_stretch_queue_count++;
+  m_stretch_wake_cv.notify_one();
+}
+
+std::unique_lock<std::mutex> AudioStream::LockStretcher()
+{
+  std::unique_lock lock(m_stretch_mutex);
+  m_stretch_done_cv.wait(lock, [this]() { return !m_stretch_thread_busy; });
+  return lock;
+}
+
+ALWAYS_INLINE static s32 InterpolateFrame(s32 frame0, s32 frame1, s32 frac)
+{
+  const s32 left0 = static_cast<s16>(static_cast<u32>(frame0));
+  const s32 right0 = static_cast<s16>(static_cast<u32>(frame0) >> 16);
+  const s32 left1 = static_cast<s16>(static_cast<u32>(frame1));
+  const s32 right1 = static_cast<s16>(static_cast<u32>(frame1) >> 16);
+  const s32 left = left0 + (((left1 - left0) * frac) >> 15);
+  const s32 right = right0 + (((right1 - right0) * frac) >> 15);
+  return static_cast<s32>((static_cast<u32>(left) & 0xFFFFu) | (static_cast<u32>(right) << 16));
+}
+
+void AudioStream::RateControlReset()
+{
+  m_rate_control_position = 0;
+  m_rate_control_last_frame = 0;
+  m_rate_control_target = m_target_buffer_size;
+  m_rate_control_frames_since_underrun = 0;
+  m_rate_control_last_underrun_count = m_underrun_count.load(std::memory_order_relaxed);
+}
+
+void AudioStream::RateControlWrite(const s32* chunk)
+{
+  // Small enough to not be audible as a pitch change.
+  static constexpr float MAX_RATE_DEVIATION = 0.005f;
+
+  UpdateRateControlTarget();
+
+  // Consume input faster when we're above the target, and slower when below.
+  const float target = static_cast<float>(m_rate_control_target);
+  const float error = std::clamp((static_cast<float>(GetBufferedFramesRelaxed()) - target) / target, -1.0f, 1.0f);
+  const float ratio = m_nominal_rate * (1.0f + (error * MAX_RATE_DEVIATION));
+  const u32 step = std::max(static_cast<u32>(ratio * 65536.0f), 1u);
+
+  // Position is 16.16 fixed point, where index 0 interpolates from the last frame of the previous chunk.
+  alignas(16) std::array<s32, CHUNK_SIZE> output;
+  u32 output_frames = 0;
+  u32 position = m_rate_control_position;
+  while ((position >> 16) < CHUNK_SIZE)
+  {
+    const u32 index = position >> 16;
+    const s32 frac = static_cast<s32>((position & 0xFFFFu) >> 1);
+    const s32 frame0 = (index == 0) ? m_rate_control_last_frame : chunk[index - 1];
+    output[output_frames++] = InterpolateFrame(frame0, chunk[index], frac);
+    if (output_frames == CHUNK_SIZE)
+    {
+      InternalWriteFrames(output.data(), output_frames);
+      output_frames = 0;
+    }
+
+    position += step;
+  }
+
+  if (output_frames > 0)
+    InternalWriteFrames(output.data(), output_frames);
+
+  m_rate_control_position = position - (CHUNK_SIZE << 16);
+  m_rate_control_last_frame = chunk[CHUNK_SIZE - 1];
+}
+
+void AudioStream::UpdateRateControlTarget()
+{
+  static constexpr u32 GROW_FRAMES = CHUNK_SIZE * 4;
+  static constexpr u32 SHRINK_FRAMES = CHUNK_SIZE;
+  static constexpr u32 SHRINK_AFTER_SECONDS = 10;
+
+  const u32 min_target = std::max(GetAlignedBufferSize(m_target_buffer_size / 4), CHUNK_SIZE * 2u);
+  const u32 max_target = GetAlignedBufferSize((m_buffer_size * 3) / 4);
+
+  const u32 underrun_count = m_underrun_count.load(std::memory_order_relaxed);
+  if (underrun_count != m_rate_control_last_underrun_count)
+  {
+    m_rate_control_last_underrun_count = underrun_count;
+    m_rate_control_frames_since_underrun = 0;
+    m_rate_control_target = std::min(m_rate_control_target + GROW_FRAMES, max_target);
+    Log_VerbosePrintf("Underrun, rate control target increased to %u frames", m_rate_control_target);
+    return;
+  }
+
+  m_rate_control_frames_since_underrun += CHUNK_SIZE;
+  if (m_rate_control_frames_since_underrun >= (m_sample_rate * SHRINK_AFTER_SECONDS) &&
+      m_rate_control_target > min_target)
+  {
+    m_rate_control_frames_since_underrun = 0;
+    m_rate_control_target = std::max(m_rate_control_target - SHRINK_FRAMES, min_target);
+    Log_VerbosePrintf("No underruns, rate control target decreased to %u frames", m_rate_control_target);
+  }
+}
@@ -5,8 +5,11 @@
 #include "common/types.h"
 #include <array>
 #include <atomic>
+#include <condition_variable>
 #include <memory>
+#include <mutex>
 #include <optional>
+#include <thread>
 
 #ifdef _MSC_VER
 #pragma warning(push)
@@ -22,6 +25,7 @@ enum class AudioStretchMode : u8
   Off,
   Resample,
   TimeStretch,
+  RateControl,
   Count
 };
 
@@ -54,6 +58,7 @@ public:
   ALWAYS_INLINE u32 GetOutputVolume() const { return m_volume; }
   ALWAYS_INLINE float GetNominalTempo() const { return m_nominal_rate; }
   ALWAYS_INLINE bool IsPaused() const { return m_paused; }
+  ALWAYS_INLINE bool IsStretchThreaded() const { return m_stretch_threaded; }
 
   u32 GetBufferedFramesRelaxed() const;
 
@@ -75,6 +80,9 @@ public:
 
   void SetStretchMode(AudioStretchMode mode);
 
+  /// Moves resampling/time stretching to a worker thread, so the writer only has to queue chunks.
+  void SetStretchThreaded(bool enabled);
+
   static std::unique_ptr<AudioStream> CreateNullStream(u32 sample_rate, u32 channels, u32 buffer_ms);
 
 protected:
@@ -100,6 +108,7 @@ private:
     AVERAGING_WINDOW = 50,
     STRETCH_RESET_THRESHOLD = 5,
     TARGET_IPS = 691,
+    STRETCH_QUEUE_CHUNKS = 64,
   };
 
   void AllocateBuffer();
@@ -109,10 +118,22 @@ private:
 
   void StretchAllocate();
   void StretchDestroy();
-  void StretchWrite();
+  void StretchWrite(s32* chunk);
   void StretchUnderrun();
   void StretchOverrun();
 
+  void StartStretchThread();
+  void StopStretchThread();
+  void StretchThreadEntryPoint();
+  void QueueStretchChunk(const s32* chunk);
+
+  void RateControlReset();
+  void RateControlWrite(const s32* chunk);
+  void UpdateRateControlTarget();
+
+  /// Returns a lock which keeps the worker thread from touching the stretcher.
+  std::unique_lock<std::mutex> LockStretcher();
+
   float AddAndGetAverageTempo(float val);
   void UpdateStretchTempo();
 
@@ -142,6 +163,30 @@ private:
 
   // float buffer, soundtouch only accepts float samples as input
   alignas(16) std::array<float, CHUNK_SIZE * MAX_CHANNELS> m_float_buffer;
+
+  // chunks waiting to be stretched on the worker thread, protected by the mutex
+  std::thread m_stretch_thread;
+  std::mutex m_stretch_mutex;
+  std::condition_variable m_stretch_wake_cv;
+  std::condition_variable m_stretch_done_cv;
+  std::unique_ptr<s32[]> m_stretch_queue;
+  u32 m_stretch_queue_rpos = 0;
+  u32 m_stretch_queue_count = 0;
+  bool m_stretch_thread_busy = false;
+  bool m_stretch_thread_shutdown = false;
+  bool m_stretch_threaded = false;
+
+  // chunk being stretched on the worker thread
+  alignas(16) std::array<s32, CHUNK_SIZE> m_stretch_chunk;
+
+  // rate control resamples with a ratio nudged around the nominal rate, to keep the buffer at the target fill,
+  // which itself grows when the host underruns and shrinks back after a while without underruns
+  std::atomic<u32> m_underrun_count{0};
+  u32 m_rate_control_position = 0;
+  s32 m_rate_control_last_frame = 0;
+  u32 m_rate_control_target = 0;
+  u32 m_rate_control_frames_since_underrun = 0;
+  u32 m_rate_control_last_underrun_count = 0;
 };
 
 #ifdef _MSC_VER
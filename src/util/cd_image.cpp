@@ -353,7 +353,8 @@ std::string CDImage::GetSubImageMetadata(u32 index, const std::string_view& type
   return {};
 }
 
-CDImage::PrecacheResult CDImage::Precache(ProgressCallback* progress /*= ProgressCallback::NullProgressCallback*/)
+CDImage::PrecacheResult CDImage::Precache(ProgressCallback* progress /*= ProgressCallback::NullProgressCallback*/,
+                                          bool compressed /*= false*/)
 {
   return PrecacheResult::Unsupported;
 }
@@ -363,6 +364,8 @@ bool CDImage::IsPrecached() const
   return false;
 }
 
+void CDImage::SetDecompressionCache(u32 num_blocks, bool prefetch) {}
+
 void CDImage::ClearTOC()
 {
   m_lba_count = 0;
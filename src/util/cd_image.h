@@ -230,7 +230,8 @@ public:
   static std::unique_ptr<CDImage> OpenM3uImage(const char* filename, bool apply_patches, Common::Error* error);
   static std::unique_ptr<CDImage> OpenDeviceImage(const char* filename, Common::Error* error);
   static std::unique_ptr<CDImage>
-  CreateMemoryImage(CDImage* image, ProgressCallback* progress = ProgressCallback::NullProgressCallback);
+  CreateMemoryImage(CDImage* image, ProgressCallback* progress = ProgressCallback::NullProgressCallback,
+                    bool compressed = false);
   static std::unique_ptr<CDImage> OverlayPPFPatch(const char* filename, std::unique_ptr<CDImage> parent_image,
                                                   ProgressCallback* progress = ProgressCallback::NullProgressCallback);
 
@@ -347,9 +348,15 @@ public:
   virtual std::string GetSubImageMetadata(u32 index, const std::string_view& type) const;
 
   // Returns true if the source supports precaching, which may be more optimal than an in-memory copy.
-  virtual PrecacheResult Precache(ProgressCallback* progress = ProgressCallback::NullProgressCallback);
+  // If compressed is set, the precached data should be kept compressed in memory.
+  virtual PrecacheResult Precache(ProgressCallback* progress = ProgressCallback::NullProgressCallback,
+                                  bool compressed = false);
   virtual bool IsPrecached() const;
 
+  // Sets the number of decompressed blocks kept in memory for compressed formats, and whether the blocks following
+  // the last read are decompressed ahead of time on a worker thread.
+  virtual void SetDecompressionCache(u32 num_blocks, bool prefetch);
+
 protected:
   void ClearTOC();
   void CopyTOC(const CDImage* image);
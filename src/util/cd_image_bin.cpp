@@ -3,6 +3,7 @@
 
 #include "cd_image.h"
 #include "cd_subchannel_replacement.h"
+#include "mapped_file.h"
 #include "common/error.h"
 #include "common/file_system.h"
 #include "common/log.h"
@@ -26,6 +27,7 @@ protected:
 private:
   std::FILE* m_fp = nullptr;
   u64 m_file_position = 0;
+  Common::MappedFile m_mapping;
 
   CDSubChannelReplacement m_sbi;
 };
@@ -34,6 +36,7 @@ CDImageBin::CDImageBin() = default;
 
 CDImageBin::~CDImageBin()
 {
+  m_mapping.Unmap();
   if (m_fp)
     std::fclose(m_fp);
 }
@@ -59,6 +62,9 @@ bool CDImageBin::Open(const char* filename, Common::Error* error)
 
   m_lba_count = file_size / track_sector_size;
 
+  // reads go through the file if it can't be mapped
+  m_mapping.Map(m_fp);
+
   SubChannelQ::Control control = {};
   TrackMode mode = TrackMode::Mode2Raw;
   control.data = mode != TrackMode::Audio;
@@ -118,6 +124,9 @@ bool CDImageBin::HasNonStandardSubchannel() const
 bool CDImageBin::ReadSectorFromIndex(void* buffer, const Index& index, LBA lba_in_index)
 {
   const u64 file_position = index.file_offset + (static_cast<u64>(lba_in_index) * index.file_sector_size);
+  if (m_mapping.IsMapped())
+    return m_mapping.Read(buffer, file_position, index.file_sector_size);
+
   if (m_file_position != file_position)
   {
     if (std::fseek(m_fp, static_cast<long>(file_position), SEEK_SET) != 0)
@@ -17,11 +17,14 @@
 #include "libchdr/chd.h"
 #include <algorithm>
 #include <cerrno>
+#include <condition_variable>
 #include <cstdio>
 #include <cstring>
 #include <limits>
 #include <map>
+#include <mutex>
 #include <optional>
+#include <thread>
 Log_SetChannel(CDImageCHD);
 
 static std::optional<CDImage::TrackMode> ParseTrackModeString(const char* str)
@@ -56,8 +59,9 @@ public:
 
   bool ReadSubChannelQ(SubChannelQ* subq, const Index& index, LBA lba_in_index) override;
   bool HasNonStandardSubchannel() const override;
-  PrecacheResult Precache(ProgressCallback* progress) override;
+  PrecacheResult Precache(ProgressCallback* progress, bool compressed) override;
   bool IsPrecached() const override;
+  void SetDecompressionCache(u32 num_blocks, bool prefetch) override;
 
 protected:
   bool ReadSectorFromIndex(void* buffer, const Index& index, LBA lba_in_index) override;
@@ -66,20 +70,48 @@ private:
   enum : u32
   {
     CHD_CD_SECTOR_DATA_SIZE = 2352 + 96,
-    CHD_CD_TRACK_ALIGNMENT = 4
+    CHD_CD_TRACK_ALIGNMENT = 4,
+    INVALID_HUNK_INDEX = static_cast<u32>(-1),
+    PREFETCH_HUNKS = 2,
   };
 
-  bool ReadHunk(u32 hunk_index);
+  struct CachedHunk
+  {
+    u32 hunk_index = INVALID_HUNK_INDEX;
+    u32 last_used = 0;
+    std::unique_ptr<u8[]> data;
+  };
+
+  // These require m_hunk_cache_mutex to be held.
+  CachedHunk* LookupHunk(u32 hunk_index);
+  CachedHunk& GetLeastRecentlyUsedHunk();
+  const u8* ReadHunk(u32 hunk_index, std::unique_lock<std::mutex>& lock);
+
+  bool StartPrefetchThread();
+  void StopPrefetchThread();
+  void PrefetchThreadEntryPoint();
 
   std::FILE* m_fp = nullptr;
   chd_file* m_chd = nullptr;
   u32 m_hunk_size = 0;
+  u32 m_hunk_count = 0;
   u32 m_sectors_per_hunk = 0;
 
-  std::vector<u8> m_hunk_buffer;
-  u32 m_current_hunk_index = static_cast<u32>(-1);
+  std::mutex m_hunk_cache_mutex;
+  std::vector<CachedHunk> m_hunk_cache;
+  u32 m_hunk_cache_counter = 0;
   bool m_precached = false;
 
+  // The prefetcher has its own handle, since libchdr isn't thread safe.
+  std::FILE* m_prefetch_fp = nullptr;
+  chd_file* m_prefetch_chd = nullptr;
+  std::thread m_prefetch_thread;
+  std::condition_variable m_prefetch_wake_cv;
+  std::condition_variable m_prefetch_done_cv;
+  u32 m_prefetch_request = INVALID_HUNK_INDEX;
+  u32 m_prefetch_current = INVALID_HUNK_INDEX;
+  bool m_prefetch_shutdown = false;
+
   CDSubChannelReplacement m_sbi;
 };
 
@@ -87,6 +119,7 @@ CDImageCHD::CDImageCHD() = default;
 
 CDImageCHD::~CDImageCHD()
 {
+  StopPrefetchThread();
   if (m_chd)
     chd_close(m_chd);
   if (m_fp)
@@ -118,6 +151,7 @@ bool CDImageCHD::Open(const char* filename, Common::Error* error)
 
   const chd_header* header = chd_get_header(m_chd);
   m_hunk_size = header->hunkbytes;
+  m_hunk_count = header->totalhunks;
   if ((m_hunk_size % CHD_CD_SECTOR_DATA_SIZE) != 0)
   {
     Log_ErrorPrintf("Hunk size (%u) is not a multiple of %u", m_hunk_size, CHD_CD_SECTOR_DATA_SIZE);
@@ -128,7 +162,7 @@ bool CDImageCHD::Open(const char* filename, Common::Error* error)
   }
 
   m_sectors_per_hunk = m_hunk_size / CHD_CD_SECTOR_DATA_SIZE;
-  m_hunk_buffer.resize(m_hunk_size);
+  SetDecompressionCache(1, false);
   m_filename = filename;
 
   u32 disc_lba = 0;
@@ -307,8 +341,9 @@ bool CDImageCHD::HasNonStandardSubchannel() const
   return (m_sbi.GetReplacementSectorCount() > 0);
 }
 
-CDImage::PrecacheResult CDImageCHD::Precache(ProgressCallback* progress)
+CDImage::PrecacheResult CDImageCHD::Precache(ProgressCallback* progress, bool compressed)
 {
+  // The file is loaded as-is, so hunks stay compressed in memory regardless of the compressed flag.
   if (m_precached)
     return CDImage::PrecacheResult::Success;
 
@@ -332,6 +367,24 @@ bool CDImageCHD::IsPrecached() const
   return m_precached;
 }
 
+void CDImageCHD::SetDecompressionCache(u32 num_blocks, bool prefetch)
+{
+  StopPrefetchThread();
+
+  {
+    std::unique_lock lock(m_hunk_cache_mutex);
+    m_hunk_cache.clear();
+    m_hunk_cache.resize(std::max(num_blocks, 1u));
+    for (CachedHunk& hunk : m_hunk_cache)
+      hunk.data = std::make_unique<u8[]>(m_hunk_size);
+    m_hunk_cache_counter = 0;
+  }
+
+  // Prefetching needs room for the hunks ahead, without evicting the one being read.
+  if (prefetch && num_blocks > PREFETCH_HUNKS && !StartPrefetchThread())
+    Log_WarningPrintf("Failed to start CHD prefetch thread, hunks will be decompressed on demand.");
+}
+
 // There's probably a more efficient way of doing this with vectorization...
 ALWAYS_INLINE static void CopyAndSwap(void* dst_ptr, const u8* src_ptr, u32 data_size)
 {
@@ -379,34 +432,168 @@ bool CDImageCHD::ReadSectorFromIndex(void* buffer, const Index& index, LBA lba_i
   const u32 hunk_offset = static_cast<u32>((disc_frame % m_sectors_per_hunk) * CHD_CD_SECTOR_DATA_SIZE);
   DebugAssert((m_hunk_size - hunk_offset) >= CHD_CD_SECTOR_DATA_SIZE);
 
-  if (m_current_hunk_index != hunk_index && !ReadHunk(hunk_index))
+  std::unique_lock lock(m_hunk_cache_mutex);
+  const u8* hunk_data = ReadHunk(hunk_index, lock);
+  if (!hunk_data)
     return false;
 
   // Audio data is in big-endian, so we have to swap it for little endian hosts...
   if (index.mode == TrackMode::Audio)
-    CopyAndSwap(buffer, &m_hunk_buffer[hunk_offset], RAW_SECTOR_SIZE);
+    CopyAndSwap(buffer, &hunk_data[hunk_offset], RAW_SECTOR_SIZE);
   else
-    std::memcpy(buffer, &m_hunk_buffer[hunk_offset], RAW_SECTOR_SIZE);
+    std::memcpy(buffer, &hunk_data[hunk_offset], RAW_SECTOR_SIZE);
 
   return true;
 }
 
-bool CDImageCHD::ReadHunk(u32 hunk_index)
+CDImageCHD::CachedHunk* CDImageCHD::LookupHunk(u32 hunk_index)
 {
-  const chd_error err = chd_read(m_chd, hunk_index, m_hunk_buffer.data());
-  if (err != CHDERR_NONE)
+  for (CachedHunk& hunk : m_hunk_cache)
   {
-    Log_ErrorPrintf("chd_read(%u) failed: %s", hunk_index, chd_error_string(err));
+    if (hunk.hunk_index == hunk_index)
+      return &hunk;
+  }
+
+  return nullptr;
+}
+
+CDImageCHD::CachedHunk& CDImageCHD::GetLeastRecentlyUsedHunk()
+{
+  CachedHunk* lru = &m_hunk_cache[0];
+  for (CachedHunk& hunk : m_hunk_cache)
+  {
+    if (hunk.hunk_index == INVALID_HUNK_INDEX)
+      return hunk;
+    if (hunk.last_used < lru->last_used)
+      lru = &hunk;
+  }
+
+  return *lru;
+}
+
+const u8* CDImageCHD::ReadHunk(u32 hunk_index, std::unique_lock<std::mutex>& lock)
+{
+  // Don't decompress the hunk twice if the prefetcher is already working on it.
+  m_prefetch_done_cv.wait(lock, [this, hunk_index]() { return (m_prefetch_current != hunk_index); });
+
+  CachedHunk* hunk = LookupHunk(hunk_index);
+  if (!hunk)
+  {
+    hunk = &GetLeastRecentlyUsedHunk();
+    const chd_error err = chd_read(m_chd, hunk_index, hunk->data.get());
+    if (err != CHDERR_NONE)
+    {
+      Log_ErrorPrintf("chd_read(%u) failed: %s", hunk_index, chd_error_string(err));
+
+      // data might have been partially written
+      hunk->hunk_index = INVALID_HUNK_INDEX;
+      return nullptr;
+    }
+
+    hunk->hunk_index = hunk_index;
+  }
+
+  hunk->last_used = ++m_hunk_cache_counter;
+
+  // Keep the prefetcher ahead of the reads, for sequential access.
+  if (m_prefetch_thread.joinable() && LookupHunk(hunk_index + 1) == nullptr)
+  {
+    m_prefetch_request = hunk_index + 1;
+    m_prefetch_wake_cv.notify_one();
+  }
 
-    // data might have been partially written
-    m_current_hunk_index = static_cast<u32>(-1);
+  return hunk->data.get();
+}
+
+bool CDImageCHD::StartPrefetchThread()
+{
+  m_prefetch_fp = FileSystem::OpenCFile(m_filename.c_str(), "rb");
+  if (!m_prefetch_fp)
+    return false;
+
+  if (chd_open_file(m_prefetch_fp, CHD_OPEN_READ, nullptr, &m_prefetch_chd) != CHDERR_NONE)
+  {
+    std::fclose(m_prefetch_fp);
+    m_prefetch_fp = nullptr;
     return false;
   }
 
-  m_current_hunk_index = hunk_index;
+  m_prefetch_request = INVALID_HUNK_INDEX;
+  m_prefetch_current = INVALID_HUNK_INDEX;
+  m_prefetch_shutdown = false;
+  m_prefetch_thread = std::thread(&CDImageCHD::PrefetchThreadEntryPoint, this);
   return true;
 }
 
+void CDImageCHD::StopPrefetchThread()
+{
+  if (!m_prefetch_thread.joinable())
+    return;
+
+  {
+    std::unique_lock lock(m_hunk_cache_mutex);
+    m_prefetch_shutdown = true;
+    m_prefetch_wake_cv.notify_one();
+  }
+
+  m_prefetch_thread.join();
+
+  chd_close(m_prefetch_chd);
+  m_prefetch_chd = nullptr;
+  std::fclose(m_prefetch_fp);
+  m_prefetch_fp = nullptr;
+}
+
+void CDImageCHD::PrefetchThreadEntryPoint()
+{
+  std::unique_ptr<u8[]> buffer = std::make_unique<u8[]>(m_hunk_size);
+
+  std::unique_lock lock(m_hunk_cache_mutex);
+  for (;;)
+  {
+    m_prefetch_wake_cv.wait(lock,
+                            [this]() { return (m_prefetch_shutdown || m_prefetch_request != INVALID_HUNK_INDEX); });
+    if (m_prefetch_shutdown)
+      break;
+
+    const u32 first_hunk = m_prefetch_request;
+    const u32 last_hunk = std::min(first_hunk + PREFETCH_HUNKS, m_hunk_count);
+    m_prefetch_request = INVALID_HUNK_INDEX;
+
+    for (u32 hunk_index = first_hunk; hunk_index < last_hunk; hunk_index++)
+    {
+      // Stop early if the reader has moved somewhere else in the meantime.
+      if (m_prefetch_shutdown || m_prefetch_request != INVALID_HUNK_INDEX)
+        break;
+      if (LookupHunk(hunk_index))
+        continue;
+
+      m_prefetch_current = hunk_index;
+      lock.unlock();
+      const chd_error err = chd_read(m_prefetch_chd, hunk_index, buffer.get());
+      lock.lock();
+      m_prefetch_current = INVALID_HUNK_INDEX;
+
+      if (err == CHDERR_NONE)
+      {
+        // Swap the buffers, so the evicted hunk's memory gets reused for the next one.
+        CachedHunk& hunk = GetLeastRecentlyUsedHunk();
+        hunk.hunk_index = hunk_index;
+        hunk.last_used = ++m_hunk_cache_counter;
+        std::swap(hunk.data, buffer);
+      }
+      else
+      {
+        Log_ErrorPrintf("Prefetch chd_read(%u) failed: %s", hunk_index, chd_error_string(err));
+      }
+
+      m_prefetch_done_cv.notify_one();
+      if (err != CHDERR_NONE)
+        break;
+    }
+  }
+}
+
 std::unique_ptr<CDImage> CDImage::OpenCHDImage(const char* filename, Common::Error* error)
 {
   std::unique_ptr<CDImageCHD> image = std::make_unique<CDImageCHD>();
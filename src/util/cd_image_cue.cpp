@@ -3,6 +3,7 @@
 
 #include "cd_image.h"
 #include "cd_subchannel_replacement.h"
+#include "mapped_file.h"
 #include "common/assert.h"
 #include "common/error.h"
 #include "common/file_system.h"
@@ -13,8 +14,34 @@
 #include <cerrno>
 #include <cinttypes>
 #include <map>
+#include <mutex>
+#include <unordered_map>
 Log_SetChannel(CDImageCueSheet);
 
+namespace {
+/// Resolved location and size of a file referenced by a cue sheet.
+struct CueFileLayout
+{
+  std::string filename;
+  std::string full_path;
+  u64 size;
+  std::time_t modification_time;
+};
+
+/// Files of a cue sheet, valid while the cue sheet itself is unchanged. Remembered for the lifetime of the process,
+/// so scanning the game list and then booting the disc doesn't have to search for the files again. The files are
+/// still checked on every open, in case they were replaced or removed.
+struct CueSheetLayout
+{
+  std::time_t cue_modification_time;
+  s64 cue_size;
+  std::vector<CueFileLayout> files;
+};
+} // namespace
+
+static std::mutex s_layout_cache_mutex;
+static std::unordered_map<std::string, CueSheetLayout> s_layout_cache;
+
 class CDImageCueSheet : public CDImage
 {
 public:
@@ -33,10 +60,16 @@ private:
   struct TrackFile
   {
     std::string filename;
+    std::string full_path;
+    u64 size;
+    std::time_t modification_time;
     std::FILE* file;
     u64 file_position;
+    Common::MappedFile mapping;
   };
 
+  static bool OpenTrackFile(TrackFile& tf);
+
   std::vector<TrackFile> m_files;
   CDSubChannelReplacement m_sbi;
 };
@@ -45,7 +78,26 @@ CDImageCueSheet::CDImageCueSheet() = default;
 
 CDImageCueSheet::~CDImageCueSheet()
 {
-  std::for_each(m_files.begin(), m_files.end(), [](TrackFile& t) { std::fclose(t.file); });
+  std::for_each(m_files.begin(), m_files.end(), [](TrackFile& t) {
+    t.mapping.Unmap();
+    if (t.file)
+      std::fclose(t.file);
+  });
+}
+
+bool CDImageCueSheet::OpenTrackFile(TrackFile& tf)
+{
+  tf.file = FileSystem::OpenCFile(tf.full_path.c_str(), "rb");
+  if (!tf.file)
+  {
+    Log_ErrorPrintf("Failed to open track file '%s': errno %d", tf.full_path.c_str(), errno);
+    return false;
+  }
+
+  // reads go through the file if it can't be mapped
+  tf.file_position = 0;
+  tf.mapping.Map(tf.file);
+  return true;
 }
 
 bool CDImageCueSheet::OpenAndParse(const char* filename, Common::Error* error)
@@ -60,6 +112,9 @@ bool CDImageCueSheet::OpenAndParse(const char* filename, Common::Error* error)
     return false;
   }
 
+  FILESYSTEM_STAT_DATA cue_sd;
+  const bool cue_stat_valid = FileSystem::StatFile(fp, &cue_sd);
+
   CueParser::File parser;
   if (!parser.Parse(fp, error))
   {
@@ -71,6 +126,22 @@ bool CDImageCueSheet::OpenAndParse(const char* filename, Common::Error* error)
 
   m_filename = filename;
 
+  // Track files are only searched for when the cue sheet has changed since we last saw it, and aren't opened until
+  // a sector is read from them. For multi-bin images on network shares, this saves a round-trip per file.
+  std::vector<CueFileLayout> cached_files;
+  bool layout_from_cache = false;
+  if (cue_stat_valid)
+  {
+    std::unique_lock lock(s_layout_cache_mutex);
+    auto iter = s_layout_cache.find(m_filename);
+    if (iter != s_layout_cache.end() && iter->second.cue_modification_time == cue_sd.ModificationTime &&
+        iter->second.cue_size == cue_sd.Size)
+    {
+      cached_files = iter->second.files;
+      layout_from_cache = true;
+    }
+  }
+
   u32 disc_lba = 0;
 
   // for each track..
@@ -90,25 +161,53 @@ bool CDImageCueSheet::OpenAndParse(const char* filename, Common::Error* error)
       if (t.filename == track_filename)
         break;
     }
+    if (track_file_index == m_files.size() && layout_from_cache)
+    {
+      if (track_file_index >= cached_files.size() || cached_files[track_file_index].filename != track_filename)
+      {
+        // shouldn't happen since the cue sheet is unchanged, but don't trust it if it does
+        Log_WarningPrintf("Cached layout for '%s' does not match, looking up files", filename);
+        layout_from_cache = false;
+      }
+      else
+      {
+        // make sure it's still there, and hasn't been swapped for a different file
+        CueFileLayout& cf = cached_files[track_file_index];
+        FILESYSTEM_STAT_DATA track_sd;
+        if (FileSystem::StatFile(cf.full_path.c_str(), &track_sd) && static_cast<u64>(track_sd.Size) == cf.size &&
+            track_sd.ModificationTime == cf.modification_time)
+        {
+          m_files.push_back(
+            TrackFile{std::move(cf.filename), std::move(cf.full_path), cf.size, cf.modification_time, nullptr, 0});
+        }
+        else
+        {
+          Log_WarningPrintf("Track file '%s' has changed, looking up files", cf.full_path.c_str());
+          layout_from_cache = false;
+        }
+      }
+    }
     if (track_file_index == m_files.size())
     {
-      const std::string track_full_filename(
+      std::string track_full_filename(
         !Path::IsAbsolute(track_filename) ? Path::BuildRelativePath(m_filename, track_filename) : track_filename);
-      std::FILE* track_fp = FileSystem::OpenCFile(track_full_filename.c_str(), "rb");
-      if (!track_fp && track_file_index == 0)
+      FILESYSTEM_STAT_DATA track_sd;
+      bool track_found = FileSystem::StatFile(track_full_filename.c_str(), &track_sd);
+      if (!track_found && track_file_index == 0)
       {
         // many users have bad cuesheets, or they're renamed the files without updating the cuesheet.
         // so, try searching for a bin with the same name as the cue, but only for the first referenced file.
-        const std::string alternative_filename(Path::ReplaceExtension(filename, "bin"));
-        track_fp = FileSystem::OpenCFile(alternative_filename.c_str(), "rb");
-        if (track_fp)
+        std::string alternative_filename(Path::ReplaceExtension(filename, "bin"));
+        track_found = FileSystem::StatFile(alternative_filename.c_str(), &track_sd);
+        if (track_found)
         {
           Log_WarningPrintf("Your cue sheet references an invalid file '%s', but this was found at '%s' instead.",
                             track_filename.c_str(), alternative_filename.c_str());
+          track_full_filename = std::move(alternative_filename);
         }
       }
 
-      if (!track_fp)
+      if (!track_found)
       {
         Log_ErrorPrintf("Failed to open track filename '%s' (from '%s' and '%s'): errno %d",
                         track_full_filename.c_str(), track_filename.c_str(), filename, errno);
@@ -121,7 +220,8 @@ bool CDImageCueSheet::OpenAndParse(const char* filename, Common::Error* error)
         return false;
       }
 
-      m_files.push_back(TrackFile{std::move(track_filename), track_fp, 0});
+      m_files.push_back(TrackFile{std::move(track_filename), std::move(track_full_filename),
+                                  static_cast<u64>(track_sd.Size), track_sd.ModificationTime, nullptr, 0});
     }
 
     // data type determines the sector size
@@ -139,11 +239,7 @@ bool CDImageCueSheet::OpenAndParse(const char* filename, Common::Error* error)
     LBA track_length;
     if (!track->length.has_value())
     {
-      FileSystem::FSeek64(m_files[track_file_index].file, 0, SEEK_END);
-      u64 file_size = static_cast<u64>(FileSystem::FTell64(m_files[track_file_index].file));
-      FileSystem::FSeek64(m_files[track_file_index].file, 0, SEEK_SET);
-
-      file_size /= track_sector_size;
+      const u64 file_size = m_files[track_file_index].size / track_sector_size;
       if (track_start >= file_size)
       {
         Log_ErrorPrintf("Failed to open track %u in '%s': track start is out of range (%u vs %" PRIu64 ")", track_num,
@@ -288,6 +384,19 @@ bool CDImageCueSheet::OpenAndParse(const char* filename, Common::Error* error)
     return false;
   }
 
+  if (cue_stat_valid && !layout_from_cache)
+  {
+    CueSheetLayout layout;
+    layout.cue_modification_time = cue_sd.ModificationTime;
+    layout.cue_size = cue_sd.Size;
+    layout.files.reserve(m_files.size());
+    for (const TrackFile& tf : m_files)
+      layout.files.push_back(CueFileLayout{tf.filename, tf.full_path, tf.size, tf.modification_time});
+
+    std::unique_lock lock(s_layout_cache_mutex);
+    s_layout_cache[m_filename] = std::move(layout);
+  }
+
   m_lba_count = disc_lba;
   AddLeadOutIndex();
 
@@ -314,7 +423,13 @@ bool CDImageCueSheet::ReadSectorFromIndex(void* buffer, const Index& index, LBA
   DebugAssert(index.file_index < m_files.size());
 
   TrackFile& tf = m_files[index.file_index];
+  if (!tf.file && !OpenTrackFile(tf))
+    return false;
+
   const u64 file_position = index.file_offset + (static_cast<u64>(lba_in_index) * index.file_sector_size);
+  if (tf.mapping.IsMapped())
+    return tf.mapping.Read(buffer, file_position, index.file_sector_size);
+
   if (tf.file_position != file_position)
   {
     if (std::fseek(tf.file, static_cast<long>(file_position), SEEK_SET) != 0)
@@ -81,30 +81,49 @@ protected:
   bool ReadSectorFromIndex(void* buffer, const Index& index, LBA lba_in_index) override;
 
 private:
+  enum : u32
+  {
+    /// Number of sectors read per request, when the adapter doesn't report a transfer limit.
+    DEFAULT_READ_AHEAD_SECTORS = 16,
+
+    /// Upper bound on the sectors per request, regardless of the adapter's transfer limit.
+    MAX_READ_AHEAD_SECTORS = 32,
+  };
+
   struct SPTDBuffer
   {
     SCSI_PASS_THROUGH_DIRECT cmd;
     u8 sense[20];
   };
 
-  static void FillSPTD(SPTDBuffer* sptd, u32 sector_number, bool include_subq, void* buffer);
+  static void FillSPTD(SPTDBuffer* sptd, u32 sector_number, u32 sector_count, bool include_subq, void* buffer);
+
+  /// Returns the size of each sector in the buffer for the current read mode.
+  u32 GetBufferSectorStride() const;
+
+  /// Returns a pointer to the sector at the specified offset, reading it and the sectors after it if needed.
+  const u8* GetSector(u64 offset);
 
-  bool ReadSectorToBuffer(u64 offset);
+  bool ReadSectorsToBuffer(u64 offset);
   bool DetermineReadMode();
+  void DetermineReadAheadSectors();
 
   HANDLE m_hDevice = INVALID_HANDLE_VALUE;
 
+  // The buffer holds a window of consecutive sectors, so sequential reads only hit the drive once per window.
   u64 m_buffer_offset = ~static_cast<u64>(0);
+  u32 m_buffer_sector_count = 0;
+  u32 m_read_ahead_sectors = DEFAULT_READ_AHEAD_SECTORS;
+  u32 m_lead_out_sector = 0;
 
   bool m_use_sptd = true;
   bool m_read_subcode = false;
 
-  std::array<u8, CD_RAW_SECTOR_WITH_SUBCODE_SIZE> m_buffer;
+  std::vector<u8> m_buffer;
   std::array<u8, ALL_SUBCODE_SIZE> m_deinterleaved_subcode;
-  std::array<u8, SUBCHANNEL_BYTES_PER_FRAME> m_subq;
 };
 
-CDImageDeviceWin32::CDImageDeviceWin32() = default;
+CDImageDeviceWin32::CDImageDeviceWin32() : m_buffer(MAX_READ_AHEAD_SECTORS * CD_RAW_SECTOR_WITH_SUBCODE_SIZE) {}
 
 CDImageDeviceWin32::~CDImageDeviceWin32()
 {
@@ -191,6 +210,7 @@ bool CDImageDeviceWin32::Open(const char* filename, Common::Error* error)
     last_track_address = track_address;
     if (track_num == LEAD_OUT_TRACK_NUMBER)
     {
+      m_lead_out_sector = static_cast<u32>(track_address);
       AddLeadOutIndex();
       break;
     }
@@ -276,6 +296,8 @@ bool CDImageDeviceWin32::Open(const char* filename, Common::Error* error)
     return false;
   }
 
+  DetermineReadAheadSectors();
+
   return Seek(1, Position{0, 0, 0});
 }
 
@@ -285,11 +307,21 @@ bool CDImageDeviceWin32::ReadSubChannelQ(SubChannelQ* subq, const Index& index,
     return CDImage::ReadSubChannelQ(subq, index, lba_in_index);
 
   const u64 offset = index.file_offset + static_cast<u64>(lba_in_index) * index.file_sector_size;
-  if (m_buffer_offset != offset && !ReadSectorToBuffer(offset))
+  const u8* sector = GetSector(offset);
+  if (!sector)
     return false;
 
   // P, Q, ...
-  std::memcpy(subq->data.data(), m_subq.data(), SUBCHANNEL_BYTES_PER_FRAME);
+  if (m_use_sptd)
+  {
+    std::memcpy(subq->data.data(), &sector[RAW_SECTOR_SIZE], SUBCHANNEL_BYTES_PER_FRAME);
+  }
+  else
+  {
+    DeinterleaveSubcode(&sector[RAW_SECTOR_SIZE], m_deinterleaved_subcode.data());
+    std::memcpy(subq->data.data(), &m_deinterleaved_subcode[SUBCHANNEL_BYTES_PER_FRAME], SUBCHANNEL_BYTES_PER_FRAME);
+  }
+
   return true;
 }
 
@@ -304,14 +336,37 @@ bool CDImageDeviceWin32::ReadSectorFromIndex(void* buffer, const Index& index, L
     return false;
 
   const u64 offset = index.file_offset + static_cast<u64>(lba_in_index) * index.file_sector_size;
-  if (m_buffer_offset != offset && !ReadSectorToBuffer(offset))
+  const u8* sector = GetSector(offset);
+  if (!sector)
     return false;
 
-  std::memcpy(buffer, m_buffer.data(), RAW_SECTOR_SIZE);
+  std::memcpy(buffer, sector, RAW_SECTOR_SIZE);
   return true;
 }
 
-void CDImageDeviceWin32::FillSPTD(SPTDBuffer* sptd, u32 sector_number, bool include_subq, void* buffer)
+u32 CDImageDeviceWin32::GetBufferSectorStride() const
+{
+  // raw reads always return the full interleaved subcode
+  if (!m_use_sptd)
+    return CD_RAW_SECTOR_WITH_SUBCODE_SIZE;
+
+  return m_read_subcode ? (RAW_SECTOR_SIZE + SUBCHANNEL_BYTES_PER_FRAME) : RAW_SECTOR_SIZE;
+}
+
+const u8* CDImageDeviceWin32::GetSector(u64 offset)
+{
+  if (offset < m_buffer_offset || offset >= (m_buffer_offset + static_cast<u64>(m_buffer_sector_count) * 2048))
+  {
+    if (!ReadSectorsToBuffer(offset))
+      return nullptr;
+  }
+
+  const u32 index_in_buffer = static_cast<u32>((offset - m_buffer_offset) / 2048);
+  return &m_buffer[index_in_buffer * GetBufferSectorStride()];
+}
+
+void CDImageDeviceWin32::FillSPTD(SPTDBuffer* sptd, u32 sector_number, u32 sector_count, bool include_subq,
+                                  void* buffer)
 {
   std::memset(sptd, 0, sizeof(SPTDBuffer));
 
@@ -319,7 +374,8 @@ void CDImageDeviceWin32::FillSPTD(SPTDBuffer* sptd, u32 sector_number, bool incl
   sptd->cmd.CdbLength = 12;
   sptd->cmd.SenseInfoLength = sizeof(sptd->sense);
   sptd->cmd.DataIn = SCSI_IOCTL_DATA_IN;
-  sptd->cmd.DataTransferLength = include_subq ? (RAW_SECTOR_SIZE + SUBCHANNEL_BYTES_PER_FRAME) : RAW_SECTOR_SIZE;
+  sptd->cmd.DataTransferLength =
+    (include_subq ? (RAW_SECTOR_SIZE + SUBCHANNEL_BYTES_PER_FRAME) : RAW_SECTOR_SIZE) * sector_count;
   sptd->cmd.TimeOutValue = 10;
   sptd->cmd.SenseInfoOffset = offsetof(SPTDBuffer, sense);
   sptd->cmd.DataBuffer = buffer;
@@ -330,9 +386,9 @@ void CDImageDeviceWin32::FillSPTD(SPTDBuffer* sptd, u32 sector_number, bool incl
   sptd->cmd.Cdb[3] = Truncate8(sector_number >> 16);
   sptd->cmd.Cdb[4] = Truncate8(sector_number >> 8);
   sptd->cmd.Cdb[5] = Truncate8(sector_number);
-  sptd->cmd.Cdb[6] = 0x00; // Transfer Count
-  sptd->cmd.Cdb[7] = 0x00;
-  sptd->cmd.Cdb[8] = 0x01;
+  sptd->cmd.Cdb[6] = Truncate8(sector_count >> 16); // Transfer Count
+  sptd->cmd.Cdb[7] = Truncate8(sector_count >> 8);
+  sptd->cmd.Cdb[8] = Truncate8(sector_count);
   sptd->cmd.Cdb[9] = (1 << 7) |                                     // include sync
                      (0b11 << 5) |                                  // include header codes
                      (1 << 4) |                                     // include user data
@@ -341,14 +397,17 @@ void CDImageDeviceWin32::FillSPTD(SPTDBuffer* sptd, u32 sector_number, bool incl
   sptd->cmd.Cdb[10] = (include_subq ? (0b010 << 0) : (0b000 << 0)); // subq selection
 }
 
-bool CDImageDeviceWin32::ReadSectorToBuffer(u64 offset)
+bool CDImageDeviceWin32::ReadSectorsToBuffer(u64 offset)
 {
+  // read ahead up to the end of the disc
+  const u32 sector_number = static_cast<u32>(offset / 2048);
+  const u32 sector_count =
+    (sector_number < m_lead_out_sector) ? std::min(m_read_ahead_sectors, m_lead_out_sector - sector_number) : 1;
+
   if (m_use_sptd)
   {
-    const u32 sector_number = static_cast<u32>(offset / 2048);
-
     SPTDBuffer sptd = {};
-    FillSPTD(&sptd, sector_number, m_read_subcode, m_buffer.data());
+    FillSPTD(&sptd, sector_number, sector_count, m_read_subcode, m_buffer.data());
 
     const u32 expected_bytes = sptd.cmd.DataTransferLength;
     DWORD bytes_returned;
@@ -359,43 +418,66 @@ bool CDImageDeviceWin32::ReadSectorToBuffer(u64 offset)
       Log_ErrorPrintf("DeviceIoControl(IOCTL_SCSI_PASS_THROUGH_DIRECT) for offset %" PRIu64
                       " failed: %08X Status 0x%02X",
                       offset, GetLastError(), sptd.cmd.ScsiStatus);
+      m_buffer_sector_count = 0;
       return false;
     }
 
     if (sptd.cmd.DataTransferLength != expected_bytes)
       Log_WarningPrintf("Only read %u of %u bytes", static_cast<u32>(sptd.cmd.DataTransferLength), expected_bytes);
-
-    if (m_read_subcode)
-      std::memcpy(m_subq.data(), &m_buffer[RAW_SECTOR_SIZE], SUBCHANNEL_BYTES_PER_FRAME);
   }
   else
   {
     RAW_READ_INFO rri;
     rri.DiskOffset.QuadPart = offset;
-    rri.SectorCount = 1;
+    rri.SectorCount = sector_count;
     rri.TrackMode = RawWithSubCode;
 
+    const DWORD expected_bytes = sector_count * CD_RAW_SECTOR_WITH_SUBCODE_SIZE;
     DWORD bytes_returned;
-    if (!DeviceIoControl(m_hDevice, IOCTL_CDROM_RAW_READ, &rri, sizeof(rri), m_buffer.data(),
-                         static_cast<DWORD>(m_buffer.size()), &bytes_returned, nullptr))
+    if (!DeviceIoControl(m_hDevice, IOCTL_CDROM_RAW_READ, &rri, sizeof(rri), m_buffer.data(), expected_bytes,
+                         &bytes_returned, nullptr))
     {
       Log_ErrorPrintf("DeviceIoControl(IOCTL_CDROM_RAW_READ) for offset %" PRIu64 " failed: %08X", offset,
                       GetLastError());
+      m_buffer_sector_count = 0;
       return false;
     }
 
-    if (bytes_returned != m_buffer.size())
-      Log_WarningPrintf("Only read %u of %u bytes", bytes_returned, static_cast<unsigned>(m_buffer.size()));
-
-    // P, Q, ...
-    DeinterleaveSubcode(&m_buffer[RAW_SECTOR_SIZE], m_deinterleaved_subcode.data());
-    std::memcpy(m_subq.data(), &m_deinterleaved_subcode[SUBCHANNEL_BYTES_PER_FRAME], SUBCHANNEL_BYTES_PER_FRAME);
+    if (bytes_returned != expected_bytes)
+      Log_WarningPrintf("Only read %u of %u bytes", bytes_returned, expected_bytes);
   }
 
   m_buffer_offset = offset;
+  m_buffer_sector_count = sector_count;
   return true;
 }
 
+void CDImageDeviceWin32::DetermineReadAheadSectors()
+{
+  // Keep each request within what the adapter can transfer in one go, otherwise it gets split or rejected.
+  STORAGE_PROPERTY_QUERY query = {};
+  query.PropertyId = StorageAdapterProperty;
+  query.QueryType = PropertyStandardQuery;
+
+  STORAGE_ADAPTER_DESCRIPTOR desc = {};
+  DWORD bytes_returned;
+  u32 max_sectors = DEFAULT_READ_AHEAD_SECTORS;
+  if (DeviceIoControl(m_hDevice, IOCTL_STORAGE_QUERY_PROPERTY, &query, sizeof(query), &desc, sizeof(desc),
+                      &bytes_returned, nullptr) &&
+      bytes_returned >= offsetof(STORAGE_ADAPTER_DESCRIPTOR, MaximumPhysicalPages) && desc.MaximumTransferLength > 0)
+  {
+    max_sectors = static_cast<u32>(desc.MaximumTransferLength / GetBufferSectorStride());
+    Log_DevPrintf("Adapter maximum transfer length is %u bytes", static_cast<u32>(desc.MaximumTransferLength));
+  }
+  else
+  {
+    Log_DevPrintf("DeviceIoControl(IOCTL_STORAGE_QUERY_PROPERTY) failed: %08X", GetLastError());
+  }
+
+  m_read_ahead_sectors = std::clamp<u32>(max_sectors, 1, MAX_READ_AHEAD_SECTORS);
+  Log_DevPrintf("Reading %u sectors per request", m_read_ahead_sectors);
+}
+
 bool CDImageDeviceWin32::DetermineReadMode()
 {
   // Prefer raw reads if we can use them
@@ -406,7 +488,7 @@ bool CDImageDeviceWin32::DetermineReadMode()
 
   DWORD bytes_returned;
   if (DeviceIoControl(m_hDevice, IOCTL_CDROM_RAW_READ, &rri, sizeof(rri), m_buffer.data(),
-                      static_cast<DWORD>(m_buffer.size()), &bytes_returned, nullptr) &&
+                      CD_RAW_SECTOR_WITH_SUBCODE_SIZE, &bytes_returned, nullptr) &&
       bytes_returned == CD_RAW_SECTOR_WITH_SUBCODE_SIZE)
   {
     SubChannelQ subq;
@@ -435,7 +517,7 @@ bool CDImageDeviceWin32::DetermineReadMode()
                 bytes_returned);
 
   SPTDBuffer sptd = {};
-  FillSPTD(&sptd, 0, true, m_buffer.data());
+  FillSPTD(&sptd, 0, 1, true, m_buffer.data());
 
   if (DeviceIoControl(m_hDevice, IOCTL_SCSI_PASS_THROUGH_DIRECT, &sptd, sizeof(sptd), &sptd, sizeof(sptd),
                       &bytes_returned, nullptr) &&
@@ -460,7 +542,7 @@ bool CDImageDeviceWin32::DetermineReadMode()
   }
 
   // try without subcode
-  FillSPTD(&sptd, 0, false, m_buffer.data());
+  FillSPTD(&sptd, 0, 1, false, m_buffer.data());
   if (DeviceIoControl(m_hDevice, IOCTL_SCSI_PASS_THROUGH_DIRECT, &sptd, sizeof(sptd), &sptd, sizeof(sptd),
                       &bytes_returned, nullptr) &&
       sptd.cmd.ScsiStatus == 0x00)
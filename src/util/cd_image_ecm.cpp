@@ -7,9 +7,18 @@
 #include "common/error.h"
 #include "common/file_system.h"
 #include "common/log.h"
+#include "fmt/format.h"
+#include <algorithm>
 #include <array>
+#include <atomic>
 #include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
 #include <map>
+#include <mutex>
+#include <optional>
+#include <thread>
 Log_SetChannel(CDImageEcm);
 
 // unecm.c by Neill Corlett (c) 2002, GPL licensed
@@ -51,9 +60,22 @@ static constexpr std::array<u32, 256> ComputeEDCLUT()
   return edc_lut;
 }
 
+// Slice-by-4 tables, edc_lut[k] advances the CRC over k further zero bytes, so four input bytes go in per step.
+static constexpr std::array<std::array<u32, 256>, 4> ComputeEDCSliceLUT()
+{
+  std::array<std::array<u32, 256>, 4> edc_lut{};
+  edc_lut[0] = ComputeEDCLUT();
+  for (u32 k = 1; k < 4; k++)
+  {
+    for (u32 i = 0; i < 256; i++)
+      edc_lut[k][i] = (edc_lut[k - 1][i] >> 8) ^ edc_lut[0][edc_lut[k - 1][i] & 0xFF];
+  }
+  return edc_lut;
+}
+
 static constexpr std::array<u8, 256> ecc_f_lut = ComputeECCFLUT();
 static constexpr std::array<u8, 256> ecc_b_lut = ComputeECCBLUT();
-static constexpr std::array<u32, 256> edc_lut = ComputeEDCLUT();
+static constexpr std::array<std::array<u32, 256>, 4> edc_lut = ComputeEDCSliceLUT();
 
 /***************************************************************************/
 /*
@@ -61,8 +83,16 @@ static constexpr std::array<u32, 256> edc_lut = ComputeEDCLUT();
 */
 static u32 edc_partial_computeblock(u32 edc, const u8* src, u16 size)
 {
+  for (; size >= 4; size -= 4, src += 4)
+  {
+    const u32 value = edc ^ (static_cast<u32>(src[0]) | (static_cast<u32>(src[1]) << 8) |
+                             (static_cast<u32>(src[2]) << 16) | (static_cast<u32>(src[3]) << 24));
+    edc = edc_lut[3][value & 0xFF] ^ edc_lut[2][(value >> 8) & 0xFF] ^ edc_lut[1][(value >> 16) & 0xFF] ^
+          edc_lut[0][value >> 24];
+  }
+
   while (size--)
-    edc = (edc >> 8) ^ edc_lut[(edc ^ (*src++)) & 0xFF];
+    edc = (edc >> 8) ^ edc_lut[0][(edc ^ (*src++)) & 0xFF];
   return edc;
 }
 
@@ -94,9 +124,8 @@ static void ecc_computeblock(u8* src, u32 major_count, u32 minor_count, u32 majo
       index += minor_inc;
       if (index >= size)
         index -= size;
-      ecc_a ^= temp;
+      ecc_a = ecc_f_lut[ecc_a ^ temp];
       ecc_b ^= temp;
-      ecc_a = ecc_f_lut[ecc_a];
     }
     ecc_a = ecc_b_lut[ecc_f_lut[ecc_a] ^ ecc_b];
     dest[major] = ecc_a;
@@ -168,12 +197,18 @@ public:
 
   bool ReadSubChannelQ(SubChannelQ* subq, const Index& index, LBA lba_in_index) override;
   bool HasNonStandardSubchannel() const override;
+  PrecacheResult Precache(ProgressCallback* progress, bool compressed) override;
+  bool IsPrecached() const override;
 
 protected:
   bool ReadSectorFromIndex(void* buffer, const Index& index, LBA lba_in_index) override;
 
 private:
-  bool ReadChunks(u32 disc_offset, u32 size);
+  enum : u32
+  {
+    /// How often the progress callback is updated while waiting for the precache workers.
+    PROGRESS_UPDATE_INTERVAL_MS = 50,
+  };
 
   std::FILE* m_fp = nullptr;
 
@@ -209,10 +244,23 @@ private:
 
   using DataMap = std::map<u32, SectorEntry>;
 
+  bool ReadChunks(u32 disc_offset, u32 size);
+
+  /// Reads and decodes a single chunk to dest, from the in-memory file if it has been loaded, otherwise from fp.
+  bool ReadChunk(std::FILE* fp, const SectorEntry& entry, u8* dest) const;
+
+  bool PrecacheDecoded(ProgressCallback* progress);
+
   DataMap m_data_map;
   std::vector<u8> m_chunk_buffer;
   u32 m_chunk_start = 0;
 
+  // Compressed precaching keeps the ECM file in memory, otherwise the whole disc is decoded up front.
+  std::vector<u8> m_file_data;
+  std::vector<u8> m_decoded_data;
+  u32 m_disc_size = 0;
+  bool m_precached = false;
+
   CDSubChannelReplacement m_sbi;
 };
 
@@ -367,6 +415,7 @@ bool CDImageEcm::Open(const char* filename, Common::Error* error)
     return false;
   }
 
+  m_disc_size = disc_offset;
   m_lba_count = disc_offset / RAW_SECTOR_SIZE;
   if ((disc_offset % RAW_SECTOR_SIZE) != 0)
     Log_WarningPrintf("ECM image is misaligned with offset %u", disc_offset);
@@ -434,90 +483,240 @@ bool CDImageEcm::ReadChunks(u32 disc_offset, u32 size)
   u32 total_bytes_read = 0;
   while (total_bytes_read < size)
   {
-    if (current == m_data_map.end() || std::fseek(m_fp, current->second.file_offset, SEEK_SET) != 0)
+    if (current == m_data_map.end())
       return false;
 
     const u32 chunk_size = current->second.chunk_size;
     const u32 chunk_start = static_cast<u32>(m_chunk_buffer.size());
     m_chunk_buffer.resize(chunk_start + chunk_size);
+    if (!ReadChunk(m_fp, current->second, &m_chunk_buffer[chunk_start]))
+      return false;
+
+    total_bytes_read += chunk_size;
+    ++current;
+  }
+
+  return true;
+}
+
+bool CDImageEcm::ReadChunk(std::FILE* fp, const SectorEntry& entry, u8* dest) const
+{
+  const u32 encoded_size =
+    (entry.type == SectorType::Raw) ? entry.chunk_size : s_sector_sizes[static_cast<u32>(entry.type)];
+
+  const u8* src;
+  u8 encoded[RAW_SECTOR_SIZE];
+  if (!m_file_data.empty())
+  {
+    if ((static_cast<size_t>(entry.file_offset) + encoded_size) > m_file_data.size())
+      return false;
+
+    src = &m_file_data[entry.file_offset];
+  }
+  else
+  {
+    if (std::fseek(fp, entry.file_offset, SEEK_SET) != 0 || std::fread(encoded, encoded_size, 1, fp) != 1)
+      return false;
+
+    src = encoded;
+  }
+
+  if (entry.type == SectorType::Raw)
+  {
+    std::memcpy(dest, src, entry.chunk_size);
+    return true;
+  }
+
+  u8 sector[RAW_SECTOR_SIZE];
+
+  // TODO: needed?
+  std::memset(sector, 0, RAW_SECTOR_SIZE);
+  std::memset(sector + 1, 0xFF, 10);
 
-    if (current->second.type == SectorType::Raw)
+  u32 skip;
+  switch (entry.type)
+  {
+    case SectorType::Mode1:
     {
-      if (std::fread(&m_chunk_buffer[chunk_start], chunk_size, 1, m_fp) != 1)
-        return false;
+      sector[0x0F] = 0x01;
+      std::memcpy(sector + 0x00C, src, 0x003);
+      std::memcpy(sector + 0x010, src + 0x003, 0x800);
 
-      total_bytes_read += chunk_size;
+      eccedc_generate(sector, 1);
+      skip = 0;
     }
-    else
+    break;
+
+    case SectorType::Mode2Form1:
     {
-      // u8* sector = &m_chunk_buffer[chunk_start];
-      u8 sector[RAW_SECTOR_SIZE];
+      sector[0x0F] = 0x02;
+      std::memcpy(sector + 0x014, src, 0x804);
 
-      // TODO: needed?
-      std::memset(sector, 0, RAW_SECTOR_SIZE);
-      std::memset(sector + 1, 0xFF, 10);
+      sector[0x10] = sector[0x14];
+      sector[0x11] = sector[0x15];
+      sector[0x12] = sector[0x16];
+      sector[0x13] = sector[0x17];
 
-      u32 skip;
-      switch (current->second.type)
-      {
-        case SectorType::Mode1:
-        {
-          sector[0x0F] = 0x01;
-          if (std::fread(sector + 0x00C, 0x003, 1, m_fp) != 1 || std::fread(sector + 0x010, 0x800, 1, m_fp) != 1)
-            return false;
+      eccedc_generate(sector, 2);
+      skip = 0x10;
+    }
+    break;
 
-          eccedc_generate(sector, 1);
-          skip = 0;
-        }
-        break;
+    case SectorType::Mode2Form2:
+    {
+      sector[0x0F] = 0x02;
+      std::memcpy(sector + 0x014, src, 0x918);
 
-        case SectorType::Mode2Form1:
-        {
-          sector[0x0F] = 0x02;
-          if (std::fread(sector + 0x014, 0x804, 1, m_fp) != 1)
-            return false;
+      sector[0x10] = sector[0x14];
+      sector[0x11] = sector[0x15];
+      sector[0x12] = sector[0x16];
+      sector[0x13] = sector[0x17];
 
-          sector[0x10] = sector[0x14];
-          sector[0x11] = sector[0x15];
-          sector[0x12] = sector[0x16];
-          sector[0x13] = sector[0x17];
+      eccedc_generate(sector, 3);
+      skip = 0x10;
+    }
+    break;
 
-          eccedc_generate(sector, 2);
-          skip = 0x10;
-        }
-        break;
+    default:
+      UnreachableCode();
+      return false;
+  }
 
-        case SectorType::Mode2Form2:
-        {
-          sector[0x0F] = 0x02;
-          if (std::fread(sector + 0x014, 0x918, 1, m_fp) != 1)
-            return false;
+  std::memcpy(dest, sector + skip, entry.chunk_size);
+  return true;
+}
 
-          sector[0x10] = sector[0x14];
-          sector[0x11] = sector[0x15];
-          sector[0x12] = sector[0x16];
-          sector[0x13] = sector[0x17];
+CDImage::PrecacheResult CDImageEcm::Precache(ProgressCallback* progress, bool compressed)
+{
+  if (m_precached)
+    return PrecacheResult::Success;
 
-          eccedc_generate(sector, 3);
-          skip = 0x10;
-        }
-        break;
+  progress->SetStatusText(fmt::format("Precaching {}...", FileSystem::GetDisplayNameFromPath(m_filename)).c_str());
 
-        default:
-          UnreachableCode();
-          return false;
+  if (compressed)
+  {
+    // ECM is already a compressed form, and decoding a sector from memory is cheap, so just keep the file around.
+    progress->SetProgressRange(1);
+    progress->SetProgressValue(0);
+    if (std::fseek(m_fp, 0, SEEK_SET) != 0)
+      return PrecacheResult::ReadError;
+
+    std::optional<std::vector<u8>> data = FileSystem::ReadBinaryFile(m_fp);
+    if (!data.has_value())
+      return PrecacheResult::ReadError;
+
+    m_file_data = std::move(data.value());
+    progress->SetProgressValue(1);
+  }
+  else
+  {
+    if (!PrecacheDecoded(progress))
+    {
+      m_decoded_data = std::vector<u8>();
+      return PrecacheResult::ReadError;
+    }
+
+    m_chunk_buffer = std::vector<u8>();
+    m_chunk_start = 0;
+  }
+
+  m_precached = true;
+  return PrecacheResult::Success;
+}
+
+bool CDImageEcm::PrecacheDecoded(ProgressCallback* progress)
+{
+  const u32 num_chunks = static_cast<u32>(m_data_map.size());
+  const u32 num_workers = std::clamp<u32>(std::thread::hardware_concurrency(), 1u, num_chunks);
+  const u32 chunks_per_worker = (num_chunks + num_workers - 1) / num_workers;
+
+  m_decoded_data.resize(m_disc_size);
+
+  std::mutex mutex;
+  std::condition_variable done_cv;
+  std::atomic<u32> chunks_done{0};
+  std::atomic_bool failed{false};
+  u32 workers_running = 0;
+
+  // Each worker decodes a contiguous run of chunks, through its own file handle so the reads don't serialize.
+  auto worker = [this, &mutex, &done_cv, &chunks_done, &failed, &workers_running](DataMap::const_iterator begin,
+                                                                                  DataMap::const_iterator end) {
+    std::FILE* fp = FileSystem::OpenCFile(m_filename.c_str(), "rb");
+    if (!fp)
+    {
+      Log_ErrorPrintf("Failed to reopen '%s' for precaching: errno %d", m_filename.c_str(), errno);
+      failed.store(true);
+    }
+
+    for (DataMap::const_iterator it = begin; fp && it != end && !failed.load(std::memory_order_relaxed); ++it)
+    {
+      if (!ReadChunk(fp, it->second, &m_decoded_data[it->first]))
+      {
+        Log_ErrorPrintf("Failed to decode chunk at disc offset %u", it->first);
+        failed.store(true);
+        break;
       }
 
-      std::memcpy(&m_chunk_buffer[chunk_start], sector + skip, chunk_size);
-      total_bytes_read += chunk_size;
+      chunks_done.fetch_add(1, std::memory_order_relaxed);
     }
 
-    ++current;
+    if (fp)
+      std::fclose(fp);
+
+    std::unique_lock lock(mutex);
+    workers_running--;
+    done_cv.notify_all();
+  };
+
+  progress->SetProgressRange(num_chunks);
+  progress->SetProgressValue(0);
+
+  std::vector<std::thread> threads;
+  DataMap::const_iterator begin = m_data_map.begin();
+  for (u32 i = 0; i < num_workers && begin != m_data_map.end(); i++)
+  {
+    DataMap::const_iterator end = begin;
+    for (u32 j = 0; j < chunks_per_worker && end != m_data_map.end(); j++)
+      ++end;
+
+    {
+      std::unique_lock lock(mutex);
+      workers_running++;
+    }
+
+    threads.emplace_back(worker, begin, end);
+    begin = end;
   }
 
+  {
+    std::unique_lock lock(mutex);
+    while (workers_running > 0)
+    {
+      done_cv.wait_for(lock, std::chrono::milliseconds(PROGRESS_UPDATE_INTERVAL_MS));
+
+      lock.unlock();
+      progress->SetProgressValue(chunks_done.load());
+      if (progress->IsCancelled())
+        failed.store(true);
+      lock.lock();
+    }
+  }
+
+  for (std::thread& thread : threads)
+    thread.join();
+
+  if (failed.load())
+    return false;
+
+  progress->SetProgressValue(num_chunks);
   return true;
 }
 
+bool CDImageEcm::IsPrecached() const
+{
+  return m_precached;
+}
+
 bool CDImageEcm::ReadSubChannelQ(SubChannelQ* subq, const Index& index, LBA lba_in_index)
 {
   if (m_sbi.GetReplacementSubChannelQ(index.start_lba_on_disc + lba_in_index, subq))
@@ -536,6 +735,15 @@ bool CDImageEcm::ReadSectorFromIndex(void* buffer, const Index& index, LBA lba_i
   const u32 file_start = static_cast<u32>(index.file_offset) + (lba_in_index * index.file_sector_size);
   const u32 file_end = file_start + RAW_SECTOR_SIZE;
 
+  if (!m_decoded_data.empty())
+  {
+    if (file_end > m_decoded_data.size())
+      return false;
+
+    std::memcpy(buffer, &m_decoded_data[file_start], RAW_SECTOR_SIZE);
+    return true;
+  }
+
   if (file_start < m_chunk_start || file_end > (m_chunk_start + m_chunk_buffer.size()))
   {
     if (!ReadChunks(file_start, RAW_SECTOR_SIZE))
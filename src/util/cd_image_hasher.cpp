@@ -3,78 +3,287 @@
 
 #include "cd_image_hasher.h"
 #include "cd_image.h"
+#include "common/log.h"
 #include "common/md5_digest.h"
 #include "common/string_util.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+Log_SetChannel(CDImageHasher);
 
 namespace CDImageHasher {
 
-static bool ReadIndex(CDImage* image, u8 track, u8 index, MD5Digest* digest, ProgressCallback* progress_callback)
+namespace {
+
+enum : u32
 {
-  const CDImage::LBA index_start = image->GetTrackIndexPosition(track, index);
-  const u32 index_length = image->GetTrackIndexLength(track, index);
-  const u32 update_interval = std::max<u32>(index_length / 100u, 1u);
+  /// Number of sectors read by the I/O thread in one go. Large batches keep the underlying file reads sequential.
+  SECTORS_PER_BATCH = 256,
+
+  /// Number of batches in flight between the I/O thread and the hash thread of a job.
+  NUM_BATCHES = 3,
 
-  progress_callback->SetFormattedStatusText("Computing hash for track %u/index %u...", track, index);
-  progress_callback->SetProgressRange(index_length);
+  /// Maximum number of tracks hashed at the same time.
+  MAX_WORKERS = 8,
 
-  if (!image->Seek(index_start))
+  /// How often the progress callback is updated while waiting for the workers.
+  PROGRESS_UPDATE_INTERVAL_MS = 50,
+};
+
+struct alignas(4096) ReadBatch
+{
+  std::array<u8, SECTORS_PER_BATCH * CDImage::RAW_SECTOR_SIZE> data;
+  u32 num_sectors;
+};
+
+struct HashJob
+{
+  struct Range
   {
-    progress_callback->DisplayFormattedModalError("Failed to seek to sector %u for track %u index %u", index_start,
-                                                  track, index);
-    return false;
-  }
+    CDImage::LBA start;
+    u32 length;
+  };
+
+  std::vector<Range> ranges;
+  MD5Digest digest;
+};
+
+struct HashContext
+{
+  std::vector<HashJob> jobs;
+  u32 total_sectors = 0;
+
+  std::atomic<u32> next_job{0};
+  std::atomic<u32> sectors_done{0};
+  std::atomic_bool cancelled{false};
 
-  std::array<u8, CDImage::RAW_SECTOR_SIZE> sector;
-  for (u32 lba = 0; lba < index_length; lba++)
+  std::mutex mutex;
+  std::condition_variable done_cv;
+  u32 workers_running = 0;
+  std::string error;
+};
+
+} // namespace
+
+static void AddTrackRanges(CDImage* image, u8 track, HashJob* job)
+{
+  static constexpr u8 INDICES_TO_READ = 2;
+
+  for (u8 index = 0; index < INDICES_TO_READ; index++)
   {
-    if ((lba % update_interval) == 0)
-      progress_callback->SetProgressValue(lba);
+    // skip index 0 if data track
+    if (track == 1 && index == 0)
+      continue;
+
+    const u32 length = image->GetTrackIndexLength(track, index);
+    if (length > 0)
+      job->ranges.push_back({image->GetTrackIndexPosition(track, index), length});
+  }
+}
+
+static void SetContextError(HashContext* ctx, std::string error)
+{
+  std::unique_lock lock(ctx->mutex);
+  if (ctx->error.empty())
+    ctx->error = std::move(error);
+  ctx->cancelled.store(true);
+}
+
+/// Streams the sectors of a job through the digest. Reads happen on a separate thread, so the image can be fetching
+/// (or decompressing) the next batch while the current one is being hashed.
+static bool HashJobSectors(CDImage* image, HashJob* job, HashContext* ctx)
+{
+  std::array<std::unique_ptr<ReadBatch>, NUM_BATCHES> batches;
+  for (std::unique_ptr<ReadBatch>& batch : batches)
+    batch = std::make_unique<ReadBatch>();
 
-    if (!image->ReadRawSector(sector.data(), nullptr))
+  std::mutex mutex;
+  std::condition_variable cv;
+  u32 head = 0;
+  u32 count = 0;
+  bool read_done = false;
+
+  std::thread io_thread([image, job, ctx, &batches, &mutex, &cv, &head, &count, &read_done]() {
+    u32 tail = 0;
+    for (const HashJob::Range& range : job->ranges)
     {
-      progress_callback->DisplayFormattedModalError("Failed to read sector %u from image", image->GetPositionOnDisc());
-      return false;
+      if (!image->Seek(range.start))
+      {
+        SetContextError(ctx, StringUtil::StdStringFromFormat("Failed to seek to sector %u", range.start));
+        break;
+      }
+
+      for (u32 pos = 0; pos < range.length && !ctx->cancelled.load();)
+      {
+        {
+          std::unique_lock lock(mutex);
+          cv.wait(lock, [&count, ctx]() { return (count < NUM_BATCHES || ctx->cancelled.load()); });
+          if (ctx->cancelled.load())
+            break;
+        }
+
+        // the hash thread won't touch this batch until it's been queued
+        ReadBatch* batch = batches[tail].get();
+        batch->num_sectors = std::min<u32>(range.length - pos, SECTORS_PER_BATCH);
+        for (u32 i = 0; i < batch->num_sectors; i++)
+        {
+          if (!image->ReadRawSector(&batch->data[i * CDImage::RAW_SECTOR_SIZE], nullptr))
+          {
+            SetContextError(ctx, StringUtil::StdStringFromFormat("Failed to read sector %u from image",
+                                                                 image->GetPositionOnDisc()));
+            break;
+          }
+        }
+        if (ctx->cancelled.load())
+          break;
+
+        pos += batch->num_sectors;
+        tail = (tail + 1) % NUM_BATCHES;
+
+        std::unique_lock lock(mutex);
+        count++;
+        cv.notify_all();
+      }
+
+      if (ctx->cancelled.load())
+        break;
     }
 
-    digest->Update(sector.data(), static_cast<u32>(sector.size()));
+    std::unique_lock lock(mutex);
+    read_done = true;
+    cv.notify_all();
+  });
+
+  for (;;)
+  {
+    ReadBatch* batch;
+    {
+      std::unique_lock lock(mutex);
+      cv.wait(lock, [&count, &read_done]() { return (count > 0 || read_done); });
+      if (count == 0 || ctx->cancelled.load())
+        break;
+
+      batch = batches[head].get();
+    }
+
+    job->digest.Update(batch->data.data(), batch->num_sectors * CDImage::RAW_SECTOR_SIZE);
+    ctx->sectors_done.fetch_add(batch->num_sectors);
+
+    std::unique_lock lock(mutex);
+    head = (head + 1) % NUM_BATCHES;
+    count--;
+    cv.notify_all();
   }
 
-  progress_callback->SetProgressValue(index_length);
-  return true;
+  // wake the I/O thread if we're bailing out early
+  {
+    std::unique_lock lock(mutex);
+    cv.notify_all();
+  }
+  io_thread.join();
+
+  return !ctx->cancelled.load();
 }
 
-static bool ReadTrack(CDImage* image, u8 track, MD5Digest* digest, ProgressCallback* progress_callback)
+static void HashWorkerThread(CDImage* image, HashContext* ctx)
 {
-  static constexpr u8 INDICES_TO_READ = 2;
+  for (;;)
+  {
+    const u32 job_index = ctx->next_job.fetch_add(1);
+    if (job_index >= ctx->jobs.size() || !HashJobSectors(image, &ctx->jobs[job_index], ctx))
+      break;
+  }
 
-  progress_callback->PushState();
+  std::unique_lock lock(ctx->mutex);
+  ctx->workers_running--;
+  ctx->done_cv.notify_all();
+}
 
-  const bool dataTrack = track == 1;
-  progress_callback->SetProgressRange(dataTrack ? 1 : 2);
+/// Opens another handle to the image, so a worker can read from it independently of the others.
+static std::unique_ptr<CDImage> ReopenImage(CDImage* image)
+{
+  // hammering a physical drive from multiple threads would only make it seek back and forth
+  const std::string& filename = image->GetFileName();
+  if (filename.empty() || CDImage::IsDeviceName(filename.c_str()))
+    return {};
 
-  u8 progress = 0;
-  for (u8 index = 0; index < INDICES_TO_READ; index++)
+  std::unique_ptr<CDImage> reopened = CDImage::Open(filename.c_str(), false, nullptr);
+
+  // playlists may have been switched to another disc, and patches change the data, so make sure it's the same layout
+  if (!reopened || reopened->GetTrackCount() != image->GetTrackCount() ||
+      reopened->GetLBACount() != image->GetLBACount() || reopened->GetIndexCount() != image->GetIndexCount())
   {
-    progress_callback->SetProgressValue(progress);
+    return {};
+  }
 
-    // skip index 0 if data track
-    if (dataTrack && index == 0)
-      continue;
+  return reopened;
+}
+
+/// Hashes all jobs in the context. The first worker reads from the image passed in, any others get their own handle.
+/// The calling thread stays on the progress callback until the workers are done.
+static bool RunHashJobs(CDImage* image, HashContext* ctx, u32 max_workers, ProgressCallback* progress_callback)
+{
+  for (const HashJob& job : ctx->jobs)
+  {
+    for (const HashJob::Range& range : job.ranges)
+      ctx->total_sectors += range.length;
+  }
+
+  std::vector<std::unique_ptr<CDImage>> extra_images;
+  const u32 num_workers = std::clamp<u32>(std::min<u32>(max_workers, static_cast<u32>(ctx->jobs.size())), 1u,
+                                          MAX_WORKERS);
+  for (u32 i = 1; i < num_workers; i++)
+  {
+    std::unique_ptr<CDImage> reopened = ReopenImage(image);
+    if (!reopened)
+      break;
 
-    progress++;
-    progress_callback->PushState();
-    if (!ReadIndex(image, track, index, digest, progress_callback))
+    extra_images.push_back(std::move(reopened));
+  }
+  Log_DevPrintf("Hashing %zu jobs with %zu workers", ctx->jobs.size(), extra_images.size() + 1);
+
+  progress_callback->SetProgressRange(std::max<u32>(ctx->total_sectors, 1u));
+  progress_callback->SetProgressValue(0);
+
+  std::vector<std::thread> workers;
+  ctx->workers_running = static_cast<u32>(extra_images.size() + 1);
+  workers.emplace_back(HashWorkerThread, image, ctx);
+  for (std::unique_ptr<CDImage>& extra_image : extra_images)
+    workers.emplace_back(HashWorkerThread, extra_image.get(), ctx);
+
+  {
+    std::unique_lock lock(ctx->mutex);
+    while (ctx->workers_running > 0)
     {
-      progress_callback->PopState();
-      progress_callback->PopState();
-      return false;
+      ctx->done_cv.wait_for(lock, std::chrono::milliseconds(PROGRESS_UPDATE_INTERVAL_MS));
+
+      lock.unlock();
+      progress_callback->SetProgressValue(ctx->sectors_done.load());
+      if (progress_callback->IsCancelled())
+        ctx->cancelled.store(true);
+      lock.lock();
     }
+  }
+
+  for (std::thread& worker : workers)
+    worker.join();
 
-    progress_callback->PopState();
+  if (!ctx->error.empty())
+  {
+    progress_callback->DisplayFormattedModalError("%s", ctx->error.c_str());
+    return false;
+  }
+  else if (ctx->cancelled.load())
+  {
+    return false;
   }
 
-  progress_callback->SetProgressValue(progress);
-  progress_callback->PopState();
+  progress_callback->SetProgressValue(std::max<u32>(ctx->total_sectors, 1u));
   return true;
 }
 
@@ -99,36 +308,55 @@ std::optional<Hash> HashFromString(const std::string_view& str) {
 bool GetImageHash(CDImage* image, Hash* out_hash,
                   ProgressCallback* progress_callback /*= ProgressCallback::NullProgressCallback*/)
 {
-  MD5Digest digest;
-
-  progress_callback->SetProgressRange(image->GetTrackCount());
-  progress_callback->SetProgressValue(0);
-  progress_callback->PushState();
-
+  // the image hash covers all tracks in one digest, so it can only be pipelined, not split up
+  HashContext ctx;
+  HashJob& job = ctx.jobs.emplace_back();
   for (u32 i = 1; i <= image->GetTrackCount(); i++)
-  {
-    progress_callback->SetProgressValue(i - 1);
-    if (!ReadTrack(image, static_cast<u8>(i), &digest, progress_callback))
-    {
-      progress_callback->PopState();
-      return false;
-    }
-  }
+    AddTrackRanges(image, static_cast<u8>(i), &job);
+
+  progress_callback->SetStatusText("Computing image hash...");
+  if (!RunHashJobs(image, &ctx, 1, progress_callback))
+    return false;
 
-  progress_callback->SetProgressValue(image->GetTrackCount());
-  digest.Final(out_hash->data());
+  job.digest.Final(out_hash->data());
   return true;
 }
 
 bool GetTrackHash(CDImage* image, u8 track, Hash* out_hash,
                   ProgressCallback* progress_callback /*= ProgressCallback::NullProgressCallback*/)
 {
-  MD5Digest digest;
-  if (!ReadTrack(image, track, &digest, progress_callback))
+  HashContext ctx;
+  HashJob& job = ctx.jobs.emplace_back();
+  AddTrackRanges(image, track, &job);
+
+  progress_callback->SetFormattedStatusText("Computing hash for track %u...", track);
+  if (!RunHashJobs(image, &ctx, 1, progress_callback))
+    return false;
+
+  job.digest.Final(out_hash->data());
+  return true;
+}
+
+bool GetTrackHashes(CDImage* image, std::vector<Hash>* out_hashes,
+                    ProgressCallback* progress_callback /*= ProgressCallback::NullProgressCallback*/)
+{
+  HashContext ctx;
+  ctx.jobs.resize(image->GetTrackCount());
+  for (u32 i = 1; i <= image->GetTrackCount(); i++)
+    AddTrackRanges(image, static_cast<u8>(i), &ctx.jobs[i - 1]);
+
+  // each worker runs an I/O thread and a hash thread
+  const u32 max_workers = std::max<u32>(std::thread::hardware_concurrency() / 2, 1u);
+
+  progress_callback->SetFormattedStatusText("Computing hashes for %u tracks...", image->GetTrackCount());
+  if (!RunHashJobs(image, &ctx, max_workers, progress_callback))
     return false;
 
-  digest.Final(out_hash->data());
+  out_hashes->resize(ctx.jobs.size());
+  for (size_t i = 0; i < ctx.jobs.size(); i++)
+    ctx.jobs[i].digest.Final((*out_hashes)[i].data());
+
   return true;
 }
 
-} // namespace CDImageHasher
\ No newline at end of file
+} // namespace CDImageHasher
@@ -7,6 +7,7 @@
 #include <array>
 #include <optional>
 #include <string>
+#include <vector>
 
 class CDImage;
 
@@ -21,4 +22,9 @@ bool GetImageHash(CDImage* image, Hash* out_hash,
 bool GetTrackHash(CDImage* image, u8 track, Hash* out_hash,
                   ProgressCallback* progress_callback = ProgressCallback::NullProgressCallback);
 
+/// Computes the hash of every track, returned in track order. Tracks are hashed in parallel when the image can be
+/// reopened from its filename, otherwise they are read one after another from the image passed in.
+bool GetTrackHashes(CDImage* image, std::vector<Hash>* out_hashes,
+                    ProgressCallback* progress_callback = ProgressCallback::NullProgressCallback);
+
 } // namespace CDImageHasher
\ No newline at end of file
@@ -10,8 +10,11 @@
 #include "common/path.h"
 #include <algorithm>
 #include <cerrno>
+#include <condition_variable>
 #include <map>
+#include <mutex>
 #include <sstream>
+#include <thread>
 Log_SetChannel(CDImageMemory);
 
 class CDImageM3u : public CDImage
@@ -30,6 +33,10 @@ public:
   u32 GetCurrentSubImage() const override;
   std::string GetSubImageMetadata(u32 index, const std::string_view& type) const override;
   bool SwitchSubImage(u32 index, Common::Error* error) override;
+  void SetDecompressionCache(u32 num_blocks, bool prefetch) override;
+
+  PrecacheResult Precache(ProgressCallback* progress, bool compressed) override;
+  bool IsPrecached() const override;
 
 protected:
   bool ReadSectorFromIndex(void* buffer, const Index& index, LBA lba_in_index) override;
@@ -40,17 +47,40 @@ private:
     // TODO: Worth storing any other data?
     std::string filename;
     std::string title;
+
+    // Opened image, kept while another sub-image is current. The other discs are opened in the background after the
+    // first one, so switching doesn't have to open and parse the file. Protected by m_preopen_mutex.
+    std::unique_ptr<CDImage> image;
+    bool precached = false;
   };
 
+  bool PrecacheSubImage(std::unique_ptr<CDImage>& image, ProgressCallback* progress);
+
+  void StartPreopenThread();
+  void StopPreopenThread();
+  void PreopenThreadEntryPoint();
+
   std::vector<Entry> m_entries;
   std::unique_ptr<CDImage> m_current_image;
   u32 m_current_image_index = UINT32_C(0xFFFFFFFF);
+  u32 m_decompression_cache_blocks = 1;
+  bool m_decompression_prefetch = false;
   bool m_apply_patches = false;
+  bool m_precached = false;
+
+  std::thread m_preopen_thread;
+  std::mutex m_preopen_mutex;
+  std::condition_variable m_preopen_done_cv;
+  u32 m_preopen_index = UINT32_C(0xFFFFFFFF);
+  bool m_preopen_shutdown = false;
 };
 
 CDImageM3u::CDImageM3u() = default;
 
-CDImageM3u::~CDImageM3u() = default;
+CDImageM3u::~CDImageM3u()
+{
+  StopPreopenThread();
+}
 
 bool CDImageM3u::Open(const char* path, bool apply_patches, Common::Error* error)
 {
@@ -105,7 +135,61 @@ bool CDImageM3u::Open(const char* path, bool apply_patches, Common::Error* error
   }
 
   Log_InfoPrintf("Loaded %zu paths from m3u '%s'", m_entries.size(), path);
-  return !m_entries.empty() && SwitchSubImage(0, error);
+  if (m_entries.empty() || !SwitchSubImage(0, error))
+    return false;
+
+  if (m_entries.size() > 1)
+    StartPreopenThread();
+
+  return true;
+}
+
+void CDImageM3u::StartPreopenThread()
+{
+  m_preopen_shutdown = false;
+  m_preopen_thread = std::thread(&CDImageM3u::PreopenThreadEntryPoint, this);
+}
+
+void CDImageM3u::StopPreopenThread()
+{
+  if (!m_preopen_thread.joinable())
+    return;
+
+  {
+    std::unique_lock lock(m_preopen_mutex);
+    m_preopen_shutdown = true;
+  }
+
+  m_preopen_thread.join();
+}
+
+void CDImageM3u::PreopenThreadEntryPoint()
+{
+  std::unique_lock lock(m_preopen_mutex);
+  for (u32 i = 0; i < static_cast<u32>(m_entries.size()) && !m_preopen_shutdown; i++)
+  {
+    if (i == m_current_image_index || m_entries[i].image)
+      continue;
+
+    m_preopen_index = i;
+    const u32 cache_blocks = m_decompression_cache_blocks;
+    lock.unlock();
+
+    // Only the current disc gets a prefetch thread, the cache is resized when switching.
+    std::unique_ptr<CDImage> image = CDImage::Open(m_entries[i].filename.c_str(), m_apply_patches, nullptr);
+    if (image)
+      image->SetDecompressionCache(cache_blocks, false);
+    else
+      Log_WarningPrintf("Failed to preopen subimage %u (%s)", i, m_entries[i].filename.c_str());
+
+    lock.lock();
+    if (image && !m_entries[i].image)
+      m_entries[i].image = std::move(image);
+    m_preopen_index = UINT32_C(0xFFFFFFFF);
+    m_preopen_done_cv.notify_all();
+  }
+
+  Log_DevPrintf("Finished preopening subimages");
 }
 
 bool CDImageM3u::HasNonStandardSubchannel() const
@@ -135,23 +219,135 @@ bool CDImageM3u::SwitchSubImage(u32 index, Common::Error* error)
   else if (index == m_current_image_index)
     return true;
 
-  const Entry& entry = m_entries[index];
-  std::unique_ptr<CDImage> new_image = CDImage::Open(entry.filename.c_str(), m_apply_patches, error);
+  Entry& entry = m_entries[index];
+  std::unique_ptr<CDImage> new_image;
+  {
+    // if it's being opened in the background right now, that'll finish sooner than opening it again
+    std::unique_lock lock(m_preopen_mutex);
+    m_preopen_done_cv.wait(lock, [this, index]() { return (m_preopen_index != index); });
+    new_image = std::move(entry.image);
+  }
+
   if (!new_image)
   {
-    Log_ErrorPrintf("Failed to load subimage %u (%s)", index, entry.filename.c_str());
-    return false;
+    new_image = CDImage::Open(entry.filename.c_str(), m_apply_patches, error);
+    if (!new_image)
+    {
+      Log_ErrorPrintf("Failed to load subimage %u (%s)", index, entry.filename.c_str());
+      return false;
+    }
   }
 
+  new_image->SetDecompressionCache(m_decompression_cache_blocks, m_decompression_prefetch);
+
   CopyTOC(new_image.get());
+
+  // keep the old image open, so switching back is just as quick
+  if (m_current_image)
+    m_current_image->SetDecompressionCache(m_decompression_cache_blocks, false);
+
+  std::unique_lock lock(m_preopen_mutex);
+  if (m_current_image)
+    m_entries[m_current_image_index].image = std::move(m_current_image);
   m_current_image = std::move(new_image);
   m_current_image_index = index;
+  lock.unlock();
+
   if (!Seek(1, Position{0, 0, 0}))
     Panic("Failed to seek to start after sub-image change.");
 
   return true;
 }
 
+void CDImageM3u::SetDecompressionCache(u32 num_blocks, bool prefetch)
+{
+  {
+    std::unique_lock lock(m_preopen_mutex);
+    m_decompression_cache_blocks = num_blocks;
+    m_decompression_prefetch = prefetch;
+  }
+
+  if (m_current_image)
+    m_current_image->SetDecompressionCache(num_blocks, prefetch);
+}
+
+CDImage::PrecacheResult CDImageM3u::Precache(ProgressCallback* progress, bool compressed)
+{
+  // Keeping every disc uncompressed in memory is too expensive, so only the compressed mode covers all sub-images.
+  if (!compressed)
+    return PrecacheResult::Unsupported;
+
+  // any remaining sub-images are opened here instead
+  StopPreopenThread();
+
+  for (u32 i = 0; i < static_cast<u32>(m_entries.size()); i++)
+  {
+    Entry& entry = m_entries[i];
+    if (entry.precached)
+      continue;
+
+    if (i == m_current_image_index)
+    {
+      const CDImage* old_image = m_current_image.get();
+      if (!PrecacheSubImage(m_current_image, progress))
+        return PrecacheResult::ReadError;
+
+      // memory images remap the index file offsets, so the TOC has to come from the new image
+      if (m_current_image.get() != old_image)
+      {
+        const LBA lba = GetPositionOnDisc();
+        CopyTOC(m_current_image.get());
+        if (!Seek(lba))
+          Panic("Failed to seek to position after precaching sub-image.");
+      }
+    }
+    else
+    {
+      std::unique_ptr<CDImage> image = std::move(entry.image);
+      if (!image)
+      {
+        image = CDImage::Open(entry.filename.c_str(), m_apply_patches, nullptr);
+        if (!image)
+        {
+          Log_ErrorPrintf("Failed to load subimage %u (%s)", i, entry.filename.c_str());
+          return PrecacheResult::ReadError;
+        }
+
+        image->SetDecompressionCache(m_decompression_cache_blocks, false);
+      }
+
+      const bool result = PrecacheSubImage(image, progress);
+      entry.image = std::move(image);
+      if (!result)
+        return PrecacheResult::ReadError;
+    }
+
+    entry.precached = true;
+  }
+
+  m_precached = true;
+  return PrecacheResult::Success;
+}
+
+bool CDImageM3u::PrecacheSubImage(std::unique_ptr<CDImage>& image, ProgressCallback* progress)
+{
+  const PrecacheResult res = image->Precache(progress, true);
+  if (res != PrecacheResult::Unsupported)
+    return (res == PrecacheResult::Success);
+
+  std::unique_ptr<CDImage> memory_image = CDImage::CreateMemoryImage(image.get(), progress, true);
+  if (!memory_image)
+    return false;
+
+  image = std::move(memory_image);
+  return true;
+}
+
+bool CDImageM3u::IsPrecached() const
+{
+  return m_precached;
+}
+
 std::string CDImageM3u::GetSubImageMetadata(u32 index, const std::string_view& type) const
 {
   if (index > m_entries.size())
@@ -7,8 +7,12 @@
 #include "common/file_system.h"
 #include "common/log.h"
 #include "common/path.h"
+#include "zstd.h"
+#include "zstd_errors.h"
 #include <algorithm>
+#include <array>
 #include <cerrno>
+#include <vector>
 Log_SetChannel(CDImageMemory);
 
 class CDImageMemory : public CDImage
@@ -17,7 +21,7 @@ public:
   CDImageMemory();
   ~CDImageMemory() override;
 
-  bool CopyImage(CDImage* image, ProgressCallback* progress);
+  bool CopyImage(CDImage* image, ProgressCallback* progress, bool compressed);
 
   bool ReadSubChannelQ(SubChannelQ* subq, const Index& index, LBA lba_in_index) override;
   bool HasNonStandardSubchannel() const override;
@@ -28,20 +32,48 @@ protected:
   bool ReadSectorFromIndex(void* buffer, const Index& index, LBA lba_in_index) override;
 
 private:
+  enum : u32
+  {
+    SECTORS_PER_CHUNK = 16,
+    CHUNK_SIZE = RAW_SECTOR_SIZE * SECTORS_PER_CHUNK,
+    NUM_DECODED_CHUNKS = 4,
+    COMPRESSION_LEVEL = 1,
+    INVALID_CHUNK_INDEX = static_cast<u32>(-1),
+  };
+
+  struct DecodedChunk
+  {
+    u32 chunk_index = INVALID_CHUNK_INDEX;
+    u32 last_used = 0;
+    std::unique_ptr<u8[]> data;
+  };
+
+  bool CompressImage(CDImage* image, ProgressCallback* progress);
+  const u8* GetDecodedChunk(u32 chunk_index);
+
   u8* m_memory = nullptr;
   u32 m_memory_sectors = 0;
   CDSubChannelReplacement m_sbi;
+
+  // Compressed storage, each chunk is an independent zstd frame. m_chunk_offsets has one extra entry for the end.
+  std::vector<u8> m_compressed_data;
+  std::vector<size_t> m_chunk_offsets;
+  std::array<DecodedChunk, NUM_DECODED_CHUNKS> m_decoded_chunks;
+  u32 m_decoded_chunk_counter = 0;
+  ZSTD_DCtx* m_dctx = nullptr;
 };
 
 CDImageMemory::CDImageMemory() = default;
 
 CDImageMemory::~CDImageMemory()
 {
+  if (m_dctx)
+    ZSTD_freeDCtx(m_dctx);
   if (m_memory)
     std::free(m_memory);
 }
 
-bool CDImageMemory::CopyImage(CDImage* image, ProgressCallback* progress)
+bool CDImageMemory::CopyImage(CDImage* image, ProgressCallback* progress, bool compressed)
 {
   // figure out the total number of sectors (not including blank pregaps)
   m_memory_sectors = 0;
@@ -59,39 +91,47 @@ bool CDImageMemory::CopyImage(CDImage* image, ProgressCallback* progress)
     return false;
   }
 
-  progress->SetFormattedStatusText("Allocating memory for %u sectors...", m_memory_sectors);
-
-  m_memory =
-    static_cast<u8*>(std::malloc(static_cast<size_t>(RAW_SECTOR_SIZE) * static_cast<size_t>(m_memory_sectors)));
-  if (!m_memory)
+  if (compressed)
   {
-    progress->DisplayFormattedModalError("Failed to allocate memory for %u sectors", m_memory_sectors);
-    return false;
+    if (!CompressImage(image, progress))
+      return false;
   }
+  else
+  {
+    progress->SetFormattedStatusText("Allocating memory for %u sectors...", m_memory_sectors);
 
-  progress->SetStatusText("Preloading CD image to RAM...");
-  progress->SetProgressRange(m_memory_sectors);
-  progress->SetProgressValue(0);
+    m_memory =
+      static_cast<u8*>(std::malloc(static_cast<size_t>(RAW_SECTOR_SIZE) * static_cast<size_t>(m_memory_sectors)));
+    if (!m_memory)
+    {
+      progress->DisplayFormattedModalError("Failed to allocate memory for %u sectors", m_memory_sectors);
+      return false;
+    }
 
-  u8* memory_ptr = m_memory;
-  u32 sectors_read = 0;
-  for (u32 i = 0; i < image->GetIndexCount(); i++)
-  {
-    const Index& index = image->GetIndex(i);
-    if (index.file_sector_size == 0)
-      continue;
+    progress->SetStatusText("Preloading CD image to RAM...");
+    progress->SetProgressRange(m_memory_sectors);
+    progress->SetProgressValue(0);
 
-    for (u32 lba = 0; lba < index.length; lba++)
+    u8* memory_ptr = m_memory;
+    u32 sectors_read = 0;
+    for (u32 i = 0; i < image->GetIndexCount(); i++)
     {
-      if (!image->ReadSectorFromIndex(memory_ptr, index, lba))
+      const Index& index = image->GetIndex(i);
+      if (index.file_sector_size == 0)
+        continue;
+
+      for (u32 lba = 0; lba < index.length; lba++)
       {
-        Log_ErrorPrintf("Failed to read LBA %u in index %u", lba, i);
-        return false;
-      }
+        if (!image->ReadSectorFromIndex(memory_ptr, index, lba))
+        {
+          Log_ErrorPrintf("Failed to read LBA %u in index %u", lba, i);
+          return false;
+        }
 
-      progress->SetProgressValue(sectors_read);
-      memory_ptr += RAW_SECTOR_SIZE;
-      sectors_read++;
+        progress->SetProgressValue(sectors_read);
+        memory_ptr += RAW_SECTOR_SIZE;
+        sectors_read++;
+      }
     }
   }
 
@@ -146,16 +186,149 @@ bool CDImageMemory::ReadSectorFromIndex(void* buffer, const Index& index, LBA lb
   if (sector_number >= m_memory_sectors)
     return false;
 
+  if (!m_memory)
+  {
+    const u8* chunk = GetDecodedChunk(static_cast<u32>(sector_number / SECTORS_PER_CHUNK));
+    if (!chunk)
+      return false;
+
+    std::memcpy(buffer, chunk + (sector_number % SECTORS_PER_CHUNK) * RAW_SECTOR_SIZE, RAW_SECTOR_SIZE);
+    return true;
+  }
+
   const size_t file_offset = static_cast<size_t>(sector_number) * static_cast<size_t>(RAW_SECTOR_SIZE);
   std::memcpy(buffer, &m_memory[file_offset], RAW_SECTOR_SIZE);
   return true;
 }
 
+bool CDImageMemory::CompressImage(CDImage* image, ProgressCallback* progress)
+{
+  const u32 num_chunks = (m_memory_sectors + (SECTORS_PER_CHUNK - 1)) / SECTORS_PER_CHUNK;
+  m_chunk_offsets.reserve(num_chunks + 1);
+  m_dctx = ZSTD_createDCtx();
+  ZSTD_CCtx* cctx = ZSTD_createCCtx();
+  if (!m_dctx || !cctx)
+  {
+    progress->DisplayFormattedModalError("Failed to create zstd context");
+    if (cctx)
+      ZSTD_freeCCtx(cctx);
+    return false;
+  }
+
+  progress->SetStatusText("Preloading CD image to RAM (compressed)...");
+  progress->SetProgressRange(m_memory_sectors);
+  progress->SetProgressValue(0);
+
+  std::unique_ptr<u8[]> chunk_buffer = std::make_unique<u8[]>(CHUNK_SIZE);
+  std::unique_ptr<u8[]> compress_buffer = std::make_unique<u8[]>(ZSTD_compressBound(CHUNK_SIZE));
+  u32 chunk_sectors = 0;
+  u32 sectors_read = 0;
+  bool result = true;
+
+  const auto flush_chunk = [&]() {
+    // partial chunks at the end are padded with zeros, since the sector count bounds the reads anyway
+    if (chunk_sectors < SECTORS_PER_CHUNK)
+    {
+      std::memset(&chunk_buffer[chunk_sectors * RAW_SECTOR_SIZE], 0,
+                  (SECTORS_PER_CHUNK - chunk_sectors) * RAW_SECTOR_SIZE);
+    }
+
+    const size_t size = ZSTD_compressCCtx(cctx, compress_buffer.get(), ZSTD_compressBound(CHUNK_SIZE),
+                                          chunk_buffer.get(), CHUNK_SIZE, COMPRESSION_LEVEL);
+    if (ZSTD_isError(size))
+    {
+      Log_ErrorPrintf("ZSTD_compressCCtx() failed: %u (%s)", static_cast<unsigned>(ZSTD_getErrorCode(size)),
+                      ZSTD_getErrorString(ZSTD_getErrorCode(size)));
+      return false;
+    }
+
+    m_chunk_offsets.push_back(m_compressed_data.size());
+    m_compressed_data.insert(m_compressed_data.end(), compress_buffer.get(), compress_buffer.get() + size);
+    chunk_sectors = 0;
+    return true;
+  };
+
+  for (u32 i = 0; i < image->GetIndexCount() && result; i++)
+  {
+    const Index& index = image->GetIndex(i);
+    if (index.file_sector_size == 0)
+      continue;
+
+    for (u32 lba = 0; lba < index.length; lba++)
+    {
+      if (!image->ReadSectorFromIndex(&chunk_buffer[chunk_sectors * RAW_SECTOR_SIZE], index, lba))
+      {
+        Log_ErrorPrintf("Failed to read LBA %u in index %u", lba, i);
+        result = false;
+        break;
+      }
+
+      progress->SetProgressValue(++sectors_read);
+      if ((++chunk_sectors) == SECTORS_PER_CHUNK && !flush_chunk())
+      {
+        result = false;
+        break;
+      }
+    }
+  }
+
+  if (result && chunk_sectors > 0)
+    result = flush_chunk();
+
+  ZSTD_freeCCtx(cctx);
+  if (!result)
+    return false;
+
+  m_chunk_offsets.push_back(m_compressed_data.size());
+  m_compressed_data.shrink_to_fit();
+  for (DecodedChunk& chunk : m_decoded_chunks)
+    chunk.data = std::make_unique<u8[]>(CHUNK_SIZE);
+
+  Log_InfoPrintf("Compressed %u sectors to %zu bytes (%.2f%%)", m_memory_sectors, m_compressed_data.size(),
+                 (static_cast<double>(m_compressed_data.size()) * 100.0) /
+                   (static_cast<double>(m_memory_sectors) * static_cast<double>(RAW_SECTOR_SIZE)));
+  return true;
+}
+
+const u8* CDImageMemory::GetDecodedChunk(u32 chunk_index)
+{
+  DecodedChunk* lru = &m_decoded_chunks[0];
+  for (DecodedChunk& chunk : m_decoded_chunks)
+  {
+    if (chunk.chunk_index == chunk_index)
+    {
+      chunk.last_used = ++m_decoded_chunk_counter;
+      return chunk.data.get();
+    }
+
+    if (chunk.last_used < lru->last_used)
+      lru = &chunk;
+  }
+
+  if ((chunk_index + 1) >= m_chunk_offsets.size())
+    return nullptr;
+
+  const size_t offset = m_chunk_offsets[chunk_index];
+  const size_t size = m_chunk_offsets[chunk_index + 1] - offset;
+  const size_t result = ZSTD_decompressDCtx(m_dctx, lru->data.get(), CHUNK_SIZE, &m_compressed_data[offset], size);
+  if (ZSTD_isError(result) || result != CHUNK_SIZE)
+  {
+    Log_ErrorPrintf("Failed to decompress chunk %u", chunk_index);
+    lru->chunk_index = INVALID_CHUNK_INDEX;
+    return nullptr;
+  }
+
+  lru->chunk_index = chunk_index;
+  lru->last_used = ++m_decoded_chunk_counter;
+  return lru->data.get();
+}
+
 std::unique_ptr<CDImage>
-CDImage::CreateMemoryImage(CDImage* image, ProgressCallback* progress /* = ProgressCallback::NullProgressCallback */)
+CDImage::CreateMemoryImage(CDImage* image, ProgressCallback* progress /* = ProgressCallback::NullProgressCallback */,
+                           bool compressed /* = false */)
 {
   std::unique_ptr<CDImageMemory> memory_image = std::make_unique<CDImageMemory>();
-  if (!memory_image->CopyImage(image, progress))
+  if (!memory_image->CopyImage(image, progress, compressed))
     return {};
 
   return memory_image;
@@ -12,8 +12,13 @@
 #include "pbp_types.h"
 #include "string.h"
 #include "zlib.h"
+#include <algorithm>
 #include <array>
+#include <atomic>
+#include <condition_variable>
 #include <cstdio>
+#include <mutex>
+#include <thread>
 #include <vector>
 Log_SetChannel(CDImagePBP);
 
@@ -39,16 +44,40 @@ public:
   std::string GetMetadata(const std::string_view& type) const override;
   std::string GetSubImageMetadata(u32 index, const std::string_view& type) const override;
 
+  PrecacheResult Precache(ProgressCallback* progress, bool compressed) override;
+  bool IsPrecached() const override;
+  void SetDecompressionCache(u32 num_blocks, bool prefetch) override;
+
 protected:
   bool ReadSectorFromIndex(void* buffer, const Index& index, LBA lba_in_index) override;
 
 private:
+  enum : u32
+  {
+    INVALID_BLOCK_INDEX = static_cast<u32>(-1),
+    PREFETCH_BLOCKS = 2,
+  };
+
+  enum class PrecacheMode : u8
+  {
+    None,
+    Compressed,
+    Decompressed,
+  };
+
   struct BlockInfo
   {
     u32 offset; // Absolute offset from start of file
     u16 size;
   };
 
+  struct CachedBlock
+  {
+    u32 block_index = INVALID_BLOCK_INDEX;
+    u32 last_used = 0;
+    std::unique_ptr<u8[]> data;
+  };
+
 #if _DEBUG
   static void PrintPBPHeaderInfo(const PBPHeader& pbp_header);
   static void PrintSFOHeaderInfo(const SFOHeader& sfo_header);
@@ -63,11 +92,27 @@ private:
 
   bool IsValidEboot(Common::Error* error);
 
-  bool InitDecompressionStream();
-  bool DecompressBlock(const BlockInfo& block_info);
+  static bool InitDecompressionStream(z_stream* stream);
+
+  // Reads from the precached compressed data if present, otherwise from fp into compressed_buffer.
+  bool DecompressBlock(u32 block_index, std::FILE* fp, z_stream* stream, std::vector<u8>& compressed_buffer,
+                       u8* out_data);
 
   bool OpenDisc(u32 index, Common::Error* error);
 
+  // These require m_block_cache_mutex to be held.
+  CachedBlock* LookupBlock(u32 block_index);
+  CachedBlock& GetLeastRecentlyUsedBlock();
+  const u8* ReadBlock(u32 block_index, std::unique_lock<std::mutex>& lock);
+
+  bool StartPrefetchThread();
+  void StopPrefetchThread();
+  void PrefetchThreadEntryPoint();
+
+  bool PrecacheDisc(ProgressCallback* progress);
+  bool DecompressPrecachedBlocks(ProgressCallback* progress);
+  void ClearPrecachedData();
+
   static const std::string* LookupStringSFOTableEntry(const char* key, const SFOTable& table);
 
   FILE* m_file = nullptr;
@@ -86,11 +131,32 @@ private:
 
   std::array<TOCEntry, TOC_NUM_ENTRIES> m_toc;
 
-  u32 m_current_block = static_cast<u32>(-1);
-  std::array<u8, DECOMPRESSED_BLOCK_SIZE> m_decompressed_block;
+  u32 m_num_blocks = 0;
   std::vector<u8> m_compressed_block;
-
-  z_stream m_inflate_stream;
+  z_stream m_inflate_stream = {};
+
+  std::mutex m_block_cache_mutex;
+  std::vector<CachedBlock> m_block_cache;
+  u32 m_block_cache_counter = 0;
+  u32 m_decompression_cache_blocks = 1;
+  bool m_decompression_prefetch = false;
+
+  // Precached blocks, either as stored in the file with an offset per block, or fully decompressed.
+  // The mode is kept so it can be reapplied when switching discs.
+  PrecacheMode m_precache_mode = PrecacheMode::None;
+  std::vector<u8> m_precached_compressed_data;
+  std::vector<u32> m_precached_block_offsets;
+  std::unique_ptr<u8[]> m_precached_decompressed_data;
+
+  // The prefetcher has its own handle and stream, since they're not thread safe.
+  std::FILE* m_prefetch_file = nullptr;
+  z_stream m_prefetch_inflate_stream = {};
+  std::thread m_prefetch_thread;
+  std::condition_variable m_prefetch_wake_cv;
+  std::condition_variable m_prefetch_done_cv;
+  u32 m_prefetch_request = INVALID_BLOCK_INDEX;
+  u32 m_prefetch_current = INVALID_BLOCK_INDEX;
+  bool m_prefetch_shutdown = false;
 
   CDSubChannelReplacement m_sbi;
 };
@@ -124,6 +190,7 @@ static void SwapByteOrder(T& val)
 
 CDImagePBP::~CDImagePBP()
 {
+  StopPrefetchThread();
   if (m_file)
     fclose(m_file);
 
@@ -438,6 +505,9 @@ bool CDImagePBP::Open(const char* filename, Common::Error* error)
     m_disc_offsets.push_back(m_pbp_header.data_psar_offset);
   }
 
+  // Decompress on demand into a single block until the cache size is configured.
+  SetDecompressionCache(m_decompression_cache_blocks, m_decompression_prefetch);
+
   // Default to first disc for now
   return OpenDisc(0, error);
 }
@@ -452,10 +522,15 @@ bool CDImagePBP::OpenDisc(u32 index, Common::Error* error)
     return false;
   }
 
-  m_current_block = static_cast<u32>(-1);
+  // the block table is about to change, so nothing cached can be used
+  StopPrefetchThread();
+  ClearPrecachedData();
+  for (CachedBlock& block : m_block_cache)
+    block.block_index = INVALID_BLOCK_INDEX;
+
+  m_num_blocks = 0;
   m_blockinfo_table.fill({});
   m_toc.fill({});
-  m_decompressed_block.fill(0x00);
   m_compressed_block.clear();
 
   // Go to ISO header
@@ -523,6 +598,8 @@ bool CDImagePBP::OpenDisc(u32 index, Common::Error* error)
 
     // Only store absolute file offset into a BlockInfo if this is a valid block
     m_blockinfo_table[i] = {(bte.size != 0) ? (iso_header_start + iso_offset + bte.offset) : 0, bte.size};
+    if (bte.size != 0)
+      m_num_blocks = i + 1;
 
     // printf("Block %u, file offset %u, size %u\n", i, m_blockinfo_table[i].offset, m_blockinfo_table[i].size);
   }
@@ -670,7 +747,8 @@ bool CDImagePBP::OpenDisc(u32 index, Common::Error* error)
   AddLeadOutIndex();
 
   // Initialize zlib stream
-  if (!InitDecompressionStream())
+  inflateEnd(&m_inflate_stream);
+  if (!InitDecompressionStream(&m_inflate_stream))
   {
     Log_ErrorPrint("Failed to initialize zlib decompression stream");
     return false;
@@ -686,6 +764,16 @@ bool CDImagePBP::OpenDisc(u32 index, Common::Error* error)
     m_sbi.LoadSBI(Path::ReplaceExtension(m_filename, "sbi").c_str());
 
   m_current_disc = index;
+
+  if (m_precache_mode != PrecacheMode::None && !PrecacheDisc(ProgressCallback::NullProgressCallback))
+  {
+    Log_WarningPrintf("Failed to precache disc %u, reading from file", index + 1);
+    ClearPrecachedData();
+  }
+
+  if (m_decompression_prefetch && !m_precached_decompressed_data && !StartPrefetchThread())
+    Log_WarningPrintf("Failed to start PBP prefetch thread, blocks will be decompressed on demand.");
+
   return Seek(1, Position{0, 0, 0});
 }
 
@@ -702,45 +790,59 @@ const std::string* CDImagePBP::LookupStringSFOTableEntry(const char* key, const
   return &std::get<std::string>(data_value);
 }
 
-bool CDImagePBP::InitDecompressionStream()
+bool CDImagePBP::InitDecompressionStream(z_stream* stream)
 {
-  m_inflate_stream = {};
-  m_inflate_stream.next_in = Z_NULL;
-  m_inflate_stream.avail_in = 0;
-  m_inflate_stream.zalloc = Z_NULL;
-  m_inflate_stream.zfree = Z_NULL;
-  m_inflate_stream.opaque = Z_NULL;
-
-  int ret = inflateInit2(&m_inflate_stream, -MAX_WBITS);
+  *stream = {};
+  stream->next_in = Z_NULL;
+  stream->avail_in = 0;
+  stream->zalloc = Z_NULL;
+  stream->zfree = Z_NULL;
+  stream->opaque = Z_NULL;
+
+  int ret = inflateInit2(stream, -MAX_WBITS);
   return ret == Z_OK;
 }
 
-bool CDImagePBP::DecompressBlock(const BlockInfo& block_info)
+bool CDImagePBP::DecompressBlock(u32 block_index, std::FILE* fp, z_stream* stream,
+                                 std::vector<u8>& compressed_buffer, u8* out_data)
 {
-  if (FSeek64(m_file, block_info.offset, SEEK_SET) != 0)
-    return false;
-
-  // Compression level 0 has compressed size == decompressed size.
-  if (block_info.size == m_decompressed_block.size())
+  const BlockInfo& block_info = m_blockinfo_table[block_index];
+  const u8* compressed_data;
+  if (!m_precached_compressed_data.empty())
   {
-    return (fread(m_decompressed_block.data(), sizeof(u8), m_decompressed_block.size(), m_file) ==
-            m_decompressed_block.size());
+    compressed_data = &m_precached_compressed_data[m_precached_block_offsets[block_index]];
   }
+  else
+  {
+    if (FSeek64(fp, block_info.offset, SEEK_SET) != 0)
+      return false;
 
-  m_compressed_block.resize(block_info.size);
+    // Compression level 0 has compressed size == decompressed size.
+    if (block_info.size == DECOMPRESSED_BLOCK_SIZE)
+      return (fread(out_data, sizeof(u8), DECOMPRESSED_BLOCK_SIZE, fp) == DECOMPRESSED_BLOCK_SIZE);
 
-  if (fread(m_compressed_block.data(), sizeof(u8), m_compressed_block.size(), m_file) != m_compressed_block.size())
-    return false;
+    compressed_buffer.resize(block_info.size);
+    if (fread(compressed_buffer.data(), sizeof(u8), compressed_buffer.size(), fp) != compressed_buffer.size())
+      return false;
 
-  m_inflate_stream.next_in = m_compressed_block.data();
-  m_inflate_stream.avail_in = static_cast<uInt>(m_compressed_block.size());
-  m_inflate_stream.next_out = m_decompressed_block.data();
-  m_inflate_stream.avail_out = static_cast<uInt>(m_decompressed_block.size());
+    compressed_data = compressed_buffer.data();
+  }
 
-  if (inflateReset(&m_inflate_stream) != Z_OK)
+  if (block_info.size == DECOMPRESSED_BLOCK_SIZE)
+  {
+    std::memcpy(out_data, compressed_data, DECOMPRESSED_BLOCK_SIZE);
+    return true;
+  }
+
+  stream->next_in = const_cast<u8*>(compressed_data);
+  stream->avail_in = static_cast<uInt>(block_info.size);
+  stream->next_out = out_data;
+  stream->avail_out = static_cast<uInt>(DECOMPRESSED_BLOCK_SIZE);
+
+  if (inflateReset(stream) != Z_OK)
     return false;
 
-  int err = inflate(&m_inflate_stream, Z_FINISH);
+  int err = inflate(stream, Z_FINISH);
   if (err != Z_STREAM_END)
   {
     Log_ErrorPrintf("Inflate error %d", err);
@@ -777,13 +879,341 @@ bool CDImagePBP::ReadSectorFromIndex(void* buffer, const Index& index, LBA lba_i
     return false;
   }
 
-  if (m_current_block != requested_block && !DecompressBlock(bi))
+  if (m_precached_decompressed_data)
+  {
+    std::memcpy(buffer,
+                &m_precached_decompressed_data[static_cast<size_t>(requested_block) * DECOMPRESSED_BLOCK_SIZE +
+                                               offset_in_block],
+                RAW_SECTOR_SIZE);
+    return true;
+  }
+
+  std::unique_lock lock(m_block_cache_mutex);
+  const u8* block_data = ReadBlock(requested_block, lock);
+  if (!block_data)
   {
     Log_ErrorPrintf("Failed to decompress block %u", requested_block);
     return false;
   }
 
-  std::memcpy(buffer, &m_decompressed_block[offset_in_block], RAW_SECTOR_SIZE);
+  std::memcpy(buffer, &block_data[offset_in_block], RAW_SECTOR_SIZE);
+  return true;
+}
+
+CDImagePBP::CachedBlock* CDImagePBP::LookupBlock(u32 block_index)
+{
+  for (CachedBlock& block : m_block_cache)
+  {
+    if (block.block_index == block_index)
+      return &block;
+  }
+
+  return nullptr;
+}
+
+CDImagePBP::CachedBlock& CDImagePBP::GetLeastRecentlyUsedBlock()
+{
+  CachedBlock* lru = &m_block_cache[0];
+  for (CachedBlock& block : m_block_cache)
+  {
+    if (block.block_index == INVALID_BLOCK_INDEX)
+      return block;
+    if (block.last_used < lru->last_used)
+      lru = &block;
+  }
+
+  return *lru;
+}
+
+const u8* CDImagePBP::ReadBlock(u32 block_index, std::unique_lock<std::mutex>& lock)
+{
+  // Don't decompress the block twice if the prefetcher is already working on it.
+  m_prefetch_done_cv.wait(lock, [this, block_index]() { return (m_prefetch_current != block_index); });
+
+  CachedBlock* block = LookupBlock(block_index);
+  if (!block)
+  {
+    block = &GetLeastRecentlyUsedBlock();
+    if (!DecompressBlock(block_index, m_file, &m_inflate_stream, m_compressed_block, block->data.get()))
+    {
+      // data might have been partially written
+      block->block_index = INVALID_BLOCK_INDEX;
+      return nullptr;
+    }
+
+    block->block_index = block_index;
+  }
+
+  block->last_used = ++m_block_cache_counter;
+
+  // Keep the prefetcher ahead of the reads, for sequential access.
+  if (m_prefetch_thread.joinable() && LookupBlock(block_index + 1) == nullptr)
+  {
+    m_prefetch_request = block_index + 1;
+    m_prefetch_wake_cv.notify_one();
+  }
+
+  return block->data.get();
+}
+
+void CDImagePBP::SetDecompressionCache(u32 num_blocks, bool prefetch)
+{
+  StopPrefetchThread();
+
+  {
+    std::unique_lock lock(m_block_cache_mutex);
+    m_block_cache.clear();
+    m_block_cache.resize(std::max(num_blocks, 1u));
+    for (CachedBlock& block : m_block_cache)
+      block.data = std::make_unique<u8[]>(DECOMPRESSED_BLOCK_SIZE);
+    m_block_cache_counter = 0;
+  }
+
+  // Prefetching needs room for the blocks ahead, without evicting the one being read.
+  m_decompression_cache_blocks = num_blocks;
+  m_decompression_prefetch = (prefetch && num_blocks > PREFETCH_BLOCKS);
+  if (m_decompression_prefetch && !m_precached_decompressed_data && !StartPrefetchThread())
+    Log_WarningPrintf("Failed to start PBP prefetch thread, blocks will be decompressed on demand.");
+}
+
+bool CDImagePBP::StartPrefetchThread()
+{
+  // the precached compressed data is shared, otherwise the prefetcher needs its own handle
+  if (m_precached_compressed_data.empty())
+  {
+    m_prefetch_file = FileSystem::OpenCFile(m_filename.c_str(), "rb");
+    if (!m_prefetch_file)
+      return false;
+  }
+
+  if (!InitDecompressionStream(&m_prefetch_inflate_stream))
+  {
+    if (m_prefetch_file)
+    {
+      std::fclose(m_prefetch_file);
+      m_prefetch_file = nullptr;
+    }
+
+    return false;
+  }
+
+  m_prefetch_request = INVALID_BLOCK_INDEX;
+  m_prefetch_current = INVALID_BLOCK_INDEX;
+  m_prefetch_shutdown = false;
+  m_prefetch_thread = std::thread(&CDImagePBP::PrefetchThreadEntryPoint, this);
+  return true;
+}
+
+void CDImagePBP::StopPrefetchThread()
+{
+  if (!m_prefetch_thread.joinable())
+    return;
+
+  {
+    std::unique_lock lock(m_block_cache_mutex);
+    m_prefetch_shutdown = true;
+    m_prefetch_wake_cv.notify_one();
+  }
+
+  m_prefetch_thread.join();
+
+  inflateEnd(&m_prefetch_inflate_stream);
+  if (m_prefetch_file)
+  {
+    std::fclose(m_prefetch_file);
+    m_prefetch_file = nullptr;
+  }
+}
+
+void CDImagePBP::PrefetchThreadEntryPoint()
+{
+  std::unique_ptr<u8[]> buffer = std::make_unique<u8[]>(DECOMPRESSED_BLOCK_SIZE);
+  std::vector<u8> compressed_buffer;
+
+  std::unique_lock lock(m_block_cache_mutex);
+  for (;;)
+  {
+    m_prefetch_wake_cv.wait(lock,
+                            [this]() { return (m_prefetch_shutdown || m_prefetch_request != INVALID_BLOCK_INDEX); });
+    if (m_prefetch_shutdown)
+      break;
+
+    const u32 first_block = m_prefetch_request;
+    const u32 last_block = std::min(first_block + PREFETCH_BLOCKS, m_num_blocks);
+    m_prefetch_request = INVALID_BLOCK_INDEX;
+
+    for (u32 block_index = first_block; block_index < last_block; block_index++)
+    {
+      // Stop early if the reader has moved somewhere else in the meantime.
+      if (m_prefetch_shutdown || m_prefetch_request != INVALID_BLOCK_INDEX)
+        break;
+      if (LookupBlock(block_index) || m_blockinfo_table[block_index].size == 0)
+        continue;
+
+      m_prefetch_current = block_index;
+      lock.unlock();
+      const bool result = DecompressBlock(block_index, m_prefetch_file, &m_prefetch_inflate_stream,
+                                          compressed_buffer, buffer.get());
+      lock.lock();
+      m_prefetch_current = INVALID_BLOCK_INDEX;
+
+      if (result)
+      {
+        // Swap the buffers, so the evicted block's memory gets reused for the next one.
+        CachedBlock& block = GetLeastRecentlyUsedBlock();
+        block.block_index = block_index;
+        block.last_used = ++m_block_cache_counter;
+        std::swap(block.data, buffer);
+      }
+      else
+      {
+        Log_ErrorPrintf("Prefetch of block %u failed", block_index);
+      }
+
+      m_prefetch_done_cv.notify_one();
+      if (!result)
+        break;
+    }
+  }
+}
+
+CDImage::PrecacheResult CDImagePBP::Precache(ProgressCallback* progress, bool compressed)
+{
+  const PrecacheMode mode = compressed ? PrecacheMode::Compressed : PrecacheMode::Decompressed;
+  if (m_precache_mode == mode)
+    return PrecacheResult::Success;
+
+  StopPrefetchThread();
+  ClearPrecachedData();
+  m_precache_mode = mode;
+
+  const bool result = PrecacheDisc(progress);
+  if (!result)
+  {
+    ClearPrecachedData();
+    m_precache_mode = PrecacheMode::None;
+  }
+
+  if (m_decompression_prefetch && !m_precached_decompressed_data && !StartPrefetchThread())
+    Log_WarningPrintf("Failed to start PBP prefetch thread, blocks will be decompressed on demand.");
+
+  return result ? PrecacheResult::Success : PrecacheResult::ReadError;
+}
+
+bool CDImagePBP::IsPrecached() const
+{
+  return (m_precache_mode != PrecacheMode::None);
+}
+
+void CDImagePBP::ClearPrecachedData()
+{
+  m_precached_compressed_data = {};
+  m_precached_block_offsets = {};
+  m_precached_decompressed_data.reset();
+}
+
+bool CDImagePBP::PrecacheDisc(ProgressCallback* progress)
+{
+  DebugAssert(!m_prefetch_thread.joinable());
+
+  // Read the blocks in file order first, the file is the bottleneck here.
+  u32 total_size = 0;
+  for (u32 i = 0; i < m_num_blocks; i++)
+    total_size += m_blockinfo_table[i].size;
+
+  progress->SetFormattedStatusText("Loading %u blocks of disc %u...", m_num_blocks, m_current_disc + 1);
+  progress->SetProgressRange(m_num_blocks);
+  progress->SetProgressValue(0);
+
+  std::vector<u8> compressed_data(total_size);
+  std::vector<u32> block_offsets(m_num_blocks);
+  u32 offset = 0;
+  for (u32 i = 0; i < m_num_blocks; i++)
+  {
+    const BlockInfo& bi = m_blockinfo_table[i];
+    block_offsets[i] = offset;
+    if (bi.size == 0)
+      continue;
+
+    if (FSeek64(m_file, bi.offset, SEEK_SET) != 0 || fread(&compressed_data[offset], bi.size, 1, m_file) != 1)
+    {
+      Log_ErrorPrintf("Failed to read block %u for precaching", i);
+      return false;
+    }
+
+    offset += bi.size;
+    progress->SetProgressValue(i + 1);
+  }
+
+  m_precached_compressed_data = std::move(compressed_data);
+  m_precached_block_offsets = std::move(block_offsets);
+  if (m_precache_mode == PrecacheMode::Compressed)
+    return true;
+
+  // Inflating everything is CPU bound, so spread it across all cores. The compressed copy isn't needed afterwards.
+  const bool result = DecompressPrecachedBlocks(progress);
+  m_precached_compressed_data = {};
+  m_precached_block_offsets = {};
+  return result;
+}
+
+bool CDImagePBP::DecompressPrecachedBlocks(ProgressCallback* progress)
+{
+  std::unique_ptr<u8[]> data = std::make_unique<u8[]>(static_cast<size_t>(m_num_blocks) * DECOMPRESSED_BLOCK_SIZE);
+  std::atomic<u32> next_block{0};
+  std::atomic<u32> blocks_done{0};
+  std::atomic_bool failed{false};
+
+  const auto worker = [this, &data, &next_block, &blocks_done, &failed](ProgressCallback* progress) {
+    z_stream stream;
+    if (!InitDecompressionStream(&stream))
+    {
+      failed.store(true);
+      return;
+    }
+
+    std::vector<u8> unused_buffer;
+    for (;;)
+    {
+      const u32 block_index = next_block.fetch_add(1);
+      if (block_index >= m_num_blocks || failed.load())
+        break;
+
+      if (m_blockinfo_table[block_index].size != 0 &&
+          !DecompressBlock(block_index, nullptr, &stream, unused_buffer,
+                           &data[static_cast<size_t>(block_index) * DECOMPRESSED_BLOCK_SIZE]))
+      {
+        Log_ErrorPrintf("Failed to decompress block %u for precaching", block_index);
+        failed.store(true);
+        break;
+      }
+
+      const u32 done = blocks_done.fetch_add(1) + 1;
+      if (progress)
+        progress->SetProgressValue(done);
+    }
+
+    inflateEnd(&stream);
+  };
+
+  progress->SetFormattedStatusText("Decompressing %u blocks of disc %u...", m_num_blocks, m_current_disc + 1);
+  progress->SetProgressRange(m_num_blocks);
+  progress->SetProgressValue(0);
+
+  // the calling thread works too, and is the only one which reports progress
+  std::vector<std::thread> threads;
+  const u32 num_threads = std::max(std::thread::hardware_concurrency(), 1u);
+  for (u32 i = 1; i < num_threads; i++)
+    threads.emplace_back(worker, nullptr);
+  worker(progress);
+  for (std::thread& thread : threads)
+    thread.join();
+
+  if (failed.load())
+    return false;
+
+  Log_InfoPrintf("Decompressed %u blocks on %u threads", m_num_blocks, num_threads);
+  m_precached_decompressed_data = std::move(data);
   return true;
 }
 
@@ -32,7 +32,8 @@ public:
   std::string GetMetadata(const std::string_view& type) const override;
   std::string GetSubImageMetadata(u32 index, const std::string_view& type) const override;
 
-  PrecacheResult Precache(ProgressCallback* progress = ProgressCallback::NullProgressCallback) override;
+  PrecacheResult Precache(ProgressCallback* progress = ProgressCallback::NullProgressCallback,
+                          bool compressed = false) override;
 
 protected:
   bool ReadSectorFromIndex(void* buffer, const Index& index, LBA lba_in_index) override;
@@ -45,10 +46,19 @@ private:
 
   bool AddPatch(u64 offset, const u8* patch, u32 patch_size);
 
+  ALWAYS_INLINE bool IsSectorPatched(u32 sector_index) const
+  {
+    const u32 word = sector_index / 64;
+    return (word < m_patched_sectors.size() && (m_patched_sectors[word] & (u64(1) << (sector_index % 64))) != 0);
+  }
+
   std::unique_ptr<CDImage> m_parent_image;
   std::vector<u8> m_replacement_data;
   std::unordered_map<u32, u32> m_replacement_map;
   u32 m_replacement_offset = 0;
+
+  // One bit per sector on the disc, so unpatched reads can skip the map lookup.
+  std::vector<u64> m_patched_sectors;
 };
 
 CDImagePPF::CDImagePPF() = default;
@@ -81,6 +91,7 @@ bool CDImagePPF::Open(const char* filename, std::unique_ptr<CDImage> parent_imag
   m_tracks = parent_image->GetTracks();
   m_indices = parent_image->GetIndices();
   m_parent_image = std::move(parent_image);
+  m_patched_sectors.resize((m_parent_image->GetLBACount() + 63) / 64);
 
   if (magic == 0x33465050) // PPF3
     return ReadV3Patch(fp.get());
@@ -382,6 +393,7 @@ bool CDImagePPF::AddPatch(u64 offset, const u8* patch, u32 patch_size)
       }
 
       iter = m_replacement_map.emplace(sector_index, replacement_buffer_start).first;
+      m_patched_sectors[sector_index / 64] |= (u64(1) << (sector_index % 64));
     }
 
     // patch it!
@@ -420,9 +432,10 @@ std::string CDImagePPF::GetSubImageMetadata(u32 index, const std::string_view& t
   return ret;
 }
 
-CDImage::PrecacheResult CDImagePPF::Precache(ProgressCallback* progress /*= ProgressCallback::NullProgressCallback*/)
+CDImage::PrecacheResult CDImagePPF::Precache(ProgressCallback* progress /*= ProgressCallback::NullProgressCallback*/,
+                                             bool compressed /*= false*/)
 {
-  return m_parent_image->Precache(progress);
+  return m_parent_image->Precache(progress, compressed);
 }
 
 bool CDImagePPF::ReadSectorFromIndex(void* buffer, const Index& index, LBA lba_in_index)
@@ -430,10 +443,12 @@ bool CDImagePPF::ReadSectorFromIndex(void* buffer, const Index& index, LBA lba_i
   DebugAssert(index.file_index == 0);
 
   const u32 sector_number = index.start_lba_on_disc + lba_in_index;
-  const auto it = m_replacement_map.find(sector_number);
-  if (it == m_replacement_map.end())
+  if (!IsSectorPatched(sector_number))
     return m_parent_image->ReadSectorFromIndex(buffer, index, lba_in_index);
 
+  const auto it = m_replacement_map.find(sector_number);
+  DebugAssert(it != m_replacement_map.end());
+
   std::memcpy(buffer, &m_replacement_data[it->second], RAW_SECTOR_SIZE);
   return true;
 }
@@ -81,6 +81,7 @@ bool CDSubChannelReplacement::LoadSBI(const char* path)
     subq.data[11] = Truncate8(crc >> 8);
 
     m_replacement_subq.emplace(lba, subq);
+    AddToBitmap(lba);
   }
 
   Log_InfoPrintf("Loaded %zu replacement sectors from '%s'", m_replacement_subq.size(), path);
@@ -99,6 +100,17 @@ void CDSubChannelReplacement::AddReplacementSubChannelQ(u32 lba, const CDImage::
     iter->second.data = subq.data;
   else
     m_replacement_subq.emplace(lba, subq);
+
+  AddToBitmap(lba);
+}
+
+void CDSubChannelReplacement::AddToBitmap(u32 lba)
+{
+  const u32 word = lba / 64;
+  if (word >= m_replacement_bitmap.size())
+    m_replacement_bitmap.resize(word + 1);
+
+  m_replacement_bitmap[word] |= (u64(1) << (lba % 64));
 }
 
 bool CDSubChannelReplacement::GetReplacementSubChannelQ(u8 minute_bcd, u8 second_bcd, u8 frame_bcd,
@@ -109,6 +121,9 @@ bool CDSubChannelReplacement::GetReplacementSubChannelQ(u8 minute_bcd, u8 second
 
 bool CDSubChannelReplacement::GetReplacementSubChannelQ(u32 lba, CDImage::SubChannelQ* subq) const
 {
+  if (!HasReplacementSubChannelQ(lba))
+    return false;
+
   const auto iter = m_replacement_subq.find(lba);
   if (iter == m_replacement_subq.cend())
     return false;
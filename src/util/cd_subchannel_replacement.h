@@ -7,6 +7,7 @@
 #include <array>
 #include <cstdio>
 #include <unordered_map>
+#include <vector>
 
 class CDSubChannelReplacement
 {
@@ -28,8 +29,20 @@ public:
   /// Returns the replacement subchannel data for the specified sector.
   bool GetReplacementSubChannelQ(u32 lba, CDImage::SubChannelQ* subq) const;
 
+  /// Returns true if the specified sector has replacement subchannel data.
+  ALWAYS_INLINE bool HasReplacementSubChannelQ(u32 lba) const
+  {
+    const u32 word = lba / 64;
+    return (word < m_replacement_bitmap.size() && (m_replacement_bitmap[word] & (u64(1) << (lba % 64))) != 0);
+  }
+
 private:
   using ReplacementMap = std::unordered_map<u32, CDImage::SubChannelQ>;
 
+  void AddToBitmap(u32 lba);
+
   ReplacementMap m_replacement_subq;
+
+  // One bit per sector, so the common case of no replacement doesn't need a map lookup.
+  std::vector<u64> m_replacement_bitmap;
 };
@@ -3,20 +3,72 @@
 
 #include "cd_xa.h"
 #include "cd_image.h"
+#include "common/platform.h"
 #include <algorithm>
 #include <array>
+#include <cstring>
+
+#if defined(CPU_X64)
+#include <emmintrin.h>
+#elif defined(CPU_AARCH64)
+#ifdef _MSC_VER
+#include <arm64_neon.h>
+#else
+#include <arm_neon.h>
+#endif
+#endif
 
 namespace CDXA {
 static constexpr std::array<s32, 4> s_xa_adpcm_filter_table_pos = {{0, 60, 115, 98}};
 static constexpr std::array<s32, 4> s_xa_adpcm_filter_table_neg = {{0, 0, -52, -55}};
 
+static constexpr u32 WORDS_PER_BLOCK = 28;
+
+/// Pulls the nibbles (or bytes) of one block out of the interleaved words, and applies the shift from the header.
+/// Only the low four bits of a sample survive the truncation to 16 bits, so both sample sizes are handled the same:
+/// moving them to the top of a 32-bit lane and arithmetic shifting back down is s16(nibble << 12) >> shift.
+template<bool IS_8BIT>
+ALWAYS_INLINE static void UnpackXA_ADPCMBlock(const u8* words_ptr, u32 block, u8 shift, s32* out)
+{
+  constexpr u32 BITS_PER_SAMPLE = IS_8BIT ? 8 : 4;
+  const u32 field_shift = block * BITS_PER_SAMPLE;
+  const u32 sample_shift = 16 + shift;
+
+#if defined(CPU_X64)
+  const __m128i field_shift_vec = _mm_cvtsi32_si128(static_cast<int>(field_shift));
+  const __m128i sample_shift_vec = _mm_cvtsi32_si128(static_cast<int>(sample_shift));
+  for (u32 word = 0; word < WORDS_PER_BLOCK; word += 4)
+  {
+    __m128i value = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&words_ptr[word * sizeof(u32)]));
+    value = _mm_slli_epi32(_mm_srl_epi32(value, field_shift_vec), 28);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(&out[word]), _mm_sra_epi32(value, sample_shift_vec));
+  }
+#elif defined(CPU_AARCH64)
+  const int32x4_t field_shift_vec = vdupq_n_s32(-static_cast<s32>(field_shift));
+  const int32x4_t sample_shift_vec = vdupq_n_s32(-static_cast<s32>(sample_shift));
+  for (u32 word = 0; word < WORDS_PER_BLOCK; word += 4)
+  {
+    uint32x4_t value = vld1q_u32(reinterpret_cast<const u32*>(&words_ptr[word * sizeof(u32)]));
+    value = vshlq_n_u32(vshlq_u32(value, field_shift_vec), 28);
+    vst1q_s32(&out[word], vshlq_s32(vreinterpretq_s32_u32(value), sample_shift_vec));
+  }
+#else
+  for (u32 word = 0; word < WORDS_PER_BLOCK; word++)
+  {
+    // NOTE: assumes LE
+    u32 word_data;
+    std::memcpy(&word_data, &words_ptr[word * sizeof(u32)], sizeof(word_data));
+    out[word] = static_cast<s32>((word_data >> field_shift) << 28) >> sample_shift;
+  }
+#endif
+}
+
 template<bool IS_STEREO, bool IS_8BIT>
 static void DecodeXA_ADPCMChunk(const u8* chunk_ptr, s16* samples, s32* last_samples)
 {
   // The data layout is annoying here. Each word of data is interleaved with the other blocks, requiring multiple
   // passes to decode the whole chunk.
   constexpr u32 NUM_BLOCKS = IS_8BIT ? 4 : 8;
-  constexpr u32 WORDS_PER_BLOCK = 28;
 
   const u8* headers_ptr = chunk_ptr + 4;
   const u8* words_ptr = chunk_ptr + 16;
@@ -29,31 +81,30 @@ static void DecodeXA_ADPCMChunk(const u8* chunk_ptr, s16* samples, s32* last_sam
     const s32 filter_pos = s_xa_adpcm_filter_table_pos[filter];
     const s32 filter_neg = s_xa_adpcm_filter_table_neg[filter];
 
+    alignas(16) std::array<s32, WORDS_PER_BLOCK> block_samples;
+    UnpackXA_ADPCMBlock<IS_8BIT>(words_ptr, block, shift, block_samples.data());
+
     s16* out_samples_ptr =
       IS_STEREO ? &samples[(block / 2) * (WORDS_PER_BLOCK * 2) + (block % 2)] : &samples[block * WORDS_PER_BLOCK];
     constexpr u32 out_samples_increment = IS_STEREO ? 2 : 1;
 
-    for (u32 word = 0; word < 28; word++)
+    // the filter depends on the previous output, so it's serial, but keep the history in registers
+    s32* prev = IS_STEREO ? &last_samples[(block & 1) * 2] : last_samples;
+    s32 prev0 = prev[0];
+    s32 prev1 = prev[1];
+    for (u32 word = 0; word < WORDS_PER_BLOCK; word++)
     {
-      // NOTE: assumes LE
-      u32 word_data;
-      std::memcpy(&word_data, &words_ptr[word * sizeof(u32)], sizeof(word_data));
-
-      // extract nibble from block
-      const u32 nibble = IS_8BIT ? ((word_data >> (block * 8)) & 0xFF) : ((word_data >> (block * 4)) & 0x0F);
-      const s16 sample = static_cast<s16>(Truncate16(nibble << 12)) >> shift;
-
       // mix in previous values
-      s32* prev = IS_STEREO ? &last_samples[(block & 1) * 2] : last_samples;
-      const s32 interp_sample = s32(sample) + ((prev[0] * filter_pos) + (prev[1] * filter_neg) + 32) / 64;
-
-      // update previous values
-      prev[1] = prev[0];
-      prev[0] = interp_sample;
+      const s32 interp_sample = block_samples[word] + ((prev0 * filter_pos) + (prev1 * filter_neg) + 32) / 64;
+      prev1 = prev0;
+      prev0 = interp_sample;
 
       *out_samples_ptr = static_cast<s16>(std::clamp<s32>(interp_sample, -0x8000, 0x7FFF));
       out_samples_ptr += out_samples_increment;
     }
+
+    prev[0] = prev0;
+    prev[1] = prev1;
   }
 }
 
@@ -73,6 +124,112 @@ static void DecodeXA_ADPCMChunks(const u8* chunk_ptr, s16* samples, s32* last_sa
   }
 }
 
+static constexpr u32 ZIGZAG_TABLE_SIZE = 29;
+
+static constexpr std::array<std::array<s16, ZIGZAG_TABLE_SIZE>, XA_RESAMPLE_OUTPUTS_PER_WINDOW> s_zigzag_table = {
+  {{0,      0x0,     0x0,     0x0,    0x0,     -0x0002, 0x000A,  -0x0022, 0x0041, -0x0054,
+    0x0034, 0x0009,  -0x010A, 0x0400, -0x0A78, 0x234C,  0x6794,  -0x1780, 0x0BCD, -0x0623,
+    0x0350, -0x016D, 0x006B,  0x000A, -0x0010, 0x0011,  -0x0008, 0x0003,  -0x0001},
+   {0,       0x0,    0x0,     -0x0002, 0x0,    0x0003,  -0x0013, 0x003C,  -0x004B, 0x00A2,
+    -0x00E3, 0x0132, -0x0043, -0x0267, 0x0C9D, 0x74BB,  -0x11B4, 0x09B8,  -0x05BF, 0x0372,
+    -0x01A8, 0x00A6, -0x001B, 0x0005,  0x0006, -0x0008, 0x0003,  -0x0001, 0x0},
+   {0,      0x0,     -0x0001, 0x0003,  -0x0002, -0x0005, 0x001F,  -0x004A, 0x00B3, -0x0192,
+    0x02B1, -0x039E, 0x04F8,  -0x05A6, 0x7939,  -0x05A6, 0x04F8,  -0x039E, 0x02B1, -0x0192,
+    0x00B3, -0x004A, 0x001F,  -0x0005, -0x0002, 0x0003,  -0x0001, 0x0,     0x0},
+   {0,       -0x0001, 0x0003,  -0x0008, 0x0006, 0x0005,  -0x001B, 0x00A6, -0x01A8, 0x0372,
+    -0x05BF, 0x09B8,  -0x11B4, 0x74BB,  0x0C9D, -0x0267, -0x0043, 0x0132, -0x00E3, 0x00A2,
+    -0x004B, 0x003C,  -0x0013, 0x0003,  0x0,    -0x0002, 0x0,     0x0,    0x0},
+   {-0x0001, 0x0003,  -0x0008, 0x0011,  -0x0010, 0x000A, 0x006B,  -0x016D, 0x0350, -0x0623,
+    0x0BCD,  -0x1780, 0x6794,  0x234C,  -0x0A78, 0x0400, -0x010A, 0x0009,  0x0034, -0x0054,
+    0x0041,  -0x0022, 0x000A,  -0x0001, 0x0,     0x0001, 0x0,     0x0,     0x0},
+   {0x0002,  -0x0008, 0x0010,  -0x0023, 0x002B, 0x001A,  -0x00EB, 0x027B,  -0x0548, 0x0AFA,
+    -0x16FA, 0x53E0,  0x3C07,  -0x1249, 0x080E, -0x0347, 0x015B,  -0x0044, -0x0017, 0x0046,
+    -0x0023, 0x0011,  -0x0005, 0x0,     0x0,    0x0,     0x0,     0x0,     0x0},
+   {-0x0005, 0x0011,  -0x0023, 0x0046, -0x0017, -0x0044, 0x015B,  -0x0347, 0x080E, -0x1249,
+    0x3C07,  0x53E0,  -0x16FA, 0x0AFA, -0x0548, 0x027B,  -0x00EB, 0x001A,  0x002B, -0x0023,
+    0x0010,  -0x0008, 0x0002,  0x0,    0x0,     0x0,     0x0,     0x0,     0x0}}};
+
+// The tables rearranged and padded out to the size of the ring buffer, so that they line up with the ring buffer
+// unwrapped into a straight line starting at p. Tap i applies to ringbuf[(p - i) & 0x1F].
+static constexpr auto s_zigzag_table_linear = []() {
+  std::array<std::array<s16, XA_RESAMPLE_RING_BUFFER_SIZE>, XA_RESAMPLE_OUTPUTS_PER_WINDOW> ret = {};
+  for (u32 i = 0; i < XA_RESAMPLE_OUTPUTS_PER_WINDOW; i++)
+  {
+    for (u32 j = 0; j < ZIGZAG_TABLE_SIZE; j++)
+      ret[i][(XA_RESAMPLE_RING_BUFFER_SIZE - j) % XA_RESAMPLE_RING_BUFFER_SIZE] = s_zigzag_table[i][j];
+  }
+  return ret;
+}();
+
+static void UnwrapRingBuffer(const s16* ringbuf, u8 p, s16* linear)
+{
+  const u32 first_part = XA_RESAMPLE_RING_BUFFER_SIZE - p;
+  std::memcpy(linear, ringbuf + p, first_part * sizeof(s16));
+  std::memcpy(linear + first_part, ringbuf, p * sizeof(s16));
+}
+
+static s16 ZigZagInterpolateTable(const s16* linear, const s16* table)
+{
+  // Each product is divided separately, truncating towards zero, before summing.
+  static_assert(XA_RESAMPLE_RING_BUFFER_SIZE % 8 == 0);
+  s32 sum = 0;
+
+#if defined(CPU_X64)
+  __m128i vsum = _mm_setzero_si128();
+  for (u32 i = 0; i < XA_RESAMPLE_RING_BUFFER_SIZE; i += 8)
+  {
+    const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&linear[i]));
+    const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&table[i]));
+    const __m128i lo = _mm_mullo_epi16(a, b);
+    const __m128i hi = _mm_mulhi_epi16(a, b);
+    const __m128i prod_lo = _mm_unpacklo_epi16(lo, hi);
+    const __m128i prod_hi = _mm_unpackhi_epi16(lo, hi);
+
+    // adding 0x7FFF to negative products makes the shift round towards zero
+    const __m128i round_lo = _mm_srli_epi32(_mm_srai_epi32(prod_lo, 31), 17);
+    const __m128i round_hi = _mm_srli_epi32(_mm_srai_epi32(prod_hi, 31), 17);
+    vsum = _mm_add_epi32(vsum, _mm_srai_epi32(_mm_add_epi32(prod_lo, round_lo), 15));
+    vsum = _mm_add_epi32(vsum, _mm_srai_epi32(_mm_add_epi32(prod_hi, round_hi), 15));
+  }
+  vsum = _mm_add_epi32(vsum, _mm_shuffle_epi32(vsum, _MM_SHUFFLE(1, 0, 3, 2)));
+  vsum = _mm_add_epi32(vsum, _mm_shuffle_epi32(vsum, _MM_SHUFFLE(2, 3, 0, 1)));
+  sum = _mm_cvtsi128_si32(vsum);
+#elif defined(CPU_AARCH64)
+  int32x4_t vsum = vdupq_n_s32(0);
+  for (u32 i = 0; i < XA_RESAMPLE_RING_BUFFER_SIZE; i += 8)
+  {
+    const int16x8_t a = vld1q_s16(&linear[i]);
+    const int16x8_t b = vld1q_s16(&table[i]);
+    const int32x4_t prod_lo = vmull_s16(vget_low_s16(a), vget_low_s16(b));
+    const int32x4_t prod_hi = vmull_high_s16(a, b);
+
+    // adding 0x7FFF to negative products makes the shift round towards zero
+    const int32x4_t round_lo =
+      vreinterpretq_s32_u32(vshrq_n_u32(vreinterpretq_u32_s32(vshrq_n_s32(prod_lo, 31)), 17));
+    const int32x4_t round_hi =
+      vreinterpretq_s32_u32(vshrq_n_u32(vreinterpretq_u32_s32(vshrq_n_s32(prod_hi, 31)), 17));
+    vsum = vaddq_s32(vsum, vshrq_n_s32(vaddq_s32(prod_lo, round_lo), 15));
+    vsum = vaddq_s32(vsum, vshrq_n_s32(vaddq_s32(prod_hi, round_hi), 15));
+  }
+  sum = vaddvq_s32(vsum);
+#else
+  for (u32 i = 0; i < XA_RESAMPLE_RING_BUFFER_SIZE; i++)
+    sum += (s32(linear[i]) * s32(table[i])) / 0x8000;
+#endif
+
+  return static_cast<s16>(std::clamp<s32>(sum, -0x8000, 0x7FFF));
+}
+
+void ZigZagInterpolate(const s16* ringbuf, u8 p, s16* out)
+{
+  // all seven outputs use the same window, so only unwrap it once
+  alignas(16) std::array<s16, XA_RESAMPLE_RING_BUFFER_SIZE> linear;
+  UnwrapRingBuffer(ringbuf, p, linear.data());
+
+  for (u32 i = 0; i < XA_RESAMPLE_OUTPUTS_PER_WINDOW; i++)
+    out[i] = ZigZagInterpolateTable(linear.data(), s_zigzag_table_linear[i].data());
+}
+
 void DecodeADPCMSector(const void* data, s16* samples, s32* last_samples)
 {
   const XASubHeader* subheader = reinterpret_cast<const XASubHeader*>(
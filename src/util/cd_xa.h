@@ -10,7 +10,9 @@ enum
 {
   XA_SUBHEADER_SIZE = 4,
   XA_ADPCM_SAMPLES_PER_SECTOR_4BIT = 4032, // 28 words * 8 nibbles per word * 18 chunks
-  XA_ADPCM_SAMPLES_PER_SECTOR_8BIT = 2016  // 28 words * 4 bytes per word * 18 chunks
+  XA_ADPCM_SAMPLES_PER_SECTOR_8BIT = 2016, // 28 words * 4 bytes per word * 18 chunks
+  XA_RESAMPLE_RING_BUFFER_SIZE = 32,
+  XA_RESAMPLE_OUTPUTS_PER_WINDOW = 7
 };
 
 struct XASubHeader
@@ -70,4 +72,8 @@ static_assert(sizeof(XA_ADPCMBlockHeader) == 1, "XA-ADPCM block header is one by
 // Decodes XA-ADPCM samples in an audio sector. Stereo samples are interleaved with left first.
 void DecodeADPCMSector(const void* data, s16* samples, s32* last_samples);
 
+// Resamples to 44.1KHz: computes the next seven output samples from a ring buffer of the last 32 input samples, where
+// p is the position of the oldest one.
+void ZigZagInterpolate(const s16* ringbuf, u8 p, s16* out);
+
 } // namespace CDXA
\ No newline at end of file
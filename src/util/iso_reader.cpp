@@ -5,20 +5,53 @@
 #include "cd_image.h"
 #include "common/log.h"
 #include <cctype>
+#include <cstring>
 Log_SetChannel(ISOReader);
 
-static bool FilenamesEqual(const char* a, const char* b, u32 length)
+static bool FilenamesEqual(const char* a, const std::string_view& b)
 {
-  u32 pos = 0;
-  for (; pos < length && *a != '\0' && *b != '\0'; pos++)
+  for (const char ch : b)
   {
-    if (std::tolower(*(a++)) != std::tolower(*(b++)))
+    if (std::tolower(*(a++)) != std::tolower(ch))
       return false;
   }
 
   return true;
 }
 
+/// Calls the callback for each entry in a directory, skipping the current/parent entries.
+/// Stops early if the callback returns false.
+template<typename T>
+static void ForEachDirectoryEntry(const std::vector<u8>& data, const T& callback)
+{
+  for (size_t sector_start = 0; sector_start < data.size(); sector_start += ISOReader::SECTOR_SIZE)
+  {
+    const u8* sector_buffer = &data[sector_start];
+    u32 sector_offset = 0;
+    while ((sector_offset + sizeof(ISOReader::ISODirectoryEntry)) < ISOReader::SECTOR_SIZE)
+    {
+      const ISOReader::ISODirectoryEntry* de =
+        reinterpret_cast<const ISOReader::ISODirectoryEntry*>(&sector_buffer[sector_offset]);
+      const char* de_filename =
+        reinterpret_cast<const char*>(&sector_buffer[sector_offset + sizeof(ISOReader::ISODirectoryEntry)]);
+      if ((sector_offset + de->entry_length) > ISOReader::SECTOR_SIZE || de->filename_length > de->entry_length ||
+          de->entry_length < sizeof(ISOReader::ISODirectoryEntry))
+      {
+        break;
+      }
+
+      sector_offset += de->entry_length;
+
+      // skip current/parent directory
+      if (de->filename_length == 1 && (*de_filename == '\x0' || *de_filename == '\x1'))
+        continue;
+
+      if (!callback(de, de_filename))
+        return;
+    }
+  }
+}
+
 ISOReader::ISOReader() = default;
 
 ISOReader::~ISOReader() = default;
@@ -27,9 +60,15 @@ bool ISOReader::Open(CDImage* image, u32 track_number)
 {
   m_image = image;
   m_track_number = track_number;
+  m_path_table.clear();
+  m_directory_cache.clear();
   if (!ReadPVD())
     return false;
 
+  // not fatal, lookups just walk the directories instead
+  if (!ReadPathTable())
+    m_path_table.clear();
+
   return true;
 }
 
@@ -39,139 +78,245 @@ bool ISOReader::ReadPVD()
   if (!m_image->Seek(m_track_number, 16))
     return false;
 
-  // try only a maximum of 256 volume descriptors
-  for (u32 i = 0; i < 256; i++)
+  // try only a maximum of 256 volume descriptors, the PVD is almost always the first, so read a few at a time
+  u8 buffer[VOLUME_DESCRIPTOR_BATCH_SIZE][SECTOR_SIZE];
+  for (u32 i = 0; i < 256;)
   {
-    u8 buffer[SECTOR_SIZE];
-    if (m_image->Read(CDImage::ReadMode::DataOnly, 1, buffer) != 1)
+    const u32 sectors_read = m_image->Read(CDImage::ReadMode::DataOnly, VOLUME_DESCRIPTOR_BATCH_SIZE, buffer);
+    if (sectors_read == 0)
       return false;
 
-    const ISOVolumeDescriptorHeader* header = reinterpret_cast<ISOVolumeDescriptorHeader*>(buffer);
-    if (header->type_code != 1)
-      continue;
-    else if (header->type_code == 255)
-      break;
+    for (u32 j = 0; j < sectors_read; j++, i++)
+    {
+      const ISOVolumeDescriptorHeader* header = reinterpret_cast<ISOVolumeDescriptorHeader*>(buffer[j]);
+      if (header->type_code == 255)
+      {
+        Log_ErrorPrint("PVD not found");
+        return false;
+      }
+      else if (header->type_code != 1)
+        continue;
 
-    std::memcpy(&m_pvd, buffer, sizeof(ISOPrimaryVolumeDescriptor));
-    Log_DebugPrintf("PVD found at index %u", i);
-    return true;
+      std::memcpy(&m_pvd, buffer[j], sizeof(ISOPrimaryVolumeDescriptor));
+      Log_DebugPrintf("PVD found at index %u", i);
+      return true;
+    }
+
+    if (sectors_read < VOLUME_DESCRIPTOR_BATCH_SIZE)
+      break;
   }
 
   Log_ErrorPrint("PVD not found");
   return false;
 }
 
-std::optional<ISOReader::ISODirectoryEntry> ISOReader::LocateFile(const char* path)
+bool ISOReader::ReadPathTable()
 {
-  u8 sector_buffer[SECTOR_SIZE];
+  const u32 size = m_pvd.path_table_size_le;
+  if (size == 0 || size > MAX_PATH_TABLE_SIZE)
+  {
+    Log_DevPrintf("Invalid path table size %u", size);
+    return false;
+  }
 
-  const ISODirectoryEntry* root_de = reinterpret_cast<const ISODirectoryEntry*>(m_pvd.root_directory_entry);
-  if (*path == '\0' || std::strcmp(path, "/") == 0)
+  const u32 num_sectors = (size + (SECTOR_SIZE - 1)) / SECTOR_SIZE;
+  std::vector<u8> data(num_sectors * SECTOR_SIZE);
+  if (!m_image->Seek(m_track_number, m_pvd.path_table_location_le) ||
+      m_image->Read(CDImage::ReadMode::DataOnly, num_sectors, data.data()) != num_sectors)
   {
-    // locating the root directory
-    return *root_de;
+    Log_DevPrintf("Failed to read path table at LBA %u", m_pvd.path_table_location_le);
+    return false;
   }
 
-  // start at the root directory
-  return LocateFile(path, sector_buffer, root_de->location_le, root_de->length_le);
+  u32 offset = 0;
+  while ((offset + sizeof(ISOPathTableEntry)) <= size)
+  {
+    ISOPathTableEntry pte;
+    std::memcpy(&pte, &data[offset], sizeof(pte));
+    if (pte.name_length == 0 || (offset + sizeof(pte) + pte.name_length) > size ||
+        pte.parent_directory_number == 0 || pte.parent_directory_number > (m_path_table.size() + 1))
+    {
+      Log_DevPrintf("Invalid path table entry at offset %u", offset);
+      return false;
+    }
+
+    PathTableDirectory& dir = m_path_table.emplace_back();
+    dir.name.assign(reinterpret_cast<const char*>(&data[offset + sizeof(pte)]), pte.name_length);
+    dir.location = pte.location_le;
+    dir.parent_directory_number = pte.parent_directory_number;
+
+    // names are padded to an even length
+    offset += static_cast<u32>(sizeof(pte)) + pte.name_length + (pte.name_length & 1u);
+  }
+
+  Log_DevPrintf("%zu directories in path table", m_path_table.size());
+  return !m_path_table.empty();
 }
 
-std::optional<ISOReader::ISODirectoryEntry> ISOReader::LocateFile(const char* path, u8* sector_buffer,
-                                                                  u32 directory_record_lba, u32 directory_record_size)
+u16 ISOReader::FindPathTableDirectory(u16 parent_directory_number, const std::string_view& name) const
 {
-  if (directory_record_size == 0)
+  // the root is its own parent, so skip it
+  for (size_t i = 1; i < m_path_table.size(); i++)
   {
-    Log_ErrorPrintf("Directory entry record size 0 while looking for '%s'", path);
-    return std::nullopt;
+    const PathTableDirectory& dir = m_path_table[i];
+    if (dir.parent_directory_number == parent_directory_number && dir.name.length() == name.length() &&
+        FilenamesEqual(dir.name.c_str(), name))
+    {
+      return static_cast<u16>(i + 1);
+    }
   }
 
-  // strip any leading slashes
-  const char* path_component_start = path;
-  while (*path_component_start == '/' || *path_component_start == '\\')
-    path_component_start++;
+  return 0;
+}
 
-  u32 path_component_length = 0;
-  const char* path_component_end = path_component_start;
-  while (*path_component_end != '\0' && *path_component_end != '/' && *path_component_end != '\\')
-  {
-    path_component_length++;
-    path_component_end++;
-  }
+const std::vector<u8>* ISOReader::ReadDirectory(u32 directory_record_lba, u32 directory_record_size)
+{
+  auto iter = m_directory_cache.find(directory_record_lba);
+  if (iter != m_directory_cache.end())
+    return &iter->second;
 
-  // start reading directory entries
-  const u32 num_sectors = (directory_record_size + (SECTOR_SIZE - 1)) / SECTOR_SIZE;
   if (!m_image->Seek(m_track_number, directory_record_lba))
   {
     Log_ErrorPrintf("Seek to LBA %u failed", directory_record_lba);
-    return std::nullopt;
+    return nullptr;
   }
 
-  for (u32 i = 0; i < num_sectors; i++)
+  std::vector<u8> data;
+  if (directory_record_size == 0)
   {
-    if (m_image->Read(CDImage::ReadMode::DataOnly, 1, sector_buffer) != 1)
+    // directories found through the path table don't have a size, so get it from the "." entry
+    data.resize(SECTOR_SIZE);
+    if (m_image->Read(CDImage::ReadMode::DataOnly, 1, data.data()) != 1)
     {
-      Log_ErrorPrintf("Failed to read LBA %u", directory_record_lba + i);
-      return std::nullopt;
+      Log_ErrorPrintf("Failed to read LBA %u", directory_record_lba);
+      return nullptr;
     }
 
-    u32 sector_offset = 0;
-    while ((sector_offset + sizeof(ISODirectoryEntry)) < SECTOR_SIZE)
+    ISODirectoryEntry de;
+    std::memcpy(&de, data.data(), sizeof(de));
+    directory_record_size = de.length_le;
+  }
+
+  if (directory_record_size == 0 || directory_record_size > MAX_DIRECTORY_SIZE)
+  {
+    Log_ErrorPrintf("Invalid directory record size %u at LBA %u", directory_record_size, directory_record_lba);
+    return nullptr;
+  }
+
+  const u32 num_sectors = (directory_record_size + (SECTOR_SIZE - 1)) / SECTOR_SIZE;
+  const u32 sectors_present = static_cast<u32>(data.size() / SECTOR_SIZE);
+  if (num_sectors > sectors_present)
+  {
+    data.resize(num_sectors * SECTOR_SIZE);
+    const u32 sectors_to_read = num_sectors - sectors_present;
+    if (m_image->Read(CDImage::ReadMode::DataOnly, sectors_to_read, &data[sectors_present * SECTOR_SIZE]) !=
+        sectors_to_read)
     {
-      const ISODirectoryEntry* de = reinterpret_cast<const ISODirectoryEntry*>(&sector_buffer[sector_offset]);
-      const char* de_filename =
-        reinterpret_cast<const char*>(&sector_buffer[sector_offset + sizeof(ISODirectoryEntry)]);
-      if ((sector_offset + de->entry_length) > SECTOR_SIZE || de->filename_length > de->entry_length ||
-          de->entry_length < sizeof(ISODirectoryEntry))
-      {
-        break;
-      }
+      Log_ErrorPrintf("Failed to read directory at LBA %u", directory_record_lba);
+      return nullptr;
+    }
+  }
 
-      sector_offset += de->entry_length;
+  return &m_directory_cache.emplace(directory_record_lba, std::move(data)).first->second;
+}
 
-      // skip current/parent directory
-      if (de->filename_length == 1 && (*de_filename == '\x0' || *de_filename == '\x1'))
+std::optional<ISOReader::ISODirectoryEntry> ISOReader::LocateFile(const char* path)
+{
+  const ISODirectoryEntry* root_de = reinterpret_cast<const ISODirectoryEntry*>(m_pvd.root_directory_entry);
+  if (*path == '\0' || std::strcmp(path, "/") == 0)
+  {
+    // locating the root directory
+    return *root_de;
+  }
+
+  // start at the root directory
+  u32 directory_record_lba = root_de->location_le;
+  u32 directory_record_size = root_de->length_le;
+  u16 directory_number = m_path_table.empty() ? 0 : 1;
+
+  const char* path_component_start = path;
+  for (;;)
+  {
+    // strip any leading slashes
+    while (*path_component_start == '/' || *path_component_start == '\\')
+      path_component_start++;
+
+    const char* path_component_end = path_component_start;
+    while (*path_component_end != '\0' && *path_component_end != '/' && *path_component_end != '\\')
+      path_component_end++;
+
+    const std::string_view path_component(path_component_start,
+                                          static_cast<size_t>(path_component_end - path_component_start));
+    const bool is_last_component = (*path_component_end == '\0');
+
+    // intermediate directories can be resolved from the path table, without reading the parent
+    if (!is_last_component && directory_number != 0)
+    {
+      const u16 child_directory_number = FindPathTableDirectory(directory_number, path_component);
+      if (child_directory_number != 0)
+      {
+        directory_record_lba = m_path_table[child_directory_number - 1].location;
+        directory_record_size = 0;
+        directory_number = child_directory_number;
+        path_component_start = path_component_end;
         continue;
+      }
+    }
+
+    const std::vector<u8>* directory = ReadDirectory(directory_record_lba, directory_record_size);
+    if (!directory)
+      return std::nullopt;
 
+    std::optional<ISODirectoryEntry> found;
+    ForEachDirectoryEntry(*directory, [&path_component, &found](const ISODirectoryEntry* de, const char* de_filename) {
       // check filename length
-      if (de->filename_length < path_component_length)
-        continue;
+      if (de->filename_length < path_component.length())
+        return true;
 
       if (de->flags & ISODirectoryEntryFlag_Directory)
       {
         // directories don't have the version? so check the length instead
-        if (de->filename_length != path_component_length ||
-            !FilenamesEqual(de_filename, path_component_start, path_component_length))
-        {
-          continue;
-        }
+        if (de->filename_length != path_component.length() || !FilenamesEqual(de_filename, path_component))
+          return true;
       }
       else
       {
         // compare filename
-        if (!FilenamesEqual(de_filename, path_component_start, path_component_length) ||
-            de_filename[path_component_length] != ';')
+        if (de->filename_length == path_component.length() || !FilenamesEqual(de_filename, path_component) ||
+            de_filename[path_component.length()] != ';')
         {
-          continue;
+          return true;
         }
       }
 
-      // found it. is this the file we're looking for?
-      if (*path_component_end == '\0')
-        return *de;
+      found = *de;
+      return false;
+    });
 
-      // if it is a directory, recurse into it
-      if (de->flags & ISODirectoryEntryFlag_Directory)
-        return LocateFile(path_component_end, sector_buffer, de->location_le, de->length_le);
+    if (!found.has_value())
+    {
+      std::string temp(path_component);
+      Log_ErrorPrintf("Path component '%s' not found", temp.c_str());
+      return std::nullopt;
+    }
+
+    // found it. is this the file we're looking for?
+    if (is_last_component)
+      return found;
 
-      // we're looking for a directory but got a file
+    // we're looking for a directory but got a file
+    if (!(found->flags & ISODirectoryEntryFlag_Directory))
+    {
       Log_ErrorPrintf("Looking for directory but got file");
       return std::nullopt;
     }
-  }
 
-  std::string temp(path_component_start, path_component_length);
-  Log_ErrorPrintf("Path component '%s' not found", temp.c_str());
-  return std::nullopt;
+    // if it is a directory, continue into it, its number is unknown since it wasn't found through the path table
+    directory_record_lba = found->location_le;
+    directory_record_size = found->length_le;
+    directory_number = 0;
+    path_component_start = path_component_end;
+  }
 }
 
 std::vector<std::string> ISOReader::GetFilesInDirectory(const char* path)
@@ -208,56 +353,27 @@ std::vector<std::string> ISOReader::GetFilesInDirectory(const char* path)
       base_path += '/';
   }
 
-  // start reading directory entries
-  const u32 num_sectors = (directory_record_length + (SECTOR_SIZE - 1)) / SECTOR_SIZE;
-  if (!m_image->Seek(m_track_number, directory_record_lba))
-  {
-    Log_ErrorPrintf("Seek to LBA %u failed", directory_record_lba);
+  const std::vector<u8>* directory = ReadDirectory(directory_record_lba, directory_record_length);
+  if (!directory)
     return {};
-  }
 
   std::vector<std::string> files;
-  u8 sector_buffer[SECTOR_SIZE];
-  for (u32 i = 0; i < num_sectors; i++)
-  {
-    if (m_image->Read(CDImage::ReadMode::DataOnly, 1, sector_buffer) != 1)
+  ForEachDirectoryEntry(*directory, [&base_path, &files](const ISODirectoryEntry* de, const char* de_filename) {
+    // strip off terminator/file version
+    std::string filename(de_filename, de->filename_length);
+    std::string::size_type pos = filename.rfind(';');
+    if (pos == std::string::npos)
     {
-      Log_ErrorPrintf("Failed to read LBA %u", directory_record_lba + i);
-      break;
+      Log_ErrorPrintf("Invalid filename '%s'", filename.c_str());
+      return true;
     }
+    filename.erase(pos);
 
-    u32 sector_offset = 0;
-    while ((sector_offset + sizeof(ISODirectoryEntry)) < SECTOR_SIZE)
-    {
-      const ISODirectoryEntry* de = reinterpret_cast<const ISODirectoryEntry*>(&sector_buffer[sector_offset]);
-      const char* de_filename =
-        reinterpret_cast<const char*>(&sector_buffer[sector_offset + sizeof(ISODirectoryEntry)]);
-      if ((sector_offset + de->entry_length) > SECTOR_SIZE || de->filename_length > de->entry_length ||
-          de->entry_length < sizeof(ISODirectoryEntry))
-      {
-        break;
-      }
-
-      sector_offset += de->entry_length;
-
-      // skip current/parent directory
-      if (de->filename_length == 1 && (*de_filename == '\x0' || *de_filename == '\x1'))
-        continue;
-
-      // strip off terminator/file version
-      std::string filename(de_filename, de->filename_length);
-      std::string::size_type pos = filename.rfind(';');
-      if (pos == std::string::npos)
-      {
-        Log_ErrorPrintf("Invalid filename '%s'", filename.c_str());
-        continue;
-      }
-      filename.erase(pos);
+    if (!filename.empty())
+      files.push_back(base_path + filename);
 
-      if (!filename.empty())
-        files.push_back(base_path + filename);
-    }
-  }
+    return true;
+  });
 
   return files;
 }
@@ -6,6 +6,8 @@
 #include <memory>
 #include <optional>
 #include <string>
+#include <string_view>
+#include <unordered_map>
 #include <vector>
 
 class CDImage;
@@ -15,7 +17,14 @@ class ISOReader
 public:
   enum : u32
   {
-    SECTOR_SIZE = 2048
+    SECTOR_SIZE = 2048,
+
+    /// Number of volume descriptors read at once when looking for the PVD.
+    VOLUME_DESCRIPTOR_BATCH_SIZE = 4,
+
+    /// Upper bound on path table and directory sizes, anything bigger is treated as corrupted.
+    MAX_PATH_TABLE_SIZE = 1024 * 1024,
+    MAX_DIRECTORY_SIZE = 1024 * 1024,
   };
 
 #pragma pack(push, 1)
@@ -129,6 +138,15 @@ public:
     u8 filename_length;
   };
 
+  struct ISOPathTableEntry
+  {
+    u8 name_length;
+    u8 extended_attribute_length;
+    u32 location_le;
+    u16 parent_directory_number;
+  };
+  static_assert(sizeof(ISOPathTableEntry) == 8);
+
 #pragma pack(pop)
 
   ISOReader();
@@ -145,14 +163,33 @@ public:
   bool ReadFile(const char* path, std::vector<u8>* data);
 
 private:
+  struct PathTableDirectory
+  {
+    std::string name;
+    u32 location;
+    u16 parent_directory_number;
+  };
+
   bool ReadPVD();
+  bool ReadPathTable();
+
+  /// Returns the directory number of the named child of the specified directory, or 0 if it's not in the path table.
+  u16 FindPathTableDirectory(u16 parent_directory_number, const std::string_view& name) const;
+
+  /// Returns the contents of the directory at the specified LBA, reading it from the disc if it's not cached yet.
+  /// If the size is zero, it is taken from the directory's own "." entry.
+  const std::vector<u8>* ReadDirectory(u32 directory_record_lba, u32 directory_record_size);
 
   std::optional<ISODirectoryEntry> LocateFile(const char* path);
-  std::optional<ISODirectoryEntry> LocateFile(const char* path, u8* sector_buffer, u32 directory_record_lba,
-                                              u32 directory_record_size);
 
   CDImage* m_image;
   u32 m_track_number;
 
   ISOPrimaryVolumeDescriptor m_pvd = {};
+
+  // Directories from the path table, in directory number order (the root is number 1).
+  std::vector<PathTableDirectory> m_path_table;
+
+  // Directory contents read so far, keyed by LBA, so looking up several files only reads each directory once.
+  std::unordered_map<u32, std::vector<u8>> m_directory_cache;
 };
\ No newline at end of file
@@ -6,6 +6,7 @@
 #include "common/assert.h"
 #include "common/log.h"
 #include "common/platform.h"
+#include "memory_arena.h"
 #include <algorithm>
 Log_SetChannel(JitCodeBuffer);
 
@@ -21,6 +22,38 @@ Log_SetChannel(JitCodeBuffer);
 #include <pthread.h>
 #endif
 
+#ifndef _WIN32
+static void RequestTransparentHugePages(void* ptr, u32 size)
+{
+  if (Common::MemoryArena::AdviseHugePages(ptr, size))
+  {
+    Log_InfoPrintf("Code buffer is using transparent huge pages (mode: %s)",
+                   Common::MemoryArena::GetTransparentHugePageMode(false).c_str());
+  }
+  else
+  {
+    Log_WarningPrint("Huge pages are not available for the code buffer, using regular pages");
+  }
+}
+#else
+static bool EnableLockMemoryPrivilege()
+{
+  // Large pages require SeLockMemoryPrivilege, which has to be granted to the user and enabled for the process.
+  HANDLE token;
+  if (!OpenProcessToken(GetCurrentProcess(), TOKEN_ADJUST_PRIVILEGES | TOKEN_QUERY, &token))
+    return false;
+
+  TOKEN_PRIVILEGES tp = {};
+  tp.PrivilegeCount = 1;
+  tp.Privileges[0].Attributes = SE_PRIVILEGE_ENABLED;
+  const bool result = (LookupPrivilegeValueW(nullptr, SE_LOCK_MEMORY_NAME, &tp.Privileges[0].Luid) &&
+                       AdjustTokenPrivileges(token, FALSE, &tp, 0, nullptr, nullptr) &&
+                       GetLastError() == ERROR_SUCCESS);
+  CloseHandle(token);
+  return result;
+}
+#endif
+
 JitCodeBuffer::JitCodeBuffer() = default;
 
 JitCodeBuffer::JitCodeBuffer(u32 size, u32 far_code_size)
@@ -40,14 +73,31 @@ JitCodeBuffer::~JitCodeBuffer()
   Destroy();
 }
 
-bool JitCodeBuffer::Allocate(u32 size /* = 64 * 1024 * 1024 */, u32 far_code_size /* = 0 */)
+bool JitCodeBuffer::Allocate(u32 size /* = 64 * 1024 * 1024 */, u32 far_code_size /* = 0 */,
+                             bool huge_pages /* = false */)
 {
   Destroy();
 
   m_total_size = size + far_code_size;
 
 #if defined(_WIN32)
-  m_code_ptr = static_cast<u8*>(VirtualAlloc(nullptr, m_total_size, MEM_COMMIT, PAGE_EXECUTE_READWRITE));
+  if (huge_pages)
+  {
+    const SIZE_T large_page_size = GetLargePageMinimum();
+    if (large_page_size > 0 && (m_total_size % large_page_size) == 0 && EnableLockMemoryPrivilege())
+    {
+      m_code_ptr = static_cast<u8*>(VirtualAlloc(nullptr, m_total_size, MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES,
+                                                 PAGE_EXECUTE_READWRITE));
+    }
+
+    if (m_code_ptr)
+      Log_InfoPrintf("Code buffer is using %zu byte large pages", static_cast<size_t>(large_page_size));
+    else
+      Log_WarningPrintf("Failed to allocate large pages for code buffer (%u), using regular pages", GetLastError());
+  }
+
+  if (!m_code_ptr)
+    m_code_ptr = static_cast<u8*>(VirtualAlloc(nullptr, m_total_size, MEM_COMMIT, PAGE_EXECUTE_READWRITE));
   if (!m_code_ptr)
   {
     Log_ErrorPrintf("VirtualAlloc(RWX, %u) for internal buffer failed: %u", m_total_size, GetLastError());
@@ -60,12 +110,34 @@ bool JitCodeBuffer::Allocate(u32 size /* = 64 * 1024 * 1024 */, u32 far_code_siz
   flags |= MAP_JIT;
 #endif
 
-  m_code_ptr = static_cast<u8*>(mmap(nullptr, m_total_size, PROT_READ | PROT_WRITE | PROT_EXEC, flags, -1, 0));
+#if defined(__linux__) && defined(MAP_HUGETLB)
+  // Explicit huge pages only succeed if the user has reserved some, so this usually falls back to THP below.
+  if (huge_pages && Common::IsAlignedPow2(m_total_size, static_cast<unsigned>(Common::MemoryArena::HUGE_PAGE_SIZE)))
+  {
+    void* ptr = mmap(nullptr, m_total_size, PROT_READ | PROT_WRITE | PROT_EXEC, flags | MAP_HUGETLB, -1, 0);
+    if (ptr != MAP_FAILED)
+    {
+      m_code_ptr = static_cast<u8*>(ptr);
+      huge_pages = false;
+      Log_InfoPrint("Code buffer is using hugetlbfs pages");
+    }
+  }
+#endif
+
   if (!m_code_ptr)
   {
-    Log_ErrorPrintf("mmap(RWX, %u) for internal buffer failed: %d", m_total_size, errno);
-    return false;
+    void* ptr = mmap(nullptr, m_total_size, PROT_READ | PROT_WRITE | PROT_EXEC, flags, -1, 0);
+    if (ptr == MAP_FAILED)
+    {
+      Log_ErrorPrintf("mmap(RWX, %u) for internal buffer failed: %d", m_total_size, errno);
+      return false;
+    }
+
+    m_code_ptr = static_cast<u8*>(ptr);
   }
+
+  if (huge_pages)
+    RequestTransparentHugePages(m_code_ptr, m_total_size);
 #else
   return false;
 #endif
@@ -73,18 +145,21 @@ bool JitCodeBuffer::Allocate(u32 size /* = 64 * 1024 * 1024 */, u32 far_code_siz
   m_free_code_ptr = m_code_ptr;
   m_code_size = size;
   m_code_used = 0;
+  m_code_limit = size;
 
   m_far_code_ptr = static_cast<u8*>(m_code_ptr) + size;
   m_free_far_code_ptr = m_far_code_ptr;
   m_far_code_size = far_code_size;
   m_far_code_used = 0;
+  m_far_code_limit = far_code_size;
 
   m_old_protection = 0;
   m_owns_buffer = true;
   return true;
 }
 
-bool JitCodeBuffer::Initialize(void* buffer, u32 size, u32 far_code_size /* = 0 */, u32 guard_size /* = 0 */)
+bool JitCodeBuffer::Initialize(void* buffer, u32 size, u32 far_code_size /* = 0 */, u32 guard_size /* = 0 */,
+                               bool huge_pages /* = false */)
 {
   Destroy();
 
@@ -111,6 +186,9 @@ bool JitCodeBuffer::Initialize(void* buffer, u32 size, u32 far_code_size /* = 0
     }
   }
 
+  if (huge_pages)
+    Log_WarningPrint("Large pages are not supported for external code buffers, using regular pages");
+
   m_code_ptr = static_cast<u8*>(buffer);
   m_old_protection = static_cast<u32>(old_protect);
 #elif defined(__linux__) || defined(__ANDROID__) || defined(__APPLE__) || defined(__HAIKU__) || defined(__FreeBSD__)
@@ -130,6 +208,9 @@ bool JitCodeBuffer::Initialize(void* buffer, u32 size, u32 far_code_size /* = 0
     }
   }
 
+  if (huge_pages)
+    RequestTransparentHugePages(buffer, size);
+
   // reasonable default?
   m_code_ptr = static_cast<u8*>(buffer);
   m_old_protection = PROT_READ | PROT_WRITE;
@@ -144,11 +225,13 @@ bool JitCodeBuffer::Initialize(void* buffer, u32 size, u32 far_code_size /* = 0
   m_free_code_ptr = m_code_ptr + guard_size;
   m_code_size = size - far_code_size - (guard_size * 2);
   m_code_used = 0;
+  m_code_limit = m_code_size;
 
   m_far_code_ptr = static_cast<u8*>(m_code_ptr) + m_code_size;
   m_free_far_code_ptr = m_far_code_ptr;
   m_far_code_size = far_code_size - guard_size;
   m_far_code_used = 0;
+  m_far_code_limit = m_far_code_size;
 
   m_guard_size = guard_size;
   m_owns_buffer = false;
@@ -184,10 +267,14 @@ void JitCodeBuffer::Destroy()
   m_code_size = 0;
   m_code_reserve_size = 0;
   m_code_used = 0;
+  m_code_limit = 0;
   m_far_code_ptr = nullptr;
   m_free_far_code_ptr = nullptr;
   m_far_code_size = 0;
   m_far_code_used = 0;
+  m_far_code_limit = 0;
+  m_region_count = 0;
+  m_current_region = 0;
   m_total_size = 0;
   m_guard_size = 0;
   m_old_protection = 0;
@@ -202,6 +289,7 @@ void JitCodeBuffer::ReserveCode(u32 size)
   m_code_reserve_size += size;
   m_free_code_ptr += size;
   m_code_size -= size;
+  m_code_limit = m_code_size;
 }
 
 void JitCodeBuffer::CommitCode(u32 length)
@@ -214,7 +302,7 @@ void JitCodeBuffer::CommitCode(u32 length)
   FlushInstructionCache(m_free_code_ptr, length);
 #endif
 
-  Assert(length <= (m_code_size - m_code_used));
+  Assert(length <= (m_code_limit - m_code_used));
   m_free_code_ptr += length;
   m_code_used += length;
 }
@@ -229,7 +317,7 @@ void JitCodeBuffer::CommitFarCode(u32 length)
   FlushInstructionCache(m_free_far_code_ptr, length);
 #endif
 
-  Assert(length <= (m_far_code_size - m_far_code_used));
+  Assert(length <= (m_far_code_limit - m_far_code_used));
   m_free_far_code_ptr += length;
   m_far_code_used += length;
 }
@@ -238,8 +326,12 @@ void JitCodeBuffer::Reset()
 {
   WriteProtect(false);
 
-  m_free_code_ptr = m_code_ptr + m_guard_size + m_code_reserve_size;
+  m_free_code_ptr = GetCodeBasePointer();
   m_code_used = 0;
+  m_code_limit = m_code_size;
+  m_far_code_limit = m_far_code_size;
+  m_region_count = 0;
+  m_current_region = 0;
   std::memset(m_free_code_ptr, 0, m_code_size);
   FlushInstructionCache(m_free_code_ptr, m_code_size);
 
@@ -254,6 +346,32 @@ void JitCodeBuffer::Reset()
   WriteProtect(true);
 }
 
+void JitCodeBuffer::InitializeRegions(u32 count)
+{
+  Assert(count > 0 && m_region_count == 0);
+
+  m_region_count = count;
+  m_region_code_start = m_code_used;
+  m_region_code_size = (m_code_size - m_code_used) / count;
+  m_region_far_code_start = m_far_code_used;
+  m_region_far_code_size = (m_far_code_size - m_far_code_used) / count;
+  SwitchToRegion(0);
+}
+
+void JitCodeBuffer::SwitchToRegion(u32 region)
+{
+  DebugAssert(region < m_region_count);
+  m_current_region = region;
+
+  m_code_used = m_region_code_start + (region * m_region_code_size);
+  m_code_limit = m_code_used + m_region_code_size;
+  m_free_code_ptr = GetCodeBasePointer() + m_code_used;
+
+  m_far_code_used = m_region_far_code_start + (region * m_region_far_code_size);
+  m_far_code_limit = m_far_code_used + m_region_far_code_size;
+  m_free_far_code_ptr = m_far_code_ptr + m_far_code_used;
+}
+
 void JitCodeBuffer::Align(u32 alignment, u8 padding_value)
 {
   DebugAssert(Common::IsPow2(alignment));
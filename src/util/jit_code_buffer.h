@@ -14,23 +14,45 @@ public:
 
   bool IsValid() const { return (m_code_ptr != nullptr); }
 
-  bool Allocate(u32 size = 64 * 1024 * 1024, u32 far_code_size = 0);
-  bool Initialize(void* buffer, u32 size, u32 far_code_size = 0, u32 guard_size = 0);
+  /// If huge_pages is set, the buffer is backed by huge/large pages when the host allows it, falling back to regular
+  /// pages otherwise. This reduces TLB misses when executing code spread across the buffer.
+  bool Allocate(u32 size = 64 * 1024 * 1024, u32 far_code_size = 0, bool huge_pages = false);
+  bool Initialize(void* buffer, u32 size, u32 far_code_size = 0, u32 guard_size = 0, bool huge_pages = false);
   void Destroy();
   void Reset();
 
   ALWAYS_INLINE u8* GetCodePointer() const { return m_code_ptr; }
   ALWAYS_INLINE u32 GetTotalSize() const { return m_total_size; }
 
+  /// Space for code not including far code, and how far into it code has been written.
+  ALWAYS_INLINE u32 GetCodeSize() const { return m_code_size; }
+  ALWAYS_INLINE u32 GetCodeUsed() const { return m_code_used; }
+
   ALWAYS_INLINE u8* GetFreeCodePointer() const { return m_free_code_ptr; }
-  ALWAYS_INLINE u32 GetFreeCodeSpace() const { return static_cast<u32>(m_code_size - m_code_used); }
+  ALWAYS_INLINE u32 GetFreeCodeSpace() const { return static_cast<u32>(m_code_limit - m_code_used); }
   void ReserveCode(u32 size);
   void CommitCode(u32 length);
 
   ALWAYS_INLINE u8* GetFreeFarCodePointer() const { return m_free_far_code_ptr; }
-  ALWAYS_INLINE u32 GetFreeFarCodeSpace() const { return static_cast<u32>(m_far_code_size - m_far_code_used); }
+  ALWAYS_INLINE u32 GetFreeFarCodeSpace() const { return static_cast<u32>(m_far_code_limit - m_far_code_used); }
   void CommitFarCode(u32 length);
 
+  /// Splits the remaining code space into regions, which are filled in order. Code before the first region (e.g.
+  /// dispatchers) is never reused. Once the current region is full, the owner can throw away the code in the next
+  /// region and switch to it, instead of resetting the whole buffer. Reset() removes the regions.
+  void InitializeRegions(u32 count);
+  void SwitchToRegion(u32 region);
+
+  ALWAYS_INLINE u32 GetRegionCount() const { return m_region_count; }
+  ALWAYS_INLINE u32 GetCurrentRegion() const { return m_current_region; }
+  ALWAYS_INLINE u32 GetNextRegion() const { return (m_current_region + 1) % m_region_count; }
+  ALWAYS_INLINE u32 GetRegionCodeSize() const { return m_region_code_size; }
+  ALWAYS_INLINE u32 GetRegionFarCodeSize() const { return m_region_far_code_size; }
+  ALWAYS_INLINE u8* GetRegionCodePointer(u32 region) const
+  {
+    return GetCodeBasePointer() + m_region_code_start + (region * m_region_code_size);
+  }
+
   /// Adjusts the free code pointer to the specified alignment, padding with bytes.
   /// Assumes alignment is a power-of-two.
   void Align(u32 alignment, u8 padding_value);
@@ -46,16 +68,27 @@ public:
 #endif
 
 private:
+  ALWAYS_INLINE u8* GetCodeBasePointer() const { return m_code_ptr + m_guard_size + m_code_reserve_size; }
+
   u8* m_code_ptr = nullptr;
   u8* m_free_code_ptr = nullptr;
   u32 m_code_size = 0;
   u32 m_code_reserve_size = 0;
   u32 m_code_used = 0;
+  u32 m_code_limit = 0;
 
   u8* m_far_code_ptr = nullptr;
   u8* m_free_far_code_ptr = nullptr;
   u32 m_far_code_size = 0;
   u32 m_far_code_used = 0;
+  u32 m_far_code_limit = 0;
+
+  u32 m_region_count = 0;
+  u32 m_current_region = 0;
+  u32 m_region_code_start = 0;
+  u32 m_region_code_size = 0;
+  u32 m_region_far_code_start = 0;
+  u32 m_region_far_code_size = 0;
 
   u32 m_total_size = 0;
   u32 m_guard_size = 0;
@@ -0,0 +1,200 @@
+// SPDX-FileCopyrightText: 2019-2022 Connor McLaughlin <stenzek@gmail.com>
+// SPDX-License-Identifier: (GPL-3.0 OR CC-BY-NC-ND-4.0)
+
+#include "mapped_file.h"
+#include "common/log.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <cwchar>
+#include <iterator>
+#include <limits>
+#include <utility>
+Log_SetChannel(MappedFile);
+
+#if defined(_WIN32)
+#include "common/windows_headers.h"
+#include <io.h>
+#elif defined(__linux__)
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/vfs.h>
+#include <unistd.h>
+#elif defined(__APPLE__) || defined(__FreeBSD__)
+#include <sys/mman.h>
+#include <sys/mount.h>
+#include <sys/param.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace Common {
+
+MappedFile::MappedFile() = default;
+
+MappedFile::MappedFile(MappedFile&& move)
+{
+  *this = std::move(move);
+}
+
+MappedFile::~MappedFile()
+{
+  Unmap();
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& move)
+{
+  Unmap();
+  m_data = std::exchange(move.m_data, nullptr);
+  m_size = std::exchange(move.m_size, 0);
+  m_next_read_offset = std::exchange(move.m_next_read_offset, 0);
+#ifdef _WIN32
+  m_mapping_handle = std::exchange(move.m_mapping_handle, nullptr);
+#endif
+  return *this;
+}
+
+bool MappedFile::IsNetworkFile(std::FILE* fp)
+{
+#if defined(_WIN32)
+  const HANDLE file_handle = reinterpret_cast<HANDLE>(_get_osfhandle(_fileno(fp)));
+  wchar_t path[MAX_PATH + 16];
+  const DWORD len = GetFinalPathNameByHandleW(file_handle, path, static_cast<DWORD>(std::size(path)), 0);
+
+  // mapped network drives resolve to UNC paths as well
+  return (len == 0 || len >= std::size(path) || std::wcsncmp(path, L"\\\\?\\UNC\\", 8) == 0);
+#elif defined(__linux__)
+  struct statfs sfs;
+  if (fstatfs(fileno(fp), &sfs) != 0)
+    return true;
+
+  switch (static_cast<u32>(sfs.f_type))
+  {
+    case 0x6969:     // NFS_SUPER_MAGIC
+    case 0x517B:     // SMB_SUPER_MAGIC
+    case 0xFF534D42: // CIFS_SUPER_MAGIC
+    case 0xFE534D42: // SMB2_SUPER_MAGIC
+    case 0x564C:     // NCP_SUPER_MAGIC
+    case 0x65735546: // FUSE_SUPER_MAGIC (sshfs etc)
+      return true;
+
+    default:
+      return false;
+  }
+#elif defined(__APPLE__) || defined(__FreeBSD__)
+  struct statfs sfs;
+  return (fstatfs(fileno(fp), &sfs) != 0 || !(sfs.f_flags & MNT_LOCAL));
+#else
+  return true;
+#endif
+}
+
+bool MappedFile::Map(std::FILE* fp)
+{
+  Unmap();
+
+  if (IsNetworkFile(fp))
+  {
+    Log_DevPrintf("Not mapping file on network filesystem");
+    return false;
+  }
+
+#if defined(_WIN32)
+  const HANDLE file_handle = reinterpret_cast<HANDLE>(_get_osfhandle(_fileno(fp)));
+  LARGE_INTEGER size;
+  if (!GetFileSizeEx(file_handle, &size) || size.QuadPart <= 0 ||
+      static_cast<u64>(size.QuadPart) > std::numeric_limits<size_t>::max())
+  {
+    return false;
+  }
+
+  m_mapping_handle = CreateFileMappingW(file_handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  if (!m_mapping_handle)
+  {
+    Log_ErrorPrintf("CreateFileMappingW() failed: %u", GetLastError());
+    return false;
+  }
+
+  m_data = static_cast<const u8*>(MapViewOfFile(m_mapping_handle, FILE_MAP_READ, 0, 0, 0));
+  if (!m_data)
+  {
+    Log_ErrorPrintf("MapViewOfFile() failed: %u", GetLastError());
+    CloseHandle(m_mapping_handle);
+    m_mapping_handle = nullptr;
+    return false;
+  }
+
+  m_size = static_cast<u64>(size.QuadPart);
+#elif defined(__linux__) || defined(__APPLE__) || defined(__FreeBSD__)
+  const int fd = fileno(fp);
+  struct stat st;
+  if (fstat(fd, &st) != 0 || st.st_size <= 0 || static_cast<u64>(st.st_size) > std::numeric_limits<size_t>::max())
+    return false;
+
+  void* data = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_SHARED, fd, 0);
+  if (data == MAP_FAILED)
+  {
+    Log_ErrorPrintf("mmap() failed: %d", errno);
+    return false;
+  }
+
+  // disc images are mostly streamed, so let the host read ahead aggressively
+  madvise(data, static_cast<size_t>(st.st_size), MADV_SEQUENTIAL);
+
+  m_data = static_cast<const u8*>(data);
+  m_size = static_cast<u64>(st.st_size);
+#else
+  return false;
+#endif
+
+  m_next_read_offset = 0;
+  return true;
+}
+
+void MappedFile::Unmap()
+{
+  if (!m_data)
+    return;
+
+#if defined(_WIN32)
+  UnmapViewOfFile(m_data);
+  CloseHandle(m_mapping_handle);
+  m_mapping_handle = nullptr;
+#elif defined(__linux__) || defined(__APPLE__) || defined(__FreeBSD__)
+  munmap(const_cast<u8*>(m_data), static_cast<size_t>(m_size));
+#endif
+
+  m_data = nullptr;
+  m_size = 0;
+}
+
+bool MappedFile::Read(void* buffer, u64 offset, u32 size)
+{
+  if (offset >= m_size || (m_size - offset) < size)
+    return false;
+
+  if (offset != m_next_read_offset)
+    AdviseWillNeed(offset, PREFETCH_SIZE);
+
+  std::memcpy(buffer, m_data + offset, size);
+  m_next_read_offset = offset + size;
+  return true;
+}
+
+void MappedFile::AdviseWillNeed(u64 offset, u64 length)
+{
+#if defined(__linux__) || defined(__APPLE__) || defined(__FreeBSD__)
+  // madvise() needs a page aligned start address
+  const uintptr_t page_mask = static_cast<uintptr_t>(sysconf(_SC_PAGESIZE)) - 1;
+  const u64 end = std::min(offset + length, m_size);
+  if (offset >= end)
+    return;
+
+  const uintptr_t start = reinterpret_cast<uintptr_t>(m_data + offset);
+  const uintptr_t aligned_start = start & ~page_mask;
+  madvise(reinterpret_cast<void*>(aligned_start), static_cast<size_t>(end - offset) + (start - aligned_start),
+          MADV_WILLNEED);
+#endif
+}
+
+} // namespace Common
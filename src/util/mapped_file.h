@@ -0,0 +1,56 @@
+// SPDX-FileCopyrightText: 2019-2022 Connor McLaughlin <stenzek@gmail.com>
+// SPDX-License-Identifier: (GPL-3.0 OR CC-BY-NC-ND-4.0)
+
+#pragma once
+#include "common/types.h"
+#include <cstdio>
+
+namespace Common {
+
+/// Read-only mapping of an entire file, so reads are a copy out of the page cache rather than a syscall each.
+class MappedFile
+{
+public:
+  enum : u32
+  {
+    /// Amount of data after a non-sequential read which the host is asked to start reading in the background.
+    PREFETCH_SIZE = 1024 * 1024
+  };
+
+  MappedFile();
+  MappedFile(const MappedFile&) = delete;
+  MappedFile(MappedFile&& move);
+  ~MappedFile();
+
+  MappedFile& operator=(const MappedFile&) = delete;
+  MappedFile& operator=(MappedFile&& move);
+
+  ALWAYS_INLINE bool IsMapped() const { return (m_data != nullptr); }
+  ALWAYS_INLINE const u8* GetData() const { return m_data; }
+  ALWAYS_INLINE u64 GetSize() const { return m_size; }
+
+  /// Maps the file behind fp. Files on network filesystems are not mapped, since accesses fault if the connection
+  /// drops, so callers should keep reading through the file when this fails.
+  bool Map(std::FILE* fp);
+  void Unmap();
+
+  /// Copies size bytes at offset out of the mapping. A read which doesn't follow on from the previous one is treated
+  /// as a seek, and the data after it is prefetched.
+  bool Read(void* buffer, u64 offset, u32 size);
+
+  /// Asks the host to start reading the specified range in the background.
+  void AdviseWillNeed(u64 offset, u64 length);
+
+private:
+  static bool IsNetworkFile(std::FILE* fp);
+
+  const u8* m_data = nullptr;
+  u64 m_size = 0;
+  u64 m_next_read_offset = 0;
+
+#ifdef _WIN32
+  void* m_mapping_handle = nullptr;
+#endif
+};
+
+} // namespace Common
@@ -2,9 +2,11 @@
 // SPDX-License-Identifier: (GPL-3.0 OR CC-BY-NC-ND-4.0)
 
 #include "memory_arena.h"
+#include "common/align.h"
 #include "common/assert.h"
 #include "common/log.h"
 #include "common/string_util.h"
+#include <cstdio>
 Log_SetChannel(Common::MemoryArena);
 
 #if defined(_WIN32)
@@ -77,9 +79,18 @@ void* MemoryArena::FindBaseAddressForMapping(size_t size)
   if (base_address)
     VirtualFree(base_address, 0, MEM_RELEASE);
 #elif defined(__linux__) || defined(__APPLE__) || defined(__FreeBSD__)
-  base_address = mmap(nullptr, size, PROT_NONE, MAP_ANON | MAP_PRIVATE, -1, 0);
-  if (base_address)
-    munmap(base_address, size);
+  // Over-allocate so the base can be aligned to a huge page boundary, otherwise views can't use huge pages.
+  base_address = mmap(nullptr, size + HUGE_PAGE_SIZE, PROT_NONE, MAP_ANON | MAP_PRIVATE, -1, 0);
+  if (base_address != MAP_FAILED)
+  {
+    munmap(base_address, size + HUGE_PAGE_SIZE);
+    base_address = reinterpret_cast<void*>(
+      Common::AlignUpPow2(reinterpret_cast<uintptr_t>(base_address), static_cast<unsigned>(HUGE_PAGE_SIZE)));
+  }
+  else
+  {
+    base_address = nullptr;
+  }
 #elif defined(__ANDROID__)
   base_address = mmap(nullptr, size, PROT_NONE, MAP_ANON | MAP_SHARED, -1, 0);
   if (base_address)
@@ -121,13 +132,30 @@ static std::string GetFileMappingName()
   return ret;
 }
 
-bool MemoryArena::Create(size_t size, bool writable, bool executable)
+bool MemoryArena::Create(size_t size, bool writable, bool executable, bool huge_pages /* = false */)
 {
   if (IsValid())
     Destroy();
 
   const std::string file_mapping_name(GetFileMappingName());
 
+  m_huge_pages = false;
+  if (huge_pages)
+  {
+#if defined(__linux__) && !defined(__ANDROID__)
+    // hugetlbfs pages can't be write protected at 4KB granularity, which code page tracking needs, so we rely on THP.
+    const std::string thp_mode(GetTransparentHugePageMode(true));
+    m_huge_pages = (thp_mode != "never" && thp_mode != "deny" && thp_mode != "unsupported");
+    if (m_huge_pages)
+      Log_InfoPrintf("Memory arena is using transparent huge pages (shmem mode: %s)", thp_mode.c_str());
+    else
+      Log_WarningPrintf("Transparent huge pages unavailable for shared memory (mode: %s), using regular pages",
+                        thp_mode.c_str());
+#else
+    Log_WarningPrint("Huge pages are not supported for memory arenas on this platform, using regular pages");
+#endif
+  }
+
 #if defined(_WIN32)
   const DWORD protect = (writable ? (executable ? PAGE_EXECUTE_READWRITE : PAGE_READWRITE) : PAGE_READONLY);
   m_file_handle = CreateFileMappingA(INVALID_HANDLE_VALUE, nullptr, protect, Truncate32(size >> 32), Truncate32(size),
@@ -262,6 +290,9 @@ void* MemoryArena::CreateViewPtr(size_t offset, size_t size, bool writable, bool
   base_pointer = mmap(fixed_address, size, prot, flags, m_shmem_fd, static_cast<off_t>(offset));
   if (base_pointer == reinterpret_cast<void*>(-1))
     return nullptr;
+
+  if (m_huge_pages && !AdviseHugePages(base_pointer, size))
+    Log_WarningPrintf("Failed to request huge pages for view at %p (size 0x%zX)", base_pointer, size);
 #else
   return nullptr;
 #endif
@@ -362,6 +393,48 @@ bool MemoryArena::SetPageProtection(void* address, size_t length, bool readable,
 #endif
 }
 
+bool MemoryArena::AdviseHugePages(void* address, size_t length)
+{
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+  // Only whole huge pages within the range can be backed by them.
+  const uintptr_t start =
+    Common::AlignUpPow2(reinterpret_cast<uintptr_t>(address), static_cast<unsigned>(HUGE_PAGE_SIZE));
+  const uintptr_t end =
+    Common::AlignDownPow2(reinterpret_cast<uintptr_t>(address) + length, static_cast<unsigned>(HUGE_PAGE_SIZE));
+  if (end <= start)
+    return false;
+
+  return (madvise(reinterpret_cast<void*>(start), end - start, MADV_HUGEPAGE) >= 0);
+#else
+  return false;
+#endif
+}
+
+std::string MemoryArena::GetTransparentHugePageMode(bool shared_memory)
+{
+#if defined(__linux__)
+  // The active mode is the bracketed word, e.g. "always [madvise] never". sysfs files don't report their size, so
+  // we can't use FileSystem::ReadFileToString() here.
+  std::FILE* fp = std::fopen(
+    shared_memory ? "/sys/kernel/mm/transparent_hugepage/shmem_enabled" : "/sys/kernel/mm/transparent_hugepage/enabled",
+    "r");
+  if (fp)
+  {
+    char buf[128];
+    const bool result = (std::fgets(buf, sizeof(buf), fp) != nullptr);
+    std::fclose(fp);
+
+    const std::string modes(result ? buf : "");
+    const std::string::size_type start = modes.find('[');
+    const std::string::size_type end = modes.find(']', start);
+    if (start != std::string::npos && end != std::string::npos)
+      return modes.substr(start + 1, end - start - 1);
+  }
+#endif
+
+  return "unsupported";
+}
+
 MemoryArena::View::View(MemoryArena* parent, void* base_pointer, size_t arena_offset, size_t mapping_size,
                         bool writable)
   : m_parent(parent), m_base_pointer(base_pointer), m_arena_offset(arena_offset), m_mapping_size(mapping_size),
@@ -5,6 +5,7 @@
 #include "common/types.h"
 #include <atomic>
 #include <optional>
+#include <string>
 
 namespace Common {
 class MemoryArena
@@ -35,6 +36,12 @@ public:
     bool m_writable;
   };
 
+  enum : size_t
+  {
+    /// Size of huge/large pages which we try to back memory with. This matches x86-64 and AArch64 with 4KB pages.
+    HUGE_PAGE_SIZE = 2 * 1024 * 1024
+  };
+
   MemoryArena();
   ~MemoryArena();
 
@@ -43,9 +50,13 @@ public:
   ALWAYS_INLINE size_t GetSize() const { return m_size; }
   ALWAYS_INLINE bool IsWritable() const { return m_writable; }
   ALWAYS_INLINE bool IsExecutable() const { return m_executable; }
+  ALWAYS_INLINE bool IsUsingHugePages() const { return m_huge_pages; }
 
   bool IsValid() const;
-  bool Create(size_t size, bool writable, bool executable);
+
+  /// Creates the backing storage for the arena. If huge_pages is set, views are hinted to use transparent huge pages
+  /// where the host supports them, otherwise regular pages are used.
+  bool Create(size_t size, bool writable, bool executable, bool huge_pages = false);
   void Destroy();
 
   std::optional<View> CreateView(size_t offset, size_t size, bool writable, bool executable,
@@ -62,6 +73,14 @@ public:
 
   static bool SetPageProtection(void* address, size_t length, bool readable, bool writable, bool executable);
 
+  /// Hints that the huge page aligned part of the specified range should be backed by transparent huge pages.
+  /// Returns false if the host doesn't support it, in which case the range keeps using regular pages.
+  static bool AdviseHugePages(void* address, size_t length);
+
+  /// Returns the host's transparent huge page policy (e.g. "always", "madvise", "never") for anonymous or shared
+  /// memory, or "unsupported" if it can't be determined.
+  static std::string GetTransparentHugePageMode(bool shared_memory);
+
 private:
 #if defined(_WIN32)
   void* m_file_handle = nullptr;
@@ -73,5 +92,6 @@ private:
   size_t m_size = 0;
   bool m_writable = false;
   bool m_executable = false;
+  bool m_huge_pages = false;
 };
 } // namespace Common
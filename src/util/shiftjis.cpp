@@ -1,270 +1,200 @@
 #include "shiftjis.h"
+#include "common/bitutils.h"
+#include "common/platform.h"
+#include "common/types.h"
+#include <algorithm>
+#include <array>
 #include <cstdint>
-#include <cstdlib>
-#include <cstring>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+#if defined(CPU_X64)
+#include <emmintrin.h>
+#elif defined(CPU_AARCH64)
+#ifdef _MSC_VER
+#include <arm64_neon.h>
+#else
+#include <arm_neon.h>
+#endif
+#endif
 
-// https://github.com/bucanero/apollo-ps3/commit/b8e52b021239d40f2ba6945d7352345f4457b7b7
 extern const unsigned char shiftJIS_convTable[25088];
 
-void sjis2ascii(char* bData)
+namespace {
+// Two-level conversion table: the lead byte selects a row of 256 UTF-16 code points indexed by the trail byte.
+// Row 0 holds the single-byte characters. Identical rows are shared, and the ASCII simplifications for the 0x81/0x82
+// rows are folded in so the conversion loop doesn't need to special-case them.
+struct SJISTable
 {
-  std::uint16_t ch;
-  int i, j = 0;
-  int len = static_cast<int>(std::strlen(bData));
+  std::array<std::uint8_t, 256> lead_rows{};
+  std::vector<std::array<std::uint16_t, 256>> rows;
 
-  for (i = 0; i < len; i += 2)
+  SJISTable()
   {
-    ch = (bData[i] << 8) | bData[i + 1];
+    const auto lookup = [](size_t offset) -> std::uint16_t {
+      return static_cast<std::uint16_t>((shiftJIS_convTable[offset << 1] << 8) | shiftJIS_convTable[(offset << 1) + 1]);
+    };
 
-    // 'A' .. 'Z'
-    // '0' .. '9'
-    if ((ch >= 0x8260 && ch <= 0x8279) || (ch >= 0x824F && ch <= 0x8258))
-    {
-      bData[j++] = (ch & 0xFF) - 0x1F;
-      continue;
-    }
-
-    // 'a' .. 'z'
-    if (ch >= 0x8281 && ch <= 0x829A)
-    {
-      bData[j++] = (ch & 0xFF) - 0x20;
-      continue;
-    }
+    std::array<std::uint16_t, 256> row;
+    for (unsigned i = 0; i < 256; i++)
+      row[i] = lookup(i);
+    rows.push_back(row);
 
-    switch (ch)
+    for (unsigned lead = 0; lead < 256; lead++)
     {
-      case 0x0000: // End of the string
-        bData[j] = 0;
-        return;
-
-      case 0x8140:
-        bData[j++] = ' ';
-        break;
-
-      case 0x8143:
-        bData[j++] = ',';
-        break;
-
-      case 0x8144:
-        bData[j++] = '.';
-        break;
-
-      case 0x8145:
-        bData[j++] = '\xFA';
-        break;
-
-      case 0x8146:
-        bData[j++] = ':';
-        break;
-
-      case 0x8147:
-        bData[j++] = ';';
-        break;
-
-      case 0x8148:
-        bData[j++] = '?';
-        break;
-
-      case 0x8149:
-        bData[j++] = '!';
-        break;
-
-      case 0x814F:
-        bData[j++] = '^';
-        break;
-
-      case 0x8151:
-        bData[j++] = '_';
-        break;
-
-      case 0x815B:
-      case 0x815C:
-      case 0x815D:
-        bData[j++] = '-';
-        break;
-
-      case 0x815E:
-        bData[j++] = '/';
-        break;
-
-      case 0x815F:
-        bData[j++] = '\\';
-        break;
-
-      case 0x8160:
-        bData[j++] = '~';
-        break;
-
-      case 0x8161:
-        bData[j++] = '|';
-        break;
-
-      case 0x8168:
-        bData[j++] = '"';
-        break;
-
-      case 0x8169:
-        bData[j++] = '(';
-        break;
-
-      case 0x816A:
-        bData[j++] = ')';
-        break;
-
-      case 0x816D:
-        bData[j++] = '[';
-        break;
-
-      case 0x816E:
-        bData[j++] = ']';
-        break;
-
-      case 0x816F:
-        bData[j++] = '{';
-        break;
-
-      case 0x8170:
-        bData[j++] = '}';
-        break;
-
-      case 0x817B:
-        bData[j++] = '+';
-        break;
+      const unsigned section = lead >> 4;
+      if (section != 0x8 && section != 0x9 && section != 0xE)
+        continue;
 
-      case 0x817C:
-        bData[j++] = '-';
-        break;
-
-      case 0x817D:
-        bData[j++] = '\xF1';
-        break;
-
-      case 0x817E:
-        bData[j++] = '*';
-        break;
-
-      case 0x8180:
-        bData[j++] = '\xF6';
-        break;
+      const size_t base = ((section == 0x8) ? 0x100 : ((section == 0x9) ? 0x1100 : 0x2100)) + ((lead & 0xf) << 8);
+      for (unsigned trail = 0; trail < 256; trail++)
+        row[trail] = lookup(base + trail);
 
-      case 0x8181:
-        bData[j++] = '=';
-        break;
-
-      case 0x8183:
-        bData[j++] = '<';
-        break;
-
-      case 0x8184:
-        bData[j++] = '>';
-        break;
-
-      case 0x818A:
-        bData[j++] = '\xF8';
-        break;
+      if (lead == 0x81 || lead == 0x82)
+        ApplyASCIIReplacements(lead, row, lookup);
 
-      case 0x818B:
-        bData[j++] = '\'';
-        break;
-
-      case 0x818C:
-        bData[j++] = '"';
-        break;
+      auto it = std::find(rows.begin() + 1, rows.end(), row);
+      if (it == rows.end())
+        it = rows.insert(rows.end(), row);
+      lead_rows[lead] = static_cast<std::uint8_t>(std::distance(rows.begin(), it));
+    }
+  }
 
-      case 0x8190:
-        bData[j++] = '$';
-        break;
+  template<typename F>
+  static void ApplyASCIIReplacements(unsigned lead, std::array<std::uint16_t, 256>& row, const F& lookup)
+  {
+    // Fullwidth letters, digits and punctuation are simplified to the single-byte characters, which keeps memory
+    // card titles readable. The replacement goes through the single-byte row, so '\\' still becomes a yen sign.
+    // https://github.com/bucanero/apollo-ps3/commit/b8e52b021239d40f2ba6945d7352345f4457b7b7
+    if (lead == 0x82)
+    {
+      for (unsigned i = 0x4F; i <= 0x58; i++)
+        row[i] = lookup(i - 0x1F); // '0' .. '9'
+      for (unsigned i = 0x60; i <= 0x79; i++)
+        row[i] = lookup(i - 0x1F); // 'A' .. 'Z'
+      for (unsigned i = 0x81; i <= 0x9A; i++)
+        row[i] = lookup(i - 0x20); // 'a' .. 'z'
+      return;
+    }
 
-      case 0x8193:
-        bData[j++] = '%';
-        break;
+    static constexpr std::pair<u8, u8> replacements[] = {
+      {0x40, ' '}, {0x43, ','},  {0x44, '.'}, {0x45, 0xFA}, {0x46, ':'},  {0x47, ';'}, {0x48, '?'}, {0x49, '!'},
+      {0x4F, '^'}, {0x51, '_'},  {0x5B, '-'}, {0x5C, '-'},  {0x5D, '-'},  {0x5E, '/'}, {0x5F, '\\'}, {0x60, '~'},
+      {0x61, '|'}, {0x68, '"'},  {0x69, '('}, {0x6A, ')'},  {0x6D, '['},  {0x6E, ']'}, {0x6F, '{'}, {0x70, '}'},
+      {0x7B, '+'}, {0x7C, '-'},  {0x7D, 0xF1}, {0x7E, '*'}, {0x80, 0xF6}, {0x81, '='}, {0x83, '<'}, {0x84, '>'},
+      {0x8A, 0xF8}, {0x8B, '\''}, {0x8C, '"'}, {0x90, '$'}, {0x93, '%'},  {0x94, '#'}, {0x95, '&'}, {0x96, '*'},
+      {0x97, '@'},
+    };
+    for (const auto& [trail, ch] : replacements)
+      row[trail] = lookup(ch);
+  }
+};
+} // namespace
 
-      case 0x8194:
-        bData[j++] = '#';
-        break;
+static const SJISTable& GetSJISTable()
+{
+  static const SJISTable table;
+  return table;
+}
 
-      case 0x8195:
-        bData[j++] = '&';
-        break;
+static void AppendUTF8(std::string& output, std::uint16_t unicodeValue)
+{
+  if (unicodeValue < 0x80)
+  {
+    output.push_back(static_cast<char>(unicodeValue));
+  }
+  else if (unicodeValue < 0x800)
+  {
+    output.push_back(static_cast<char>(0xC0 | (unicodeValue >> 6)));
+    output.push_back(static_cast<char>(0x80 | (unicodeValue & 0x3f)));
+  }
+  else
+  {
+    output.push_back(static_cast<char>(0xE0 | (unicodeValue >> 12)));
+    output.push_back(static_cast<char>(0x80 | ((unicodeValue & 0xfff) >> 6)));
+    output.push_back(static_cast<char>(0x80 | (unicodeValue & 0x3f)));
+  }
+}
 
-      case 0x8196:
-        bData[j++] = '*';
-        break;
+/// Returns the length of the run of bytes at the start of input which convert to themselves, i.e. ASCII other than
+/// null, backslash (yen), tilde (overline) and DEL.
+static size_t GetPlainASCIIRunLength(std::string_view input)
+{
+  size_t len = 0;
 
-      case 0x8197:
-        bData[j++] = '@';
-        break;
+#if defined(CPU_X64) || defined(CPU_AARCH64)
+  for (; (input.size() - len) >= 16; len += 16)
+  {
+    const char* ptr = input.data() + len;
+#if defined(CPU_X64)
+    const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(ptr));
+    const __m128i special = _mm_or_si128(_mm_or_si128(_mm_cmplt_epi8(v, _mm_set1_epi8(0x01)),
+                                                      _mm_cmpgt_epi8(v, _mm_set1_epi8(0x7D))),
+                                         _mm_cmpeq_epi8(v, _mm_set1_epi8(0x5C)));
+    const u32 mask = static_cast<u32>(_mm_movemask_epi8(special));
+#else
+    static constexpr u8 bits[16] = {1, 2, 4, 8, 16, 32, 64, 128, 1, 2, 4, 8, 16, 32, 64, 128};
+    const int8x16_t v = vld1q_s8(reinterpret_cast<const s8*>(ptr));
+    const uint8x16_t special = vorrq_u8(vorrq_u8(vcltq_s8(v, vdupq_n_s8(0x01)), vcgtq_s8(v, vdupq_n_s8(0x7D))),
+                                        vceqq_s8(v, vdupq_n_s8(0x5C)));
+    const uint8x16_t masked = vandq_u8(special, vld1q_u8(bits));
+    const u32 mask =
+      static_cast<u32>(vaddv_u8(vget_low_u8(masked))) | (static_cast<u32>(vaddv_u8(vget_high_u8(masked))) << 8);
+#endif
+    if (mask != 0)
+      return len + CountTrailingZeros(mask);
+  }
+#endif
 
-        // Character not found
-      default:
-        bData[j++] = bData[i];
-        bData[j++] = bData[i + 1];
-        break;
-    }
+  for (; len < input.size(); len++)
+  {
+    const char ch = input[len];
+    if (ch < 0x01 || ch > 0x7D || ch == 0x5C)
+      break;
   }
 
-  bData[j] = 0;
-  return;
+  return len;
 }
 
-char* sjis2utf8(char* input)
+std::string sjis2utf8(std::string_view input)
 {
-  // Simplify the input and decode standard ASCII characters
-  sjis2ascii(input);
+  const SJISTable& table = GetSJISTable();
 
-  size_t len = static_cast<int>(std::strlen(input));
-  char* output = reinterpret_cast<char*>(
-    std::malloc(3 * len)); // ShiftJis won't give 4byte UTF8, so max. 3 byte per input char are needed
-  size_t indexInput = 0, indexOutput = 0;
+  std::string output;
+  output.reserve(input.size() * 3);
 
-  while (indexInput < len)
+  for (size_t i = 0; i < input.size();)
   {
-    char arraySection = ((uint8_t)input[indexInput]) >> 4;
-
-    size_t arrayOffset;
-    if (arraySection == 0x8)
-      arrayOffset = 0x100; // these are two-byte shiftjis
-    else if (arraySection == 0x9)
-      arrayOffset = 0x1100;
-    else if (arraySection == 0xE)
-      arrayOffset = 0x2100;
-    else
-      arrayOffset = 0; // this is one byte shiftjis
-
-    // determining real array offset
-    if (arrayOffset)
+    const size_t run = GetPlainASCIIRunLength(input.substr(i));
+    if (run > 0)
     {
-      arrayOffset += (((uint8_t)input[indexInput]) & 0xf) << 8;
-      indexInput++;
-      if (indexInput >= len)
+      output.append(input.data() + i, run);
+      i += run;
+      if (i == input.size())
         break;
     }
-    arrayOffset += (uint8_t)input[indexInput++];
-    arrayOffset <<= 1;
 
-    // unicode number is...
-    uint16_t unicodeValue = (shiftJIS_convTable[arrayOffset] << 8) | shiftJIS_convTable[arrayOffset + 1];
+    const std::uint8_t lead = static_cast<std::uint8_t>(input[i]);
+    if (lead == 0)
+      break;
 
-    // converting to UTF8
-    if (unicodeValue < 0x80)
+    const std::uint8_t row = table.lead_rows[lead];
+    if (row == 0)
     {
-      output[indexOutput++] = static_cast<char>(unicodeValue);
-    }
-    else if (unicodeValue < 0x800)
-    {
-      output[indexOutput++] = 0xC0 | static_cast<char>((unicodeValue >> 6));
-      output[indexOutput++] = 0x80 | static_cast<char>((unicodeValue & 0x3f));
-    }
-    else
-    {
-      output[indexOutput++] = 0xE0 | static_cast<char>((unicodeValue >> 12));
-      output[indexOutput++] = 0x80 | static_cast<char>(((unicodeValue & 0xfff) >> 6));
-      output[indexOutput++] = 0x80 | static_cast<char>((unicodeValue & 0x3f));
+      AppendUTF8(output, table.rows[0][lead]);
+      i++;
+      continue;
     }
+
+    if ((i + 1) >= input.size())
+      break;
+
+    const std::uint16_t ch = table.rows[row][static_cast<std::uint8_t>(input[i + 1])];
+    i += 2;
+    AppendUTF8(output, ch);
   }
 
-  // remove the unnecessary bytes
-  output[indexOutput] = 0;
   return output;
 }
 
@@ -1,4 +1,6 @@
 #pragma once
+#include <string>
+#include <string_view>
 
-void sjis2ascii(char* bData);
-char* sjis2utf8(char* input);
+/// Single-pass conversion which does not modify or require a null-terminated input. Stops at the first null.
+std::string sjis2utf8(std::string_view input);
@@ -29,6 +29,22 @@ void StateWrapper::DoBytes(void* data, size_t length)
   }
 }
 
+const void* StateWrapper::MapBytes(size_t length, size_t alignment /* = 1 */)
+{
+  if (m_mode != Mode::Read || m_error)
+    return nullptr;
+
+  const u64 position = m_stream->GetPosition();
+  const void* ptr = m_stream->MapRead(static_cast<u32>(length));
+  if (ptr && (reinterpret_cast<uintptr_t>(ptr) % alignment) != 0)
+  {
+    m_stream->SeekAbsolute(position);
+    return nullptr;
+  }
+
+  return ptr;
+}
+
 void StateWrapper::DoBytesEx(void* data, size_t length, u32 version_introduced, const void* default_value)
 {
   if (m_mode == Mode::Read && m_version < version_introduced)
@@ -84,7 +100,15 @@ bool StateWrapper::DoMarker(const char* marker)
   if (m_error)
     return false;
 
-  if (m_mode == Mode::Write || file_value.Compare(marker))
+  if (m_mode == Mode::Write)
+  {
+    if (m_marker_offsets)
+      m_marker_offsets->push_back(static_cast<u32>(m_stream->GetPosition()));
+
+    return true;
+  }
+
+  if (file_value.Compare(marker))
     return true;
 
   Log_ErrorPrintf("Marker mismatch at offset %" PRIu64 ": found '%s' expected '%s'", m_stream->GetPosition(),
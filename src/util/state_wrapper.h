@@ -92,20 +92,32 @@ public:
   template<typename T>
   void DoArray(T* values, size_t count)
   {
-    for (size_t i = 0; i < count; i++)
-      Do(&values[i]);
+    // same layout as doing each element, just without the per-element stream calls
+    if constexpr (IsRawSerializable<T>)
+    {
+      DoBytes(values, sizeof(T) * count);
+    }
+    else
+    {
+      for (size_t i = 0; i < count; i++)
+        Do(&values[i]);
+    }
   }
 
   template<typename T>
   void DoPODArray(T* values, size_t count)
   {
-    for (size_t i = 0; i < count; i++)
-      DoPOD(&values[i]);
+    DoBytes(values, sizeof(T) * count);
   }
 
   void DoBytes(void* data, size_t length);
   void DoBytesEx(void* data, size_t length, u32 version_introduced, const void* default_value);
 
+  /// When reading from a memory-backed stream, returns a view of the next length bytes without copying them, and
+  /// skips over them. Returns nullptr without consuming anything if the stream can't be mapped, or the view would not
+  /// have the requested alignment, in which case the caller should fall back to DoBytes().
+  const void* MapBytes(size_t length, size_t alignment = 1);
+
   void Do(bool* value_ptr);
   void Do(std::string* value_ptr);
   void Do(String* value_ptr);
@@ -150,7 +162,7 @@ public:
     else
     {
       for (u32 i = 0; i < length; i++)
-        Do(&data[i]);
+        Do(&(*data)[i]);
     }
   }
 
@@ -160,6 +172,31 @@ public:
     u32 size = data->GetSize();
     Do(&size);
 
+    if constexpr (IsRawSerializable<T>)
+    {
+      // the ring buffer is at most two contiguous runs, the same bytes as doing each element
+      if (m_mode == Mode::Read)
+      {
+        data->Clear();
+        if (size > CAPACITY)
+        {
+          m_error = true;
+          return;
+        }
+
+        DoBytes(data->GetWritePointer(), sizeof(T) * size);
+        data->AdvanceTail(size);
+      }
+      else
+      {
+        const u32 first_run = data->GetContiguousSize();
+        DoBytes(data->GetReadPointer(), sizeof(T) * first_run);
+        DoBytes(data->GetDataPointer(), sizeof(T) * (size - first_run));
+      }
+
+      return;
+    }
+
     if (m_mode == Mode::Read)
     {
       T* temp = new T[size];
@@ -180,6 +217,9 @@ public:
 
   bool DoMarker(const char* marker);
 
+  /// When writing, records the stream position after each marker, so two states can be compared section by section.
+  void SetMarkerOffsets(std::vector<u32>* offsets) { m_marker_offsets = offsets; }
+
   template<typename T>
   void DoEx(T* data, u32 version_introduced, T default_value)
   {
@@ -205,8 +245,14 @@ public:
   }
 
 private:
+  /// Types which are serialized as their in-memory bytes, so arrays of them can be done with a single copy.
+  template<typename T>
+  static constexpr bool IsRawSerializable =
+    (std::is_integral_v<T> && !std::is_same_v<T, bool>) || std::is_floating_point_v<T> || std::is_enum_v<T>;
+
   ByteStream* m_stream;
   Mode m_mode;
   u32 m_version;
+  std::vector<u32>* m_marker_offsets = nullptr;
   bool m_error = false;
 };